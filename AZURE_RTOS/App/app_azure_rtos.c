@@ -50,8 +50,9 @@ static UCHAR tx_byte_pool_buffer[TX_APP_MEM_POOL_SIZE];
 static TX_BYTE_POOL tx_app_byte_pool;
 
 /* USER CODE BEGIN NX_Pool_Buffer */
+/* The NetX memory is static, see app_netxduo.h, the pool is left for the application */
 /* USER CODE END NX_Pool_Buffer */
-static UCHAR  nx_byte_pool_buffer[NX_APP_MEM_POOL_SIZE];
+static UCHAR  nx_byte_pool_buffer[NX_APP_MEM_POOL_SIZE] DMA_RAM;
 static TX_BYTE_POOL nx_app_byte_pool;
 
 /* USER CODE BEGIN PV */
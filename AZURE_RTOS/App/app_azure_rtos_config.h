@@ -42,7 +42,7 @@ extern "C" {
 /* define the size of static threadX byte memory pools */
 #define TX_APP_MEM_POOL_SIZE                     1024
 
-#define NX_APP_MEM_POOL_SIZE                     1024 * 80
+#define NX_APP_MEM_POOL_SIZE                     1024
 
 /* USER CODE BEGIN EC */
 
@@ -52,6 +52,13 @@ extern "C" {
 UINT App_ThreadX_Init(VOID *memory_ptr);
 void MX_ThreadX_Init(void);
 /* USER CODE BEGIN EFP */
+void App_ThreadX_FPU_Enable(TX_THREAD *thread_ptr);
+#ifdef TX_THREAD_FPU_POLICY
+void App_ThreadX_FPU_Switch(TX_THREAD *thread_ptr);
+#endif
+#ifdef CLOCK_GOVERNOR
+void App_ThreadX_Tick_Rescale(ULONG old_hclk);
+#endif
 
 /* USER CODE END EFP */
 
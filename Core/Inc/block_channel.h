@@ -0,0 +1,71 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    block_channel.h
+  * @author  MCD Application Team
+  * @brief   Zero-copy channel of blocks between a producer and a consumer
+  *
+  *          A block pool and a queue of block pointers, so that a payload is
+  *          written once in its block and handed over rather than copied:
+  *          the producer reserves a block, fills it and commits it with its
+  *          length, the consumer receives the block and releases it to the
+  *          pool once done with it. The block belongs to one side at a time,
+  *          from the reserve to the commit to the producer, from the receive
+  *          to the release to the consumer. The queue holds as many entries
+  *          as the pool has blocks, so a commit never fails and the producer
+  *          only waits, or drops, at the reserve. An interrupt may reserve
+  *          and commit with TX_NO_WAIT.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BLOCK_CHANNEL_H__
+#define __BLOCK_CHANNEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct BLOCK_CHANNEL_STRUCT
+{
+  /* Blocks free, reserved or in use by the consumer. */
+  TX_BLOCK_POOL block_channel_pool;
+
+  /* Blocks committed, each entry the block and its length. */
+  TX_QUEUE block_channel_queue;
+} BLOCK_CHANNEL;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Storage of the pool for count blocks of size bytes, with the pointer ThreadX keeps before each block */
+#define BLOCK_CHANNEL_POOL_SIZE(size, count)  \
+  ((count) * ((((size) + sizeof(ULONG) - 1U) & ~(sizeof(ULONG) - 1U)) + sizeof(VOID *)))
+
+/* Storage of the queue for count blocks */
+#define BLOCK_CHANNEL_QUEUE_SIZE(count)       ((count) * 2U * sizeof(ULONG))
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT block_channel_create(BLOCK_CHANNEL *channel, CHAR *name, ULONG block_size,
+                          VOID *pool_start, ULONG pool_size, VOID *queue_start, ULONG queue_size);
+UINT block_channel_reserve(BLOCK_CHANNEL *channel, VOID **block_ptr, ULONG wait_option);
+UINT block_channel_commit(BLOCK_CHANNEL *channel, VOID *block_ptr, ULONG length);
+UINT block_channel_receive(BLOCK_CHANNEL *channel, VOID **block_ptr, ULONG *length_ptr, ULONG wait_option);
+UINT block_channel_release(VOID *block_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __BLOCK_CHANNEL_H__ */
@@ -0,0 +1,62 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    boot_profile.h
+  * @author  MCD Application Team
+  * @brief   Time stamps of the boot phases, from main() to the MQTT connection
+  *
+  *          boot_profile_init() starts the DWT cycle counter at the entry of
+  *          main(), each boot_profile_mark() stamps the first time its phase
+  *          is reached, later calls are ignored so the reconnections do not
+  *          move them. boot_profile_report() prints the time of the phases
+  *          reached since main(), once. Until then the core clock keeps
+  *          running in the sleep of the idle loop, so that the counter times
+  *          the waits for the PHY, DHCP and the broker too.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_PROFILE_H__
+#define __BOOT_PROFILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Boot phases, in the order of the report. The threads reach the last ones
+   concurrently, the link may come up before or after the TLS setup. */
+#define BOOT_PROFILE_CLOCKS           0U    /* HAL_Init() and the PLL at 180 MHz */
+#define BOOT_PROFILE_PERIPHERALS      1U    /* GPIO, DMA, ETH MAC, UART and RNG initialized */
+#define BOOT_PROFILE_KERNEL           2U    /* tx_application_define() entered */
+#define BOOT_PROFILE_NETX             3U    /* pools, IP instance and threads created */
+#define BOOT_PROFILE_TLS_READY        4U    /* store, certificates and MQTT client set up */
+#define BOOT_PROFILE_LINK_UP          5U    /* PHY reset and auto-negotiation done */
+#define BOOT_PROFILE_DHCP             6U    /* address bound */
+#define BOOT_PROFILE_DNS              7U    /* broker address resolved */
+#define BOOT_PROFILE_MQTT             8U    /* TCP connection, TLS handshake and MQTT CONNACK done */
+
+#define BOOT_PROFILE_PHASES           9U
+
+/* Exported functions prototypes ---------------------------------------------*/
+VOID boot_profile_init(VOID);
+VOID boot_profile_mark(UINT phase);
+VOID boot_profile_report(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __BOOT_PROFILE_H__ */
@@ -0,0 +1,88 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    clock_governor.h
+  * @author  MCD Application Team
+  * @brief   HCLK scaled to the load, 180 MHz when busy, 45 MHz when idle
+  *
+  *          With CLOCK_GOVERNOR defined in the Makefile, a ThreadX timer looks
+  *          every CLOCK_GOVERNOR_PERIOD at the CPU share of the threads and
+  *          interrupts, from the cycles the execution profile charges them,
+  *          and at the threads ready to run. A busy or queued CPU gets the
+  *          full 180 MHz at once, an idle one drops to HCLK/4 after
+  *          CLOCK_GOVERNOR_IDLE_PERIODS quiet periods. The TLS handshakes and
+  *          the signature checks hold the full speed while they run, between
+  *          clock_governor_boost() and clock_governor_release().
+  *          Only the AHB and APB prescalers change: the PLL stays locked, the
+  *          regulator in scale 1 with the over-drive on, a switch takes a few
+  *          cycles and the Ethernet MAC, its DMA and the RNG keep running.
+  *          PCLK1 stays at 45 MHz, the USART3 baud rate with it, the SysTick
+  *          period and phase, the prescalers of the running timers and the
+  *          MDC range of the MAC follow each switch. The cycle counts of the
+  *          profiles are in the cycles of the clock that ran. Without
+  *          CLOCK_GOVERNOR the functions compile to nothing, HCLK stays at
+  *          180 MHz.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CLOCK_GOVERNOR_H__
+#define __CLOCK_GOVERNOR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Clock levels */
+#define CLOCK_GOVERNOR_FULL           0U    /* HCLK 180 MHz, PCLK1 45 MHz, PCLK2 90 MHz */
+#define CLOCK_GOVERNOR_LOW            1U    /* HCLK 45 MHz, PCLK1 45 MHz, PCLK2 45 MHz */
+
+/* Period of the decision, in ticks: shorter than the stretched sleep the TCP timers allow anyway */
+#define CLOCK_GOVERNOR_PERIOD         (TX_TIMER_TICKS_PER_SECOND / 4U)
+
+/* CPU share, in per mille of the period, over which the low level goes full and under which
+   the full level counts a quiet period. A quarter of the load at low speed is left at full speed. */
+#define CLOCK_GOVERNOR_BUSY_PERMILLE  600U
+#define CLOCK_GOVERNOR_IDLE_PERMILLE  100U
+
+/* Quiet periods in a row before the clock drops */
+#define CLOCK_GOVERNOR_IDLE_PERIODS   4U
+
+/* Threads ready at the decision, the one interrupted included, from which the clock goes full */
+#define CLOCK_GOVERNOR_READY_THREADS  3U
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef CLOCK_GOVERNOR
+
+UINT clock_governor_start(VOID);
+VOID clock_governor_boost(VOID);
+VOID clock_governor_release(VOID);
+UINT clock_governor_level_get(VOID);
+
+#else
+
+#define clock_governor_start()        TX_SUCCESS
+#define clock_governor_boost()
+#define clock_governor_release()
+#define clock_governor_level_get()    CLOCK_GOVERNOR_FULL
+
+#endif /* CLOCK_GOVERNOR */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CLOCK_GOVERNOR_H__ */
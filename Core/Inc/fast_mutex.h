@@ -0,0 +1,169 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    fast_mutex.h
+  * @author  MCD Application Team
+  * @brief   Inline get and put of the uncontended mutexes without inheritance
+  *
+  *          NetX Duo takes nx_ip_protection and the MQTT client takes
+  *          nxd_mqtt_protection several times for each packet, both created
+  *          with TX_NO_INHERIT, and nearly always free or already owned by the
+  *          caller. fast_mutex_get() and fast_mutex_put() do these cases
+  *          inline, with the same updates of the mutex and of the owned list
+  *          of the thread as tx_mutex_get() and tx_mutex_put(), but without
+  *          the call, the argument checks and the inheritance bookkeeping. Any
+  *          other case, a mutex owned by another thread, threads waiting,
+  *          priority inheritance or a caller that is not a thread, an
+  *          interrupt handler included, calls the kernel service, so both
+  *          paths can be mixed on the same mutex. With NX_ENABLE_FAST_MUTEX,
+  *          nx_user.h maps the mutex services of the NetX sources on these
+  *          functions.
+  *          The mutex is updated with interrupts disabled, as the kernel does:
+  *          on the single Cortex-M4 core, setting PRIMASK costs fewer cycles
+  *          than an LDREX/STREX loop, and it is needed anyway to keep the
+  *          owned list of the thread consistent with the owner.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FAST_MUTEX_H__
+#define __FAST_MUTEX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported variables --------------------------------------------------------*/
+/* Running thread and system state, see tx_thread.h. The current thread is also set in an
+   interrupt handler that preempted it, only the system state tells the thread context. */
+extern TX_THREAD *_tx_thread_current_ptr;
+extern volatile ULONG _tx_thread_system_state;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Get the mutex inline when it is free or owned by the calling thread, otherwise call tx_mutex_get().
+* @param  mutex_ptr: created mutex
+* @param  wait_option: as for tx_mutex_get()
+* @retval As tx_mutex_get()
+*/
+static inline UINT fast_mutex_get(TX_MUTEX *mutex_ptr, ULONG wait_option)
+{
+  TX_INTERRUPT_SAVE_AREA
+  TX_THREAD *thread_ptr;
+  TX_MUTEX *next_mutex;
+
+  TX_DISABLE
+  thread_ptr = _tx_thread_current_ptr;
+  if ((thread_ptr != TX_NULL) && (TX_THREAD_GET_SYSTEM_STATE() == 0U) && (mutex_ptr -> tx_mutex_inherit == TX_FALSE))
+  {
+    if (mutex_ptr -> tx_mutex_ownership_count == 0U)
+    {
+      mutex_ptr -> tx_mutex_ownership_count = 1U;
+      mutex_ptr -> tx_mutex_owner = thread_ptr;
+
+      /* Add the mutex to the end of the owned list, released by tx_thread_delete() and tx_thread_terminate(). */
+      next_mutex = thread_ptr -> tx_thread_owned_mutex_list;
+      if (next_mutex != TX_NULL)
+      {
+        mutex_ptr -> tx_mutex_owned_previous = next_mutex -> tx_mutex_owned_previous;
+        mutex_ptr -> tx_mutex_owned_next = next_mutex;
+        next_mutex -> tx_mutex_owned_previous -> tx_mutex_owned_next = mutex_ptr;
+        next_mutex -> tx_mutex_owned_previous = mutex_ptr;
+      }
+      else
+      {
+        thread_ptr -> tx_thread_owned_mutex_list = mutex_ptr;
+        mutex_ptr -> tx_mutex_owned_next = mutex_ptr;
+        mutex_ptr -> tx_mutex_owned_previous = mutex_ptr;
+      }
+      thread_ptr -> tx_thread_owned_mutex_count++;
+
+      TX_RESTORE
+      return TX_SUCCESS;
+    }
+
+    if (mutex_ptr -> tx_mutex_owner == thread_ptr)
+    {
+      mutex_ptr -> tx_mutex_ownership_count++;
+
+      TX_RESTORE
+      return TX_SUCCESS;
+    }
+  }
+  TX_RESTORE
+
+  return tx_mutex_get(mutex_ptr, wait_option);
+}
+
+/**
+* @brief  Put the mutex inline when the calling thread owns it and no thread waits for it,
+*         otherwise call tx_mutex_put().
+* @param  mutex_ptr: created mutex
+* @retval As tx_mutex_put()
+*/
+static inline UINT fast_mutex_put(TX_MUTEX *mutex_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+  TX_THREAD *thread_ptr;
+
+  TX_DISABLE
+  thread_ptr = _tx_thread_current_ptr;
+  if ((thread_ptr != TX_NULL) && (TX_THREAD_GET_SYSTEM_STATE() == 0U) && (mutex_ptr -> tx_mutex_owner == thread_ptr) &&
+      (mutex_ptr -> tx_mutex_inherit == TX_FALSE))
+  {
+    if (mutex_ptr -> tx_mutex_ownership_count > 1U)
+    {
+      mutex_ptr -> tx_mutex_ownership_count--;
+
+      TX_RESTORE
+      return TX_SUCCESS;
+    }
+
+    if ((mutex_ptr -> tx_mutex_ownership_count == 1U) && (mutex_ptr -> tx_mutex_suspension_list == TX_NULL))
+    {
+      mutex_ptr -> tx_mutex_ownership_count = 0U;
+      mutex_ptr -> tx_mutex_owner = TX_NULL;
+
+      /* Remove the mutex from the owned list of the thread. */
+      thread_ptr -> tx_thread_owned_mutex_count--;
+      if (thread_ptr -> tx_thread_owned_mutex_count == 0U)
+      {
+        thread_ptr -> tx_thread_owned_mutex_list = TX_NULL;
+      }
+      else
+      {
+        mutex_ptr -> tx_mutex_owned_next -> tx_mutex_owned_previous = mutex_ptr -> tx_mutex_owned_previous;
+        mutex_ptr -> tx_mutex_owned_previous -> tx_mutex_owned_next = mutex_ptr -> tx_mutex_owned_next;
+        if (thread_ptr -> tx_thread_owned_mutex_list == mutex_ptr)
+        {
+          thread_ptr -> tx_thread_owned_mutex_list = mutex_ptr -> tx_mutex_owned_next;
+        }
+      }
+
+      TX_RESTORE
+      return TX_SUCCESS;
+    }
+  }
+  TX_RESTORE
+
+  return tx_mutex_put(mutex_ptr);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __FAST_MUTEX_H__ */
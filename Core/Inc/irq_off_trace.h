@@ -0,0 +1,85 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    irq_off_trace.h
+  * @author  MCD Application Team
+  * @brief   Length of the sections run with the interrupts disabled
+  *
+  *          With TX_IRQ_OFF_TRACE defined in the Makefile, the TX_DISABLE and
+  *          TX_RESTORE macros of tx_port.h, used by ThreadX and NetX Duo for
+  *          their critical sections, call the hooks below. The outermost
+  *          section of a nesting, the one entered with the interrupts
+  *          enabled, is timed with the DWT cycle counter from its TX_DISABLE
+  *          to its TX_RESTORE, and charged to the address of its TX_DISABLE.
+  *          The IRQ_OFF_TRACE_SITES sites with the longest windows are kept,
+  *          each with its longest window, the interrupt it ran in and the
+  *          number of its windows, along with a log2 histogram of all the
+  *          windows. irq_off_trace_dump() prints them, longest first, the
+  *          addresses to be resolved with arm-none-eabi-addr2line -f -e on the
+  *          ELF file; irq_off_trace_reset() clears them. The sections of the
+  *          port assembly, the scheduler and the context save, and those of
+  *          the HAL are not timed. The hooks update the statistics before the
+  *          interrupts are enabled again: the windows measured exclude them,
+  *          the interrupt latency of this build does not. Without
+  *          TX_IRQ_OFF_TRACE the functions compile to nothing.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __IRQ_OFF_TRACE_H__
+#define __IRQ_OFF_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Sites of TX_DISABLE kept, those with the longest windows */
+#define IRQ_OFF_TRACE_SITES           16U
+
+/* Buckets of the histogram, the last one counts the windows of 2^(IRQ_OFF_TRACE_BUCKETS - 1) cycles or more */
+#define IRQ_OFF_TRACE_BUCKETS         16U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct IRQ_OFF_TRACE_SITE_STRUCT
+{
+  ULONG pc;                           /* Return address of the hook in the TX_DISABLE */
+  ULONG max_cycles;                   /* Longest window */
+  ULONG exception;                    /* IPSR of the longest window, 0 in a thread */
+  ULONG count;                        /* Windows timed since the site was kept */
+} IRQ_OFF_TRACE_SITE;
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef TX_IRQ_OFF_TRACE
+
+VOID irq_off_trace_init(VOID);
+VOID irq_off_trace_reset(VOID);
+UINT irq_off_trace_worst_get(IRQ_OFF_TRACE_SITE *site_ptr);
+VOID irq_off_trace_dump(VOID);
+
+#else
+
+#define irq_off_trace_init()
+#define irq_off_trace_reset()
+#define irq_off_trace_worst_get(site_ptr)  TX_FEATURE_NOT_ENABLED
+#define irq_off_trace_dump()
+
+#endif /* TX_IRQ_OFF_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __IRQ_OFF_TRACE_H__ */
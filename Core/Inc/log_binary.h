@@ -0,0 +1,104 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    log_binary.h
+  * @author  MCD Application Team
+  * @brief   Log records formatted on the host instead of the target
+  *
+  *          With LOG_BINARY_ENABLE defined below, LOG_PRINTF() does not format
+  *          its text: the format string is placed in the .log_strings section,
+  *          which the linker script keeps in the ELF file but not in the flash,
+  *          and only a record of the offset of the string and of the raw
+  *          arguments is queued to the log_uart ring, 4 bytes plus 4 bytes per
+  *          argument. Utilities/log_decode.py reads the format strings from the
+  *          ELF file and prints the text of the records, the plain printf()
+  *          output between them passes through unchanged. Records start with
+  *          the byte 0xFF, which ASCII text does not contain.
+  *          The arguments are 32-bit integers. A %s argument must be a string
+  *          constant of the image, the host reads it from the ELF file, and
+  *          the text pointed to by %.*s is not copied into the record either.
+  *          Without LOG_BINARY_ENABLE, LOG_PRINTF() is printf().
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_BINARY_H__
+#define __LOG_BINARY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include <stdio.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Binary log records instead of text, GCC only: decode them with Utilities/log_decode.py */
+/*
+#define LOG_BINARY_ENABLE
+*/
+
+/* First byte of a record, then the argument count and the 16-bit offset of the format string */
+#define LOG_BINARY_MARKER             0xFFU
+#define LOG_BINARY_HEADER_SIZE        4U
+
+/* Arguments of a record at most */
+#define LOG_BINARY_ARGS_MAX           8U
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef LOG_BINARY_ENABLE
+
+#if !defined(__GNUC__)
+#error "LOG_BINARY_ENABLE requires the .log_strings section of the GCC linker script"
+#endif
+
+#define LOG_PRINTF(format, ...)       do { \
+                                        static const CHAR log_binary_format[] \
+                                          __attribute__((section(".log_strings"))) = format; \
+                                        const ULONG log_binary_args[] = \
+                                          { 0U LOG_BINARY_CAST(LOG_BINARY_COUNT(__VA_ARGS__))(__VA_ARGS__) }; \
+                                        log_binary_write((ULONG)log_binary_format, &log_binary_args[1], \
+                                                         (sizeof(log_binary_args) / sizeof(ULONG)) - 1U); \
+                                      } while (0)
+
+/* Number of arguments, 0 to LOG_BINARY_ARGS_MAX */
+#define LOG_BINARY_COUNT(...)         LOG_BINARY_COUNT_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_BINARY_COUNT_(z, a, b, c, d, e, f, g, h, n, ...) n
+
+/* Arguments converted to ULONG, each after a comma */
+#define LOG_BINARY_CAST(n)            LOG_BINARY_CAST_(n)
+#define LOG_BINARY_CAST_(n)           LOG_BINARY_CAST_##n
+#define LOG_BINARY_CAST_0()
+#define LOG_BINARY_CAST_1(a)          , (ULONG)(a)
+#define LOG_BINARY_CAST_2(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_1(__VA_ARGS__)
+#define LOG_BINARY_CAST_3(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_2(__VA_ARGS__)
+#define LOG_BINARY_CAST_4(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_3(__VA_ARGS__)
+#define LOG_BINARY_CAST_5(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_4(__VA_ARGS__)
+#define LOG_BINARY_CAST_6(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_5(__VA_ARGS__)
+#define LOG_BINARY_CAST_7(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_6(__VA_ARGS__)
+#define LOG_BINARY_CAST_8(a, ...)     , (ULONG)(a) LOG_BINARY_CAST_7(__VA_ARGS__)
+
+/* Exported functions prototypes ---------------------------------------------*/
+VOID log_binary_write(ULONG format_address, const ULONG *args_ptr, UINT count);
+
+#else
+
+#define LOG_PRINTF(format, ...)       printf(format, ##__VA_ARGS__)
+
+#endif /* LOG_BINARY_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LOG_BINARY_H__ */
@@ -0,0 +1,59 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    log_uart.h
+  * @author  MCD Application Team
+  * @brief   Non-blocking printf output, sent over USART3 by DMA
+  *
+  *          printf() and the writes below copy the text into a ring buffer
+  *          of the main SRAM and return, so a thread no longer waits for the
+  *          serial line, about 87 us per character at 115200 baud. The USART3
+  *          TX DMA sends the ring from its interrupts: the half transfer
+  *          interrupt frees the first half of the block in progress, the
+  *          transmission complete interrupt frees the rest and starts the
+  *          next block. Threads and interrupts write without a lock: space is
+  *          reserved with LDREX/STREX, and the text is handed to the DMA when
+  *          the outermost of the nested writers returns, the writers of the
+  *          single core preempting each other without time slices. A write
+  *          that does not fit in the free space is dropped whole, so the lines
+  *          sent are never cut, and its bytes are counted.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_UART_H__
+#define __LOG_UART_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Size of the ring in bytes, a power of two, 2 KB is about 180 ms of output */
+#define LOG_UART_BUFFER_SIZE          2048U
+
+#if (LOG_UART_BUFFER_SIZE & (LOG_UART_BUFFER_SIZE - 1U)) != 0U
+#error "LOG_UART_BUFFER_SIZE must be a power of two"
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+ULONG log_uart_write(const CHAR *data_ptr, ULONG length);
+ULONG log_uart_dropped(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LOG_UART_H__ */
@@ -47,6 +47,17 @@ extern "C" {
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
+/* Memory placement attributes, see the linker script.
+   CCMRAM_BSS places zero initialized, CPU only data in the 64 KB CCM-RAM, off the
+   bus matrix shared with the Ethernet DMA. It must never hold DMA buffers.
+   DMA_RAM keeps DMA visible data at the start of the main SRAM. */
+#if defined ( __GNUC__ )
+#define CCMRAM_BSS    __attribute__((section(".ccmbss")))
+#define DMA_RAM       __attribute__((section(".dmabss")))
+#else
+#define CCMRAM_BSS
+#define DMA_RAM
+#endif
 
 /* USER CODE END EM */
 
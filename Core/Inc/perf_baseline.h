@@ -0,0 +1,36 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    perf_baseline.h
+  * @author  MCD Application Team
+  * @brief   Baselines of the performance harness
+  *
+  *          Generated by Utilities/perf_baseline.py from the PERF lines of
+  *          one or more runs of the harness build, the median of each
+  *          result; regenerate it when a change is meant to move a result.
+  *          Each entry is
+  *            ENTRY(suite, name, metric, value, threshold)
+  *          the threshold in percent, 0 for PERF_HARNESS_THRESHOLD_PERCENT.
+  *          A result without an entry is reported NEW and does not fail the
+  *          run, an entry without a result does.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERF_BASELINE_H__
+#define __PERF_BASELINE_H__
+
+/* Exported constants --------------------------------------------------------*/
+#define PERF_BASELINE_LIST(ENTRY)
+
+#endif /* __PERF_BASELINE_H__ */
@@ -0,0 +1,66 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    perf_harness.h
+  * @author  MCD Application Team
+  * @brief   Performance harness, the benchmarks compared with their baselines
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERF_HARNESS_H__
+#define __PERF_HARNESS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Defined, PERF_HARNESS runs the crypto, Thread-Metric, network, TLS and MQTT benchmarks in
+   turn, prints each result as a PERF line and compares it with its baseline of perf_baseline.h;
+   make PERF_HARNESS=1 defines it in a build of its own, with the benchmarks */
+/*
+#define PERF_HARNESS
+*/
+#define PERF_HARNESS_LOWER             0U   /* The result is better lower, a time or a cycle count */
+#define PERF_HARNESS_HIGHER            1U   /* The result is better higher, a rate */
+#define PERF_HARNESS_THRESHOLD_PERCENT 5U   /* Regression allowed by the baselines that give none */
+
+/* Identifies the build in each line, the make target sets it to the description of the commit */
+#ifndef PERF_HARNESS_BUILD_ID
+#define PERF_HARNESS_BUILD_ID          __DATE__ " " __TIME__
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef PERF_HARNESS
+/* Prints the header of the run, before the first suite. */
+VOID perf_harness_start(VOID);
+/* Prints a result of a suite and compares it with its baseline, the name formatted as printf()
+   does. */
+VOID perf_harness_result(const CHAR *suite, const CHAR *metric, ULONG value, UINT direction,
+                         const CHAR *name_format, ...);
+/* Prints the status of a suite, an error fails the run. */
+VOID perf_harness_suite_end(const CHAR *suite, UINT status);
+/* Prints the baselines not measured and the summary, TX_NOT_DONE if the run failed. */
+UINT perf_harness_end(VOID);
+#else
+#define perf_harness_result(...)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PERF_HARNESS_H__ */
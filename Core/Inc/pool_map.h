@@ -0,0 +1,94 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pool_map.h
+  * @author  MCD Application Team
+  * @brief   Map of the blocks of the ThreadX byte pools, with their owners
+  *
+  *          With POOL_MAP defined in the Makefile, pool_map_dump() walks the
+  *          block list of every byte pool created, the TX_BYTE_POOL given to
+  *          App_ThreadX_Init() and MX_NetXDuo_Init() included, and prints each
+  *          block: its offset in the pool, its size, whether it is free, and
+  *          for an allocated block the alignment of its memory and its owner.
+  *          The owner is the tag and the thread given by pool_map_allocate(),
+  *          or the thread whose stack the block holds. The totals follow: the
+  *          bytes allocated and free, the free fragments and the largest one,
+  *          that is the largest allocation that can succeed whatever the free
+  *          bytes. pool_map_info_get() gives the same totals to the code that
+  *          decides whether an allocation may be tried. The list is walked
+  *          with the interrupts disabled, the pools change under them only,
+  *          and each link is checked to stay ahead of the previous one and
+  *          within the pool, so that a corrupted pool ends the walk instead of
+  *          faulting. With POOL_MAP_TRACE as well, pool_map_allocate() and
+  *          pool_map_release() keep their last POOL_MAP_TRACE_ENTRIES calls,
+  *          printed by the next dump. Without POOL_MAP, pool_map_allocate()
+  *          and pool_map_release() are tx_byte_allocate() and
+  *          tx_byte_release(), the other functions compile to nothing.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __POOL_MAP_H__
+#define __POOL_MAP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Blocks of a pool printed by a dump, the others only counted in the totals */
+#define POOL_MAP_BLOCKS               64U
+
+/* Calls of pool_map_allocate() and pool_map_release() kept between two dumps */
+#define POOL_MAP_TRACE_ENTRIES        32U
+
+/* Bytes taken ahead of the memory of pool_map_allocate() for its owner, a multiple of 8 */
+#define POOL_MAP_TAG_SIZE             16U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct POOL_MAP_INFO_STRUCT
+{
+  ULONG allocated_blocks;
+  ULONG allocated_bytes;              /* Block headers included */
+  ULONG free_blocks;                  /* The fragments of the free bytes */
+  ULONG free_bytes;
+  ULONG largest_free;                 /* Largest allocation that succeeds */
+  UINT  corrupted;                    /* The walk stopped on a link out of the pool */
+} POOL_MAP_INFO;
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef POOL_MAP
+
+UINT pool_map_allocate(TX_BYTE_POOL *pool_ptr, VOID **memory_ptr, ULONG memory_size, ULONG wait_option,
+                       const CHAR *tag);
+UINT pool_map_release(VOID *memory_ptr);
+UINT pool_map_info_get(TX_BYTE_POOL *pool_ptr, POOL_MAP_INFO *info_ptr);
+VOID pool_map_dump(VOID);
+
+#else
+
+#define pool_map_allocate(pool_ptr, memory_ptr, memory_size, wait_option, tag) \
+  tx_byte_allocate((pool_ptr), (memory_ptr), (memory_size), (wait_option))
+#define pool_map_release(memory_ptr)  tx_byte_release(memory_ptr)
+#define pool_map_info_get(pool_ptr, info_ptr) TX_FEATURE_NOT_ENABLED
+#define pool_map_dump()
+
+#endif /* POOL_MAP */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __POOL_MAP_H__ */
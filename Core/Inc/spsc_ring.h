@@ -0,0 +1,67 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    spsc_ring.h
+  * @author  MCD Application Team
+  * @brief   Single producer, single consumer ring of fixed-size messages
+  *
+  *          An interrupt hands messages to one thread without disabling
+  *          interrupts: the producer only writes the head index and the
+  *          consumer only writes the tail index, so neither needs a lock.
+  *          Messages are 1 to 16 ULONG words, as for tx_queue_send().
+  *          The consumer thread may optionally wait on event flags, which are
+  *          only set when a message is put into an empty ring.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct SPSC_RING_STRUCT
+{
+  /* Storage of the messages, message_size words per message. */
+  ULONG *spsc_ring_start;
+  ULONG spsc_ring_message_size;
+
+  /* Number of messages of the storage, a power of two. */
+  ULONG spsc_ring_capacity;
+
+  /* Free running indexes, the head is written by the producer only
+     and the tail by the consumer only. */
+  volatile ULONG spsc_ring_head;
+  volatile ULONG spsc_ring_tail;
+
+  /* Optional event flags set when the ring goes from empty to not empty. */
+  TX_EVENT_FLAGS_GROUP *spsc_ring_notify_group;
+  ULONG spsc_ring_notify_flags;
+} SPSC_RING;
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT spsc_ring_create(SPSC_RING *ring, UINT message_size, VOID *start, ULONG size);
+VOID spsc_ring_notify_set(SPSC_RING *ring, TX_EVENT_FLAGS_GROUP *group, ULONG flags);
+UINT spsc_ring_send(SPSC_RING *ring, VOID *source);
+UINT spsc_ring_receive(SPSC_RING *ring, VOID *destination, ULONG wait_option);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SPSC_RING_H__ */
@@ -52,8 +52,10 @@ void MemManage_Handler(void);
 void BusFault_Handler(void);
 void UsageFault_Handler(void);
 void DebugMon_Handler(void);
-void TIM6_DAC_IRQHandler(void);
+void DMA1_Stream3_IRQHandler(void);
+void USART3_IRQHandler(void);
 void ETH_IRQHandler(void);
+void HASH_RNG_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
@@ -0,0 +1,55 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_metric.h
+  * @author  MCD Application Team
+  * @brief   Thread-Metric measurement of the kernel services, as configured
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __THREAD_METRIC_H__
+#define __THREAD_METRIC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Defined, THREAD_METRIC runs the Thread-Metric tests in place of the demo, the network is not
+   started; make THREAD_METRIC=1 defines it in a build of its own */
+/*
+#define THREAD_METRIC
+*/
+#define THREAD_METRIC_PERIOD          (10U * TX_TIMER_TICKS_PER_SECOND) /* Length of each test, 30 s in the original suite */
+#define THREAD_METRIC_REPORT_PRIORITY 1U                    /* Above the tests, under the timer thread */
+#define THREAD_METRIC_PRIORITY        10U                   /* Lowest priority of the test threads, minus 4 the highest */
+#define THREAD_METRIC_STACK_SIZE      1024U                 /* Stack of each test thread */
+#define THREAD_METRIC_IRQn            TIM7_IRQn             /* Unused vector, pended by the interrupt tests */
+#define THREAD_METRIC_IRQ_PRIORITY    12U                   /* Under the peripheral interrupts of the application */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Creates the thread that runs the tests and reports them over the UART, from
+   tx_application_define(). */
+UINT thread_metric_start(VOID);
+/* Runs the tests from the calling thread and reports them, the performance
+   harness does so with the network started. */
+UINT thread_metric_run(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __THREAD_METRIC_H__ */
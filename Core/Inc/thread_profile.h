@@ -0,0 +1,85 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_profile.h
+  * @author  MCD Application Team
+  * @brief   CPU time of the threads and interrupts, and stack usage of the threads
+  *
+  *          With TX_EXECUTION_PROFILE_ENABLE defined in the Makefile, the port
+  *          scheduler calls the thread enter and exit hooks below at each
+  *          context switch, and the interrupt handlers call the ISR hooks.
+  *          Each hook charges the DWT cycles elapsed since the previous one to
+  *          the thread, the interrupt or the idle loop that ran meanwhile, so
+  *          the times exclude the interrupts they were preempted by.
+  *          thread_profile_dump() prints the CPU share of each over the time
+  *          since the previous dump, the context switch rate and the stack
+  *          high-water mark of each thread, thread_profile_busy_cycles() the
+  *          cycles of the threads and interrupts for the clock governor.
+  *          Without TX_EXECUTION_PROFILE_ENABLE the macros and the functions
+  *          compile to nothing, except
+          thread_profile_stack_used(), read by the device statistics too.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __THREAD_PROFILE_H__
+#define __THREAD_PROFILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Period of the report of the profile work item, in ticks */
+#define THREAD_PROFILE_REPORT_PERIOD  (10U * TX_TIMER_TICKS_PER_SECOND)
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+/* Bracket the body of the interrupt handlers written in C, the SysTick handler
+   of tx_initialize_low_level.s calls the hooks itself. */
+#define THREAD_PROFILE_ISR_ENTER()    _tx_execution_isr_enter()
+#define THREAD_PROFILE_ISR_EXIT()     _tx_execution_isr_exit()
+
+/* Exported functions prototypes ---------------------------------------------*/
+VOID thread_profile_init(VOID);
+VOID thread_profile_dump(VOID);
+ULONG thread_profile_busy_cycles(VOID);
+
+/* Hooks of the port, see tx_thread_schedule.s */
+VOID _tx_execution_thread_enter(VOID);
+VOID _tx_execution_thread_exit(VOID);
+VOID _tx_execution_isr_enter(VOID);
+VOID _tx_execution_isr_exit(VOID);
+
+#else
+
+#define THREAD_PROFILE_ISR_ENTER()
+#define THREAD_PROFILE_ISR_EXIT()
+
+#define thread_profile_init()
+#define thread_profile_dump()
+#define thread_profile_busy_cycles()  0U
+
+#endif /* TX_EXECUTION_PROFILE_ENABLE */
+
+/* Stack high-water mark of a thread, called with the interrupts disabled */
+ULONG thread_profile_stack_used(TX_THREAD *thread_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __THREAD_PROFILE_H__ */
@@ -0,0 +1,77 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    trace_swo.h
+  * @author  MCD Application Team
+  * @brief   ThreadX event trace streamed over the ITM/SWO debug output
+  *
+  *          With TX_ENABLE_EVENT_TRACE defined in tx_user.h, ThreadX and NetX
+  *          record their events into the trace buffer, and the application
+  *          events below are added with TRACE_SWO_EVENT(). A thread of the
+  *          lowest priority sends the new entries of the buffer over the ITM
+  *          stimulus port TRACE_SWO_PORT while a debug probe listens on SWO,
+  *          so the system is traced live, without being halted. The writers
+  *          of the events never wait for the port, only the trace thread does.
+  *          The stream is the trace control header and the object registry,
+  *          starting with the "TXTB" word, sent again every second so that a
+  *          probe attached later finds the objects, and in between the 32-byte
+  *          entries of the buffer in the order of their insertion. Entries are
+  *          lost, not delayed, when the buffer wraps around before being sent.
+  *          Without TX_ENABLE_EVENT_TRACE the macros compile to nothing.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TRACE_SWO_H__
+#define __TRACE_SWO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* ITM stimulus port of the trace, port 0 is left to the console */
+#define TRACE_SWO_PORT                1U
+
+/* Application events, next to the ThreadX and NetX events of the trace */
+#define TRACE_SWO_EVENT_ETH_RECEIVE   (TX_TRACE_USER_EVENT_START + 0)   /* I1 = packet ptr, I2 = frame length               */
+#define TRACE_SWO_EVENT_ETH_SEND      (TX_TRACE_USER_EVENT_START + 1)   /* I1 = packet ptr, I2 = frame length               */
+#define TRACE_SWO_EVENT_ETH_SENT      (TX_TRACE_USER_EVENT_START + 2)   /* I1 = packet ptr, its frame left the MAC          */
+#define TRACE_SWO_EVENT_TLS_ENCRYPT   (TX_TRACE_USER_EVENT_START + 3)   /* I1 = session ptr, I2 = packet ptr, I3 = length, I4 = record type */
+#define TRACE_SWO_EVENT_TLS_DECRYPT   (TX_TRACE_USER_EVENT_START + 4)   /* I1 = session ptr, I2 = packet ptr, I3 = length, I4 = record type */
+#define TRACE_SWO_EVENT_MQTT_PUBLISH  (TX_TRACE_USER_EVENT_START + 5)   /* I1 = client ptr, I2 = packet id, I3 = QoS, I4 = length */
+#define TRACE_SWO_EVENT_MQTT_ACK      (TX_TRACE_USER_EVENT_START + 6)   /* I1 = client ptr, I2 = packet id, I3 = packet type */
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef TX_ENABLE_EVENT_TRACE
+
+#define TRACE_SWO_EVENT(e, a, b, c, d) tx_trace_user_event_insert((ULONG)(e), (ULONG)(a), (ULONG)(b), (ULONG)(c), (ULONG)(d));
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT trace_swo_init(VOID);
+
+#else
+
+#define TRACE_SWO_EVENT(e, a, b, c, d)
+
+#define trace_swo_init()              TX_SUCCESS
+
+#endif /* TX_ENABLE_EVENT_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TRACE_SWO_H__ */
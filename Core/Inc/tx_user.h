@@ -91,6 +91,13 @@
 
 /*#define TX_MINIMUM_STACK                200*/
 
+/* Define the number of entries in the timer list, one per tick. Timers set further out than the
+   list pass through it again every TX_TIMER_ENTRIES ticks until they expire. With 128 entries at
+   100 ticks per second, a timeout of up to 1.28 seconds is inserted once and expires without a
+   pass, and a 60 second MQTT keep alive takes 46 passes instead of 187.  */
+
+#define TX_TIMER_ENTRIES                ((ULONG) 128)
+
 /* Determine if timer expirations (application timers, timeouts, and tx_thread_sleep calls
    should be processed within the a system timer thread or directly in the timer ISR.
    By default, the timer thread is used. When the following is defined, the timer expiration
@@ -164,7 +171,8 @@
 
 /* Determine if the trace event logging code should be enabled. This causes slight increases in
    code size and overhead, but provides the ability to generate system trace information which
-   is available for viewing in TraceX.  */
+   is available for viewing in TraceX. trace_swo.c then streams the trace over SWO, with the
+   Ethernet, TLS and MQTT events of trace_swo.h.  */
 
 /*#define TX_ENABLE_EVENT_TRACE*/
 
@@ -178,6 +186,12 @@
 
 /*#define TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO*/
 
+/* Determine if the byte pools use segregated free lists (TLSF) instead of the first-fit search. When
+   the following is defined, tx_byte_allocate and tx_byte_release take constant time whatever the
+   fragmentation of the pool, for about 580 bytes of free list heads taken from the start of each pool. */
+
+#define TX_BYTE_POOL_ENABLE_TLSF
+
 /* Determine if event flags performance gathering is required by the application. When the following is
    defined, ThreadX gathers various event flags performance information. */
 
@@ -212,6 +226,10 @@
 
 /*#define TX_ENABLE_EXECUTION_CHANGE_NOTIFY*/
 
+/* TX_EXECUTION_PROFILE_ENABLE, the Azure RTOS 6 replacement of TX_ENABLE_EXECUTION_CHANGE_NOTIFY that adds the
+   execution time to the thread control block, is defined on the compiler command line, since the port scheduler
+   calling its hooks does not include this file. The hooks are in thread_profile.c. */
+
 /* Define the get system state macro. */
 
 /*#define TX_THREAD_GET_SYSTEM_STATE() _tx_thread_system_state */
@@ -225,6 +243,32 @@
 
 /*#define TX_TIMER_TICKS_PER_SECOND                100*/
 
+/* Define the low power hooks called by tx_low_power_enter and tx_low_power_exit. TX_LOW_POWER
+   itself is defined on the compiler command line, since the idle loop of the port scheduler in
+   tx_thread_schedule.s does not include this file. While no thread is ready, SysTick is stretched
+   up to the tick of the next timer expiration, the core waits in SLEEP mode (TX_ENABLE_WFI), and
+   the ticks elapsed are added back on wake. The HAL time base follows the ThreadX tick and has
+   no interrupt of its own to stop meanwhile.  */
+
+#ifdef TX_LOW_POWER
+void          App_ThreadX_LowPower_Timer_Setup(unsigned long count);
+unsigned long App_ThreadX_LowPower_Timer_Adjust(void);
+
+#define TX_LOW_POWER_TIMER_SETUP(_count)            App_ThreadX_LowPower_Timer_Setup(_count)
+#define TX_LOW_POWER_USER_TIMER_ADJUST              App_ThreadX_LowPower_Timer_Adjust()
+#endif
+
+/* Define the per-thread FPU policy. TX_THREAD_FPU_POLICY is defined on the compiler command line,
+   since the PendSV handler in tx_thread_schedule.s does not include this file. A thread may use
+   the FPU only once App_ThreadX_FPU_Enable() designated it, before it starts; the PendSV handler
+   grants CP10 and CP11 to the thread it switches to by App_ThreadX_FPU_Switch(). The others keep
+   CONTROL.FPCA clear and always switch with the basic frame, an FP instruction of theirs raises
+   a NOCP UsageFault instead of making their frames extended from then on.  */
+
+#ifdef TX_THREAD_FPU_POLICY
+#define TX_THREAD_USER_EXTENSION                    unsigned int tx_thread_fpu_allowed;
+#endif
+
 /* Determinate if the basic alignment type is defined. */
 
 /*#define ALIGN_TYPE_DEFINED*/
@@ -0,0 +1,85 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    work_queue.h
+  * @author  MCD Application Team
+  * @brief   Work items run one after the other by the thread of a work queue
+  *
+  *          A work queue is one thread running the work items submitted to
+  *          it, in the order they were submitted, in place of a thread per
+  *          task that spends its life waiting. An item is submitted to run
+  *          as soon as the thread gets to it, or scheduled to run after a
+  *          delay, once or every period. The delayed items are kept by
+  *          expiry; the thread sleeps until the first one is due or an
+  *          item is submitted, no timer ticks it meanwhile. Items are
+  *          submitted, scheduled and cancelled from threads and interrupts;
+  *          an item already waiting to run is not queued twice. A handler
+  *          runs on the stack of the queue and must not block, it schedules
+  *          itself again instead of waiting; it may submit, schedule or
+  *          cancel any item, itself included. A periodic item runs again a
+  *          period after its last expiry, the runs missed by a late thread
+  *          are skipped.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __WORK_QUEUE_H__
+#define __WORK_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct WORK_ITEM_STRUCT
+{
+  /* Run by the thread of the queue, with the item. */
+  VOID (*work_item_handler)(struct WORK_ITEM_STRUCT *item);
+  VOID *work_item_context;
+
+  /* Set by the work queue. */
+  struct WORK_ITEM_STRUCT *work_item_next;
+  ULONG work_item_expiry;           /* Tick a delayed item is due at       */
+  ULONG work_item_period;           /* Ticks between the runs, 0 for once  */
+  UINT  work_item_state;
+} WORK_ITEM;
+
+typedef struct WORK_QUEUE_STRUCT
+{
+  TX_THREAD work_queue_thread;
+
+  /* Set when an item is ready or the first delayed one changes. */
+  TX_EVENT_FLAGS_GROUP work_queue_events;
+
+  /* Items to run now, in the order they were submitted. */
+  WORK_ITEM *work_queue_ready_head;
+  WORK_ITEM *work_queue_ready_tail;
+
+  /* Items to run later, the first due first. */
+  WORK_ITEM *work_queue_delayed;
+} WORK_QUEUE;
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT work_queue_create(WORK_QUEUE *queue, CHAR *name, VOID *stack, ULONG stack_size, UINT priority);
+VOID work_item_init(WORK_ITEM *item, VOID (*handler)(WORK_ITEM *), VOID *context);
+VOID work_item_submit(WORK_QUEUE *queue, WORK_ITEM *item);
+VOID work_item_schedule(WORK_QUEUE *queue, WORK_ITEM *item, ULONG delay, ULONG period);
+VOID work_item_cancel(WORK_QUEUE *queue, WORK_ITEM *item);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __WORK_QUEUE_H__ */
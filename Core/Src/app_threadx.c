@@ -23,6 +23,12 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "main.h"
+#include "thread_profile.h"
+#include "boot_profile.h"
+#include "trace_swo.h"
+#include "irq_off_trace.h"
+#include "thread_metric.h"
 
 /* USER CODE END Includes */
 
@@ -33,6 +39,20 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#ifdef TX_LOW_POWER
+/* SysTick runs from HCLK/8 with TX_LOW_POWER, see tx_initialize_low_level.s */
+#define LOW_POWER_TICK_CYCLES         (SystemCoreClock / 8U / TX_TIMER_TICKS_PER_SECOND)
+#define TICK_CYCLES                   LOW_POWER_TICK_CYCLES
+#define TICK_CLKSOURCE                0U
+#else
+#define TICK_CYCLES                   (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND)
+#define TICK_CLKSOURCE                SysTick_CTRL_CLKSOURCE_Msk
+#endif
+
+#ifdef TX_THREAD_FPU_POLICY
+/* CP10 and CP11 full access, as granted by SystemInit() */
+#define FPU_CPACR_FULL_ACCESS         ((3UL << 10U * 2U) | (3UL << 11U * 2U))
+#endif
 
 /* USER CODE END PD */
 
@@ -43,11 +63,18 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
+#ifdef TX_LOW_POWER
+/* Ticks the SysTick period is stretched to, zero while it runs the normal tick */
+static ULONG low_power_ticks;
+#endif
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
+#if defined(TX_LOW_POWER) || defined(CLOCK_GOVERNOR)
+static void Tick_Start(uint32_t reload);
+#endif
 
 /* USER CODE END PFP */
 
@@ -63,6 +90,25 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
 
   /* USER CODE BEGIN App_ThreadX_Init */
   (void)byte_pool;
+
+  boot_profile_mark(BOOT_PROFILE_KERNEL);
+
+  /* Account the CPU time of the threads from their first run. */
+  thread_profile_init();
+
+  /* Time the critical sections from now on. */
+  irq_off_trace_init();
+
+  /* Trace the events of the objects created from now on. */
+  ret = trace_swo_init();
+
+#ifdef THREAD_METRIC
+  /* Measure the kernel services in place of the demo. */
+  if (ret == TX_SUCCESS)
+  {
+    ret = thread_metric_start();
+  }
+#endif
   /* USER CODE END App_ThreadX_Init */
 
   return ret;
@@ -87,5 +133,188 @@ void MX_ThreadX_Init(void)
 }
 
 /* USER CODE BEGIN 1 */
+#ifdef TX_LOW_POWER
+/**
+  * @brief  Stretches the SysTick period up to the tick of the next timer expiration.
+  * @param  count: ticks to the next timer expiration
+  * @retval None
+  */
+void App_ThreadX_LowPower_Timer_Setup(ULONG count)
+{
+  uint32_t cycles = LOW_POWER_TICK_CYCLES;
+  uint32_t remaining;
+
+  low_power_ticks = 0U;
+
+  /* Stop the counter within the current tick */
+  SysTick->CTRL = SysTick_CTRL_TICKINT_Msk;
+  remaining = SysTick->VAL;
+
+  /* Leave the tick alone when it is already due */
+  if ((remaining == 0U) || ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U))
+  {
+    SysTick->CTRL = SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    return;
+  }
+
+  /* The 24-bit counter bounds the sleep */
+  if (count > ((SysTick_LOAD_RELOAD_Msk + 1U) / cycles))
+  {
+    count = (SysTick_LOAD_RELOAD_Msk + 1U) / cycles;
+  }
+
+  /* Count the rest of the current tick, then the whole ticks up to the expiration */
+  Tick_Start(remaining + ((count - 1U) * cycles) - 1U);
+  low_power_ticks = count;
+}
+
+/**
+  * @brief  Restores the SysTick period once the core is woken.
+  * @param  None
+  * @retval Ticks elapsed, less the tick whose interrupt is pending
+  */
+ULONG App_ThreadX_LowPower_Timer_Adjust(void)
+{
+  uint32_t cycles = LOW_POWER_TICK_CYCLES;
+  uint32_t left;
+  ULONG elapsed;
+
+  if (low_power_ticks == 0U)
+  {
+    return 0U;
+  }
+
+  SysTick->CTRL = SysTick_CTRL_TICKINT_Msk;
+  left = SysTick->VAL;
+
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+  {
+    /* The stretched period ended, its interrupt processes the last tick */
+    elapsed = low_power_ticks - 1U;
+    left = cycles;
+  }
+  else
+  {
+    /* Woken early: count the tick boundaries passed and keep the phase of the next one */
+    if (left == 0U)
+    {
+      left = 1U;
+    }
+    elapsed = low_power_ticks - ((left + cycles - 1U) / cycles);
+    left -= ((left - 1U) / cycles) * cycles;
+  }
+
+  low_power_ticks = 0U;
+
+  /* Finish the current tick, then reload the normal period */
+  Tick_Start(left - 1U);
+  SysTick->LOAD = cycles - 1U;
+
+  return elapsed;
+}
+#endif
+
+#ifdef CLOCK_GOVERNOR
+/**
+  * @brief  Keeps the tick period, and the phase of the current tick, once HCLK changed. Called
+  *         with the interrupts disabled, SystemCoreClock holding the new HCLK already.
+  * @param  old_hclk: HCLK the SysTick counted at until now
+  * @retval None
+  */
+void App_ThreadX_Tick_Rescale(ULONG old_hclk)
+{
+  uint32_t cycles = TICK_CYCLES;
+  uint32_t left;
+
+  /* Stop the counter within the current tick */
+  SysTick->CTRL = TICK_CLKSOURCE | SysTick_CTRL_TICKINT_Msk;
+  left = SysTick->VAL;
+
+  if ((left == 0U) || ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U))
+  {
+    /* The tick is due, its interrupt stays pending: the next one is a whole period away */
+    left = cycles;
+  }
+  else
+  {
+    left = (uint32_t)(((uint64_t)left * SystemCoreClock) / old_hclk);
+    if (left == 0U)
+    {
+      left = 1U;
+    }
+  }
+
+  /* Finish the current tick at the new clock, then reload the new period */
+  Tick_Start(left - 1U);
+  SysTick->LOAD = cycles - 1U;
+}
+#endif
+
+#if defined(TX_LOW_POWER) || defined(CLOCK_GOVERNOR)
+/**
+  * @brief  Restarts SysTick from the given reload value.
+  * @param  reload: reload value of the first period
+  * @retval None
+  */
+static void Tick_Start(uint32_t reload)
+{
+  /* A zero reload value would stop the counter */
+  if (reload == 0U)
+  {
+    reload = 1U;
+  }
+
+  SysTick->LOAD = reload;
+  SysTick->VAL = 0U;
+
+  /* Count once from the core clock so the reload is taken now rather than on the next HCLK/8 edge */
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+  SysTick->CTRL = TICK_CLKSOURCE | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+#endif
+
+/**
+  * @brief  Designates a thread that uses the FPU, to be called before it starts: create it
+  *         with TX_DONT_START, then resume it. The other threads switch with integer only frames.
+  * @param  thread_ptr: thread to designate
+  * @retval None
+  */
+void App_ThreadX_FPU_Enable(TX_THREAD *thread_ptr)
+{
+#ifdef TX_THREAD_FPU_POLICY
+  thread_ptr->tx_thread_fpu_allowed = TX_TRUE;
+#else
+  /* Every thread may use the FPU, the lazy stacking saves those that did */
+  (void)thread_ptr;
+#endif
+}
+
+#ifdef TX_THREAD_FPU_POLICY
+/**
+  * @brief  Grants CP10 and CP11 to the thread the PendSV handler switches to, if designated.
+  * @note   Called from tx_thread_schedule.s before the VFP registers of the thread are
+  *         restored: the access must be set when the saved FP context is read back.
+  * @param  thread_ptr: thread switched to
+  * @retval None
+  */
+void App_ThreadX_FPU_Switch(TX_THREAD *thread_ptr)
+{
+  uint32_t cpacr = SCB->CPACR;
+  uint32_t access = cpacr & ~FPU_CPACR_FULL_ACCESS;
+
+  if (thread_ptr->tx_thread_fpu_allowed)
+  {
+    access |= FPU_CPACR_FULL_ACCESS;
+  }
+
+  /* Most switches are between threads of the same kind */
+  if (access != cpacr)
+  {
+    SCB->CPACR = access;
+    __DSB();
+    __ISB();
+  }
+}
+#endif
 
 /* USER CODE END 1 */
@@ -0,0 +1,128 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    block_channel.c
+  * @author  MCD Application Team
+  * @brief   Zero-copy channel of blocks between a producer and a consumer
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "block_channel.h"
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Create a channel, its pool in the first storage and its queue in the second one.
+* @param  channel: channel control block
+* @param  name: name of the pool and of the queue
+* @param  block_size: size of a block in bytes
+* @param  pool_start: storage of the pool, see BLOCK_CHANNEL_POOL_SIZE()
+* @param  pool_size: size of the storage of the pool in bytes
+* @param  queue_start: storage of the queue, see BLOCK_CHANNEL_QUEUE_SIZE()
+* @param  queue_size: size of the storage of the queue in bytes
+* @retval TX_SUCCESS, the error of the pool or queue creation, or TX_SIZE_ERROR when the queue
+*         cannot hold every block of the pool
+*/
+UINT block_channel_create(BLOCK_CHANNEL *channel, CHAR *name, ULONG block_size,
+                          VOID *pool_start, ULONG pool_size, VOID *queue_start, ULONG queue_size)
+{
+  UINT ret;
+
+  ret = tx_block_pool_create(&channel -> block_channel_pool, name, block_size, pool_start, pool_size);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* A committed block always finds its entry. */
+  if ((queue_size / BLOCK_CHANNEL_QUEUE_SIZE(1U)) < channel -> block_channel_pool.tx_block_pool_total)
+  {
+    tx_block_pool_delete(&channel -> block_channel_pool);
+    return TX_SIZE_ERROR;
+  }
+
+  ret = tx_queue_create(&channel -> block_channel_queue, name, TX_2_ULONG, queue_start, queue_size);
+  if (ret != TX_SUCCESS)
+  {
+    tx_block_pool_delete(&channel -> block_channel_pool);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Take a free block to fill, called by the producer.
+* @param  channel: channel control block
+* @param  block_ptr: block reserved, to commit or release
+* @param  wait_option: ticks to wait for a free block, TX_NO_WAIT from an interrupt
+* @retval TX_SUCCESS, or the error of tx_block_allocate(), TX_NO_MEMORY when all the blocks are
+*         reserved or not released yet
+*/
+UINT block_channel_reserve(BLOCK_CHANNEL *channel, VOID **block_ptr, ULONG wait_option)
+{
+  return tx_block_allocate(&channel -> block_channel_pool, block_ptr, wait_option);
+}
+
+/**
+* @brief  Hand a block filled to the consumer, it is not accessed by the producer any more.
+* @param  channel: channel control block
+* @param  block_ptr: block of block_channel_reserve()
+* @param  length: bytes filled, from the start of the block
+* @retval TX_SUCCESS
+*/
+UINT block_channel_commit(BLOCK_CHANNEL *channel, VOID *block_ptr, ULONG length)
+{
+  ULONG entry[2];
+
+  entry[0] = (ULONG) block_ptr;
+  entry[1] = length;
+
+  /* As many entries as blocks, the queue is never full. */
+  return tx_queue_send(&channel -> block_channel_queue, entry, TX_NO_WAIT);
+}
+
+/**
+* @brief  Take the oldest block committed, called by the consumer.
+* @param  channel: channel control block
+* @param  block_ptr: block received, to release once used
+* @param  length_ptr: bytes filled by the producer
+* @param  wait_option: ticks to wait for a block, TX_NO_WAIT or TX_WAIT_FOREVER
+* @retval TX_SUCCESS or TX_QUEUE_EMPTY
+*/
+UINT block_channel_receive(BLOCK_CHANNEL *channel, VOID **block_ptr, ULONG *length_ptr, ULONG wait_option)
+{
+  ULONG entry[2];
+  UINT ret;
+
+  ret = tx_queue_receive(&channel -> block_channel_queue, entry, wait_option);
+  if (ret == TX_SUCCESS)
+  {
+    *block_ptr = (VOID *) entry[0];
+    *length_ptr = entry[1];
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Give a block back to the pool: by the consumer once used, or by the producer in place of
+*         the commit, to drop what it reserved.
+* @param  block_ptr: block received or reserved
+* @retval TX_SUCCESS or TX_PTR_ERROR
+*/
+UINT block_channel_release(VOID *block_ptr)
+{
+  return tx_block_release(block_ptr);
+}
@@ -0,0 +1,172 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    boot_profile.c
+  * @author  MCD Application Team
+  * @brief   Time stamps of the boot phases, from main() to the MQTT connection
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_profile.h"
+#include "main.h"
+#include <stdio.h>
+
+/* Private define ------------------------------------------------------------*/
+/* DWT cycle counter */
+#define BOOT_PROFILE_COUNTER          (DWT -> CYCCNT)
+
+/* The counter wraps after 23.8 s at 180 MHz, a phase reached later than this after
+   the clocks is timed with the 1 ms HAL tick instead. */
+#define BOOT_PROFILE_CYCLES_SPAN      20000U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct BOOT_PROFILE_MARK_STRUCT
+{
+  ULONG cycles;
+  ULONG tick;
+  UINT  reached;
+} BOOT_PROFILE_MARK;
+
+/* Private variables ---------------------------------------------------------*/
+static BOOT_PROFILE_MARK boot_profile_marks[BOOT_PROFILE_PHASES];
+
+/* Core clock up to BOOT_PROFILE_CLOCKS, the HSI SystemInit() leaves it at. */
+static ULONG boot_profile_start_clock;
+
+/* The sleep of the idle loop stopped the core clock before boot_profile_init(). */
+static UINT boot_profile_sleep_stops_clock;
+
+static UINT boot_profile_reported;
+
+static const CHAR *const boot_profile_names[BOOT_PROFILE_PHASES] =
+{
+  "HAL and clocks",
+  "peripherals",
+  "kernel",
+  "NetX init",
+  "TLS ready",
+  "link up",
+  "DHCP bound",
+  "DNS resolved",
+  "MQTT connected",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static ULONG boot_profile_elapsed(const BOOT_PROFILE_MARK *mark_ptr);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the DWT cycle counter from zero and keep the core clock running in sleep until the report.
+*         Called first in main(), before any other user of the counter.
+* @param  None
+* @retval None
+*/
+VOID boot_profile_init(VOID)
+{
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  BOOT_PROFILE_COUNTER = 0U;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  boot_profile_start_clock = SystemCoreClock;
+
+  /* A debugger may have set it already, it is left to it then. */
+  boot_profile_sleep_stops_clock = ((DBGMCU -> CR & DBGMCU_CR_DBG_SLEEP) == 0U);
+  DBGMCU -> CR |= DBGMCU_CR_DBG_SLEEP;
+}
+
+/**
+* @brief  Stamp a boot phase, the first time it is reached only.
+* @param  phase: BOOT_PROFILE_CLOCKS ... BOOT_PROFILE_MQTT
+* @retval None
+*/
+VOID boot_profile_mark(UINT phase)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if ((phase < BOOT_PROFILE_PHASES) && !boot_profile_marks[phase].reached)
+  {
+    boot_profile_marks[phase].cycles = BOOT_PROFILE_COUNTER;
+    boot_profile_marks[phase].tick = HAL_GetTick();
+    boot_profile_marks[phase].reached = 1U;
+  }
+  TX_RESTORE
+}
+
+/**
+* @brief  Print the time of each phase since main() on the first call, and let the core clock stop in sleep again.
+* @param  None
+* @retval None
+*/
+VOID boot_profile_report(VOID)
+{
+  ULONG elapsed;
+  UINT phase;
+
+  if (boot_profile_reported)
+  {
+    return;
+  }
+  boot_profile_reported = 1U;
+
+  if (boot_profile_sleep_stops_clock)
+  {
+    DBGMCU -> CR &= ~DBGMCU_CR_DBG_SLEEP;
+  }
+
+  printf("Boot profile, time since main():\n");
+  for (phase = 0U; phase < BOOT_PROFILE_PHASES; phase++)
+  {
+    if (!boot_profile_marks[phase].reached)
+    {
+      printf("  %-16s        -\n", boot_profile_names[phase]);
+      continue;
+    }
+
+    elapsed = boot_profile_elapsed(&boot_profile_marks[phase]);
+    printf("  %-16s %5lu.%03lu ms\n", boot_profile_names[phase], elapsed / 1000U, elapsed % 1000U);
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Time of a mark since main(), the cycles up to the clock setup are counted at the HSI frequency.
+* @param  mark_ptr: reached mark
+* @retval Time in us
+*/
+static ULONG boot_profile_elapsed(const BOOT_PROFILE_MARK *mark_ptr)
+{
+  const BOOT_PROFILE_MARK *clocks_ptr = &boot_profile_marks[BOOT_PROFILE_CLOCKS];
+  ULONG elapsed;
+
+  elapsed = (ULONG)(((ULONG64)clocks_ptr -> cycles * 1000000U) / boot_profile_start_clock);
+  if (mark_ptr == clocks_ptr)
+  {
+    return elapsed;
+  }
+
+  if ((mark_ptr -> tick - clocks_ptr -> tick) < BOOT_PROFILE_CYCLES_SPAN)
+  {
+    elapsed += (ULONG)(((ULONG64)(mark_ptr -> cycles - clocks_ptr -> cycles) * 1000000U) / SystemCoreClock);
+  }
+  else
+  {
+    elapsed += (mark_ptr -> tick - clocks_ptr -> tick) * 1000U;
+  }
+
+  return elapsed;
+}
@@ -0,0 +1,307 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    clock_governor.c
+  * @author  MCD Application Team
+  * @brief   HCLK scaled to the load, 180 MHz when busy, 45 MHz when idle
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "clock_governor.h"
+#include "app_threadx.h"
+#include "thread_profile.h"
+#include "tx_thread.h"
+#include "main.h"
+#include "nx_stm32_eth_config.h"
+
+#ifdef CLOCK_GOVERNOR
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct CLOCK_GOVERNOR_LEVEL_STRUCT
+{
+  ULONG cfgr;                 /* HPRE, PPRE1 and PPRE2 of RCC_CFGR */
+  ULONG flash_latency;
+  ULONG apb1_timer_divider;   /* SYSCLK over the clock of the APB1 timers */
+  ULONG apb2_timer_divider;   /* SYSCLK over the clock of the APB2 timers */
+} CLOCK_GOVERNOR_LEVEL;
+
+/* Private define ------------------------------------------------------------*/
+#define CLOCK_GOVERNOR_PRESCALERS     (RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)
+
+/* Private variables ---------------------------------------------------------*/
+/* Indexed by the levels, from the SYSCLK of 180 MHz of SystemClock_Config() */
+static const CLOCK_GOVERNOR_LEVEL clock_governor_levels[] =
+{
+  /* CLOCK_GOVERNOR_FULL, the setting of SystemClock_Config(): the timers at twice their divided PCLK */
+  { RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2, FLASH_LATENCY_5, 2U, 1U },
+  /* CLOCK_GOVERNOR_LOW: the timers at their undivided PCLK, 1 wait state up to 60 MHz above 2.7 V */
+  { RCC_CFGR_HPRE_DIV4 | RCC_CFGR_PPRE1_DIV1 | RCC_CFGR_PPRE2_DIV1, FLASH_LATENCY_1, 4U, 4U },
+};
+
+/* The timers whose prescaler follows the clock of their bus, while they count */
+static TIM_TypeDef *const clock_governor_apb1_timers[] = { TIM2, TIM3, TIM4, TIM5, TIM6, TIM7, TIM12, TIM13, TIM14 };
+static TIM_TypeDef *const clock_governor_apb2_timers[] = { TIM1, TIM8, TIM9, TIM10, TIM11 };
+
+static TX_TIMER clock_governor_timer;
+
+static UINT clock_governor_level = CLOCK_GOVERNOR_FULL;
+
+/* Nested boosts in progress, the clock stays full while there is one */
+static UINT clock_governor_boosts;
+
+/* Quiet periods in a row at full speed */
+static UINT clock_governor_quiet;
+
+/* Busy cycles of the profile and tick at the start of the period */
+static ULONG clock_governor_busy_start;
+static ULONG clock_governor_time_start;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID clock_governor_decide(ULONG input);
+static VOID clock_governor_switch(UINT level);
+static VOID clock_governor_timers_scale(TIM_TypeDef *const *timers, UINT count, ULONG old_divider,
+                                        ULONG new_divider);
+static UINT clock_governor_ready_count(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the decisions, at full speed. Called once the peripherals whose setup reads the bus
+*         clocks are set up, the timers of the sensors included.
+* @param  None
+* @retval TX_SUCCESS or the error of the timer creation
+*/
+UINT clock_governor_start(VOID)
+{
+  clock_governor_busy_start = thread_profile_busy_cycles();
+  clock_governor_time_start = tx_time_get();
+
+  return tx_timer_create(&clock_governor_timer, "Clock Governor", clock_governor_decide, 0,
+                         CLOCK_GOVERNOR_PERIOD, CLOCK_GOVERNOR_PERIOD, TX_AUTO_ACTIVATE);
+}
+
+/**
+* @brief  Switch to full speed at once and keep it until the matching clock_governor_release(),
+*         around a handshake or a signature check. Boosts nest, not from an interrupt.
+* @param  None
+* @retval None
+*/
+VOID clock_governor_boost(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  clock_governor_boosts++;
+  clock_governor_quiet = 0U;
+  if (clock_governor_level != CLOCK_GOVERNOR_FULL)
+  {
+    clock_governor_switch(CLOCK_GOVERNOR_FULL);
+  }
+  TX_RESTORE
+}
+
+/**
+* @brief  End a boost. The clock drops once the load has been low for CLOCK_GOVERNOR_IDLE_PERIODS.
+* @param  None
+* @retval None
+*/
+VOID clock_governor_release(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if (clock_governor_boosts > 0U)
+  {
+    clock_governor_boosts--;
+  }
+  TX_RESTORE
+}
+
+/**
+* @brief  Level the clock runs at.
+* @param  None
+* @retval CLOCK_GOVERNOR_FULL or CLOCK_GOVERNOR_LOW
+*/
+UINT clock_governor_level_get(VOID)
+{
+  return clock_governor_level;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Timer expiration, from the SysTick interrupt: the level of the next period from the load
+*         of the one that ends.
+* @param  input: not used
+* @retval None
+*/
+static VOID clock_governor_decide(ULONG input)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG busy;
+  ULONG elapsed;
+  ULONG permille;
+  UINT ready;
+
+  (void)input;
+
+  TX_DISABLE
+  busy = thread_profile_busy_cycles() - clock_governor_busy_start;
+  elapsed = tx_time_get() - clock_governor_time_start;
+  if (elapsed == 0U)
+  {
+    elapsed = 1U;
+  }
+  permille = (ULONG)(((ULONG64)busy * 1000U) / ((ULONG64)(SystemCoreClock / TX_TIMER_TICKS_PER_SECOND) * elapsed));
+  ready = clock_governor_ready_count();
+
+  clock_governor_busy_start += busy;
+  clock_governor_time_start += elapsed;
+
+  if (clock_governor_level == CLOCK_GOVERNOR_LOW)
+  {
+    /* A burst, or threads waiting for the CPU, the next ones are served at full speed. */
+    if ((permille >= CLOCK_GOVERNOR_BUSY_PERMILLE) || (ready >= CLOCK_GOVERNOR_READY_THREADS))
+    {
+      clock_governor_quiet = 0U;
+      clock_governor_switch(CLOCK_GOVERNOR_FULL);
+    }
+  }
+  else if ((clock_governor_boosts == 0U) && (permille < CLOCK_GOVERNOR_IDLE_PERMILLE) &&
+           (ready < CLOCK_GOVERNOR_READY_THREADS))
+  {
+    if (++clock_governor_quiet >= CLOCK_GOVERNOR_IDLE_PERIODS)
+    {
+      clock_governor_quiet = 0U;
+      clock_governor_switch(CLOCK_GOVERNOR_LOW);
+    }
+  }
+  else
+  {
+    clock_governor_quiet = 0U;
+  }
+  TX_RESTORE
+}
+
+/**
+* @brief  Set the prescalers and the flash wait states of a level, then everything that counts
+*         from the bus clocks. Called with the interrupts disabled.
+* @param  level: CLOCK_GOVERNOR_FULL or CLOCK_GOVERNOR_LOW, not the current one
+* @retval None
+*/
+static VOID clock_governor_switch(UINT level)
+{
+  const CLOCK_GOVERNOR_LEVEL *old_ptr = &clock_governor_levels[clock_governor_level];
+  const CLOCK_GOVERNOR_LEVEL *new_ptr = &clock_governor_levels[level];
+  ULONG old_hclk = SystemCoreClock;
+
+  /* An MDIO transfer in progress ends at the MDC it started with. */
+  while ((ETH -> MACMIIAR & ETH_MACMIIAR_MB) != 0U)
+  {
+  }
+
+  if (level == CLOCK_GOVERNOR_FULL)
+  {
+    /* The wait states first, then the APB prescalers, so that no bus goes over its maximum once
+       HCLK is up. PCLK1 is HCLK/16 for the few cycles between the writes. */
+    __HAL_FLASH_SET_LATENCY(new_ptr -> flash_latency);
+    while (__HAL_FLASH_GET_LATENCY() != new_ptr -> flash_latency)
+    {
+    }
+    MODIFY_REG(RCC -> CFGR, RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2, new_ptr -> cfgr & (RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2));
+    MODIFY_REG(RCC -> CFGR, CLOCK_GOVERNOR_PRESCALERS, new_ptr -> cfgr);
+  }
+  else
+  {
+    /* HCLK down first, the wait states last. */
+    MODIFY_REG(RCC -> CFGR, RCC_CFGR_HPRE, new_ptr -> cfgr & RCC_CFGR_HPRE);
+    MODIFY_REG(RCC -> CFGR, CLOCK_GOVERNOR_PRESCALERS, new_ptr -> cfgr);
+    __HAL_FLASH_SET_LATENCY(new_ptr -> flash_latency);
+    while (__HAL_FLASH_GET_LATENCY() != new_ptr -> flash_latency)
+    {
+    }
+  }
+
+  clock_governor_level = level;
+  SystemCoreClockUpdate();
+
+  /* The tick keeps its period, the timers their rate, the MDC its range. */
+  App_ThreadX_Tick_Rescale(old_hclk);
+  clock_governor_timers_scale(clock_governor_apb1_timers,
+                              sizeof(clock_governor_apb1_timers) / sizeof(clock_governor_apb1_timers[0]),
+                              old_ptr -> apb1_timer_divider, new_ptr -> apb1_timer_divider);
+  clock_governor_timers_scale(clock_governor_apb2_timers,
+                              sizeof(clock_governor_apb2_timers) / sizeof(clock_governor_apb2_timers[0]),
+                              old_ptr -> apb2_timer_divider, new_ptr -> apb2_timer_divider);
+  HAL_ETH_SetMDIOClockRange(&heth);
+
+  /* The period in progress is measured at the new clock. */
+  clock_governor_busy_start = thread_profile_busy_cycles();
+  clock_governor_time_start = tx_time_get();
+}
+
+/**
+* @brief  Keep the count rate of the running timers of a bus, by their prescaler. The new value is
+*         taken at the next update event, the period in progress ends at the old rate.
+* @param  timers: timers of the bus
+* @param  count: number of timers
+* @param  old_divider: SYSCLK over their clock until now
+* @param  new_divider: SYSCLK over their clock from now on
+* @retval None
+*/
+static VOID clock_governor_timers_scale(TIM_TypeDef *const *timers, UINT count, ULONG old_divider,
+                                        ULONG new_divider)
+{
+  ULONG prescaler;
+  UINT i;
+
+  for (i = 0; i < count; i++)
+  {
+    /* A timer with its clock gated reads as zero. */
+    if ((timers[i] -> CR1 & TIM_CR1_CEN) == 0U)
+    {
+      continue;
+    }
+
+    prescaler = ((timers[i] -> PSC + 1U) * old_divider + (new_divider / 2U)) / new_divider;
+    timers[i] -> PSC = (prescaler != 0U) ? (prescaler - 1U) : 0U;
+  }
+}
+
+/**
+* @brief  Threads ready to run, the one the SysTick interrupt preempted included. Called with the
+*         interrupts disabled.
+* @param  None
+* @retval Number of threads in the TX_READY state
+*/
+static UINT clock_governor_ready_count(VOID)
+{
+  TX_THREAD *thread_ptr = _tx_thread_created_ptr;
+  UINT ready = 0U;
+  ULONG i;
+
+  for (i = 0; i < _tx_thread_created_count; i++)
+  {
+    if (thread_ptr -> tx_thread_state == TX_READY)
+    {
+      ready++;
+    }
+    thread_ptr = thread_ptr -> tx_thread_created_next;
+  }
+
+  return ready;
+}
+
+#endif /* CLOCK_GOVERNOR */
@@ -0,0 +1,305 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    irq_off_trace.c
+  * @author  MCD Application Team
+  * @brief   Length of the sections run with the interrupts disabled
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "irq_off_trace.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TX_IRQ_OFF_TRACE
+
+/* Private define ------------------------------------------------------------*/
+/* DWT cycle counter */
+#define IRQ_OFF_TRACE_COUNTER         (DWT -> CYCCNT)
+
+/* Interrupt posture of the port, without the hooks */
+#ifndef TX_DISABLE_INLINE
+#define IRQ_OFF_TRACE_DISABLE()       __disable_interrupts()
+#define IRQ_OFF_TRACE_RESTORE(p)      __restore_interrupt(p)
+#else
+#define IRQ_OFF_TRACE_DISABLE()       _tx_thread_interrupt_disable()
+#define IRQ_OFF_TRACE_RESTORE(p)      _tx_thread_interrupt_restore(p)
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* Window in progress, the outermost sections do not nest. */
+static ULONG irq_off_trace_start;
+static ULONG irq_off_trace_pc;
+
+/* Sites with the longest windows, and the shortest of their longest windows, a window
+   of a site not kept has to be longer to replace it. */
+static IRQ_OFF_TRACE_SITE irq_off_trace_sites[IRQ_OFF_TRACE_SITES] CCMRAM_BSS;
+static UINT irq_off_trace_site_count;
+static ULONG irq_off_trace_site_min;
+
+static ULONG irq_off_trace_histogram[IRQ_OFF_TRACE_BUCKETS] CCMRAM_BSS;
+static ULONG irq_off_trace_windows;
+
+/* Private function prototypes -----------------------------------------------*/
+UINT _tx_irq_off_trace_disable(VOID) __attribute__((noinline));
+VOID _tx_irq_off_trace_restore(UINT interrupt_save);
+static VOID irq_off_trace_record(ULONG cycles);
+
+/**
+* @brief  Start the DWT cycle counter and clear the statistics.
+* @param  None
+* @retval None
+*/
+VOID irq_off_trace_init(VOID)
+{
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  irq_off_trace_reset();
+}
+
+/**
+* @brief  Clear the sites and the histogram.
+* @param  None
+* @retval None
+*/
+VOID irq_off_trace_reset(VOID)
+{
+  UINT interrupt_save;
+
+  interrupt_save = IRQ_OFF_TRACE_DISABLE();
+
+  memset(irq_off_trace_sites, 0, sizeof(irq_off_trace_sites));
+  memset(irq_off_trace_histogram, 0, sizeof(irq_off_trace_histogram));
+  irq_off_trace_site_count = 0U;
+  irq_off_trace_site_min = 0U;
+  irq_off_trace_windows = 0U;
+
+  IRQ_OFF_TRACE_RESTORE(interrupt_save);
+}
+
+/**
+* @brief  TX_DISABLE of the port: disable the interrupts and start timing when they were enabled.
+* @param  None
+* @retval The interrupt posture to give back to TX_RESTORE
+*/
+UINT _tx_irq_off_trace_disable(VOID)
+{
+  UINT interrupt_save;
+
+  interrupt_save = IRQ_OFF_TRACE_DISABLE();
+
+  if (interrupt_save == 0U)
+  {
+    irq_off_trace_pc = (ULONG)__builtin_return_address(0) & ~1UL;
+    irq_off_trace_start = IRQ_OFF_TRACE_COUNTER;
+  }
+
+  return interrupt_save;
+}
+
+/**
+* @brief  TX_RESTORE of the port: charge the window to its site when it ends, then restore the posture.
+* @param  interrupt_save: posture returned by the TX_DISABLE of the section
+* @retval None
+*/
+VOID _tx_irq_off_trace_restore(UINT interrupt_save)
+{
+  if (interrupt_save == 0U)
+  {
+    irq_off_trace_record(IRQ_OFF_TRACE_COUNTER - irq_off_trace_start);
+  }
+
+  IRQ_OFF_TRACE_RESTORE(interrupt_save);
+}
+
+/**
+* @brief  Count a window in the histogram, and keep it when it is among the longest of the sites.
+* @note   Called with the interrupts disabled.
+* @param  cycles: length of the window
+* @retval None
+*/
+static VOID irq_off_trace_record(ULONG cycles)
+{
+  IRQ_OFF_TRACE_SITE *site_ptr = TX_NULL;
+  UINT bucket;
+  UINT i;
+
+  irq_off_trace_windows++;
+
+  bucket = (cycles != 0U) ? (32U - __CLZ(cycles)) : 0U;
+  if (bucket >= IRQ_OFF_TRACE_BUCKETS)
+  {
+    bucket = IRQ_OFF_TRACE_BUCKETS - 1U;
+  }
+  irq_off_trace_histogram[bucket]++;
+
+  for (i = 0U; i < irq_off_trace_site_count; i++)
+  {
+    if (irq_off_trace_sites[i].pc == irq_off_trace_pc)
+    {
+      site_ptr = &irq_off_trace_sites[i];
+      break;
+    }
+  }
+
+  if (site_ptr == TX_NULL)
+  {
+    if (irq_off_trace_site_count < IRQ_OFF_TRACE_SITES)
+    {
+      site_ptr = &irq_off_trace_sites[irq_off_trace_site_count++];
+    }
+    else if (cycles > irq_off_trace_site_min)
+    {
+      /* Replace the site of the shortest longest window. */
+      site_ptr = &irq_off_trace_sites[0];
+      for (i = 1U; i < IRQ_OFF_TRACE_SITES; i++)
+      {
+        if (irq_off_trace_sites[i].max_cycles < site_ptr -> max_cycles)
+        {
+          site_ptr = &irq_off_trace_sites[i];
+        }
+      }
+    }
+    else
+    {
+      return;
+    }
+
+    site_ptr -> pc = irq_off_trace_pc;
+    site_ptr -> max_cycles = 0U;
+    site_ptr -> count = 0U;
+  }
+
+  site_ptr -> count++;
+  if (cycles <= site_ptr -> max_cycles)
+  {
+    return;
+  }
+  site_ptr -> max_cycles = cycles;
+  site_ptr -> exception = __get_IPSR();
+
+  /* Once the table is full, a new site has to beat its shortest longest window. */
+  if (irq_off_trace_site_count == IRQ_OFF_TRACE_SITES)
+  {
+    irq_off_trace_site_min = irq_off_trace_sites[0].max_cycles;
+    for (i = 1U; i < IRQ_OFF_TRACE_SITES; i++)
+    {
+      if (irq_off_trace_sites[i].max_cycles < irq_off_trace_site_min)
+      {
+        irq_off_trace_site_min = irq_off_trace_sites[i].max_cycles;
+      }
+    }
+  }
+}
+
+/**
+* @brief  Copy the site with the longest window.
+* @param  site_ptr: site copied
+* @retval TX_SUCCESS, or TX_NOT_AVAILABLE before the first window
+*/
+UINT irq_off_trace_worst_get(IRQ_OFF_TRACE_SITE *site_ptr)
+{
+  UINT interrupt_save;
+  UINT ret = TX_NOT_AVAILABLE;
+  UINT i;
+
+  interrupt_save = IRQ_OFF_TRACE_DISABLE();
+
+  for (i = 0U; i < irq_off_trace_site_count; i++)
+  {
+    if ((ret != TX_SUCCESS) || (irq_off_trace_sites[i].max_cycles > site_ptr -> max_cycles))
+    {
+      *site_ptr = irq_off_trace_sites[i];
+      ret = TX_SUCCESS;
+    }
+  }
+
+  IRQ_OFF_TRACE_RESTORE(interrupt_save);
+
+  return ret;
+}
+
+/**
+* @brief  Print the sites, longest window first, and the histogram of the windows.
+* @param  None
+* @retval None
+*/
+VOID irq_off_trace_dump(VOID)
+{
+  static IRQ_OFF_TRACE_SITE sites[IRQ_OFF_TRACE_SITES];
+  static ULONG histogram[IRQ_OFF_TRACE_BUCKETS];
+  IRQ_OFF_TRACE_SITE site;
+  ULONG windows;
+  ULONG cycles_per_us = SystemCoreClock / 1000000U;
+  UINT site_count;
+  UINT interrupt_save;
+  UINT i;
+  UINT j;
+
+  /* Copy the statistics without timing the copy. */
+  interrupt_save = IRQ_OFF_TRACE_DISABLE();
+  memcpy(sites, irq_off_trace_sites, sizeof(sites));
+  memcpy(histogram, irq_off_trace_histogram, sizeof(histogram));
+  site_count = irq_off_trace_site_count;
+  windows = irq_off_trace_windows;
+  IRQ_OFF_TRACE_RESTORE(interrupt_save);
+
+  /* Longest window first. */
+  for (i = 1U; i < site_count; i++)
+  {
+    site = sites[i];
+    for (j = i; (j > 0U) && (sites[j - 1U].max_cycles < site.max_cycles); j--)
+    {
+      sites[j] = sites[j - 1U];
+    }
+    sites[j] = site;
+  }
+
+  printf("Interrupts disabled, %lu windows, longest at %lu MHz:\n", windows, cycles_per_us);
+  for (i = 0U; i < site_count; i++)
+  {
+    printf("  0x%08lx %8lu cycles %6lu us %8lu times", sites[i].pc, sites[i].max_cycles,
+           sites[i].max_cycles / cycles_per_us, sites[i].count);
+    if (sites[i].exception != 0U)
+    {
+      printf(" in exception %lu\n", sites[i].exception);
+    }
+    else
+    {
+      printf(" in a thread\n");
+    }
+  }
+
+  printf("  cycles:");
+  for (i = 0U; i < IRQ_OFF_TRACE_BUCKETS; i++)
+  {
+    if (histogram[i] != 0U)
+    {
+      if (i < (IRQ_OFF_TRACE_BUCKETS - 1U))
+      {
+        printf(" <%lu:%lu", 1UL << i, histogram[i]);
+      }
+      else
+      {
+        printf(" >=%lu:%lu", 1UL << (i - 1U), histogram[i]);
+      }
+    }
+  }
+  printf("\n");
+}
+
+#endif /* TX_IRQ_OFF_TRACE */
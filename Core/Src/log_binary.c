@@ -0,0 +1,60 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    log_binary.c
+  * @author  MCD Application Team
+  * @brief   Log records formatted on the host instead of the target
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "log_binary.h"
+#include "log_uart.h"
+
+#ifdef LOG_BINARY_ENABLE
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Queue a record, from a thread or an interrupt. Called through LOG_PRINTF().
+* @param  format_address: address of the format string, its offset in the .log_strings section
+*         linked at 0
+* @param  args_ptr: arguments
+* @param  count: number of arguments, LOG_BINARY_ARGS_MAX at most
+* @retval None
+*/
+VOID log_binary_write(ULONG format_address, const ULONG *args_ptr, UINT count)
+{
+  UCHAR record[LOG_BINARY_HEADER_SIZE + (LOG_BINARY_ARGS_MAX * sizeof(ULONG))];
+  UINT i;
+
+  record[0] = LOG_BINARY_MARKER;
+  record[1] = (UCHAR)count;
+  record[2] = (UCHAR)format_address;
+  record[3] = (UCHAR)(format_address >> 8);
+
+  /* Little endian words, as on the target. */
+  for (i = 0U; i < count; i++)
+  {
+    record[LOG_BINARY_HEADER_SIZE + (i * 4U)] = (UCHAR)args_ptr[i];
+    record[LOG_BINARY_HEADER_SIZE + (i * 4U) + 1U] = (UCHAR)(args_ptr[i] >> 8);
+    record[LOG_BINARY_HEADER_SIZE + (i * 4U) + 2U] = (UCHAR)(args_ptr[i] >> 16);
+    record[LOG_BINARY_HEADER_SIZE + (i * 4U) + 3U] = (UCHAR)(args_ptr[i] >> 24);
+  }
+
+  /* A single write, so the record is dropped whole or queued whole. */
+  (void)log_uart_write((CHAR *)record, LOG_BINARY_HEADER_SIZE + (count * sizeof(ULONG)));
+}
+
+#endif /* LOG_BINARY_ENABLE */
@@ -0,0 +1,244 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    log_uart.c
+  * @author  MCD Application Team
+  * @brief   Non-blocking printf output, sent over USART3 by DMA
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "log_uart.h"
+#include "main.h"
+
+/* Private variables ---------------------------------------------------------*/
+extern UART_HandleTypeDef huart3;
+
+/* Read by the DMA, so out of the CCM-RAM. */
+static UCHAR log_uart_buffer[LOG_UART_BUFFER_SIZE] DMA_RAM;
+
+/* Free running byte counts, masked to index the ring. The writers advance the reserved end,
+   then the published end once their copies are done, the DMA interrupts advance the tail. */
+static volatile ULONG log_uart_reserved;
+static volatile ULONG log_uart_published;
+static volatile ULONG log_uart_tail;
+
+/* Writers between their entry and their return, nested by preemption. */
+static volatile ULONG log_uart_writers;
+
+/* Set while a block is sent, by the context that starts it. */
+static volatile ULONG log_uart_busy;
+static ULONG log_uart_block_start;
+static ULONG log_uart_block_length;
+
+static volatile ULONG log_uart_dropped_bytes;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID log_uart_publish(VOID);
+static VOID log_uart_start(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Copy text into the ring and have it sent, from a thread or an interrupt. Does not wait.
+* @param  data_ptr: text to send
+* @param  length: length of the text in bytes
+* @retval length, or 0 if the text did not fit and was dropped
+*/
+ULONG log_uart_write(const CHAR *data_ptr, ULONG length)
+{
+  ULONG start;
+  ULONG i;
+  ULONG dropped;
+  UINT fits;
+
+  if (length == 0U)
+  {
+    return 0;
+  }
+
+  /* A writer preempting this one returns before it resumes, so the count is back to its value then. */
+  log_uart_writers++;
+
+  do
+  {
+    start = __LDREXW((volatile uint32_t *)&log_uart_reserved);
+    fits = ((start + length - log_uart_tail) <= LOG_UART_BUFFER_SIZE);
+    if (!fits)
+    {
+      __CLREX();
+      break;
+    }
+  } while (__STREXW(start + length, (volatile uint32_t *)&log_uart_reserved) != 0U);
+
+  if (fits)
+  {
+    for (i = 0U; i < length; i++)
+    {
+      log_uart_buffer[(start + i) & (LOG_UART_BUFFER_SIZE - 1U)] = (UCHAR)data_ptr[i];
+    }
+  }
+  else
+  {
+    do
+    {
+      dropped = __LDREXW((volatile uint32_t *)&log_uart_dropped_bytes);
+    } while (__STREXW(dropped + length, (volatile uint32_t *)&log_uart_dropped_bytes) != 0U);
+
+    length = 0U;
+  }
+
+  /* The nested writers left their text to this one, the outermost hands all of it to the DMA. */
+  log_uart_writers--;
+  if (log_uart_writers == 0U)
+  {
+    log_uart_publish();
+    log_uart_start();
+  }
+
+  return length;
+}
+
+/**
+* @brief  Bytes dropped since the start because the ring was full.
+* @param  None
+* @retval Number of bytes
+*/
+ULONG log_uart_dropped(VOID)
+{
+  return log_uart_dropped_bytes;
+}
+
+/**
+* @brief  Send the standard output through the ring, instead of the blocking loop of syscalls.c.
+* @param  file: not used, stdout and stderr
+* @param  ptr: text to send
+* @param  len: length of the text
+* @retval len, the dropped text is not reported to the C library
+*/
+int _write(int file, char *ptr, int len)
+{
+  (void)file;
+
+  if (len > 0)
+  {
+    (void)log_uart_write(ptr, (ULONG)len);
+  }
+
+  return len;
+}
+
+/**
+* @brief  The first half of the block is out of the DMA, its space is free again.
+* @param  huart: UART handle
+* @retval None
+*/
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart -> Instance == USART3)
+  {
+    log_uart_tail = log_uart_block_start + (log_uart_block_length / 2U);
+  }
+}
+
+/**
+* @brief  The block has left the line, free the rest of it and send the text published meanwhile.
+* @param  huart: UART handle
+* @retval None
+*/
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart -> Instance == USART3)
+  {
+    log_uart_tail = log_uart_block_start + log_uart_block_length;
+    log_uart_busy = 0U;
+    log_uart_start();
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Publish the reserved text, called when no writer is between its reservation and its return.
+*         An interrupt between the exclusive load and store makes the store fail, so the published end
+*         is only set to a reserved end read with all the copies done, and it never moves back.
+* @param  None
+* @retval None
+*/
+static VOID log_uart_publish(VOID)
+{
+  ULONG reserved;
+
+  do
+  {
+    (void)__LDREXW((volatile uint32_t *)&log_uart_published);
+    reserved = log_uart_reserved;
+  } while (__STREXW(reserved, (volatile uint32_t *)&log_uart_published) != 0U);
+}
+
+/**
+* @brief  Start sending the published text if the DMA is idle. The block stops at the end of the ring,
+*         the next one starts at its beginning.
+* @param  None
+* @retval None
+*/
+static VOID log_uart_start(VOID)
+{
+  ULONG start;
+  ULONG length;
+  ULONG offset;
+
+  for (;;)
+  {
+    do
+    {
+      if (__LDREXW((volatile uint32_t *)&log_uart_busy) != 0U)
+      {
+        __CLREX();
+        return;
+      }
+    } while (__STREXW(1U, (volatile uint32_t *)&log_uart_busy) != 0U);
+
+    start = log_uart_tail;
+    length = log_uart_published - start;
+    if (length != 0U)
+    {
+      offset = start & (LOG_UART_BUFFER_SIZE - 1U);
+      if (length > (LOG_UART_BUFFER_SIZE - offset))
+      {
+        length = LOG_UART_BUFFER_SIZE - offset;
+      }
+
+      log_uart_block_start = start;
+      log_uart_block_length = length;
+
+      /* The copies must be in the SRAM before the DMA reads them. */
+      __DMB();
+      if (HAL_UART_Transmit_DMA(&huart3, &log_uart_buffer[offset], (uint16_t)length) != HAL_OK)
+      {
+        /* The UART is not ready yet, the next write tries again. */
+        log_uart_busy = 0U;
+      }
+      return;
+    }
+
+    /* Text published after the check found the DMA busy, take it now. */
+    log_uart_busy = 0U;
+    __DMB();
+    if (log_uart_published == log_uart_tail)
+    {
+      return;
+    }
+  }
+}
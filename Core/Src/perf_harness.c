@@ -0,0 +1,216 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    perf_harness.c
+  * @author  MCD Application Team
+  * @brief   Performance harness, the benchmarks compared with their baselines
+  *
+  *          The application runs the suites in turn, each benchmark passes
+  *          its results here as it prints them. Each result is a line
+  *            PERF,build,suite,name,metric,value,baseline,limit,verdict
+  *          for the host to collect, the limit its baseline moved by the
+  *          threshold in the direction of the regression, the verdict
+  *          PASS, FAIL past the limit, NEW without a baseline; a comma of
+  *          a name is replaced with a semicolon. Each suite
+  *          ends on a line of its status, its metric "status", FAIL on an
+  *          error, and the run on the baselines not measured, MISSING, and
+  *          a summary line, its value the failures; any failure fails the
+  *          run. Utilities/perf_baseline.py makes perf_baseline.h from the
+  *          lines of runs of a build taken as the reference.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "perf_harness.h"
+#include "perf_baseline.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef PERF_HARNESS
+
+/* Private define ------------------------------------------------------------*/
+#define PERF_HARNESS_NAME_SIZE        48U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct PERF_BASELINE_STRUCT
+{
+  const CHAR *suite;
+  const CHAR *name;
+  const CHAR *metric;
+  ULONG       value;
+  UINT        threshold;
+} PERF_BASELINE;
+
+/* Private macro -------------------------------------------------------------*/
+#define PERF_BASELINE_ENTRY(suite, name, metric, value, threshold) \
+  { (suite), (name), (metric), (value), (threshold) },
+
+/* Private function prototypes -----------------------------------------------*/
+static ULONG perf_harness_limit(const PERF_BASELINE *baseline, UINT direction);
+
+/* Private variables ---------------------------------------------------------*/
+/* Closed by an entry without a suite, the list may be empty. */
+static const PERF_BASELINE perf_baselines[] =
+{
+  PERF_BASELINE_LIST(PERF_BASELINE_ENTRY)
+  { TX_NULL, TX_NULL, TX_NULL, 0, 0 }
+};
+
+static UCHAR perf_baseline_measured[sizeof(perf_baselines) / sizeof(perf_baselines[0])];
+
+static ULONG perf_harness_results;
+static ULONG perf_harness_new;
+static ULONG perf_harness_failures;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Print the header of the run.
+* @param  None
+* @retval None
+*/
+VOID perf_harness_start(VOID)
+{
+  printf("Performance harness, build %s, %u baselines\n", PERF_HARNESS_BUILD_ID,
+         (unsigned)(sizeof(perf_baselines) / sizeof(perf_baselines[0]) - 1U));
+  printf("PERF,build,suite,name,metric,value,baseline,limit,verdict\n");
+}
+
+/**
+* @brief  Print a result and compare it with its baseline.
+* @param  suite: suite of the result
+* @param  metric: unit of the result
+* @param  value: the result
+* @param  direction: PERF_HARNESS_LOWER or PERF_HARNESS_HIGHER, the better way of the result
+* @param  name_format: printf() format of the name of the result, then its arguments
+* @retval None
+*/
+VOID perf_harness_result(const CHAR *suite, const CHAR *metric, ULONG value, UINT direction,
+                         const CHAR *name_format, ...)
+{
+  CHAR name[PERF_HARNESS_NAME_SIZE];
+  const PERF_BASELINE *baseline;
+  CHAR *comma_ptr;
+  ULONG limit;
+  UINT pass;
+  va_list args;
+
+  va_start(args, name_format);
+  vsnprintf(name, sizeof(name), name_format, args);
+  va_end(args);
+
+  /* One column per field. */
+  for (comma_ptr = strchr(name, ','); comma_ptr != TX_NULL; comma_ptr = strchr(comma_ptr, ','))
+  {
+    *comma_ptr = ';';
+  }
+
+  perf_harness_results++;
+
+  for (baseline = perf_baselines; baseline -> suite != TX_NULL; baseline++)
+  {
+    if ((strcmp(baseline -> suite, suite) == 0) && (strcmp(baseline -> name, name) == 0) &&
+        (strcmp(baseline -> metric, metric) == 0))
+    {
+      break;
+    }
+  }
+
+  if (baseline -> suite == TX_NULL)
+  {
+    perf_harness_new++;
+    printf("PERF,%s,%s,%s,%s,%lu,-,-,NEW\n", PERF_HARNESS_BUILD_ID, suite, name, metric, value);
+    return;
+  }
+
+  perf_baseline_measured[baseline - perf_baselines] = 1U;
+
+  limit = perf_harness_limit(baseline, direction);
+  pass = (direction == PERF_HARNESS_HIGHER) ? (value >= limit) : (value <= limit);
+  if (!pass)
+  {
+    perf_harness_failures++;
+  }
+
+  printf("PERF,%s,%s,%s,%s,%lu,%lu,%lu,%s\n", PERF_HARNESS_BUILD_ID, suite, name, metric, value,
+         baseline -> value, limit, pass ? "PASS" : "FAIL");
+}
+
+/**
+* @brief  Print the status of a suite.
+* @param  suite: the suite
+* @param  status: its status, an error fails the run
+* @retval None
+*/
+VOID perf_harness_suite_end(const CHAR *suite, UINT status)
+{
+  if (status != TX_SUCCESS)
+  {
+    perf_harness_failures++;
+  }
+
+  printf("PERF,%s,%s,-,status,%u,0,0,%s\n", PERF_HARNESS_BUILD_ID, suite, status,
+         (status == TX_SUCCESS) ? "PASS" : "FAIL");
+}
+
+/**
+* @brief  Print the baselines not measured, then the summary of the run.
+* @param  None
+* @retval TX_SUCCESS, or TX_NOT_DONE if a result, a suite or a baseline failed
+*/
+UINT perf_harness_end(VOID)
+{
+  const PERF_BASELINE *baseline;
+
+  for (baseline = perf_baselines; baseline -> suite != TX_NULL; baseline++)
+  {
+    if (!perf_baseline_measured[baseline - perf_baselines])
+    {
+      perf_harness_failures++;
+      printf("PERF,%s,%s,%s,%s,-,%lu,-,MISSING\n", PERF_HARNESS_BUILD_ID, baseline -> suite,
+             baseline -> name, baseline -> metric, baseline -> value);
+    }
+  }
+
+  printf("PERF,%s,summary,-,failures,%lu,0,0,%s\n", PERF_HARNESS_BUILD_ID, perf_harness_failures,
+         (perf_harness_failures == 0U) ? "PASS" : "FAIL");
+  printf("Performance harness done, %lu results, %lu new, %lu failures\n", perf_harness_results,
+         perf_harness_new, perf_harness_failures);
+
+  return (perf_harness_failures == 0U) ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Limit of a result, its baseline moved by the threshold in the direction of the regression.
+* @param  baseline: the baseline of the result
+* @param  direction: PERF_HARNESS_LOWER or PERF_HARNESS_HIGHER
+* @retval The limit
+*/
+static ULONG perf_harness_limit(const PERF_BASELINE *baseline, UINT direction)
+{
+  UINT threshold = (baseline -> threshold != 0U) ? baseline -> threshold : PERF_HARNESS_THRESHOLD_PERCENT;
+  ULONG margin = (ULONG)(((ULONG64)baseline -> value * threshold + 99U) / 100U);
+
+  if (direction == PERF_HARNESS_HIGHER)
+  {
+    return (margin < baseline -> value) ? (baseline -> value - margin) : 0U;
+  }
+
+  return (baseline -> value + margin >= baseline -> value) ? (baseline -> value + margin) : 0xFFFFFFFFUL;
+}
+
+#endif /* PERF_HARNESS */
@@ -0,0 +1,544 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pool_map.c
+  * @author  MCD Application Team
+  * @brief   Map of the blocks of the ThreadX byte pools, with their owners
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pool_map.h"
+#include "tx_byte_pool.h"
+#include "tx_thread.h"
+#include "main.h"
+#include <stdio.h>
+
+#ifdef POOL_MAP
+
+/* Private define ------------------------------------------------------------*/
+/* Each block starts with the link to the next one and the owner, the pool or TX_BYTE_BLOCK_FREE */
+#define POOL_MAP_BLOCK_HEADER         ((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE)))
+
+/* Low bits of the link that are not address, the TLSF free lists flag a free previous block there */
+#ifdef TX_BYTE_BLOCK_PREVIOUS_FREE
+#define POOL_MAP_LINK_FLAGS           TX_BYTE_BLOCK_PREVIOUS_FREE
+#else
+#define POOL_MAP_LINK_FLAGS           ((ALIGN_TYPE) 0)
+#endif
+
+/* Mixed with the tag pointer, tells a block of pool_map_allocate() */
+#define POOL_MAP_TAG_MAGIC            0x504D4150U   /* "PMAP" */
+
+/* Byte pools a dump goes through */
+#define POOL_MAP_POOLS                8U
+
+/* Largest alignment printed */
+#define POOL_MAP_ALIGN_MAX            64U
+
+/* Private typedef -----------------------------------------------------------*/
+/* Ahead of the memory given by pool_map_allocate() */
+typedef struct POOL_MAP_TAG_STRUCT
+{
+  ULONG       check;                  /* POOL_MAP_TAG_MAGIC mixed with the tag */
+  const CHAR *tag;
+  const CHAR *thread_name;            /* Of the thread that allocated, NX_NULL outside of one */
+  ULONG       size;                   /* Bytes asked */
+} POOL_MAP_TAG;
+
+typedef struct POOL_MAP_BLOCK_STRUCT
+{
+  ULONG       offset;                 /* Of the block from the start of the pool memory */
+  ULONG       size;                   /* Header included */
+  ULONG       memory;                 /* Address of the memory given to its owner, 0 when free */
+  const CHAR *tag;                    /* NX_NULL when free or unknown */
+  const CHAR *thread_name;
+} POOL_MAP_BLOCK;
+
+#ifdef POOL_MAP_TRACE
+typedef struct POOL_MAP_TRACE_ENTRY_STRUCT
+{
+  ULONG       time;
+  const CHAR *pool_name;
+  VOID       *memory_ptr;             /* NX_NULL for an allocation that failed */
+  ULONG       size;                   /* Bytes asked, 0 for a release */
+  const CHAR *tag;
+  const CHAR *thread_name;
+  UINT        release;
+  UINT        status;
+} POOL_MAP_TRACE_ENTRY;
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* The dump copies the blocks here with the interrupts disabled, and prints them after. */
+static POOL_MAP_BLOCK pool_map_blocks[POOL_MAP_BLOCKS] CCMRAM_BSS;
+static UINT pool_map_dumping;
+
+#ifdef POOL_MAP_TRACE
+static POOL_MAP_TRACE_ENTRY pool_map_trace[POOL_MAP_TRACE_ENTRIES];
+static POOL_MAP_TRACE_ENTRY pool_map_trace_copy[POOL_MAP_TRACE_ENTRIES] CCMRAM_BSS;
+
+/* Calls recorded since the previous dump, the oldest overwritten past POOL_MAP_TRACE_ENTRIES */
+static ULONG pool_map_trace_count;
+static ULONG pool_map_trace_next;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT pool_map_walk(TX_BYTE_POOL *pool_ptr, POOL_MAP_INFO *info_ptr, POOL_MAP_BLOCK *blocks,
+                          UINT *block_count);
+static VOID pool_map_owner(UCHAR *memory_ptr, UCHAR *next_ptr, POOL_MAP_BLOCK *block_ptr);
+static ULONG pool_map_align(ULONG address);
+static VOID pool_map_pool_dump(TX_BYTE_POOL *pool_ptr);
+#ifdef POOL_MAP_TRACE
+static VOID pool_map_trace_add(TX_BYTE_POOL *pool_ptr, VOID *memory_ptr, ULONG size, const CHAR *tag,
+                               UINT release, UINT status);
+static VOID pool_map_trace_dump(VOID);
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Allocate memory from a byte pool as tx_byte_allocate() does, the block tagged with its owner.
+* @param  pool_ptr: byte pool
+* @param  memory_ptr: set to the memory allocated
+* @param  memory_size: bytes asked, POOL_MAP_TAG_SIZE more are taken from the pool
+* @param  wait_option: as for tx_byte_allocate()
+* @param  tag: owner printed by pool_map_dump(), a string kept as long as the block
+* @retval Status of tx_byte_allocate()
+*/
+UINT pool_map_allocate(TX_BYTE_POOL *pool_ptr, VOID **memory_ptr, ULONG memory_size, ULONG wait_option,
+                       const CHAR *tag)
+{
+  POOL_MAP_TAG *tag_ptr;
+  TX_THREAD *thread_ptr;
+  VOID *block_memory_ptr = TX_NULL;
+  UINT ret;
+
+  ret = tx_byte_allocate(pool_ptr, &block_memory_ptr, memory_size + POOL_MAP_TAG_SIZE, wait_option);
+  if (ret == TX_SUCCESS)
+  {
+    thread_ptr = tx_thread_identify();
+
+    tag_ptr = (POOL_MAP_TAG *)block_memory_ptr;
+    tag_ptr -> tag = tag;
+    tag_ptr -> thread_name = (thread_ptr != TX_NULL) ? thread_ptr -> tx_thread_name : TX_NULL;
+    tag_ptr -> size = memory_size;
+    tag_ptr -> check = POOL_MAP_TAG_MAGIC ^ (ULONG)tag;
+
+    *memory_ptr = (UCHAR *)block_memory_ptr + POOL_MAP_TAG_SIZE;
+  }
+  else
+  {
+    *memory_ptr = TX_NULL;
+  }
+
+#ifdef POOL_MAP_TRACE
+  pool_map_trace_add(pool_ptr, *memory_ptr, memory_size, tag, 0U, ret);
+#endif
+
+  return ret;
+}
+
+/**
+* @brief  Release memory of pool_map_allocate().
+* @param  memory_ptr: memory given by pool_map_allocate()
+* @retval TX_PTR_ERROR when the memory is not of pool_map_allocate(), else the status of tx_byte_release()
+*/
+UINT pool_map_release(VOID *memory_ptr)
+{
+  POOL_MAP_TAG *tag_ptr;
+  UINT ret;
+#ifdef POOL_MAP_TRACE
+  TX_BYTE_POOL *pool_ptr;
+  const CHAR *tag;
+#endif
+
+  if (memory_ptr == TX_NULL)
+  {
+    return TX_PTR_ERROR;
+  }
+
+  tag_ptr = (POOL_MAP_TAG *)((UCHAR *)memory_ptr - POOL_MAP_TAG_SIZE);
+  if (tag_ptr -> check != (POOL_MAP_TAG_MAGIC ^ (ULONG)tag_ptr -> tag))
+  {
+    return TX_PTR_ERROR;
+  }
+
+#ifdef POOL_MAP_TRACE
+  /* The owner field of the block is its pool while allocated. */
+  pool_ptr = (TX_BYTE_POOL *)(*(ALIGN_TYPE *)((UCHAR *)tag_ptr - sizeof(ALIGN_TYPE)));
+  tag = tag_ptr -> tag;
+#endif
+
+  tag_ptr -> check = 0U;
+  ret = tx_byte_release(tag_ptr);
+  if (ret != TX_SUCCESS)
+  {
+    tag_ptr -> check = POOL_MAP_TAG_MAGIC ^ (ULONG)tag_ptr -> tag;
+  }
+
+#ifdef POOL_MAP_TRACE
+  pool_map_trace_add(pool_ptr, memory_ptr, 0U, tag, 1U, ret);
+#endif
+
+  return ret;
+}
+
+/**
+* @brief  Totals of the blocks of a byte pool.
+* @param  pool_ptr: byte pool
+* @param  info_ptr: set to the totals
+* @retval TX_SUCCESS, or TX_POOL_ERROR when the pool is not created
+*/
+UINT pool_map_info_get(TX_BYTE_POOL *pool_ptr, POOL_MAP_INFO *info_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UINT block_count = 0U;
+
+  TX_DISABLE
+  if ((pool_ptr == TX_NULL) || (pool_ptr -> tx_byte_pool_id != TX_BYTE_POOL_ID))
+  {
+    TX_RESTORE
+    return TX_POOL_ERROR;
+  }
+
+  pool_map_walk(pool_ptr, info_ptr, TX_NULL, &block_count);
+  TX_RESTORE
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Print the blocks and the totals of every byte pool created, then the trace since the previous dump.
+* @param  None
+* @retval None
+*/
+VOID pool_map_dump(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  TX_BYTE_POOL *pools[POOL_MAP_POOLS];
+  TX_BYTE_POOL *pool_ptr;
+  UINT pool_count = 0U;
+  UINT i;
+
+  /* One dump at a time, the copies are shared. */
+  TX_DISABLE
+  if (pool_map_dumping)
+  {
+    TX_RESTORE
+    return;
+  }
+  pool_map_dumping = 1U;
+
+  pool_ptr = _tx_byte_pool_created_ptr;
+  for (i = 0; (i < _tx_byte_pool_created_count) && (pool_count < POOL_MAP_POOLS); i++)
+  {
+    pools[pool_count++] = pool_ptr;
+    pool_ptr = pool_ptr -> tx_byte_pool_created_next;
+  }
+  TX_RESTORE
+
+  for (i = 0; i < pool_count; i++)
+  {
+    pool_map_pool_dump(pools[i]);
+  }
+
+#ifdef POOL_MAP_TRACE
+  pool_map_trace_dump();
+#endif
+
+  pool_map_dumping = 0U;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Print the blocks and the totals of a byte pool.
+* @param  pool_ptr: byte pool, deleted meanwhile possibly
+* @retval None
+*/
+static VOID pool_map_pool_dump(TX_BYTE_POOL *pool_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+  POOL_MAP_INFO info;
+  const CHAR *name;
+  ULONG start;
+  ULONG size;
+  ULONG permille;
+  UINT block_count = POOL_MAP_BLOCKS;
+  UINT blocks;
+  UINT i;
+
+  TX_DISABLE
+  if (pool_ptr -> tx_byte_pool_id != TX_BYTE_POOL_ID)
+  {
+    TX_RESTORE
+    return;
+  }
+
+  blocks = pool_map_walk(pool_ptr, &info, pool_map_blocks, &block_count);
+  name = pool_ptr -> tx_byte_pool_name;
+  start = (ULONG)pool_ptr -> tx_byte_pool_start;
+  size = pool_ptr -> tx_byte_pool_size;
+  TX_RESTORE
+
+  printf("Byte pool %s, %lu bytes at 0x%08lx:\n", (name != TX_NULL) ? name : "?", size, start);
+
+  for (i = 0; i < block_count; i++)
+  {
+    if (pool_map_blocks[i].memory == 0U)
+    {
+      printf("  +0x%05lx %6lu bytes free\n", pool_map_blocks[i].offset, pool_map_blocks[i].size);
+    }
+    else
+    {
+      printf("  +0x%05lx %6lu bytes, align %2lu, %s%s%s\n", pool_map_blocks[i].offset, pool_map_blocks[i].size,
+             pool_map_align(pool_map_blocks[i].memory),
+             (pool_map_blocks[i].tag != TX_NULL) ? pool_map_blocks[i].tag : "untagged",
+             (pool_map_blocks[i].thread_name != TX_NULL) ? " of " : "",
+             (pool_map_blocks[i].thread_name != TX_NULL) ? pool_map_blocks[i].thread_name : "");
+    }
+  }
+
+  if (blocks > block_count)
+  {
+    printf("  %u more blocks\n", blocks - block_count);
+  }
+
+  /* The share of the free bytes no allocation can have at once. */
+  permille = (info.free_bytes != 0U) ?
+             (1000U - (((info.largest_free + POOL_MAP_BLOCK_HEADER) * 1000U) / info.free_bytes)) : 0U;
+
+  printf("  %lu allocated, %lu bytes; %lu free fragments, %lu bytes, largest allocation %lu bytes,"
+         " fragmentation %lu.%lu%%%s\n",
+         info.allocated_blocks, info.allocated_bytes, info.free_blocks, info.free_bytes, info.largest_free,
+         permille / 10U, permille % 10U, info.corrupted ? ", CORRUPTED" : "");
+}
+
+/**
+* @brief  Walk the block list of a byte pool. Called with the interrupts disabled.
+* @param  pool_ptr: byte pool, created
+* @param  info_ptr: set to the totals
+* @param  blocks: filled with the first blocks, NX_NULL for the totals only
+* @param  block_count: room of blocks, set to the number of blocks filled
+* @retval Number of blocks of the pool, its last one left out
+*/
+static UINT pool_map_walk(TX_BYTE_POOL *pool_ptr, POOL_MAP_INFO *info_ptr, POOL_MAP_BLOCK *blocks,
+                          UINT *block_count)
+{
+  UCHAR *block_ptr = pool_ptr -> tx_byte_pool_list;
+  UCHAR *last_ptr;
+  UCHAR *next_ptr;
+  ALIGN_TYPE owner;
+  ULONG block_size;
+  UINT room = (blocks != TX_NULL) ? *block_count : 0U;
+  UINT count = 0U;
+
+  info_ptr -> allocated_blocks = 0U;
+  info_ptr -> allocated_bytes = 0U;
+  info_ptr -> free_blocks = 0U;
+  info_ptr -> free_bytes = 0U;
+  info_ptr -> largest_free = 0U;
+  info_ptr -> corrupted = 0U;
+  *block_count = 0U;
+
+  /* The pool ends with a block of its header alone, allocated and linked back to the first. */
+  last_ptr = pool_ptr -> tx_byte_pool_start + pool_ptr -> tx_byte_pool_size - POOL_MAP_BLOCK_HEADER;
+
+  while (block_ptr != last_ptr)
+  {
+    next_ptr = (UCHAR *)(*(ALIGN_TYPE *)block_ptr & ~POOL_MAP_LINK_FLAGS);
+    owner = *(ALIGN_TYPE *)(block_ptr + sizeof(UCHAR *));
+
+    /* Each link stays ahead and within the pool, the blocks no more than the fragments counted. */
+    if ((next_ptr < block_ptr + POOL_MAP_BLOCK_HEADER) || (next_ptr > last_ptr) ||
+        (count >= pool_ptr -> tx_byte_pool_fragments) ||
+        ((owner != TX_BYTE_BLOCK_FREE) && (owner != (ALIGN_TYPE)pool_ptr)))
+    {
+      info_ptr -> corrupted = 1U;
+      break;
+    }
+
+    block_size = (ULONG)(next_ptr - block_ptr);
+
+    if (owner == TX_BYTE_BLOCK_FREE)
+    {
+      info_ptr -> free_blocks++;
+      info_ptr -> free_bytes += block_size;
+      if (block_size - POOL_MAP_BLOCK_HEADER > info_ptr -> largest_free)
+      {
+        info_ptr -> largest_free = block_size - POOL_MAP_BLOCK_HEADER;
+      }
+    }
+    else
+    {
+      info_ptr -> allocated_blocks++;
+      info_ptr -> allocated_bytes += block_size;
+    }
+
+    if (count < room)
+    {
+      blocks[count].offset = (ULONG)(block_ptr - pool_ptr -> tx_byte_pool_start);
+      blocks[count].size = block_size;
+      blocks[count].memory = 0U;
+      blocks[count].tag = TX_NULL;
+      blocks[count].thread_name = TX_NULL;
+      if (owner != TX_BYTE_BLOCK_FREE)
+      {
+        pool_map_owner(block_ptr + POOL_MAP_BLOCK_HEADER, next_ptr, &blocks[count]);
+      }
+      *block_count = count + 1U;
+    }
+
+    count++;
+    block_ptr = next_ptr;
+  }
+
+  return count;
+}
+
+/**
+* @brief  Find the owner of an allocated block, from its tag or the stacks of the threads. Called with
+*         the interrupts disabled.
+* @param  memory_ptr: memory of the block
+* @param  next_ptr: next block
+* @param  block_ptr: block of the map, its owner and memory set
+* @retval None
+*/
+static VOID pool_map_owner(UCHAR *memory_ptr, UCHAR *next_ptr, POOL_MAP_BLOCK *block_ptr)
+{
+  POOL_MAP_TAG *tag_ptr = (POOL_MAP_TAG *)memory_ptr;
+  TX_THREAD *thread_ptr;
+  ULONG i;
+
+  block_ptr -> memory = (ULONG)memory_ptr;
+
+  if ((memory_ptr + POOL_MAP_TAG_SIZE <= next_ptr) &&
+      (tag_ptr -> check == (POOL_MAP_TAG_MAGIC ^ (ULONG)tag_ptr -> tag)))
+  {
+    block_ptr -> memory += POOL_MAP_TAG_SIZE;
+    block_ptr -> tag = tag_ptr -> tag;
+    block_ptr -> thread_name = tag_ptr -> thread_name;
+    return;
+  }
+
+  thread_ptr = _tx_thread_created_ptr;
+  for (i = 0; i < _tx_thread_created_count; i++)
+  {
+    if (((UCHAR *)thread_ptr -> tx_thread_stack_start >= memory_ptr) &&
+        ((UCHAR *)thread_ptr -> tx_thread_stack_start < next_ptr))
+    {
+      block_ptr -> tag = "stack";
+      block_ptr -> thread_name = thread_ptr -> tx_thread_name;
+      return;
+    }
+    thread_ptr = thread_ptr -> tx_thread_created_next;
+  }
+}
+
+/**
+* @brief  Alignment of an address, the largest power of two it is a multiple of.
+* @param  address: address, not zero
+* @retval Alignment in bytes, up to POOL_MAP_ALIGN_MAX
+*/
+static ULONG pool_map_align(ULONG address)
+{
+  ULONG align = address & (~address + 1U);
+
+  return (align > POOL_MAP_ALIGN_MAX) ? POOL_MAP_ALIGN_MAX : align;
+}
+
+#ifdef POOL_MAP_TRACE
+/**
+* @brief  Record a call of pool_map_allocate() or pool_map_release().
+* @param  pool_ptr: byte pool
+* @param  memory_ptr: memory allocated or released, NX_NULL for an allocation that failed
+* @param  size: bytes asked, 0 for a release
+* @param  tag: owner of the memory
+* @param  release: 1 for a release, 0 for an allocation
+* @param  status: status of the call
+* @retval None
+*/
+static VOID pool_map_trace_add(TX_BYTE_POOL *pool_ptr, VOID *memory_ptr, ULONG size, const CHAR *tag,
+                               UINT release, UINT status)
+{
+  TX_INTERRUPT_SAVE_AREA
+  POOL_MAP_TRACE_ENTRY *entry_ptr;
+  TX_THREAD *thread_ptr = tx_thread_identify();
+
+  TX_DISABLE
+  entry_ptr = &pool_map_trace[pool_map_trace_next];
+  pool_map_trace_next = (pool_map_trace_next + 1U) % POOL_MAP_TRACE_ENTRIES;
+  pool_map_trace_count++;
+
+  entry_ptr -> time = tx_time_get();
+  entry_ptr -> pool_name = (pool_ptr != TX_NULL) ? pool_ptr -> tx_byte_pool_name : TX_NULL;
+  entry_ptr -> memory_ptr = memory_ptr;
+  entry_ptr -> size = size;
+  entry_ptr -> tag = tag;
+  entry_ptr -> thread_name = (thread_ptr != TX_NULL) ? thread_ptr -> tx_thread_name : TX_NULL;
+  entry_ptr -> release = release;
+  entry_ptr -> status = status;
+  TX_RESTORE
+}
+
+/**
+* @brief  Print the calls recorded since the previous dump, oldest first, and forget them.
+* @param  None
+* @retval None
+*/
+static VOID pool_map_trace_dump(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  POOL_MAP_TRACE_ENTRY *entry_ptr;
+  ULONG count;
+  ULONG kept;
+  ULONG first;
+  ULONG i;
+
+  TX_DISABLE
+  count = pool_map_trace_count;
+  kept = (count > POOL_MAP_TRACE_ENTRIES) ? POOL_MAP_TRACE_ENTRIES : count;
+  first = (pool_map_trace_next + POOL_MAP_TRACE_ENTRIES - kept) % POOL_MAP_TRACE_ENTRIES;
+  for (i = 0; i < kept; i++)
+  {
+    pool_map_trace_copy[i] = pool_map_trace[(first + i) % POOL_MAP_TRACE_ENTRIES];
+  }
+  pool_map_trace_count = 0U;
+  TX_RESTORE
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  printf("Byte pool trace, %lu calls, %lu not kept:\n", count, count - kept);
+
+  for (i = 0; i < kept; i++)
+  {
+    entry_ptr = &pool_map_trace_copy[i];
+    printf("  %8lu ms %-8s %s %6lu bytes at 0x%08lx, %s of %s in %s, status %u\n",
+           (unsigned long)(entry_ptr -> time * 1000U / TX_TIMER_TICKS_PER_SECOND),
+           entry_ptr -> release ? "release" : "allocate",
+           (entry_ptr -> status == TX_SUCCESS) ? "  " : "!!",
+           entry_ptr -> size, (ULONG)entry_ptr -> memory_ptr,
+           (entry_ptr -> tag != TX_NULL) ? entry_ptr -> tag : "untagged",
+           (entry_ptr -> thread_name != TX_NULL) ? entry_ptr -> thread_name : "no thread",
+           (entry_ptr -> pool_name != TX_NULL) ? entry_ptr -> pool_name : "?",
+           entry_ptr -> status);
+  }
+}
+#endif /* POOL_MAP_TRACE */
+
+#endif /* POOL_MAP */
@@ -0,0 +1,183 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    spsc_ring.c
+  * @author  MCD Application Team
+  * @brief   Single producer, single consumer ring of fixed-size messages
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "spsc_ring.h"
+#include "main.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Largest message, in words, as TX_16_ULONG for the queues */
+#define SPSC_RING_MESSAGE_SIZE_MAX    16U
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Create a ring in the given storage, the number of messages is rounded down to a power of two.
+* @param  ring: ring control block
+* @param  message_size: size of a message in ULONG words, 1 to 16
+* @param  start: storage of the messages, ULONG aligned
+* @param  size: size of the storage in bytes
+* @retval TX_SUCCESS, TX_PTR_ERROR or TX_SIZE_ERROR
+*/
+UINT spsc_ring_create(SPSC_RING *ring, UINT message_size, VOID *start, ULONG size)
+{
+  ULONG capacity;
+
+  if ((ring == TX_NULL) || (start == TX_NULL))
+  {
+    return TX_PTR_ERROR;
+  }
+
+  if ((message_size == 0U) || (message_size > SPSC_RING_MESSAGE_SIZE_MAX))
+  {
+    return TX_SIZE_ERROR;
+  }
+
+  capacity = size / (message_size * sizeof(ULONG));
+  if (capacity == 0U)
+  {
+    return TX_SIZE_ERROR;
+  }
+
+  /* Keep the highest bit only, so the indexes wrap with a mask. */
+  while ((capacity & (capacity - 1U)) != 0U)
+  {
+    capacity &= capacity - 1U;
+  }
+
+  ring -> spsc_ring_start = (ULONG *) start;
+  ring -> spsc_ring_message_size = message_size;
+  ring -> spsc_ring_capacity = capacity;
+  ring -> spsc_ring_head = 0U;
+  ring -> spsc_ring_tail = 0U;
+  ring -> spsc_ring_notify_group = TX_NULL;
+  ring -> spsc_ring_notify_flags = 0U;
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Set the event flags the producer sets when it puts a message into the empty ring.
+*         Must be called before the producer is started.
+* @param  ring: ring control block
+* @param  group: event flags group of the consumer, TX_NULL for none
+* @param  flags: flags of this ring in the group
+* @retval None
+*/
+VOID spsc_ring_notify_set(SPSC_RING *ring, TX_EVENT_FLAGS_GROUP *group, ULONG flags)
+{
+  ring -> spsc_ring_notify_group = group;
+  ring -> spsc_ring_notify_flags = flags;
+}
+
+/**
+* @brief  Put a message into the ring, called by the producer only, from an interrupt or a thread.
+* @param  ring: ring control block
+* @param  source: message of message_size words
+* @retval TX_SUCCESS or TX_QUEUE_FULL
+*/
+UINT spsc_ring_send(SPSC_RING *ring, VOID *source)
+{
+  ULONG head = ring -> spsc_ring_head;
+  ULONG *source_ptr = (ULONG *) source;
+  ULONG *slot_ptr;
+  UINT i;
+
+  if ((head - ring -> spsc_ring_tail) >= ring -> spsc_ring_capacity)
+  {
+    return TX_QUEUE_FULL;
+  }
+
+  slot_ptr = ring -> spsc_ring_start + ((head & (ring -> spsc_ring_capacity - 1U)) * ring -> spsc_ring_message_size);
+  for (i = 0U; i < ring -> spsc_ring_message_size; i++)
+  {
+    slot_ptr[i] = source_ptr[i];
+  }
+
+  /* The message must be written before the consumer sees the new head. */
+  __DMB();
+  ring -> spsc_ring_head = head + 1U;
+
+  if (ring -> spsc_ring_notify_group != TX_NULL)
+  {
+    /* Read the tail after the head is written, as the consumer reads the head after it writes the tail:
+       if the consumer took all messages before this one, it may be waiting, wake it up. Otherwise it
+       sees this message before it waits. */
+    __DMB();
+    if (ring -> spsc_ring_tail == head)
+    {
+      tx_event_flags_set(ring -> spsc_ring_notify_group, ring -> spsc_ring_notify_flags, TX_OR);
+    }
+  }
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Take the oldest message from the ring, called by the consumer thread only.
+* @param  ring: ring control block
+* @param  destination: buffer of message_size words
+* @param  wait_option: ticks to wait for a message on the notify event flags, TX_NO_WAIT
+*         or TX_WAIT_FOREVER. Without notify event flags the call does not wait.
+* @retval TX_SUCCESS or TX_QUEUE_EMPTY
+*/
+UINT spsc_ring_receive(SPSC_RING *ring, VOID *destination, ULONG wait_option)
+{
+  ULONG *destination_ptr = (ULONG *) destination;
+  ULONG *slot_ptr;
+  ULONG tail;
+  ULONG actual_flags;
+  UINT i;
+
+  for (;;)
+  {
+    tail = ring -> spsc_ring_tail;
+    if (ring -> spsc_ring_head != tail)
+    {
+      /* Read the message only after the head that published it. */
+      __DMB();
+      slot_ptr = ring -> spsc_ring_start + ((tail & (ring -> spsc_ring_capacity - 1U)) * ring -> spsc_ring_message_size);
+      for (i = 0U; i < ring -> spsc_ring_message_size; i++)
+      {
+        destination_ptr[i] = slot_ptr[i];
+      }
+
+      /* The message must be read before the producer may write its slot again, and the tail written
+         before the next read of the head. */
+      __DMB();
+      ring -> spsc_ring_tail = tail + 1U;
+      __DMB();
+
+      return TX_SUCCESS;
+    }
+
+    if ((wait_option == TX_NO_WAIT) || (ring -> spsc_ring_notify_group == TX_NULL))
+    {
+      return TX_QUEUE_EMPTY;
+    }
+
+    /* The flags may be left from a message already taken, the ring is checked again either way. */
+    if (tx_event_flags_get(ring -> spsc_ring_notify_group, ring -> spsc_ring_notify_flags, TX_OR_CLEAR,
+                           &actual_flags, wait_option) != TX_SUCCESS)
+    {
+      return TX_QUEUE_EMPTY;
+    }
+  }
+}
@@ -0,0 +1,176 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal_timebase_tx.c
+  * @brief   HAL time base derived from the ThreadX tick.
+  *
+  *          The HAL has no periodic interrupt of its own: HAL_GetTick() counts
+  *          the milliseconds from the ThreadX tick and the phase of SysTick
+  *          within it, so that the HAL timeouts and the kernel share one
+  *          notion of time, the ticks the low power mode skips included.
+  *          Before the kernel sets SysTick up, the DWT cycle counter times the
+  *          clock setup and the peripheral initialization instead. TIM6 is
+  *          left free.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_hal.h"
+#include "tx_api.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Milliseconds of a ThreadX tick */
+#define TIMEBASE_TICK_MS            (1000U / TX_TIMER_TICKS_PER_SECOND)
+
+/* SysTick cycles of a millisecond, see tx_initialize_low_level.s */
+#ifdef TX_LOW_POWER
+#define TIMEBASE_SYSTICK_MS_CYCLES  (SystemCoreClock / 8U / 1000U)
+#else
+#define TIMEBASE_SYSTICK_MS_CYCLES  (SystemCoreClock / 1000U)
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Cycle counter at the last HAL_InitTick(), and its cycles per millisecond then */
+static uint32_t timebase_cycles;
+static uint32_t timebase_ms_cycles;
+
+/* Milliseconds at the first ThreadX tick, set once the kernel counts the time */
+static uint32_t timebase_kernel_ms;
+static uint32_t timebase_kernel;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t timebase_kernel_get(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  This function starts the cycle counter as the time base until the kernel
+  *         starts. No interrupt is enabled, SysTick is left to ThreadX.
+  * @note   This function is called  automatically at the beginning of program after
+  *         reset by HAL_Init() or at any time when clock is configured, by HAL_RCC_ClockConfig().
+  *         The milliseconds counted at the previous clock are kept.
+  * @param  TickPriority: Tick interrupt priority.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+  uint32_t cycles;
+
+  if (TickPriority >= (1UL << __NVIC_PRIO_BITS))
+  {
+    return HAL_ERROR;
+  }
+  uwTickPrio = TickPriority;
+
+  /* The kernel counts the time already */
+  if (timebase_kernel)
+  {
+    return HAL_OK;
+  }
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  cycles = DWT->CYCCNT;
+  if (timebase_ms_cycles != 0U)
+  {
+    uwTick += (cycles - timebase_cycles) / timebase_ms_cycles;
+  }
+
+  timebase_cycles = cycles;
+  timebase_ms_cycles = SystemCoreClock / 1000U;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Provides a tick value in millisecond.
+  * @note   The first call once SysTick runs takes the time over from the cycle counter.
+  * @retval tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+  if (!timebase_kernel)
+  {
+    if (timebase_ms_cycles == 0U)
+    {
+      return uwTick;
+    }
+
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+      return uwTick + ((DWT->CYCCNT - timebase_cycles) / timebase_ms_cycles);
+    }
+
+    /* Go on from the time counted so far, the kernel started a moment ago */
+    timebase_kernel_ms = uwTick + ((DWT->CYCCNT - timebase_cycles) / timebase_ms_cycles);
+    timebase_kernel_ms -= timebase_kernel_get();
+    timebase_kernel = 1U;
+  }
+
+  return timebase_kernel_ms + timebase_kernel_get();
+}
+
+/**
+  * @brief  Suspend Tick increment.
+  * @note   The time base has no interrupt to suspend, the kernel keeps the time
+  *         across the low power mode.
+  * @param  None
+  * @retval None
+  */
+void HAL_SuspendTick(void)
+{
+}
+
+/**
+  * @brief  Resume Tick increment.
+  * @note   The time base has no interrupt to resume.
+  * @param  None
+  * @retval None
+  */
+void HAL_ResumeTick(void)
+{
+}
+
+/**
+  * @brief  Milliseconds since the kernel started, from the ThreadX tick and the SysTick
+  *         counter. A tick whose interrupt is pending, masked by the caller, is counted.
+  * @param  None
+  * @retval Time in ms
+  */
+static uint32_t timebase_kernel_get(void)
+{
+  ULONG ticks;
+  uint32_t left;
+  uint32_t pending;
+
+  /* Read again if the tick interrupt ran or the counter reloaded meanwhile */
+  do
+  {
+    ticks = tx_time_get();
+    left = SysTick->VAL;
+    pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  } while ((SysTick->VAL > left) || (tx_time_get() != ticks));
+
+  if (pending != 0U)
+  {
+    ticks++;
+  }
+
+  /* The counter reaches zero at the next tick, outside the stretched sleep periods */
+  return ((uint32_t)ticks * TIMEBASE_TICK_MS) +
+         (((TIMEBASE_SYSTICK_MS_CYCLES * TIMEBASE_TICK_MS) - 1U - left) / TIMEBASE_SYSTICK_MS_CYCLES);
+}
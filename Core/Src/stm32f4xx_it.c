@@ -22,6 +22,8 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "thread_profile.h"
+#include "nx_stm32_eth_config.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,7 +58,9 @@
 
 /* External variables --------------------------------------------------------*/
 extern ETH_HandleTypeDef heth;
-extern TIM_HandleTypeDef htim6;
+extern DMA_HandleTypeDef hdma_usart3_tx;
+extern UART_HandleTypeDef huart3;
+extern RNG_HandleTypeDef hrng;
 
 /* USER CODE BEGIN EV */
 
@@ -161,15 +165,31 @@ void DebugMon_Handler(void)
 /******************************************************************************/
 
 /**
-  * @brief This function handles TIM6 global interrupt, DAC1 and DAC2 underrun error interrupts.
+  * @brief This function handles DMA1 stream3 global interrupt.
   */
-void TIM6_DAC_IRQHandler(void)
+void DMA1_Stream3_IRQHandler(void)
 {
-  /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
-  /* USER CODE END TIM6_DAC_IRQn 0 */
-  HAL_TIM_IRQHandler(&htim6);
-  /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
-  /* USER CODE END TIM6_DAC_IRQn 1 */
+  /* USER CODE BEGIN DMA1_Stream3_IRQn 0 */
+  THREAD_PROFILE_ISR_ENTER();
+  /* USER CODE END DMA1_Stream3_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart3_tx);
+  /* USER CODE BEGIN DMA1_Stream3_IRQn 1 */
+  THREAD_PROFILE_ISR_EXIT();
+  /* USER CODE END DMA1_Stream3_IRQn 1 */
+}
+
+/**
+  * @brief This function handles USART3 global interrupt.
+  */
+void USART3_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART3_IRQn 0 */
+  THREAD_PROFILE_ISR_ENTER();
+  /* USER CODE END USART3_IRQn 0 */
+  HAL_UART_IRQHandler(&huart3);
+  /* USER CODE BEGIN USART3_IRQn 1 */
+  THREAD_PROFILE_ISR_EXIT();
+  /* USER CODE END USART3_IRQn 1 */
 }
 
 /**
@@ -178,14 +198,38 @@ void TIM6_DAC_IRQHandler(void)
 void ETH_IRQHandler(void)
 {
   /* USER CODE BEGIN ETH_IRQn 0 */
-
+  THREAD_PROFILE_ISR_ENTER();
   /* USER CODE END ETH_IRQn 0 */
   HAL_ETH_IRQHandler(&heth);
   /* USER CODE BEGIN ETH_IRQn 1 */
-
+  THREAD_PROFILE_ISR_EXIT();
   /* USER CODE END ETH_IRQn 1 */
 }
 
-/* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles HASH and RNG global interrupts.
+  */
+void HASH_RNG_IRQHandler(void)
+{
+  /* USER CODE BEGIN HASH_RNG_IRQn 0 */
+  THREAD_PROFILE_ISR_ENTER();
+  /* USER CODE END HASH_RNG_IRQn 0 */
+  HAL_RNG_IRQHandler(&hrng);
+  /* USER CODE BEGIN HASH_RNG_IRQn 1 */
+  THREAD_PROFILE_ISR_EXIT();
+  /* USER CODE END HASH_RNG_IRQn 1 */
+}
 
+/* USER CODE BEGIN 1 */
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+/**
+  * @brief This function handles the EXTI line of the nINT output of the PHY.
+  */
+void NX_ETH_PHY_INTERRUPT_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+  HAL_GPIO_EXTI_IRQHandler(NX_ETH_PHY_INTERRUPT_PIN);
+  THREAD_PROFILE_ISR_EXIT();
+}
+#endif
 /* USER CODE END 1 */
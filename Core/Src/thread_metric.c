@@ -0,0 +1,697 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_metric.c
+  * @author  MCD Application Team
+  * @brief   Thread-Metric measurement of the kernel services, as configured
+  *
+  *          The tests of the Thread-Metric suite, each run alone for
+  *          THREAD_METRIC_PERIOD over the ThreadX build of the application,
+  *          tx_user.h and the make options included:
+  *           - cooperative context switch, 5 threads of one priority
+  *             relinquishing in turn,
+  *           - preemptive context switch, 5 threads of rising priorities,
+  *             each resuming the next one and suspending itself,
+  *           - interrupt processing, a thread pends an interrupt whose
+  *             handler puts a semaphore, the thread gets it,
+  *           - interrupt preemption processing, the handler resumes a thread
+  *             of higher priority than the one that pended it,
+  *           - message processing, a 16-byte message sent to a queue and
+  *             received back,
+  *           - synchronization processing, a semaphore got and put,
+  *           - memory allocation, a 128-byte block allocated and released.
+  *          Each counted step increments a counter, the report thread reads
+  *          them at the end of the period and prints their total, as the
+  *          original suite does, and the period in CPU cycles over that
+  *          total. The counters of a test must stay within one of each
+  *          other, and no service may fail, or the test is reported failed.
+  *          The interrupt is the TIM7 vector, pended from software, the
+  *          timer itself is not used. In the performance harness build,
+  *          thread_metric_run() runs the tests from the harness instead,
+  *          each cycle count a result compared with its baseline.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "thread_metric.h"
+#include "thread_profile.h"
+#include "perf_harness.h"
+#include "main.h"
+#include <stdio.h>
+
+#if defined(THREAD_METRIC) || defined(PERF_HARNESS)
+
+/* Private define ------------------------------------------------------------*/
+#define THREAD_METRIC_THREADS         5U
+
+/* A counter per thread, then the one of the interrupt handler */
+#define THREAD_METRIC_ISR_COUNTER     THREAD_METRIC_THREADS
+#define THREAD_METRIC_COUNTERS        (THREAD_METRIC_THREADS + 1U)
+
+/* Messages of 16 bytes, as in the original suite */
+#define THREAD_METRIC_MESSAGE_WORDS   4U
+#define THREAD_METRIC_QUEUE_MESSAGES  4U
+
+#define THREAD_METRIC_BLOCK_SIZE      128U
+#define THREAD_METRIC_POOL_SIZE       (2U * (THREAD_METRIC_BLOCK_SIZE + sizeof(VOID *)))
+
+/* Objects created by the test running */
+#define THREAD_METRIC_SEMAPHORE       0x01U
+#define THREAD_METRIC_QUEUE           0x02U
+#define THREAD_METRIC_POOL            0x04U
+
+/* What the interrupt handler does */
+#define THREAD_METRIC_ISR_SEMAPHORE   0U   /* Puts the semaphore                            */
+#define THREAD_METRIC_ISR_RESUME      1U   /* Resumes the second thread                     */
+
+/* Private types -------------------------------------------------------------*/
+typedef struct THREAD_METRIC_TEST_STRUCT
+{
+  const CHAR *name;
+  UINT      (*start)(VOID);
+  UINT        counters;   /* Thread counters of the test, from the first one */
+  UINT        interrupt;  /* The interrupt handler counts too */
+} THREAD_METRIC_TEST;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT thread_metric_cooperative_start(VOID);
+static UINT thread_metric_preemptive_start(VOID);
+static UINT thread_metric_interrupt_start(VOID);
+static UINT thread_metric_interrupt_preemption_start(VOID);
+static UINT thread_metric_message_start(VOID);
+static UINT thread_metric_synchronization_start(VOID);
+static UINT thread_metric_memory_start(VOID);
+static VOID thread_metric_stop(VOID);
+static UINT thread_metric_thread_create(UINT index, VOID (*entry)(ULONG), UINT priority, UINT auto_start);
+static VOID thread_metric_interrupt_cause(VOID);
+static UINT thread_metric_report(const THREAD_METRIC_TEST *test, const ULONG *counters);
+#ifdef THREAD_METRIC
+static VOID thread_metric_report_entry(ULONG thread_input);
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static const THREAD_METRIC_TEST thread_metric_tests[] =
+{
+  { "Cooperative switch",     thread_metric_cooperative_start,          THREAD_METRIC_THREADS, TX_FALSE },
+  { "Preemptive switch",      thread_metric_preemptive_start,           THREAD_METRIC_THREADS, TX_FALSE },
+  { "Interrupt",              thread_metric_interrupt_start,            1U,                    TX_TRUE  },
+  { "Interrupt preemption",   thread_metric_interrupt_preemption_start, 2U,                    TX_TRUE  },
+  { "Message",                thread_metric_message_start,              1U,                    TX_FALSE },
+  { "Synchronization",        thread_metric_synchronization_start,      1U,                    TX_FALSE },
+  { "Memory allocation",      thread_metric_memory_start,               1U,                    TX_FALSE },
+};
+
+static volatile ULONG thread_metric_counters[THREAD_METRIC_COUNTERS];
+
+/* Services that did not succeed at once, they all should */
+static volatile ULONG thread_metric_errors;
+
+static UINT thread_metric_isr_action;
+
+static TX_THREAD thread_metric_threads[THREAD_METRIC_THREADS];
+static ULONG thread_metric_stacks[THREAD_METRIC_THREADS][THREAD_METRIC_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+/* Threads created by the test running, a bit each */
+static UINT thread_metric_thread_mask;
+
+static UINT thread_metric_objects;
+static TX_SEMAPHORE thread_metric_semaphore;
+static TX_QUEUE thread_metric_queue;
+static ULONG thread_metric_queue_storage[THREAD_METRIC_QUEUE_MESSAGES * THREAD_METRIC_MESSAGE_WORDS];
+static TX_BLOCK_POOL thread_metric_pool;
+static ULONG thread_metric_pool_memory[THREAD_METRIC_POOL_SIZE / sizeof(ULONG)];
+
+#ifdef THREAD_METRIC
+/* Twice the stack of a test thread, for printf. */
+static TX_THREAD thread_metric_report_thread;
+static ULONG thread_metric_report_stack[2U * THREAD_METRIC_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+#ifdef THREAD_METRIC
+/**
+* @brief  Create the report thread, it runs the tests once the kernel starts.
+* @param  None
+* @retval TX_SUCCESS or the error of the thread creation
+*/
+UINT thread_metric_start(VOID)
+{
+  return tx_thread_create(&thread_metric_report_thread, "Thread-Metric report thread", thread_metric_report_entry, 0,
+                          thread_metric_report_stack, sizeof(thread_metric_report_stack),
+                          THREAD_METRIC_REPORT_PRIORITY, THREAD_METRIC_REPORT_PRIORITY, TX_NO_TIME_SLICE,
+                          TX_AUTO_START);
+}
+#endif
+
+/**
+* @brief  Run each test for the period, then report it. The calling thread is raised to
+*         THREAD_METRIC_REPORT_PRIORITY meanwhile, above the tests, and needs the stack of printf.
+* @param  None
+* @retval TX_SUCCESS, or TX_NOT_DONE or the error of the start of the last test that failed
+*/
+UINT thread_metric_run(VOID)
+{
+  ULONG counters[THREAD_METRIC_COUNTERS];
+  UINT ret = TX_SUCCESS;
+  UINT status;
+  UINT priority;
+  UINT i;
+  UINT j;
+
+  HAL_NVIC_SetPriority(THREAD_METRIC_IRQn, THREAD_METRIC_IRQ_PRIORITY, 0);
+  tx_thread_priority_change(tx_thread_identify(), THREAD_METRIC_REPORT_PRIORITY, &priority);
+
+  printf("Thread-Metric, CPU at %lu MHz, %lu s per test\n", (unsigned long)(SystemCoreClock / 1000000U),
+         (unsigned long)(THREAD_METRIC_PERIOD / TX_TIMER_TICKS_PER_SECOND));
+
+  /* A failed test is reported and the next ones still run. */
+  for (i = 0; i < sizeof(thread_metric_tests) / sizeof(thread_metric_tests[0]); i++)
+  {
+    for (j = 0; j < THREAD_METRIC_COUNTERS; j++)
+    {
+      thread_metric_counters[j] = 0;
+    }
+    thread_metric_errors = 0;
+
+    status = thread_metric_tests[i].start();
+    if (status == TX_SUCCESS)
+    {
+      tx_thread_sleep(THREAD_METRIC_PERIOD);
+    }
+
+    for (j = 0; j < THREAD_METRIC_COUNTERS; j++)
+    {
+      counters[j] = thread_metric_counters[j];
+    }
+
+    thread_metric_stop();
+
+    if (status != TX_SUCCESS)
+    {
+      printf("%s failed: 0x%x\n", thread_metric_tests[i].name, status);
+    }
+    else
+    {
+      status = thread_metric_report(&thread_metric_tests[i], counters);
+    }
+
+    ret = (ret == TX_SUCCESS) ? status : ret;
+  }
+
+  printf("Thread-Metric done\n");
+
+  tx_thread_priority_change(tx_thread_identify(), priority, &priority);
+
+  return ret;
+}
+
+/**
+* @brief  This function handles the TIM7 vector, pended by the interrupt tests.
+* @param  None
+* @retval None
+*/
+void TIM7_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+
+  thread_metric_counters[THREAD_METRIC_ISR_COUNTER]++;
+
+  if (thread_metric_isr_action == THREAD_METRIC_ISR_SEMAPHORE)
+  {
+    if (tx_semaphore_put(&thread_metric_semaphore) != TX_SUCCESS)
+    {
+      thread_metric_errors++;
+    }
+  }
+  else
+  {
+    if (tx_thread_resume(&thread_metric_threads[1]) != TX_SUCCESS)
+    {
+      thread_metric_errors++;
+    }
+  }
+
+  THREAD_PROFILE_ISR_EXIT();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Cooperative context switch: count, then let the next thread of the priority run.
+* @param  index: counter of the thread
+* @retval None
+*/
+static VOID thread_metric_cooperative_entry(ULONG index)
+{
+  for (;;)
+  {
+    thread_metric_counters[index]++;
+    tx_thread_relinquish();
+  }
+}
+
+/**
+* @brief  Preemptive context switch: resume the thread above, count once it has suspended itself,
+*         then suspend to the thread below. The first one only resumes, the last one only suspends.
+* @param  index: counter of the thread, its priority rising with it
+* @retval None
+*/
+static VOID thread_metric_preemptive_entry(ULONG index)
+{
+  for (;;)
+  {
+    if (index < (THREAD_METRIC_THREADS - 1U))
+    {
+      if (tx_thread_resume(&thread_metric_threads[index + 1U]) != TX_SUCCESS)
+      {
+        thread_metric_errors++;
+      }
+    }
+
+    thread_metric_counters[index]++;
+
+    if (index > 0U)
+    {
+      tx_thread_suspend(&thread_metric_threads[index]);
+    }
+  }
+}
+
+/**
+* @brief  Interrupt processing: pend the interrupt, then get the semaphore its handler put.
+* @param  index: not used
+* @retval None
+*/
+static VOID thread_metric_interrupt_entry(ULONG index)
+{
+  TX_PARAMETER_NOT_USED(index);
+
+  for (;;)
+  {
+    thread_metric_interrupt_cause();
+
+    if (tx_semaphore_get(&thread_metric_semaphore, TX_NO_WAIT) != TX_SUCCESS)
+    {
+      thread_metric_errors++;
+    }
+
+    thread_metric_counters[0]++;
+  }
+}
+
+/**
+* @brief  Interrupt preemption processing: the first thread pends the interrupt, whose handler
+*         resumes the second one, which counts and suspends itself before the first one counts.
+* @param  index: counter of the thread
+* @retval None
+*/
+static VOID thread_metric_interrupt_preemption_entry(ULONG index)
+{
+  for (;;)
+  {
+    if (index == 0U)
+    {
+      thread_metric_interrupt_cause();
+      thread_metric_counters[0]++;
+    }
+    else
+    {
+      thread_metric_counters[index]++;
+      tx_thread_suspend(&thread_metric_threads[index]);
+    }
+  }
+}
+
+/**
+* @brief  Message processing: send a message to the queue and receive it back.
+* @param  index: not used
+* @retval None
+*/
+static VOID thread_metric_message_entry(ULONG index)
+{
+  ULONG sent[THREAD_METRIC_MESSAGE_WORDS] = { 0x11223344U, 0x55667788U, 0x99AABBCCU, 0 };
+  ULONG received[THREAD_METRIC_MESSAGE_WORDS];
+
+  TX_PARAMETER_NOT_USED(index);
+
+  for (;;)
+  {
+    sent[THREAD_METRIC_MESSAGE_WORDS - 1U]++;
+
+    if ((tx_queue_send(&thread_metric_queue, sent, TX_NO_WAIT) != TX_SUCCESS) ||
+        (tx_queue_receive(&thread_metric_queue, received, TX_NO_WAIT) != TX_SUCCESS) ||
+        (received[THREAD_METRIC_MESSAGE_WORDS - 1U] != sent[THREAD_METRIC_MESSAGE_WORDS - 1U]))
+    {
+      thread_metric_errors++;
+    }
+
+    thread_metric_counters[0]++;
+  }
+}
+
+/**
+* @brief  Synchronization processing: get the semaphore and put it back.
+* @param  index: not used
+* @retval None
+*/
+static VOID thread_metric_synchronization_entry(ULONG index)
+{
+  TX_PARAMETER_NOT_USED(index);
+
+  for (;;)
+  {
+    if ((tx_semaphore_get(&thread_metric_semaphore, TX_NO_WAIT) != TX_SUCCESS) ||
+        (tx_semaphore_put(&thread_metric_semaphore) != TX_SUCCESS))
+    {
+      thread_metric_errors++;
+    }
+
+    thread_metric_counters[0]++;
+  }
+}
+
+/**
+* @brief  Memory allocation: allocate a block and release it.
+* @param  index: not used
+* @retval None
+*/
+static VOID thread_metric_memory_entry(ULONG index)
+{
+  VOID *block_ptr;
+
+  TX_PARAMETER_NOT_USED(index);
+
+  for (;;)
+  {
+    if ((tx_block_allocate(&thread_metric_pool, &block_ptr, TX_NO_WAIT) != TX_SUCCESS) ||
+        (tx_block_release(block_ptr) != TX_SUCCESS))
+    {
+      thread_metric_errors++;
+    }
+
+    thread_metric_counters[0]++;
+  }
+}
+
+/**
+* @brief  Start the cooperative context switch test.
+* @param  None
+* @retval TX_SUCCESS or the error of the thread creation
+*/
+static UINT thread_metric_cooperative_start(VOID)
+{
+  UINT ret = TX_SUCCESS;
+  UINT i;
+
+  for (i = 0; (i < THREAD_METRIC_THREADS) && (ret == TX_SUCCESS); i++)
+  {
+    ret = thread_metric_thread_create(i, thread_metric_cooperative_entry, THREAD_METRIC_PRIORITY, TX_AUTO_START);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Start the preemptive context switch test, from the thread of the lowest priority.
+* @param  None
+* @retval TX_SUCCESS or the error of the thread creation
+*/
+static UINT thread_metric_preemptive_start(VOID)
+{
+  UINT ret = TX_SUCCESS;
+  UINT i;
+
+  for (i = 0; (i < THREAD_METRIC_THREADS) && (ret == TX_SUCCESS); i++)
+  {
+    ret = thread_metric_thread_create(i, thread_metric_preemptive_entry, THREAD_METRIC_PRIORITY - i,
+                                      (i == 0U) ? TX_AUTO_START : TX_DONT_START);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Start the interrupt processing test.
+* @param  None
+* @retval TX_SUCCESS or the error of the object creation
+*/
+static UINT thread_metric_interrupt_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_semaphore_create(&thread_metric_semaphore, "Thread-Metric semaphore", 0);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+  thread_metric_objects |= THREAD_METRIC_SEMAPHORE;
+
+  thread_metric_isr_action = THREAD_METRIC_ISR_SEMAPHORE;
+  HAL_NVIC_EnableIRQ(THREAD_METRIC_IRQn);
+
+  return thread_metric_thread_create(0, thread_metric_interrupt_entry, THREAD_METRIC_PRIORITY, TX_AUTO_START);
+}
+
+/**
+* @brief  Start the interrupt preemption processing test.
+* @param  None
+* @retval TX_SUCCESS or the error of the thread creation
+*/
+static UINT thread_metric_interrupt_preemption_start(VOID)
+{
+  UINT ret;
+
+  thread_metric_isr_action = THREAD_METRIC_ISR_RESUME;
+
+  ret = thread_metric_thread_create(1, thread_metric_interrupt_preemption_entry, THREAD_METRIC_PRIORITY - 1U,
+                                    TX_DONT_START);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  HAL_NVIC_EnableIRQ(THREAD_METRIC_IRQn);
+
+  return thread_metric_thread_create(0, thread_metric_interrupt_preemption_entry, THREAD_METRIC_PRIORITY,
+                                     TX_AUTO_START);
+}
+
+/**
+* @brief  Start the message processing test.
+* @param  None
+* @retval TX_SUCCESS or the error of the object creation
+*/
+static UINT thread_metric_message_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_queue_create(&thread_metric_queue, "Thread-Metric queue", TX_4_ULONG,
+                        thread_metric_queue_storage, sizeof(thread_metric_queue_storage));
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+  thread_metric_objects |= THREAD_METRIC_QUEUE;
+
+  return thread_metric_thread_create(0, thread_metric_message_entry, THREAD_METRIC_PRIORITY, TX_AUTO_START);
+}
+
+/**
+* @brief  Start the synchronization processing test.
+* @param  None
+* @retval TX_SUCCESS or the error of the object creation
+*/
+static UINT thread_metric_synchronization_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_semaphore_create(&thread_metric_semaphore, "Thread-Metric semaphore", 1);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+  thread_metric_objects |= THREAD_METRIC_SEMAPHORE;
+
+  return thread_metric_thread_create(0, thread_metric_synchronization_entry, THREAD_METRIC_PRIORITY, TX_AUTO_START);
+}
+
+/**
+* @brief  Start the memory allocation test.
+* @param  None
+* @retval TX_SUCCESS or the error of the object creation
+*/
+static UINT thread_metric_memory_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_block_pool_create(&thread_metric_pool, "Thread-Metric pool", THREAD_METRIC_BLOCK_SIZE,
+                             thread_metric_pool_memory, sizeof(thread_metric_pool_memory));
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+  thread_metric_objects |= THREAD_METRIC_POOL;
+
+  return thread_metric_thread_create(0, thread_metric_memory_entry, THREAD_METRIC_PRIORITY, TX_AUTO_START);
+}
+
+/**
+* @brief  Stop the test running: the interrupt first, then its threads and its objects. The report
+*         thread preempted the threads, none is within a service.
+* @param  None
+* @retval None
+*/
+static VOID thread_metric_stop(VOID)
+{
+  UINT i;
+
+  HAL_NVIC_DisableIRQ(THREAD_METRIC_IRQn);
+  HAL_NVIC_ClearPendingIRQ(THREAD_METRIC_IRQn);
+
+  for (i = 0; i < THREAD_METRIC_THREADS; i++)
+  {
+    if (thread_metric_thread_mask & (1U << i))
+    {
+      tx_thread_terminate(&thread_metric_threads[i]);
+      tx_thread_delete(&thread_metric_threads[i]);
+    }
+  }
+  thread_metric_thread_mask = 0;
+
+  if (thread_metric_objects & THREAD_METRIC_SEMAPHORE)
+  {
+    tx_semaphore_delete(&thread_metric_semaphore);
+  }
+  if (thread_metric_objects & THREAD_METRIC_QUEUE)
+  {
+    tx_queue_delete(&thread_metric_queue);
+  }
+  if (thread_metric_objects & THREAD_METRIC_POOL)
+  {
+    tx_block_pool_delete(&thread_metric_pool);
+  }
+  thread_metric_objects = 0;
+}
+
+/**
+* @brief  Create a thread of the test running.
+* @param  index: thread, its stack and the input of its entry function
+* @param  entry: entry function
+* @param  priority: priority of the thread
+* @param  auto_start: TX_AUTO_START, or TX_DONT_START for a thread the test resumes
+* @retval TX_SUCCESS or the error of the thread creation
+*/
+static UINT thread_metric_thread_create(UINT index, VOID (*entry)(ULONG), UINT priority, UINT auto_start)
+{
+  UINT ret;
+
+  ret = tx_thread_create(&thread_metric_threads[index], "Thread-Metric thread", entry, index,
+                         thread_metric_stacks[index], sizeof(thread_metric_stacks[index]),
+                         priority, priority, TX_NO_TIME_SLICE, auto_start);
+  if (ret == TX_SUCCESS)
+  {
+    thread_metric_thread_mask |= 1U << index;
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Pend the interrupt of the tests, it is taken before the next instruction.
+* @param  None
+* @retval None
+*/
+static VOID thread_metric_interrupt_cause(VOID)
+{
+  NVIC->STIR = (uint32_t)THREAD_METRIC_IRQn;
+  __DSB();
+  __ISB();
+}
+
+/**
+* @brief  Report a test, and check its counters stayed in step.
+* @param  test: test run
+* @param  counters: counters at the end of the period, the interrupt one last
+* @retval TX_SUCCESS, or TX_NOT_DONE when the counters are out of step or a service failed
+*/
+static UINT thread_metric_report(const THREAD_METRIC_TEST *test, const ULONG *counters)
+{
+  ULONG64 cycles_x10;
+  ULONG total = 0;
+  ULONG count;
+  UINT in_step = TX_TRUE;
+  UINT i;
+
+  for (i = 0; i < THREAD_METRIC_COUNTERS; i++)
+  {
+    if ((i >= test -> counters) && !((i == THREAD_METRIC_ISR_COUNTER) && test -> interrupt))
+    {
+      continue;
+    }
+
+    count = counters[i];
+    total += count;
+
+    if ((count + 1U < counters[0]) || (count > counters[0] + 1U))
+    {
+      in_step = TX_FALSE;
+    }
+  }
+
+  if (total == 0U)
+  {
+    total = 1U;
+  }
+
+  /* No floating point printf with the nano C library, tenths are printed apart. */
+  cycles_x10 = ((ULONG64)THREAD_METRIC_PERIOD * SystemCoreClock * 10U) / ((ULONG64)TX_TIMER_TICKS_PER_SECOND * total);
+
+  printf("%-24s %10lu, %5lu.%lu cycles each\n", test -> name, (unsigned long)total,
+         (unsigned long)(cycles_x10 / 10U), (unsigned long)(cycles_x10 % 10U));
+  perf_harness_result("rtos", "cycles x10", (ULONG)cycles_x10, PERF_HARNESS_LOWER, "%s", test -> name);
+
+  if (!in_step)
+  {
+    printf("%s failed: counters out of step\n", test -> name);
+    return TX_NOT_DONE;
+  }
+
+  if (thread_metric_errors != 0U)
+  {
+    printf("%s failed: %lu services not done\n", test -> name, (unsigned long)thread_metric_errors);
+    return TX_NOT_DONE;
+  }
+
+  return TX_SUCCESS;
+}
+
+#ifdef THREAD_METRIC
+/**
+* @brief  Run the tests, then end in the success or the error handler.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID thread_metric_report_entry(ULONG thread_input)
+{
+  TX_PARAMETER_NOT_USED(thread_input);
+
+  if (thread_metric_run() != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
+  Success_Handler();
+}
+#endif
+
+#endif /* THREAD_METRIC || PERF_HARNESS */
@@ -0,0 +1,383 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_profile.c
+  * @author  MCD Application Team
+  * @brief   CPU time of the threads and interrupts, and stack usage of the threads
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "thread_profile.h"
+#include "tx_thread.h"
+#include "main.h"
+#include "nx_stm32_eth_config.h"
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+/* Private define ------------------------------------------------------------*/
+/* Exception numbers of the STM32F429, the 16 of the core then its 91 interrupts */
+#define THREAD_PROFILE_VECTORS        (16U + 91U)
+
+/* Interrupts preempting each other, one per priority level at most */
+#define THREAD_PROFILE_NESTING        16U
+
+/* Threads and interrupts reported, the others are left out */
+#define THREAD_PROFILE_THREADS        16U
+#define THREAD_PROFILE_ISRS           8U
+
+/* DWT cycle counter */
+#define THREAD_PROFILE_COUNTER        (DWT -> CYCCNT)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct THREAD_PROFILE_ENTRY_STRUCT
+{
+  const CHAR *name;
+  ULONG64     cycles;
+  ULONG       stack_used;
+  ULONG       stack_size;
+} THREAD_PROFILE_ENTRY;
+
+/* Private variables ---------------------------------------------------------*/
+/* Counter of what runs now, a thread, an interrupt or the idle loop, and the cycle count
+   it was last charged at. */
+static ULONG64 *thread_profile_current_ptr;
+static ULONG thread_profile_last_time;
+
+/* Counters of what the interrupts in progress preempted. */
+static ULONG64 *thread_profile_preempted[THREAD_PROFILE_NESTING] CCMRAM_BSS;
+static UINT thread_profile_nesting;
+
+static ULONG64 thread_profile_idle;
+
+/* Cycles of the threads and interrupts since the start, never cleared, the load the clock
+   governor reads. */
+static ULONG thread_profile_busy;
+static ULONG64 thread_profile_isr[THREAD_PROFILE_VECTORS] CCMRAM_BSS;
+static ULONG thread_profile_switches;
+
+/* Time of the last dump. */
+static ULONG thread_profile_dump_time;
+
+/* Interrupts handled in this application, the others are printed by number. */
+static const struct
+{
+  UINT        vector;
+  const CHAR *name;
+} thread_profile_isr_names[] =
+{
+  { 16U + (UINT)SysTick_IRQn,       "SysTick" },
+  { 16U + (UINT)ETH_IRQn,           "ETH" },
+  { 16U + (UINT)HASH_RNG_IRQn,      "RNG" },
+  { 16U + (UINT)USART3_IRQn,        "USART3" },
+  { 16U + (UINT)DMA1_Stream3_IRQn,  "USART3 TX DMA" },
+  { 16U + (UINT)DMA2_Stream0_IRQn,  "ADC1 DMA" },
+  { 16U + (UINT)DMA2_Stream1_IRQn,  "Copy DMA" },
+  { 16U + (UINT)DMA2_Stream2_IRQn,  "CRC DMA" },
+#ifdef NX_CRYPTO_STM32_HW
+  { 16U + (UINT)DMA2_Stream5_IRQn,  "CRYP DMA" },
+  { 16U + (UINT)DMA2_Stream7_IRQn,  "HASH DMA" },
+#endif
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+  { 16U + (UINT)NX_ETH_PHY_INTERRUPT_IRQn, "PHY nINT" },
+#endif
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID thread_profile_charge(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the DWT cycle counter and charge the time to the idle loop until the first thread runs.
+*         Called from tx_application_define(), before the scheduler starts.
+* @param  None
+* @retval None
+*/
+VOID thread_profile_init(VOID)
+{
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  thread_profile_current_ptr = &thread_profile_idle;
+  thread_profile_last_time = THREAD_PROFILE_COUNTER;
+  thread_profile_dump_time = tx_time_get();
+}
+
+/**
+* @brief  Called by the scheduler when the thread in _tx_thread_current_ptr starts running.
+* @param  None
+* @retval None
+*/
+VOID _tx_execution_thread_enter(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  thread_profile_charge();
+  thread_profile_current_ptr = &_tx_thread_current_ptr -> tx_thread_execution_time_total;
+  thread_profile_switches++;
+  TX_RESTORE
+}
+
+/**
+* @brief  Called by the scheduler when the running thread stops, the idle loop or the next thread follows.
+* @param  None
+* @retval None
+*/
+VOID _tx_execution_thread_exit(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  thread_profile_charge();
+  thread_profile_current_ptr = &thread_profile_idle;
+  TX_RESTORE
+}
+
+/**
+* @brief  Called at the start of an interrupt handler, the time is charged to the active exception.
+* @param  None
+* @retval None
+*/
+VOID _tx_execution_isr_enter(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG vector = __get_IPSR();
+
+  TX_DISABLE
+  if ((thread_profile_nesting < THREAD_PROFILE_NESTING) && (vector < THREAD_PROFILE_VECTORS))
+  {
+    thread_profile_charge();
+    thread_profile_preempted[thread_profile_nesting] = thread_profile_current_ptr;
+    thread_profile_current_ptr = &thread_profile_isr[vector];
+  }
+
+  /* Count the levels not recorded too, so the exits stay paired with the entries. */
+  thread_profile_nesting++;
+  TX_RESTORE
+}
+
+/**
+* @brief  Called at the end of an interrupt handler, the time is charged again to what it preempted.
+* @param  None
+* @retval None
+*/
+VOID _tx_execution_isr_exit(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if (thread_profile_nesting > 0U)
+  {
+    thread_profile_nesting--;
+    if (thread_profile_nesting < THREAD_PROFILE_NESTING)
+    {
+      thread_profile_charge();
+      thread_profile_current_ptr = thread_profile_preempted[thread_profile_nesting];
+    }
+  }
+  TX_RESTORE
+}
+
+/**
+* @brief  Cycles the threads and the interrupts ran since the start, up to now. The count wraps,
+*         the difference of two reads less than 23 s apart at 180 MHz is the load between them.
+* @param  None
+* @retval Busy cycles, modulo 2^32
+*/
+ULONG thread_profile_busy_cycles(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG busy;
+
+  TX_DISABLE
+  thread_profile_charge();
+  busy = thread_profile_busy;
+  TX_RESTORE
+
+  return busy;
+}
+
+/**
+* @brief  Print the CPU share of the threads, the interrupts and the idle loop since the previous dump,
+*         then clear their counters, and print the stack usage of the threads.
+* @param  None
+* @retval None
+*/
+VOID thread_profile_dump(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  THREAD_PROFILE_ENTRY threads[THREAD_PROFILE_THREADS];
+  UINT isr_vectors[THREAD_PROFILE_ISRS];
+  ULONG64 isr_cycles[THREAD_PROFILE_ISRS];
+  ULONG64 idle_cycles;
+  ULONG64 total;
+  TX_THREAD *thread_ptr;
+  ULONG switches;
+  ULONG elapsed;
+  ULONG permille;
+  UINT thread_count = 0;
+  UINT isr_count = 0;
+  UINT i;
+  UINT j;
+
+  /* Take the counters of the interval and clear them at once, so the shares add up to 100%.
+     The stack usage search is short enough to be done here too, while the threads cannot be deleted. */
+  TX_DISABLE
+  thread_profile_charge();
+
+  thread_ptr = _tx_thread_created_ptr;
+  for (i = 0; (i < _tx_thread_created_count) && (thread_count < THREAD_PROFILE_THREADS); i++)
+  {
+    threads[thread_count].name = thread_ptr -> tx_thread_name;
+    threads[thread_count].cycles = thread_ptr -> tx_thread_execution_time_total;
+    threads[thread_count].stack_size = thread_ptr -> tx_thread_stack_size;
+    threads[thread_count].stack_used = thread_profile_stack_used(thread_ptr);
+    thread_ptr -> tx_thread_execution_time_total = 0;
+    thread_count++;
+    thread_ptr = thread_ptr -> tx_thread_created_next;
+  }
+
+  for (i = 0; i < THREAD_PROFILE_VECTORS; i++)
+  {
+    if ((thread_profile_isr[i] != 0U) && (isr_count < THREAD_PROFILE_ISRS))
+    {
+      isr_vectors[isr_count] = i;
+      isr_cycles[isr_count] = thread_profile_isr[i];
+      isr_count++;
+    }
+    thread_profile_isr[i] = 0;
+  }
+
+  idle_cycles = thread_profile_idle;
+  thread_profile_idle = 0;
+  switches = thread_profile_switches;
+  thread_profile_switches = 0;
+  elapsed = tx_time_get() - thread_profile_dump_time;
+  thread_profile_dump_time += elapsed;
+  TX_RESTORE
+
+  total = idle_cycles;
+  for (i = 0; i < thread_count; i++)
+  {
+    total += threads[i].cycles;
+  }
+  for (i = 0; i < isr_count; i++)
+  {
+    total += isr_cycles[i];
+  }
+  if (total == 0U)
+  {
+    total = 1;
+  }
+
+  printf("Thread profile, %lu ms, %lu context switches/s:\n",
+         (unsigned long)(elapsed * 1000U / TX_TIMER_TICKS_PER_SECOND),
+         (elapsed != 0U) ? (unsigned long)((switches * TX_TIMER_TICKS_PER_SECOND) / elapsed) : 0UL);
+
+  for (i = 0; i < thread_count; i++)
+  {
+    permille = (ULONG)((threads[i].cycles * 1000U) / total);
+    printf("  %-24s %3lu.%lu%% CPU, stack %lu of %lu bytes\n", threads[i].name, permille / 10, permille % 10,
+           threads[i].stack_used, threads[i].stack_size);
+  }
+
+  for (i = 0; i < isr_count; i++)
+  {
+    permille = (ULONG)((isr_cycles[i] * 1000U) / total);
+    for (j = 0; j < (sizeof(thread_profile_isr_names) / sizeof(thread_profile_isr_names[0])); j++)
+    {
+      if (thread_profile_isr_names[j].vector == isr_vectors[i])
+      {
+        break;
+      }
+    }
+
+    if (j < (sizeof(thread_profile_isr_names) / sizeof(thread_profile_isr_names[0])))
+    {
+      printf("  ISR %-20s %3lu.%lu%% CPU\n", thread_profile_isr_names[j].name, permille / 10, permille % 10);
+    }
+    else
+    {
+      printf("  ISR %-20d %3lu.%lu%% CPU\n", (int)isr_vectors[i] - 16, permille / 10, permille % 10);
+    }
+  }
+
+  permille = (ULONG)((idle_cycles * 1000U) / total);
+  printf("  %-24s %3lu.%lu%% CPU\n", "Idle", permille / 10, permille % 10);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Add the cycles elapsed since the last charge to the counter of what runs, interrupts disabled.
+*         The 32-bit counter wraps after 23 s at 180 MHz, the SysTick interrupt charges more often.
+* @param  None
+* @retval None
+*/
+static VOID thread_profile_charge(VOID)
+{
+  ULONG now = THREAD_PROFILE_COUNTER;
+
+  if (thread_profile_current_ptr != TX_NULL)
+  {
+    *thread_profile_current_ptr += now - thread_profile_last_time;
+    if (thread_profile_current_ptr != &thread_profile_idle)
+    {
+      thread_profile_busy += now - thread_profile_last_time;
+    }
+  }
+  thread_profile_last_time = now;
+}
+
+#endif /* TX_EXECUTION_PROFILE_ENABLE */
+
+/* Exported functions, also without the profile ------------------------------*/
+
+/**
+* @brief  Highest stack usage of a thread, from the 0xEF fill of tx_thread_create() left below the
+*         deepest stack pointer. The fill is binary searched below the saved stack pointer, the way
+*         tx_thread_stack_analyze() does from the highest pointer kept with TX_ENABLE_STACK_CHECKING.
+* @param  thread_ptr: created thread, interrupts disabled so that it is not deleted meanwhile
+* @retval Bytes used
+*/
+ULONG thread_profile_stack_used(TX_THREAD *thread_ptr)
+{
+  ULONG *lowest_ptr = (ULONG *)thread_ptr -> tx_thread_stack_start;
+  ULONG *highest_ptr = (ULONG *)thread_ptr -> tx_thread_stack_ptr;
+  ULONG *middle_ptr;
+
+  /* A used word at the bottom is an overflow, the whole stack is used. */
+  if (*lowest_ptr != TX_STACK_FILL)
+  {
+    return thread_ptr -> tx_thread_stack_size;
+  }
+
+  /* Keep the lowest fill word below the highest used word, until they are adjacent. */
+  while ((highest_ptr - lowest_ptr) > 1)
+  {
+    middle_ptr = lowest_ptr + ((highest_ptr - lowest_ptr) / 2);
+    if (*middle_ptr != TX_STACK_FILL)
+    {
+      highest_ptr = middle_ptr;
+    }
+    else
+    {
+      lowest_ptr = middle_ptr;
+    }
+  }
+
+  return (ULONG)(((UCHAR *)thread_ptr -> tx_thread_stack_end + 1) - (UCHAR *)highest_ptr);
+}
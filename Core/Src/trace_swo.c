@@ -0,0 +1,165 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    trace_swo.c
+  * @author  MCD Application Team
+  * @brief   ThreadX event trace streamed over the ITM/SWO debug output
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "trace_swo.h"
+#include "tx_trace.h"
+#include "main.h"
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+/* Private define ------------------------------------------------------------*/
+/* Trace buffer, the control header, TRACE_SWO_REGISTRY_ENTRIES objects then the entries */
+#define TRACE_SWO_BUFFER_SIZE         (16U * 1024U)
+#define TRACE_SWO_REGISTRY_ENTRIES    40U
+
+/* The trace thread runs below all the others, it only takes idle time */
+#define TRACE_SWO_STACK_SIZE          1024U
+#define TRACE_SWO_PRIORITY            (TX_MAX_PRIORITIES - 1U)
+
+/* Period of the control header and registry, and of the checks while no probe listens, in ticks */
+#define TRACE_SWO_HEADER_PERIOD       TX_TIMER_TICKS_PER_SECOND
+#define TRACE_SWO_IDLE_PERIOD         (TX_TIMER_TICKS_PER_SECOND / 10U)
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR trace_swo_buffer[TRACE_SWO_BUFFER_SIZE];
+
+static TX_THREAD trace_swo_thread;
+static ULONG trace_swo_thread_stack[TRACE_SWO_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID trace_swo_thread_entry(ULONG thread_input);
+static UINT trace_swo_connected(VOID);
+static UINT trace_swo_send(ULONG *words_ptr, ULONG count);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the event trace and the thread streaming it. Called from tx_application_define(),
+*         before the NetX objects are created so that they are registered.
+* @param  None
+* @retval TX_SUCCESS or the error of tx_trace_enable() or tx_thread_create()
+*/
+UINT trace_swo_init(VOID)
+{
+  UINT ret;
+
+  ret = tx_trace_enable(trace_swo_buffer, sizeof(trace_swo_buffer), TRACE_SWO_REGISTRY_ENTRIES);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  return tx_thread_create(&trace_swo_thread, "Trace SWO thread", trace_swo_thread_entry, 0,
+                          trace_swo_thread_stack, sizeof(trace_swo_thread_stack),
+                          TRACE_SWO_PRIORITY, TRACE_SWO_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Trace thread entry, send the entries inserted since the last pass, then sleep a tick.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID trace_swo_thread_entry(ULONG thread_input)
+{
+  TX_TRACE_BUFFER_ENTRY *read_ptr = _tx_trace_buffer_start_ptr;
+  ULONG header_time = 0;
+  UINT header_due = 1;
+
+  (void)thread_input;
+
+  for (;;)
+  {
+    /* Without probe the entries are skipped, the next probe gets the header first. */
+    if (!trace_swo_connected())
+    {
+      read_ptr = _tx_trace_buffer_current_ptr;
+      header_due = 1;
+      tx_thread_sleep(TRACE_SWO_IDLE_PERIOD);
+      continue;
+    }
+
+    if (header_due || ((tx_time_get() - header_time) >= TRACE_SWO_HEADER_PERIOD))
+    {
+      header_time = tx_time_get();
+      header_due = !trace_swo_send((ULONG *)_tx_trace_header_ptr,
+                                   (ULONG)((UCHAR *)_tx_trace_buffer_start_ptr - (UCHAR *)_tx_trace_header_ptr) / sizeof(ULONG));
+    }
+
+    /* The entries before the current pointer are complete, the insertion moves it after writing one. */
+    while (!header_due && (read_ptr != _tx_trace_buffer_current_ptr))
+    {
+      if (!trace_swo_send((ULONG *)read_ptr, sizeof(TX_TRACE_BUFFER_ENTRY) / sizeof(ULONG)))
+      {
+        break;
+      }
+
+      read_ptr++;
+      if (read_ptr >= _tx_trace_buffer_end_ptr)
+      {
+        read_ptr = _tx_trace_buffer_start_ptr;
+      }
+    }
+
+    tx_thread_sleep(1);
+  }
+}
+
+/**
+* @brief  Determine if a probe has enabled the ITM and the trace stimulus port.
+* @param  None
+* @retval 1 if the port is enabled, 0 otherwise
+*/
+static UINT trace_swo_connected(VOID)
+{
+  return ((ITM -> TCR & ITM_TCR_ITMENA_Msk) != 0U) && ((ITM -> TER & (1UL << TRACE_SWO_PORT)) != 0U);
+}
+
+/**
+* @brief  Write words to the stimulus port, waiting while its FIFO is full. The wait is a busy loop:
+*         nothing else runs at this priority, and a kernel call would itself be traced.
+* @param  words_ptr: words to send
+* @param  count: number of words
+* @retval 1 if the words were sent, 0 if the probe went away
+*/
+static UINT trace_swo_send(ULONG *words_ptr, ULONG count)
+{
+  ULONG i;
+
+  for (i = 0; i < count; i++)
+  {
+    /* The port reads 1 when its FIFO can take a word. */
+    while (ITM -> PORT[TRACE_SWO_PORT].u32 == 0U)
+    {
+      if (!trace_swo_connected())
+      {
+        return 0;
+      }
+    }
+
+    ITM -> PORT[TRACE_SWO_PORT].u32 = words_ptr[i];
+  }
+
+  return 1;
+}
+
+#endif /* TX_ENABLE_EVENT_TRACE */
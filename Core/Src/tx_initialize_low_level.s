@@ -65,7 +65,11 @@
 @
 @
 SYSTEM_CLOCK      =   180000000
+#ifdef TX_LOW_POWER
+SYSTICK_CYCLES    =   ((SYSTEM_CLOCK / 8 / 100) -1)
+#else
 SYSTICK_CYCLES    =   ((SYSTEM_CLOCK / 100) -1)
+#endif
 
     .text 32
     .align 4
@@ -156,7 +160,11 @@ _tx_initialize_low_level:
     MOV     r0, #0xE000E000                         @ Build address of NVIC registers
     LDR     r1, =SYSTICK_CYCLES
     STR     r1, [r0, #0x14]                         @ Setup SysTick Reload Value
+#ifdef TX_LOW_POWER
+    MOV     r1, #0x3                                @ Build SysTick Control Enable Value, clocked by HCLK/8
+#else
     MOV     r1, #0x7                                @ Build SysTick Control Enable Value
+#endif
     STR     r1, [r0, #0x10]                         @ Setup SysTick Control
 @
 @    /* Configure handler priorities.  */
@@ -279,7 +287,11 @@ __tx_DBGHandler:
 ;
 ;
 SYSTEM_CLOCK      EQU   180000000
+#ifdef TX_LOW_POWER
+SYSTICK_CYCLES    EQU   ((SYSTEM_CLOCK / 8 / 100) -1)
+#else
 SYSTICK_CYCLES    EQU   ((SYSTEM_CLOCK / 100) -1)
+#endif
 
 #ifdef USE_DYNAMIC_MEMORY_ALLOCATION
     RSEG    FREE_MEM:DATA
@@ -376,7 +388,11 @@ _tx_initialize_low_level:
     MOV     r0, #0xE000E000                         ; Build address of NVIC registers
     LDR     r1, =SYSTICK_CYCLES
     STR     r1, [r0, #0x14]                         ; Setup SysTick Reload Value
+#ifdef TX_LOW_POWER
+    MOV     r1, #0x3                                ; Build SysTick Control Enable Value, clocked by HCLK/8
+#else
     MOV     r1, #0x7                                ; Build SysTick Control Enable Value
+#endif
     STR     r1, [r0, #0x10]                         ; Setup SysTick Control
 ;
 ;    /* Configure handler priorities.  */
@@ -407,11 +423,11 @@ SysTick_Handler:
 ; {
 ;
     PUSH    {r0, lr}
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_enter             ; Call the ISR enter function
 #endif
     BL      _tx_timer_interrupt
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_exit              ; Call the ISR exit function
 #endif
     POP     {r0, lr}
@@ -463,7 +479,11 @@ SysTick_Handler:
 @
 
 SYSTEM_CLOCK      =   180000000
+#ifdef TX_LOW_POWER
+SYSTICK_CYCLES    =   ((SYSTEM_CLOCK / 8 / 100) -1)
+#else
 SYSTICK_CYCLES    =   ((SYSTEM_CLOCK / 100) -1)
+#endif
 
     .text 32
     .align 4
@@ -557,7 +577,11 @@ _tx_initialize_low_level:
     MOV     r0, #0xE000E000                         @ Build address of NVIC registers
     LDR     r1, =SYSTICK_CYCLES
     STR     r1, [r0, #0x14]                         @ Setup SysTick Reload Value
+#ifdef TX_LOW_POWER
+    MOV     r1, #0x3                                @ Build SysTick Control Enable Value, clocked by HCLK/8
+#else
     MOV     r1, #0x7                                @ Build SysTick Control Enable Value
+#endif
     STR     r1, [r0, #0x10]                         @ Setup SysTick Control
 @
 @    /* Configure handler priorities.  */
@@ -607,14 +631,14 @@ __tx_IntHandler:
 @ VOID InterruptHandler (VOID)
 @ {
     PUSH    {r0, lr}
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_enter             @ Call the ISR enter function
 #endif
 
 @    /* Do interrupt handler work here */
 @    /* BL <your C Function>.... */
 
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_exit              @ Call the ISR exit function
 #endif
     POP     {r0, lr}
@@ -632,11 +656,11 @@ SysTick_Handler:
 @ {
 @
     PUSH    {r0, lr}
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_enter             @ Call the ISR enter function
 #endif
     BL      _tx_timer_interrupt
-#ifdef TX_ENABLE_EXECUTION_CHANGE_NOTIFY
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
     BL      _tx_execution_isr_exit              @ Call the ISR exit function
 #endif
     POP     {r0, lr}
@@ -0,0 +1,326 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    work_queue.c
+  * @author  MCD Application Team
+  * @brief   Work items run one after the other by the thread of a work queue
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "work_queue.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WORK_QUEUE_EVENT              0x01U
+
+/* States of an item */
+#define WORK_ITEM_IDLE                0U  /* Neither ready nor delayed, or running */
+#define WORK_ITEM_READY               1U
+#define WORK_ITEM_DELAYED             2U
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID work_queue_thread_entry(ULONG thread_input);
+static UINT work_queue_ready_put(WORK_QUEUE *queue, WORK_ITEM *item);
+static UINT work_queue_delayed_put(WORK_QUEUE *queue, WORK_ITEM *item);
+static VOID work_queue_remove(WORK_QUEUE *queue, WORK_ITEM *item);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Create a work queue and start its thread.
+* @param  queue: work queue control block
+* @param  name: name of the thread and of its event flags
+* @param  stack: stack of the thread, the handlers run on it
+* @param  stack_size: size of the stack in bytes
+* @param  priority: priority of the thread, the handlers run at it
+* @retval TX_SUCCESS or the error of the object creation
+*/
+UINT work_queue_create(WORK_QUEUE *queue, CHAR *name, VOID *stack, ULONG stack_size, UINT priority)
+{
+  UINT ret;
+
+  queue -> work_queue_ready_head = TX_NULL;
+  queue -> work_queue_ready_tail = TX_NULL;
+  queue -> work_queue_delayed = TX_NULL;
+
+  ret = tx_event_flags_create(&queue -> work_queue_events, name);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  return tx_thread_create(&queue -> work_queue_thread, name, work_queue_thread_entry, (ULONG) queue,
+                          stack, stack_size, priority, priority, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Set up an item, before it is first submitted or scheduled.
+* @param  item: work item
+* @param  handler: run by the thread of the queue, with the item
+* @param  context: for the handler, in work_item_context
+* @retval None
+*/
+VOID work_item_init(WORK_ITEM *item, VOID (*handler)(WORK_ITEM *), VOID *context)
+{
+  item -> work_item_handler = handler;
+  item -> work_item_context = context;
+  item -> work_item_next = TX_NULL;
+  item -> work_item_expiry = 0U;
+  item -> work_item_period = 0U;
+  item -> work_item_state = WORK_ITEM_IDLE;
+}
+
+/**
+* @brief  Have the item run as soon as the thread of the queue gets to it, from a thread or an interrupt.
+*         A delayed item runs now instead, and keeps its period; a ready one is left as it is.
+* @param  queue: work queue
+* @param  item: work item
+* @retval None
+*/
+VOID work_item_submit(WORK_QUEUE *queue, WORK_ITEM *item)
+{
+  UINT wake = TX_FALSE;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  if (item -> work_item_state != WORK_ITEM_READY)
+  {
+    work_queue_remove(queue, item);
+    item -> work_item_expiry = tx_time_get();
+    wake = work_queue_ready_put(queue, item);
+  }
+  TX_RESTORE
+
+  if (wake)
+  {
+    tx_event_flags_set(&queue -> work_queue_events, WORK_QUEUE_EVENT, TX_OR);
+  }
+}
+
+/**
+* @brief  Have the item run after a delay, then every period, from a thread or an interrupt.
+*         An item already ready or delayed is moved to the new expiry.
+* @param  queue: work queue
+* @param  item: work item
+* @param  delay: ticks before the first run, 0 to run as soon as the thread gets to it
+* @param  period: ticks between the next runs, 0 to run once
+* @retval None
+*/
+VOID work_item_schedule(WORK_QUEUE *queue, WORK_ITEM *item, ULONG delay, ULONG period)
+{
+  UINT wake;
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  work_queue_remove(queue, item);
+  item -> work_item_expiry = tx_time_get() + delay;
+  item -> work_item_period = period;
+  if (delay == 0U)
+  {
+    wake = work_queue_ready_put(queue, item);
+  }
+  else
+  {
+    wake = work_queue_delayed_put(queue, item);
+  }
+  TX_RESTORE
+
+  if (wake)
+  {
+    tx_event_flags_set(&queue -> work_queue_events, WORK_QUEUE_EVENT, TX_OR);
+  }
+}
+
+/**
+* @brief  Take the item off the queue and stop its period, from a thread or an interrupt.
+*         A run already started completes.
+* @param  queue: work queue
+* @param  item: work item
+* @retval None
+*/
+VOID work_item_cancel(WORK_QUEUE *queue, WORK_ITEM *item)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  work_queue_remove(queue, item);
+  item -> work_item_period = 0U;
+  TX_RESTORE
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Thread of a queue: runs the ready items, moves the due ones to them, and sleeps until
+*         the first delayed item is due or an item is submitted.
+* @param  thread_input: work queue
+* @retval None
+*/
+static VOID work_queue_thread_entry(ULONG thread_input)
+{
+  WORK_QUEUE *queue = (WORK_QUEUE *) thread_input;
+  WORK_ITEM *item;
+  ULONG now;
+  ULONG expiry;
+  ULONG wait = TX_WAIT_FOREVER;
+  ULONG events;
+  TX_INTERRUPT_SAVE_AREA
+
+  for (;;)
+  {
+    TX_DISABLE
+    now = tx_time_get();
+
+    /* The due items join the ready ones, in the order of their expiry. */
+    while ((queue -> work_queue_delayed != TX_NULL) &&
+           ((LONG) (queue -> work_queue_delayed -> work_item_expiry - now) <= 0))
+    {
+      item = queue -> work_queue_delayed;
+      queue -> work_queue_delayed = item -> work_item_next;
+      item -> work_item_state = WORK_ITEM_IDLE;
+      work_queue_ready_put(queue, item);
+    }
+
+    item = queue -> work_queue_ready_head;
+    if (item != TX_NULL)
+    {
+      queue -> work_queue_ready_head = item -> work_item_next;
+      if (queue -> work_queue_ready_head == TX_NULL)
+      {
+        queue -> work_queue_ready_tail = TX_NULL;
+      }
+      item -> work_item_next = TX_NULL;
+      item -> work_item_state = WORK_ITEM_IDLE;
+    }
+    else if (queue -> work_queue_delayed != TX_NULL)
+    {
+      wait = queue -> work_queue_delayed -> work_item_expiry - now;
+    }
+    else
+    {
+      wait = TX_WAIT_FOREVER;
+    }
+    TX_RESTORE
+
+    if (item == TX_NULL)
+    {
+      /* An item put after the lists were read has set the flag, the wait ends at once. */
+      tx_event_flags_get(&queue -> work_queue_events, WORK_QUEUE_EVENT, TX_OR_CLEAR, &events, wait);
+      continue;
+    }
+
+    expiry = item -> work_item_expiry;
+    item -> work_item_handler(item);
+
+    /* A periodic item runs again, unless its handler scheduled or cancelled it, or it was submitted meanwhile. */
+    TX_DISABLE
+    if ((item -> work_item_period != 0U) && (item -> work_item_state == WORK_ITEM_IDLE))
+    {
+      now = tx_time_get();
+      expiry += item -> work_item_period;
+      if ((LONG) (expiry - now) <= 0)
+      {
+        expiry = now + item -> work_item_period;
+      }
+      item -> work_item_expiry = expiry;
+      work_queue_delayed_put(queue, item);
+    }
+    TX_RESTORE
+  }
+}
+
+/**
+* @brief  Put an idle item at the end of the ready ones, interrupts disabled.
+* @param  queue: work queue
+* @param  item: work item
+* @retval TX_TRUE when the ready items were none, the thread is then to be woken
+*/
+static UINT work_queue_ready_put(WORK_QUEUE *queue, WORK_ITEM *item)
+{
+  UINT was_empty = (queue -> work_queue_ready_head == TX_NULL);
+
+  item -> work_item_next = TX_NULL;
+  item -> work_item_state = WORK_ITEM_READY;
+  if (was_empty)
+  {
+    queue -> work_queue_ready_head = item;
+  }
+  else
+  {
+    queue -> work_queue_ready_tail -> work_item_next = item;
+  }
+  queue -> work_queue_ready_tail = item;
+
+  return was_empty;
+}
+
+/**
+* @brief  Put an idle item among the delayed ones by its expiry, after those due at the same tick,
+*         interrupts disabled.
+* @param  queue: work queue
+* @param  item: work item, its expiry set
+* @retval TX_TRUE when the item is the first due, the thread is then to be woken to shorten its sleep
+*/
+static UINT work_queue_delayed_put(WORK_QUEUE *queue, WORK_ITEM *item)
+{
+  WORK_ITEM **link_ptr = &queue -> work_queue_delayed;
+
+  while ((*link_ptr != TX_NULL) && ((LONG) ((*link_ptr) -> work_item_expiry - item -> work_item_expiry) <= 0))
+  {
+    link_ptr = &(*link_ptr) -> work_item_next;
+  }
+
+  item -> work_item_next = *link_ptr;
+  item -> work_item_state = WORK_ITEM_DELAYED;
+  *link_ptr = item;
+
+  return (link_ptr == &queue -> work_queue_delayed);
+}
+
+/**
+* @brief  Take an item off the ready or the delayed ones, interrupts disabled. An idle item is left as it is.
+* @param  queue: work queue
+* @param  item: work item
+* @retval None
+*/
+static VOID work_queue_remove(WORK_QUEUE *queue, WORK_ITEM *item)
+{
+  WORK_ITEM **link_ptr;
+  WORK_ITEM *previous = TX_NULL;
+
+  if (item -> work_item_state == WORK_ITEM_IDLE)
+  {
+    return;
+  }
+
+  link_ptr = (item -> work_item_state == WORK_ITEM_READY) ? &queue -> work_queue_ready_head
+                                                          : &queue -> work_queue_delayed;
+  while ((*link_ptr != TX_NULL) && (*link_ptr != item))
+  {
+    previous = *link_ptr;
+    link_ptr = &previous -> work_item_next;
+  }
+
+  if (*link_ptr == item)
+  {
+    *link_ptr = item -> work_item_next;
+    if ((item -> work_item_state == WORK_ITEM_READY) && (queue -> work_queue_ready_tail == item))
+    {
+      queue -> work_queue_ready_tail = previous;
+    }
+  }
+
+  item -> work_item_next = TX_NULL;
+  item -> work_item_state = WORK_ITEM_IDLE;
+}
@@ -77,7 +77,8 @@ int32_t  LAN8742_RegisterBusIO(lan8742_Object_t *pObj, lan8742_IOCtx_t *ioctx)
 }
 
 /**
-  * @brief  Initialize the lan8742 and configure the needed hardware resources
+  * @brief  Initialize the lan8742 and configure the needed hardware resources.
+  *         Waits for the software reset, then 2 s for the auto negotiation.
   * @param  pObj: device object LAN8742_Object_t. 
   * @retval LAN8742_STATUS_OK  if OK
   *         LAN8742_STATUS_ADDRESS_ERROR if cannot find device address
@@ -87,82 +88,23 @@ int32_t  LAN8742_RegisterBusIO(lan8742_Object_t *pObj, lan8742_IOCtx_t *ioctx)
   */
  int32_t LAN8742_Init(lan8742_Object_t *pObj)
  {
-   uint32_t tickstart = 0, regvalue = 0, addr = 0;
+   uint32_t tickstart = 0;
    int32_t status = LAN8742_STATUS_OK;
    
    if(pObj->Is_Initialized == 0)
    {
-     if(pObj->IO.Init != 0)
-     {
-       /* GPIO and Clocks initialization */
-       pObj->IO.Init();
-     }
-   
-     /* for later check */
-     pObj->DevAddr = LAN8742_MAX_DEV_ADDR + 1;
-   
-     /* Get the device address from special mode register */  
-     for(addr = 0; addr <= LAN8742_MAX_DEV_ADDR; addr ++)
-     {
-       if(pObj->IO.ReadReg(addr, LAN8742_SMR, &regvalue) < 0)
-       { 
-         status = LAN8742_STATUS_READ_ERROR;
-         /* Can't read from this device address 
-            continue with next address */
-         continue;
-       }
-     
-       if((regvalue & LAN8742_SMR_PHY_ADDR) == addr)
-       {
-         pObj->DevAddr = addr;
-         status = LAN8742_STATUS_OK;
-         break;
-       }
-     }
-   
-     if(pObj->DevAddr > LAN8742_MAX_DEV_ADDR)
-     {
-       status = LAN8742_STATUS_ADDRESS_ERROR;
-     }
+     status = LAN8742_StartInit(pObj);
      
-     /* if device address is matched */
-     if(status == LAN8742_STATUS_OK)
+     /* wait until software reset is done or timeout occured  */
+     while(status == LAN8742_STATUS_OK)
      {
-       /* set a software reset  */
-       if(pObj->IO.WriteReg(pObj->DevAddr, LAN8742_BCR, LAN8742_BCR_SOFT_RESET) >= 0)
-       { 
-         /* get software reset status */
-         if(pObj->IO.ReadReg(pObj->DevAddr, LAN8742_BCR, &regvalue) >= 0)
-         { 
-           tickstart = pObj->IO.GetTick();
-           
-           /* wait until software reset is done or timeout occured  */
-           while(regvalue & LAN8742_BCR_SOFT_RESET)
-           {
-             if((pObj->IO.GetTick() - tickstart) <= LAN8742_SW_RESET_TO)
-             {
-               if(pObj->IO.ReadReg(pObj->DevAddr, LAN8742_BCR, &regvalue) < 0)
-               { 
-                 status = LAN8742_STATUS_READ_ERROR;
-                 break;
-               }
-             }
-             else
-             {
-               status = LAN8742_STATUS_RESET_TIMEOUT;
-               break;
-             }
-           } 
-         }
-         else
-         {
-           status = LAN8742_STATUS_READ_ERROR;
-         }
-       }
-       else
+       status = LAN8742_GetInitState(pObj);
+       
+       if(status != LAN8742_STATUS_RESET_PENDING)
        {
-         status = LAN8742_STATUS_WRITE_ERROR;
+         break;
        }
+       status = LAN8742_STATUS_OK;
      }
    }
       
@@ -180,6 +122,126 @@ int32_t  LAN8742_RegisterBusIO(lan8742_Object_t *pObj, lan8742_IOCtx_t *ioctx)
    return status;
  }
 
+/**
+  * @brief  Start the initialization of the lan8742 without waiting: find the
+  *         device address and set a software reset. LAN8742_GetInitState()
+  *         then tells when the reset is done, the link state when the auto
+  *         negotiation is.
+  * @param  pObj: device object LAN8742_Object_t. 
+  * @retval LAN8742_STATUS_OK  if OK, or if already initialized
+  *         LAN8742_STATUS_ADDRESS_ERROR if cannot find device address
+  *         LAN8742_STATUS_WRITE_ERROR if connot write to register
+  */
+int32_t LAN8742_StartInit(lan8742_Object_t *pObj)
+{
+  uint32_t regvalue = 0, addr = 0;
+  int32_t status = LAN8742_STATUS_OK;
+  
+  if(pObj->Is_Initialized == 0)
+  {
+    pObj->Is_Resetting = 0;
+    
+    if(pObj->IO.Init != 0)
+    {
+      /* GPIO and Clocks initialization */
+      pObj->IO.Init();
+    }
+    
+    /* for later check */
+    pObj->DevAddr = LAN8742_MAX_DEV_ADDR + 1;
+    
+    /* Get the device address from special mode register */  
+    for(addr = 0; addr <= LAN8742_MAX_DEV_ADDR; addr ++)
+    {
+      if(pObj->IO.ReadReg(addr, LAN8742_SMR, &regvalue) < 0)
+      { 
+        status = LAN8742_STATUS_READ_ERROR;
+        /* Can't read from this device address 
+           continue with next address */
+        continue;
+      }
+      
+      if((regvalue & LAN8742_SMR_PHY_ADDR) == addr)
+      {
+        pObj->DevAddr = addr;
+        status = LAN8742_STATUS_OK;
+        break;
+      }
+    }
+    
+    if(pObj->DevAddr > LAN8742_MAX_DEV_ADDR)
+    {
+      status = LAN8742_STATUS_ADDRESS_ERROR;
+    }
+    
+    /* if device address is matched */
+    if(status == LAN8742_STATUS_OK)
+    {
+      /* set a software reset  */
+      if(pObj->IO.WriteReg(pObj->DevAddr, LAN8742_BCR, LAN8742_BCR_SOFT_RESET) >= 0)
+      { 
+        pObj->ResetTick = pObj->IO.GetTick();
+        pObj->Is_Resetting = 1;
+      }
+      else
+      {
+        status = LAN8742_STATUS_WRITE_ERROR;
+      }
+    }
+  }
+  
+  return status;
+}
+
+/**
+  * @brief  Get the state of the initialization LAN8742_StartInit() started,
+  *         with a single read of the software reset status. Called again
+  *         until it is no longer pending, sets the lan8742 initialized once
+  *         the reset is done.
+  * @param  pObj: device object LAN8742_Object_t. 
+  * @retval LAN8742_STATUS_OK  if the reset is done
+  *         LAN8742_STATUS_RESET_PENDING if the reset is still going on
+  *         LAN8742_STATUS_READ_ERROR if connot read register
+  *         LAN8742_STATUS_RESET_TIMEOUT if cannot perform a software reset
+  *         LAN8742_STATUS_ERROR if the initialization was not started
+  */
+int32_t LAN8742_GetInitState(lan8742_Object_t *pObj)
+{
+  uint32_t regvalue = 0;
+  
+  if(pObj->Is_Initialized)
+  {
+    return LAN8742_STATUS_OK;
+  }
+  
+  if(pObj->Is_Resetting == 0)
+  {
+    return LAN8742_STATUS_ERROR;
+  }
+  
+  /* get software reset status */
+  if(pObj->IO.ReadReg(pObj->DevAddr, LAN8742_BCR, &regvalue) < 0)
+  {
+    pObj->Is_Resetting = 0;
+    return LAN8742_STATUS_READ_ERROR;
+  }
+  
+  if((regvalue & LAN8742_BCR_SOFT_RESET) == 0)
+  {
+    pObj->Is_Resetting = 0;
+    pObj->Is_Initialized = 1;
+    return LAN8742_STATUS_OK;
+  }
+  
+  if((pObj->IO.GetTick() - pObj->ResetTick) > LAN8742_SW_RESET_TO)
+  {
+    pObj->Is_Resetting = 0;
+    return LAN8742_STATUS_RESET_TIMEOUT;
+  }
+  
+  return LAN8742_STATUS_RESET_PENDING;
+}
+
 /**
   * @brief  De-Initialize the lan8742 and it's hardware resources
   * @param  pObj: device object LAN8742_Object_t. 
@@ -199,6 +261,7 @@ int32_t LAN8742_DeInit(lan8742_Object_t *pObj)
   
     pObj->Is_Initialized = 0;  
   }
+  pObj->Is_Resetting = 0;
   
   return LAN8742_STATUS_OK;
 }
@@ -347,6 +347,7 @@
 #define  LAN8742_STATUS_10MBITS_FULLDUPLEX    ((int32_t) 4)
 #define  LAN8742_STATUS_10MBITS_HALFDUPLEX    ((int32_t) 5)
 #define  LAN8742_STATUS_AUTONEGO_NOTDONE      ((int32_t) 6)
+#define  LAN8742_STATUS_RESET_PENDING         ((int32_t) 7)
 /**
   * @}
   */
@@ -394,6 +395,8 @@ typedef struct
 {
   uint32_t            DevAddr;
   uint32_t            Is_Initialized;
+  uint32_t            Is_Resetting;
+  uint32_t            ResetTick;
   lan8742_IOCtx_t     IO;
   void               *pData;
 }lan8742_Object_t;
@@ -408,6 +411,8 @@ typedef struct
   */
 int32_t LAN8742_RegisterBusIO(lan8742_Object_t *pObj, lan8742_IOCtx_t *ioctx);
 int32_t LAN8742_Init(lan8742_Object_t *pObj);
+int32_t LAN8742_StartInit(lan8742_Object_t *pObj);
+int32_t LAN8742_GetInitState(lan8742_Object_t *pObj);
 int32_t LAN8742_DeInit(lan8742_Object_t *pObj);
 int32_t LAN8742_DisablePowerDownMode(lan8742_Object_t *pObj);
 int32_t LAN8742_EnablePowerDownMode(lan8742_Object_t *pObj);
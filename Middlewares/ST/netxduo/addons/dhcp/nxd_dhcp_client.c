@@ -3077,7 +3077,8 @@ UINT status;
 /*  has been enabled for DHCP (see nx_dhcp_interface_enable). It then     */
 /*  checks if any interfaces are running DHCP. If not it binds the DHCP   */
 /*  socket port, activates the DHCP timer, and resumes the DHCP Client    */
-/*  thread.                                                               */
+/*  thread. A client requesting its previous address without the          */
+/*  discovery sends its request at once.                                  */
 /*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
@@ -3098,6 +3099,8 @@ UINT status;
 /*    tx_timer_activate                     Activate DHCP timer           */
 /*    tx_mutex_get                          Get the DHCP mutex            */ 
 /*    tx_mutex_put                          Release the DHCP mutex        */ 
+/*    _nx_dhcp_send_request_internal        Send DHCP request             */
+/*    _nx_dhcp_add_randomize                Randomize the timeout         */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -3218,6 +3221,34 @@ NX_DHCP_INTERFACE_RECORD *interface_record = NX_NULL;
     interface_record -> nx_dhcp_timeout = NX_IP_PERIODIC_RATE;
     interface_record -> nx_dhcp_rtr_interval = 0;
 
+#ifndef NX_DHCP_ENABLE_BOOTP
+    /* A client requesting its previous address without the discovery is in the INIT-REBOOT state,
+       the wait is for the discovery of the INIT state only. Send the request now. RFC2131, Section4.4.2, Page39.  */
+    if ((interface_record -> nx_dhcp_ip_address != NX_BOOTP_NO_ADDRESS) &&
+        (interface_record -> nx_dhcp_skip_discovery))
+    {
+
+        /* Reset the seconds field for starting the DHCP address acquistiion. */
+        interface_record -> nx_dhcp_seconds = 0;
+
+        /* Send out the DHCP request.  */
+        _nx_dhcp_send_request_internal(dhcp_ptr, interface_record, NX_DHCP_TYPE_DHCPREQUEST);
+
+        /* And change to the Requesting state. */
+        interface_record -> nx_dhcp_state = NX_DHCP_STATE_REQUESTING;
+
+        /* Retransmit as from the INIT state, after the min retransmission timeout.  */
+        interface_record -> nx_dhcp_rtr_interval = NX_DHCP_MIN_RETRANS_TIMEOUT;
+
+        /* This will modify the timeout by up to +/- 1 second as recommended by RFC 2131, Section 4.1, Page 24. */
+        interface_record -> nx_dhcp_timeout = _nx_dhcp_add_randomize(interface_record -> nx_dhcp_rtr_interval);
+
+        /* Check if the timeout is zero.  */
+        if (interface_record -> nx_dhcp_timeout == 0)
+            interface_record -> nx_dhcp_timeout = 1;
+    }
+#endif
+
     /* Determine if the application has specified a routine for DHCP state change notification.  */
     if (dhcp_ptr -> nx_dhcp_state_change_callback)
     {
@@ -5511,8 +5542,27 @@ ULONG       probing_delay;
                 interface_record -> nx_dhcp_state = NX_DHCP_STATE_REQUESTING;
            }
 
+#if defined(NX_DHCP_CLIENT_ENABLE_RAPID_COMMIT) && !defined(NX_DHCP_ENABLE_BOOTP)
+
+           /* An ACK to the Discover is only accepted with the Rapid Commit option, RFC4039, Section4, Page5.  */
+           if ((status != NX_SUCCESS) || (dhcp_type != NX_DHCP_TYPE_DHCPACK) ||
+               (_nx_dhcp_search_buffer(buffer + NX_BOOTP_OFFSET_OPTIONS, NX_DHCP_OPTION_RAPID_COMMIT,
+                                       new_packet_ptr -> nx_packet_length - NX_BOOTP_OFFSET_OPTIONS) == NX_NULL))
+           {
+
+               /* Let the timeout processing handle retransmissions. We're done here */
+               break;
+           }
+
+           /* The server committed the address, process the ACK as the answer to a Request.  */
+           interface_record -> nx_dhcp_state = NX_DHCP_STATE_REQUESTING;
+
+           /* fallthrough */
+#else
+
            /* Let the timeout processing handle retransmissions. We're done here */
            break;
+#endif
         }
 
         case NX_DHCP_STATE_REQUESTING:
@@ -6838,6 +6888,13 @@ UINT            name_length;
             _nx_dhcp_add_option_value(buffer, NX_DHCP_OPTION_MAX_DHCP_MESSAGE, 2, dhcp_ptr -> nx_dhcp_max_dhcp_message_size, &index);
 #endif
 
+#ifdef NX_DHCP_CLIENT_ENABLE_RAPID_COMMIT
+
+            /* Add the Rapid Commit option, the server may answer with an ACK directly.  
+               RFC4039, Section4, Page4.  */
+            _nx_dhcp_add_option_value(buffer, NX_DHCP_OPTION_RAPID_COMMIT, NX_DHCP_OPTION_RAPID_COMMIT_SIZE, 0, &index);
+#endif
+
             /* Increment the number of Discovery messages sent.  */
             interface_record -> nx_dhcp_discoveries_sent++;
             break;
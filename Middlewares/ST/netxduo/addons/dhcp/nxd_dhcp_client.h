@@ -94,6 +94,12 @@ extern   "C" {
 #define NX_DHCP_CLIENT_SEND_MAX_DHCP_MESSAGE_OPTION
 */
 
+/* Enables DHCP Client send the Rapid Commit Option in the Discover and accept an ACK to it in place
+   of an Offer, two messages instead of four when the server supports it. Offers are still answered
+   with a Request otherwise. RFC4039, Section4, Page4.
+#define NX_DHCP_CLIENT_ENABLE_RAPID_COMMIT
+*/
+
 /* Defined, the host name is checked, the host name must follow the rules for ARPANET host names.
    RFC 1035, Section 2.3.1, Page 8.  The default is disabled.
 #define NX_DHCP_CLIENT_ENABLE_HOST_NAME_CHECK
@@ -303,6 +309,8 @@ extern   "C" {
 #define NX_DHCP_OPTION_REBIND_SIZE      4
 #define NX_DHCP_OPTION_CLIENT_ID        61
 #define NX_DHCP_OPTION_CLIENT_ID_SIZE   7 /* 1 byte for address type (01 = Ethernet), 6 bytes for address */ 
+#define NX_DHCP_OPTION_RAPID_COMMIT     80
+#define NX_DHCP_OPTION_RAPID_COMMIT_SIZE 0
 #define NX_DHCP_OPTION_FDQN             81
 #define NX_DHCP_OPTION_FDQN_FLAG_N      8
 #define NX_DHCP_OPTION_FDQN_FLAG_E      4
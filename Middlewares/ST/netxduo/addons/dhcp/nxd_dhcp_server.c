@@ -74,6 +74,9 @@ static UINT        _nx_dhcp_find_ip_address_owner(NX_DHCP_INTERFACE_IP_ADDRESS *
 static UINT        _nx_dhcp_record_ip_address_owner(NX_DHCP_INTERFACE_IP_ADDRESS *iface_owner, NX_DHCP_CLIENT *client_record_ptr, UINT lease_time);
 static UINT        _nx_dhcp_clear_ip_address_owner(NX_DHCP_INTERFACE_IP_ADDRESS *iface_owner);
 static VOID        _nx_dhcp_server_socket_receive_notify(NX_UDP_SOCKET *socket_ptr);
+static UINT        _nx_dhcp_client_index_hash(ULONG client_mac_msw, ULONG client_mac_lsw);
+static VOID        _nx_dhcp_client_index_remove(NX_DHCP_SERVER *dhcp_ptr, NX_DHCP_CLIENT *dhcp_client_ptr);
+static ULONG       _nx_dhcp_find_static_lease(NX_DHCP_SERVER *dhcp_ptr, NX_DHCP_CLIENT *dhcp_client_ptr);
 
 
 /* To enable dhcp server output, define TESTOUTPUT. */
@@ -1174,6 +1177,169 @@ UINT  _nx_dhcp_set_interface_network_parameters(NX_DHCP_SERVER *dhcp_ptr, UINT i
 }
 
 
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                                              */ 
+/*                                                                        */ 
+/*    _nxe_dhcp_set_interface_static_leases               PORTABLE C      */ 
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function checks for errors in the set static leases service.   */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    dhcp_ptr                           Pointer to DHCP server           */ 
+/*    iface_index                        Index specifying server interface*/
+/*    lease_table                        Table of static leases           */
+/*    lease_count                        Number of static leases          */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    status                             Completion status                */
+/*    NX_PTR_ERROR                       Invalid pointer input            */
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _nx_dhcp_set_interface_static_leases                                */
+/*                                       Actual set static leases service */
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application code                                                    */ 
+/*                                                                        */ 
+/**************************************************************************/
+UINT  _nxe_dhcp_set_interface_static_leases(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, 
+                                            const NX_DHCP_STATIC_LEASE *lease_table, UINT lease_count)
+{
+
+UINT status;
+
+    /* Check for invalid pointer input. */
+    if ((dhcp_ptr == NX_NULL) || ((lease_table == NX_NULL) && (lease_count != 0)))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Call the actual service. */
+    status = _nx_dhcp_set_interface_static_leases(dhcp_ptr, iface_index, lease_table, lease_count);
+
+    /* Return completion status. */
+    return(status);
+}
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                                              */ 
+/*                                                                        */ 
+/*    _nx_dhcp_set_interface_static_leases                PORTABLE C      */ 
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function sets the static leases of the specified interface, the*/
+/*    addresses always assigned to the same client hardware address. Each */
+/*    address must be in the interface address list, created before. It is*/
+/*    reserved for its client: no other client is given it, and it never  */
+/*    expires or returns to the available addresses. The table is kept by */
+/*    the application, e.g. constant in flash, and must stay unchanged.   */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    dhcp_ptr                           Pointer to DHCP server           */ 
+/*    iface_index                        Index specifying server interface*/
+/*    lease_table                        Table of static leases           */
+/*    lease_count                        Number of static leases          */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    NX_SUCCESS                         Static leases set                */
+/*    NX_DHCP_SERVER_BAD_INTERFACE_INDEX Invalid interface index input    */ 
+/*    NX_DHCP_IP_ADDRESS_NOT_FOUND       Address not in the address list  */
+/*    NX_DHCP_IP_ADDRESS_ASSIGNED_TO_OTHER                                */
+/*                                       Address assigned to other client */
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _nx_dhcp_find_interface_table_ip_address                            */
+/*                                       Find the address list entry      */
+/*    tx_mutex_get                       Obtain protection mutex          */ 
+/*    tx_mutex_put                       Release protection mutex         */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application code                                                    */ 
+/*                                                                        */ 
+/**************************************************************************/
+UINT  _nx_dhcp_set_interface_static_leases(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, 
+                                           const NX_DHCP_STATIC_LEASE *lease_table, UINT lease_count)
+{
+
+UINT                            i;
+NX_DHCP_INTERFACE_IP_ADDRESS    *interface_address_ptr;
+
+
+    /* Check for invalid non pointer input. */
+    if (iface_index >= NX_MAX_PHYSICAL_INTERFACES)
+    {
+
+        return(NX_DHCP_SERVER_BAD_INTERFACE_INDEX);                                           
+    }
+
+    /* Obtain DHCP Server mutex protection,. */
+    tx_mutex_get(&dhcp_ptr -> nx_dhcp_mutex, NX_WAIT_FOREVER);
+
+    /* Check all the addresses before reserving any. */
+    for (i = 0; i < lease_count; i++)
+    {
+
+        _nx_dhcp_find_interface_table_ip_address(dhcp_ptr, iface_index, lease_table[i].nx_dhcp_static_ip_address,
+                                                 &interface_address_ptr);
+
+        /* The address must be one of the server. */
+        if (interface_address_ptr == NX_NULL)
+        {
+
+            tx_mutex_put(&dhcp_ptr -> nx_dhcp_mutex);
+            return(NX_DHCP_IP_ADDRESS_NOT_FOUND);
+        }
+
+        /* And not leased to another client. */
+        if ((interface_address_ptr -> assigned == NX_TRUE) &&
+            ((interface_address_ptr -> owner_mac_msw != lease_table[i].nx_dhcp_static_mac_msw) ||
+             (interface_address_ptr -> owner_mac_lsw != lease_table[i].nx_dhcp_static_mac_lsw)))
+        {
+
+            tx_mutex_put(&dhcp_ptr -> nx_dhcp_mutex);
+            return(NX_DHCP_IP_ADDRESS_ASSIGNED_TO_OTHER);
+        }
+    }
+
+    /* Reserve each address for its client, with a lease that does not expire. */
+    for (i = 0; i < lease_count; i++)
+    {
+
+        _nx_dhcp_find_interface_table_ip_address(dhcp_ptr, iface_index, lease_table[i].nx_dhcp_static_ip_address,
+                                                 &interface_address_ptr);
+
+        interface_address_ptr -> owner_hwtype = NX_DHCP_STATIC_LEASE_HW_TYPE;
+        interface_address_ptr -> owner_mac_msw = lease_table[i].nx_dhcp_static_mac_msw;
+        interface_address_ptr -> owner_mac_lsw = lease_table[i].nx_dhcp_static_mac_lsw;
+        interface_address_ptr -> lease_time = NX_WAIT_FOREVER;
+        interface_address_ptr -> assigned = NX_TRUE;
+        interface_address_ptr -> reserved = NX_TRUE;
+    }
+
+    dhcp_ptr -> nx_dhcp_interface_table[iface_index].nx_dhcp_static_lease_table = lease_table;
+    dhcp_ptr -> nx_dhcp_interface_table[iface_index].nx_dhcp_static_lease_count = lease_count;
+
+    /* Release DHCP Server mutex.  */
+    tx_mutex_put(&dhcp_ptr -> nx_dhcp_mutex);
+
+    return(NX_SUCCESS);
+}
+
+
 /**************************************************************************/ 
 /*                                                                        */ 
 /*  FUNCTION                                               RELEASE        */ 
@@ -1869,6 +2035,21 @@ UINT                     index = 0;
                     /* Add the list of options that go out with server OFFER replies. */
                     _nx_dhcp_load_server_options(dhcp_ptr, dhcp_client_ptr, buffer, NX_DHCP_OPTIONS_FOR_REPLY_TO_OFFER, &index);
                 }
+#ifdef NX_DHCP_SERVER_ENABLE_RAPID_COMMIT
+
+                /* Or are we committing the lease at once (Rapid Commit)? */
+                else if (dhcp_client_ptr -> nx_dhcp_response_type_to_client == NX_DHCP_TYPE_DHCPACK)
+                {
+
+                    _nx_dhcp_server_store_data(buffer + NX_DHCP_OFFSET_YOUR_IP, 4, dhcp_client_ptr -> nx_dhcp_assigned_ip_address);   
+
+                    /* Add the list of options that go out with server ACKs replies. */
+                    _nx_dhcp_load_server_options(dhcp_ptr, dhcp_client_ptr, buffer, NX_DHCP_OPTIONS_FOR_REPLY_TO_REQUEST, &index);
+
+                    /* An ACK to a DISCOVER carries the Rapid Commit option, RFC 4039 section 4. */
+                    _nx_dhcp_add_option(buffer, NX_DHCP_SERVER_OPTION_RAPID_COMMIT, NX_DHCP_SERVER_OPTION_RAPID_COMMIT_SIZE, 0, &index);
+                }
+#endif /* NX_DHCP_SERVER_ENABLE_RAPID_COMMIT */
     
                 /* Increment the number of Discovery messages received.  */
                 dhcp_ptr -> nx_dhcp_discoveries_received++;
@@ -2121,6 +2302,7 @@ UINT i;
     dhcp_client_ptr -> nx_dhcp_session_timeout = 0;
     dhcp_client_ptr -> nx_dhcp_destination_ip_address = 0; 
     dhcp_client_ptr -> nx_dhcp_source_ip_address = 0; 
+    dhcp_client_ptr -> nx_dhcp_rapid_commit = NX_FALSE;
 
     /* Clear out the option data. */
     dhcp_client_ptr -> nx_dhcp_client_option_count = 0;    
@@ -2288,6 +2470,9 @@ NX_DHCP_INTERFACE_TABLE  *iface_table_ptr;
         }
     }
 
+    /* Take the record out of its hash chain. */
+    _nx_dhcp_client_index_remove(dhcp_ptr, dhcp_client_ptr);
+
     /* Ok to clear the Client record. */
     memset(dhcp_client_ptr, 0, sizeof(NX_DHCP_CLIENT));
 
@@ -3227,7 +3412,8 @@ NX_DHCP_CLIENT  *client_record_ptr;
 /*  DESCRIPTION                                                           */ 
 /*                                                                        */ 
 /*    This function looks up a client record by the client hardware mac   */
-/*    address.                                                            */
+/*    address, in the hash chain of the address. A record added is linked */
+/*    into the chain.                                                     */
 /*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
@@ -3247,6 +3433,7 @@ NX_DHCP_CLIENT  *client_record_ptr;
 /*                                                                        */ 
 /*    _nx_dhcp_clear_client_record          Removes client record from    */
 /*                                              server table              */
+/*    _nx_dhcp_client_index_hash            Get the hash chain            */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -3267,36 +3454,22 @@ static UINT  _nx_dhcp_find_client_record_by_chaddr(NX_DHCP_SERVER *dhcp_ptr, UIN
 {
 
 UINT            i;
-UINT            available_index;
+UINT            index;
 NX_DHCP_CLIENT  *client_record_ptr;
+NX_DHCP_CLIENT  **link_ptr;
 
 
     /* Initialize the search results to unsuccessful. */
     *dhcp_client_ptr = NX_NULL;
 
-    /* Initialize an available slot in the table as outside the boundary (e.g. no slots available). */
-    available_index = NX_DHCP_CLIENT_RECORD_TABLE_SIZE;
-
-    /* Records are not necessarily added and deleted sequentially, 
-       so search the whole table until a match is found. */
-    i = 0;
-    while (i < NX_DHCP_CLIENT_RECORD_TABLE_SIZE) 
+    /* Only the records of the hash chain of this client address can match. */
+    index = _nx_dhcp_client_index_hash(client_mac_msw, client_mac_lsw);
+    link_ptr = &(dhcp_ptr -> nx_dhcp_client_index[index]);
+    while (*link_ptr != NX_NULL) 
     {
 
         /* Set local pointer for convenience. */
-        client_record_ptr = &dhcp_ptr -> client_records[i];
-
-        /* Skip empty records. Assume a client with no mac address is empty. */
-        if ((client_record_ptr -> nx_dhcp_client_mac_msw == 0) && (client_record_ptr -> nx_dhcp_client_mac_lsw == 0))
-        {
-
-            /* Flag the first empty record in case we need to add the current client to the table. */
-            if (i < available_index)
-                available_index = i;
-
-            i++;
-            continue;
-        }
+        client_record_ptr = *link_ptr;
 
         /* Check the mac address of each record for a match. */
         if ((client_record_ptr -> nx_dhcp_client_mac_msw == client_mac_msw) &&
@@ -3319,14 +3492,16 @@ NX_DHCP_CLIENT  *client_record_ptr;
                    free up any assigned IP address in the server database. */
                 _nx_dhcp_clear_client_record(dhcp_ptr, client_record_ptr);
 
-                /* Continue searching through the rest of the server records for
+                /* Continue searching through the rest of the chain for
                    another instance of this client. Either way, if not found
                    with the expected interface a null pointer is returned,
-                   or new record created depending on the caller. */
+                   or new record created depending on the caller. The link
+                   now points to the record after the one removed. */
+                continue;
             }
         }
 
-        i++;
+        link_ptr = &(client_record_ptr -> nx_dhcp_client_index_next);
     }
 
     /* Not found. Create a record for this client? */
@@ -3341,8 +3516,19 @@ NX_DHCP_CLIENT  *client_record_ptr;
         return(NX_SUCCESS);
     }
 
+    /* Find the first empty record. Assume a client with no mac address is empty. */
+    for (i = 0; i < NX_DHCP_CLIENT_RECORD_TABLE_SIZE; i++)
+    {
+
+        if ((dhcp_ptr -> client_records[i].nx_dhcp_client_mac_msw == 0) && 
+            (dhcp_ptr -> client_records[i].nx_dhcp_client_mac_lsw == 0))
+        {
+            break;
+        }
+    }
+
     /* Check if there is available room in the table for a new client. */
-    if (available_index >= NX_DHCP_CLIENT_RECORD_TABLE_SIZE)
+    if (i >= NX_DHCP_CLIENT_RECORD_TABLE_SIZE)
     {
 
         /* No, we cannot add this client so the server's table. */
@@ -3350,7 +3536,7 @@ NX_DHCP_CLIENT  *client_record_ptr;
     }
 
     /* Set local pointer to an available slot. */
-    client_record_ptr = &dhcp_ptr -> client_records[available_index];
+    client_record_ptr = &dhcp_ptr -> client_records[i];
 
     /* Add this client to the server's total number of clients. */
     dhcp_ptr -> nx_dhcp_number_clients++;
@@ -3363,6 +3549,10 @@ NX_DHCP_CLIENT  *client_record_ptr;
     /* Initialize the client state as the init state. */
     client_record_ptr -> nx_dhcp_client_state = NX_DHCP_STATE_INIT;
 
+    /* Link the record at the head of its hash chain. */
+    client_record_ptr -> nx_dhcp_client_index_next = dhcp_ptr -> nx_dhcp_client_index[index];
+    dhcp_ptr -> nx_dhcp_client_index[index] = client_record_ptr;
+
     /* Return the location of the newly created client record. */
     *dhcp_client_ptr = client_record_ptr; 
 
@@ -3370,6 +3560,157 @@ NX_DHCP_CLIENT  *client_record_ptr;
 }
 
 
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                                              */ 
+/*                                                                        */ 
+/*    _nx_dhcp_client_index_hash                          PORTABLE C      */ 
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function returns the hash chain of the client records of a     */
+/*    hardware address. The addresses of a vendor share their high bytes, */
+/*    the low bytes are folded into the index.                            */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    client_mac_msw                        MSB of client hardware address*/
+/*    client_mac_lsw                        LSB of client hardware address*/
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    index                                 Index of the hash chain       */
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _nx_dhcp_find_client_record_by_chaddr Find client record by address*/
+/*    _nx_dhcp_client_index_remove          Unlink the client record      */
+/*                                                                        */ 
+/**************************************************************************/
+static UINT  _nx_dhcp_client_index_hash(ULONG client_mac_msw, ULONG client_mac_lsw)
+{
+
+ULONG   hash;
+
+
+    hash = client_mac_lsw ^ (client_mac_lsw >> 16) ^ client_mac_msw;
+    hash ^= hash >> 8;
+
+    return((UINT)(hash & (NX_DHCP_CLIENT_RECORD_INDEX_SIZE - 1)));
+}
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                                              */ 
+/*                                                                        */ 
+/*    _nx_dhcp_client_index_remove                        PORTABLE C      */ 
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function unlinks a client record from its hash chain, before   */
+/*    the record is cleared. A record in no chain is left as it is.       */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    dhcp_ptr                              Pointer to DHCP Server        */ 
+/*    dhcp_client_ptr                       Pointer to client record      */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _nx_dhcp_client_index_hash            Get the hash chain            */
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _nx_dhcp_clear_client_record          Removes client record from    */
+/*                                              server table              */
+/*                                                                        */ 
+/**************************************************************************/
+static VOID  _nx_dhcp_client_index_remove(NX_DHCP_SERVER *dhcp_ptr, NX_DHCP_CLIENT *dhcp_client_ptr)
+{
+
+NX_DHCP_CLIENT  **link_ptr;
+
+
+    /* Find the link to the record in its chain. */
+    link_ptr = &(dhcp_ptr -> nx_dhcp_client_index[_nx_dhcp_client_index_hash(dhcp_client_ptr -> nx_dhcp_client_mac_msw,
+                                                                             dhcp_client_ptr -> nx_dhcp_client_mac_lsw)]);
+    while (*link_ptr != NX_NULL)
+    {
+        if (*link_ptr == dhcp_client_ptr)
+        {
+
+            /* Unlink the record. */
+            *link_ptr = dhcp_client_ptr -> nx_dhcp_client_index_next;
+            dhcp_client_ptr -> nx_dhcp_client_index_next = NX_NULL;
+            return;
+        }
+
+        link_ptr = &((*link_ptr) -> nx_dhcp_client_index_next);
+    }
+}
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                                              */ 
+/*                                                                        */ 
+/*    _nx_dhcp_find_static_lease                          PORTABLE C      */ 
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function returns the address of the static lease of a client   */
+/*    in the static lease table of its interface, if it has one.          */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    dhcp_ptr                              Pointer to DHCP Server        */ 
+/*    dhcp_client_ptr                       Pointer to client record      */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    ip_address                            Static address of the client, */
+/*                                            NX_DHCP_NO_ADDRESS if none  */
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _nx_dhcp_server_assign_ip_address     Assign IP address to client   */
+/*                                                                        */ 
+/**************************************************************************/
+static ULONG  _nx_dhcp_find_static_lease(NX_DHCP_SERVER *dhcp_ptr, NX_DHCP_CLIENT *dhcp_client_ptr)
+{
+
+UINT                        i;
+NX_DHCP_INTERFACE_TABLE     *iface_table_ptr;
+
+
+    iface_table_ptr = &dhcp_ptr -> nx_dhcp_interface_table[dhcp_client_ptr -> nx_dhcp_client_iface_index];
+
+    for (i = 0; i < iface_table_ptr -> nx_dhcp_static_lease_count; i++)
+    {
+        if ((iface_table_ptr -> nx_dhcp_static_lease_table[i].nx_dhcp_static_mac_msw == dhcp_client_ptr -> nx_dhcp_client_mac_msw) &&
+            (iface_table_ptr -> nx_dhcp_static_lease_table[i].nx_dhcp_static_mac_lsw == dhcp_client_ptr -> nx_dhcp_client_mac_lsw))
+        {
+            return(iface_table_ptr -> nx_dhcp_static_lease_table[i].nx_dhcp_static_ip_address);
+        }
+    }
+
+    return(NX_DHCP_NO_ADDRESS);
+}
+
+
 /**************************************************************************/ 
 /*                                                                        */ 
 /*  FUNCTION                                               RELEASE        */ 
@@ -3532,6 +3873,12 @@ NX_DHCP_INTERFACE_IP_ADDRESS    *interface_address_ptr;
         return(NX_DHCP_IP_ADDRESS_NOT_FOUND);
     }
 
+    /* A static lease stays with its owner, whatever the clients report. */
+    if (interface_address_ptr -> reserved)
+    {
+        return(NX_SUCCESS);
+    }
+
     /* Is the Client releasing IP address?  */
     if (assign_status == NX_DHCP_ADDRESS_STATUS_MARK_AVAILABLE)
     {
@@ -3796,6 +4143,12 @@ static UINT  _nx_dhcp_record_ip_address_owner(NX_DHCP_INTERFACE_IP_ADDRESS *ifac
 static UINT  _nx_dhcp_clear_ip_address_owner(NX_DHCP_INTERFACE_IP_ADDRESS *iface_owner)
 {
 
+    /* A static lease stays with its owner.  */
+    if (iface_owner -> reserved)
+    {
+        return(NX_SUCCESS);
+    }
+
     /* Clear the owner information.  */
     iface_owner -> owner_hwtype = 0;
     iface_owner -> owner_mac_msw = 0;
@@ -3946,6 +4299,18 @@ NX_DHCP_INTERFACE_TABLE *dhcp_interface_table_ptr;
                 
                     /* DHCP client state advances to SElECTING state. */
                     dhcp_client_ptr -> nx_dhcp_client_state = NX_DHCP_STATE_SELECTING;
+
+#ifdef NX_DHCP_SERVER_ENABLE_RAPID_COMMIT
+
+                    /* Does the client accept a lease in a single exchange (RFC 4039)? */
+                    if (dhcp_client_ptr -> nx_dhcp_rapid_commit)
+                    {
+
+                        /* Yes, answer with the ACK, the client is bound once it is sent. */
+                        dhcp_client_ptr -> nx_dhcp_response_type_to_client = NX_DHCP_TYPE_DHCPACK;
+                        dhcp_client_ptr -> nx_dhcp_client_state = NX_DHCP_STATE_REQUESTING;
+                    }
+#endif /* NX_DHCP_SERVER_ENABLE_RAPID_COMMIT */
                 }
 
                 break;
@@ -4556,6 +4921,9 @@ NX_DHCP_INTERFACE_TABLE *dhcp_interface_table_ptr;
 /*  interface pointer entry, and the "Your IP address" in its message back*/
 /*  to the client.                                                        */
 /*                                                                        */ 
+/*  A client with a static lease is offered its static address, and is    */
+/*  sent a NACK when it requests another one.                             */
+/*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
 /*    dhcp_cptr                             Pointer to DHCP Server        */
@@ -4568,6 +4936,9 @@ NX_DHCP_INTERFACE_TABLE *dhcp_interface_table_ptr;
 /*                                                                        */ 
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
+/*    _nx_dhcp_find_static_lease            Look up the static lease of   */
+/*                                             the client                 */
+/*    _nx_dhcp_update_assignable_ip_address Return the previous address   */
 /*    _nx_dhcp_find_interface_table_ip_address                            */ 
 /*                                          Look up IP address in         */
 /*                                             server interface table     */
@@ -4599,6 +4970,7 @@ NX_DHCP_INTERFACE_IP_ADDRESS    *interface_address_ptr;
 UINT                            assigned_to_client;
 UINT                            assigned_ip;
 UINT                            lease_time;
+ULONG                           static_ip_address;
 
 
     /* Set a flag on the outcome of finding an available address. */
@@ -4621,6 +4993,42 @@ UINT                            lease_time;
 
     interface_address_ptr = (NX_DHCP_INTERFACE_IP_ADDRESS *)NX_NULL;
 
+    /* A client with a static lease is only given its own address. */
+    static_ip_address = _nx_dhcp_find_static_lease(dhcp_ptr, dhcp_client_ptr);
+    if ((static_ip_address != NX_DHCP_NO_ADDRESS) && 
+        (dhcp_client_ptr -> nx_dhcp_assigned_ip_address != static_ip_address))
+    {
+
+        /* Offer it in place of any other address. */
+        if (dhcp_client_ptr -> nx_dhcp_message_type == NX_DHCP_TYPE_DHCPDISCOVER)
+        {
+
+            /* Return an address leased before the static lease was set. */
+            if (dhcp_client_ptr -> nx_dhcp_assigned_ip_address != NX_DHCP_NO_ADDRESS)
+            {
+                _nx_dhcp_update_assignable_ip_address(dhcp_ptr, dhcp_client_ptr, dhcp_client_ptr -> nx_dhcp_assigned_ip_address,
+                                                      NX_DHCP_ADDRESS_STATUS_MARK_AVAILABLE);
+            }
+
+            dhcp_client_ptr -> nx_dhcp_assigned_ip_address = static_ip_address;
+        }
+        else
+        {
+
+#ifdef EL_PRINTF_ENABLE
+            EL_PRINTF("DHCPserv: NACK! Client with a static lease requests another IP address\n");
+#endif
+
+            /* The client asks for another address, it gets its own after a new discovery. */
+            dhcp_client_ptr -> nx_dhcp_response_type_to_client = NX_DHCP_TYPE_DHCPNACK;
+            dhcp_client_ptr -> nx_dhcp_client_state = NX_DHCP_STATE_INIT;
+            dhcp_client_ptr -> nx_dhcp_assigned_ip_address = NX_DHCP_NO_ADDRESS;
+            dhcp_client_ptr -> nx_dhcp_requested_lease_time = 0;
+
+            return(NX_SUCCESS);
+        }
+    }
+
     /* Does the Client have a candidate already assigned? */
     if (dhcp_client_ptr -> nx_dhcp_assigned_ip_address)
     {
@@ -4654,8 +5062,11 @@ UINT                            lease_time;
 
                     /* Yes, so we're done here, except for checking a few fields. */
 
-                    /* Renew the lease time. */
-                    interface_address_ptr -> lease_time = lease_time;
+                    /* Renew the lease time, a static lease does not expire. */
+                    if (interface_address_ptr -> reserved == NX_FALSE)
+                    {
+                        interface_address_ptr -> lease_time = lease_time;
+                    }
 
                     /* Set the Your IP address field for the server response message. */
                     dhcp_client_ptr -> nx_dhcp_your_ip_address = interface_address_ptr -> nx_assignable_ip_address;
@@ -5034,6 +5445,9 @@ NX_DHCP_CLIENT  *temp_client_rec_ptr;
     }
 
     /* Note we don't store the magic cookie value. */
+
+    /* The Rapid Commit option applies to the message carrying it only. */
+    temp_client_rec_ptr -> nx_dhcp_rapid_commit = NX_FALSE;
    
     /* Are there user options?  */
     if (value == NX_DHCP_MAGIC_COOKIE)
@@ -5158,6 +5572,13 @@ static UINT  _nx_dhcp_process_option_data(NX_DHCP_CLIENT *dhcp_client_ptr, CHAR
 UINT  status;
 ULONG option_value = 0;
 
+    /* The Rapid Commit option has no data, it is present or not. */
+    if (option == NX_DHCP_SERVER_OPTION_RAPID_COMMIT)
+    {
+        dhcp_client_ptr -> nx_dhcp_rapid_commit = NX_TRUE;
+        return(NX_SUCCESS);
+    }
+
     /* Do we parse option data for this option? */
     if (get_option_data)
     {
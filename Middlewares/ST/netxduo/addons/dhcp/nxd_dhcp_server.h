@@ -233,6 +233,17 @@ extern   "C" {
 
 #ifndef NX_DHCP_CLIENT_RECORD_TABLE_SIZE
 #define NX_DHCP_CLIENT_RECORD_TABLE_SIZE      50 
+#endif
+
+/* Define the number of hash chains of the client records, looked up by hardware address
+   at each client message. Must be a power of 2. */
+
+#ifndef NX_DHCP_CLIENT_RECORD_INDEX_SIZE
+#define NX_DHCP_CLIENT_RECORD_INDEX_SIZE      16
+#endif
+
+#if ((NX_DHCP_CLIENT_RECORD_INDEX_SIZE & (NX_DHCP_CLIENT_RECORD_INDEX_SIZE - 1)) != 0)
+#error "NX_DHCP_CLIENT_RECORD_INDEX_SIZE must be a power of 2."
 #endif
 
     /* END OF CONFIGURABLE OPTIONS */
@@ -316,6 +327,8 @@ extern   "C" {
 #define NX_DHCP_SERVER_OPTION_REBIND_SIZE      4
 #define NX_DHCP_SERVER_OPTION_CLIENT_ID        61
 #define NX_DHCP_SERVER_OPTION_CLIENT_ID_SIZE   7  
+#define NX_DHCP_SERVER_OPTION_RAPID_COMMIT     80
+#define NX_DHCP_SERVER_OPTION_RAPID_COMMIT_SIZE 0
 #define NX_DHCP_SERVER_OPTION_FDQN             81
 #define NX_DHCP_SERVER_OPTION_FDQN_FLAG_N      8
 #define NX_DHCP_SERVER_OPTION_FDQN_FLAG_E      4
@@ -421,6 +434,20 @@ extern   "C" {
 #define NX_DHCP_OPTIONS_FOR_GENERIC_ACK         0x05
 #define NX_DHCP_OPTIONS_REQUESTED_BY_CLIENT     0x06
 
+/* Define the hardware type of the static leases, Ethernet. */
+
+#define NX_DHCP_STATIC_LEASE_HW_TYPE            1
+
+/* Define the static lease structure, an address always assigned to the same client hardware address.
+   The application keeps its table of static leases, e.g. constant in flash. */
+
+typedef struct NX_DHCP_STATIC_LEASE_STRUCT
+{
+    ULONG           nx_dhcp_static_mac_msw;         /* Client MAC address high bits */
+    ULONG           nx_dhcp_static_mac_lsw;         /* Client MAC address low bits */
+    ULONG           nx_dhcp_static_ip_address;      /* IP address of the client, in the interface address list */
+} NX_DHCP_STATIC_LEASE;
+
 /* Define the DHCP structure that contains DHCP client information during DHCP session.  Note
    this is not the same control block as the NX_DHCP_STRUCT in nx_dhcp.h for the NetX DHCP Client
    package.  */
@@ -458,6 +485,9 @@ typedef struct NX_DHCP_CLIENT_STRUCT
     ULONG           nx_dhcp_session_timeout;     /* Time out on waiting for client's next response */
     UINT            nx_dhcp_response_type_to_client; 
                                                  /* DHCP code for response to send back to client. */
+    UINT            nx_dhcp_rapid_commit;        /* Client message carries the Rapid Commit option. */
+    struct NX_DHCP_CLIENT_STRUCT
+                   *nx_dhcp_client_index_next;   /* Next record of the same hash chain. */
 
 } NX_DHCP_CLIENT;
 
@@ -471,6 +501,7 @@ typedef struct NX_DHCP_INTERFACE_IP_ADDRESS_STRUCT
     UINT            owner_hwtype;                   /* Hardware type.  */
     UINT            owner_mac_msw;                  /* MAC address high bits.  */
     UINT            owner_mac_lsw;                  /* MAC address low bits.  */
+    UINT            reserved;                       /* Static lease, the owner keeps the address.  */
 } NX_DHCP_INTERFACE_IP_ADDRESS;
 
 
@@ -486,6 +517,9 @@ typedef struct NX_DHCP_INTERFACE_TABLE_STRUCT
     ULONG           nx_dhcp_subnet;                 /* DHCP server interface subnet. */
     ULONG           nx_dhcp_router_ip_address;      /* The router IP Address for DHCP client configuration  */
     UINT            nx_dhcp_address_list_size;      /* Actual number of assignable addresses for this interface. */
+    const NX_DHCP_STATIC_LEASE
+                   *nx_dhcp_static_lease_table;     /* Static leases of this interface. */
+    UINT            nx_dhcp_static_lease_count;     /* Number of static leases. */
 
 } NX_DHCP_INTERFACE_TABLE;
 
@@ -508,6 +542,8 @@ typedef struct NX_DHCP_SERVER_STRUCT
     TX_EVENT_FLAGS_GROUP nx_dhcp_server_events;     /* DHCP Server events. */
     UINT            nx_dhcp_number_clients;         /* Number of clients currently assigned IP address by this server. */
     NX_DHCP_CLIENT  client_records[NX_DHCP_CLIENT_RECORD_TABLE_SIZE];   /* Table of DHCP clients.*/
+    NX_DHCP_CLIENT *nx_dhcp_client_index[NX_DHCP_CLIENT_RECORD_INDEX_SIZE];
+                                                    /* Hash chains of the client records by hardware address. */
                                                     /* List of IP addresses server can assign to DHCP Clients */
     NX_UDP_SOCKET   nx_dhcp_socket;                 /* DHCP server socket to receive DHCP messages on its interfaces. */
     UINT            nx_dhcp_server_options[NX_DHCP_SERVER_OPTION_LIST_SIZE]; 
@@ -541,6 +577,7 @@ typedef struct NX_DHCP_SERVER_STRUCT
 #define nx_dhcp_server_create                  _nx_dhcp_server_create
 #define nx_dhcp_create_server_ip_address_list  _nx_dhcp_create_server_ip_address_list
 #define nx_dhcp_set_interface_network_parameters  _nx_dhcp_set_interface_network_parameters
+#define nx_dhcp_set_interface_static_leases    _nx_dhcp_set_interface_static_leases
 #define nx_dhcp_server_delete                  _nx_dhcp_server_delete
 #define nx_dhcp_server_start                   _nx_dhcp_server_start
 #define nx_dhcp_server_stop                    _nx_dhcp_server_stop
@@ -553,6 +590,7 @@ typedef struct NX_DHCP_SERVER_STRUCT
 #define nx_dhcp_server_create                  _nxe_dhcp_server_create
 #define nx_dhcp_create_server_ip_address_list  _nxe_dhcp_create_server_ip_address_list
 #define nx_dhcp_set_interface_network_parameters  _nxe_dhcp_set_interface_network_parameters
+#define nx_dhcp_set_interface_static_leases    _nxe_dhcp_set_interface_static_leases
 #define nx_dhcp_server_delete                  _nxe_dhcp_server_delete
 #define nx_dhcp_server_start                   _nxe_dhcp_server_start
 #define nx_dhcp_server_stop                    _nxe_dhcp_server_stop
@@ -564,6 +602,7 @@ typedef struct NX_DHCP_SERVER_STRUCT
 UINT        nx_dhcp_server_create(NX_DHCP_SERVER *dhcp_ptr, NX_IP *ip_ptr, VOID *stack_ptr, ULONG stack_size, CHAR *name_ptr, NX_PACKET_POOL *packet_pool);
 UINT        nx_dhcp_create_server_ip_address_list(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, ULONG start_ip_address, ULONG end_ip_address, UINT *addresses_added);
 UINT        nx_dhcp_set_interface_network_parameters(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index,  ULONG subnet_mask, ULONG default_gateway_address, ULONG dns_server_address);
+UINT        nx_dhcp_set_interface_static_leases(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, const NX_DHCP_STATIC_LEASE *lease_table, UINT lease_count);
 UINT        nx_dhcp_server_delete(NX_DHCP_SERVER *dhcp_ptr);
 UINT        nx_dhcp_server_start(NX_DHCP_SERVER *dhcp_ptr);
 UINT        nx_dhcp_server_stop(NX_DHCP_SERVER *dhcp_ptr);
@@ -580,6 +619,8 @@ UINT        _nx_dhcp_create_server_ip_address_list(NX_DHCP_SERVER *dhcp_ptr, UIN
 UINT        _nxe_dhcp_create_server_ip_address_list(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, ULONG start_ip_address, ULONG end_ip_address, UINT *addresses_added);
 UINT        _nxe_dhcp_set_interface_network_parameters(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index,  ULONG subnet_mask, ULONG default_gateway_address, ULONG dns_server_address);
 UINT        _nx_dhcp_set_interface_network_parameters(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index,  ULONG subnet_mask, ULONG default_gateway_address, ULONG dns_server_address);
+UINT        _nxe_dhcp_set_interface_static_leases(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, const NX_DHCP_STATIC_LEASE *lease_table, UINT lease_count);
+UINT        _nx_dhcp_set_interface_static_leases(NX_DHCP_SERVER *dhcp_ptr, UINT iface_index, const NX_DHCP_STATIC_LEASE *lease_table, UINT lease_count);
 UINT        _nxe_dhcp_server_delete(NX_DHCP_SERVER *dhcp_ptr);
 UINT        _nx_dhcp_server_delete(NX_DHCP_SERVER *dhcp_ptr);
 UINT        _nxe_dhcp_server_start(NX_DHCP_SERVER *dhcp_ptr);
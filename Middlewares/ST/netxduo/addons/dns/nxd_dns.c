@@ -85,6 +85,8 @@ static UINT        _nx_dns_cache_delete_rr(NX_DNS *dns_ptr, VOID *cache_ptr, UIN
 static UINT        _nx_dns_cache_delete_rr_string(NX_DNS *dns_ptr, VOID *cache_ptr, UINT cache_size, NX_DNS_RR *record_ptr);
 static UINT        _nx_dns_cache_add_string(NX_DNS *dns_ptr, VOID *cache_ptr, UINT cache_size, VOID *string_ptr, UINT string_size, VOID **insert_ptr);
 static UINT        _nx_dns_cache_delete_string(NX_DNS *dns_ptr, VOID *cache_ptr, UINT cache_size, VOID *string_ptr, UINT string_len);  
+static UINT        _nx_dns_cache_index_hash(UCHAR *name, USHORT type);
+static VOID        _nx_dns_cache_index_remove(NX_DNS *dns_ptr, NX_DNS_RR *record_ptr);
 static UINT        _nx_dns_resource_time_to_live_get(UCHAR *resource, NX_PACKET *packet_ptr, ULONG *rr_ttl);
 #endif /* NX_DNS_CACHE_ENABLE  */
 
@@ -9483,6 +9485,9 @@ ALIGN_TYPE *tail;
     dns_ptr -> nx_dns_string_count = 0;
     dns_ptr -> nx_dns_string_bytes = 0;
 
+    /* Clear the hash chains.  */
+    memset(dns_ptr -> nx_dns_cache_index, 0, sizeof(dns_ptr -> nx_dns_cache_index));
+
     /* Put the DNS mutex.  */
     tx_mutex_put(&dns_ptr -> nx_dns_mutex);
 
@@ -9744,6 +9749,155 @@ UINT _nx_dns_cache_notify_clear(NX_DNS *dns_ptr)
 #endif /* NX_DNS_CACHE_ENABLE  */
 
 
+#ifdef NX_DNS_CACHE_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxe_dns_cache_ttl_get                              PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the DNS cache time to live get   */
+/*    function call.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    dns_ptr                           Pointer to DNS instance           */
+/*    host_name                         Name of the resource record       */
+/*    rr_type                           Type of the resource record       */
+/*    ttl_ptr                           Pointer to the remaining TTL      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_dns_cache_ttl_get             Actual cache time to live get     */
+/*                                        function                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxe_dns_cache_ttl_get(NX_DNS *dns_ptr, UCHAR *host_name, USHORT rr_type, ULONG *ttl_ptr)
+{
+
+UINT    status;
+
+
+    /* Check for invalid input pointers.  */
+    if ((dns_ptr == NX_NULL) || (host_name == NX_NULL) || (ttl_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Check for invalid non pointer input. */
+    if (dns_ptr -> nx_dns_id != NX_DNS_ID)
+    {
+        return(NX_DNS_PARAM_ERROR);
+    }
+
+    /* Call actual DNS cache time to live get function.  */
+    status =  _nx_dns_cache_ttl_get(dns_ptr, host_name, rr_type, ttl_ptr);
+
+    /* Return status.  */
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_dns_cache_ttl_get                               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the time to live left, in seconds, to the     */
+/*    first unexpired resource record of the cache with the given name    */
+/*    and type, so that the application can refresh the answer before it  */
+/*    expires. The record and its time to live are not modified.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    dns_ptr                           Pointer to DNS instance           */
+/*    host_name                         Name of the resource record       */
+/*    rr_type                           Type of the resource record       */
+/*    ttl_ptr                           Pointer to the remaining TTL      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                      Get the DNS mutex                 */
+/*    tx_mutex_put                      Put the DNS mutex                 */
+/*    _nx_utility_string_length_check   Check string length               */
+/*    _nx_dns_name_match                Compare the names                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_dns_cache_ttl_get(NX_DNS *dns_ptr, UCHAR *host_name, USHORT rr_type, ULONG *ttl_ptr)
+{
+
+NX_DNS_RR           *p;
+ULONG               elapsed_ttl;
+UINT                name_length;
+UINT                status;
+
+
+    /* Check the name string.  */
+    if (_nx_utility_string_length_check((CHAR *)host_name, &name_length, NX_DNS_NAME_MAX))
+    {
+        return(NX_DNS_CACHE_ERROR);
+    }
+
+    status = NX_DNS_ENTRY_NOT_FOUND;
+
+    /* Get the DNS mutex.  */
+    tx_mutex_get(&(dns_ptr -> nx_dns_mutex), TX_WAIT_FOREVER);
+
+    if (dns_ptr -> nx_dns_cache != NX_NULL)
+    {
+
+        /* Only the records of the hash chain of the name and type may match.  */
+        for(p = dns_ptr -> nx_dns_cache_index[_nx_dns_cache_index_hash(host_name, rr_type)]; p != NX_NULL; p = p -> nx_dns_rr_index_next)
+        {
+
+            /* Check the resource record type. */
+            if (p -> nx_dns_rr_type != rr_type)
+                continue;
+
+            /* Check the resource record name.  */
+            if (_nx_dns_name_match(p -> nx_dns_rr_name, host_name, name_length))
+                continue;
+
+            /* Skip the record expired, it is deleted by the next lookup.  */
+            elapsed_ttl = (tx_time_get() - p -> nx_dns_rr_last_used_time) / NX_IP_PERIODIC_RATE;
+            if (elapsed_ttl >= p -> nx_dns_rr_ttl)
+                continue;
+
+            *ttl_ptr = p -> nx_dns_rr_ttl - elapsed_ttl;
+            status = NX_DNS_SUCCESS;
+            break;
+        }
+    }
+
+    /* Release the DNS mutex.  */
+    tx_mutex_put(&(dns_ptr -> nx_dns_mutex));
+
+    return(status);
+}
+#endif /* NX_DNS_CACHE_ENABLE  */
+
+
 #ifdef NX_DNS_CACHE_ENABLE
 /**************************************************************************/ 
 /*                                                                        */ 
@@ -9792,6 +9946,7 @@ NX_DNS_RR   *rr;
 ULONG       elapsed_time;
 ULONG       current_time;
 ULONG       max_elapsed_time;
+UINT        index;
                             
                                    
     /* Check the cache.  */
@@ -9886,6 +10041,11 @@ ULONG       max_elapsed_time;
     /* Get the current time to set the elapsed time.  */
     rr -> nx_dns_rr_last_used_time = current_time;
 
+    /* Link the record at the head of its hash chain.  */
+    index = _nx_dns_cache_index_hash(rr -> nx_dns_rr_name, rr -> nx_dns_rr_type);
+    rr -> nx_dns_rr_index_next = dns_ptr -> nx_dns_cache_index[index];
+    dns_ptr -> nx_dns_cache_index[index] = rr;
+
     /* Set the insert ptr.  */
     if(insert_ptr != NX_NULL)
         *insert_ptr = rr;
@@ -9952,8 +10112,8 @@ ULONG       max_elapsed_time;
 static UINT _nx_dns_cache_find_answer(NX_DNS *dns_ptr, VOID *cache_ptr, UCHAR *query_name, USHORT query_type, UCHAR *buffer, UINT buffer_size, UINT *record_count)
 {
 
-ALIGN_TYPE          *head;
 NX_DNS_RR           *p;      
+NX_DNS_RR           *next_rr;
 ULONG               current_time;   
 ULONG               elasped_ttl;    
 UINT                old_count;
@@ -9999,17 +10159,12 @@ UINT                 mname_string_length;
     /* Get the current time.  */
     current_time = tx_time_get();
 
-    /* Get head. */
-    head = (ALIGN_TYPE*)cache_ptr;
-    head = (ALIGN_TYPE*)(*head);
-
-    /* Lookup the cache to delete the expired resource record and find the answer.  */ 
-    for(p = (NX_DNS_RR*)((UCHAR*)cache_ptr + sizeof(ALIGN_TYPE)); (ALIGN_TYPE*)p < head; p++)
+    /* Lookup the hash chain of the name and type to delete the expired resource record and find the answer.  */ 
+    for(p = dns_ptr -> nx_dns_cache_index[_nx_dns_cache_index_hash(query_name, query_type)]; p != NX_NULL; p = next_rr)
     {
 
-        /* Check whether the resource record is valid. */
-        if (!p -> nx_dns_rr_name)
-            continue;  
+        /* Get the next record before this one is deleted.  */
+        next_rr = p -> nx_dns_rr_index_next;
 
         /* Calucate the elapsed time.  */
         elasped_ttl = (current_time - p -> nx_dns_rr_last_used_time) / NX_IP_PERIODIC_RATE;
@@ -10345,6 +10500,9 @@ ALIGN_TYPE  *head;
     if (cache_ptr == NX_NULL)
         return(NX_DNS_CACHE_ERROR);
 
+    /* Unlink the record from its hash chain, while its name is valid. */
+    _nx_dns_cache_index_remove(dns_ptr, record_ptr);
+
     /* Delete the resource record strings. */
     _nx_dns_cache_delete_rr_string(dns_ptr, cache_ptr,cache_size, record_ptr);
     
@@ -10909,3 +11067,121 @@ UINT    index = 0;
     return(NX_DNS_SUCCESS);
 }
 #endif /* NX_DNS_CACHE_ENABLE  */       
+
+
+#ifdef NX_DNS_CACHE_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_dns_cache_index_hash                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the hash chain of the cache records of a name */
+/*    and type, FNV-1a of the name and type. The letters are hashed in    */
+/*    lowercase, as _nx_dns_name_match compares them regardless of case.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    name                                  Name string                   */
+/*    type                                  Resource record type          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    index                                 Index of the hash chain       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_dns_cache_add_rr                  Add the RR into cache         */
+/*    _nx_dns_cache_find_answer             Find the answer in cache      */
+/*    _nx_dns_cache_index_remove            Unlink the RR from its chain  */
+/*    _nx_dns_cache_ttl_get                 Get the TTL left of a RR      */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_dns_cache_index_hash(UCHAR *name, USHORT type)
+{
+
+ULONG   hash = 2166136261UL;
+UCHAR   c;
+
+
+    /* Hash the name.  */
+    while (*name != '\0')
+    {
+        c = *name;
+        if ((c >= 'A') && (c <= 'Z'))
+            c = (UCHAR)(c | 0x20);
+        hash = (hash ^ c) * 16777619UL;
+        name++;
+    }
+
+    /* Hash the type.  */
+    hash = (hash ^ type) * 16777619UL;
+
+    /* Fold the upper bits in, the index takes the lower ones.  */
+    hash ^= hash >> 16;
+
+    return((UINT)(hash & (NX_DNS_CACHE_INDEX_SIZE - 1)));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_dns_cache_index_remove                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function unlinks a resource record from its hash chain. A      */
+/*    record not in the cache, such as a temporary one, is not found and  */
+/*    nothing is changed.                                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    dns_ptr                               Pointer to DNS instance       */
+/*    record_ptr                            Pointer to the record         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_dns_cache_index_hash              Get the hash chain            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_dns_cache_delete_rr               Delete the RR from cache      */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_dns_cache_index_remove(NX_DNS *dns_ptr, NX_DNS_RR *record_ptr)
+{
+
+NX_DNS_RR   **link_ptr;
+
+
+    /* A free record is in no chain.  */
+    if (!record_ptr -> nx_dns_rr_name)
+        return;
+
+    /* Find the link to the record in its chain.  */
+    link_ptr = &(dns_ptr -> nx_dns_cache_index[_nx_dns_cache_index_hash(record_ptr -> nx_dns_rr_name, record_ptr -> nx_dns_rr_type)]);
+    while (*link_ptr != NX_NULL)
+    {
+        if (*link_ptr == record_ptr)
+        {
+
+            /* Unlink the record.  */
+            *link_ptr = record_ptr -> nx_dns_rr_index_next;
+            return;
+        }
+        link_ptr = &((*link_ptr) -> nx_dns_rr_index_next);
+    }
+}
+#endif /* NX_DNS_CACHE_ENABLE  */
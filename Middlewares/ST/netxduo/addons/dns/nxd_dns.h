@@ -123,6 +123,7 @@ extern   "C" {
 #define NX_DNS_FEATURE_NOT_SUPPORTED    0xB5        /* The requested feature is not supported in this build */
 #define NX_DNS_NAME_MISMATCH            0xB6        /* The name mismatch.                                   */
 #define NX_DNS_CACHE_ERROR              0xB7        /* The Cache size is not enough.                        */ 
+#define NX_DNS_ENTRY_NOT_FOUND          0xB8        /* No unexpired record of the name in the cache         */
 
 
 /* Define constants for the flags word.  */
@@ -233,6 +234,17 @@ extern   "C" {
 #define NX_DNS_CACHE_ENABLE
 */
 
+/* Define the number of hash chains of the cache, a power of 2. The records are
+   chained by their name and type, so that a lookup only compares the names of
+   the records of its chain.  */
+#ifndef NX_DNS_CACHE_INDEX_SIZE
+#define NX_DNS_CACHE_INDEX_SIZE         16
+#endif
+
+#if (NX_DNS_CACHE_INDEX_SIZE & (NX_DNS_CACHE_INDEX_SIZE - 1)) != 0
+#error "NX_DNS_CACHE_INDEX_SIZE must be a power of 2"
+#endif
+
 /* Define UDP socket create options.  */
 
 #ifndef NX_DNS_TYPE_OF_SERVICE
@@ -333,6 +345,8 @@ typedef struct NX_IP_DNS_STRUCT
     ULONG           nx_dns_string_count;                            /* The number of strings in the cache.                      */         
     ULONG           nx_dns_string_bytes;                            /* The number of total bytes in string table in the cache.  */ 
     VOID            (*nx_dns_cache_full_notify)(struct NX_IP_DNS_STRUCT *);
+    struct NX_DNS_RR_STRUCT
+                    *nx_dns_cache_index[NX_DNS_CACHE_INDEX_SIZE];   /* Hash chains of the records, by name and type.            */
 #endif /* NX_DNS_CACHE_ENABLE  */
 } NX_DNS;
 
@@ -804,6 +818,11 @@ typedef struct NX_DNS_RR_STRUCT
                                      
     ULONG   nx_dns_rr_last_used_time;           /* Define the last used time for the peer RR.               */
 
+#ifdef NX_DNS_CACHE_ENABLE
+    struct NX_DNS_RR_STRUCT
+           *nx_dns_rr_index_next;               /* Next record of the hash chain in the cache.              */
+#endif /* NX_DNS_CACHE_ENABLE  */
+
     /* Union that holds resource record data. */
     union   nx_dns_rr_rdata_union
     {
@@ -868,6 +887,7 @@ typedef struct NX_DNS_RR_STRUCT
 #define nx_dns_cache_initialize                     _nx_dns_cache_initialize   
 #define nx_dns_cache_notify_set                     _nx_dns_cache_notify_set
 #define nx_dns_cache_notify_clear                   _nx_dns_cache_notify_clear
+#define nx_dns_cache_ttl_get                        _nx_dns_cache_ttl_get
 #endif /* NX_DNS_CACHE_ENABLE  */
 
 #else
@@ -908,6 +928,7 @@ typedef struct NX_DNS_RR_STRUCT
 #define nx_dns_cache_initialize                     _nxe_dns_cache_initialize   
 #define nx_dns_cache_notify_set                     _nxe_dns_cache_notify_set
 #define nx_dns_cache_notify_clear                   _nxe_dns_cache_notify_clear
+#define nx_dns_cache_ttl_get                        _nxe_dns_cache_ttl_get
 #endif /* NX_DNS_CACHE_ENABLE  */
 
 #endif
@@ -947,6 +968,7 @@ UINT        nxd_dns_server_get(NX_DNS *dns_ptr, UINT index, NXD_ADDRESS *dns_ser
 UINT        nx_dns_cache_initialize(NX_DNS *dns_ptr, VOID *cache_ptr, UINT cache_size); 
 UINT        nx_dns_cache_notify_set(NX_DNS *dns_ptr, VOID (*cache_full_notify_cb)(NX_DNS *dns_ptr));
 UINT        nx_dns_cache_notify_clear(NX_DNS *dns_ptr);    
+UINT        nx_dns_cache_ttl_get(NX_DNS *dns_ptr, UCHAR *host_name, USHORT rr_type, ULONG *ttl_ptr);
 #endif /* NX_DNS_CACHE_ENABLE  */
 
 #else
@@ -1013,6 +1035,8 @@ UINT        _nxe_dns_cache_notify_set(NX_DNS *dns_ptr, VOID (*cache_full_notify_
 UINT        _nx_dns_cache_notify_set(NX_DNS *dns_ptr, VOID (*cache_full_notify_cb)(NX_DNS *dns_ptr)); 
 UINT        _nxe_dns_cache_notify_clear(NX_DNS *dns_ptr);     
 UINT        _nx_dns_cache_notify_clear(NX_DNS *dns_ptr);    
+UINT        _nxe_dns_cache_ttl_get(NX_DNS *dns_ptr, UCHAR *host_name, USHORT rr_type, ULONG *ttl_ptr);
+UINT        _nx_dns_cache_ttl_get(NX_DNS *dns_ptr, UCHAR *host_name, USHORT rr_type, ULONG *ttl_ptr);
 #endif /* NX_DNS_CACHE_ENABLE  */
 
 #endif
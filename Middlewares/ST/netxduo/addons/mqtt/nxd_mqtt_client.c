@@ -47,18 +47,78 @@
 #define MQTT_PING_TIMEOUT_EVENT       ((ULONG)0x00000010)
 #define MQTT_NETWORK_DISCONNECT_EVENT ((ULONG)0x00000020)
 #define MQTT_TCP_ESTABLISH_EVENT      ((ULONG)0x00000040)
+#define MQTT_PUBLISH_ENQUEUE_EVENT    ((ULONG)0x00000080)
+
+#ifdef NX_SECURE_ENABLE
+/* Release the TLS session of a connection that ended or failed to start. Kept,
+   the session is only reset and deleted with the client.  */
+#ifdef NXD_MQTT_TLS_SESSION_KEEP
+#define NXD_MQTT_TLS_SESSION_RELEASE(client_ptr)  nx_secure_tls_session_reset(&((client_ptr) -> nxd_mqtt_tls_session))
+#else
+#define NXD_MQTT_TLS_SESSION_RELEASE(client_ptr)  nx_secure_tls_session_delete(&((client_ptr) -> nxd_mqtt_tls_session))
+#endif /* NXD_MQTT_TLS_SESSION_KEEP */
+#endif /* NX_SECURE_ENABLE */
 
 static UINT _nxd_mqtt_client_create_internal(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
                                              CHAR *client_id, UINT client_id_length,
                                              NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
                                              VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority);
-static UINT _nxd_mqtt_packet_allocate(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr);
+static UINT _nxd_mqtt_client_sub_unsub_send(NXD_MQTT_CLIENT *client_ptr, UINT op,
+                                            NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count,
+                                            USHORT *packet_id_ptr);
+static VOID _nxd_mqtt_topic_filter_results_set(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                               USHORT packet_id, ULONG offset, ULONG end);
+static UINT _nxd_mqtt_packet_allocate(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr, ULONG payload_size);
 static UINT _nxd_mqtt_copy_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET **new_packet_ptr,
                                            USHORT packet_id, UCHAR set_duplicate_flag, UINT wait_option);
 static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr);
+static VOID _nxd_mqtt_release_transmit_queue(NXD_MQTT_CLIENT *client_ptr);
+static UINT _nxd_mqtt_inflight_slot_find(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
+static UINT _nxd_mqtt_transmit_queue_append(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
+static NX_PACKET *_nxd_mqtt_transmit_packet_find(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, UCHAR header_mask,
+                                                 UCHAR header_value, NX_PACKET **previous_packet_ptr);
 static VOID _nxd_mqtt_release_receive_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr);
 static UINT _nxd_mqtt_client_retransmit_message(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+static NXD_MQTT_LAST_VALUE_ENTRY *_nxd_mqtt_last_value_find(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_ptr, UINT topic_length,
+                                                            ULONG hash, UINT *index_ptr);
+static ULONG _nxd_mqtt_last_value_hash(UCHAR *topic_ptr, UINT topic_length);
+static VOID _nxd_mqtt_last_value_update(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
+static UINT _nxd_mqtt_qos2_entry_find(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, USHORT phase);
+static UINT _nxd_mqtt_qos2_entry_add(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, USHORT phase);
+static VOID _nxd_mqtt_qos2_entry_remove(NXD_MQTT_CLIENT *client_ptr, UINT hole);
+static UINT _nxd_mqtt_publish_response_send(NXD_MQTT_CLIENT *client_ptr, UCHAR header, USHORT packet_id, UINT keep_copy);
+static UINT _nxd_mqtt_message_length_get(NX_PACKET *packet_ptr, ULONG *message_length_ptr);
 static UINT _nxd_mqtt_client_connect_packet_send(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+static UINT _nxd_mqtt_client_connect_packet_transmit(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
+static UINT _nxd_mqtt_client_publish_batch_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
+static UINT _nxd_mqtt_client_publish_packet_transmit(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                     USHORT packet_id, UINT QoS, UINT lane, UINT topic_strip_length,
+                                                     ULONG wait_option);
+static UINT _nxd_mqtt_lane_token_get(NXD_MQTT_CLIENT *client_ptr, UINT lane, ULONG wait_option);
+static UINT _nxd_mqtt_lane_publish_fragments(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                             NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG wait_option);
+static VOID _nxd_mqtt_publish_topic_strip(NX_PACKET *packet_ptr, UINT topic_length);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+static VOID _nxd_mqtt_latency_batch_sent(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *skip_packet_ptr);
+static VOID _nxd_mqtt_latency_histogram_add(NXD_MQTT_LATENCY_HISTOGRAM *histogram_ptr, ULONG microseconds);
+static VOID _nxd_mqtt_latency_record(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *transmit_packet_ptr);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+#ifdef NXD_MQTT_V5_ENABLE
+static UINT _nxd_mqtt_read_variable_integer(NX_PACKET *packet_ptr, ULONG offset, UINT *value_ptr, ULONG *size_ptr);
+static UINT _nxd_mqtt_process_properties(NX_PACKET *packet_ptr, ULONG offset, ULONG end,
+                                         UINT *topic_alias_maximum_ptr, ULONG *maximum_packet_size_ptr,
+                                         ULONG *next_offset_ptr);
+static UINT _nxd_mqtt_topic_alias_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      UINT *established_ptr);
+static VOID _nxd_mqtt_topic_alias_sent(NXD_MQTT_CLIENT *client_ptr, UINT alias, UINT status);
+#endif /* NXD_MQTT_V5_ENABLE */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+static VOID _nxd_mqtt_client_events_set(NXD_MQTT_CLIENT *client_ptr, ULONG events);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+static VOID _nxd_mqtt_publish_ring_drain(NXD_MQTT_CLIENT *client_ptr);
+static UINT _nxd_mqtt_receive_queue_full(NXD_MQTT_CLIENT *client_ptr, ULONG length);
+static VOID _nxd_mqtt_receive_queue_drop_oldest(NXD_MQTT_CLIENT *client_ptr, ULONG length);
+static VOID _nxd_mqtt_receive_queue_resume(NXD_MQTT_CLIENT *client_ptr);
 
 /**************************************************************************/
 /*                                                                        */
@@ -96,7 +156,7 @@ static UINT _nxd_mqtt_client_connect_packet_send(NXD_MQTT_CLIENT *client_ptr, UL
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_sub_unsub                                          */
+/*    _nxd_mqtt_client_sub_unsub_send                                     */
 /*    _nxd_mqtt_client_connect                                            */
 /*    _nxd_mqtt_client_publish                                            */
 /*                                                                        */
@@ -240,6 +300,239 @@ ULONG  bytes_copied;
 }
 
 
+#ifdef NXD_MQTT_V5_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_read_variable_integer                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function reads an MQTT 5 Variable Byte Integer, such  */
+/*    as a property length, at the given offset of a packet.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Incoming MQTT packet          */
+/*    offset                                Offset of the integer         */
+/*    value_ptr                             Pointer to the value          */
+/*    size_ptr                              Pointer to the number of      */
+/*                                            bytes of the integer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                                              */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_data_extract_offset                                       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_properties                                        */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_read_variable_integer(NX_PACKET *packet_ptr, ULONG offset, UINT *value_ptr, ULONG *size_ptr)
+{
+UINT   value = 0;
+UCHAR  bytes[4] = {0};
+UINT   multiplier = 1;
+UINT   byte_count = 0;
+ULONG  bytes_copied;
+
+    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied))
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+
+    do
+    {
+        if (byte_count >= bytes_copied)
+        {
+            return(NXD_MQTT_INVALID_PACKET);
+        }
+        value += (((bytes[byte_count]) & 0x7F) * multiplier);
+        multiplier = multiplier << 7;
+    } while ((bytes[byte_count++]) & 0x80);
+
+    *value_ptr = value;
+    *size_ptr = byte_count;
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_process_properties                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function walks the MQTT 5 properties of an incoming   */
+/*    packet, starting at their length field. It checks each property     */
+/*    fits in the packet and returns the Topic Alias Maximum and the      */
+/*    Maximum Packet Size, zero if the property is absent. Other          */
+/*    properties are skipped.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Incoming MQTT packet          */
+/*    offset                                Offset of the property length */
+/*    end                                   End of the MQTT packet        */
+/*    topic_alias_maximum_ptr               Pointer to Topic Alias        */
+/*                                            Maximum, can be NULL        */
+/*    maximum_packet_size_ptr               Pointer to Maximum Packet     */
+/*                                            Size, can be NULL           */
+/*    next_offset_ptr                       Pointer to the offset that    */
+/*                                            follows the properties      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                                              */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_read_variable_integer                                     */
+/*    nx_packet_data_extract_offset                                       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_connack                                           */
+/*    _nxd_mqtt_process_publish_packet                                    */
+/*    _nxd_mqtt_process_sub_unsub_ack                                     */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_process_properties(NX_PACKET *packet_ptr, ULONG offset, ULONG end,
+                                         UINT *topic_alias_maximum_ptr, ULONG *maximum_packet_size_ptr,
+                                         ULONG *next_offset_ptr)
+{
+UINT   properties_length;
+UINT   value;
+ULONG  size;
+ULONG  properties_end;
+UCHAR  bytes[5];
+ULONG  bytes_copied;
+UINT   strings;
+UCHAR  property_id;
+
+    if (topic_alias_maximum_ptr)
+    {
+        *topic_alias_maximum_ptr = 0;
+    }
+
+    if (maximum_packet_size_ptr)
+    {
+        *maximum_packet_size_ptr = 0;
+    }
+
+    if ((offset >= end) ||
+        _nxd_mqtt_read_variable_integer(packet_ptr, offset, &properties_length, &size))
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+
+    offset += size;
+    if (properties_length > end - offset)
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+    properties_end = offset + properties_length;
+
+    while (offset < properties_end)
+    {
+
+        /* Read the identifier and up to four bytes of value. */
+        if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
+            (bytes_copied == 0))
+        {
+            return(NXD_MQTT_INVALID_PACKET);
+        }
+        property_id = bytes[0];
+        offset++;
+
+        /* Size the value based on the type of the property. */
+        strings = 0;
+        switch (property_id)
+        {
+        case 0x01: case 0x17: case 0x19: case 0x24: case 0x25: case 0x28: case 0x29: case 0x2A:
+            size = 1;
+            break;
+
+        case 0x13: case 0x21: case 0x22: case 0x23:
+            size = 2;
+            break;
+
+        case 0x02: case 0x11: case 0x18: case 0x27:
+            size = 4;
+            break;
+
+        case 0x0B:
+            if (_nxd_mqtt_read_variable_integer(packet_ptr, offset, &value, &size))
+            {
+                return(NXD_MQTT_INVALID_PACKET);
+            }
+            break;
+
+        case 0x03: case 0x08: case 0x09: case 0x12: case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F:
+
+            /* UTF-8 string or binary data. */
+            strings = 1;
+            size = 0;
+            break;
+
+        case 0x26:
+
+            /* UTF-8 string pair. */
+            strings = 2;
+            size = 0;
+            break;
+
+        default:
+
+            /* Unknown property. */
+            return(NXD_MQTT_INVALID_PACKET);
+        }
+
+        /* Add the length fields and the bytes of the strings. */
+        while (strings--)
+        {
+            if ((properties_end - offset < size + 2) ||
+                nx_packet_data_extract_offset(packet_ptr, offset + size, &bytes, 2, &bytes_copied) ||
+                (bytes_copied != 2))
+            {
+                return(NXD_MQTT_INVALID_PACKET);
+            }
+            size += 2 + (ULONG)((bytes[0] << 8) | bytes[1]);
+        }
+
+        if (size > properties_end - offset)
+        {
+            return(NXD_MQTT_INVALID_PACKET);
+        }
+
+        if ((property_id == MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM) && topic_alias_maximum_ptr)
+        {
+            *topic_alias_maximum_ptr = (UINT)((bytes[1] << 8) | bytes[2]);
+        }
+
+        if ((property_id == MQTT_PROPERTY_MAXIMUM_PACKET_SIZE) && maximum_packet_size_ptr)
+        {
+            *maximum_packet_size_ptr = ((ULONG)bytes[1] << 24) | ((ULONG)bytes[2] << 16) |
+                                       ((ULONG)bytes[3] << 8) | (ULONG)bytes[4];
+        }
+
+        offset += size;
+    }
+
+    *next_offset_ptr = properties_end;
+
+    return(NXD_MQTT_SUCCESS);
+}
+#endif /* NXD_MQTT_V5_ENABLE */
+
 
 /**************************************************************************/
 /*                                                                        */
@@ -277,15 +570,7 @@ ULONG  bytes_copied;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_mutex_get                                                        */
-/*    _nxd_mqtt_packet_allocate                                           */
-/*    _nxd_mqtt_client_set_fixed_header                                   */
-/*    _nxd_mqtt_client_append_message                                     */
-/*    tx_mutex_put                                                        */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_secure_tls_session_send                                          */
-/*    nx_packet_release                                                   */
-/*    _nxd_mqtt_copy_transmit_packet                                      */
+/*    _nxd_mqtt_client_sub_unsub_send       Send the message              */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -309,6 +594,69 @@ UINT _nxd_mqtt_client_sub_unsub(NXD_MQTT_CLIENT *client_ptr, UINT op,
                                 USHORT *packet_id_ptr, UINT QoS)
 {
 
+NXD_MQTT_TOPIC_FILTER filter;
+
+
+    /* Send the topic as a list of one filter.  */
+    filter.nxd_mqtt_topic_filter_name = topic_name;
+    filter.nxd_mqtt_topic_filter_name_length = topic_name_length;
+    filter.nxd_mqtt_topic_filter_qos = QoS;
+
+    return(_nxd_mqtt_client_sub_unsub_send(client_ptr, op, &filter, 1, packet_id_ptr));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub_send                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sends one subscribe or unsubscribe message   */
+/*    with the topic filters of the list, in order. Each filter records   */
+/*    the packet ID of the message and is marked pending until the ACK of */
+/*    the broker, before the message can be answered.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    op                                    Subscribe or Unsubscribe      */
+/*    filter_list                           Pointer to the topic filters  */
+/*    filter_count                          Number of topic filters       */
+/*    packet_id_ptr                         Pointer to packet id that     */
+/*                                            will be filled with         */
+/*                                            assigned packet id for      */
+/*                                            sub/unsub message           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    _nxd_mqtt_client_set_fixed_header                                   */
+/*    _nxd_mqtt_client_append_message                                     */
+/*    tx_mutex_put                                                        */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_packet_release                                                   */
+/*    _nxd_mqtt_copy_transmit_packet                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub                                          */
+/*    _nxd_mqtt_client_subscribe_list                                     */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_sub_unsub_send(NXD_MQTT_CLIENT *client_ptr, UINT op,
+                                            NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count,
+                                            USHORT *packet_id_ptr)
+{
+
 
 NX_PACKET          *packet_ptr;
 NX_PACKET          *transmit_packet_ptr;
@@ -316,6 +664,7 @@ UINT                status;
 UINT                length = 0;
 UINT                ret = NXD_MQTT_SUCCESS;
 UCHAR               temp_data[2];
+UINT                i;
 
     /* Obtain the mutex. */
     status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
@@ -332,23 +681,31 @@ UCHAR               temp_data[2];
         return(NXD_MQTT_NOT_CONNECTED);
     }
 
-    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr);
-    if (status)
-    {
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-        return(status);
-    }
-
     /* Compute the remaining length field, starting with 2 bytes of packet ID */
     length = 2;
 
-    /* Count the topic. */
-    length += (2 + topic_name_length);
+    /* Count the topics. */
+    for (i = 0; i < filter_count; i++)
+    {
+        length += (2 + filter_list[i].nxd_mqtt_topic_filter_name_length);
+
+        if (op == ((MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02))
+        {
+            /* Count one byte for QoS */
+            length++;
+        }
+    }
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Count the property length, no property is sent. */
+    length++;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-    if (op == ((MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02))
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, length + 5);
+    if (status)
     {
-        /* Count one byte for QoS */
-        length++;
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(status);
     }
 
     /* Write out the control header and remaining length field. */
@@ -377,20 +734,31 @@ UCHAR               temp_data[2];
     /* Append packet ID. */
     ret = nx_packet_data_append(packet_ptr, temp_data, 2, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_WAIT_FOREVER);
 
-    if (ret)
+#ifdef NXD_MQTT_V5_ENABLE
+    if (!ret)
     {
 
-        /* Release the mutex. */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        /* Append an empty property length. */
+        temp_data[0] = 0;
+        ret = nx_packet_data_append(packet_ptr, temp_data, 1, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_WAIT_FOREVER);
+    }
+#endif /* NXD_MQTT_V5_ENABLE */
 
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
+    for (i = 0; (i < filter_count) && (!ret); i++)
+    {
 
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
+        /* Append topic name */
+        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, filter_list[i].nxd_mqtt_topic_filter_name,
+                                              filter_list[i].nxd_mqtt_topic_filter_name_length, NX_WAIT_FOREVER);
 
-    /* Append topic name */
-    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, topic_name, topic_name_length, NX_WAIT_FOREVER);
+        if ((!ret) && (op == ((MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02)))
+        {
+            /* Fill in QoS value. */
+            temp_data[0] = filter_list[i].nxd_mqtt_topic_filter_qos & 0x3;
+
+            ret = nx_packet_data_append(packet_ptr, temp_data, 1, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_WAIT_FOREVER);
+        }
+    }
 
     if (ret)
     {
@@ -404,26 +772,6 @@ UCHAR               temp_data[2];
         return(NXD_MQTT_PACKET_POOL_FAILURE);
     }
 
-    if (op == ((MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02))
-    {
-        /* Fill in QoS value. */
-        temp_data[0] = QoS & 0x3;
-
-        ret = nx_packet_data_append(packet_ptr, temp_data, 1, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_WAIT_FOREVER);
-
-        if (ret)
-        {
-
-            /* Release the mutex. */
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-            /* Release the packet. */
-            nx_packet_release(packet_ptr);
-
-            return(NXD_MQTT_PACKET_POOL_FAILURE);
-        }
-    }
-
     /* Copy packet for retransmission. */
     if (_nxd_mqtt_copy_transmit_packet(client_ptr, packet_ptr, &transmit_packet_ptr,
                                        (USHORT)(client_ptr -> nxd_mqtt_client_packet_identifier),
@@ -438,15 +786,23 @@ UCHAR               temp_data[2];
         return(NXD_MQTT_PACKET_POOL_FAILURE);
     }
 
-    if (client_ptr -> message_transmit_queue_head == NX_NULL)
+    if (_nxd_mqtt_transmit_queue_append(client_ptr, transmit_packet_ptr))
     {
-        client_ptr -> message_transmit_queue_head = transmit_packet_ptr;
+        /* Release the mutex. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
     }
-    else
+
+    /* The ACK is matched to the filters by the packet ID, set before it can arrive. */
+    for (i = 0; i < filter_count; i++)
     {
-        client_ptr -> message_transmit_queue_tail -> nx_packet_queue_next = transmit_packet_ptr;
+        filter_list[i].nxd_mqtt_topic_filter_packet_id = (USHORT)(client_ptr -> nxd_mqtt_client_packet_identifier & 0xFFFF);
+        filter_list[i].nxd_mqtt_topic_filter_reason_code = NXD_MQTT_TOPIC_FILTER_PENDING;
     }
-    client_ptr -> message_transmit_queue_tail = transmit_packet_ptr;
 
     client_ptr -> nxd_mqtt_client_packet_identifier = (client_ptr -> nxd_mqtt_client_packet_identifier + 1) & 0xFFFF;
 
@@ -503,6 +859,8 @@ UCHAR               temp_data[2];
 /*    Special care has to be taken for accommodating IPv4/IPv6 header,    */
 /*    and possibly TLS record if TLS is being used. On failure, the       */
 /*    TLS mutex is released and the caller can simply return.             */
+/*    If the client pool is linked into packet pool size classes, the     */
+/*    smallest class that fits payload_size is tried first.               */
 /*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
@@ -510,6 +868,7 @@ UCHAR               temp_data[2];
 /*    client_ptr                            Pointer to MQTT Client        */
 /*    packet_ptr                            Allocated packet to be        */
 /*                                            returned to the caller.     */
+/*    payload_size                          Expected MQTT message size    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -519,7 +878,7 @@ UCHAR               temp_data[2];
 /*                                                                        */
 /*    nx_secure_tls_packet_allocate         Allocate packet for MQTT      */
 /*                                            over TLS socket             */
-/*    nx_packet_allocate                    Allocate a packet for MQTT    */
+/*    nx_packet_size_allocate               Allocate a packet for MQTT    */
 /*                                            over regular TCP socket     */
 /*    tx_mutex_put                          Release a mutex               */
 /*                                                                        */
@@ -541,13 +900,40 @@ UCHAR               temp_data[2];
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_packet_allocate(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr)
+static UINT _nxd_mqtt_packet_allocate(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr, ULONG payload_size)
 {
-UINT status = NXD_MQTT_SUCCESS;
-
+UINT            status = NXD_MQTT_SUCCESS;
+ULONG           packet_type;
+#ifdef NX_SECURE_ENABLE
+NX_PACKET_POOL *pool_ptr;
+#endif
+
+    if (client_ptr -> nxd_mqtt_client_socket.nx_tcp_socket_connect_ip.nxd_ip_version == NX_IP_VERSION_V4)
+    {
+        packet_type = NX_IPv4_TCP_PACKET;
+    }
+    else
+    {
+        packet_type = NX_IPv6_TCP_PACKET;
+    }
+
 #ifdef NX_SECURE_ENABLE
     if (client_ptr -> nxd_mqtt_client_use_tls)
     {
+
+        /* Try the smaller size classes that fit the record without waiting.  */
+        pool_ptr = client_ptr -> nxd_mqtt_client_packet_pool_ptr -> nx_packet_pool_class_first;
+        while ((pool_ptr != NX_NULL) && (pool_ptr -> nx_packet_pool_class_next != NX_NULL))
+        {
+            if ((pool_ptr -> nx_packet_pool_payload_size >= (packet_type + NXD_MQTT_TLS_PACKET_OVERHEAD + payload_size)) &&
+                (nx_secure_tls_packet_allocate(&client_ptr -> nxd_mqtt_tls_session, pool_ptr,
+                                               packet_ptr, NX_NO_WAIT) == NX_SUCCESS))
+            {
+                return(NXD_MQTT_SUCCESS);
+            }
+            pool_ptr = pool_ptr -> nx_packet_pool_class_next;
+        }
+
         /* Use TLS packet allocate.  The TLS packet allocate is able to count for 
            TLS-related header space including crypto initial vector area. */
         status = nx_secure_tls_packet_allocate(&client_ptr -> nxd_mqtt_tls_session, client_ptr -> nxd_mqtt_client_packet_pool_ptr,
@@ -557,27 +943,68 @@ UINT status = NXD_MQTT_SUCCESS;
     else
     {
 #endif
-        if (client_ptr -> nxd_mqtt_client_socket.nx_tcp_socket_connect_ip.nxd_ip_version == NX_IP_VERSION_V4)
-        {
-            status = nx_packet_allocate(client_ptr -> nxd_mqtt_client_packet_pool_ptr, packet_ptr, NX_IPv4_TCP_PACKET,
-                                        TX_WAIT_FOREVER);
-        }
-        else
-        {
-            status = nx_packet_allocate(client_ptr -> nxd_mqtt_client_packet_pool_ptr, packet_ptr, NX_IPv6_TCP_PACKET,
-                                        TX_WAIT_FOREVER);
-        }
+        status = nx_packet_size_allocate(client_ptr -> nxd_mqtt_client_packet_pool_ptr, packet_ptr, packet_type,
+                                         payload_size, TX_WAIT_FOREVER);
 #ifdef NX_SECURE_ENABLE
     }
 #endif
 
     if (status != NX_SUCCESS)
     {
+
+        /* Account the failure to MQTT in the pool statistics.  */
+        NX_PACKET_POOL_CALLER_FAILURE(client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_PACKET_POOL_CALLER_MQTT);
         return(NXD_MQTT_PACKET_POOL_FAILURE);
     }
     return(NXD_MQTT_SUCCESS);
 }
 
+#ifndef NXD_MQTT_CLOUD_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_events_set                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sets events of the client, and the flag of   */
+/*    the client in the group of the application thread that processes   */
+/*    them when one is set.  It is called from the IP thread and from the */
+/*    timer too.                                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    events                                Events to set                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_event_flags_set                                                  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    MQTT internal functions                                             */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_client_events_set(NXD_MQTT_CLIENT *client_ptr, ULONG events)
+{
+
+    tx_event_flags_set(&client_ptr -> nxd_mqtt_events, events, TX_OR);
+
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+    if (client_ptr -> nxd_mqtt_events_signal_ptr)
+    {
+        tx_event_flags_set(client_ptr -> nxd_mqtt_events_signal_ptr, client_ptr -> nxd_mqtt_events_signal_flag, TX_OR);
+    }
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+}
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -631,7 +1058,7 @@ NXD_MQTT_CLIENT *client_ptr;
 
         /* Set the event flag. */
 #ifndef NXD_MQTT_CLOUD_ENABLE
-        tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_TCP_ESTABLISH_EVENT, TX_OR);
+        _nxd_mqtt_client_events_set(client_ptr, MQTT_TCP_ESTABLISH_EVENT);
 #else
         nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_TCP_ESTABLISH_EVENT);
 #endif /* NXD_MQTT_CLOUD_ENABLE */
@@ -693,7 +1120,7 @@ NXD_MQTT_CLIENT *client_ptr;
     {
         /* Set the event flag. */
 #ifndef NXD_MQTT_CLOUD_ENABLE
-        tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_PACKET_RECEIVE_EVENT, TX_OR);
+        _nxd_mqtt_client_events_set(client_ptr, MQTT_PACKET_RECEIVE_EVENT);
 #else
         nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PACKET_RECEIVE_EVENT);
 #endif /* NXD_MQTT_CLOUD_ENABLE */
@@ -715,7 +1142,9 @@ NXD_MQTT_CLIENT *client_ptr;
 /*    This internal function saves a transmit packet.                     */
 /*    A transmit packet is allocated to store QoS 1 and 2 messages.       */
 /*    Upon a message being properly acknowledged, the packet will         */
-/*    be released.                                                        */
+/*    be released. The copy is taken from the smallest size class of the  */
+/*    client pool it fits in, so that a short message held until its      */
+/*    acknowledgement does not take a full size packet.                   */
 /*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
@@ -739,7 +1168,7 @@ NXD_MQTT_CLIENT *client_ptr;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_sub_unsub                                          */
+/*    _nxd_mqtt_client_sub_unsub_send                                     */
 /*    _nxd_mqtt_process_publish                                           */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
@@ -758,7 +1187,9 @@ NXD_MQTT_CLIENT *client_ptr;
 static UINT _nxd_mqtt_copy_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET **new_packet_ptr,
                                            USHORT packet_id, UCHAR set_duplicate_flag, UINT wait_option)
 {
-UINT status;
+UINT            status = NX_NO_PACKET;
+NX_PACKET_POOL *pool_ptr;
+ULONG           copy_size;
 
 #ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
     if (client_ptr -> message_transmit_queue_depth >= NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH)
@@ -769,8 +1200,25 @@ UINT status;
     }
 #endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
 
+    /* The copy keeps the headroom of the packet, to be sent again as is. */
+    copy_size = (ULONG)(packet_ptr -> nx_packet_prepend_ptr - packet_ptr -> nx_packet_data_start) + packet_ptr -> nx_packet_length;
+
+    /* Try the smaller size classes that hold the copy in one packet without waiting.  */
+    pool_ptr = client_ptr -> nxd_mqtt_client_packet_pool_ptr -> nx_packet_pool_class_first;
+    while ((pool_ptr != NX_NULL) && (pool_ptr -> nx_packet_pool_class_next != NX_NULL) && status)
+    {
+        if (pool_ptr -> nx_packet_pool_payload_size >= copy_size)
+        {
+            status = nx_packet_copy(packet_ptr, new_packet_ptr, pool_ptr, NX_NO_WAIT);
+        }
+        pool_ptr = pool_ptr -> nx_packet_pool_class_next;
+    }
+
     /* Copy current packet. */
-    status = nx_packet_copy(packet_ptr, new_packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    if (status)
+    {
+        status = nx_packet_copy(packet_ptr, new_packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
     if (status)
     {
         
@@ -781,6 +1229,12 @@ UINT status;
     /* Save packet_id at the beginning of packet. */
     *((USHORT *)(*new_packet_ptr) -> nx_packet_data_start) = packet_id;
 
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    /* The copy is timed from the publish call of the message, its send not stamped yet. */
+    NXD_MQTT_LATENCY_PUBLISH_TIME(*new_packet_ptr) = NXD_MQTT_LATENCY_PUBLISH_TIME(packet_ptr);
+    NXD_MQTT_LATENCY_SENT(*new_packet_ptr) = NX_FALSE;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
     if (set_duplicate_flag)
     {
         
@@ -811,7 +1265,8 @@ UINT status;
 /*    This internal function releases a transmit packet.                  */
 /*    A transmit packet is allocated to store QoS 1 and 2 messages.       */
 /*    Upon a message being properly acknowledged, the packet can          */
-/*    be released.                                                        */
+/*    be released. With an inflight table, previous_packet_ptr is taken   */
+/*    from the table.                                                     */
 /*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
@@ -850,6 +1305,51 @@ UINT status;
 /**************************************************************************/
 static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr)
 {
+NXD_MQTT_INFLIGHT_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_inflight_table;
+UINT                     mask;
+UINT                     hole;
+UINT                     index;
+UINT                     home;
+UINT                     count;
+
+    if (table_ptr)
+    {
+        mask = client_ptr -> nxd_mqtt_client_inflight_table_size - 1;
+        hole = _nxd_mqtt_inflight_slot_find(client_ptr, packet_ptr);
+
+        if (hole <= mask)
+        {
+
+            /* The table knows the previous packet, no need to walk the queue. */
+            previous_packet_ptr = table_ptr[hole].nxd_mqtt_inflight_previous_ptr;
+
+            /* Remove the entry and shift back the entries of the probe sequence behind it. */
+            index = (hole + 1) & mask;
+            for (count = 1; (count <= mask) && table_ptr[index].nxd_mqtt_inflight_packet_ptr; count++)
+            {
+                home = NXD_MQTT_INFLIGHT_HASH(table_ptr[index].nxd_mqtt_inflight_packet_ptr, mask);
+                if (((index - home) & mask) >= ((index - hole) & mask))
+                {
+                    table_ptr[hole] = table_ptr[index];
+                    hole = index;
+                }
+                index = (index + 1) & mask;
+            }
+            table_ptr[hole].nxd_mqtt_inflight_packet_ptr = NX_NULL;
+            table_ptr[hole].nxd_mqtt_inflight_previous_ptr = NX_NULL;
+            client_ptr -> nxd_mqtt_client_inflight_count--;
+        }
+
+        /* Link the next packet to the previous one. */
+        if (packet_ptr -> nx_packet_queue_next)
+        {
+            index = _nxd_mqtt_inflight_slot_find(client_ptr, packet_ptr -> nx_packet_queue_next);
+            if (index <= mask)
+            {
+                table_ptr[index].nxd_mqtt_inflight_previous_ptr = previous_packet_ptr;
+            }
+        }
+    }
 
     if (previous_packet_ptr)
     {
@@ -871,31 +1371,21 @@ static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PA
 #endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_release_receive_packet                    PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_release_transmit_queue                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function releases a receive packet.                   */
-/*    A receive packet is allocated to store QoS 1 and 2 messages.        */
-/*    Upon a message being properly acknowledged, the packet can          */
-/*    be released.                                                        */
-/*                                                                        */
+/*    This internal function releases all the packets of the transmit     */
+/*    queue back to their pools at once, and empties the inflight table.  */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the MQTT message   */
-/*                                            packet to be removed        */
-/*    previous_packet_ptr                   Pointer to the previous packet*/
-/*                                            or NULL if none exists      */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -903,525 +1393,527 @@ static VOID _nxd_mqtt_release_transmit_packet(NXD_MQTT_CLIENT *client_ptr, NX_PA
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    nx_packet_release_chain_bulk          Release the packet chains     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_thread_entry                                              */
 /*    _nxd_mqtt_client_event_process                                      */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_client_connect_packet_send                                */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_release_receive_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr)
+static VOID _nxd_mqtt_release_transmit_queue(NXD_MQTT_CLIENT *client_ptr)
 {
+NX_PACKET *packet_list = client_ptr -> message_transmit_queue_head;
 
-    if (previous_packet_ptr)
-    {
-        previous_packet_ptr -> nx_packet_queue_next = packet_ptr -> nx_packet_queue_next;
-    }
-    else
+    if (packet_list == NX_NULL)
     {
-        client_ptr -> message_receive_queue_head = packet_ptr -> nx_packet_queue_next;
+        return;
     }
 
-    if (packet_ptr == client_ptr -> message_receive_queue_tail)
+    /* The queued packets are linked by their queue next pointers already. */
+    nx_packet_release_chain_bulk(packet_list);
+
+    client_ptr -> message_transmit_queue_head = NX_NULL;
+    client_ptr -> message_transmit_queue_tail = NX_NULL;
+
+#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
+    client_ptr -> message_transmit_queue_depth = 0;
+#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+
+    if (client_ptr -> nxd_mqtt_client_inflight_table)
     {
-        client_ptr -> message_receive_queue_tail = previous_packet_ptr;
+        NXD_MQTT_SECURE_MEMSET(client_ptr -> nxd_mqtt_client_inflight_table, 0,
+                               client_ptr -> nxd_mqtt_client_inflight_table_size * sizeof(NXD_MQTT_INFLIGHT_ENTRY));
+        client_ptr -> nxd_mqtt_client_inflight_count = 0;
     }
-
-    client_ptr -> message_receive_queue_depth--;
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_process_connack                           PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_inflight_slot_find                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function processes a CONNACK message from the broker. */
-/*                                                                        */
+/*    This internal function returns the inflight table index holding a   */
+/*    transmit packet, or the table size when the packet is not in the    */
+/*    table.                                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the packet         */
-/*    wait_option                           Timeout value                 */
+/*    packet_ptr                            Pointer to transmit packet    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                                              */
+/*    index                                 Table index                   */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    [nxd_mqtt_connect_notify]             User supplied connect         */
-/*                                            callback function           */
-/*    tx_mutex_get                                                        */
-/*    tx_mutex_put                                                        */
-/*    _nxd_mqtt_client_retransmit_message                                 */
-/*    _nxd_mqtt_client_connection_end                                     */
-/*                                                                        */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_packet_receive_process                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_release_transmit_packet                                   */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_process_connack(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
+static UINT _nxd_mqtt_inflight_slot_find(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
+NXD_MQTT_INFLIGHT_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_inflight_table;
+UINT                     mask = client_ptr -> nxd_mqtt_client_inflight_table_size - 1;
+UINT                     index;
+UINT                     count;
 
-UINT    ret = NXD_MQTT_COMMUNICATION_FAILURE;
-MQTT_PACKET_CONNACK *connack_packet_ptr = (MQTT_PACKET_CONNACK *)(packet_ptr -> nx_packet_prepend_ptr);
-
-
-    /* Check the length.  */
-    if ((packet_ptr -> nx_packet_length != sizeof(MQTT_PACKET_CONNACK)) ||
-        (connack_packet_ptr -> mqtt_connack_packet_header >> 4 != MQTT_CONTROL_PACKET_TYPE_CONNACK))
-    {
-        /* Invalid packet length.  Free the packet and process error. */
-        ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
-    }
-    else
+    index = NXD_MQTT_INFLIGHT_HASH(packet_ptr, mask);
+    for (count = 0; count <= mask; count++)
     {
-
-        /* Check remaining length.  */
-        if (connack_packet_ptr -> mqtt_connack_packet_remaining_length != 2)
-        {
-            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
-        }
-        /* Follow MQTT-3.2.2-1 rule.  */
-        else if ((client_ptr -> nxd_mqtt_clean_session) && (connack_packet_ptr -> mqtt_connack_packet_ack_flags & MQTT_CONNACK_CONNECT_FLAGS_SP))
-        {
-
-            /* Client requested clean session, and server responded with Session Present.  This is a violation. */
-            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
-        }
-        else if (connack_packet_ptr -> mqtt_connack_packet_return_code >  MQTT_CONNACK_CONNECT_RETURN_CODE_NOT_AUTHORIZED)
-        {
-            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
-        }
-        else if (connack_packet_ptr -> mqtt_connack_packet_return_code > 0)
-        {
-
-            /* Pass the server return code to the application. */
-            ret = (UINT)(NXD_MQTT_ERROR_CONNECT_RETURN_CODE + connack_packet_ptr -> mqtt_connack_packet_return_code);
-        }
-        else
+        if (table_ptr[index].nxd_mqtt_inflight_packet_ptr == packet_ptr)
         {
-            ret = NXD_MQTT_SUCCESS;
-            
-            /* Obtain mutex before we modify client control block. */
-            tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-            client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_CONNECTED;
-
-            /* Initialize the packet identification field. */
-            client_ptr -> nxd_mqtt_client_packet_identifier = NXD_MQTT_INITIAL_PACKET_ID_VALUE;
-            
-            /* Prevent packet identifier from being zero. MQTT-2.3.1-1 */
-            if(client_ptr -> nxd_mqtt_client_packet_identifier == 0)
-                client_ptr -> nxd_mqtt_client_packet_identifier = 1;
-
-            /* Release mutex */
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(index);
         }
-    }
-
-    /* Check callback function.  */
-    if (client_ptr -> nxd_mqtt_connect_notify)
-    {
-        client_ptr -> nxd_mqtt_connect_notify(client_ptr, ret, client_ptr -> nxd_mqtt_connect_context);
-    }
 
-    if (ret == NXD_MQTT_SUCCESS)
-    {
-
-        /* If client doesn't start with Clean Session, and there are un-acked PUBLISH messages,
-           we shall re-publish these messages. */
-        if ((client_ptr -> nxd_mqtt_clean_session != NX_TRUE) && (client_ptr -> message_transmit_queue_head))
+        if (table_ptr[index].nxd_mqtt_inflight_packet_ptr == NX_NULL)
         {
-
-            tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-            /* There are messages from the previous session that has not been acknowledged. */
-            ret = _nxd_mqtt_client_retransmit_message(client_ptr, wait_option);
-
-            /* Release mutex */
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            break;
         }
-    }
-    else
-    {
-
-        /* End connection. */
-        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+        index = (index + 1) & mask;
     }
 
-    return(ret);
+    return(mask + 1);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_process_publish_packet                    PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_transmit_queue_append                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function processes a packet and parses topic and      */
-/*    message.                                                            */
-/*                                                                        */
+/*    This internal function appends a transmit packet, copied by         */
+/*    _nxd_mqtt_copy_transmit_packet, to the transmit queue and indexes   */
+/*    it by packet ID in the inflight table. When the table is full the   */
+/*    packet is released and an error is returned. The caller holds the   */
+/*    client mutex.                                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    packet_ptr                            Pointer to the packet         */
-/*    topic_offset_ptr                      Return topic offset           */
-/*    topic_length_ptr                      Return topic length           */
-/*    message_offset_ptr                    Return message offset         */
-/*    message_length_ptr                    Return message length         */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to transmit packet    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    Status                                                              */
+/*    status                                Completion status             */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_read_remaining_length                                     */
-/*    nx_packet_data_extract_offset                                       */
-/*                                                                        */
+/*    nx_packet_release                                                   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub_send                                     */
 /*    _nxd_mqtt_process_publish                                           */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_client_publish_packet_send                                */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_process_publish_packet(NX_PACKET *packet_ptr, ULONG *topic_offset_ptr, USHORT *topic_length_ptr,
-                                      ULONG *message_offset_ptr, ULONG *message_length_ptr)
+static UINT _nxd_mqtt_transmit_queue_append(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
-UCHAR  QoS;
-UINT   remaining_length = 0;
-UINT   topic_length;
-ULONG  offset;
-UCHAR  bytes[2];
-ULONG  bytes_copied;
+NXD_MQTT_INFLIGHT_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_inflight_table;
+UINT                     mask;
+UINT                     index;
 
+    if (table_ptr)
+    {
+        if (client_ptr -> nxd_mqtt_client_inflight_count >= client_ptr -> nxd_mqtt_client_inflight_table_size)
+        {
 
-    QoS = (UCHAR)((*(packet_ptr -> nx_packet_prepend_ptr) & MQTT_PUBLISH_QOS_LEVEL_FIELD) >> 1);
+            /* No room left to track the packet. */
+            nx_packet_release(packet_ptr);
 
-    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
-    {
-        return(NXD_MQTT_INVALID_PACKET);
+#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
+            client_ptr -> message_transmit_queue_depth--;
+#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+            return(NX_TX_QUEUE_DEPTH);
+        }
+
+        /* Linear probing from the home slot of the packet ID. */
+        mask = client_ptr -> nxd_mqtt_client_inflight_table_size - 1;
+        index = NXD_MQTT_INFLIGHT_HASH(packet_ptr, mask);
+        while (table_ptr[index].nxd_mqtt_inflight_packet_ptr)
+        {
+            index = (index + 1) & mask;
+        }
+        table_ptr[index].nxd_mqtt_inflight_packet_ptr = packet_ptr;
+        table_ptr[index].nxd_mqtt_inflight_previous_ptr = client_ptr -> message_transmit_queue_tail;
+        client_ptr -> nxd_mqtt_client_inflight_count++;
     }
 
-    if (remaining_length < 2)
+    if (client_ptr -> message_transmit_queue_head == NX_NULL)
     {
-        return(NXD_MQTT_INVALID_PACKET);
+        client_ptr -> message_transmit_queue_head = packet_ptr;
     }
-
-    /* Get topic length fields. */
-    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
-        (bytes_copied != sizeof(bytes)))
+    else
     {
-        return(NXD_MQTT_INVALID_PACKET);
+        client_ptr -> message_transmit_queue_tail -> nx_packet_queue_next = packet_ptr;
     }
+    client_ptr -> message_transmit_queue_tail = packet_ptr;
 
-    topic_length = (UINT)(*(bytes) << 8) | (*(bytes + 1));
+    return(NXD_MQTT_SUCCESS);
+}
 
-    if (topic_length > remaining_length - 2u)
-    {
-        return(NXD_MQTT_INVALID_PACKET);
-    }
 
-    *topic_offset_ptr = offset + 2;
-    *topic_length_ptr = (USHORT)topic_length;
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_transmit_packet_find                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function finds the transmit packet with a packet ID   */
+/*    whose fixed header, masked with header_mask, equals header_value.   */
+/*    The inflight table is used when one is set, otherwise the transmit  */
+/*    queue is searched.                                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_id                             Packet ID to match            */
+/*    header_mask                           Mask of the fixed header      */
+/*    header_value                          Expected masked fixed header  */
+/*    previous_packet_ptr                   Destination for the previous  */
+/*                                            packet on the queue         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    packet_ptr                            Matching packet or NULL       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish                                           */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*    _nxd_mqtt_process_sub_unsub_ack                                     */
+/*                                                                        */
+/**************************************************************************/
+static NX_PACKET *_nxd_mqtt_transmit_packet_find(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, UCHAR header_mask,
+                                                 UCHAR header_value, NX_PACKET **previous_packet_ptr)
+{
+NXD_MQTT_INFLIGHT_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_inflight_table;
+NX_PACKET               *transmit_packet_ptr;
+UINT                     mask;
+UINT                     index;
+UINT                     count;
 
-    remaining_length = remaining_length - topic_length - 2;
-    if ((QoS == 1) || (QoS == 2))
+    if (table_ptr)
     {
-        offset += 2 + 2 + topic_length;
-
-        if (remaining_length < 2)
+        mask = client_ptr -> nxd_mqtt_client_inflight_table_size - 1;
+        index = packet_id & mask;
+        for (count = 0; count <= mask; count++)
         {
-            return(NXD_MQTT_INVALID_PACKET);
+            transmit_packet_ptr = table_ptr[index].nxd_mqtt_inflight_packet_ptr;
+            if (transmit_packet_ptr == NX_NULL)
+            {
+                break;
+            }
+
+            if ((*((USHORT *)transmit_packet_ptr -> nx_packet_data_start) == packet_id) &&
+                ((*(transmit_packet_ptr -> nx_packet_prepend_ptr) & header_mask) == header_value))
+            {
+                *previous_packet_ptr = table_ptr[index].nxd_mqtt_inflight_previous_ptr;
+                return(transmit_packet_ptr);
+            }
+            index = (index + 1) & mask;
         }
-        remaining_length = remaining_length - 2;
+
+        return(NX_NULL);
     }
-    else
+
+    /* Search all the outstanding transmitted packets for a match. */
+    *previous_packet_ptr = NX_NULL;
+    transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
+    while (transmit_packet_ptr)
     {
-        offset += 2 + topic_length;
-    }
+        if ((*((USHORT *)transmit_packet_ptr -> nx_packet_data_start) == packet_id) &&
+            ((*(transmit_packet_ptr -> nx_packet_prepend_ptr) & header_mask) == header_value))
+        {
+            return(transmit_packet_ptr);
+        }
 
-    *message_offset_ptr = offset;
-    *message_length_ptr = (ULONG)remaining_length;
+        /* Move on to the next packet */
+        *previous_packet_ptr = transmit_packet_ptr;
+        transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
+    }
 
-    /* Return */
-    return(NXD_MQTT_SUCCESS);
+    return(NX_NULL);
 }
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_process_publish                           PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_qos2_entry_find                           PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process a publish message from the broker.   */
-/*                                                                        */
+/*    This internal function returns the index of the QoS 2 table entry of*/
+/*    a packet ID in the given phase, or the table size when there is none*/
+/*    or no table is set.                                                 */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the packet         */
+/*    packet_id                             Packet ID to match            */
+/*    phase                                 Phase of the exchange         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    NX_TRUE - packet is consumed                                        */
-/*    NX_FALSE - packet is not consumed                                   */
+/*    index                                 Entry index or table size     */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    [receive_notify]                      User supplied receive         */
-/*                                            callback function           */
-/*    _nxd_mqtt_packet_allocate                                           */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_packet_release                                                   */
-/*    nx_secure_tls_session_send                                          */
-/*    _nxd_mqtt_process_publish_packet                                    */
-/*    _nxd_mqtt_copy_transmit_packet                                      */
-/*                                                                        */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_packet_receive_process                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_process_publish                                           */
+/*    _nxd_mqtt_process_publish_response                                  */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_process_publish(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+static UINT _nxd_mqtt_qos2_entry_find(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, USHORT phase)
 {
-MQTT_PACKET_PUBLISH_RESPONSE *pubresp_ptr;
-UINT                          status;
-USHORT                        packet_id = 0;
-UCHAR                         QoS;
-UINT                          enqueue_message = 0;
-NX_PACKET                    *transmit_packet_ptr;
-UINT                          remaining_length = 0;
-UINT                          packet_consumed = NX_FALSE;
-UCHAR                         fixed_header;
-USHORT                        transmit_packet_id;
-UINT                          topic_length;
-ULONG                         offset;
-UCHAR                         bytes[2];
-ULONG                         bytes_copied;
-
-    QoS = (UCHAR)((*(packet_ptr -> nx_packet_prepend_ptr) & MQTT_PUBLISH_QOS_LEVEL_FIELD) >> 1);
+NXD_MQTT_QOS2_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_qos2_table;
+UINT                 mask;
+UINT                 index;
+UINT                 count;
 
-    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
+    if (table_ptr == NX_NULL)
     {
-        return(NX_FALSE);
+        return(0);
     }
 
-    if (remaining_length < 2)
+    mask = client_ptr -> nxd_mqtt_client_qos2_table_size - 1;
+    index = packet_id & mask;
+    for (count = 0; (count <= mask) && (table_ptr[index].nxd_mqtt_qos2_phase != NXD_MQTT_QOS2_FREE); count++)
     {
-        return(NXD_MQTT_INVALID_PACKET);
+        if (table_ptr[index].nxd_mqtt_qos2_packet_id == packet_id)
+        {
+            return((table_ptr[index].nxd_mqtt_qos2_phase == phase) ? index : (mask + 1));
+        }
+        index = (index + 1) & mask;
     }
 
-    /* Get topic length fields. */
-    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
-        (bytes_copied != sizeof(bytes)))
-    {
-        return(NXD_MQTT_INVALID_PACKET);
-    }
+    return(mask + 1);
+}
 
-    topic_length = (UINT)(*(bytes) << 8) | (*(bytes + 1));
 
-    if (topic_length > remaining_length - 2u)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_qos2_entry_add                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function records the phase of the QoS 2 exchange of a */
+/*    packet ID, replacing the phase already recorded for it. The caller  */
+/*    holds the client mutex.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_id                             Packet ID                     */
+/*    phase                                 Phase of the exchange         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish                                           */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_qos2_entry_add(NXD_MQTT_CLIENT *client_ptr, USHORT packet_id, USHORT phase)
+{
+NXD_MQTT_QOS2_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_qos2_table;
+UINT                 mask = client_ptr -> nxd_mqtt_client_qos2_table_size - 1;
+UINT                 index;
+
+    index = packet_id & mask;
+    while (table_ptr[index].nxd_mqtt_qos2_phase != NXD_MQTT_QOS2_FREE)
     {
-        return(NXD_MQTT_INVALID_PACKET);
+        if (table_ptr[index].nxd_mqtt_qos2_packet_id == packet_id)
+        {
+            table_ptr[index].nxd_mqtt_qos2_phase = phase;
+            return(NXD_MQTT_SUCCESS);
+        }
+        index = (index + 1) & mask;
     }
 
-    if (QoS == 0)
+    /* Keep one free entry, so that a search always ends. */
+    if (client_ptr -> nxd_mqtt_client_qos2_count >= mask)
     {
-        enqueue_message = 1;
+        return(NX_TX_QUEUE_DEPTH);
     }
-    else
-    {
-        /* QoS 1 or QoS 2 messages. */
-        /* Get packet id fields. */
-        if (nx_packet_data_extract_offset(packet_ptr, offset + 2 + topic_length, &bytes, sizeof(bytes), &bytes_copied))
-        {
-            return(NXD_MQTT_INVALID_PACKET);
-        }
 
-        packet_id = (USHORT)(((*bytes) << 8) | (*(bytes + 1)));
+    table_ptr[index].nxd_mqtt_qos2_packet_id = packet_id;
+    table_ptr[index].nxd_mqtt_qos2_phase = phase;
+    client_ptr -> nxd_mqtt_client_qos2_count++;
 
-        /* Look for an existing transmit packets with the same packet id */
-        transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
+    return(NXD_MQTT_SUCCESS);
+}
 
-        while (transmit_packet_ptr)
-        {
-            fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
-            transmit_packet_id = *((USHORT *)transmit_packet_ptr -> nx_packet_data_start);
-            if ((transmit_packet_id == packet_id) &&
-                ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBREC << 4)))
-            {
 
-                /* Found a packet containing the packet_id */
-                break;
-            }
-            transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
-        }
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_qos2_entry_remove                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function frees an entry of the QoS 2 table and shifts */
+/*    back the entries of the probe sequence behind it. The caller holds  */
+/*    the client mutex.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    hole                                  Index of the entry            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_qos2_entry_remove(NXD_MQTT_CLIENT *client_ptr, UINT hole)
+{
+NXD_MQTT_QOS2_ENTRY *table_ptr = client_ptr -> nxd_mqtt_client_qos2_table;
+UINT                 mask = client_ptr -> nxd_mqtt_client_qos2_table_size - 1;
+UINT                 index;
+UINT                 home;
 
-        if (transmit_packet_ptr)
-        {
-            /* This published data is already in our system.  No need to deliver this message to the application. */
-            enqueue_message = 0;
-        }
-        else
+    index = (hole + 1) & mask;
+    while (table_ptr[index].nxd_mqtt_qos2_phase != NXD_MQTT_QOS2_FREE)
+    {
+        home = table_ptr[index].nxd_mqtt_qos2_packet_id & mask;
+        if (((index - home) & mask) >= ((index - hole) & mask))
         {
-            enqueue_message = 1;
+            table_ptr[hole] = table_ptr[index];
+            hole = index;
         }
+        index = (index + 1) & mask;
     }
+    table_ptr[hole].nxd_mqtt_qos2_packet_id = 0;
+    table_ptr[hole].nxd_mqtt_qos2_phase = NXD_MQTT_QOS2_FREE;
+    client_ptr -> nxd_mqtt_client_qos2_count--;
+}
 
-    if (enqueue_message)
-    {
-        if (packet_ptr -> nx_packet_length > (offset + remaining_length))
-        {
-
-            /* This packet contains multiple messages. */
-            if (nx_packet_copy(packet_ptr, &packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_NO_WAIT))
-            {
-
-                /* No packet is available. */
-                return(NX_FALSE);
-            }
-        }
-        else
-        {
-            packet_consumed = NX_TRUE;
-        }
-
-        /* Increment the queue depth counter. */
-        client_ptr -> message_receive_queue_depth++;
-
-        if (client_ptr -> message_receive_queue_head == NX_NULL)
-        {
-            client_ptr -> message_receive_queue_head = packet_ptr;
-        }
-        else
-        {
-            client_ptr -> message_receive_queue_tail -> nx_packet_queue_next = packet_ptr;
-        }
-        client_ptr -> message_receive_queue_tail = packet_ptr;
-
-        /* Invoke the user-defined receive notify function if it is set. */
-        if (client_ptr -> nxd_mqtt_client_receive_notify)
-        {
-            (*(client_ptr -> nxd_mqtt_client_receive_notify))(client_ptr, client_ptr -> message_receive_queue_depth);
-        }
-    }
 
-    /* If the message QoS level is 0, we are done. */
-    if (QoS == 0)
-    {
-        /* Return */
-        return(packet_consumed);
-    }
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_publish_response_send                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sends a PUBREL or PUBCOMP message. With      */
+/*    keep_copy set, a copy is put on the transmit queue first, to be sent*/
+/*    again on reconnection. The caller holds the client mutex, which is  */
+/*    released while the message is sent.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    header                                Fixed header of the message   */
+/*    packet_id                             Packet ID                     */
+/*    keep_copy                             Queue a copy for              */
+/*                                            retransmission              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    _nxd_mqtt_copy_transmit_packet                                      */
+/*    _nxd_mqtt_transmit_queue_append                                     */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_packet_release                                                   */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*    _nxd_mqtt_client_retransmit_message                                 */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_publish_response_send(NXD_MQTT_CLIENT *client_ptr, UCHAR header, USHORT packet_id, UINT keep_copy)
+{
+MQTT_PACKET_PUBLISH_RESPONSE *response_ptr;
+NX_PACKET                    *packet_ptr;
+NX_PACKET                    *transmit_packet_ptr;
+UINT                          status;
 
-    /* Send out proper ACKs for QoS 1 and 2 messages. */
-    /* Allocate a new packet so we can send out a response. */
-    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr);
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, 4);
     if (status)
     {
-        /* Packet allocation fails. */
-        return(packet_consumed);
+        return(status);
     }
 
-    /* Fill in the packet ID */
-    pubresp_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)(packet_ptr -> nx_packet_prepend_ptr);
-    pubresp_ptr -> mqtt_publish_response_packet_remaining_length = 2;
-    pubresp_ptr -> mqtt_publish_response_packet_packet_identifier_msb = (UCHAR)(packet_id >> 8);
-    pubresp_ptr -> mqtt_publish_response_packet_packet_identifier_lsb = (UCHAR)(packet_id & 0xFF);
-
-    if (QoS == 1)
+    if (4u > ((ULONG)(packet_ptr -> nx_packet_data_end) - (ULONG)(packet_ptr -> nx_packet_append_ptr)))
     {
+        nx_packet_release(packet_ptr);
 
-        pubresp_ptr -> mqtt_publish_response_packet_header = MQTT_CONTROL_PACKET_TYPE_PUBACK << 4;
-    }
-    else
-    {
-        pubresp_ptr -> mqtt_publish_response_packet_header = MQTT_CONTROL_PACKET_TYPE_PUBREC << 4;
+        /* Packet buffer is too small to hold the message. */
+        return(NX_SIZE_ERROR);
     }
 
+    response_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)(packet_ptr -> nx_packet_prepend_ptr);
+    response_ptr -> mqtt_publish_response_packet_header = header;
+    response_ptr -> mqtt_publish_response_packet_remaining_length = 2;
+    response_ptr -> mqtt_publish_response_packet_packet_identifier_msb = (UCHAR)(packet_id >> 8);
+    response_ptr -> mqtt_publish_response_packet_packet_identifier_lsb = (UCHAR)(packet_id & 0xFF);
     packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr + sizeof(MQTT_PACKET_PUBLISH_RESPONSE);
     packet_ptr -> nx_packet_length = sizeof(MQTT_PACKET_PUBLISH_RESPONSE);
 
-    if (QoS == 2)
+    if (keep_copy)
     {
-
-        /* Copy packet for checking duplicate publish packet. */
         if (_nxd_mqtt_copy_transmit_packet(client_ptr, packet_ptr, &transmit_packet_ptr,
-                                           packet_id, NX_FALSE, NX_WAIT_FOREVER))
+                                           packet_id, NX_FALSE, NX_NO_WAIT) ||
+            _nxd_mqtt_transmit_queue_append(client_ptr, transmit_packet_ptr))
         {
-
-            /* Release the packet. */
             nx_packet_release(packet_ptr);
-            return(packet_consumed);
-        }
-        if (client_ptr -> message_transmit_queue_head == NX_NULL)
-        {
-            client_ptr -> message_transmit_queue_head = transmit_packet_ptr;
-        }
-        else
-        {
-            client_ptr -> message_transmit_queue_tail -> nx_packet_queue_next = transmit_packet_ptr;
+            return(NXD_MQTT_PACKET_POOL_FAILURE);
         }
-        client_ptr -> message_transmit_queue_tail = transmit_packet_ptr;
     }
 
     tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
 #ifdef NX_SECURE_ENABLE
     if (client_ptr -> nxd_mqtt_client_use_tls)
     {
@@ -1433,31 +1925,28 @@ ULONG                         bytes_copied;
     }
 #else
     status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
-
 #endif /* NX_SECURE_ENABLE */
 
     tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+
     if (status)
     {
-
-        /* Release the packet. */
         nx_packet_release(packet_ptr);
-    }
-    else
-    {
-        /* Update the timeout value. */
-        client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+        return(NXD_MQTT_COMMUNICATION_FAILURE);
     }
 
-    /* Return */
-    return(packet_consumed);
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    return(NXD_MQTT_SUCCESS);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_process_publish_response                  PORTABLE C      */
+/*    _nxd_mqtt_release_receive_packet                    PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -1465,401 +1954,236 @@ ULONG                         bytes_copied;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process a publish response messages.         */
-/*    Publish Response messages are: PUBACK, PUBREC, PUBREL               */
+/*    This internal function releases a receive packet.                   */
+/*    A receive packet is allocated to store QoS 1 and 2 messages.        */
+/*    Upon a message being properly acknowledged, the packet can          */
+/*    be released.                                                        */
+/*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the packet         */
+/*    packet_ptr                            Pointer to the MQTT message   */
+/*                                            packet to be removed        */
+/*    previous_packet_ptr                   Pointer to the previous packet*/
+/*                                            or NULL if none exists      */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    Status                                                              */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    [nxd_mqtt_client_receive_notify]      User supplied publish         */
-/*                                            callback function           */
-/*    _nxd_mqtt_release_transmit_packet                                   */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_secure_tls_session_send                                          */
-/*                                                                        */
+/*    nx_packet_release                     Release the message packet    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_packet_receive_process                                    */
+/*    _nxd_mqtt_thread_entry                                              */
+/*    _nxd_mqtt_client_event_process                                      */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            added ack receive notify,   */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_process_publish_response(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+static VOID _nxd_mqtt_release_receive_packet(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, NX_PACKET *previous_packet_ptr)
 {
-MQTT_PACKET_PUBLISH_RESPONSE *response_ptr;
-USHORT                        packet_id;
-NX_PACKET                    *previous_packet_ptr;
-NX_PACKET                    *transmit_packet_ptr;
-NX_PACKET                    *response_packet;
-UINT                          ret;
-UCHAR                         fixed_header;
-USHORT                        transmit_packet_id;
-
-    response_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)(packet_ptr -> nx_packet_prepend_ptr);
 
-    /* Validate the packet. */
-    if (response_ptr -> mqtt_publish_response_packet_remaining_length != 2)
+    if (previous_packet_ptr)
     {
-        /* Invalid remaining_length value. Return 1 so the caller can release
-           the packet. */
-
-        return(1);
+        previous_packet_ptr -> nx_packet_queue_next = packet_ptr -> nx_packet_queue_next;
     }
-
-    packet_id = (USHORT)((response_ptr -> mqtt_publish_response_packet_packet_identifier_msb << 8) |
-                         (response_ptr -> mqtt_publish_response_packet_packet_identifier_lsb));
-
-    /* Search all the outstanding transmitted packets for a match. */
-    previous_packet_ptr = NX_NULL;
-    transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
-    while (transmit_packet_ptr)
+    else
     {
-        fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
-        transmit_packet_id = *((USHORT *)transmit_packet_ptr -> nx_packet_data_start);
-        if (transmit_packet_id == packet_id)
-        {
-
-            /* Found the matching packet id */
-            if (((response_ptr -> mqtt_publish_response_packet_header) >> 4) == MQTT_CONTROL_PACKET_TYPE_PUBACK)
-            {
-
-                /* PUBACK is the response to a PUBLISH packet with QoS Level 1*/
-                /* Therefore we verify that packet contains PUBLISH packet with QoS level 1*/
-                if ((fixed_header & 0xF6) == ((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | MQTT_PUBLISH_QOS_LEVEL_1))
-                {
-
-                    /* Check ack notify function.  */
-                    if (client_ptr -> nxd_mqtt_ack_receive_notify)
-                    {
-
-                        /* Call notify function. Note: user routine should not release the packet.  */
-                        client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
-                    }
-
-                    /* QoS Level1 message receives an ACK. */
-                    /* This message can be released. */
-                    _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
-
-                    /* Return with value 1, so the caller will release packet_ptr */
-                    return(1);
-                }
-            }
-            else if (((response_ptr -> mqtt_publish_response_packet_header) >> 4) == MQTT_CONTROL_PACKET_TYPE_PUBREL)
-            {
-
-                /* QoS 2 publish Release received, part 2. */
-                /* Therefore we verify that packet contains PUBLISH packet with QoS level 2*/
-                if ((fixed_header & 0xF6) == (MQTT_CONTROL_PACKET_TYPE_PUBREC << 4))
-                {
-
-                    /* QoS Level2 message receives an ACK. */
-                    /* This message can be released. */
-                    /* Send PUBCOMP */
-
-                    /* Allocate a packet to send the response. */
-                    ret = _nxd_mqtt_packet_allocate(client_ptr, &response_packet);
-                    if (ret)
-                    {
-                        return(1);
-                    }
-
-                    if (4u > ((ULONG)(response_packet -> nx_packet_data_end) - (ULONG)(response_packet -> nx_packet_append_ptr)))
-                    {
-                        nx_packet_release(response_packet);
-
-                        /* Packet buffer is too small to hold the message. */
-                        return(NX_SIZE_ERROR);
-                    }
-
-                    response_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)response_packet -> nx_packet_prepend_ptr;
-
-                    response_ptr ->  mqtt_publish_response_packet_header = MQTT_CONTROL_PACKET_TYPE_PUBCOMP << 4;
-                    response_ptr ->  mqtt_publish_response_packet_remaining_length = 2;
-
-                    /* Fill in packet ID */
-                    response_packet -> nx_packet_prepend_ptr[3] = packet_ptr -> nx_packet_prepend_ptr[3];
-                    response_packet -> nx_packet_prepend_ptr[4] = packet_ptr -> nx_packet_prepend_ptr[4];
-                    response_packet -> nx_packet_append_ptr = response_packet -> nx_packet_prepend_ptr + 4;
-                    response_packet -> nx_packet_length = 4;
-
-                    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-#ifdef NX_SECURE_ENABLE
-                    if (client_ptr -> nxd_mqtt_client_use_tls)
-                    {
-                        ret = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), response_packet, NX_WAIT_FOREVER);
-                    }
-                    else
-                    {
-                        ret = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, response_packet, NX_WAIT_FOREVER);
-                    }
-#else
-                    ret = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, response_packet, NX_WAIT_FOREVER);
-
-#endif /* NX_SECURE_ENABLE */
-
-                    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
-
-                    /* Update the timeout value. */
-                    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
-
-                    if (ret)
-                    {
-                        nx_packet_release(response_packet);
-                    }
-
-                    /* Check ack notify function.  */
-                    if (client_ptr -> nxd_mqtt_ack_receive_notify)
-                    {
-
-                        /* Call notify function. Note: user routine should not release the packet.  */
-                        client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBREL, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
-                    }
-
-                    /* This packet can be released. */
-                    _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
-
-                    /* Return with value 1, so the caller will release packet_ptr */
-                    return(1);
-                }
-            }
-        }
+        client_ptr -> message_receive_queue_head = packet_ptr -> nx_packet_queue_next;
+    }
 
-        /* Move on to the next packet */
-        previous_packet_ptr = transmit_packet_ptr;
-        transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
+    if (packet_ptr == client_ptr -> message_receive_queue_tail)
+    {
+        client_ptr -> message_receive_queue_tail = previous_packet_ptr;
     }
 
-    /* nothing is found.  Return 1 to release the packet.*/
-    return(1);
+    client_ptr -> message_receive_queue_depth--;
+    client_ptr -> message_receive_queue_bytes -= packet_ptr -> nx_packet_length;
+
+    nx_packet_release(packet_ptr);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_process_sub_unsub_ack                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_receive_queue_full                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process an ACK message for subscribe         */
-/*    or unsubscribe request.                                             */
+/*    This function checks whether a message of length bytes would pass   */
+/*    one of the limits of the receive queue. An empty queue always takes */
+/*    the message, and a queue without limits is never full.              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the packet         */
+/*    length                                Bytes of the message          */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    Status                                                              */
+/*    NX_TRUE                               No room for the message       */
+/*    NX_FALSE                              Message fits in the queue     */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    [nxd_mqtt_client_receive_notify]      User supplied publish         */
-/*                                            callback function           */
-/*    _nxd_mqtt_release_transmit_packet                                   */
-/*                                          Release the memory block      */
-/*    _nxd_mqtt_read_remaining_length       Skip the remaining length     */
-/*                                            field                       */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
+/*    _nxd_mqtt_process_publish                                           */
 /*    _nxd_mqtt_packet_receive_process                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            added ack receive notify,   */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_receive_queue_drop_oldest                                 */
+/*    _nxd_mqtt_receive_queue_resume                                      */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_process_sub_unsub_ack(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+static UINT _nxd_mqtt_receive_queue_full(NXD_MQTT_CLIENT *client_ptr, ULONG length)
 {
 
-USHORT     packet_id;
-NX_PACKET *previous_packet_ptr;
-NX_PACKET *transmit_packet_ptr;
-UCHAR      response_header;
-UCHAR      fixed_header;
-USHORT     transmit_packet_id;
-UINT       remaining_length;
-ULONG      offset;
-UCHAR      bytes[2];
-ULONG      bytes_copied;
-
-
-    response_header = *(packet_ptr -> nx_packet_prepend_ptr);
-
-    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
+    if (client_ptr -> message_receive_queue_depth == 0)
     {
-
-        /* Unable to process the sub/unsub ack.  Simply return and release the packet. */
-        return(NXD_MQTT_INVALID_PACKET);
+        return(NX_FALSE);
     }
 
-    /* Get packet id fields. */
-    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
-        (bytes_copied != sizeof(bytes)))
+    if (client_ptr -> nxd_mqtt_client_receive_queue_messages &&
+        (client_ptr -> message_receive_queue_depth >= client_ptr -> nxd_mqtt_client_receive_queue_messages))
     {
-        return(NXD_MQTT_INVALID_PACKET);
+        return(NX_TRUE);
     }
 
-    packet_id = (USHORT)(((*bytes) << 8) | (*(bytes + 1)));
-
-    /* Search all the outstanding transmitted packets for a match. */
-    previous_packet_ptr = NX_NULL;
-    transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
-    while (transmit_packet_ptr)
+    if (client_ptr -> nxd_mqtt_client_receive_queue_bytes &&
+        ((client_ptr -> message_receive_queue_bytes >= client_ptr -> nxd_mqtt_client_receive_queue_bytes) ||
+         (length > client_ptr -> nxd_mqtt_client_receive_queue_bytes - client_ptr -> message_receive_queue_bytes)))
     {
-        fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
-        transmit_packet_id = *((USHORT *)transmit_packet_ptr -> nx_packet_data_start);
-        if (transmit_packet_id == packet_id)
-        {
-
-            /* Found the matching packet id */
-            if (((response_header >> 4) == MQTT_CONTROL_PACKET_TYPE_SUBACK) &&
-                ((fixed_header >> 4) == MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE))
-            {
-                /* Validate the packet. */
-                if (remaining_length != 3)
-                {
-                    /* Invalid remaining_length value. */
-                    return(1);
-                }
-
-                /* Check ack notify function.  */
-                if (client_ptr -> nxd_mqtt_ack_receive_notify)
-                {
-
-                    /* Call notify function. Note: user routine should not release the packet.  */
-                    client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_SUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
-                }
+        return(NX_TRUE);
+    }
 
-                /* Release the transmit packet. */
-                _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+    return(NX_FALSE);
+}
 
-                return(1);
-            }
-            else if (((response_header >> 4) == MQTT_CONTROL_PACKET_TYPE_UNSUBACK) &&
-                     ((fixed_header >> 4) == MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE))
-            {
-                /* Validate the packet. */
-                if (remaining_length != 2)
-                {
-                    /* Invalid remaining_length value. */
-                    return(1);
-                }
 
-                /* Check ack notify function.  */
-                if (client_ptr -> nxd_mqtt_ack_receive_notify)
-                {
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_receive_queue_drop_oldest                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function makes room for a message of length bytes by dropping  */
+/*    the oldest QoS 0 messages of the receive queue. The QoS 1 and 2     */
+/*    messages are kept, the queue stays full when they fill it.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    length                                Bytes of the message          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_receive_queue_full          Check the limits of the queue */
+/*    _nxd_mqtt_release_receive_packet      Drop a queued message         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish                                           */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_receive_queue_drop_oldest(NXD_MQTT_CLIENT *client_ptr, ULONG length)
+{
 
-                    /* Call notify function. Note: user routine should not release the packet.  */
-                    client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_UNSUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
-                }
+NX_PACKET *packet_ptr = client_ptr -> message_receive_queue_head;
+NX_PACKET *previous_packet_ptr = NX_NULL;
+NX_PACKET *next_packet_ptr;
 
-                /* Unsubscribe succeeded. */
-                /* Release the transmit packet. */
-                _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+    while (packet_ptr && _nxd_mqtt_receive_queue_full(client_ptr, length))
+    {
+        next_packet_ptr = packet_ptr -> nx_packet_queue_next;
 
-                return(1);
-            }
+        if ((*(packet_ptr -> nx_packet_prepend_ptr) & MQTT_PUBLISH_QOS_LEVEL_FIELD) == 0)
+        {
+            _nxd_mqtt_release_receive_packet(client_ptr, packet_ptr, previous_packet_ptr);
+            client_ptr -> nxd_mqtt_client_receive_dropped++;
+        }
+        else
+        {
+            previous_packet_ptr = packet_ptr;
         }
 
-        /* Move on to the next packet */
-        previous_packet_ptr = transmit_packet_ptr;
-        transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
+        packet_ptr = next_packet_ptr;
     }
-    return(1);
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_process_pingresp                          PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_receive_queue_resume                      PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process a PINGRESP message.                  */
+/*    This function resumes the reading of the TCP socket, stopped by the */
+/*    NXD_MQTT_RECEIVE_QUEUE_BACKPRESSURE policy, once the application    */
+/*    has taken a message from the full receive queue.                    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    Status                                                              */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
-/*                                            callback function           */
+/*    _nxd_mqtt_receive_queue_full          Check the limits of the queue */
+/*    _nxd_mqtt_client_events_set           Set the receive event         */
+/*    nx_cloud_module_event_set             Set the receive event         */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_packet_receive_process                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_client_message_get                                        */
+/*    _nxd_mqtt_client_message_packet_get                                 */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_process_pingresp(NXD_MQTT_CLIENT *client_ptr)
+static VOID _nxd_mqtt_receive_queue_resume(NXD_MQTT_CLIENT *client_ptr)
 {
 
-
-    /* If there is an outstanding ping, mark it as responded. */
-    if (client_ptr -> nxd_mqtt_ping_not_responded == NX_TRUE)
+    /* Room for one byte is room for the next message, an empty queue takes any. */
+    if (client_ptr -> nxd_mqtt_client_receive_paused && !_nxd_mqtt_receive_queue_full(client_ptr, 1))
     {
-        client_ptr -> nxd_mqtt_ping_not_responded = NX_FALSE;
+        client_ptr -> nxd_mqtt_client_receive_paused = NX_FALSE;
 
-        client_ptr -> nxd_mqtt_ping_sent_time = 0;
+        /* Process the data left in the TCP receive queue. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+        _nxd_mqtt_client_events_set(client_ptr, MQTT_PACKET_RECEIVE_EVENT);
+#else
+        nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PACKET_RECEIVE_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
     }
-
-    return;
 }
 
-
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_process_disconnect                        PORTABLE C      */
+/*    _nxd_mqtt_process_connack                           PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -1867,29 +2191,32 @@ static VOID _nxd_mqtt_process_pingresp(NXD_MQTT_CLIENT *client_ptr)
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process a DISCONNECT message.                */
+/*    This internal function processes a CONNACK message from the broker. */
+/*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
 /*    packet_ptr                            Pointer to the packet         */
+/*    wait_option                           Timeout value                 */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    None                                                                */
+/*    status                                                              */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*   nx_secure_tls_session_send                                           */
-/*   nx_tcp_socket_disconnect                                             */
-/*   nx_tcp_client_socket_unbind                                          */
-/*   _nxd_mqtt_release_transmit_packet                                    */
-/*   _nxd_mqtt_release_receive_packet                                     */
-/*   _nxd_mqtt_client_connection_end                                      */
+/*    [nxd_mqtt_connect_notify]             User supplied connect         */
+/*                                            callback function           */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    _nxd_mqtt_client_retransmit_message                                 */
+/*    _nxd_mqtt_client_connection_end                                     */
+/*                                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*   _nxd_mqtt_packet_receive_process                                     */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -1900,114 +2227,190 @@ static VOID _nxd_mqtt_process_pingresp(NXD_MQTT_CLIENT *client_ptr)
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_process_disconnect(NXD_MQTT_CLIENT *client_ptr)
+static UINT _nxd_mqtt_process_connack(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
 {
-NX_PACKET  *previous = NX_NULL;
-NX_PACKET  *current;
-NX_PACKET  *next;
-UINT        disconnect_callback = NX_FALSE;
-UINT        status;
-UCHAR       fixed_header;
 
-    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+UINT    ret = NXD_MQTT_COMMUNICATION_FAILURE;
+MQTT_PACKET_CONNACK *connack_packet_ptr = (MQTT_PACKET_CONNACK *)(packet_ptr -> nx_packet_prepend_ptr);
+#ifdef NXD_MQTT_V5_ENABLE
+UINT    remaining_length;
+ULONG   offset;
+ULONG   next_offset;
+UINT    topic_alias_maximum = 0;
+ULONG   maximum_packet_size = 0;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+
+    /* Check the length.  */
+#ifndef NXD_MQTT_V5_ENABLE
+    if ((packet_ptr -> nx_packet_length != sizeof(MQTT_PACKET_CONNACK)) ||
+        (connack_packet_ptr -> mqtt_connack_packet_header >> 4 != MQTT_CONTROL_PACKET_TYPE_CONNACK))
+#else
+    /* The properties of an MQTT 5 CONNACK follow the reason code. The
+       ACK flags and reason code are read through the structure, so the
+       remaining length is expected to fit in one byte.  */
+    if ((connack_packet_ptr -> mqtt_connack_packet_header >> 4 != MQTT_CONTROL_PACKET_TYPE_CONNACK) ||
+        _nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset) ||
+        (offset != MQTT_FIXED_HEADER_SIZE) || (remaining_length < 3) ||
+        _nxd_mqtt_process_properties(packet_ptr, offset + 2, offset + remaining_length,
+                                     &topic_alias_maximum, &maximum_packet_size, &next_offset))
+#endif /* NXD_MQTT_V5_ENABLE */
     {
-        /* State changes from CONNECTED TO IDLE.  Call disconnect notify callback
-           if the function is set. */
-        disconnect_callback = NX_TRUE;
+        /* Invalid packet length.  Free the packet and process error. */
+        ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
     }
-    else if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTING)
+    else
     {
 
-        /* If state isn't CONNECTED or CONNECTING, just return. */
-        return;
-    }
-
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-    /* End connection. */
-    _nxd_mqtt_client_connection_end(client_ptr, NXD_MQTT_SOCKET_TIMEOUT);
-
-    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
-
-    /* Free up sub/unsub packets on the transmit queue. */
-    current = client_ptr -> message_transmit_queue_head;
-
-    while (current)
-    {
-        next = current -> nx_packet_queue_next;
-        fixed_header = *(current -> nx_packet_prepend_ptr);
+#ifdef NXD_MQTT_V5_ENABLE
+        client_ptr -> nxd_mqtt_client_reason_code = connack_packet_ptr -> mqtt_connack_packet_return_code;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-        if (((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4)) ||
-            ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE << 4)))
+        /* Check remaining length.  */
+#ifndef NXD_MQTT_V5_ENABLE
+        if (connack_packet_ptr -> mqtt_connack_packet_remaining_length != 2)
+#else
+        if (next_offset != offset + remaining_length)
+#endif /* NXD_MQTT_V5_ENABLE */
         {
-            _nxd_mqtt_release_transmit_packet(client_ptr, current, previous);
+            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
         }
-        else
+        /* Follow MQTT-3.2.2-1 rule.  */
+        else if ((client_ptr -> nxd_mqtt_clean_session) && (connack_packet_ptr -> mqtt_connack_packet_ack_flags & MQTT_CONNACK_CONNECT_FLAGS_SP))
         {
-            previous = current;
-        }
-        current = next;
-    }
-
-    /* If a callback notification is defined, call it now. */
-    if ((disconnect_callback == NX_TRUE) && (client_ptr -> nxd_mqtt_disconnect_notify))
-    {
-        client_ptr -> nxd_mqtt_disconnect_notify(client_ptr);
-    }
-
-    /* If a connect callback notification is defined and is still in connecting stage, call it now. */
-    if ((disconnect_callback == NX_FALSE) && (client_ptr -> nxd_mqtt_connect_notify))
-    {
-        client_ptr -> nxd_mqtt_connect_notify(client_ptr, NXD_MQTT_CONNECT_FAILURE, client_ptr -> nxd_mqtt_connect_context);
-    }
 
-    if (status == TX_SUCCESS)
-    {
-        /* Remove all the packets in the receive queue. */
-        while (client_ptr -> message_receive_queue_head)
+            /* Client requested clean session, and server responded with Session Present.  This is a violation. */
+            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
+        }
+#ifndef NXD_MQTT_V5_ENABLE
+        else if (connack_packet_ptr -> mqtt_connack_packet_return_code >  MQTT_CONNACK_CONNECT_RETURN_CODE_NOT_AUTHORIZED)
         {
-            _nxd_mqtt_release_receive_packet(client_ptr, client_ptr -> message_receive_queue_head, NX_NULL);
+            ret = NXD_MQTT_SERVER_MESSAGE_FAILURE;
         }
-        client_ptr -> message_receive_queue_depth = 0;
+        else if (connack_packet_ptr -> mqtt_connack_packet_return_code > 0)
+        {
 
-        /* Clear the MQTT_PACKET_RECEIVE_EVENT */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-        tx_event_flags_set(&client_ptr -> nxd_mqtt_events, ~MQTT_PACKET_RECEIVE_EVENT, TX_AND);
+            /* Pass the server return code to the application. */
+            ret = (UINT)(NXD_MQTT_ERROR_CONNECT_RETURN_CODE + connack_packet_ptr -> mqtt_connack_packet_return_code);
+        }
 #else
-        nx_cloud_module_event_clear(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PACKET_RECEIVE_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-    }
-
-    /* Clear flags if keep alive is enabled. */
-    if (client_ptr -> nxd_mqtt_keepalive)
-    {
-        client_ptr -> nxd_mqtt_ping_not_responded = 0;
-        client_ptr -> nxd_mqtt_ping_sent_time = 0;
-    }
+        else if (connack_packet_ptr -> mqtt_connack_packet_return_code > 0)
+        {
 
-    /* Clean up the information when disconnecting. */
-    client_ptr -> nxd_mqtt_client_username = NX_NULL;
-    client_ptr -> nxd_mqtt_client_password = NX_NULL;
-    client_ptr -> nxd_mqtt_client_will_topic = NX_NULL;
-    client_ptr -> nxd_mqtt_client_will_message = NX_NULL;
-    client_ptr -> nxd_mqtt_client_will_qos_retain = 0;
+            /* Pass the reason codes that have an MQTT 3.1.1 return code to the application as
+               before. The reason code itself is kept in the client control block.  */
+            switch (connack_packet_ptr -> mqtt_connack_packet_return_code)
+            {
+            case MQTT_REASON_CODE_UNSUPPORTED_PROTOCOL_VERSION:
+                ret = NXD_MQTT_ERROR_UNACCEPTABLE_PROTOCOL;
+                break;
+            case MQTT_REASON_CODE_CLIENT_IDENTIFIER_NOT_VALID:
+                ret = NXD_MQTT_ERROR_IDENTIFYIER_REJECTED;
+                break;
+            case MQTT_REASON_CODE_BAD_USERNAME_PASSWORD:
+                ret = NXD_MQTT_ERROR_BAD_USERNAME_PASSWORD;
+                break;
+            case MQTT_REASON_CODE_NOT_AUTHORIZED:
+                ret = NXD_MQTT_ERROR_NOT_AUTHORIZED;
+                break;
+            case MQTT_REASON_CODE_SERVER_UNAVAILABLE:
+                ret = NXD_MQTT_ERROR_SERVER_UNAVAILABLE;
+                break;
+            default:
+                ret = NXD_MQTT_CONNECT_FAILURE;
+                break;
+            }
+        }
+#endif /* NXD_MQTT_V5_ENABLE */
+        else
+        {
+            ret = NXD_MQTT_SUCCESS;
+            
+            /* Obtain mutex before we modify client control block. */
+            tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    /* Release current processing packet. */
-    if (client_ptr -> nxd_mqtt_client_processing_packet)
+            client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_CONNECTED;
+
+            /* Subscriptions of a resumed session need not be sent again.  */
+            if (connack_packet_ptr -> mqtt_connack_packet_ack_flags & MQTT_CONNACK_CONNECT_FLAGS_SP)
+            {
+                client_ptr -> nxd_mqtt_client_session_present = NX_TRUE;
+            }
+            else
+            {
+                client_ptr -> nxd_mqtt_client_session_present = NX_FALSE;
+            }
+
+#ifdef NXD_MQTT_V5_ENABLE
+            /* Topic aliases do not outlive the network connection.  */
+            NXD_MQTT_SECURE_MEMSET(client_ptr -> nxd_mqtt_client_topic_alias, 0, sizeof(client_ptr -> nxd_mqtt_client_topic_alias));
+            client_ptr -> nxd_mqtt_client_topic_alias_next = 0;
+            if (topic_alias_maximum > NXD_MQTT_TOPIC_ALIAS_MAX)
+            {
+                topic_alias_maximum = NXD_MQTT_TOPIC_ALIAS_MAX;
+            }
+            client_ptr -> nxd_mqtt_client_topic_alias_maximum = topic_alias_maximum;
+
+            /* The broker does not take packets larger than its Maximum Packet Size, zero is no limit.  */
+            client_ptr -> nxd_mqtt_client_maximum_packet_size = maximum_packet_size;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+            /* Initialize the packet identification field. The PUBLISH messages kept from the
+               previous session are sent again with their identifier, the new ones follow them.  */
+            if ((client_ptr -> nxd_mqtt_clean_session == NX_TRUE) ||
+                ((client_ptr -> message_transmit_queue_head == NX_NULL) && (client_ptr -> nxd_mqtt_client_qos2_count == 0)))
+            {
+                client_ptr -> nxd_mqtt_client_packet_identifier = NXD_MQTT_INITIAL_PACKET_ID_VALUE;
+            }
+            
+            /* Prevent packet identifier from being zero. MQTT-2.3.1-1 */
+            if(client_ptr -> nxd_mqtt_client_packet_identifier == 0)
+                client_ptr -> nxd_mqtt_client_packet_identifier = 1;
+
+            /* Release mutex */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        }
+    }
+
+    /* Check callback function.  */
+    if (client_ptr -> nxd_mqtt_connect_notify)
     {
-        nx_packet_release(client_ptr -> nxd_mqtt_client_processing_packet);
-        client_ptr -> nxd_mqtt_client_processing_packet = NX_NULL;
+        client_ptr -> nxd_mqtt_connect_notify(client_ptr, ret, client_ptr -> nxd_mqtt_connect_context);
     }
 
-    return;
-}
+    if (ret == NXD_MQTT_SUCCESS)
+    {
+
+        /* If client doesn't start with Clean Session, and there are un-acked PUBLISH messages,
+           we shall re-publish these messages. */
+        if ((client_ptr -> nxd_mqtt_clean_session != NX_TRUE) &&
+            (client_ptr -> message_transmit_queue_head || client_ptr -> nxd_mqtt_client_qos2_count))
+        {
+
+            tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+            /* There are messages from the previous session that has not been acknowledged. */
+            ret = _nxd_mqtt_client_retransmit_message(client_ptr, wait_option);
+
+            /* Release mutex */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        }
+    }
+    else
+    {
 
+        /* End connection. */
+        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+    }
+
+    return(ret);
+}
 
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_packet_receive_process                    PORTABLE C      */
+/*    _nxd_mqtt_process_publish_packet                    PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -2015,32 +2418,31 @@ UCHAR       fixed_header;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function process MQTT message.                        */
-/*    NOTE: MQTT Mutex is NOT obtained on entering this function.         */
-/*    Therefore it shouldn't hold the mutex when it exists this function. */
+/*    This internal function processes a packet and parses topic and      */
+/*    message.                                                            */
+/*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to the packet         */
+/*    topic_offset_ptr                      Return topic offset           */
+/*    topic_length_ptr                      Return topic length           */
+/*    message_offset_ptr                    Return message offset         */
+/*    message_length_ptr                    Return message length         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    None                                                                */
+/*    Status                                                              */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    nx_secure_tls_session_receive                                       */
-/*    nx_tcp_socket_receive                                               */
-/*    _nxd_mqtt_process_publish                                           */
-/*    _nxd_mqtt_process_publish_response                                  */
-/*    _nxd_mqtt_process_sub_unsub_ack                                     */
-/*    _nxd_mqtt_process_pingresp                                          */
-/*    _nxd_mqtt_process_disconnect                                        */
-/*    nx_packet_release                                                   */
+/*    _nxd_mqtt_read_remaining_length                                     */
+/*    nx_packet_data_extract_offset                                       */
+/*                                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_event_process                                      */
+/*    _nxd_mqtt_process_publish                                           */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -2051,253 +2453,202 @@ UCHAR       fixed_header;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_packet_receive_process(NXD_MQTT_CLIENT *client_ptr)
+UINT _nxd_mqtt_process_publish_packet(NX_PACKET *packet_ptr, ULONG *topic_offset_ptr, USHORT *topic_length_ptr,
+                                      ULONG *message_offset_ptr, ULONG *message_length_ptr)
 {
-NX_PACKET *packet_ptr;
-NX_PACKET *previous_packet_ptr;
-UINT       status;
-UCHAR      packet_type;
-UINT       remaining_length;
-UINT       packet_consumed;
-ULONG      offset;
-ULONG      bytes_copied;
-ULONG      packet_length;
+UCHAR  QoS;
+UINT   remaining_length = 0;
+UINT   topic_length;
+ULONG  offset;
+UCHAR  bytes[2];
+ULONG  bytes_copied;
+#ifdef NXD_MQTT_V5_ENABLE
+ULONG  next_offset;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-    for (;;)
+
+    QoS = (UCHAR)((*(packet_ptr -> nx_packet_prepend_ptr) & MQTT_PUBLISH_QOS_LEVEL_FIELD) >> 1);
+
+    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
     {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
 
-        /* Release the mutex. */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    if (remaining_length < 2)
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
 
-        /* Make a receive call. */
-#ifdef NX_SECURE_ENABLE
-        if (client_ptr -> nxd_mqtt_client_use_tls)
-        {
-            status = nx_secure_tls_session_receive(&(client_ptr -> nxd_mqtt_tls_session), &packet_ptr, NX_NO_WAIT);
-        }
-        else
+    /* Get topic length fields. */
+    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
+        (bytes_copied != sizeof(bytes)))
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+
+    topic_length = (UINT)(*(bytes) << 8) | (*(bytes + 1));
+
+    if (topic_length > remaining_length - 2u)
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+
+    *topic_offset_ptr = offset + 2;
+    *topic_length_ptr = (USHORT)topic_length;
+
+    remaining_length = remaining_length - topic_length - 2;
+    if ((QoS == 1) || (QoS == 2))
+    {
+        offset += 2 + 2 + topic_length;
+
+        if (remaining_length < 2)
         {
-            status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, NX_NO_WAIT);
+            return(NXD_MQTT_INVALID_PACKET);
         }
-#else
-        status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, NX_NO_WAIT);
-#endif /* NX_SECURE_ENABLE */
+        remaining_length = remaining_length - 2;
+    }
+    else
+    {
+        offset += 2 + topic_length;
+    }
 
-        if (status != NX_SUCCESS)
-        {
-            if (status != NX_NO_PACKET)
-            {
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Skip the properties that precede the message.  */
+    if (_nxd_mqtt_process_properties(packet_ptr, offset, offset + remaining_length, NX_NULL, NX_NULL, &next_offset))
+    {
+        return(NXD_MQTT_INVALID_PACKET);
+    }
+    remaining_length -= (UINT)(next_offset - offset);
+    offset = next_offset;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-                /* Network issue. Close the MQTT session. */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-                tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_NETWORK_DISCONNECT_EVENT, TX_OR);
-#else
-                nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_NETWORK_DISCONNECT_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-            }
+    *message_offset_ptr = offset;
+    *message_length_ptr = (ULONG)remaining_length;
 
-            break;
-        }
+    /* Return */
+    return(NXD_MQTT_SUCCESS);
+}
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_topic_trie_match                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function collects the topic filter nodes matching a   */
+/*    topic, from one level of the trie down. "+" matches one level and   */
+/*    "#" the remaining levels, including the parent level. Wildcards at  */
+/*    the first level do not match topics starting with '$'               */
+/*    (MQTT-4.7.2-1).                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    node_ptr                              First node of the level       */
+/*    level_ptr                             Topic level to match          */
+/*    topic_end                             End of the topic              */
+/*    first_level                           Level is the first one        */
+/*    match_list                            Matching nodes                */
+/*    match_count                           Number of matching nodes      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_topic_trie_match            Match the next level          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_topic_dispatch                                            */
+/*    _nxd_mqtt_topic_trie_match                                          */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_topic_trie_match(NXD_MQTT_TOPIC_NODE *node_ptr, UCHAR *level_ptr, UCHAR *topic_end, UINT first_level,
+                                       NXD_MQTT_TOPIC_NODE **match_list, UINT *match_count)
+{
+UCHAR               *level_end;
+NXD_MQTT_TOPIC_NODE *child_ptr;
+UINT                 system_topic;
 
-        /* Obtain the mutex. */
-        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    /* Find the end of this level. */
+    level_end = level_ptr;
+    while ((level_end < topic_end) && (*level_end != '/'))
+    {
+        level_end++;
+    }
 
-        /* Is there a packet waiting for processing? */
-        if (client_ptr -> nxd_mqtt_client_processing_packet)
-        {
+    system_topic = first_level && (level_ptr < topic_end) && (*level_ptr == '$');
 
-            /* Yes. Link received packet to existing one. */
-            if (client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last)
-            {
-                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last -> nx_packet_next = packet_ptr;
-            }
-            else
-            {
-                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_next = packet_ptr;
-            }
-            if (packet_ptr -> nx_packet_last)
-            {
-                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last = packet_ptr -> nx_packet_last;
-            }
-            else
+    for (; node_ptr; node_ptr = node_ptr -> nxd_mqtt_topic_node_sibling)
+    {
+        if ((node_ptr -> nxd_mqtt_topic_node_level_length == 1) && (node_ptr -> nxd_mqtt_topic_node_level[0] == '#'))
+        {
+            if ((!system_topic) && (*match_count < NXD_MQTT_TOPIC_MATCH_MAX))
             {
-                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last = packet_ptr;
+                match_list[(*match_count)++] = node_ptr;
             }
-            client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_length += packet_ptr -> nx_packet_length;
-
-            /* Start to process existing packet. */
-            packet_ptr = client_ptr -> nxd_mqtt_client_processing_packet;
-            client_ptr -> nxd_mqtt_client_processing_packet = NX_NULL;
+            continue;
         }
 
-        /* Check notify function.  */
-        if (client_ptr -> nxd_mqtt_packet_receive_notify)
+        if ((node_ptr -> nxd_mqtt_topic_node_level_length == 1) && (node_ptr -> nxd_mqtt_topic_node_level[0] == '+'))
         {
-
-            /* Call notify function. Return NX_TRUE if the packet has been consumed.  */
-            if (client_ptr -> nxd_mqtt_packet_receive_notify(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_packet_receive_context) == NX_TRUE)
+            if (system_topic)
             {
                 continue;
             }
         }
-
-        packet_consumed = NX_FALSE;
-        while (packet_ptr)
+        else if ((node_ptr -> nxd_mqtt_topic_node_level_length != (UINT)(level_end - level_ptr)) ||
+                 memcmp(node_ptr -> nxd_mqtt_topic_node_level, level_ptr, (UINT)(level_end - level_ptr)))
         {
-            /* Parse the incoming packet. */
-            status = _nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset);
-            if (status == NXD_MQTT_PARTIAL_PACKET)
-            {
-
-                /* We only have partial MQTT message. 
-                 * Put it to waiting list for more packets. */
-                client_ptr -> nxd_mqtt_client_processing_packet = packet_ptr;
-                packet_consumed = NX_TRUE;
-                break;
-            }
-            else if (status)
-            {
-                
-                /* Invalid packet. */
-                break;
-            }
-
-            /* Get packet type. */
-            if (nx_packet_data_extract_offset(packet_ptr, 0, &packet_type, 1, &bytes_copied))
-            {
-
-                /* Unable to read packet type. */
-                break;
-            }
-
-            /* Right shift 4 bits to get the packet type. */
-            packet_type = packet_type >> 4;
-
-            /* Process based on packet type. */
-            switch (packet_type)
-            {
-            case MQTT_CONTROL_PACKET_TYPE_CONNECT:
-                /* Client does not accept connections.  Nothing needs to be done. */
-                break;
-            case MQTT_CONTROL_PACKET_TYPE_CONNACK:
-                _nxd_mqtt_process_connack(client_ptr, packet_ptr, NX_NO_WAIT);
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_PUBLISH:
-                packet_consumed = _nxd_mqtt_process_publish(client_ptr, packet_ptr);
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_PUBACK:
-            case MQTT_CONTROL_PACKET_TYPE_PUBREL:
-                _nxd_mqtt_process_publish_response(client_ptr, packet_ptr);
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE:
-            case MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE:
-                /* Client should not process subscribe or unsubscribe message. */
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_SUBACK:
-            case MQTT_CONTROL_PACKET_TYPE_UNSUBACK:
-                _nxd_mqtt_process_sub_unsub_ack(client_ptr, packet_ptr);
-                break;
-
-
-            case MQTT_CONTROL_PACKET_TYPE_PINGREQ:
-                /* Client is not supposed to receive ping req.  Ignore it. */
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_PINGRESP:
-                _nxd_mqtt_process_pingresp(client_ptr);
-                break;
-
-            case MQTT_CONTROL_PACKET_TYPE_DISCONNECT:
-                _nxd_mqtt_process_disconnect(client_ptr);
-                break;
+            continue;
+        }
 
-            /* Publisher sender message type for QoS 2. Not supported. */
-            case MQTT_CONTROL_PACKET_TYPE_PUBREC:
-            case MQTT_CONTROL_PACKET_TYPE_PUBCOMP:
-            default:
-                /* Unknown type. */
-                break;
-            }
+        if (level_end == topic_end)
+        {
 
-            if (packet_consumed)
+            /* Last level of the topic. */
+            if ((node_ptr -> nxd_mqtt_topic_node_callback) && (*match_count < NXD_MQTT_TOPIC_MATCH_MAX))
             {
-                break;
+                match_list[(*match_count)++] = node_ptr;
             }
 
-            /* Trim current packet. */
-            offset += remaining_length;
-            packet_length = packet_ptr -> nx_packet_length;
-            if (packet_length > offset)
+            /* "level/#" matches "level" too. */
+            for (child_ptr = node_ptr -> nxd_mqtt_topic_node_child; child_ptr; child_ptr = child_ptr -> nxd_mqtt_topic_node_sibling)
             {
-
-                /* Multiple MQTT message in one packet. */
-                packet_length = packet_ptr -> nx_packet_length - offset;
-                while ((ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) <= offset)
-                {
-                    offset -= (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
-
-                    /* Current packet can be released. */
-                    previous_packet_ptr = packet_ptr;
-                    packet_ptr = packet_ptr -> nx_packet_next;
-                    previous_packet_ptr -> nx_packet_next = NX_NULL;
-                    nx_packet_release(previous_packet_ptr);
-                    if (packet_ptr == NX_NULL)
-                    {
-
-                        /* Invalid packet. */
-                        break;
-                    }
-                }
-
-                if (packet_ptr)
+                if ((child_ptr -> nxd_mqtt_topic_node_level_length == 1) && (child_ptr -> nxd_mqtt_topic_node_level[0] == '#') &&
+                    (*match_count < NXD_MQTT_TOPIC_MATCH_MAX))
                 {
-
-                    /* Adjust current packet. */
-                    packet_ptr -> nx_packet_prepend_ptr = packet_ptr -> nx_packet_prepend_ptr + offset;
-                    packet_ptr -> nx_packet_length = packet_length;
+                    match_list[(*match_count)++] = child_ptr;
                 }
             }
-            else
-            {
-
-                /* All messages in current packet is processed. */
-                break;
-            }
         }
-
-        if (!packet_consumed)
+        else if (node_ptr -> nxd_mqtt_topic_node_child)
         {
-            nx_packet_release(packet_ptr);
+            _nxd_mqtt_topic_trie_match(node_ptr -> nxd_mqtt_topic_node_child, level_end + 1, topic_end, NX_FALSE,
+                                       match_list, match_count);
         }
     }
-
-    /* No more data in the receive queue.  Return. */
-
-    return;
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_tcp_establish_process                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_topic_trie_prune                          PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes MQTT TCP connection establish event.        */
+/*    This internal function returns the nodes that neither have a        */
+/*    callback nor lead to one to the free list.                          */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    node_list_ptr                         Link to the first node of a   */
+/*                                            level                       */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -2305,342 +2656,231 @@ ULONG      packet_length;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    nx_secure_tls_session_start                                         */
-/*    _nxd_mqtt_client_connection_end                                     */
-/*    _nxd_mqtt_client_connect_packet_send                                */
+/*    _nxd_mqtt_topic_trie_prune            Prune the next level          */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_event_process                                      */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_client_topic_callback_set                                 */
+/*    _nxd_mqtt_topic_trie_prune                                          */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_tcp_establish_process(NXD_MQTT_CLIENT *client_ptr)
+static VOID _nxd_mqtt_topic_trie_prune(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_NODE **node_list_ptr)
 {
-UINT       status;
-
-
-    /* TCP connection is established.  */
+NXD_MQTT_TOPIC_NODE *node_ptr;
 
-    /* If TLS is enabled, start TLS */
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
+    while ((node_ptr = *node_list_ptr) != NX_NULL)
     {
-        status = nx_secure_tls_session_start(&(client_ptr -> nxd_mqtt_tls_session), &(client_ptr -> nxd_mqtt_client_socket), NX_NO_WAIT);
+        _nxd_mqtt_topic_trie_prune(client_ptr, &(node_ptr -> nxd_mqtt_topic_node_child));
 
-        if (status != NX_CONTINUE)
+        if ((node_ptr -> nxd_mqtt_topic_node_child == NX_NULL) && (node_ptr -> nxd_mqtt_topic_node_callback == NX_NULL))
         {
-
-            /* End connection. */
-            _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
-
-            /* Check callback function.  */
-            if (client_ptr -> nxd_mqtt_connect_notify)
-            {
-                client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
-            }
-
-            return;
+            *node_list_ptr = node_ptr -> nxd_mqtt_topic_node_sibling;
+            node_ptr -> nxd_mqtt_topic_node_sibling = client_ptr -> nxd_mqtt_client_topic_free_list;
+            client_ptr -> nxd_mqtt_client_topic_free_list = node_ptr;
         }
-
-        /* TLS in progress.  */
-        client_ptr -> nxd_mqtt_tls_in_progress = NX_TRUE;
-
-        return;
-    }
-#endif /* NX_SECURE_ENABLE */
-
-    /* Start to send MQTT connect packet.  */
-    status = _nxd_mqtt_client_connect_packet_send(client_ptr, NX_NO_WAIT);
-
-    /* Check status.  */
-    if (status)
-    {
-
-        /* End connection. */
-        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
-
-        /* Check callback function.  */
-        if (client_ptr -> nxd_mqtt_connect_notify)
+        else
         {
-            client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
+            node_list_ptr = &(node_ptr -> nxd_mqtt_topic_node_sibling);
         }
     }
 }
 
 
-#ifdef NX_SECURE_ENABLE
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_tls_establish_process                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_topic_dispatch                            PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes TLS connection establish event.             */
+/*    This internal function invokes the callbacks of the topic filters   */
+/*    matching a received publish message. The topic is matched in place, */
+/*    so a topic that does not fit in the first packet of a chain is not  */
+/*    dispatched and the message is queued instead.                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to publish packet     */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    None                                                                */
+/*    NX_TRUE - message is dispatched                                     */
+/*    NX_FALSE - no topic filter matches                                  */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_secure_tls_handshake_process                                    */
-/*    _nxd_mqtt_client_connect_packet_send                                */
-/*    _nxd_mqtt_client_connection_end                                     */
+/*    _nxd_mqtt_process_publish_packet      Parse topic and message       */
+/*    _nxd_mqtt_topic_trie_match            Match the topic filters       */
+/*    [nxd_mqtt_topic_node_callback]        Topic filter callback         */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_event_process                                      */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_process_publish                                           */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_tls_establish_process(NXD_MQTT_CLIENT *client_ptr)
+static UINT _nxd_mqtt_topic_dispatch(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
-UINT       status;
-
+NXD_MQTT_TOPIC_NODE *match_list[NXD_MQTT_TOPIC_MATCH_MAX];
+UINT                 match_count = 0;
+UINT                 i;
+ULONG                topic_offset;
+USHORT               topic_length;
+ULONG                message_offset;
+ULONG                message_length;
+UCHAR               *topic_ptr;
 
-    /* Directly call handshake process for async mode. */
-    status = _nx_secure_tls_handshake_process(&(client_ptr -> nxd_mqtt_tls_session), NX_NO_WAIT);
-    if (status == NX_SUCCESS)
+    if (_nxd_mqtt_process_publish_packet(packet_ptr, &topic_offset, &topic_length, &message_offset, &message_length))
     {
-
-        /* TLS session established.   */
-        client_ptr -> nxd_mqtt_tls_in_progress= NX_FALSE;
-
-        /* Start to send MQTT connect packet.  */
-        status = _nxd_mqtt_client_connect_packet_send(client_ptr, NX_NO_WAIT);
-
-        /* Check status.  */
-        if (status)
-        {
-
-            /* End connection. */
-            _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
-
-            /* Check callback function.  */
-            if (client_ptr -> nxd_mqtt_connect_notify)
-            {
-                client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
-            }
-        }
+        return(NX_FALSE);
     }
-    else if (status != NX_CONTINUE)
-    {
 
-        /* Error.  */
+    if ((topic_offset + topic_length) > (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr))
+    {
+        return(NX_FALSE);
+    }
 
-        /* End connection. */
-        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+    topic_ptr = packet_ptr -> nx_packet_prepend_ptr + topic_offset;
+    _nxd_mqtt_topic_trie_match(client_ptr -> nxd_mqtt_client_topic_trie, topic_ptr, topic_ptr + topic_length, NX_TRUE,
+                               match_list, &match_count);
 
-        /* Check callback function.  */
-        if (client_ptr -> nxd_mqtt_connect_notify)
-        {
-            client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
-        }
+    for (i = 0; i < match_count; i++)
+    {
+        match_list[i] -> nxd_mqtt_topic_node_callback(client_ptr, packet_ptr, topic_offset, topic_length,
+                                                      message_offset, message_length,
+                                                      match_list[i] -> nxd_mqtt_topic_node_context);
     }
 
-    return;
+    return(match_count != 0);
 }
-#endif /* NX_SECURE_ENABLE */
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_append_message                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_last_value_find                           PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function writes the message length and message in the outgoing */
-/*    MQTT packet.                                                        */
+/*    This internal function looks a topic up in the last value cache. It */
+/*    returns the entry of the topic, or NULL with the index of the free  */
+/*    entry that ends its probe sequence.                                 */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Outgoing MQTT packet          */
-/*    message                               Pointer to the message        */
-/*    length                                Length of the message         */
-/*    wait_option                           Wait option                   */
+/*    topic_ptr                             Topic                         */
+/*    topic_length                          Length of the topic           */
+/*    hash                                  Hash of the topic             */
+/*    index_ptr                             Pointer to the entry index    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                                              */
+/*    entry_ptr                             Entry of the topic or NULL    */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    nx_packet_data_append                 Append packet data            */
+/*    NXD_MQTT_SECURE_MEMCMP                                              */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_sub_unsub                                          */
-/*    _nxd_mqtt_client_connect                                            */
-/*    _nxd_mqtt_client_publish                                            */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_last_value_update                                         */
+/*    _nxd_mqtt_client_last_value_get                                     */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_append_message(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, CHAR *message, UINT length, ULONG wait_option)
+static NXD_MQTT_LAST_VALUE_ENTRY *_nxd_mqtt_last_value_find(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_ptr, UINT topic_length,
+                                                            ULONG hash, UINT *index_ptr)
 {
-UINT ret = 0;
-UCHAR len[2];
-
-    len[0] = (length >> 8) & 0xFF;
-    len[1] = length  & 0xFF;
-
-    /* Append message length field. */
-    ret = nx_packet_data_append(packet_ptr, len, 2, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+NXD_MQTT_LAST_VALUE_ENTRY *entry_ptr;
+UINT                       mask = client_ptr -> nxd_mqtt_client_last_value_entries - 1;
+UINT                       index;
 
-    if (ret)
+    /* One entry is always free, the probe sequence ends. */
+    index = hash & mask;
+    for (;;)
     {
-        return(ret);
-    }
+        entry_ptr = NXD_MQTT_LAST_VALUE_ENTRY_AT(client_ptr, index);
+        if (entry_ptr -> nxd_mqtt_last_value_hash == 0)
+        {
+            *index_ptr = index;
+            return(NX_NULL);
+        }
 
-    if (length)
-    {
-        /* Copy the string into the packet. */
-        ret = nx_packet_data_append(packet_ptr, message, length, 
-                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+        if ((entry_ptr -> nxd_mqtt_last_value_hash == hash) &&
+            (entry_ptr -> nxd_mqtt_last_value_topic_length == topic_length) &&
+            (NXD_MQTT_SECURE_MEMCMP((UCHAR *)(entry_ptr + 1), topic_ptr, topic_length) == 0))
+        {
+            *index_ptr = index;
+            return(entry_ptr);
+        }
+        index = (index + 1) & mask;
     }
-
-    return(ret);
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_connection_end                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_last_value_hash                           PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function is used to end the MQTT connection.                   */
+/*    This internal function returns the FNV-1a hash of a topic, never 0, */
+/*    which marks a free entry of the last value cache.                   */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
-/*    wait_option                           Wait option                   */
+/*    topic_ptr                             Topic                         */
+/*    topic_length                          Length of the topic           */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    None                                                                */
+/*    hash                                  Hash of the topic             */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    nx_secure_tls_session_end             End TLS session               */
-/*    nx_secure_tls_session_delete          Delete TLS session            */
-/*    nx_tcp_socket_disconnect              Close TCP connection          */
-/*    nx_tcp_client_socket_unbind           Unbind TCP socket             */
-/*    tx_timer_delete                       Delete timer                  */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect                                            */
-/*    _nxd_mqtt_process_disconnect                                        */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_last_value_update                                         */
+/*    _nxd_mqtt_client_last_value_get                                     */
 /*                                                                        */
 /**************************************************************************/
-VOID _nxd_mqtt_client_connection_end(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+static ULONG _nxd_mqtt_last_value_hash(UCHAR *topic_ptr, UINT topic_length)
 {
+ULONG hash = 2166136261UL;
 
-    /* Obtain the mutex. */
-    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-    /* Mark the session as terminated. */
-    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
-
-    /* Release the mutex. */
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
+    while (topic_length--)
     {
-        nx_secure_tls_session_end(&(client_ptr -> nxd_mqtt_tls_session), wait_option);
-        nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
+        hash = (hash ^ *topic_ptr++) * 16777619UL;
     }
-#endif
-    nx_tcp_socket_disconnect(&(client_ptr -> nxd_mqtt_client_socket), wait_option);
-    nx_tcp_client_socket_unbind(&(client_ptr -> nxd_mqtt_client_socket));
 
-    /* Disable timer if timer has been started. */
-    if (client_ptr -> nxd_mqtt_keepalive)
-    {
-         tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
-    }
+    return(hash ? hash : 1);
 }
 
 
-static UINT _nxd_mqtt_send_simple_message(NXD_MQTT_CLIENT *client_ptr, UCHAR header_value);
-
-
-/* MQTT internal function */
-
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_periodic_timer_entry                      PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_last_value_update                         PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function is passed to MQTT client socket create call. */
-/*    This callback function notifies MQTT client thread when the TCP     */
-/*    connection is lost.                                                 */
-/*                                                                        */
+/*    This internal function keeps the message of an incoming PUBLISH as  */
+/*    the last value of its topic. An empty message, as sent to clear a   */
+/*    retained message, or one too large for an entry removes the topic   */
+/*    from the cache, so that no stale value is returned. A new topic is  */
+/*    not cached when the cache is full. The caller holds the client      */
+/*    mutex.                                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    socket_ptr                            Pointer to TCP socket that    */
-/*                                            disconnected.               */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -2648,66 +2888,98 @@ static UINT _nxd_mqtt_send_simple_message(NXD_MQTT_CLIENT *client_ptr, UCHAR hea
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _nxd_mqtt_process_publish_packet                                    */
+/*    _nxd_mqtt_last_value_hash                                           */
+/*    _nxd_mqtt_last_value_find                                           */
+/*    nx_packet_data_extract_offset                                       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    TCP socket disconnect callback                                      */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_process_publish                                           */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_periodic_timer_entry(ULONG client)
+static VOID _nxd_mqtt_last_value_update(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
-/* Check if it is time to send out a ping message. */
-NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)client;
+NXD_MQTT_LAST_VALUE_ENTRY *entry_ptr;
+NXD_MQTT_LAST_VALUE_ENTRY *next_ptr;
+ULONG                      topic_offset;
+USHORT                     topic_length;
+ULONG                      message_offset;
+ULONG                      message_length;
+ULONG                      bytes_copied;
+ULONG                      hash;
+UINT                       mask = client_ptr -> nxd_mqtt_client_last_value_entries - 1;
+UINT                       hole;
+UINT                       index;
+UINT                       home;
+UCHAR                     *topic_ptr;
+
+    if (_nxd_mqtt_process_publish_packet(packet_ptr, &topic_offset, &topic_length, &message_offset, &message_length) ||
+        ((topic_offset + topic_length) > (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr)))
+    {
+        return;
+    }
 
-    /* If an outstanding ping response has not been received, and the client exceeds the time waiting for ping response,
-       the client shall disconnect from the server. */
-    if (client_ptr -> nxd_mqtt_ping_not_responded)
+    topic_ptr = packet_ptr -> nx_packet_prepend_ptr + topic_offset;
+    hash = _nxd_mqtt_last_value_hash(topic_ptr, topic_length);
+    entry_ptr = _nxd_mqtt_last_value_find(client_ptr, topic_ptr, topic_length, hash, &hole);
+
+    if ((message_length == 0) ||
+        ((sizeof(NXD_MQTT_LAST_VALUE_ENTRY) + topic_length + message_length) > client_ptr -> nxd_mqtt_client_last_value_entry_size))
     {
-        /* If current time is greater than the ping timeout */
-        if ((tx_time_get() - client_ptr -> nxd_mqtt_ping_sent_time) >= client_ptr -> nxd_mqtt_ping_timeout)
+        if (entry_ptr == NX_NULL)
         {
-            /* Ping timed out.  Need to terminate the connection. */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-            tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_PING_TIMEOUT_EVENT, TX_OR);
-#else
-            nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PING_TIMEOUT_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-
             return;
         }
+
+        /* Remove the entry and shift back the entries of the probe sequence behind it. */
+        index = (hole + 1) & mask;
+        next_ptr = NXD_MQTT_LAST_VALUE_ENTRY_AT(client_ptr, index);
+        while (next_ptr -> nxd_mqtt_last_value_hash)
+        {
+            home = next_ptr -> nxd_mqtt_last_value_hash & mask;
+            if (((index - home) & mask) >= ((index - hole) & mask))
+            {
+                NXD_MQTT_SECURE_MEMCPY(entry_ptr, next_ptr, client_ptr -> nxd_mqtt_client_last_value_entry_size); /* Use case of memcpy is verified. */
+                entry_ptr = next_ptr;
+                hole = index;
+            }
+            index = (index + 1) & mask;
+            next_ptr = NXD_MQTT_LAST_VALUE_ENTRY_AT(client_ptr, index);
+        }
+        entry_ptr -> nxd_mqtt_last_value_hash = 0;
+        client_ptr -> nxd_mqtt_client_last_value_count--;
+        return;
     }
 
-    /* About to timeout? */
-    if ((client_ptr -> nxd_mqtt_timeout - tx_time_get()) <= client_ptr -> nxd_mqtt_timer_value)
+    if (entry_ptr == NX_NULL)
     {
-        /* Set the flag so the MQTT thread can send the ping. */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-        tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_TIMEOUT_EVENT, TX_OR);
-#else
-        nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_TIMEOUT_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-    }
 
-    /* If keepalive is not enabled, just return. */
-    return;
-}
+        /* Keep one entry free, so that a search always ends. */
+        if (client_ptr -> nxd_mqtt_client_last_value_count >= mask)
+        {
+            return;
+        }
 
+        entry_ptr = NXD_MQTT_LAST_VALUE_ENTRY_AT(client_ptr, hole);
+        entry_ptr -> nxd_mqtt_last_value_hash = hash;
+        entry_ptr -> nxd_mqtt_last_value_topic_length = topic_length;
+        NXD_MQTT_SECURE_MEMCPY((UCHAR *)(entry_ptr + 1), topic_ptr, topic_length); /* Use case of memcpy is verified. */
+        client_ptr -> nxd_mqtt_client_last_value_count++;
+    }
 
+    /* The message may span several packets of the chain. */
+    nx_packet_data_extract_offset(packet_ptr, message_offset, (UCHAR *)(entry_ptr + 1) + topic_length,
+                                  message_length, &bytes_copied);
+    entry_ptr -> nxd_mqtt_last_value_length = (USHORT)bytes_copied;
+    entry_ptr -> nxd_mqtt_last_value_time = tx_time_get();
+}
 
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_event_process                      PORTABLE C      */
+/*    _nxd_mqtt_process_publish                           PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -2715,165 +2987,311 @@ NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)client;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function serves as the entry point for the MQTT       */
-/*    client thread.                                                      */
+/*    This internal function process a publish message from the broker.   */
+/*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    mqtt_client                           Pointer to MQTT Client        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    None                                                                */
+/*    NX_TRUE - packet is consumed                                        */
+/*    NX_FALSE - packet is not consumed                                   */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_release_transmit_packet                                   */
-/*    _nxd_mqtt_release_receive_packet                                    */
-/*    _nxd_mqtt_send_simple_message                                       */
-/*    _nxd_mqtt_process_disconnect                                        */
-/*    _nxd_mqtt_packet_receive_process                                    */
-/*    tx_timer_delete                                                     */
-/*    tx_event_flags_delete                                               */
-/*    nx_tcp_socket_delete                                                */
-/*    tx_timer_delete                                                     */
-/*    tx_mutex_delete                                                     */
+/*    [receive_notify]                      User supplied receive         */
+/*                                            callback function           */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_packet_release                                                   */
+/*    nx_secure_tls_session_send                                          */
+/*    _nxd_mqtt_process_publish_packet                                    */
+/*    _nxd_mqtt_copy_transmit_packet                                      */
+/*    _nxd_mqtt_last_value_update                                         */
+/*    _nxd_mqtt_topic_dispatch                                            */
+/*                                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*   _nxd_mqtt_client_create                                              */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected mqtt client state,*/
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_client_event_process(VOID *mqtt_client, ULONG common_events, ULONG module_own_events)
+static UINT _nxd_mqtt_process_publish(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
-NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)mqtt_client;
-
-
-    /* Obtain the mutex. */
-    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+MQTT_PACKET_PUBLISH_RESPONSE *pubresp_ptr;
+UINT                          status;
+USHORT                        packet_id = 0;
+UCHAR                         QoS;
+UINT                          enqueue_message = 0;
+NX_PACKET                    *transmit_packet_ptr;
+UINT                          remaining_length = 0;
+UINT                          packet_consumed = NX_FALSE;
+NX_PACKET                    *previous_packet_ptr;
+UINT                          topic_length;
+ULONG                         offset;
+UCHAR                         bytes[2];
+ULONG                         bytes_copied;
 
-    /* Process common events.  */
-    NX_PARAMETER_NOT_USED(common_events);
+    QoS = (UCHAR)((*(packet_ptr -> nx_packet_prepend_ptr) & MQTT_PUBLISH_QOS_LEVEL_FIELD) >> 1);
 
-    if (module_own_events & MQTT_TIMEOUT_EVENT)
+    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
     {
-        /* Send out PING only if the client is connected. */
-        if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
-        {
-            _nxd_mqtt_send_simple_message(client_ptr, MQTT_CONTROL_PACKET_TYPE_PINGREQ);
-        }
+        return(NX_FALSE);
     }
 
-    if (module_own_events & MQTT_TCP_ESTABLISH_EVENT)
+    if (remaining_length < 2)
     {
-        _nxd_mqtt_tcp_establish_process(client_ptr);
+        return(NXD_MQTT_INVALID_PACKET);
     }
 
-    if (module_own_events & MQTT_PACKET_RECEIVE_EVENT)
+    /* Get topic length fields. */
+    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
+        (bytes_copied != sizeof(bytes)))
     {
-#ifdef NX_SECURE_ENABLE
-        /* TLS in progress on async mode.  */
-        if (client_ptr -> nxd_mqtt_tls_in_progress)
-        {
-            _nxd_mqtt_tls_establish_process(client_ptr);
-        }
-        else
-#endif /* NX_SECURE_ENABLE */
-
-        _nxd_mqtt_packet_receive_process(client_ptr);
+        return(NXD_MQTT_INVALID_PACKET);
     }
 
-    if (module_own_events & MQTT_PING_TIMEOUT_EVENT)
+    topic_length = (UINT)(*(bytes) << 8) | (*(bytes + 1));
+
+    if (topic_length > remaining_length - 2u)
     {
-        /* The server/broker didn't respond to our ping request message. Disconnect from the server. */
-        _nxd_mqtt_process_disconnect(client_ptr);
+        return(NXD_MQTT_INVALID_PACKET);
     }
-    if (module_own_events & MQTT_NETWORK_DISCONNECT_EVENT)
+
+    if (QoS == 0)
     {
-        /* The server closed TCP socket. We shall go through the disconnect code path. */
-        _nxd_mqtt_process_disconnect(client_ptr);
+        enqueue_message = 1;
     }
-
-    if (module_own_events & MQTT_DELETE_EVENT)
+    else
     {
-
-        /* Stop the client and disconnect from the server. */
-        if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+        /* QoS 1 or QoS 2 messages. */
+        /* Get packet id fields. */
+        if (nx_packet_data_extract_offset(packet_ptr, offset + 2 + topic_length, &bytes, sizeof(bytes), &bytes_copied))
         {
-            _nxd_mqtt_process_disconnect(client_ptr);
+            return(NXD_MQTT_INVALID_PACKET);
         }
 
-        /* Delete the timer. Check first if it is already deleted. */
-        if ((client_ptr -> nxd_mqtt_timer).tx_timer_id != 0)
-            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+        packet_id = (USHORT)(((*bytes) << 8) | (*(bytes + 1)));
 
-#ifndef NXD_MQTT_CLOUD_ENABLE
-        /* Delete the event flag. Check first if it is already deleted. */
-        if ((client_ptr -> nxd_mqtt_events).tx_event_flags_group_id != 0)
-            tx_event_flags_delete(&client_ptr -> nxd_mqtt_events);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
+        /* Look for an existing transmit packets with the same packet id */
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF0,
+                                                             MQTT_CONTROL_PACKET_TYPE_PUBREC << 4,
+                                                             &previous_packet_ptr);
 
-        /* Release all the messages on the receive queue. */
-        while (client_ptr -> message_receive_queue_head)
+        if (transmit_packet_ptr ||
+            (_nxd_mqtt_qos2_entry_find(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREC_SENT) <
+             client_ptr -> nxd_mqtt_client_qos2_table_size))
         {
-            _nxd_mqtt_release_receive_packet(client_ptr, client_ptr -> message_receive_queue_head, NX_NULL);
+            /* This published data is already in our system.  No need to deliver this message to the application. */
+            enqueue_message = 0;
         }
-        client_ptr -> message_receive_queue_depth = 0;
+        else
+        {
+            enqueue_message = 1;
+        }
+    }
 
-        /* Delete all the messages sitting in the receive and transmit queue. */
-        while (client_ptr -> message_transmit_queue_head)
+    /* Keep the message as the last value of its topic. */
+    if (enqueue_message && client_ptr -> nxd_mqtt_client_last_value_cache)
+    {
+        _nxd_mqtt_last_value_update(client_ptr, packet_ptr);
+    }
+
+    /* Hand the message to the callbacks of the matching topic filters instead of queuing it. */
+    if (enqueue_message && client_ptr -> nxd_mqtt_client_topic_trie &&
+        _nxd_mqtt_topic_dispatch(client_ptr, packet_ptr))
+    {
+        enqueue_message = 0;
+    }
+
+    /* Make room in the full receive queue, or drop the message. QoS 1 and 2 messages
+       are queued over the limits, the backpressure stops the reading after this one. */
+    if (enqueue_message && _nxd_mqtt_receive_queue_full(client_ptr, offset + remaining_length))
+    {
+        if (client_ptr -> nxd_mqtt_client_receive_queue_policy == NXD_MQTT_RECEIVE_QUEUE_DROP_OLDEST)
         {
-            _nxd_mqtt_release_transmit_packet(client_ptr, client_ptr -> message_transmit_queue_head, NX_NULL);
+            _nxd_mqtt_receive_queue_drop_oldest(client_ptr, offset + remaining_length);
         }
 
-        /* Release mutex */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-        
-#ifndef NXD_MQTT_CLOUD_ENABLE
-        /* Delete the mutex. */
-        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
+        if ((QoS == 0) &&
+            (client_ptr -> nxd_mqtt_client_receive_queue_policy != NXD_MQTT_RECEIVE_QUEUE_BACKPRESSURE) &&
+            _nxd_mqtt_receive_queue_full(client_ptr, offset + remaining_length))
+        {
+            client_ptr -> nxd_mqtt_client_receive_dropped++;
+            enqueue_message = 0;
+        }
+    }
 
-        /* Deleting the socket, (the socket ID is cleared); this signals it is ok to delete this thread. */
-        nx_tcp_socket_delete(&client_ptr -> nxd_mqtt_client_socket);
+    if (enqueue_message)
+    {
+        if (packet_ptr -> nx_packet_length > (offset + remaining_length))
+        {
+
+            /* This packet contains multiple messages. */
+            if (nx_packet_copy(packet_ptr, &packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, NX_NO_WAIT))
+            {
+
+                /* No packet is available. */
+                return(NX_FALSE);
+            }
+        }
+        else
+        {
+            packet_consumed = NX_TRUE;
+        }
+
+        /* Increment the queue depth counter. */
+        client_ptr -> message_receive_queue_depth++;
+        client_ptr -> message_receive_queue_bytes += packet_ptr -> nx_packet_length;
+
+        if (client_ptr -> message_receive_queue_head == NX_NULL)
+        {
+            client_ptr -> message_receive_queue_head = packet_ptr;
+        }
+        else
+        {
+            client_ptr -> message_receive_queue_tail -> nx_packet_queue_next = packet_ptr;
+        }
+        client_ptr -> message_receive_queue_tail = packet_ptr;
+
+        /* Invoke the user-defined receive notify function if it is set. */
+        if (client_ptr -> nxd_mqtt_client_receive_notify)
+        {
+            (*(client_ptr -> nxd_mqtt_client_receive_notify))(client_ptr, client_ptr -> message_receive_queue_depth);
+        }
+    }
+
+    /* If the message QoS level is 0, we are done. */
+    if (QoS == 0)
+    {
+        /* Return */
+        return(packet_consumed);
+    }
+
+    /* Send out proper ACKs for QoS 1 and 2 messages. */
+    /* Allocate a new packet so we can send out a response. */
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, 4);
+    if (status)
+    {
+        /* Packet allocation fails. */
+        return(packet_consumed);
+    }
+
+    /* Fill in the packet ID */
+    pubresp_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)(packet_ptr -> nx_packet_prepend_ptr);
+    pubresp_ptr -> mqtt_publish_response_packet_remaining_length = 2;
+    pubresp_ptr -> mqtt_publish_response_packet_packet_identifier_msb = (UCHAR)(packet_id >> 8);
+    pubresp_ptr -> mqtt_publish_response_packet_packet_identifier_lsb = (UCHAR)(packet_id & 0xFF);
+
+    if (QoS == 1)
+    {
+
+        pubresp_ptr -> mqtt_publish_response_packet_header = MQTT_CONTROL_PACKET_TYPE_PUBACK << 4;
     }
     else
     {
+        pubresp_ptr -> mqtt_publish_response_packet_header = MQTT_CONTROL_PACKET_TYPE_PUBREC << 4;
+    }
 
-        /* Release mutex */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr + sizeof(MQTT_PACKET_PUBLISH_RESPONSE);
+    packet_ptr -> nx_packet_length = sizeof(MQTT_PACKET_PUBLISH_RESPONSE);
+
+    if ((QoS == 2) && client_ptr -> nxd_mqtt_client_qos2_table)
+    {
+
+        /* Record the packet ID only, for checking duplicate publish packet. */
+        if (_nxd_mqtt_qos2_entry_add(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREC_SENT))
+        {
+
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+            return(packet_consumed);
+        }
     }
-}
+    else if (QoS == 2)
+    {
 
+        /* Copy packet for checking duplicate publish packet. */
+        if (_nxd_mqtt_copy_transmit_packet(client_ptr, packet_ptr, &transmit_packet_ptr,
+                                           packet_id, NX_FALSE, NX_WAIT_FOREVER))
+        {
 
-#ifndef NXD_MQTT_CLOUD_ENABLE
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+            return(packet_consumed);
+        }
+        if (_nxd_mqtt_transmit_queue_append(client_ptr, transmit_packet_ptr))
+        {
+
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+            return(packet_consumed);
+        }
+    }
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, NX_WAIT_FOREVER);
+    }
+    else
+    {
+        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
+    }
+#else
+    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
+
+#endif /* NX_SECURE_ENABLE */
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+    if (status)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+    }
+    else
+    {
+        /* Update the timeout value. */
+        client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+    }
+
+    /* Return */
+    return(packet_consumed);
+}
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_thread_entry                              PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_latency_batch_sent                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function serves as the entry point for the MQTT       */
-/*    client thread.                                                      */
+/*    This internal function stamps the time a publish batch is handed to */
+/*    TCP on the transmit packets of its messages, the publish packets of */
+/*    the transmit queue not stamped yet: each of the others is stamped   */
+/*    under the mutex it is queued with, right before its own send. The   */
+/*    caller holds the mutex.                                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    mqtt_client                           Pointer to MQTT Client        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    skip_packet_ptr                       Transmit packet of a message  */
+/*                                            out of the batch, or NULL   */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -2881,68 +3299,47 @@ NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)mqtt_client;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_get                                                  */
-/*    _nxd_mqtt_client_event_process                                      */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*   _nxd_mqtt_client_create                                              */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_client_publish_packet_transmit                            */
+/*    _nxd_mqtt_client_publish_batch_flush                                */
 /*                                                                        */
 /**************************************************************************/
-static VOID _nxd_mqtt_thread_entry(ULONG mqtt_client)
+static VOID _nxd_mqtt_latency_batch_sent(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *skip_packet_ptr)
 {
-NXD_MQTT_CLIENT *client_ptr;
-ULONG            events;
 
-    client_ptr = (NXD_MQTT_CLIENT *)mqtt_client;
+NX_PACKET *transmit_packet_ptr;
+ULONG      now = NXD_MQTT_LATENCY_TIME();
 
-    /* Loop to process events on the MQTT client */
-    for (;;)
+    for (transmit_packet_ptr = client_ptr -> message_transmit_queue_head; transmit_packet_ptr;
+         transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next)
     {
-
-        tx_event_flags_get(&client_ptr -> nxd_mqtt_events, MQTT_ALL_EVENTS, TX_OR_CLEAR, &events, TX_WAIT_FOREVER);
-
-        /* Call the event processing routine.  */
-        _nxd_mqtt_client_event_process(client_ptr, NX_NULL, events);
-
-        if (events & MQTT_DELETE_EVENT)
+        if ((transmit_packet_ptr != skip_packet_ptr) && !NXD_MQTT_LATENCY_SENT(transmit_packet_ptr) &&
+            ((*(transmit_packet_ptr -> nx_packet_prepend_ptr) & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4)))
         {
-            break;
+            NXD_MQTT_LATENCY_SEND_TIME(transmit_packet_ptr) = now;
+            NXD_MQTT_LATENCY_SENT(transmit_packet_ptr) = NX_TRUE;
         }
     }
 }
-#endif /* NXD_MQTT_CLOUD_ENABLE */
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _mqtt_client_disconnect_callback                    PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_latency_histogram_add                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function is passed to MQTT client socket create call. */
-/*    This callback function notifies MQTT client thread when the TCP     */
-/*    connection is lost.                                                 */
-/*                                                                        */
+/*    This internal function counts a latency in its histogram bucket.    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    socket_ptr                            Pointer to TCP socket that    */
-/*                                            disconnected.               */
+/*    histogram_ptr                         Pointer to the histogram      */
+/*    microseconds                          Latency                       */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -2954,38 +3351,96 @@ ULONG            events;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    TCP socket disconnect callback                                      */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_latency_record                                            */
 /*                                                                        */
 /**************************************************************************/
-static VOID _mqtt_client_disconnect_callback(NX_TCP_SOCKET *socket_ptr)
+static VOID _nxd_mqtt_latency_histogram_add(NXD_MQTT_LATENCY_HISTOGRAM *histogram_ptr, ULONG microseconds)
 {
-NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)(socket_ptr -> nx_tcp_socket_reserved_ptr);
 
-    /* Set the MQTT_NETWORK_DISCONNECT  event.  This event indicates
-       that the disconnect is initiated from the network. */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-    tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_NETWORK_DISCONNECT_EVENT, TX_OR);
-#else
-    nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_NETWORK_DISCONNECT_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
+UINT index = (UINT)microseconds;
+UINT exponent = 2;
 
-    return;
+    /* Four linear buckets in the power of two of the latency. */
+    if (microseconds >= 4)
+    {
+        while ((exponent < 31) && (microseconds >> (exponent + 1)))
+        {
+            exponent++;
+        }
+        index = ((exponent - 1) << 2) + (UINT)((microseconds >> (exponent - 2)) & 3);
+    }
+
+    if (index >= NXD_MQTT_LATENCY_BUCKETS)
+    {
+        index = NXD_MQTT_LATENCY_BUCKETS - 1;
+    }
+
+    histogram_ptr -> nxd_mqtt_latency_buckets[index]++;
+    histogram_ptr -> nxd_mqtt_latency_count++;
+    if (microseconds > histogram_ptr -> nxd_mqtt_latency_maximum)
+    {
+        histogram_ptr -> nxd_mqtt_latency_maximum = microseconds;
+    }
 }
 
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_latency_record                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function counts the latencies of a message whose      */
+/*    PUBACK or PUBREC is received, from the stamps of its transmit       */
+/*    packet. The caller holds the mutex.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    transmit_packet_ptr                   Transmit packet of message    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_latency_histogram_add                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_latency_record(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *transmit_packet_ptr)
+{
+
+NXD_MQTT_LATENCY *latency_ptr = &(client_ptr -> nxd_mqtt_client_latency);
+ULONG             now = NXD_MQTT_LATENCY_TIME();
+ULONG             publish_time = NXD_MQTT_LATENCY_PUBLISH_TIME(transmit_packet_ptr);
+ULONG             send_time = NXD_MQTT_LATENCY_SEND_TIME(transmit_packet_ptr);
+
+    if (NXD_MQTT_LATENCY_SENT(transmit_packet_ptr))
+    {
+        _nxd_mqtt_latency_histogram_add(&(latency_ptr -> nxd_mqtt_latency_queueing),
+                                        NXD_MQTT_LATENCY_MICROSECONDS(send_time - publish_time));
+        _nxd_mqtt_latency_histogram_add(&(latency_ptr -> nxd_mqtt_latency_network),
+                                        NXD_MQTT_LATENCY_MICROSECONDS(now - send_time));
+    }
+
+    _nxd_mqtt_latency_histogram_add(&(latency_ptr -> nxd_mqtt_latency_total),
+                                    NXD_MQTT_LATENCY_MICROSECONDS(now - publish_time));
+}
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_create                             PORTABLE C      */
+/*    _nxd_mqtt_process_publish_response                  PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -2993,35 +3448,37 @@ NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)(socket_ptr -> nx_tcp_socket_re
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function creates an instance for MQTT Client.  It initializes  */
-/*    MQTT Client control block, creates a thread, mutex and event queue  */
-/*    for MQTT Client, and creates the TCP socket for MQTT messaging.     */
+/*    This internal function process a publish response messages.         */
+/*    Publish Response messages are: PUBACK, PUBREC, PUBREL, PUBCOMP      */
 /*                                                                        */
+/*    When a QoS 2 table is set, a QoS 2 exchange is kept there by packet */
+/*    ID once its message is acknowledged, instead of a PUBREC or PUBREL  */
+/*    packet on the transmit queue.                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    client_id                             Client ID for this instance   */
-/*    client_id_length                      Length of Client ID, in bytes */
-/*    ip_ptr                                Pointer to IP instance        */
-/*    pool_ptr                              Pointer to packet pool        */
-/*    stack_ptr                             Client thread's stack pointer */
-/*    stack_size                            Client thread's stack size    */
-/*    mqtt_thread_priority                  Priority for MQTT thread      */
-/*    memory_ptr                            Deprecated and not used       */
-/*    memory_size                           Deprecated and not used       */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    Status                                                              */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_create_internal      Create mqtt client            */
+/*    [nxd_mqtt_client_receive_notify]      User supplied publish         */
+/*                                            callback function           */
+/*    _nxd_mqtt_release_transmit_packet                                   */
+/*    _nxd_mqtt_transmit_packet_find                                      */
+/*    _nxd_mqtt_qos2_entry_find                                           */
+/*    _nxd_mqtt_qos2_entry_add                                            */
+/*    _nxd_mqtt_qos2_entry_remove                                         */
+/*    _nxd_mqtt_publish_response_send                                     */
+/*                                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -3029,90 +3486,276 @@ NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)(socket_ptr -> nx_tcp_socket_re
 /*                                                                        */
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
 /*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected mqtt client state,*/
+/*                                            added ack receive notify,   */
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
-                             CHAR *client_id, UINT client_id_length,
-                             NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
-                             VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority,
-                             VOID *memory_ptr, ULONG memory_size)
+static UINT _nxd_mqtt_process_publish_response(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
+MQTT_PACKET_PUBLISH_RESPONSE *response_ptr;
+USHORT                        packet_id;
+NX_PACKET                    *previous_packet_ptr;
+NX_PACKET                    *transmit_packet_ptr;
+UINT                          index;
+UINT                          keep_copy;
+#ifdef NXD_MQTT_V5_ENABLE
+UCHAR                         reason_code;
+ULONG                         bytes_copied;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-UINT    status;
-
+    response_ptr = (MQTT_PACKET_PUBLISH_RESPONSE *)(packet_ptr -> nx_packet_prepend_ptr);
 
-    NX_PARAMETER_NOT_USED(memory_ptr);
-    NX_PARAMETER_NOT_USED(memory_size);
+    /* Validate the packet. */
+#ifndef NXD_MQTT_V5_ENABLE
+    if (response_ptr -> mqtt_publish_response_packet_remaining_length != 2)
+#else
+    /* A reason code and properties may follow the packet identifier in MQTT 5. */
+    if ((response_ptr -> mqtt_publish_response_packet_remaining_length < 2) ||
+        (response_ptr -> mqtt_publish_response_packet_remaining_length & 0x80))
+#endif /* NXD_MQTT_V5_ENABLE */
+    {
+        /* Invalid remaining_length value. Return 1 so the caller can release
+           the packet. */
 
-    /* Create MQTT client.  */
-    status = _nxd_mqtt_client_create_internal(client_ptr, client_name, client_id, client_id_length, ip_ptr,
-                                              pool_ptr, stack_ptr, stack_size, mqtt_thread_priority);
+        return(1);
+    }
 
-    /* Check status.  */
-    if (status)
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Keep the reason code for the ACK notify function, zero (Success) when it is omitted. */
+    reason_code = 0;
+    if (response_ptr -> mqtt_publish_response_packet_remaining_length > 2)
     {
-        return(status);
+        nx_packet_data_extract_offset(packet_ptr, sizeof(MQTT_PACKET_PUBLISH_RESPONSE), &reason_code, 1, &bytes_copied);
     }
+    client_ptr -> nxd_mqtt_client_reason_code = reason_code;
+#endif /* NXD_MQTT_V5_ENABLE */
 
-#ifdef NXD_MQTT_CLOUD_ENABLE
+    packet_id = (USHORT)((response_ptr -> mqtt_publish_response_packet_packet_identifier_msb << 8) |
+                         (response_ptr -> mqtt_publish_response_packet_packet_identifier_lsb));
 
-    /* Create cloud helper.  */
-    status = nx_cloud_create(&(client_ptr -> nxd_mqtt_client_cloud), "Cloud Helper", stack_ptr, stack_size, mqtt_thread_priority);
+    TRACE_SWO_EVENT(TRACE_SWO_EVENT_MQTT_ACK, client_ptr, packet_id, (response_ptr -> mqtt_publish_response_packet_header) >> 4, 0)
 
-    /* Determine if an error occurred.  */
-    if (status != NX_SUCCESS)
+    switch ((response_ptr -> mqtt_publish_response_packet_header) >> 4)
     {
+    case MQTT_CONTROL_PACKET_TYPE_PUBACK:
 
-        /* Delete internal resource created in _nxd_mqtt_client_create_internal().  */
+        /* PUBACK is the response to a PUBLISH packet with QoS Level 1*/
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF6,
+                                                             (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | MQTT_PUBLISH_QOS_LEVEL_1,
+                                                             &previous_packet_ptr);
+        if (transmit_packet_ptr)
+        {
 
-        /* Delete socket.  */
-        nx_tcp_socket_delete(&(client_ptr -> nxd_mqtt_client_socket));
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
 
-        return(NXD_MQTT_INTERNAL_ERROR);
-    }
+                /* Call notify function. Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
 
-    /* Save the cloud pointer.  */
-    client_ptr -> nxd_mqtt_client_cloud_ptr = &(client_ptr -> nxd_mqtt_client_cloud);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+            _nxd_mqtt_latency_record(client_ptr, transmit_packet_ptr);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
 
-    /* Save the mutex pointer.  */
-    client_ptr -> nxd_mqtt_client_mutex_ptr = &(client_ptr -> nxd_mqtt_client_cloud.nx_cloud_mutex);
+            /* QoS Level1 message receives an ACK. */
+            /* This message can be released. */
+            _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+        }
+        break;
 
-    /* Register MQTT on cloud helper.  */
-    status = nx_cloud_module_register(client_ptr -> nxd_mqtt_client_cloud_ptr, &(client_ptr -> nxd_mqtt_client_cloud_module), client_name, NX_CLOUD_MODULE_MQTT_EVENT,
-                                      _nxd_mqtt_client_event_process, client_ptr);
+    case MQTT_CONTROL_PACKET_TYPE_PUBREC:
 
-    /* Determine if an error occurred.  */
-    if (status != NX_SUCCESS)
-    {
+        /* QoS 2 publish received by the broker, part 1. */
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF6,
+                                                             (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | MQTT_PUBLISH_QOS_LEVEL_2,
+                                                             &previous_packet_ptr);
+        if (transmit_packet_ptr)
+        {
 
-        /* Delete own created cloud.  */
-        nx_cloud_delete(&(client_ptr -> nxd_mqtt_client_cloud));
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
 
-        /* Delete internal resource created in _nxd_mqtt_client_create_internal().  */
+                /* Call notify function. Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBREC, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
 
-        /* Delete socket.  */
-        nx_tcp_socket_delete(&(client_ptr -> nxd_mqtt_client_socket));
+#ifdef NXD_MQTT_LATENCY_ENABLE
+            /* A QoS 2 message is timed to its PUBREC, the broker has it then. */
+            _nxd_mqtt_latency_record(client_ptr, transmit_packet_ptr);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
 
-        return(NXD_MQTT_INTERNAL_ERROR);
-    }
+            /* The broker owns the message now, the PUBREL stands for it from here. */
+            _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
 
-#endif /* NXD_MQTT_CLOUD_ENABLE */
+#ifdef NXD_MQTT_V5_ENABLE
+            /* A failure reason code ends the exchange. */
+            if (reason_code >= 0x80)
+            {
+                break;
+            }
+#endif /* NXD_MQTT_V5_ENABLE */
 
-    /* Update state.  */
-    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
+            /* Keep the phase in the QoS 2 table, or a copy of the PUBREL on the transmit queue
+               when there is no table or no room left in it. */
+            keep_copy = ((client_ptr -> nxd_mqtt_client_qos2_table == NX_NULL) ||
+                         _nxd_mqtt_qos2_entry_add(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREL_SENT));
 
-    /* Return.  */
-    return(NXD_MQTT_SUCCESS);
+            _nxd_mqtt_publish_response_send(client_ptr, (MQTT_CONTROL_PACKET_TYPE_PUBREL << 4) | 0x02, packet_id, keep_copy);
+        }
+        else if ((_nxd_mqtt_qos2_entry_find(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREL_SENT) <
+                  client_ptr -> nxd_mqtt_client_qos2_table_size) ||
+                 _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF0, MQTT_CONTROL_PACKET_TYPE_PUBREL << 4,
+                                                &previous_packet_ptr))
+        {
+
+            /* The broker did not get the PUBREL, send it again. */
+            _nxd_mqtt_publish_response_send(client_ptr, (MQTT_CONTROL_PACKET_TYPE_PUBREL << 4) | 0x02, packet_id, NX_FALSE);
+        }
+        break;
+
+    case MQTT_CONTROL_PACKET_TYPE_PUBREL:
+
+        /* QoS 2 publish Release received, part 2. */
+        index = _nxd_mqtt_qos2_entry_find(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREC_SENT);
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF6,
+                                                             MQTT_CONTROL_PACKET_TYPE_PUBREC << 4,
+                                                             &previous_packet_ptr);
+        if (transmit_packet_ptr || (index < client_ptr -> nxd_mqtt_client_qos2_table_size))
+        {
+
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
+
+                /* Call notify function, without a packet when the QoS 2 table holds the exchange.
+                   Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBREL, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
+
+            /* QoS Level2 message receives an ACK. */
+            if (transmit_packet_ptr)
+            {
+                _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+            }
+            else
+            {
+                _nxd_mqtt_qos2_entry_remove(client_ptr, index);
+            }
+        }
+
+        /* Send PUBCOMP, also for an exchange completed already: the broker sends the
+           PUBREL again until it gets the PUBCOMP. */
+        _nxd_mqtt_publish_response_send(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBCOMP << 4, packet_id, NX_FALSE);
+        break;
+
+    case MQTT_CONTROL_PACKET_TYPE_PUBCOMP:
+
+        /* QoS 2 publish completed by the broker, part 3. */
+        index = _nxd_mqtt_qos2_entry_find(client_ptr, packet_id, NXD_MQTT_QOS2_PUBREL_SENT);
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF0,
+                                                             MQTT_CONTROL_PACKET_TYPE_PUBREL << 4,
+                                                             &previous_packet_ptr);
+        if (transmit_packet_ptr || (index < client_ptr -> nxd_mqtt_client_qos2_table_size))
+        {
+
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
+
+                /* Call notify function, without a packet when the QoS 2 table holds the exchange.
+                   Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_PUBCOMP, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
+
+            if (transmit_packet_ptr)
+            {
+                _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+            }
+            else
+            {
+                _nxd_mqtt_qos2_entry_remove(client_ptr, index);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    /* Return 1 to release the packet.*/
+    return(1);
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_topic_filter_results_set                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sets the reason codes of a SUBACK to the     */
+/*    filters of the topic filter list still pending with its packet ID,  */
+/*    in the order they were sent.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to the SUBACK         */
+/*    packet_id                             Packet ID of the SUBACK       */
+/*    offset                                Offset of the reason codes    */
+/*    end                                   End of the MQTT packet        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_data_extract_offset         Extract a reason code         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_process_sub_unsub_ack                                     */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_topic_filter_results_set(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                               USHORT packet_id, ULONG offset, ULONG end)
+{
+NXD_MQTT_TOPIC_FILTER *filter_ptr;
+UINT                   i;
+UCHAR                  reason_code;
+ULONG                  bytes_copied;
+
+    for (i = 0; (i < client_ptr -> nxd_mqtt_client_filter_list_count) && (offset < end); i++)
+    {
+        filter_ptr = &(client_ptr -> nxd_mqtt_client_filter_list[i]);
+
+        /* Skip the filters of the other packets and those answered already.  */
+        if ((filter_ptr -> nxd_mqtt_topic_filter_packet_id != packet_id) ||
+            (filter_ptr -> nxd_mqtt_topic_filter_reason_code != NXD_MQTT_TOPIC_FILTER_PENDING))
+        {
+            continue;
+        }
+
+        if (nx_packet_data_extract_offset(packet_ptr, offset, &reason_code, 1, &bytes_copied) ||
+            (bytes_copied != 1))
+        {
+            return;
+        }
+
+        filter_ptr -> nxd_mqtt_topic_filter_reason_code = reason_code;
+        offset++;
+    }
+}
 
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_create_internal                    PORTABLE C      */
+/*    _nxd_mqtt_process_sub_unsub_ack                     PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -3120,37 +3763,31 @@ UINT    status;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function creates an instance for MQTT Client.  It initializes  */
-/*    MQTT Client control block, creates a thread, mutex and event queue  */
-/*    for MQTT Client, and creates the TCP socket for MQTT messaging.     */
-/*                                                                        */
+/*    This internal function process an ACK message for subscribe         */
+/*    or unsubscribe request.                                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    client_id                             Client ID for this instance   */
-/*    client_id_length                      Length of Client ID, in bytes */
-/*    ip_ptr                                Pointer to IP instance        */
-/*    pool_ptr                              Pointer to packet pool        */
-/*    stack_ptr                             Client thread's stack pointer */
-/*    stack_size                            Client thread's stack size    */
-/*    mqtt_thread_priority                  Priority for MQTT thread      */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    Status                                                              */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_thread_create                      Create a thread               */
-/*    tx_mutex_create                       Create mutex                  */
-/*    tx_mutex_get                                                        */
-/*    tx_mutex_put                                                        */
-/*    tx_event_flag_create                  Create event flag             */
+/*    [nxd_mqtt_client_receive_notify]      User supplied publish         */
+/*                                            callback function           */
+/*    _nxd_mqtt_release_transmit_packet                                   */
+/*                                          Release the memory block      */
+/*    _nxd_mqtt_read_remaining_length       Skip the remaining length     */
+/*                                            field                       */
+/*    _nxd_mqtt_topic_filter_results_set    Set the SUBACK reason codes   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -3158,106 +3795,125 @@ UINT    status;
 /*                                                                        */
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
 /*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected mqtt client state,*/
+/*                                            added ack receive notify,   */
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_client_create_internal(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
-                                             CHAR *client_id, UINT client_id_length,
-                                             NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
-                                             VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority)
+static UINT _nxd_mqtt_process_sub_unsub_ack(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
 {
-UINT                status;
-
-#ifdef NXD_MQTT_CLOUD_ENABLE
-    NX_PARAMETER_NOT_USED(stack_ptr);
-    NX_PARAMETER_NOT_USED(stack_size);
-    NX_PARAMETER_NOT_USED(mqtt_thread_priority);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
 
-    /* Clear the MQTT Client control block. */
-    NXD_MQTT_SECURE_MEMSET((void *)client_ptr, 0, sizeof(NXD_MQTT_CLIENT));
+USHORT     packet_id;
+NX_PACKET *previous_packet_ptr;
+NX_PACKET *transmit_packet_ptr;
+UCHAR      response_header;
+UCHAR      fixed_header;
+UINT       remaining_length;
+ULONG      offset;
+ULONG      codes_offset;
+UCHAR      bytes[2];
+ULONG      bytes_copied;
 
-#ifndef NXD_MQTT_CLOUD_ENABLE
 
-    /* Create MQTT mutex.  */
-    status = tx_mutex_create(&client_ptr -> nxd_mqtt_protection, client_name, TX_NO_INHERIT);
+    response_header = *(packet_ptr -> nx_packet_prepend_ptr);
 
-    /* Determine if an error occurred. */
-    if (status != TX_SUCCESS)
+    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset))
     {
 
-        return(NXD_MQTT_INTERNAL_ERROR);
+        /* Unable to process the sub/unsub ack.  Simply return and release the packet. */
+        return(NXD_MQTT_INVALID_PACKET);
     }
-    client_ptr -> nxd_mqtt_client_mutex_ptr = &(client_ptr -> nxd_mqtt_protection);
-
-    /* Now create MQTT client thread */
-    status = tx_thread_create(&(client_ptr -> nxd_mqtt_thread), client_name, _nxd_mqtt_thread_entry,
-                              (ULONG)client_ptr, stack_ptr, stack_size, mqtt_thread_priority, mqtt_thread_priority,
-                              NXD_MQTT_CLIENT_THREAD_TIME_SLICE, TX_DONT_START);
 
-    /* Determine if an error occurred. */
-    if (status != TX_SUCCESS)
+    /* Get packet id fields. */
+    if (nx_packet_data_extract_offset(packet_ptr, offset, &bytes, sizeof(bytes), &bytes_copied) ||
+        (bytes_copied != sizeof(bytes)))
     {
-        /* Delete the mutex. */
-        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
-
-        /* Return error code. */
-        return(NXD_MQTT_INTERNAL_ERROR);
+        return(NXD_MQTT_INVALID_PACKET);
     }
 
-    status = tx_event_flags_create(&(client_ptr -> nxd_mqtt_events), client_name);
+    packet_id = (USHORT)(((*bytes) << 8) | (*(bytes + 1)));
 
-    if (status != TX_SUCCESS)
+    /* Look up the outstanding subscribe or unsubscribe request this ACK answers. */
+    if ((response_header >> 4) == MQTT_CONTROL_PACKET_TYPE_SUBACK)
     {
-        /* Delete the mutex. */
-        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
-
-        /* Delete the thread. */
-        tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
-        
-        /* Return error code. */
-        return(NXD_MQTT_INTERNAL_ERROR);
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF0,
+                                                             MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4,
+                                                             &previous_packet_ptr);
+    }
+    else
+    {
+        transmit_packet_ptr = _nxd_mqtt_transmit_packet_find(client_ptr, packet_id, 0xF0,
+                                                             MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE << 4,
+                                                             &previous_packet_ptr);
     }
-#endif /* NXD_MQTT_CLOUD_ENABLE */
 
-    /* Record the client ID information. */
-    client_ptr -> nxd_mqtt_client_id = client_id;
-    client_ptr -> nxd_mqtt_client_id_length = client_id_length;
-    client_ptr -> nxd_mqtt_client_ip_ptr = ip_ptr;
-    client_ptr -> nxd_mqtt_client_packet_pool_ptr = pool_ptr;
-    client_ptr -> nxd_mqtt_client_name = client_name;
+    if (transmit_packet_ptr)
+    {
+        fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
 
-    /* Create the socket. */
-    status = nx_tcp_socket_create(client_ptr -> nxd_mqtt_client_ip_ptr, &(client_ptr -> nxd_mqtt_client_socket), client_ptr -> nxd_mqtt_client_name,
-                                  NX_IP_NORMAL, NX_DONT_FRAGMENT, 0x80, NXD_MQTT_CLIENT_SOCKET_WINDOW_SIZE,
-                                  NX_NULL, _mqtt_client_disconnect_callback);
+        /* Found the matching packet id */
+        if (((response_header >> 4) == MQTT_CONTROL_PACKET_TYPE_SUBACK) &&
+            ((fixed_header >> 4) == MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE))
+        {
+            /* Validate the packet, a reason code follows for each topic filter. */
+#ifndef NXD_MQTT_V5_ENABLE
+            codes_offset = offset + 2;
+            if (remaining_length < 3)
+#else
+            if ((remaining_length < 4) ||
+                _nxd_mqtt_process_properties(packet_ptr, offset + 2, offset + remaining_length,
+                                             NX_NULL, NX_NULL, &codes_offset))
+#endif /* NXD_MQTT_V5_ENABLE */
+            {
+                /* Invalid remaining_length value. */
+                return(1);
+            }
 
-    /* Determine if an error occurred. */
-    if (status != NX_SUCCESS)
-    {
-#ifndef NXD_MQTT_CLOUD_ENABLE
-        /* Delete the mutex. */
-        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
+            /* Hand the reason codes to the topic filter list.  */
+            _nxd_mqtt_topic_filter_results_set(client_ptr, packet_ptr, packet_id, codes_offset, offset + remaining_length);
 
-        /* Delete the event flags. */
-        tx_event_flags_delete(&(client_ptr -> nxd_mqtt_events));
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
 
-        /* Delete the thread. */
-        tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
-#endif /* NXD_MQTT_CLOUD_ENABLE */
+                /* Call notify function. Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_SUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
 
-        return(NXD_MQTT_INTERNAL_ERROR);
-    }
+            /* Release the transmit packet. */
+            _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
 
-    /* Record the client_ptr in the socket structure. */
-    client_ptr -> nxd_mqtt_client_socket.nx_tcp_socket_reserved_ptr = (VOID *)client_ptr;
+            return(1);
+        }
+        else if (((response_header >> 4) == MQTT_CONTROL_PACKET_TYPE_UNSUBACK) &&
+                 ((fixed_header >> 4) == MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE))
+        {
+            /* Validate the packet. */
+#ifndef NXD_MQTT_V5_ENABLE
+            if (remaining_length != 2)
+#else
+            if (remaining_length < 4)
+#endif /* NXD_MQTT_V5_ENABLE */
+            {
+                /* Invalid remaining_length value. */
+                return(1);
+            }
 
-#ifndef NXD_MQTT_CLOUD_ENABLE
-    /* Start MQTT thread. */
-    tx_thread_resume(&(client_ptr -> nxd_mqtt_thread));
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-    return(NXD_MQTT_SUCCESS);
+            /* Check ack notify function.  */
+            if (client_ptr -> nxd_mqtt_ack_receive_notify)
+            {
+
+                /* Call notify function. Note: user routine should not release the packet.  */
+                client_ptr -> nxd_mqtt_ack_receive_notify(client_ptr, MQTT_CONTROL_PACKET_TYPE_UNSUBACK, packet_id, transmit_packet_ptr, client_ptr -> nxd_mqtt_ack_receive_context);
+            }
+
+            /* Unsubscribe succeeded. */
+            /* Release the transmit packet. */
+            _nxd_mqtt_release_transmit_packet(client_ptr, transmit_packet_ptr, previous_packet_ptr);
+
+            return(1);
+        }
+    }
+    return(1);
 }
 
 
@@ -3265,7 +3921,7 @@ UINT                status;
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_login_set                          PORTABLE C      */
+/*    _nxd_mqtt_process_pingresp                          PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -3273,35 +3929,25 @@ UINT                status;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sets optional MQTT username and password.  Note       */
-/*    if the broker requires username and password, this information      */
-/*    must be set prior to calling nxd_mqtt_client_connect or             */
-/*    nxd_mqtt_client_secure_connect.                                     */
-/*                                                                        */
+/*    This internal function process a PINGRESP message.                  */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    username                              User name, or NULL if user    */
-/*                                            name is not required        */
-/*    username_length                       Length of the user name, or   */
-/*                                            0 if user name is NULL      */
-/*    password                              Password string, or NULL if   */
-/*                                            password is not required    */
-/*    password_length                       Length of the password, or    */
-/*                                            0 if password is NULL       */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    Status                                                              */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_mutex_get                                                        */
+/*    None                                                                */
+/*                                            callback function           */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -3312,33 +3958,27 @@ UINT                status;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
-                                CHAR *username, UINT username_length, CHAR *password, UINT password_length)
+static VOID _nxd_mqtt_process_pingresp(NXD_MQTT_CLIENT *client_ptr)
 {
-UINT status;
 
-    /* Obtain the mutex. */
-    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    if (status != TX_SUCCESS)
+    /* If there is an outstanding ping, mark it as responded. */
+    if (client_ptr -> nxd_mqtt_ping_not_responded == NX_TRUE)
     {
-        return(NXD_MQTT_MUTEX_FAILURE);
-    }
-    client_ptr -> nxd_mqtt_client_username = username;
-    client_ptr -> nxd_mqtt_client_username_length = (USHORT)username_length;
-    client_ptr -> nxd_mqtt_client_password = password;
-    client_ptr -> nxd_mqtt_client_password_length = (USHORT)password_length;
+        client_ptr -> nxd_mqtt_ping_not_responded = NX_FALSE;
 
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        client_ptr -> nxd_mqtt_ping_sent_time = 0;
+    }
 
-    return(NX_SUCCESS);
+    return;
 }
 
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_will_message_set                   PORTABLE C      */
+/*    _nxd_mqtt_process_disconnect                        PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -3346,39 +3986,29 @@ UINT status;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sets optional MQTT will topic and will message.       */
-/*    Note that if will message is needed, application must set will      */
-/*    message prior to calling nxd_mqtt_client_connect or                 */
-/*    nxd_mqtt_client_secure_connect.                                     */
-/*                                                                        */
+/*    This internal function process a DISCONNECT message.                */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    will_topic                            Will topic string.            */
-/*    will_topic_length                     Length of the will topic.     */
-/*    will_message                          Will message string.          */
-/*    will_message_length                   Length of the will message.   */
-/*    will_retain_flag                      Whether or not the will       */
-/*                                            message is to be retained   */
-/*                                            when it is published.       */
-/*                                            Valid values are NX_TRUE    */
-/*                                            NX_FALSE                    */
-/*    will_QoS                              QoS level to be used when     */
-/*                                            publishing will message.    */
-/*                                            Valid values are 0, 1, 2    */
+/*    packet_ptr                            Pointer to the packet         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_mutex_get                                                        */
+/*   nx_secure_tls_session_send                                           */
+/*   nx_tcp_socket_disconnect                                             */
+/*   nx_tcp_client_socket_unbind                                          */
+/*   _nxd_mqtt_release_transmit_packet                                    */
+/*   _nxd_mqtt_release_receive_packet                                     */
+/*   _nxd_mqtt_client_connection_end                                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*   _nxd_mqtt_packet_receive_process                                     */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -3389,151 +4019,135 @@ UINT status;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
-                                       const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
-                                       UINT will_message_length, UINT will_retain_flag, UINT will_QoS)
+static VOID _nxd_mqtt_process_disconnect(NXD_MQTT_CLIENT *client_ptr)
 {
-UINT status;
+NX_PACKET  *previous = NX_NULL;
+NX_PACKET  *current;
+NX_PACKET  *next;
+UINT        disconnect_callback = NX_FALSE;
+UINT        status;
+UCHAR       fixed_header;
 
-    if (will_QoS == 2)
+    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
     {
-        return(NXD_MQTT_QOS2_NOT_SUPPORTED);
+        /* State changes from CONNECTED TO IDLE.  Call disconnect notify callback
+           if the function is set. */
+        disconnect_callback = NX_TRUE;
     }
-
-    /* Obtain the mutex. */
-    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-    if (status != TX_SUCCESS)
+    else if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTING)
     {
-        return(NXD_MQTT_MUTEX_FAILURE);
+
+        /* If state isn't CONNECTED or CONNECTING, just return. */
+        return;
     }
 
-    client_ptr -> nxd_mqtt_client_will_topic = will_topic;
-    client_ptr -> nxd_mqtt_client_will_topic_length = will_topic_length;
-    client_ptr -> nxd_mqtt_client_will_message = will_message;
-    client_ptr -> nxd_mqtt_client_will_message_length = will_message_length;
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-    if (will_retain_flag == NX_TRUE)
+    /* End connection. */
+    _nxd_mqtt_client_connection_end(client_ptr, NXD_MQTT_SOCKET_TIMEOUT);
+
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+
+    /* Free up sub/unsub packets on the transmit queue. */
+    current = client_ptr -> message_transmit_queue_head;
+
+    while (current)
     {
-        client_ptr -> nxd_mqtt_client_will_qos_retain = 0x80;
-    }
-    client_ptr -> nxd_mqtt_client_will_qos_retain = (UCHAR)(client_ptr -> nxd_mqtt_client_will_qos_retain | will_QoS);
+        next = current -> nx_packet_queue_next;
+        fixed_header = *(current -> nx_packet_prepend_ptr);
 
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        if (((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4)) ||
+            ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE << 4)))
+        {
+            _nxd_mqtt_release_transmit_packet(client_ptr, current, previous);
+        }
+        else
+        {
+            previous = current;
+        }
+        current = next;
+    }
 
-    return(NX_SUCCESS);
-}
+    /* If a callback notification is defined, call it now. */
+    if ((disconnect_callback == NX_TRUE) && (client_ptr -> nxd_mqtt_disconnect_notify))
+    {
+        client_ptr -> nxd_mqtt_disconnect_notify(client_ptr);
+    }
 
+    /* If a connect callback notification is defined and is still in connecting stage, call it now. */
+    if ((disconnect_callback == NX_FALSE) && (client_ptr -> nxd_mqtt_connect_notify))
+    {
+        client_ptr -> nxd_mqtt_connect_notify(client_ptr, NXD_MQTT_CONNECT_FAILURE, client_ptr -> nxd_mqtt_connect_context);
+    }
 
-/**************************************************************************/
-/*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_will_message_set                  PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
-/*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
-/*                                                                        */
-/*  DESCRIPTION                                                           */
-/*                                                                        */
-/*    This function checks for errors in the                              */
-/*    nxd_mqtt_client_will_message_set call.                              */
-/*                                                                        */
-/*                                                                        */
-/*  INPUT                                                                 */
-/*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
-/*    will_topic                            Will topic string.            */
-/*    will_topic_length                     Length of the will topic.     */
-/*    will_message                          Will message string.          */
-/*    will_message_length                   Length of the will message.   */
-/*    will_retain_flag                      Whether or not the will       */
-/*                                            message is to be retained   */
-/*                                            when it is published.       */
-/*                                            Valid values are NX_TRUE    */
-/*                                            NX_FALSE                    */
-/*    will_QoS                              QoS level to be used when     */
-/*                                            publishing will message.    */
-/*                                            Valid values are 0, 1, 2    */
-/*                                                                        */
-/*  OUTPUT                                                                */
-/*                                                                        */
-/*    status                                Completion status             */
-/*                                                                        */
-/*  CALLS                                                                 */
-/*                                                                        */
-/*    _nxd_mqtt_client_will_message_set                                   */
-/*                                                                        */
-/*  CALLED BY                                                             */
-/*                                                                        */
-/*    Application Code                                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
-/**************************************************************************/
-UINT _nxde_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
-                                        const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
-                                        UINT will_message_length, UINT will_retain_flag, UINT will_QoS)
-{
-
-    if (client_ptr == NX_NULL)
+    if (status == TX_SUCCESS)
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        /* Remove all the packets in the receive queue. */
+        while (client_ptr -> message_receive_queue_head)
+        {
+            _nxd_mqtt_release_receive_packet(client_ptr, client_ptr -> message_receive_queue_head, NX_NULL);
+        }
+        client_ptr -> message_receive_queue_depth = 0;
+        client_ptr -> message_receive_queue_bytes = 0;
+        client_ptr -> nxd_mqtt_client_receive_paused = NX_FALSE;
+
+        /* Clear the MQTT_PACKET_RECEIVE_EVENT */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+        tx_event_flags_set(&client_ptr -> nxd_mqtt_events, ~MQTT_PACKET_RECEIVE_EVENT, TX_AND);
+#else
+        nx_cloud_module_event_clear(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PACKET_RECEIVE_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
     }
 
-    /* Valid will_topic string.  The will topic string cannot be NULL. */
-    if ((will_topic == NX_NULL) || (will_topic_length  == 0))
+    /* Clear flags if keep alive is enabled. */
+    if (client_ptr -> nxd_mqtt_keepalive)
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        client_ptr -> nxd_mqtt_ping_not_responded = 0;
+        client_ptr -> nxd_mqtt_ping_sent_time = 0;
     }
 
-    if ((will_retain_flag != NX_TRUE) && (will_retain_flag != NX_FALSE))
+    /* Clean up the information when disconnecting, the CONNECT cache holding it included. */
+    if (client_ptr -> nxd_mqtt_client_username || client_ptr -> nxd_mqtt_client_will_topic)
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        client_ptr -> nxd_mqtt_client_connect_cache_length = 0;
     }
+    client_ptr -> nxd_mqtt_client_username = NX_NULL;
+    client_ptr -> nxd_mqtt_client_password = NX_NULL;
+    client_ptr -> nxd_mqtt_client_will_topic = NX_NULL;
+    client_ptr -> nxd_mqtt_client_will_message = NX_NULL;
+    client_ptr -> nxd_mqtt_client_will_qos_retain = 0;
 
-    if (will_QoS > 2)
+    /* Release current processing packet. */
+    if (client_ptr -> nxd_mqtt_client_processing_packet)
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        nx_packet_release(client_ptr -> nxd_mqtt_client_processing_packet);
+        client_ptr -> nxd_mqtt_client_processing_packet = NX_NULL;
     }
+    client_ptr -> nxd_mqtt_client_processing_length = 0;
 
-    return(_nxd_mqtt_client_will_message_set(client_ptr, will_topic, will_topic_length, will_message,
-                                             will_message_length, will_retain_flag, will_QoS));
+    return;
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_login_set                         PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_message_length_get                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in the nxd_mqtt_client_login call.  */
-/*                                                                        */
+/*    This internal function decodes the fixed header at the start of a   */
+/*    partial incoming message and returns the length of the whole        */
+/*    message, so that the receive loop waits for it without parsing the  */
+/*    header again on each segment.                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
-/*    username                              User name, or NULL if user    */
-/*                                            name is not required        */
-/*    username_length                       Length of the user name, or   */
-/*                                            0 if user name is NULL      */
-/*    password                              Password string, or NULL if   */
-/*                                            password is not required    */
-/*    password_length                       Length of the password, or    */
-/*                                            0 if password is NULL       */
+/*    packet_ptr                            Incoming MQTT packet          */
+/*    message_length_ptr                    Pointer to the length of the  */
+/*                                            message, fixed header       */
+/*                                            included                    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -3541,38 +4155,41 @@ UINT _nxde_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_login_set                                          */
+/*    nx_packet_data_extract_offset                                       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nxd_mqtt_packet_receive_process                                    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
-                                 CHAR *username, UINT username_length, CHAR *password, UINT password_length)
+static UINT _nxd_mqtt_message_length_get(NX_PACKET *packet_ptr, ULONG *message_length_ptr)
 {
-    if (client_ptr == NX_NULL)
+ULONG  value = 0;
+UCHAR  bytes[4] = {0};
+UINT   shift = 0;
+UINT   byte_count = 0;
+ULONG  bytes_copied;
+
+    if (nx_packet_data_extract_offset(packet_ptr, 1, &bytes, sizeof(bytes), &bytes_copied))
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        return(NXD_MQTT_PARTIAL_PACKET);
     }
 
-    /* Username and username length don't match,
-       or password and password length don't match. */
-    if (((username == NX_NULL) && (username_length != 0)) ||
-        ((password == NX_NULL) && (password_length != 0)))
+    do
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
-    }
+        if (byte_count >= bytes_copied)
+        {
 
-    return(_nxd_mqtt_client_login_set(client_ptr, username, username_length, password, password_length));
+            /* The remaining length is not in yet, or longer than 4 bytes. */
+            return(NXD_MQTT_PARTIAL_PACKET);
+        }
+        value += (ULONG)(bytes[byte_count] & 0x7F) << shift;
+        shift += 7;
+    } while (bytes[byte_count++] & 0x80);
+
+    *message_length_ptr = 1 + byte_count + value;
+
+    return(NXD_MQTT_SUCCESS);
 }
 
 
@@ -3580,7 +4197,7 @@ UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_retransmit_message                 PORTABLE C      */
+/*    _nxd_mqtt_packet_receive_process                    PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -3588,32 +4205,39 @@ UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function retransmit QoS1 messages upon reconnection, if the    */
-/*    connection is not set CLEAN_SESSION.                                */
+/*    This internal function process MQTT message.                        */
+/*    NOTE: MQTT Mutex is NOT obtained on entering this function.         */
+/*    Therefore it shouldn't hold the mutex when it exists this function. */
 /*                                                                        */
+/*    A message split across TCP segments or TLS records waits in         */
+/*    nxd_mqtt_client_processing_packet, the segments that follow are     */
+/*    linked to it as they come. Its length is decoded once, as soon as   */
+/*    its fixed header is in, and the next segments are only counted      */
+/*    against it until the message is complete.                           */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    wait_option                           Timeout value                 */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_mutex_get                                                        */
-/*    tx_mutex_put                                                        */
-/*    nx_secure_tls_session_send                                          */
-/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_receive                                       */
+/*    nx_tcp_socket_receive                                               */
+/*    _nxd_mqtt_message_length_get                                        */
+/*    _nxd_mqtt_process_publish                                           */
+/*    _nxd_mqtt_process_publish_response                                  */
+/*    _nxd_mqtt_process_sub_unsub_ack                                     */
+/*    _nxd_mqtt_process_pingresp                                          */
+/*    _nxd_mqtt_process_disconnect                                        */
 /*    nx_packet_release                                                   */
-/*    tx_time_get                                                         */
-/*    nx_packet_copy                                                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*    _nxd_mqtt_client_event_process                                      */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -3624,426 +4248,6643 @@ UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_client_retransmit_message(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+static VOID _nxd_mqtt_packet_receive_process(NXD_MQTT_CLIENT *client_ptr)
 {
-NX_PACKET          *transmit_packet_ptr;
-NX_PACKET          *packet_ptr;
-UINT                status = NXD_MQTT_SUCCESS;
-UINT                mutex_status;
-UCHAR               fixed_header;
-
-    transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
+NX_PACKET *packet_ptr;
+NX_PACKET *previous_packet_ptr;
+UINT       status;
+UCHAR      packet_type;
+UINT       remaining_length;
+UINT       packet_consumed;
+ULONG      offset;
+ULONG      bytes_copied;
+ULONG      packet_length;
 
-    while (transmit_packet_ptr)
+    for (;;)
     {
-        fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
 
-        if ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4))
+        /* Leave the data in the TCP receive queue while the receive queue is full, the
+           window closes and the broker waits. Taking a message resumes the reading. */
+        if ((client_ptr -> nxd_mqtt_client_receive_queue_policy == NXD_MQTT_RECEIVE_QUEUE_BACKPRESSURE) &&
+            _nxd_mqtt_receive_queue_full(client_ptr, 1))
         {
+            client_ptr -> nxd_mqtt_client_receive_paused = NX_TRUE;
+            break;
+        }
 
-            /* Retransmit publish packet only. */
-            /* Obtain a NetX Packet. */
-            status = nx_packet_copy(transmit_packet_ptr, &packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
-
-            if (status != NXD_MQTT_SUCCESS)
-            {
-                return(NXD_MQTT_PACKET_POOL_FAILURE);
-            }
-
-            /* Release the mutex. */
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        /* Release the mutex. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-            /* Send the packet. */
+        /* Make a receive call. */
 #ifdef NX_SECURE_ENABLE
-            if (client_ptr -> nxd_mqtt_client_use_tls)
-            {
-                status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
-            }
-            else
-            {
-                status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
-            }
+        if (client_ptr -> nxd_mqtt_client_use_tls)
+        {
+            status = nx_secure_tls_session_receive(&(client_ptr -> nxd_mqtt_tls_session), &packet_ptr, NX_NO_WAIT);
+        }
+        else
+        {
+            status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, NX_NO_WAIT);
+        }
 #else
-            status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
-
+        status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, NX_NO_WAIT);
 #endif /* NX_SECURE_ENABLE */
 
-            if (status)
+        if (status != NX_SUCCESS)
+        {
+            if (status != NX_NO_PACKET)
             {
-                /* Release the packet. */
-                nx_packet_release(packet_ptr);
 
-                status = NXD_MQTT_COMMUNICATION_FAILURE;
+                /* Network issue. Close the MQTT session. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+                _nxd_mqtt_client_events_set(client_ptr, MQTT_NETWORK_DISCONNECT_EVENT);
+#else
+                nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_NETWORK_DISCONNECT_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
             }
-            /* Obtain the mutex. */
-            mutex_status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, wait_option);
 
-            if (mutex_status != TX_SUCCESS)
-            {
-                return(NXD_MQTT_MUTEX_FAILURE);
-            }
-            if (status)
-            {
-                return(status);
-            }
+            break;
         }
-        transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
-    }
 
-    /* Update the timeout value. */
-    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+        /* Obtain the mutex. */
+        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    return(status);
+        /* Is there a packet waiting for processing? */
+        if (client_ptr -> nxd_mqtt_client_processing_packet)
+        {
+
+            /* Yes. Link received packet to existing one. */
+            if (client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last)
+            {
+                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last -> nx_packet_next = packet_ptr;
+            }
+            else
+            {
+                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_next = packet_ptr;
+            }
+            if (packet_ptr -> nx_packet_last)
+            {
+                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last = packet_ptr -> nx_packet_last;
+            }
+            else
+            {
+                client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_last = packet_ptr;
+            }
+            client_ptr -> nxd_mqtt_client_processing_packet -> nx_packet_length += packet_ptr -> nx_packet_length;
+
+            /* Start to process existing packet. */
+            packet_ptr = client_ptr -> nxd_mqtt_client_processing_packet;
+            client_ptr -> nxd_mqtt_client_processing_packet = NX_NULL;
+        }
+
+        /* Check notify function.  */
+        if (client_ptr -> nxd_mqtt_packet_receive_notify)
+        {
+
+            /* Call notify function. Return NX_TRUE if the packet has been consumed.  */
+            if (client_ptr -> nxd_mqtt_packet_receive_notify(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_packet_receive_context) == NX_TRUE)
+            {
+
+                /* The waiting message went with it. */
+                client_ptr -> nxd_mqtt_client_processing_length = 0;
+                continue;
+            }
+        }
+
+        packet_consumed = NX_FALSE;
+        while (packet_ptr)
+        {
+
+            /* The length of a waiting message is known, keep waiting without parsing it again. */
+            if (client_ptr -> nxd_mqtt_client_processing_length > packet_ptr -> nx_packet_length)
+            {
+                client_ptr -> nxd_mqtt_client_processing_packet = packet_ptr;
+                packet_consumed = NX_TRUE;
+                break;
+            }
+            client_ptr -> nxd_mqtt_client_processing_length = 0;
+
+            /* Parse the incoming packet. */
+            status = _nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset);
+            if (status == NXD_MQTT_PARTIAL_PACKET)
+            {
+
+                /* We only have partial MQTT message. 
+                 * Put it to waiting list for more packets. */
+                client_ptr -> nxd_mqtt_client_processing_packet = packet_ptr;
+                packet_consumed = NX_TRUE;
+
+                /* Remember its length when the fixed header is complete. */
+                if (_nxd_mqtt_message_length_get(packet_ptr, &packet_length) == NXD_MQTT_SUCCESS)
+                {
+                    client_ptr -> nxd_mqtt_client_processing_length = packet_length;
+                }
+                break;
+            }
+            else if (status)
+            {
+                
+                /* Invalid packet. */
+                break;
+            }
+
+            /* Get packet type. */
+            if (nx_packet_data_extract_offset(packet_ptr, 0, &packet_type, 1, &bytes_copied))
+            {
+
+                /* Unable to read packet type. */
+                break;
+            }
+
+            /* Right shift 4 bits to get the packet type. */
+            packet_type = packet_type >> 4;
+
+            /* Process based on packet type. */
+            switch (packet_type)
+            {
+            case MQTT_CONTROL_PACKET_TYPE_CONNECT:
+                /* Client does not accept connections.  Nothing needs to be done. */
+                break;
+            case MQTT_CONTROL_PACKET_TYPE_CONNACK:
+                _nxd_mqtt_process_connack(client_ptr, packet_ptr, NX_NO_WAIT);
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_PUBLISH:
+                packet_consumed = _nxd_mqtt_process_publish(client_ptr, packet_ptr);
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_PUBACK:
+            case MQTT_CONTROL_PACKET_TYPE_PUBREC:
+            case MQTT_CONTROL_PACKET_TYPE_PUBREL:
+            case MQTT_CONTROL_PACKET_TYPE_PUBCOMP:
+                _nxd_mqtt_process_publish_response(client_ptr, packet_ptr);
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE:
+            case MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE:
+                /* Client should not process subscribe or unsubscribe message. */
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_SUBACK:
+            case MQTT_CONTROL_PACKET_TYPE_UNSUBACK:
+                _nxd_mqtt_process_sub_unsub_ack(client_ptr, packet_ptr);
+                break;
+
+
+            case MQTT_CONTROL_PACKET_TYPE_PINGREQ:
+                /* Client is not supposed to receive ping req.  Ignore it. */
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_PINGRESP:
+                _nxd_mqtt_process_pingresp(client_ptr);
+                break;
+
+            case MQTT_CONTROL_PACKET_TYPE_DISCONNECT:
+                _nxd_mqtt_process_disconnect(client_ptr);
+                break;
+
+            default:
+                /* Unknown type. */
+                break;
+            }
+
+            if (packet_consumed)
+            {
+                break;
+            }
+
+            /* Trim current packet. */
+            offset += remaining_length;
+            packet_length = packet_ptr -> nx_packet_length;
+            if (packet_length > offset)
+            {
+
+                /* Multiple MQTT message in one packet. */
+                packet_length = packet_ptr -> nx_packet_length - offset;
+                while ((ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) <= offset)
+                {
+                    offset -= (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+
+                    /* Current packet can be released. */
+                    previous_packet_ptr = packet_ptr;
+                    packet_ptr = packet_ptr -> nx_packet_next;
+                    previous_packet_ptr -> nx_packet_next = NX_NULL;
+                    nx_packet_release(previous_packet_ptr);
+                    if (packet_ptr == NX_NULL)
+                    {
+
+                        /* Invalid packet. */
+                        break;
+                    }
+                }
+
+                if (packet_ptr)
+                {
+
+                    /* Adjust current packet. */
+                    packet_ptr -> nx_packet_prepend_ptr = packet_ptr -> nx_packet_prepend_ptr + offset;
+                    packet_ptr -> nx_packet_length = packet_length;
+                }
+            }
+            else
+            {
+
+                /* All messages in current packet is processed. */
+                break;
+            }
+        }
+
+        if (!packet_consumed)
+        {
+            nx_packet_release(packet_ptr);
+        }
+    }
+
+    /* No more data in the receive queue.  Return. */
+
+    return;
 }
 
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect                            PORTABLE C      */
-/*                                                           6.1.8        */
+/*    _nxd_mqtt_tcp_establish_process                     PORTABLE C      */
+/*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    Yuxin Zhou, Microsoft Corporation                                   */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function makes an initial connection to the MQTT server.       */
-/*                                                                        */
+/*    This function processes MQTT TCP connection establish event.        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    server_ip                             Server IP address structure   */
-/*    server_port                           Server port number, in host   */
-/*                                            byte order                  */
-/*    keepalive                             Keepalive flag                */
-/*    clean_session                         Clean session flag            */
-/*    wait_option                           Timeout value                 */
-/*                                                                        */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                Completion status             */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_mutex_get                                                        */
-/*    nx_tcp_socket_create                  Create TCP socket             */
-/*    nx_tcp_socket_receive_notify                                        */
-/*    nx_tcp_client_socket_bind                                           */
-/*    nxd_tcp_client_socket_connect                                       */
-/*    nx_tcp_client_socket_unbind                                         */
-/*    tx_mutex_put                                                        */
 /*    nx_secure_tls_session_start                                         */
-/*    nx_secure_tls_session_send                                          */
-/*    nx_secure_tls_session_receive                                       */
-/*    _nxd_mqtt_packet_allocate                                           */
-/*    _nxd_mqtt_client_set_fixed_header                                   */
-/*    _nxd_mqtt_client_append_message                                     */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_packet_release                                                   */
-/*    nx_tcp_socket_receive                                               */
-/*    tx_event_flag_set                                                   */
-/*    _nxd_mqtt_release_transmit_packet                                   */
-/*    tx_timer_create                                                     */
-/*    nx_secure_tls_session_receive                                       */
 /*    _nxd_mqtt_client_connection_end                                     */
+/*    _nxd_mqtt_client_connect_packet_send                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
+/*    _nxd_mqtt_client_event_process                                      */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            fixed return value when it  */
-/*                                            is set in CONNACK, corrected*/
-/*                                            mqtt client state,          */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
-/*  08-02-2021     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected the logic for     */
-/*                                            non-blocking mode,          */
-/*                                            resulting in version 6.1.8  */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
-                              UINT keepalive, UINT clean_session, ULONG wait_option)
+static VOID _nxd_mqtt_tcp_establish_process(NXD_MQTT_CLIENT *client_ptr)
 {
-NX_PACKET           *packet_ptr;
-UINT                 status;
-TX_THREAD           *thread_ptr;
-UINT                 new_priority;
-UINT                 old_priority;
+UINT       status;
 
 
-    /* Obtain the mutex. */
-    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    /* TCP connection is established.  */
 
-    if (status != TX_SUCCESS)
-    {
+    /* If TLS is enabled, start TLS */
 #ifdef NX_SECURE_ENABLE
-        if (client_ptr -> nxd_mqtt_client_use_tls)
-        {
-            nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
-        }
-#endif /* NX_SECURE_ENABLE */
-
-        return(NXD_MQTT_MUTEX_FAILURE);
-    }
-
-    /* Do nothing if the client is already connected. */
-    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
-    {
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-        return(NXD_MQTT_ALREADY_CONNECTED);
-    }
-
-    /* Check if client is connecting. */
-    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTING)
+    if (client_ptr -> nxd_mqtt_client_use_tls)
     {
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-        return(NXD_MQTT_CONNECTING);
-    }
+        status = nx_secure_tls_session_start(&(client_ptr -> nxd_mqtt_tls_session), &(client_ptr -> nxd_mqtt_client_socket), NX_NO_WAIT);
 
-    /* Client state must be in IDLE.  */
-    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_IDLE)
-    {
-#ifdef NX_SECURE_ENABLE
-        if (client_ptr -> nxd_mqtt_client_use_tls)
+        if (status != NX_CONTINUE)
         {
-            nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
-        }
-#endif /* NX_SECURE_ENABLE */
-        return(NXD_MQTT_INVALID_STATE);
-    }
-
-#if defined(NX_SECURE_ENABLE) && defined(NXD_MQTT_REQUIRE_TLS)
-    if (!client_ptr -> nxd_mqtt_client_use_tls)
-    {
-
-        /* NXD_MQTT_REQUIRE_TLS is defined but the application does not use TLS.
-           This is security violation.  Return with failure code. */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-        return(NXD_MQTT_CONNECT_FAILURE);
-    }
-#endif /* NX_SECURE_ENABLE && NXD_MQTT_REQUIRE_TLS*/
 
-    /* Record the keepalive value, converted to TX timer ticks. */
-    client_ptr -> nxd_mqtt_keepalive = keepalive * NX_IP_PERIODIC_RATE;
-    if (keepalive)
-    {
-        client_ptr -> nxd_mqtt_timer_value = NXD_MQTT_KEEPALIVE_TIMER_RATE;
-        client_ptr -> nxd_mqtt_ping_timeout = NXD_MQTT_PING_TIMEOUT_DELAY;
+            /* End connection. */
+            _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
 
-        /* Create timer */
-        status = tx_timer_create(&(client_ptr -> nxd_mqtt_timer), "MQTT Timer", _nxd_mqtt_periodic_timer_entry, (ULONG)client_ptr,
-                                 client_ptr -> nxd_mqtt_timer_value, client_ptr -> nxd_mqtt_timer_value, TX_AUTO_ACTIVATE);
-        if (status)
-        {
-#ifdef NX_SECURE_ENABLE
-            if (client_ptr -> nxd_mqtt_client_use_tls)
+            /* Check callback function.  */
+            if (client_ptr -> nxd_mqtt_connect_notify)
             {
-                nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
+                client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
             }
-#endif /* NX_SECURE_ENABLE */
 
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-            return(NXD_MQTT_INTERNAL_ERROR);
+            return;
         }
-    }
-    else
-    {
-        client_ptr -> nxd_mqtt_timer_value = 0;
-        client_ptr -> nxd_mqtt_ping_timeout = 0;
-    }
-
-    /* Record the clean session flag.  */
-    client_ptr -> nxd_mqtt_clean_session = clean_session;
-
-    /* Set TCP connection establish notify for non-blocking mode.  */
-    if (wait_option == 0)
-    {
-        status = nx_tcp_socket_establish_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_tcp_establish_notify);
 
-        /* Check status.  */
-        if (status != NX_SUCCESS)
-        {
-#ifdef NX_SECURE_ENABLE
-            if (client_ptr -> nxd_mqtt_client_use_tls)
-            {
-                nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
-            }
-#endif /* NX_SECURE_ENABLE */
-            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-            return(status);
-        }
+        /* TLS in progress.  */
+        client_ptr -> nxd_mqtt_tls_in_progress = NX_TRUE;
 
-        /* Set the receive callback. */
-        nx_tcp_socket_receive_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_receive_callback);
+        return;
     }
-    else
-    {
+#endif /* NX_SECURE_ENABLE */
 
-        /* Clean receive callback.  */
-        client_ptr -> nxd_mqtt_client_socket.nx_tcp_receive_callback = NX_NULL;
-    }
+    /* Start to send MQTT connect packet.  */
+    status = _nxd_mqtt_client_connect_packet_send(client_ptr, NX_NO_WAIT);
 
-    /* Release mutex */
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    /* Check status.  */
+    if (status)
+    {
 
-    /* First attempt to bind the client socket. */
-    status = nx_tcp_client_socket_bind(&(client_ptr -> nxd_mqtt_client_socket), NX_ANY_PORT, wait_option);
+        /* End connection. */
+        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
 
-    if (status != NX_SUCCESS)
-    {
-#ifdef NX_SECURE_ENABLE
-        if (client_ptr -> nxd_mqtt_client_use_tls)
+        /* Check callback function.  */
+        if (client_ptr -> nxd_mqtt_connect_notify)
         {
-            nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
+            client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
         }
-#endif /* NX_SECURE_ENABLE */
-        tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
-        return(NXD_MQTT_INTERNAL_ERROR);
     }
+}
 
-    /* Obtain the mutex. */
-    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-    /* Make state as NXD_MQTT_CLIENT_STATE_CONNECTING. */
-    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_CONNECTING;
-
-    /* Release mutex. */
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-    /* Connect to the MQTT server */
-    status = nxd_tcp_client_socket_connect(&(client_ptr -> nxd_mqtt_client_socket), server_ip, server_port, wait_option);
-    if ((status != NX_SUCCESS) && (status != NX_IN_PROGRESS))
-    {
-
-        /* Obtain the mutex. */
-        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-        /* Make state as NXD_MQTT_CLIENT_STATE_IDLE. */
-        client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
-
-        /* Release mutex. */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
 #ifdef NX_SECURE_ENABLE
-        if (client_ptr -> nxd_mqtt_client_use_tls)
-        {
-            nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
-        }
-#endif /* NX_SECURE_ENABLE */
-        nx_tcp_client_socket_unbind(&(client_ptr -> nxd_mqtt_client_socket));
-        tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
-        return(NXD_MQTT_CONNECT_FAILURE);
-    }
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_tls_establish_process                     PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes TLS connection establish event. One TLS     */
+/*    record is processed per event, so that the other events of the      */
+/*    client are serviced between the public key operations of the        */
+/*    handshake. While records are pending the event is set again.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_secure_tls_session_handshake_step                                */
+/*    _nxd_mqtt_client_connect_packet_send                                */
+/*    _nxd_mqtt_client_connection_end                                     */
+/*    tx_event_flags_set                                                  */
+/*    nx_cloud_module_event_set                                           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_event_process                                      */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_tls_establish_process(NXD_MQTT_CLIENT *client_ptr)
+{
+UINT       status;
 
-    /* Just return for non-blocking mode.  */
-    if ((status == NX_IN_PROGRESS) || (wait_option == 0))
+
+    /* Step the handshake by one record for async mode. */
+    status = nx_secure_tls_session_handshake_step(&(client_ptr -> nxd_mqtt_tls_session));
+    if (status == NX_IN_PROGRESS)
     {
-        return(NX_IN_PROGRESS);
-    }
 
-    /* Increase priority to the same of internal thread to avoid out of order packet process. */
+        /* More records pending, process them on the next event. */
 #ifndef NXD_MQTT_CLOUD_ENABLE
-    thread_ptr = &(client_ptr -> nxd_mqtt_thread);
+        _nxd_mqtt_client_events_set(client_ptr, MQTT_PACKET_RECEIVE_EVENT);
 #else
-    thread_ptr = &(client_ptr -> nxd_mqtt_client_cloud_ptr -> nx_cloud_thread);
+        nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PACKET_RECEIVE_EVENT);
 #endif /* NXD_MQTT_CLOUD_ENABLE */
-    tx_thread_info_get(thread_ptr, NX_NULL, NX_NULL, NX_NULL, 
-                       &new_priority, NX_NULL, NX_NULL, NX_NULL, NX_NULL);
-    tx_thread_priority_change(tx_thread_identify(), new_priority, &old_priority);
-
-    /* If TLS is enabled, start TLS */
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
+    }
+    else if (status == NX_SUCCESS)
     {
 
-        status = nx_secure_tls_session_start(&(client_ptr -> nxd_mqtt_tls_session), &(client_ptr -> nxd_mqtt_client_socket), wait_option);
+        /* TLS session established.   */
+        client_ptr -> nxd_mqtt_tls_in_progress= NX_FALSE;
 
-        if (status != NX_SUCCESS)
-        {
+        /* Start to send MQTT connect packet.  */
+        status = _nxd_mqtt_client_connect_packet_send(client_ptr, NX_NO_WAIT);
 
-            /* Revert thread priority. */
-            tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+        /* Check status.  */
+        if (status)
+        {
 
             /* End connection. */
             _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
 
-            return(NXD_MQTT_CONNECT_FAILURE);
+            /* Check callback function.  */
+            if (client_ptr -> nxd_mqtt_connect_notify)
+            {
+                client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
+            }
         }
     }
-#endif /* NX_SECURE_ENABLE */
-
-    /* Start to send connect packet.  */
-    status = _nxd_mqtt_client_connect_packet_send(client_ptr, wait_option);
-
-    if (status != NX_SUCCESS)
+    else if (status != NX_CONTINUE)
     {
 
-        /* Revert thread priority. */
-        tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+        /* Error.  */
 
         /* End connection. */
         _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
 
-        return(NXD_MQTT_CONNECT_FAILURE);
+        /* Check callback function.  */
+        if (client_ptr -> nxd_mqtt_connect_notify)
+        {
+            client_ptr -> nxd_mqtt_connect_notify(client_ptr, status, client_ptr -> nxd_mqtt_connect_context);
+        }
     }
 
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
-    {
-        status = nx_secure_tls_session_receive(&(client_ptr -> nxd_mqtt_tls_session), &packet_ptr, wait_option);
-    }
-    else
-    {
-        status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, wait_option);
-    }
-#else
-    status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, wait_option);
+    return;
+}
 #endif /* NX_SECURE_ENABLE */
 
-    /* Revert thread priority. */
-    tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_append_message                     PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes the message length and message in the outgoing */
+/*    MQTT packet.                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Outgoing MQTT packet          */
+/*    message                               Pointer to the message        */
+/*    length                                Length of the message         */
+/*    wait_option                           Wait option                   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                                              */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_data_append                 Append packet data            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub_send                                     */
+/*    _nxd_mqtt_client_connect                                            */
+/*    _nxd_mqtt_client_publish                                            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_append_message(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, CHAR *message, UINT length, ULONG wait_option)
+{
+UINT ret = 0;
+UCHAR len[2];
 
-    /* Check status.  */
-    if (status)
+    len[0] = (length >> 8) & 0xFF;
+    len[1] = length  & 0xFF;
+
+    /* Append message length field. */
+    ret = nx_packet_data_append(packet_ptr, len, 2, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+
+    if (ret)
+    {
+        return(ret);
+    }
+
+    if (length)
     {
+        /* Copy the string into the packet. */
+        ret = nx_packet_data_append(packet_ptr, message, length, 
+                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
 
-        /* End connection. */
-        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
-        return(NXD_MQTT_COMMUNICATION_FAILURE);
+    return(ret);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_connection_end                     PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is used to end the MQTT connection.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Wait option                   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_secure_tls_session_end             End TLS session               */
+/*    nx_secure_tls_session_delete          Delete TLS session            */
+/*    nx_secure_tls_session_reset           Reset TLS session to keep it  */
+/*    nx_tcp_socket_disconnect              Close TCP connection          */
+/*    nx_tcp_client_socket_unbind           Unbind TCP socket             */
+/*    tx_timer_delete                       Delete timer                  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect                                            */
+/*    _nxd_mqtt_process_disconnect                                        */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+VOID _nxd_mqtt_client_connection_end(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+
+    /* Obtain the mutex. */
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    /* Mark the session as terminated. */
+    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
+
+    /* Drop the publish batch that was not flushed. QoS 1 messages in it
+       are still on the transmit queue for retransmission.  */
+    if (client_ptr -> nxd_mqtt_client_batch_packet_ptr)
+    {
+        nx_packet_release(client_ptr -> nxd_mqtt_client_batch_packet_ptr);
+        client_ptr -> nxd_mqtt_client_batch_packet_ptr = NX_NULL;
+    }
+    client_ptr -> nxd_mqtt_client_batch_enabled = NX_FALSE;
+
+    /* The SUBACKs the topic filter list still waits for do not come.  */
+    client_ptr -> nxd_mqtt_client_filter_list = NX_NULL;
+    client_ptr -> nxd_mqtt_client_filter_list_count = 0;
+
+    /* Release the mutex. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        nx_secure_tls_session_end(&(client_ptr -> nxd_mqtt_tls_session), wait_option);
+        NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+    }
+#endif
+    nx_tcp_socket_disconnect(&(client_ptr -> nxd_mqtt_client_socket), wait_option);
+    nx_tcp_client_socket_unbind(&(client_ptr -> nxd_mqtt_client_socket));
+
+    /* Disable timer if timer has been started. */
+    if (client_ptr -> nxd_mqtt_keepalive)
+    {
+         tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+    }
+}
+
+
+static UINT _nxd_mqtt_send_simple_message(NXD_MQTT_CLIENT *client_ptr, UCHAR header_value);
+
+
+/* MQTT internal function */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_periodic_timer_entry                      PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function is the expiration routine of the one-shot   */
+/*    keepalive timer.  The timer expires at the next deadline only: the  */
+/*    end of the ping response wait, or NXD_MQTT_KEEPALIVE_TIMER_RATE     */
+/*    ahead of the keepalive timeout.  Each packet sent pushes the        */
+/*    keepalive timeout back, so on a busy link the timer finds the       */
+/*    deadline moved and is rearmed for the remaining time, no ping is    */
+/*    sent.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client                                Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_event_flags_set                                                  */
+/*    tx_timer_change                                                     */
+/*    tx_timer_activate                                                   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX timer                                                       */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_periodic_timer_entry(ULONG client)
+{
+/* Check if it is time to send out a ping message. */
+NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)client;
+UINT             elapsed;
+UINT             remaining;
+
+    /* If an outstanding ping response has not been received, and the client exceeds the time waiting for ping response,
+       the client shall disconnect from the server. */
+    if (client_ptr -> nxd_mqtt_ping_not_responded)
+    {
+        elapsed = tx_time_get() - client_ptr -> nxd_mqtt_ping_sent_time;
+
+        /* If current time is greater than the ping timeout */
+        if (elapsed >= client_ptr -> nxd_mqtt_ping_timeout)
+        {
+            /* Ping timed out.  Need to terminate the connection. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+            _nxd_mqtt_client_events_set(client_ptr, MQTT_PING_TIMEOUT_EVENT);
+#else
+            nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PING_TIMEOUT_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+            /* The disconnection deletes the timer. */
+            return;
+        }
+
+        /* Expire again at the end of the ping response wait. */
+        remaining = client_ptr -> nxd_mqtt_ping_timeout - elapsed;
+    }
+    else
+    {
+        remaining = client_ptr -> nxd_mqtt_timeout - tx_time_get();
+
+        /* About to timeout?  A remaining time above the keepalive means the timeout is already passed. */
+        if ((remaining <= client_ptr -> nxd_mqtt_timer_value) || (remaining > client_ptr -> nxd_mqtt_keepalive))
+        {
+            /* Set the flag so the MQTT thread can send the ping. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+            _nxd_mqtt_client_events_set(client_ptr, MQTT_TIMEOUT_EVENT);
+#else
+            nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_TIMEOUT_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+            /* Check for the ping response once it is due. */
+            remaining = client_ptr -> nxd_mqtt_ping_timeout;
+        }
+        else
+        {
+
+            /* Packets were sent meanwhile, no ping is needed before the new deadline. */
+            remaining -= client_ptr -> nxd_mqtt_timer_value;
+        }
+    }
+
+    /* The timer is one-shot and inactive in its expiration routine, rearm it for the next deadline. */
+    tx_timer_change(&(client_ptr -> nxd_mqtt_timer), remaining, 0);
+    tx_timer_activate(&(client_ptr -> nxd_mqtt_timer));
+
+    return;
+}
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_publish_ring_drain                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function publishes the messages of the publish ring   */
+/*    in their order, packed into one batch unless the application has a  */
+/*    batch open already, with the client mutex held. A packet not        */
+/*    allocated at once, or the lane over its rate, stops the drain: the  */
+/*    message stays in its slot for the next processing of the events. A  */
+/*    slot claimed by a producer still copying its message stops it too,  */
+/*    the producer sets the event again once done. A message the client   */
+/*    fails to publish otherwise is dropped, as by                        */
+/*    nxd_mqtt_client_publish.                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish                                            */
+/*    _nxd_mqtt_client_publish_batch_flush                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_event_process                                      */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_publish_ring_drain(NXD_MQTT_CLIENT *client_ptr)
+{
+
+NXD_MQTT_PUBLISH_SLOT *slot_ptr;
+ULONG                  tail;
+UINT                   batch_opened = NX_FALSE;
+UINT                   status;
+CHAR                  *topic_ptr;
+
+    while ((client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED) &&
+           (client_ptr -> nxd_mqtt_client_publish_tail != client_ptr -> nxd_mqtt_client_publish_head))
+    {
+        tail = client_ptr -> nxd_mqtt_client_publish_tail;
+        slot_ptr = NXD_MQTT_PUBLISH_SLOT_AT(client_ptr, tail);
+
+        /* The producer of this slot is still copying its message. */
+        if (!slot_ptr -> nxd_mqtt_publish_slot_ready)
+        {
+            break;
+        }
+
+        /* Pack the messages of the ring together, in the batch of the application if one is open. */
+        if (!client_ptr -> nxd_mqtt_client_batch_enabled)
+        {
+            client_ptr -> nxd_mqtt_client_batch_enabled = NX_TRUE;
+            batch_opened = NX_TRUE;
+        }
+
+        topic_ptr = (CHAR *)(slot_ptr + 1);
+        status = _nxd_mqtt_client_publish(client_ptr, topic_ptr, slot_ptr -> nxd_mqtt_publish_slot_topic_length,
+                                          topic_ptr + slot_ptr -> nxd_mqtt_publish_slot_topic_length,
+                                          slot_ptr -> nxd_mqtt_publish_slot_length,
+                                          slot_ptr -> nxd_mqtt_publish_slot_retain, slot_ptr -> nxd_mqtt_publish_slot_qos,
+                                          NX_NO_WAIT);
+
+        /* No packet or no token of the lane now, keep the message for the next turn. */
+        if ((status == NXD_MQTT_PACKET_POOL_FAILURE) || (status == NXD_MQTT_INTERNAL_ERROR) ||
+            (status == NXD_MQTT_RATE_LIMITED))
+        {
+            break;
+        }
+
+        /* Free the slot before the producers can claim it again. */
+        slot_ptr -> nxd_mqtt_publish_slot_ready = NX_FALSE;
+        client_ptr -> nxd_mqtt_client_publish_tail = tail + 1;
+    }
+
+    if (batch_opened)
+    {
+        _nxd_mqtt_client_publish_batch_flush(client_ptr, NXD_MQTT_SOCKET_TIMEOUT);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_event_process                      PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function serves as the entry point for the MQTT       */
+/*    client thread.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    mqtt_client                           Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_release_transmit_packet                                   */
+/*    _nxd_mqtt_release_receive_packet                                    */
+/*    _nxd_mqtt_send_simple_message                                       */
+/*    _nxd_mqtt_process_disconnect                                        */
+/*    _nxd_mqtt_packet_receive_process                                    */
+/*    _nxd_mqtt_publish_ring_drain                                        */
+/*    tx_timer_delete                                                     */
+/*    tx_event_flags_delete                                               */
+/*    nx_tcp_socket_delete                                                */
+/*    tx_timer_delete                                                     */
+/*    tx_mutex_delete                                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*   _nxd_mqtt_client_create                                              */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected mqtt client state,*/
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_client_event_process(VOID *mqtt_client, ULONG common_events, ULONG module_own_events)
+{
+NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)mqtt_client;
+CYCLE_PROFILE_SAVE_AREA
+
+
+    /* Obtain the mutex. */
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+
+    /* Process common events.  */
+    NX_PARAMETER_NOT_USED(common_events);
+
+    if (module_own_events & MQTT_TIMEOUT_EVENT)
+    {
+        /* Send out PING only if the client is connected. */
+        if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+        {
+            _nxd_mqtt_send_simple_message(client_ptr, MQTT_CONTROL_PACKET_TYPE_PINGREQ);
+        }
+    }
+
+    if (module_own_events & MQTT_TCP_ESTABLISH_EVENT)
+    {
+        _nxd_mqtt_tcp_establish_process(client_ptr);
+    }
+
+    if (module_own_events & MQTT_PACKET_RECEIVE_EVENT)
+    {
+#ifdef NX_SECURE_ENABLE
+        /* TLS in progress on async mode.  */
+        if (client_ptr -> nxd_mqtt_tls_in_progress)
+        {
+            _nxd_mqtt_tls_establish_process(client_ptr);
+        }
+        else
+#endif /* NX_SECURE_ENABLE */
+        {
+            CYCLE_PROFILE_ENTER
+            _nxd_mqtt_packet_receive_process(client_ptr);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_MQTT_RECEIVE)
+        }
+    }
+
+    if (module_own_events & MQTT_PING_TIMEOUT_EVENT)
+    {
+        /* The server/broker didn't respond to our ping request message. Disconnect from the server. */
+        _nxd_mqtt_process_disconnect(client_ptr);
+    }
+    if (module_own_events & MQTT_NETWORK_DISCONNECT_EVENT)
+    {
+        /* The server closed TCP socket. We shall go through the disconnect code path. */
+        _nxd_mqtt_process_disconnect(client_ptr);
+    }
+
+    /* Publish the messages enqueued, on MQTT_PUBLISH_ENQUEUE_EVENT or left over for a lack of packets. */
+    if (client_ptr -> nxd_mqtt_client_publish_tail != client_ptr -> nxd_mqtt_client_publish_head)
+    {
+        _nxd_mqtt_publish_ring_drain(client_ptr);
+    }
+
+    if (module_own_events & MQTT_DELETE_EVENT)
+    {
+
+        /* Stop the client and disconnect from the server. */
+        if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+        {
+            _nxd_mqtt_process_disconnect(client_ptr);
+        }
+
+        /* Delete the timer. Check first if it is already deleted. */
+        if ((client_ptr -> nxd_mqtt_timer).tx_timer_id != 0)
+            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+
+#ifndef NXD_MQTT_CLOUD_ENABLE
+        /* Delete the event flag. Check first if it is already deleted. */
+        if ((client_ptr -> nxd_mqtt_events).tx_event_flags_group_id != 0)
+            tx_event_flags_delete(&client_ptr -> nxd_mqtt_events);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+#if defined(NX_SECURE_ENABLE) && defined(NXD_MQTT_TLS_SESSION_KEEP)
+        /* Delete the TLS session kept from the last connection. Check first if it is already deleted. */
+        if (client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_id == NX_SECURE_TLS_ID)
+        {
+            nx_secure_tls_session_delete(&(client_ptr -> nxd_mqtt_tls_session));
+        }
+#endif /* NX_SECURE_ENABLE && NXD_MQTT_TLS_SESSION_KEEP */
+
+        /* Release all the messages on the receive queue. */
+        while (client_ptr -> message_receive_queue_head)
+        {
+            _nxd_mqtt_release_receive_packet(client_ptr, client_ptr -> message_receive_queue_head, NX_NULL);
+        }
+        client_ptr -> message_receive_queue_depth = 0;
+        client_ptr -> message_receive_queue_bytes = 0;
+        client_ptr -> nxd_mqtt_client_receive_paused = NX_FALSE;
+
+        /* Delete all the messages sitting in the receive and transmit queue. */
+        _nxd_mqtt_release_transmit_queue(client_ptr);
+
+        /* Release mutex */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        
+#ifndef NXD_MQTT_CLOUD_ENABLE
+        /* Delete the mutex. */
+        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+        /* Deleting the socket, (the socket ID is cleared); this signals it is ok to delete this thread. */
+        nx_tcp_socket_delete(&client_ptr -> nxd_mqtt_client_socket);
+    }
+    else
+    {
+
+        /* Release mutex */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    }
+}
+
+
+#if !defined(NXD_MQTT_CLOUD_ENABLE) && !defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_thread_entry                              PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function serves as the entry point for the MQTT       */
+/*    client thread.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    mqtt_client                           Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_event_flags_get                                                  */
+/*    _nxd_mqtt_client_event_process                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*   _nxd_mqtt_client_create                                              */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_thread_entry(ULONG mqtt_client)
+{
+NXD_MQTT_CLIENT *client_ptr;
+ULONG            events;
+
+    client_ptr = (NXD_MQTT_CLIENT *)mqtt_client;
+
+    /* Loop to process events on the MQTT client */
+    for (;;)
+    {
+
+        tx_event_flags_get(&client_ptr -> nxd_mqtt_events, MQTT_ALL_EVENTS, TX_OR_CLEAR, &events, TX_WAIT_FOREVER);
+
+        /* Call the event processing routine.  */
+        _nxd_mqtt_client_event_process(client_ptr, NX_NULL, events);
+
+        if (events & MQTT_DELETE_EVENT)
+        {
+            break;
+        }
+    }
+}
+#endif /* !NXD_MQTT_CLOUD_ENABLE && !NXD_MQTT_APPLICATION_EVENT_LOOP */
+
+
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_events_process                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function waits for the events of the MQTT client and processes */
+/*    them in the calling thread, in place of the thread the client       */
+/*    creates when NXD_MQTT_APPLICATION_EVENT_LOOP is not defined.  The   */
+/*    application calls it in a loop, at least once per keepalive         */
+/*    interval, from the thread that uses the client. Without an event,   */
+/*    the messages left in the publish ring for a lack of packets are     */
+/*    published again.                                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_event_flags_get                                                  */
+/*    _nxd_mqtt_client_event_process                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_events_process(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+UINT             status;
+ULONG            events;
+
+
+    status = tx_event_flags_get(&client_ptr -> nxd_mqtt_events, MQTT_ALL_EVENTS, TX_OR_CLEAR, &events, wait_option);
+
+    if (status == TX_NO_EVENTS)
+    {
+
+        /* Retry the publish ring once a call finds no event, the packets freed meanwhile set none. */
+        if ((client_ptr -> nxd_mqtt_client_publish_tail == client_ptr -> nxd_mqtt_client_publish_head) ||
+            (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED))
+        {
+            return(NXD_MQTT_NO_MESSAGE);
+        }
+        events = 0;
+    }
+
+    /* The event flags are deleted with the client. */
+    else if (status != TX_SUCCESS)
+    {
+        return(NXD_MQTT_CLIENT_NOT_RUNNING);
+    }
+
+    /* Call the event processing routine.  */
+    _nxd_mqtt_client_event_process(client_ptr, NX_NULL, events);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_events_signal_set                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function has every event of the client also set a flag in an   */
+/*    event flags group of the application, so that one thread waits for */
+/*    the events of several clients on that group, then calls             */
+/*    nxd_mqtt_client_events_process without waiting for each client     */
+/*    whose flag is set.  A null group_ptr stops the signal.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    group_ptr                             Group of the application      */
+/*    flag                                  Flag of the client in it      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_events_signal_set(NXD_MQTT_CLIENT *client_ptr, TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flag)
+{
+TX_INTERRUPT_SAVE_AREA
+
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+
+    /* The IP thread and the timer read both fields. */
+    TX_DISABLE
+    client_ptr -> nxd_mqtt_events_signal_ptr = group_ptr;
+    client_ptr -> nxd_mqtt_events_signal_flag = flag;
+    TX_RESTORE
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _mqtt_client_disconnect_callback                    PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function is passed to MQTT client socket create call. */
+/*    This callback function notifies MQTT client thread when the TCP     */
+/*    connection is lost.                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to TCP socket that    */
+/*                                            disconnected.               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    TCP socket disconnect callback                                      */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static VOID _mqtt_client_disconnect_callback(NX_TCP_SOCKET *socket_ptr)
+{
+NXD_MQTT_CLIENT *client_ptr = (NXD_MQTT_CLIENT *)(socket_ptr -> nx_tcp_socket_reserved_ptr);
+
+    /* Set the MQTT_NETWORK_DISCONNECT  event.  This event indicates
+       that the disconnect is initiated from the network. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+    _nxd_mqtt_client_events_set(client_ptr, MQTT_NETWORK_DISCONNECT_EVENT);
+#else
+    nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_NETWORK_DISCONNECT_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    return;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_create                             PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function creates an instance for MQTT Client.  It initializes  */
+/*    MQTT Client control block, creates a thread, mutex and event queue  */
+/*    for MQTT Client, and creates the TCP socket for MQTT messaging.     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    client_id                             Client ID for this instance   */
+/*    client_id_length                      Length of Client ID, in bytes */
+/*    ip_ptr                                Pointer to IP instance        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    stack_ptr                             Client thread's stack pointer */
+/*    stack_size                            Client thread's stack size    */
+/*    mqtt_thread_priority                  Priority for MQTT thread      */
+/*    memory_ptr                            Deprecated and not used       */
+/*    memory_size                           Deprecated and not used       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_create_internal      Create mqtt client            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected mqtt client state,*/
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
+                             CHAR *client_id, UINT client_id_length,
+                             NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
+                             VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority,
+                             VOID *memory_ptr, ULONG memory_size)
+{
+
+UINT    status;
+
+
+    NX_PARAMETER_NOT_USED(memory_ptr);
+    NX_PARAMETER_NOT_USED(memory_size);
+
+    /* Create MQTT client.  */
+    status = _nxd_mqtt_client_create_internal(client_ptr, client_name, client_id, client_id_length, ip_ptr,
+                                              pool_ptr, stack_ptr, stack_size, mqtt_thread_priority);
+
+    /* Check status.  */
+    if (status)
+    {
+        return(status);
+    }
+
+#ifdef NXD_MQTT_CLOUD_ENABLE
+
+    /* Create cloud helper.  */
+    status = nx_cloud_create(&(client_ptr -> nxd_mqtt_client_cloud), "Cloud Helper", stack_ptr, stack_size, mqtt_thread_priority);
+
+    /* Determine if an error occurred.  */
+    if (status != NX_SUCCESS)
+    {
+
+        /* Delete internal resource created in _nxd_mqtt_client_create_internal().  */
+
+        /* Delete socket.  */
+        nx_tcp_socket_delete(&(client_ptr -> nxd_mqtt_client_socket));
+
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    /* Save the cloud pointer.  */
+    client_ptr -> nxd_mqtt_client_cloud_ptr = &(client_ptr -> nxd_mqtt_client_cloud);
+
+    /* Save the mutex pointer.  */
+    client_ptr -> nxd_mqtt_client_mutex_ptr = &(client_ptr -> nxd_mqtt_client_cloud.nx_cloud_mutex);
+
+    /* Register MQTT on cloud helper.  */
+    status = nx_cloud_module_register(client_ptr -> nxd_mqtt_client_cloud_ptr, &(client_ptr -> nxd_mqtt_client_cloud_module), client_name, NX_CLOUD_MODULE_MQTT_EVENT,
+                                      _nxd_mqtt_client_event_process, client_ptr);
+
+    /* Determine if an error occurred.  */
+    if (status != NX_SUCCESS)
+    {
+
+        /* Delete own created cloud.  */
+        nx_cloud_delete(&(client_ptr -> nxd_mqtt_client_cloud));
+
+        /* Delete internal resource created in _nxd_mqtt_client_create_internal().  */
+
+        /* Delete socket.  */
+        nx_tcp_socket_delete(&(client_ptr -> nxd_mqtt_client_socket));
+
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    /* Update state.  */
+    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
+
+    /* Return.  */
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_create_internal                    PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function creates an instance for MQTT Client.  It initializes  */
+/*    MQTT Client control block, creates a thread, mutex and event queue  */
+/*    for MQTT Client, and creates the TCP socket for MQTT messaging.     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    client_id                             Client ID for this instance   */
+/*    client_id_length                      Length of Client ID, in bytes */
+/*    ip_ptr                                Pointer to IP instance        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    stack_ptr                             Client thread's stack pointer */
+/*    stack_size                            Client thread's stack size    */
+/*    mqtt_thread_priority                  Priority for MQTT thread      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_thread_create                      Create a thread               */
+/*    tx_mutex_create                       Create mutex                  */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    tx_event_flag_create                  Create event flag             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected mqtt client state,*/
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_create_internal(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
+                                             CHAR *client_id, UINT client_id_length,
+                                             NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
+                                             VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority)
+{
+UINT                status;
+
+#if defined(NXD_MQTT_CLOUD_ENABLE) || defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+    NX_PARAMETER_NOT_USED(stack_ptr);
+    NX_PARAMETER_NOT_USED(stack_size);
+    NX_PARAMETER_NOT_USED(mqtt_thread_priority);
+#endif /* NXD_MQTT_CLOUD_ENABLE || NXD_MQTT_APPLICATION_EVENT_LOOP */
+
+    /* Clear the MQTT Client control block. */
+    NXD_MQTT_SECURE_MEMSET((void *)client_ptr, 0, sizeof(NXD_MQTT_CLIENT));
+
+#ifndef NXD_MQTT_CLOUD_ENABLE
+
+    /* Create MQTT mutex.  */
+    status = tx_mutex_create(&client_ptr -> nxd_mqtt_protection, client_name, TX_NO_INHERIT);
+
+    /* Determine if an error occurred. */
+    if (status != TX_SUCCESS)
+    {
+
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+    client_ptr -> nxd_mqtt_client_mutex_ptr = &(client_ptr -> nxd_mqtt_protection);
+
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+    /* Now create MQTT client thread */
+    status = tx_thread_create(&(client_ptr -> nxd_mqtt_thread), client_name, _nxd_mqtt_thread_entry,
+                              (ULONG)client_ptr, stack_ptr, stack_size, mqtt_thread_priority, mqtt_thread_priority,
+                              NXD_MQTT_CLIENT_THREAD_TIME_SLICE, TX_DONT_START);
+
+    /* Determine if an error occurred. */
+    if (status != TX_SUCCESS)
+    {
+        /* Delete the mutex. */
+        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
+
+        /* Return error code. */
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+
+    status = tx_event_flags_create(&(client_ptr -> nxd_mqtt_events), client_name);
+
+    if (status != TX_SUCCESS)
+    {
+        /* Delete the mutex. */
+        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
+
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+        /* Delete the thread. */
+        tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+        
+        /* Return error code. */
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    /* Record the client ID information. */
+    client_ptr -> nxd_mqtt_client_id = client_id;
+    client_ptr -> nxd_mqtt_client_id_length = client_id_length;
+    client_ptr -> nxd_mqtt_client_ip_ptr = ip_ptr;
+    client_ptr -> nxd_mqtt_client_packet_pool_ptr = pool_ptr;
+    client_ptr -> nxd_mqtt_client_name = client_name;
+
+    /* Create the socket. */
+    status = nx_tcp_socket_create(client_ptr -> nxd_mqtt_client_ip_ptr, &(client_ptr -> nxd_mqtt_client_socket), client_ptr -> nxd_mqtt_client_name,
+                                  NX_IP_NORMAL, NX_DONT_FRAGMENT, 0x80, NXD_MQTT_CLIENT_SOCKET_WINDOW_SIZE,
+                                  NX_NULL, _mqtt_client_disconnect_callback);
+
+    /* Determine if an error occurred. */
+    if (status != NX_SUCCESS)
+    {
+#ifndef NXD_MQTT_CLOUD_ENABLE
+        /* Delete the mutex. */
+        tx_mutex_delete(&client_ptr -> nxd_mqtt_protection);
+
+        /* Delete the event flags. */
+        tx_event_flags_delete(&(client_ptr -> nxd_mqtt_events));
+
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+        /* Delete the thread. */
+        tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    /* Record the client_ptr in the socket structure. */
+    client_ptr -> nxd_mqtt_client_socket.nx_tcp_socket_reserved_ptr = (VOID *)client_ptr;
+
+#if !defined(NXD_MQTT_CLOUD_ENABLE) && !defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+    /* Start MQTT thread. */
+    tx_thread_resume(&(client_ptr -> nxd_mqtt_thread));
+#endif /* !NXD_MQTT_CLOUD_ENABLE && !NXD_MQTT_APPLICATION_EVENT_LOOP */
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_login_set                          PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets optional MQTT username and password.  Note       */
+/*    if the broker requires username and password, this information      */
+/*    must be set prior to calling nxd_mqtt_client_connect or             */
+/*    nxd_mqtt_client_secure_connect.                                     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    username                              User name, or NULL if user    */
+/*                                            name is not required        */
+/*    username_length                       Length of the user name, or   */
+/*                                            0 if user name is NULL      */
+/*    password                              Password string, or NULL if   */
+/*                                            password is not required    */
+/*    password_length                       Length of the password, or    */
+/*                                            0 if password is NULL       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
+                                CHAR *username, UINT username_length, CHAR *password, UINT password_length)
+{
+UINT status;
+
+    /* Obtain the mutex. */
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (status != TX_SUCCESS)
+    {
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+    client_ptr -> nxd_mqtt_client_username = username;
+    client_ptr -> nxd_mqtt_client_username_length = (USHORT)username_length;
+    client_ptr -> nxd_mqtt_client_password = password;
+    client_ptr -> nxd_mqtt_client_password_length = (USHORT)password_length;
+
+    /* The next CONNECT is encoded again. */
+    client_ptr -> nxd_mqtt_client_connect_cache_length = 0;
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NX_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_will_message_set                   PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets optional MQTT will topic and will message.       */
+/*    Note that if will message is needed, application must set will      */
+/*    message prior to calling nxd_mqtt_client_connect or                 */
+/*    nxd_mqtt_client_secure_connect.                                     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    will_topic                            Will topic string.            */
+/*    will_topic_length                     Length of the will topic.     */
+/*    will_message                          Will message string.          */
+/*    will_message_length                   Length of the will message.   */
+/*    will_retain_flag                      Whether or not the will       */
+/*                                            message is to be retained   */
+/*                                            when it is published.       */
+/*                                            Valid values are NX_TRUE    */
+/*                                            NX_FALSE                    */
+/*    will_QoS                              QoS level to be used when     */
+/*                                            publishing will message.    */
+/*                                            Valid values are 0, 1, 2    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
+                                       const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
+                                       UINT will_message_length, UINT will_retain_flag, UINT will_QoS)
+{
+UINT status;
+
+    if (will_QoS == 2)
+    {
+        return(NXD_MQTT_QOS2_NOT_SUPPORTED);
+    }
+
+    /* Obtain the mutex. */
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (status != TX_SUCCESS)
+    {
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+
+    client_ptr -> nxd_mqtt_client_will_topic = will_topic;
+    client_ptr -> nxd_mqtt_client_will_topic_length = will_topic_length;
+    client_ptr -> nxd_mqtt_client_will_message = will_message;
+    client_ptr -> nxd_mqtt_client_will_message_length = will_message_length;
+
+    if (will_retain_flag == NX_TRUE)
+    {
+        client_ptr -> nxd_mqtt_client_will_qos_retain = 0x80;
+    }
+    client_ptr -> nxd_mqtt_client_will_qos_retain = (UCHAR)(client_ptr -> nxd_mqtt_client_will_qos_retain | will_QoS);
+
+    /* The next CONNECT is encoded again. */
+    client_ptr -> nxd_mqtt_client_connect_cache_length = 0;
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_will_message_set                  PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the                              */
+/*    nxd_mqtt_client_will_message_set call.                              */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    will_topic                            Will topic string.            */
+/*    will_topic_length                     Length of the will topic.     */
+/*    will_message                          Will message string.          */
+/*    will_message_length                   Length of the will message.   */
+/*    will_retain_flag                      Whether or not the will       */
+/*                                            message is to be retained   */
+/*                                            when it is published.       */
+/*                                            Valid values are NX_TRUE    */
+/*                                            NX_FALSE                    */
+/*    will_QoS                              QoS level to be used when     */
+/*                                            publishing will message.    */
+/*                                            Valid values are 0, 1, 2    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_will_message_set                                   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
+                                        const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
+                                        UINT will_message_length, UINT will_retain_flag, UINT will_QoS)
+{
+
+    if (client_ptr == NX_NULL)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Valid will_topic string.  The will topic string cannot be NULL. */
+    if ((will_topic == NX_NULL) || (will_topic_length  == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    if ((will_retain_flag != NX_TRUE) && (will_retain_flag != NX_FALSE))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    if (will_QoS > 2)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_will_message_set(client_ptr, will_topic, will_topic_length, will_message,
+                                             will_message_length, will_retain_flag, will_QoS));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_login_set                         PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the nxd_mqtt_client_login call.  */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    username                              User name, or NULL if user    */
+/*                                            name is not required        */
+/*    username_length                       Length of the user name, or   */
+/*                                            0 if user name is NULL      */
+/*    password                              Password string, or NULL if   */
+/*                                            password is not required    */
+/*    password_length                       Length of the password, or    */
+/*                                            0 if password is NULL       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_login_set                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
+                                 CHAR *username, UINT username_length, CHAR *password, UINT password_length)
+{
+    if (client_ptr == NX_NULL)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Username and username length don't match,
+       or password and password length don't match. */
+    if (((username == NX_NULL) && (username_length != 0)) ||
+        ((password == NX_NULL) && (password_length != 0)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_login_set(client_ptr, username, username_length, password, password_length));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_retransmit_message                 PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function retransmit QoS1 messages upon reconnection, if the    */
+/*    connection is not set CLEAN_SESSION. The QoS 2 messages are sent    */
+/*    again too, or their PUBREL once the broker received them.           */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Timeout value                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_packet_release                                                   */
+/*    tx_time_get                                                         */
+/*    nx_packet_copy                                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_retransmit_message(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+NX_PACKET          *transmit_packet_ptr;
+NX_PACKET          *packet_ptr;
+UINT                status = NXD_MQTT_SUCCESS;
+UINT                mutex_status;
+UCHAR               fixed_header;
+UINT                index;
+
+    transmit_packet_ptr = client_ptr -> message_transmit_queue_head;
+
+    while (transmit_packet_ptr)
+    {
+        fixed_header = *(transmit_packet_ptr -> nx_packet_prepend_ptr);
+
+        if (((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4)) ||
+            ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBREL << 4)))
+        {
+
+            /* Retransmit publish and publish release packets only. */
+            /* Obtain a NetX Packet. */
+            status = nx_packet_copy(transmit_packet_ptr, &packet_ptr, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+
+            if (status != NXD_MQTT_SUCCESS)
+            {
+                return(NXD_MQTT_PACKET_POOL_FAILURE);
+            }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+            /* The network latency of a message sent again counts from its last send. */
+            if ((fixed_header & 0xF0) == (MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4))
+            {
+                NXD_MQTT_LATENCY_SEND_TIME(transmit_packet_ptr) = NXD_MQTT_LATENCY_TIME();
+                NXD_MQTT_LATENCY_SENT(transmit_packet_ptr) = NX_TRUE;
+            }
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+            /* Release the mutex. */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+            /* Send the packet. */
+#ifdef NX_SECURE_ENABLE
+            if (client_ptr -> nxd_mqtt_client_use_tls)
+            {
+                status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
+            }
+            else
+            {
+                status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+            }
+#else
+            status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+
+#endif /* NX_SECURE_ENABLE */
+
+            if (status)
+            {
+                /* Release the packet. */
+                nx_packet_release(packet_ptr);
+
+                status = NXD_MQTT_COMMUNICATION_FAILURE;
+            }
+            /* Obtain the mutex. */
+            mutex_status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, wait_option);
+
+            if (mutex_status != TX_SUCCESS)
+            {
+                return(NXD_MQTT_MUTEX_FAILURE);
+            }
+            if (status)
+            {
+                return(status);
+            }
+        }
+        transmit_packet_ptr = transmit_packet_ptr -> nx_packet_queue_next;
+    }
+
+    /* Release again the QoS 2 messages the QoS 2 table keeps by packet ID. */
+    for (index = 0; index < client_ptr -> nxd_mqtt_client_qos2_table_size; index++)
+    {
+        if (client_ptr -> nxd_mqtt_client_qos2_table[index].nxd_mqtt_qos2_phase == NXD_MQTT_QOS2_PUBREL_SENT)
+        {
+            status = _nxd_mqtt_publish_response_send(client_ptr, (MQTT_CONTROL_PACKET_TYPE_PUBREL << 4) | 0x02,
+                                                     client_ptr -> nxd_mqtt_client_qos2_table[index].nxd_mqtt_qos2_packet_id,
+                                                     NX_FALSE);
+            if (status)
+            {
+                return(status);
+            }
+        }
+    }
+
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect                            PORTABLE C      */
+/*                                                           6.1.8        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function makes an initial connection to the MQTT server.       */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    server_ip                             Server IP address structure   */
+/*    server_port                           Server port number, in host   */
+/*                                            byte order                  */
+/*    keepalive                             Keepalive flag                */
+/*    clean_session                         Clean session flag            */
+/*    wait_option                           Timeout value                 */
+/*                                                                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    nx_tcp_socket_create                  Create TCP socket             */
+/*    nx_tcp_socket_receive_notify                                        */
+/*    nx_tcp_client_socket_bind                                           */
+/*    nxd_tcp_client_socket_connect                                       */
+/*    nx_tcp_client_socket_unbind                                         */
+/*    tx_mutex_put                                                        */
+/*    nx_secure_tls_session_start                                         */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_secure_tls_session_receive                                       */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    _nxd_mqtt_client_set_fixed_header                                   */
+/*    _nxd_mqtt_client_append_message                                     */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_packet_release                                                   */
+/*    nx_tcp_socket_receive                                               */
+/*    tx_event_flag_set                                                   */
+/*    _nxd_mqtt_release_transmit_packet                                   */
+/*    tx_timer_create                                                     */
+/*    nx_secure_tls_session_receive                                       */
+/*    _nxd_mqtt_client_connection_end                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            fixed return value when it  */
+/*                                            is set in CONNACK, corrected*/
+/*                                            mqtt client state,          */
+/*                                            resulting in version 6.1    */
+/*  08-02-2021     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected the logic for     */
+/*                                            non-blocking mode,          */
+/*                                            resulting in version 6.1.8  */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
+                              UINT keepalive, UINT clean_session, ULONG wait_option)
+{
+NX_PACKET           *packet_ptr;
+UINT                 status;
+TX_THREAD           *thread_ptr;
+UINT                 new_priority;
+UINT                 old_priority;
+
+
+    /* Obtain the mutex. */
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (status != TX_SUCCESS)
+    {
+#ifdef NX_SECURE_ENABLE
+        if (client_ptr -> nxd_mqtt_client_use_tls)
+        {
+            NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+        }
+#endif /* NX_SECURE_ENABLE */
+
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+
+    /* Do nothing if the client is already connected. */
+    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+    {
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_ALREADY_CONNECTED);
+    }
+
+    /* Check if client is connecting. */
+    if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTING)
+    {
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_CONNECTING);
+    }
+
+    /* Client state must be in IDLE.  */
+    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_IDLE)
+    {
+#ifdef NX_SECURE_ENABLE
+        if (client_ptr -> nxd_mqtt_client_use_tls)
+        {
+            NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+        }
+#endif /* NX_SECURE_ENABLE */
+        return(NXD_MQTT_INVALID_STATE);
+    }
+
+#if defined(NX_SECURE_ENABLE) && defined(NXD_MQTT_REQUIRE_TLS)
+    if (!client_ptr -> nxd_mqtt_client_use_tls)
+    {
+
+        /* NXD_MQTT_REQUIRE_TLS is defined but the application does not use TLS.
+           This is security violation.  Return with failure code. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_CONNECT_FAILURE);
+    }
+#endif /* NX_SECURE_ENABLE && NXD_MQTT_REQUIRE_TLS*/
+
+    /* Record the keepalive value, converted to TX timer ticks. */
+    client_ptr -> nxd_mqtt_keepalive = keepalive * NX_IP_PERIODIC_RATE;
+    if (keepalive)
+    {
+        client_ptr -> nxd_mqtt_timer_value = NXD_MQTT_KEEPALIVE_TIMER_RATE;
+        client_ptr -> nxd_mqtt_ping_timeout = NXD_MQTT_PING_TIMEOUT_DELAY;
+
+        /* Create a one-shot timer, expiring first when the ping would be due if nothing else was sent.  */
+        status = tx_timer_create(&(client_ptr -> nxd_mqtt_timer), "MQTT Timer", _nxd_mqtt_periodic_timer_entry, (ULONG)client_ptr,
+                                 (client_ptr -> nxd_mqtt_keepalive > client_ptr -> nxd_mqtt_timer_value) ?
+                                 (client_ptr -> nxd_mqtt_keepalive - client_ptr -> nxd_mqtt_timer_value) : client_ptr -> nxd_mqtt_keepalive,
+                                 0, TX_AUTO_ACTIVATE);
+        if (status)
+        {
+#ifdef NX_SECURE_ENABLE
+            if (client_ptr -> nxd_mqtt_client_use_tls)
+            {
+                NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+            }
+#endif /* NX_SECURE_ENABLE */
+
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(NXD_MQTT_INTERNAL_ERROR);
+        }
+    }
+    else
+    {
+        client_ptr -> nxd_mqtt_timer_value = 0;
+        client_ptr -> nxd_mqtt_ping_timeout = 0;
+    }
+
+    /* Record the clean session flag.  */
+    client_ptr -> nxd_mqtt_clean_session = clean_session;
+
+    /* Set TCP connection establish notify for non-blocking mode.  */
+    if (wait_option == 0)
+    {
+        status = nx_tcp_socket_establish_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_tcp_establish_notify);
+
+        /* Check status.  */
+        if (status != NX_SUCCESS)
+        {
+#ifdef NX_SECURE_ENABLE
+            if (client_ptr -> nxd_mqtt_client_use_tls)
+            {
+                NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+            }
+#endif /* NX_SECURE_ENABLE */
+            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(status);
+        }
+
+        /* Set the receive callback. */
+        nx_tcp_socket_receive_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_receive_callback);
+    }
+    else
+    {
+
+        /* Clean receive callback.  */
+        client_ptr -> nxd_mqtt_client_socket.nx_tcp_receive_callback = NX_NULL;
+    }
+
+    /* Release mutex */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    /* First attempt to bind the client socket. */
+    status = nx_tcp_client_socket_bind(&(client_ptr -> nxd_mqtt_client_socket), NX_ANY_PORT, wait_option);
+
+    if (status != NX_SUCCESS)
+    {
+#ifdef NX_SECURE_ENABLE
+        if (client_ptr -> nxd_mqtt_client_use_tls)
+        {
+            NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+        }
+#endif /* NX_SECURE_ENABLE */
+        tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    /* Obtain the mutex. */
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    /* Make state as NXD_MQTT_CLIENT_STATE_CONNECTING. */
+    client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_CONNECTING;
+
+    /* Release mutex. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    /* Connect to the MQTT server */
+    status = nxd_tcp_client_socket_connect(&(client_ptr -> nxd_mqtt_client_socket), server_ip, server_port, wait_option);
+    if ((status != NX_SUCCESS) && (status != NX_IN_PROGRESS))
+    {
+
+        /* Obtain the mutex. */
+        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        /* Make state as NXD_MQTT_CLIENT_STATE_IDLE. */
+        client_ptr -> nxd_mqtt_client_state = NXD_MQTT_CLIENT_STATE_IDLE;
+
+        /* Release mutex. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+#ifdef NX_SECURE_ENABLE
+        if (client_ptr -> nxd_mqtt_client_use_tls)
+        {
+            NXD_MQTT_TLS_SESSION_RELEASE(client_ptr);
+        }
+#endif /* NX_SECURE_ENABLE */
+        nx_tcp_client_socket_unbind(&(client_ptr -> nxd_mqtt_client_socket));
+        tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+        return(NXD_MQTT_CONNECT_FAILURE);
+    }
+
+    /* Just return for non-blocking mode.  */
+    if ((status == NX_IN_PROGRESS) || (wait_option == 0))
+    {
+        return(NX_IN_PROGRESS);
+    }
+
+    /* Increase priority to the same of internal thread to avoid out of order packet process. */
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+    /* The caller processes the events itself, its priority is kept. */
+    thread_ptr = tx_thread_identify();
+#elif !defined(NXD_MQTT_CLOUD_ENABLE)
+    thread_ptr = &(client_ptr -> nxd_mqtt_thread);
+#else
+    thread_ptr = &(client_ptr -> nxd_mqtt_client_cloud_ptr -> nx_cloud_thread);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+    tx_thread_info_get(thread_ptr, NX_NULL, NX_NULL, NX_NULL, 
+                       &new_priority, NX_NULL, NX_NULL, NX_NULL, NX_NULL);
+    tx_thread_priority_change(tx_thread_identify(), new_priority, &old_priority);
+
+    /* If TLS is enabled, start TLS */
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+
+        status = nx_secure_tls_session_start(&(client_ptr -> nxd_mqtt_tls_session), &(client_ptr -> nxd_mqtt_client_socket), wait_option);
+
+        if (status != NX_SUCCESS)
+        {
+
+            /* Revert thread priority. */
+            tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+
+            /* End connection. */
+            _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+
+            return(NXD_MQTT_CONNECT_FAILURE);
+        }
+    }
+#endif /* NX_SECURE_ENABLE */
+
+    /* Start to send connect packet.  */
+    status = _nxd_mqtt_client_connect_packet_send(client_ptr, wait_option);
+
+    if (status != NX_SUCCESS)
+    {
+
+        /* Revert thread priority. */
+        tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+
+        /* End connection. */
+        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+
+        return(NXD_MQTT_CONNECT_FAILURE);
+    }
+
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_receive(&(client_ptr -> nxd_mqtt_tls_session), &packet_ptr, wait_option);
+    }
+    else
+    {
+        status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, wait_option);
+    }
+#else
+    status = nx_tcp_socket_receive(&client_ptr -> nxd_mqtt_client_socket, &packet_ptr, wait_option);
+#endif /* NX_SECURE_ENABLE */
+
+    /* Revert thread priority. */
+    tx_thread_priority_change(tx_thread_identify(), old_priority, &old_priority);
+
+    /* Check status.  */
+    if (status)
+    {
+
+        /* End connection. */
+        _nxd_mqtt_client_connection_end(client_ptr, NX_NO_WAIT);
+        return(NXD_MQTT_COMMUNICATION_FAILURE);
+    }
+
+    /* Process CONNACK message.  */
+    status = _nxd_mqtt_process_connack(client_ptr, packet_ptr, wait_option);
+
+    /* Release the packet.  */
+    nx_packet_release(packet_ptr);
+
+    /* Check status.  */
+    if (status == NX_SUCCESS)
+    {
+
+        /* Set the receive callback. */
+        nx_tcp_socket_receive_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_receive_callback);
+    }
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect_packet_send                PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends CONNECT packet to MQTT server. With a CONNECT   */
+/*    cache set by nxd_mqtt_client_connect_cache_set, the packet encoded  */
+/*    for the first connection is sent again by the next ones as long as  */
+/*    the login, the will, the keepalive and the clean session flag are   */
+/*    the same.                                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    keepalive                             Keepalive flag                */
+/*    clean_session                         Clean session flag            */
+/*    wait_option                           Timeout value                 */
+/*                                                                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_release                                                   */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    _nxd_mqtt_release_transmit_packet                                   */
+/*    _nxd_mqtt_client_connection_end                                     */
+/*    _nxd_mqtt_client_set_fixed_header                                   */
+/*    _nxd_mqtt_client_append_message                                     */
+/*    _nxd_mqtt_client_connect_packet_transmit                            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect                                            */
+/*    _nxd_mqtt_tcp_establish_process                                     */
+/*    _nxd_mqtt_tls_establish_process                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_connect_packet_send(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+NX_PACKET           *packet_ptr;
+UINT                 status;
+UINT                 length = 0;
+UCHAR                connection_flags = 0;
+UINT                 ret = NXD_MQTT_SUCCESS;
+UCHAR                temp_data[4];
+UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODIC_RATE);
+ULONG                bytes_copied;
+#ifdef NXD_MQTT_V5_ENABLE
+UCHAR                properties[6];
+UINT                 properties_length = 1;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+
+    /* Construct connect flags by taking the connect flag user supplies, or'ing the username and
+       password bits, if they are supplied. */
+    if (client_ptr -> nxd_mqtt_client_username)
+    {
+        connection_flags |= MQTT_CONNECT_FLAGS_USERNAME;
+
+        /* Add the password flag only if username is supplied. */
+        if (client_ptr -> nxd_mqtt_client_password)
+        {
+            connection_flags |= MQTT_CONNECT_FLAGS_PASSWORD;
+        }
+    }
+
+    if (client_ptr -> nxd_mqtt_client_will_topic)
+    {
+        connection_flags = connection_flags | MQTT_CONNECT_FLAGS_WILL_FLAG;
+
+
+        if (client_ptr -> nxd_mqtt_client_will_qos_retain & 0x80)
+        {
+            connection_flags = connection_flags | MQTT_CONNECT_FLAGS_WILL_RETAIN;
+        }
+
+        connection_flags = (UCHAR)(connection_flags | ((client_ptr -> nxd_mqtt_client_will_qos_retain & 0x3) << 3));
+    }
+
+    if (client_ptr -> nxd_mqtt_clean_session == NX_TRUE)
+    {
+        connection_flags = connection_flags | MQTT_CONNECT_FLAGS_CLEAN_SESSION;
+
+        /* Clear any transmit blocks from the previous session. */
+        _nxd_mqtt_release_transmit_queue(client_ptr);
+
+        /* And the QoS 2 exchanges of the previous session. */
+        if (client_ptr -> nxd_mqtt_client_qos2_table)
+        {
+            NXD_MQTT_SECURE_MEMSET(client_ptr -> nxd_mqtt_client_qos2_table, 0,
+                                   client_ptr -> nxd_mqtt_client_qos2_table_size * sizeof(NXD_MQTT_QOS2_ENTRY));
+            client_ptr -> nxd_mqtt_client_qos2_count = 0;
+        }
+    }
+
+    /* Send the CONNECT encoded for an earlier connection, unless a setting it holds changed since. */
+    if (client_ptr -> nxd_mqtt_client_connect_cache_length &&
+        (client_ptr -> nxd_mqtt_client_connect_cache_keepalive == client_ptr -> nxd_mqtt_keepalive) &&
+        (client_ptr -> nxd_mqtt_client_connect_cache_clean_session == client_ptr -> nxd_mqtt_clean_session))
+    {
+        status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, client_ptr -> nxd_mqtt_client_connect_cache_length);
+        if (status)
+        {
+
+            return(status);
+        }
+
+        if (nx_packet_data_append(packet_ptr, client_ptr -> nxd_mqtt_client_connect_cache,
+                                  client_ptr -> nxd_mqtt_client_connect_cache_length,
+                                  client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option))
+        {
+
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+
+            return(NXD_MQTT_PACKET_POOL_FAILURE);
+        }
+
+        return(_nxd_mqtt_client_connect_packet_transmit(client_ptr, packet_ptr, wait_option));
+    }
+
+    /* Set the length of the packet. */
+    length = 10;
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Without Clean Session, ask the server to keep the session after the network connection
+       closes, as an MQTT 3.1.1 server does. The Session Expiry Interval defaults to zero.  */
+    properties[0] = 0;
+    if (client_ptr -> nxd_mqtt_clean_session != NX_TRUE)
+    {
+        properties[0] = 5;
+        properties[1] = MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL;
+        properties[2] = 0xFF;
+        properties[3] = 0xFF;
+        properties[4] = 0xFF;
+        properties[5] = 0xFF;
+        properties_length = 6;
+    }
+    length += properties_length;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Add the size of the client Identifier. */
+    length += (client_ptr -> nxd_mqtt_client_id_length + 2);
+
+    /* Add the will topic, if present. */
+    if (connection_flags & MQTT_CONNECT_FLAGS_WILL_FLAG)
+    {
+        length += (client_ptr -> nxd_mqtt_client_will_topic_length + 2);
+        length += (client_ptr -> nxd_mqtt_client_will_message_length + 2);
+#ifdef NXD_MQTT_V5_ENABLE
+        /* Count the will property length. */
+        length++;
+#endif /* NXD_MQTT_V5_ENABLE */
+    }
+    if (connection_flags & MQTT_CONNECT_FLAGS_USERNAME)
+    {
+        length += (UINT)(client_ptr -> nxd_mqtt_client_username_length + 2);
+    }
+    if (connection_flags & MQTT_CONNECT_FLAGS_PASSWORD)
+    {
+        length += (UINT)(client_ptr -> nxd_mqtt_client_password_length + 2);
+    }
+
+    /* Check for invalid length. */
+    if (length > (127 * 127 * 127 * 127))
+    {
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr,
+                                       client_ptr -> nxd_mqtt_client_packet_pool_ptr -> nx_packet_pool_payload_size);
+    if (status)
+    {
+
+        return(status);
+    }
+
+    /* Construct MQTT CONNECT message. */
+    temp_data[0] = ((MQTT_CONTROL_PACKET_TYPE_CONNECT << 4) & 0xF0);
+
+    /* Fill in fixed header. */
+    ret = _nxd_mqtt_client_set_fixed_header(client_ptr, packet_ptr, temp_data[0], length, wait_option);
+
+    if (ret)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, "MQTT", 4, wait_option);
+
+    if (ret)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+    /* Fill in protocol level, */
+    temp_data[0] = MQTT_PROTOCOL_LEVEL;
+
+    /* Fill in byte 8: connect flags */
+    temp_data[1] = connection_flags;
+
+    /* Fill in byte 9 and 10: keep alive */
+    temp_data[2] = (keepalive >> 8) & 0xFF;
+    temp_data[3] = (keepalive & 0xFF);
+
+    ret = nx_packet_data_append(packet_ptr, temp_data, 4, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+
+#ifdef NXD_MQTT_V5_ENABLE
+    if (!ret)
+    {
+
+        /* Fill in the CONNECT properties. No Topic Alias Maximum is sent, so the server
+           does not use aliases in the messages it forwards to the client. */
+        ret = nx_packet_data_append(packet_ptr, properties, properties_length,
+                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    if (ret)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+    /* Fill in payload area, in the order of: client identifier, will topic, will message,
+       user name, and password. */
+    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_id, 
+                                          client_ptr -> nxd_mqtt_client_id_length, wait_option);
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Fill in an empty will property length ahead of the will topic. */
+    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_WILL_FLAG))
+    {
+        temp_data[0] = 0;
+        ret = nx_packet_data_append(packet_ptr, temp_data, 1, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Next fill will topic and will message if the will flag is set. */
+    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_WILL_FLAG))
+    {
+        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, (CHAR *)client_ptr -> nxd_mqtt_client_will_topic,
+                                              client_ptr -> nxd_mqtt_client_will_topic_length, wait_option);
+
+        if (!ret)
+        {
+            ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, (CHAR *)client_ptr -> nxd_mqtt_client_will_message,
+                                                  client_ptr -> nxd_mqtt_client_will_message_length, wait_option);
+        }
+    }
+
+    /* Fill username if username flag is set */
+    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_USERNAME))
+    {
+        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_username, 
+                                              client_ptr -> nxd_mqtt_client_username_length, wait_option);
+    }
+
+    /* Fill password if password flag is set */
+    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_PASSWORD))
+    {
+        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_password, 
+                                              client_ptr -> nxd_mqtt_client_password_length, wait_option);
+    }
+
+    if (ret)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+    /* Keep the encoding for the next connections, before TLS encrypts the packet in place. */
+    if (client_ptr -> nxd_mqtt_client_connect_cache &&
+        (packet_ptr -> nx_packet_length <= client_ptr -> nxd_mqtt_client_connect_cache_size) &&
+        (nx_packet_data_extract_offset(packet_ptr, 0, client_ptr -> nxd_mqtt_client_connect_cache,
+                                       client_ptr -> nxd_mqtt_client_connect_cache_size, &bytes_copied) == NX_SUCCESS))
+    {
+        client_ptr -> nxd_mqtt_client_connect_cache_length = bytes_copied;
+        client_ptr -> nxd_mqtt_client_connect_cache_keepalive = client_ptr -> nxd_mqtt_keepalive;
+        client_ptr -> nxd_mqtt_client_connect_cache_clean_session = client_ptr -> nxd_mqtt_clean_session;
+    }
+
+    return(_nxd_mqtt_client_connect_packet_transmit(client_ptr, packet_ptr, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect_packet_transmit            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sends a CONNECT packet, encoded or taken     */
+/*    from the CONNECT cache, to the MQTT server. The packet is released  */
+/*    when the send fails.                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            CONNECT packet                */
+/*    wait_option                           Timeout value                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_release                                                   */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect_packet_send                                */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_connect_packet_transmit(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
+{
+UINT status;
+
+    /* Ready to send the connect message to the server. */
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
+    }
+    else
+    {
+        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+    }
+#else
+    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+
+#endif /* NX_SECURE_ENABLE */
+
+    if (status)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+    }
+
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_secure_connect                     PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function makes an initial secure (TLS) connection to           */
+/*    the MQTT server.                                                    */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    server_ip                             Server IP address structure   */
+/*    server_port                           Server port number, in host   */
+/*                                            byte order                  */
+/*    tls_setup                             User-supplied callback        */
+/*                                            function to set up TLS      */
+/*                                            parameters.                 */
+/*    username                              User name, or NULL if user    */
+/*                                            name is not required        */
+/*    username_length                       Length of the user name, or   */
+/*                                            0 if user name is NULL      */
+/*    password                              Password string, or NULL if   */
+/*                                            password is not required    */
+/*    password_length                       Length of the password, or    */
+/*                                            0 if password is NULL       */
+/*    connection_flag                       Flag passed to the server     */
+/*    timeout                               Timeout value                 */
+/*                                                                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
+/*                                            call                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_ENABLE
+UINT _nxd_mqtt_client_secure_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
+                                     UINT (*tls_setup)(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESSION *,
+                                                       NX_SECURE_X509_CERT *, NX_SECURE_X509_CERT *),
+                                     UINT keepalive, UINT clean_session, ULONG wait_option)
+{
+UINT ret;
+
+    /* Set up TLS session information. */
+    ret = (*tls_setup)(client_ptr, &client_ptr -> nxd_mqtt_tls_session,
+                       &client_ptr -> nxd_mqtt_tls_certificate,
+                       &client_ptr -> nxd_mqtt_tls_trusted_certificate);
+
+    if (ret)
+    {
+        return(ret);
+    }
+
+    /* Mark the connection as secure. */
+    client_ptr -> nxd_mqtt_client_use_tls = 1;
+
+    ret = _nxd_mqtt_client_connect(client_ptr, server_ip, server_port, keepalive, clean_session, wait_option);
+
+    return(ret);
+}
+
+#endif /* NX_SECURE_ENABLE */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_delete                             PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function deletes a previously created MQTT client instance.    */
+/*    If the NXD_MQTT_SOCKET_TIMEOUT is set to NX_WAIT_FOREVER, this may  */
+/*    suspend infinitely. This is because the MQTT Client must            */
+/*    disconnect with the server, and if the network link is disabled or  */
+/*    the server is not responding, this will blocks this function from   */
+/*    completing.                                                         */ 
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_event_flags_set                                                  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr)
+{
+
+
+    /* Set the event flag for DELETE. Next time when the MQTT client thread
+       wakes up, it will perform the deletion process. */
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+    /* There is no client thread, perform the deletion in the caller. */
+    _nxd_mqtt_client_event_process(client_ptr, NX_NULL, MQTT_DELETE_EVENT);
+#elif !defined(NXD_MQTT_CLOUD_ENABLE)
+    tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_DELETE_EVENT, TX_OR);
+#else
+    nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_DELETE_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    /* Check if the MQTT client thread has completed. */
+    while((client_ptr -> nxd_mqtt_client_socket).nx_tcp_socket_id != 0) 
+    {
+        tx_thread_sleep(NX_IP_PERIODIC_RATE);
+    }
+
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP)
+    /* No thread to delete. */
+#elif !defined(NXD_MQTT_CLOUD_ENABLE)
+    /* Now we can delete the Client instance. */
+    tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
+#else
+    /* Deregister mqtt module from cloud helper.  */
+    nx_cloud_module_deregister(client_ptr -> nxd_mqtt_client_cloud_ptr, &(client_ptr -> nxd_mqtt_client_cloud_module));
+
+    /* Delete own created cloud.  */
+    if (client_ptr -> nxd_mqtt_client_cloud.nx_cloud_id == NX_CLOUD_ID)
+        nx_cloud_delete(&(client_ptr -> nxd_mqtt_client_cloud));
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_send                PORTABLE C      */
+/*                                                           6.1.8        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends a publish packet to the connected broker.       */
+/*    While a publish batch is open, the packet is added to the batch     */
+/*    instead and sent by nxd_mqtt_client_publish_batch_flush.            */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to publish packet     */
+/*    packet_id                             Current packet ID             */
+/*    QoS                                   Quality of service            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_transmit                            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  08-02-2021     Yuxin Zhou               Modified comment(s),          */
+/*                                            supported maximum transmit  */
+/*                                            queue depth,                */
+/*                                            resulting in version 6.1.8  */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_publish_packet_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                          USHORT packet_id, UINT QoS, ULONG wait_option)
+{
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    NXD_MQTT_LATENCY_PUBLISH_TIME(packet_ptr) = NXD_MQTT_LATENCY_TIME();
+    NXD_MQTT_LATENCY_SENT(packet_ptr) = NX_FALSE;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    return(_nxd_mqtt_client_publish_packet_transmit(client_ptr, packet_ptr, packet_id, QoS, NXD_MQTT_LANE_BULK, 0, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_publish_topic_strip                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function removes the topic of an outgoing publish     */
+/*    packet, leaving an empty topic. The fixed header and the topic      */
+/*    length are moved forward over the topic and the remaining length is */
+/*    shortened. The packet is left unchanged when the topic is not in    */
+/*    the first packet of the chain.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Pointer to publish packet     */
+/*    topic_length                          Length of the topic           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_read_remaining_length                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_transmit                            */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_publish_topic_strip(NX_PACKET *packet_ptr, UINT topic_length)
+{
+UINT   remaining_length;
+ULONG  offset;
+UCHAR  fixed_header;
+UCHAR *ptr;
+UINT   header_size = 2;
+
+    if (_nxd_mqtt_read_remaining_length(packet_ptr, &remaining_length, &offset) ||
+        (remaining_length < topic_length) ||
+        ((ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) < offset + 2 + topic_length))
+    {
+        return;
+    }
+
+    fixed_header = *(packet_ptr -> nx_packet_prepend_ptr);
+    remaining_length -= topic_length;
+
+    /* Size the new fixed header. */
+    if (remaining_length > 127)
+    {
+        header_size++;
+    }
+    if (remaining_length > 16383)
+    {
+        header_size++;
+    }
+    if (remaining_length > 2097151)
+    {
+        header_size++;
+    }
+
+    /* Write the fixed header and an empty topic right before the end of the topic. */
+    ptr = packet_ptr -> nx_packet_prepend_ptr + offset + 2 + topic_length - header_size - 2;
+    packet_ptr -> nx_packet_length -= (ULONG)(ptr - packet_ptr -> nx_packet_prepend_ptr);
+    packet_ptr -> nx_packet_prepend_ptr = ptr;
+
+    *ptr++ = fixed_header;
+    do
+    {
+        *ptr = remaining_length & 0x7F;
+        remaining_length = remaining_length >> 7;
+        if (remaining_length)
+        {
+            *ptr = *ptr | 0x80;
+        }
+        ptr++;
+    } while (remaining_length);
+    *ptr++ = 0;
+    *ptr = 0;
+}
+
+
+#ifdef NXD_MQTT_V5_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_topic_alias_get                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function returns the topic alias of an outgoing       */
+/*    publish, zero if the topic is not given one. A new topic takes a    */
+/*    free alias, or the next one on rotation that is not being sent.     */
+/*    Until an alias is established with the server, the publish carries  */
+/*    the full topic along with the alias, and must be followed by a call */
+/*    to _nxd_mqtt_topic_alias_sent. The caller holds the client mutex.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Topic of the publish          */
+/*    topic_name_length                     Length of the topic           */
+/*    established_ptr                       Pointer to the flag set when  */
+/*                                            the topic can be omitted    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    alias                                 Topic alias, or zero          */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish                                            */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_topic_alias_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      UINT *established_ptr)
+{
+NXD_MQTT_TOPIC_ALIAS *alias_ptr = NX_NULL;
+UINT                  i;
+UINT                  index = 0;
+
+    *established_ptr = NX_FALSE;
+
+    if (topic_name_length > NXD_MQTT_TOPIC_ALIAS_TOPIC_SIZE)
+    {
+        return(0);
+    }
+
+    /* Look for the topic. */
+    for (i = 0; i < client_ptr -> nxd_mqtt_client_topic_alias_maximum; i++)
+    {
+        alias_ptr = &(client_ptr -> nxd_mqtt_client_topic_alias[i]);
+        if ((alias_ptr -> nxd_mqtt_topic_alias_topic_length == topic_name_length) &&
+            (NXD_MQTT_SECURE_MEMCMP(alias_ptr -> nxd_mqtt_topic_alias_topic, topic_name, topic_name_length) == 0))
+        {
+            if (alias_ptr -> nxd_mqtt_topic_alias_established)
+            {
+                *established_ptr = NX_TRUE;
+            }
+            else
+            {
+                alias_ptr -> nxd_mqtt_topic_alias_pending++;
+            }
+            return(i + 1);
+        }
+    }
+
+    /* Take a free alias, else reassign one that no publish is using. */
+    for (i = 0; i < client_ptr -> nxd_mqtt_client_topic_alias_maximum; i++)
+    {
+        index = (client_ptr -> nxd_mqtt_client_topic_alias_next + i) % client_ptr -> nxd_mqtt_client_topic_alias_maximum;
+        alias_ptr = &(client_ptr -> nxd_mqtt_client_topic_alias[index]);
+        if (alias_ptr -> nxd_mqtt_topic_alias_topic_length == 0)
+        {
+            break;
+        }
+    }
+
+    if (i == client_ptr -> nxd_mqtt_client_topic_alias_maximum)
+    {
+        for (i = 0; i < client_ptr -> nxd_mqtt_client_topic_alias_maximum; i++)
+        {
+            index = (client_ptr -> nxd_mqtt_client_topic_alias_next + i) % client_ptr -> nxd_mqtt_client_topic_alias_maximum;
+            alias_ptr = &(client_ptr -> nxd_mqtt_client_topic_alias[index]);
+            if (alias_ptr -> nxd_mqtt_topic_alias_pending == 0)
+            {
+                break;
+            }
+        }
+
+        if (i == client_ptr -> nxd_mqtt_client_topic_alias_maximum)
+        {
+
+            /* No alias is available, send the full topic only. */
+            return(0);
+        }
+    }
+
+    client_ptr -> nxd_mqtt_client_topic_alias_next = (index + 1) % client_ptr -> nxd_mqtt_client_topic_alias_maximum;
+
+    NXD_MQTT_SECURE_MEMCPY(alias_ptr -> nxd_mqtt_topic_alias_topic, topic_name, topic_name_length);
+    alias_ptr -> nxd_mqtt_topic_alias_topic_length = topic_name_length;
+    alias_ptr -> nxd_mqtt_topic_alias_established = NX_FALSE;
+    alias_ptr -> nxd_mqtt_topic_alias_pending = 1;
+
+    return(index + 1);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_topic_alias_sent                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function records that a publish carrying the full     */
+/*    topic along with its alias has been handed to the network. Once     */
+/*    one is sent, the publishes that follow omit the topic.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    alias                                 Topic alias                   */
+/*    status                                Status of the publish         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish                                            */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nxd_mqtt_topic_alias_sent(NXD_MQTT_CLIENT *client_ptr, UINT alias, UINT status)
+{
+NXD_MQTT_TOPIC_ALIAS *alias_ptr = &(client_ptr -> nxd_mqtt_client_topic_alias[alias - 1]);
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    /* The table is cleared when a new connection is accepted. */
+    if (alias_ptr -> nxd_mqtt_topic_alias_pending)
+    {
+        alias_ptr -> nxd_mqtt_topic_alias_pending--;
+        if (status == NXD_MQTT_SUCCESS)
+        {
+            alias_ptr -> nxd_mqtt_topic_alias_established = NX_TRUE;
+        }
+    }
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+}
+#endif /* NXD_MQTT_V5_ENABLE */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_transmit            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sends a publish packet to the connected      */
+/*    broker, or adds it to the open publish batch. The packet is copied  */
+/*    for retransmission first, unless the message is copied into the     */
+/*    open batch: the packet itself is then kept for retransmission and   */
+/*    no second packet is taken from the pool. When topic_strip_length is */
+/*    not zero, the message is always copied, and the topic of the packet */
+/*    sent is then removed, leaving the Topic Alias property to name it,  */
+/*    while the copy keeps the full topic. A packet of the control lane   */
+/*    is sent at once, ahead of the open batch.                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to publish packet     */
+/*    packet_id                             Current packet ID             */
+/*    QoS                                   Quality of service            */
+/*    lane                                  Publish lane                  */
+/*    topic_strip_length                    Length of the topic to remove */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_packet_release                                                   */
+/*    nx_packet_data_append                                               */
+/*    _nxd_mqtt_copy_transmit_packet                                      */
+/*    _nxd_mqtt_publish_topic_strip                                       */
+/*    _nxd_mqtt_client_publish_batch_send                                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_send                                */
+/*    _nxd_mqtt_client_publish                                            */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_publish_packet_transmit(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                     USHORT packet_id, UINT QoS, UINT lane, UINT topic_strip_length,
+                                                     ULONG wait_option)
+{
+
+UINT       status;
+UINT       ret = NXD_MQTT_SUCCESS;
+NX_PACKET *flush_packet_ptr = NX_NULL;
+UINT       batched = NX_FALSE;
+UINT       copied = NX_FALSE;
+ULONG      batch_size = NXD_MQTT_PUBLISH_BATCH_SIZE;
+#ifdef NXD_MQTT_LATENCY_ENABLE
+NX_PACKET *latency_packet_ptr = NX_NULL;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    TRACE_SWO_EVENT(TRACE_SWO_EVENT_MQTT_PUBLISH, client_ptr, packet_id, QoS, packet_ptr -> nx_packet_length)
+
+#if defined(NX_SECURE_ENABLE) && defined(NX_SECURE_TLS_RECORD_SIZE_LIMIT)
+    /* A batch goes out as one TLS record, keep it within the record size the broker accepts. */
+    if (client_ptr -> nxd_mqtt_client_use_tls &&
+        client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit &&
+        (client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit < batch_size))
+    {
+        batch_size = client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit;
+    }
+#endif /* NX_SECURE_ENABLE && NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
+    if ((QoS != 0) && (topic_strip_length == 0) && (lane != NXD_MQTT_LANE_CONTROL) &&
+        (packet_ptr -> nx_packet_next == NX_NULL))
+    {
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (status != TX_SUCCESS)
+        {
+            return(NXD_MQTT_MUTEX_FAILURE);
+        }
+
+        /* The batch record carries the message to TCP, so the packet itself can be
+           kept for retransmission. Check the queue has room before appending. */
+        if (client_ptr -> nxd_mqtt_client_batch_enabled && client_ptr -> nxd_mqtt_client_batch_packet_ptr &&
+#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
+            (client_ptr -> message_transmit_queue_depth < NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH) &&
+#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+            ((client_ptr -> nxd_mqtt_client_inflight_table == NX_NULL) ||
+             (client_ptr -> nxd_mqtt_client_inflight_count < client_ptr -> nxd_mqtt_client_inflight_table_size)) &&
+            (client_ptr -> nxd_mqtt_client_batch_packet_ptr -> nx_packet_length + packet_ptr -> nx_packet_length <= batch_size) &&
+            (nx_packet_data_append(client_ptr -> nxd_mqtt_client_batch_packet_ptr, packet_ptr -> nx_packet_prepend_ptr,
+                                   packet_ptr -> nx_packet_length, client_ptr -> nxd_mqtt_client_packet_pool_ptr,
+                                   NX_NO_WAIT) == NX_SUCCESS))
+        {
+
+            /* Mark the packet as _nxd_mqtt_copy_transmit_packet marks a copy. */
+            *((USHORT *)packet_ptr -> nx_packet_data_start) = packet_id;
+            *(packet_ptr -> nx_packet_prepend_ptr) = (UCHAR)(*(packet_ptr -> nx_packet_prepend_ptr) | MQTT_PUBLISH_DUP_FLAG);
+
+#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
+            client_ptr -> message_transmit_queue_depth++;
+#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+
+            /* Room was checked above, this does not fail. */
+            _nxd_mqtt_transmit_queue_append(client_ptr, packet_ptr);
+
+            /* Update the timeout value. */
+            client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+            return(NXD_MQTT_SUCCESS);
+        }
+
+        /* Copy the packet below, without holding the mutex while waiting for the pool. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    }
+
+    if (QoS != 0)
+    {
+    /* This packet needs to be stored locally for possible retransmission. */
+    NX_PACKET *transmit_packet_ptr;
+
+        /* Copy packet for retransmission. */
+        if (_nxd_mqtt_copy_transmit_packet(client_ptr, packet_ptr, &transmit_packet_ptr,
+                                           packet_id, NX_TRUE, wait_option))
+        {
+            return(NXD_MQTT_PACKET_POOL_FAILURE);
+        }
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (status != TX_SUCCESS)
+        {
+            nx_packet_release(transmit_packet_ptr);
+
+#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
+            /* Decrease the transmit queue depth.  */
+            client_ptr -> message_transmit_queue_depth--;
+#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+            return(NXD_MQTT_MUTEX_FAILURE);
+        }
+
+        if (_nxd_mqtt_transmit_queue_append(client_ptr, transmit_packet_ptr))
+        {
+
+            /* Release the mutex. */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+            return(NXD_MQTT_PACKET_POOL_FAILURE);
+        }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+        latency_packet_ptr = transmit_packet_ptr;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+    }
+    else
+    {
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (status != TX_SUCCESS)
+        {
+            return(NXD_MQTT_MUTEX_FAILURE);
+        }
+    }
+
+    /* Send the topic as its alias, now that the copy for retransmission holds the full topic. */
+    if (topic_strip_length)
+    {
+        _nxd_mqtt_publish_topic_strip(packet_ptr, topic_strip_length);
+    }
+
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    /* Add the packet to the open publish batch. Chained packets and the control lane are not batched. */
+    if (client_ptr -> nxd_mqtt_client_batch_enabled && (packet_ptr -> nx_packet_next == NX_NULL) &&
+        (lane != NXD_MQTT_LANE_CONTROL))
+    {
+        if (client_ptr -> nxd_mqtt_client_batch_packet_ptr == NX_NULL)
+        {
+
+            /* The first packet of the batch carries the ones that follow. */
+            client_ptr -> nxd_mqtt_client_batch_packet_ptr = packet_ptr;
+            batched = NX_TRUE;
+        }
+        else if ((client_ptr -> nxd_mqtt_client_batch_packet_ptr -> nx_packet_length + packet_ptr -> nx_packet_length <= batch_size) &&
+                 (nx_packet_data_append(client_ptr -> nxd_mqtt_client_batch_packet_ptr, packet_ptr -> nx_packet_prepend_ptr,
+                                        packet_ptr -> nx_packet_length, client_ptr -> nxd_mqtt_client_packet_pool_ptr,
+                                        NX_NO_WAIT) == NX_SUCCESS))
+        {
+
+            /* The message was copied into the batch. */
+            copied = NX_TRUE;
+        }
+        else
+        {
+
+            /* The batch is full, send it ahead of this packet to keep the order. */
+            flush_packet_ptr = client_ptr -> nxd_mqtt_client_batch_packet_ptr;
+            client_ptr -> nxd_mqtt_client_batch_packet_ptr = NX_NULL;
+        }
+    }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    if (flush_packet_ptr)
+    {
+
+        /* The messages of the batch go to TCP now, this one after them. */
+        _nxd_mqtt_latency_batch_sent(client_ptr, latency_packet_ptr);
+    }
+    else if (latency_packet_ptr && !batched && !copied)
+    {
+
+        /* Stamped before the send, the PUBACK may release the copy right after it. */
+        NXD_MQTT_LATENCY_SEND_TIME(latency_packet_ptr) = NXD_MQTT_LATENCY_TIME();
+        NXD_MQTT_LATENCY_SENT(latency_packet_ptr) = NX_TRUE;
+    }
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    /* Release the mutex. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    if (copied)
+    {
+        nx_packet_release(packet_ptr);
+        return(NXD_MQTT_SUCCESS);
+    }
+
+    if (batched)
+    {
+        return(NXD_MQTT_SUCCESS);
+    }
+
+    if (flush_packet_ptr)
+    {
+        if (_nxd_mqtt_client_publish_batch_send(client_ptr, flush_packet_ptr, wait_option))
+        {
+            nx_packet_release(flush_packet_ptr);
+            return(NXD_MQTT_COMMUNICATION_FAILURE);
+        }
+
+        /* Start the next batch with this packet. */
+        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+        if (client_ptr -> nxd_mqtt_client_batch_enabled && (client_ptr -> nxd_mqtt_client_batch_packet_ptr == NX_NULL))
+        {
+            client_ptr -> nxd_mqtt_client_batch_packet_ptr = packet_ptr;
+            batched = NX_TRUE;
+        }
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+        if (batched)
+        {
+            return(NXD_MQTT_SUCCESS);
+        }
+    }
+
+    /* Ready to send the connect message to the server. */
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
+    }
+    else
+    {
+        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+    }
+#else
+    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+
+#endif /* NX_SECURE_ENABLE */
+
+    if (status)
+    {
+        ret = NXD_MQTT_COMMUNICATION_FAILURE;
+    }
+
+    return(ret);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_lane_publish_fragments                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function publishes a message given as fragments on a  */
+/*    publish lane. Each fragment is appended to the PUBLISH packet in    */
+/*    turn, so that the message is not assembled in a buffer first.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    iov                                   Fragments of the message      */
+/*    iov_count                             Number of fragments           */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    _nxd_mqtt_lane_token_get                                            */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    _nxd_mqtt_client_set_fixed_header                                   */
+/*    _nxd_mqtt_client_append_message                                     */
+/*    tx_mutex_put                                                        */
+/*    nx_packet_data_append                                               */
+/*    nx_packet_release                                                   */
+/*    _nxd_mqtt_client_publish_packet_transmit                            */
+/*    _nxd_mqtt_topic_alias_get                                           */
+/*    _nxd_mqtt_topic_alias_sent                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_publish                                       */
+/*    _nxd_mqtt_client_publish_iov                                        */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_lane_publish_fragments(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                             NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG wait_option)
+{
+
+NX_PACKET *packet_ptr;
+UINT       status;
+UINT       length = 0;
+UINT       message_length = 0;
+UINT       i;
+UCHAR      flags;
+USHORT     packet_id = 0;
+UINT       ret = NXD_MQTT_SUCCESS;
+#ifdef NXD_MQTT_V5_ENABLE
+UINT       alias;
+UINT       established;
+UCHAR      properties[4];
+UINT       properties_length = 1;
+#endif /* NXD_MQTT_V5_ENABLE */
+#ifdef NXD_MQTT_LATENCY_ENABLE
+ULONG      publish_time = NXD_MQTT_LATENCY_TIME();
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    /* Do nothing if the client is already connected. */
+    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED)
+    {
+        return(NXD_MQTT_NOT_CONNECTED);
+    }
+
+    /* Take a token of the lane before any packet. */
+    status = _nxd_mqtt_lane_token_get(client_ptr, lane, wait_option);
+
+    if (status != NXD_MQTT_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Size of the message, the fragments are copied as they are. */
+    for (i = 0; i < iov_count; i++)
+    {
+        message_length += iov[i].nxd_mqtt_iov_length;
+    }
+
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, topic_name_length + message_length + 7);
+
+    if (status != NXD_MQTT_SUCCESS)
+    {
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    /* The wait for a token of the lane counts in the queueing delay. */
+    NXD_MQTT_LATENCY_PUBLISH_TIME(packet_ptr) = publish_time;
+    NXD_MQTT_LATENCY_SENT(packet_ptr) = NX_FALSE;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    flags = (UCHAR)((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | (QoS << 1));
+
+    if (retain)
+    {
+        flags = flags | MQTT_PUBLISH_RETAIN;
+    }
+
+
+    /* Compute the remaining length. */
+
+    /* Topic Name. */
+    /* Compute Topic Name length. */
+    length = topic_name_length + 2;
+
+    /* Count packet ID for QoS 1 or QoS 2 message. */
+    if ((QoS == 1) || (QoS == 2))
+    {
+        length += 2;
+    }
+
+    /* Count message. */
+    length += message_length;
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Name the topic by its alias when the server accepts topic aliases. */
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    alias = _nxd_mqtt_topic_alias_get(client_ptr, topic_name, topic_name_length, &established);
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    properties[0] = 0;
+    if (alias)
+    {
+        properties[0] = 3;
+        properties[1] = MQTT_PROPERTY_TOPIC_ALIAS;
+        properties[2] = (UCHAR)(alias >> 8);
+        properties[3] = (UCHAR)(alias & 0xFF);
+        properties_length = 4;
+    }
+
+    /* Count the properties. */
+    length += properties_length;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Write out the control header and remaining length field. */
+    ret = _nxd_mqtt_client_set_fixed_header(client_ptr, packet_ptr, flags, length, wait_option);
+
+    /* Write out topic */
+    if (!ret)
+    {
+        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, topic_name, topic_name_length, wait_option);
+    }
+
+    /* Append Packet Identifier for QoS level 1 or 2  MQTT 3.3.2.2 */
+    if (!ret && ((QoS == 1) || (QoS == 2)))
+    {
+    UCHAR identifier[2];
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (status != TX_SUCCESS)
+        {
+            ret = NXD_MQTT_MUTEX_FAILURE;
+        }
+        else
+        {
+            packet_id = (USHORT)client_ptr -> nxd_mqtt_client_packet_identifier;
+            identifier[0] = (UCHAR)(client_ptr -> nxd_mqtt_client_packet_identifier >> 8);
+            identifier[1] = (client_ptr -> nxd_mqtt_client_packet_identifier & 0xFF);
+
+            /* Update packet id. */
+            client_ptr -> nxd_mqtt_client_packet_identifier = (client_ptr -> nxd_mqtt_client_packet_identifier + 1) & 0xFFFF;
+
+            /* Prevent packet identifier from being zero. MQTT-2.3.1-1 */
+            if(client_ptr -> nxd_mqtt_client_packet_identifier == 0)
+                client_ptr -> nxd_mqtt_client_packet_identifier = 1;
+
+            /* Release the mutex. */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+            ret = nx_packet_data_append(packet_ptr, identifier, 2,
+                                        client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+        }
+    }
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* Append the properties. */
+    if (!ret)
+    {
+        ret = nx_packet_data_append(packet_ptr, properties, properties_length,
+                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Append message. */
+    for (i = 0; !ret && (i < iov_count); i++)
+    {
+        if (iov[i].nxd_mqtt_iov_length == 0)
+        {
+            continue;
+        }
+
+        /* Use nx_packet_data_append to move user-supplied message data into the packet.
+           nx_packet_data_append uses chained packet if the additional storage space is 
+           needed. */
+        ret = nx_packet_data_append(packet_ptr, iov[i].nxd_mqtt_iov_base, iov[i].nxd_mqtt_iov_length,
+                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
+
+    if (ret)
+    {
+
+        /* Unable to build the packet. */
+#ifdef NXD_MQTT_V5_ENABLE
+        if (alias && !established)
+        {
+            _nxd_mqtt_topic_alias_sent(client_ptr, alias, ret);
+        }
+#endif /* NXD_MQTT_V5_ENABLE */
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        if (ret != NXD_MQTT_MUTEX_FAILURE)
+        {
+            ret = NXD_MQTT_INTERNAL_ERROR;
+        }
+        return(ret);
+    }
+
+    /* Send publish packet. */
+#ifndef NXD_MQTT_V5_ENABLE
+    ret = _nxd_mqtt_client_publish_packet_transmit(client_ptr, packet_ptr, packet_id, QoS, lane, 0, wait_option);
+#else
+    /* Leave out the topic once the server knows its alias. */
+    ret = _nxd_mqtt_client_publish_packet_transmit(client_ptr, packet_ptr, packet_id, QoS, lane,
+                                                   established ? topic_name_length : 0, wait_option);
+
+    if (alias && !established)
+    {
+        _nxd_mqtt_topic_alias_sent(client_ptr, alias, ret);
+    }
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    if (ret)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+    }
+    return(ret);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_publish                       PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function publishes a message to the connected broker on a      */
+/*    publish lane. When the rate limit of the lane is reached, it waits  */
+/*    for the next token up to wait_option, or returns                    */
+/*    NXD_MQTT_RATE_LIMITED.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag, whether      */
+/*                                            or not the broker should    */
+/*                                            store this message          */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_lane_publish_fragments                                    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*    _nxd_mqtt_client_publish                                            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_lane_publish(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                   CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+{
+
+NXD_MQTT_IOV iov;
+
+    iov.nxd_mqtt_iov_base = message;
+    iov.nxd_mqtt_iov_length = message ? message_length : 0;
+
+    return(_nxd_mqtt_lane_publish_fragments(client_ptr, lane, topic_name, topic_name_length, &iov, 1,
+                                            retain, QoS, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function publishes a message to the connected broker, on the   */
+/*    bulk lane.                                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_publish                                       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                              CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+{
+
+    return(_nxd_mqtt_client_lane_publish(client_ptr, NXD_MQTT_LANE_BULK, topic_name, topic_name_length,
+                                         message, message_length, retain, QoS, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_iov                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function publishes a message given as an array of fragments to */
+/*    the connected broker, on the bulk lane. The fragments, for example a*/
+/*    header, a batch of samples and a trailer, are appended one after the*/
+/*    other straight into the PUBLISH packet, the message is their        */
+/*    concatenation. Fragments of length 0 are skipped. The fragments are */
+/*    copied before the function returns.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    iov                                   Fragments of the message      */
+/*    iov_count                             Number of fragments           */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_lane_publish_fragments                                    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_publish_iov(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                  NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG wait_option)
+{
+
+    return(_nxd_mqtt_lane_publish_fragments(client_ptr, NXD_MQTT_LANE_BULK, topic_name, topic_name_length,
+                                            iov, iov_count, retain, QoS, wait_option));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_topic_prepare                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encodes a topic once for its publishes: the first     */
+/*    byte of the fixed header with the QoS and retain flags, and the     */
+/*    topic with its length. nxd_mqtt_client_prepared_publish copies the  */
+/*    template ahead of each message instead of encoding the topic again. */
+/*    The prepared topic is not tied to a client.                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    topic_ptr                             Pointer to prepared topic     */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_topic_prepare(NXD_MQTT_PREPARED_TOPIC *topic_ptr, CHAR *topic_name, UINT topic_name_length,
+                                    UINT retain, UINT QoS)
+{
+
+    if (topic_name_length > NXD_MQTT_PREPARED_TOPIC_SIZE)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    topic_ptr -> nxd_mqtt_prepared_topic_header = (UCHAR)((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | (QoS << 1));
+    if (retain)
+    {
+        topic_ptr -> nxd_mqtt_prepared_topic_header |= MQTT_PUBLISH_RETAIN;
+    }
+    topic_ptr -> nxd_mqtt_prepared_topic_qos = (UCHAR)QoS;
+
+    topic_ptr -> nxd_mqtt_prepared_topic_template[0] = (UCHAR)(topic_name_length >> 8);
+    topic_ptr -> nxd_mqtt_prepared_topic_template[1] = (UCHAR)(topic_name_length & 0xFF);
+    NXD_MQTT_SECURE_MEMCPY(&topic_ptr -> nxd_mqtt_prepared_topic_template[2], topic_name, topic_name_length); /* Use case of memcpy is verified. */
+    topic_ptr -> nxd_mqtt_prepared_topic_length = (USHORT)(topic_name_length + 2);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_prepared_publish                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function publishes a message on a prepared topic to the        */
+/*    connected broker, on the bulk lane. The header of the packet is the */
+/*    template of the topic, with the remaining length and the packet ID  */
+/*    filled in, appended in one piece ahead of the message. The topic is */
+/*    always sent in full, without a topic alias.                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_ptr                             Pointer to prepared topic     */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_lane_token_get                                            */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    nx_packet_data_append                                               */
+/*    nx_packet_release                                                   */
+/*    _nxd_mqtt_client_publish_packet_transmit                            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_prepared_publish(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_PREPARED_TOPIC *topic_ptr,
+                                       CHAR *message, UINT message_length, ULONG wait_option)
+{
+
+NX_PACKET *packet_ptr;
+UINT       status;
+UINT       length;
+UINT       QoS = topic_ptr -> nxd_mqtt_prepared_topic_qos;
+USHORT     packet_id = 0;
+UCHAR      header[1 + 4 + NXD_MQTT_PREPARED_TOPIC_SIZE + 2 + 2 + 1];
+UCHAR     *ptr = header;
+#ifdef NXD_MQTT_LATENCY_ENABLE
+ULONG      publish_time = NXD_MQTT_LATENCY_TIME();
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    if (message == NX_NULL)
+    {
+        message_length = 0;
+    }
+
+    /* Do nothing if the client is not connected. */
+    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED)
+    {
+        return(NXD_MQTT_NOT_CONNECTED);
+    }
+
+    /* Take a token of the lane before any packet. */
+    status = _nxd_mqtt_lane_token_get(client_ptr, NXD_MQTT_LANE_BULK, wait_option);
+
+    if (status != NXD_MQTT_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Remaining length: the topic, the packet ID for QoS 1 and 2, the properties and the message. */
+    length = topic_ptr -> nxd_mqtt_prepared_topic_length + message_length;
+    if ((QoS == 1) || (QoS == 2))
+    {
+        length += 2;
+    }
+#ifdef NXD_MQTT_V5_ENABLE
+    length += 1;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Fill in the fixed header. */
+    *ptr++ = topic_ptr -> nxd_mqtt_prepared_topic_header;
+    do
+    {
+        *ptr = (UCHAR)(length & 0x7F);
+        length = length >> 7;
+        if (length)
+        {
+            *ptr = *ptr | 0x80;
+        }
+        ptr++;
+    } while (length);
+
+    /* Copy the topic. */
+    NXD_MQTT_SECURE_MEMCPY(ptr, topic_ptr -> nxd_mqtt_prepared_topic_template, topic_ptr -> nxd_mqtt_prepared_topic_length); /* Use case of memcpy is verified. */
+    ptr += topic_ptr -> nxd_mqtt_prepared_topic_length;
+
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, (ULONG)(ptr - header) + 3 + message_length);
+
+    if (status != NXD_MQTT_SUCCESS)
+    {
+        return(NXD_MQTT_PACKET_POOL_FAILURE);
+    }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    /* The wait for a token of the lane counts in the queueing delay. */
+    NXD_MQTT_LATENCY_PUBLISH_TIME(packet_ptr) = publish_time;
+    NXD_MQTT_LATENCY_SENT(packet_ptr) = NX_FALSE;
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+    /* Fill in the Packet Identifier for QoS level 1 or 2  MQTT 3.3.2.2 */
+    if ((QoS == 1) || (QoS == 2))
+    {
+
+        /* Obtain the mutex. */
+        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (status != TX_SUCCESS)
+        {
+
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+
+            return(NXD_MQTT_MUTEX_FAILURE);
+        }
+
+        packet_id = (USHORT)client_ptr -> nxd_mqtt_client_packet_identifier;
+
+        /* Update packet id. */
+        client_ptr -> nxd_mqtt_client_packet_identifier = (client_ptr -> nxd_mqtt_client_packet_identifier + 1) & 0xFFFF;
+
+        /* Prevent packet identifier from being zero. MQTT-2.3.1-1 */
+        if(client_ptr -> nxd_mqtt_client_packet_identifier == 0)
+            client_ptr -> nxd_mqtt_client_packet_identifier = 1;
+
+        /* Release the mutex. */
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+        *ptr++ = (UCHAR)(packet_id >> 8);
+        *ptr++ = (UCHAR)(packet_id & 0xFF);
+    }
+
+#ifdef NXD_MQTT_V5_ENABLE
+    /* No property. */
+    *ptr++ = 0;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+    /* Append the header in one piece, then the message. */
+    status = nx_packet_data_append(packet_ptr, header, (ULONG)(ptr - header),
+                                   client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+
+    if (!status && message_length)
+    {
+        status = nx_packet_data_append(packet_ptr, message, message_length,
+                                       client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
+    }
+
+    if (status)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    /* Send publish packet. */
+    status = _nxd_mqtt_client_publish_packet_transmit(client_ptr, packet_ptr, packet_id, QoS, NXD_MQTT_LANE_BULK, 0, wait_option);
+
+    if (status)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+    }
+    return(status);
+}
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_lane_token_get                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function takes a token from the bucket of a publish   */
+/*    lane, after adding the tokens of the ticks elapsed since the last   */
+/*    count. Without a token, it sleeps until the next one as long as     */
+/*    wait_option allows. The mutex is not held while sleeping.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    tx_time_get                                                         */
+/*    tx_thread_sleep                                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_lane_publish_fragments                                    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_lane_token_get(NXD_MQTT_CLIENT *client_ptr, UINT lane, ULONG wait_option)
+{
+
+NXD_MQTT_LANE *lane_ptr = &(client_ptr -> nxd_mqtt_client_lanes[lane]);
+ULONG          current_time;
+ULONG          elapsed;
+ULONG          ticks;
+
+    for (;;)
+    {
+        tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+        if (lane_ptr -> nxd_mqtt_lane_rate == 0)
+        {
+
+            /* No limit on this lane. */
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(NXD_MQTT_SUCCESS);
+        }
+
+        /* Refill the bucket, without overflowing the product after a long idle time. */
+        current_time = tx_time_get();
+        elapsed = current_time - lane_ptr -> nxd_mqtt_lane_update_time;
+        lane_ptr -> nxd_mqtt_lane_update_time = current_time;
+
+        if (elapsed >= (lane_ptr -> nxd_mqtt_lane_capacity - lane_ptr -> nxd_mqtt_lane_tokens) / lane_ptr -> nxd_mqtt_lane_rate)
+        {
+            lane_ptr -> nxd_mqtt_lane_tokens = lane_ptr -> nxd_mqtt_lane_capacity;
+        }
+        else
+        {
+            lane_ptr -> nxd_mqtt_lane_tokens += elapsed * lane_ptr -> nxd_mqtt_lane_rate;
+        }
+
+        if (lane_ptr -> nxd_mqtt_lane_tokens >= NX_IP_PERIODIC_RATE)
+        {
+            lane_ptr -> nxd_mqtt_lane_tokens -= NX_IP_PERIODIC_RATE;
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(NXD_MQTT_SUCCESS);
+        }
+
+        /* Ticks until the next token. */
+        ticks = (NX_IP_PERIODIC_RATE - lane_ptr -> nxd_mqtt_lane_tokens + lane_ptr -> nxd_mqtt_lane_rate - 1) /
+                lane_ptr -> nxd_mqtt_lane_rate;
+
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+        if ((wait_option != NX_WAIT_FOREVER) && (ticks > wait_option))
+        {
+            return(NXD_MQTT_RATE_LIMITED);
+        }
+
+        if (wait_option != NX_WAIT_FOREVER)
+        {
+            wait_option -= ticks;
+        }
+
+        tx_thread_sleep(ticks);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_rate_set                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function limits the publishes of a lane to rate messages per   */
+/*    second, with bursts of up to burst messages after an idle time. The */
+/*    bucket starts full. A rate of 0 removes the limit.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    rate                                  Messages per second           */
+/*    burst                                 Messages sent back to back    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    tx_time_get                                                         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_lane_rate_set(NXD_MQTT_CLIENT *client_ptr, UINT lane, UINT rate, UINT burst)
+{
+
+NXD_MQTT_LANE *lane_ptr = &(client_ptr -> nxd_mqtt_client_lanes[lane]);
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    lane_ptr -> nxd_mqtt_lane_rate = rate;
+    lane_ptr -> nxd_mqtt_lane_capacity = (ULONG)burst * NX_IP_PERIODIC_RATE;
+    lane_ptr -> nxd_mqtt_lane_tokens = lane_ptr -> nxd_mqtt_lane_capacity;
+    lane_ptr -> nxd_mqtt_lane_update_time = tx_time_get();
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_latency_get                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies the latency histograms of the QoS 1 and QoS 2  */
+/*    messages acknowledged so far, and clears them on request so that    */
+/*    the next copy covers the messages acknowledged since.               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    latency_ptr                           Histograms copied             */
+/*    reset                                 Clear after the copy          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    memcpy                                                              */
+/*    memset                                                              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_latency_get(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_LATENCY *latency_ptr, UINT reset)
+{
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    NXD_MQTT_SECURE_MEMCPY(latency_ptr, &(client_ptr -> nxd_mqtt_client_latency), sizeof(NXD_MQTT_LATENCY)); /* Use case of memcpy is verified. */
+
+    if (reset)
+    {
+        NXD_MQTT_SECURE_MEMSET(&(client_ptr -> nxd_mqtt_client_latency), 0, sizeof(NXD_MQTT_LATENCY));
+    }
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_batch_send                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function sends a batch of publish packets to the      */
+/*    broker as one TCP send, or one TLS record on a secure connection.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Pointer to batch packet       */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_packet_send                                */
+/*    _nxd_mqtt_client_publish_batch_flush                                */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_client_publish_batch_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
+{
+
+UINT status;
+
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
+    }
+    else
+    {
+        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+    }
+#else
+    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+#endif /* NX_SECURE_ENABLE */
+
+    if (status)
+    {
+        return(NXD_MQTT_COMMUNICATION_FAILURE);
+    }
+
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_batch_begin                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function opens a publish batch. The messages published until   */
+/*    nxd_mqtt_client_publish_batch_flush is called are packed into one   */
+/*    packet, up to NXD_MQTT_PUBLISH_BATCH_SIZE bytes, and sent together, */
+/*    so that small messages share one TLS record and one TCP segment.    */
+/*    A full batch is sent early, when the next message does not fit.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_publish_batch_begin(NXD_MQTT_CLIENT *client_ptr)
+{
+
+    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED)
+    {
+        return(NXD_MQTT_NOT_CONNECTED);
+    }
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    client_ptr -> nxd_mqtt_client_batch_enabled = NX_TRUE;
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_batch_flush                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends the messages collected since                    */
+/*    nxd_mqtt_client_publish_batch_begin and closes the batch.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    nx_packet_release                                                   */
+/*    _nxd_mqtt_client_publish_batch_send                                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_publish_batch_flush(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+
+NX_PACKET *packet_ptr;
+UINT       ret = NXD_MQTT_SUCCESS;
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    packet_ptr = client_ptr -> nxd_mqtt_client_batch_packet_ptr;
+    client_ptr -> nxd_mqtt_client_batch_packet_ptr = NX_NULL;
+    client_ptr -> nxd_mqtt_client_batch_enabled = NX_FALSE;
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    if (packet_ptr)
+    {
+        _nxd_mqtt_latency_batch_sent(client_ptr, NX_NULL);
+    }
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    if (packet_ptr)
+    {
+        ret = _nxd_mqtt_client_publish_batch_send(client_ptr, packet_ptr, wait_option);
+
+        if (ret)
+        {
+
+            /* Release the packet. */
+            nx_packet_release(packet_ptr);
+        }
+    }
+
+    return(ret);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_subscribe                          PORTABLE C      */
+/*                                                           6.1.2        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends a subscribe message to the broker.              */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Pointer to the topic string   */
+/*                                            to subscribe to             */
+/*    topic_name_length                     Length of the topic string    */
+/*                                            in bytes                    */
+/*    QoS                                   Expected QoS level            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub            The actual routine that       */
+/*                                            performs the sub/unsub      */
+/*                                            action.                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  11-09-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            added packet id parameter,  */
+/*                                            resulting in version 6.1.2  */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS)
+{
+
+    if (QoS == 2)
+    {
+        return(NXD_MQTT_QOS2_NOT_SUPPORTED);
+    }
+
+    return(_nxd_mqtt_client_sub_unsub(client_ptr, (MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02,
+                                      topic_name, topic_name_length, NX_NULL, QoS));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_subscribe_list                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function subscribes to the topic filters of the list, packed   */
+/*    into as few SUBSCRIBE messages as NXD_MQTT_SUBSCRIBE_FILTERS_MAX,   */
+/*    the Maximum Packet Size of the broker and the TLS record size limit */
+/*    allow, sent without waiting for their SUBACKs. The list must stay   */
+/*    valid until the SUBACKs: each one sets the reason codes of its      */
+/*    filters, which are NXD_MQTT_TOPIC_FILTER_PENDING until then. The    */
+/*    list replaces the one of a previous call.                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    filter_list                           Pointer to the topic filters  */
+/*    filter_count                          Number of topic filters       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Obtain protection mutex       */
+/*    tx_mutex_put                          Release protection mutex      */
+/*    _nxd_mqtt_client_sub_unsub_send       Send a subscribe message      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_subscribe_list(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count)
+{
+UINT  status;
+UINT  first;
+UINT  count;
+ULONG length;
+ULONG filter_length;
+ULONG size_limit = 0;
+
+
+    for (first = 0; first < filter_count; first++)
+    {
+        if (filter_list[first].nxd_mqtt_topic_filter_qos == 2)
+        {
+            return(NXD_MQTT_QOS2_NOT_SUPPORTED);
+        }
+    }
+
+    /* Obtain the mutex. */
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (status != TX_SUCCESS)
+    {
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+
+    /* The SUBACKs set their reason codes in this list from now on.  */
+    client_ptr -> nxd_mqtt_client_filter_list = filter_list;
+    client_ptr -> nxd_mqtt_client_filter_list_count = filter_count;
+
+#ifdef NXD_MQTT_V5_ENABLE
+    size_limit = client_ptr -> nxd_mqtt_client_maximum_packet_size;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+#if defined(NX_SECURE_ENABLE) && defined(NX_SECURE_TLS_RECORD_SIZE_LIMIT)
+    /* A SUBSCRIBE goes out as one TLS record, keep it within the record size the broker accepts. */
+    if (client_ptr -> nxd_mqtt_client_use_tls &&
+        client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit &&
+        ((size_limit == 0) || (client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit < size_limit)))
+    {
+        size_limit = client_ptr -> nxd_mqtt_tls_session.nx_secure_tls_send_record_size_limit;
+    }
+#endif /* NX_SECURE_ENABLE && NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
+    /* Release the mutex. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    for (first = 0; first < filter_count; first += count)
+    {
+
+        /* Count the packet ID, and the property length of MQTT 5.  */
+#ifdef NXD_MQTT_V5_ENABLE
+        length = 3;
+#else
+        length = 2;
+#endif /* NXD_MQTT_V5_ENABLE */
+
+        /* Take the filters that fit, with the fixed header of up to 5 bytes. A filter
+           too long to fit alone is sent alone.  */
+        for (count = 0; (first + count < filter_count) && (count < NXD_MQTT_SUBSCRIBE_FILTERS_MAX); count++)
+        {
+            filter_length = 3 + filter_list[first + count].nxd_mqtt_topic_filter_name_length;
+            if (count && size_limit && (length + filter_length + 5 > size_limit))
+            {
+                break;
+            }
+            length += filter_length;
+        }
+
+        status = _nxd_mqtt_client_sub_unsub_send(client_ptr, (MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02,
+                                                 &filter_list[first], count, NX_NULL);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_unsubscribe                        PORTABLE C      */
+/*                                                           6.1.2        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function unsubscribes a topic from the broker.                 */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Pointer to the topic string   */
+/*                                            to subscribe to             */
+/*    topic_name_length                     Length of the topic string    */
+/*                                            in bytes                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_sub_unsub                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  11-09-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            added packet id parameter,  */
+/*                                            resulting in version 6.1.2  */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length)
+{
+    return(_nxd_mqtt_client_sub_unsub(client_ptr, (MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE << 4) | 0x02,
+                                      topic_name, topic_name_length, NX_NULL, 0));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_send_simple_message                       PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function handles the transmission of PINGREQ or       */
+/*    DISCONNECT message.                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    header_value                          Value to be programmed into   */
+/*                                            MQTT header.                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    _nxd_mqtt_packet_allocate                                           */
+/*    tx_mutex_put                                                        */
+/*    nx_tcp_socket_send                                                  */
+/*    nx_secure_tls_session_send                                          */
+/*    nx_packet_release                                                   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_mqtt_client_ping                                               */
+/*    _nxd_mqtt_client_disconnect                                         */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nxd_mqtt_send_simple_message(NXD_MQTT_CLIENT *client_ptr, UCHAR header_value)
+{
+
+NX_PACKET *packet_ptr;
+UINT       status;
+UINT       status_mutex;
+UCHAR     *byte;
+
+    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr, 2);
+    if (status)
+    {
+        return(NXD_MQTT_INTERNAL_ERROR);
+    }
+
+    if (2u > ((ULONG)(packet_ptr -> nx_packet_data_end) - (ULONG)(packet_ptr -> nx_packet_append_ptr)))
+    {
+        nx_packet_release(packet_ptr);
+
+        /* Packet buffer is too small to hold the message. */
+        return(NX_SIZE_ERROR);
+    }
+
+    byte = packet_ptr -> nx_packet_prepend_ptr;
+
+    *byte = (UCHAR)(header_value << 4);
+    *(byte + 1) = 0;
+
+    packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr + 2;
+    packet_ptr -> nx_packet_length = 2;
+
+
+    /* Release MQTT protection before making NetX/TLS calls. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+#ifdef NX_SECURE_ENABLE
+    if (client_ptr -> nxd_mqtt_client_use_tls)
+    {
+        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, NX_WAIT_FOREVER);
+    }
+    else
+    {
+        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
+    }
+#else
+
+    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
+
+#endif /* NX_SECURE_ENABLE */
+
+    status_mutex = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    if (status)
+    {
+
+        /* Release the packet. */
+        nx_packet_release(packet_ptr);
+
+        status = NXD_MQTT_COMMUNICATION_FAILURE;
+    }
+    if (status_mutex)
+    {
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+
+    if (header_value == MQTT_CONTROL_PACKET_TYPE_PINGREQ)
+    {
+        /* Do not update the ping sent time if the outstanding ping has not been responded yet */
+        if (client_ptr -> nxd_mqtt_ping_not_responded != 1)
+        {
+            /* Record the time we send out the PINGREG */
+            client_ptr -> nxd_mqtt_ping_sent_time = tx_time_get();
+            client_ptr -> nxd_mqtt_ping_not_responded = 1;
+        }
+    }
+
+    /* Update the timeout value. */
+    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_disconnect                         PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function disconnects the MQTT client from a server.            */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_send_simple_message                                       */
+/*    _nxd_mqtt_process_disconnect                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr)
+{
+UINT status;
+
+    /* Obtain the mutex. */
+    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
+    if (status != TX_SUCCESS)
+    {
+        /* Disable timer if timer has been started. */
+        if (client_ptr -> nxd_mqtt_keepalive)
+        {
+            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+        }
+
+        return(NXD_MQTT_MUTEX_FAILURE);
+    }
+
+    /* Let the server know we are ending the MQTT session. */
+    _nxd_mqtt_send_simple_message(client_ptr, MQTT_CONTROL_PACKET_TYPE_DISCONNECT);
+
+    /* Call the disconnect routine to disconnect the socket,
+       release transmit packets, release received packets,
+       and delete the client timer. */
+    _nxd_mqtt_process_disconnect(client_ptr);
+
+    /* Release the mutex. */
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_receive_notify_set                 PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function installs the MQTT client publish notify callback      */
+/*    function.                                                           */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    mqtt_client_receive_notify            User-supplied callback        */
+/*                                            function, which is invoked  */
+/*                                            upon receiving a publish    */
+/*                                            message.                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                         VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count))
+{
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    client_ptr -> nxd_mqtt_client_receive_notify = receive_notify;
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_receive_queue_set                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function limits the messages waiting in the receive queue for  */
+/*    nxd_mqtt_client_message_get, to max_messages messages and max_bytes */
+/*    bytes of packets, 0 for no limit, and selects the policy once the   */
+/*    queue is full: drop the oldest QoS 0 messages queued, drop the QoS  */
+/*    0 message received, or stop reading the TCP socket. The messages    */
+/*    dropped are counted in the nxd_mqtt_client_receive_dropped field of */
+/*    the client. QoS 1 and 2 messages are queued over the limits with    */
+/*    the drop policies.                                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    max_messages                          Largest depth of the queue    */
+/*    max_bytes                             Largest size of the queue     */
+/*    policy                                Policy of the full queue      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_receive_queue_resume        Read the TCP socket again     */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_receive_queue_set(NXD_MQTT_CLIENT *client_ptr, UINT max_messages, ULONG max_bytes, UINT policy)
+{
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    client_ptr -> nxd_mqtt_client_receive_queue_messages = max_messages;
+    client_ptr -> nxd_mqtt_client_receive_queue_bytes = max_bytes;
+    client_ptr -> nxd_mqtt_client_receive_queue_policy = policy;
+
+    /* The reading stopped by the previous limits may go on. */
+    _nxd_mqtt_receive_queue_resume(client_ptr);
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_get                        PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function retrieves a published MQTT message.                   */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_buffer                          Pointer to the topic buffer   */
+/*                                            where topic is copied to    */
+/*    topic_buffer_size                     Size of the topic buffer.     */
+/*    actual_topic_length                   Number of bytes copied into   */
+/*                                            topic_buffer                */
+/*    message_buffer                        Pointer to the buffer where   */
+/*                                            message is copied to        */
+/*    message_buffer_size                   Size of the message_buffer    */
+/*    actual_message_length                 Number of bytes copied into   */
+/*                                            the message buffer.         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_disconnect           Actual MQTT Client disconnect */
+/*                                            call                        */
+/*    _nxd_mqtt_read_remaining_length       Skip the remaining length     */
+/*                                            field                       */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            fixed uninitialized value,  */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
+                                  UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
+{
+
+UINT                status;
+NX_PACKET          *packet_ptr;
+ULONG               topic_offset;
+USHORT              topic_length;
+ULONG               message_offset;
+ULONG               message_length;
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    while (client_ptr -> message_receive_queue_depth)
+    {
+        packet_ptr = client_ptr -> message_receive_queue_head;
+        status = _nxd_mqtt_process_publish_packet(packet_ptr, &topic_offset, &topic_length, &message_offset, &message_length);
+        if (status == NXD_MQTT_SUCCESS)
+        {
+            if ((topic_buffer_size < topic_length) ||
+                (message_buffer_size < message_length))
+            {
+                tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+                return(NXD_MQTT_INSUFFICIENT_BUFFER_SPACE);
+            }
+        }
+
+        client_ptr -> message_receive_queue_head = packet_ptr -> nx_packet_queue_next;
+        if (client_ptr -> message_receive_queue_tail == packet_ptr)
+        {
+            client_ptr -> message_receive_queue_tail = NX_NULL;
+        }
+        client_ptr -> message_receive_queue_depth--;
+        client_ptr -> message_receive_queue_bytes -= packet_ptr -> nx_packet_length;
+        _nxd_mqtt_receive_queue_resume(client_ptr);
+
+        if (status == NXD_MQTT_SUCCESS)
+        {
+
+            /* Set topic and message lengths to avoid uninitialized value. */
+            *actual_topic_length = 0;
+            *actual_message_length = 0;
+            nx_packet_data_extract_offset(packet_ptr, topic_offset, topic_buffer,
+                                          topic_length, (ULONG *)actual_topic_length);
+            nx_packet_data_extract_offset(packet_ptr, message_offset, message_buffer,
+                                          message_length, (ULONG *)actual_message_length);
+            nx_packet_release(packet_ptr);
+
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(NXD_MQTT_SUCCESS);
+        }
+        nx_packet_release(packet_ptr);
+    }
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    return(NXD_MQTT_NO_MESSAGE);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_packet_get                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function retrieves a published MQTT message without copying    */
+/*    it. The received packet is removed from the receive queue and       */
+/*    handed to the caller together with the offsets, relative to the     */
+/*    packet prepend pointer, and lengths of the topic and the message.   */
+/*    The message may span a packet chain. The caller owns the packet     */
+/*    and returns it with nxd_mqtt_client_message_packet_release.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Destination for the packet    */
+/*                                            holding the message         */
+/*    topic_offset                          Offset of the topic           */
+/*    topic_length                          Length of the topic           */
+/*    message_offset                        Offset of the message         */
+/*    message_length                        Length of the message         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_process_publish_packet      Parse topic and message       */
+/*    nx_packet_release                     Release invalid packets       */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_message_packet_get(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr,
+                                         ULONG *topic_offset, UINT *topic_length,
+                                         ULONG *message_offset, ULONG *message_length)
+{
+
+UINT                status;
+NX_PACKET          *head_packet_ptr;
+USHORT              topic_size;
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+    while (client_ptr -> message_receive_queue_depth)
+    {
+        head_packet_ptr = client_ptr -> message_receive_queue_head;
+        status = _nxd_mqtt_process_publish_packet(head_packet_ptr, topic_offset, &topic_size, message_offset, message_length);
+
+        client_ptr -> message_receive_queue_head = head_packet_ptr -> nx_packet_queue_next;
+        if (client_ptr -> message_receive_queue_tail == head_packet_ptr)
+        {
+            client_ptr -> message_receive_queue_tail = NX_NULL;
+        }
+        client_ptr -> message_receive_queue_depth--;
+        client_ptr -> message_receive_queue_bytes -= head_packet_ptr -> nx_packet_length;
+        _nxd_mqtt_receive_queue_resume(client_ptr);
+
+        if (status == NXD_MQTT_SUCCESS)
+        {
+
+            /* Hand the packet over, the caller releases it.  */
+            head_packet_ptr -> nx_packet_queue_next = NX_NULL;
+            *packet_ptr = head_packet_ptr;
+            *topic_length = topic_size;
+
+            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+            return(NXD_MQTT_SUCCESS);
+        }
+        nx_packet_release(head_packet_ptr);
+    }
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+    return(NXD_MQTT_NO_MESSAGE);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_packet_release             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function releases a message packet obtained from               */
+/*    nxd_mqtt_client_message_packet_get.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Packet holding the message    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_release                     Release the packet            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxd_mqtt_client_message_packet_release(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+{
+
+    NX_PARAMETER_NOT_USED(client_ptr);
+
+    return(nx_packet_release(packet_ptr));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_create                            PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in nxd_mqt_client_create call.      */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    client_name                           Name string used in by the    */
+/*                                            client                      */
+/*    client_id                             Client ID used by the client  */
+/*    client_id_length                      Length of Client ID, in bytes */
+/*    ip_ptr                                Pointer to IP instance        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    stack_ptr                             Client thread's stack pointer */
+/*    stack_size                            Client thread's stack size    */
+/*    mqtt_thread_priority                  Priority for MQTT thread      */
+/*    memory_ptr                            Deprecated and not used       */
+/*    memory_size                           Deprecated and not used       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_create               Actual client create call     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name, CHAR *client_id, UINT client_id_length,
+                              NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
+                              VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority,
+                              VOID *memory_ptr, ULONG memory_size)
+{
+
+
+    /* Check for invalid input pointers.  */
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+    if ((client_ptr == NX_NULL) || (ip_ptr == NX_NULL) || (ip_ptr -> nx_ip_id != NX_IP_ID) ||
+        (stack_ptr == NX_NULL) || (stack_size == 0) || (pool_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+#else
+    /* No client thread, the stack is not needed. */
+    if ((client_ptr == NX_NULL) || (ip_ptr == NX_NULL) || (ip_ptr -> nx_ip_id != NX_IP_ID) ||
+        (pool_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+    
+    return(_nxd_mqtt_client_create(client_ptr, client_name, client_id, client_id_length, ip_ptr,
+                                   pool_ptr, stack_ptr, stack_size, mqtt_thread_priority,
+                                   memory_ptr, memory_size));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_connect                           PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in MQTT client stop call.           */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    server_ip                             Server IP address structure   */
+/*    server_port                           Server port number, in host   */
+/*                                            byte order                  */
+/*    keepalive                             The MQTT keepalive timer      */
+/*    clean_session                         Clean session flag            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
+/*                                            call                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected mqtt client state,*/
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
+                               UINT keepalive, UINT clean_session, ULONG wait_option)
+{
+
+UINT status;
+
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    if (server_ip == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Test for IP version flag. */
+    if ((server_ip -> nxd_ip_version != 4) && (server_ip -> nxd_ip_version != 6))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    if (server_port == 0)
+    {
+        return(NX_INVALID_PORT);
+    }
+
+    status = _nxd_mqtt_client_connect(client_ptr, server_ip, server_port, keepalive, clean_session, wait_option);
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_secure_connect                    PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in MQTT client TLS secure connect.  */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    server_ip                             Server IP address structure   */
+/*    server_port                           Server port number, in host   */
+/*                                            byte order                  */
+/*    tls_setup                             User-supplied callback        */
+/*                                            function to set up TLS      */
+/*                                            parameters.                 */
+/*    keepalive                             The MQTT keepalive timer      */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
+/*                                            call                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            corrected mqtt client state,*/
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_ENABLE
+
+UINT _nxde_mqtt_client_secure_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
+                                      UINT (*tls_setup)(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESSION *,
+                                                        NX_SECURE_X509_CERT *, NX_SECURE_X509_CERT *),
+                                      UINT keepalive, UINT clean_session, ULONG wait_option)
+{
+
+UINT status;
+
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    if (server_ip == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    if (server_port == 0)
+    {
+        return(NX_INVALID_PORT);
+    }
+
+    status = _nxd_mqtt_client_secure_connect(client_ptr, server_ip, server_port, tls_setup,
+                                             keepalive, clean_session, wait_option);
+
+    return(status);
+}
+#endif /* NX_SECURE_ENABLE */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_delete                            PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in MQTT client delete call.         */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_delete               Actual MQTT Client delete     */
+/*                                            call.                       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr)
+{
+
+UINT status;
+
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    status = _nxd_mqtt_client_delete(client_ptr);
+
+    return(status);
+}
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_publish                           PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs error checking to the publish service.       */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag, whether      */
+/*                                            or not the broker should    */
+/*                                            store this message          */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                               CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate topic_name */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate message length. */
+    if (message && (message_length == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate QoS value. */
+    if (QoS > 3)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_publish(client_ptr, topic_name, topic_name_length, message, message_length, retain, QoS, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_lane_publish                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client lane publish     */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_publish                                       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_lane_publish(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                    CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate lane, topic_name, message length and QoS value. */
+    if ((lane >= NXD_MQTT_LANES) || (topic_name == NX_NULL) || (topic_name_length == 0) ||
+        (message && (message_length == 0)) || (QoS > 3))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_lane_publish(client_ptr, lane, topic_name, topic_name_length, message, message_length,
+                                         retain, QoS, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_publish_iov                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client publish of a     */
+/*    message given as fragments.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    iov                                   Fragments of the message      */
+/*    iov_count                             Number of fragments           */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_iov                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_publish_iov(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                   NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG wait_option)
+{
+
+UINT i;
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate topic_name, the fragments and QoS value. */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0) || (iov_count && (iov == NX_NULL)) || (QoS > 3))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    for (i = 0; i < iov_count; i++)
+    {
+        if (iov[i].nxd_mqtt_iov_length && (iov[i].nxd_mqtt_iov_base == NX_NULL))
+        {
+            return(NXD_MQTT_INVALID_PARAMETER);
+        }
+    }
+
+    return(_nxd_mqtt_client_publish_iov(client_ptr, topic_name, topic_name_length, iov, iov_count, retain, QoS, wait_option));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_topic_prepare                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client topic prepare    */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    topic_ptr                             Pointer to prepared topic     */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_topic_prepare                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_topic_prepare(NXD_MQTT_PREPARED_TOPIC *topic_ptr, CHAR *topic_name, UINT topic_name_length,
+                                     UINT retain, UINT QoS)
+{
+
+    /* Validate topic_ptr */
+    if (topic_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate topic_name and QoS value. */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0) ||
+        (topic_name_length > NXD_MQTT_PREPARED_TOPIC_SIZE) || (QoS > 2))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_topic_prepare(topic_ptr, topic_name, topic_name_length, retain, QoS));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_prepared_publish                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client publish on a     */
+/*    prepared topic.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_ptr                             Pointer to prepared topic     */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_prepared_publish                                   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_prepared_publish(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_PREPARED_TOPIC *topic_ptr,
+                                        CHAR *message, UINT message_length, ULONG wait_option)
+{
+
+    /* Validate client_ptr and topic_ptr */
+    if ((client_ptr == NX_NULL) || (topic_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate the prepared topic and message length. */
+    if ((topic_ptr -> nxd_mqtt_prepared_topic_length <= 2) || (message && (message_length == 0)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_prepared_publish(client_ptr, topic_ptr, message, message_length, wait_option));
+}
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_lane_rate_set                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client lane rate set    */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    lane                                  Publish lane                  */
+/*    rate                                  Messages per second           */
+/*    burst                                 Messages sent back to back    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_lane_rate_set                                      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_lane_rate_set(NXD_MQTT_CLIENT *client_ptr, UINT lane, UINT rate, UINT burst)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* A limited lane sends one message at least between two tokens. */
+    if ((lane >= NXD_MQTT_LANES) || (rate && (burst == 0)) || (burst > (0xFFFFFFFFUL / NX_IP_PERIODIC_RATE)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_lane_rate_set(client_ptr, lane, rate, burst));
+}
+
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_latency_get                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client latency get      */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    latency_ptr                           Histograms copied             */
+/*    reset                                 Clear after the copy          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_latency_get                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_latency_get(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_LATENCY *latency_ptr, UINT reset)
+{
+    /* Validate the pointers. */
+    if ((client_ptr == NX_NULL) || (latency_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_latency_get(client_ptr, latency_ptr, reset));
+}
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_publish_batch_begin               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client publish batch    */
+/*    begin call.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_batch_begin                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_publish_batch_begin(NXD_MQTT_CLIENT *client_ptr)
+{
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_publish_batch_begin(client_ptr));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_publish_batch_flush               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client publish batch    */
+/*    flush call.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_publish_batch_flush                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_publish_batch_flush(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_publish_batch_flush(client_ptr, wait_option));
+}
+
+
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_events_process                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client events process   */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_events_process                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_events_process(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+{
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_events_process(client_ptr, wait_option));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_events_signal_set                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client events signal    */
+/*    set call.                                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    group_ptr                             Group of the application      */
+/*    flag                                  Flag of the client in it      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_events_signal_set                                  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_events_signal_set(NXD_MQTT_CLIENT *client_ptr, TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flag)
+{
+
+    /* Validate client_ptr, and the flag of a group */
+    if ((client_ptr == NX_NULL) || ((group_ptr != NX_NULL) && (flag == 0)))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_events_signal_set(client_ptr, group_ptr, flag));
+}
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_subscribe                         PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs error checking to the subscribe service.     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Pointer to the topic string   */
+/*                                            to subscribe to             */
+/*    topic_name_length                     Length of the topic string    */
+/*                                            in bytes                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Pointer to the topic string   */
+/*                                            to subscribe to             */
+/*    topic_name_length                     Length of the topic string    */
+/*                                            in bytes                    */
+/*    QoS                                   Expected QoS level            */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_subscribe                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS)
+{
+
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate topic_name */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate QoS value. */
+    if (QoS > 2)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_subscribe(client_ptr, topic_name, topic_name_length, QoS));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_subscribe_list                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the subscribe list call.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    filter_list                           Pointer to the topic filters  */
+/*    filter_count                          Number of topic filters       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_subscribe_list                                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_subscribe_list(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count)
+{
+UINT i;
+
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate the list */
+    if ((filter_list == NX_NULL) || (filter_count == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate each topic filter and QoS value. */
+    for (i = 0; i < filter_count; i++)
+    {
+        if ((filter_list[i].nxd_mqtt_topic_filter_name == NX_NULL) ||
+            (filter_list[i].nxd_mqtt_topic_filter_name_length == 0) ||
+            (filter_list[i].nxd_mqtt_topic_filter_qos > 2))
+        {
+            return(NXD_MQTT_INVALID_PARAMETER);
+        }
+    }
+
+    return(_nxd_mqtt_client_subscribe_list(client_ptr, filter_list, filter_count));
+}
+
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_unsubscribe                       PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs error checking to the unsubscribe service.   */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_name                            Pointer to the topic string   */
+/*                                            to unsubscribe              */
+/*    topic_name_length                     Length of the topic string    */
+/*                                            in bytes                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate topic_name */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_unsubscribe(client_ptr, topic_name, topic_name_length));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_disconnect                        PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in MQTT client disconnect call.     */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_disconnect           Actual MQTT Client disconnect */
+/*                                            call                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    return(_nxd_mqtt_client_disconnect(client_ptr));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxde_mqtt_client_message_get                       PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in MQTT client message get call.    */
+/*                                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    topic_buffer                          Pointer to the topic buffer   */
+/*                                            where topic is copied to    */
+/*    topic_buffer_size                     Size of the topic buffer.     */
+/*    actual_topic_length                   Number of bytes copied into   */
+/*                                            topic_buffer                */
+/*    message_buffer                        Pointer to the buffer where   */
+/*                                            message is copied to        */
+/*    message_buffer_size                   Size of the message_buffer    */
+/*    actual_message_length                 Number of bytes copied into   */
+/*                                            the message buffer.         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_get                                        */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
+                                   UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
+{
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Topic and topic_length can be NULL if caller does not care the topic string. */
+
+    /* Validate message.  Message_length can be NULL if caller does not care message length. */
+    if ((message_buffer == NX_NULL) || (topic_buffer == NX_NULL))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+
+    return(_nxd_mqtt_client_message_get(client_ptr, topic_buffer, topic_buffer_size, actual_topic_length,
+                                        message_buffer, message_buffer_size, actual_message_length));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_message_packet_get                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client message packet   */
+/*    get call.                                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Destination for the packet    */
+/*                                            holding the message         */
+/*    topic_offset                          Offset of the topic           */
+/*    topic_length                          Length of the topic           */
+/*    message_offset                        Offset of the message         */
+/*    message_length                        Length of the message         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_packet_get                                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_message_packet_get(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr,
+                                          ULONG *topic_offset, UINT *topic_length,
+                                          ULONG *message_offset, ULONG *message_length)
+{
+
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Validate the destinations. */
+    if ((packet_ptr == NX_NULL) || (topic_offset == NX_NULL) || (topic_length == NX_NULL) ||
+        (message_offset == NX_NULL) || (message_length == NX_NULL))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    /* Process CONNACK message.  */
-    status = _nxd_mqtt_process_connack(client_ptr, packet_ptr, wait_option);
+    return(_nxd_mqtt_client_message_packet_get(client_ptr, packet_ptr, topic_offset, topic_length,
+                                               message_offset, message_length));
+}
 
-    /* Release the packet.  */
-    nx_packet_release(packet_ptr);
 
-    /* Check status.  */
-    if (status == NX_SUCCESS)
-    {
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_message_packet_release            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client message packet   */
+/*    release call.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    packet_ptr                            Packet holding the message    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_message_packet_release                             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_message_packet_release(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+{
 
-        /* Set the receive callback. */
-        nx_tcp_socket_receive_notify(&client_ptr -> nxd_mqtt_client_socket, _nxd_mqtt_receive_callback);
+    /* Validate the pointers */
+    if ((client_ptr == NX_NULL) || (packet_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
     }
 
-    return(status);
+    return(_nxd_mqtt_client_message_packet_release(client_ptr, packet_ptr));
 }
 
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect_packet_send                PORTABLE C      */
+/*    _nxde_mqtt_client_receive_notify_set                PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -4051,16 +10892,16 @@ UINT                 old_priority;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sends CONNECT packet to MQTT server.                  */
+/*    This function checks for errors in MQTT client publish notify call. */
 /*                                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    keepalive                             Keepalive flag                */
-/*    clean_session                         Clean session flag            */
-/*    wait_option                           Timeout value                 */
-/*                                                                        */
+/*    receive_notify                        User-supplied callback        */
+/*                                            function, which is invoked  */
+/*                                            upon receiving a publish    */
+/*                                            message.                    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4068,20 +10909,12 @@ UINT                 old_priority;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    nx_packet_release                                                   */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_secure_tls_session_send                                          */
-/*    _nxd_mqtt_packet_allocate                                           */
-/*    _nxd_mqtt_release_transmit_packet                                   */
-/*    _nxd_mqtt_client_connection_end                                     */
-/*    _nxd_mqtt_client_set_fixed_header                                   */
-/*    _nxd_mqtt_client_append_message                                     */
+/*    _nxd_mqtt_client_receive_notify_set                                 */
+/*                                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect                                            */
-/*    _nxd_mqtt_tcp_establish_process                                     */
-/*    _nxd_mqtt_tls_establish_process                                     */
+/*    Application Code                                                    */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -4092,209 +10925,79 @@ UINT                 old_priority;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_connect_packet_send(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option)
+UINT _nxde_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                          VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count))
 {
-NX_PACKET           *packet_ptr;
-UINT                 status;
-UINT                 length = 0;
-UCHAR                connection_flags = 0;
-UINT                 ret = NXD_MQTT_SUCCESS;
-UCHAR                temp_data[4];
-UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODIC_RATE);
-
-
-    /* Construct connect flags by taking the connect flag user supplies, or'ing the username and
-       password bits, if they are supplied. */
-    if (client_ptr -> nxd_mqtt_client_username)
-    {
-        connection_flags |= MQTT_CONNECT_FLAGS_USERNAME;
-
-        /* Add the password flag only if username is supplied. */
-        if (client_ptr -> nxd_mqtt_client_password)
-        {
-            connection_flags |= MQTT_CONNECT_FLAGS_PASSWORD;
-        }
-    }
-
-    if (client_ptr -> nxd_mqtt_client_will_topic)
-    {
-        connection_flags = connection_flags | MQTT_CONNECT_FLAGS_WILL_FLAG;
-
-
-        if (client_ptr -> nxd_mqtt_client_will_qos_retain & 0x80)
-        {
-            connection_flags = connection_flags | MQTT_CONNECT_FLAGS_WILL_RETAIN;
-        }
-
-        connection_flags = (UCHAR)(connection_flags | ((client_ptr -> nxd_mqtt_client_will_qos_retain & 0x3) << 3));
-    }
-
-    if (client_ptr -> nxd_mqtt_clean_session == NX_TRUE)
-    {
-        connection_flags = connection_flags | MQTT_CONNECT_FLAGS_CLEAN_SESSION;
-
-        /* Clear any transmit blocks from the previous session. */
-        while (client_ptr -> message_transmit_queue_head)
-        {
-            _nxd_mqtt_release_transmit_packet(client_ptr, client_ptr -> message_transmit_queue_head, NX_NULL);
-        }
-    }
-
-    /* Set the length of the packet. */
-    length = 10;
-
-    /* Add the size of the client Identifier. */
-    length += (client_ptr -> nxd_mqtt_client_id_length + 2);
-
-    /* Add the will topic, if present. */
-    if (connection_flags & MQTT_CONNECT_FLAGS_WILL_FLAG)
-    {
-        length += (client_ptr -> nxd_mqtt_client_will_topic_length + 2);
-        length += (client_ptr -> nxd_mqtt_client_will_message_length + 2);
-    }
-    if (connection_flags & MQTT_CONNECT_FLAGS_USERNAME)
-    {
-        length += (UINT)(client_ptr -> nxd_mqtt_client_username_length + 2);
-    }
-    if (connection_flags & MQTT_CONNECT_FLAGS_PASSWORD)
-    {
-        length += (UINT)(client_ptr -> nxd_mqtt_client_password_length + 2);
-    }
-
-    /* Check for invalid length. */
-    if (length > (127 * 127 * 127 * 127))
-    {
-        return(NXD_MQTT_INTERNAL_ERROR);
-    }
-
-    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr);
-    if (status)
-    {
-
-        return(status);
-    }
-
-    /* Construct MQTT CONNECT message. */
-    temp_data[0] = ((MQTT_CONTROL_PACKET_TYPE_CONNECT << 4) & 0xF0);
-
-    /* Fill in fixed header. */
-    ret = _nxd_mqtt_client_set_fixed_header(client_ptr, packet_ptr, temp_data[0], length, wait_option);
-
-    if (ret)
-    {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
-
-    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, "MQTT", 4, wait_option);
-
-    if (ret)
-    {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
-
-    /* Fill in protocol level, */
-    temp_data[0] = MQTT_PROTOCOL_LEVEL;
-
-    /* Fill in byte 8: connect flags */
-    temp_data[1] = connection_flags;
-
-    /* Fill in byte 9 and 10: keep alive */
-    temp_data[2] = (keepalive >> 8) & 0xFF;
-    temp_data[3] = (keepalive & 0xFF);
-
-    ret = nx_packet_data_append(packet_ptr, temp_data, 4, client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
-
-    if (ret)
-    {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
-
-    /* Fill in payload area, in the order of: client identifier, will topic, will message,
-       user name, and password. */
-    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_id, 
-                                          client_ptr -> nxd_mqtt_client_id_length, wait_option);
-
-    /* Next fill will topic and will message if the will flag is set. */
-    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_WILL_FLAG))
-    {
-        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, (CHAR *)client_ptr -> nxd_mqtt_client_will_topic,
-                                              client_ptr -> nxd_mqtt_client_will_topic_length, wait_option);
-
-        if (!ret)
-        {
-            ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, (CHAR *)client_ptr -> nxd_mqtt_client_will_message,
-                                                  client_ptr -> nxd_mqtt_client_will_message_length, wait_option);
-        }
-    }
-
-    /* Fill username if username flag is set */
-    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_USERNAME))
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
     {
-        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_username, 
-                                              client_ptr -> nxd_mqtt_client_username_length, wait_option);
+        return(NX_PTR_ERROR);
     }
 
-    /* Fill password if password flag is set */
-    if (!ret && (connection_flags & MQTT_CONNECT_FLAGS_PASSWORD))
+    if (receive_notify == NX_NULL)
     {
-        ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, client_ptr -> nxd_mqtt_client_password, 
-                                              client_ptr -> nxd_mqtt_client_password_length, wait_option);
+        return(NX_PTR_ERROR);
     }
 
-    if (ret)
-    {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
+    return(_nxd_mqtt_client_receive_notify_set(client_ptr, receive_notify));
+}
 
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
 
-    /* Ready to send the connect message to the server. */
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
-    {
-        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
-    }
-    else
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxde_mqtt_client_receive_queue_set                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the MQTT client receive queue    */
+/*    set call.                                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    max_messages                          Largest depth of the queue    */
+/*    max_bytes                             Largest size of the queue     */
+/*    policy                                Policy of the full queue      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nxd_mqtt_client_receive_queue_set                                  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxde_mqtt_client_receive_queue_set(NXD_MQTT_CLIENT *client_ptr, UINT max_messages, ULONG max_bytes, UINT policy)
+{
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
     {
-        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
+        return(NX_PTR_ERROR);
     }
-#else
-    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
-
-#endif /* NX_SECURE_ENABLE */
 
-    if (status)
+    if ((policy != NXD_MQTT_RECEIVE_QUEUE_DROP_OLDEST) && (policy != NXD_MQTT_RECEIVE_QUEUE_DROP_NEWEST) &&
+        (policy != NXD_MQTT_RECEIVE_QUEUE_BACKPRESSURE))
     {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
+        return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    /* Update the timeout value. */
-    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
-
-    return(status);
+    return(_nxd_mqtt_client_receive_queue_set(client_ptr, max_messages, max_bytes, policy));
 }
 
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_secure_connect                     PORTABLE C      */
+/*    _nxd_mqtt_client_disconnect_notify_set              PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -4302,30 +11005,15 @@ UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODI
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function makes an initial secure (TLS) connection to           */
-/*    the MQTT server.                                                    */
-/*                                                                        */
+/*    This function sets the notify function for the disconnect event.    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    server_ip                             Server IP address structure   */
-/*    server_port                           Server port number, in host   */
-/*                                            byte order                  */
-/*    tls_setup                             User-supplied callback        */
-/*                                            function to set up TLS      */
-/*                                            parameters.                 */
-/*    username                              User name, or NULL if user    */
-/*                                            name is not required        */
-/*    username_length                       Length of the user name, or   */
-/*                                            0 if user name is NULL      */
-/*    password                              Password string, or NULL if   */
-/*                                            password is not required    */
-/*    password_length                       Length of the password, or    */
-/*                                            0 if password is NULL       */
-/*    connection_flag                       Flag passed to the server     */
-/*    timeout                               Timeout value                 */
-/*                                                                        */
+/*    disconnect_notify                     The notify function to be     */
+/*                                            used when the client is     */
+/*                                            disconnected from the       */
+/*                                            server.                     */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4333,8 +11021,7 @@ UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODI
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
-/*                                            call                        */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -4349,40 +11036,20 @@ UINT                 keepalive = (client_ptr -> nxd_mqtt_keepalive/NX_IP_PERIODI
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-#ifdef NX_SECURE_ENABLE
-UINT _nxd_mqtt_client_secure_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
-                                     UINT (*tls_setup)(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESSION *,
-                                                       NX_SECURE_X509_CERT *, NX_SECURE_X509_CERT *),
-                                     UINT keepalive, UINT clean_session, ULONG wait_option)
+UINT _nxd_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *))
 {
-UINT ret;
-
-    /* Set up TLS session information. */
-    ret = (*tls_setup)(client_ptr, &client_ptr -> nxd_mqtt_tls_session,
-                       &client_ptr -> nxd_mqtt_tls_certificate,
-                       &client_ptr -> nxd_mqtt_tls_trusted_certificate);
-
-    if (ret)
-    {
-        return(ret);
-    }
-
-    /* Mark the connection as secure. */
-    client_ptr -> nxd_mqtt_client_use_tls = 1;
 
-    ret = _nxd_mqtt_client_connect(client_ptr, server_ip, server_port, keepalive, clean_session, wait_option);
+    client_ptr -> nxd_mqtt_disconnect_notify = disconnect_notify;
 
-    return(ret);
+    return(NXD_MQTT_SUCCESS);
 }
 
-#endif /* NX_SECURE_ENABLE */
-
 
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nxd_mqtt_client_delete                             PORTABLE C      */
+/*    _nxde_mqtt_client_disconnect_notify_set             PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -4390,16 +11057,15 @@ UINT ret;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function deletes a previously created MQTT client instance.    */
-/*    If the NXD_MQTT_SOCKET_TIMEOUT is set to NX_WAIT_FOREVER, this may  */
-/*    suspend infinitely. This is because the MQTT Client must            */
-/*    disconnect with the server, and if the network link is disabled or  */
-/*    the server is not responding, this will blocks this function from   */
-/*    completing.                                                         */ 
+/*    This function checks for errors in setting MQTT client disconnect   */
+/*    callback function.                                                  */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    disconnect_callback                   The callback function to be   */
+/*                                            used when an on-going       */
+/*                                            connection is disconnected. */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4407,7 +11073,7 @@ UINT ret;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                                                  */
+/*    _nxd_mqtt_client_disconnect_notify_set                              */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -4422,61 +11088,40 @@ UINT ret;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr)
+UINT _nxde_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *))
 {
 
-
-    /* Set the event flag for DELETE. Next time when the MQTT client thread
-       wakes up, it will perform the deletion process. */
-#ifndef NXD_MQTT_CLOUD_ENABLE
-    tx_event_flags_set(&client_ptr -> nxd_mqtt_events, MQTT_DELETE_EVENT, TX_OR);
-#else
-    nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_DELETE_EVENT);
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-
-    /* Check if the MQTT client thread has completed. */
-    while((client_ptr -> nxd_mqtt_client_socket).nx_tcp_socket_id != 0) 
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
     {
-        tx_thread_sleep(NX_IP_PERIODIC_RATE);
+        return(NX_PTR_ERROR);
     }
-
-#ifndef NXD_MQTT_CLOUD_ENABLE
-    /* Now we can delete the Client instance. */
-    tx_thread_delete(&(client_ptr -> nxd_mqtt_thread));
-#else
-    /* Deregister mqtt module from cloud helper.  */
-    nx_cloud_module_deregister(client_ptr -> nxd_mqtt_client_cloud_ptr, &(client_ptr -> nxd_mqtt_client_cloud_module));
-
-    /* Delete own created cloud.  */
-    if (client_ptr -> nxd_mqtt_client_cloud.nx_cloud_id == NX_CLOUD_ID)
-        nx_cloud_delete(&(client_ptr -> nxd_mqtt_client_cloud));
-#endif /* NXD_MQTT_CLOUD_ENABLE */
-
-    return(NXD_MQTT_SUCCESS);
+    return(_nxd_mqtt_client_disconnect_notify_set(client_ptr, disconnect_notify));
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_publish_packet_send                PORTABLE C      */
-/*                                                           6.1.8        */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_ack_notify_set                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sends a publish packet to the connected broker.       */
-/*                                                                        */
+/*    This function sets the notify function called when the server       */
+/*    acknowledges a QoS 1 or QoS 2 message, so the application can keep  */
+/*    several messages in flight and account for their completion. The    */
+/*    notify function runs in the MQTT thread and must not release the    */
+/*    transmit packet it is handed.                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    packet_ptr                            Pointer to publish packet     */
-/*    packet_id                             Current packet ID             */
-/*    QoS                                   Quality of service            */
-/*    wait_option                           Suspension option             */
+/*    ack_notify                            The notify function to be     */
+/*                                            used when an ACK is         */
+/*                                            received from the server.   */
+/*    context                               Context passed to the notify  */
+/*                                            function                    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4486,141 +11131,53 @@ UINT _nxd_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr)
 /*                                                                        */
 /*    tx_mutex_get                                                        */
 /*    tx_mutex_put                                                        */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_secure_tls_session_send                                          */
-/*    nx_packet_release                                                   */
-/*    _nxd_mqtt_copy_transmit_packet                                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_publish                                            */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*  08-02-2021     Yuxin Zhou               Modified comment(s),          */
-/*                                            supported maximum transmit  */
-/*                                            queue depth,                */
-/*                                            resulting in version 6.1.8  */
+/*    Application Code                                                    */
 /*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_publish_packet_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
-                                          USHORT packet_id, UINT QoS, ULONG wait_option)
+UINT _nxd_mqtt_client_ack_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                     VOID (*ack_notify)(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                                        NX_PACKET *transmit_packet_ptr, VOID *context),
+                                     VOID *context)
 {
 
-UINT       status;
-UINT       ret = NXD_MQTT_SUCCESS;
-
-    if (QoS != 0)
-    {
-    /* This packet needs to be stored locally for possible retransmission. */
-    NX_PACKET *transmit_packet_ptr;
-
-        /* Copy packet for retransmission. */
-        if (_nxd_mqtt_copy_transmit_packet(client_ptr, packet_ptr, &transmit_packet_ptr,
-                                           packet_id, NX_TRUE, wait_option))
-        {
-            return(NXD_MQTT_PACKET_POOL_FAILURE);
-        }
-
-        /* Obtain the mutex. */
-        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-        if (status != TX_SUCCESS)
-        {
-            nx_packet_release(transmit_packet_ptr);
-
-#ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
-            /* Decrease the transmit queue depth.  */
-            client_ptr -> message_transmit_queue_depth--;
-#endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
-            return(NXD_MQTT_MUTEX_FAILURE);
-        }
-
-        if (client_ptr -> message_transmit_queue_head == NX_NULL)
-        {
-            client_ptr -> message_transmit_queue_head = transmit_packet_ptr;
-        }
-        else
-        {
-            client_ptr -> message_transmit_queue_tail -> nx_packet_queue_next = transmit_packet_ptr;
-        }
-        client_ptr -> message_transmit_queue_tail = transmit_packet_ptr;
-    }
-    else
-    {
-
-        /* Obtain the mutex. */
-        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-        if (status != TX_SUCCESS)
-        {
-            return(NXD_MQTT_MUTEX_FAILURE);
-        }
-    }
-
-    /* Update the timeout value. */
-    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+    /* Obtain the mutex so the notify function and its context change together. */
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
+    client_ptr -> nxd_mqtt_ack_receive_notify = ack_notify;
+    client_ptr -> nxd_mqtt_ack_receive_context = context;
 
-    /* Release the mutex. */
     tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-    /* Ready to send the connect message to the server. */
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
-    {
-        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, wait_option);
-    }
-    else
-    {
-        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
-    }
-#else
-    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, wait_option);
-
-#endif /* NX_SECURE_ENABLE */
-
-    if (status)
-    {
-        ret = NXD_MQTT_COMMUNICATION_FAILURE;
-    }
-
-    return(ret);
+    return(NXD_MQTT_SUCCESS);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_publish                            PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_inflight_table_set                 PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function publishes a message to the connected broker.          */
-/*                                                                        */
-/*                                                                        */
-/*  INPUT                                                                 */
+/*    This function gives the client the memory of its inflight table.    */
+/*    The table indexes the QoS 1 and QoS 2 messages and the subscribe    */
+/*    and unsubscribe requests waiting for an acknowledgement by packet   */
+/*    ID, so that an ACK is matched in constant time instead of walking   */
+/*    the transmit queue. The table holds the largest power of two of     */
+/*    NXD_MQTT_INFLIGHT_ENTRY entries that fits in memory_size, which     */
+/*    also bounds the number of such packets outstanding. A NULL          */
+/*    memory_ptr removes the table. The table can only be changed while   */
+/*    the transmit queue is empty, typically after create.                */
 /*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Name of the topic             */
-/*    topic_name_length                     Length of the topic name      */
-/*    message                               Message string                */
-/*    message_length                        Length of the message,        */
-/*                                            in bytes                    */
-/*    retain                                The retain flag, whether      */
-/*                                            or not the broker should    */
-/*                                            store this message          */
-/*    QoS                                   Expected QoS level            */
-/*    wait_option                           Suspension option             */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    client_ptr                            Pointer to MQTT Client        */
+/*    memory_ptr                            Memory of the table           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4629,202 +11186,79 @@ UINT       ret = NXD_MQTT_SUCCESS;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    tx_mutex_get                                                        */
-/*    _nxd_mqtt_packet_allocate                                           */
-/*    _nxd_mqtt_client_set_fixed_header                                   */
-/*    _nxd_mqtt_client_append_message                                     */
 /*    tx_mutex_put                                                        */
-/*    nx_packet_release                                                   */
-/*    _nxd_mqtt_client_publish_packet_send                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
-                              CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+UINT _nxd_mqtt_client_inflight_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
-NX_PACKET *packet_ptr;
-UINT       status;
-UINT       length = 0;
-UCHAR      flags;
-USHORT     packet_id = 0;
-UINT       ret = NXD_MQTT_SUCCESS;
-
-    if (QoS == 2)
-    {
-        return(NXD_MQTT_QOS2_NOT_SUPPORTED);
-    }
-
-
-    /* Do nothing if the client is already connected. */
-    if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED)
-    {
-        return(NXD_MQTT_NOT_CONNECTED);
-    }
-
-    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr);
-
-    if (status != NXD_MQTT_SUCCESS)
-    {
-        return(NXD_MQTT_PACKET_POOL_FAILURE);
-    }
-
-    flags = (UCHAR)((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | (QoS << 1));
-
-    if (retain)
-    {
-        flags = flags | MQTT_PUBLISH_RETAIN;
-    }
-
-
-    /* Compute the remaining length. */
-
-    /* Topic Name. */
-    /* Compute Topic Name length. */
-    length = topic_name_length + 2;
-
-    /* Count packet ID for QoS 1 or QoS 2 message. */
-    if ((QoS == 1) || (QoS == 2))
-    {
-        length += 2;
-    }
-
-    /* Count message. */
-    if ((message != NX_NULL) && (message_length != 0))
-    {
-        length += message_length;
-    }
-
-    /* Write out the control header and remaining length field. */
-    ret = _nxd_mqtt_client_set_fixed_header(client_ptr, packet_ptr, flags, length, wait_option);
+UINT table_size = 0;
 
-    if (ret)
+    if (memory_ptr && (memory_size >= sizeof(NXD_MQTT_INFLIGHT_ENTRY)))
     {
 
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        return(NXD_MQTT_INTERNAL_ERROR);
+        /* Round the number of entries down to a power of two. */
+        table_size = 1;
+        while ((table_size << 1) <= (memory_size / sizeof(NXD_MQTT_INFLIGHT_ENTRY)))
+        {
+            table_size <<= 1;
+        }
     }
 
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    /* Write out topic */
-    ret = _nxd_mqtt_client_append_message(client_ptr, packet_ptr, topic_name, topic_name_length, wait_option);
-
-    if (ret)
+    /* Packets on the transmit queue are indexed by the current table. */
+    if (client_ptr -> message_transmit_queue_head)
     {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        return(NXD_MQTT_INTERNAL_ERROR);
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_INVALID_STATE);
     }
 
-    /* Append Packet Identifier for QoS level 1 or 2  MQTT 3.3.2.2 */
-    if ((QoS == 1) || (QoS == 2))
+    if (table_size)
     {
-    UCHAR identifier[2];
-
-        /* Obtain the mutex. */
-        status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-
-        if (status != TX_SUCCESS)
-        {
-            return(NXD_MQTT_MUTEX_FAILURE);
-        }
-
-        packet_id = (USHORT)client_ptr -> nxd_mqtt_client_packet_identifier;
-        identifier[0] = (UCHAR)(client_ptr -> nxd_mqtt_client_packet_identifier >> 8);
-        identifier[1] = (client_ptr -> nxd_mqtt_client_packet_identifier & 0xFF);
-
-        /* Update packet id. */
-        client_ptr -> nxd_mqtt_client_packet_identifier = (client_ptr -> nxd_mqtt_client_packet_identifier + 1) & 0xFFFF;
-
-        /* Prevent packet identifier from being zero. MQTT-2.3.1-1 */
-        if(client_ptr -> nxd_mqtt_client_packet_identifier == 0)
-            client_ptr -> nxd_mqtt_client_packet_identifier = 1;
-
-        /* Release the mutex. */
-        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-
-        ret = nx_packet_data_append(packet_ptr, identifier, 2, 
-                                    client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
-
-        if (ret)
-        {
-
-            /* Release the packet. */
-            nx_packet_release(packet_ptr);
-
-            return(NXD_MQTT_INTERNAL_ERROR);
-        }
+        NXD_MQTT_SECURE_MEMSET(memory_ptr, 0, table_size * sizeof(NXD_MQTT_INFLIGHT_ENTRY));
+        client_ptr -> nxd_mqtt_client_inflight_table = (NXD_MQTT_INFLIGHT_ENTRY *)memory_ptr;
     }
-
-    /* Append message. */
-    if ((message != NX_NULL) && (message_length) != 0)
+    else
     {
-        
-        /* Use nx_packet_data_append to move user-supplied message data into the packet.
-           nx_packet_data_append uses chained packet if the additional storage space is 
-           needed. */
-        ret = nx_packet_data_append(packet_ptr, message, message_length, 
-                                       client_ptr -> nxd_mqtt_client_packet_pool_ptr, wait_option);
-        if(ret)
-        {
-            /* Unable to obtain a new packet to store the message. */
-
-            /* Release the packet. */
-            nx_packet_release(packet_ptr);
-
-            return(NXD_MQTT_INTERNAL_ERROR);
-        }
+        client_ptr -> nxd_mqtt_client_inflight_table = NX_NULL;
     }
+    client_ptr -> nxd_mqtt_client_inflight_table_size = table_size;
+    client_ptr -> nxd_mqtt_client_inflight_count = 0;
 
-    /* Send publish packet. */
-    ret = _nxd_mqtt_client_publish_packet_send(client_ptr, packet_ptr, packet_id, QoS, wait_option);
-
-    if (ret)
-    {
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-    }
-    return(ret);
+    return(NXD_MQTT_SUCCESS);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_subscribe                          PORTABLE C      */
-/*                                                           6.1.2        */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_qos2_table_set                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sends a subscribe message to the broker.              */
-/*                                                                        */
+/*    This function gives the client the memory of its QoS 2 table. Once  */
+/*    their message is acknowledged, the QoS 2 exchanges in both          */
+/*    directions are kept there by packet ID and phase, in                */
+/*    NXD_MQTT_QOS2_ENTRY entries of a few bytes, instead of a PUBREC or  */
+/*    PUBREL packet on the transmit queue. The table holds the largest    */
+/*    power of two of entries that fits in memory_size, one of them is    */
+/*    kept free. When it is full, the exchanges fall back to the transmit */
+/*    queue. A NULL memory_ptr removes the table. The table can only be   */
+/*    changed while it holds no exchange, typically after create.         */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Pointer to the topic string   */
-/*                                            to subscribe to             */
-/*    topic_name_length                     Length of the topic string    */
-/*                                            in bytes                    */
-/*    QoS                                   Expected QoS level            */
+/*    memory_ptr                            Memory of the table           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4832,63 +11266,81 @@ UINT       ret = NXD_MQTT_SUCCESS;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_sub_unsub            The actual routine that       */
-/*                                            performs the sub/unsub      */
-/*                                            action.                     */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*  11-09-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            added packet id parameter,  */
-/*                                            resulting in version 6.1.2  */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS)
+UINT _nxd_mqtt_client_qos2_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
-    if (QoS == 2)
+UINT table_size = 0;
+
+    if (memory_ptr && (memory_size >= 2 * sizeof(NXD_MQTT_QOS2_ENTRY)))
     {
-        return(NXD_MQTT_QOS2_NOT_SUPPORTED);
+
+        /* Round the number of entries down to a power of two. */
+        table_size = 2;
+        while ((table_size << 1) <= (memory_size / sizeof(NXD_MQTT_QOS2_ENTRY)))
+        {
+            table_size <<= 1;
+        }
     }
 
-    return(_nxd_mqtt_client_sub_unsub(client_ptr, (MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE << 4) | 0x02,
-                                      topic_name, topic_name_length, NX_NULL, QoS));
-}
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    /* The exchanges in progress are kept by the current table. */
+    if (client_ptr -> nxd_mqtt_client_qos2_count)
+    {
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_INVALID_STATE);
+    }
 
+    if (table_size)
+    {
+        NXD_MQTT_SECURE_MEMSET(memory_ptr, 0, table_size * sizeof(NXD_MQTT_QOS2_ENTRY));
+        client_ptr -> nxd_mqtt_client_qos2_table = (NXD_MQTT_QOS2_ENTRY *)memory_ptr;
+    }
+    else
+    {
+        client_ptr -> nxd_mqtt_client_qos2_table = NX_NULL;
+    }
+    client_ptr -> nxd_mqtt_client_qos2_table_size = table_size;
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
+    return(NXD_MQTT_SUCCESS);
+}
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_unsubscribe                        PORTABLE C      */
-/*                                                           6.1.2        */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_last_value_cache_set               PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function unsubscribes a topic from the broker.                 */
-/*                                                                        */
+/*    This function gives the client the memory of its last value cache.  */
+/*    The message of each PUBLISH received is kept there as the last value*/
+/*    of its topic, retained messages sent on subscription included, and  */
+/*    nxd_mqtt_client_last_value_get returns it by topic without a search */
+/*    of the receive queue. Each entry takes entry_size bytes, rounded up */
+/*    to a ULONG, for a NXD_MQTT_LAST_VALUE_ENTRY followed by the topic   */
+/*    and the message. The cache holds the largest power of two of entries*/
+/*    that fits in memory_size, one of them is kept free. A message too   */
+/*    large for an entry is not cached. A NULL memory_ptr removes the     */
+/*    cache, any change empties it.                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Pointer to the topic string   */
-/*                                            to subscribe to             */
-/*    topic_name_length                     Length of the topic string    */
-/*                                            in bytes                    */
+/*    memory_ptr                            Memory of the cache           */
+/*    memory_size                           Size of the memory, in bytes  */
+/*    entry_size                            Size of an entry, in bytes    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4896,51 +11348,74 @@ UINT _nxd_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, U
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_sub_unsub                                          */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*  11-09-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            added packet id parameter,  */
-/*                                            resulting in version 6.1.2  */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length)
+UINT _nxd_mqtt_client_last_value_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG entry_size)
 {
-    return(_nxd_mqtt_client_sub_unsub(client_ptr, (MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE << 4) | 0x02,
-                                      topic_name, topic_name_length, NX_NULL, 0));
+
+UINT entries = 0;
+
+    /* Keep the headers of the entries aligned. */
+    entry_size = (entry_size + sizeof(ULONG) - 1) & ~(ULONG)(sizeof(ULONG) - 1);
+
+    if (memory_ptr && (entry_size > sizeof(NXD_MQTT_LAST_VALUE_ENTRY)) && (memory_size >= 2 * entry_size))
+    {
+
+        /* Round the number of entries down to a power of two. */
+        entries = 2;
+        while ((entries << 1) <= (memory_size / entry_size))
+        {
+            entries <<= 1;
+        }
+    }
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (entries)
+    {
+        NXD_MQTT_SECURE_MEMSET(memory_ptr, 0, entries * entry_size);
+        client_ptr -> nxd_mqtt_client_last_value_cache = (UCHAR *)memory_ptr;
+    }
+    else
+    {
+        client_ptr -> nxd_mqtt_client_last_value_cache = NX_NULL;
+    }
+    client_ptr -> nxd_mqtt_client_last_value_entry_size = entry_size;
+    client_ptr -> nxd_mqtt_client_last_value_entries = entries;
+    client_ptr -> nxd_mqtt_client_last_value_count = 0;
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_send_simple_message                       PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_last_value_get                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This internal function handles the transmission of PINGREQ or       */
-/*    DISCONNECT message.                                                 */
-/*                                                                        */
+/*    This function copies the last message received on a topic from the  */
+/*    last value cache. The topic is matched as received, not as a topic  */
+/*    filter. The message stays in the cache.                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    header_value                          Value to be programmed into   */
-/*                                            MQTT header.                */
+/*    topic_name                            Topic                         */
+/*    topic_name_length                     Length of the topic           */
+/*    message_buffer                        Buffer of the message         */
+/*    message_buffer_size                   Size of the buffer            */
+/*    actual_message_length                 Length of the message         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -4948,102 +11423,53 @@ UINT _nxd_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name,
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nxd_mqtt_last_value_hash                                           */
+/*    _nxd_mqtt_last_value_find                                           */
 /*    tx_mutex_get                                                        */
-/*    _nxd_mqtt_packet_allocate                                           */
 /*    tx_mutex_put                                                        */
-/*    nx_tcp_socket_send                                                  */
-/*    nx_secure_tls_session_send                                          */
-/*    nx_packet_release                                                   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nxd_mqtt_client_ping                                               */
-/*    _nxd_mqtt_client_disconnect                                         */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    Application Code                                                    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nxd_mqtt_send_simple_message(NXD_MQTT_CLIENT *client_ptr, UCHAR header_value)
+UINT _nxd_mqtt_client_last_value_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                     UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
 {
 
-NX_PACKET *packet_ptr;
-UINT       status;
-UINT       status_mutex;
-UCHAR     *byte;
+NXD_MQTT_LAST_VALUE_ENTRY *entry_ptr = NX_NULL;
+UINT                       index;
+UINT                       status;
 
-    status = _nxd_mqtt_packet_allocate(client_ptr, &packet_ptr);
-    if (status)
-    {
-        return(NXD_MQTT_INTERNAL_ERROR);
-    }
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    if (2u > ((ULONG)(packet_ptr -> nx_packet_data_end) - (ULONG)(packet_ptr -> nx_packet_append_ptr)))
+    if (client_ptr -> nxd_mqtt_client_last_value_cache)
     {
-        nx_packet_release(packet_ptr);
-
-        /* Packet buffer is too small to hold the message. */
-        return(NX_SIZE_ERROR);
+        entry_ptr = _nxd_mqtt_last_value_find(client_ptr, (UCHAR *)topic_name, topic_name_length,
+                                              _nxd_mqtt_last_value_hash((UCHAR *)topic_name, topic_name_length),
+                                              &index);
     }
 
-    byte = packet_ptr -> nx_packet_prepend_ptr;
-
-    *byte = (UCHAR)(header_value << 4);
-    *(byte + 1) = 0;
-
-    packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr + 2;
-    packet_ptr -> nx_packet_length = 2;
-
-
-    /* Release MQTT protection before making NetX/TLS calls. */
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-#ifdef NX_SECURE_ENABLE
-    if (client_ptr -> nxd_mqtt_client_use_tls)
+    if (entry_ptr == NX_NULL)
     {
-        status = nx_secure_tls_session_send(&(client_ptr -> nxd_mqtt_tls_session), packet_ptr, NX_WAIT_FOREVER);
+        status = NXD_MQTT_NO_MESSAGE;
     }
     else
     {
-        status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
-    }
-#else
-
-    status = nx_tcp_socket_send(&client_ptr -> nxd_mqtt_client_socket, packet_ptr, NX_WAIT_FOREVER);
-
-#endif /* NX_SECURE_ENABLE */
-
-    status_mutex = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-    if (status)
-    {
-
-        /* Release the packet. */
-        nx_packet_release(packet_ptr);
-
-        status = NXD_MQTT_COMMUNICATION_FAILURE;
-    }
-    if (status_mutex)
-    {
-        return(NXD_MQTT_MUTEX_FAILURE);
-    }
-
-    if (header_value == MQTT_CONTROL_PACKET_TYPE_PINGREQ)
-    {
-        /* Do not update the ping sent time if the outstanding ping has not been responded yet */
-        if (client_ptr -> nxd_mqtt_ping_not_responded != 1)
+        *actual_message_length = entry_ptr -> nxd_mqtt_last_value_length;
+        if (entry_ptr -> nxd_mqtt_last_value_length > message_buffer_size)
         {
-            /* Record the time we send out the PINGREG */
-            client_ptr -> nxd_mqtt_ping_sent_time = tx_time_get();
-            client_ptr -> nxd_mqtt_ping_not_responded = 1;
+            status = NXD_MQTT_INSUFFICIENT_BUFFER_SPACE;
+        }
+        else
+        {
+            NXD_MQTT_SECURE_MEMCPY(message_buffer, (UCHAR *)(entry_ptr + 1) + entry_ptr -> nxd_mqtt_last_value_topic_length,
+                                   entry_ptr -> nxd_mqtt_last_value_length); /* Use case of memcpy is verified. */
+            status = NXD_MQTT_SUCCESS;
         }
     }
 
-    /* Update the timeout value. */
-    client_ptr -> nxd_mqtt_timeout = tx_time_get() + client_ptr -> nxd_mqtt_keepalive;
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
     return(status);
 }
@@ -5051,22 +11477,25 @@ UCHAR     *byte;
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_disconnect                         PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_publish_ring_set                   PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function disconnects the MQTT client from a server.            */
-/*                                                                        */
+/*    This function gives the client the memory of its publish ring, for  */
+/*    nxd_mqtt_client_publish_enqueue. Each slot takes slot_size bytes,   */
+/*    rounded up to a ULONG, for a NXD_MQTT_PUBLISH_SLOT followed by the  */
+/*    topic and the message. The ring holds the largest power of two of   */
+/*    slots that fits in memory_size. The ring is set before any message  */
+/*    is enqueued, a NULL memory_ptr removes it, any change empties it.   */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    memory_ptr                            Memory of the ring            */
+/*    memory_size                           Size of the memory, in bytes  */
+/*    slot_size                             Size of a slot, in bytes      */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5074,76 +11503,72 @@ UCHAR     *byte;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_send_simple_message                                       */
-/*    _nxd_mqtt_process_disconnect                                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr)
+UINT _nxd_mqtt_client_publish_ring_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG slot_size)
 {
-UINT status;
+TX_INTERRUPT_SAVE_AREA
 
-    /* Obtain the mutex. */
-    status = tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, TX_WAIT_FOREVER);
-    if (status != TX_SUCCESS)
+UINT slots = 0;
+
+    /* Keep the headers of the slots aligned. */
+    slot_size = (slot_size + sizeof(ULONG) - 1) & ~(ULONG)(sizeof(ULONG) - 1);
+
+    if (memory_ptr && (slot_size > sizeof(NXD_MQTT_PUBLISH_SLOT)) && (memory_size >= slot_size))
     {
-        /* Disable timer if timer has been started. */
-        if (client_ptr -> nxd_mqtt_keepalive)
+
+        /* Round the number of slots down to a power of two. */
+        slots = 1;
+        while ((slots << 1) <= (memory_size / slot_size))
         {
-            tx_timer_delete(&(client_ptr -> nxd_mqtt_timer));
+            slots <<= 1;
         }
 
-        return(NXD_MQTT_MUTEX_FAILURE);
+        NXD_MQTT_SECURE_MEMSET(memory_ptr, 0, slots * slot_size);
     }
 
-    /* Let the server know we are ending the MQTT session. */
-    _nxd_mqtt_send_simple_message(client_ptr, MQTT_CONTROL_PACKET_TYPE_DISCONNECT);
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    /* Call the disconnect routine to disconnect the socket,
-       release transmit packets, release received packets,
-       and delete the client timer. */
-    _nxd_mqtt_process_disconnect(client_ptr);
+    /* The producers read the ring with interrupts disabled. */
+    TX_DISABLE
+    client_ptr -> nxd_mqtt_client_publish_ring = slots ? (UCHAR *)memory_ptr : NX_NULL;
+    client_ptr -> nxd_mqtt_client_publish_slot_size = slots ? slot_size : 0;
+    client_ptr -> nxd_mqtt_client_publish_slots = slots;
+    client_ptr -> nxd_mqtt_client_publish_head = 0;
+    client_ptr -> nxd_mqtt_client_publish_tail = 0;
+    TX_RESTORE
 
-    /* Release the mutex. */
     tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-    return(status);
+    return(NXD_MQTT_SUCCESS);
 }
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_receive_notify_set                 PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_connect_cache_set                  PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function installs the MQTT client publish notify callback      */
-/*    function.                                                           */
-/*                                                                        */
+/*    This function gives the client the memory of its CONNECT cache. The */
+/*    CONNECT packet encoded for a connection is kept there and sent      */
+/*    again by the next ones, until the login or the will message is set  */
+/*    again, or the keepalive or the clean session flag change. A CONNECT */
+/*    larger than memory_size is encoded each time. A NULL memory_ptr     */
+/*    removes the cache.                                                  */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    mqtt_client_receive_notify            User-supplied callback        */
-/*                                            function, which is invoked  */
-/*                                            upon receiving a publish    */
-/*                                            message.                    */
+/*    memory_ptr                            Memory of the cache           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5158,56 +11583,54 @@ UINT status;
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
-                                         VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count))
+UINT _nxd_mqtt_client_connect_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
     tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    client_ptr -> nxd_mqtt_client_receive_notify = receive_notify;
+    client_ptr -> nxd_mqtt_client_connect_cache = memory_size ? (UCHAR *)memory_ptr : NX_NULL;
+    client_ptr -> nxd_mqtt_client_connect_cache_size = memory_ptr ? memory_size : 0;
+    client_ptr -> nxd_mqtt_client_connect_cache_length = 0;
 
     tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
     return(NXD_MQTT_SUCCESS);
 }
 
+
+
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_message_get                        PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_publish_enqueue                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function retrieves a published MQTT message.                   */
-/*                                                                        */
+/*    This function copies a message into the next slot of the publish    */
+/*    ring and returns at once, for the thread processing the events of   */
+/*    the client to publish it, in the order enqueued, batched with the   */
+/*    others. It takes no mutex, allocates no packet and never waits for  */
+/*    the network, so that it can be called from an interrupt or a thread */
+/*    above the one processing the events. The slot is claimed with       */
+/*    interrupts disabled for a few instructions, and the message is      */
+/*    copied with interrupts enabled. The messages wait in the ring while */
+/*    the client is not connected. A message too large for a slot, or     */
+/*    enqueued when the ring is full, is refused, the latter is counted   */
+/*    in the nxd_mqtt_client_publish_dropped field of the client.         */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_buffer                          Pointer to the topic buffer   */
-/*                                            where topic is copied to    */
-/*    topic_buffer_size                     Size of the topic buffer.     */
-/*    actual_topic_length                   Number of bytes copied into   */
-/*                                            topic_buffer                */
-/*    message_buffer                        Pointer to the buffer where   */
-/*                                            message is copied to        */
-/*    message_buffer_size                   Size of the message_buffer    */
-/*    actual_message_length                 Number of bytes copied into   */
-/*                                            the message buffer.         */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5215,110 +11638,89 @@ UINT _nxd_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_disconnect           Actual MQTT Client disconnect */
-/*                                            call                        */
-/*    _nxd_mqtt_read_remaining_length       Skip the remaining length     */
-/*                                            field                       */
-/*    tx_mutex_get                                                        */
-/*    tx_mutex_put                                                        */
+/*    _nxd_mqtt_client_events_set                                         */
+/*    nx_cloud_module_event_set             Set cloud module event        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            fixed uninitialized value,  */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
-                                  UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
+UINT _nxd_mqtt_client_publish_enqueue(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      CHAR *message, UINT message_length, UINT retain, UINT QoS)
 {
+TX_INTERRUPT_SAVE_AREA
 
-UINT                status;
-NX_PACKET          *packet_ptr;
-ULONG               topic_offset;
-USHORT              topic_length;
-ULONG               message_offset;
-ULONG               message_length;
+NXD_MQTT_PUBLISH_SLOT *slot_ptr = NX_NULL;
+ULONG                  head;
 
-    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
-    while (client_ptr -> message_receive_queue_depth)
+    if ((sizeof(NXD_MQTT_PUBLISH_SLOT) + topic_name_length + message_length) > client_ptr -> nxd_mqtt_client_publish_slot_size)
     {
-        packet_ptr = client_ptr -> message_receive_queue_head;
-        status = _nxd_mqtt_process_publish_packet(packet_ptr, &topic_offset, &topic_length, &message_offset, &message_length);
-        if (status == NXD_MQTT_SUCCESS)
-        {
-            if ((topic_buffer_size < topic_length) ||
-                (message_buffer_size < message_length))
-            {
-                tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-                return(NXD_MQTT_INSUFFICIENT_BUFFER_SPACE);
-            }
-        }
-
-        client_ptr -> message_receive_queue_head = packet_ptr -> nx_packet_queue_next;
-        if (client_ptr -> message_receive_queue_tail == packet_ptr)
-        {
-            client_ptr -> message_receive_queue_tail = NX_NULL;
-        }
-        client_ptr -> message_receive_queue_depth--;
+        return(NXD_MQTT_INSUFFICIENT_BUFFER_SPACE);
+    }
 
-        if (status == NXD_MQTT_SUCCESS)
-        {
+    /* Claim the slot at the head, if the ring is not full. */
+    TX_DISABLE
+    head = client_ptr -> nxd_mqtt_client_publish_head;
+    if ((head - client_ptr -> nxd_mqtt_client_publish_tail) < client_ptr -> nxd_mqtt_client_publish_slots)
+    {
+        slot_ptr = NXD_MQTT_PUBLISH_SLOT_AT(client_ptr, head);
+        client_ptr -> nxd_mqtt_client_publish_head = head + 1;
+    }
+    else
+    {
+        client_ptr -> nxd_mqtt_client_publish_dropped++;
+    }
+    TX_RESTORE
 
-            /* Set topic and message lengths to avoid uninitialized value. */
-            *actual_topic_length = 0;
-            *actual_message_length = 0;
-            nx_packet_data_extract_offset(packet_ptr, topic_offset, topic_buffer,
-                                          topic_length, (ULONG *)actual_topic_length);
-            nx_packet_data_extract_offset(packet_ptr, message_offset, message_buffer,
-                                          message_length, (ULONG *)actual_message_length);
-            nx_packet_release(packet_ptr);
+    if (slot_ptr == NX_NULL)
+    {
+        return(NXD_MQTT_PUBLISH_RING_FULL);
+    }
 
-            tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-            return(NXD_MQTT_SUCCESS);
-        }
-        nx_packet_release(packet_ptr);
+    /* Copy the message, the slot is published once marked ready. */
+    slot_ptr -> nxd_mqtt_publish_slot_topic_length = (USHORT)topic_name_length;
+    slot_ptr -> nxd_mqtt_publish_slot_length = (USHORT)message_length;
+    slot_ptr -> nxd_mqtt_publish_slot_retain = (UCHAR)(retain ? 1 : 0);
+    slot_ptr -> nxd_mqtt_publish_slot_qos = (UCHAR)QoS;
+    NXD_MQTT_SECURE_MEMCPY((UCHAR *)(slot_ptr + 1), topic_name, topic_name_length); /* Use case of memcpy is verified. */
+    if (message_length)
+    {
+        NXD_MQTT_SECURE_MEMCPY((UCHAR *)(slot_ptr + 1) + topic_name_length, message, message_length); /* Use case of memcpy is verified. */
     }
-    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
-    return(NXD_MQTT_NO_MESSAGE);
+    slot_ptr -> nxd_mqtt_publish_slot_ready = NX_TRUE;
+
+    /* Wake the thread processing the events of the client. */
+#ifndef NXD_MQTT_CLOUD_ENABLE
+    _nxd_mqtt_client_events_set(client_ptr, MQTT_PUBLISH_ENQUEUE_EVENT);
+#else
+    nx_cloud_module_event_set(&(client_ptr -> nxd_mqtt_client_cloud_module), MQTT_PUBLISH_ENQUEUE_EVENT);
+#endif /* NXD_MQTT_CLOUD_ENABLE */
+
+    return(NXD_MQTT_SUCCESS);
 }
 
-/**************************************************************************/
-/*                                                                        */
-/*  FUNCTION                                               RELEASE        */
+
+/**************************************************************************/
 /*                                                                        */
-/*    _nxde_mqtt_client_create                            PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_topic_trie_set                     PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in nxd_mqt_client_create call.      */
-/*                                                                        */
+/*    This function gives the client the memory of its topic filter trie, */
+/*    as an array of NXD_MQTT_TOPIC_NODE. Each level of each topic filter */
+/*    set with nxd_mqtt_client_topic_callback_set takes one node, levels  */
+/*    shared by several filters take one node only. A NULL memory_ptr     */
+/*    removes the memory. The memory can only be changed while no         */
+/*    callback is set.                                                    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    client_name                           Name string used in by the    */
-/*                                            client                      */
-/*    client_id                             Client ID used by the client  */
-/*    client_id_length                      Length of Client ID, in bytes */
-/*    ip_ptr                                Pointer to IP instance        */
-/*    pool_ptr                              Pointer to packet pool        */
-/*    stack_ptr                             Client thread's stack pointer */
-/*    stack_size                            Client thread's stack size    */
-/*    mqtt_thread_priority                  Priority for MQTT thread      */
-/*    memory_ptr                            Deprecated and not used       */
-/*    memory_size                           Deprecated and not used       */
+/*    memory_ptr                            Memory of the trie            */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5326,66 +11728,74 @@ ULONG               message_length;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_create               Actual client create call     */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name, CHAR *client_id, UINT client_id_length,
-                              NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr,
-                              VOID *stack_ptr, ULONG stack_size, UINT mqtt_thread_priority,
-                              VOID *memory_ptr, ULONG memory_size)
+UINT _nxd_mqtt_client_topic_trie_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
+NXD_MQTT_TOPIC_NODE *node_ptr = (NXD_MQTT_TOPIC_NODE *)memory_ptr;
+ULONG                node_count = 0;
 
-    /* Check for invalid input pointers.  */
-    if ((client_ptr == NX_NULL) || (ip_ptr == NX_NULL) || (ip_ptr -> nx_ip_id != NX_IP_ID) ||
-        (stack_ptr == NX_NULL) || (stack_size == 0) || (pool_ptr == NX_NULL))
+    if (memory_ptr)
     {
-        return(NX_PTR_ERROR);
+        node_count = memory_size / sizeof(NXD_MQTT_TOPIC_NODE);
     }
-    
-    return(_nxd_mqtt_client_create(client_ptr, client_name, client_id, client_id_length, ip_ptr,
-                                   pool_ptr, stack_ptr, stack_size, mqtt_thread_priority,
-                                   memory_ptr, memory_size));
+
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
+
+    if (client_ptr -> nxd_mqtt_client_topic_trie)
+    {
+        tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+        return(NXD_MQTT_INVALID_STATE);
+    }
+
+    /* Put all the nodes on the free list. */
+    client_ptr -> nxd_mqtt_client_topic_free_list = NX_NULL;
+    while (node_count--)
+    {
+        NXD_MQTT_SECURE_MEMSET(&node_ptr[node_count], 0, sizeof(NXD_MQTT_TOPIC_NODE));
+        node_ptr[node_count].nxd_mqtt_topic_node_sibling = client_ptr -> nxd_mqtt_client_topic_free_list;
+        client_ptr -> nxd_mqtt_client_topic_free_list = &node_ptr[node_count];
+    }
+
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+
+    return(NXD_MQTT_SUCCESS);
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_connect                           PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxd_mqtt_client_topic_callback_set                 PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client stop call.           */
-/*                                                                        */
+/*    This function sets the callback of a topic filter, which may use    */
+/*    the "+" and "#" wildcards. A received publish message whose topic   */
+/*    matches one or more filters is passed to their callbacks from the   */
+/*    MQTT thread, while the topic is parsed, instead of being queued for */
+/*    nxd_mqtt_client_message_get. The packet is only valid during the    */
+/*    callback, and the callback must not set or remove topic callbacks.  */
+/*    A NULL callback removes the filter. The filter string is not        */
+/*    copied and must stay valid while the filter is set. The filter is   */
+/*    matched locally, the application still subscribes to it with        */
+/*    nxd_mqtt_client_subscribe.                                          */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    server_ip                             Server IP address structure   */
-/*    server_port                           Server port number, in host   */
-/*                                            byte order                  */
-/*    keepalive                             The MQTT keepalive timer      */
-/*    clean_session                         Clean session flag            */
-/*    wait_option                           Suspension option             */
-/*                                                                        */
+/*    topic_filter                          Topic filter                  */
+/*    topic_filter_length                   Length of the topic filter    */
+/*    callback                              Callback of the filter        */
+/*    context                               Context passed to callback    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5393,82 +11803,121 @@ UINT _nxde_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name, CH
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
-/*                                            call                        */
+/*    tx_mutex_get                                                        */
+/*    tx_mutex_put                                                        */
+/*    _nxd_mqtt_topic_trie_prune            Free unused nodes             */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected mqtt client state,*/
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
-                               UINT keepalive, UINT clean_session, ULONG wait_option)
+UINT _nxd_mqtt_client_topic_callback_set(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_filter, UINT topic_filter_length,
+                                         VOID (*callback)(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                          ULONG topic_offset, UINT topic_length,
+                                                          ULONG message_offset, ULONG message_length, VOID *context),
+                                         VOID *context)
 {
 
-UINT status;
+NXD_MQTT_TOPIC_NODE **node_list_ptr;
+NXD_MQTT_TOPIC_NODE  *node_ptr;
+UCHAR                *level_ptr = (UCHAR *)topic_filter;
+UCHAR                *level_end;
+UCHAR                *filter_end = (UCHAR *)topic_filter + topic_filter_length;
 
-    if (client_ptr == NX_NULL)
-    {
-        return(NX_PTR_ERROR);
-    }
+    tx_mutex_get(client_ptr -> nxd_mqtt_client_mutex_ptr, NX_WAIT_FOREVER);
 
-    if (server_ip == NX_NULL)
+    /* Walk down the levels of the filter, adding the missing ones. */
+    node_list_ptr = &(client_ptr -> nxd_mqtt_client_topic_trie);
+    for (;;)
     {
-        return(NX_PTR_ERROR);
-    }
+        level_end = level_ptr;
+        while ((level_end < filter_end) && (*level_end != '/'))
+        {
+            level_end++;
+        }
 
-    /* Test for IP version flag. */
-    if ((server_ip -> nxd_ip_version != 4) && (server_ip -> nxd_ip_version != 6))
-    {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        for (node_ptr = *node_list_ptr; node_ptr; node_ptr = node_ptr -> nxd_mqtt_topic_node_sibling)
+        {
+            if ((node_ptr -> nxd_mqtt_topic_node_level_length == (UINT)(level_end - level_ptr)) &&
+                (memcmp(node_ptr -> nxd_mqtt_topic_node_level, level_ptr, (UINT)(level_end - level_ptr)) == 0))
+            {
+                break;
+            }
+        }
+
+        if (node_ptr == NX_NULL)
+        {
+            if (callback == NX_NULL)
+            {
+
+                /* The filter is not set, nothing to remove. */
+                tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+                return(NXD_MQTT_SUCCESS);
+            }
+
+            node_ptr = client_ptr -> nxd_mqtt_client_topic_free_list;
+            if (node_ptr == NX_NULL)
+            {
+
+                /* Out of nodes, free the levels added for this filter. */
+                _nxd_mqtt_topic_trie_prune(client_ptr, &(client_ptr -> nxd_mqtt_client_topic_trie));
+                tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
+                return(NXD_MQTT_INSUFFICIENT_BUFFER_SPACE);
+            }
+            client_ptr -> nxd_mqtt_client_topic_free_list = node_ptr -> nxd_mqtt_topic_node_sibling;
+
+            node_ptr -> nxd_mqtt_topic_node_level = level_ptr;
+            node_ptr -> nxd_mqtt_topic_node_level_length = (UINT)(level_end - level_ptr);
+            node_ptr -> nxd_mqtt_topic_node_child = NX_NULL;
+            node_ptr -> nxd_mqtt_topic_node_callback = NX_NULL;
+            node_ptr -> nxd_mqtt_topic_node_context = NX_NULL;
+            node_ptr -> nxd_mqtt_topic_node_sibling = *node_list_ptr;
+            *node_list_ptr = node_ptr;
+        }
+
+        if (level_end == filter_end)
+        {
+            break;
+        }
+
+        node_list_ptr = &(node_ptr -> nxd_mqtt_topic_node_child);
+        level_ptr = level_end + 1;
     }
 
-    if (server_port == 0)
+    node_ptr -> nxd_mqtt_topic_node_callback = callback;
+    node_ptr -> nxd_mqtt_topic_node_context = context;
+
+    if (callback == NX_NULL)
     {
-        return(NX_INVALID_PORT);
+        _nxd_mqtt_topic_trie_prune(client_ptr, &(client_ptr -> nxd_mqtt_client_topic_trie));
     }
 
-    status = _nxd_mqtt_client_connect(client_ptr, server_ip, server_port, keepalive, clean_session, wait_option);
+    tx_mutex_put(client_ptr -> nxd_mqtt_client_mutex_ptr);
 
-    return(status);
+    return(NXD_MQTT_SUCCESS);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_secure_connect                    PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_ack_notify_set                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client TLS secure connect.  */
-/*                                                                        */
+/*    This function checks for errors in setting MQTT client ACK notify   */
+/*    function.                                                           */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    server_ip                             Server IP address structure   */
-/*    server_port                           Server port number, in host   */
-/*                                            byte order                  */
-/*    tls_setup                             User-supplied callback        */
-/*                                            function to set up TLS      */
-/*                                            parameters.                 */
-/*    keepalive                             The MQTT keepalive timer      */
-/*    wait_option                           Suspension option             */
-/*                                                                        */
+/*    ack_notify                            The notify function to be     */
+/*                                            used when an ACK is         */
+/*                                            received from the server.   */
+/*    context                               Context passed to the notify  */
+/*                                            function                    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5476,74 +11925,44 @@ UINT status;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_connect              Actual MQTT Client connect    */
-/*                                            call                        */
+/*    _nxd_mqtt_client_ack_notify_set                                     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            corrected mqtt client state,*/
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-#ifdef NX_SECURE_ENABLE
-
-UINT _nxde_mqtt_client_secure_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *server_ip, UINT server_port,
-                                      UINT (*tls_setup)(NXD_MQTT_CLIENT *client_ptr, NX_SECURE_TLS_SESSION *,
-                                                        NX_SECURE_X509_CERT *, NX_SECURE_X509_CERT *),
-                                      UINT keepalive, UINT clean_session, ULONG wait_option)
+UINT _nxde_mqtt_client_ack_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                      VOID (*ack_notify)(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                                         NX_PACKET *transmit_packet_ptr, VOID *context),
+                                      VOID *context)
 {
 
-UINT status;
-
+    /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
-
-    if (server_ip == NX_NULL)
-    {
-        return(NX_PTR_ERROR);
-    }
-
-    if (server_port == 0)
-    {
-        return(NX_INVALID_PORT);
-    }
-
-    status = _nxd_mqtt_client_secure_connect(client_ptr, server_ip, server_port, tls_setup,
-                                             keepalive, clean_session, wait_option);
-
-    return(status);
+    return(_nxd_mqtt_client_ack_notify_set(client_ptr, ack_notify, context));
 }
-#endif /* NX_SECURE_ENABLE */
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_delete                            PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_inflight_table_set                PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client delete call.         */
-/*                                                                        */
+/*    This function checks for errors in setting the MQTT client inflight */
+/*    table.                                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    memory_ptr                            Memory of the table           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5551,67 +11970,48 @@ UINT status;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_delete               Actual MQTT Client delete     */
-/*                                            call.                       */
+/*    _nxd_mqtt_client_inflight_table_set                                 */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr)
+UINT _nxde_mqtt_client_inflight_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
-UINT status;
-
+    /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
 
-    status = _nxd_mqtt_client_delete(client_ptr);
+    /* The memory must hold at least one entry. */
+    if (memory_ptr && (memory_size < sizeof(NXD_MQTT_INFLIGHT_ENTRY)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
 
-    return(status);
+    return(_nxd_mqtt_client_inflight_table_set(client_ptr, memory_ptr, memory_size));
 }
 
 
-
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_publish                           PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_qos2_table_set                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function performs error checking to the publish service.       */
-/*                                                                        */
+/*    This function checks for errors in setting the MQTT client QoS 2    */
+/*    table.                                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Name of the topic             */
-/*    topic_name_length                     Length of the topic name      */
-/*    message                               Message string                */
-/*    message_length                        Length of the message,        */
-/*                                            in bytes                    */
-/*    retain                                The retain flag, whether      */
-/*                                            or not the broker should    */
-/*                                            store this message          */
-/*    QoS                                   Expected QoS level            */
-/*    wait_option                           Suspension option             */
+/*    memory_ptr                            Memory of the table           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5619,150 +12019,101 @@ UINT status;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nxd_mqtt_client_qos2_table_set                                     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
-                               CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG wait_option)
+UINT _nxde_mqtt_client_qos2_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
-    /* Validate client_ptr */
-    if (client_ptr == NX_NULL)
-    {
-        return(NX_PTR_ERROR);
-    }
-
-    /* Validate topic_name */
-    if ((topic_name == NX_NULL) || (topic_name_length == 0))
-    {
-        return(NXD_MQTT_INVALID_PARAMETER);
-    }
 
-    /* Validate message length. */
-    if (message && (message_length == 0))
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
     {
-        return(NXD_MQTT_INVALID_PARAMETER);
+        return(NX_PTR_ERROR);
     }
 
-    /* Validate QoS value. */
-    if (QoS > 3)
+    /* The memory must hold at least two entries, one is kept free. */
+    if (memory_ptr && (memory_size < 2 * sizeof(NXD_MQTT_QOS2_ENTRY)))
     {
         return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    return(_nxd_mqtt_client_publish(client_ptr, topic_name, topic_name_length, message, message_length, retain, QoS, wait_option));
+    return(_nxd_mqtt_client_qos2_table_set(client_ptr, memory_ptr, memory_size));
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_subscribe                         PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_last_value_cache_set              PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function performs error checking to the subscribe service.     */
-/*                                                                        */
+/*    This function checks for errors in setting the MQTT client last     */
+/*    value cache memory.                                                 */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Pointer to the topic string   */
-/*                                            to subscribe to             */
-/*    topic_name_length                     Length of the topic string    */
-/*                                            in bytes                    */
+/*    memory_ptr                            Memory of the cache           */
+/*    memory_size                           Size of the memory, in bytes  */
+/*    entry_size                            Size of an entry, in bytes    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Pointer to the topic string   */
-/*                                            to subscribe to             */
-/*    topic_name_length                     Length of the topic string    */
-/*                                            in bytes                    */
-/*    QoS                                   Expected QoS level            */
+/*    status                                Completion status             */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_subscribe                                          */
+/*    _nxd_mqtt_client_last_value_cache_set                               */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS)
+UINT _nxde_mqtt_client_last_value_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG entry_size)
 {
 
-
     /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
 
-    /* Validate topic_name */
-    if ((topic_name == NX_NULL) || (topic_name_length == 0))
-    {
-        return(NXD_MQTT_INVALID_PARAMETER);
-    }
-
-    /* Validate QoS value. */
-    if (QoS > 2)
+    /* The memory must hold at least two entries with room for a topic, one is kept free. */
+    if (memory_ptr && ((entry_size <= sizeof(NXD_MQTT_LAST_VALUE_ENTRY)) || (memory_size < 2 * entry_size)))
     {
         return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    return(_nxd_mqtt_client_subscribe(client_ptr, topic_name, topic_name_length, QoS));
+    return(_nxd_mqtt_client_last_value_cache_set(client_ptr, memory_ptr, memory_size, entry_size));
 }
 
 
-
-
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_unsubscribe                       PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_last_value_get                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function performs error checking to the unsubscribe service.   */
-/*                                                                        */
+/*    This function checks for errors in getting the last message of a    */
+/*    topic from the MQTT client last value cache.                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_name                            Pointer to the topic string   */
-/*                                            to unsubscribe              */
-/*    topic_name_length                     Length of the topic string    */
-/*                                            in bytes                    */
+/*    topic_name                            Topic                         */
+/*    topic_name_length                     Length of the topic           */
+/*    message_buffer                        Buffer of the message         */
+/*    message_buffer_size                   Size of the buffer            */
+/*    actual_message_length                 Length of the message         */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5770,56 +12121,55 @@ UINT _nxde_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name,
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nxd_mqtt_client_last_value_get                                     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length)
+UINT _nxde_mqtt_client_last_value_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
 {
+
     /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
 
-    /* Validate topic_name */
-    if ((topic_name == NX_NULL) || (topic_name_length == 0))
+    if ((topic_name == NX_NULL) || (message_buffer == NX_NULL) || (actual_message_length == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    if (topic_name_length == 0)
     {
         return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    return(_nxd_mqtt_client_unsubscribe(client_ptr, topic_name, topic_name_length));
+    return(_nxd_mqtt_client_last_value_get(client_ptr, topic_name, topic_name_length,
+                                           message_buffer, message_buffer_size, actual_message_length));
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_disconnect                        PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_publish_ring_set                  PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client disconnect call.     */
-/*                                                                        */
+/*    This function checks for errors in setting the MQTT client publish  */
+/*    ring memory.                                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
+/*    memory_ptr                            Memory of the ring            */
+/*    memory_size                           Size of the memory, in bytes  */
+/*    slot_size                             Size of a slot, in bytes      */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5827,62 +12177,47 @@ UINT _nxde_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_disconnect           Actual MQTT Client disconnect */
-/*                                            call                        */
+/*    _nxd_mqtt_client_publish_ring_set                                   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr)
+UINT _nxde_mqtt_client_publish_ring_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG slot_size)
 {
+
     /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
 
-    return(_nxd_mqtt_client_disconnect(client_ptr));
-}
+    /* The memory must hold at least one slot with room for a topic. */
+    if (memory_ptr && ((slot_size <= sizeof(NXD_MQTT_PUBLISH_SLOT)) || (memory_size < slot_size)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
 
+    return(_nxd_mqtt_client_publish_ring_set(client_ptr, memory_ptr, memory_size, slot_size));
+}
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_message_get                       PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_connect_cache_set                 PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client message get call.    */
-/*                                                                        */
+/*    This function checks for errors in setting the MQTT client CONNECT  */
+/*    cache memory.                                                       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    topic_buffer                          Pointer to the topic buffer   */
-/*                                            where topic is copied to    */
-/*    topic_buffer_size                     Size of the topic buffer.     */
-/*    actual_topic_length                   Number of bytes copied into   */
-/*                                            topic_buffer                */
-/*    message_buffer                        Pointer to the buffer where   */
-/*                                            message is copied to        */
-/*    message_buffer_size                   Size of the message_buffer    */
-/*    actual_message_length                 Number of bytes copied into   */
-/*                                            the message buffer.         */
+/*    memory_ptr                            Memory of the cache           */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5890,24 +12225,14 @@ UINT _nxde_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_message_get                                        */
-/*                                                                        */
+/*    _nxd_mqtt_client_connect_cache_set                                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
-                                   UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length)
+UINT _nxde_mqtt_client_connect_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
     /* Validate client_ptr */
@@ -5916,42 +12241,39 @@ UINT _nxde_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buf
         return(NX_PTR_ERROR);
     }
 
-    /* Topic and topic_length can be NULL if caller does not care the topic string. */
-
-    /* Validate message.  Message_length can be NULL if caller does not care message length. */
-    if ((message_buffer == NX_NULL) || (topic_buffer == NX_NULL))
+    /* The memory must hold at least a CONNECT without payload. */
+    if (memory_ptr && (memory_size < 12))
     {
         return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-
-    return(_nxd_mqtt_client_message_get(client_ptr, topic_buffer, topic_buffer_size, actual_topic_length,
-                                        message_buffer, message_buffer_size, actual_message_length));
+    return(_nxd_mqtt_client_connect_cache_set(client_ptr, memory_ptr, memory_size));
 }
 
 
+
+
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_receive_notify_set                PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_publish_enqueue                   PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in MQTT client publish notify call. */
-/*                                                                        */
+/*    This function checks for errors in the MQTT client publish enqueue  */
+/*    call. It makes no caller check, interrupts included are allowed.    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    receive_notify                        User-supplied callback        */
-/*                                            function, which is invoked  */
-/*                                            upon receiving a publish    */
-/*                                            message.                    */
+/*    topic_name                            Name of the topic             */
+/*    topic_name_length                     Length of the topic name      */
+/*    message                               Message string                */
+/*    message_length                        Length of the message,        */
+/*                                            in bytes                    */
+/*    retain                                The retain flag               */
+/*    QoS                                   Expected QoS level            */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -5959,62 +12281,61 @@ UINT _nxde_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buf
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_receive_notify_set                                 */
-/*                                                                        */
+/*    _nxd_mqtt_client_publish_enqueue                                    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
-                                          VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count))
+UINT _nxde_mqtt_client_publish_enqueue(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                       CHAR *message, UINT message_length, UINT retain, UINT QoS)
 {
+
     /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
 
-    if (receive_notify == NX_NULL)
+    /* Validate topic_name */
+    if ((topic_name == NX_NULL) || (topic_name_length == 0))
     {
-        return(NX_PTR_ERROR);
+        return(NXD_MQTT_INVALID_PARAMETER);
     }
 
-    return(_nxd_mqtt_client_receive_notify_set(client_ptr, receive_notify));
-}
+    /* Validate the message. */
+    if ((message == NX_NULL) && message_length)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate QoS value. */
+    if (QoS > 2)
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
 
+    return(_nxd_mqtt_client_publish_enqueue(client_ptr, topic_name, topic_name_length, message, message_length, retain, QoS));
+}
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxd_mqtt_client_disconnect_notify_set              PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_topic_trie_set                    PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function sets the notify function for the disconnect event.    */
+/*    This function checks for errors in setting the MQTT client topic    */
+/*    filter trie memory.                                                 */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    disconnect_notify                     The notify function to be     */
-/*                                            used when the client is     */
-/*                                            disconnected from the       */
-/*                                            server.                     */
+/*    memory_ptr                            Memory of the trie            */
+/*    memory_size                           Size of the memory, in bytes  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -6022,51 +12343,51 @@ UINT _nxde_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _nxd_mqtt_client_topic_trie_set                                     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxd_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *))
+UINT _nxde_mqtt_client_topic_trie_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size)
 {
 
-    client_ptr -> nxd_mqtt_disconnect_notify = disconnect_notify;
+    /* Validate client_ptr */
+    if (client_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
 
-    return(NXD_MQTT_SUCCESS);
+    /* The memory must hold at least one node. */
+    if (memory_ptr && (memory_size < sizeof(NXD_MQTT_TOPIC_NODE)))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    return(_nxd_mqtt_client_topic_trie_set(client_ptr, memory_ptr, memory_size));
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nxde_mqtt_client_disconnect_notify_set             PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nxde_mqtt_client_topic_callback_set                PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function checks for errors in setting MQTT client disconnect   */
-/*    callback function.                                                  */
+/*    This function checks for errors in setting the callback of an MQTT  */
+/*    topic filter. "+" must fill a whole level, "#" must fill the last   */
+/*    level.                                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    client_ptr                            Pointer to MQTT Client        */
-/*    disconnect_callback                   The callback function to be   */
-/*                                            used when an on-going       */
-/*                                            connection is disconnected. */
+/*    topic_filter                          Topic filter                  */
+/*    topic_filter_length                   Length of the topic filter    */
+/*    callback                              Callback of the filter        */
+/*    context                               Context passed to callback    */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -6074,30 +12395,48 @@ UINT _nxd_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nxd_mqtt_client_disconnect_notify_set                              */
+/*    _nxd_mqtt_client_topic_callback_set                                 */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    Application Code                                                    */
 /*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
 /**************************************************************************/
-UINT _nxde_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *))
+UINT _nxde_mqtt_client_topic_callback_set(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_filter, UINT topic_filter_length,
+                                          VOID (*callback)(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                           ULONG topic_offset, UINT topic_length,
+                                                           ULONG message_offset, ULONG message_length, VOID *context),
+                                          VOID *context)
 {
 
+UINT i;
+
     /* Validate client_ptr */
     if (client_ptr == NX_NULL)
     {
         return(NX_PTR_ERROR);
     }
-    return(_nxd_mqtt_client_disconnect_notify_set(client_ptr, disconnect_notify));
+
+    /* Validate topic_filter */
+    if ((topic_filter == NX_NULL) || (topic_filter_length == 0))
+    {
+        return(NXD_MQTT_INVALID_PARAMETER);
+    }
+
+    /* Validate the wildcards, MQTT 4.7.1. */
+    for (i = 0; i < topic_filter_length; i++)
+    {
+        if ((topic_filter[i] == '+') || (topic_filter[i] == '#'))
+        {
+            if (((i > 0) && (topic_filter[i - 1] != '/')) ||
+                ((i + 1 < topic_filter_length) && ((topic_filter[i] == '#') || (topic_filter[i + 1] != '/'))))
+            {
+                return(NXD_MQTT_INVALID_PARAMETER);
+            }
+        }
+    }
+
+    return(_nxd_mqtt_client_topic_callback_set(client_ptr, topic_filter, topic_filter_length, callback, context));
 }
 
 
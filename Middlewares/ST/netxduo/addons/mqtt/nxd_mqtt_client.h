@@ -87,6 +87,21 @@ extern   "C" {
 #endif /* NX_SECURE_ENABLE */
 #endif /* NXD_MQTT_REQUIRE_TLS */
 
+/* Defined, the client does not create its own thread. The application processes
+   the events of the client by calling nxd_mqtt_client_events_process from one of
+   its threads, the one that also connects, publishes and deletes the client.
+   The stack and priority passed to nxd_mqtt_client_create are not used.
+   With nxd_mqtt_client_events_signal_set, each event of the client also sets
+   a flag in a group of the application, so that one thread can wait for the
+   events of several clients at once.  */
+/*
+#define NXD_MQTT_APPLICATION_EVENT_LOOP
+*/
+
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP) && defined(NXD_MQTT_CLOUD_ENABLE)
+#error "The features NXD_MQTT_APPLICATION_EVENT_LOOP and NXD_MQTT_CLOUD_ENABLE are exclusive."
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP && NXD_MQTT_CLOUD_ENABLE */
+
 /* Defined, MQTT transmit queue depth is enabled. It must be positive integer.  */
 /*
 #define NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH                          20
@@ -123,8 +138,9 @@ extern   "C" {
 #define NXD_MQTT_CLIENT_THREAD_TIME_SLICE                              2
 #endif
 
-/* Set the default timer rate for the keepalive timer, in ThreadX timer ticks.
-   THe default is one second. */
+/* Set how long before the keepalive timeout the ping is sent, in ThreadX timer
+   ticks. The keepalive timer is one-shot and expires at this point only.
+   The default is one second. */
 #ifndef NXD_MQTT_KEEPALIVE_TIMER_RATE
 #define NXD_MQTT_KEEPALIVE_TIMER_RATE                                  (NX_IP_PERIODIC_RATE)
 #endif
@@ -156,11 +172,108 @@ extern   "C" {
 #define NXD_MQTT_SOCKET_TIMEOUT                                         NX_WAIT_FOREVER
 #endif
 
+/* Define the room reserved for the TLS record header, IV and MAC when the
+   packet pool size class of an outgoing message sent over TLS is chosen. */
+#ifndef NXD_MQTT_TLS_PACKET_OVERHEAD
+#define NXD_MQTT_TLS_PACKET_OVERHEAD                                   128
+#endif
+
+/* Define the largest number of bytes of PUBLISH packets packed into one
+   batch by nxd_mqtt_client_publish_batch_begin before the batch is sent. */
+#ifndef NXD_MQTT_PUBLISH_BATCH_SIZE
+#define NXD_MQTT_PUBLISH_BATCH_SIZE                                    1024
+#endif
+
+/* Define the largest number of topic filters sent in one SUBSCRIBE packet by
+   nxd_mqtt_client_subscribe_list. The list is split further to fit the
+   Maximum Packet Size of an MQTT 5 broker and the TLS record size limit. */
+#ifndef NXD_MQTT_SUBSCRIBE_FILTERS_MAX
+#define NXD_MQTT_SUBSCRIBE_FILTERS_MAX                                 16
+#endif
+
+/* Define the largest number of topic filter callbacks invoked for one message. */
+#ifndef NXD_MQTT_TOPIC_MATCH_MAX
+#define NXD_MQTT_TOPIC_MATCH_MAX                                       8
+#endif
+
+/* Define the largest number of topic aliases the client assigns to its own
+   publishes when NXD_MQTT_V5_ENABLE is defined. The number actually used is
+   capped by the Topic Alias Maximum of the server. */
+#ifndef NXD_MQTT_TOPIC_ALIAS_MAX
+#define NXD_MQTT_TOPIC_ALIAS_MAX                                       8
+#endif
+
+/* Define the longest topic, in bytes, that is given a topic alias. */
+#ifndef NXD_MQTT_TOPIC_ALIAS_TOPIC_SIZE
+#define NXD_MQTT_TOPIC_ALIAS_TOPIC_SIZE                                64
+#endif
+
+/* Define the longest topic, in bytes, of a topic prepared with
+   nxd_mqtt_client_topic_prepare. */
+#ifndef NXD_MQTT_PREPARED_TOPIC_SIZE
+#define NXD_MQTT_PREPARED_TOPIC_SIZE                                   64
+#endif
+
+/* Defined, the client times each QoS 1 and QoS 2 message from its publish
+   call to its handoff to TCP, and to the PUBACK or PUBREC of the broker. The
+   queueing delay, the network round trip and the total are counted into
+   log-linear histograms of microseconds, read with
+   nxd_mqtt_client_latency_get.  */
+/*
+#define NXD_MQTT_LATENCY_ENABLE
+*/
+
+/* Defined, the TLS session of the client is created by the tls_setup callback
+   of the first nxd_mqtt_client_secure_connect only. At the end of each
+   connection it is reset instead of deleted, keeping its ciphersuite table,
+   packet buffer and trusted certificates, and nxd_mqtt_client_delete deletes
+   it. The callback is still called on each connect, and must return at once
+   when the session is already created, nx_secure_tls_id set to
+   NX_SECURE_TLS_ID.  */
+/*
+#define NXD_MQTT_TLS_SESSION_KEEP
+*/
+
+/* Define the number of buckets of each latency histogram. Four buckets per
+   power of two, the 96 buckets reach 2^25 microseconds, 33 s. The last
+   bucket also counts the longer latencies. */
+#ifndef NXD_MQTT_LATENCY_BUCKETS
+#define NXD_MQTT_LATENCY_BUCKETS                                       96
+#endif
+
+/* Define the clock the latencies are measured on, and the conversion of a
+   time difference on it to microseconds. By default, the ThreadX timer. */
+#ifndef NXD_MQTT_LATENCY_TIME
+#define NXD_MQTT_LATENCY_TIME()                                        tx_time_get()
+#define NXD_MQTT_LATENCY_MICROSECONDS(time)                            ((time) * (1000000UL / TX_TIMER_TICKS_PER_SECOND))
+#endif
+
+/* Define the publish lanes. A publish of the control lane is never held in
+   the open publish batch, it goes out ahead of the bulk messages batched
+   before it. Each lane may have its own rate limit. Publishes keep their
+   order within a lane only. */
+#define NXD_MQTT_LANE_CONTROL                                          0
+#define NXD_MQTT_LANE_BULK                                             1
+#define NXD_MQTT_LANES                                                 2
+
+/* Define the policies of a full receive queue, see
+   nxd_mqtt_client_receive_queue_set. The QoS 0 messages are dropped, the
+   oldest queued or the one received, or the client stops reading the TCP
+   socket until the application takes a message, closing the window of the
+   broker. QoS 1 and 2 messages are acknowledged, they are never dropped. */
+#define NXD_MQTT_RECEIVE_QUEUE_DROP_OLDEST                             1
+#define NXD_MQTT_RECEIVE_QUEUE_DROP_NEWEST                             2
+#define NXD_MQTT_RECEIVE_QUEUE_BACKPRESSURE                            3
+
 /* Define the default MQTT TLS (secure) port number */
 #define NXD_MQTT_TLS_PORT                                              8883
 
 
+#ifndef NXD_MQTT_V5_ENABLE
 #define MQTT_PROTOCOL_LEVEL                                            4
+#else
+#define MQTT_PROTOCOL_LEVEL                                            5
+#endif /* NXD_MQTT_V5_ENABLE */
 
 /* Define bit fields and constant values used in the CONNECT packet. */
 #define MQTT_CONNECT_FLAGS_USERNAME                                    (1 << 7)
@@ -182,6 +295,19 @@ extern   "C" {
 #define MQTT_CONNACK_CONNECT_RETURN_CODE_BAD_USERNAME_PASSWORD         (4)
 #define MQTT_CONNACK_CONNECT_RETURN_CODE_NOT_AUTHORIZED                (5)
 
+/* Define the MQTT 5 reason codes of the CONNACK packet that have an MQTT 3.1.1 return code. */
+#define MQTT_REASON_CODE_UNSUPPORTED_PROTOCOL_VERSION                  (0x84)
+#define MQTT_REASON_CODE_CLIENT_IDENTIFIER_NOT_VALID                   (0x85)
+#define MQTT_REASON_CODE_BAD_USERNAME_PASSWORD                         (0x86)
+#define MQTT_REASON_CODE_NOT_AUTHORIZED                                (0x87)
+#define MQTT_REASON_CODE_SERVER_UNAVAILABLE                            (0x88)
+
+/* Define the MQTT 5 property identifiers used by the client. */
+#define MQTT_PROPERTY_SESSION_EXPIRY_INTERVAL                          (0x11)
+#define MQTT_PROPERTY_MAXIMUM_PACKET_SIZE                              (0x27)
+#define MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM                              (0x22)
+#define MQTT_PROPERTY_TOPIC_ALIAS                                      (0x23)
+
 /* Define bit fields and constant values used in the PUBLISH packet. */
 #define MQTT_PUBLISH_DUP_FLAG                                          (1 << 3)
 #define MQTT_PUBLISH_QOS_LEVEL_0                                       (0)
@@ -293,6 +419,8 @@ typedef struct MQTT_PACKET_DISCONNECT_STRUCT
 #define NXD_MQTT_PARTIAL_PACKET              0x10010
 #define NXD_MQTT_CONNECTING                  0x10011
 #define NXD_MQTT_INVALID_STATE               0x10012
+#define NXD_MQTT_RATE_LIMITED                0x10013
+#define NXD_MQTT_PUBLISH_RING_FULL           0x10014
 
 /* The following error codes match the Connect Return code in CONNACK message. */
 #define NXD_MQTT_ERROR_CONNECT_RETURN_CODE   0x10080
@@ -303,6 +431,179 @@ typedef struct MQTT_PACKET_DISCONNECT_STRUCT
 #define NXD_MQTT_ERROR_NOT_AUTHORIZED        0x10085
 
 
+/* Define the entry of the inflight table, which indexes the transmit queue
+   by packet ID. The table is an open addressing hash table with linear
+   probing, its size is a power of two. */
+typedef struct NXD_MQTT_INFLIGHT_ENTRY_STRUCT
+{
+    NX_PACKET                     *nxd_mqtt_inflight_packet_ptr;       /* Packet on the transmit queue, NULL if free */
+    NX_PACKET                     *nxd_mqtt_inflight_previous_ptr;     /* Previous packet on the transmit queue      */
+} NXD_MQTT_INFLIGHT_ENTRY;
+
+/* Define the entry of the QoS 2 table, which keeps the phase of a QoS 2
+   exchange by packet ID once its message is no longer needed, instead of
+   a packet on the transmit queue. The table is an open addressing hash
+   table with linear probing, its size is a power of two. */
+typedef struct NXD_MQTT_QOS2_ENTRY_STRUCT
+{
+    USHORT                         nxd_mqtt_qos2_packet_id;
+    USHORT                         nxd_mqtt_qos2_phase;                /* NXD_MQTT_QOS2_FREE if the entry is free    */
+} NXD_MQTT_QOS2_ENTRY;
+
+#define NXD_MQTT_QOS2_FREE                   0
+#define NXD_MQTT_QOS2_PUBREC_SENT            1                         /* Message received, waiting for PUBREL       */
+#define NXD_MQTT_QOS2_PUBREL_SENT            2                         /* Message sent and received, waiting for PUBCOMP */
+
+/* Define the header of an entry of the last value cache, which keeps the
+   latest message received on each topic. The topic and then the message
+   follow the header, within the entry size given to
+   nxd_mqtt_client_last_value_cache_set. The cache is an open addressing
+   hash table on the topic with linear probing, its size is a power of two. */
+typedef struct NXD_MQTT_LAST_VALUE_ENTRY_STRUCT
+{
+    ULONG                          nxd_mqtt_last_value_hash;           /* Hash of the topic, 0 if the entry is free  */
+    ULONG                          nxd_mqtt_last_value_time;           /* TX Timer tick of the last message          */
+    USHORT                         nxd_mqtt_last_value_topic_length;
+    USHORT                         nxd_mqtt_last_value_length;
+} NXD_MQTT_LAST_VALUE_ENTRY;
+
+/* Define the header of a slot of the publish ring, which holds a message of
+   nxd_mqtt_client_publish_enqueue until the thread processing the events of
+   the client publishes it. The topic and then the message follow the header,
+   within the slot size given to nxd_mqtt_client_publish_ring_set. The ring
+   size is a power of two. */
+typedef struct NXD_MQTT_PUBLISH_SLOT_STRUCT
+{
+    volatile UINT                  nxd_mqtt_publish_slot_ready;        /* Set once the message is copied in          */
+    USHORT                         nxd_mqtt_publish_slot_topic_length;
+    USHORT                         nxd_mqtt_publish_slot_length;
+    UCHAR                          nxd_mqtt_publish_slot_retain;
+    UCHAR                          nxd_mqtt_publish_slot_qos;
+    USHORT                         nxd_mqtt_publish_slot_reserved;
+} NXD_MQTT_PUBLISH_SLOT;
+
+/* Define a fragment of a message published with nxd_mqtt_client_publish_iov. */
+typedef struct NXD_MQTT_IOV_STRUCT
+{
+    VOID                          *nxd_mqtt_iov_base;
+    UINT                           nxd_mqtt_iov_length;
+} NXD_MQTT_IOV;
+
+/* Define a topic prepared by nxd_mqtt_client_topic_prepare: the first byte of
+   the fixed header and the encoded topic of its PUBLISH packets, copied as
+   they are ahead of each message of nxd_mqtt_client_prepared_publish, which
+   only fills in the remaining length, the packet ID and the properties. The
+   publishes only read it, several clients and threads may publish on it at
+   the same time. */
+typedef struct NXD_MQTT_PREPARED_TOPIC_STRUCT
+{
+    UCHAR                          nxd_mqtt_prepared_topic_header;     /* Type, QoS and retain flags                 */
+    UCHAR                          nxd_mqtt_prepared_topic_qos;
+    USHORT                         nxd_mqtt_prepared_topic_length;     /* Bytes of the template                      */
+    UCHAR                          nxd_mqtt_prepared_topic_template[NXD_MQTT_PREPARED_TOPIC_SIZE + 2]; /* Length and topic */
+} NXD_MQTT_PREPARED_TOPIC;
+
+/* Define the token bucket of a publish lane. One message costs
+   NX_IP_PERIODIC_RATE tokens, each tick adds the rate in messages per
+   second, up to the burst. */
+typedef struct NXD_MQTT_LANE_STRUCT
+{
+    UINT                           nxd_mqtt_lane_rate;                 /* Messages per second, 0 for no limit        */
+    ULONG                          nxd_mqtt_lane_capacity;             /* Burst, in tokens                           */
+    ULONG                          nxd_mqtt_lane_tokens;               /* Tokens left                                */
+    ULONG                          nxd_mqtt_lane_update_time;          /* TX Timer tick the tokens were counted at   */
+} NXD_MQTT_LANE;
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+/* Define a latency histogram. Bucket n counts the latencies of n
+   microseconds below 4, then each power of two 2^e to 2^(e+1) - 1 is split
+   into four linear buckets, 4(e - 1) to 4(e - 1) + 3. */
+typedef struct NXD_MQTT_LATENCY_HISTOGRAM_STRUCT
+{
+    ULONG                          nxd_mqtt_latency_count;
+    ULONG                          nxd_mqtt_latency_maximum;           /* Microseconds                               */
+    ULONG                          nxd_mqtt_latency_buckets[NXD_MQTT_LATENCY_BUCKETS];
+} NXD_MQTT_LATENCY_HISTOGRAM;
+
+/* Define the latency histograms of the QoS 1 and QoS 2 messages. A message
+   acknowledged before it was handed to TCP, as when its send failed and the
+   PUBACK follows the retransmission, counts in the total only. */
+typedef struct NXD_MQTT_LATENCY_STRUCT
+{
+    NXD_MQTT_LATENCY_HISTOGRAM     nxd_mqtt_latency_queueing;          /* From the publish call to TCP               */
+    NXD_MQTT_LATENCY_HISTOGRAM     nxd_mqtt_latency_network;           /* From TCP to the PUBACK or PUBREC           */
+    NXD_MQTT_LATENCY_HISTOGRAM     nxd_mqtt_latency_total;             /* From the publish call to the PUBACK or PUBREC */
+} NXD_MQTT_LATENCY;
+
+/* Lowest latency counted in a bucket, in microseconds. */
+#define NXD_MQTT_LATENCY_BUCKET_LOWER(index)                           (((index) < 4) ? (ULONG)(index) : \
+                                                                        ((ULONG)(4 + ((index) & 3)) << (((index) >> 2) - 1)))
+
+/* Stamps of a publish packet, in its headroom after the packet ID saved at the start of its buffer. */
+#define NXD_MQTT_LATENCY_SENT(packet_ptr)                              (((USHORT *)(packet_ptr) -> nx_packet_data_start)[1])
+#define NXD_MQTT_LATENCY_PUBLISH_TIME(packet_ptr)                      (((ULONG *)(packet_ptr) -> nx_packet_data_start)[1])
+#define NXD_MQTT_LATENCY_SEND_TIME(packet_ptr)                         (((ULONG *)(packet_ptr) -> nx_packet_data_start)[2])
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+/* Home slot of a transmit packet, keyed by the packet ID saved at the start of its buffer. */
+#define NXD_MQTT_INFLIGHT_HASH(packet_ptr, mask)                       ((UINT)(*((USHORT *)(packet_ptr) -> nx_packet_data_start)) & (mask))
+
+/* Entry of the last value cache at an index. */
+#define NXD_MQTT_LAST_VALUE_ENTRY_AT(client_ptr, index)                ((NXD_MQTT_LAST_VALUE_ENTRY *)((client_ptr) -> nxd_mqtt_client_last_value_cache + \
+                                                                        (ULONG)(index) * (client_ptr) -> nxd_mqtt_client_last_value_entry_size))
+
+/* Slot of the publish ring for a free running index. */
+#define NXD_MQTT_PUBLISH_SLOT_AT(client_ptr, index)                    ((NXD_MQTT_PUBLISH_SLOT *)((client_ptr) -> nxd_mqtt_client_publish_ring + \
+                                                                        (ULONG)((index) & ((client_ptr) -> nxd_mqtt_client_publish_slots - 1)) * \
+                                                                        (client_ptr) -> nxd_mqtt_client_publish_slot_size))
+
+/* Define the node of the topic filter trie. A node holds one level of a
+   topic filter, "+" and "#" included. The level text points into the
+   filter string of the application, which is not copied. */
+struct NXD_MQTT_CLIENT_STRUCT;
+
+typedef struct NXD_MQTT_TOPIC_NODE_STRUCT
+{
+    const UCHAR                       *nxd_mqtt_topic_node_level;
+    UINT                               nxd_mqtt_topic_node_level_length;
+    struct NXD_MQTT_TOPIC_NODE_STRUCT *nxd_mqtt_topic_node_child;         /* First node of the next level         */
+    struct NXD_MQTT_TOPIC_NODE_STRUCT *nxd_mqtt_topic_node_sibling;       /* Next node of this level, or free one */
+    VOID                             (*nxd_mqtt_topic_node_callback)(struct NXD_MQTT_CLIENT_STRUCT *client_ptr, NX_PACKET *packet_ptr,
+                                                                     ULONG topic_offset, UINT topic_length,
+                                                                     ULONG message_offset, ULONG message_length, VOID *context);
+    VOID                              *nxd_mqtt_topic_node_context;
+} NXD_MQTT_TOPIC_NODE;
+
+
+/* Define a topic filter of nxd_mqtt_client_subscribe_list. The client sets
+   the packet ID of the SUBSCRIBE carrying the filter and the reason code to
+   NXD_MQTT_TOPIC_FILTER_PENDING, then to the code of the SUBACK: the QoS
+   level granted, or a failure from 0x80. */
+#define NXD_MQTT_TOPIC_FILTER_PENDING                                  0xFF
+
+typedef struct NXD_MQTT_TOPIC_FILTER_STRUCT
+{
+    CHAR                          *nxd_mqtt_topic_filter_name;
+    UINT                           nxd_mqtt_topic_filter_name_length;
+    UINT                           nxd_mqtt_topic_filter_qos;                      /* QoS level requested                  */
+    USHORT                         nxd_mqtt_topic_filter_packet_id;                /* Set by the client                    */
+    UCHAR                          nxd_mqtt_topic_filter_reason_code;              /* Set by the client                    */
+    UCHAR                          nxd_mqtt_topic_filter_reserved;
+} NXD_MQTT_TOPIC_FILTER;
+
+
+/* Define a topic alias of the client. The alias value is the entry index
+   plus one. While a publish carrying the full topic is being sent, the
+   entry cannot be given to another topic. */
+typedef struct NXD_MQTT_TOPIC_ALIAS_STRUCT
+{
+    UCHAR                          nxd_mqtt_topic_alias_topic[NXD_MQTT_TOPIC_ALIAS_TOPIC_SIZE];
+    UINT                           nxd_mqtt_topic_alias_topic_length;              /* Zero if the entry is free            */
+    UINT                           nxd_mqtt_topic_alias_pending;                   /* Publishes sending the full topic     */
+    UINT                           nxd_mqtt_topic_alias_established;               /* Server knows the alias               */
+} NXD_MQTT_TOPIC_ALIAS;
+
+
 /* Define the basic MQTT Client control block. */
 typedef struct NXD_MQTT_CLIENT_STRUCT
 {
@@ -318,14 +619,25 @@ typedef struct NXD_MQTT_CLIENT_STRUCT
     UINT                           nxd_mqtt_client_will_topic_length;
     const UCHAR                   *nxd_mqtt_client_will_message;
     UINT                           nxd_mqtt_client_will_message_length;
+    UCHAR                         *nxd_mqtt_client_connect_cache;                   /* CONNECT packet of the last connection */
+    ULONG                          nxd_mqtt_client_connect_cache_size;
+    ULONG                          nxd_mqtt_client_connect_cache_length;            /* 0 until encoded with the settings below */
+    UINT                           nxd_mqtt_client_connect_cache_keepalive;
+    UINT                           nxd_mqtt_client_connect_cache_clean_session;
     NX_IP                         *nxd_mqtt_client_ip_ptr;                          /* Pointer to associated IP structure   */
     NX_PACKET_POOL                *nxd_mqtt_client_packet_pool_ptr;                 /* Pointer to client packet pool        */
     TX_MUTEX                      *nxd_mqtt_client_mutex_ptr;                       /* Pointer to client mutex              */
     TX_TIMER                       nxd_mqtt_timer;
 #ifndef NXD_MQTT_CLOUD_ENABLE
     TX_MUTEX                       nxd_mqtt_protection;
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
     TX_THREAD                      nxd_mqtt_thread;
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
     TX_EVENT_FLAGS_GROUP           nxd_mqtt_events;
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+    TX_EVENT_FLAGS_GROUP          *nxd_mqtt_events_signal_ptr;                      /* Group of the thread serving several clients */
+    ULONG                          nxd_mqtt_events_signal_flag;                     /* Flag of this client in that group    */
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
 #else
     NX_CLOUD                      *nxd_mqtt_client_cloud_ptr;                      /* Pointer to associated CLOUD structure.                    */
     NX_CLOUD                       nxd_mqtt_client_cloud;                          /* MQTT cloud.                                               */
@@ -338,19 +650,60 @@ typedef struct NXD_MQTT_CLIENT_STRUCT
     UINT                           nxd_mqtt_timer_value;                            /* MQTT Client periodic timer tick value.  */
     UINT                           nxd_mqtt_keepalive;                              /* Keepalive value, converted to TX ticks. */
     UINT                           nxd_mqtt_clean_session;                          /* Clean session flag. */
+    UINT                           nxd_mqtt_client_session_present;                 /* Server resumed the session, subscriptions included. */
     UINT                           nxd_mqtt_client_state;                           /* Record client state                  */
     NX_TCP_SOCKET                  nxd_mqtt_client_socket;
     struct NXD_MQTT_CLIENT_STRUCT *nxd_mqtt_client_next;
     UINT                           nxd_mqtt_client_packet_identifier;
     NX_PACKET                     *nxd_mqtt_client_processing_packet;
+    ULONG                          nxd_mqtt_client_processing_length;               /* Length of the partial message, 0 until its header is in */
     NX_PACKET                     *message_transmit_queue_head;
     NX_PACKET                     *message_transmit_queue_tail;
+    NX_PACKET                     *nxd_mqtt_client_batch_packet_ptr;                /* Publish packets waiting for a flush  */
+    UINT                           nxd_mqtt_client_batch_enabled;                   /* Publish batch is open                */
+    NXD_MQTT_LANE                  nxd_mqtt_client_lanes[NXD_MQTT_LANES];           /* Rate limits of the publish lanes     */
+#ifdef NXD_MQTT_LATENCY_ENABLE
+    NXD_MQTT_LATENCY               nxd_mqtt_client_latency;                         /* Latencies of the QoS 1 and 2 messages */
+#endif /* NXD_MQTT_LATENCY_ENABLE */
 #ifdef NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH
     UINT                           message_transmit_queue_depth;
 #endif /* NXD_MQTT_MAXIMUM_TRANSMIT_QUEUE_DEPTH */
+    NXD_MQTT_INFLIGHT_ENTRY       *nxd_mqtt_client_inflight_table;                  /* Packet ID index of the transmit queue */
+    UINT                           nxd_mqtt_client_inflight_table_size;             /* Number of entries, a power of two    */
+    UINT                           nxd_mqtt_client_inflight_count;                  /* Number of entries in use             */
+    NXD_MQTT_QOS2_ENTRY           *nxd_mqtt_client_qos2_table;                      /* Phase of the QoS 2 exchanges         */
+    UINT                           nxd_mqtt_client_qos2_table_size;                 /* Number of entries, a power of two    */
+    UINT                           nxd_mqtt_client_qos2_count;                      /* Number of entries in use             */
+    UCHAR                         *nxd_mqtt_client_last_value_cache;                /* Latest message of each topic         */
+    ULONG                          nxd_mqtt_client_last_value_entry_size;           /* Bytes per entry, header included     */
+    UINT                           nxd_mqtt_client_last_value_entries;              /* Number of entries, a power of two    */
+    UINT                           nxd_mqtt_client_last_value_count;                /* Number of entries in use             */
+    UCHAR                         *nxd_mqtt_client_publish_ring;                    /* Messages enqueued, not yet published */
+    ULONG                          nxd_mqtt_client_publish_slot_size;               /* Bytes per slot, header included      */
+    UINT                           nxd_mqtt_client_publish_slots;                   /* Number of slots, a power of two      */
+    volatile ULONG                 nxd_mqtt_client_publish_head;                    /* Slots claimed by the producers       */
+    volatile ULONG                 nxd_mqtt_client_publish_tail;                    /* Slots published                      */
+    ULONG                          nxd_mqtt_client_publish_dropped;                 /* Messages refused, the ring full      */
+    NXD_MQTT_TOPIC_NODE           *nxd_mqtt_client_topic_trie;                      /* First level of the topic filters     */
+    NXD_MQTT_TOPIC_NODE           *nxd_mqtt_client_topic_free_list;                 /* Unused topic filter nodes            */
+    NXD_MQTT_TOPIC_FILTER         *nxd_mqtt_client_filter_list;                     /* Filters waiting for their SUBACK     */
+    UINT                           nxd_mqtt_client_filter_list_count;
+#ifdef NXD_MQTT_V5_ENABLE
+    NXD_MQTT_TOPIC_ALIAS           nxd_mqtt_client_topic_alias[NXD_MQTT_TOPIC_ALIAS_MAX];
+    UINT                           nxd_mqtt_client_topic_alias_maximum;             /* Aliases usable on this connection    */
+    UINT                           nxd_mqtt_client_topic_alias_next;                /* Next entry to reassign               */
+    UINT                           nxd_mqtt_client_reason_code;                     /* Reason code of the last CONNACK or PUBACK */
+    ULONG                          nxd_mqtt_client_maximum_packet_size;             /* Largest packet the broker takes, 0 if any */
+#endif /* NXD_MQTT_V5_ENABLE */
     NX_PACKET                     *message_receive_queue_head;
     NX_PACKET                     *message_receive_queue_tail;
     UINT                           message_receive_queue_depth;
+    ULONG                          message_receive_queue_bytes;
+    UINT                           nxd_mqtt_client_receive_queue_messages;          /* Largest depth, 0 if any              */
+    ULONG                          nxd_mqtt_client_receive_queue_bytes;             /* Largest size in bytes, 0 if any      */
+    UINT                           nxd_mqtt_client_receive_queue_policy;            /* Policy once the queue is full        */
+    UINT                           nxd_mqtt_client_receive_paused;                  /* TCP socket left unread, queue full   */
+    ULONG                          nxd_mqtt_client_receive_dropped;                 /* QoS 0 messages dropped, queue full   */
     VOID                         (*nxd_mqtt_client_receive_notify)(struct NXD_MQTT_CLIENT_STRUCT *client_ptr, UINT number_of_messages);
     VOID                         (*nxd_mqtt_connect_notify)(struct NXD_MQTT_CLIENT_STRUCT *client_ptr, UINT status, VOID *context);
     VOID                          *nxd_mqtt_connect_context;
@@ -390,12 +743,36 @@ typedef struct NXD_MQTT_CLIENT_STRUCT
 #define nxd_mqtt_client_connect               _nxd_mqtt_client_connect
 #define nxd_mqtt_client_secure_connect        _nxd_mqtt_client_secure_connect
 #define nxd_mqtt_client_publish               _nxd_mqtt_client_publish
+#define nxd_mqtt_client_lane_publish          _nxd_mqtt_client_lane_publish
+#define nxd_mqtt_client_publish_iov           _nxd_mqtt_client_publish_iov
+#define nxd_mqtt_client_topic_prepare         _nxd_mqtt_client_topic_prepare
+#define nxd_mqtt_client_prepared_publish      _nxd_mqtt_client_prepared_publish
+#define nxd_mqtt_client_lane_rate_set         _nxd_mqtt_client_lane_rate_set
+#define nxd_mqtt_client_latency_get           _nxd_mqtt_client_latency_get
+#define nxd_mqtt_client_publish_batch_begin   _nxd_mqtt_client_publish_batch_begin
+#define nxd_mqtt_client_publish_batch_flush   _nxd_mqtt_client_publish_batch_flush
 #define nxd_mqtt_client_subscribe             _nxd_mqtt_client_subscribe
+#define nxd_mqtt_client_subscribe_list        _nxd_mqtt_client_subscribe_list
 #define nxd_mqtt_client_unsubscribe           _nxd_mqtt_client_unsubscribe
 #define nxd_mqtt_client_disconnect            _nxd_mqtt_client_disconnect
 #define nxd_mqtt_client_receive_notify_set    _nxd_mqtt_client_receive_notify_set
+#define nxd_mqtt_client_receive_queue_set     _nxd_mqtt_client_receive_queue_set
 #define nxd_mqtt_client_message_get           _nxd_mqtt_client_message_get
+#define nxd_mqtt_client_message_packet_get    _nxd_mqtt_client_message_packet_get
+#define nxd_mqtt_client_message_packet_release _nxd_mqtt_client_message_packet_release
 #define nxd_mqtt_client_disconnect_notify_set _nxd_mqtt_client_disconnect_notify_set
+#define nxd_mqtt_client_ack_notify_set        _nxd_mqtt_client_ack_notify_set
+#define nxd_mqtt_client_inflight_table_set    _nxd_mqtt_client_inflight_table_set
+#define nxd_mqtt_client_qos2_table_set        _nxd_mqtt_client_qos2_table_set
+#define nxd_mqtt_client_last_value_cache_set  _nxd_mqtt_client_last_value_cache_set
+#define nxd_mqtt_client_last_value_get        _nxd_mqtt_client_last_value_get
+#define nxd_mqtt_client_publish_ring_set      _nxd_mqtt_client_publish_ring_set
+#define nxd_mqtt_client_connect_cache_set     _nxd_mqtt_client_connect_cache_set
+#define nxd_mqtt_client_publish_enqueue       _nxd_mqtt_client_publish_enqueue
+#define nxd_mqtt_client_topic_trie_set        _nxd_mqtt_client_topic_trie_set
+#define nxd_mqtt_client_topic_callback_set    _nxd_mqtt_client_topic_callback_set
+#define nxd_mqtt_client_events_process        _nxd_mqtt_client_events_process
+#define nxd_mqtt_client_events_signal_set     _nxd_mqtt_client_events_signal_set
 #else /* if !NXD_MQTT_CLIENT_SOURCE_CODE */
 
 #define nxd_mqtt_client_create                _nxde_mqtt_client_create
@@ -405,12 +782,36 @@ typedef struct NXD_MQTT_CLIENT_STRUCT
 #define nxd_mqtt_client_connect               _nxde_mqtt_client_connect
 #define nxd_mqtt_client_secure_connect        _nxde_mqtt_client_secure_connect
 #define nxd_mqtt_client_publish               _nxde_mqtt_client_publish
+#define nxd_mqtt_client_lane_publish          _nxde_mqtt_client_lane_publish
+#define nxd_mqtt_client_publish_iov           _nxde_mqtt_client_publish_iov
+#define nxd_mqtt_client_topic_prepare         _nxde_mqtt_client_topic_prepare
+#define nxd_mqtt_client_prepared_publish      _nxde_mqtt_client_prepared_publish
+#define nxd_mqtt_client_lane_rate_set         _nxde_mqtt_client_lane_rate_set
+#define nxd_mqtt_client_latency_get           _nxde_mqtt_client_latency_get
+#define nxd_mqtt_client_publish_batch_begin   _nxde_mqtt_client_publish_batch_begin
+#define nxd_mqtt_client_publish_batch_flush   _nxde_mqtt_client_publish_batch_flush
 #define nxd_mqtt_client_subscribe             _nxde_mqtt_client_subscribe
+#define nxd_mqtt_client_subscribe_list        _nxde_mqtt_client_subscribe_list
 #define nxd_mqtt_client_unsubscribe           _nxde_mqtt_client_unsubscribe
 #define nxd_mqtt_client_disconnect            _nxde_mqtt_client_disconnect
 #define nxd_mqtt_client_receive_notify_set    _nxde_mqtt_client_receive_notify_set
+#define nxd_mqtt_client_receive_queue_set     _nxde_mqtt_client_receive_queue_set
 #define nxd_mqtt_client_message_get           _nxde_mqtt_client_message_get
+#define nxd_mqtt_client_message_packet_get    _nxde_mqtt_client_message_packet_get
+#define nxd_mqtt_client_message_packet_release _nxde_mqtt_client_message_packet_release
 #define nxd_mqtt_client_disconnect_notify_set _nxde_mqtt_client_disconnect_notify_set
+#define nxd_mqtt_client_ack_notify_set        _nxde_mqtt_client_ack_notify_set
+#define nxd_mqtt_client_inflight_table_set    _nxde_mqtt_client_inflight_table_set
+#define nxd_mqtt_client_qos2_table_set        _nxde_mqtt_client_qos2_table_set
+#define nxd_mqtt_client_last_value_cache_set  _nxde_mqtt_client_last_value_cache_set
+#define nxd_mqtt_client_last_value_get        _nxde_mqtt_client_last_value_get
+#define nxd_mqtt_client_publish_ring_set      _nxde_mqtt_client_publish_ring_set
+#define nxd_mqtt_client_connect_cache_set     _nxde_mqtt_client_connect_cache_set
+#define nxd_mqtt_client_publish_enqueue       _nxde_mqtt_client_publish_enqueue
+#define nxd_mqtt_client_topic_trie_set        _nxde_mqtt_client_topic_trie_set
+#define nxd_mqtt_client_topic_callback_set    _nxde_mqtt_client_topic_callback_set
+#define nxd_mqtt_client_events_process        _nxde_mqtt_client_events_process
+#define nxd_mqtt_client_events_signal_set     _nxde_mqtt_client_events_signal_set
 #endif /* NX_DISABLE_ERROR_CHECKING */
 
 
@@ -434,16 +835,59 @@ UINT nxd_mqtt_client_secure_connect(NXD_MQTT_CLIENT *client_ptr, NXD_ADDRESS *se
 #endif /* NX_SECURE_ENABLE */
 UINT nxd_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, CHAR *message, UINT message_length,
                              UINT retain, UINT QoS, ULONG timeout);
+UINT nxd_mqtt_client_lane_publish(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                  CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG timeout);
+UINT nxd_mqtt_client_publish_iov(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                 NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG timeout);
+UINT nxd_mqtt_client_topic_prepare(NXD_MQTT_PREPARED_TOPIC *topic_ptr, CHAR *topic_name, UINT topic_name_length,
+                                   UINT retain, UINT QoS);
+UINT nxd_mqtt_client_prepared_publish(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_PREPARED_TOPIC *topic_ptr,
+                                      CHAR *message, UINT message_length, ULONG timeout);
+UINT nxd_mqtt_client_lane_rate_set(NXD_MQTT_CLIENT *client_ptr, UINT lane, UINT rate, UINT burst);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+UINT nxd_mqtt_client_latency_get(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_LATENCY *latency_ptr, UINT reset);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+UINT nxd_mqtt_client_publish_batch_begin(NXD_MQTT_CLIENT *client_ptr);
+UINT nxd_mqtt_client_publish_batch_flush(NXD_MQTT_CLIENT *client_ptr, ULONG timeout);
 UINT nxd_mqtt_client_subscribe(NXD_MQTT_CLIENT *mqtt_client_pr, CHAR *topic_name, UINT topic_name_length, UINT QoS);
+UINT nxd_mqtt_client_subscribe_list(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count);
 UINT nxd_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *mqtt_client_pr, CHAR *topic_name, UINT topic_name_length);
 UINT nxd_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
                                         VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT number_of_messages));
+UINT nxd_mqtt_client_receive_queue_set(NXD_MQTT_CLIENT *client_ptr, UINT max_messages, ULONG max_bytes, UINT policy);
 UINT nxd_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
                                  UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT nxd_mqtt_client_message_packet_get(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr,
+                                        ULONG *topic_offset, UINT *topic_length,
+                                        ULONG *message_offset, ULONG *message_length);
+UINT nxd_mqtt_client_message_packet_release(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
 UINT nxd_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr);
 
 UINT nxd_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr);
 UINT nxd_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *));
+UINT nxd_mqtt_client_ack_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                    VOID (*ack_notify)(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                                       NX_PACKET *transmit_packet_ptr, VOID *context),
+                                    VOID *context);
+UINT nxd_mqtt_client_inflight_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT nxd_mqtt_client_qos2_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT nxd_mqtt_client_last_value_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG entry_size);
+UINT nxd_mqtt_client_last_value_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                    UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT nxd_mqtt_client_publish_ring_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG slot_size);
+UINT nxd_mqtt_client_connect_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT nxd_mqtt_client_publish_enqueue(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                     CHAR *message, UINT message_length, UINT retain, UINT QoS);
+UINT nxd_mqtt_client_topic_trie_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT nxd_mqtt_client_topic_callback_set(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_filter, UINT topic_filter_length,
+                                        VOID (*callback)(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                         ULONG topic_offset, UINT topic_length,
+                                                         ULONG message_offset, ULONG message_length, VOID *context),
+                                        VOID *context);
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+UINT nxd_mqtt_client_events_process(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+UINT nxd_mqtt_client_events_signal_set(NXD_MQTT_CLIENT *client_ptr, TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flag);
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
 
 #else /* ifdef NXD_MQTT_CLIENT_SOURCE_CODE */
 
@@ -457,20 +901,63 @@ UINT _nxd_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name,
 UINT _nxd_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr);
 UINT _nxd_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr);
 UINT _nxd_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *));
+UINT _nxd_mqtt_client_ack_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                     VOID (*ack_notify)(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                                        NX_PACKET *transmit_packet_ptr, VOID *context),
+                                     VOID *context);
+UINT _nxd_mqtt_client_inflight_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxd_mqtt_client_qos2_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxd_mqtt_client_last_value_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG entry_size);
+UINT _nxd_mqtt_client_last_value_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                     UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT _nxd_mqtt_client_publish_ring_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG slot_size);
+UINT _nxd_mqtt_client_connect_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxd_mqtt_client_publish_enqueue(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      CHAR *message, UINT message_length, UINT retain, UINT QoS);
+UINT _nxd_mqtt_client_topic_trie_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxd_mqtt_client_topic_callback_set(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_filter, UINT topic_filter_length,
+                                         VOID (*callback)(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                          ULONG topic_offset, UINT topic_length,
+                                                          ULONG message_offset, ULONG message_length, VOID *context),
+                                         VOID *context);
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+UINT _nxd_mqtt_client_events_process(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+UINT _nxd_mqtt_client_events_signal_set(NXD_MQTT_CLIENT *client_ptr, TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flag);
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
 UINT _nxd_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
                                 CHAR *username, UINT username_length, CHAR *password, UINT password_length);
 UINT _nxd_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
                                   UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT _nxd_mqtt_client_message_packet_get(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr,
+                                         ULONG *topic_offset, UINT *topic_length,
+                                         ULONG *message_offset, ULONG *message_length);
+UINT _nxd_mqtt_client_message_packet_release(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
 UINT _nxd_mqtt_client_publish_packet_send(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
                                           USHORT packet_id, UINT QoS, ULONG wait_option);
 UINT _nxd_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
                               CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxd_mqtt_client_lane_publish(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                   CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxd_mqtt_client_publish_iov(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                  NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxd_mqtt_client_topic_prepare(NXD_MQTT_PREPARED_TOPIC *topic_ptr, CHAR *topic_name, UINT topic_name_length,
+                                    UINT retain, UINT QoS);
+UINT _nxd_mqtt_client_prepared_publish(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_PREPARED_TOPIC *topic_ptr,
+                                       CHAR *message, UINT message_length, ULONG timeout);
+UINT _nxd_mqtt_client_lane_rate_set(NXD_MQTT_CLIENT *client_ptr, UINT lane, UINT rate, UINT burst);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+UINT _nxd_mqtt_client_latency_get(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_LATENCY *latency_ptr, UINT reset);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+UINT _nxd_mqtt_client_publish_batch_begin(NXD_MQTT_CLIENT *client_ptr);
+UINT _nxd_mqtt_client_publish_batch_flush(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
 UINT _nxd_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
                                          VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count));
+UINT _nxd_mqtt_client_receive_queue_set(NXD_MQTT_CLIENT *client_ptr, UINT max_messages, ULONG max_bytes, UINT policy);
 UINT _nxd_mqtt_client_release_callback_set(NXD_MQTT_CLIENT *client_ptr, VOID (*memory_release_function)(CHAR *, UINT));
 UINT _nxd_mqtt_client_sub_unsub(NXD_MQTT_CLIENT *client_ptr, UINT op,
                                 CHAR *topic_name, UINT topic_name_length, USHORT *packet_id_ptr, UINT QoS);
 UINT _nxd_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS);
+UINT _nxd_mqtt_client_subscribe_list(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count);
 UINT _nxd_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length);
 UINT _nxd_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
                                        const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
@@ -490,17 +977,60 @@ UINT _nxde_mqtt_client_create(NXD_MQTT_CLIENT *client_ptr, CHAR *client_name, CH
                               VOID *memory_ptr, ULONG memory_size);
 UINT _nxde_mqtt_client_delete(NXD_MQTT_CLIENT *client_ptr);
 UINT _nxde_mqtt_client_disconnect_notify_set(NXD_MQTT_CLIENT *client_ptr, VOID (*disconnect_notify)(NXD_MQTT_CLIENT *));
+UINT _nxde_mqtt_client_ack_notify_set(NXD_MQTT_CLIENT *client_ptr,
+                                      VOID (*ack_notify)(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                                         NX_PACKET *transmit_packet_ptr, VOID *context),
+                                      VOID *context);
+UINT _nxde_mqtt_client_inflight_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxde_mqtt_client_qos2_table_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxde_mqtt_client_last_value_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG entry_size);
+UINT _nxde_mqtt_client_last_value_get(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                      UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT _nxde_mqtt_client_publish_ring_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size, ULONG slot_size);
+UINT _nxde_mqtt_client_connect_cache_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxde_mqtt_client_publish_enqueue(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                       CHAR *message, UINT message_length, UINT retain, UINT QoS);
+UINT _nxde_mqtt_client_topic_trie_set(NXD_MQTT_CLIENT *client_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _nxde_mqtt_client_topic_callback_set(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_filter, UINT topic_filter_length,
+                                          VOID (*callback)(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                                           ULONG topic_offset, UINT topic_length,
+                                                           ULONG message_offset, ULONG message_length, VOID *context),
+                                          VOID *context);
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+UINT _nxde_mqtt_client_events_process(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
+UINT _nxde_mqtt_client_events_signal_set(NXD_MQTT_CLIENT *client_ptr, TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flag);
+#endif /* NXD_MQTT_APPLICATION_EVENT_LOOP */
 UINT _nxde_mqtt_client_disconnect(NXD_MQTT_CLIENT *client_ptr);
 UINT _nxde_mqtt_client_login_set(NXD_MQTT_CLIENT *client_ptr,
                                  CHAR *username, UINT username_length, CHAR *password, UINT password_length);
 UINT _nxde_mqtt_client_message_get(NXD_MQTT_CLIENT *client_ptr, UCHAR *topic_buffer, UINT topic_buffer_size, UINT *actual_topic_length,
                                    UCHAR *message_buffer, UINT message_buffer_size, UINT *actual_message_length);
+UINT _nxde_mqtt_client_message_packet_get(NXD_MQTT_CLIENT *client_ptr, NX_PACKET **packet_ptr,
+                                          ULONG *topic_offset, UINT *topic_length,
+                                          ULONG *message_offset, ULONG *message_length);
+UINT _nxde_mqtt_client_message_packet_release(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr);
 UINT _nxde_mqtt_client_publish(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
                                CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxde_mqtt_client_lane_publish(NXD_MQTT_CLIENT *client_ptr, UINT lane, CHAR *topic_name, UINT topic_name_length,
+                                    CHAR *message, UINT message_length, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxde_mqtt_client_publish_iov(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length,
+                                   NXD_MQTT_IOV *iov, UINT iov_count, UINT retain, UINT QoS, ULONG timeout);
+UINT _nxde_mqtt_client_topic_prepare(NXD_MQTT_PREPARED_TOPIC *topic_ptr, CHAR *topic_name, UINT topic_name_length,
+                                     UINT retain, UINT QoS);
+UINT _nxde_mqtt_client_prepared_publish(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_PREPARED_TOPIC *topic_ptr,
+                                        CHAR *message, UINT message_length, ULONG timeout);
+UINT _nxde_mqtt_client_lane_rate_set(NXD_MQTT_CLIENT *client_ptr, UINT lane, UINT rate, UINT burst);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+UINT _nxde_mqtt_client_latency_get(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_LATENCY *latency_ptr, UINT reset);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+UINT _nxde_mqtt_client_publish_batch_begin(NXD_MQTT_CLIENT *client_ptr);
+UINT _nxde_mqtt_client_publish_batch_flush(NXD_MQTT_CLIENT *client_ptr, ULONG wait_option);
 UINT _nxde_mqtt_client_receive_notify_set(NXD_MQTT_CLIENT *client_ptr,
                                           VOID (*receive_notify)(NXD_MQTT_CLIENT *client_ptr, UINT message_count));
+UINT _nxde_mqtt_client_receive_queue_set(NXD_MQTT_CLIENT *client_ptr, UINT max_messages, ULONG max_bytes, UINT policy);
 UINT _nxde_mqtt_client_release_callback_set(NXD_MQTT_CLIENT *client_ptr, VOID (*release_callback)(CHAR *, UINT));
 UINT _nxde_mqtt_client_subscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length, UINT QoS);
+UINT _nxde_mqtt_client_subscribe_list(NXD_MQTT_CLIENT *client_ptr, NXD_MQTT_TOPIC_FILTER *filter_list, UINT filter_count);
 UINT _nxde_mqtt_client_unsubscribe(NXD_MQTT_CLIENT *client_ptr, CHAR *topic_name, UINT topic_name_length);
 UINT _nxde_mqtt_client_will_message_set(NXD_MQTT_CLIENT *client_ptr,
                                         const UCHAR *will_topic, UINT will_topic_length, const UCHAR *will_message,
@@ -0,0 +1,1706 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "nx_crypto_hmac.h"
+#include "nx_stm32_crypto_driver.h"
+
+/****** DRIVER SPECIFIC ****** Start of part/vendor specific include area.  Include driver-specific include file here!  */
+
+#include "nx_stm32_crypto_config.h"
+
+#if !defined(CRYP) || !defined(HASH)
+#error "The CRYP and HASH peripherals are only in the STM32F415/417/437/439/479 parts"
+#endif
+
+/****** DRIVER SPECIFIC ****** End of part/vendor specific include file area!  */
+
+
+/* Define the longest DMA transfer in words, NDTR being 16 bits and the blocks of the
+   CRYP 4 words.  */
+
+#define NX_CRYPTO_STM32_DMA_MAX_WORDS       0xFFFC
+
+/* Define the buffers the DMA reaches: word aligned and out of the CCM RAM, at
+   0x10000000, only the CPU reaches.  */
+
+#define NX_CRYPTO_STM32_DMA_CAPABLE(ptr)    (((((ULONG)(ptr)) & 0x3) == 0) && \
+                                             ((((ULONG)(ptr)) & 0xFFFF0000) != 0x10000000))
+
+/* Define the words of the key, IV and digest registers, big endian in memory.  */
+
+#define NX_CRYPTO_STM32_LOAD_WORD(ptr)      __REV(__UNALIGNED_UINT32_READ(ptr))
+#define NX_CRYPTO_STM32_STORE_WORD(ptr, val) __UNALIGNED_UINT32_WRITE((ptr), __REV(val))
+
+
+/* Define the state of the driver, the peripherals shared by the threads under a mutex each.  */
+
+static UINT          nx_crypto_stm32_ready;
+static TX_MUTEX      nx_crypto_stm32_cryp_mutex;
+static TX_MUTEX      nx_crypto_stm32_hash_mutex;
+static TX_SEMAPHORE  nx_crypto_stm32_cryp_done;
+static TX_SEMAPHORE  nx_crypto_stm32_hash_done;
+static volatile UINT nx_crypto_stm32_cryp_dma_error;
+static volatile UINT nx_crypto_stm32_hash_dma_error;
+
+extern NX_CRYPTO_METHOD crypto_method_sha1_stm32;
+extern NX_CRYPTO_METHOD crypto_method_sha256_stm32;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_crypto_initialize                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function enables the CRYP and HASH peripherals and the DMA     */
+/*    streams that feed them, and creates the mutexes that share them     */
+/*    between the threads. On a part without the peripherals, whose clock */
+/*    enable bits read back as zero, it returns with the driver off, and  */
+/*    the methods of the driver run in software. It is called once from a */
+/*    thread, before the first TLS session.                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_create                       Create the peripheral mutexes */
+/*    tx_semaphore_create                   Create the DMA semaphores     */
+/*    HAL_NVIC_SetPriority                  Set the DMA interrupt priority*/
+/*    HAL_NVIC_EnableIRQ                    Enable the DMA interrupts     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT nx_stm32_crypto_initialize(VOID)
+{
+
+    if (nx_crypto_stm32_ready)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    /* Enable the clocks, the bits of the missing peripherals read back as zero.  */
+    RCC -> AHB2ENR |= RCC_AHB2ENR_CRYPEN | RCC_AHB2ENR_HASHEN;
+    if ((RCC -> AHB2ENR & (RCC_AHB2ENR_CRYPEN | RCC_AHB2ENR_HASHEN)) != (RCC_AHB2ENR_CRYPEN | RCC_AHB2ENR_HASHEN))
+    {
+        return(NX_CRYPTO_NOT_SUCCESSFUL);
+    }
+    RCC -> AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+    (VOID)RCC -> AHB1ENR;
+
+    tx_mutex_create(&nx_crypto_stm32_cryp_mutex, "CRYP", TX_INHERIT);
+    tx_mutex_create(&nx_crypto_stm32_hash_mutex, "HASH", TX_INHERIT);
+    tx_semaphore_create(&nx_crypto_stm32_cryp_done, "CRYP DMA", 0);
+    tx_semaphore_create(&nx_crypto_stm32_hash_done, "HASH DMA", 0);
+
+    HAL_NVIC_SetPriority(NX_CRYPTO_STM32_CRYP_OUT_IRQn, NX_CRYPTO_STM32_DMA_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(NX_CRYPTO_STM32_CRYP_OUT_IRQn);
+    HAL_NVIC_SetPriority(NX_CRYPTO_STM32_HASH_IN_IRQn, NX_CRYPTO_STM32_DMA_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(NX_CRYPTO_STM32_HASH_IN_IRQn);
+
+    nx_crypto_stm32_ready = NX_CRYPTO_TRUE;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function takes the mutex of a peripheral for the calling       */
+/*    thread. The peripheral is not available before the driver is        */
+/*    initialized, from an interrupt or outside a thread, and to a caller */
+/*    not allowed to suspend, the timer thread included: the caller runs  */
+/*    the operation in software instead.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    mutex_ptr                             Pointer to peripheral mutex   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                NX_CRYPTO_TRUE if locked      */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    __get_IPSR                            Get the active exception      */
+/*    tx_thread_identify                    Get the calling thread        */
+/*    tx_mutex_get                          Take the mutex                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Driver functions                                                    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_stm32_lock(TX_MUTEX *mutex_ptr)
+{
+
+    if ((!nx_crypto_stm32_ready) || (__get_IPSR() != 0) || (tx_thread_identify() == TX_NULL))
+    {
+        return(NX_CRYPTO_FALSE);
+    }
+
+    return(tx_mutex_get(mutex_ptr, TX_WAIT_FOREVER) == TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_dma_start                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts a transfer of words between memory and a data  */
+/*    register of the CRYP or HASH peripheral on a DMA2 stream, once the  */
+/*    stream is stopped and its flags cleared.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    stream                                DMA2 stream                   */
+/*    flags                                 Clear mask of the stream flags*/
+/*    direction                             DMA_SxCR_DIR_0 to the         */
+/*                                            peripheral, 0 from it       */
+/*    peripheral                            Data register                 */
+/*    memory                                Memory buffer                 */
+/*    words                                 Number of words               */
+/*    interrupts                            Interrupts of the stream      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_cryp_dma            Process blocks with the DMA    */
+/*    _nx_crypto_stm32_hash_dma            Hash words with the DMA        */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_crypto_stm32_dma_start(DMA_Stream_TypeDef *stream, ULONG flags, ULONG direction,
+                                       volatile uint32_t *peripheral, UCHAR *memory, UINT words, ULONG interrupts)
+{
+
+    stream -> CR = 0;
+    while (stream -> CR & DMA_SxCR_EN)
+    {
+    }
+    DMA2 -> HIFCR = flags;
+
+    stream -> PAR = (ULONG)peripheral;
+    stream -> M0AR = (ULONG)memory;
+    stream -> NDTR = words;
+    stream -> FCR = 0;
+    stream -> CR = NX_CRYPTO_STM32_DMA_CHANNEL | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 |
+                   DMA_SxCR_MINC | direction | interrupts;
+    stream -> CR |= DMA_SxCR_EN;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_cryp_dma                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the blocks through the enabled CRYP peripheral  */
+/*    with two DMA streams, the input to the peripheral and the output    */
+/*    back, and waits for the end of the output transfer, in transfers of */
+/*    at most NX_CRYPTO_STM32_DMA_MAX_WORDS. The output buffer may point  */
+/*    to the input buffer, the output of a block being written after its  */
+/*    input is read.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    words                                 Number of words               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_dma_start            Start a DMA transfer          */
+/*    tx_semaphore_get                      Wait for the end of transfer  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_cryp_process       Process blocks in the CRYP      */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_stm32_cryp_dma(UCHAR *input, UCHAR *output, UINT words)
+{
+UINT chunk;
+UINT status = NX_CRYPTO_SUCCESS;
+
+    while ((words > 0) && (status == NX_CRYPTO_SUCCESS))
+    {
+        chunk = (words > NX_CRYPTO_STM32_DMA_MAX_WORDS) ? NX_CRYPTO_STM32_DMA_MAX_WORDS : words;
+
+        nx_crypto_stm32_cryp_dma_error = NX_CRYPTO_FALSE;
+
+        /* The output stream first, ready for the first block out.  */
+        _nx_crypto_stm32_dma_start(NX_CRYPTO_STM32_CRYP_OUT_STREAM, NX_CRYPTO_STM32_CRYP_OUT_FLAGS, 0,
+                                   &CRYP -> DOUT, output, chunk, DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+        _nx_crypto_stm32_dma_start(NX_CRYPTO_STM32_CRYP_IN_STREAM, NX_CRYPTO_STM32_CRYP_IN_FLAGS, DMA_SxCR_DIR_0,
+                                   &CRYP -> DIN, input, chunk, 0);
+        CRYP -> DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
+
+        if ((tx_semaphore_get(&nx_crypto_stm32_cryp_done, NX_CRYPTO_STM32_DMA_TIMEOUT) != TX_SUCCESS) ||
+            (nx_crypto_stm32_cryp_dma_error))
+        {
+            status = NX_CRYPTO_NOT_SUCCESSFUL;
+        }
+
+        CRYP -> DMACR = 0;
+        NX_CRYPTO_STM32_CRYP_IN_STREAM -> CR = 0;
+        NX_CRYPTO_STM32_CRYP_OUT_STREAM -> CR = 0;
+
+        input += chunk << 2;
+        output += chunk << 2;
+        words -= chunk;
+    }
+
+    /* Take back the end of a transfer that came after the timeout, so that it does not end the next one.  */
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+        tx_semaphore_get(&nx_crypto_stm32_cryp_done, TX_NO_WAIT);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_cryp_process                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes blocks in the CRYP peripheral, with the key */
+/*    of the AES context and the mode of the caller, held by the CRYP     */
+/*    mutex. Decryption first prepares the decryption key from the key of */
+/*    the context. The IV registers are loaded from the IV or counter     */
+/*    block, if any. Long buffers the DMA reaches go through the DMA, the */
+/*    others through the CPU. The peripheral is disabled on return, so    */
+/*    that no state is left to the next caller.                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    mode                                  Algorithm and direction bits  */
+/*    iv                                    IV or counter block, or NULL  */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_cryp_dma             Process blocks with the DMA   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_encrypt         Encrypt blocks in ECB mode     */
+/*    _nx_crypto_stm32_aes_decrypt         Decrypt blocks in ECB mode     */
+/*    _nx_crypto_stm32_aes_cbc_encrypt_blocks                             */
+/*                                          Encrypt blocks in CBC mode    */
+/*    _nx_crypto_stm32_aes_cbc_decrypt_blocks                             */
+/*                                          Decrypt blocks in CBC mode    */
+/*    _nx_crypto_stm32_aes_ctr_encrypt_blocks                             */
+/*                                          Encrypt blocks in CTR mode    */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_stm32_cryp_process(NX_CRYPTO_AES *aes_ptr, ULONG mode, UCHAR *iv,
+                                          UCHAR *input, UCHAR *output, UINT blocks)
+{
+UCHAR             *key;
+volatile uint32_t *key_register;
+ULONG              key_size;
+UINT               key_words;
+UINT               i;
+UINT               j;
+UINT               status = NX_CRYPTO_SUCCESS;
+
+    /* The key expansion keeps the key in the first words of the schedule.  */
+    key = (UCHAR *)aes_ptr -> nx_crypto_aes_key_schedule;
+    key_words = aes_ptr -> nx_crypto_aes_key_size;
+    switch (key_words)
+    {
+    case NX_CRYPTO_AES_KEY_SIZE_128_BITS:
+        key_size = 0;
+        break;
+    case NX_CRYPTO_AES_KEY_SIZE_192_BITS:
+        key_size = CRYP_CR_KEYSIZE_0;
+        break;
+    case NX_CRYPTO_AES_KEY_SIZE_256_BITS:
+        key_size = CRYP_CR_KEYSIZE_1;
+        break;
+    default:
+        return(NX_CRYPTO_INVALID_PARAMETER);
+    }
+
+    /* The key registers end at K3RR, a shorter key in the last ones.  */
+    CRYP -> CR = 0;
+    key_register = &CRYP -> K0LR + (8 - key_words);
+    for (i = 0; i < key_words; i++)
+    {
+        key_register[i] = NX_CRYPTO_STM32_LOAD_WORD(&key[i << 2]);
+    }
+
+    if (mode & CRYP_CR_ALGODIR)
+    {
+
+        /* Prepare the decryption key, the last round key of the schedule.  */
+        CRYP -> CR = CRYP_CR_ALGOMODE_AES_KEY | CRYP_CR_ALGODIR | CRYP_CR_DATATYPE_1 | key_size;
+        CRYP -> CR |= CRYP_CR_CRYPEN;
+        while (CRYP -> SR & CRYP_SR_BUSY)
+        {
+        }
+        CRYP -> CR = 0;
+    }
+
+    CRYP -> CR = mode | CRYP_CR_DATATYPE_1 | key_size;
+
+    if (iv)
+    {
+        CRYP -> IV0LR = NX_CRYPTO_STM32_LOAD_WORD(&iv[0]);
+        CRYP -> IV0RR = NX_CRYPTO_STM32_LOAD_WORD(&iv[4]);
+        CRYP -> IV1LR = NX_CRYPTO_STM32_LOAD_WORD(&iv[8]);
+        CRYP -> IV1RR = NX_CRYPTO_STM32_LOAD_WORD(&iv[12]);
+    }
+
+    CRYP -> CR |= CRYP_CR_FFLUSH;
+    CRYP -> CR |= CRYP_CR_CRYPEN;
+
+    if (((blocks * NX_CRYPTO_AES_BLOCK_SIZE) >= NX_CRYPTO_STM32_DMA_THRESHOLD) &&
+        NX_CRYPTO_STM32_DMA_CAPABLE(input) && NX_CRYPTO_STM32_DMA_CAPABLE(output))
+    {
+        status = _nx_crypto_stm32_cryp_dma(input, output, blocks << 2);
+    }
+    else
+    {
+
+        /* The FIFOs hold two blocks, one in and out at a time.  */
+        for (i = 0; i < blocks; i++)
+        {
+            CRYP -> DIN = __UNALIGNED_UINT32_READ(&input[0]);
+            CRYP -> DIN = __UNALIGNED_UINT32_READ(&input[4]);
+            CRYP -> DIN = __UNALIGNED_UINT32_READ(&input[8]);
+            CRYP -> DIN = __UNALIGNED_UINT32_READ(&input[12]);
+
+            for (j = 0; j < NX_CRYPTO_AES_BLOCK_SIZE; j += 4)
+            {
+                while ((CRYP -> SR & CRYP_SR_OFNE) == 0)
+                {
+                }
+                __UNALIGNED_UINT32_WRITE(&output[j], CRYP -> DOUT);
+            }
+
+            input += NX_CRYPTO_AES_BLOCK_SIZE;
+            output += NX_CRYPTO_AES_BLOCK_SIZE;
+        }
+    }
+
+    CRYP -> CR = 0;
+
+#ifdef NX_SECURE_KEY_CLEAR
+    for (i = 0; i < 8; i++)
+    {
+        (&CRYP -> K0LR)[i] = 0;
+    }
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_encrypt                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts 16-byte blocks in ECB mode in the CRYP       */
+/*    peripheral, in place of _nx_crypto_aes_encrypt in the AES methods   */
+/*    of the driver, whose modes recognize it to encrypt their blocks in  */
+/*    one call. When the peripheral is not available or fails, the blocks */
+/*    are encrypted in software.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    length                                Length of the input in bytes  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the CRYP mutex           */
+/*    _nx_crypto_stm32_cryp_process         Process blocks in the CRYP    */
+/*    tx_mutex_put                          Release the CRYP mutex        */
+/*    _nx_crypto_aes_encrypt                Encrypt a block in software   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_aes_cbc_operation                           */
+/*    _nx_crypto_method_stm32_aes_gcm_operation                           */
+/*    _nx_crypto_method_stm32_aes_ctr_operation                           */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_stm32_aes_encrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length)
+{
+UINT status = NX_CRYPTO_NOT_SUCCESSFUL;
+UINT i;
+
+    if (_nx_crypto_stm32_lock(&nx_crypto_stm32_cryp_mutex))
+    {
+        status = _nx_crypto_stm32_cryp_process(aes_ptr, CRYP_CR_ALGOMODE_AES_ECB, NX_CRYPTO_NULL,
+                                               input, output, length / NX_CRYPTO_AES_BLOCK_SIZE);
+        tx_mutex_put(&nx_crypto_stm32_cryp_mutex);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    for (i = 0; i < length; i += NX_CRYPTO_AES_BLOCK_SIZE)
+    {
+        status = _nx_crypto_aes_encrypt(aes_ptr, &input[i], &output[i], NX_CRYPTO_AES_BLOCK_SIZE);
+        if (status)
+        {
+            break;
+        }
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_decrypt                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function decrypts 16-byte blocks in ECB mode in the CRYP       */
+/*    peripheral, in place of _nx_crypto_aes_decrypt in the AES methods   */
+/*    of the driver, whose modes recognize it to decrypt their blocks in  */
+/*    one call. When the peripheral is not available or fails, the blocks */
+/*    are decrypted in software.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    length                                Length of the input in bytes  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the CRYP mutex           */
+/*    _nx_crypto_stm32_cryp_process         Process blocks in the CRYP    */
+/*    tx_mutex_put                          Release the CRYP mutex        */
+/*    _nx_crypto_aes_decrypt                Decrypt a block in software   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_aes_cbc_operation                           */
+/*    _nx_crypto_method_stm32_aes_gcm_operation                           */
+/*    _nx_crypto_method_stm32_aes_ctr_operation                           */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_stm32_aes_decrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length)
+{
+UINT status = NX_CRYPTO_NOT_SUCCESSFUL;
+UINT i;
+
+    if (_nx_crypto_stm32_lock(&nx_crypto_stm32_cryp_mutex))
+    {
+        status = _nx_crypto_stm32_cryp_process(aes_ptr, CRYP_CR_ALGOMODE_AES_ECB | CRYP_CR_ALGODIR, NX_CRYPTO_NULL,
+                                               input, output, length / NX_CRYPTO_AES_BLOCK_SIZE);
+        tx_mutex_put(&nx_crypto_stm32_cryp_mutex);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    for (i = 0; i < length; i += NX_CRYPTO_AES_BLOCK_SIZE)
+    {
+        status = _nx_crypto_aes_decrypt(aes_ptr, &input[i], &output[i], NX_CRYPTO_AES_BLOCK_SIZE);
+        if (status)
+        {
+            break;
+        }
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_cbc_encrypt_blocks             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts 16-byte blocks in CBC mode in the CRYP       */
+/*    peripheral, the bulk path of CBC encryption with the AES methods of */
+/*    the driver. The IV is updated to the last output block for the next */
+/*    call. When the peripheral is not available or fails, the blocks are */
+/*    chained and encrypted in software.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    iv                                    Pointer to the IV, the last   */
+/*                                            output block on return      */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the CRYP mutex           */
+/*    _nx_crypto_stm32_cryp_process         Process blocks in the CRYP    */
+/*    tx_mutex_put                          Release the CRYP mutex        */
+/*    _nx_crypto_aes_encrypt                Encrypt a block in software   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_cbc_encrypt               Perform CBC mode encryption    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_stm32_aes_cbc_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                             UCHAR *input, UCHAR *output, UINT blocks)
+{
+UCHAR *chain;
+UINT   status = NX_CRYPTO_NOT_SUCCESSFUL;
+UINT   i;
+UINT   j;
+
+    if (blocks == 0)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    if (_nx_crypto_stm32_lock(&nx_crypto_stm32_cryp_mutex))
+    {
+        status = _nx_crypto_stm32_cryp_process(aes_ptr, CRYP_CR_ALGOMODE_AES_CBC, iv, input, output, blocks);
+        tx_mutex_put(&nx_crypto_stm32_cryp_mutex);
+    }
+
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+        chain = iv;
+        for (i = 0; i < blocks; i++)
+        {
+            for (j = 0; j < NX_CRYPTO_AES_BLOCK_SIZE; j++)
+            {
+                output[j] = (UCHAR)(input[j] ^ chain[j]);
+            }
+
+            status = _nx_crypto_aes_encrypt(aes_ptr, output, output, NX_CRYPTO_AES_BLOCK_SIZE);
+            if (status)
+            {
+                return(status);
+            }
+
+            chain = output;
+            input += NX_CRYPTO_AES_BLOCK_SIZE;
+            output += NX_CRYPTO_AES_BLOCK_SIZE;
+        }
+    }
+    else
+    {
+        output += blocks * NX_CRYPTO_AES_BLOCK_SIZE;
+    }
+
+    /* Chain the next call to the last output block.  */
+    NX_CRYPTO_MEMCPY(iv, output - NX_CRYPTO_AES_BLOCK_SIZE, NX_CRYPTO_AES_BLOCK_SIZE); /* Use case of memcpy is verified. */
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_cbc_decrypt_blocks             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function decrypts 16-byte blocks in CBC mode in the CRYP       */
+/*    peripheral, the bulk path of CBC decryption with the AES methods of */
+/*    the driver. The IV is updated to the last input block for the next  */
+/*    call, kept before the output may overwrite it. When the peripheral  */
+/*    is not available or fails, the blocks are decrypted in software.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    iv                                    Pointer to the previous       */
+/*                                            ciphertext block, the last  */
+/*                                            block on return             */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the CRYP mutex           */
+/*    _nx_crypto_stm32_cryp_process         Process blocks in the CRYP    */
+/*    tx_mutex_put                          Release the CRYP mutex        */
+/*    _nx_crypto_aes_cbc_decrypt_blocks     Decrypt blocks in software    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_cbc_decrypt               Perform CBC mode decryption    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_stm32_aes_cbc_decrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                             UCHAR *input, UCHAR *output, UINT blocks)
+{
+UCHAR last_cipher[NX_CRYPTO_AES_BLOCK_SIZE];
+UINT  status;
+
+    if (blocks == 0)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    if (!_nx_crypto_stm32_lock(&nx_crypto_stm32_cryp_mutex))
+    {
+        return(_nx_crypto_aes_cbc_decrypt_blocks(aes_ptr, iv, input, output, blocks));
+    }
+
+    /* The last ciphertext block chains to the next call, keep it before the output overwrites it.  */
+    NX_CRYPTO_MEMCPY(last_cipher, &input[(blocks - 1) * NX_CRYPTO_AES_BLOCK_SIZE], NX_CRYPTO_AES_BLOCK_SIZE); /* Use case of memcpy is verified. */
+
+    status = _nx_crypto_stm32_cryp_process(aes_ptr, CRYP_CR_ALGOMODE_AES_CBC | CRYP_CR_ALGODIR, iv,
+                                           input, output, blocks);
+    tx_mutex_put(&nx_crypto_stm32_cryp_mutex);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        NX_CRYPTO_MEMCPY(iv, last_cipher, NX_CRYPTO_AES_BLOCK_SIZE); /* Use case of memcpy is verified. */
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_aes_ctr_encrypt_blocks             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts 16-byte blocks in counter mode in the CRYP   */
+/*    peripheral, the bulk path of CTR and GCM with the AES methods of    */
+/*    the driver. The peripheral increments the last 32 bits of the       */
+/*    counter block, as the software does, and the counter block is       */
+/*    updated to the next counter for the next call. When the peripheral  */
+/*    is not available or fails, the blocks are encrypted in software.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    counter_block                         Pointer to the counter block, */
+/*                                            the next counter on return  */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the CRYP mutex           */
+/*    _nx_crypto_stm32_cryp_process         Process blocks in the CRYP    */
+/*    tx_mutex_put                          Release the CRYP mutex        */
+/*    _nx_crypto_aes_ctr_encrypt_blocks     Encrypt blocks in software    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_gctr                  Perform GCTR operation         */
+/*    _nx_crypto_ctr_encrypt               Perform CTR mode encryption    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_stm32_aes_ctr_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *counter_block,
+                                             UCHAR *input, UCHAR *output, UINT blocks)
+{
+ULONG count;
+UINT  status = NX_CRYPTO_NOT_SUCCESSFUL;
+
+    if (blocks == 0)
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    if (_nx_crypto_stm32_lock(&nx_crypto_stm32_cryp_mutex))
+    {
+        status = _nx_crypto_stm32_cryp_process(aes_ptr, CRYP_CR_ALGOMODE_AES_CTR, counter_block,
+                                               input, output, blocks);
+        tx_mutex_put(&nx_crypto_stm32_cryp_mutex);
+    }
+
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+        return(_nx_crypto_aes_ctr_encrypt_blocks(aes_ptr, counter_block, input, output, blocks));
+    }
+
+    count = NX_CRYPTO_STM32_LOAD_WORD(&counter_block[12]) + blocks;
+    NX_CRYPTO_STM32_STORE_WORD(&counter_block[12], count);
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_algorithm                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the ALGO bits of the HASH peripheral and the  */
+/*    digest length of a hash algorithm of the driver.                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    algorithm                             Hash algorithm                */
+/*    digest_length                         Digest length in bytes        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    algo                                  ALGO bits of HASH_CR          */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_operation                               */
+/*                                                                        */
+/**************************************************************************/
+static ULONG _nx_crypto_stm32_hash_algorithm(UINT algorithm, UINT *digest_length)
+{
+
+    switch (algorithm)
+    {
+    case NX_CRYPTO_HASH_SHA1:
+        *digest_length = NX_CRYPTO_SHA1_ICV_LEN_IN_BITS >> 3;
+        return(0);
+    case NX_CRYPTO_HASH_SHA224:
+        *digest_length = NX_CRYPTO_SHA224_ICV_LEN_IN_BITS >> 3;
+        return(HASH_CR_ALGO_1);
+    default:
+        *digest_length = NX_CRYPTO_SHA256_ICV_LEN_IN_BITS >> 3;
+        return(HASH_CR_ALGO);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_restore                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function puts a hash context in the HASH peripheral, held by   */
+/*    the HASH mutex: a new message starts the peripheral with the        */
+/*    algorithm, a message already started has its saved registers        */
+/*    written back.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    context                               Pointer to hash context       */
+/*    algo                                  ALGO bits of HASH_CR          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_update         Hash bytes in the HASH         */
+/*    _nx_crypto_stm32_hash_calculate      Calculate the digest           */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_crypto_stm32_hash_restore(NX_CRYPTO_STM32_HASH *context, ULONG algo)
+{
+UINT i;
+
+    if (context -> nx_crypto_stm32_hash_engine == NX_CRYPTO_STM32_HASH_STARTED)
+    {
+        HASH -> STR = 0;
+        HASH -> CR = algo | HASH_CR_DATATYPE_1 | HASH_CR_INIT;
+        return;
+    }
+
+    HASH -> IMR = context -> nx_crypto_stm32_hash_imr;
+    HASH -> STR = context -> nx_crypto_stm32_hash_str;
+    HASH -> CR = context -> nx_crypto_stm32_hash_cr;
+    HASH -> CR |= HASH_CR_INIT;
+    for (i = 0; i < NX_CRYPTO_STM32_HASH_CSR_COUNT; i++)
+    {
+        HASH -> CSR[i] = context -> nx_crypto_stm32_hash_csr[i];
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_save                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function saves the registers of the HASH peripheral in a hash  */
+/*    context, once the peripheral is done with the words written, so     */
+/*    that the next caller may use the peripheral.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    context                               Pointer to hash context       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_update         Hash bytes in the HASH         */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_crypto_stm32_hash_save(NX_CRYPTO_STM32_HASH *context)
+{
+UINT i;
+
+    while (HASH -> SR & HASH_SR_BUSY)
+    {
+    }
+
+    context -> nx_crypto_stm32_hash_imr = HASH -> IMR;
+    context -> nx_crypto_stm32_hash_str = HASH -> STR;
+    context -> nx_crypto_stm32_hash_cr = HASH -> CR;
+    for (i = 0; i < NX_CRYPTO_STM32_HASH_CSR_COUNT; i++)
+    {
+        context -> nx_crypto_stm32_hash_csr[i] = HASH -> CSR[i];
+    }
+
+    context -> nx_crypto_stm32_hash_engine = NX_CRYPTO_STM32_HASH_SAVED;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_dma                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes words to the HASH peripheral with a DMA stream */
+/*    and waits for the end of the transfer, in transfers of at most      */
+/*    NX_CRYPTO_STM32_DMA_MAX_WORDS. MDMAT keeps the peripheral from      */
+/*    ending the message at the end of a transfer.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    input                                 Pointer to the words          */
+/*    words                                 Number of words               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_dma_start            Start a DMA transfer          */
+/*    tx_semaphore_get                      Wait for the end of transfer  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_update         Hash bytes in the HASH         */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_stm32_hash_dma(UCHAR *input, UINT words)
+{
+UINT chunk;
+UINT status = NX_CRYPTO_SUCCESS;
+
+    HASH -> CR |= HASH_CR_MDMAT;
+
+    while ((words > 0) && (status == NX_CRYPTO_SUCCESS))
+    {
+        chunk = (words > NX_CRYPTO_STM32_DMA_MAX_WORDS) ? NX_CRYPTO_STM32_DMA_MAX_WORDS : words;
+
+        nx_crypto_stm32_hash_dma_error = NX_CRYPTO_FALSE;
+
+        _nx_crypto_stm32_dma_start(NX_CRYPTO_STM32_HASH_IN_STREAM, NX_CRYPTO_STM32_HASH_IN_FLAGS, DMA_SxCR_DIR_0,
+                                   &HASH -> DIN, input, chunk, DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+        HASH -> CR |= HASH_CR_DMAE;
+
+        if ((tx_semaphore_get(&nx_crypto_stm32_hash_done, NX_CRYPTO_STM32_DMA_TIMEOUT) != TX_SUCCESS) ||
+            (nx_crypto_stm32_hash_dma_error))
+        {
+            status = NX_CRYPTO_NOT_SUCCESSFUL;
+        }
+
+        HASH -> CR &= ~HASH_CR_DMAE;
+        NX_CRYPTO_STM32_HASH_IN_STREAM -> CR = 0;
+
+        input += chunk << 2;
+        words -= chunk;
+    }
+
+    HASH -> CR &= ~HASH_CR_MDMAT;
+
+    /* Take back the end of a transfer that came after the timeout, so that it does not end the next one.  */
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+        tx_semaphore_get(&nx_crypto_stm32_hash_done, TX_NO_WAIT);
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_update                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function hashes bytes of a message in the HASH peripheral,     */
+/*    held by the HASH mutex. The bytes complete the pending partial word */
+/*    first, then go to the peripheral in whole words, through the DMA    */
+/*    for long aligned buffers. The bytes short of a word are kept        */
+/*    pending, for the next update or the last word of the message, and   */
+/*    the context is saved.                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    context                               Pointer to hash context       */
+/*    algo                                  ALGO bits of HASH_CR          */
+/*    input                                 Pointer to the bytes          */
+/*    length                                Number of bytes               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_restore         Put the context in the HASH   */
+/*    _nx_crypto_stm32_hash_dma             Hash words with the DMA       */
+/*    _nx_crypto_stm32_hash_save            Save the context of the HASH  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_operation                               */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_crypto_stm32_hash_update(NX_CRYPTO_STM32_HASH *context, ULONG algo, UCHAR *input, UINT length)
+{
+UCHAR *pending;
+UINT   words;
+UINT   i;
+UINT   status = NX_CRYPTO_SUCCESS;
+
+    pending = context -> nx_crypto_stm32_hash_pending;
+
+    _nx_crypto_stm32_hash_restore(context, algo);
+
+    while ((context -> nx_crypto_stm32_hash_pending_length > 0) && (length > 0))
+    {
+        pending[context -> nx_crypto_stm32_hash_pending_length++] = *input++;
+        length--;
+        if (context -> nx_crypto_stm32_hash_pending_length == 4)
+        {
+            HASH -> DIN = __UNALIGNED_UINT32_READ(pending);
+            context -> nx_crypto_stm32_hash_pending_length = 0;
+        }
+    }
+
+    words = length >> 2;
+    if (((words << 2) >= NX_CRYPTO_STM32_DMA_THRESHOLD) && NX_CRYPTO_STM32_DMA_CAPABLE(input))
+    {
+        status = _nx_crypto_stm32_hash_dma(input, words);
+    }
+    else
+    {
+        for (i = 0; i < words; i++)
+        {
+            HASH -> DIN = __UNALIGNED_UINT32_READ(&input[i << 2]);
+        }
+    }
+    input += words << 2;
+    length &= 3;
+
+    while (length > 0)
+    {
+        pending[context -> nx_crypto_stm32_hash_pending_length++] = *input++;
+        length--;
+    }
+
+    _nx_crypto_stm32_hash_save(context);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_calculate                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function ends a message in the HASH peripheral, held by the    */
+/*    HASH mutex: the pending bytes are written as the last word, with    */
+/*    their number of valid bits, and the digest is calculated and read   */
+/*    out.                                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    context                               Pointer to hash context       */
+/*    algo                                  ALGO bits of HASH_CR          */
+/*    digest                                Pointer to the digest         */
+/*    digest_length                         Digest length in bytes        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_hash_restore         Put the context in the HASH   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_operation                               */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_crypto_stm32_hash_calculate(NX_CRYPTO_STM32_HASH *context, ULONG algo,
+                                            UCHAR *digest, UINT digest_length)
+{
+UINT i;
+
+    _nx_crypto_stm32_hash_restore(context, algo);
+
+    HASH -> STR = context -> nx_crypto_stm32_hash_pending_length << 3;
+    if (context -> nx_crypto_stm32_hash_pending_length > 0)
+    {
+        HASH -> DIN = __UNALIGNED_UINT32_READ(context -> nx_crypto_stm32_hash_pending);
+    }
+    HASH -> STR |= HASH_STR_DCAL;
+
+    while ((HASH -> SR & HASH_SR_DCIS) == 0)
+    {
+    }
+
+    /* The first five words are also in the registers of SHA-1, the other ones of SHA-2 only.  */
+    for (i = 0; i < (digest_length >> 2); i++)
+    {
+        NX_CRYPTO_STM32_STORE_WORD(&digest[i << 2], (i < 5) ? HASH -> HR[i] : HASH_DIGEST -> HR[i]);
+    }
+
+    context -> nx_crypto_stm32_hash_pending_length = 0;
+    context -> nx_crypto_stm32_hash_engine = NX_CRYPTO_STM32_HASH_STARTED;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_init                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the common crypto method init callback for the     */
+/*    SHA-1 and SHA-2 methods of the driver. It checks the metadata,      */
+/*    which holds the hash context.                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    method                                Pointer to crypto method      */
+/*    key                                   Pointer to key                */
+/*    key_size_in_bits                      Length of key size in bits    */
+/*    handle                                Handle, specified by user     */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Size of the metadata area     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_method_stm32_sha_init(struct NX_CRYPTO_METHOD_STRUCT *method,
+                                      UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                      VOID **handle,
+                                      VOID *crypto_metadata,
+                                      ULONG crypto_metadata_size)
+{
+
+    NX_CRYPTO_PARAMETER_NOT_USED(key);
+    NX_CRYPTO_PARAMETER_NOT_USED(key_size_in_bits);
+    NX_CRYPTO_PARAMETER_NOT_USED(handle);
+
+    NX_CRYPTO_STATE_CHECK
+
+    if ((method == NX_CRYPTO_NULL) || (crypto_metadata == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    /* Verify the metadata addrsss is 4-byte aligned. */
+    if((((ULONG)crypto_metadata) & 0x3) != 0)
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if(crypto_metadata_size < sizeof(NX_CRYPTO_STM32_HASH))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_cleanup                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function cleans up the crypto metadata of the SHA-1 and SHA-2  */
+/*    methods of the driver.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crypto_metadata                       Crypto metadata               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_method_stm32_sha_cleanup(VOID *crypto_metadata)
+{
+
+    NX_CRYPTO_STATE_CHECK
+
+#ifdef NX_SECURE_KEY_CLEAR
+    if (!crypto_metadata)
+        return (NX_CRYPTO_SUCCESS);
+
+    /* Clean up the crypto metadata.  */
+    NX_CRYPTO_MEMSET(crypto_metadata, 0, sizeof(NX_CRYPTO_STM32_HASH));
+#else
+    NX_CRYPTO_PARAMETER_NOT_USED(crypto_metadata);
+#endif/* NX_SECURE_KEY_CLEAR  */
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_sha_operation               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function hashes a message with the SHA-1, SHA-224 or SHA-256   */
+/*    algorithm in the HASH peripheral, in place of the software methods. */
+/*    The engine is chosen at the start of each message: the peripheral   */
+/*    if it is available to the caller then, the software otherwise, for  */
+/*    the whole message. Each update and the calculation take the         */
+/*    peripheral for their own length only, so that the messages of       */
+/*    several threads interleave.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    Hash operation                */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_stm32_lock                 Take the HASH mutex           */
+/*    _nx_crypto_stm32_hash_update          Hash bytes in the HASH        */
+/*    _nx_crypto_stm32_hash_calculate       Calculate the digest          */
+/*    tx_mutex_put                          Release the HASH mutex        */
+/*    _nx_crypto_sha1_initialize            Initialize the SHA1 context   */
+/*    _nx_crypto_sha1_update                Update the digest with padding*/
+/*                                            and length of digest        */
+/*    _nx_crypto_sha1_digest_calculate      Calculate the SHA1 digest     */
+/*    _nx_crypto_sha256_initialize          Initialize the SHA256 context */
+/*    _nx_crypto_sha256_update              Update the digest with padding*/
+/*                                            and length of digest        */
+/*    _nx_crypto_sha256_digest_calculate    Calculate the SHA256 digest   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*    _nx_crypto_method_hmac_operation     Handle HMAC operation          */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_method_stm32_sha_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                           VOID *handle, /* Crypto handler */
+                                           struct NX_CRYPTO_METHOD_STRUCT *method,
+                                           UCHAR *key,
+                                           NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                           UCHAR *input,
+                                           ULONG input_length_in_byte,
+                                           UCHAR *iv_ptr,
+                                           UCHAR *output,
+                                           ULONG output_length_in_byte,
+                                           VOID *crypto_metadata,
+                                           ULONG crypto_metadata_size,
+                                           VOID *packet_ptr,
+                                           VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+NX_CRYPTO_STM32_HASH *context;
+ULONG                 algo;
+UINT                  algorithm;
+UINT                  digest_length;
+UINT                  status = NX_CRYPTO_SUCCESS;
+
+
+    NX_CRYPTO_PARAMETER_NOT_USED(handle);
+    NX_CRYPTO_PARAMETER_NOT_USED(key);
+    NX_CRYPTO_PARAMETER_NOT_USED(key_size_in_bits);
+    NX_CRYPTO_PARAMETER_NOT_USED(iv_ptr);
+    NX_CRYPTO_PARAMETER_NOT_USED(packet_ptr);
+    NX_CRYPTO_PARAMETER_NOT_USED(nx_crypto_hw_process_callback);
+
+    NX_CRYPTO_STATE_CHECK
+
+    /* Verify the metadata address is 4-byte aligned. */
+    if((method == NX_CRYPTO_NULL) || (crypto_metadata == NX_CRYPTO_NULL) || ((((ULONG)crypto_metadata) & 0x3) != 0))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if(crypto_metadata_size < sizeof(NX_CRYPTO_STM32_HASH))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    context = (NX_CRYPTO_STM32_HASH *)crypto_metadata;
+    algorithm = method -> nx_crypto_algorithm;
+    if ((algorithm != NX_CRYPTO_HASH_SHA1) && (algorithm != NX_CRYPTO_HASH_SHA224) &&
+        (algorithm != NX_CRYPTO_HASH_SHA256))
+    {
+        return(NX_CRYPTO_INVALID_ALGORITHM);
+    }
+    algo = _nx_crypto_stm32_hash_algorithm(algorithm, &digest_length);
+
+    if ((op != NX_CRYPTO_HASH_INITIALIZE) && (op != NX_CRYPTO_HASH_UPDATE) && (output_length_in_byte < digest_length))
+    {
+        return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+    }
+
+    if ((op != NX_CRYPTO_HASH_UPDATE) && (op != NX_CRYPTO_HASH_CALCULATE))
+    {
+
+        /* A new message, in the peripheral if available now.  */
+        if (nx_crypto_stm32_ready && (__get_IPSR() == 0) && (tx_thread_identify() != TX_NULL))
+        {
+            context -> nx_crypto_stm32_hash_pending_length = 0;
+            context -> nx_crypto_stm32_hash_engine = NX_CRYPTO_STM32_HASH_STARTED;
+        }
+        else
+        {
+            context -> nx_crypto_stm32_hash_engine = NX_CRYPTO_STM32_HASH_SOFTWARE;
+            if (algorithm == NX_CRYPTO_HASH_SHA1)
+            {
+                _nx_crypto_sha1_initialize(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha1, algorithm);
+            }
+            else
+            {
+                _nx_crypto_sha256_initialize(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha256, algorithm);
+            }
+        }
+
+        if (op == NX_CRYPTO_HASH_INITIALIZE)
+        {
+            return(NX_CRYPTO_SUCCESS);
+        }
+    }
+
+    if (context -> nx_crypto_stm32_hash_engine == NX_CRYPTO_STM32_HASH_SOFTWARE)
+    {
+        if (algorithm == NX_CRYPTO_HASH_SHA1)
+        {
+            if (op != NX_CRYPTO_HASH_CALCULATE)
+            {
+                _nx_crypto_sha1_update(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha1,
+                                       input, input_length_in_byte);
+            }
+            if (op != NX_CRYPTO_HASH_UPDATE)
+            {
+                _nx_crypto_sha1_digest_calculate(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha1,
+                                                 output, algorithm);
+            }
+        }
+        else
+        {
+            if (op != NX_CRYPTO_HASH_CALCULATE)
+            {
+                _nx_crypto_sha256_update(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha256,
+                                         input, input_length_in_byte);
+            }
+            if (op != NX_CRYPTO_HASH_UPDATE)
+            {
+                _nx_crypto_sha256_digest_calculate(&context -> nx_crypto_stm32_hash_software.nx_crypto_stm32_hash_sha256,
+                                                   output, algorithm);
+            }
+        }
+
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    /* A message started in the peripheral needs it to the end, the context being in its registers.  */
+    if (tx_mutex_get(&nx_crypto_stm32_hash_mutex, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+        return(NX_CRYPTO_NOT_SUCCESSFUL);
+    }
+
+    if ((op != NX_CRYPTO_HASH_CALCULATE) && (input_length_in_byte > 0))
+    {
+        status = _nx_crypto_stm32_hash_update(context, algo, input, input_length_in_byte);
+    }
+    if ((op != NX_CRYPTO_HASH_UPDATE) && (status == NX_CRYPTO_SUCCESS))
+    {
+        _nx_crypto_stm32_hash_calculate(context, algo, output, digest_length);
+    }
+
+    tx_mutex_put(&nx_crypto_stm32_hash_mutex);
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_hmac_operation              PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the HMAC-SHA1 or HMAC-SHA256 of a message    */
+/*    with the generic HMAC over the SHA-1 or SHA-256 method of the       */
+/*    driver, which hashes in the HASH peripheral. The hash method is set */
+/*    at the start of each message, before the key, as the generic HMAC   */
+/*    method expects.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    HMAC operation                */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_method_hmac_operation      Handle HMAC operation         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_method_stm32_hmac_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                            VOID *handle, /* Crypto handler */
+                                            struct NX_CRYPTO_METHOD_STRUCT *method,
+                                            UCHAR *key,
+                                            NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                            UCHAR *input,
+                                            ULONG input_length_in_byte,
+                                            UCHAR *iv_ptr,
+                                            UCHAR *output,
+                                            ULONG output_length_in_byte,
+                                            VOID *crypto_metadata,
+                                            ULONG crypto_metadata_size,
+                                            VOID *packet_ptr,
+                                            VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+NX_CRYPTO_METHOD *hash_method;
+UINT              status;
+
+
+    NX_CRYPTO_STATE_CHECK
+
+    if (method == NX_CRYPTO_NULL)
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    switch (method -> nx_crypto_algorithm)
+    {
+    case NX_CRYPTO_AUTHENTICATION_HMAC_SHA1_160:
+        hash_method = &crypto_method_sha1_stm32;
+        break;
+    case NX_CRYPTO_AUTHENTICATION_HMAC_SHA2_256:
+        hash_method = &crypto_method_sha256_stm32;
+        break;
+    default:
+        return(NX_CRYPTO_INVALID_ALGORITHM);
+    }
+
+    if ((op != NX_CRYPTO_HASH_UPDATE) && (op != NX_CRYPTO_HASH_CALCULATE))
+    {
+        status = _nx_crypto_method_hmac_operation(NX_CRYPTO_HMAC_SET_HASH, handle, hash_method,
+                                                  NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                  NX_CRYPTO_NULL, 0, crypto_metadata, crypto_metadata_size,
+                                                  NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+        if (status)
+        {
+            return(status);
+        }
+    }
+
+    return(_nx_crypto_method_hmac_operation(op, handle, method, key, key_size_in_bits, input, input_length_in_byte,
+                                            iv_ptr, output, output_length_in_byte, crypto_metadata,
+                                            crypto_metadata_size, packet_ptr, nx_crypto_hw_process_callback));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    NX_CRYPTO_STM32_CRYP_OUT_IRQHandler                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the interrupt of the DMA stream of the CRYP        */
+/*    output. It clears the flags of the stream and wakes the waiting     */
+/*    thread at the end of the transfer, a transfer error recorded.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_semaphore_put                      Wake the waiting thread       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    DMA interrupt                                                       */
+/*                                                                        */
+/**************************************************************************/
+void NX_CRYPTO_STM32_CRYP_OUT_IRQHandler(void)
+{
+ULONG flags;
+
+    THREAD_PROFILE_ISR_ENTER();
+
+    flags = DMA2 -> HISR & NX_CRYPTO_STM32_CRYP_OUT_FLAGS;
+    DMA2 -> HIFCR = flags;
+
+    if (flags & NX_CRYPTO_STM32_CRYP_OUT_ERROR)
+    {
+        nx_crypto_stm32_cryp_dma_error = NX_CRYPTO_TRUE;
+    }
+
+    if (flags & (NX_CRYPTO_STM32_CRYP_OUT_DONE | NX_CRYPTO_STM32_CRYP_OUT_ERROR))
+    {
+        tx_semaphore_put(&nx_crypto_stm32_cryp_done);
+    }
+
+    THREAD_PROFILE_ISR_EXIT();
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    NX_CRYPTO_STM32_HASH_IN_IRQHandler                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the interrupt of the DMA stream of the HASH input. */
+/*    It clears the flags of the stream and wakes the waiting thread at   */
+/*    the end of the transfer, a transfer error recorded.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_semaphore_put                      Wake the waiting thread       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    DMA interrupt                                                       */
+/*                                                                        */
+/**************************************************************************/
+void NX_CRYPTO_STM32_HASH_IN_IRQHandler(void)
+{
+ULONG flags;
+
+    THREAD_PROFILE_ISR_ENTER();
+
+    flags = DMA2 -> HISR & NX_CRYPTO_STM32_HASH_IN_FLAGS;
+    DMA2 -> HIFCR = flags;
+
+    if (flags & NX_CRYPTO_STM32_HASH_IN_ERROR)
+    {
+        nx_crypto_stm32_hash_dma_error = NX_CRYPTO_TRUE;
+    }
+
+    if (flags & (NX_CRYPTO_STM32_HASH_IN_DONE | NX_CRYPTO_STM32_HASH_IN_ERROR))
+    {
+        tx_semaphore_put(&nx_crypto_stm32_hash_done);
+    }
+
+    THREAD_PROFILE_ISR_EXIT();
+}
@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+#ifndef NX_STM32_CRYPTO_DRIVER_H
+#define NX_STM32_CRYPTO_DRIVER_H
+
+
+#ifdef   __cplusplus
+
+/* Yes, C++ compiler is present.  Use standard C.  */
+extern   "C" {
+#endif
+
+
+/* Include the crypto headers of the contexts the driver works on.  */
+
+#include "nx_crypto_aes.h"
+#include "nx_crypto_sha1.h"
+#include "nx_crypto_sha2.h"
+
+
+/* Define the engine of a hash context, chosen by NX_CRYPTO_HASH_INITIALIZE for the whole
+   message: the software, or the HASH peripheral before and after its first update. Each
+   update restores the context to the peripheral and saves it back, so that the contexts
+   interleave and can be copied, as the TLS handshake hash is.  */
+
+#define NX_CRYPTO_STM32_HASH_SOFTWARE       0
+#define NX_CRYPTO_STM32_HASH_STARTED        1
+#define NX_CRYPTO_STM32_HASH_SAVED          2
+
+/* Define the number of context swap registers of SHA-1 and SHA-2, the HMAC mode of the
+   peripheral not used.  */
+
+#define NX_CRYPTO_STM32_HASH_CSR_COUNT      38
+
+
+typedef struct NX_CRYPTO_STM32_HASH_STRUCT
+{
+
+    /* Software context, when the peripheral is not available at the start of the message.  */
+    union
+    {
+        NX_CRYPTO_SHA1   nx_crypto_stm32_hash_sha1;
+        NX_CRYPTO_SHA256 nx_crypto_stm32_hash_sha256;
+    } nx_crypto_stm32_hash_software;
+
+    /* Context of the peripheral, saved after each update.  */
+    ULONG nx_crypto_stm32_hash_imr;
+    ULONG nx_crypto_stm32_hash_str;
+    ULONG nx_crypto_stm32_hash_cr;
+    ULONG nx_crypto_stm32_hash_csr[NX_CRYPTO_STM32_HASH_CSR_COUNT];
+
+    /* Bytes of a partial word, written with the next bytes or as the last word.  */
+    UCHAR nx_crypto_stm32_hash_pending[4];
+    UINT  nx_crypto_stm32_hash_pending_length;
+
+    UINT  nx_crypto_stm32_hash_engine;
+} NX_CRYPTO_STM32_HASH;
+
+
+/* Define the driver functions.  */
+
+UINT nx_stm32_crypto_initialize(VOID);
+
+UINT _nx_crypto_stm32_aes_encrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length);
+UINT _nx_crypto_stm32_aes_decrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length);
+UINT _nx_crypto_stm32_aes_cbc_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                             UCHAR *input, UCHAR *output, UINT blocks);
+UINT _nx_crypto_stm32_aes_cbc_decrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                             UCHAR *input, UCHAR *output, UINT blocks);
+UINT _nx_crypto_stm32_aes_ctr_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *counter_block,
+                                             UCHAR *input, UCHAR *output, UINT blocks);
+
+UINT _nx_crypto_method_stm32_sha_init(struct NX_CRYPTO_METHOD_STRUCT *method,
+                                      UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                      VOID **handle,
+                                      VOID *crypto_metadata,
+                                      ULONG crypto_metadata_size);
+
+UINT _nx_crypto_method_stm32_sha_cleanup(VOID *crypto_metadata);
+
+UINT _nx_crypto_method_stm32_sha_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                           VOID *handle, /* Crypto handler */
+                                           struct NX_CRYPTO_METHOD_STRUCT *method,
+                                           UCHAR *key,
+                                           NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                           UCHAR *input,
+                                           ULONG input_length_in_byte,
+                                           UCHAR *iv_ptr,
+                                           UCHAR *output,
+                                           ULONG output_length_in_byte,
+                                           VOID *crypto_metadata,
+                                           ULONG crypto_metadata_size,
+                                           VOID *packet_ptr,
+                                           VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+
+UINT _nx_crypto_method_stm32_hmac_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                            VOID *handle, /* Crypto handler */
+                                            struct NX_CRYPTO_METHOD_STRUCT *method,
+                                            UCHAR *key,
+                                            NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                            UCHAR *input,
+                                            ULONG input_length_in_byte,
+                                            UCHAR *iv_ptr,
+                                            UCHAR *output,
+                                            ULONG output_length_in_byte,
+                                            VOID *crypto_metadata,
+                                            ULONG crypto_metadata_size,
+                                            VOID *packet_ptr,
+                                            VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+
+
+#ifdef   __cplusplus
+/* Yes, C++ compiler is present.  Use standard C.  */
+    }
+#endif
+
+#endif /* NX_STM32_CRYPTO_DRIVER_H */
@@ -24,6 +24,10 @@ static int32_t lan8742_io_read_reg(uint32_t DevAddr, uint32_t RegAddr, uint32_t
 
 static int32_t lan8742_io_get_tick(void);
 
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+static int32_t nx_eth_phy_interrupt_init(void);
+#endif
+
 /* LAN8742 IO context object */
 static lan8742_IOCtx_t  LAN8742_IOCtx = { lan8742_io_init,
                                           lan8742_io_deinit,
@@ -35,7 +39,9 @@ static lan8742_IOCtx_t  LAN8742_IOCtx = { lan8742_io_init,
 static lan8742_Object_t LAN8742;
 
 /**
-  * @brief  Initialize the PHY interface
+  * @brief  Initialize the PHY interface. Only starts the software reset of the
+  *         PHY, nx_eth_phy_get_link_state() reports the link down until the
+  *         reset and the auto-negotiation are done.
   * @param  none
   * @retval ETH_PHY_STATUS_OK on success, ETH_PHY_STATUS_ERROR otherwise
   */
@@ -46,9 +52,9 @@ int32_t nx_eth_phy_init(void)
     /* Set PHY IO functions */
 
     LAN8742_RegisterBusIO(&LAN8742, &LAN8742_IOCtx);
-    /* Initialize the LAN8742 ETH PHY */
+    /* Start the initialization of the LAN8742 ETH PHY */
 
-    if (LAN8742_Init(&LAN8742) == LAN8742_STATUS_OK)
+    if (LAN8742_StartInit(&LAN8742) == LAN8742_STATUS_OK)
     {
         ret = ETH_PHY_STATUS_OK;
     }
@@ -57,14 +63,42 @@ int32_t nx_eth_phy_init(void)
 }
 
 /**
-  * @brief  get the Phy link status.
+  * @brief  get the Phy link status. Moves the initialization of the PHY on
+  *         while it is not done, a single MDIO read each call.
   * @param  none
   * @retval the link status.
   */
 
 int32_t nx_eth_phy_get_link_state(void)
 {
-    int32_t  linkstate = LAN8742_GetLinkState(&LAN8742);
+    int32_t  linkstate;
+
+    if (LAN8742.Is_Initialized == 0)
+    {
+        linkstate = LAN8742_GetInitState(&LAN8742);
+
+        if (linkstate == LAN8742_STATUS_RESET_PENDING)
+        {
+            return ETH_PHY_STATUS_LINK_DOWN;
+        }
+
+        if (linkstate != LAN8742_STATUS_OK)
+        {
+            /* Reset the PHY again, from the next check on. */
+            LAN8742_StartInit(&LAN8742);
+            return ETH_PHY_STATUS_LINK_ERROR;
+        }
+
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+        /* Report the link changes on nINT from now on, the reset cleared the mask. */
+        if (nx_eth_phy_interrupt_init() != ETH_PHY_STATUS_OK)
+        {
+            return ETH_PHY_STATUS_LINK_ERROR;
+        }
+#endif
+    }
+
+    linkstate = LAN8742_GetLinkState(&LAN8742);
 
     return linkstate;
 }
@@ -80,6 +114,59 @@ nx_eth_phy_handle_t nx_eth_phy_get_handle(void)
     return (nx_eth_phy_handle_t)&LAN8742;
 }
 
+/**
+  * @brief  Clear the interrupt flags of the PHY, which releases nINT. Reads the
+  *         PHY over MDIO, so it is called from a thread once the EXTI line fired.
+  * @param  none
+  * @retval ETH_PHY_STATUS_OK on success, ETH_PHY_STATUS_ERROR otherwise
+  */
+
+int32_t nx_eth_phy_interrupt_clear(void)
+{
+    if (LAN8742_ClearIT(&LAN8742, LAN8742_LINK_DOWN_IT | LAN8742_AUTONEGO_COMPLETE_IT) != LAN8742_STATUS_OK)
+    {
+        return ETH_PHY_STATUS_ERROR;
+    }
+
+    return ETH_PHY_STATUS_OK;
+}
+
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+/**
+  * @brief  Enable the link down and auto-negotiation complete interrupts of the PHY,
+  *         and the falling edge EXTI line of its nINT output.
+  * @param  none
+  * @retval ETH_PHY_STATUS_OK on success, ETH_PHY_STATUS_ERROR otherwise
+  */
+
+static int32_t nx_eth_phy_interrupt_init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    if (LAN8742_EnableIT(&LAN8742, LAN8742_LINK_DOWN_IT | LAN8742_AUTONEGO_COMPLETE_IT) != LAN8742_STATUS_OK)
+    {
+        return ETH_PHY_STATUS_ERROR;
+    }
+
+    /* nINT stays low until the flags are read, a pending one would leave no edge to see. */
+    if (nx_eth_phy_interrupt_clear() != ETH_PHY_STATUS_OK)
+    {
+        return ETH_PHY_STATUS_ERROR;
+    }
+
+    /* The GPIO clocks are enabled by MX_GPIO_Init(). nINT is open drain. */
+    GPIO_InitStruct.Pin = NX_ETH_PHY_INTERRUPT_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(NX_ETH_PHY_INTERRUPT_PORT, &GPIO_InitStruct);
+
+    HAL_NVIC_SetPriority(NX_ETH_PHY_INTERRUPT_IRQn, NX_ETH_PHY_INTERRUPT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(NX_ETH_PHY_INTERRUPT_IRQn);
+
+    return ETH_PHY_STATUS_OK;
+}
+#endif
+
 /**
   * @brief  Initialize the PHY MDIO interface
   * @param  None
@@ -137,6 +224,8 @@ int32_t lan8742_io_write_reg(uint32_t DevAddr, uint32_t RegAddr, uint32_t RegVal
 
 /**
   * @brief  Get the time in millisecons used for internal PHY driver process.
+  *         Read once per link state check for the reset timeout, nothing
+  *         waits on it.
   * @retval Time value
   */
 int32_t lan8742_io_get_tick(void)
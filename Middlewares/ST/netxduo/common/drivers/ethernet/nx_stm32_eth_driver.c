@@ -28,6 +28,16 @@
 /* Include the phy driver header */
 #include "nx_stm32_phy_driver.h"
 
+#ifdef NX_DRIVER_ICMP_ECHO_FAST_REPLY
+/* Include the ICMPv4 header for the echo message types.  */
+#include "nx_icmpv4.h"
+#endif /* NX_DRIVER_ICMP_ECHO_FAST_REPLY */
+
+#if NX_DRIVER_TX_RECYCLE_PACKETS > 0
+/* Include the packet header for the states of the sent packets.  */
+#include "nx_packet.h"
+#endif
+
 #endif /* NX_STM32_ETH_DRIVER_H */
 
 /****** DRIVER SPECIFIC ****** End of part/vendor specific include file area!  */
@@ -37,12 +47,27 @@
 /* Place Ethernet BD at uncacheable memory*/
 static  NX_DRIVER_INFORMATION nx_driver_information;
 
+#if NX_DRIVER_RX_POOL_PACKETS > 0
+/* Define the memory of the packet pool dedicated to the RX descriptors.  */
+static  ULONG nx_driver_rx_pool_memory[(NX_DRIVER_RX_POOL_PACKETS * (NX_DRIVER_RX_PACKET_PAYLOAD + sizeof(NX_PACKET))) / sizeof(ULONG)] NX_DRIVER_DMA_MEMORY;
+#endif
+
+#if NX_DRIVER_RX_COPY_BREAK > 0
+/* Define the memory of the small RX packet pool. NetX may send a received packet back,
+   an ICMP echo reply for instance, so it must be visible to the DMA as well.  */
+static  ULONG nx_driver_rx_small_pool_memory[(NX_DRIVER_RX_SMALL_POOL_PACKETS * (NX_DRIVER_RX_SMALL_PACKET_PAYLOAD + sizeof(NX_PACKET))) / sizeof(ULONG)] NX_DRIVER_DMA_MEMORY;
+#endif
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+/* Define the ring of the frames captured.  */
+static  NX_DRIVER_CAPTURE_RECORD nx_driver_capture_records[NX_DRIVER_CAPTURE_FRAMES] NX_DRIVER_CAPTURE_MEMORY;
+#endif
+
 
 extern ETH_DMADescTypeDef  DMARxDscrTab[ETH_RX_DESC_CNT]; /* Ethernet Rx DMA Descriptors */
 extern ETH_DMADescTypeDef  DMATxDscrTab[ETH_TX_DESC_CNT]; /* Ethernet Tx DMA Descriptors */
 
 
-ETH_TxPacketConfig TxPacketCfg;
 ETH_MACFilterConfigTypeDef FilterConfig;
 
 /****** DRIVER SPECIFIC ****** Start of part/vendor specific data area.  Include hardware-specific data here!  */
@@ -61,6 +86,7 @@ static VOID         _nx_driver_packet_send(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_multicast_join(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_multicast_leave(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_get_status(NX_IP_DRIVER *driver_req_ptr);
+static VOID         _nx_driver_get_statistics(NX_IP_DRIVER *driver_req_ptr);
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
 static VOID         _nx_driver_capability_get(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_capability_set(NX_IP_DRIVER *driver_req_ptr);
@@ -69,6 +95,13 @@ static VOID         _nx_driver_capability_set(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_deferred_processing(NX_IP_DRIVER *driver_req_ptr);
 
 static VOID         _nx_driver_transfer_to_netx(NX_IP *ip_ptr, NX_PACKET *packet_ptr);
+static UINT         _nx_driver_transmit_class_get(NX_PACKET *packet_ptr);
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+static VOID         _nx_driver_capture(NX_PACKET *packet_ptr);
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+#ifdef NX_DRIVER_ICMP_ECHO_FAST_REPLY
+static UINT         _nx_driver_icmp_echo_reply(NX_IP *ip_ptr, NX_PACKET *packet_ptr);
+#endif /* NX_DRIVER_ICMP_ECHO_FAST_REPLY */
 
 
 /* Define the prototypes for the hardware implementation of this driver. The contents of these routines are
@@ -77,11 +110,35 @@ driver-specific.  */
 static UINT         _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr);
 static UINT         _nx_driver_hardware_enable(NX_IP_DRIVER *driver_req_ptr);
 static UINT         _nx_driver_hardware_disable(NX_IP_DRIVER *driver_req_ptr);
-static UINT         _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr);
+static UINT         _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr, UINT tx_class);
 static UINT         _nx_driver_hardware_multicast_join(NX_IP_DRIVER *driver_req_ptr);
 static UINT         _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req_ptr);
+static VOID         _nx_driver_hardware_multicast_filter_set(VOID);
+static UINT         _nx_driver_hardware_multicast_hash(ULONG msw, ULONG lsw);
+#ifdef NX_DRIVER_ENABLE_PTP
+static VOID         _nx_driver_hardware_ptp_initialize(VOID);
+#endif
 static UINT         _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr);
+static UINT         _nx_driver_hardware_link_update(NX_IP *ip_ptr);
+static UINT         _nx_driver_hardware_get_statistics(NX_IP_DRIVER *driver_req_ptr);
 static VOID         _nx_driver_hardware_packet_received(VOID);
+static VOID         _nx_driver_hardware_receive_ring_reset(VOID);
+static VOID         _nx_driver_hardware_receive_ring_refill(VOID);
+#if NX_DRIVER_RX_COPY_BREAK > 0
+static NX_PACKET   *_nx_driver_hardware_receive_copy(NX_PACKET *packet_ptr);
+#endif
+static VOID         _nx_driver_hardware_receive_poll_schedule(VOID);
+static VOID         _nx_driver_hardware_receive_poll_timeout(ULONG timer_input);
+static VOID         _nx_driver_hardware_packet_transmitted(VOID);
+static VOID         _nx_driver_hardware_transmit_release(VOID);
+static UINT         _nx_driver_hardware_transmit_class_next(VOID);
+static VOID         _nx_driver_hardware_transmit_schedule(VOID);
+#if NX_DRIVER_TX_RECYCLE_PACKETS > 0
+static UINT         _nx_driver_hardware_transmit_recycle(NX_PACKET *packet_ptr);
+#endif
+static UINT         _nx_driver_hardware_transmit_descriptors_set(NX_PACKET *packet_ptr);
+static NX_PACKET   *_nx_driver_hardware_packet_linearize(NX_PACKET *packet_ptr);
+static UINT         _nx_driver_hardware_packet_segments_get(NX_PACKET *packet_ptr);
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
 static UINT         _nx_driver_hardware_capability_set(NX_IP_DRIVER *driver_req_ptr);
 #endif /* NX_ENABLE_INTERFACE_CAPABILITY */
@@ -220,6 +277,17 @@ VOID  nx_stm32_eth_driver(NX_IP_DRIVER *driver_req_ptr)
       break;
     }
 
+  case NX_LINK_GET_ERROR_COUNT:
+  case NX_LINK_GET_RX_COUNT:
+  case NX_LINK_GET_TX_COUNT:
+  case NX_LINK_GET_ALLOC_ERRORS:
+    {
+
+      /* Process get statistics requests.  */
+      _nx_driver_get_statistics(driver_req_ptr);
+      break;
+    }
+
   case NX_LINK_DEFERRED_PROCESSING:
     {
 
@@ -366,14 +434,10 @@ static VOID  _nx_driver_interface_attach(NX_IP_DRIVER *driver_req_ptr)
 static VOID  _nx_driver_initialize(NX_IP_DRIVER *driver_req_ptr)
 {
 
-  NX_IP           *ip_ptr;
   NX_INTERFACE    *interface_ptr;
   UINT            status;
 
 
-  /* Setup the IP pointer from the driver request.  */
-  ip_ptr =  driver_req_ptr -> nx_ip_driver_ptr;
-
   /* Setup interface pointer.  */
   interface_ptr = driver_req_ptr -> nx_ip_driver_interface;
 
@@ -385,12 +449,55 @@ static VOID  _nx_driver_initialize(NX_IP_DRIVER *driver_req_ptr)
   /* Setup the driver state to not initialized.  */
   nx_driver_information.nx_driver_information_state =                NX_DRIVER_STATE_NOT_INITIALIZED;
 
+#if NX_DRIVER_RX_POOL_PACKETS > 0
+  /* Setup the dedicated packet pool for the driver's received packets, so that the RX
+     descriptors do not compete with the application for the default packet pool.  */
+  if (nx_packet_pool_create(&nx_driver_information.nx_driver_information_receive_pool, "ETH RX Packet Pool",
+                            NX_DRIVER_RX_PACKET_PAYLOAD, nx_driver_rx_pool_memory, sizeof(nx_driver_rx_pool_memory)) != NX_SUCCESS)
+  {
+
+    /* Indicate an unsuccessful request.  */
+    driver_req_ptr -> nx_ip_driver_status =  NX_DRIVER_ERROR;
+    return;
+  }
+
+  /* Keep enough packets available to re-arm the RX descriptors.  */
+  nx_packet_pool_low_watermark_set(&nx_driver_information.nx_driver_information_receive_pool, NX_DRIVER_RX_POOL_WATERMARK);
+
+  nx_driver_information.nx_driver_information_packet_pool_ptr = &nx_driver_information.nx_driver_information_receive_pool;
+#else
+  NX_IP           *ip_ptr;
+
+  /* Setup the IP pointer from the driver request.  */
+  ip_ptr =  driver_req_ptr -> nx_ip_driver_ptr;
+
   /* Setup the default packet pool for the driver's received packets.  */
   nx_driver_information.nx_driver_information_packet_pool_ptr = ip_ptr -> nx_ip_default_packet_pool;
+#endif
+
+#if NX_DRIVER_RX_COPY_BREAK > 0
+  /* Setup the packet pool of the short received frames.  */
+  if (nx_packet_pool_create(&nx_driver_information.nx_driver_information_receive_small_pool, "ETH RX Small Packet Pool",
+                            NX_DRIVER_RX_SMALL_PACKET_PAYLOAD, nx_driver_rx_small_pool_memory, sizeof(nx_driver_rx_small_pool_memory)) != NX_SUCCESS)
+  {
+
+    /* Indicate an unsuccessful request.  */
+    driver_req_ptr -> nx_ip_driver_status =  NX_DRIVER_ERROR;
+    return;
+  }
+#endif
+
+  nx_driver_information.nx_driver_information_receive_recycle = NX_NULL;
+  nx_driver_information.nx_driver_information_receive_recycle_count = 0;
 
   /* Clear the deferred events for the driver.  */
   nx_driver_information.nx_driver_information_deferred_events =       0;
 
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+  /* Capture the frames from the start.  */
+  nx_driver_information.nx_driver_information_capture_enabled =       NX_TRUE;
+#endif
+
   /* Call the hardware-specific ethernet controller initialization.  */
   status =  _nx_driver_hardware_initialize(driver_req_ptr);
 
@@ -480,9 +587,7 @@ static VOID  _nx_driver_enable(NX_IP_DRIVER *driver_req_ptr)
 {
 
   NX_IP           *ip_ptr;
-  ETH_MACConfigTypeDef MACConf;
-  UINT            status, duplex, speed = 0;
-  INT             PHYLinkState;
+  UINT            status;
 
   /* Setup the IP pointer from the driver request.  */
   ip_ptr =  driver_req_ptr -> nx_ip_driver_ptr;
@@ -505,53 +610,13 @@ static VOID  _nx_driver_enable(NX_IP_DRIVER *driver_req_ptr)
     return;
   }
 
+  /* Start the PHY reset, the link comes up later without the IP thread waiting for it.  */
   if (nx_eth_phy_init() != ETH_PHY_STATUS_OK)
   {
     driver_req_ptr -> nx_ip_driver_status =  NX_DRIVER_ERROR;
     return;
   }
 
-  PHYLinkState = nx_eth_phy_get_link_state();
-
-  /* Get link state */
-  if(PHYLinkState <= ETH_PHY_STATUS_LINK_DOWN)
-  {
-    driver_req_ptr -> nx_ip_driver_status =  NX_DRIVER_ERROR;
-    return;
-  }
-  else
-  {
-    switch (PHYLinkState)
-    {
-    case ETH_PHY_STATUS_100MBITS_FULLDUPLEX:
-      duplex = ETH_FULLDUPLEX_MODE;
-      speed = ETH_SPEED_100M;
-      break;
-    case ETH_PHY_STATUS_100MBITS_HALFDUPLEX:
-      duplex = ETH_HALFDUPLEX_MODE;
-      speed = ETH_SPEED_100M;
-      break;
-    case ETH_PHY_STATUS_10MBITS_FULLDUPLEX:
-      duplex = ETH_FULLDUPLEX_MODE;
-      speed = ETH_SPEED_10M;
-      break;
-    case ETH_PHY_STATUS_10MBITS_HALFDUPLEX:
-      duplex = ETH_HALFDUPLEX_MODE;
-      speed = ETH_SPEED_10M;
-      break;
-    default:
-      duplex = ETH_FULLDUPLEX_MODE;
-      speed = ETH_SPEED_100M;
-      break;
-    }
-
-    /* Get MAC Config MAC */
-    HAL_ETH_GetMACConfig(&eth_handle, &MACConf);
-    MACConf.DuplexMode = duplex;
-    MACConf.Speed = speed;
-    HAL_ETH_SetMACConfig(&eth_handle, &MACConf);
-  }
-
   /* Call hardware specific enable.  */
   status =  _nx_driver_hardware_enable(driver_req_ptr);
 
@@ -565,8 +630,9 @@ static VOID  _nx_driver_enable(NX_IP_DRIVER *driver_req_ptr)
     /* Mark request as successful.  */
     driver_req_ptr -> nx_ip_driver_status =  NX_SUCCESS;
 
-    /* Mark the IP instance as link up.  */
-    ip_ptr -> nx_ip_driver_link_up =  NX_TRUE;
+    /* Mark the IP instance as link down, the status checks bring it up with the PHY.  */
+    ip_ptr -> nx_ip_driver_link_up =  NX_FALSE;
+    _nx_driver_hardware_link_update(ip_ptr);
   }
   else
   {
@@ -690,6 +756,7 @@ static VOID  _nx_driver_disable(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_driver_transmit_class_get         Classify the frame            */
 /*    _nx_driver_hardware_packet_send       Process packet send request   */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -804,7 +871,15 @@ static VOID  _nx_driver_packet_send(NX_IP_DRIVER *driver_req_ptr)
   }
 
   /* Transmit the packet through the Ethernet controller low level access routine. */
-  status = _nx_driver_hardware_packet_send(packet_ptr);
+  if ((driver_req_ptr -> nx_ip_driver_command == NX_LINK_ARP_SEND) ||
+      (driver_req_ptr -> nx_ip_driver_command == NX_LINK_ARP_RESPONSE_SEND))
+  {
+    status = _nx_driver_hardware_packet_send(packet_ptr, NX_DRIVER_TX_CLASS_CONTROL);
+  }
+  else
+  {
+    status = _nx_driver_hardware_packet_send(packet_ptr, _nx_driver_transmit_class_get(packet_ptr));
+  }
 
   /* Determine if there was an error.  */
   if (status != NX_SUCCESS)
@@ -1032,6 +1107,62 @@ static VOID  _nx_driver_get_status(NX_IP_DRIVER *driver_req_ptr)
 }
 
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_get_statistics                                           */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processing the get statistics requests, that return   */
+/*    the RX, TX, error or allocation error count of the driver. The      */
+/*    processing in this function is generic.                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver command from the IP    */
+/*                                            thread                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_get_statistics    Process get statistics        */
+/*                                            request                     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Driver entry function                                               */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_get_statistics(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  UINT        status;
+
+
+  /* Call hardware specific get statistics function. */
+  status =  _nx_driver_hardware_get_statistics(driver_req_ptr);
+
+  /* Determine if there was an error.  */
+  if (status != NX_SUCCESS)
+  {
+
+    /* Indicate an unsuccessful request.  */
+    driver_req_ptr -> nx_ip_driver_status =  NX_DRIVER_ERROR;
+  }
+  else
+  {
+
+    /* Indicate the request was successful.   */
+    driver_req_ptr -> nx_ip_driver_status =  NX_SUCCESS;
+  }
+}
+
+
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
 /**************************************************************************/
 /*                                                                        */
@@ -1176,7 +1307,8 @@ static VOID  _nx_driver_capability_set(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_driver_packet_transmitted        Clean up after transmission    */
+/*    _nx_driver_hardware_packet_transmitted                              */
+/*                                         Clean up after transmission    */
 /*    _nx_driver_packet_received           Process a received packet      */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -1196,6 +1328,7 @@ static VOID  _nx_driver_deferred_processing(NX_IP_DRIVER *driver_req_ptr)
 {
 
   TX_INTERRUPT_SAVE_AREA
+  CYCLE_PROFILE_SAVE_AREA
 
     ULONG       deferred_events;
 
@@ -1214,14 +1347,16 @@ static VOID  _nx_driver_deferred_processing(NX_IP_DRIVER *driver_req_ptr)
     {
 
       /* Process transmitted packet(s).  */
-      HAL_ETH_ReleaseTxPacket(&eth_handle);
+      _nx_driver_hardware_packet_transmitted();
     }
   /* Check for received packet.  */
   if(deferred_events & NX_DRIVER_DEFERRED_PACKET_RECEIVED)
   {
 
     /* Process received packet(s).  */
+    CYCLE_PROFILE_ENTER
     _nx_driver_hardware_packet_received();
+    CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ETH_RECEIVE)
   }
 
   /* Mark request as successful.  */
@@ -1256,6 +1391,8 @@ static VOID  _nx_driver_deferred_processing(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_driver_capture                    Capture the frame             */
+/*    _nx_driver_icmp_echo_reply            Answer an ICMP echo request   */
 /*    _nx_ip_packet_receive                 NetX IP packet receive        */
 /*    _nx_ip_packet_deferred_receive        NetX IP packet receive        */
 /*    _nx_arp_packet_deferred_receive       NetX ARP packet receive       */
@@ -1281,6 +1418,15 @@ static VOID _nx_driver_transfer_to_netx(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
   USHORT    packet_type;
 
 
+  TRACE_SWO_EVENT(TRACE_SWO_EVENT_ETH_RECEIVE, packet_ptr, packet_ptr -> nx_packet_length, 0, 0)
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+  if (nx_driver_information.nx_driver_information_capture_enabled)
+  {
+    _nx_driver_capture(packet_ptr);
+  }
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+
   /* Set the interface for the incoming packet.  */
   packet_ptr -> nx_packet_ip_interface = nx_driver_information.nx_driver_information_interface;
 
@@ -1292,6 +1438,14 @@ static VOID _nx_driver_transfer_to_netx(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
   /* Route the incoming packet according to its ethernet type.  */
   if (packet_type == NX_DRIVER_ETHERNET_IP || packet_type == NX_DRIVER_ETHERNET_IPV6)
   {
+#ifdef NX_DRIVER_ICMP_ECHO_FAST_REPLY
+    /* Echo requests to our address go back out in the frame they came in.  */
+    if ((packet_type == NX_DRIVER_ETHERNET_IP) && _nx_driver_icmp_echo_reply(ip_ptr, packet_ptr))
+    {
+      return;
+    }
+#endif /* NX_DRIVER_ICMP_ECHO_FAST_REPLY */
+
     /* Note:  The length reported by some Ethernet hardware includes
     bytes after the packet as well as the Ethernet header.  In some
     cases, the actual packet length after the Ethernet header should
@@ -1305,7 +1459,14 @@ static VOID _nx_driver_transfer_to_netx(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
     packet_ptr -> nx_packet_length -= NX_DRIVER_ETHERNET_FRAME_SIZE;
 
     /* Route to the ip receive function.  */
+#ifdef NX_DRIVER_RX_DIRECT_DISPATCH
+    /* The RX ring is drained on the IP thread with the IP mutex held, so the frame
+       goes through IP and TCP processing, and its consumer is notified, right away
+       instead of on the next pass of the IP thread event loop.  */
+    _nx_ip_packet_receive(ip_ptr, packet_ptr);
+#else
     _nx_ip_packet_deferred_receive(ip_ptr, packet_ptr);
+#endif /* NX_DRIVER_RX_DIRECT_DISPATCH */
   }
   else if (packet_type == NX_DRIVER_ETHERNET_ARP)
   {
@@ -1339,138 +1500,441 @@ static VOID _nx_driver_transfer_to_netx(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
 }
 
 
-/****** DRIVER SPECIFIC ****** Start of part/vendor specific internal driver functions.  */
-
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_initialize                                      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_transmit_class_get                                       */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes hardware-specific initialization.           */
+/*    This function returns the transmit class of an IP frame. The TCP    */
+/*    segments without data, other than FIN which must follow the data    */
+/*    sent before it, are control frames. Otherwise the DSCP of the IPv4  */
+/*    or IPv6 header sets the class: CS6, CS7 and EF are control, CS3 to  */
+/*    CS5 with AF3x and AF4x are interactive, the others are bulk. The IP */
+/*    and TCP headers are read from the first buffer of the frame.        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    driver_req_ptr                        Driver request pointer        */
+/*    packet_ptr                            Pointer to Ethernet frame     */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*    tx_class                              Transmit class                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    ETH_BSP_Config                        Configure Ethernet            */
-/*    ETH_MACAddressConfig                  Setup MAC address             */
-/*    ETH_DMARxDescReceiveITConfig          Enable receive descriptors    */
-/*    nx_packet_allocate                    Allocate receive packet(s)    */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_driver_initialize                 Driver initialize processing  */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_driver_packet_send                Driver packet send processing */
 /*                                                                        */
 /**************************************************************************/
-static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
+static UINT _nx_driver_transmit_class_get(NX_PACKET *packet_ptr)
 {
 
-  /* Default to successful return.  */
-  driver_req_ptr -> nx_ip_driver_status =  NX_SUCCESS;
+  UCHAR           *ip_header_ptr;
+  UCHAR           *tcp_header_ptr;
+  ULONG           available;
+  ULONG           ip_header_length;
+  ULONG           ip_payload_length;
+  ULONG           tcp_header_length;
+  UINT            protocol;
+  UINT            dscp;
 
-  /* Setup indices.  */
-  nx_driver_information.nx_driver_information_receive_current_index = 0;
-  nx_driver_information.nx_driver_information_transmit_current_index = 0;
-  nx_driver_information.nx_driver_information_transmit_release_index = 0;
 
-  /* Clear the number of buffers in use counter.  */
-  nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use = 0;
+  ip_header_ptr = packet_ptr -> nx_packet_prepend_ptr + NX_DRIVER_ETHERNET_FRAME_SIZE;
+  available = (ULONG)(packet_ptr -> nx_packet_append_ptr - ip_header_ptr);
 
-  /* Make sure there are receive packets... otherwise, return an error.  */
-  if (nx_driver_information.nx_driver_information_packet_pool_ptr == NULL)
+#ifdef FEATURE_NX_IPV6
+  if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6)
   {
+    if (available < 40U)
+    {
+      return(NX_DRIVER_TX_CLASS_BULK);
+    }
 
-    /* There must be receive packets. If not, return an error!  */
-    return(NX_DRIVER_ERROR);
+    dscp = (UINT)((((ip_header_ptr[0] & 0x0FU) << 4) | (ip_header_ptr[1] >> 4)) >> 2);
+    protocol = ip_header_ptr[6];
+    ip_header_length = 40U;
+    ip_payload_length = ((ULONG)ip_header_ptr[4] << 8) | ip_header_ptr[5];
   }
+  else
+#endif /* FEATURE_NX_IPV6 */
+  {
+    if ((available < 20U) || ((ip_header_ptr[0] >> 4) != 4U))
+    {
+      return(NX_DRIVER_TX_CLASS_BULK);
+    }
 
-#ifdef NX_DRIVER_ETH_HW_IP_INIT
-  nx_eth_init();
-#endif /* NX_DRIVER_ETH_HW_IP_INIT */
+    dscp = (UINT)(ip_header_ptr[1] >> 2);
+    protocol = ip_header_ptr[9];
+    ip_header_length = (ULONG)(ip_header_ptr[0] & 0x0FU) << 2;
+    ip_payload_length = (((ULONG)ip_header_ptr[2] << 8) | ip_header_ptr[3]) - ip_header_length;
+  }
 
-  ETH_DMAConfigTypeDef dmaDefaultConf;
-  dmaDefaultConf.DMAArbitration = ETH_DMAARBITRATION_RX1_TX1;
-  dmaDefaultConf.AddressAlignedBeats = ENABLE;
-  dmaDefaultConf.BurstMode = ETH_BURSTLENGTH_FIXED;
-  dmaDefaultConf.TxDMABurstLength = ETH_TXDMABURSTLENGTH_32BEAT;
-  dmaDefaultConf.RxDMABurstLength = ETH_RXDMABURSTLENGTH_32BEAT;
-  dmaDefaultConf.FlushRxPacket = DISABLE;
-#ifndef STM32_ETH_HAL_LEGACY
-  dmaDefaultConf.PBLx8Mode = DISABLE;
-  dmaDefaultConf.RebuildINCRxBurst = DISABLE;
-  dmaDefaultConf.SecondPacketOperate = ENABLE;
-  dmaDefaultConf.TCPSegmentation = DISABLE;
-  dmaDefaultConf.MaximumSegmentSize = 536;
-#endif
-#ifdef STM32_ETH_HAL_LEGACY
-  dmaDefaultConf.DropTCPIPChecksumErrorFrame = ENABLE;
-  dmaDefaultConf.ReceiveStoreForward =  DISABLE;
-  dmaDefaultConf.TransmitStoreForward =  ENABLE;
-  dmaDefaultConf.TransmitThresholdControl =  ENABLE;
-  dmaDefaultConf.ForwardErrorFrames =  DISABLE;
-  dmaDefaultConf.ReceiveThresholdControl =  DISABLE;
-  dmaDefaultConf.SecondFrameOperate =  DISABLE;
-  dmaDefaultConf.EnhancedDescriptorFormat =  DISABLE;
-  dmaDefaultConf.DescriptorSkipLength =  DISABLE;
-#endif
-  /* enable OSF bit to enhance throughput */
-  HAL_ETH_SetDMAConfig(&eth_handle, &dmaDefaultConf);
+  /* A pure ACK, SYN or RST jumps the data segments queued.  */
+  if ((protocol == NX_PROTOCOL_TCP) && (available >= ip_header_length + 20U))
+  {
+    tcp_header_ptr = ip_header_ptr + ip_header_length;
+    tcp_header_length = (ULONG)(tcp_header_ptr[12] >> 4) << 2;
 
-  FilterConfig.PromiscuousMode = DISABLE;
-  FilterConfig.HashUnicast = DISABLE;
-  FilterConfig.HashMulticast = DISABLE;
-  FilterConfig.DestAddrInverseFiltering = DISABLE;
-  FilterConfig.PassAllMulticast = DISABLE;
-  FilterConfig.BroadcastFilter = ENABLE;
-  FilterConfig.SrcAddrInverseFiltering = DISABLE;
-  FilterConfig.SrcAddrFiltering = DISABLE;
-  FilterConfig.HachOrPerfectFilter = DISABLE;
-  FilterConfig.ReceiveAllMode = DISABLE;
-  FilterConfig.ControlPacketsFilter = 0x00;
+    if ((ip_payload_length <= tcp_header_length) && !(tcp_header_ptr[13] & 0x01U))
+    {
+      return(NX_DRIVER_TX_CLASS_CONTROL);
+    }
+  }
 
-  /* Set Tx packet config common parameters */
-  memset(&TxPacketCfg, 0, sizeof(ETH_TxPacketConfig));
-  TxPacketCfg.Attributes = ETH_TX_PACKETS_FEATURES_CSUM ;
-  TxPacketCfg.CRCPadCtrl = ETH_CRC_PAD_DISABLE;
+  /* CS6, CS7 and EF.  */
+  if ((dscp >= 48U) || (dscp == 46U))
+  {
+    return(NX_DRIVER_TX_CLASS_CONTROL);
+  }
 
-  /* Clear the number of buffers in use counter.  */
-  nx_driver_information.nx_driver_information_multicast_count = 0;
+  /* CS3 to CS5, AF3x and AF4x.  */
+  if ((dscp >= 24U) && (dscp <= 40U))
+  {
+    return(NX_DRIVER_TX_CLASS_INTERACTIVE);
+  }
 
-  /* Return success!  */
-  return(NX_SUCCESS);
+  return(NX_DRIVER_TX_CLASS_BULK);
 }
 
 
+#ifdef NX_DRIVER_ICMP_ECHO_FAST_REPLY
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_enable                                          */
-/*                                                            6.1         */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_icmp_echo_reply                                          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function turns a received ICMP echo request to the interface   */
+/*    address into the echo reply in place, and sends it back to the      */
+/*    MAC address it came from, without IP send, route or ARP             */
+/*    processing. Frames it does not take, any other frame, fragments,    */
+/*    requests with IP options, from a broadcast or multicast address, or */
+/*    whose checksums the MAC did not verify, are left to NetX.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ip_ptr                                Pointer to IP protocol block  */
+/*    packet_ptr                            Received IPv4 frame           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_TRUE                               Frame answered or released    */
+/*    NX_FALSE                              Frame left to NetX            */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_send       Send the reply                */
+/*    nx_packet_transmit_release            Release the reply             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_transfer_to_netx           Driver packet receive         */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_icmp_echo_reply(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
+{
+
+  NX_INTERFACE    *interface_ptr = nx_driver_information.nx_driver_information_interface;
+  UCHAR           *frame_ptr = packet_ptr -> nx_packet_prepend_ptr;
+  UCHAR           *ip_header_ptr = frame_ptr + NX_DRIVER_ETHERNET_FRAME_SIZE;
+  UCHAR           *icmp_header_ptr = ip_header_ptr + NX_DRIVER_IPV4_HEADER_SIZE;
+  ULONG           source_ip;
+  ULONG           destination_ip;
+  ULONG           total_length;
+  ULONG           checksum;
+  UINT            i;
+
+
+  /* Only answer requests whose IP and ICMP checksums the MAC verified.  */
+  if (!(interface_ptr -> nx_interface_capability_flag & NX_INTERFACE_CAPABILITY_ICMPV4_RX_CHECKSUM) ||
+      (packet_ptr -> nx_packet_interface_capability_flag & NX_INTERFACE_CAPABILITY_RX_CHECKSUM_BYPASS) ||
+      (nx_driver_information.nx_driver_information_state != NX_DRIVER_STATE_LINK_ENABLED))
+  {
+    return(NX_FALSE);
+  }
+
+  if (packet_ptr -> nx_packet_length < (NX_DRIVER_ETHERNET_FRAME_SIZE + NX_DRIVER_IPV4_HEADER_SIZE + NX_DRIVER_ICMP_HEADER_SIZE))
+  {
+    return(NX_FALSE);
+  }
+
+  /* An unfragmented echo request without IP options, from a unicast MAC address to ours.  */
+  if ((ip_header_ptr[0] != 0x45U) || (ip_header_ptr[9] != (UCHAR)(NX_IP_ICMP >> 16)) ||
+      (ip_header_ptr[6] & 0x3FU) || ip_header_ptr[7] ||
+      (icmp_header_ptr[0] != NX_ICMP_ECHO_REQUEST_TYPE) || icmp_header_ptr[1] ||
+      (frame_ptr[0] & 0x01U) || (frame_ptr[6] & 0x01U))
+  {
+    return(NX_FALSE);
+  }
+
+  total_length = ((ULONG)ip_header_ptr[2] << 8) | ip_header_ptr[3];
+  if ((total_length < (NX_DRIVER_IPV4_HEADER_SIZE + NX_DRIVER_ICMP_HEADER_SIZE)) ||
+      (total_length > (packet_ptr -> nx_packet_length - NX_DRIVER_ETHERNET_FRAME_SIZE)))
+  {
+    return(NX_FALSE);
+  }
+
+  source_ip = ((ULONG)ip_header_ptr[12] << 24) | ((ULONG)ip_header_ptr[13] << 16) |
+              ((ULONG)ip_header_ptr[14] << 8) | ip_header_ptr[15];
+  destination_ip = ((ULONG)ip_header_ptr[16] << 24) | ((ULONG)ip_header_ptr[17] << 16) |
+                   ((ULONG)ip_header_ptr[18] << 8) | ip_header_ptr[19];
+
+  /* To the address of the interface, from a unicast address, as NX_ENABLE_ICMP_ADDRESS_CHECK wants.  */
+  if ((destination_ip == 0U) || (destination_ip != interface_ptr -> nx_interface_ip_address) ||
+      (source_ip == 0U) || ((source_ip & NX_IP_CLASS_D_MASK) >= NX_IP_CLASS_D_TYPE) ||
+      (((source_ip & interface_ptr -> nx_interface_ip_network_mask) == interface_ptr -> nx_interface_ip_network) &&
+       ((source_ip | interface_ptr -> nx_interface_ip_network_mask) == NX_IP_LIMITED_BROADCAST)))
+  {
+    return(NX_FALSE);
+  }
+
+#ifndef NX_DISABLE_ICMP_INFO
+  ip_ptr -> nx_ip_pings_received++;
+#endif
+
+  /* Back to the sender, from our MAC address.  */
+  memcpy(frame_ptr, frame_ptr + 6, 6); /* Use case of memcpy is verified. */
+  frame_ptr[6] = (UCHAR)(interface_ptr -> nx_interface_physical_address_msw >> 8);
+  frame_ptr[7] = (UCHAR)interface_ptr -> nx_interface_physical_address_msw;
+  frame_ptr[8] = (UCHAR)(interface_ptr -> nx_interface_physical_address_lsw >> 24);
+  frame_ptr[9] = (UCHAR)(interface_ptr -> nx_interface_physical_address_lsw >> 16);
+  frame_ptr[10] = (UCHAR)(interface_ptr -> nx_interface_physical_address_lsw >> 8);
+  frame_ptr[11] = (UCHAR)interface_ptr -> nx_interface_physical_address_lsw;
+
+  /* The IP header NetX would send the reply with, then its checksum.  */
+  ip_header_ptr[1] = (UCHAR)(NX_IP_NORMAL >> 16);
+  ip_header_ptr[4] = (UCHAR)(ip_ptr -> nx_ip_packet_id >> 8);
+  ip_header_ptr[5] = (UCHAR)ip_ptr -> nx_ip_packet_id;
+  ip_ptr -> nx_ip_packet_id++;
+  ip_header_ptr[6] = 0U;
+  ip_header_ptr[8] = (UCHAR)NX_IP_TIME_TO_LIVE;
+  ip_header_ptr[10] = 0U;
+  ip_header_ptr[11] = 0U;
+  memcpy(ip_header_ptr + 16, ip_header_ptr + 12, 4); /* Use case of memcpy is verified. */
+  ip_header_ptr[12] = (UCHAR)(destination_ip >> 24);
+  ip_header_ptr[13] = (UCHAR)(destination_ip >> 16);
+  ip_header_ptr[14] = (UCHAR)(destination_ip >> 8);
+  ip_header_ptr[15] = (UCHAR)destination_ip;
+
+  checksum = 0U;
+  for (i = 0U; i < NX_DRIVER_IPV4_HEADER_SIZE; i += 2U)
+  {
+    checksum += ((ULONG)ip_header_ptr[i] << 8) | ip_header_ptr[i + 1U];
+  }
+  checksum = (checksum >> 16) + (checksum & 0xFFFFU);
+  checksum = (checksum >> 16) + (checksum & 0xFFFFU);
+  checksum = ~checksum & 0xFFFFU;
+  ip_header_ptr[10] = (UCHAR)(checksum >> 8);
+  ip_header_ptr[11] = (UCHAR)checksum;
+
+  /* Echo reply, the ICMP checksum updated for the type only, RFC 1624 Eqn.3:
+     HC' = ~(~HC + ~m + m') with m = echo request << 8 and m' = 0.  */
+  icmp_header_ptr[0] = NX_ICMP_ECHO_REPLY_TYPE;
+  checksum = ((ULONG)icmp_header_ptr[2] << 8) | icmp_header_ptr[3];
+  checksum = ((~checksum) & 0xFFFFU) + ((~((ULONG)NX_ICMP_ECHO_REQUEST_TYPE << 8)) & 0xFFFFU);
+  checksum = (checksum >> 16) + (checksum & 0xFFFFU);
+  checksum = (checksum >> 16) + (checksum & 0xFFFFU);
+  checksum = ~checksum & 0xFFFFU;
+  icmp_header_ptr[2] = (UCHAR)(checksum >> 8);
+  icmp_header_ptr[3] = (UCHAR)checksum;
+
+  /* Drop the Ethernet padding, the checksums are complete.  */
+  packet_ptr -> nx_packet_length = NX_DRIVER_ETHERNET_FRAME_SIZE + total_length;
+  packet_ptr -> nx_packet_append_ptr = frame_ptr + packet_ptr -> nx_packet_length;
+  packet_ptr -> nx_packet_interface_capability_flag = 0U;
+
+#ifndef NX_DISABLE_ICMP_INFO
+  ip_ptr -> nx_ip_pings_responded_to++;
+#endif
+
+  if (_nx_driver_hardware_packet_send(packet_ptr, NX_DRIVER_TX_CLASS_INTERACTIVE) != NX_SUCCESS)
+  {
+    nx_packet_transmit_release(packet_ptr);
+  }
+
+  return(NX_TRUE);
+}
+#endif /* NX_DRIVER_ICMP_ECHO_FAST_REPLY */
+
+
+/****** DRIVER SPECIFIC ****** Start of part/vendor specific internal driver functions.  */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_initialize                                      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes hardware-specific initialization.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver request pointer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    ETH_BSP_Config                        Configure Ethernet            */
+/*    ETH_MACAddressConfig                  Setup MAC address             */
+/*    ETH_DMARxDescReceiveITConfig          Enable receive descriptors    */
+/*    nx_packet_allocate                    Allocate receive packet(s)    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_initialize                 Driver initialize processing  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  UINT            i;
+
+
+  /* Default to successful return.  */
+  driver_req_ptr -> nx_ip_driver_status =  NX_SUCCESS;
+
+  /* Setup indices.  */
+  nx_driver_information.nx_driver_information_receive_current_index = 0;
+  nx_driver_information.nx_driver_information_receive_refill_index = 0;
+  nx_driver_information.nx_driver_information_transmit_current_index = 0;
+  nx_driver_information.nx_driver_information_transmit_release_index = 0;
+
+  /* Clear the number of buffers in use counter.  */
+  nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use = 0;
+
+  /* Make sure there are receive packets... otherwise, return an error.  */
+  if (nx_driver_information.nx_driver_information_packet_pool_ptr == NULL)
+  {
+
+    /* There must be receive packets. If not, return an error!  */
+    return(NX_DRIVER_ERROR);
+  }
+
+#ifdef NX_DRIVER_ETH_HW_IP_INIT
+  nx_eth_init();
+#endif /* NX_DRIVER_ETH_HW_IP_INIT */
+
+  ETH_DMAConfigTypeDef dmaDefaultConf;
+  dmaDefaultConf.DMAArbitration = ETH_DMAARBITRATION_RX1_TX1;
+  dmaDefaultConf.AddressAlignedBeats = ENABLE;
+  dmaDefaultConf.BurstMode = ETH_BURSTLENGTH_FIXED;
+  dmaDefaultConf.TxDMABurstLength = ETH_TXDMABURSTLENGTH_32BEAT;
+  dmaDefaultConf.RxDMABurstLength = ETH_RXDMABURSTLENGTH_32BEAT;
+  dmaDefaultConf.FlushRxPacket = DISABLE;
+#ifndef STM32_ETH_HAL_LEGACY
+  dmaDefaultConf.PBLx8Mode = DISABLE;
+  dmaDefaultConf.RebuildINCRxBurst = DISABLE;
+  dmaDefaultConf.SecondPacketOperate = ENABLE;
+  dmaDefaultConf.TCPSegmentation = DISABLE;
+  dmaDefaultConf.MaximumSegmentSize = 536;
+#endif
+#ifdef STM32_ETH_HAL_LEGACY
+  dmaDefaultConf.DropTCPIPChecksumErrorFrame = ENABLE;
+  /* A whole frame must be in the RX FIFO for frames failing the checksum offload
+     verification to be dropped before being handed to the driver.  */
+  dmaDefaultConf.ReceiveStoreForward =  ENABLE;
+  dmaDefaultConf.TransmitStoreForward =  ENABLE;
+  dmaDefaultConf.TransmitThresholdControl =  ENABLE;
+  dmaDefaultConf.ForwardErrorFrames =  DISABLE;
+  dmaDefaultConf.ReceiveThresholdControl =  DISABLE;
+  dmaDefaultConf.SecondFrameOperate =  DISABLE;
+#ifdef NX_DRIVER_ENABLE_PTP
+  /* The time stamps are written back to the words 6 and 7 of the enhanced descriptors.  */
+  dmaDefaultConf.EnhancedDescriptorFormat =  ENABLE;
+#else
+  dmaDefaultConf.EnhancedDescriptorFormat =  DISABLE;
+#endif
+  dmaDefaultConf.DescriptorSkipLength =  DISABLE;
+#endif
+  /* enable OSF bit to enhance throughput */
+  HAL_ETH_SetDMAConfig(&eth_handle, &dmaDefaultConf);
+
+  FilterConfig.PromiscuousMode = DISABLE;
+  FilterConfig.HashUnicast = DISABLE;
+  FilterConfig.HashMulticast = DISABLE;
+  FilterConfig.DestAddrInverseFiltering = DISABLE;
+  FilterConfig.PassAllMulticast = DISABLE;
+  FilterConfig.BroadcastFilter = ENABLE;
+  FilterConfig.SrcAddrInverseFiltering = DISABLE;
+  FilterConfig.SrcAddrFiltering = DISABLE;
+  FilterConfig.HachOrPerfectFilter = DISABLE;
+  FilterConfig.ReceiveAllMode = DISABLE;
+  FilterConfig.ControlPacketsFilter = 0x00;
+
+  /* No frame is waiting for transmit descriptors.  */
+  for (i = 0; i < NX_DRIVER_TX_CLASSES; i++)
+  {
+    nx_driver_information.nx_driver_information_transmit_queue_head[i] = NX_NULL;
+    nx_driver_information.nx_driver_information_transmit_queue_tail[i] = NX_NULL;
+    nx_driver_information.nx_driver_information_transmit_deficit[i] = 0;
+  }
+  nx_driver_information.nx_driver_information_transmit_round_class = NX_DRIVER_TX_CLASS_INTERACTIVE;
+
+  /* Clear the number of buffers in use counter.  */
+  nx_driver_information.nx_driver_information_multicast_count = 0;
+  nx_driver_information.nx_driver_information_multicast_overflow = 0;
+
+#if NX_DRIVER_RX_MITIGATION_TICKS > 0
+  /* Create the one-shot timer for the delayed RX poll.  */
+  if (tx_timer_create(&nx_driver_information.nx_driver_information_rx_mitigation_timer, "ETH RX mitigation",
+                      _nx_driver_hardware_receive_poll_timeout, 0,
+                      NX_DRIVER_RX_MITIGATION_TICKS, 0, TX_NO_ACTIVATE) != TX_SUCCESS)
+  {
+    return(NX_DRIVER_ERROR);
+  }
+#endif
+
+  /* Create the one-shot timer retrying to re-arm RX descriptors left without a buffer.  */
+  if (tx_timer_create(&nx_driver_information.nx_driver_information_rx_refill_timer, "ETH RX refill",
+                      _nx_driver_hardware_receive_poll_timeout, 0,
+                      NX_DRIVER_RX_REFILL_TICKS, 0, TX_NO_ACTIVATE) != TX_SUCCESS)
+  {
+    return(NX_DRIVER_ERROR);
+  }
+
+#ifdef NX_DRIVER_ENABLE_PTP
+  _nx_driver_hardware_ptp_initialize();
+#endif
+
+  /* Return success!  */
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_enable                                          */
+/*                                                            6.1         */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
@@ -1486,7 +1950,9 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    ETH_Start                             Start Ethernet operation      */
+/*    _nx_driver_hardware_receive_ring_reset                              */
+/*                                          Attach packets to the RX ring */
+/*    HAL_ETH_Start_IT                      Start Ethernet operation      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -1504,6 +1970,9 @@ static UINT  _nx_driver_hardware_initialize(NX_IP_DRIVER *driver_req_ptr)
 static UINT  _nx_driver_hardware_enable(NX_IP_DRIVER *driver_req_ptr)
 {
 
+  /* The RX ring must be armed before the DMA reception starts.  */
+  _nx_driver_hardware_receive_ring_reset();
+
   /* Call STM32 library to start Ethernet operation.  */
   HAL_ETH_Start_IT(&eth_handle);
 
@@ -1558,401 +2027,2241 @@ static UINT  _nx_driver_hardware_enable(NX_IP_DRIVER *driver_req_ptr)
 static UINT  _nx_driver_hardware_disable(NX_IP_DRIVER *driver_req_ptr)
 {
 
-  HAL_ETH_Stop(&eth_handle);
+  NX_PACKET       *packet_ptr;
+  UINT            tx_class;
+
+
+  HAL_ETH_Stop(&eth_handle);
+
+#if NX_DRIVER_RX_MITIGATION_TICKS > 0
+  /* No RX poll is needed while the link is down.  */
+  tx_timer_deactivate(&nx_driver_information.nx_driver_information_rx_mitigation_timer);
+#endif
+  tx_timer_deactivate(&nx_driver_information.nx_driver_information_rx_refill_timer);
+
+  /* Release the frames still waiting for transmit descriptors.  */
+  for (tx_class = 0; tx_class < NX_DRIVER_TX_CLASSES; tx_class++)
+  {
+    while (nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] != NX_NULL)
+    {
+      packet_ptr = nx_driver_information.nx_driver_information_transmit_queue_head[tx_class];
+      nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] = packet_ptr -> nx_packet_queue_next;
+
+      NX_DRIVER_ETHERNET_HEADER_REMOVE(packet_ptr);
+      nx_packet_transmit_release(packet_ptr);
+    }
+    nx_driver_information.nx_driver_information_transmit_queue_tail[tx_class] = NX_NULL;
+    nx_driver_information.nx_driver_information_transmit_deficit[tx_class] = 0;
+  }
+
+  /* Return success!  */
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_send                                     */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes hardware-specific packet send requests.     */
+/*    The frame is queued in its transmit class, then the queues are      */
+/*    scheduled onto the ring.                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Pointer to packet to send     */
+/*    tx_class                              Transmit class of the frame   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_capture                    Capture the frame             */
+/*    _nx_driver_hardware_packet_linearize  Coalesce over-long chains     */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_packet_send                Driver packet send processing */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+
+static UINT  _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr, UINT tx_class)
+{
+
+  TRACE_SWO_EVENT(TRACE_SWO_EVENT_ETH_SEND, packet_ptr, packet_ptr -> nx_packet_length, 0, 0)
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+  if (nx_driver_information.nx_driver_information_capture_enabled)
+  {
+    _nx_driver_capture(packet_ptr);
+  }
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+
+  /* A chain with more buffers than its class may hold can never be mapped,
+     coalesce it into a single buffer first.  */
+  if (_nx_driver_hardware_packet_segments_get(packet_ptr) >
+      ((tx_class == NX_DRIVER_TX_CLASS_CONTROL) ? NX_DRIVER_TX_DESCRIPTORS : NX_DRIVER_TX_SHARED_DESCRIPTORS))
+  {
+    packet_ptr = _nx_driver_hardware_packet_linearize(packet_ptr);
+
+    if (packet_ptr == NX_NULL)
+    {
+      return(NX_DRIVER_ERROR);
+    }
+  }
+
+  /* Queue the frame behind those of its class, the scheduler maps it onto the
+     ring at once if its turn has come and there is room.  */
+  packet_ptr -> nx_packet_queue_next = NX_NULL;
+  if (nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] == NX_NULL)
+  {
+    nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] = packet_ptr;
+  }
+  else
+  {
+    nx_driver_information.nx_driver_information_transmit_queue_tail[tx_class] -> nx_packet_queue_next = packet_ptr;
+  }
+  nx_driver_information.nx_driver_information_transmit_queue_tail[tx_class] = packet_ptr;
+
+  _nx_driver_hardware_transmit_schedule();
+
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_class_next                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the class of the next frame to map onto the   */
+/*    ring. A control frame is always next. Otherwise, the class whose    */
+/*    round it is goes on while its deficit covers its first frame, then  */
+/*    the round passes to the next class with frames, whose deficit grows */
+/*    by its quantum. A class left empty loses its deficit.               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    tx_class                              Class of the next frame, or   */
+/*                                            NX_DRIVER_TX_CLASSES if no  */
+/*                                            frame is queued             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_transmit_class_next(VOID)
+{
+
+  static const ULONG  quantum[NX_DRIVER_TX_CLASSES] =
+  {
+    0U, NX_DRIVER_TX_QUANTUM_INTERACTIVE, NX_DRIVER_TX_QUANTUM_BULK
+  };
+  NX_PACKET           **queue_head = nx_driver_information.nx_driver_information_transmit_queue_head;
+  ULONG               *deficit = nx_driver_information.nx_driver_information_transmit_deficit;
+  UINT                tx_class;
+
+
+  if (queue_head[NX_DRIVER_TX_CLASS_CONTROL] != NX_NULL)
+  {
+    return(NX_DRIVER_TX_CLASS_CONTROL);
+  }
+
+  if ((queue_head[NX_DRIVER_TX_CLASS_INTERACTIVE] == NX_NULL) && (queue_head[NX_DRIVER_TX_CLASS_BULK] == NX_NULL))
+  {
+    return(NX_DRIVER_TX_CLASSES);
+  }
+
+  /* A quantum holds a full frame, the loop ends within a turn of the classes.  */
+  tx_class = nx_driver_information.nx_driver_information_transmit_round_class;
+  while ((queue_head[tx_class] == NX_NULL) || (deficit[tx_class] < queue_head[tx_class] -> nx_packet_length))
+  {
+    if (queue_head[tx_class] == NX_NULL)
+    {
+      deficit[tx_class] = 0;
+    }
+
+    tx_class = (tx_class + 1 < NX_DRIVER_TX_CLASSES) ? (tx_class + 1) : NX_DRIVER_TX_CLASS_INTERACTIVE;
+
+    if (queue_head[tx_class] != NX_NULL)
+    {
+      deficit[tx_class] += quantum[tx_class];
+    }
+  }
+
+  nx_driver_information.nx_driver_information_transmit_round_class = tx_class;
+
+  return(tx_class);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_schedule                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function maps the queued frames onto the ring in the order of  */
+/*    their classes, as long as there are free descriptors. The           */
+/*    interactive and bulk frames take no more than                       */
+/*    NX_DRIVER_TX_SHARED_DESCRIPTORS, so that a control frame finds room */
+/*    behind at most that many descriptors.                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_class_next                             */
+/*                                          Pick the next class           */
+/*    _nx_driver_hardware_packet_segments_get                             */
+/*                                          Count the frame buffers       */
+/*    _nx_driver_hardware_transmit_release  Reclaim sent descriptors      */
+/*    _nx_driver_hardware_transmit_descriptors_set                        */
+/*                                          Map the chain onto the ring   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_send       Driver packet send processing */
+/*    _nx_driver_hardware_packet_transmitted                              */
+/*                                          Transmit complete processing  */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_transmit_schedule(VOID)
+{
+
+  NX_PACKET       *packet_ptr;
+  UINT            tx_class;
+
+
+  while ((tx_class = _nx_driver_hardware_transmit_class_next()) < NX_DRIVER_TX_CLASSES)
+  {
+    packet_ptr = nx_driver_information.nx_driver_information_transmit_queue_head[tx_class];
+
+    if ((tx_class != NX_DRIVER_TX_CLASS_CONTROL) &&
+        (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use +
+         _nx_driver_hardware_packet_segments_get(packet_ptr) > NX_DRIVER_TX_SHARED_DESCRIPTORS))
+    {
+      _nx_driver_hardware_transmit_release();
+
+      if (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use +
+          _nx_driver_hardware_packet_segments_get(packet_ptr) > NX_DRIVER_TX_SHARED_DESCRIPTORS)
+      {
+
+        /* Wait for the next transmit complete event.  */
+        break;
+      }
+    }
+
+    if (_nx_driver_hardware_transmit_descriptors_set(packet_ptr) != NX_SUCCESS)
+    {
+
+      /* Still not enough room, wait for the next transmit complete event.  */
+      break;
+    }
+
+    nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] = packet_ptr -> nx_packet_queue_next;
+    if (nx_driver_information.nx_driver_information_transmit_queue_head[tx_class] == NX_NULL)
+    {
+      nx_driver_information.nx_driver_information_transmit_queue_tail[tx_class] = NX_NULL;
+    }
+
+    if (tx_class != NX_DRIVER_TX_CLASS_CONTROL)
+    {
+      nx_driver_information.nx_driver_information_transmit_deficit[tx_class] -= packet_ptr -> nx_packet_length;
+    }
+  }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_descriptors_set                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function maps each buffer of the packet chain directly onto    */
+/*    one DMA transmit descriptor of the driver-owned ring and hands the  */
+/*    frame to the DMA.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Pointer to packet to send     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_release  Reclaim sent descriptors      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_transmit_descriptors_set(NX_PACKET *packet_ptr)
+{
+
+  ETH_DMADescTypeDef  *dma_tx_desc;
+  NX_PACKET           *pktIdx;
+  ULONG               checksum_ctrl;
+  ULONG               control;
+  UINT                segments;
+  UINT                index;
+  UINT                first_index;
+  UINT                last_index;
+
+
+  segments = _nx_driver_hardware_packet_segments_get(packet_ptr);
+
+  /* Make sure there are enough free descriptors, reclaim the sent ones if needed.  */
+  if (segments > (NX_DRIVER_TX_DESCRIPTORS - nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use))
+  {
+    _nx_driver_hardware_transmit_release();
+
+    if (segments > (NX_DRIVER_TX_DESCRIPTORS - nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use))
+    {
+      return(NX_DRIVER_ERROR);
+    }
+  }
+
+  checksum_ctrl = ETH_CHECKSUM_DISABLE;
+
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+  if (packet_ptr -> nx_packet_interface_capability_flag & (NX_INTERFACE_CAPABILITY_TCP_TX_CHECKSUM |
+                                                           NX_INTERFACE_CAPABILITY_UDP_TX_CHECKSUM |
+                                                             NX_INTERFACE_CAPABILITY_ICMPV4_TX_CHECKSUM |
+                                                               NX_INTERFACE_CAPABILITY_ICMPV6_TX_CHECKSUM))
+  {
+    checksum_ctrl = ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC;
+  }
+  else if (packet_ptr -> nx_packet_interface_capability_flag & NX_INTERFACE_CAPABILITY_IPV4_TX_CHECKSUM)
+  {
+    checksum_ctrl = ETH_CHECKSUM_IPHDR_INSERT;
+  }
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+
+  first_index = nx_driver_information.nx_driver_information_transmit_current_index;
+  last_index = first_index;
+  index = first_index;
+
+  for (pktIdx = packet_ptr; pktIdx != NX_NULL; pktIdx = pktIdx -> nx_packet_next)
+  {
+    dma_tx_desc = &DMATxDscrTab[index];
+
+#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr((uint32_t*)(pktIdx -> nx_packet_data_start), pktIdx -> nx_packet_data_end - pktIdx -> nx_packet_data_start);
+#endif
+
+    dma_tx_desc -> DESC2 = (uint32_t)pktIdx -> nx_packet_prepend_ptr;
+    dma_tx_desc -> DESC1 = (uint32_t)(pktIdx -> nx_packet_append_ptr - pktIdx -> nx_packet_prepend_ptr) & ETH_DMATXDESC_TBS1;
+
+    control = ETH_DMATXDESC_TCH | checksum_ctrl;
+
+    if (index == first_index)
+    {
+      control |= ETH_DMATXDESC_FS;
+#ifdef NX_DRIVER_ENABLE_PTP
+      /* The time of transmission is written back to the last descriptor.  */
+      control |= ETH_DMATXDESC_TTSE;
+#endif
+    }
+    else
+    {
+      /* The DMA cannot reach this descriptor before the first one is handed over.  */
+      control |= ETH_DMATXDESC_OWN;
+    }
+
+    if (pktIdx -> nx_packet_next == NX_NULL)
+    {
+      control |= ETH_DMATXDESC_LS | ETH_DMATXDESC_IC;
+    }
+
+    dma_tx_desc -> DESC0 = control;
+
+    last_index = index;
+    index = (index + 1) % NX_DRIVER_TX_DESCRIPTORS;
+  }
+
+  /* The packet is released once its last descriptor has been sent.  */
+  nx_driver_information.nx_driver_information_transmit_packets[last_index] = packet_ptr;
+  nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use += segments;
+  nx_driver_information.nx_driver_information_transmit_current_index = index;
+
+  /* Ensure the descriptors are written before the first one is given to the DMA.  */
+  __DMB();
+  DMATxDscrTab[first_index].DESC0 |= ETH_DMATXDESC_OWN;
+  __DSB();
+
+  /* Resume the DMA if it suspended on an empty ring.  */
+  if (((eth_handle.Instance) -> DMASR & ETH_DMASR_TBUS) != (uint32_t)RESET)
+  {
+    (eth_handle.Instance) -> DMASR = ETH_DMASR_TBUS;
+    (eth_handle.Instance) -> DMATPDR = 0U;
+  }
+
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_segments_get                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the number of buffers of a packet chain,      */
+/*    that is the number of transmit descriptors it requires.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Pointer to packet             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    segments                              Number of buffers             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_send       Driver packet send processing */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*    _nx_driver_hardware_transmit_descriptors_set                        */
+/*                                          Transmit descriptors setup    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_packet_segments_get(NX_PACKET *packet_ptr)
+{
+
+  UINT            segments = 0;
+
+
+  while (packet_ptr != NX_NULL)
+  {
+    segments++;
+    packet_ptr = packet_ptr -> nx_packet_next;
+  }
+
+  return(segments);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_linearize                                */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies a packet chain that does not fit in the        */
+/*    transmit ring into a single buffer and releases the original chain. */
+/*    The original chain is left untouched on failure.                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Pointer to packet chain       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    linear_packet_ptr                     Single buffer packet, or      */
+/*                                            NX_NULL on failure          */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_packet_allocate                    Allocate the linear packet    */
+/*    nx_packet_data_retrieve               Copy the chain data           */
+/*    nx_packet_transmit_release            Release the original chain    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_send       Driver packet send processing */
+/*                                                                        */
+/**************************************************************************/
+static NX_PACKET  *_nx_driver_hardware_packet_linearize(NX_PACKET *packet_ptr)
+{
+
+  NX_PACKET       *linear_packet_ptr;
+  ULONG           bytes_copied;
+
+
+  /* Take the copy from the default pool, the RX packet pool is kept for the RX descriptors.  */
+  if (nx_packet_allocate(nx_driver_information.nx_driver_information_ip_ptr -> nx_ip_default_packet_pool, &linear_packet_ptr,
+                         NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
+  {
+    return(NX_NULL);
+  }
+
+  /* Keep the same 2 bytes offset as the original frame so that the IP header stays aligned.  */
+  linear_packet_ptr -> nx_packet_prepend_ptr += 2;
+
+  if ((ULONG)(linear_packet_ptr -> nx_packet_data_end - linear_packet_ptr -> nx_packet_prepend_ptr) < packet_ptr -> nx_packet_length)
+  {
+    nx_packet_release(linear_packet_ptr);
+    return(NX_NULL);
+  }
+
+  nx_packet_data_retrieve(packet_ptr, linear_packet_ptr -> nx_packet_prepend_ptr, &bytes_copied);
+
+  linear_packet_ptr -> nx_packet_append_ptr = linear_packet_ptr -> nx_packet_prepend_ptr + bytes_copied;
+  linear_packet_ptr -> nx_packet_length = bytes_copied;
+  linear_packet_ptr -> nx_packet_ip_version = packet_ptr -> nx_packet_ip_version;
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+  linear_packet_ptr -> nx_packet_interface_capability_flag = packet_ptr -> nx_packet_interface_capability_flag;
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+
+  /* The original chain is no longer needed by the driver.  */
+  NX_DRIVER_ETHERNET_HEADER_REMOVE(packet_ptr);
+  nx_packet_transmit_release(packet_ptr);
+
+  return(linear_packet_ptr);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_join                                  */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes hardware-specific multicast join requests.  */
+/*    The group is added to the table the MAC address filter is built     */
+/*    from. When the table is full, all multicast frames pass the filter  */
+/*    until the group is left.                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver request pointer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_filter_set                            */
+/*                                          Program the address filter    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_multicast_join             Driver multicast join         */
+/*                                            processing                  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_multicast_join(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  NX_DRIVER_MULTICAST_GROUP  *group_ptr;
+  NX_DRIVER_MULTICAST_GROUP  *free_ptr = NX_NULL;
+  UINT                        i;
+
+
+  /* Increase the multicast count.  */
+  nx_driver_information.nx_driver_information_multicast_count++;
+
+  for (i = 0; i < NX_DRIVER_MULTICAST_GROUPS; i++)
+  {
+    group_ptr = &nx_driver_information.nx_driver_information_multicast_groups[i];
+
+    if (group_ptr -> nx_driver_multicast_group_joins == 0)
+    {
+      if (free_ptr == NX_NULL)
+      {
+        free_ptr = group_ptr;
+      }
+    }
+    else if ((group_ptr -> nx_driver_multicast_group_msw == driver_req_ptr -> nx_ip_driver_physical_address_msw) &&
+             (group_ptr -> nx_driver_multicast_group_lsw == driver_req_ptr -> nx_ip_driver_physical_address_lsw))
+    {
+
+      /* Already in the filter.  */
+      group_ptr -> nx_driver_multicast_group_joins++;
+      return(NX_SUCCESS);
+    }
+  }
+
+  if (free_ptr != NX_NULL)
+  {
+    free_ptr -> nx_driver_multicast_group_msw = driver_req_ptr -> nx_ip_driver_physical_address_msw;
+    free_ptr -> nx_driver_multicast_group_lsw = driver_req_ptr -> nx_ip_driver_physical_address_lsw;
+    free_ptr -> nx_driver_multicast_group_joins = 1;
+  }
+  else
+  {
+
+    /* No more room in the table, pass all multicast frames.  */
+    nx_driver_information.nx_driver_information_multicast_overflow++;
+  }
+
+  _nx_driver_hardware_multicast_filter_set();
+
+  /* Return success.  */
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_leave                                 */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes hardware-specific multicast leave requests. */
+/*    The group is removed from the MAC address filter after its last     */
+/*    join is left.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver request pointer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]*/
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_filter_set                            */
+/*                                          Program the address filter    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_multicast_leave            Driver multicast leave        */
+/*                                            processing                  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  NX_DRIVER_MULTICAST_GROUP  *group_ptr;
+  UINT                        i;
+
+
+  /* Decrease the multicast count.  */
+  nx_driver_information.nx_driver_information_multicast_count--;
+
+  for (i = 0; i < NX_DRIVER_MULTICAST_GROUPS; i++)
+  {
+    group_ptr = &nx_driver_information.nx_driver_information_multicast_groups[i];
+
+    if ((group_ptr -> nx_driver_multicast_group_joins != 0) &&
+        (group_ptr -> nx_driver_multicast_group_msw == driver_req_ptr -> nx_ip_driver_physical_address_msw) &&
+        (group_ptr -> nx_driver_multicast_group_lsw == driver_req_ptr -> nx_ip_driver_physical_address_lsw))
+    {
+      group_ptr -> nx_driver_multicast_group_joins--;
+      if (group_ptr -> nx_driver_multicast_group_joins == 0)
+      {
+        _nx_driver_hardware_multicast_filter_set();
+      }
+
+      /* Return success.  */
+      return(NX_SUCCESS);
+    }
+  }
+
+  /* The group was one of those that did not fit the table.  */
+  if (nx_driver_information.nx_driver_information_multicast_overflow != 0)
+  {
+    nx_driver_information.nx_driver_information_multicast_overflow--;
+    if (nx_driver_information.nx_driver_information_multicast_overflow == 0)
+    {
+      _nx_driver_hardware_multicast_filter_set();
+    }
+  }
+
+  /* Return success.  */
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_filter_set                            */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function programs the MAC address filter from the joined       */
+/*    multicast groups. The first groups are matched exactly by the MAC   */
+/*    address registers 1 to 3, the next ones set their bit of the hash   */
+/*    table, which passes the other groups sharing the bit as well. The   */
+/*    unicast frames are still matched against the station address only. */
+/*    All multicast frames pass while joined groups did not fit the table.*/
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_hash    Hash table bit of a group     */
+/*    HAL_ETH_SetHashTable                  Write the hash table          */
+/*    HAL_ETH_SetMACFilterConfig            Write the filter mode         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_join    Multicast join processing     */
+/*    _nx_driver_hardware_multicast_leave   Multicast leave processing    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_multicast_filter_set(VOID)
+{
+
+  NX_DRIVER_MULTICAST_GROUP  *group_ptr;
+  __IO uint32_t              *address_ptr;
+  uint32_t                    hash_table[2] = {0U, 0U};
+  UINT                        slot = 0;
+  UINT                        bit;
+  UINT                        i;
+
+
+  for (i = 0; i < NX_DRIVER_MULTICAST_GROUPS; i++)
+  {
+    group_ptr = &nx_driver_information.nx_driver_information_multicast_groups[i];
+
+    if (group_ptr -> nx_driver_multicast_group_joins == 0)
+    {
+      continue;
+    }
+
+    if (slot < NX_DRIVER_MULTICAST_PERFECT_SLOTS)
+    {
+
+      /* The registers hold the first byte on the wire in the lowest bits, the high
+         register enables the destination address match.  */
+      address_ptr = &(eth_handle.Instance) -> MACA1HR + (slot * 2U);
+      address_ptr[0] = ETH_MACA1HR_AE |
+                       ((group_ptr -> nx_driver_multicast_group_lsw & 0xFFU) << 8) |
+                       ((group_ptr -> nx_driver_multicast_group_lsw >> 8) & 0xFFU);
+      address_ptr[1] = ((group_ptr -> nx_driver_multicast_group_lsw & 0xFF0000U) << 8) |
+                       ((group_ptr -> nx_driver_multicast_group_lsw >> 8) & 0xFF0000U) |
+                       ((group_ptr -> nx_driver_multicast_group_msw & 0xFFU) << 8) |
+                       ((group_ptr -> nx_driver_multicast_group_msw >> 8) & 0xFFU);
+      slot++;
+    }
+    else
+    {
+      bit = _nx_driver_hardware_multicast_hash(group_ptr -> nx_driver_multicast_group_msw,
+                                               group_ptr -> nx_driver_multicast_group_lsw);
+
+      /* Bits 32 to 63 are in the high register, given first.  */
+      hash_table[(bit < 32U) ? 1 : 0] |= 1UL << (bit & 31U);
+    }
+  }
+
+  /* Disable the registers left unused.  */
+  for (; slot < NX_DRIVER_MULTICAST_PERFECT_SLOTS; slot++)
+  {
+    address_ptr = &(eth_handle.Instance) -> MACA1HR + (slot * 2U);
+    address_ptr[0] = 0U;
+  }
+
+  HAL_ETH_SetHashTable(&eth_handle, hash_table);
+
+  /* A multicast frame passes when it matches a MAC address register or, once groups
+     are hashed, its hash table bit.  */
+  FilterConfig.HashMulticast = ((hash_table[0] | hash_table[1]) != 0U) ? ENABLE : DISABLE;
+  FilterConfig.HachOrPerfectFilter = FilterConfig.HashMulticast;
+  FilterConfig.PassAllMulticast = (nx_driver_information.nx_driver_information_multicast_overflow != 0) ? ENABLE : DISABLE;
+  HAL_ETH_SetMACFilterConfig(&eth_handle, &FilterConfig);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_hash                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the hash table bit of a MAC address: the     */
+/*    upper 6 bits of the bit reversed complement of the Ethernet CRC-32  */
+/*    of the address, as computed by the MAC on the destination address.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    msw                                   Address bytes 0 and 1         */
+/*    lsw                                   Address bytes 2 to 5          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    bit                                   Hash table bit, 0 to 63       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_multicast_filter_set                            */
+/*                                          Program the address filter    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_multicast_hash(ULONG msw, ULONG lsw)
+{
+
+  UCHAR           address[6];
+  ULONG           crc = 0xFFFFFFFFUL;
+  UINT            bit = 0;
+  UINT            i;
+  UINT            j;
+
+
+  address[0] = (UCHAR)(msw >> 8);
+  address[1] = (UCHAR)msw;
+  address[2] = (UCHAR)(lsw >> 24);
+  address[3] = (UCHAR)(lsw >> 16);
+  address[4] = (UCHAR)(lsw >> 8);
+  address[5] = (UCHAR)lsw;
+
+  /* Reflected CRC-32, bytes taken least significant bit first as on the wire.  */
+  for (i = 0; i < sizeof(address); i++)
+  {
+    crc ^= address[i];
+    for (j = 0; j < 8; j++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1UL) ? 0xEDB88320UL : 0UL);
+    }
+  }
+
+  /* The upper 6 bits of the reversed complement are its lower 6 bits, reversed.  */
+  crc = ~crc;
+  for (i = 0; i < 6; i++)
+  {
+    bit = (bit << 1) | (UINT)((crc >> i) & 1UL);
+  }
+
+  return(bit);
+}
+
+
+#ifdef NX_DRIVER_ENABLE_PTP
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_ptp_initialize                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts the PTP clock from 0, in nanoseconds with      */
+/*    fine update, and enables the time stamps of all received frames.    */
+/*    Sent frames are time stamped through their transmit descriptors.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    HAL_RCC_GetHCLKFreq                   PTP clock source frequency    */
+/*    HAL_ETH_PTP_SetConfig                 Configure the PTP clock       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_initialize        Driver hardware initialize    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_ptp_initialize(VOID)
+{
+
+  ETH_PTP_ConfigTypeDef  ptp_config;
+
+
+  ptp_config.Timestamp = ENABLE;
+  ptp_config.TimestampUpdateMode = ENABLE;
+  ptp_config.TimestampInitialize = ENABLE;
+  ptp_config.TimestampUpdate = ENABLE;
+  ptp_config.TimestampAddendUpdate = ENABLE;
+  ptp_config.TimestampAll = ENABLE;
+  ptp_config.TimestampRolloverMode = ENABLE;
+  ptp_config.TimestampV2 = ENABLE;
+  ptp_config.TimestampEthernet = DISABLE;
+  ptp_config.TimestampIPv6 = DISABLE;
+  ptp_config.TimestampIPv4 = ENABLE;
+  ptp_config.TimestampEvent = DISABLE;
+  ptp_config.TimestampMaster = DISABLE;
+  ptp_config.TimestampFilter = DISABLE;
+  ptp_config.TimestampClockType = 0U;
+
+  /* The sub-second counter rolls over at 10^9, it is incremented by the increment each
+     time the 32 bits accumulator overflows, adding the addend at HCLK.  */
+  ptp_config.TimestampSubsecondInc = NX_DRIVER_PTP_SUBSECOND_INCREMENT;
+  ptp_config.TimestampAddend = (uint32_t)(((uint64_t)(1000000000U / NX_DRIVER_PTP_SUBSECOND_INCREMENT) << 32) /
+                                          HAL_RCC_GetHCLKFreq());
+
+  HAL_ETH_PTP_SetConfig(&eth_handle, &ptp_config);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_eth_time_get                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the current time of the PTP clock, to compare */
+/*    with the time stamps of the frames.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    seconds_ptr                           Seconds destination           */
+/*    nanoseconds_ptr                       Nanoseconds destination       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS]                  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  nx_stm32_eth_time_get(ULONG *seconds_ptr, ULONG *nanoseconds_ptr)
+{
+
+  ULONG           seconds;
+  ULONG           nanoseconds;
+
+
+  /* Read again if the seconds changed in between.  */
+  do
+  {
+    seconds = (eth_handle.Instance) -> PTPTSHR;
+    nanoseconds = (eth_handle.Instance) -> PTPTSLR & ETH_PTPTSLR_STSS;
+  } while (seconds != (eth_handle.Instance) -> PTPTSHR);
+
+  *seconds_ptr = seconds;
+  *nanoseconds_ptr = nanoseconds;
+
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_eth_packet_timestamp_get                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the PTP clock time at which the MAC received  */
+/*    the frame of a packet the driver passed to NetX.                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Received packet               */
+/*    seconds_ptr                           Seconds destination           */
+/*    nanoseconds_ptr                       Nanoseconds destination       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_NOT_FOUND]     */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  nx_stm32_eth_packet_timestamp_get(NX_PACKET *packet_ptr, ULONG *seconds_ptr, ULONG *nanoseconds_ptr)
+{
+
+  if ((packet_ptr -> nx_packet_packet_pad[0] == 0) && (packet_ptr -> nx_packet_packet_pad[1] == 0))
+  {
+
+    /* The frame was not time stamped.  */
+    return(NX_NOT_FOUND);
+  }
+
+  *seconds_ptr = packet_ptr -> nx_packet_packet_pad[0];
+  *nanoseconds_ptr = packet_ptr -> nx_packet_packet_pad[1];
+
+  return(NX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_eth_transmit_timestamp_notify_set                          */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the routine called with the PTP clock time at    */
+/*    which each frame was sent, NX_NULL for none. It is called from the  */
+/*    IP thread before the packet is released, the packet prepend pointer */
+/*    is back on the IP header.                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    notify                                Time of transmission notify   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+VOID  nx_stm32_eth_transmit_timestamp_notify_set(VOID (*notify)(NX_PACKET *packet_ptr, ULONG seconds, ULONG nanoseconds))
+{
+
+  nx_driver_information.nx_driver_information_transmit_timestamp_notify = notify;
+}
+#endif /* NX_DRIVER_ENABLE_PTP */
+
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_capture                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies the first NX_DRIVER_CAPTURE_SNAP_LENGTH bytes  */
+/*    of a frame, from its Ethernet header, with its time into the next   */
+/*    record of the capture ring, over the oldest one once the ring is    */
+/*    full. It runs with the IP mutex held.                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Frame received or sent        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_stm32_eth_time_get                 Read the PTP clock            */
+/*    tx_time_get                           Read the ThreadX timer        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_transfer_to_netx           Driver packet receive         */
+/*    _nx_driver_hardware_packet_send       Driver packet send processing */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_capture(NX_PACKET *packet_ptr)
+{
+
+  NX_DRIVER_CAPTURE_RECORD  *record_ptr;
+  NX_PACKET                 *buffer_ptr;
+  ULONG                     captured = 0;
+  ULONG                     size;
+#ifdef NX_DRIVER_ENABLE_PTP
+  ULONG                     nanoseconds;
+#else
+  ULONG                     ticks;
+#endif
+
+
+  record_ptr = &nx_driver_capture_records[nx_driver_information.nx_driver_information_capture_count & (NX_DRIVER_CAPTURE_FRAMES - 1U)];
+
+#ifdef NX_DRIVER_ENABLE_PTP
+  nx_stm32_eth_time_get(&(record_ptr -> nx_driver_capture_seconds), &nanoseconds);
+  record_ptr -> nx_driver_capture_microseconds = nanoseconds / 1000U;
+#else
+  ticks = tx_time_get();
+  record_ptr -> nx_driver_capture_seconds = ticks / TX_TIMER_TICKS_PER_SECOND;
+  record_ptr -> nx_driver_capture_microseconds = (ticks % TX_TIMER_TICKS_PER_SECOND) * (1000000U / TX_TIMER_TICKS_PER_SECOND);
+#endif
+
+  /* Copy the buffers of the chain in turn, up to the snap length.  */
+  for (buffer_ptr = packet_ptr; (buffer_ptr != NX_NULL) && (captured < NX_DRIVER_CAPTURE_SNAP_LENGTH);
+       buffer_ptr = buffer_ptr -> nx_packet_next)
+  {
+    size = (ULONG)(buffer_ptr -> nx_packet_append_ptr - buffer_ptr -> nx_packet_prepend_ptr);
+    if (size > (NX_DRIVER_CAPTURE_SNAP_LENGTH - captured))
+    {
+      size = NX_DRIVER_CAPTURE_SNAP_LENGTH - captured;
+    }
+
+    memcpy(&(record_ptr -> nx_driver_capture_data[captured]), buffer_ptr -> nx_packet_prepend_ptr, size); /* Use case of memcpy is verified. */
+    captured += size;
+  }
+
+  record_ptr -> nx_driver_capture_captured_length = captured;
+  record_ptr -> nx_driver_capture_length = packet_ptr -> nx_packet_length;
+
+  nx_driver_information.nx_driver_information_capture_count++;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_eth_capture_enable                                         */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts or stops the capture of the frames received    */
+/*    and sent, the records of the ring are kept. The capture starts      */
+/*    with the driver.                                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    enable                                NX_TRUE to capture            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+VOID  nx_stm32_eth_capture_enable(UINT enable)
+{
+
+  nx_driver_information.nx_driver_information_capture_enabled = enable;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    nx_stm32_eth_capture_read                                           */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies the frames captured from a sequence number on  */
+/*    as pcap records, as many whole records as the buffer holds, and     */
+/*    advances the sequence number past them. Frames overwritten since    */
+/*    are skipped, a sequence number of 0 reads the oldest frame kept.    */
+/*    The buffer holds one record at least, 16 bytes plus the snap        */
+/*    length. The records are read with the IP mutex held, so the caller  */
+/*    must not hold it across waits on the IP thread.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    sequence_ptr                          Sequence number, advanced     */
+/*    buffer_ptr                            Records destination           */
+/*    buffer_size                           Size of the destination       */
+/*    length_ptr                            Bytes copied destination      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_NOT_FOUND]     */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get the IP mutex              */
+/*    tx_mutex_put                          Put the IP mutex              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  nx_stm32_eth_capture_read(ULONG *sequence_ptr, VOID *buffer_ptr, ULONG buffer_size, ULONG *length_ptr)
+{
+
+  NX_IP                     *ip_ptr = nx_driver_information.nx_driver_information_ip_ptr;
+  NX_DRIVER_CAPTURE_RECORD  *record_ptr;
+  ULONG                     sequence = *sequence_ptr;
+  ULONG                     count;
+  ULONG                     length = 0;
+  ULONG                     record_size;
+
+
+  /* The frames are captured with the IP mutex held, by the IP thread and the sending threads.  */
+  tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+  count = nx_driver_information.nx_driver_information_capture_count;
+
+  /* Skip the frames overwritten.  */
+  if ((count - sequence) > NX_DRIVER_CAPTURE_FRAMES)
+  {
+    sequence = count - NX_DRIVER_CAPTURE_FRAMES;
+  }
+
+  if (sequence == count)
+  {
+    tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+    /* No frame left to read.  */
+    *sequence_ptr = sequence;
+    *length_ptr = 0;
+    return(NX_NOT_FOUND);
+  }
+
+  while (sequence != count)
+  {
+    record_ptr = &nx_driver_capture_records[sequence & (NX_DRIVER_CAPTURE_FRAMES - 1U)];
+    record_size = (4U * sizeof(ULONG)) + record_ptr -> nx_driver_capture_captured_length;
+
+    if ((length + record_size) > buffer_size)
+    {
+      break;
+    }
+
+    memcpy((UCHAR *)buffer_ptr + length, record_ptr, record_size); /* Use case of memcpy is verified. */
+    length += record_size;
+    sequence++;
+  }
+
+  tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+  *sequence_ptr = sequence;
+  *length_ptr = length;
+
+  return(NX_SUCCESS);
+}
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_driver_hardware_get_status                                      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes hardware-specific get status requests.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver request pointer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]*/
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_link_update       Follow the link of the PHY    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_get_status                 Driver get status processing  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  /* The PHY is not set up before the link is enabled.  */
+  if (nx_driver_information.nx_driver_information_state < NX_DRIVER_STATE_LINK_ENABLED)
+  {
+    *(driver_req_ptr->nx_ip_driver_return_ptr) = NX_FALSE;
+    return NX_SUCCESS;
+  }
+
+  /* Update Link status from the phsical link. */
+  *(driver_req_ptr->nx_ip_driver_return_ptr) = _nx_driver_hardware_link_update(driver_req_ptr -> nx_ip_driver_ptr);
+
+  /* Return success. */
+  return NX_SUCCESS;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_link_update                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function follows the link state of the PHY, which also moves   */
+/*    its bring-up on, so that the enable request never waits for the     */
+/*    reset or the auto-negotiation. Once the link is up, the MAC is set  */
+/*    to its speed and duplex mode. An IP instance whose link came up or  */
+/*    went down is updated, and the IP helper thread is told so for the   */
+/*    link status change callback. It is called with the IP mutex held.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ip_ptr                                Pointer to IP instance        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    link_up                               [NX_TRUE|NX_FALSE]            */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_eth_phy_get_link_state             Get the link state of the PHY */
+/*    HAL_ETH_GetMACConfig                  Get the MAC configuration     */
+/*    HAL_ETH_SetMACConfig                  Set the MAC configuration     */
+/*    _nx_ip_driver_link_status_event       Tell the IP thread the link   */
+/*                                            status changed              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_enable                     Driver link enable processing */
+/*    _nx_driver_hardware_get_status        Get status processing         */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_link_update(NX_IP *ip_ptr)
+{
+
+  ETH_MACConfigTypeDef MACConf;
+  UINT            link_up, duplex, speed;
+  INT             PHYLinkState;
+
+
+  /* Get link state.  */
+  PHYLinkState = nx_eth_phy_get_link_state();
+  link_up = ETH_PHY_LINK_IS_UP(PHYLinkState) ? NX_TRUE : NX_FALSE;
+
+  /* Nothing to do while the link stays as the IP instance knows it.  */
+  if (link_up == ip_ptr -> nx_ip_driver_link_up)
+  {
+    return(link_up);
+  }
+
+  if (link_up)
+  {
+    switch (PHYLinkState)
+    {
+    case ETH_PHY_STATUS_100MBITS_HALFDUPLEX:
+      duplex = ETH_HALFDUPLEX_MODE;
+      speed = ETH_SPEED_100M;
+      break;
+    case ETH_PHY_STATUS_10MBITS_FULLDUPLEX:
+      duplex = ETH_FULLDUPLEX_MODE;
+      speed = ETH_SPEED_10M;
+      break;
+    case ETH_PHY_STATUS_10MBITS_HALFDUPLEX:
+      duplex = ETH_HALFDUPLEX_MODE;
+      speed = ETH_SPEED_10M;
+      break;
+    default:
+      duplex = ETH_FULLDUPLEX_MODE;
+      speed = ETH_SPEED_100M;
+      break;
+    }
+
+    /* Set the MAC to the negotiated mode, no frame went through it since the link was down.  */
+    HAL_ETH_GetMACConfig(&eth_handle, &MACConf);
+    MACConf.DuplexMode = duplex;
+    MACConf.Speed = speed;
+    HAL_ETH_SetMACConfig(&eth_handle, &MACConf);
+  }
+
+  /* Update the IP instance and have its thread call the link status change callback.  */
+  ip_ptr -> nx_ip_driver_link_up =  link_up;
+  _nx_ip_driver_link_status_event(ip_ptr, 0);
+
+  return(link_up);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_get_statistics                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the driver counter asked for. The frames the  */
+/*    DMA missed, with no descriptor free or its FIFO full, are added to  */
+/*    the error count from the missed frame register, cleared on read.    */
+/*    The requests come with the IP mutex held, which the IP thread holds */
+/*    as well while it updates the counters.                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    driver_req_ptr                        Driver request pointer        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]*/
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_get_statistics             Driver get statistics         */
+/*                                            processing                  */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_get_statistics(NX_IP_DRIVER *driver_req_ptr)
+{
+
+  ULONG       missed;
+
+
+  missed = (eth_handle.Instance) -> DMAMFBOCR;
+  nx_driver_information.nx_driver_information_receive_error_count +=
+    (missed & ETH_DMAMFBOCR_MFC) + ((missed & ETH_DMAMFBOCR_MFA) >> ETH_DMAMFBOCR_MFA_Pos);
+
+  switch (driver_req_ptr -> nx_ip_driver_command)
+  {
+  case NX_LINK_GET_ERROR_COUNT:
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = nx_driver_information.nx_driver_information_receive_error_count;
+    break;
+
+  case NX_LINK_GET_RX_COUNT:
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = nx_driver_information.nx_driver_information_receive_count;
+    break;
+
+  case NX_LINK_GET_TX_COUNT:
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = nx_driver_information.nx_driver_information_transmit_count;
+    break;
+
+  case NX_LINK_GET_ALLOC_ERRORS:
+    *(driver_req_ptr -> nx_ip_driver_return_ptr) = nx_driver_information.nx_driver_information_allocation_errors;
+    break;
+
+  default:
+    return(NX_DRIVER_ERROR);
+  }
+
+  return(NX_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_release                                */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function advances the ring tail over the descriptors the DMA   */
+/*    is done with and releases the packets whose last descriptor has     */
+/*    been sent.                                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_recycle  Keep the packet for RX        */
+/*    nx_packet_transmit_release            Release transmitted packet    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_transmitted                              */
+/*                                          Transmit complete processing  */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*    _nx_driver_hardware_transmit_descriptors_set                        */
+/*                                          Transmit descriptors setup    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_transmit_release(VOID)
+{
+
+  NX_PACKET       *release_packet;
+  UINT            index;
+
+
+  index = nx_driver_information.nx_driver_information_transmit_release_index;
+
+  while (nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use != 0)
+  {
+
+    /* Stop at the first descriptor still owned by the DMA.  */
+    if (DMATxDscrTab[index].DESC0 & ETH_DMATXDESC_OWN)
+    {
+      break;
+    }
+
+    release_packet = nx_driver_information.nx_driver_information_transmit_packets[index];
+
+    if (release_packet != NX_NULL)
+    {
+      nx_driver_information.nx_driver_information_transmit_packets[index] = NX_NULL;
+
+      TRACE_SWO_EVENT(TRACE_SWO_EVENT_ETH_SENT, release_packet, 0, 0, 0)
+
+      /* Remove the Ethernet header and release the packet.  */
+      NX_DRIVER_ETHERNET_HEADER_REMOVE(release_packet);
+#ifdef NX_DRIVER_ENABLE_PTP
+      if ((nx_driver_information.nx_driver_information_transmit_timestamp_notify != NX_NULL) &&
+          (DMATxDscrTab[index].DESC0 & ETH_DMATXDESC_TTSS))
+      {
+        nx_driver_information.nx_driver_information_transmit_timestamp_notify(release_packet,
+                                                                               DMATxDscrTab[index].DESC7,
+                                                                               DMATxDscrTab[index].DESC6);
+      }
+#endif
+#if NX_DRIVER_TX_RECYCLE_PACKETS > 0
+      if (!_nx_driver_hardware_transmit_recycle(release_packet))
+#endif
+      {
+        nx_packet_transmit_release(release_packet);
+      }
+      nx_driver_information.nx_driver_information_transmit_count++;
+    }
+
+    index = (index + 1) % NX_DRIVER_TX_DESCRIPTORS;
+    nx_driver_information.nx_driver_information_number_of_transmit_buffers_in_use--;
+  }
+
+  nx_driver_information.nx_driver_information_transmit_release_index = index;
+}
+
+
+#if NX_DRIVER_TX_RECYCLE_PACKETS > 0
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_recycle                                */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function keeps a sent packet of the RX packet pool on the      */
+/*    recycle list, as a received packet, so that the RX ring refill      */
+/*    re-arms a descriptor with it without a pool allocation. Packets of  */
+/*    other pools, chained, still queued by TCP, or beyond                */
+/*    NX_DRIVER_TX_RECYCLE_PACKETS on the list are left to release.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_ptr                            Sent packet                   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_TRUE                               Packet kept                   */
+/*    NX_FALSE                              Packet to release             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_release  Transmitted packets release   */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _nx_driver_hardware_transmit_recycle(NX_PACKET *packet_ptr)
+{
+
+  if ((packet_ptr -> nx_packet_pool_owner != nx_driver_information.nx_driver_information_packet_pool_ptr) ||
+      (packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next != (NX_PACKET *)NX_PACKET_ALLOCATED) ||
+#ifndef NX_DISABLE_PACKET_CHAIN
+      (packet_ptr -> nx_packet_next != NX_NULL) ||
+#endif
+      (packet_ptr -> nx_packet_identical_copy) ||
+      (nx_driver_information.nx_driver_information_receive_recycle_count >= NX_DRIVER_TX_RECYCLE_PACKETS))
+  {
+    return(NX_FALSE);
+  }
+
+  /* Reset it as nx_packet_allocate() does, with the 2 bytes offset of the RX packets.  */
+  packet_ptr -> nx_packet_prepend_ptr = packet_ptr -> nx_packet_data_start + NX_RECEIVE_PACKET + 2;
+  packet_ptr -> nx_packet_append_ptr = packet_ptr -> nx_packet_prepend_ptr;
+  packet_ptr -> nx_packet_length = 0;
+#ifndef NX_DISABLE_PACKET_CHAIN
+  packet_ptr -> nx_packet_last = NX_NULL;
+#endif
+  packet_ptr -> nx_packet_address.nx_packet_interface_ptr = NX_NULL;
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+  packet_ptr -> nx_packet_interface_capability_flag = 0;
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+#ifndef NX_DISABLE_IPV4
+  packet_ptr -> nx_packet_ip_version = NX_IP_VERSION_V4;
+#endif
+  packet_ptr -> nx_packet_ip_header_length = 0;
+
+  packet_ptr -> nx_packet_queue_next = nx_driver_information.nx_driver_information_receive_recycle;
+  nx_driver_information.nx_driver_information_receive_recycle = packet_ptr;
+  nx_driver_information.nx_driver_information_receive_recycle_count++;
+
+  return(NX_TRUE);
+}
+#endif /* NX_DRIVER_TX_RECYCLE_PACKETS > 0 */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_transmitted                              */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes the transmit complete event: it reclaims    */
+/*    the sent descriptors and maps the queued frames onto the ring, in   */
+/*    the order of their classes.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_transmit_release  Reclaim sent descriptors      */
+/*    _nx_driver_hardware_transmit_schedule Transmit queue processing     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_deferred_processing        Deferred driver processing    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_packet_transmitted(VOID)
+{
+
+  _nx_driver_hardware_transmit_release();
+
+  _nx_driver_hardware_transmit_schedule();
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_driver_hardware_packet_received                                 */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function drains at most NX_DRIVER_RX_POLL_BUDGET frames from   */
+/*    the RX ring, reading the status of the DMA receive descriptors      */
+/*    directly, then re-arms the consumed descriptors in one batch. RX    */
+/*    interrupts are masked since the first RX interrupt and are unmasked */
+/*    only once the ring is found empty; otherwise another poll is        */
+/*    scheduled on the IP thread. With RX checksum offload, frames        */
+/*    flagged with a checksum error are dropped and frames the engine     */
+/*    could not verify are marked for NetX.                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_driver_hardware_receive_copy      Copy a short frame            */
+/*    _nx_driver_transfer_to_netx           Pass the frame to NetX        */
+/*    _nx_driver_hardware_receive_ring_refill                             */
+/*                                          Re-arm the consumed descs     */
+/*    _nx_driver_hardware_receive_poll_schedule                           */
+/*                                          Schedule the next RX poll     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_driver_deferred_processing        Deferred driver processing    */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _nx_driver_hardware_packet_received(VOID)
+{
+  ETH_DMADescTypeDef  *dma_rx_desc;
+  NX_PACKET           *received_packet_ptr;
+  ULONG               status;
+  UINT                length;
+  UINT                index;
+  UINT                frames = 0;
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+  ULONG               rx_status;
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+
+  /* Frames completed from now on set the RX status again, so that unmasking
+     RX interrupts below cannot miss them.  */
+  __HAL_ETH_DMA_CLEAR_IT(&eth_handle, ETH_DMASR_RS);
+
+  /* Only the descriptors holding a packet may have received a frame.  */
+  while ((frames < NX_DRIVER_RX_POLL_BUDGET) &&
+         (nx_driver_information.nx_driver_information_receive_empty_count < NX_DRIVER_RX_DESCRIPTORS))
+  {
+    index = nx_driver_information.nx_driver_information_receive_current_index;
+    dma_rx_desc = &DMARxDscrTab[index];
+
+    status = dma_rx_desc -> DESC0;
+    if (status & ETH_DMARXDESC_OWN)
+    {
+      break;
+    }
+    frames++;
+
+    /* Detach the packet, the descriptor is re-armed with a new one after the loop.  */
+    received_packet_ptr = nx_driver_information.nx_driver_information_receive_packets[index];
+    nx_driver_information.nx_driver_information_receive_packets[index] = NX_NULL;
+    dma_rx_desc -> BackupAddr0 = 0U;
+    nx_driver_information.nx_driver_information_receive_current_index = (index + 1) % NX_DRIVER_RX_DESCRIPTORS;
+    nx_driver_information.nx_driver_information_receive_empty_count++;
+
+    /* A buffer holds a whole frame, so a frame spanning descriptors is an error as well.  */
+    if (((status & (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) != (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) ||
+        (status & ETH_DMARXDESC_ES))
+    {
+      nx_driver_information.nx_driver_information_receive_error_count++;
+      nx_packet_release(received_packet_ptr);
+      continue;
+    }
+
+    /* Remove the 4 bytes of the CRC from the frame length.  */
+    length = ((status & ETH_DMARXDESC_FL) >> NX_DRIVER_RX_FRAME_LENGTH_SHIFT) - 4U;
+    received_packet_ptr -> nx_packet_append_ptr = received_packet_ptr -> nx_packet_prepend_ptr + length;
+    received_packet_ptr -> nx_packet_length = length;
+
+#ifdef NX_DRIVER_ENABLE_PTP
+    /* Keep the time of reception, seconds then nanoseconds, 0 when not time stamped.  */
+    if (status & NX_DRIVER_RX_TIMESTAMP_VALID)
+    {
+      received_packet_ptr -> nx_packet_packet_pad[0] = dma_rx_desc -> DESC7;
+      received_packet_ptr -> nx_packet_packet_pad[1] = dma_rx_desc -> DESC6;
+    }
+    else
+    {
+      received_packet_ptr -> nx_packet_packet_pad[0] = 0;
+      received_packet_ptr -> nx_packet_packet_pad[1] = 0;
+    }
+#endif
+
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+    if (nx_driver_information.nx_driver_information_interface -> nx_interface_capability_flag & NX_DRIVER_RX_CAPABILITY)
+    {
+
+#ifdef NX_DRIVER_ENABLE_PTP
+      /* Translate the checksum status of the extended status word to the one of the
+         normal descriptors.  */
+      rx_status = status & ETH_DMARXDESC_FT;
+      if (status & NX_DRIVER_RX_EXTENDED_STATUS)
+      {
+        if (dma_rx_desc -> DESC4 & (ETH_DMAPTPRXDESC_IPHE | ETH_DMAPTPRXDESC_IPPE))
+        {
+          rx_status |= ETH_DMARXDESC_IPV4HCE;
+        }
+        else if (dma_rx_desc -> DESC4 & ETH_DMAPTPRXDESC_IPCB)
+        {
+          rx_status = ETH_DMARXDESC_MAMPCE;
+        }
+      }
+#else
+      /* Pickup the checksum offload status of the frame.  */
+      rx_status = status & (ETH_DMARXDESC_FT | ETH_DMARXDESC_IPV4HCE | ETH_DMARXDESC_MAMPCE);
+#endif
+
+      if ((rx_status & ETH_DMARXDESC_FT) && (rx_status & (ETH_DMARXDESC_IPV4HCE | ETH_DMARXDESC_MAMPCE)))
+      {
+
+        /* IP header or payload checksum error that the DMA did not drop.  */
+        nx_driver_information.nx_driver_information_receive_error_count++;
+        nx_packet_release(received_packet_ptr);
+        continue;
+      }
+
+      if (rx_status == ETH_DMARXDESC_MAMPCE)
+      {
+
+        /* IP frame whose payload the engine does not handle (fragment, IPv6 extension headers),
+           let NetX verify its checksum.  */
+        received_packet_ptr -> nx_packet_interface_capability_flag = NX_INTERFACE_CAPABILITY_RX_CHECKSUM_BYPASS;
+      }
+    }
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+
+#if NX_DRIVER_RX_COPY_BREAK > 0
+    if (length <= NX_DRIVER_RX_COPY_BREAK)
+    {
 
-  /* Return success!  */
-  return(NX_SUCCESS);
+      /* Keep the full size packet for the ring, NetX may hold the frame for long.  */
+      received_packet_ptr = _nx_driver_hardware_receive_copy(received_packet_ptr);
+    }
+#endif
+
+    /* Transfer the packet to NetX.  */
+    nx_driver_information.nx_driver_information_receive_count++;
+    _nx_driver_transfer_to_netx(nx_driver_information.nx_driver_information_ip_ptr, received_packet_ptr);
+  }
+
+  if (frames == NX_DRIVER_RX_POLL_BUDGET)
+  {
+
+    /* Budget used up, keep RX interrupts masked and poll again on the next IP thread wakeup.  */
+    _nx_driver_hardware_receive_poll_schedule();
+  }
+#if NX_DRIVER_RX_MITIGATION_TICKS > 0
+  else if (frames != 0)
+  {
+
+    /* Traffic is still flowing, poll once more after the mitigation delay.  */
+    tx_timer_deactivate(&nx_driver_information.nx_driver_information_rx_mitigation_timer);
+    tx_timer_change(&nx_driver_information.nx_driver_information_rx_mitigation_timer, NX_DRIVER_RX_MITIGATION_TICKS, 0);
+    tx_timer_activate(&nx_driver_information.nx_driver_information_rx_mitigation_timer);
+  }
+#endif
+  else
+  {
+
+    /* The ring is empty, go back to interrupt mode.  */
+    __HAL_ETH_DMA_ENABLE_IT(&eth_handle, ETH_DMAIER_RIE);
+  }
+
+  /* Re-arm the consumed descriptors. Those left without a packet because the RX
+     packet pool was empty are retried from the refill timer, as no RX interrupt
+     comes for a descriptor the DMA does not own.  */
+  _nx_driver_hardware_receive_ring_refill();
+
+  if (nx_driver_information.nx_driver_information_receive_empty_count != 0U)
+  {
+
+    /* Neither call has an effect while the timer is already pending.  */
+    tx_timer_change(&nx_driver_information.nx_driver_information_rx_refill_timer, NX_DRIVER_RX_REFILL_TICKS, 0);
+    tx_timer_activate(&nx_driver_information.nx_driver_information_rx_refill_timer);
+  }
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_packet_send                                     */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_hardware_receive_poll_schedule                           */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes hardware-specific packet send requests.     */
+/*    This function requests an RX poll from the IP thread.               */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    packet_ptr                            Pointer to packet to send     */
+/*    None                                                                */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    [_nx_driver_transmit_packet_enqueue]  Optional internal transmit    */
-/*                                            packet queue routine        */
+/*    _nx_ip_driver_deferred_processing     Wake up the IP thread         */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_driver_packet_send                Driver packet send processing */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_driver_hardware_packet_received   RX ring processing            */
+/*    _nx_driver_hardware_receive_poll_timeout                            */
+/*                                          Delayed RX poll               */
+/*    HAL_ETH_RxCpltCallback                RX interrupt                  */
+/*    HAL_ETH_ErrorCallback                 RX buffer unavailable         */
 /*                                                                        */
 /**************************************************************************/
-
-static UINT  _nx_driver_hardware_packet_send(NX_PACKET *packet_ptr)
+static VOID  _nx_driver_hardware_receive_poll_schedule(VOID)
 {
 
-  NX_PACKET       *pktIdx;
-  UINT            buffLen = 0;
-
-  ETH_BufferTypeDef Txbuffer[ETH_TX_DESC_CNT];
-  memset(Txbuffer, 0 , ETH_TX_DESC_CNT*sizeof(ETH_BufferTypeDef));
-
-
-  int i = 0;
-
-  for (pktIdx = packet_ptr;pktIdx != NX_NULL ; pktIdx = pktIdx -> nx_packet_next)
-  {
-    if (i >= ETH_TX_DESC_CNT)
-    {
-      return NX_DRIVER_ERROR;
-    }
-
-    Txbuffer[i].buffer = pktIdx->nx_packet_prepend_ptr;
-    Txbuffer[i].len = (pktIdx -> nx_packet_append_ptr - pktIdx->nx_packet_prepend_ptr);
-    buffLen += (pktIdx -> nx_packet_append_ptr - pktIdx->nx_packet_prepend_ptr);
+  TX_INTERRUPT_SAVE_AREA
 
-    if(i>0)
-    {
-      Txbuffer[i-1].next = &Txbuffer[i];
-    }
+  ULONG       deferred_events;
 
-    if (pktIdx-> nx_packet_next ==NULL)
-    {
-      Txbuffer[i].next = NULL;
-    }
 
-    i++;
-#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    SCB_CleanDCache_by_Addr((uint32_t*)(pktIdx -> nx_packet_data_start), pktIdx -> nx_packet_data_end - pktIdx -> nx_packet_data_start);
-#endif
-  }
+  TX_DISABLE
 
-#ifdef NX_ENABLE_INTERFACE_CAPABILITY
-  if (packet_ptr -> nx_packet_interface_capability_flag & (NX_INTERFACE_CAPABILITY_TCP_TX_CHECKSUM |
-                                                           NX_INTERFACE_CAPABILITY_UDP_TX_CHECKSUM |
-                                                             NX_INTERFACE_CAPABILITY_ICMPV4_TX_CHECKSUM |
-                                                               NX_INTERFACE_CAPABILITY_ICMPV6_TX_CHECKSUM))
-  {
-    TxPacketCfg.ChecksumCtrl = ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC;
-  }
-  else if (packet_ptr -> nx_packet_interface_capability_flag & NX_INTERFACE_CAPABILITY_IPV4_TX_CHECKSUM)
-  {
-    TxPacketCfg.ChecksumCtrl = ETH_CHECKSUM_IPHDR_INSERT;
-  }
-#else
-  TxPacketCfg.ChecksumCtrl = ETH_CHECKSUM_DISABLE;
-#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+  deferred_events = nx_driver_information.nx_driver_information_deferred_events;
+  nx_driver_information.nx_driver_information_deferred_events |= NX_DRIVER_DEFERRED_PACKET_RECEIVED;
 
-  TxPacketCfg.Length = buffLen;
-  TxPacketCfg.TxBuffer = Txbuffer;
-  TxPacketCfg.pData = (uint32_t *)packet_ptr;
+  TX_RESTORE
 
-  if(HAL_ETH_Transmit_IT(&eth_handle, &TxPacketCfg))
+  if (!deferred_events)
   {
-    return(NX_DRIVER_ERROR);
+    /* Call NetX deferred driver processing.  */
+    _nx_ip_driver_deferred_processing(nx_driver_information.nx_driver_information_ip_ptr);
   }
-
-  return(NX_SUCCESS);
 }
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_multicast_join                                  */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_hardware_receive_poll_timeout                            */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes hardware-specific multicast join requests.  */
+/*    This function is the expiration routine of the RX mitigation and    */
+/*    RX refill timers, it schedules an RX poll. The poll re-arms the     */
+/*    descriptors left without a buffer and may unmask RX interrupts.     */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    driver_req_ptr                        Driver request pointer        */
+/*    timer_input                           Not used                      */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]  */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _nx_driver_hardware_receive_poll_schedule                           */
+/*                                          Schedule the next RX poll     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_driver_multicast_join             Driver multicast join         */
-/*                                            processing                  */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    ThreadX timer                                                       */
 /*                                                                        */
 /**************************************************************************/
-static UINT  _nx_driver_hardware_multicast_join(NX_IP_DRIVER *driver_req_ptr)
+static VOID  _nx_driver_hardware_receive_poll_timeout(ULONG timer_input)
 {
 
+  NX_PARAMETER_NOT_USED(timer_input);
 
-  /* Increase the multicast count.  */
-  nx_driver_information.nx_driver_information_multicast_count++;
-
-  /* Enable multicast frame reception.  */
-  FilterConfig.PassAllMulticast = ENABLE;
-  HAL_ETH_SetMACFilterConfig(&eth_handle, &FilterConfig);
-
-  /* Return success.  */
-  return(NX_SUCCESS);
+  _nx_driver_hardware_receive_poll_schedule();
 }
 
-
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_multicast_leave                                 */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_hardware_receive_ring_reset                              */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes hardware-specific multicast leave requests. */
+/*    This function releases the packets left on the RX ring, takes all   */
+/*    the receive descriptors back from the DMA and attaches a new packet */
+/*    to each of them, starting again from the first descriptor. The DMA  */
+/*    reception must be stopped.                                          */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    driver_req_ptr                        Driver request pointer        */
+/*    None                                                                */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]*/
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    nx_packet_release                     Release packet                */
+/*    _nx_driver_hardware_receive_ring_refill                             */
+/*                                          Attach packets to the ring    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_driver_multicast_leave            Driver multicast leave        */
-/*                                            processing                  */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_driver_hardware_enable            Driver link enable processing */
 /*                                                                        */
 /**************************************************************************/
-static UINT  _nx_driver_hardware_multicast_leave(NX_IP_DRIVER *driver_req_ptr)
+static VOID  _nx_driver_hardware_receive_ring_reset(VOID)
 {
 
-  /* Decrease the multicast count.  */
-  nx_driver_information.nx_driver_information_multicast_count--;
+  UINT            index;
 
-  /* If multicast count reaches zero, disable multicast frame reception.  */
-  if (nx_driver_information.nx_driver_information_multicast_count == 0)
+
+  for (index = 0; index < NX_DRIVER_RX_DESCRIPTORS; index++)
   {
+    DMARxDscrTab[index].DESC0 = 0U;
+    DMARxDscrTab[index].BackupAddr0 = 0U;
 
-    /* Disable multicast frame reception.  */
-    FilterConfig.PassAllMulticast = DISABLE;
-    HAL_ETH_SetMACFilterConfig(&eth_handle, &FilterConfig);
+    if (nx_driver_information.nx_driver_information_receive_packets[index] != NX_NULL)
+    {
+      nx_packet_release(nx_driver_information.nx_driver_information_receive_packets[index]);
+      nx_driver_information.nx_driver_information_receive_packets[index] = NX_NULL;
+    }
   }
 
-  /* Return success.  */
-  return(NX_SUCCESS);
+  nx_driver_information.nx_driver_information_receive_current_index = 0;
+  nx_driver_information.nx_driver_information_receive_refill_index = 0;
+  nx_driver_information.nx_driver_information_receive_empty_count = NX_DRIVER_RX_DESCRIPTORS;
+
+  _nx_driver_hardware_receive_ring_refill();
+
+  /* Restart the DMA from the first descriptor.  */
+  (eth_handle.Instance) -> DMARDLAR = (uint32_t)&DMARxDscrTab[0];
 }
 
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_driver_hardware_get_status                                      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    _nx_driver_hardware_receive_ring_refill                             */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function processes hardware-specific get status requests.      */
+/*    This function attaches a new packet to each receive descriptor      */
+/*    left without one, in ring order, and hands them back to the DMA.    */
+/*    The packets whose frame was copied, and the sent packets kept from  */
+/*    the RX pool, are reused first, the others are allocated from the    */
+/*    pool at once. When the pool runs short, the remaining descriptors   */
+/*    are retried on a later poll. The DMA is resumed once for the batch. */
+/*    A descriptor holding a packet keeps its buffer address in           */
+/*    BackupAddr0, which is how HAL_ETH_Start_IT tells it apart from an   */
+/*    empty one.                                                          */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    driver_req_ptr                        Driver request pointer        */
+/*    None                                                                */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    status                                [NX_SUCCESS|NX_DRIVER_ERROR]*/
+/*    None                                                                */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    nx_packet_allocate_bulk               Allocate receive packets      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_driver_get_status                 Driver get status processing  */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  xx-xx-xxxx     Yuxin Zhou               Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_driver_hardware_packet_received   RX ring processing            */
+/*    _nx_driver_hardware_receive_ring_reset                              */
+/*                                          RX ring reset                 */
 /*                                                                        */
 /**************************************************************************/
-static UINT  _nx_driver_hardware_get_status(NX_IP_DRIVER *driver_req_ptr)
+static VOID  _nx_driver_hardware_receive_ring_refill(VOID)
 {
-  INT PHYLinkState;
 
-  /* Get link status. */
-  PHYLinkState = nx_eth_phy_get_link_state();
+  ETH_DMADescTypeDef  *dma_rx_desc;
+  NX_PACKET           *packet_ptr;
+  NX_PACKET           *allocated[NX_DRIVER_RX_DESCRIPTORS];
+  UINT                allocated_count = 0U;
+  UINT                taken = 0U;
+  UINT                index;
+  UINT                armed = 0;
 
-  /* Check link status. */
-  if(PHYLinkState <= ETH_PHY_STATUS_LINK_DOWN)
-  {
-    /* Update Link status if phsical link is down. */
-    *(driver_req_ptr->nx_ip_driver_return_ptr) = NX_FALSE;
-  }
-  else
+
+  /* Allocate the packets the recycle list does not cover in one pass over the pool.  */
+  if (nx_driver_information.nx_driver_information_receive_empty_count >
+      nx_driver_information.nx_driver_information_receive_recycle_count)
   {
-    /* Update Link status if phsical link is up. */
-    *(driver_req_ptr->nx_ip_driver_return_ptr) = NX_TRUE;
+    nx_packet_allocate_bulk(nx_driver_information.nx_driver_information_packet_pool_ptr, allocated, NX_RECEIVE_PACKET,
+                            nx_driver_information.nx_driver_information_receive_empty_count -
+                            nx_driver_information.nx_driver_information_receive_recycle_count,
+                            &allocated_count);
   }
 
-  /* Return success. */
-  return NX_SUCCESS;
-}
-
-void HAL_ETH_TxFreeCallback(uint32_t * buff)
-{
-  NX_PACKET * release_packet = (NX_PACKET *) buff;
-
-  /* Remove the Ethernet header and release the packet.  */
-  NX_DRIVER_ETHERNET_HEADER_REMOVE(release_packet);
+  index = nx_driver_information.nx_driver_information_receive_refill_index;
 
-  /* Release the packet.  */
-  nx_packet_transmit_release(release_packet);
-}
+  while (nx_driver_information.nx_driver_information_receive_empty_count != 0U)
+  {
+    packet_ptr = nx_driver_information.nx_driver_information_receive_recycle;
+    if (packet_ptr != NX_NULL)
+    {
 
-static VOID  _nx_driver_hardware_packet_received(VOID)
-{
-  NX_PACKET  *received_packet_ptr;
+      /* Its prepend pointer is still adjusted from the previous frame.  */
+      nx_driver_information.nx_driver_information_receive_recycle = packet_ptr -> nx_packet_queue_next;
+      nx_driver_information.nx_driver_information_receive_recycle_count--;
+    }
+    else if (taken < allocated_count)
+    {
+      packet_ptr = allocated[taken++];
 
-  while (HAL_ETH_ReadData(&eth_handle, (void **)&received_packet_ptr) == HAL_OK)
-  {
-      /* Transfer the packet to NetX.  */
-      _nx_driver_transfer_to_netx(nx_driver_information.nx_driver_information_ip_ptr, received_packet_ptr);
-  }
-}
+      /* Adjust the packet.  */
+      packet_ptr -> nx_packet_prepend_ptr += 2;
+    }
+    else
+    {
+      nx_driver_information.nx_driver_information_allocation_errors++;
+      break;
+    }
 
-void HAL_ETH_RxAllocateCallback(uint8_t ** buff)
-{
-  NX_PACKET     *packet_ptr;
-  if (nx_packet_allocate(nx_driver_information.nx_driver_information_packet_pool_ptr, &packet_ptr,
-                         NX_RECEIVE_PACKET, NX_NO_WAIT) == NX_SUCCESS)
-  {
-    /* Adjust the packet.  */
-    packet_ptr -> nx_packet_prepend_ptr += 2;
 #if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
     SCB_InvalidateDCache_by_Addr((uint32_t*)packet_ptr -> nx_packet_data_start, packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_data_start);
 #endif
-    *buff = packet_ptr -> nx_packet_prepend_ptr;
+
+    dma_rx_desc = &DMARxDscrTab[index];
+    dma_rx_desc -> DESC2 = (uint32_t)packet_ptr -> nx_packet_prepend_ptr;
+    dma_rx_desc -> DESC1 = ETH_RX_BUF_SIZE | ETH_DMARXDESC_RCH;
+    dma_rx_desc -> BackupAddr0 = (uint32_t)packet_ptr -> nx_packet_prepend_ptr;
+    nx_driver_information.nx_driver_information_receive_packets[index] = packet_ptr;
+
+    /* Ensure the descriptor is written before it is given to the DMA, the status of
+       the previous frame is cleared along.  */
+    __DMB();
+    dma_rx_desc -> DESC0 = ETH_DMARXDESC_OWN;
+
+    index = (index + 1) % NX_DRIVER_RX_DESCRIPTORS;
+    nx_driver_information.nx_driver_information_receive_empty_count--;
+    armed++;
   }
-  else
+
+  nx_driver_information.nx_driver_information_receive_refill_index = index;
+
+  if (armed != 0U)
   {
-    /* Rx Buffer Pool is exhausted. */
-    *buff = NULL;
+
+    /* Resume the DMA in case it suspended on a descriptor it did not own.  */
+    __DSB();
+    (eth_handle.Instance) -> DMARPDR = 0U;
   }
 }
 
+#if NX_DRIVER_RX_COPY_BREAK > 0
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                                              */
 /*                                                                        */
-/*    HAL_ETH_RxLinkCallback                                              */
+/*    _nx_driver_hardware_receive_copy                                    */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function chains all received packets before passing            */
-/*    the first one to NetXDuo stack.                                     */
+/*    This function copies a short received frame into a packet of the   */
+/*    small RX packet pool, and keeps the full size packet to re-arm the  */
+/*    RX ring. The frame stays in its packet when the pool is empty.      */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    first_packet_ptr           pointer to first received packet         */
-/*    last_packet_ptr            pointer to last received packet          */
-/*    buff                       pointer to received data                 */
-/*    length                     received data length                     */
+/*    packet_ptr                            Received packet               */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
-/*    received packet pointer                                             */
+/*    packet_ptr                            Packet to pass to NetX        */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    nx_packet_allocate                    Allocate small packet         */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    HAL_ETH_ReadData              Read a received packet                */
+/*    _nx_driver_hardware_packet_received   RX ring processing            */
 /*                                                                        */
 /**************************************************************************/
-
-void HAL_ETH_RxLinkCallback(void **first_packet_ptr, void **last_packet_ptr, uint8_t *buff, uint16_t Length)
+static NX_PACKET  *_nx_driver_hardware_receive_copy(NX_PACKET *packet_ptr)
 {
-  NX_PACKET **first_nx_packet_ptr = (NX_PACKET **)first_packet_ptr;
-  NX_PACKET **last_nx_packet_ptr = (NX_PACKET **)last_packet_ptr;
-  NX_PACKET  *received_packet_ptr;
 
-  /* Indicate the offset of the received data.  */
-  uint8_t *data_buffer_ptr = buff - 2U - sizeof(NX_PACKET);
+  NX_PACKET       *copy_ptr;
 
-  received_packet_ptr = (NX_PACKET *)data_buffer_ptr;
-  received_packet_ptr->nx_packet_append_ptr = received_packet_ptr->nx_packet_prepend_ptr + Length;
-  received_packet_ptr->nx_packet_length = Length;
 
-  /* Check whether this is the first packet. */
-  if (*first_nx_packet_ptr == NULL)
-  {
-    /* Add the first buffer of the packet. */
-    *first_nx_packet_ptr = received_packet_ptr;
-  }
-  /* This is not the first packet. */
-  else
+  if (nx_packet_allocate(&nx_driver_information.nx_driver_information_receive_small_pool, &copy_ptr,
+                         NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
   {
-    /* Add the rest of the buffer to the end of the packet. */
-    (*last_nx_packet_ptr)->nx_packet_next = received_packet_ptr;
+    return(packet_ptr);
   }
-  /* Save the current packet in order to use it in the next iteration. */
-  *last_nx_packet_ptr  = received_packet_ptr;
+
+  /* Keep the IP header aligned as in the full size packets.  */
+  copy_ptr -> nx_packet_prepend_ptr += 2;
+  memcpy(copy_ptr -> nx_packet_prepend_ptr, packet_ptr -> nx_packet_prepend_ptr, packet_ptr -> nx_packet_length); /* Use case of memcpy is verified. */
+  copy_ptr -> nx_packet_append_ptr = copy_ptr -> nx_packet_prepend_ptr + packet_ptr -> nx_packet_length;
+  copy_ptr -> nx_packet_length = packet_ptr -> nx_packet_length;
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+  copy_ptr -> nx_packet_interface_capability_flag = packet_ptr -> nx_packet_interface_capability_flag;
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+#ifdef NX_DRIVER_ENABLE_PTP
+  copy_ptr -> nx_packet_packet_pad[0] = packet_ptr -> nx_packet_packet_pad[0];
+  copy_ptr -> nx_packet_packet_pad[1] = packet_ptr -> nx_packet_packet_pad[1];
+#endif
+
+  /* The ring refill after the poll loop takes it back.  */
+  packet_ptr -> nx_packet_queue_next = nx_driver_information.nx_driver_information_receive_recycle;
+  nx_driver_information.nx_driver_information_receive_recycle = packet_ptr;
+  nx_driver_information.nx_driver_information_receive_recycle_count++;
+
+  return(copy_ptr);
 }
+#endif /* NX_DRIVER_RX_COPY_BREAK > 0 */
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
 /**************************************************************************/
@@ -1968,6 +4277,10 @@ void HAL_ETH_RxLinkCallback(void **first_packet_ptr, void **last_packet_ptr, uin
 /*  DESCRIPTION                                                           */
 /*                                                                        */
 /*    This function processes hardware-specific capability set requests.  */
+/*    The requested capabilities are read from the return pointer, masked */
+/*    with the ones supported, applied to the MAC checksum offload engine */
+/*    and to the interface, then returned through the same pointer.       */
+/*    Requesting any RX capability enables all of them.                   */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -1979,7 +4292,7 @@ void HAL_ETH_RxLinkCallback(void **first_packet_ptr, void **last_packet_ptr, uin
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    HAL_Delay                             MACCR write back delay        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -1997,7 +4310,46 @@ void HAL_ETH_RxLinkCallback(void **first_packet_ptr, void **last_packet_ptr, uin
 static UINT _nx_driver_hardware_capability_set(NX_IP_DRIVER *driver_req_ptr)
 {
 
-  return NX_SUCCESS;
+  ULONG       capability;
+  uint32_t    tmpreg;
+
+
+  if (driver_req_ptr -> nx_ip_driver_return_ptr == NX_NULL)
+  {
+    return(NX_DRIVER_ERROR);
+  }
+
+  capability = *(driver_req_ptr -> nx_ip_driver_return_ptr) & NX_DRIVER_CAPABILITY;
+
+  if (capability & NX_DRIVER_RX_CAPABILITY)
+  {
+    capability |= NX_DRIVER_RX_CAPABILITY;
+  }
+
+  /* The checksum offload engine verifies the RX checksums and the DMA drops the frames
+     failing the check. The TX checksums are requested per descriptor. HAL_ETH_SetMACConfig
+     is only allowed while the MAC is stopped, so the registers are updated in place.  */
+  if (capability & NX_DRIVER_RX_CAPABILITY)
+  {
+    SET_BIT(eth_handle.Instance -> MACCR, ETH_MACCR_IPCO);
+    CLEAR_BIT(eth_handle.Instance -> DMAOMR, ETH_DMAOMR_DTCEFD);
+  }
+  else
+  {
+    CLEAR_BIT(eth_handle.Instance -> MACCR, ETH_MACCR_IPCO);
+    SET_BIT(eth_handle.Instance -> DMAOMR, ETH_DMAOMR_DTCEFD);
+  }
+
+  /* Wait until the write operation will be taken into account :
+     at least four TX_CLK/RX_CLK clock cycles */
+  tmpreg = eth_handle.Instance -> MACCR;
+  HAL_Delay(1);
+  eth_handle.Instance -> MACCR = tmpreg;
+
+  driver_req_ptr -> nx_ip_driver_interface -> nx_interface_capability_flag = capability;
+  *(driver_req_ptr -> nx_ip_driver_return_ptr) = capability;
+
+  return(NX_SUCCESS);
 }
 #endif /* NX_ENABLE_INTERFACE_CAPABILITY */
 
@@ -2005,16 +4357,10 @@ static UINT _nx_driver_hardware_capability_set(NX_IP_DRIVER *driver_req_ptr)
 void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
 {
 
-  ULONG deffered_events;
-  deffered_events = nx_driver_information.nx_driver_information_deferred_events;
-
-  nx_driver_information.nx_driver_information_deferred_events |= NX_DRIVER_DEFERRED_PACKET_RECEIVED;
+  /* Switch to polling: RX interrupts stay masked until the ring has been drained.  */
+  __HAL_ETH_DMA_DISABLE_IT(heth, ETH_DMAIER_RIE);
 
-  if (!deffered_events)
-  {
-    /* Call NetX deferred driver processing.  */
-    _nx_ip_driver_deferred_processing(nx_driver_information.nx_driver_information_ip_ptr);
-  }
+  _nx_driver_hardware_receive_poll_schedule();
 }
 
 void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
@@ -2032,4 +4378,16 @@ void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
   }
 }
 
+void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth)
+{
+
+  /* The RX DMA suspended on a descriptor left without a buffer, poll to re-arm it.  */
+  if ((heth -> DMAErrorCode & ETH_DMASR_RBUS) != 0U)
+  {
+    __HAL_ETH_DMA_DISABLE_IT(heth, ETH_DMAIER_RIE);
+
+    _nx_driver_hardware_receive_poll_schedule();
+  }
+}
+
 /****** DRIVER SPECIFIC ****** Start of part/vendor specific internal driver functions.  */
@@ -88,6 +88,182 @@ extern   "C" {
 #define NX_DRIVER_RX_DESCRIPTORS   ETH_RX_DESC_CNT
 #endif
 
+/* Define the classes of the frames waiting for transmit descriptors. The control class, ARP, the TCP
+   segments without data and the frames marked CS6, CS7 or EF, is always served first. The interactive
+   class, the frames marked CS3 to CS5 or AF3x and AF4x, and the bulk class, all the others, share the
+   ring by deficit round robin.  */
+#define NX_DRIVER_TX_CLASS_CONTROL       0
+#define NX_DRIVER_TX_CLASS_INTERACTIVE   1
+#define NX_DRIVER_TX_CLASS_BULK          2
+#define NX_DRIVER_TX_CLASSES             3
+
+/* Define the bytes the interactive and bulk classes may send per round, at least a full frame.  */
+#ifndef NX_DRIVER_TX_QUANTUM_INTERACTIVE
+#define NX_DRIVER_TX_QUANTUM_INTERACTIVE   (2 * NX_DRIVER_ETHERNET_MTU)
+#endif
+
+#ifndef NX_DRIVER_TX_QUANTUM_BULK
+#define NX_DRIVER_TX_QUANTUM_BULK          NX_DRIVER_ETHERNET_MTU
+#endif
+
+#if (NX_DRIVER_TX_QUANTUM_INTERACTIVE < NX_DRIVER_ETHERNET_MTU) || (NX_DRIVER_TX_QUANTUM_BULK < NX_DRIVER_ETHERNET_MTU)
+#error "NX_DRIVER_TX_QUANTUM_INTERACTIVE and NX_DRIVER_TX_QUANTUM_BULK must hold a full frame"
+#endif
+
+/* Define the number of transmit descriptors the interactive and bulk frames may hold, the others
+   are left to the control frames. Longer chains are coalesced into a single buffer.  */
+#ifndef NX_DRIVER_TX_SHARED_DESCRIPTORS
+#define NX_DRIVER_TX_SHARED_DESCRIPTORS   NX_DRIVER_TX_DESCRIPTORS
+#endif
+
+#if (NX_DRIVER_TX_SHARED_DESCRIPTORS < 1) || (NX_DRIVER_TX_SHARED_DESCRIPTORS > NX_DRIVER_TX_DESCRIPTORS)
+#error "NX_DRIVER_TX_SHARED_DESCRIPTORS must be between 1 and NX_DRIVER_TX_DESCRIPTORS"
+#endif
+
+/* Define the number of frames processed per deferred RX poll.  */
+
+#ifndef NX_DRIVER_RX_POLL_BUDGET
+#define NX_DRIVER_RX_POLL_BUDGET   8
+#endif
+
+/* Define the delay, in timer ticks, before the last RX poll that unmasks RX interrupts.  */
+
+#ifndef NX_DRIVER_RX_MITIGATION_TICKS
+#define NX_DRIVER_RX_MITIGATION_TICKS   0
+#endif
+
+/* Define the number of packets in the driver owned RX packet pool. 0 receives into the
+   IP instance default packet pool.  */
+
+#ifndef NX_DRIVER_RX_POOL_PACKETS
+#define NX_DRIVER_RX_POOL_PACKETS   0
+#endif
+
+/* Define the RX packet pool low watermark. TCP and UDP drop received frames instead of
+   queuing them while no more packets than this are available.  */
+
+#ifndef NX_DRIVER_RX_POOL_WATERMARK
+#define NX_DRIVER_RX_POOL_WATERMARK   NX_DRIVER_RX_DESCRIPTORS
+#endif
+
+/* Define the delay, in timer ticks, between attempts to re-arm RX descriptors left
+   without a buffer.  */
+
+#ifndef NX_DRIVER_RX_REFILL_TICKS
+#define NX_DRIVER_RX_REFILL_TICKS   1
+#endif
+
+/* Define the payload size of the driver owned RX packets, leaving room for the 2 bytes
+   alignment of the IP header.  */
+
+#define NX_DRIVER_RX_PACKET_PAYLOAD   (((ETH_RX_BUF_SIZE + 2) + 3) & ~3)
+
+/* Define the length, in bytes, up to which received frames are copied into a packet of
+   the small RX packet pool, so that the full size packet can re-arm its descriptor at
+   once. 0 passes every frame to NetX in the packet it was received into.  */
+
+#ifndef NX_DRIVER_RX_COPY_BREAK
+#define NX_DRIVER_RX_COPY_BREAK   0
+#endif
+
+/* Define the number of packets in the small RX packet pool of the copied frames.  */
+
+#ifndef NX_DRIVER_RX_SMALL_POOL_PACKETS
+#define NX_DRIVER_RX_SMALL_POOL_PACKETS   16
+#endif
+
+/* Define the payload size of the small RX packets, with the same 2 bytes offset.  */
+
+#define NX_DRIVER_RX_SMALL_PACKET_PAYLOAD   (((NX_DRIVER_RX_COPY_BREAK + 2) + 3) & ~3)
+
+/* Define the number of sent packets of the RX packet pool, such as the echo replies
+   built in the received frame, kept to re-arm the RX descriptors instead of being
+   released to the pool. 0 releases them all.  */
+
+#ifndef NX_DRIVER_TX_RECYCLE_PACKETS
+#define NX_DRIVER_TX_RECYCLE_PACKETS   4
+#endif
+
+/* Define the number of multicast groups tracked for the MAC address filter. The
+   frames of the groups joined beyond this number pass the filter with all the other
+   multicast frames.  */
+
+#ifndef NX_DRIVER_MULTICAST_GROUPS
+#define NX_DRIVER_MULTICAST_GROUPS   8
+#endif
+
+/* Define the number of MAC address registers, after the station address, matching
+   multicast groups exactly. The groups beyond them share the 64 bits hash table.  */
+
+#define NX_DRIVER_MULTICAST_PERFECT_SLOTS   3
+
+#ifdef NX_DRIVER_ICMP_ECHO_FAST_REPLY
+#ifndef NX_ENABLE_INTERFACE_CAPABILITY
+#error "NX_DRIVER_ICMP_ECHO_FAST_REPLY requires NX_ENABLE_INTERFACE_CAPABILITY, the replies rely on the RX checksum offload"
+#endif
+
+/* Define the sizes of the IPv4 header without options and of the ICMP echo header.  */
+
+#define NX_DRIVER_IPV4_HEADER_SIZE          20
+#define NX_DRIVER_ICMP_HEADER_SIZE          8
+#endif /* NX_DRIVER_ICMP_ECHO_FAST_REPLY */
+
+#ifdef NX_DRIVER_ENABLE_PTP
+#ifndef HAL_ETH_USE_PTP
+#error "NX_DRIVER_ENABLE_PTP requires HAL_ETH_USE_PTP in the HAL configuration"
+#endif
+#if !defined(NX_PACKET_HEADER_PAD) || (NX_PACKET_HEADER_PAD_SIZE < 2)
+#error "NX_DRIVER_ENABLE_PTP requires NX_PACKET_HEADER_PAD with NX_PACKET_HEADER_PAD_SIZE of at least 2"
+#endif
+
+/* Define the PTP clock sub-second increment in nanoseconds. The addend of the fine
+   update makes the clock advance by this step at 1 GHz / increment, 50 MHz, which must
+   be below the HCLK frequency.  */
+
+#define NX_DRIVER_PTP_SUBSECOND_INCREMENT   20U
+
+/* Define the bits of the enhanced RX descriptor status that replace the IPv4 header
+   and payload checksum errors: the time stamp is valid, the checksum status is in the
+   extended status word.  */
+
+#define NX_DRIVER_RX_TIMESTAMP_VALID        ETH_DMARXDESC_IPV4HCE
+#define NX_DRIVER_RX_EXTENDED_STATUS        ETH_DMARXDESC_MAMPCE
+#endif /* NX_DRIVER_ENABLE_PTP */
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+/* Define the bytes kept of each frame captured, from its Ethernet header, and the number of
+   frames the capture ring holds, a power of two. The oldest frames are overwritten.  */
+
+#ifndef NX_DRIVER_CAPTURE_SNAP_LENGTH
+#define NX_DRIVER_CAPTURE_SNAP_LENGTH       96U
+#endif
+
+#ifndef NX_DRIVER_CAPTURE_FRAMES
+#define NX_DRIVER_CAPTURE_FRAMES            64U
+#endif
+
+#if (NX_DRIVER_CAPTURE_FRAMES & (NX_DRIVER_CAPTURE_FRAMES - 1U)) != 0
+#error "NX_DRIVER_CAPTURE_FRAMES must be a power of two"
+#endif
+
+/* Define the placement attribute of the capture ring, only read and written by the CPU.  */
+
+#ifndef NX_DRIVER_CAPTURE_MEMORY
+#define NX_DRIVER_CAPTURE_MEMORY
+#endif
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+
+/* Define the position of the frame length, CRC included, in the RX descriptor status.  */
+
+#define NX_DRIVER_RX_FRAME_LENGTH_SHIFT   16U
+
+/* Define the placement attribute of the memory the Ethernet DMA reads and writes,
+   by default the compiler and linker choose.  */
+
+#ifndef NX_DRIVER_DMA_MEMORY
+#define NX_DRIVER_DMA_MEMORY
+#endif
+
 /****** DRIVER SPECIFIC ****** End of part/vendor specific constant area!  */
 
 #define NX_DRIVER_CAPABILITY ( NX_INTERFACE_CAPABILITY_IPV4_TX_CHECKSUM   | \
@@ -101,10 +277,44 @@ extern   "C" {
                                NX_INTERFACE_CAPABILITY_ICMPV6_TX_CHECKSUM | \
                                NX_INTERFACE_CAPABILITY_ICMPV6_RX_CHECKSUM )
 
+/* The MAC verifies all the RX checksums at once, so the RX capabilities can only be
+   enabled or disabled together. The TX capabilities are applied per packet.  */
+#define NX_DRIVER_RX_CAPABILITY ( NX_INTERFACE_CAPABILITY_IPV4_RX_CHECKSUM   | \
+                                  NX_INTERFACE_CAPABILITY_TCP_RX_CHECKSUM    | \
+                                  NX_INTERFACE_CAPABILITY_UDP_RX_CHECKSUM    | \
+                                  NX_INTERFACE_CAPABILITY_ICMPV4_RX_CHECKSUM | \
+                                  NX_INTERFACE_CAPABILITY_ICMPV6_RX_CHECKSUM )
+
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+/* Define a frame of the capture ring, its first four words are the pcap record header.  */
+
+typedef struct NX_DRIVER_CAPTURE_RECORD_STRUCT
+{
+    ULONG               nx_driver_capture_seconds;
+    ULONG               nx_driver_capture_microseconds;
+    ULONG               nx_driver_capture_captured_length;
+    ULONG               nx_driver_capture_length;
+    UCHAR               nx_driver_capture_data[NX_DRIVER_CAPTURE_SNAP_LENGTH];
+
+}   NX_DRIVER_CAPTURE_RECORD;
+#endif /* NX_DRIVER_ENABLE_CAPTURE */
+
 
 /* Define basic Ethernet driver information typedef. Note that this typedefs is designed to be used only
    in the driver's C file. */
 
+typedef struct NX_DRIVER_MULTICAST_GROUP_STRUCT
+{
+    /* Define the group MAC address, as given by NetX.  */
+    ULONG               nx_driver_multicast_group_msw;
+    ULONG               nx_driver_multicast_group_lsw;
+
+    /* Define the number of joins of the group, 0 for a free entry.  */
+    UINT                nx_driver_multicast_group_joins;
+
+}   NX_DRIVER_MULTICAST_GROUP;
+
 typedef struct NX_DRIVER_INFORMATION_STRUCT
 {
     /* NetX IP instance that this driver is attached to.  */
@@ -133,6 +343,12 @@ typedef struct NX_DRIVER_INFORMATION_STRUCT
     /* Transmit release index.  */
     UINT                nx_driver_information_transmit_release_index;
 
+    /* Receive refill index, the first of the descriptors left without a packet.  */
+    UINT                nx_driver_information_receive_refill_index;
+
+    /* Define the number of receive descriptors without a packet, they follow the refill index.  */
+    UINT                nx_driver_information_receive_empty_count;
+
     /* Define the number of transmit buffers in use.  */
     UINT                nx_driver_information_number_of_transmit_buffers_in_use;
 
@@ -140,11 +356,65 @@ typedef struct NX_DRIVER_INFORMATION_STRUCT
     NX_PACKET           *nx_driver_information_transmit_packets[NX_DRIVER_TX_DESCRIPTORS];
     NX_PACKET           *nx_driver_information_receive_packets[NX_DRIVER_RX_DESCRIPTORS];
 
+    /* Define the queues of frames waiting for free transmit descriptors, one per class, the
+       bytes each class may still send in its round, and the class whose round it is.  */
+    NX_PACKET           *nx_driver_information_transmit_queue_head[NX_DRIVER_TX_CLASSES];
+    NX_PACKET           *nx_driver_information_transmit_queue_tail[NX_DRIVER_TX_CLASSES];
+    ULONG               nx_driver_information_transmit_deficit[NX_DRIVER_TX_CLASSES];
+    UINT                nx_driver_information_transmit_round_class;
+
+#if NX_DRIVER_RX_MITIGATION_TICKS > 0
+    /* Define the timer scheduling the last RX poll before RX interrupts are unmasked.  */
+    TX_TIMER            nx_driver_information_rx_mitigation_timer;
+#endif
+
+    /* Define the timer retrying to re-arm RX descriptors when the pool was empty.  */
+    TX_TIMER            nx_driver_information_rx_refill_timer;
+
+#if NX_DRIVER_RX_POOL_PACKETS > 0
+    /* Define the packet pool dedicated to the RX descriptors.  */
+    NX_PACKET_POOL      nx_driver_information_receive_pool;
+#endif
+
+#if NX_DRIVER_RX_COPY_BREAK > 0
+    /* Define the packet pool the short received frames are copied into.  */
+    NX_PACKET_POOL      nx_driver_information_receive_small_pool;
+#endif
+
+    /* Define the list of the RX packets whose frame was copied, and of the sent packets
+       kept from the RX pool, they re-arm the ring first.  */
+    NX_PACKET           *nx_driver_information_receive_recycle;
+    UINT                nx_driver_information_receive_recycle_count;
+
     /* Define the size of a rx buffer size.  */
     ULONG               nx_driver_information_rx_buffer_size;
 
     ULONG               nx_driver_information_multicast_count;
 
+    /* Define the joined multicast groups, and the number of joins that did not fit.  */
+    NX_DRIVER_MULTICAST_GROUP
+                        nx_driver_information_multicast_groups[NX_DRIVER_MULTICAST_GROUPS];
+    UINT                nx_driver_information_multicast_overflow;
+
+    /* Define the statistics returned by the NX_LINK_GET_*_COUNT requests: the frames passed to NetX,
+       the frames sent, the frames dropped in error or missed by the DMA, and the failed RX packet allocations.  */
+    ULONG               nx_driver_information_receive_count;
+    ULONG               nx_driver_information_transmit_count;
+    ULONG               nx_driver_information_receive_error_count;
+    ULONG               nx_driver_information_allocation_errors;
+
+#ifdef NX_DRIVER_ENABLE_PTP
+    /* Define the routine getting the time of transmission of the sent frames.  */
+    VOID                (*nx_driver_information_transmit_timestamp_notify)(NX_PACKET *packet_ptr, ULONG seconds, ULONG nanoseconds);
+#endif
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+    /* Define the capture switch, and the free running count of the frames captured, the next
+       record of the ring to write once masked.  */
+    UINT                nx_driver_information_capture_enabled;
+    ULONG               nx_driver_information_capture_count;
+#endif
+
     /****** DRIVER SPECIFIC ****** End of part/vendor specific driver information area.  */
 
 }   NX_DRIVER_INFORMATION;
@@ -160,6 +430,21 @@ typedef struct NX_DRIVER_INFORMATION_STRUCT
 
 VOID  nx_stm32_eth_driver(NX_IP_DRIVER *driver_req_ptr);
 
+#ifdef NX_DRIVER_ENABLE_PTP
+/* Define the IEEE 1588 time stamp functions, the times are those of the PTP clock.  */
+
+UINT  nx_stm32_eth_time_get(ULONG *seconds_ptr, ULONG *nanoseconds_ptr);
+UINT  nx_stm32_eth_packet_timestamp_get(NX_PACKET *packet_ptr, ULONG *seconds_ptr, ULONG *nanoseconds_ptr);
+VOID  nx_stm32_eth_transmit_timestamp_notify_set(VOID (*notify)(NX_PACKET *packet_ptr, ULONG seconds, ULONG nanoseconds));
+#endif
+
+#ifdef NX_DRIVER_ENABLE_CAPTURE
+/* Define the frame capture functions, the records read are those of the pcap format.  */
+
+VOID  nx_stm32_eth_capture_enable(UINT enable);
+UINT  nx_stm32_eth_capture_read(ULONG *sequence_ptr, VOID *buffer_ptr, ULONG buffer_size, ULONG *length_ptr);
+#endif
+
 /****** DRIVER SPECIFIC ****** End of part/vendor specific external function prototypes.  */
 
 
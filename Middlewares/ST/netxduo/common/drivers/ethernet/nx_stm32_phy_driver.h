@@ -31,6 +31,10 @@ extern   "C" {
 #define  ETH_PHY_STATUS_10MBITS_HALFDUPLEX    ((int32_t) 5)
 #define  ETH_PHY_STATUS_AUTONEGO_NOT_DONE     ((int32_t) 6)
 
+/* The link carries frames, negotiated or forced. */
+#define  ETH_PHY_LINK_IS_UP(linkstate)        (((linkstate) > ETH_PHY_STATUS_LINK_DOWN) && \
+                                               ((linkstate) != ETH_PHY_STATUS_AUTONEGO_NOT_DONE))
+
 typedef void * 	nx_eth_phy_handle_t;
 
 int32_t nx_eth_phy_init(void);
@@ -41,6 +45,8 @@ int32_t nx_eth_phy_set_link_state(int32_t linkstate);
 
 nx_eth_phy_handle_t nx_eth_phy_get_handle(void);
 
+int32_t nx_eth_phy_interrupt_clear(void);
+
 #ifdef   __cplusplus
 }
 #endif
@@ -227,6 +227,11 @@ extern   "C" {
 #endif
 #endif
 
+/* Define the copy of the data between packets and application buffers.  */
+#ifndef NX_PACKET_DATA_COPY
+#define NX_PACKET_DATA_COPY                                 memcpy
+#endif
+
 
 /* Define the max string length.  */
 #ifndef NX_MAX_STRING_LENGTH
@@ -997,6 +1002,17 @@ VOID _nx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define NX_IPV6_ADDR_STATE_PREFERRED           0x02
 #define NX_IPV6_ADDR_STATE_DEPRECATED          0x03
 #define NX_IPV6_ADDR_STATE_VALID               0x04
+#define NX_IPV6_ADDR_STATE_OPTIMISTIC          0x05
+
+/* Define the checks of the IPv6 address state.  An optimistic address (RFC 4429) is used
+   as a valid address while it is still under DAD as a tentative address.  */
+#ifdef NX_IPV6_OPTIMISTIC_DAD
+#define NX_IPV6_ADDR_STATE_USABLE(state)       (((state) == NX_IPV6_ADDR_STATE_VALID) || ((state) == NX_IPV6_ADDR_STATE_OPTIMISTIC))
+#define NX_IPV6_ADDR_STATE_UNDER_DAD(state)    (((state) == NX_IPV6_ADDR_STATE_TENTATIVE) || ((state) == NX_IPV6_ADDR_STATE_OPTIMISTIC))
+#else
+#define NX_IPV6_ADDR_STATE_USABLE(state)       ((state) == NX_IPV6_ADDR_STATE_VALID)
+#define NX_IPV6_ADDR_STATE_UNDER_DAD(state)    ((state) == NX_IPV6_ADDR_STATE_TENTATIVE)
+#endif /* NX_IPV6_OPTIMISTIC_DAD */
 
 
 
@@ -1118,6 +1134,12 @@ typedef struct NX_IPV6_DESTINATION_ENTRY_STRUCT
     /* MTU Timeout value. */
     ULONG nx_ipv6_destination_entry_MTU_timer_tick;
 #endif
+
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+
+    /* Use count of the IP instance when this entry was last found. */
+    ULONG nx_ipv6_destination_entry_last_used;
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
 } NX_IPV6_DESTINATION_ENTRY;
 
 /* Define data structure for IPv6 prefix table. */
@@ -1178,6 +1200,24 @@ typedef struct NX_IPV6_DEFAULT_ROUTER_ENTRY_STRUCT
 #define NX_TCP_PORT_TABLE_MASK                     (NX_TCP_PORT_TABLE_SIZE - 1)
 
 
+/* Define the constants that determine how big the hash table is for TCP connections, when
+   NX_ENABLE_TCP_CONNECTION_TABLE is defined.  The value must be a power of two, so
+   subtracting one gives us the mask.  */
+
+#ifndef NX_TCP_CONNECTION_TABLE_SIZE
+#define NX_TCP_CONNECTION_TABLE_SIZE               32
+#endif
+#define NX_TCP_CONNECTION_TABLE_MASK               (NX_TCP_CONNECTION_TABLE_SIZE - 1)
+
+
+/* Define the number of ranges selectively acknowledged by the peer that a TCP socket
+   remembers, when NX_ENABLE_TCP_SACK is defined.  */
+
+#ifndef NX_TCP_SACK_SCOREBOARD_SIZE
+#define NX_TCP_SACK_SCOREBOARD_SIZE                8
+#endif
+
+
 /* Define the maximum number of multicast groups the system can support.  This might
    be further limited by the underlying physical hardware.  */
 
@@ -1355,6 +1395,11 @@ typedef struct NX_IPV6_DEFAULT_ROUTER_ENTRY_STRUCT
 #define NX_INTERFACE_CAPABILITY_IGMP_RX_CHECKSUM   0x00000800
 #define NX_INTERFACE_CAPABILITY_PTP_TIMESTAMP      0x00001000
 #define NX_INTERFACE_CAPABILITY_TCPIP_OFFLOAD      0x00002000
+
+/* Set by the driver in the capability flag of a received packet whose payload
+   checksum could not be verified by the hardware, for example an IP fragment.
+   The RX checksum capabilities of the interface are then ignored for this packet.  */
+#define NX_INTERFACE_CAPABILITY_RX_CHECKSUM_BYPASS 0x00004000
 #define NX_INTERFACE_CAPABILITY_CHECKSUM_ALL       (NX_INTERFACE_CAPABILITY_IPV4_TX_CHECKSUM | \
                                                     NX_INTERFACE_CAPABILITY_IPV4_RX_CHECKSUM | \
                                                     NX_INTERFACE_CAPABILITY_TCP_TX_CHECKSUM | \
@@ -1619,6 +1664,45 @@ typedef  struct NX_PACKET_STRUCT
 } NX_PACKET;
 
 
+/* Define the caller classes that packet pool allocation failures are accounted to.
+   Driver receive, TCP transmit and other allocations are told apart by the packet
+   type offset.  MQTT and TLS record their failures through
+   NX_PACKET_POOL_CALLER_FAILURE, on top of the TCP transmit count.  */
+#define NX_PACKET_POOL_CALLER_DRIVER_RX         0
+#define NX_PACKET_POOL_CALLER_TCP_TX            1
+#define NX_PACKET_POOL_CALLER_MQTT              2
+#define NX_PACKET_POOL_CALLER_TLS               3
+#define NX_PACKET_POOL_CALLER_OTHER             4
+#define NX_PACKET_POOL_CALLERS                  5
+
+/* Define the number of released chain length buckets.  The last bucket
+   counts every chain of that length and longer.  */
+#ifndef NX_PACKET_POOL_CHAIN_BUCKETS
+#define NX_PACKET_POOL_CHAIN_BUCKETS            4
+#endif /* NX_PACKET_POOL_CHAIN_BUCKETS */
+
+/* Define the packet pool statistics returned by nx_packet_pool_stats_get.  */
+
+typedef struct NX_PACKET_POOL_STATS_STRUCT
+{
+
+    /* Define the lowest number of available packets seen.  */
+    ULONG       nx_packet_pool_stats_min_free;
+
+    /* Define the allocation failures per caller class.  */
+    ULONG       nx_packet_pool_stats_failures[NX_PACKET_POOL_CALLERS];
+
+    /* Define the number of suspended allocations, along with the total and
+       the longest time, in ticks, spent blocked in them.  */
+    ULONG       nx_packet_pool_stats_blocked_count;
+    ULONG       nx_packet_pool_stats_blocked_ticks;
+    ULONG       nx_packet_pool_stats_blocked_ticks_max;
+
+    /* Define the histogram of chain lengths of the released packets.  */
+    ULONG       nx_packet_pool_stats_chain_histogram[NX_PACKET_POOL_CHAIN_BUCKETS];
+} NX_PACKET_POOL_STATS;
+
+
 /* Define the Packet Pool control block that will be used to manage each individual
    packet pool.  */
 
@@ -1667,10 +1751,36 @@ typedef struct NX_PACKET_POOL_STRUCT
 #ifdef NX_ENABLE_LOW_WATERMARK
     /* Low watermark. */
     UINT        nx_packet_pool_low_watermark;
+
+    /* Define the watermark notification, see nx_packet_pool_watermark_notify.  */
+    ULONG       nx_packet_pool_watermark_low;
+    ULONG       nx_packet_pool_watermark_high;
+    UINT        nx_packet_pool_watermark_is_low;
+    VOID      (*nx_packet_pool_watermark_notify)(struct NX_PACKET_POOL_STRUCT *pool_ptr, UINT is_low);
 #endif /* NX_ENABLE_LOW_WATERMARK */
+
+    /* Define the size class list the pool belongs to, see nx_packet_pool_class_set.  */
+    struct NX_PACKET_POOL_STRUCT
+               *nx_packet_pool_class_first,
+               *nx_packet_pool_class_next;
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    /* Define the occupancy and allocation latency statistics.  */
+    NX_PACKET_POOL_STATS
+                nx_packet_pool_stats;
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
 } NX_PACKET_POOL;
 
 
+/* Define the hook used by protocols above TCP to account a failed allocation.  */
+VOID _nx_packet_pool_caller_failure(NX_PACKET_POOL *pool_ptr, UINT caller);
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+#define NX_PACKET_POOL_CALLER_FAILURE(p, c)     _nx_packet_pool_caller_failure(p, c)
+#else
+#define NX_PACKET_POOL_CALLER_FAILURE(p, c)
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+
 #ifndef NX_DISABLE_IPV4
 /* Define the Address Resolution Protocol (ARP) structure that makes up the
    route table in each IP instance.  This is how IP addresses are translated
@@ -1825,12 +1935,33 @@ typedef struct NX_UDP_SOCKET_STRUCT
     VOID        *nx_udp_socket_tcpip_offload_context;
 #endif /* NX_ENABLE_TCPIP_OFFLOAD */
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* Define the route of the last IPv4 destination sent to: its address, the outgoing
+       interface, the next hop, and the route generation of the IP instance it is valid for.  */
+    ULONG       nx_udp_socket_route_address;
+    struct NX_INTERFACE_STRUCT
+                *nx_udp_socket_route_interface;
+    ULONG       nx_udp_socket_route_next_hop;
+    ULONG       nx_udp_socket_route_generation;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
     /* Define the port extension in the UDP socket control block. This 
        is typically defined to whitespace in nx_port.h.  */
     NX_UDP_SOCKET_MODULE_EXTENSION
     
 } NX_UDP_SOCKET;
 
+/* Define the datagram returned by nx_udp_socket_receive_batch, the packet with its source.  */
+
+typedef struct NX_UDP_DATAGRAM_STRUCT
+{
+
+    NX_PACKET  *nx_udp_datagram_packet_ptr;
+    NXD_ADDRESS nx_udp_datagram_source_address;
+    UINT        nx_udp_datagram_source_port;
+    UINT        nx_udp_datagram_interface_index;
+} NX_UDP_DATAGRAM;
+
 
 /* Determine if the TCP control block has an extension defined. If not, 
    define the extension to whitespace.  */
@@ -1912,6 +2043,12 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_socket_rx_window_current;
     ULONG       nx_tcp_socket_rx_window_last_sent;
 
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+    /* Define the pool of the received segments, whose free packets cap the window advertised.  */
+    struct NX_PACKET_POOL_STRUCT
+                *nx_tcp_socket_rx_window_pool;
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+
     /* Define the statistic and error counters for this TCP socket.  */
     ULONG       nx_tcp_socket_packets_sent;
     ULONG       nx_tcp_socket_bytes_sent;
@@ -1961,6 +2098,21 @@ typedef struct NX_TCP_SOCKET_STRUCT
     NX_PACKET   *nx_tcp_socket_transmit_sent_head,
                 *nx_tcp_socket_transmit_sent_tail;
 
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+    /* Define the packet not sent yet, small sends are appended to it while
+       the data sent is waiting to be acknowledged.  */
+    NX_PACKET   *nx_tcp_socket_coalesce_packet;
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* Define the packets queued by sends that would have suspended, and the
+       routine called once they are all sent.  */
+    NX_PACKET   *nx_tcp_socket_send_pending_head,
+                *nx_tcp_socket_send_pending_tail;
+    ULONG        nx_tcp_socket_send_pending_count;
+    VOID        (*nx_tcp_socket_send_notify)(struct NX_TCP_SOCKET_STRUCT *socket_ptr);
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+
     /* Define the maximum TCP packet receive queue. */
 #ifdef NX_ENABLE_LOW_WATERMARK
     ULONG   nx_tcp_socket_receive_queue_maximum;
@@ -1975,6 +2127,21 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_socket_timeout_max_retries;
     ULONG       nx_tcp_socket_timeout_shift;
 
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+    /* Timeout rate configured, each connection starts with it until the round trip is measured.  */
+    ULONG       nx_tcp_socket_timeout_rate_initial;
+
+    /* Smoothed round trip time scaled by 8 and its variation scaled by 4, in ticks.
+       A zero smoothed round trip time indicates no sample has been taken yet.  */
+    ULONG       nx_tcp_socket_rtt_smoothed;
+    ULONG       nx_tcp_socket_rtt_variance;
+
+    /* Segment being timed: the sequence its ACK covers and the time it was sent.  */
+    UINT        nx_tcp_socket_rtt_timing;
+    ULONG       nx_tcp_socket_rtt_sequence;
+    ULONG       nx_tcp_socket_rtt_time;
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
+
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
     /* Local receive window size, when user creates the TCP socket. */
     ULONG       nx_tcp_socket_rx_window_maximum;
@@ -1986,6 +2153,32 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_snd_win_scale_value;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Whether SACK is offered in our SYN, or was offered by the peer.  */
+    UINT        nx_tcp_socket_sack_permitted;
+
+    /* Ranges the peer selectively acknowledged, sorted by sequence and not overlapping.  */
+    UINT        nx_tcp_socket_sack_count;
+    ULONG       nx_tcp_socket_sack_left_edge[NX_TCP_SACK_SCOREBOARD_SIZE];
+    ULONG       nx_tcp_socket_sack_right_edge[NX_TCP_SACK_SCOREBOARD_SIZE];
+
+    /* End of the data retransmitted in the current fast recovery.  */
+    ULONG       nx_tcp_socket_sack_retransmit_sequence;
+
+    /* Start of the last out of order segment received, reported in the first SACK block.  */
+    ULONG       nx_tcp_socket_sack_last_sequence;
+#endif /* NX_ENABLE_TCP_SACK */
+
+#ifdef NX_ENABLE_TCP_QUICKACK
+    /* Number of segments acknowledged immediately once the connection is established,
+       and the number of them still to receive.  */
+    UINT        nx_tcp_socket_quickack_segments;
+    UINT        nx_tcp_socket_quickack_remaining;
+
+    /* Largest segment with the PSH bit that is acknowledged immediately.  */
+    ULONG       nx_tcp_socket_quickack_push_size;
+#endif /* NX_ENABLE_TCP_QUICKACK */
+
     /* Define the TCP keepalive timer parameters.  If enabled with NX_ENABLE_TCP_KEEPALIVE,
        these parameters are used to implement the keepalive timer.  */
 #ifdef NX_ENABLE_TCP_KEEPALIVE
@@ -1999,6 +2192,14 @@ typedef struct NX_TCP_SOCKET_STRUCT
                 *nx_tcp_socket_bound_next,
                 *nx_tcp_socket_bound_previous;
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+    /* Define the TCP connection list, the sockets on the same index of the connection
+       table, and the index the socket is on.  */
+    struct NX_TCP_SOCKET_STRUCT
+                *nx_tcp_socket_connection_next;
+    UINT        nx_tcp_socket_connection_index;
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
     /* Define the TCP socket bind suspension thread pointer.  This pointer points
        to the thread that that is suspended attempting to bind to a port that is
        already bound to another socket.  */
@@ -2437,6 +2638,11 @@ typedef struct NX_IP_STRUCT
 
     /* Define the destination table size. */
     UINT        nx_ipv6_destination_table_size;
+
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+    /* Define the count of destination table lookups, it orders the entries by last use. */
+    ULONG       nx_ipv6_destination_use_count;
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
 #endif /* FEATURE_NX_IPV6 */
 
     /* Define the statistic and error counters for this IP instance.   */
@@ -2596,10 +2802,18 @@ typedef struct NX_IP_STRUCT
        reassembles IP messages, and helps handle TCP/IP packets.  */
     TX_THREAD   nx_ip_thread;
 
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+    /* Define the events pending for the IP helper thread, and the semaphore
+       that wakes it up when the first of them is posted.  */
+    ULONG       nx_ip_events_pending;
+    TX_SEMAPHORE
+                nx_ip_events_semaphore;
+#else
     /* Define the IP event flags that are used to stimulate the IP helper
        thread.  */
     TX_EVENT_FLAGS_GROUP
                 nx_ip_events;
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
 
     /* Define the IP periodic timer for this IP instance.  */
     TX_TIMER    nx_ip_periodic_timer;
@@ -2752,6 +2966,15 @@ typedef struct NX_IP_STRUCT
     struct NX_TCP_SOCKET_STRUCT
                 *nx_ip_tcp_port_table[NX_TCP_PORT_TABLE_SIZE];
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+    /* Define the TCP connection table, the connected sockets hashed by their ports and
+       peer address, and the connection a segment was last received for.  */
+    struct NX_TCP_SOCKET_STRUCT
+                *nx_ip_tcp_connection_table[NX_TCP_CONNECTION_TABLE_SIZE];
+    struct NX_TCP_SOCKET_STRUCT
+                *nx_ip_tcp_connection_cache;
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
     /* Define the head pointer of the created TCP socket list.  */
     struct NX_TCP_SOCKET_STRUCT
                 *nx_ip_tcp_created_sockets_ptr;
@@ -2802,6 +3025,12 @@ typedef struct NX_IP_STRUCT
        this IP instance.  */
     TX_TIMER    nx_ip_fast_periodic_timer;
 
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+    /* Define a flag indicating the fast periodic timer is stopped until the
+       next TCP event arms it again.  */
+    UINT        nx_ip_fast_periodic_timer_idle;
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
+
 #ifndef NX_DISABLE_IPV4
     /* Define the destination routing information associated with this IP
        instance.  */
@@ -2907,6 +3136,13 @@ typedef struct NX_IP_STRUCT
 #endif /* NX_ENABLE_IP_STATIC_ROUTING */
 #endif /* !NX_DISABLE_IPV4  */
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* Define the route generation, incremented each time the IPv4 addresses, the
+       gateway or the static routes change, so the routes cached by the UDP sockets
+       are no longer used.  */
+    ULONG       nx_ip_route_generation;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
 #ifdef FEATURE_NX_IPV6
 
     /* Number of valid entries in the IPv6 default router table. */
@@ -3166,6 +3402,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 
 /* APIs for packet pool. */
 #define nx_packet_allocate                              _nx_packet_allocate
+#define nx_packet_allocate_bulk                         _nx_packet_allocate_bulk
 #define nx_packet_copy                                  _nx_packet_copy
 #define nx_packet_data_append                           _nx_packet_data_append
 #define nx_packet_data_extract_offset                   _nx_packet_data_extract_offset
@@ -3175,7 +3412,12 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_packet_pool_delete                           _nx_packet_pool_delete
 #define nx_packet_pool_info_get                         _nx_packet_pool_info_get
 #define nx_packet_pool_low_watermark_set                _nx_packet_pool_low_watermark_set
+#define nx_packet_pool_watermark_notify                 _nx_packet_pool_watermark_notify
+#define nx_packet_pool_class_set                        _nx_packet_pool_class_set
+#define nx_packet_size_allocate                         _nx_packet_size_allocate
+#define nx_packet_pool_stats_get                        _nx_packet_pool_stats_get
 #define nx_packet_release                               _nx_packet_release
+#define nx_packet_release_chain_bulk                    _nx_packet_release_chain_bulk
 #define nx_packet_transmit_release                      _nx_packet_transmit_release
 
 /* APIs for RARP. */
@@ -3196,6 +3438,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_tcp_server_socket_relisten                   _nx_tcp_server_socket_relisten
 #define nx_tcp_server_socket_unaccept                   _nx_tcp_server_socket_unaccept
 #define nx_tcp_server_socket_unlisten                   _nx_tcp_server_socket_unlisten
+#define nx_tcp_socket_ack_policy_set                    _nx_tcp_socket_ack_policy_set
 #define nx_tcp_socket_bytes_available                   _nx_tcp_socket_bytes_available
 #define nx_tcp_socket_create                            _nx_tcp_socket_create
 #define nx_tcp_socket_delete                            _nx_tcp_socket_delete
@@ -3209,9 +3452,13 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_tcp_socket_peer_info_get                     _nx_tcp_socket_peer_info_get
 #define nx_tcp_socket_queue_depth_notify_set            _nx_tcp_socket_queue_depth_notify_set
 #define nx_tcp_socket_receive                           _nx_tcp_socket_receive
+#define nx_tcp_socket_receive_chain                     _nx_tcp_socket_receive_chain
 #define nx_tcp_socket_receive_notify                    _nx_tcp_socket_receive_notify
 #define nx_tcp_socket_receive_queue_max_set             _nx_tcp_socket_receive_queue_max_set
 #define nx_tcp_socket_send                              _nx_tcp_socket_send
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+#define nx_tcp_socket_send_notify_set                   _nx_tcp_socket_send_notify_set
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 #define nx_tcp_socket_state_wait                        _nx_tcp_socket_state_wait
 #define nx_tcp_socket_timed_wait_callback               _nx_tcp_socket_timed_wait_callback
 #define nx_tcp_socket_transmit_configure                _nx_tcp_socket_transmit_configure
@@ -3234,6 +3481,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_udp_socket_info_get                          _nx_udp_socket_info_get
 #define nx_udp_socket_port_get                          _nx_udp_socket_port_get
 #define nx_udp_socket_receive                           _nx_udp_socket_receive
+#define nx_udp_socket_receive_batch                     _nx_udp_socket_receive_batch
 #define nx_udp_socket_receive_notify                    _nx_udp_socket_receive_notify
 #define nx_udp_socket_send                              _nx_udp_socket_send
 #define nx_udp_socket_source_send                       _nx_udp_socket_source_send
@@ -3354,6 +3602,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 
 /* APIs for packet pool. */
 #define nx_packet_allocate                              _nxe_packet_allocate
+#define nx_packet_allocate_bulk                         _nxe_packet_allocate_bulk
 #define nx_packet_copy                                  _nxe_packet_copy
 #define nx_packet_data_append                           _nxe_packet_data_append
 #define nx_packet_data_extract_offset                   _nxe_packet_data_extract_offset
@@ -3363,7 +3612,12 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_packet_pool_delete                           _nxe_packet_pool_delete
 #define nx_packet_pool_info_get                         _nxe_packet_pool_info_get
 #define nx_packet_pool_low_watermark_set                _nxe_packet_pool_low_watermark_set
+#define nx_packet_pool_watermark_notify                 _nxe_packet_pool_watermark_notify
+#define nx_packet_pool_class_set                        _nxe_packet_pool_class_set
+#define nx_packet_size_allocate                         _nxe_packet_size_allocate
+#define nx_packet_pool_stats_get                        _nxe_packet_pool_stats_get
 #define nx_packet_release(p)                            _nxe_packet_release(&p)
+#define nx_packet_release_chain_bulk(p)                 _nxe_packet_release_chain_bulk(&p)
 #define nx_packet_transmit_release(p)                   _nxe_packet_transmit_release(&p)
 
 /* APIs for RARP. */
@@ -3384,6 +3638,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_tcp_server_socket_relisten                   _nxe_tcp_server_socket_relisten
 #define nx_tcp_server_socket_unaccept                   _nxe_tcp_server_socket_unaccept
 #define nx_tcp_server_socket_unlisten                   _nxe_tcp_server_socket_unlisten
+#define nx_tcp_socket_ack_policy_set                    _nxe_tcp_socket_ack_policy_set
 #define nx_tcp_socket_bytes_available                   _nxe_tcp_socket_bytes_available
 #define nx_tcp_socket_create(i, s, n, t, f, l, w, u, d) _nxe_tcp_socket_create(i, s, n, t, f, l, w, u, d, sizeof(NX_TCP_SOCKET))
 #define nx_tcp_socket_delete                            _nxe_tcp_socket_delete
@@ -3397,9 +3652,13 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_tcp_socket_peer_info_get                     _nxe_tcp_socket_peer_info_get
 #define nx_tcp_socket_queue_depth_notify_set            _nxe_tcp_socket_queue_depth_notify_set
 #define nx_tcp_socket_receive                           _nxe_tcp_socket_receive
+#define nx_tcp_socket_receive_chain                     _nxe_tcp_socket_receive_chain
 #define nx_tcp_socket_receive_notify                    _nxe_tcp_socket_receive_notify
 #define nx_tcp_socket_receive_queue_max_set             _nxe_tcp_socket_receive_queue_max_set
 #define nx_tcp_socket_send(s, p, t)                     _nxe_tcp_socket_send(s, &p, t)
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+#define nx_tcp_socket_send_notify_set                   _nxe_tcp_socket_send_notify_set
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 #define nx_tcp_socket_state_wait                        _nxe_tcp_socket_state_wait
 #define nx_tcp_socket_timed_wait_callback               _nxe_tcp_socket_timed_wait_callback
 #define nx_tcp_socket_transmit_configure                _nxe_tcp_socket_transmit_configure
@@ -3421,6 +3680,7 @@ typedef struct NX_IP_DRIVER_STRUCT
 #define nx_udp_socket_info_get                          _nxe_udp_socket_info_get
 #define nx_udp_socket_port_get                          _nxe_udp_socket_port_get
 #define nx_udp_socket_receive                           _nxe_udp_socket_receive
+#define nx_udp_socket_receive_batch                     _nxe_udp_socket_receive_batch
 #define nx_udp_socket_receive_notify                    _nxe_udp_socket_receive_notify
 #define nx_udp_socket_send(s, p, i, t)                  _nxe_udp_socket_send(s, &p, i, t)
 #define nx_udp_socket_source_send(s, p, i, t, a)        _nxe_udp_socket_source_send(s, &p, i, t, a)
@@ -3603,6 +3863,8 @@ UINT nxd_nd_cache_ip_address_find(NX_IP *ip_ptr, NXD_ADDRESS *ip_address,
 /* APIs for packet pool. */
 UINT nx_packet_allocate(NX_PACKET_POOL *pool_ptr,  NX_PACKET **packet_ptr,
                         ULONG packet_type, ULONG wait_option);
+UINT nx_packet_allocate_bulk(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_array,
+                             ULONG packet_type, UINT count, UINT *allocated_count);
 UINT nx_packet_copy(NX_PACKET *packet_ptr, NX_PACKET **new_packet_ptr,
                     NX_PACKET_POOL *pool_ptr, ULONG wait_option);
 UINT nx_packet_data_append(NX_PACKET *packet_ptr, VOID *data_start, ULONG data_size,
@@ -3623,11 +3885,19 @@ UINT nx_packet_pool_info_get(NX_PACKET_POOL *pool_ptr, ULONG *total_packets, ULO
                              ULONG *empty_pool_requests, ULONG *empty_pool_suspensions,
                              ULONG *invalid_packet_releases);
 UINT nx_packet_pool_low_watermark_set(NX_PACKET_POOL *pool_ptr, ULONG low_water_mark);
+UINT nx_packet_pool_watermark_notify(NX_PACKET_POOL *pool_ptr, ULONG low_watermark, ULONG high_watermark,
+                                     VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low));
+UINT nx_packet_pool_class_set(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL *larger_pool_ptr);
+UINT nx_packet_size_allocate(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_ptr,
+                             ULONG packet_type, ULONG payload_size, ULONG wait_option);
+UINT nx_packet_pool_stats_get(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL_STATS *stats_ptr);
 #ifndef NX_DISABLE_ERROR_CHECKING
 UINT _nxe_packet_release(NX_PACKET **packet_ptr_ptr);
+UINT _nxe_packet_release_chain_bulk(NX_PACKET **packet_list_ptr);
 UINT _nxe_packet_transmit_release(NX_PACKET **packet_ptr_ptr);
 #else
 UINT _nx_packet_release(NX_PACKET *packet_ptr);
+UINT _nx_packet_release_chain_bulk(NX_PACKET *packet_list);
 UINT _nx_packet_transmit_release(NX_PACKET *packet_ptr);
 #endif
 
@@ -3657,6 +3927,7 @@ UINT nx_tcp_server_socket_listen(NX_IP *ip_ptr, UINT port, NX_TCP_SOCKET *socket
 UINT nx_tcp_server_socket_relisten(NX_IP *ip_ptr, UINT port, NX_TCP_SOCKET *socket_ptr);
 UINT nx_tcp_server_socket_unaccept(NX_TCP_SOCKET *socket_ptr);
 UINT nx_tcp_server_socket_unlisten(NX_IP *ip_ptr, UINT port);
+UINT nx_tcp_socket_ack_policy_set(NX_TCP_SOCKET *socket_ptr, UINT quickack_segments, ULONG push_ack_size);
 UINT nx_tcp_socket_bytes_available(NX_TCP_SOCKET *socket_ptr, ULONG *bytes_available);
 #ifndef NX_DISABLE_ERROR_CHECKING
 UINT _nxe_tcp_socket_create(NX_IP *ip_ptr, NX_TCP_SOCKET *socket_ptr, CHAR *name,
@@ -3689,6 +3960,7 @@ UINT nx_tcp_socket_peer_info_get(NX_TCP_SOCKET *socket_ptr, ULONG *peer_ip_addre
 UINT nx_tcp_socket_queue_depth_notify_set(NX_TCP_SOCKET *socket_ptr,
                                           VOID (*tcp_socket_queue_depth_notify)(NX_TCP_SOCKET *));
 UINT nx_tcp_socket_receive(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
+UINT nx_tcp_socket_receive_chain(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
 UINT nx_tcp_socket_receive_notify(NX_TCP_SOCKET *socket_ptr,
                                   VOID (*tcp_receive_notify)(NX_TCP_SOCKET *));
 UINT nx_tcp_socket_receive_queue_max_set(NX_TCP_SOCKET *socket_ptr, UINT receive_queue_maximum);
@@ -3697,6 +3969,10 @@ UINT _nxe_tcp_socket_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr_ptr,
 #else
 UINT _nx_tcp_socket_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
 #endif
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+UINT nx_tcp_socket_send_notify_set(NX_TCP_SOCKET *socket_ptr,
+                                   VOID (*tcp_socket_send_notify)(NX_TCP_SOCKET *));
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 UINT nx_tcp_socket_state_wait(NX_TCP_SOCKET *socket_ptr, UINT desired_state, ULONG wait_option);
 UINT nx_tcp_socket_timed_wait_callback(NX_TCP_SOCKET *socket_ptr,
                                        VOID (*tcp_timed_wait_callback)(NX_TCP_SOCKET *));
@@ -3736,6 +4012,8 @@ UINT nx_udp_socket_info_get(NX_UDP_SOCKET *socket_ptr, ULONG *udp_packets_sent,
                             ULONG *udp_receive_packets_dropped, ULONG *udp_checksum_errors);
 UINT nx_udp_socket_port_get(NX_UDP_SOCKET *socket_ptr, UINT *port_ptr);
 UINT nx_udp_socket_receive(NX_UDP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
+UINT nx_udp_socket_receive_batch(NX_UDP_SOCKET *socket_ptr, NX_UDP_DATAGRAM *datagrams, UINT max_datagrams,
+                                 UINT *datagram_count, ULONG wait_option);
 UINT nx_udp_socket_receive_notify(NX_UDP_SOCKET *socket_ptr,
                                   VOID (*udp_receive_notify)(NX_UDP_SOCKET *));
 #ifndef NX_DISABLE_ERROR_CHECKING
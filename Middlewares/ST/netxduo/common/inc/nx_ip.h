@@ -93,6 +93,23 @@
 #define NX_IP_LINK_STATUS_EVENT      ((ULONG)0x00004000)       /* Link status change event     */
 
 
+/* Define the macro that posts events to the IP thread. With NX_ENABLE_IP_EVENT_SEMAPHORE the
+   events are or'ed into a pending word and the IP thread is woken by a semaphore put, only
+   when the word was empty.  */
+
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+#define NX_IP_EVENT_SET(ip_ptr, events)   _nx_ip_event_set((ip_ptr), (events))
+#else
+#define NX_IP_EVENT_SET(ip_ptr, events)   tx_event_flags_set(&((ip_ptr) -> nx_ip_events), (events), TX_OR)
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
+
+/* Define the number of deferred packets the IP thread processes from a queue before it
+   serves the other pending events. The rest of the queue is processed on the next pass.  */
+#ifndef NX_IP_THREAD_PACKET_BUDGET
+#define NX_IP_THREAD_PACKET_BUDGET   16
+#endif /* NX_IP_THREAD_PACKET_BUDGET */
+
+
 #ifndef NX_IP_FAST_TIMER_RATE
 #define NX_IP_FAST_TIMER_RATE        10
 #endif
@@ -162,6 +179,9 @@ VOID _nx_ip_packet_deferred_receive(NX_IP *ip_ptr, NX_PACKET *packet_ptr);
 UINT _nx_ip_status_check(NX_IP *ip_ptr, ULONG needed_status, ULONG *actual_status, ULONG wait_option);
 UINT _nx_ip_link_status_change_notify_set(NX_IP *ip_ptr,  VOID (*link_status_change_notify)(NX_IP *ip_ptr, UINT interface_index, UINT link_up));
 VOID _nx_ip_thread_entry(ULONG ip_ptr_value);
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+VOID _nx_ip_event_set(NX_IP *ip_ptr, ULONG events);
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
 VOID _nx_ip_raw_packet_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 UINT _nx_ip_raw_packet_processing(NX_IP *ip_ptr, ULONG protocol, NX_PACKET *packet_ptr);
 UINT _nxd_ip_raw_packet_send(NX_IP *ip_ptr, NX_PACKET *packet_ptr,
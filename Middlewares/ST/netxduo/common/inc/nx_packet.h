@@ -88,10 +88,22 @@
 #endif /* NX_ENABLE_PACKET_DEBUG_INFO */
 
 
+/* Define the check of the watermark notification, made once the available count of the
+   pool changed and interrupts are restored.  A pool without notification costs a compare.  */
+
+#ifdef NX_ENABLE_LOW_WATERMARK
+#define NX_PACKET_POOL_WATERMARK_CHECK(p)   if ((p) -> nx_packet_pool_watermark_notify) _nx_packet_pool_watermark_check(p);
+#else
+#define NX_PACKET_POOL_WATERMARK_CHECK(p)
+#endif /* NX_ENABLE_LOW_WATERMARK */
+
+
 /* Define packet pool management function prototypes.  */
 
 UINT _nx_packet_allocate(NX_PACKET_POOL *pool_ptr,  NX_PACKET **packet_ptr,
                          ULONG packet_type, ULONG wait_option);
+UINT _nx_packet_allocate_bulk(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_array,
+                              ULONG packet_type, UINT count, UINT *allocated_count);
 UINT _nx_packet_copy(NX_PACKET *packet_ptr, NX_PACKET **new_packet_ptr,
                      NX_PACKET_POOL *pool_ptr, ULONG wait_option);
 UINT _nx_packet_data_append(NX_PACKET *packet_ptr, VOID *data_start, ULONG data_size,
@@ -111,10 +123,18 @@ UINT _nx_packet_pool_info_get(NX_PACKET_POOL *pool_ptr, ULONG *total_packets, UL
                               ULONG *empty_pool_requests, ULONG *empty_pool_suspensions,
                               ULONG *invalid_packet_releases);
 UINT _nx_packet_release(NX_PACKET *packet_ptr);
+UINT _nx_packet_release_chain_bulk(NX_PACKET *packet_list);
 UINT _nx_packet_transmit_release(NX_PACKET *packet_ptr);
 VOID _nx_packet_pool_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_packet_pool_initialize(VOID);
 UINT _nx_packet_pool_low_watermark_set(NX_PACKET_POOL *pool_ptr, ULONG low_watermark);
+UINT _nx_packet_pool_watermark_notify(NX_PACKET_POOL *pool_ptr, ULONG low_watermark, ULONG high_watermark,
+                                      VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low));
+VOID _nx_packet_pool_watermark_check(NX_PACKET_POOL *pool_ptr);
+UINT _nx_packet_pool_class_set(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL *larger_pool_ptr);
+UINT _nx_packet_size_allocate(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_ptr,
+                              ULONG packet_type, ULONG payload_size, ULONG wait_option);
+UINT _nx_packet_pool_stats_get(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL_STATS *stats_ptr);
 
 
 /* Define error checking shells for API services.  These are only referenced by the
@@ -122,6 +142,8 @@ UINT _nx_packet_pool_low_watermark_set(NX_PACKET_POOL *pool_ptr, ULONG low_water
 
 UINT _nxe_packet_allocate(NX_PACKET_POOL *pool_ptr,  NX_PACKET **packet_ptr,
                           ULONG packet_type, ULONG wait_option);
+UINT _nxe_packet_allocate_bulk(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_array,
+                               ULONG packet_type, UINT count, UINT *allocated_count);
 UINT _nxe_packet_copy(NX_PACKET *packet_ptr, NX_PACKET **new_packet_ptr,
                       NX_PACKET_POOL *pool_ptr, ULONG wait_option);
 UINT _nxe_packet_data_append(NX_PACKET *packet_ptr, VOID *data_start, ULONG data_size,
@@ -136,8 +158,15 @@ UINT _nxe_packet_pool_info_get(NX_PACKET_POOL *pool_ptr, ULONG *total_packets, U
                                ULONG *empty_pool_requests, ULONG *empty_pool_suspensions,
                                ULONG *invalid_packet_releases);
 UINT _nxe_packet_release(NX_PACKET **packet_ptr_ptr);
+UINT _nxe_packet_release_chain_bulk(NX_PACKET **packet_list_ptr);
 UINT _nxe_packet_transmit_release(NX_PACKET **packet_ptr_ptr);
 UINT _nxe_packet_pool_low_watermark_set(NX_PACKET_POOL *pool_ptr, ULONG low_watermark);
+UINT _nxe_packet_pool_watermark_notify(NX_PACKET_POOL *pool_ptr, ULONG low_watermark, ULONG high_watermark,
+                                       VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low));
+UINT _nxe_packet_pool_class_set(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL *larger_pool_ptr);
+UINT _nxe_packet_size_allocate(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_ptr,
+                               ULONG packet_type, ULONG payload_size, ULONG wait_option);
+UINT _nxe_packet_pool_stats_get(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL_STATS *stats_ptr);
 
 
 /* Packet pool management component data declarations follow.  */
@@ -100,6 +100,43 @@
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
 
+/* Define the selective acknowledgement options, RFC 2018.  */
+
+#ifdef NX_ENABLE_TCP_SACK
+#define NX_TCP_SYN_SACK_HEADER          ((ULONG)0x80000000) /* SYN header with MSS and SACK */
+#define NX_TCP_SACK_PERMIT_OPTION       ((ULONG)0x01010402) /* NOP, NOP, SACK permitted     */
+#define NX_TCP_SACK_PERMIT_KIND         0x04                /* SACK permitted option kind   */
+#define NX_TCP_SACK_KIND                0x05                /* SACK option kind             */
+#define NX_TCP_SACK_BLOCKS_MAX          4                   /* SACK blocks in one ACK       */
+#define NX_TCP_SACK_OPTION_SIZE         (4 + (NX_TCP_SACK_BLOCKS_MAX << 3)) /* Largest SACK option  */
+#define NX_TCP_SACK_RETRANSMIT          2                   /* Retransmit the next SACK hole*/
+#endif /* NX_ENABLE_TCP_SACK */
+
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+/* Define the hash index of a connection in the TCP connection table, from the local port,
+   the peer port and the last word of the peer address.  */
+#define NX_TCP_CONNECTION_INDEX(port, connect_port, address) \
+    ((UINT)(((ULONG)(port) ^ (ULONG)(connect_port) ^ ((ULONG)(connect_port) >> 8) ^ \
+             (ULONG)(address) ^ ((ULONG)(address) >> 8)) & NX_TCP_CONNECTION_TABLE_MASK))
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
+
+/* Define the restart of the fast TCP timer, stopped by the fast periodic processing
+   while no socket had a timeout or a delayed ACK pending. Used, with the IP protection
+   held, where a segment is received or a socket timeout is armed.  */
+
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+#define NX_TCP_FAST_TIMER_RESUME(ip_ptr)                                     \
+    if ((ip_ptr) -> nx_ip_fast_periodic_timer_idle)                          \
+    {                                                                        \
+        (ip_ptr) -> nx_ip_fast_periodic_timer_idle =  NX_FALSE;              \
+        tx_timer_activate(&((ip_ptr) -> nx_ip_fast_periodic_timer));         \
+    }
+#else
+#define NX_TCP_FAST_TIMER_RESUME(ip_ptr)
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
+
+
 /* Define constants for the optional TCP keepalive Timer.  To enable this
    feature, the TCP source must be compiled with NX_ENABLE_TCP_KEEPALIVE
    defined.  */
@@ -138,6 +175,11 @@
                                                     /* default is 2 minutes (120s)   */
 
 
+/* Merging the contiguous segments received out of order chains their packets.  */
+#if defined(NX_ENABLE_TCP_RX_SEGMENT_MERGE) && defined(NX_DISABLE_PACKET_CHAIN)
+#undef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE && NX_DISABLE_PACKET_CHAIN */
+
 /* Define the maximum receive queue depth for TCP socket. */
 #ifdef NX_ENABLE_LOW_WATERMARK
 #ifndef NX_TCP_MAXIMUM_RX_QUEUE
@@ -173,6 +215,18 @@
 #define NX_TCP_TRANSMIT_TIMER_RATE      1
 #endif
 
+/* Define the bounds of the retransmit timeout derived from the round trip time when
+   NX_ENABLE_TCP_RTO_ESTIMATION is defined.  The minimum is the NX_IP_PERIODIC_RATE
+   divided by the rate, one second by default, and the maximum is in seconds.  */
+
+#ifndef NX_TCP_RTO_MINIMUM_RATE
+#define NX_TCP_RTO_MINIMUM_RATE         1
+#endif
+
+#ifndef NX_TCP_RTO_MAXIMUM
+#define NX_TCP_RTO_MAXIMUM              60
+#endif
+
 /* Define the value of the TCP minimum acceptable MSS for the host to accept the connection,
    which by default is 128.  */
 
@@ -272,12 +326,17 @@ UINT _nx_tcp_socket_mss_get(NX_TCP_SOCKET *socket_ptr, ULONG *mss);
 UINT _nx_tcp_socket_mss_peer_get(NX_TCP_SOCKET *socket_ptr, ULONG *peer_mss);
 UINT _nx_tcp_socket_mss_set(NX_TCP_SOCKET *socket_ptr, ULONG mss);
 UINT _nx_tcp_socket_receive(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
+UINT _nx_tcp_socket_receive_chain(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
 UINT _nx_tcp_socket_receive_notify(NX_TCP_SOCKET *socket_ptr,
                                    VOID (*tcp_receive_notify)(NX_TCP_SOCKET *socket_ptr));
 UINT _nx_tcp_socket_window_update_notify_set(NX_TCP_SOCKET *socket_ptr,
                                              VOID (*tcp_windows_update_notify)(NX_TCP_SOCKET *socket_ptr));
 UINT _nx_tcp_socket_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
 UINT _nx_tcp_socket_send_internal(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+UINT _nx_tcp_socket_send_notify_set(NX_TCP_SOCKET *socket_ptr,
+                                    VOID (*tcp_socket_send_notify)(NX_TCP_SOCKET *socket_ptr));
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 UINT _nx_tcp_socket_state_wait(NX_TCP_SOCKET *socket_ptr, UINT desired_state, ULONG wait_option);
 UINT _nx_tcp_socket_transmit_configure(NX_TCP_SOCKET *socket_ptr, ULONG max_queue_depth, ULONG timeout,
                                        ULONG max_retries, ULONG timeout_shift);
@@ -321,17 +380,46 @@ VOID _nx_tcp_packet_send_control(NX_TCP_SOCKET *socket_ptr, ULONG control_bits,
 VOID _nx_tcp_periodic_processing(NX_IP *ip_ptr);
 VOID _nx_tcp_queue_process(NX_IP *ip_ptr);
 VOID _nx_tcp_receive_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
+UINT _nx_tcp_socket_ack_policy_set(NX_TCP_SOCKET *socket_ptr, UINT quickack_segments, ULONG push_ack_size);
 UINT _nx_tcp_socket_bytes_available(NX_TCP_SOCKET *socket_ptr, ULONG *bytes_available);
 VOID _nx_tcp_socket_connection_reset(NX_TCP_SOCKET *socket_ptr);
 VOID _nx_tcp_socket_packet_process(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr);
 UINT _nx_tcp_socket_peer_info_get(NX_TCP_SOCKET *socket_ptr, ULONG *peer_ip_address, ULONG *peer_port);
 
 VOID _nx_tcp_socket_receive_queue_flush(NX_TCP_SOCKET *socket_ptr);
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+NX_TCP_SOCKET *_nx_tcp_connection_find(NX_IP *ip_ptr, UINT port, UINT source_port, UINT ip_version, ULONG *source_ip);
+VOID _nx_tcp_socket_connection_insert(NX_TCP_SOCKET *socket_ptr);
+VOID _nx_tcp_socket_connection_remove(NX_TCP_SOCKET *socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+ULONG _nx_tcp_socket_rx_window_compute(NX_TCP_SOCKET *socket_ptr);
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+VOID _nx_tcp_socket_rtt_update(NX_TCP_SOCKET *socket_ptr, ULONG rtt);
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+UINT _nx_tcp_socket_coalesce_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
+UINT _nx_tcp_socket_coalesce_flush(NX_TCP_SOCKET *socket_ptr, ULONG wait_option);
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+UINT _nx_tcp_socket_send_async(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option);
+UINT _nx_tcp_socket_send_pending_flush(NX_TCP_SOCKET *socket_ptr, ULONG wait_option);
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+#ifdef NX_ENABLE_TCP_SACK
+UINT _nx_tcp_sack_permitted_option_get(UCHAR *option_ptr, ULONG option_area_size, UINT *sack_permitted);
+UINT _nx_tcp_socket_sack_option_build(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr);
+VOID _nx_tcp_socket_sack_process(NX_TCP_SOCKET *socket_ptr, ULONG ack_number, UCHAR *option_ptr, ULONG option_area_size);
+UINT _nx_tcp_socket_sack_check(NX_TCP_SOCKET *socket_ptr, ULONG begin_sequence, ULONG end_sequence);
+#endif /* NX_ENABLE_TCP_SACK */
 UINT _nx_tcp_socket_state_ack_check(NX_TCP_SOCKET *socket_ptr, NX_TCP_HEADER *tcp_header_ptr);
 VOID _nx_tcp_socket_state_closing(NX_TCP_SOCKET *socket_ptr, NX_TCP_HEADER *tcp_header_ptr);
 UINT _nx_tcp_socket_state_data_check(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr);
 VOID _nx_tcp_socket_state_data_trim_front(NX_PACKET *packet_ptr, ULONG amount);
 VOID _nx_tcp_socket_state_data_trim(NX_PACKET *packet_ptr, ULONG amount);
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+UINT _nx_tcp_socket_state_data_merge(NX_PACKET *queued_ptr, NX_PACKET *packet_ptr);
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
 VOID _nx_tcp_socket_state_established(NX_TCP_SOCKET *socket_ptr);
 VOID _nx_tcp_socket_state_fin_wait1(NX_TCP_SOCKET *socket_ptr);
 VOID _nx_tcp_socket_state_fin_wait2(NX_TCP_SOCKET *socket_ptr);
@@ -369,6 +457,7 @@ UINT _nxe_tcp_server_socket_listen(NX_IP *ip_ptr, UINT port, NX_TCP_SOCKET *sock
 UINT _nxe_tcp_server_socket_relisten(NX_IP *ip_ptr, UINT port, NX_TCP_SOCKET *socket_ptr);
 UINT _nxe_tcp_server_socket_unaccept(NX_TCP_SOCKET *socket_ptr);
 UINT _nxe_tcp_server_socket_unlisten(NX_IP *ip_ptr, UINT port);
+UINT _nxe_tcp_socket_ack_policy_set(NX_TCP_SOCKET *socket_ptr, UINT quickack_segments, ULONG push_ack_size);
 UINT _nxe_tcp_socket_bytes_available(NX_TCP_SOCKET *socket_ptr, ULONG *bytes_available);
 UINT _nxe_tcp_socket_create(NX_IP *ip_ptr, NX_TCP_SOCKET *socket_ptr, CHAR *name,
                             ULONG type_of_service, ULONG fragment, UINT time_to_live, ULONG window_size,
@@ -388,9 +477,14 @@ UINT _nxe_tcp_socket_mss_peer_get(NX_TCP_SOCKET *socket_ptr, ULONG *peer_mss);
 UINT _nxe_tcp_socket_mss_set(NX_TCP_SOCKET *socket_ptr, ULONG mss);
 UINT _nxe_tcp_socket_peer_info_get(NX_TCP_SOCKET *socket_ptr, ULONG *peer_ip_address, ULONG *peer_port);
 UINT _nxe_tcp_socket_receive(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
+UINT _nxe_tcp_socket_receive_chain(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option);
 UINT _nxe_tcp_socket_receive_notify(NX_TCP_SOCKET *socket_ptr,
                                     VOID (*tcp_receive_notify)(NX_TCP_SOCKET *socket_ptr));
 UINT _nxe_tcp_socket_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr_ptr, ULONG wait_option);
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+UINT _nxe_tcp_socket_send_notify_set(NX_TCP_SOCKET *socket_ptr,
+                                     VOID (*tcp_socket_send_notify)(NX_TCP_SOCKET *socket_ptr));
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 UINT _nxe_tcp_socket_state_wait(NX_TCP_SOCKET *socket_ptr, UINT desired_state, ULONG wait_option);
 UINT _nxe_tcp_socket_transmit_configure(NX_TCP_SOCKET *socket_ptr, ULONG max_queue_depth, ULONG timeout,
                                         ULONG max_retries, ULONG timeout_shift);
@@ -115,12 +115,18 @@ UINT _nxde_udp_socket_source_send(NX_UDP_SOCKET *socket_ptr, NX_PACKET *packet_p
 UINT _nx_udp_socket_port_get(NX_UDP_SOCKET *socket_ptr, UINT *port_ptr);
 UINT _nx_udp_socket_receive(NX_UDP_SOCKET *socket_ptr, NX_PACKET **packet_ptr,
                             ULONG wait_option);
+UINT _nx_udp_socket_receive_batch(NX_UDP_SOCKET *socket_ptr, NX_UDP_DATAGRAM *datagrams, UINT max_datagrams,
+                                  UINT *datagram_count, ULONG wait_option);
 UINT _nx_udp_socket_receive_notify(NX_UDP_SOCKET *socket_ptr,
                                    VOID (*udp_receive_notify)(NX_UDP_SOCKET *socket_ptr));
 
 UINT _nx_udp_socket_send(NX_UDP_SOCKET *socket_ptr, NX_PACKET *packet_ptr,
                          ULONG ip_address, UINT port);
 UINT _nx_udp_socket_unbind(NX_UDP_SOCKET *socket_ptr);
+#if !defined(NX_DISABLE_IPV4) && defined(NX_ENABLE_UDP_ROUTE_CACHE)
+VOID _nx_udp_socket_route_find(NX_UDP_SOCKET *socket_ptr, ULONG destination_address,
+                               NX_INTERFACE **ip_interface_ptr, ULONG *next_hop_address);
+#endif /* !NX_DISABLE_IPV4 && NX_ENABLE_UDP_ROUTE_CACHE */
 UINT _nx_udp_source_extract(NX_PACKET *packet_ptr, ULONG *ip_address, UINT *port);
 UINT _nx_udp_packet_info_extract(NX_PACKET *packet_ptr, ULONG *ip_address, UINT *protocol, UINT *port, UINT *interface_index);
 UINT _nxd_udp_source_extract(NX_PACKET *packet_ptr, NXD_ADDRESS *ip_address, UINT *port);
@@ -155,6 +161,8 @@ UINT _nxe_udp_socket_info_get(NX_UDP_SOCKET *socket_ptr, ULONG *udp_packets_sent
 UINT _nxe_udp_socket_port_get(NX_UDP_SOCKET *socket_ptr, UINT *port_ptr);
 UINT _nxe_udp_socket_receive(NX_UDP_SOCKET *socket_ptr, NX_PACKET **packet_ptr,
                              ULONG wait_option);
+UINT _nxe_udp_socket_receive_batch(NX_UDP_SOCKET *socket_ptr, NX_UDP_DATAGRAM *datagrams, UINT max_datagrams,
+                                   UINT *datagram_count, ULONG wait_option);
 UINT _nxe_udp_socket_receive_notify(NX_UDP_SOCKET *socket_ptr,
                                     VOID (*udp_receive_notify)(NX_UDP_SOCKET *socket_ptr));
 UINT _nx_udp_socket_source_send(NX_UDP_SOCKET *socket_ptr, NX_PACKET *packet_ptr,
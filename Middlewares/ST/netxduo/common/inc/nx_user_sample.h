@@ -280,6 +280,13 @@
 #define NX_IPV6_DAD_TRANSMITS           3
 */
 
+/* Defined, the link local address built from the MAC address and the addresses configured
+   from router advertisements are optimistic (RFC 4429): they are used at once while DAD runs,
+   and they are removed the same way on DAD failure.  */
+/*
+#define NX_IPV6_OPTIMISTIC_DAD
+*/
+
 /* Define the number of neighbor cache entries. */
 /*
 #define NX_IPV6_NEIGHBOR_CACHE_SIZE     16
@@ -61,7 +61,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_icmp_packet_process               Process ICMP packet           */
-/*    tx_event_flags_set                    Set event flags for IP helper */
+/*    NX_IP_EVENT_SET                       Set event flags for IP helper */
 /*                                            thread                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -187,7 +187,7 @@ NX_INTERFACE   *interface_ptr;
         TX_RESTORE
 
         /* Wakeup IP thread for processing one or more messages in the ICMP queue.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_ICMP_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_ICMP_EVENT);
     }
     else
     {
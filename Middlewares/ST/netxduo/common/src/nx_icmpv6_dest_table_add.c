@@ -94,7 +94,11 @@ UINT _nx_icmpv6_dest_table_add(NX_IP *ip_ptr, ULONG *destination_address,
 {
 
 UINT i, table_size;
+UINT start, index;
 UINT status;
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+ULONG age, oldest_age;
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
 
     /* Pointers must not be NULL. */
     NX_ASSERT((destination_address != NX_NULL) && (dest_entry_ptr != NX_NULL) && (next_hop != NX_NULL));
@@ -136,18 +140,55 @@ UINT status;
     /* There is no invalid destination in table. */
     if (table_size == NX_IPV6_DESTINATION_TABLE_SIZE)
     {
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+
+        /* Reuse the entry found least recently. The count of the lookups wraps, the
+           oldest entry is the one whose last use is the furthest behind it. */
+        index = 0;
+        oldest_age = 0;
+        for (i = 0; i < NX_IPV6_DESTINATION_TABLE_SIZE; i++)
+        {
+            age = ip_ptr -> nx_ipv6_destination_use_count - ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_last_used;
+            if (age >= oldest_age)
+            {
+                oldest_age = age;
+                index = i;
+            }
+        }
+
+        /* Its next hop stays in the ND cache, the destination is added again when it is used. */
+        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_valid = 0;
+        ip_ptr -> nx_ipv6_destination_table_size--;
+#else
         return(NX_NOT_SUCCESSFUL);
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
     }
 
     /* Initialize the pointer to the table location where we will update/add information. */
     *dest_entry_ptr = NX_NULL;
 
+#ifdef NX_ENABLE_IPV6_DESTINATION_HASH
+
+    /* Start at the slot of the destination, _nx_icmpv6_dest_table_find starts there too. */
+    start = (UINT)((destination_address[0] + destination_address[1] + destination_address[2] + destination_address[3]) %
+                   (NX_IPV6_DESTINATION_TABLE_SIZE));
+#else
+    start = 0;
+#endif /* NX_ENABLE_IPV6_DESTINATION_HASH */
+
     /* Go through the table to find an empty slot. */
     for (i = 0; i < NX_IPV6_DESTINATION_TABLE_SIZE; i++)
     {
 
+        /* From the start slot around the table. */
+        index = start + i;
+        if (index >= NX_IPV6_DESTINATION_TABLE_SIZE)
+        {
+            index -= NX_IPV6_DESTINATION_TABLE_SIZE;
+        }
+
         /* Is this slot empty? */
-        if (!ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_valid)
+        if (!ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_valid)
         {
             /* Yes; we can use it for adding a new entry. */
             /* Have found an empty slot. */
@@ -155,7 +196,7 @@ UINT status;
         }
     }
 
-    /* Destination is not empty so i must be less than table size. */
+    /* Destination is not full so an empty slot was found. */
     NX_ASSERT(i < NX_IPV6_DESTINATION_TABLE_SIZE);
 
     /*
@@ -166,22 +207,22 @@ UINT status;
 
     /* Clear out any previous data from this slot. */
     /*lint -e{669} -e{826} suppress cast of pointer to pointer, since it is necessary  */
-    memset(&ip_ptr -> nx_ipv6_destination_table[i], 0, sizeof(NX_IPV6_DESTINATION_ENTRY));
+    memset(&ip_ptr -> nx_ipv6_destination_table[index], 0, sizeof(NX_IPV6_DESTINATION_ENTRY));
 
     /* Fill in the newly created table entry with the supplied and/or default information. */
-    COPY_IPV6_ADDRESS(destination_address, ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_destination_address);
+    COPY_IPV6_ADDRESS(destination_address, ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_destination_address);
 
     /* Add next hop information to the entry. */
-    COPY_IPV6_ADDRESS(next_hop, ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_next_hop);
+    COPY_IPV6_ADDRESS(next_hop, ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_next_hop);
 
     /* Attempt to find the matching entry in the cache table. NetX Duo will need to know
        how to get a packet to the next hop, not just the destination! */
-    status = _nx_nd_cache_find_entry(ip_ptr, next_hop, &ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_nd_entry);
+    status = _nx_nd_cache_find_entry(ip_ptr, next_hop, &ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_nd_entry);
 
     /* Did not find the matching entry. Try to add one. */
     if (status)
     {
-        status = _nx_nd_cache_add_entry(ip_ptr, next_hop, ipv6_address, &ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_nd_entry);
+        status = _nx_nd_cache_add_entry(ip_ptr, next_hop, ipv6_address, &ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_nd_entry);
 
         /* Failed to add new entry. Return. */
         if (status)
@@ -192,11 +233,17 @@ UINT status;
 
 
     /* Validate this entry to ensure it will not be overwritten with new entries. */
-    ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_valid = 1;
+    ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_valid = 1;
 
     /* Update the count of destinations currently in the table. */
     ip_ptr -> nx_ipv6_destination_table_size++;
 
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+
+    /* A new entry is the most recently used one. */
+    ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_last_used = ++ip_ptr -> nx_ipv6_destination_use_count;
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
+
 #ifdef NX_ENABLE_IPV6_PATH_MTU_DISCOVERY
 
     /* Is a valid path mtu is given? */
@@ -204,13 +251,13 @@ UINT status;
     {
 
         /* Update the destination path MTU with this supplied data. */
-        ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_path_mtu = path_mtu;
+        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_path_mtu = path_mtu;
     }
     else
     {
 
         /* No; set the path MTU to the IP task MTU (on link path MTU).*/
-        ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_path_mtu = ipv6_address -> nxd_ipv6_address_attached -> nx_interface_ip_mtu_size;
+        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_path_mtu = ipv6_address -> nxd_ipv6_address_attached -> nx_interface_ip_mtu_size;
     }
 
     /* Is a valid entry timeout is supplied? */
@@ -218,24 +265,24 @@ UINT status;
     {
 
         /* Yes; Update the table entry timeout to the supplied data. */
-        ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_MTU_timer_tick = mtu_timeout;
+        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_MTU_timer_tick = mtu_timeout;
     }
     else
     {
 
         /* No; have we defaulted to our own IP task MTU?*/
-        if (ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_path_mtu == ipv6_address -> nxd_ipv6_address_attached -> nx_interface_ip_mtu_size)
+        if (ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_path_mtu == ipv6_address -> nxd_ipv6_address_attached -> nx_interface_ip_mtu_size)
         {
 
             /* Yes; This is our optimal path MTU. So there is no need to age this table entry
                and attempt to increase the path MTU; ok set it to infinity. */
-            ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_MTU_timer_tick = NX_WAIT_FOREVER;
+            ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_MTU_timer_tick = NX_WAIT_FOREVER;
         }
         else
         {
             /* No, this is less than our optimal path MTU. Wait the required interval
                before probing for a higher path MTU. */
-            ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_MTU_timer_tick = NX_PATH_MTU_INCREASE_WAIT_INTERVAL_TICKS;
+            ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_MTU_timer_tick = NX_PATH_MTU_INCREASE_WAIT_INTERVAL_TICKS;
         }
     }
 #else
@@ -244,7 +291,7 @@ UINT status;
 #endif  /* NX_ENABLE_IPV6_PATH_MTU_DISCOVERY */
 
     /* Set the table location pointer to the entry we just added/updated. */
-    *dest_entry_ptr = &ip_ptr -> nx_ipv6_destination_table[i];
+    *dest_entry_ptr = &ip_ptr -> nx_ipv6_destination_table[index];
 
     return(NX_SUCCESS);
 }
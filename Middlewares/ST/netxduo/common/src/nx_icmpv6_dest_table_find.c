@@ -86,6 +86,7 @@ UINT _nx_icmpv6_dest_table_find(NX_IP *ip_ptr, ULONG *destination_address, NX_IP
 {
 
 UINT i, table_size;
+UINT start, index;
 
     /* Destination address must be valid. */
     NX_ASSERT((destination_address != NX_NULL) && (dest_entry_ptr != NULL));
@@ -102,12 +103,29 @@ UINT i, table_size;
     /* Initialize the return value. */
     *dest_entry_ptr = NX_NULL;
 
+#ifdef NX_ENABLE_IPV6_DESTINATION_HASH
+
+    /* Start at the slot the entry is added at, hashed as in the ND cache.
+       Unless that slot was taken, the entry is the first one checked. */
+    start = (UINT)((destination_address[0] + destination_address[1] + destination_address[2] + destination_address[3]) %
+                   (NX_IPV6_DESTINATION_TABLE_SIZE));
+#else
+    start = 0;
+#endif /* NX_ENABLE_IPV6_DESTINATION_HASH */
+
     /* Loop through all entries. */
     for (i = 0; table_size && (i < NX_IPV6_DESTINATION_TABLE_SIZE); i++)
     {
 
+        /* From the start slot around the table. */
+        index = start + i;
+        if (index >= NX_IPV6_DESTINATION_TABLE_SIZE)
+        {
+            index -= NX_IPV6_DESTINATION_TABLE_SIZE;
+        }
+
         /* Skip invalid entries. */
-        if (!ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_valid)
+        if (!ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_valid)
         {
             continue;
         }
@@ -116,7 +134,7 @@ UINT i, table_size;
         table_size--;
 
         /* Check whether or not the address is the same. */
-        if (CHECK_IPV6_ADDRESSES_SAME(&ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_destination_address[0], destination_address))
+        if (CHECK_IPV6_ADDRESSES_SAME(&ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_destination_address[0], destination_address))
         {
 
 #ifdef NX_ENABLE_IPV6_PATH_MTU_DISCOVERY
@@ -128,18 +146,18 @@ UINT i, table_size;
 
                 /* Do we have a valid timeout e.g. did this information come from an RA packet?
                    Or is a packet too big message indicating we need to decrease our path MTU? */
-                if ((mtu_timeout > 0) || (ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_path_mtu > path_mtu))
+                if ((mtu_timeout > 0) || (ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_path_mtu > path_mtu))
                 {
 
                     /* OK to change the path MTU. */
-                    ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_path_mtu = path_mtu;
+                    ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_path_mtu = path_mtu;
 
                     /* Was a valid timeout supplied? */
                     if (mtu_timeout > 0)
                     {
 
                         /* Yes;  Ok to update table entry with the specified timeout. */
-                        ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_MTU_timer_tick = mtu_timeout;
+                        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_MTU_timer_tick = mtu_timeout;
                     }
                     else
                     {
@@ -147,7 +165,7 @@ UINT i, table_size;
                            message.  Set the table entry timeout to the required wait
                            interval.  We cannot attempt to restore (increase) the path MTU
                            before this time out expires. */
-                        ip_ptr -> nx_ipv6_destination_table[i].nx_ipv6_destination_entry_MTU_timer_tick = NX_PATH_MTU_INCREASE_WAIT_INTERVAL_TICKS;
+                        ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_MTU_timer_tick = NX_PATH_MTU_INCREASE_WAIT_INTERVAL_TICKS;
                     }
                 }
 
@@ -160,7 +178,13 @@ UINT i, table_size;
             NX_PARAMETER_NOT_USED(mtu_timeout);
 #endif /* NX_ENABLE_IPV6_PATH_MTU_DISCOVERY */
 
-            *dest_entry_ptr = &ip_ptr -> nx_ipv6_destination_table[i];
+#ifdef NX_ENABLE_IPV6_DESTINATION_LRU
+
+            /* Mark the entry as the most recently used one. */
+            ip_ptr -> nx_ipv6_destination_table[index].nx_ipv6_destination_entry_last_used = ++ip_ptr -> nx_ipv6_destination_use_count;
+#endif /* NX_ENABLE_IPV6_DESTINATION_LRU */
+
+            *dest_entry_ptr = &ip_ptr -> nx_ipv6_destination_table[index];
 
             return(NX_SUCCESS);
         }
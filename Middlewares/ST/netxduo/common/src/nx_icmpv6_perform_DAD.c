@@ -52,7 +52,8 @@
 /*    This function is called from IP thread periodic process routine.    */
 /*    It starts the Duplicate Address Detection process if the interface  */
 /*    address is in tentative state (not validated yet).  It does nothing */
-/*    to an address if the state of the address is not tentative.         */
+/*    to an address if the state of the address is not tentative.  An     */
+/*    optimistic address is checked as a tentative one.                   */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -112,7 +113,7 @@ UINT              ipv6_addr_index;
         {
 
             /* Check the address state. */
-            if (nx_ipv6_address_next -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_TENTATIVE)
+            if (NX_IPV6_ADDR_STATE_UNDER_DAD(nx_ipv6_address_next -> nxd_ipv6_address_state))
             {
 
                 /* Check if the number of NS messages is used up. */
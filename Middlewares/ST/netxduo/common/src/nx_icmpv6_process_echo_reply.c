@@ -145,7 +145,7 @@ NX_ICMPV6_ECHO *echo_ptr;
 
     /* For IPv6, if the interface IP address is not valid yet,
        do not respond to ping. */
-    if (packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+    if (!NX_IPV6_ADDR_STATE_USABLE(packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state))
     {
 
 
@@ -161,7 +161,7 @@ UINT              ret;
     {
 
         /* Make sure the interface IP address has been validated. */
-        if (packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+        if (!NX_IPV6_ADDR_STATE_USABLE(packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state))
         {
 
             /* Not validated, so release the packet and abort.*/
@@ -177,7 +177,7 @@ UINT              i;
             if (CHECK_IPV6_ADDRESSES_SAME(ip_ptr -> nx_ipv6_address[i].nxd_ipv6_address,
                                           nd_ptr -> nx_icmpv6_nd_targetAddress))
             {
-                if (ip_ptr -> nx_ipv6_address[i].nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_TENTATIVE)
+                if (NX_IPV6_ADDR_STATE_UNDER_DAD(ip_ptr -> nx_ipv6_address[i].nxd_ipv6_address_state))
                 {
 
                     /* Sender sends a NS in response to a DAD request we sent out.
@@ -213,7 +213,7 @@ ULONG             dest_address[4];
 
 #ifndef NX_DISABLE_IPV6_DAD
         /* The sender is doing a DAD on the same address as we have... */
-        if (interface_addr -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_TENTATIVE)
+        if (NX_IPV6_ADDR_STATE_UNDER_DAD(interface_addr -> nxd_ipv6_address_state))
         {
 
             /* Our interface address is in tentative state.  Therefore interface
@@ -369,6 +369,16 @@ ULONG             dest_address[4];
     {
         /* Response to a normal NS: set the S bit.*/
         nd_ptr -> nx_icmpv6_nd_flag = (0x60000000);
+
+#ifdef NX_IPV6_OPTIMISTIC_DAD
+
+        /* An optimistic address may be a duplicate: clear the O bit, so that a neighbor
+           cache entry of the owner is not overridden. RFC 4429, Section 3.3. */
+        if (interface_addr -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_OPTIMISTIC)
+        {
+            nd_ptr -> nx_icmpv6_nd_flag = (0x40000000);
+        }
+#endif /* NX_IPV6_OPTIMISTIC_DAD */
     }
 
     NX_CHANGE_ULONG_ENDIAN(nd_ptr -> nx_icmpv6_nd_flag);
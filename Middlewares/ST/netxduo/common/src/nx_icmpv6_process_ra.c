@@ -383,7 +383,10 @@ UINT                          interface_index;
                             ipv6_address -> nxd_ipv6_address_next = if_ptr -> nxd_interface_ipv6_address_list_head;
                             if_ptr -> nxd_interface_ipv6_address_list_head = ipv6_address;
 
-#ifndef NX_DISABLE_IPV6_DAD
+#if defined(NX_IPV6_OPTIMISTIC_DAD) && !defined(NX_DISABLE_IPV6_DAD)
+                            /* Set the address to Optimistic, usable while the stack performs DAD. RFC 4429. */
+                            ipv6_address -> nxd_ipv6_address_state = NX_IPV6_ADDR_STATE_OPTIMISTIC;
+#elif !defined(NX_DISABLE_IPV6_DAD)
                             /* Set the address to Tentative, so the stack can start DAD process. */
                             ipv6_address -> nxd_ipv6_address_state = NX_IPV6_ADDR_STATE_TENTATIVE;
 #else /* !NX_DISABLE_IPV6_DAD */
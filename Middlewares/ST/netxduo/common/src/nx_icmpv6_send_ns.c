@@ -143,6 +143,15 @@ NX_IP_DRIVER  driver_request;
     /* Setup the size of the ICMPv6 NS message */
     pkt_ptr -> nx_packet_length = sizeof(NX_ICMPV6_ND);
 
+#ifdef NX_IPV6_OPTIMISTIC_DAD
+
+    /* An optimistic address sends no source link layer address. RFC 4429, Section 3.3. */
+    if (outgoing_address -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_OPTIMISTIC)
+    {
+        send_slla = 0;
+    }
+#endif /* NX_IPV6_OPTIMISTIC_DAD */
+
     /* Add 8 more bytes if sending source link layer address. */
     if (send_slla)
     {
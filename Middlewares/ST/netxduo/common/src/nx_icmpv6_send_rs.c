@@ -143,6 +143,15 @@ NX_ICMPV6_OPTION *rs_options;
     /* Size of the message is ICMPv6 + options, which is 8 bytes. */
     pkt_ptr -> nx_packet_length = (sizeof(NX_ICMPV6_RS) + 8);
 
+#ifdef NX_IPV6_OPTIMISTIC_DAD
+
+    /* An optimistic address sends no source link layer address option. RFC 4429, Section 3.2. */
+    if (pkt_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_OPTIMISTIC)
+    {
+        pkt_ptr -> nx_packet_length = sizeof(NX_ICMPV6_RS);
+    }
+#endif /* NX_IPV6_OPTIMISTIC_DAD */
+
     /* Set the prepend pointer. */
     pkt_ptr -> nx_packet_prepend_ptr -= pkt_ptr -> nx_packet_length;
 
@@ -153,24 +162,29 @@ NX_ICMPV6_OPTION *rs_options;
     rs_ptr -> nx_icmpv6_rs_icmpv6_header.nx_icmpv6_header_checksum = 0;
     rs_ptr -> nx_icmpv6_rs_reserved = 0;
 
-    /* Get a pointer to the Option header in the ICMPv6 header. */
-    /*lint -e{923} suppress cast between pointer and ULONG, since it is necessary  */
-    rs_options = (NX_ICMPV6_OPTION *)NX_UCHAR_POINTER_ADD(rs_ptr, sizeof(NX_ICMPV6_RS));
+    /* Check whether the source link layer address option is sent. */
+    if (pkt_ptr -> nx_packet_length > sizeof(NX_ICMPV6_RS))
+    {
+
+        /* Get a pointer to the Option header in the ICMPv6 header. */
+        /*lint -e{923} suppress cast between pointer and ULONG, since it is necessary  */
+        rs_options = (NX_ICMPV6_OPTION *)NX_UCHAR_POINTER_ADD(rs_ptr, sizeof(NX_ICMPV6_RS));
 
-    /* Fill in the options field */
-    rs_options -> nx_icmpv6_option_type = ICMPV6_OPTION_TYPE_SRC_LINK_ADDR;
-    rs_options -> nx_icmpv6_option_length = 1;
+        /* Fill in the options field */
+        rs_options -> nx_icmpv6_option_type = ICMPV6_OPTION_TYPE_SRC_LINK_ADDR;
+        rs_options -> nx_icmpv6_option_length = 1;
 
-    /* Fill in the source mac address. */
-    mac_addr = &rs_options -> nx_icmpv6_option_data;
-    mac_addr[0] = (USHORT)(ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_msw);
-    mac_addr[1] = (USHORT)((ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_lsw & 0xFFFF0000) >> 16);
-    mac_addr[2] = (USHORT)(ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_lsw & 0x0000FFFF);
+        /* Fill in the source mac address. */
+        mac_addr = &rs_options -> nx_icmpv6_option_data;
+        mac_addr[0] = (USHORT)(ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_msw);
+        mac_addr[1] = (USHORT)((ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_lsw & 0xFFFF0000) >> 16);
+        mac_addr[2] = (USHORT)(ip_ptr -> nx_ip_interface[if_index].nx_interface_physical_address_lsw & 0x0000FFFF);
 
-    /* Byte swapping. */
-    NX_CHANGE_USHORT_ENDIAN(mac_addr[0]);
-    NX_CHANGE_USHORT_ENDIAN(mac_addr[1]);
-    NX_CHANGE_USHORT_ENDIAN(mac_addr[2]);
+        /* Byte swapping. */
+        NX_CHANGE_USHORT_ENDIAN(mac_addr[0]);
+        NX_CHANGE_USHORT_ENDIAN(mac_addr[1]);
+        NX_CHANGE_USHORT_ENDIAN(mac_addr[2]);
+    }
 
 #ifdef NX_DISABLE_ICMPV6_TX_CHECKSUM
     compute_checksum = 0;
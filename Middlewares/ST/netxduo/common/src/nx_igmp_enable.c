@@ -55,7 +55,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Set deferred IGMP enable      */
+/*    NX_IP_EVENT_SET                       Set deferred IGMP enable      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -99,7 +99,7 @@ UINT  _nx_igmp_enable(NX_IP *ip_ptr)
     ip_ptr -> nx_ip_igmp_queue_process =  _nx_igmp_queue_process;
 
     /* Wakeup IP helper thread to process the IGMP deferred enable.  */
-    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_IGMP_ENABLE_EVENT, TX_OR);
+    NX_IP_EVENT_SET(ip_ptr, NX_IP_IGMP_ENABLE_EVENT);
 
     /* Return a successful status!  */
     return(NX_SUCCESS);
@@ -63,7 +63,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_igmp_packet_process               Process the IGMP packet       */
-/*    tx_event_flags_set                    Set event flags for IP helper */
+/*    NX_IP_EVENT_SET                       Set event flags for IP helper */
 /*                                            thread                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -142,7 +142,7 @@ TX_INTERRUPT_SAVE_AREA
         TX_RESTORE
 
         /* Wakeup IP thread for processing one or more messages in the IGMP queue.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_IGMP_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_IGMP_EVENT);
     }
     else
     {
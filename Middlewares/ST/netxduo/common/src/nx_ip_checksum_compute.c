@@ -94,6 +94,9 @@ ALIGN_TYPE end_ptr;
 #ifdef FEATURE_NX_IPV6
 UINT       i;
 #endif
+#ifdef NX_PORT_CHECKSUM_WORDS_ADD
+UINT       words;
+#endif /* NX_PORT_CHECKSUM_WORDS_ADD */
 
     /* For computing TCP/UDP/ICMPv6, we need to include the pseudo header.
        The ICMPv4 checksum does not cover the pseudo header. */
@@ -200,6 +203,13 @@ UINT       i;
             /*lint -e{923} suppress cast of pointer to ULONG.  */
             data_length -= (UINT)(((end_ptr + 3) & (ALIGN_TYPE)(~3llu)) - (ALIGN_TYPE)long_ptr);
 
+#ifdef NX_PORT_CHECKSUM_WORDS_ADD
+            /* Sum the same words as the loop below with the port specific kernel.  */
+            /*lint -e{923} suppress cast of pointer to ULONG.  */
+            words = (UINT)((end_ptr - (ALIGN_TYPE)long_ptr + 3) >> 2);
+            checksum = NX_PORT_CHECKSUM_WORDS_ADD(checksum, long_ptr, words);
+            long_ptr += words;
+#else
             /* Loop to calculate the packet's checksum.  */
             /*lint -e{946} suppress pointer subtraction, since it is necessary. */
             while ((ALIGN_TYPE)long_ptr < end_ptr)
@@ -208,6 +218,7 @@ UINT       i;
                 checksum += (*long_ptr >> NX_SHIFT_BY_16);
                 long_ptr++;
             }
+#endif /* NX_PORT_CHECKSUM_WORDS_ADD */
         }
 #ifndef NX_DISABLE_PACKET_CHAIN
 
@@ -208,8 +208,14 @@ TX_THREAD *current_thread;
     /* Create the internal IP protection mutex.  */
     tx_mutex_create(&(ip_ptr -> nx_ip_protection), name, TX_NO_INHERIT);
 
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+    /* Create the internal IP event semaphore, no event is pending.  */
+    ip_ptr -> nx_ip_events_pending =  0;
+    tx_semaphore_create(&(ip_ptr -> nx_ip_events_semaphore), name, 0);
+#else
     /* Create the internal IP event flag object.  */
     tx_event_flags_create(&(ip_ptr -> nx_ip_events), name);
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
 
     /* Pickup current thread pointer.  */
     current_thread =  tx_thread_identify();
@@ -252,8 +252,13 @@ NX_PACKET   *igmp_queue_head;
     /* Delete the internal IP protection mutex.  */
     tx_mutex_delete(&(ip_ptr -> nx_ip_protection));
 
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+    /* Delete the internal IP event semaphore.  */
+    tx_semaphore_delete(&(ip_ptr -> nx_ip_events_semaphore));
+#else
     /* Delete the internal IP event flag object.  */
     tx_event_flags_delete(&(ip_ptr -> nx_ip_events));
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
 
     /* Delete the internal IP thread for handling more processing intensive
        duties.  */
@@ -474,7 +474,7 @@ NX_ICMPV6_HEADER *icmp_header_ptr;
 #ifdef FEATURE_NX_IPV6
                 if ((packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4) ||
                     ((packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6) &&
-                     (incoming_addr -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_VALID)))
+                     NX_IPV6_ADDR_STATE_USABLE(incoming_addr -> nxd_ipv6_address_state)))
                 {
 #endif /* FEATURE_NX_IPV6 */
 
@@ -557,7 +557,7 @@ NX_ICMPV6_HEADER *icmp_header_ptr;
 #ifdef FEATURE_NX_IPV6
                 if ((packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4) ||
                     ((packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6) &&
-                     (incoming_addr -> nxd_ipv6_address_state == NX_IPV6_ADDR_STATE_VALID)))
+                     NX_IPV6_ADDR_STATE_USABLE(incoming_addr -> nxd_ipv6_address_state)))
                 {
 #endif /* FEATURE_NX_IPV6 */
 
@@ -59,7 +59,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Set event flags to wake IP    */
+/*    NX_IP_EVENT_SET                       Set event flags to wake IP    */
 /*                                            helper thread               */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -80,6 +80,6 @@ VOID  _nx_ip_driver_deferred_processing(NX_IP *ip_ptr)
 
     /* Set event flags to wake the IP helper thread, which will in turn
        call the driver with the NX_LINK_DEFERRED_PROCESSING command.  */
-    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_DRIVER_DEFERRED_EVENT, TX_OR);
+    NX_IP_EVENT_SET(ip_ptr, NX_IP_DRIVER_DEFERRED_EVENT);
 }
 
@@ -96,7 +96,7 @@ TX_INTERRUPT_SAVE_AREA
         TX_RESTORE
 
         /* Wakeup IP helper thread to process the packet.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_DRIVER_PACKET_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_DRIVER_PACKET_EVENT);
     }
     else
     {
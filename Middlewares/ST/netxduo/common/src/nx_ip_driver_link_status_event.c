@@ -53,7 +53,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Wakeup IP helper thread       */
+/*    NX_IP_EVENT_SET                       Wakeup IP helper thread       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -79,7 +79,7 @@ TX_INTERRUPT_SAVE_AREA
     ip_ptr -> nx_ip_interface[interface_index].nx_interface_link_status_change = NX_TRUE;
 
     /* Wakeup IP helper thread to process the link status event.  */
-    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_LINK_STATUS_EVENT, TX_OR);
+    NX_IP_EVENT_SET(ip_ptr, NX_IP_LINK_STATUS_EVENT);
 
     /* Restore interrupts.  */
     TX_RESTORE
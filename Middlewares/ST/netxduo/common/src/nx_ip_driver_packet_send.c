@@ -223,6 +223,26 @@ UINT         queued_count;
                 /* Move this ARP entry to the head of the list.  */
                 ip_ptr -> nx_ip_arp_table[index] =  arp_ptr;
 
+#ifdef NX_ENABLE_ARP_ENTRY_LRU
+                /* Move a dynamic ARP entry to the front of the dynamic ARP pool as well.  New
+                   entries are taken from the end of the pool, so the entries traffic is
+                   sent to, such as the gateway, are the last ones to be reused.  */
+                if ((!arp_ptr -> nx_arp_route_static) && (arp_ptr != ip_ptr -> nx_ip_arp_dynamic_list))
+                {
+
+                    /* Link up the neighbors first.  */
+                    (arp_ptr -> nx_arp_pool_next) -> nx_arp_pool_previous =  arp_ptr -> nx_arp_pool_previous;
+                    (arp_ptr -> nx_arp_pool_previous) -> nx_arp_pool_next =  arp_ptr -> nx_arp_pool_next;
+
+                    /* Now link this ARP entry to the head of the pool.  */
+                    arp_ptr -> nx_arp_pool_next =      ip_ptr -> nx_ip_arp_dynamic_list;
+                    arp_ptr -> nx_arp_pool_previous =  (arp_ptr -> nx_arp_pool_next) -> nx_arp_pool_previous;
+                    (arp_ptr -> nx_arp_pool_previous) -> nx_arp_pool_next =  arp_ptr;
+                    (arp_ptr -> nx_arp_pool_next) -> nx_arp_pool_previous =  arp_ptr;
+                    ip_ptr -> nx_ip_arp_dynamic_list =  arp_ptr;
+                }
+#endif /* NX_ENABLE_ARP_ENTRY_LRU */
+
                 /* Restore interrupts.  */
                 TX_RESTORE
             }
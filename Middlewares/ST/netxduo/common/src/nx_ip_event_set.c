@@ -0,0 +1,89 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Internet Protocol (IP)                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+
+
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_ip_event_set                                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function posts events to the IP helper thread. The events are  */
+/*    or'ed into the pending events of the IP instance, and the thread is */
+/*    woken up only when none was pending: further events posted before   */
+/*    it picks them up cost no kernel call. May be called from an ISR.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ip_ptr                                Pointer to IP control block   */
+/*    events                                Events to post                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_semaphore_put                      Wakeup IP helper thread       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    NX_IP_EVENT_SET                       Post events to the IP thread  */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_ip_event_set(NX_IP *ip_ptr, ULONG events)
+{
+TX_INTERRUPT_SAVE_AREA
+
+ULONG pending;
+
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* Add the events to those the IP thread has yet to pickup.  */
+    pending =  ip_ptr -> nx_ip_events_pending;
+    ip_ptr -> nx_ip_events_pending =  pending | events;
+
+    /* The semaphore counts the passes of the IP thread, one is due already
+       when events were pending. It is put before interrupts are restored, so
+       that no other event waits for a preempted caller.  */
+    if (pending == 0)
+    {
+        tx_semaphore_put(&(ip_ptr -> nx_ip_events_semaphore));
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+}
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
@@ -90,6 +90,11 @@ TX_INTERRUPT_SAVE_AREA
 
     ip_ptr -> nx_ip_gateway_interface = NX_NULL;
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* The default route is gone, drop the routes cached.  */
+    ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
     /* Restore interrupts.  */
     TX_RESTORE
 
@@ -129,6 +129,11 @@ NX_INTERFACE *ip_interface_ptr = NX_NULL;
 
     ip_ptr -> nx_ip_gateway_interface = ip_interface_ptr;
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* The default route changed, drop the routes cached.  */
+    ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
     /* Restore interrupts.  */
     TX_RESTORE
 
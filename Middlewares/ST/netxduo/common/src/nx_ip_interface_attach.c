@@ -151,6 +151,10 @@ ULONG         address[4];
     nx_interface -> nx_interface_ip_address        = ip_address;
     nx_interface -> nx_interface_ip_network_mask   = network_mask;
     nx_interface -> nx_interface_ip_network        = ip_address & network_mask;
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* A new network is reachable, drop the routes cached.  */
+    ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
 #endif /* !NX_DISABLE_IPV4  */
     nx_interface -> nx_interface_link_driver_entry = ip_link_driver;
     nx_interface -> nx_interface_name              = interface_name;
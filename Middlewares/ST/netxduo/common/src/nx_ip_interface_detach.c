@@ -282,6 +282,11 @@ NX_IPV6_DEFAULT_ROUTER_ENTRY *rt_entry;
 
     (interface_ptr -> nx_interface_link_driver_entry)(&driver_request);
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* The routes through the interface are gone, drop the routes cached.  */
+    ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
     /* Release the IP internal mutex. */
     tx_mutex_put(&(ip_ptr -> nx_ip_protection));
 
@@ -57,7 +57,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Set events for IP thread      */
+/*    NX_IP_EVENT_SET                       Set events for IP thread      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -110,7 +110,7 @@ TX_INTERRUPT_SAVE_AREA
         TX_RESTORE
 
         /* Wakeup IP helper thread to process the IP deferred receive.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_RECEIVE_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_RECEIVE_EVENT);
     }
 }
 
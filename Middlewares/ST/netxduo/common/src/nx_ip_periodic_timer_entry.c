@@ -57,7 +57,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Set event flags to wakeup     */
+/*    NX_IP_EVENT_SET                       Set event flags to wakeup     */
 /*                                            IP helper thread            */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -83,6 +83,6 @@ NX_IP *ip_ptr;
     NX_TIMER_EXTENSION_PTR_GET(ip_ptr, NX_IP, ip_address)
 
     /* Wakeup this IP's helper thread.  */
-    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_PERIODIC_EVENT, TX_OR);
+    NX_IP_EVENT_SET(ip_ptr, NX_IP_PERIODIC_EVENT);
 }
 
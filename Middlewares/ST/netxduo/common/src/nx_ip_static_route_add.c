@@ -133,6 +133,11 @@ NX_INTERFACE *nx_ip_interface = NX_NULL;
             /* Found the same entry: only need to update the next hop field */
             ip_ptr -> nx_ip_routing_table[i].nx_ip_routing_next_hop_address = next_hop;
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+            /* The next hop changed, drop the routes cached.  */
+            ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
             /* All done.  Unlock the mutex, and return */
             tx_mutex_put(&(ip_ptr -> nx_ip_protection));
             return(NX_SUCCESS);
@@ -190,6 +195,11 @@ NX_INTERFACE *nx_ip_interface = NX_NULL;
 
     ip_ptr -> nx_ip_routing_table_entry_count++;
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+    /* A new route may apply, drop the routes cached.  */
+    ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
     /* Unlock the mutex. */
     tx_mutex_put(&(ip_ptr -> nx_ip_protection));
 
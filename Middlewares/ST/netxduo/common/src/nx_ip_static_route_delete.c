@@ -147,6 +147,11 @@ UINT status         = NX_NOT_SUCCESSFUL;
 
         ip_ptr -> nx_ip_routing_table_entry_count--;
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+        /* The route is gone, drop the routes cached.  */
+        ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
         /* Indicate successful deletion. */
         status = NX_SUCCESS;
     }
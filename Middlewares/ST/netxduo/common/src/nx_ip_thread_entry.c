@@ -71,6 +71,11 @@
 /*    tx_event_flags_get                    Suspend on event flags that   */
 /*                                            are used to signal this     */
 /*                                            thread what to do           */
+/*    tx_semaphore_get                      Suspend until events are      */
+/*                                            pending, with               */
+/*                                            NX_ENABLE_IP_EVENT_SEMAPHORE*/
+/*    NX_IP_EVENT_SET                       Repost the events of a queue  */
+/*                                            left over the budget        */
 /*    tx_mutex_get                          Obtain protection mutex       */
 /*    tx_mutex_put                          Release protection mutex      */
 /*    (nx_ip_driver_deferred_packet_handler)Optional deferred packet      */
@@ -130,6 +135,7 @@ ULONG             ip_events;
 NX_PACKET        *packet_ptr;
 UINT              i;
 UINT              index;
+UINT              packets;
 ULONG             foo;
 #ifdef FEATURE_NX_IPV6
 NXD_IPV6_ADDRESS *interface_ipv6_address;
@@ -243,8 +249,19 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         /* Release the IP internal mutex.  */
         tx_mutex_put(&(ip_ptr -> nx_ip_protection));
 
+#ifdef NX_ENABLE_IP_EVENT_SEMAPHORE
+        /* Wait for the first event posted since the last pass, then pickup all
+           the pending events at once.  */
+        tx_semaphore_get(&(ip_ptr -> nx_ip_events_semaphore), TX_WAIT_FOREVER);
+
+        TX_DISABLE
+        ip_events =  ip_ptr -> nx_ip_events_pending;
+        ip_ptr -> nx_ip_events_pending =  0;
+        TX_RESTORE
+#else
         /* Pickup IP event flags.  */
         tx_event_flags_get(&(ip_ptr -> nx_ip_events), NX_IP_ALL_EVENTS, TX_OR_CLEAR, &ip_events, TX_WAIT_FOREVER);
+#endif /* NX_ENABLE_IP_EVENT_SEMAPHORE */
 
         /* Obtain the IP internal mutex before processing the IP event.  */
         tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
@@ -255,9 +272,12 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         if (ip_events & NX_IP_DRIVER_PACKET_EVENT)
         {
 
-            /* Loop to process all deferred packet requests.  */
-            while (ip_ptr -> nx_ip_driver_deferred_packet_head)
+            /* Loop to process the deferred packet requests, up to the budget.  */
+            packets =  0;
+            while ((ip_ptr -> nx_ip_driver_deferred_packet_head) && (packets < NX_IP_THREAD_PACKET_BUDGET))
             {
+                packets++;
+
                 /* Remove the first packet and process it!  */
 
                 /* Disable interrupts.  */
@@ -291,6 +311,12 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
                 }
             }
 
+            /* Process the rest of the queue on the next pass.  */
+            if (ip_ptr -> nx_ip_driver_deferred_packet_head)
+            {
+                NX_IP_EVENT_SET(ip_ptr, NX_IP_DRIVER_PACKET_EVENT);
+            }
+
             /* Determine if there is anything else to do in the loop.  */
             ip_events =  ip_events & ~(NX_IP_DRIVER_PACKET_EVENT);
             if (!ip_events)
@@ -305,9 +331,11 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         if (ip_events & NX_IP_RECEIVE_EVENT)
         {
 
-            /* Loop to process all deferred packet requests.  */
-            while (ip_ptr -> nx_ip_deferred_received_packet_head)
+            /* Loop to process the deferred packet requests, up to the budget.  */
+            packets =  0;
+            while ((ip_ptr -> nx_ip_deferred_received_packet_head) && (packets < NX_IP_THREAD_PACKET_BUDGET))
             {
+                packets++;
 
                 /* Remove the first packet and process it!  */
 
@@ -335,6 +363,12 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
                 _nx_ip_packet_receive(ip_ptr, packet_ptr);
             }
 
+            /* Process the rest of the queue on the next pass.  */
+            if (ip_ptr -> nx_ip_deferred_received_packet_head)
+            {
+                NX_IP_EVENT_SET(ip_ptr, NX_IP_RECEIVE_EVENT);
+            }
+
             /* Determine if there is anything else to do in the loop.  */
             ip_events =  ip_events & ~(NX_IP_RECEIVE_EVENT);
             if (!ip_events)
@@ -63,7 +63,7 @@
 /*    _nx_ip_checksum_compute               Compute IP checksum           */
 /*    _nx_igmp_multicast_check              Check for Multicast match     */
 /*    _nx_packet_release                    Release packet to packet pool */
-/*    tx_event_flags_set                    Set events for IP thread      */
+/*    NX_IP_EVENT_SET                       Set events for IP thread      */
 /*    _nx_ip_dispatch_process               The routine that examines     */
 /*                                            other optional headers and  */
 /*                                            upper layer protocols.      */
@@ -476,7 +476,7 @@ UINT            packet_consumed;
 
 #ifndef NX_FRAGMENT_IMMEDIATE_ASSEMBLY
                     /* Wakeup IP helper thread to process the IP fragment re-assembly.  */
-                    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_UNFRAG_EVENT, TX_OR);
+                    NX_IP_EVENT_SET(ip_ptr, NX_IP_UNFRAG_EVENT);
 #else
                     /* Process the IP fragment reassemble.  */
                     (ip_ptr -> nx_ip_fragment_assembly)(ip_ptr);
@@ -602,7 +602,7 @@ UINT            packet_consumed;
 
 #ifndef NX_FRAGMENT_IMMEDIATE_ASSEMBLY
                 /* Wakeup IP helper thread to process the IP fragment re-assembly.  */
-                tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_UNFRAG_EVENT, TX_OR);
+                NX_IP_EVENT_SET(ip_ptr, NX_IP_UNFRAG_EVENT);
 #else
                 /* Process the IP fragment reassemble.  */
                 (ip_ptr -> nx_ip_fragment_assembly)(ip_ptr);
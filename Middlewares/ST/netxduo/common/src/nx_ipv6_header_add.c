@@ -194,7 +194,7 @@ USHORT                     short_val;
 
 
         /* If the interface IP address is not valid (in DAD state), only ICMP is allowed */
-        if (packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+        if (!NX_IPV6_ADDR_STATE_USABLE(packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state))
         {
 
 #ifndef NX_DISABLE_IPV6_DAD
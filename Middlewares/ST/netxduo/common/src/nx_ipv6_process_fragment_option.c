@@ -66,7 +66,7 @@
 /*    _nx_ip_dispatch_process               Process IPv6 optional headers */
 /*    NX_ICMPV6_SEND_PARAMETER_PROBLEM      Report IPv6 errors via ICMP   */
 /*                                            message                     */
-/*    tx_event_flags_set                    Wake up the IP helper thread  */
+/*    NX_IP_EVENT_SET                       Wake up the IP helper thread  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -211,7 +211,7 @@ NX_IPV6_HEADER_FRAGMENT_OPTION *fragment_option;
 
 #ifndef NX_FRAGMENT_IMMEDIATE_ASSEMBLY
     /* Wakeup IP helper thread to process the IP fragment re-assembly.  */
-    tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_UNFRAG_EVENT, TX_OR);
+    NX_IP_EVENT_SET(ip_ptr, NX_IP_UNFRAG_EVENT);
 #else
     /* Process the IP fragment reassemble.  */
     (ip_ptr -> nx_ip_fragment_assembly)(ip_ptr);
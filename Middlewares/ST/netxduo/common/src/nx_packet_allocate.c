@@ -59,6 +59,9 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _tx_thread_system_suspend             Suspend thread                */
+/*    tx_time_get                           Get the blocked time          */
+/*    _nx_packet_pool_watermark_check       Check the watermarks of the   */
+/*                                            pool                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -81,6 +84,10 @@ TX_INTERRUPT_SAVE_AREA
 UINT       status;              /* Return status           */
 TX_THREAD *thread_ptr;          /* Working thread pointer  */
 NX_PACKET *work_ptr;            /* Working packet pointer  */
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+UINT       caller;              /* Caller class            */
+ULONG      blocked_ticks;       /* Time spent suspended    */
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
 
 #ifdef TX_ENABLE_EVENT_TRACE
 TX_TRACE_BUFFER_ENTRY *trace_event;
@@ -96,6 +103,22 @@ ULONG                  trace_timestamp;
     /* Set the return pointer to NULL initially.  */
     *packet_ptr =   NX_NULL;
 
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    /* Derive the caller class from the packet type.  */
+    if (packet_type == NX_RECEIVE_PACKET)
+    {
+        caller =  NX_PACKET_POOL_CALLER_DRIVER_RX;
+    }
+    else if ((packet_type == NX_IPv4_TCP_PACKET) || (packet_type == NX_IPv6_TCP_PACKET))
+    {
+        caller =  NX_PACKET_POOL_CALLER_TCP_TX;
+    }
+    else
+    {
+        caller =  NX_PACKET_POOL_CALLER_OTHER;
+    }
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
     /* If trace is enabled, insert this event into the trace buffer.  */
     NX_TRACE_IN_LINE_INSERT(NX_TRACE_PACKET_ALLOCATE, pool_ptr, 0, packet_type, pool_ptr -> nx_packet_pool_available, NX_TRACE_PACKET_EVENTS, &trace_event, &trace_timestamp);
 
@@ -109,6 +132,14 @@ ULONG                  trace_timestamp;
         /* Yes, a packet is available.  Decrement the available count.  */
         pool_ptr -> nx_packet_pool_available--;
 
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+        /* Track the lowest number of available packets.  */
+        if (pool_ptr -> nx_packet_pool_available < pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_min_free)
+        {
+            pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_min_free =  pool_ptr -> nx_packet_pool_available;
+        }
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
         /* Pickup the current packet pointer.  */
         work_ptr =  pool_ptr -> nx_packet_pool_available_list;
 
@@ -246,9 +277,37 @@ ULONG                  trace_timestamp;
             /* Restore interrupts.  */
             TX_RESTORE
 
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+            /* Note the time the suspension starts.  */
+            blocked_ticks =  tx_time_get();
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
             /* Call actual thread suspension routine.  */
             _tx_thread_system_suspend(thread_ptr);
 
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+            /* Compute the time spent suspended.  */
+            blocked_ticks =  tx_time_get() - blocked_ticks;
+
+            /* Disable interrupts to update the statistics.  */
+            TX_DISABLE
+
+            /* Account the blocked time, and the failure if no packet came in time.  */
+            pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_blocked_count++;
+            pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_blocked_ticks +=  blocked_ticks;
+            if (blocked_ticks > pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_blocked_ticks_max)
+            {
+                pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_blocked_ticks_max =  blocked_ticks;
+            }
+            if (thread_ptr -> tx_thread_suspend_status != NX_SUCCESS)
+            {
+                pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_failures[caller]++;
+            }
+
+            /* Restore interrupts.  */
+            TX_RESTORE
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
             /* Update the trace event with the status.  */
             NX_TRACE_EVENT_UPDATE(trace_event, trace_timestamp, NX_TRACE_PACKET_ALLOCATE, 0, *packet_ptr, 0, 0);
 
@@ -269,12 +328,20 @@ ULONG                  trace_timestamp;
 
             /* Immediate return, return error completion.  */
             status =  NX_NO_PACKET;
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+            /* Increment the failure count of the caller class.  */
+            pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_failures[caller]++;
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
         }
     }
 
     /* Restore interrupts.  */
     TX_RESTORE
 
+    /* Tell the application when the pool falls to its low watermark.  */
+    NX_PACKET_POOL_WATERMARK_CHECK(pool_ptr)
+
     /* Update the trace event with the status.  */
     NX_TRACE_EVENT_UPDATE(trace_event, trace_timestamp, NX_TRACE_PACKET_ALLOCATE, 0, *packet_ptr, 0, 0);
 
@@ -0,0 +1,231 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_allocate_bulk                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function allocates up to the specified number of packets from  */
+/*    the packet pool, unlinking them from the available list in one      */
+/*    critical section. It does not suspend: fewer packets are returned   */
+/*    when the pool runs short, and none only when it is empty.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pool to allocate packets from */
+/*    packet_array                          Array to place the allocated  */
+/*                                            packet pointers             */
+/*    packet_type                           Type of packets to allocate   */
+/*    count                                 Packets requested             */
+/*    allocated_count                       Pointer to place the number   */
+/*                                            of packets allocated        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_pool_watermark_check       Check the watermarks of the   */
+/*                                            pool                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_packet_allocate_bulk(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_array,
+                               ULONG packet_type, UINT count, UINT *allocated_count)
+{
+TX_INTERRUPT_SAVE_AREA
+
+UINT       taken;               /* Packets unlinked        */
+UINT       index;               /* Working array index     */
+NX_PACKET *work_ptr;            /* Working packet pointer  */
+NX_PACKET *list_ptr;            /* Unlinked packets        */
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+UINT       caller;              /* Caller class            */
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+
+    /* Make sure the packet_type does not go beyond nx_packet_data_end. */
+    if (pool_ptr -> nx_packet_pool_payload_size < packet_type)
+    {
+        return(NX_INVALID_PARAMETERS);
+    }
+
+    /* Set the allocated count to zero initially.  */
+    *allocated_count =  0;
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    /* Derive the caller class from the packet type.  */
+    if (packet_type == NX_RECEIVE_PACKET)
+    {
+        caller =  NX_PACKET_POOL_CALLER_DRIVER_RX;
+    }
+    else if ((packet_type == NX_IPv4_TCP_PACKET) || (packet_type == NX_IPv6_TCP_PACKET))
+    {
+        caller =  NX_PACKET_POOL_CALLER_TCP_TX;
+    }
+    else
+    {
+        caller =  NX_PACKET_POOL_CALLER_OTHER;
+    }
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+    /* Disable interrupts to get the packets from the pool.  */
+    TX_DISABLE
+
+    /* Take as many packets as requested and available.  */
+    taken =  count;
+    if (taken > pool_ptr -> nx_packet_pool_available)
+    {
+        taken =  (UINT)pool_ptr -> nx_packet_pool_available;
+    }
+
+    if (taken == 0)
+    {
+
+#ifndef NX_DISABLE_PACKET_INFO
+        /* Increment the packet pool empty request count.  */
+        pool_ptr -> nx_packet_pool_empty_requests++;
+#endif
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+        /* Increment the failure count of the caller class.  */
+        pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_failures[caller]++;
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+
+        /* Immediate return, return error completion.  */
+        return(NX_NO_PACKET);
+    }
+
+    /* Unlink the packets at the head of the available list.  */
+    list_ptr =  pool_ptr -> nx_packet_pool_available_list;
+    work_ptr =  list_ptr;
+    for (index = 1; index < taken; index++)
+    {
+        work_ptr =  work_ptr -> nx_packet_queue_next;
+    }
+    pool_ptr -> nx_packet_pool_available_list =  work_ptr -> nx_packet_queue_next;
+
+    /* Decrement the available count.  */
+    pool_ptr -> nx_packet_pool_available -=  taken;
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    /* Track the lowest number of available packets.  */
+    if (pool_ptr -> nx_packet_pool_available < pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_min_free)
+    {
+        pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_min_free =  pool_ptr -> nx_packet_pool_available;
+    }
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Tell the application when the pool falls to its low watermark.  */
+    NX_PACKET_POOL_WATERMARK_CHECK(pool_ptr)
+
+    /* The unlinked packets belong to the caller now, setup their fields
+       outside of the critical section.  */
+    for (index = 0; index < taken; index++)
+    {
+
+        /* Pickup the current packet pointer.  */
+        work_ptr =  list_ptr;
+        list_ptr =  work_ptr -> nx_packet_queue_next;
+
+        /* Setup various fields for this packet.  */
+        work_ptr -> nx_packet_queue_next =   NX_NULL;
+#ifndef NX_DISABLE_PACKET_CHAIN
+        work_ptr -> nx_packet_next =         NX_NULL;
+        work_ptr -> nx_packet_last =         NX_NULL;
+#endif /* NX_DISABLE_PACKET_CHAIN */
+        work_ptr -> nx_packet_length =       0;
+        work_ptr -> nx_packet_prepend_ptr =  work_ptr -> nx_packet_data_start + packet_type;
+        work_ptr -> nx_packet_append_ptr =   work_ptr -> nx_packet_prepend_ptr;
+        work_ptr -> nx_packet_address.nx_packet_interface_ptr = NX_NULL;
+#ifdef NX_ENABLE_INTERFACE_CAPABILITY
+        work_ptr -> nx_packet_interface_capability_flag = 0;
+#endif /* NX_ENABLE_INTERFACE_CAPABILITY */
+        /* Set the TCP queue to the value that indicates it has been allocated.  */
+        /*lint -e{923} suppress cast of ULONG to pointer.  */
+        work_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next =  (NX_PACKET *)NX_PACKET_ALLOCATED;
+
+#ifdef FEATURE_NX_IPV6
+
+        /* Clear the option state. */
+        work_ptr -> nx_packet_option_state = 0;
+#endif /* FEATURE_NX_IPV6 */
+
+#ifdef NX_IPSEC_ENABLE
+
+        /* Clear the ipsec state. */
+        work_ptr -> nx_packet_ipsec_state = 0;
+        work_ptr -> nx_packet_ipsec_sa_ptr = NX_NULL;
+#endif /* NX_IPSEC_ENABLE */
+
+#ifndef NX_DISABLE_IPV4
+        /* Initialize the IP version field */
+        work_ptr -> nx_packet_ip_version = NX_IP_VERSION_V4;
+#endif /* !NX_DISABLE_IPV4  */
+
+        /* Initialize the IP identification flag.  */
+        work_ptr -> nx_packet_identical_copy = NX_FALSE;
+
+        /* Initialize the IP header length. */
+        work_ptr -> nx_packet_ip_header_length = 0;
+
+#ifdef NX_ENABLE_THREAD
+        work_ptr -> nx_packet_type = 0;
+#endif /* NX_ENABLE_THREAD  */
+
+        /* Place the new packet pointer in the return array.  */
+        packet_array[index] =  work_ptr;
+
+        /* Add debug information. */
+        NX_PACKET_DEBUG(__FILE__, __LINE__, work_ptr);
+    }
+
+    /* Return the number of packets allocated.  */
+    *allocated_count =  taken;
+
+    /* Return successful completion.  */
+    return(NX_SUCCESS);
+}
@@ -0,0 +1,86 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_pool_caller_failure                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function accounts a failed packet allocation to the specified  */
+/*    caller class of the pool statistics. It is used by the protocols    */
+/*    above TCP, whose allocations the packet pool cannot tell apart.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pool the allocation failed on */
+/*    caller                                Caller class                  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    NetX Duo Source Code                                                */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_packet_pool_caller_failure(NX_PACKET_POOL *pool_ptr, UINT caller)
+{
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+TX_INTERRUPT_SAVE_AREA
+
+
+    /* Ignore unknown caller classes.  */
+    if ((pool_ptr == NX_NULL) || (caller >= NX_PACKET_POOL_CALLERS))
+    {
+        return;
+    }
+
+    /* Disable interrupts to update the statistics.  */
+    TX_DISABLE
+
+    /* Increment the failure count of this caller class.  */
+    pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_failures[caller]++;
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+#else
+    NX_PARAMETER_NOT_USED(pool_ptr);
+    NX_PARAMETER_NOT_USED(caller);
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+}
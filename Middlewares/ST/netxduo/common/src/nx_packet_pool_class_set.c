@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_pool_class_set                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function links a packet pool to the next larger size class, so */
+/*    that _nx_packet_size_allocate can pick the smallest pool of the     */
+/*    class list that fits and fall back to the larger ones. Classes are  */
+/*    linked from the smallest to the largest.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    larger_pool_ptr                       Pointer to the packet pool of */
+/*                                            the next larger class       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_packet_pool_class_set(NX_PACKET_POOL *pool_ptr, NX_PACKET_POOL *larger_pool_ptr)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+
+    /* Classes must grow, and a pool belongs to one class list only.  */
+    if ((larger_pool_ptr -> nx_packet_pool_payload_size <= pool_ptr -> nx_packet_pool_payload_size) ||
+        (pool_ptr -> nx_packet_pool_class_next != NX_NULL) ||
+        (larger_pool_ptr -> nx_packet_pool_class_first != NX_NULL))
+    {
+        return(NX_INVALID_PARAMETERS);
+    }
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* The first linked pool is the smallest class of the list.  */
+    if (pool_ptr -> nx_packet_pool_class_first == NX_NULL)
+    {
+        pool_ptr -> nx_packet_pool_class_first =  pool_ptr;
+    }
+
+    pool_ptr -> nx_packet_pool_class_next =  larger_pool_ptr;
+    larger_pool_ptr -> nx_packet_pool_class_first =  pool_ptr -> nx_packet_pool_class_first;
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Return success to the caller.  */
+    return(NX_SUCCESS);
+}
+
@@ -190,6 +190,9 @@ VOID           *rounded_pool_start;    /* Rounded stating address     */
     /* Save the remaining information in the pool control packet.  */
     pool_ptr -> nx_packet_pool_available =  packets;
     pool_ptr -> nx_packet_pool_total =      packets;
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    pool_ptr -> nx_packet_pool_stats.nx_packet_pool_stats_min_free =  packets;
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
 
     /* Set the packet pool available list.  */
     pool_ptr -> nx_packet_pool_available_list =  (NX_PACKET *)pool_start;
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_pool_watermark_check                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calls the watermark notification of the specified     */
+/*    packet pool when its available packets have fallen to the low       */
+/*    watermark, or are back to the high watermark after that. The state  */
+/*    changes under interrupt lock, so that one crossing is notified      */
+/*    once whatever the allocations and releases racing with it. The      */
+/*    notify function is called with interrupts restored.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    (nx_packet_pool_watermark_notify)     Application notify function   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_packet_allocate                   Allocate a packet             */
+/*    _nx_packet_allocate_bulk              Allocate several packets      */
+/*    _nx_packet_release                    Release a packet              */
+/*    _nx_packet_release_chain_bulk         Release several chains        */
+/*    _nx_packet_pool_watermark_notify      Set the notification          */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_packet_pool_watermark_check(NX_PACKET_POOL *pool_ptr)
+{
+#ifdef NX_ENABLE_LOW_WATERMARK
+TX_INTERRUPT_SAVE_AREA
+
+VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low);
+UINT is_low;
+
+
+    watermark_notify =  NX_NULL;
+
+    /* Disable interrupts to compare and change the state together.  */
+    TX_DISABLE
+
+    is_low =  pool_ptr -> nx_packet_pool_watermark_is_low;
+
+    if ((!is_low) && (pool_ptr -> nx_packet_pool_available <= pool_ptr -> nx_packet_pool_watermark_low))
+    {
+
+        /* Fallen to the low watermark.  */
+        is_low =  NX_TRUE;
+        watermark_notify =  pool_ptr -> nx_packet_pool_watermark_notify;
+    }
+    else if (is_low && (pool_ptr -> nx_packet_pool_available >= pool_ptr -> nx_packet_pool_watermark_high))
+    {
+
+        /* Back to the high watermark.  */
+        is_low =  NX_FALSE;
+        watermark_notify =  pool_ptr -> nx_packet_pool_watermark_notify;
+    }
+
+    pool_ptr -> nx_packet_pool_watermark_is_low =  is_low;
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Notify the crossing, if any.  */
+    if (watermark_notify)
+    {
+        watermark_notify(pool_ptr, is_low);
+    }
+#else
+    NX_PARAMETER_NOT_USED(pool_ptr);
+#endif /* NX_ENABLE_LOW_WATERMARK */
+}
@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_pool_watermark_notify                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the watermark notification of the specified      */
+/*    packet pool. The notify function is called with NX_TRUE once the    */
+/*    available packets fall to the low watermark, and with NX_FALSE once */
+/*    they are back to the high watermark, so that senders pause in       */
+/*    between instead of blocking on the pool. It is called from the      */
+/*    context that allocated or released the packet, interrupts included, */
+/*    with interrupts enabled, and is limited to services allowed from an */
+/*    ISR. A pool already at its low watermark is notified at once. A     */
+/*    NX_NULL notify function removes the notification.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    low_watermark                         Available packets to pause at */
+/*    high_watermark                        Available packets to resume at*/
+/*    watermark_notify                      Notify function               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_pool_watermark_check       Check the watermarks of the   */
+/*                                            pool                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_packet_pool_watermark_notify(NX_PACKET_POOL *pool_ptr, ULONG low_watermark, ULONG high_watermark,
+                                       VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low))
+{
+#ifdef NX_ENABLE_LOW_WATERMARK
+TX_INTERRUPT_SAVE_AREA
+
+
+    /* Disable interrupts to change the notification as a whole.  */
+    TX_DISABLE
+
+    /* Set the watermarks and the notify function, the pool is not low until checked.  */
+    pool_ptr -> nx_packet_pool_watermark_low =     low_watermark;
+    pool_ptr -> nx_packet_pool_watermark_high =    high_watermark;
+    pool_ptr -> nx_packet_pool_watermark_is_low =  NX_FALSE;
+    pool_ptr -> nx_packet_pool_watermark_notify =  watermark_notify;
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Notify a pool already at its low watermark.  */
+    NX_PACKET_POOL_WATERMARK_CHECK(pool_ptr)
+
+    /* Return completion status.  */
+    return(NX_SUCCESS);
+#else
+    NX_PARAMETER_NOT_USED(pool_ptr);
+    NX_PARAMETER_NOT_USED(low_watermark);
+    NX_PARAMETER_NOT_USED(high_watermark);
+    NX_PARAMETER_NOT_USED(watermark_notify);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_ENABLE_LOW_WATERMARK */
+}
@@ -56,6 +56,8 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _tx_thread_system_resume              Resume suspended thread       */
+/*    _nx_packet_pool_watermark_check       Check the watermarks of the   */
+/*                                            pool                        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -80,11 +82,42 @@ TX_THREAD      *thread_ptr;     /* Working thread pointer  */
 #ifndef NX_DISABLE_PACKET_CHAIN
 NX_PACKET      *next_packet;    /* Working block pointer   */
 #endif /* NX_DISABLE_PACKET_CHAIN */
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+ULONG           chain_length;   /* Packets in the chain    */
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
 
 
     /* If trace is enabled, insert this event into the trace buffer.  */
     NX_TRACE_IN_LINE_INSERT(NX_TRACE_PACKET_RELEASE, packet_ptr, packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next, (packet_ptr -> nx_packet_pool_owner) -> nx_packet_pool_available, 0, NX_TRACE_PACKET_EVENTS, 0, 0);
 
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+    /* Account the chain length to the pool of the head packet.  */
+    /*lint -e{923} suppress cast of ULONG to pointer.  */
+    if (packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next == ((NX_PACKET *)NX_PACKET_ALLOCATED))
+    {
+        chain_length =  1;
+#ifndef NX_DISABLE_PACKET_CHAIN
+        for (next_packet = packet_ptr -> nx_packet_next; next_packet; next_packet = next_packet -> nx_packet_next)
+        {
+            chain_length++;
+        }
+#endif /* NX_DISABLE_PACKET_CHAIN */
+
+        if (chain_length > NX_PACKET_POOL_CHAIN_BUCKETS)
+        {
+            chain_length =  NX_PACKET_POOL_CHAIN_BUCKETS;
+        }
+
+        /* Disable interrupts to update the statistics.  */
+        TX_DISABLE
+
+        (packet_ptr -> nx_packet_pool_owner) -> nx_packet_pool_stats.nx_packet_pool_stats_chain_histogram[chain_length - 1]++;
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+    }
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
 #ifndef NX_DISABLE_PACKET_CHAIN
     /* Loop to free all packets chained together, not assuming they are
        from the same pool.  */
@@ -242,6 +275,9 @@ NX_PACKET      *next_packet;    /* Working block pointer   */
 
             /* Restore interrupts.  */
             TX_RESTORE
+
+            /* Tell the application when the pool is back to its high watermark.  */
+            NX_PACKET_POOL_WATERMARK_CHECK(pool_ptr)
         }
 
 #ifndef NX_DISABLE_PACKET_CHAIN
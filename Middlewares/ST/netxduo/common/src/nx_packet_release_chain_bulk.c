@@ -0,0 +1,232 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_release_chain_bulk                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function releases a list of packet chains, linked by their     */
+/*    queue next pointers, back to their pools. All the packets are       */
+/*    checked first, none is released if one is not allocated. They are   */
+/*    then put back in the available lists in one critical section,       */
+/*    except the packets of a pool a thread is suspended on, which are    */
+/*    released one at a time to hand them to the thread.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_list                           First packet chain to release */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_release                    Release a packet to a thread  */
+/*                                            suspended on its pool       */
+/*    _nx_packet_pool_watermark_check       Check the watermarks of the   */
+/*                                            pool                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*    _nx_tcp_socket_state_ack_check        Process received ACK          */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_packet_release_chain_bulk(NX_PACKET *packet_list)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+NX_PACKET_POOL *pool_ptr;       /* Pool pointer            */
+NX_PACKET      *head_ptr;       /* Working chain pointer   */
+NX_PACKET      *next_head;      /* Next chain pointer      */
+NX_PACKET      *packet_ptr;     /* Working packet pointer  */
+NX_PACKET      *next_packet;    /* Next packet pointer     */
+NX_PACKET      *slow_list;      /* Packets for a thread    */
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+ULONG           chain_length;   /* Packets in the chain    */
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+#ifdef NX_ENABLE_LOW_WATERMARK
+ULONG           index;          /* Created pool index      */
+#endif /* NX_ENABLE_LOW_WATERMARK */
+
+
+    /* Check all the packets before releasing any of them.  */
+    for (head_ptr = packet_list; head_ptr; head_ptr = head_ptr -> nx_packet_queue_next)
+    {
+#ifndef NX_DISABLE_PACKET_CHAIN
+        for (packet_ptr = head_ptr; packet_ptr; packet_ptr = packet_ptr -> nx_packet_next)
+#else
+        packet_ptr =  head_ptr;
+#endif /* NX_DISABLE_PACKET_CHAIN */
+        {
+
+            /* Check to see if the packet is releasable.  */
+            /*lint -e{923} suppress cast of ULONG to pointer.  */
+            if (packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next != ((NX_PACKET *)NX_PACKET_ALLOCATED))
+            {
+
+#ifndef NX_DISABLE_PACKET_INFO
+                /* Pickup the pool pointer.  */
+                pool_ptr =  packet_ptr -> nx_packet_pool_owner;
+
+                /* Check for a good pool pointer...  error must be the packet!  */
+                if ((pool_ptr) && (pool_ptr -> nx_packet_pool_id == NX_PACKET_POOL_ID))
+                {
+
+                    /* Increment the packet pool invalid release error count.  */
+                    pool_ptr -> nx_packet_pool_invalid_releases++;
+                }
+#endif
+
+                /* Return an error indicating the packets could not be released.  */
+                return(NX_PTR_ERROR);
+            }
+        }
+    }
+
+    slow_list =  NX_NULL;
+
+    /* Disable interrupts to put the packets back in their pools.  */
+    TX_DISABLE
+
+    head_ptr =  packet_list;
+    while (head_ptr)
+    {
+
+        /* Pickup the next chain before the queue pointer is reused.  */
+        next_head =  head_ptr -> nx_packet_queue_next;
+
+#ifdef NX_ENABLE_PACKET_POOL_STATISTICS
+        /* Account the chain length to the pool of the head packet.  */
+        chain_length =  1;
+#ifndef NX_DISABLE_PACKET_CHAIN
+        for (packet_ptr = head_ptr -> nx_packet_next; packet_ptr; packet_ptr = packet_ptr -> nx_packet_next)
+        {
+            chain_length++;
+        }
+#endif /* NX_DISABLE_PACKET_CHAIN */
+
+        if (chain_length > NX_PACKET_POOL_CHAIN_BUCKETS)
+        {
+            chain_length =  NX_PACKET_POOL_CHAIN_BUCKETS;
+        }
+
+        (head_ptr -> nx_packet_pool_owner) -> nx_packet_pool_stats.nx_packet_pool_stats_chain_histogram[chain_length - 1]++;
+#endif /* NX_ENABLE_PACKET_POOL_STATISTICS */
+
+        packet_ptr =  head_ptr;
+        while (packet_ptr)
+        {
+
+            /* Pickup the next packet of the chain.  */
+#ifndef NX_DISABLE_PACKET_CHAIN
+            next_packet =  packet_ptr -> nx_packet_next;
+#else
+            next_packet =  NX_NULL;
+#endif /* NX_DISABLE_PACKET_CHAIN */
+
+            /* Add debug information. */
+            NX_PACKET_DEBUG(__FILE__, __LINE__, packet_ptr);
+
+            /* Pickup the pool pointer.  */
+            pool_ptr =  packet_ptr -> nx_packet_pool_owner;
+
+            if (pool_ptr -> nx_packet_pool_suspension_list)
+            {
+
+                /* A thread waits for this pool, the packet is given to it
+                   once interrupts are restored.  */
+#ifndef NX_DISABLE_PACKET_CHAIN
+                packet_ptr -> nx_packet_next =  NX_NULL;
+#endif /* NX_DISABLE_PACKET_CHAIN */
+                packet_ptr -> nx_packet_queue_next =  slow_list;
+                slow_list =  packet_ptr;
+            }
+            else
+            {
+
+                /* Mark the packet as free.  */
+                /*lint -e{923} suppress cast of ULONG to pointer.  */
+                packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next =  (NX_PACKET *)NX_PACKET_FREE;
+
+                /* Put the packet back in the available list.  */
+                packet_ptr -> nx_packet_queue_next =  pool_ptr -> nx_packet_pool_available_list;
+
+                /* Adjust the head pointer.  */
+                pool_ptr -> nx_packet_pool_available_list =  packet_ptr;
+
+                /* Increment the count of available blocks.  */
+                pool_ptr -> nx_packet_pool_available++;
+            }
+
+            /* Move to the next packet in the chain.  */
+            packet_ptr =  next_packet;
+        }
+
+        /* Move to the next chain in the list.  */
+        head_ptr =  next_head;
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+#ifdef NX_ENABLE_LOW_WATERMARK
+    /* The chains may come from several pools, check each pool that has a
+       watermark notification.  */
+    pool_ptr =  _nx_packet_pool_created_ptr;
+    for (index = 0; index < _nx_packet_pool_created_count; index++)
+    {
+        NX_PACKET_POOL_WATERMARK_CHECK(pool_ptr)
+        pool_ptr =  pool_ptr -> nx_packet_pool_created_next;
+    }
+#endif /* NX_ENABLE_LOW_WATERMARK */
+
+    /* Hand the remaining packets to the suspended threads, each is
+       accounted again as a chain of one packet.  */
+    while (slow_list)
+    {
+        packet_ptr =  slow_list;
+        slow_list =  packet_ptr -> nx_packet_queue_next;
+        packet_ptr -> nx_packet_queue_next =  NX_NULL;
+
+        _nx_packet_release(packet_ptr);
+    }
+
+    /* Return completion status.  */
+    return(NX_SUCCESS);
+}
@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_packet_size_allocate                            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function allocates a packet from the smallest size class of    */
+/*    the pool's class list whose payload holds the packet type offset    */
+/*    and the requested payload. An empty class falls back to the next    */
+/*    larger one without waiting; only the largest class honors the wait  */
+/*    option. A payload larger than every class is allocated from the     */
+/*    largest class and left to be chained by the caller.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to any pool of the    */
+/*                                            class list                  */
+/*    packet_ptr                            Pointer to place allocated    */
+/*                                            packet pointer              */
+/*    packet_type                           Type of packet to allocate    */
+/*    payload_size                          Bytes expected to be appended */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_allocate                   Allocate a packet             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_packet_size_allocate(NX_PACKET_POOL *pool_ptr, NX_PACKET **packet_ptr,
+                               ULONG packet_type, ULONG payload_size, ULONG wait_option)
+{
+
+NX_PACKET_POOL *class_ptr;
+
+
+    /* Start from the smallest class of the list.  */
+    class_ptr =  pool_ptr -> nx_packet_pool_class_first;
+    if (class_ptr == NX_NULL)
+    {
+        class_ptr =  pool_ptr;
+    }
+
+    while (class_ptr -> nx_packet_pool_class_next != NX_NULL)
+    {
+
+        /* Try the classes that fit without waiting.  */
+        if ((class_ptr -> nx_packet_pool_payload_size >= (packet_type + payload_size)) &&
+            (_nx_packet_allocate(class_ptr, packet_ptr, packet_type, NX_NO_WAIT) == NX_SUCCESS))
+        {
+            return(NX_SUCCESS);
+        }
+
+        class_ptr =  class_ptr -> nx_packet_pool_class_next;
+    }
+
+    /* Allocate from the largest class.  */
+    return(_nx_packet_allocate(class_ptr, packet_ptr, packet_type, wait_option));
+}
+
@@ -59,7 +59,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Wakeup IP helper thread       */
+/*    NX_IP_EVENT_SET                       Wakeup IP helper thread       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -133,7 +133,7 @@ TX_INTERRUPT_SAVE_AREA
         TX_RESTORE
 
         /* Wakeup IP helper thread to process the RARP deferred receive.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_RARP_REC_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_RARP_REC_EVENT);
     }
 }
 #endif /* !NX_DISABLE_IPV4  */
@@ -159,6 +159,11 @@ VOID  *additional_info = NX_NULL;
                IP address in the RARP response.  */
             packet_ptr -> nx_packet_address.nx_packet_interface_ptr -> nx_interface_ip_address =  *(message_ptr + 6);
 
+#ifdef NX_ENABLE_UDP_ROUTE_CACHE
+            /* The address of the interface changed, drop the routes cached.  */
+            ip_ptr -> nx_ip_route_generation++;
+#endif /* NX_ENABLE_UDP_ROUTE_CACHE */
+
             /* Loop through all the interfaces and check whether or not to continue periodic RARP requests. */
             for (i = 0; i < NX_MAX_PHYSICAL_INTERFACES; i++)
             {
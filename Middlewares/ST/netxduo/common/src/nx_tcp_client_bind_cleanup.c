@@ -59,7 +59,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    tx_event_flags_set                    Set event flag                */
+/*    NX_IP_EVENT_SET                       Set event flag                */
 /*    _tx_thread_system_resume              Resume thread service         */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -135,7 +135,7 @@ NX_TCP_SOCKET *owning_socket_ptr; /* Socket owning the port  */
         TX_RESTORE
 
         /* Set the deferred cleanup flag for the IP thread.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_TCP_CLEANUP_DEFERRED, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_TCP_CLEANUP_DEFERRED);
 
         /* Return to caller.  */
         return;
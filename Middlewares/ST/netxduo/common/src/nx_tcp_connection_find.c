@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef FEATURE_NX_IPV6
+#include "nx_ipv6.h"
+#endif
+
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_connection_find                             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finds the TCP socket connected with the specified     */
+/*    ports and peer address in the connection table of the IP instance.  */
+/*    The connection found last is examined first, since a burst of       */
+/*    segments is usually for the same connection, then the connections   */
+/*    on the hashed index of the table.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ip_ptr                                Pointer to IP instance        */
+/*    port                                  Local TCP port                */
+/*    source_port                           Peer TCP port                 */
+/*    ip_version                            IP version of the peer        */
+/*    source_ip                             Pointer to peer IP address    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    socket_ptr                            Connected socket, NX_NULL if  */
+/*                                            the connection is not found */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_process                Process incoming packet       */
+/*                                                                        */
+/**************************************************************************/
+NX_TCP_SOCKET  *_nx_tcp_connection_find(NX_IP *ip_ptr, UINT port, UINT source_port, UINT ip_version, ULONG *source_ip)
+{
+
+NX_TCP_SOCKET *socket_ptr;
+NX_TCP_SOCKET *cache_ptr;
+ULONG          address;
+UINT           index;
+UINT           find_a_match;
+
+
+    /* Pickup the last word of the peer address for the hash.  */
+    address =  *source_ip;
+#ifdef FEATURE_NX_IPV6
+    if (ip_version == NX_IP_VERSION_V6)
+    {
+        address =  source_ip[3];
+    }
+#endif /* FEATURE_NX_IPV6 */
+
+    /* Calculate the hash index in the TCP connection table of the IP instance.  */
+    index =  NX_TCP_CONNECTION_INDEX(port, source_port, address);
+
+    /* Examine the connection found last first, then the connections on the index.  */
+    cache_ptr =  ip_ptr -> nx_ip_tcp_connection_cache;
+    socket_ptr =  cache_ptr;
+    if (socket_ptr == NX_NULL)
+    {
+        socket_ptr =  ip_ptr -> nx_ip_tcp_connection_table[index];
+    }
+
+    while (socket_ptr)
+    {
+
+        find_a_match =  NX_FALSE;
+
+        /* Determine if the ports and the IP version are the same.  */
+        if ((socket_ptr -> nx_tcp_socket_port == port) &&
+            (socket_ptr -> nx_tcp_socket_connect_port == source_port) &&
+            (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version == ip_version))
+        {
+
+#ifndef NX_DISABLE_IPV4
+            if (ip_version == NX_IP_VERSION_V4)
+            {
+
+                if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v4 == *source_ip)
+                {
+                    find_a_match =  NX_TRUE;
+                }
+            }
+#endif /* !NX_DISABLE_IPV4  */
+
+#ifdef FEATURE_NX_IPV6
+            if (ip_version == NX_IP_VERSION_V6)
+            {
+
+                if (CHECK_IPV6_ADDRESSES_SAME(socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v6, source_ip))
+                {
+                    find_a_match =  NX_TRUE;
+                }
+            }
+#endif /* FEATURE_NX_IPV6 */
+        }
+
+        if (find_a_match)
+        {
+
+            /* Remember the connection for the next segment.  */
+            ip_ptr -> nx_ip_tcp_connection_cache =  socket_ptr;
+
+            return(socket_ptr);
+        }
+
+        /* Move to the next connection, starting over from the index after the connection found last.  */
+        if (cache_ptr)
+        {
+            socket_ptr =  ip_ptr -> nx_ip_tcp_connection_table[index];
+            cache_ptr =  NX_NULL;
+        }
+        else
+        {
+            socket_ptr =  socket_ptr -> nx_tcp_socket_connection_next;
+        }
+    }
+
+    /* The connection is not in the table.  */
+    return(NX_NULL);
+}
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
@@ -51,6 +51,12 @@
 /*    for re-transmitting packets that have not been ACKed by the other   */
 /*    side of the connection.                                             */
 /*                                                                        */
+/*    With NX_ENABLE_TCP_FAST_TIMER_IDLE, the fast periodic timer is      */
+/*    stopped once no socket has a timeout or a delayed ACK pending, so   */
+/*    that an idle connection does not wake the processor every fast      */
+/*    timer period. The next received segment or armed timeout restarts   */
+/*    it.                                                                 */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    ip_ptr                                Pointer to IP control block   */
@@ -66,6 +72,7 @@
 /*    _nx_tcp_socket_connection_reset       Reset connection on timeout   */
 /*    _nx_tcp_socket_block_cleanup          Cleanup the socket block      */
 /*    _nx_tcp_socket_retransmit             Retransmit packet             */
+/*    tx_timer_deactivate                   Stop the fast periodic timer  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -86,6 +93,9 @@ VOID  _nx_tcp_fast_periodic_processing(NX_IP *ip_ptr)
 NX_TCP_SOCKET *socket_ptr;
 ULONG          sockets;
 ULONG          timer_rate;
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+UINT           busy =  NX_FALSE;
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
 
 
     /* Pickup this timer's periodic rate.  */
@@ -105,9 +115,18 @@ ULONG          timer_rate;
            from a previous receive packet event.  */
         if ((socket_ptr -> nx_tcp_socket_state >= NX_TCP_ESTABLISHED) &&
             ((socket_ptr -> nx_tcp_socket_rx_sequence != socket_ptr -> nx_tcp_socket_rx_sequence_acked) ||
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+             (socket_ptr -> nx_tcp_socket_rx_window_last_sent < _nx_tcp_socket_rx_window_compute(socket_ptr))))
+#else
              (socket_ptr -> nx_tcp_socket_rx_window_last_sent < socket_ptr -> nx_tcp_socket_rx_window_current)))
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
         {
 
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+            /* The delayed ACK needs the next tick, if only to see it sent.  */
+            busy =  NX_TRUE;
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
+
             /* Determine if the ACK has expired.  */
             if (socket_ptr -> nx_tcp_socket_delayed_ack_timeout <= timer_rate)
             {
@@ -173,6 +192,12 @@ ULONG          timer_rate;
                 /* Update the transmit sequence that entered fast transmit. */
                 socket_ptr -> nx_tcp_socket_tx_sequence_recover = socket_ptr -> nx_tcp_socket_tx_sequence - 1;
 
+#ifdef NX_ENABLE_TCP_SACK
+                /* After a timeout the ranges selectively acknowledged are not relied on,
+                   the peer may have discarded them. RFC 2018, Section 8.  */
+                socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
+
                 /* Retransmit the packet. */
                 _nx_tcp_socket_retransmit(ip_ptr, socket_ptr, NX_FALSE);
 
@@ -206,8 +231,33 @@ ULONG          timer_rate;
             }
         }
 
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+        /* A timeout still armed, or armed again above, needs the next ticks.  */
+        if (socket_ptr -> nx_tcp_socket_timeout)
+        {
+            busy =  NX_TRUE;
+        }
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
+
         /* Move to the next TCP socket.  */
         socket_ptr =  socket_ptr -> nx_tcp_socket_created_next;
     }
+
+#ifdef NX_ENABLE_TCP_FAST_TIMER_IDLE
+#ifdef FEATURE_NX_IPV6
+    /* The ND cache and duplicate address detection run on the same timer.  */
+    if (ip_ptr -> nx_nd_cache_fast_periodic_update)
+    {
+        busy =  NX_TRUE;
+    }
+#endif /* FEATURE_NX_IPV6 */
+
+    /* Stop the fast periodic timer while nothing needs it, NX_TCP_FAST_TIMER_RESUME restarts it.  */
+    if (!busy)
+    {
+        ip_ptr -> nx_ip_fast_periodic_timer_idle =  NX_TRUE;
+        tx_timer_deactivate(&(ip_ptr -> nx_ip_fast_periodic_timer));
+    }
+#endif /* NX_ENABLE_TCP_FAST_TIMER_IDLE */
 }
 
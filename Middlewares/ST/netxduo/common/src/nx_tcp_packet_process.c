@@ -103,6 +103,9 @@ ULONG                       *source_ip = NX_NULL;
 ULONG                       *dest_ip = NX_NULL;
 UINT                         source_port;
 NX_TCP_SOCKET               *socket_ptr;
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+NX_TCP_SOCKET               *connection_ptr;
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
 NX_TCP_HEADER               *tcp_header_ptr;
 struct NX_TCP_LISTEN_STRUCT *listen_ptr;
 VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT port);
@@ -124,6 +127,9 @@ UINT                         status;
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
 ULONG                        rwin_scale = 0xFF;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+#ifdef NX_ENABLE_TCP_SACK
+UINT                         sack_permitted = NX_FALSE;
+#endif /* NX_ENABLE_TCP_SACK */
 
 #ifdef NX_DISABLE_TCP_RX_CHECKSUM
     compute_checksum = 0;
@@ -132,6 +138,9 @@ ULONG                        rwin_scale = 0xFF;
     /* Add debug information. */
     NX_PACKET_DEBUG(__FILE__, __LINE__, packet_ptr);
 
+    /* A received segment may arm a timeout or a delayed ACK, restart the fast timer.  */
+    NX_TCP_FAST_TIMER_RESUME(ip_ptr)
+
     /* Pickup the source IP address.  */
 #ifndef NX_DISABLE_IPV4
     if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4)
@@ -173,7 +182,8 @@ ULONG                        rwin_scale = 0xFF;
 #endif /* FEATURE_NX_IPV6 */
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
-    if (interface_ptr -> nx_interface_capability_flag & NX_INTERFACE_CAPABILITY_TCP_RX_CHECKSUM)
+    if ((interface_ptr -> nx_interface_capability_flag & NX_INTERFACE_CAPABILITY_TCP_RX_CHECKSUM) &&
+        !(packet_ptr -> nx_packet_interface_capability_flag & NX_INTERFACE_CAPABILITY_RX_CHECKSUM_BYPASS))
     {
         compute_checksum = 0;
     }
@@ -295,6 +305,16 @@ ULONG                        rwin_scale = 0xFF;
             is_valid_option_flag = NX_FALSE;
         }
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+
+#ifdef NX_ENABLE_TCP_SACK
+        status = _nx_tcp_sack_permitted_option_get((packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER)), option_words * (ULONG)sizeof(ULONG), &sack_permitted);
+
+        /* Check the status. if status is NX_FALSE, means Option Length is invalid.  */
+        if (status == NX_FALSE)
+        {
+            is_valid_option_flag = NX_FALSE;
+        }
+#endif /* NX_ENABLE_TCP_SACK */
     }
 
     /* Pickup the destination TCP port.  */
@@ -309,6 +329,16 @@ ULONG                        rwin_scale = 0xFF;
     /* Search the bound sockets in this index for the particular port.  */
     socket_ptr =  ip_ptr -> nx_ip_tcp_port_table[index];
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+    /* Look up the connection of the segment by its ports and peer address.  If it is
+       found, it is the first socket searched below so it matches right away.  */
+    connection_ptr =  _nx_tcp_connection_find(ip_ptr, port, source_port, packet_ptr -> nx_packet_ip_version, source_ip);
+    if (connection_ptr)
+    {
+        socket_ptr =  connection_ptr;
+    }
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
     /* Determine if there are any sockets bound on this port index.  */
     if (socket_ptr)
     {
@@ -393,6 +423,12 @@ ULONG                        rwin_scale = 0xFF;
                          */
                         socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+
+#ifdef NX_ENABLE_TCP_SACK
+                        /* Record whether the peer permits SACK, nothing is selectively acknowledged yet.  */
+                        socket_ptr -> nx_tcp_socket_sack_permitted = sack_permitted;
+                        socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
                     }
 
                     /* Process the packet within an existing TCP connection.  */
@@ -686,6 +722,12 @@ ULONG                        rwin_scale = 0xFF;
                     socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+                    /* Record whether the peer permits SACK, nothing is selectively acknowledged yet.  */
+                    socket_ptr -> nx_tcp_socket_sack_permitted = sack_permitted;
+                    socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
+
                     /* Set the initial slow start threshold to be the advertised window size. */
                     socket_ptr -> nx_tcp_socket_tx_slow_start_threshold = socket_ptr -> nx_tcp_socket_tx_window_advertised;
 
@@ -722,6 +764,11 @@ ULONG                        rwin_scale = 0xFF;
                         ip_ptr -> nx_ip_tcp_port_table[index] =       socket_ptr;
                     }
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+                    /* The peer is known now, index the connection.  */
+                    _nx_tcp_socket_connection_insert(socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
                     /* Pickup the listen callback function.  */
                     listen_callback = listen_ptr -> nx_tcp_listen_callback;
 
@@ -62,7 +62,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_tcp_packet_process                Process TCP packet            */
-/*    tx_event_flags_set                    Set event flags for IP helper */
+/*    NX_IP_EVENT_SET                       Set event flags for IP helper */
 /*                                            thread                      */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -82,6 +82,7 @@ VOID  _nx_tcp_packet_receive(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
 {
 
 TX_INTERRUPT_SAVE_AREA
+CYCLE_PROFILE_SAVE_AREA
 
 
     /* Add debug information. */
@@ -145,14 +146,16 @@ TX_INTERRUPT_SAVE_AREA
         TX_RESTORE
 
         /* Wakeup IP thread for processing one or more messages in the TCP queue.  */
-        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_TCP_EVENT, TX_OR);
+        NX_IP_EVENT_SET(ip_ptr, NX_IP_TCP_EVENT);
     }
     else
     {
 
         /* The IP message was deferred, so this routine is called from the IP helper
            thread and thus may call the TCP processing directly.  */
+        CYCLE_PROFILE_ENTER
         _nx_tcp_packet_process(ip_ptr, packet_ptr);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TCP_PROCESS)
     }
 }
 
@@ -102,6 +102,10 @@ UINT           compute_checksum = 1;
 #endif /* defined(NX_DISABLE_TCP_TX_CHECKSUM) || defined(NX_ENABLE_INTERFACE_CAPABILITY) || defined(NX_IPSEC_ENABLE) */
 ULONG          header_size;
 ULONG          window_size;
+ULONG          rx_window;
+#ifdef NX_ENABLE_TCP_SACK
+UINT           sack_option_length = 0;
+#endif /* NX_ENABLE_TCP_SACK */
 
 #ifdef NX_DISABLE_TCP_TX_CHECKSUM
     compute_checksum = 0;
@@ -110,12 +114,23 @@ ULONG          window_size;
     /* Setup the IP pointer.  */
     ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
 
+    /* Pickup the receive window.  */
+    rx_window =  socket_ptr -> nx_tcp_socket_rx_window_current;
+
     if (control_bits & NX_TCP_SYN_BIT)
     {
 
         /* Set header size. */
         header_size = NX_TCP_SYN_HEADER;
         window_size = socket_ptr -> nx_tcp_socket_rx_window_current;
+
+#ifdef NX_ENABLE_TCP_SACK
+        /* One more option word for SACK permitted.  */
+        if (socket_ptr -> nx_tcp_socket_sack_permitted)
+        {
+            header_size = NX_TCP_SYN_SACK_HEADER;
+        }
+#endif /* NX_ENABLE_TCP_SACK */
     }
     else
     {
@@ -123,11 +138,16 @@ ULONG          window_size;
         /* Set header size. */
         header_size = NX_TCP_HEADER_SIZE;
 
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+        /* Advertise no more than the free packets of the receive pool can hold.  */
+        rx_window =  _nx_tcp_socket_rx_window_compute(socket_ptr);
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+
         /* Set window size. */
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
-        window_size = socket_ptr -> nx_tcp_socket_rx_window_current >> socket_ptr -> nx_tcp_rcv_win_scale_value;
+        window_size = rx_window >> socket_ptr -> nx_tcp_rcv_win_scale_value;
 #else
-        window_size = socket_ptr -> nx_tcp_socket_rx_window_current;
+        window_size = rx_window;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
     }
 
@@ -180,6 +200,17 @@ ULONG          window_size;
         return;
     }
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Check to see if the packet has enough room to fill with the TCP header and the largest SACK option.  */
+    if ((UINT)(packet_ptr -> nx_packet_data_end - packet_ptr -> nx_packet_prepend_ptr) < (sizeof(NX_TCP_HEADER) + NX_TCP_SACK_OPTION_SIZE))
+    {
+
+        /* Error getting packet, so just get out!  */
+        _nx_packet_release(packet_ptr);
+        return;
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /*lint -e{644} suppress variable might not be initialized, since "packet_ptr" was initialized in _nx_packet_allocate. */
     packet_ptr -> nx_packet_ip_version = (UCHAR)(socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version);
 
@@ -210,6 +241,22 @@ ULONG          window_size;
     /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
     tcp_header_ptr =  (NX_TCP_HEADER *)packet_ptr -> nx_packet_prepend_ptr;
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Report the out of order data held to the peer in an ACK, but not in a zero window probe.  */
+    if ((socket_ptr -> nx_tcp_socket_sack_permitted) && (data == NX_NULL) &&
+        ((control_bits & (NX_TCP_ACK_BIT | NX_TCP_SYN_BIT | NX_TCP_RST_BIT)) == NX_TCP_ACK_BIT))
+    {
+
+        /* Build the SACK option after the TCP header.  */
+        sack_option_length = _nx_tcp_socket_sack_option_build(socket_ptr, packet_ptr -> nx_packet_append_ptr);
+
+        /* Adjust the header size and packet information. */
+        header_size += (ULONG)(sack_option_length >> 2) << NX_TCP_HEADER_SHIFT;
+        packet_ptr -> nx_packet_append_ptr += sack_option_length;
+        packet_ptr -> nx_packet_length += sack_option_length;
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Build the control request in the TCP header.  */
     tcp_header_ptr -> nx_tcp_header_word_0 =        (((ULONG)(socket_ptr -> nx_tcp_socket_port)) << NX_SHIFT_BY_16) | (ULONG)socket_ptr -> nx_tcp_socket_connect_port;
     tcp_header_ptr -> nx_tcp_sequence_number =      tx_sequence;
@@ -219,7 +266,7 @@ ULONG          window_size;
 
     /* Remember the last ACKed sequence and the last reported window size.  */
     socket_ptr -> nx_tcp_socket_rx_sequence_acked =    ack_number;
-    socket_ptr -> nx_tcp_socket_rx_window_last_sent =  socket_ptr -> nx_tcp_socket_rx_window_current;
+    socket_ptr -> nx_tcp_socket_rx_window_last_sent =  rx_window;
 
     /* Endian swapping logic.  If NX_LITTLE_ENDIAN is specified, these macros will
        swap the endian of the TCP header.  */
@@ -255,6 +302,21 @@ ULONG          window_size;
         /* Adjust packet information. */
         packet_ptr -> nx_packet_append_ptr += (sizeof(ULONG) << 1);
         packet_ptr -> nx_packet_length += (ULONG)(sizeof(ULONG) << 1);
+
+#ifdef NX_ENABLE_TCP_SACK
+        if (socket_ptr -> nx_tcp_socket_sack_permitted)
+        {
+
+            /* Set SACK permitted option. */
+            option_word_1 = NX_TCP_SACK_PERMIT_OPTION;
+            NX_CHANGE_ULONG_ENDIAN(option_word_1);
+            *((ULONG *)packet_ptr -> nx_packet_append_ptr) = option_word_1;
+
+            /* Adjust packet information. */
+            packet_ptr -> nx_packet_append_ptr += sizeof(ULONG);
+            packet_ptr -> nx_packet_length += (ULONG)sizeof(ULONG);
+        }
+#endif /* NX_ENABLE_TCP_SACK */
     }
 
 #ifdef NX_ENABLE_INTERFACE_CAPABILITY
@@ -318,6 +318,14 @@ ULONG        mss = 0;
     }
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* Offer SACK if we initiate the SYN. Otherwise it is included only if the peer offered it. */
+    if (socket_ptr -> nx_tcp_socket_state == NX_TCP_SYN_SENT)
+    {
+        socket_ptr -> nx_tcp_socket_sack_permitted = NX_TRUE;
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Send SYN or SYN+ACK packet according to socket state. */
     if (socket_ptr -> nx_tcp_socket_state == NX_TCP_SYN_SENT)
     {
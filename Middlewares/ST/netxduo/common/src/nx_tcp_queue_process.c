@@ -72,6 +72,7 @@ VOID  _nx_tcp_queue_process(NX_IP *ip_ptr)
 {
 
 TX_INTERRUPT_SAVE_AREA
+CYCLE_PROFILE_SAVE_AREA
 
 NX_PACKET *queue_head;
 NX_PACKET *packet_ptr;
@@ -104,7 +105,9 @@ NX_PACKET *packet_ptr;
         NX_PACKET_DEBUG(__FILE__, __LINE__, packet_ptr);
 
         /* Process the packet.  */
+        CYCLE_PROFILE_ENTER
         _nx_tcp_packet_process(ip_ptr, packet_ptr);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TCP_PROCESS)
     }
 }
 
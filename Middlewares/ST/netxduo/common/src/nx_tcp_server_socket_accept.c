@@ -152,6 +152,7 @@ NX_IP *ip_ptr;
 
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+            NX_TCP_FAST_TIMER_RESUME(ip_ptr)
 
             /* CLEANUP: Clean up any existing socket data before making a new connection. */
             socket_ptr -> nx_tcp_socket_tx_window_congestion = 0;
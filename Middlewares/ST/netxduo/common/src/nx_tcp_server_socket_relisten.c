@@ -102,6 +102,9 @@ NX_IPV4_HEADER              *ipv4_header_ptr;
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
 ULONG                        rwin_scale = 0;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+#ifdef NX_ENABLE_TCP_SACK
+UINT                         sack_permitted = NX_FALSE;
+#endif /* NX_ENABLE_TCP_SACK */
 VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT port);
 
 
@@ -236,6 +239,10 @@ VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
                             _nx_tcp_window_scaling_option_get((packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER)), option_words * (ULONG)sizeof(ULONG), &rwin_scale);
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
+
+#ifdef NX_ENABLE_TCP_SACK
+                            _nx_tcp_sack_permitted_option_get((packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER)), option_words * (ULONG)sizeof(ULONG), &sack_permitted);
+#endif /* NX_ENABLE_TCP_SACK */
                         }
                     }
 
@@ -351,6 +358,12 @@ VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT
                     socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
+#ifdef NX_ENABLE_TCP_SACK
+                    /* Record whether the peer permits SACK, nothing is selectively acknowledged yet.  */
+                    socket_ptr -> nx_tcp_socket_sack_permitted = sack_permitted;
+                    socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
+
                     /* If trace is enabled, insert this event into the trace buffer.  */
                     NX_TRACE_IN_LINE_INSERT(NX_TRACE_INTERNAL_TCP_STATE_CHANGE, ip_ptr, socket_ptr, socket_ptr -> nx_tcp_socket_state, NX_TCP_LISTEN_STATE, NX_TRACE_INTERNAL_EVENTS, 0, 0);
 
@@ -384,6 +397,11 @@ VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT
                         ip_ptr -> nx_ip_tcp_port_table[index] =       socket_ptr;
                     }
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+                    /* The peer is known now, index the connection.  */
+                    _nx_tcp_socket_connection_insert(socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
                     /* Pickup the listen callback routine.  */
                     listen_callback =  listen_ptr -> nx_tcp_listen_callback;
 
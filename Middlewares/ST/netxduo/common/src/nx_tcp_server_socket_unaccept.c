@@ -101,6 +101,11 @@ UINT                         port;
         /* Force to the listen state.  */
         socket_ptr -> nx_tcp_socket_state =  NX_TCP_LISTEN_STATE;
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+        /* Remove the connection from the connection table before its peer is forgotten.  */
+        _nx_tcp_socket_connection_remove(socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
         /* Ensure the connect information is cleared.  */
         socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version =    0;
 #ifdef FEATURE_NX_IPV6
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_ack_policy_set                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the ACK policy of a TCP socket. The first        */
+/*    quickack_segments segments received once the connection is          */
+/*    established, and the segments with the PSH bit of at most           */
+/*    push_ack_size bytes, are acknowledged immediately. The other        */
+/*    segments are acknowledged by the delayed ACK timer, unless the ACK  */
+/*    is carried by data sent in the meantime.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    quickack_segments                     Segments to ACK immediately   */
+/*    push_ack_size                         Largest PSH segment to ACK    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_ack_policy_set(NX_TCP_SOCKET *socket_ptr, UINT quickack_segments, ULONG push_ack_size)
+{
+#ifdef NX_ENABLE_TCP_QUICKACK
+
+    /* Get mutex protection.  */
+    tx_mutex_get(&(socket_ptr -> nx_tcp_socket_ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    /* Setup the ACK policy of the socket.  */
+    socket_ptr -> nx_tcp_socket_quickack_segments =  quickack_segments;
+    socket_ptr -> nx_tcp_socket_quickack_push_size = push_ack_size;
+
+    /* A connection already established starts its quick ACKs now.  */
+    if (socket_ptr -> nx_tcp_socket_state == NX_TCP_ESTABLISHED)
+    {
+        socket_ptr -> nx_tcp_socket_quickack_remaining = quickack_segments;
+    }
+
+    /* Release protection.  */
+    tx_mutex_put(&(socket_ptr -> nx_tcp_socket_ip_ptr -> nx_ip_protection));
+
+    /* Return completion status.  */
+    return(NX_SUCCESS);
+
+#else /* !NX_ENABLE_TCP_QUICKACK */
+    NX_PARAMETER_NOT_USED(socket_ptr);
+    NX_PARAMETER_NOT_USED(quickack_segments);
+    NX_PARAMETER_NOT_USED(push_ack_size);
+
+    return(NX_NOT_SUPPORTED);
+
+#endif /* NX_ENABLE_TCP_QUICKACK */
+}
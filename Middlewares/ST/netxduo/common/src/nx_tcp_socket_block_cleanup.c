@@ -26,6 +26,7 @@
 /* Include necessary system files.  */
 
 #include "nx_api.h"
+#include "nx_packet.h"
 #include "nx_tcp.h"
 #include "nx_ipv6.h"
 
@@ -75,6 +76,15 @@
 VOID  _nx_tcp_socket_block_cleanup(NX_TCP_SOCKET *socket_ptr)
 {
 
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+NX_PACKET *packet_ptr;
+
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+    /* Remove the connection from the connection table before its peer is forgotten.  */
+    _nx_tcp_socket_connection_remove(socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
     /* Clean up the connect IP address.  */
 
     socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version = 0;
@@ -100,6 +110,34 @@ VOID  _nx_tcp_socket_block_cleanup(NX_TCP_SOCKET *socket_ptr)
     /* Reset fast recovery stage. */
     socket_ptr -> nx_tcp_socket_fast_recovery = NX_FALSE;
 
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+    /* Release the small sends held, the connection is gone.  */
+    if (socket_ptr -> nx_tcp_socket_coalesce_packet)
+    {
+        _nx_packet_release(socket_ptr -> nx_tcp_socket_coalesce_packet);
+        socket_ptr -> nx_tcp_socket_coalesce_packet = NX_NULL;
+    }
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* Release the queued sends, the connection is gone.  */
+    while (socket_ptr -> nx_tcp_socket_send_pending_head)
+    {
+        packet_ptr =  socket_ptr -> nx_tcp_socket_send_pending_head;
+        socket_ptr -> nx_tcp_socket_send_pending_head =  packet_ptr -> nx_packet_queue_next;
+        _nx_packet_release(packet_ptr);
+    }
+    socket_ptr -> nx_tcp_socket_send_pending_tail =  NX_NULL;
+    socket_ptr -> nx_tcp_socket_send_pending_count =  0;
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+    /* Forget the round trip time, the next connection may be to another peer.  */
+    socket_ptr -> nx_tcp_socket_rtt_smoothed = 0;
+    socket_ptr -> nx_tcp_socket_rtt_timing = NX_FALSE;
+    socket_ptr -> nx_tcp_socket_timeout_rate = socket_ptr -> nx_tcp_socket_timeout_rate_initial;
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
+
     /* Connection needs to be closed down immediately.  */
     if (socket_ptr -> nx_tcp_socket_client_type)
     {
@@ -0,0 +1,121 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_flush                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends the packet held to coalesce small sends on the  */
+/*    socket. If it cannot be sent, it is held again so it is retried     */
+/*    later. This function must not be called with the IP protection held */
+/*    unless wait_option is NX_NO_WAIT.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_send_internal          Transmit TCP payload          */
+/*    _nx_packet_release                    Release packet                */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_send          Send TCP packet coalesced     */
+/*    _nx_tcp_socket_disconnect             Disconnect TCP socket         */
+/*    _nx_tcp_socket_state_transmit_check   Check transmit after ACK      */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_coalesce_flush(NX_TCP_SOCKET *socket_ptr, ULONG wait_option)
+{
+
+NX_IP     *ip_ptr;
+NX_PACKET *held_ptr;
+UINT       status;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Obtain the IP mutex so we can take the held packet.  */
+    tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    held_ptr =  socket_ptr -> nx_tcp_socket_coalesce_packet;
+    socket_ptr -> nx_tcp_socket_coalesce_packet =  NX_NULL;
+
+    /* Release protection.  */
+    tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+    /* Determine if there is anything to send.  */
+    if (held_ptr == NX_NULL)
+    {
+        return(NX_SUCCESS);
+    }
+
+    /* Send the held packet.  */
+    status =  _nx_tcp_socket_send_internal(socket_ptr, held_ptr, wait_option);
+
+    if (status != NX_SUCCESS)
+    {
+
+        /* Obtain the IP mutex again.  */
+        tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+        /* Hold the packet again, unless another send started a new one meanwhile.  */
+        if (socket_ptr -> nx_tcp_socket_coalesce_packet == NX_NULL)
+        {
+            socket_ptr -> nx_tcp_socket_coalesce_packet =  held_ptr;
+        }
+        else
+        {
+            _nx_packet_release(held_ptr);
+        }
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+    }
+
+    /* Return completion status.  */
+    return(status);
+}
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
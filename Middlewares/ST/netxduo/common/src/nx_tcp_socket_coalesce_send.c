@@ -0,0 +1,174 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_send                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends a TCP packet through the specified socket,      */
+/*    coalescing small sends as described in RFC 896. While data sent     */
+/*    earlier is not acknowledged, a packet smaller than the MSS is held  */
+/*    instead of being sent, and the data of the following sends is       */
+/*    appended to it up to the MSS. The held packet is sent once it is    */
+/*    full, once the data that does not fit is sent, or once all the data */
+/*    outstanding is acknowledged.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    packet_ptr                            Pointer to packet to send     */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_flush         Send the held packet          */
+/*    _nx_tcp_socket_send_internal          Transmit TCP payload          */
+/*    _nx_packet_data_append                Append data to held packet    */
+/*    _nx_packet_release                    Release appended packet       */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_send                   Send TCP packet               */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_coalesce_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
+{
+
+NX_IP     *ip_ptr;
+NX_PACKET *held_ptr;
+UINT       status;
+UINT       flush;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Obtain the IP mutex so we can examine the held packet.  */
+    tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    /* Pickup the packet held to coalesce the small sends.  */
+    held_ptr =  socket_ptr -> nx_tcp_socket_coalesce_packet;
+
+    if (held_ptr)
+    {
+
+        /* Determine if the data fits in the segment held.  */
+        if ((packet_ptr -> nx_packet_length) &&
+#ifndef NX_DISABLE_PACKET_CHAIN
+            (packet_ptr -> nx_packet_next == NX_NULL) &&
+#endif /* NX_DISABLE_PACKET_CHAIN */
+            ((held_ptr -> nx_packet_length + packet_ptr -> nx_packet_length) <= socket_ptr -> nx_tcp_socket_connect_mss))
+        {
+
+            /* Yes, append the data to the held packet.  */
+            status =  _nx_packet_data_append(held_ptr, packet_ptr -> nx_packet_prepend_ptr, packet_ptr -> nx_packet_length,
+                                             held_ptr -> nx_packet_pool_owner, NX_NO_WAIT);
+
+            if (status == NX_SUCCESS)
+            {
+
+                /* The data is copied, the packet of the caller is no longer needed.  */
+                _nx_packet_release(packet_ptr);
+
+                /* A full segment is not held any longer. Decide it under protection, the IP
+                   thread may send and release the held packet once it is released.  */
+                flush =  (held_ptr -> nx_packet_length == socket_ptr -> nx_tcp_socket_connect_mss);
+
+                /* Release protection.  */
+                tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+                if (flush)
+                {
+                    _nx_tcp_socket_coalesce_flush(socket_ptr, wait_option);
+                }
+
+                /* Return successful completion.  */
+                return(NX_SUCCESS);
+            }
+        }
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        /* The held data goes first.  */
+        status =  _nx_tcp_socket_coalesce_flush(socket_ptr, wait_option);
+
+        if (status != NX_SUCCESS)
+        {
+
+            /* The packet of the caller is not sent.  */
+            return(status);
+        }
+
+        /* Obtain the IP mutex again.  */
+        tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+    }
+
+    /* Determine if the packet is small and data is waiting to be acknowledged.  */
+    if ((socket_ptr -> nx_tcp_socket_coalesce_packet == NX_NULL) &&
+        (socket_ptr -> nx_tcp_socket_transmit_sent_head) &&
+        ((socket_ptr -> nx_tcp_socket_state == NX_TCP_ESTABLISHED) ||
+         (socket_ptr -> nx_tcp_socket_state == NX_TCP_CLOSE_WAIT)) &&
+        (packet_ptr -> nx_packet_length) &&
+#ifndef NX_DISABLE_PACKET_CHAIN
+        (packet_ptr -> nx_packet_next == NX_NULL) &&
+#endif /* NX_DISABLE_PACKET_CHAIN */
+        (packet_ptr -> nx_packet_length < socket_ptr -> nx_tcp_socket_connect_mss))
+    {
+
+        /* Yes, hold the packet until the ACK arrives or more data fills it.  */
+        socket_ptr -> nx_tcp_socket_coalesce_packet =  packet_ptr;
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        /* Return successful completion.  */
+        return(NX_SUCCESS);
+    }
+
+    /* Release protection.  */
+    tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+    /* Send the packet now.  */
+    return(_nx_tcp_socket_send_internal(socket_ptr, packet_ptr, wait_option));
+}
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_connection_insert                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds the TCP socket to the connection table of its IP */
+/*    instance, hashed by its ports and peer address. It is called once   */
+/*    the peer of the socket is known, so the segments of the connection  */
+/*    are found without searching all the sockets bound to the local      */
+/*    port.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_connection_remove      Remove a previous entry       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_process                Process incoming packet       */
+/*    _nx_tcp_server_socket_relisten        Relisten on a server port     */
+/*    _nxd_tcp_client_socket_connect        Connect a client socket       */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_tcp_socket_connection_insert(NX_TCP_SOCKET *socket_ptr)
+{
+
+NX_IP *ip_ptr;
+ULONG  address;
+UINT   index;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Make sure the socket is not on the table twice.  */
+    _nx_tcp_socket_connection_remove(socket_ptr);
+
+    /* Pickup the last word of the peer address for the hash.  */
+    address =  socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v4;
+#ifdef FEATURE_NX_IPV6
+    if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version == NX_IP_VERSION_V6)
+    {
+        address =  socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v6[3];
+    }
+#endif /* FEATURE_NX_IPV6 */
+
+    /* Calculate the hash index in the TCP connection table of the IP instance.  */
+    index =  NX_TCP_CONNECTION_INDEX(socket_ptr -> nx_tcp_socket_port, socket_ptr -> nx_tcp_socket_connect_port, address);
+
+    /* Add the socket to the front of the connections on the index.  */
+    socket_ptr -> nx_tcp_socket_connection_index =  index;
+    socket_ptr -> nx_tcp_socket_connection_next =  ip_ptr -> nx_ip_tcp_connection_table[index];
+    ip_ptr -> nx_ip_tcp_connection_table[index] =  socket_ptr;
+}
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_connection_remove                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function removes the TCP socket from the connection table of   */
+/*    its IP instance, before the connect information of the socket is    */
+/*    cleared. Nothing is done if the socket is not on the table.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_connection_insert      Add socket to the table       */
+/*    _nx_tcp_socket_block_cleanup          Clean up the socket           */
+/*    _nx_tcp_server_socket_unaccept        Unaccept a server socket      */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_tcp_socket_connection_remove(NX_TCP_SOCKET *socket_ptr)
+{
+
+NX_IP         *ip_ptr;
+NX_TCP_SOCKET *entry_ptr;
+NX_TCP_SOCKET *previous_ptr;
+UINT           index;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Pickup the index the socket was added on.  */
+    index =  socket_ptr -> nx_tcp_socket_connection_index;
+
+    /* Search the connections on the index for the socket.  */
+    previous_ptr =  NX_NULL;
+    entry_ptr =  ip_ptr -> nx_ip_tcp_connection_table[index];
+    while (entry_ptr)
+    {
+
+        if (entry_ptr == socket_ptr)
+        {
+
+            /* Unlink the socket from the connections on the index.  */
+            if (previous_ptr)
+            {
+                previous_ptr -> nx_tcp_socket_connection_next =  socket_ptr -> nx_tcp_socket_connection_next;
+            }
+            else
+            {
+                ip_ptr -> nx_ip_tcp_connection_table[index] =  socket_ptr -> nx_tcp_socket_connection_next;
+            }
+            break;
+        }
+
+        /* Move to the next connection on the index.  */
+        previous_ptr =  entry_ptr;
+        entry_ptr =  entry_ptr -> nx_tcp_socket_connection_next;
+    }
+
+    socket_ptr -> nx_tcp_socket_connection_next =  NX_NULL;
+
+    /* The connection found last must not point to the socket any longer.  */
+    if (ip_ptr -> nx_ip_tcp_connection_cache == socket_ptr)
+    {
+        ip_ptr -> nx_ip_tcp_connection_cache =  NX_NULL;
+    }
+}
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
@@ -134,6 +134,9 @@ NX_TCP_SOCKET *tail_ptr;
     socket_ptr -> nx_tcp_socket_timeout_rate =         _nx_tcp_transmit_timer_rate;
     socket_ptr -> nx_tcp_socket_timeout_max_retries =  NX_TCP_MAXIMUM_RETRIES;
     socket_ptr -> nx_tcp_socket_timeout_shift =        NX_TCP_RETRY_SHIFT;
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+    socket_ptr -> nx_tcp_socket_timeout_rate_initial = _nx_tcp_transmit_timer_rate;
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
 
     /* Setup the default maximum transmit queue depth.  */
     socket_ptr -> nx_tcp_socket_transmit_queue_maximum_default =  NX_TCP_MAXIMUM_TX_QUEUE;
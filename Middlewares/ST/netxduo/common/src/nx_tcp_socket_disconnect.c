@@ -106,6 +106,16 @@ NX_IP        *ip_ptr;
     /* Default status to success.  */
     status =  NX_SUCCESS;
 
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+    /* Send the small sends held before the FIN.  */
+    _nx_tcp_socket_coalesce_flush(socket_ptr, wait_option);
+
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* Send the queued sends before the FIN.  */
+    _nx_tcp_socket_send_pending_flush(socket_ptr, wait_option);
+
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
     /* Obtain the IP mutex so we can access socket and IP information.  */
     tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
 
@@ -172,6 +182,7 @@ NX_IP        *ip_ptr;
                 /* Setup FIN timeout.  */
                 socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+                NX_TCP_FAST_TIMER_RESUME(ip_ptr)
 
                 /* Increment the sequence number.  */
                 socket_ptr -> nx_tcp_socket_tx_sequence++;
@@ -196,6 +207,7 @@ NX_IP        *ip_ptr;
                 /* Setup FIN timeout.  */
                 socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+                NX_TCP_FAST_TIMER_RESUME(ip_ptr)
 
                 /* Increment the sequence number.  */
                 socket_ptr -> nx_tcp_socket_tx_sequence++;
@@ -264,6 +276,7 @@ NX_IP        *ip_ptr;
             /* No transmit packets queue, setup FIN timeout.  */
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+            NX_TCP_FAST_TIMER_RESUME(ip_ptr)
         }
 
         /* Increment the sequence number.  */
@@ -297,6 +310,7 @@ NX_IP        *ip_ptr;
             /* No transmit packets queue, setup FIN timeout.  */
             socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
             socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+            NX_TCP_FAST_TIMER_RESUME(ip_ptr)
         }
 
         /* Increment the sequence number.  */
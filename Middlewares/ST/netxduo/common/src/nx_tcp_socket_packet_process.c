@@ -277,6 +277,18 @@ ULONG         tcpip_offload;
         if (socket_ptr -> nx_tcp_socket_state != NX_TCP_SYN_RECEIVED)
         {
 
+#ifdef NX_ENABLE_TCP_SACK
+            /* Update the ranges the peer selectively acknowledged before the ACK is checked.  */
+            if ((socket_ptr -> nx_tcp_socket_sack_permitted) &&
+                (tcp_header_copy.nx_tcp_header_word_3 & NX_TCP_ACK_BIT) &&
+                (header_length >= sizeof(NX_TCP_HEADER)))
+            {
+                _nx_tcp_socket_sack_process(socket_ptr, tcp_header_copy.nx_tcp_acknowledgment_number,
+                                            (packet_ptr -> nx_packet_prepend_ptr + sizeof(NX_TCP_HEADER)),
+                                            header_length - (ULONG)sizeof(NX_TCP_HEADER));
+            }
+#endif /* NX_ENABLE_TCP_SACK */
+
             /* Check the ACK field.  */
             if (_nx_tcp_socket_state_ack_check(socket_ptr, &tcp_header_copy) == NX_FALSE)
             {
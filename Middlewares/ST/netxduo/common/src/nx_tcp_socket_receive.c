@@ -217,13 +217,23 @@ ULONG                  trace_timestamp;
 
         /* Determine if an ACK should be forced out for window update, SWS avoidance algorithm.
            RFC1122, Section4.2.3.3, Page97-98. */
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+        if (((_nx_tcp_socket_rx_window_compute(socket_ptr) - socket_ptr -> nx_tcp_socket_rx_window_last_sent) >= (socket_ptr -> nx_tcp_socket_rx_window_default / 2)) &&
+#else
         if (((socket_ptr -> nx_tcp_socket_rx_window_current - socket_ptr -> nx_tcp_socket_rx_window_last_sent) >= (socket_ptr -> nx_tcp_socket_rx_window_default / 2)) &&
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
             ((socket_ptr -> nx_tcp_socket_state == NX_TCP_ESTABLISHED) || (socket_ptr -> nx_tcp_socket_state == NX_TCP_FIN_WAIT_1) || (socket_ptr -> nx_tcp_socket_state == NX_TCP_FIN_WAIT_2)))
         {
 
             /* Send a Window Update.  */
             _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
         }
+        else
+        {
+
+            /* A smaller window update is left to the fast timer, restart it.  */
+            NX_TCP_FAST_TIMER_RESUME(ip_ptr)
+        }
 
 #ifdef TX_ENABLE_EVENT_TRACE
         /* Update the trace event with the status.  */
@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_receive_chain                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function receives all the TCP data available on the socket in  */
+/*    one call. It waits for the first packet as nx_tcp_socket_receive    */
+/*    does, then removes the other in-order packets of the receive queue  */
+/*    and links them after the first one, so the caller gets one chain    */
+/*    holding all the data received. With NX_DISABLE_PACKET_CHAIN         */
+/*    defined, only the first packet is returned.                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    packet_ptr                            Pointer to packet pointer     */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_receive                Receive one TCP packet        */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_receive_chain(NX_TCP_SOCKET *socket_ptr, NX_PACKET **packet_ptr, ULONG wait_option)
+{
+
+UINT       status;
+#ifndef NX_DISABLE_PACKET_CHAIN
+NX_IP     *ip_ptr;
+NX_PACKET *head_packet_ptr;
+NX_PACKET *next_packet_ptr;
+#endif /* NX_DISABLE_PACKET_CHAIN */
+
+
+    /* Receive the first packet, suspending for it as requested.  */
+    status =  _nx_tcp_socket_receive(socket_ptr, packet_ptr, wait_option);
+
+#ifndef NX_DISABLE_PACKET_CHAIN
+    if (status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Pickup the first packet, the head of the chain returned.  */
+    head_packet_ptr =  *packet_ptr;
+    if (head_packet_ptr -> nx_packet_last == NX_NULL)
+    {
+        head_packet_ptr -> nx_packet_last =  head_packet_ptr;
+    }
+
+    /* Get protection once for the rest of the queue, the mutex is only nested
+       by each receive below, so the IP thread does not run in between.  */
+    tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    /* Loop to link the packets of the queue that are already in order.  */
+    /*lint -e{923} suppress cast of ULONG to pointer.  */
+    while ((socket_ptr -> nx_tcp_socket_receive_queue_head) &&
+           (socket_ptr -> nx_tcp_socket_receive_queue_head -> nx_packet_queue_next == ((NX_PACKET *)NX_PACKET_READY)))
+    {
+
+        /* Remove the next packet, it is available so no suspension takes place.  */
+        if (_nx_tcp_socket_receive(socket_ptr, &next_packet_ptr, NX_NO_WAIT) != NX_SUCCESS)
+        {
+            break;
+        }
+
+        if (next_packet_ptr -> nx_packet_last == NX_NULL)
+        {
+            next_packet_ptr -> nx_packet_last =  next_packet_ptr;
+        }
+
+        /* Link the packet after the last one of the chain.  */
+        head_packet_ptr -> nx_packet_last -> nx_packet_next =  next_packet_ptr;
+        head_packet_ptr -> nx_packet_last =  next_packet_ptr -> nx_packet_last;
+        head_packet_ptr -> nx_packet_length +=  next_packet_ptr -> nx_packet_length;
+    }
+
+    /* Release protection.  */
+    tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+#endif /* NX_DISABLE_PACKET_CHAIN */
+
+    /* Return completion status.  */
+    return(status);
+}
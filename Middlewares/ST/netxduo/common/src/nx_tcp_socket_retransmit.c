@@ -90,7 +90,14 @@ ULONG      original_header_word_3;
 ULONG      original_header_word_4;
 ULONG      available;
 ULONG      window_size;
+ULONG      rx_window;
 
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+    /* The ACK of a retransmitted segment does not tell which transmission it answers,
+       stop timing the round trip. Karn's algorithm, Section 3, RFC6298.  */
+    socket_ptr -> nx_tcp_socket_rtt_timing =  NX_FALSE;
+
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
     /* If the receiver winodw is zero, we enter the zero window probe phase
        RFC 793 Sec 3.7, p42: keep send new data.
 
@@ -154,6 +161,12 @@ ULONG      window_size;
         socket_ptr -> nx_tcp_socket_zero_window_probe_has_data = NX_FALSE;
     }
 
+#ifdef NX_ENABLE_TCP_SACK
+    /* A hole retransmitted on a duplicate ACK keeps the retransmission timer.  */
+    if (need_fast_retransmit != NX_TCP_SACK_RETRANSMIT)
+    {
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Increment the retry counter only if the receiver window is open. */
     /* Increment the retry counter.  */
     socket_ptr -> nx_tcp_socket_timeout_retries++;
@@ -196,6 +209,18 @@ ULONG      window_size;
     socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
         (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
 
+#ifdef NX_ENABLE_TCP_SACK
+    }
+
+    if (need_fast_retransmit == NX_TRUE)
+    {
+
+        /* Nothing is retransmitted yet in this fast recovery.  */
+        socket_ptr -> nx_tcp_socket_sack_retransmit_sequence =
+            socket_ptr -> nx_tcp_socket_tx_sequence - socket_ptr -> nx_tcp_socket_tx_outstanding_bytes;
+    }
+#endif /* NX_ENABLE_TCP_SACK */
+
     /* Get available size of packet that can be sent. */
     available = socket_ptr -> nx_tcp_socket_tx_window_congestion;
 
@@ -216,11 +241,57 @@ ULONG      window_size;
 #if defined(NX_DISABLE_TCP_TX_CHECKSUM) || defined(NX_ENABLE_INTERFACE_CAPABILITY) || defined(NX_IPSEC_ENABLE)
     UINT           compute_checksum = 1;
 #endif /* defined(NX_DISABLE_TCP_TX_CHECKSUM) || defined(NX_ENABLE_INTERFACE_CAPABILITY) || defined(NX_IPSEC_ENABLE) */
+#ifdef NX_ENABLE_TCP_SACK
+    ULONG          begin_sequence;
+    ULONG          end_sequence = 0;
+#endif /* NX_ENABLE_TCP_SACK */
 
 #ifdef NX_DISABLE_TCP_TX_CHECKSUM
         compute_checksum = 0;
 #endif /* NX_DISABLE_TCP_TX_CHECKSUM */
 
+#ifdef NX_ENABLE_TCP_SACK
+        /* In fast recovery, only the holes between the ranges the peer selectively acknowledged
+           are retransmitted.  RFC 6675, Section 5.  */
+        if (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE)
+        {
+
+            /* Pickup the sequence range of this packet.  */
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            header_ptr =  (NX_TCP_HEADER *)packet_ptr -> nx_packet_prepend_ptr;
+            begin_sequence =  header_ptr -> nx_tcp_sequence_number;
+            NX_CHANGE_ULONG_ENDIAN(begin_sequence);
+            end_sequence =  begin_sequence + (packet_ptr -> nx_packet_length - (ULONG)sizeof(NX_TCP_HEADER));
+
+            /* On a duplicate ACK, data above the highest range is not known to be lost.  */
+            if ((need_fast_retransmit == NX_TCP_SACK_RETRANSMIT) &&
+                ((socket_ptr -> nx_tcp_socket_sack_count == 0) ||
+                 ((INT)(begin_sequence -
+                        socket_ptr -> nx_tcp_socket_sack_right_edge[socket_ptr -> nx_tcp_socket_sack_count - 1]) >= 0)))
+            {
+                break;
+            }
+
+            /* Skip the data the peer holds, or retransmitted already in this fast recovery.  */
+            if ((socket_ptr -> nx_tcp_socket_sack_count) &&
+                ((_nx_tcp_socket_sack_check(socket_ptr, begin_sequence, end_sequence)) ||
+                 ((INT)(end_sequence - socket_ptr -> nx_tcp_socket_sack_retransmit_sequence) <= 0)))
+            {
+
+                /* Move to next packet. */
+                packet_ptr = packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+
+                /*lint -e{923} suppress cast of ULONG to pointer.  */
+                if (packet_ptr == (NX_PACKET *)NX_PACKET_ENQUEUED)
+                {
+                    break;
+                }
+
+                continue;
+            }
+        }
+#endif /* NX_ENABLE_TCP_SACK */
+
         if (packet_ptr -> nx_packet_length > (available + sizeof(NX_TCP_HEADER)))
         {
 
@@ -231,6 +302,15 @@ ULONG      window_size;
         /* Decrease the available size. */
         available -= (packet_ptr -> nx_packet_length - (ULONG)sizeof(NX_TCP_HEADER));
 
+#ifdef NX_ENABLE_TCP_SACK
+        if (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE)
+        {
+
+            /* Remember the end of the data retransmitted.  */
+            socket_ptr -> nx_tcp_socket_sack_retransmit_sequence = end_sequence;
+        }
+#endif /* NX_ENABLE_TCP_SACK */
+
         /* Pickup next packet. */
         next_ptr = packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
 
@@ -275,9 +355,16 @@ ULONG      window_size;
         /* Convert to network byte order for checksum */
         NX_CHANGE_ULONG_ENDIAN(header_ptr -> nx_tcp_acknowledgment_number);
 
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+        /* Advertise no more than the free packets of the receive pool can hold.  */
+        rx_window =  _nx_tcp_socket_rx_window_compute(socket_ptr);
+#else
+        rx_window =  socket_ptr -> nx_tcp_socket_rx_window_current;
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+
         /* Set window size. */
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
-        window_size = socket_ptr -> nx_tcp_socket_rx_window_current >> socket_ptr -> nx_tcp_rcv_win_scale_value;
+        window_size = rx_window >> socket_ptr -> nx_tcp_rcv_win_scale_value;
 
         /* Make sure the window_size is less than 0xFFFF. */
         if (window_size > 0xFFFF)
@@ -285,7 +372,7 @@ ULONG      window_size;
             window_size = 0xFFFF;
         }
 #else
-        window_size = socket_ptr -> nx_tcp_socket_rx_window_current;
+        window_size = rx_window;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
         header_ptr -> nx_tcp_header_word_3 =        NX_TCP_HEADER_SIZE | NX_TCP_ACK_BIT | NX_TCP_PSH_BIT | window_size;
@@ -298,7 +385,7 @@ ULONG      window_size;
 
         /* Remember the last ACKed sequence and the last reported window size.  */
         socket_ptr -> nx_tcp_socket_rx_sequence_acked =    socket_ptr -> nx_tcp_socket_rx_sequence;
-        socket_ptr -> nx_tcp_socket_rx_window_last_sent =  socket_ptr -> nx_tcp_socket_rx_window_current;
+        socket_ptr -> nx_tcp_socket_rx_window_last_sent =  rx_window;
 
         /* Zero out existing checksum before computing new one. */
         header_ptr -> nx_tcp_header_word_4 = header_ptr -> nx_tcp_header_word_4 & 0x0000FFFF;
@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_rtt_update                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the smoothed round trip time and its          */
+/*    variation of the socket with a new sample, and derives the          */
+/*    retransmit timeout from them as described in RFC 6298.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    rtt                                   Round trip time in ticks      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_state_ack_check        Process received ACK          */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_tcp_socket_rtt_update(NX_TCP_SOCKET *socket_ptr, ULONG rtt)
+{
+
+ULONG delta;
+ULONG rto;
+
+
+    /* A segment ACKed within a tick still takes a tick.  */
+    if (rtt == 0)
+    {
+        rtt = 1;
+    }
+
+    /* Determine if this is the first sample of the connection.  */
+    if (socket_ptr -> nx_tcp_socket_rtt_smoothed == 0)
+    {
+
+        /* SRTT = R, RTTVAR = R/2. Section 2.2, RFC6298.  */
+        socket_ptr -> nx_tcp_socket_rtt_smoothed = rtt << 3;
+        socket_ptr -> nx_tcp_socket_rtt_variance = rtt << 1;
+    }
+    else
+    {
+
+        /* Compute |SRTT - R| with the previous SRTT.  */
+        if (rtt > (socket_ptr -> nx_tcp_socket_rtt_smoothed >> 3))
+        {
+            delta = rtt - (socket_ptr -> nx_tcp_socket_rtt_smoothed >> 3);
+        }
+        else
+        {
+            delta = (socket_ptr -> nx_tcp_socket_rtt_smoothed >> 3) - rtt;
+        }
+
+        /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R. Section 2.3, RFC6298.
+           With the scaled values, both reduce to additions and shifts.  */
+        socket_ptr -> nx_tcp_socket_rtt_variance += delta - (socket_ptr -> nx_tcp_socket_rtt_variance >> 2);
+        socket_ptr -> nx_tcp_socket_rtt_smoothed += rtt - (socket_ptr -> nx_tcp_socket_rtt_smoothed >> 3);
+    }
+
+    /* RTO = SRTT + max(G, 4 * RTTVAR), the clock granularity G being the fast TCP timer.
+       Section 2.3, RFC6298.  */
+    rto = socket_ptr -> nx_tcp_socket_rtt_smoothed >> 3;
+    if (socket_ptr -> nx_tcp_socket_rtt_variance > _nx_tcp_fast_timer_rate)
+    {
+        rto += socket_ptr -> nx_tcp_socket_rtt_variance;
+    }
+    else
+    {
+        rto += _nx_tcp_fast_timer_rate;
+    }
+
+    /* Keep the timeout within its bounds. Section 2.4 and 2.5, RFC6298.  */
+    if (rto < ((NX_IP_PERIODIC_RATE + (NX_TCP_RTO_MINIMUM_RATE - 1)) / NX_TCP_RTO_MINIMUM_RATE))
+    {
+        rto = (NX_IP_PERIODIC_RATE + (NX_TCP_RTO_MINIMUM_RATE - 1)) / NX_TCP_RTO_MINIMUM_RATE;
+    }
+    else if (rto > (NX_TCP_RTO_MAXIMUM * NX_IP_PERIODIC_RATE))
+    {
+        rto = NX_TCP_RTO_MAXIMUM * NX_IP_PERIODIC_RATE;
+    }
+
+    /* Subsequent transmit timeouts are derived from it.  */
+    socket_ptr -> nx_tcp_socket_timeout_rate = rto;
+}
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
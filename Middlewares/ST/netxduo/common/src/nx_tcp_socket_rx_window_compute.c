@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_rx_window_compute                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the receive window advertised to the peer.   */
+/*    The current receive window is capped by the free packets of the     */
+/*    pool the segments of the socket are received in, one maximum        */
+/*    segment each, above the low watermark of the pool. The right edge   */
+/*    of the window advertised last is kept, the window is never shrunk.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    window                                Receive window (unscaled)     */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_fast_periodic_processing      Process TCP fast timer        */
+/*    _nx_tcp_packet_send_control           Send TCP control packet       */
+/*    _nx_tcp_socket_receive                Receive TCP data              */
+/*    _nx_tcp_socket_retransmit             Retransmit TCP packets        */
+/*    _nx_tcp_socket_send_internal          Send TCP data                 */
+/*    _nx_tcp_socket_state_data_check       Process received data         */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _nx_tcp_socket_rx_window_compute(NX_TCP_SOCKET *socket_ptr)
+{
+
+NX_PACKET_POOL *pool_ptr;
+ULONG           window;
+ULONG           available;
+
+    /* Pickup the current receive window.  */
+    window =  socket_ptr -> nx_tcp_socket_rx_window_current;
+
+    /* Pickup the pool of the received segments, the default pool until one is received.  */
+    pool_ptr =  socket_ptr -> nx_tcp_socket_rx_window_pool;
+    if (pool_ptr == NX_NULL)
+    {
+        pool_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr -> nx_ip_default_packet_pool;
+    }
+
+    /* Each segment takes a packet of the pool, whatever its length.  */
+    available =  pool_ptr -> nx_packet_pool_available;
+
+#ifdef NX_ENABLE_LOW_WATERMARK
+    /* Segments received below the low watermark are dropped.  */
+    if (available > pool_ptr -> nx_packet_pool_low_watermark)
+    {
+        available -=  pool_ptr -> nx_packet_pool_low_watermark;
+    }
+    else
+    {
+        available =  0;
+    }
+#endif /* NX_ENABLE_LOW_WATERMARK */
+
+    /* Cap the window to the segments the free packets can hold.  */
+    if ((socket_ptr -> nx_tcp_socket_connect_mss) &&
+        (available < (window / socket_ptr -> nx_tcp_socket_connect_mss)))
+    {
+        window =  available * socket_ptr -> nx_tcp_socket_connect_mss;
+    }
+
+    /* Do not shrink the window, RFC 1122, Section 4.2.2.16, Page 91.  */
+    if (window < socket_ptr -> nx_tcp_socket_rx_window_last_sent)
+    {
+        window =  socket_ptr -> nx_tcp_socket_rx_window_last_sent;
+    }
+
+    /* Return the window to advertise.  */
+    return(window);
+}
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
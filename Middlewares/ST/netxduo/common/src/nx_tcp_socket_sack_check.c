@@ -0,0 +1,84 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SACK
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_sack_check                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function checks whether the peer selectively          */
+/*    acknowledged all of a range of sequence numbers.                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    begin_sequence                        Start of the range            */
+/*    end_sequence                          End of the range              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_TRUE                               Range acknowledged            */
+/*    NX_FALSE                              Range not acknowledged        */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_retransmit             Retransmit TCP packets        */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_sack_check(NX_TCP_SOCKET *socket_ptr, ULONG begin_sequence, ULONG end_sequence)
+{
+
+UINT i;
+
+
+    /* Loop through the ranges the peer selectively acknowledged.  */
+    for (i = 0; i < socket_ptr -> nx_tcp_socket_sack_count; i++)
+    {
+
+        /* Does this range cover the whole range?  */
+        if (((INT)(begin_sequence - socket_ptr -> nx_tcp_socket_sack_left_edge[i]) >= 0) &&
+            ((INT)(end_sequence - socket_ptr -> nx_tcp_socket_sack_right_edge[i]) <= 0))
+        {
+            return(NX_TRUE);
+        }
+    }
+
+    /* Return not acknowledged.  */
+    return(NX_FALSE);
+}
+#endif /* NX_ENABLE_TCP_SACK */
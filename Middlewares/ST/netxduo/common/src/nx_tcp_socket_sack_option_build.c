@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SACK
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_sack_option_build                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function builds the SACK option of an ACK from the    */
+/*    out of order segments held in the receive queue of the socket.      */
+/*    Contiguous segments are reported as one block. The block holding    */
+/*    the segment received last is reported first, the others follow in   */
+/*    sequence order, RFC 2018, Section 4.                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    option_ptr                            Pointer to option area        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    option_length                         Size of option built, 0 when  */
+/*                                            no block is held            */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_send_control           Send TCP control packet       */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_sack_option_build(NX_TCP_SOCKET *socket_ptr, UCHAR *option_ptr)
+{
+
+NX_PACKET     *search_ptr;
+NX_TCP_HEADER *search_header_ptr;
+ULONG          header_length;
+ULONG          begin_sequence;
+ULONG          end_sequence;
+ULONG          last_sequence;
+ULONG          left_edge[NX_TCP_SACK_BLOCKS_MAX];
+ULONG          right_edge[NX_TCP_SACK_BLOCKS_MAX];
+ULONG          edge;
+UINT           block_count = 0;
+UINT           i;
+
+
+    /* Pickup the start of the segment received last.  */
+    last_sequence =  socket_ptr -> nx_tcp_socket_sack_last_sequence;
+
+    /* The receive queue is sorted by sequence, walk it for the data beyond the cumulative ACK.  */
+    search_ptr =  socket_ptr -> nx_tcp_socket_receive_queue_head;
+
+    /*lint -e{923} suppress cast of ULONG to pointer.  */
+    while ((search_ptr) && (search_ptr != (NX_PACKET *)NX_PACKET_ENQUEUED))
+    {
+
+        /* Setup a pointer to header of this packet in the receive list.  */
+        /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+        search_header_ptr =  (NX_TCP_HEADER *)search_ptr -> nx_packet_prepend_ptr;
+
+        /* Calculate the header size for this packet.  */
+        header_length =  (search_header_ptr -> nx_tcp_header_word_3 >> NX_TCP_HEADER_SHIFT) * (ULONG)sizeof(ULONG);
+
+        /* Calculate the sequence range of this packet.  */
+        begin_sequence =  search_header_ptr -> nx_tcp_sequence_number;
+        end_sequence =    begin_sequence + search_ptr -> nx_packet_length - header_length;
+
+        /* Skip the data already acknowledged cumulatively.  */
+        if ((INT)(end_sequence - socket_ptr -> nx_tcp_socket_rx_sequence) > 0)
+        {
+
+            /* Is the packet contiguous with the previous block?  */
+            if ((block_count) && ((INT)(begin_sequence - right_edge[block_count - 1]) <= 0))
+            {
+
+                /* Yes, extend the block.  */
+                if ((INT)(end_sequence - right_edge[block_count - 1]) > 0)
+                {
+                    right_edge[block_count - 1] =  end_sequence;
+                }
+            }
+            else if (block_count < NX_TCP_SACK_BLOCKS_MAX)
+            {
+
+                /* Start a new block.  */
+                left_edge[block_count] =   begin_sequence;
+                right_edge[block_count] =  end_sequence;
+                block_count++;
+            }
+            else if (((INT)(last_sequence - left_edge[block_count - 1]) >= 0) &&
+                     ((INT)(last_sequence - right_edge[block_count - 1]) < 0))
+            {
+
+                /* No room for more blocks, and the last one holds the segment received last.  */
+                break;
+            }
+            else
+            {
+
+                /* No room for more blocks, the last one is replaced in case this one holds
+                   the segment received last.  */
+                left_edge[block_count - 1] =   begin_sequence;
+                right_edge[block_count - 1] =  end_sequence;
+            }
+        }
+
+        /* Move to the next packet.  */
+        search_ptr =  search_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+    }
+
+    /* Determine if there is anything to report.  */
+    if (block_count == 0)
+    {
+        return(0);
+    }
+
+    /* Find the block that holds the segment received last.  */
+    for (i = 0; i < block_count; i++)
+    {
+        if (((INT)(last_sequence - left_edge[i]) >= 0) &&
+            ((INT)(last_sequence - right_edge[i]) < 0))
+        {
+            break;
+        }
+    }
+
+    /* Move it to the front, the others keep their order.  */
+    if ((i > 0) && (i < block_count))
+    {
+        begin_sequence =  left_edge[i];
+        end_sequence =    right_edge[i];
+        for (; i > 0; i--)
+        {
+            left_edge[i] =   left_edge[i - 1];
+            right_edge[i] =  right_edge[i - 1];
+        }
+        left_edge[0] =   begin_sequence;
+        right_edge[0] =  end_sequence;
+    }
+
+    /* Build the option, two NOPs align the blocks.  */
+    *option_ptr++ =  NX_TCP_NOP_KIND;
+    *option_ptr++ =  NX_TCP_NOP_KIND;
+    *option_ptr++ =  NX_TCP_SACK_KIND;
+    *option_ptr++ =  (UCHAR)(2 + (block_count << 3));
+
+    /* Place the edges of each block in network byte order.  */
+    for (i = 0; i < block_count; i++)
+    {
+        edge =  left_edge[i];
+        *option_ptr++ =  (UCHAR)(edge >> 24);
+        *option_ptr++ =  (UCHAR)(edge >> 16);
+        *option_ptr++ =  (UCHAR)(edge >> 8);
+        *option_ptr++ =  (UCHAR)edge;
+
+        edge =  right_edge[i];
+        *option_ptr++ =  (UCHAR)(edge >> 24);
+        *option_ptr++ =  (UCHAR)(edge >> 16);
+        *option_ptr++ =  (UCHAR)(edge >> 8);
+        *option_ptr++ =  (UCHAR)edge;
+    }
+
+    /* Return the size of the option.  */
+    return(4 + (block_count << 3));
+}
+#endif /* NX_ENABLE_TCP_SACK */
@@ -0,0 +1,233 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SACK
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_sack_process                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This internal function updates the ranges the peer selectively      */
+/*    acknowledged from an incoming ACK. The ranges covered by the        */
+/*    cumulative ACK are dropped first. Each SACK block above the         */
+/*    cumulative ACK and within the data sent is then merged with the     */
+/*    ranges it overlaps or touches. When the scoreboard is full, the     */
+/*    highest range is forgotten; that only causes a needless             */
+/*    retransmission. An invalid SACK option is ignored.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    ack_number                            Cumulative ACK of the segment */
+/*    option_ptr                            Pointer to option area        */
+/*    option_area_size                      Size of option area           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_packet_process         Process TCP packet for socket */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_tcp_socket_sack_process(NX_TCP_SOCKET *socket_ptr, ULONG ack_number, UCHAR *option_ptr, ULONG option_area_size)
+{
+
+ULONG *sack_left_edge =  socket_ptr -> nx_tcp_socket_sack_left_edge;
+ULONG *sack_right_edge = socket_ptr -> nx_tcp_socket_sack_right_edge;
+ULONG  option_length;
+ULONG  left_edge;
+ULONG  right_edge;
+UINT   count;
+UINT   i;
+UINT   j;
+
+
+    /* Drop the ranges the cumulative ACK covers, and trim the one it ends in.  */
+    count =  0;
+    for (j = 0; j < socket_ptr -> nx_tcp_socket_sack_count; j++)
+    {
+        if ((INT)(sack_right_edge[j] - ack_number) > 0)
+        {
+            sack_left_edge[count] =   sack_left_edge[j];
+            sack_right_edge[count] =  sack_right_edge[j];
+            if ((INT)(sack_left_edge[count] - ack_number) < 0)
+            {
+                sack_left_edge[count] =  ack_number;
+            }
+            count++;
+        }
+    }
+    socket_ptr -> nx_tcp_socket_sack_count =  count;
+
+    /* Loop through the option area looking for the SACK option.  */
+    while (option_area_size >= 2)
+    {
+
+        /* Is the current character the SACK type?  */
+        if (*option_ptr == NX_TCP_SACK_KIND)
+        {
+
+            /* Yes, we found it!  Check the option holds whole blocks.  */
+            option_length =  *(option_ptr + 1);
+            if ((option_length < 10) || (option_length > option_area_size) || ((option_length - 2) & 7))
+            {
+                return;
+            }
+
+            /* Move to the first block.  */
+            option_ptr +=     2;
+            option_length -=  2;
+
+            /* Loop through the blocks.  */
+            while (option_length)
+            {
+
+                /* Pickup the edges of the block.  */
+                left_edge =   ((ULONG)option_ptr[0] << 24) | ((ULONG)option_ptr[1] << 16) |
+                              ((ULONG)option_ptr[2] << 8) | (ULONG)option_ptr[3];
+                right_edge =  ((ULONG)option_ptr[4] << 24) | ((ULONG)option_ptr[5] << 16) |
+                              ((ULONG)option_ptr[6] << 8) | (ULONG)option_ptr[7];
+                option_ptr +=     8;
+                option_length -=  8;
+
+                /* Only record a block above the cumulative ACK and within the data sent.  */
+                if (((INT)(right_edge - left_edge) <= 0) ||
+                    ((INT)(left_edge - ack_number) < 0) ||
+                    ((INT)(right_edge - socket_ptr -> nx_tcp_socket_tx_sequence) > 0))
+                {
+                    continue;
+                }
+
+                /* Merge the ranges the block overlaps or touches into it.  */
+                count =  0;
+                for (j = 0; j < socket_ptr -> nx_tcp_socket_sack_count; j++)
+                {
+                    if (((INT)(sack_left_edge[j] - right_edge) <= 0) &&
+                        ((INT)(left_edge - sack_right_edge[j]) <= 0))
+                    {
+                        if ((INT)(sack_left_edge[j] - left_edge) < 0)
+                        {
+                            left_edge =  sack_left_edge[j];
+                        }
+                        if ((INT)(sack_right_edge[j] - right_edge) > 0)
+                        {
+                            right_edge =  sack_right_edge[j];
+                        }
+                    }
+                    else
+                    {
+                        sack_left_edge[count] =   sack_left_edge[j];
+                        sack_right_edge[count] =  sack_right_edge[j];
+                        count++;
+                    }
+                }
+
+                /* Find the place of the block that keeps the ranges sorted.  */
+                for (i = 0; i < count; i++)
+                {
+                    if ((INT)(left_edge - sack_left_edge[i]) < 0)
+                    {
+                        break;
+                    }
+                }
+
+                /* Is the scoreboard full?  */
+                if (count == NX_TCP_SACK_SCOREBOARD_SIZE)
+                {
+
+                    /* Yes, forget the highest range, which may be this block.  */
+                    if (i == count)
+                    {
+                        socket_ptr -> nx_tcp_socket_sack_count =  count;
+                        continue;
+                    }
+                    count--;
+                }
+
+                /* Insert the block.  */
+                for (j = count; j > i; j--)
+                {
+                    sack_left_edge[j] =   sack_left_edge[j - 1];
+                    sack_right_edge[j] =  sack_right_edge[j - 1];
+                }
+                sack_left_edge[i] =   left_edge;
+                sack_right_edge[i] =  right_edge;
+                socket_ptr -> nx_tcp_socket_sack_count =  count + 1;
+            }
+
+            break;
+        }
+
+        /* Otherwise, process relative to the option type.  */
+
+        /* Check for end of list.  */
+        if (*option_ptr == NX_TCP_EOL_KIND)
+        {
+
+            /* Yes, end of list, get out!  */
+            break;
+        }
+
+        /* Check for NOP.  */
+        if (*option_ptr == NX_TCP_NOP_KIND)
+        {
+            /* One character option!  Skip this option and move to the next entry. */
+            option_ptr++;
+
+            option_area_size--;
+        }
+        else
+        {
+
+            /* Derive the option length.  */
+            option_length = *(option_ptr + 1);
+
+            /* Give up on an illegal option length, the option is checked again later.  */
+            if ((option_length == 0) || (option_length > option_area_size))
+            {
+                return;
+            }
+
+            /* Move the option pointer forward.  */
+            option_ptr =  option_ptr + option_length;
+            option_area_size =  option_area_size - option_length;
+        }
+    }
+}
+#endif /* NX_ENABLE_TCP_SACK */
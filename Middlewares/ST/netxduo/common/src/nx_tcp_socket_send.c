@@ -65,6 +65,8 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_tcp_socket_send_async             Send TCP packet or queue it   */
+/*    _nx_tcp_socket_coalesce_send          Send TCP packet coalesced     */
 /*    _nx_tcp_socket_send_internal          Transmit TCP payload          */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -84,6 +86,19 @@
 UINT  _nx_tcp_socket_send(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
 {
 
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* With a send notify set, a send that would suspend is queued instead.  */
+    if (socket_ptr -> nx_tcp_socket_send_notify)
+    {
+        return(_nx_tcp_socket_send_async(socket_ptr, packet_ptr, wait_option));
+    }
+
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+    /* Small sends are coalesced while data is waiting to be acknowledged.  */
+    return(_nx_tcp_socket_coalesce_send(socket_ptr, packet_ptr, wait_option));
+#else
     return(_nx_tcp_socket_send_internal(socket_ptr, packet_ptr, wait_option));
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
 }
 
@@ -0,0 +1,152 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_send_async                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends a TCP packet through a socket that has a send   */
+/*    notify set. When the packet cannot be sent without suspension       */
+/*    because the window or the transmit queue is full, or because data   */
+/*    sent earlier is still pending, the packet is queued on the socket   */
+/*    and NX_IN_PROGRESS is returned. The queued packets are sent from    */
+/*    the IP thread as ACKs arrive, and the send notify is called once    */
+/*    they are all sent.                                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    packet_ptr                            Pointer to packet to send     */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_IN_PROGRESS                        Packet queued on the socket   */
+/*    NX_NOT_CONNECTED                      Socket is not connected       */
+/*    NX_TX_QUEUE_DEPTH                     Pending queue is full         */
+/*    status                                Actual completion status      */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_send          Send TCP packet coalesced     */
+/*    _nx_tcp_socket_send_internal          Transmit TCP payload          */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_send                   Send TCP packet               */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_send_async(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, ULONG wait_option)
+{
+
+NX_IP *ip_ptr;
+UINT   status;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    /* Obtain the IP mutex so we can examine the pending queue.  */
+    tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    /* Determine if data sent earlier is still pending.  */
+    if (socket_ptr -> nx_tcp_socket_send_pending_head == NX_NULL)
+    {
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        /* No, try to send the packet now.  */
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+        status =  _nx_tcp_socket_coalesce_send(socket_ptr, packet_ptr, wait_option);
+#else
+        status =  _nx_tcp_socket_send_internal(socket_ptr, packet_ptr, wait_option);
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+
+        /* Only a send that would have suspended is queued.  */
+        if ((wait_option != NX_NO_WAIT) ||
+            ((status != NX_WINDOW_OVERFLOW) && (status != NX_TX_QUEUE_DEPTH)))
+        {
+            return(status);
+        }
+
+        /* Obtain the IP mutex again.  */
+        tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+    }
+
+    /* Data can only be queued on a connection that can still send.  */
+    if ((socket_ptr -> nx_tcp_socket_state != NX_TCP_ESTABLISHED) &&
+        (socket_ptr -> nx_tcp_socket_state != NX_TCP_CLOSE_WAIT))
+    {
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        return(NX_NOT_CONNECTED);
+    }
+
+    /* The pending queue is bounded like the transmit queue.  */
+    if (socket_ptr -> nx_tcp_socket_send_pending_count >= socket_ptr -> nx_tcp_socket_transmit_queue_maximum)
+    {
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        return(NX_TX_QUEUE_DEPTH);
+    }
+
+    /* Queue the packet behind the data pending, so the order is kept.  */
+    packet_ptr -> nx_packet_queue_next =  NX_NULL;
+    if (socket_ptr -> nx_tcp_socket_send_pending_tail)
+    {
+        (socket_ptr -> nx_tcp_socket_send_pending_tail) -> nx_packet_queue_next =  packet_ptr;
+    }
+    else
+    {
+        socket_ptr -> nx_tcp_socket_send_pending_head =  packet_ptr;
+    }
+    socket_ptr -> nx_tcp_socket_send_pending_tail =  packet_ptr;
+    socket_ptr -> nx_tcp_socket_send_pending_count++;
+
+    /* Release protection.  */
+    tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+    /* The packet is now owned by the socket.  */
+    return(NX_IN_PROGRESS);
+}
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
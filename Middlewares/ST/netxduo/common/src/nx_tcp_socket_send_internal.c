@@ -292,6 +292,7 @@ UCHAR           preempted = NX_FALSE;
 UCHAR           adjust_packet;
 UINT            old_threshold = 0;
 ULONG           window_size;
+ULONG           rx_window;
 #ifdef NX_ENABLE_TCPIP_OFFLOAD
 UINT            status;
 NX_INTERFACE   *interface_ptr;
@@ -382,7 +383,7 @@ UINT            compute_checksum = 1;
     {
 
         /* Determine whether or not the IPv6 address is valid. */
-        if (socket_ptr -> nx_tcp_socket_ipv6_addr -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+        if (!NX_IPV6_ADDR_STATE_USABLE(socket_ptr -> nx_tcp_socket_ipv6_addr -> nxd_ipv6_address_state))
         {
 
             /* Release the protection.  */
@@ -737,9 +738,16 @@ UINT            compute_checksum = 1;
             header_ptr -> nx_tcp_header_word_0 =        (((ULONG)(socket_ptr -> nx_tcp_socket_port)) << NX_SHIFT_BY_16) | (ULONG)socket_ptr -> nx_tcp_socket_connect_port;
             header_ptr -> nx_tcp_acknowledgment_number = socket_ptr -> nx_tcp_socket_rx_sequence;
 
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+            /* Advertise no more than the free packets of the receive pool can hold.  */
+            rx_window =  _nx_tcp_socket_rx_window_compute(socket_ptr);
+#else
+            rx_window =  socket_ptr -> nx_tcp_socket_rx_window_current;
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+
             /* Set window size. */
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
-            window_size = socket_ptr -> nx_tcp_socket_rx_window_current >> socket_ptr -> nx_tcp_rcv_win_scale_value;
+            window_size = rx_window >> socket_ptr -> nx_tcp_rcv_win_scale_value;
 
             /* Make sure the window_size is less than 0xFFFF. */
             if (window_size > 0xFFFF)
@@ -747,7 +755,7 @@ UINT            compute_checksum = 1;
                 window_size = 0xFFFF;
             }
 #else
-            window_size = socket_ptr -> nx_tcp_socket_rx_window_current;
+            window_size = rx_window;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
 
             header_ptr -> nx_tcp_header_word_3 =        NX_TCP_HEADER_SIZE | NX_TCP_ACK_BIT | NX_TCP_PSH_BIT | window_size;
@@ -755,7 +763,7 @@ UINT            compute_checksum = 1;
 
             /* Remember the last ACKed sequence and the last reported window size.  */
             socket_ptr -> nx_tcp_socket_rx_sequence_acked =    socket_ptr -> nx_tcp_socket_rx_sequence;
-            socket_ptr -> nx_tcp_socket_rx_window_last_sent =  socket_ptr -> nx_tcp_socket_rx_window_current;
+            socket_ptr -> nx_tcp_socket_rx_window_last_sent =  rx_window;
 
             /* Setup a new delayed ACK timeout.  */
             socket_ptr -> nx_tcp_socket_delayed_ack_timeout =  _nx_tcp_ack_timer_rate;
@@ -895,6 +903,7 @@ UINT            compute_checksum = 1;
                 /* Setup a timeout for the packet at the head of the list.  */
                 socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+                NX_TCP_FAST_TIMER_RESUME(ip_ptr)
                 socket_ptr -> nx_tcp_socket_tx_outstanding_bytes = 0;
             }
 
@@ -908,6 +917,16 @@ UINT            compute_checksum = 1;
             /* Increase the transmit outstanding byte count. */
             socket_ptr -> nx_tcp_socket_tx_outstanding_bytes +=
                 (send_packet -> nx_packet_length - (ULONG)sizeof(NX_TCP_HEADER));
+
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+            /* Time this segment unless another one is timed already, one sample is taken per round trip.  */
+            if (socket_ptr -> nx_tcp_socket_rtt_timing == NX_FALSE)
+            {
+                socket_ptr -> nx_tcp_socket_rtt_timing =    NX_TRUE;
+                socket_ptr -> nx_tcp_socket_rtt_sequence =  socket_ptr -> nx_tcp_socket_tx_sequence;
+                socket_ptr -> nx_tcp_socket_rtt_time =      tx_time_get();
+            }
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
 #ifndef NX_DISABLE_TCP_INFO
             /* Increment the TCP packet sent count and bytes sent count.  */
             ip_ptr -> nx_ip_tcp_packets_sent++;
@@ -1112,4 +1131,4 @@ UINT            compute_checksum = 1;
             }
         }
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_send_notify_set                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the send notify function pointer to the          */
+/*    function specified by the application. While it is set, a send      */
+/*    that would suspend queues the packet on the socket and returns      */
+/*    NX_IN_PROGRESS, and the notify is called from the IP thread once    */
+/*    the queued packets are sent.                                        */
+/*                                                                        */
+/*    If a NULL pointer is supplied, sends are no longer queued.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to TCP socket         */
+/*    tcp_socket_send_notify                Routine to call when the      */
+/*                                            queued packets are sent     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_send_notify_set(NX_TCP_SOCKET *socket_ptr,
+                                     VOID (*tcp_socket_send_notify)(NX_TCP_SOCKET *socket_ptr))
+{
+TX_INTERRUPT_SAVE_AREA
+
+    /* Get mutex protection.  */
+    tx_mutex_get(&(socket_ptr -> nx_tcp_socket_ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* Setup the send notify function pointer.  */
+    socket_ptr -> nx_tcp_socket_send_notify =  tcp_socket_send_notify;
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Release protection.  */
+    tx_mutex_put(&(socket_ptr -> nx_tcp_socket_ip_ptr -> nx_ip_protection));
+
+    /* Return successful completion.  */
+    return(NX_SUCCESS);
+}
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
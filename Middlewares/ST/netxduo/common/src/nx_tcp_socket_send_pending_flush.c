@@ -0,0 +1,157 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_tcp.h"
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_send_pending_flush                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends the packets queued on the socket by             */
+/*    _nx_tcp_socket_send_async, in order, until the window or the        */
+/*    transmit queue is full again. Once the queue is drained, the send   */
+/*    notify of the socket is called. This function must not be called    */
+/*    with the IP protection held unless wait_option is NX_NO_WAIT.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to socket             */
+/*    wait_option                           Suspension option             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_tcp_socket_coalesce_send          Send TCP packet coalesced     */
+/*    _nx_tcp_socket_send_internal          Transmit TCP payload          */
+/*    _nx_packet_release                    Release packet                */
+/*    tx_mutex_get                          Obtain protection             */
+/*    tx_mutex_put                          Release protection            */
+/*    (nx_tcp_socket_send_notify)           Application send notify       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_disconnect             Disconnect TCP socket         */
+/*    _nx_tcp_socket_state_transmit_check   Check transmit after ACK      */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_tcp_socket_send_pending_flush(NX_TCP_SOCKET *socket_ptr, ULONG wait_option)
+{
+
+NX_IP     *ip_ptr;
+NX_PACKET *packet_ptr;
+UINT       status =  NX_SUCCESS;
+UINT       sent =  NX_FALSE;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_tcp_socket_ip_ptr;
+
+    for (;;)
+    {
+
+        /* Obtain the IP mutex so we can take the next pending packet.  */
+        tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+        packet_ptr =  socket_ptr -> nx_tcp_socket_send_pending_head;
+        if (packet_ptr == NX_NULL)
+        {
+
+            /* Release protection.  */
+            tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+            break;
+        }
+
+        /* Remove the packet from the queue.  */
+        socket_ptr -> nx_tcp_socket_send_pending_head =  packet_ptr -> nx_packet_queue_next;
+        if (socket_ptr -> nx_tcp_socket_send_pending_head == NX_NULL)
+        {
+            socket_ptr -> nx_tcp_socket_send_pending_tail =  NX_NULL;
+        }
+        socket_ptr -> nx_tcp_socket_send_pending_count--;
+        packet_ptr -> nx_packet_queue_next =  NX_NULL;
+
+        /* Release protection.  */
+        tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+        /* Send the packet.  */
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+        status =  _nx_tcp_socket_coalesce_send(socket_ptr, packet_ptr, wait_option);
+#else
+        status =  _nx_tcp_socket_send_internal(socket_ptr, packet_ptr, wait_option);
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+
+        if ((status == NX_WINDOW_OVERFLOW) || (status == NX_TX_QUEUE_DEPTH))
+        {
+
+            /* Obtain the IP mutex again.  */
+            tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
+
+            /* Put what is left of the packet back at the head, it is retried on the next ACK.  */
+            packet_ptr -> nx_packet_queue_next =  socket_ptr -> nx_tcp_socket_send_pending_head;
+            if (socket_ptr -> nx_tcp_socket_send_pending_head == NX_NULL)
+            {
+                socket_ptr -> nx_tcp_socket_send_pending_tail =  packet_ptr;
+            }
+            socket_ptr -> nx_tcp_socket_send_pending_head =  packet_ptr;
+            socket_ptr -> nx_tcp_socket_send_pending_count++;
+
+            /* Release protection.  */
+            tx_mutex_put(&(ip_ptr -> nx_ip_protection));
+
+            return(status);
+        }
+
+        if (status != NX_SUCCESS)
+        {
+
+            /* The connection can no longer send, drop the packet.  */
+            _nx_packet_release(packet_ptr);
+        }
+
+        sent =  NX_TRUE;
+    }
+
+    /* Tell the application the data it queued is handed to TCP.  */
+    if ((sent) && (socket_ptr -> nx_tcp_socket_send_notify))
+    {
+        (socket_ptr -> nx_tcp_socket_send_notify)(socket_ptr);
+    }
+
+    /* Return completion status.  */
+    return(status);
+}
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
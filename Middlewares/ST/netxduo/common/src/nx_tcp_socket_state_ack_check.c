@@ -65,7 +65,10 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_tcp_packet_send_ack               Send ACK message              */
-/*    _nx_packet_release                    Packet release function       */
+/*    _nx_packet_release_chain_bulk         Release the acknowledged      */
+/*                                            packets                     */
+/*    _nx_packet_release                    Release them one at a time    */
+/*                                            if the bulk release fails   */
 /*    _nx_tcp_socket_retransmit             Retransmit packet             */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -103,6 +106,8 @@ TX_INTERRUPT_SAVE_AREA
 NX_TCP_HEADER *search_header_ptr = NX_NULL;
 NX_PACKET     *search_ptr;
 NX_PACKET     *previous_ptr;
+NX_PACKET     *release_list = NX_NULL;
+NX_PACKET     *release_next;
 ULONG          header_length;
 ULONG          search_sequence;
 ULONG          temp;
@@ -227,6 +232,11 @@ UINT           wrapped_flag = NX_FALSE;
                 /* Yes it is. */
                 socket_ptr -> nx_tcp_socket_fin_acked = NX_TRUE;
             }
+
+#ifdef NX_ENABLE_TCP_SACK
+            /* Nothing remains to be selectively acknowledged.  */
+            socket_ptr -> nx_tcp_socket_sack_count = 0;
+#endif /* NX_ENABLE_TCP_SACK */
         }
         else
         {
@@ -278,6 +288,14 @@ UINT           wrapped_flag = NX_FALSE;
 
                         /* CWND += MSS  */
                         socket_ptr -> nx_tcp_socket_tx_window_congestion += socket_ptr -> nx_tcp_socket_connect_mss;
+
+#ifdef NX_ENABLE_TCP_SACK
+                        /* Retransmit the next hole the peer selectively acknowledged data above.  */
+                        if (socket_ptr -> nx_tcp_socket_sack_count)
+                        {
+                            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TCP_SACK_RETRANSMIT);
+                        }
+#endif /* NX_ENABLE_TCP_SACK */
                     }
                 }
 
@@ -460,6 +478,18 @@ UINT           wrapped_flag = NX_FALSE;
         else
         {
 
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+            /* Determine if the ACK covers the segment being timed.  */
+            if ((socket_ptr -> nx_tcp_socket_rtt_timing == NX_TRUE) &&
+                ((INT)(tcp_header_ptr -> nx_tcp_acknowledgment_number - socket_ptr -> nx_tcp_socket_rtt_sequence) >= 0))
+            {
+
+                /* Yes, take a round trip sample and derive the next transmit timeout from it.  */
+                socket_ptr -> nx_tcp_socket_rtt_timing =  NX_FALSE;
+                _nx_tcp_socket_rtt_update(socket_ptr, tx_time_get() - socket_ptr -> nx_tcp_socket_rtt_time);
+            }
+
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
             /* Congestion window adjustment during slow start and congestion avoidance is executed
                on every incoming ACK that acknowledges new data. RFC5681, Section3.1, Page4-8.  */
 
@@ -699,8 +729,9 @@ UINT           wrapped_flag = NX_FALSE;
                 {
                     socket_ptr -> nx_tcp_socket_tx_outstanding_bytes = 0;
                 }
-                /* Release the packet.  */
-                _nx_packet_release(previous_ptr);
+                /* Add the packet to the ones released together once the queue is walked.  */
+                previous_ptr -> nx_packet_queue_next =  release_list;
+                release_list =  previous_ptr;
             }
             else
             {
@@ -731,6 +762,23 @@ UINT           wrapped_flag = NX_FALSE;
             }
         }
 
+        /* Give the acknowledged packets back to their pools in one call.  */
+        if ((release_list) && (_nx_packet_release_chain_bulk(release_list) != NX_SUCCESS))
+        {
+
+            /* The bulk release checks all the packets first and releases none if one
+               is not allocated, so release the others one at a time.  */
+            while (release_list)
+            {
+
+                /* Pickup the next packet before the queue pointer is reused.  */
+                release_next =  release_list -> nx_packet_queue_next;
+                release_list -> nx_packet_queue_next =  NX_NULL;
+                _nx_packet_release(release_list);
+                release_list =  release_next;
+            }
+        }
+
         if (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE)
         {
 
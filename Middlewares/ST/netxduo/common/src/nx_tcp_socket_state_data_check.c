@@ -112,6 +112,9 @@ NX_PACKET *work_ptr;
         work_ptr -> nx_packet_append_ptr = work_ptr -> nx_packet_prepend_ptr + bytes_to_keep;
 
 #ifndef NX_DISABLE_PACKET_CHAIN
+        /* This packet ends the packet chain now. */
+        packet_ptr -> nx_packet_last = (work_ptr == packet_ptr) ? NX_NULL : work_ptr;
+
         /* Free the rest of the packet chain. */
         tmp_ptr = work_ptr -> nx_packet_next;
         work_ptr -> nx_packet_next = NX_NULL;
@@ -270,6 +273,96 @@ ULONG      work_length;
     packet_ptr -> nx_packet_prepend_ptr -= sizeof(NX_TCP_HEADER);
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_tcp_socket_state_data_merge                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function appends the data of a TCP segment to the queued       */
+/*    segment it directly follows, so that contiguous data received out   */
+/*    of order takes one entry of the receive queue. Data that fits in    */
+/*    the room left in the last packet of the chain is copied there, the  */
+/*    segment is then released by the caller. This is an internal utility */
+/*    function, only used by _nx_tcp_socket_state_data_check.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    queued_ptr                            Pointer to queued segment     */
+/*    packet_ptr                            Pointer to segment to append  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_TRUE                               Data copied, release packet   */
+/*    NX_FALSE                              Packet chained                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    memcpy                                Copy the segment data         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_state_data_check       Process TCP packet for socket */
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+UINT _nx_tcp_socket_state_data_merge(NX_PACKET *queued_ptr, NX_PACKET *packet_ptr)
+{
+NX_TCP_HEADER *tcp_header_ptr;
+NX_PACKET     *last_ptr;
+ULONG          header_length;
+ULONG          data_length;
+
+    /* Pickup the TCP header of the segment to append.  */
+    /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+    tcp_header_ptr =  (NX_TCP_HEADER *)packet_ptr -> nx_packet_prepend_ptr;
+    header_length =  (tcp_header_ptr -> nx_tcp_header_word_3 >> NX_TCP_HEADER_SHIFT) * (ULONG)sizeof(ULONG);
+    data_length =  packet_ptr -> nx_packet_length - header_length;
+
+    /* Only the data is appended, the header is not part of the chain.  */
+    packet_ptr -> nx_packet_prepend_ptr =  packet_ptr -> nx_packet_prepend_ptr + header_length;
+
+    /* Pickup the last packet of the queued segment.  */
+    last_ptr =  queued_ptr -> nx_packet_last ? queued_ptr -> nx_packet_last : queued_ptr;
+
+    /* The queued segment covers the data appended.  */
+    queued_ptr -> nx_packet_length =  queued_ptr -> nx_packet_length + data_length;
+
+    /* Does the data fit in the room left in the last packet?  */
+    /*lint -e{946} -e{947} suppress pointer subtraction, since it is necessary. */
+    if ((packet_ptr -> nx_packet_next == NX_NULL) &&
+        ((ULONG)(last_ptr -> nx_packet_data_end - last_ptr -> nx_packet_append_ptr) >= data_length))
+    {
+
+        /* Yes, copy it so that the packet goes back to the pool.  */
+        memcpy(last_ptr -> nx_packet_append_ptr, packet_ptr -> nx_packet_prepend_ptr, data_length); /* Use case of memcpy is verified. */
+        last_ptr -> nx_packet_append_ptr =  last_ptr -> nx_packet_append_ptr + data_length;
+
+        /* Restore the packet, its header is still read by the caller.  */
+        packet_ptr -> nx_packet_prepend_ptr =  packet_ptr -> nx_packet_prepend_ptr - header_length;
+
+        /* Mark the packet as no longer being part of the TCP queue.  */
+        /*lint -e{923} suppress cast of ULONG to pointer.  */
+        packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next =  (NX_PACKET *)NX_PACKET_ALLOCATED;
+
+        return(NX_TRUE);
+    }
+
+    /* Chain the packet behind the last one.  */
+    last_ptr -> nx_packet_next =  packet_ptr;
+    queued_ptr -> nx_packet_last =  packet_ptr -> nx_packet_last ? packet_ptr -> nx_packet_last : packet_ptr;
+    packet_ptr -> nx_packet_last =  NX_NULL;
+
+    /* A packet in the chain is released with the queued segment.  */
+    /*lint -e{923} suppress cast of ULONG to pointer.  */
+    packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next =  (NX_PACKET *)NX_PACKET_ALLOCATED;
+
+    return(NX_FALSE);
+}
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
+
 
 /**************************************************************************/
 /*                                                                        */
@@ -352,6 +445,9 @@ ULONG          tcpip_offload;
 #ifdef NX_ENABLE_LOW_WATERMARK
 UCHAR          drop_packet = NX_FALSE;
 #endif /* NX_ENABLE_LOW_WATERMARK */
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+NX_PACKET     *merged_ptr = NX_NULL;
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
 #if ((!defined(NX_DISABLE_TCP_INFO)) || defined(TX_ENABLE_EVENT_TRACE))
 NX_IP         *ip_ptr;
 
@@ -374,6 +470,11 @@ NX_IP         *ip_ptr;
     /* Record the original rx_sequence. */
     original_rx_sequence = socket_ptr -> nx_tcp_socket_rx_sequence;
 
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+    /* Remember the pool the segments are received in, it bounds the window advertised.  */
+    socket_ptr -> nx_tcp_socket_rx_window_pool =  packet_ptr -> nx_packet_pool_owner;
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
+
     /* Pickup the begin sequence of this packet. */
     packet_begin_sequence = tcp_header_ptr -> nx_tcp_sequence_number;
 
@@ -664,7 +765,13 @@ NX_IP         *ip_ptr;
         /* Packet data begins to the right of the expected sequence (out of sequence data). Force an ACK. */
         if (((INT)(packet_begin_sequence - socket_ptr -> nx_tcp_socket_rx_sequence)) > 0)
         {
+#ifdef NX_ENABLE_TCP_SACK
+            /* Send the ACK once the packet is queued, its SACK option reports this packet first.  */
+            socket_ptr -> nx_tcp_socket_sack_last_sequence = packet_begin_sequence;
+            need_ack = NX_TRUE;
+#else
             _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
+#endif /* NX_ENABLE_TCP_SACK */
         }
 
         /* At this point, it is guaranteed that the receive queue contains packets. */
@@ -672,6 +779,18 @@ NX_IP         *ip_ptr;
 
         previous_ptr = NX_NULL;
 
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+        /* Most packets out of order extend the data queued last. search_end_sequence is still
+           the end of the tail packet, check it before searching from the head.  */
+        if (((INT)(packet_begin_sequence - search_end_sequence)) >= 0)
+        {
+
+            /* The packet goes after the tail.  */
+            previous_ptr = socket_ptr -> nx_tcp_socket_receive_queue_tail;
+            search_ptr = NX_NULL;
+        }
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
+
         while (search_ptr)
         {
 
@@ -889,6 +1008,71 @@ NX_IP         *ip_ptr;
         /* Increment the receive TCP packet count.  */
         socket_ptr -> nx_tcp_socket_receive_queue_count++;
 
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+
+        /* Does the next packet on the queue begin where this packet ends?  */
+        /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+        if ((search_ptr) &&
+            (((NX_TCP_HEADER *)search_ptr -> nx_packet_prepend_ptr) -> nx_tcp_sequence_number ==
+             (packet_begin_sequence + packet_data_length)))
+        {
+
+            /* Yes, remove it from the queue and append its data to this packet.  */
+            packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next = search_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+
+            if (socket_ptr -> nx_tcp_socket_receive_queue_tail == search_ptr)
+            {
+                socket_ptr -> nx_tcp_socket_receive_queue_tail = packet_ptr;
+            }
+
+            /* Decrease the packet queue count */
+            socket_ptr -> nx_tcp_socket_receive_queue_count--;
+
+            if (_nx_tcp_socket_state_data_merge(packet_ptr, search_ptr))
+            {
+
+                /* The data is copied, release the packet.  */
+                _nx_packet_release(search_ptr);
+            }
+        }
+
+        /* Does this packet begin where the previous packet ends? The data ready for
+           the application is left as it is.  */
+        /*lint -e{923} suppress cast of ULONG to pointer.  */
+        if ((previous_ptr) && (previous_ptr -> nx_packet_queue_next != (NX_PACKET *)NX_PACKET_READY))
+        {
+
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            search_header_ptr =  (NX_TCP_HEADER *)previous_ptr -> nx_packet_prepend_ptr;
+
+            /* Calculate the header size for this packet.  */
+            header_length =  (search_header_ptr -> nx_tcp_header_word_3 >> NX_TCP_HEADER_SHIFT) * (ULONG)sizeof(ULONG);
+
+            if ((search_header_ptr -> nx_tcp_sequence_number + previous_ptr -> nx_packet_length - header_length) ==
+                packet_begin_sequence)
+            {
+
+                /* Yes, remove this packet from the queue and append its data to the previous packet.  */
+                previous_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next = packet_ptr -> nx_packet_union_next.nx_packet_tcp_queue_next;
+
+                if (socket_ptr -> nx_tcp_socket_receive_queue_tail == packet_ptr)
+                {
+                    socket_ptr -> nx_tcp_socket_receive_queue_tail = previous_ptr;
+                }
+
+                /* Decrease the packet queue count */
+                socket_ptr -> nx_tcp_socket_receive_queue_count--;
+
+                if (_nx_tcp_socket_state_data_merge(previous_ptr, packet_ptr))
+                {
+
+                    /* The data is copied, release the packet once its header is no longer used.  */
+                    merged_ptr = packet_ptr;
+                }
+            }
+        }
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
+
         /* End of the out-of-order search.  At this point, the packet has been inserted. */
 
         /* Now we need to figure out how much, if any, we can ACK.  */
@@ -1046,9 +1230,12 @@ NX_IP         *ip_ptr;
     }
 
 #ifdef NX_TCP_MAX_OUT_OF_ORDER_PACKETS
-    /* Does the count of out of order packets exceed the defined value? */
-    if ((socket_ptr -> nx_tcp_socket_receive_queue_count - acked_packets) >
-        NX_TCP_MAX_OUT_OF_ORDER_PACKETS)
+    /* Does the count of out of order packets exceed the defined value? The packets not retrieved
+       yet are counted too, so make sure the tail is not data already acknowledged.  */
+    /*lint -e{923} suppress cast of ULONG to pointer.  */
+    if (((socket_ptr -> nx_tcp_socket_receive_queue_count - acked_packets) >
+         NX_TCP_MAX_OUT_OF_ORDER_PACKETS) &&
+        (socket_ptr -> nx_tcp_socket_receive_queue_tail -> nx_packet_queue_next != (NX_PACKET *)NX_PACKET_READY))
     {
 
         /* Yes it is. Remove the last packet in queue. */
@@ -1156,7 +1343,11 @@ NX_IP         *ip_ptr;
 
     /* Determine if an ACK should be forced out for window update, SWS avoidance algorithm.
        RFC1122, Section4.2.3.3, Page97-98. */
+#ifdef NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+    if ((_nx_tcp_socket_rx_window_compute(socket_ptr) - socket_ptr -> nx_tcp_socket_rx_window_last_sent) >= (socket_ptr -> nx_tcp_socket_rx_window_default / 2))
+#else
     if ((socket_ptr -> nx_tcp_socket_rx_window_current - socket_ptr -> nx_tcp_socket_rx_window_last_sent) >= (socket_ptr -> nx_tcp_socket_rx_window_default / 2))
+#endif /* NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT */
     {
 
         /* Need to send ACK for window update.  */
@@ -1201,6 +1392,32 @@ NX_IP         *ip_ptr;
             }
         }
 #endif
+
+#ifdef NX_ENABLE_TCP_QUICKACK
+        /* Determine if the ACK policy of the socket asks for an immediate ACK.  */
+        if (socket_ptr -> nx_tcp_socket_state == NX_TCP_ESTABLISHED)
+        {
+
+            /* The first segments of the connection are acknowledged at once, so the peer
+               does not wait for the delayed ACK timer while its congestion window is small.  */
+            if (socket_ptr -> nx_tcp_socket_quickack_remaining)
+            {
+                socket_ptr -> nx_tcp_socket_quickack_remaining--;
+
+                /* Need to send an immediate ACK.  */
+                need_ack = NX_TRUE;
+            }
+
+            /* A small segment with the PSH bit usually completes a request or a response.  */
+            else if ((tcp_header_ptr -> nx_tcp_header_word_3 & NX_TCP_PSH_BIT) &&
+                     (packet_data_length <= socket_ptr -> nx_tcp_socket_quickack_push_size))
+            {
+
+                /* Need to send an immediate ACK.  */
+                need_ack = NX_TRUE;
+            }
+        }
+#endif /* NX_ENABLE_TCP_QUICKACK */
     }
 
     if (need_ack == NX_TRUE)
@@ -1210,6 +1427,14 @@ NX_IP         *ip_ptr;
         _nx_tcp_packet_send_ack(socket_ptr, socket_ptr -> nx_tcp_socket_tx_sequence);
     }
 
+#ifdef NX_ENABLE_TCP_RX_SEGMENT_MERGE
+    /* Release the packet whose data was copied to the previous packet.  */
+    if (merged_ptr)
+    {
+        _nx_packet_release(merged_ptr);
+    }
+#endif /* NX_ENABLE_TCP_RX_SEGMENT_MERGE */
+
     /* Return true since the packet was queued.  */
     return(NX_TRUE);
 }
@@ -145,6 +145,11 @@ VOID  _nx_tcp_socket_state_syn_received(NX_TCP_SOCKET *socket_ptr, NX_TCP_HEADER
 
             /* Move into the ESTABLISHED state.  */
             socket_ptr -> nx_tcp_socket_state =  NX_TCP_ESTABLISHED;
+
+#ifdef NX_ENABLE_TCP_QUICKACK
+            /* Start the quick ACKs of the new connection.  */
+            socket_ptr -> nx_tcp_socket_quickack_remaining =  socket_ptr -> nx_tcp_socket_quickack_segments;
+#endif /* NX_ENABLE_TCP_QUICKACK */
 #ifndef NX_DISABLE_EXTENDED_NOTIFY_SUPPORT
 
             /* If registered with the TCP socket, call the application's connection completion callback function.  */
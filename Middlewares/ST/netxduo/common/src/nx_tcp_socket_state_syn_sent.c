@@ -185,6 +185,11 @@ VOID  _nx_tcp_socket_state_syn_sent(NX_TCP_SOCKET *socket_ptr, NX_TCP_HEADER *tc
         /* Clear the socket timeout.  */
         socket_ptr -> nx_tcp_socket_timeout =  0;
 
+#ifdef NX_ENABLE_TCP_QUICKACK
+        /* Start the quick ACKs of the new connection.  */
+        socket_ptr -> nx_tcp_socket_quickack_remaining =  socket_ptr -> nx_tcp_socket_quickack_segments;
+#endif /* NX_ENABLE_TCP_QUICKACK */
+
 #ifndef NX_DISABLE_EXTENDED_NOTIFY_SUPPORT
 
         /* Is a connection completion callback registered with the TCP socket?  */
@@ -80,6 +80,23 @@ VOID  _nx_tcp_socket_state_transmit_check(NX_TCP_SOCKET *socket_ptr)
 
 ULONG tx_window_current;
 
+#ifdef NX_ENABLE_TCP_SEND_COALESCE
+    /* Once all the data sent is acknowledged, the small sends held are sent.  */
+    if ((socket_ptr -> nx_tcp_socket_coalesce_packet) &&
+        (socket_ptr -> nx_tcp_socket_transmit_sent_head == NX_NULL))
+    {
+        _nx_tcp_socket_coalesce_flush(socket_ptr, NX_NO_WAIT);
+    }
+
+#endif /* NX_ENABLE_TCP_SEND_COALESCE */
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* The sends queued while the window was full go out as it opens.  */
+    if (socket_ptr -> nx_tcp_socket_send_pending_head)
+    {
+        _nx_tcp_socket_send_pending_flush(socket_ptr, NX_NO_WAIT);
+    }
+
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
     /* Now check to see if there is a thread suspended attempting to transmit.  */
     if (socket_ptr -> nx_tcp_socket_transmit_suspension_list)
     {
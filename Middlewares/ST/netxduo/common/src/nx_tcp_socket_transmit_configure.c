@@ -98,6 +98,9 @@ NX_IP *ip_ptr;
 
     /* Setup the socket with the new transmit parameters.  */
     socket_ptr -> nx_tcp_socket_timeout_rate =                    timeout;
+#ifdef NX_ENABLE_TCP_RTO_ESTIMATION
+    socket_ptr -> nx_tcp_socket_timeout_rate_initial =            timeout;
+#endif /* NX_ENABLE_TCP_RTO_ESTIMATION */
     socket_ptr -> nx_tcp_socket_timeout_max_retries =             max_retries;
     socket_ptr -> nx_tcp_socket_timeout_shift =                   timeout_shift;
     socket_ptr -> nx_tcp_socket_transmit_queue_maximum_default =  max_queue_depth;
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   User Datagram Protocol (UDP)                                        */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+#include "nx_udp.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_udp_socket_receive_batch                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function receives up to max_datagrams datagrams of the socket  */
+/*    in one call. It waits for the first datagram as                     */
+/*    nx_udp_socket_receive does, then takes the datagrams already queued */
+/*    without suspending, so a burst costs one call and one wakeup. Each  */
+/*    datagram is returned with its source address, port and interface,   */
+/*    the UDP header removed as with nx_udp_socket_receive. The queue is  */
+/*    protected by disabling interrupts for each datagram taken, not for  */
+/*    the whole burst, so the checksums are verified with the interrupts  */
+/*    enabled.                                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to UDP socket         */
+/*    datagrams                             Array of received datagrams   */
+/*    max_datagrams                         Number of entries of array    */
+/*    datagram_count                        Number of datagrams received, */
+/*                                            set                         */
+/*    wait_option                           Suspension option for the     */
+/*                                            first datagram              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_udp_socket_receive                Receive one UDP datagram      */
+/*    _nxd_udp_packet_info_extract          Extract the source of a       */
+/*                                            datagram                    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_udp_socket_receive_batch(NX_UDP_SOCKET *socket_ptr, NX_UDP_DATAGRAM *datagrams, UINT max_datagrams,
+                                   UINT *datagram_count, ULONG wait_option)
+{
+
+UINT             status;
+UINT             protocol;
+UINT             count = 0;
+NX_UDP_DATAGRAM *datagram_ptr;
+
+
+    *datagram_count =  0;
+
+    if (max_datagrams == 0)
+    {
+        return(NX_SUCCESS);
+    }
+
+    /* Receive the first datagram, suspending for it as requested.  */
+    status =  _nx_udp_socket_receive(socket_ptr, &(datagrams[0].nx_udp_datagram_packet_ptr), wait_option);
+
+    /* Loop to take the datagrams already queued.  */
+    while (status == NX_SUCCESS)
+    {
+
+        /* Record the source of the datagram.  */
+        datagram_ptr =  &datagrams[count];
+        _nxd_udp_packet_info_extract(datagram_ptr -> nx_udp_datagram_packet_ptr,
+                                     &(datagram_ptr -> nx_udp_datagram_source_address), &protocol,
+                                     &(datagram_ptr -> nx_udp_datagram_source_port),
+                                     &(datagram_ptr -> nx_udp_datagram_interface_index));
+        count++;
+
+        if (count == max_datagrams)
+        {
+            break;
+        }
+
+        /* Take the next datagram, no suspension takes place.  */
+        status =  _nx_udp_socket_receive(socket_ptr, &(datagrams[count].nx_udp_datagram_packet_ptr), NX_NO_WAIT);
+    }
+
+    *datagram_count =  count;
+
+    /* The datagrams taken are returned even when the queue ends on an error.  */
+    if (count > 0)
+    {
+        return(NX_SUCCESS);
+    }
+
+    /* Return completion status.  */
+    return(status);
+}
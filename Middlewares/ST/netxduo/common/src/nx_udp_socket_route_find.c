@@ -0,0 +1,137 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_udp.h"
+
+#if !defined(NX_DISABLE_IPV4) && defined(NX_ENABLE_UDP_ROUTE_CACHE)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_udp_socket_route_find                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finds the interface and the next hop to send a UDP    */
+/*    packet of the socket to an IPv4 destination. The route of the last  */
+/*    destination is cached in the socket and used again while the        */
+/*    destination, the link of its interface and the routes of the IP     */
+/*    instance are unchanged, so a socket sending to one peer does not    */
+/*    search the routes for each packet.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to UDP socket         */
+/*    destination_address                   Destination IP address        */
+/*    ip_interface_ptr                      Pointer to outgoing interface */
+/*    next_hop_address                      Pointer to next hop address   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_ip_route_find                     Find the route                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nxd_udp_socket_send                  Send a UDP packet             */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_udp_socket_route_find(NX_UDP_SOCKET *socket_ptr, ULONG destination_address,
+                                NX_INTERFACE **ip_interface_ptr, ULONG *next_hop_address)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+NX_IP        *ip_ptr;
+NX_INTERFACE *interface_ptr;
+ULONG         route_generation;
+
+
+    /* Setup the pointer to the associated IP instance.  */
+    ip_ptr =  socket_ptr -> nx_udp_socket_ip_ptr;
+
+    /* A packet sent on a specified interface is routed as usual.  */
+    if (*ip_interface_ptr)
+    {
+        _nx_ip_route_find(ip_ptr, destination_address, ip_interface_ptr, next_hop_address);
+        return;
+    }
+
+    /* Disable interrupts, the socket may be sent on by several threads.  */
+    TX_DISABLE
+
+    /* Pickup the route generation before the route is searched, a route changed
+       during the search is then not cached as valid.  */
+    route_generation =  ip_ptr -> nx_ip_route_generation;
+
+    /* Determine if the route of the last destination still applies.  */
+    interface_ptr =  socket_ptr -> nx_udp_socket_route_interface;
+    if ((interface_ptr) &&
+        (interface_ptr -> nx_interface_link_up) &&
+        (socket_ptr -> nx_udp_socket_route_address == destination_address) &&
+        (socket_ptr -> nx_udp_socket_route_generation == route_generation))
+    {
+
+        /* Yes, use the cached interface and next hop.  */
+        *ip_interface_ptr =  interface_ptr;
+        *next_hop_address =  socket_ptr -> nx_udp_socket_route_next_hop;
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+
+        return;
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Search the route of the destination.  */
+    _nx_ip_route_find(ip_ptr, destination_address, ip_interface_ptr, next_hop_address);
+
+    /* Determine if a route is found.  */
+    if ((*ip_interface_ptr) && (*next_hop_address))
+    {
+
+        /* Disable interrupts.  */
+        TX_DISABLE
+
+        /* Cache the route for the next packet to the same destination.  */
+        socket_ptr -> nx_udp_socket_route_address =     destination_address;
+        socket_ptr -> nx_udp_socket_route_interface =   *ip_interface_ptr;
+        socket_ptr -> nx_udp_socket_route_next_hop =    *next_hop_address;
+        socket_ptr -> nx_udp_socket_route_generation =  route_generation;
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+    }
+}
+#endif /* !NX_DISABLE_IPV4 && NX_ENABLE_UDP_ROUTE_CACHE */
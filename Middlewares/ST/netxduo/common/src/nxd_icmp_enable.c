@@ -26,6 +26,7 @@
 #include "nx_api.h"
 #include "nx_icmp.h"
 #include "nx_icmpv6.h"
+#include "nx_tcp.h"
 
 
 /**************************************************************************/
@@ -99,6 +100,9 @@ UINT _nxd_icmp_enable(NX_IP *ip_ptr)
     ip_ptr -> nx_nd_cache_fast_periodic_update = _nx_nd_cache_fast_periodic_update;
     ip_ptr -> nx_nd_cache_slow_periodic_update = _nx_nd_cache_slow_periodic_update;
 
+    /* The ND cache runs on the fast timer, restart it if TCP stopped it.  */
+    NX_TCP_FAST_TIMER_RESUME(ip_ptr)
+
     /* Initialize tables used in ICMPv6 protocols. */
     /* Clear the ND Cache table. */
     memset(&ip_ptr -> nx_ipv6_nd_cache[0], 0, sizeof(ND_CACHE_ENTRY) * NX_IPV6_NEIGHBOR_CACHE_SIZE);
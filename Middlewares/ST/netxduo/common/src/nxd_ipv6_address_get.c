@@ -108,7 +108,7 @@ ULONG             ip_address_lsw;
     interface_ipv6_address_next = &ip_ptr -> nx_ipv6_address[address_index];
 
     /* Check if this is a valid IP address. */
-    if (interface_ipv6_address_next -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+    if (!NX_IPV6_ADDR_STATE_USABLE(interface_ipv6_address_next -> nxd_ipv6_address_state))
     {
 
         /* No, the address is not validated yet. */
@@ -268,7 +268,19 @@ ULONG             multicast_address[4];
     {
 
         /* Start DAD */
-        ipv6_addr -> nxd_ipv6_address_state                 = NX_IPV6_ADDR_STATE_TENTATIVE;
+#ifdef NX_IPV6_OPTIMISTIC_DAD
+
+        /* The link local address built from the MAC address is unlikely to collide,
+           it is used during DAD, RFC 4429. A manual address is never optimistic. */
+        if (!ip_address)
+        {
+            ipv6_addr -> nxd_ipv6_address_state             = NX_IPV6_ADDR_STATE_OPTIMISTIC;
+        }
+        else
+#endif /* NX_IPV6_OPTIMISTIC_DAD */
+        {
+            ipv6_addr -> nxd_ipv6_address_state             = NX_IPV6_ADDR_STATE_TENTATIVE;
+        }
         ipv6_addr -> nxd_ipv6_address_DupAddrDetectTransmit = NX_IPV6_DAD_TRANSMITS;
 
         /* If trace is enabled, log the start of DAD process. */
@@ -186,7 +186,7 @@ ULONG                         address_type = IPv6_Address_Type(dest_address);
         {
 
             /* Skip address that is not valid. */
-            if (ipv6_address -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+            if (!NX_IPV6_ADDR_STATE_USABLE(ipv6_address -> nxd_ipv6_address_state))
             {
                 continue;
             }
@@ -299,7 +299,7 @@ ULONG                         address_type = IPv6_Address_Type(dest_address);
             {
 
                 /* Check for a valid address. */
-                if (ipv6_address -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+                if (!NX_IPV6_ADDR_STATE_USABLE(ipv6_address -> nxd_ipv6_address_state))
                 {
                     ipv6_address = ipv6_address -> nxd_ipv6_address_next;
                 }
@@ -411,6 +411,11 @@ ULONG         ip_address_log = 0;
 
     socket_ptr -> nx_tcp_socket_connect_interface = outgoing_interface;
 
+#ifdef NX_ENABLE_TCP_CONNECTION_TABLE
+    /* The peer is known now, index the connection.  */
+    _nx_tcp_socket_connection_insert(socket_ptr);
+#endif /* NX_ENABLE_TCP_CONNECTION_TABLE */
+
     /* Setup the initial sequence number.  */
     if (socket_ptr -> nx_tcp_socket_tx_sequence == 0)
     {
@@ -436,6 +441,7 @@ ULONG         ip_address_log = 0;
     /* Setup a timeout so the connection attempt can be sent again.  */
     socket_ptr -> nx_tcp_socket_timeout =          socket_ptr -> nx_tcp_socket_timeout_rate;
     socket_ptr -> nx_tcp_socket_timeout_retries =  0;
+    NX_TCP_FAST_TIMER_RESUME(ip_ptr)
 
     /* CLEANUP: In case any existing packets on socket's receive queue.  */
     if (socket_ptr -> nx_tcp_socket_receive_queue_count)
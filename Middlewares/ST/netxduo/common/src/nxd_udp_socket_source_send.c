@@ -96,7 +96,7 @@ NX_IP *ip_ptr;
     {
         packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr = &ip_ptr -> nx_ipv6_address[address_index];
 
-        if (packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state != NX_IPV6_ADDR_STATE_VALID)
+        if (!NX_IPV6_ADDR_STATE_USABLE(packet_ptr -> nx_packet_address.nx_packet_ipv6_address_ptr -> nxd_ipv6_address_state))
         {
             return(NX_NO_INTERFACE_ADDRESS);
         }
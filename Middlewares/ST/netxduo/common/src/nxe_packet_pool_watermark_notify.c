@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+#ifdef NX_ENABLE_LOW_WATERMARK
+/* Bring in externs for caller checking code.  */
+
+NX_CALLER_CHECKING_EXTERNS
+#endif /* NX_ENABLE_LOW_WATERMARK */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxe_packet_pool_watermark_notify                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the packet pool watermark notify */
+/*    function call.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to packet pool        */
+/*    low_watermark                         Available packets to pause at */
+/*    high_watermark                        Available packets to resume at*/
+/*    watermark_notify                      Notify function               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_pool_watermark_notify      Actual packet pool watermark  */
+/*                                            notify function             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nxe_packet_pool_watermark_notify(NX_PACKET_POOL *pool_ptr, ULONG low_watermark, ULONG high_watermark,
+                                        VOID (*watermark_notify)(NX_PACKET_POOL *pool_ptr, UINT is_low))
+{
+#ifdef NX_ENABLE_LOW_WATERMARK
+
+UINT status;
+
+
+    /* Check for invalid input pointers.  */
+    if ((pool_ptr == NX_NULL) || (pool_ptr -> nx_packet_pool_id != NX_PACKET_POOL_ID))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* The high watermark must be above the low one and reachable by the pool.  */
+    if ((watermark_notify) &&
+        ((low_watermark >= high_watermark) || (high_watermark > pool_ptr -> nx_packet_pool_total)))
+    {
+        return(NX_INVALID_PARAMETERS);
+    }
+
+    /* Check for appropriate caller.  */
+    NX_INIT_AND_THREADS_CALLER_CHECKING
+
+    /* Call actual packet pool watermark notify function.  */
+    status =  _nx_packet_pool_watermark_notify(pool_ptr, low_watermark, high_watermark, watermark_notify);
+
+    /* Return completion status.  */
+    return(status);
+
+#else /* !NX_ENABLE_LOW_WATERMARK */
+    NX_PARAMETER_NOT_USED(pool_ptr);
+    NX_PARAMETER_NOT_USED(low_watermark);
+    NX_PARAMETER_NOT_USED(high_watermark);
+    NX_PARAMETER_NOT_USED(watermark_notify);
+
+    return(NX_NOT_SUPPORTED);
+
+#endif /* NX_ENABLE_LOW_WATERMARK */
+}
@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Packet Pool Management (Packet)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_packet.h"
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxe_packet_release_chain_bulk                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the packet chain bulk release    */
+/*    function call.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    packet_list_ptr                       Pointer to the first packet   */
+/*                                            chain to release            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_packet_release_chain_bulk         Actual packet chain bulk      */
+/*                                            release function            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nxe_packet_release_chain_bulk(NX_PACKET **packet_list_ptr)
+{
+
+UINT       status;
+NX_PACKET *head_ptr;
+
+
+    /* Check for an empty list.  */
+    if (*packet_list_ptr == NX_NULL)
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Simple integrity check on the head of each chain.  */
+    for (head_ptr = *packet_list_ptr; head_ptr; head_ptr = head_ptr -> nx_packet_queue_next)
+    {
+        if ((head_ptr -> nx_packet_pool_owner == NX_NULL) ||
+            ((head_ptr -> nx_packet_pool_owner) -> nx_packet_pool_id != NX_PACKET_POOL_ID))
+        {
+            return(NX_PTR_ERROR);
+        }
+
+        /* Check for an invalid packet prepend pointer.  */
+        /*lint -e{946} suppress pointer subtraction, since it is necessary. */
+        if (head_ptr -> nx_packet_prepend_ptr < head_ptr -> nx_packet_data_start)
+        {
+            return(NX_UNDERFLOW);
+        }
+
+        /* Check for an invalid packet append pointer.  */
+        /*lint -e{946} suppress pointer subtraction, since it is necessary. */
+        if (head_ptr -> nx_packet_append_ptr > head_ptr -> nx_packet_data_end)
+        {
+            return(NX_OVERFLOW);
+        }
+    }
+
+    /* Call actual packet chain bulk release function.  */
+    status =  _nx_packet_release_chain_bulk(*packet_list_ptr);
+
+    /* Determine if the release was successful.  */
+    if (status == NX_SUCCESS)
+    {
+
+        /* Yes, now clear the application's packet pointer so it can't be accidentally
+           used again by the application.  This is only done when error checking is
+           enabled.  */
+        *packet_list_ptr =  NX_NULL;
+    }
+
+    /* Return completion status.  */
+    return(status);
+}
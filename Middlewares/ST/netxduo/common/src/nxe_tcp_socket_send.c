@@ -165,8 +165,8 @@ UINT       ip_header_size;
     /* Call actual TCP socket send function.  */
     status =  _nx_tcp_socket_send(socket_ptr, packet_ptr, wait_option);
 
-    /* Determine if the packet send was successful.  */
-    if (status == NX_SUCCESS)
+    /* Determine if the packet send was successful, or the packet was queued.  */
+    if ((status == NX_SUCCESS) || (status == NX_IN_PROGRESS))
     {
 
         /* Yes, now clear the application's packet pointer so it can't be accidentally
@@ -186,6 +186,12 @@ extern VOID *(*volatile _nx_crypto_memcpy_ptr)(void *dest, const void *src, size
 #endif
 #endif
 
+/* Defined, fills a buffer with random bytes in one call, instead of one NX_CRYPTO_RAND()
+   word after the other. */
+#if !defined(NX_CRYPTO_RAND_BYTES) && defined(NX_RAND_BYTES) && !defined(NX_CRYPTO_STANDALONE_ENABLE)
+#define NX_CRYPTO_RAND_BYTES                      NX_RAND_BYTES
+#endif
+
 
 #ifndef NX_CRYPTO_SRAND
 #ifndef NX_CRYPTO_STANDALONE_ENABLE
@@ -230,6 +236,13 @@ extern unsigned int _nx_crypto_library_state;
 #define NX_CRYPTO_PARAMETER_NOT_USED(p) ((void)(p))
 #endif /* NX_CRYPTO_PARAMETER_NOT_USED */
 
+/* The cycle profiling macros come from nx_user.h, which standalone builds do not include. */
+#ifndef CYCLE_PROFILE_SAVE_AREA
+#define CYCLE_PROFILE_SAVE_AREA
+#define CYCLE_PROFILE_ENTER
+#define CYCLE_PROFILE_EXIT(region)
+#endif /* CYCLE_PROFILE_SAVE_AREA */
+
 /* Note that both input and output packets are prepared by the
    caller. For encryption/decryption operations, the callee shall
    use the output buffer for encrypted or decrypted data. For
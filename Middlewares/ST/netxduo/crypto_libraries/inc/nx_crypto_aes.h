@@ -110,9 +110,13 @@ extern   "C" {
 #define NX_CRYPTO_AES_KEY_SCHEDULE_ENCRYPT       1
 #define NX_CRYPTO_AES_KEY_SCHEDULE_DECRYPT       2
 
-/* Define NX_CRYPTO_AES_USE_RAM_TABLES to move tables to RAM. */
+/* Define NX_CRYPTO_AES_USE_RAM_TABLES to move tables to RAM, and NX_CRYPTO_AES_TABLE_SECTION
+   to the attribute placing them in a given RAM section, for example one without wait state.  */
 #ifdef NX_CRYPTO_AES_USE_RAM_TABLES
-#define NX_CRYPTO_AES_TABLE                      static
+#ifndef NX_CRYPTO_AES_TABLE_SECTION
+#define NX_CRYPTO_AES_TABLE_SECTION
+#endif
+#define NX_CRYPTO_AES_TABLE                      static NX_CRYPTO_AES_TABLE_SECTION
 #else
 #define NX_CRYPTO_AES_TABLE                      static const
 #endif
@@ -152,6 +156,12 @@ typedef struct NX_CRYPTO_AES_STRUCT
 
 UINT _nx_crypto_aes_encrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length);
 UINT _nx_crypto_aes_decrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input, UCHAR *output, UINT length);
+UINT _nx_crypto_aes_ctr_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *counter_block,
+                                       UCHAR *input, UCHAR *output, UINT blocks);
+UINT _nx_crypto_aes_cbc_decrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                       UCHAR *input, UCHAR *output, UINT blocks);
+UINT _nx_crypto_aes_ccm_blocks(NX_CRYPTO_AES *aes_ptr, UINT op, UCHAR *counter_block,
+                               UCHAR *mac, UCHAR *input, UCHAR *output, UINT blocks);
 
 UINT _nx_crypto_aes_key_set(NX_CRYPTO_AES *aes_ptr, UCHAR *key, UINT key_size);
 
@@ -253,6 +263,54 @@ UINT  _nx_crypto_method_aes_xcbc_operation(UINT op,      /* Encrypt, Decrypt, Au
                                            VOID *packet_ptr,
                                            VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
 
+#ifdef NX_CRYPTO_STM32_HW
+/* The modes over the CRYP peripheral of the STM32F4x7/F4x9, in the methods of its driver.  */
+UINT  _nx_crypto_method_stm32_aes_cbc_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                VOID *handle, /* Crypto handler */
+                                                struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                UCHAR *key,
+                                                NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                UCHAR *input,
+                                                ULONG input_length_in_byte,
+                                                UCHAR *iv_ptr,
+                                                UCHAR *output,
+                                                ULONG output_length_in_byte,
+                                                VOID *crypto_metadata,
+                                                ULONG crypto_metadata_size,
+                                                VOID *packet_ptr,
+                                                VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+
+UINT  _nx_crypto_method_stm32_aes_gcm_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                VOID *handle, /* Crypto handler */
+                                                struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                UCHAR *key,
+                                                NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                UCHAR *input,
+                                                ULONG input_length_in_byte,
+                                                UCHAR *iv_ptr,
+                                                UCHAR *output,
+                                                ULONG output_length_in_byte,
+                                                VOID *crypto_metadata,
+                                                ULONG crypto_metadata_size,
+                                                VOID *packet_ptr,
+                                                VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+
+UINT  _nx_crypto_method_stm32_aes_ctr_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                VOID *handle, /* Crypto handler */
+                                                struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                UCHAR *key,
+                                                NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                UCHAR *input,
+                                                ULONG input_length_in_byte,
+                                                UCHAR *iv_ptr,
+                                                UCHAR *output,
+                                                ULONG output_length_in_byte,
+                                                VOID *crypto_metadata,
+                                                ULONG crypto_metadata_size,
+                                                VOID *packet_ptr,
+                                                VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+#endif /* NX_CRYPTO_STM32_HW */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   ChaCha20-Poly1305 AEAD                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  APPLICATION INTERFACE DEFINITION                       RELEASE        */
+/*                                                                        */
+/*    nx_crypto_chacha20_poly1305.h                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This file defines the basic Application Interface (API) to the      */
+/*    NetX Crypto ChaCha20-Poly1305 module, the AEAD construction of      */
+/*    RFC 8439 used by the TLS ciphersuites of RFC 7905 and RFC 8446.     */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef NX_CRYPTO_CHACHA20_POLY1305_H
+#define NX_CRYPTO_CHACHA20_POLY1305_H
+
+/* Determine if a C++ compiler is being used.  If so, ensure that standard
+   C is used to process the API information.  */
+#ifdef __cplusplus
+
+/* Yes, C++ compiler is present.  Use standard C.  */
+extern   "C" {
+
+#endif
+
+/* Include the ThreadX and port-specific data type file.  */
+
+#include "nx_crypto.h"
+
+#ifndef ULONG64_DEFINED
+#define ULONG64_DEFINED
+#define ULONG64                                  unsigned long long
+#endif /* ULONG64 */
+
+#define NX_CRYPTO_CHACHA20_KEY_LEN_IN_BITS       256
+#define NX_CRYPTO_CHACHA20_BLOCK_SIZE            64
+#define NX_CRYPTO_CHACHA20_STATE_WORDS           16
+#define NX_CRYPTO_CHACHA20_NONCE_SIZE            12
+#define NX_CRYPTO_POLY1305_BLOCK_SIZE            16
+#define NX_CRYPTO_POLY1305_TAG_SIZE              16
+
+typedef struct NX_CRYPTO_CHACHA20_POLY1305_STRUCT
+{
+
+    /* ChaCha20 input block: the constants, the key, the block counter and the nonce. */
+    UINT nx_crypto_chacha20_state[NX_CRYPTO_CHACHA20_STATE_WORDS];
+
+    /* Key stream of the current block, in bytes, and the number of its bytes already used. */
+    UCHAR nx_crypto_chacha20_key_stream[NX_CRYPTO_CHACHA20_BLOCK_SIZE];
+    UINT nx_crypto_chacha20_key_stream_used;
+
+    /* Poly1305 key r and accumulator h in 26-bit limbs, and the key s added to the tag. */
+    UINT nx_crypto_poly1305_r[5];
+    UINT nx_crypto_poly1305_h[5];
+    UINT nx_crypto_poly1305_s[4];
+
+    /* Bytes of the cipher text waiting for a full Poly1305 block. */
+    UCHAR nx_crypto_poly1305_buffer[NX_CRYPTO_POLY1305_BLOCK_SIZE];
+    UINT nx_crypto_poly1305_buffer_length;
+
+    /* Length of the cipher text authenticated so far. */
+    ULONG nx_crypto_chacha20_poly1305_text_length;
+
+    /* Pointer of additional data. */
+    VOID *nx_crypto_chacha20_poly1305_additional_data;
+
+    /* Length of additional data. */
+    UINT nx_crypto_chacha20_poly1305_additional_data_len;
+} NX_CRYPTO_CHACHA20_POLY1305;
+
+UINT _nx_crypto_chacha20_poly1305_encrypt_init(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                               VOID *additional_data, UINT additional_len,
+                                               UCHAR *iv);
+
+UINT _nx_crypto_chacha20_poly1305_encrypt_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                 UCHAR *input, UCHAR *output, UINT length);
+
+UINT _nx_crypto_chacha20_poly1305_encrypt_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                    UCHAR *output, UINT icv_len);
+
+UINT _nx_crypto_chacha20_poly1305_decrypt_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                 UCHAR *input, UCHAR *output, UINT length);
+
+UINT _nx_crypto_chacha20_poly1305_decrypt_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                    UCHAR *input, UINT icv_len);
+
+#define _nx_crypto_chacha20_poly1305_decrypt_init _nx_crypto_chacha20_poly1305_encrypt_init
+
+UINT _nx_crypto_method_chacha20_poly1305_init(struct NX_CRYPTO_METHOD_STRUCT *method,
+                                              UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                              VOID **handle,
+                                              VOID *crypto_metadata,
+                                              ULONG crypto_metadata_size);
+
+UINT _nx_crypto_method_chacha20_poly1305_cleanup(VOID *crypto_metadata);
+
+UINT _nx_crypto_method_chacha20_poly1305_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                   VOID *handle, /* Crypto handler */
+                                                   struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                   UCHAR *key,
+                                                   NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                   UCHAR *input,
+                                                   ULONG input_length_in_byte,
+                                                   UCHAR *iv_ptr,
+                                                   UCHAR *output,
+                                                   ULONG output_length_in_byte,
+                                                   VOID *crypto_metadata,
+                                                   ULONG crypto_metadata_size,
+                                                   VOID *packet_ptr,
+                                                   VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status));
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* NX_CRYPTO_CHACHA20_POLY1305_H */
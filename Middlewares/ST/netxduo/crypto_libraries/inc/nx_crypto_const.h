@@ -195,6 +195,7 @@ extern   "C" {
 #define NX_CRYPTO_EC_BRAINPOOLP256r1             0x0006001A
 #define NX_CRYPTO_EC_BRAINPOOLP384r1             0x0006001B
 #define NX_CRYPTO_EC_BRAINPOOLP512r1             0x0006001C
+#define NX_CRYPTO_EC_X25519                      0x0006001D
 #define NX_CRYPTO_EC_FFDHE2048                   0x00060100
 #define NX_CRYPTO_EC_FFDHE3072                   0x00060101
 #define NX_CRYPTO_EC_FFDHE4096                   0x00060102
@@ -242,6 +243,10 @@ extern   "C" {
 #define NX_CRYPTO_HASH_METHOD_SET                12   /* Set hash method. */
 #define NX_CRYPTO_SIGNATURE_GENERATE             13   /* Signature generation. */
 #define NX_CRYPTO_SIGNATURE_VERIFY               14   /* Signature verification. */
+#define NX_CRYPTO_SET_CRT_EXPONENT_P             15   /* Set d mod (p - 1).  This is used in software RSA implementation. */
+#define NX_CRYPTO_SET_CRT_EXPONENT_Q             16   /* Set d mod (q - 1).  This is used in software RSA implementation. */
+#define NX_CRYPTO_SET_CRT_COEFFICIENT            17   /* Set q ^ (-1) mod p.  This is used in software RSA implementation. */
+#define NX_CRYPTO_SET_PUBLIC_EXPONENT            18   /* Set the public exponent blinding the private key operations of software RSA. */
 #define NX_CRYPTO_PRF_SET_HASH                   NX_CRYPTO_HASH_METHOD_SET
 
 /* ECJPAKE operations. */
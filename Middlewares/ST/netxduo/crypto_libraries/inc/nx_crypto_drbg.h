@@ -84,6 +84,15 @@ extern   "C" {
 #define NX_CRYPTO_DRBG_MAX_SEED_LIFE    (100000)
 #endif
 
+/* Define NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN to the number of bytes _nx_crypto_drbg() generates
+   at a time and serves the following requests from, so that a small request does not pay a key
+   schedule and an update of its own. Each refill of the buffer is one generate request of the
+   reseed counter. The buffer is not used with prediction resistance, which needs fresh entropy
+   for each request. 0 disables it.  */
+#ifndef NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN
+#define NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN (0)
+#endif
+
 #ifndef NX_CRYPTO_DRBG_MUTEX_GET
 #define NX_CRYPTO_DRBG_MUTEX_GET
 #endif
@@ -130,6 +130,10 @@ typedef struct NX_CRYPTO_EC_STRUCT
     NX_CRYPTO_EC_POINT         nx_crypto_ec_g;
     NX_CRYPTO_HUGE_NUMBER      nx_crypto_ec_n;
     NX_CRYPTO_HUGE_NUMBER      nx_crypto_ec_h;
+
+    /* floor(b ^ (2 * k) / n) for the k digits of n, or no digit when n is reduced
+       by long division. */
+    NX_CRYPTO_HUGE_NUMBER      nx_crypto_ec_n_mu;
     NX_CRYPTO_EC_FIXED_POINTS *nx_crypto_ec_fixed_points;
     VOID (*nx_crypto_ec_add)(struct NX_CRYPTO_EC_STRUCT *curve,
                              NX_CRYPTO_EC_POINT *left,
@@ -147,6 +151,14 @@ typedef struct NX_CRYPTO_EC_STRUCT
     VOID (*nx_crypto_ec_reduce)(struct NX_CRYPTO_EC_STRUCT *curve,
                                 NX_CRYPTO_HUGE_NUMBER *value,
                                 HN_UBASE *scratch);
+
+    /* r = g * u1 + q * u2 with g the base point, for the ECDSA verification. */
+    VOID (*nx_crypto_ec_multiple_add)(struct NX_CRYPTO_EC_STRUCT *curve,
+                                      NX_CRYPTO_HUGE_NUMBER *u1,
+                                      NX_CRYPTO_EC_POINT *q,
+                                      NX_CRYPTO_HUGE_NUMBER *u2,
+                                      NX_CRYPTO_EC_POINT *r,
+                                      HN_UBASE *scratch);
 } NX_CRYPTO_EC;
 
 #define NX_CRYPTO_EC_POINT_INITIALIZE(p, type, buff, size)                              \
@@ -473,6 +485,19 @@ extern NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp256r1;
 extern NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp384r1;
 extern NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp521r1;
 
+/* X25519 of RFC 7748 works on 32 bit digits. Define NX_CRYPTO_DISABLE_X25519
+   to leave it out of the ECDH and of the TLS groups.  */
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32) && !defined(NX_CRYPTO_DISABLE_X25519)
+#define NX_CRYPTO_ENABLE_X25519
+#endif
+
+/* Size in bytes of the X25519 keys and of the u-coordinates. */
+#define NX_CRYPTO_EC_X25519_KEY_SIZE      32
+
+#ifdef NX_CRYPTO_ENABLE_X25519
+extern NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_x25519;
+#endif
+
 #define NX_CRYPTO_EC_GET_SECP192R1(curve) curve = (NX_CRYPTO_EC *)&_nx_crypto_ec_secp192r1
 #define NX_CRYPTO_EC_GET_SECP224R1(curve) curve = (NX_CRYPTO_EC *)&_nx_crypto_ec_secp224r1
 #define NX_CRYPTO_EC_GET_SECP256R1(curve) curve = (NX_CRYPTO_EC *)&_nx_crypto_ec_secp256r1
@@ -532,6 +557,33 @@ VOID _nx_crypto_ec_fp_fixed_multiple(NX_CRYPTO_EC *curve,
                                      NX_CRYPTO_HUGE_NUMBER *d,
                                      NX_CRYPTO_EC_POINT *r,
                                      HN_UBASE *scratch);
+VOID _nx_crypto_ec_fp_multiple_add(NX_CRYPTO_EC *curve,
+                                   NX_CRYPTO_HUGE_NUMBER *u1,
+                                   NX_CRYPTO_EC_POINT *q,
+                                   NX_CRYPTO_HUGE_NUMBER *u2,
+                                   NX_CRYPTO_EC_POINT *r,
+                                   HN_UBASE *scratch);
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32)
+VOID _nx_crypto_ec_secp256r1_multiple(NX_CRYPTO_EC *curve,
+                                      NX_CRYPTO_EC_POINT *g,
+                                      NX_CRYPTO_HUGE_NUMBER *d,
+                                      NX_CRYPTO_EC_POINT *r,
+                                      HN_UBASE *scratch);
+VOID _nx_crypto_ec_secp256r1_multiple_add(NX_CRYPTO_EC *curve,
+                                          NX_CRYPTO_HUGE_NUMBER *u1,
+                                          NX_CRYPTO_EC_POINT *q,
+                                          NX_CRYPTO_HUGE_NUMBER *u2,
+                                          NX_CRYPTO_EC_POINT *r,
+                                          HN_UBASE *scratch);
+#endif
+#ifdef NX_CRYPTO_ENABLE_X25519
+VOID _nx_crypto_ec_x25519_scalar_multiply(UCHAR *r, const UCHAR *k, const UCHAR *u, HN_UBASE *scratch);
+VOID _nx_crypto_ec_x25519_multiple(NX_CRYPTO_EC *curve,
+                                   NX_CRYPTO_EC_POINT *g,
+                                   NX_CRYPTO_HUGE_NUMBER *d,
+                                   NX_CRYPTO_EC_POINT *r,
+                                   HN_UBASE *scratch);
+#endif
 
 VOID _nx_crypto_ec_naf_compute(NX_CRYPTO_HUGE_NUMBER *d, HN_UBASE *naf_data, UINT *naf_size);
 VOID _nx_crypto_ec_add_digit_reduce(NX_CRYPTO_EC *curve,
@@ -626,6 +678,18 @@ UINT _nx_crypto_method_ec_secp521r1_operation(UINT op,
                                               VOID *crypto_metadata, ULONG crypto_metadata_size,
                                               VOID *packet_ptr,
                                               VOID (*nx_crypto_hw_process_callback)(VOID *, UINT));
+#ifdef NX_CRYPTO_ENABLE_X25519
+UINT _nx_crypto_method_ec_x25519_operation(UINT op,
+                                           VOID *handle,
+                                           struct NX_CRYPTO_METHOD_STRUCT *method,
+                                           UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                           UCHAR *input, ULONG input_length_in_byte,
+                                           UCHAR *iv_ptr,
+                                           UCHAR *output, ULONG output_length_in_byte,
+                                           VOID *crypto_metadata, ULONG crypto_metadata_size,
+                                           VOID *packet_ptr,
+                                           VOID (*nx_crypto_hw_process_callback)(VOID *, UINT));
+#endif
 #ifdef __cplusplus
 }
 #endif
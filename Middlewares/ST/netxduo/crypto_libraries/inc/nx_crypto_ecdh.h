@@ -114,6 +114,23 @@ UINT _nx_crypto_ecdh_compute_secret(NX_CRYPTO_ECDH  *ecdh_ptr,
                                     ULONG   remote_public_key_len,
                                     HN_UBASE *scratch_buf_ptr);
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+UINT _nx_crypto_ecdh_setup_x25519(NX_CRYPTO_ECDH  *ecdh_ptr,
+                                  UCHAR  *local_public_key_ptr,
+                                  ULONG   local_public_key_len,
+                                  ULONG  *actual_local_public_key_len,
+                                  NX_CRYPTO_EC *curve,
+                                  HN_UBASE *scratch_buf_ptr);
+
+UINT _nx_crypto_ecdh_compute_secret_x25519(NX_CRYPTO_ECDH  *ecdh_ptr,
+                                           UCHAR  *share_secret_key_ptr,
+                                           ULONG   share_secret_key_len_ptr,
+                                           ULONG  *actual_share_secret_key_len,
+                                           UCHAR  *remote_public_key,
+                                           ULONG   remote_public_key_len,
+                                           HN_UBASE *scratch_buf_ptr);
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
 UINT _nx_crypto_method_ecdh_init(struct  NX_CRYPTO_METHOD_STRUCT *method,
                                  UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
                                  VOID  **handle,
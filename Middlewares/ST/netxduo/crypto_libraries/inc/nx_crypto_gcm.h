@@ -68,6 +68,18 @@ extern   "C" {
 #define NX_CRYPTO_GCM_BLOCK_SIZE_INT 4
 #define NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT 4
 
+/* Define NX_CRYPTO_GCM_TABLE_BITS as 8 to multiply by the hash key one byte at a time
+   with a table of 4 KB per key, instead of one nibble at a time with a table of 256 bytes.  */
+#ifndef NX_CRYPTO_GCM_TABLE_BITS
+#define NX_CRYPTO_GCM_TABLE_BITS 4
+#endif
+
+#if (NX_CRYPTO_GCM_TABLE_BITS != 4) && (NX_CRYPTO_GCM_TABLE_BITS != 8)
+#error "NX_CRYPTO_GCM_TABLE_BITS supports 4 and 8 only!"
+#endif
+
+#define NX_CRYPTO_GCM_TABLE_SIZE (1 << NX_CRYPTO_GCM_TABLE_BITS)
+
 typedef struct NX_CRYPTO_GCM_STRUCT
 {
 
@@ -80,6 +92,12 @@ typedef struct NX_CRYPTO_GCM_STRUCT
     UCHAR nx_crypto_gcm_s[NX_CRYPTO_GCM_BLOCK_SIZE];
     UCHAR nx_crypto_gcm_counter[NX_CRYPTO_GCM_BLOCK_SIZE];
 
+    /* Products of the hash key by each value of NX_CRYPTO_GCM_TABLE_BITS bits, in big endian words. */
+    UINT nx_crypto_gcm_htable[NX_CRYPTO_GCM_TABLE_SIZE][NX_CRYPTO_GCM_BLOCK_SIZE_INT];
+
+    /* Set when the hash key and its table are computed for the current key. */
+    UINT nx_crypto_gcm_hkey_ready;
+
     /* Pointer of additional data. */
     VOID *nx_crypto_gcm_additional_data;
 
@@ -87,6 +105,9 @@ typedef struct NX_CRYPTO_GCM_STRUCT
     UINT nx_crypto_gcm_additional_data_len;
 } NX_CRYPTO_GCM;
 
+NX_CRYPTO_KEEP UINT _nx_crypto_gcm_key_set(VOID *crypto_metadata, NX_CRYPTO_GCM *gcm_metadata,
+                                           UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT));
+
 NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_init(VOID *crypto_metadata, NX_CRYPTO_GCM *gcm_metadata,
                                                 UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT),
                                                 VOID *additional_data, UINT additional_len,
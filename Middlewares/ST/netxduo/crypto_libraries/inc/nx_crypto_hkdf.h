@@ -68,6 +68,28 @@ extern   "C" {
 #include "nx_crypto.h"
 #include "nx_crypto_sha2.h"
 #include "nx_crypto_hmac_sha5.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
+
+/* Define the size of the hash metadata in the HMAC workspace, that of the largest hash,
+   SHA-512 or with NX_CRYPTO_STM32_HW the hardware hash.  */
+#ifdef NX_CRYPTO_STM32_HW
+#define NX_CRYPTO_HKDF_HASH_METADATA_SIZE  ((sizeof(NX_CRYPTO_STM32_HASH) > sizeof(NX_CRYPTO_SHA512)) ? \
+                                            sizeof(NX_CRYPTO_STM32_HASH) : sizeof(NX_CRYPTO_SHA512))
+#else
+#define NX_CRYPTO_HKDF_HASH_METADATA_SIZE  sizeof(NX_CRYPTO_SHA512)
+#endif /* NX_CRYPTO_STM32_HW */
+
+/* Define the size of each keyed HMAC state HKDF-expand keeps for its PRK. A hash with a
+   larger metadata, by default any but SHA-256, runs a full HMAC for each block instead.  */
+#ifndef NX_CRYPTO_HKDF_KEYED_METADATA_SIZE
+#ifdef NX_CRYPTO_STM32_HW
+#define NX_CRYPTO_HKDF_KEYED_METADATA_SIZE sizeof(NX_CRYPTO_STM32_HASH)
+#else
+#define NX_CRYPTO_HKDF_KEYED_METADATA_SIZE sizeof(NX_CRYPTO_SHA256)
+#endif /* NX_CRYPTO_STM32_HW */
+#endif /* NX_CRYPTO_HKDF_KEYED_METADATA_SIZE */
 
 typedef struct NX_CRYPTO_HKDF_STRUCT
 {
@@ -101,11 +123,19 @@ typedef struct NX_CRYPTO_HKDF_STRUCT
     UCHAR nx_crypto_hkdf_temp_T[120];
 
     /* Workspace for the HMAC operations. */
-    UCHAR nx_crypto_hmac_metadata[sizeof(NX_CRYPTO_SHA512_HMAC)];
+    UCHAR nx_crypto_hmac_metadata[sizeof(NX_CRYPTO_HMAC) + NX_CRYPTO_HKDF_HASH_METADATA_SIZE];
 
     /* Output from HMAC operations. */
     UCHAR *nx_crypto_hmac_output;
     UINT nx_crypto_hmac_output_size;
+
+    /* Hash states past the PRK XORed with ipad and with opad, computed by the first
+     * HKDF-expand after the PRK is set and restored for every block of the next ones. */
+    UCHAR nx_crypto_hkdf_inner_metadata[NX_CRYPTO_HKDF_KEYED_METADATA_SIZE];
+    UCHAR nx_crypto_hkdf_outer_metadata[NX_CRYPTO_HKDF_KEYED_METADATA_SIZE];
+
+    /* The hash method of the states above, NX_CRYPTO_NULL until they are computed. */
+    NX_CRYPTO_METHOD *nx_crypto_hkdf_keyed_hash_method;
 } NX_CRYPTO_HKDF;
 
 extern NX_CRYPTO_METHOD crypto_method_hmac_md5;
@@ -116,6 +146,8 @@ extern NX_CRYPTO_METHOD crypto_method_hmac_sha512;
 
 UINT _nx_crypto_hkdf_extract(NX_CRYPTO_HKDF *hkdf);
 UINT _nx_crypto_hkdf_expand(NX_CRYPTO_HKDF *hkdf, UCHAR *output, UINT desired_length);
+UINT _nx_crypto_hkdf_keyed_init(NX_CRYPTO_HKDF *hkdf);
+UINT _nx_crypto_hkdf_keyed_hmac(NX_CRYPTO_HKDF *hkdf, UCHAR *input, UINT input_length, UCHAR *output);
 
 /* Define the function prototypes for HKDF.  */
 
@@ -74,17 +74,46 @@ extern   "C" {
 #define NX_CRYPTO_HMAC_SHA224_ICV_FULL_LEN_IN_BITS NX_CRYPTO_SHA224_ICV_LEN_IN_BITS
 #define NX_CRYPTO_HMAC_SHA256_ICV_FULL_LEN_IN_BITS NX_CRYPTO_SHA256_ICV_LEN_IN_BITS
 
+/* Define the number of keys whose padded key states are kept in the metadata. TLS uses
+   one MAC key per direction, so two entries let the sent and received records alternate
+   without recomputing the pads. */
+#ifndef NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE
+#define NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE       2
+#endif
+
 /* Define the control block structure for backward compatibility. */
 #define NX_SHA256_HMAC                          NX_CRYPTO_SHA256_HMAC
 
+/* One key cache entry: the key and the SHA256 states after hashing the key XOR ipad
+   and the key XOR opad blocks. A key length of 0 marks a free entry. */
+typedef struct NX_CRYPTO_SHA256_HMAC_KEY_CACHE_STRUCT
+{
+    UCHAR               nx_sha256_hmac_key[NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES];
+    UINT                nx_sha256_hmac_key_length;
+    UINT                nx_sha256_hmac_algorithm;
+    ULONG               nx_sha256_hmac_inner_states[8];
+    ULONG               nx_sha256_hmac_outer_states[8];
+} NX_CRYPTO_SHA256_HMAC_KEY_CACHE;
+
 typedef struct NX_CRYPTO_SHA256_HMAC_STRUCT
 {
     NX_CRYPTO_SHA256    nx_sha256_hmac_context;
     NX_CRYPTO_HMAC      nx_sha256_hmac_metadata;
+
+    /* Padded key states of the recently used keys, the entry of the current key
+       (NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE if the key is not cached) and the entry
+       replaced next. */
+    NX_CRYPTO_SHA256_HMAC_KEY_CACHE nx_sha256_hmac_key_cache[NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE];
+    UINT                nx_sha256_hmac_key_cache_current;
+    UINT                nx_sha256_hmac_key_cache_next;
 } NX_CRYPTO_SHA256_HMAC;
 
 /* Define the function prototypes for HMAC SHA256.  */
 
+UINT _nx_crypto_hmac_sha256_initialize(NX_CRYPTO_SHA256_HMAC *ctx, UINT algorithm, UCHAR *key_ptr, UINT key_length);
+
+UINT _nx_crypto_hmac_sha256_digest_calculate(NX_CRYPTO_SHA256_HMAC *ctx, UINT algorithm, UCHAR *digest_ptr, UINT digest_length);
+
 UINT _nx_crypto_method_hmac_sha256_init(struct  NX_CRYPTO_METHOD_STRUCT *method,
                                         UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
                                         VOID  **handle,
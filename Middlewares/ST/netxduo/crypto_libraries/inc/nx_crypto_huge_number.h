@@ -110,6 +110,37 @@ extern   "C" {
 #error "NX_CRYPTO_HUGE_NUMBER_BITS supports 16 and 32 only!"
 #endif
 
+/* Define the window size, in bits, of the exponentiation in
+ * _nx_crypto_huge_number_mont_power_modulus. A window of w bits keeps
+ * 2 ^ (w - 1) odd powers of the base and needs one more buffer of the
+ * modulus size in the scratch area for each power above the first.
+ * Only 1 to 4 are supported. */
+#ifndef NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS    2
+#endif /* NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS */
+
+#if (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS < 1) || (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS > 4)
+#error "NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS supports 1 to 4 only!"
+#endif
+
+/* Number of the odd powers kept by the exponentiation window. */
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_TABLE_SIZE    (1 << (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS - 1))
+
+/* Multiply and accumulate one digit: (carry, digit) = a * b + digit + carry.
+   The result always fits in two digits. With the DSP extension of the
+   Cortex-M4 this is the single UMAAL instruction. */
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32) && defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+#define HN_MULTIPLY_ACCUMULATE(digit, carry, a, b)                         \
+    __asm__ ("umaal %0, %1, %2, %3" : "+r" (digit), "+r" (carry) : "r" (a), "r" (b))
+#else
+#define HN_MULTIPLY_ACCUMULATE(digit, carry, a, b)                         \
+    {                                                                      \
+        HN_UBASE2 hn_product = (HN_UBASE2)(a) * (b) + (digit) + (carry);   \
+        (digit) = (HN_UBASE)(hn_product & HN_MASK);                        \
+        (carry) = (HN_UBASE)(hn_product >> HN_SHIFT);                      \
+    }
+#endif
+
 
 /* Huge number structure - contains data pointer and size. */
 typedef struct NX_CRYPTO_HUGE_NUMBER_STRUCT
@@ -194,6 +225,8 @@ VOID _nx_crypto_huge_number_multiply_digit(NX_CRYPTO_HUGE_NUMBER *value,
                                            NX_CRYPTO_HUGE_NUMBER *result);
 VOID _nx_crypto_huge_number_square(NX_CRYPTO_HUGE_NUMBER *value, NX_CRYPTO_HUGE_NUMBER *result);
 VOID _nx_crypto_huge_number_modulus(NX_CRYPTO_HUGE_NUMBER *dividend, NX_CRYPTO_HUGE_NUMBER *divisor);
+VOID _nx_crypto_huge_number_barrett_reduce(NX_CRYPTO_HUGE_NUMBER *x, NX_CRYPTO_HUGE_NUMBER *m,
+                                           NX_CRYPTO_HUGE_NUMBER *mu, HN_UBASE *scratch);
 VOID _nx_crypto_huge_number_shift_left(NX_CRYPTO_HUGE_NUMBER *x, UINT shift);
 VOID _nx_crypto_huge_number_shift_right(NX_CRYPTO_HUGE_NUMBER *x, UINT shift);
 UINT _nx_crypto_huge_number_inverse_modulus_prime(NX_CRYPTO_HUGE_NUMBER *a,
@@ -208,6 +241,10 @@ VOID _nx_crypto_huge_number_mont(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
                                  NX_CRYPTO_HUGE_NUMBER *x,
                                  NX_CRYPTO_HUGE_NUMBER *y,
                                  NX_CRYPTO_HUGE_NUMBER *result);
+VOID _nx_crypto_huge_number_mont_square(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
+                                        NX_CRYPTO_HUGE_NUMBER *x,
+                                        NX_CRYPTO_HUGE_NUMBER *work,
+                                        NX_CRYPTO_HUGE_NUMBER *result);
 VOID _nx_crypto_huge_number_power_modulus(NX_CRYPTO_HUGE_NUMBER *number,
                                           NX_CRYPTO_HUGE_NUMBER *exponent,
                                           NX_CRYPTO_HUGE_NUMBER *modulus,
@@ -218,6 +255,15 @@ VOID _nx_crypto_huge_number_mont_power_modulus(NX_CRYPTO_HUGE_NUMBER *x,
                                                NX_CRYPTO_HUGE_NUMBER *m,
                                                NX_CRYPTO_HUGE_NUMBER *result,
                                                HN_UBASE *scratch);
+VOID _nx_crypto_huge_number_mont_setup(NX_CRYPTO_HUGE_NUMBER *m, UINT *mi,
+                                       NX_CRYPTO_HUGE_NUMBER *rr, HN_UBASE *scratch);
+VOID _nx_crypto_huge_number_mont_power_precomputed(NX_CRYPTO_HUGE_NUMBER *x,
+                                                   NX_CRYPTO_HUGE_NUMBER *e,
+                                                   NX_CRYPTO_HUGE_NUMBER *m,
+                                                   UINT mi,
+                                                   NX_CRYPTO_HUGE_NUMBER *rr,
+                                                   NX_CRYPTO_HUGE_NUMBER *result,
+                                                   HN_UBASE *scratch);
 VOID _nx_crypto_huge_number_crt_power_modulus(NX_CRYPTO_HUGE_NUMBER *x,
                                               NX_CRYPTO_HUGE_NUMBER *e,
                                               NX_CRYPTO_HUGE_NUMBER *p,
@@ -225,6 +271,19 @@ VOID _nx_crypto_huge_number_crt_power_modulus(NX_CRYPTO_HUGE_NUMBER *x,
                                               NX_CRYPTO_HUGE_NUMBER *m,
                                               NX_CRYPTO_HUGE_NUMBER *result,
                                               HN_UBASE *scratch);
+VOID _nx_crypto_huge_number_mont_power_fixed_window(NX_CRYPTO_HUGE_NUMBER *x,
+                                                    NX_CRYPTO_HUGE_NUMBER *e,
+                                                    NX_CRYPTO_HUGE_NUMBER *m,
+                                                    NX_CRYPTO_HUGE_NUMBER *result,
+                                                    HN_UBASE *scratch);
+VOID _nx_crypto_huge_number_crt_power_precomputed(NX_CRYPTO_HUGE_NUMBER *x,
+                                                  NX_CRYPTO_HUGE_NUMBER *dp,
+                                                  NX_CRYPTO_HUGE_NUMBER *dq,
+                                                  NX_CRYPTO_HUGE_NUMBER *qinv,
+                                                  NX_CRYPTO_HUGE_NUMBER *p,
+                                                  NX_CRYPTO_HUGE_NUMBER *q,
+                                                  NX_CRYPTO_HUGE_NUMBER *result,
+                                                  HN_UBASE *scratch);
 
 
 #ifdef __cplusplus
@@ -61,6 +61,7 @@ extern   "C" {
 /* Include the ThreadX and port-specific data type file.  */
 
 #include "nx_crypto.h"
+#include "nx_crypto_huge_number.h"
 
 /* Define the maximum size of an RSA modulus supported in bits. */
 #ifndef NX_CRYPTO_MAX_RSA_MODULUS_SIZE
@@ -70,8 +71,63 @@ extern   "C" {
 
 /* Scratch buffer for RSA calculations.
     Size must be no less than 10 * sizeof(modulus) + 24. 2584 bytes for 2048 bits cryption.
-    If CRT algorithm is not used, size must be no less than (7 * sizeof(modulus) + 8). 1800 bytes for 2048 bits cryption. */
-#define NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE (((10 * (NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8)) + 24) / sizeof(USHORT))
+    If CRT algorithm is not used, size must be no less than (7 * sizeof(modulus) + 8). 1800 bytes for 2048 bits cryption.
+    Each odd power of the exponentiation window above the first (see NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS)
+    adds sizeof(modulus) + 4. The CRT operation with d mod (p - 1), d mod (q - 1) and q ^ (-1) mod p
+    fits in the same size. */
+#define NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE (((10 * (NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8)) + 24 +                  \
+                                            ((NX_CRYPTO_HUGE_NUMBER_WINDOW_TABLE_SIZE - 1) *                    \
+                                             ((NX_CRYPTO_MAX_RSA_MODULUS_SIZE / 8) + 4))) / sizeof(USHORT))
+
+/* Define the number of public moduli whose Montgomery constants are kept across RSA operations,
+   so that the operations with a key verified again, such as the key of a trusted CA, skip their
+   computation. 0 computes them on each operation. The CRT operations of private keys are not cached. */
+#ifndef NX_CRYPTO_RSA_MONT_CACHE_SIZE
+#define NX_CRYPTO_RSA_MONT_CACHE_SIZE          0
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE */
+
+/* Define the largest modulus, in bits, whose Montgomery constants are cached. Each entry keeps a copy
+   of the modulus and radix ^ (2 * m_len) mod m, twice this size in bytes over 8. */
+#ifndef NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE
+#define NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE  (2048)
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE */
+
+#if NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0
+
+/* The cache is shared by the threads doing RSA operations, it is looked up and updated with
+   interrupts disabled, for the copy of a modulus and its constant at most. */
+#ifndef NX_CRYPTO_STANDALONE_ENABLE
+#define NX_CRYPTO_RSA_MONT_CACHE_SAVE_AREA     TX_INTERRUPT_SAVE_AREA
+#define NX_CRYPTO_RSA_MONT_CACHE_LOCK          TX_DISABLE
+#define NX_CRYPTO_RSA_MONT_CACHE_UNLOCK        TX_RESTORE
+#else
+#define NX_CRYPTO_RSA_MONT_CACHE_SAVE_AREA
+#define NX_CRYPTO_RSA_MONT_CACHE_LOCK
+#define NX_CRYPTO_RSA_MONT_CACHE_UNLOCK
+#endif /* NX_CRYPTO_STANDALONE_ENABLE */
+
+/* Montgomery constants of a public modulus. */
+typedef struct NX_CRYPTO_RSA_MONT_CACHE_ENTRY_STRUCT
+{
+    /* Number of digits of the modulus, 0 when the entry is free. */
+    UINT nx_crypto_rsa_mont_cache_modulus_size;
+
+    /* Number of digits of rr. */
+    UINT nx_crypto_rsa_mont_cache_rr_size;
+
+    /* mi = -m ^ (-1) mod radix */
+    UINT nx_crypto_rsa_mont_cache_mi;
+
+    /* Use count of the cache when the entry was last used. */
+    UINT nx_crypto_rsa_mont_cache_last_used;
+
+    /* Digits of the modulus. */
+    HN_UBASE nx_crypto_rsa_mont_cache_modulus[NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE / NX_CRYPTO_HUGE_NUMBER_BITS];
+
+    /* rr = radix ^ (2 * m_len) mod m */
+    HN_UBASE nx_crypto_rsa_mont_cache_rr[NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE / NX_CRYPTO_HUGE_NUMBER_BITS];
+} NX_CRYPTO_RSA_MONT_CACHE_ENTRY;
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0 */
 
 /* Control block for RSA cryptographic operations. */
 typedef struct NX_CRYPTO_RSA_STRUCT
@@ -94,6 +150,30 @@ typedef struct NX_CRYPTO_RSA_STRUCT
     /* Length of prime q in bytes. */
     UINT nx_crypto_rsa_prime_q_length;
 
+    /* Pointer to d mod (p - 1). */
+    UCHAR *nx_crypto_rsa_crt_exponent_p;
+
+    /* Length of d mod (p - 1) in bytes. */
+    UINT nx_crypto_rsa_crt_exponent_p_length;
+
+    /* Pointer to d mod (q - 1). */
+    UCHAR *nx_crypto_rsa_crt_exponent_q;
+
+    /* Length of d mod (q - 1) in bytes. */
+    UINT nx_crypto_rsa_crt_exponent_q_length;
+
+    /* Pointer to q ^ (-1) mod p. */
+    UCHAR *nx_crypto_rsa_crt_coefficient;
+
+    /* Length of q ^ (-1) mod p in bytes. */
+    UINT nx_crypto_rsa_crt_coefficient_length;
+
+    /* Pointer to the public exponent, which blinds the input of the CRT operation. */
+    UCHAR *nx_crypto_rsa_public_exponent;
+
+    /* Length of the public exponent in bytes. */
+    UINT nx_crypto_rsa_public_exponent_length;
+
     /* Scratch buffer for RSA calculations. */
     USHORT nx_crypto_rsa_scratch_buffer[NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE];
 } NX_CRYPTO_RSA;
@@ -106,6 +186,9 @@ UINT _nx_crypto_rsa_operation(const UCHAR *exponent, UINT exponent_length, const
                               const UCHAR *input, UINT input_length, UCHAR *output,
                               USHORT *scratch_buf_ptr, UINT scratch_buf_length);
 
+UINT _nx_crypto_rsa_crt_operation(NX_CRYPTO_RSA *ctx, const UCHAR *exponent, UINT exponent_length,
+                                  const UCHAR *input, UINT input_length, UCHAR *output);
+
 UINT _nx_crypto_method_rsa_cleanup(VOID *crypto_metadata);
 
 UINT _nx_crypto_method_rsa_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
@@ -86,7 +86,8 @@ typedef struct NX_CRYPTO_SHA256_STRUCT
                                                         /*   where partial buffers are              */
                                                         /*   accumulated until a full block         */
                                                         /*   can be processed.                      */
-    ULONG nx_sha256_word_array[64];                     /* Working 64 word array.                   */
+    ULONG nx_sha256_word_array[16];                     /* Working 16 word array, the rolling       */
+                                                        /*   message schedule.                      */
 } NX_CRYPTO_SHA256;
 
 
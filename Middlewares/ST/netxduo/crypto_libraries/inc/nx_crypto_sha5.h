@@ -98,7 +98,8 @@ typedef struct NX_CRYPTO_SHA512_STRUCT
                                                         /*   where partial buffers are              */
                                                         /*   accumulated until a full block         */
                                                         /*   can be processed.                      */
-    ULONG64 nx_sha512_word_array[128];                  /* Working 64 word array.                   */
+    ULONG64 nx_sha512_word_array[16];                   /* Working 16 word array, the rolling       */
+                                                        /*   message schedule.                      */
 } NX_CRYPTO_SHA512;
 
 
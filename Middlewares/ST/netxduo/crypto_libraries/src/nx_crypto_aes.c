@@ -25,6 +25,9 @@
 
 #include "nx_crypto_aes.h"
 #include "nx_crypto_xcbc_mac.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
 
 #if !defined(NX_CRYPTO_LITTLE_ENDIAN)
 /*
@@ -396,6 +399,24 @@ NX_CRYPTO_AES_TABLE UCHAR aes_rcon_array[] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20
 
 #endif
 
+/* Load and store a word of the state from and to bytes in memory at any alignment.  */
+#ifdef NX_CRYPTO_ENABLE_UNALIGNED_ACCESS
+#define NX_CRYPTO_AES_LOAD_WORD(ptr)       (*(UINT *)(ptr))
+#define NX_CRYPTO_AES_STORE_WORD(ptr, val) (*(UINT *)(ptr) = (val))
+#else
+#define NX_CRYPTO_AES_LOAD_WORD(ptr)       (SET_MSB_BYTE((UINT)(ptr)[0]) | SET_2ND_BYTE((UINT)(ptr)[1]) | \
+                                            SET_3RD_BYTE((UINT)(ptr)[2]) | SET_LSB_BYTE((UINT)(ptr)[3]))
+#define NX_CRYPTO_AES_STORE_WORD(ptr, val)                          \
+    do                                                              \
+    {                                                               \
+    UINT nx_crypto_aes_word = (val);                                \
+        (ptr)[0] = (UCHAR)EXTRACT_MSB_BYTE(nx_crypto_aes_word);     \
+        (ptr)[1] = (UCHAR)EXTRACT_2ND_BYTE(nx_crypto_aes_word);     \
+        (ptr)[2] = (UCHAR)EXTRACT_3RD_BYTE(nx_crypto_aes_word);     \
+        (ptr)[3] = (UCHAR)EXTRACT_LSB_BYTE(nx_crypto_aes_word);     \
+    } while (0)
+#endif /* NX_CRYPTO_ENABLE_UNALIGNED_ACCESS */
+
 #ifdef NX_CRYPTO_SELF_TEST
 extern UINT _nx_crypto_library_state;
 #endif /* NX_CRYPTO_SELF_TEST */
@@ -471,24 +492,28 @@ UINT i;
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nx_crypto_aes_sub_shift_roundkey                   PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
-/*                                                                        */
-/*    Timothy Stapko, Microsoft Corporation                               */
+/*    _nx_crypto_aes_encrypt_block                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function combines the following operations:                    */
-/*       SubBytes(state)                                                  */
-/*       Shiftrows(state)                                                 */
-/*       AddRoundKey(state, w[Nr*Nb, (Nr+1)*Nb-1])                        */
-/*    Refer to Figure 5 on page 15 of the AES Specification (Pub 197)     */
+/*    This function encrypts one block held in four words, in the byte    */
+/*    order of the state. It performs the whole Cipher() of the AES       */
+/*    specification (Pub 197) with the rounds fully unrolled and the      */
+/*    state in local variables: each round combines SubBytes, ShiftRows,  */
+/*    MixColumns and AddRoundKey with one lookup table, picking up the    */
+/*    bytes from their position before ShiftRows as shown below, and the  */
+/*    last round uses the S-box.                                          */
+/*                                                                        */
+/*       S00    S04    S08    S12          S00    S04    S08    S12       */
+/*       S01    S05    S09    S13   --->   S05    S09    S13    S01       */
+/*       S02    S06    S10    S14          S10    S14    S02    S06       */
+/*       S03    S07    S11    S15          S15    S03    S07    S11       */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    aes_ptr                               Pointer to AES control block  */
-/*    round_key                             Pointer to round key          */
+/*    w                                     Pointer to key schedule       */
+/*    num_rounds                            Number of rounds, 10, 12 or 14*/
+/*    block                                 Block to encrypt in place     */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -501,61 +526,80 @@ UINT i;
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    _nx_crypto_aes_encrypt                Perform AES mode encryption   */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
-/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_crypto_aes_ctr_encrypt_blocks     Encrypt blocks in counter mode*/
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP static VOID _nx_crypto_aes_sub_shift_roundkey(NX_CRYPTO_AES *aes_ptr, UINT *round_key)
+#define NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, round_key)                   \
+    t0 = aes_encryption_table[EXTRACT_MSB_BYTE(s0)] ^                                           \
+         (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(s1)])) ^                          \
+         (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(s2)])) ^                          \
+         (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(s3)])) ^ (round_key)[0];           \
+    t1 = aes_encryption_table[EXTRACT_MSB_BYTE(s1)] ^                                           \
+         (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(s2)])) ^                          \
+         (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(s3)])) ^                          \
+         (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(s0)])) ^ (round_key)[1];           \
+    t2 = aes_encryption_table[EXTRACT_MSB_BYTE(s2)] ^                                           \
+         (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(s3)])) ^                          \
+         (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(s0)])) ^                          \
+         (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(s1)])) ^ (round_key)[2];           \
+    t3 = aes_encryption_table[EXTRACT_MSB_BYTE(s3)] ^                                           \
+         (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(s0)])) ^                          \
+         (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(s1)])) ^                          \
+         (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(s2)])) ^ (round_key)[3];
+
+#define NX_CRYPTO_AES_ENCRYPT_LAST_ROUND(s0, s1, s2, s3, round_key)                              \
+    ((SET_MSB_BYTE(sub_bytes_sbox[EXTRACT_MSB_BYTE(s0)])) |                                     \
+     (SET_2ND_BYTE(sub_bytes_sbox[EXTRACT_2ND_BYTE(s1)])) |                                     \
+     (SET_3RD_BYTE(sub_bytes_sbox[EXTRACT_3RD_BYTE(s2)])) |                                     \
+     (SET_LSB_BYTE(sub_bytes_sbox[EXTRACT_LSB_BYTE(s3)]))) ^ (round_key)
+
+NX_CRYPTO_KEEP static VOID _nx_crypto_aes_encrypt_block(UINT *w, UINT num_rounds, UINT *block)
 {
-/*
-   S00    S04    S08    S12          S00    S04    S08    S12
-
-   S01    S05    S09    S13          S05    S09    S13    S01
-                              --->
-   S02    S06    S10    S14          S10    S14    S02    S06
-
-   S03    S07    S11    S15          S15    S03    S07    S11
- */
-
-
-UINT   S0, S1, S2, S3;
-UCHAR *S;
-
-    S = (UCHAR *)aes_ptr -> nx_crypto_aes_state;
-
-    S0 = ((SET_MSB_BYTE(sub_bytes_sbox[S[0]])) |
-          (SET_2ND_BYTE(sub_bytes_sbox[S[5]])) |
-          (SET_3RD_BYTE(sub_bytes_sbox[S[10]])) |
-          (SET_LSB_BYTE(sub_bytes_sbox[S[15]]))) ^ round_key[0];
+UINT s0, s1, s2, s3;
+UINT t0, t1, t2, t3;
+
+    s0 = block[0] ^ w[0];
+    s1 = block[1] ^ w[1];
+    s2 = block[2] ^ w[2];
+    s3 = block[3] ^ w[3];
+
+    /* Rounds 1 to 9, common to all the key sizes.  */
+    NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[4]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[8]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[12]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[16]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[20]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[24]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[28]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[32]);
+    NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[36]);
+
+    if (num_rounds > 10)
+    {
 
-    S1 = ((SET_MSB_BYTE(sub_bytes_sbox[S[4]])) |
-          (SET_2ND_BYTE(sub_bytes_sbox[S[9]])) |
-          (SET_3RD_BYTE(sub_bytes_sbox[S[14]])) |
-          (SET_LSB_BYTE(sub_bytes_sbox[S[03]]))) ^ round_key[1];
+        /* Rounds 10 and 11 of 192-bit and 256-bit keys.  */
+        NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[40]);
+        NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[44]);
 
-    S2 = ((SET_MSB_BYTE(sub_bytes_sbox[S[8]])) |
-          (SET_2ND_BYTE(sub_bytes_sbox[S[13]])) |
-          (SET_3RD_BYTE(sub_bytes_sbox[S[02]])) |
-          (SET_LSB_BYTE(sub_bytes_sbox[S[07]]))) ^ round_key[2];
+        if (num_rounds > 12)
+        {
 
-    S3 = ((SET_MSB_BYTE(sub_bytes_sbox[S[12]])) |
-          (SET_2ND_BYTE(sub_bytes_sbox[S[1]])) |
-          (SET_3RD_BYTE(sub_bytes_sbox[S[06]])) |
-          (SET_LSB_BYTE(sub_bytes_sbox[S[11]]))) ^ round_key[3];
+            /* Rounds 12 and 13 of 256-bit keys.  */
+            NX_CRYPTO_AES_ENCRYPT_ROUND(s0, s1, s2, s3, t0, t1, t2, t3, &w[48]);
+            NX_CRYPTO_AES_ENCRYPT_ROUND(t0, t1, t2, t3, s0, s1, s2, s3, &w[52]);
+        }
+    }
 
-    aes_ptr -> nx_crypto_aes_state[0] = S0;
-    aes_ptr -> nx_crypto_aes_state[1] = S1;
-    aes_ptr -> nx_crypto_aes_state[2] = S2;
-    aes_ptr -> nx_crypto_aes_state[3] = S3;
+    /* Last round, without MixColumns.  */
+    w += num_rounds * 4;
+    block[0] = NX_CRYPTO_AES_ENCRYPT_LAST_ROUND(t0, t1, t2, t3, w[0]);
+    block[1] = NX_CRYPTO_AES_ENCRYPT_LAST_ROUND(t1, t2, t3, t0, w[1]);
+    block[2] = NX_CRYPTO_AES_ENCRYPT_LAST_ROUND(t2, t3, t0, t1, w[2]);
+    block[3] = NX_CRYPTO_AES_ENCRYPT_LAST_ROUND(t3, t0, t1, t2, w[3]);
 
 #ifdef NX_SECURE_KEY_CLEAR
-    S0 = 0; S1 = 0; S2 = 0; S3 = 0;
+    s0 = 0; s1 = 0; s2 = 0; s3 = 0;
+    t0 = 0; t1 = 0; t2 = 0; t3 = 0;
 #endif /* NX_SECURE_KEY_CLEAR  */
 }
 
@@ -672,189 +716,6 @@ UCHAR *S;
  */
 
 
-/**************************************************************************/
-/*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_crypto_aes_encryption_round                     PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
-/*                                                                        */
-/*    Timothy Stapko, Microsoft Corporation                               */
-/*                                                                        */
-/*  DESCRIPTION                                                           */
-/*                                                                        */
-/*    This function combines the following operations:                    */
-/*       SubBytes(state)                                                  */
-/*       Shiftrows(state)                                                 */
-/*       MixColumns(state)                                                */
-/*       AddRoundKey(state, w[round*Nb, (round+1)*Nb-1])                  */
-/*    This step is the body of the loop in the middle of Cipher.          */
-/*    Refer to Figure 5 on page 15 of the AES Specification (Pub 197)     */
-/*                                                                        */
-/*  INPUT                                                                 */
-/*                                                                        */
-/*    aes_ptr                               Pointer to AES control block  */
-/*    num_rounds                            Indicates total number of     */
-/*                                            rounds for this operation.  */
-/*                                                                        */
-/*  OUTPUT                                                                */
-/*                                                                        */
-/*    None                                                                */
-/*                                                                        */
-/*  CALLS                                                                 */
-/*                                                                        */
-/*    None                                                                */
-/*                                                                        */
-/*  CALLED BY                                                             */
-/*                                                                        */
-/*    _nx_crypto_aes_encrypt                Perform AES mode encryption   */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
-/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
-/*                                            resulting in version 6.1    */
-/*                                                                        */
-/**************************************************************************/
-NX_CRYPTO_KEEP static VOID _nx_crypto_aes_encryption_round(NX_CRYPTO_AES *aes_ptr, int num_rounds)
-{
-UINT state_data[4];
-UINT saved_state[4];
-
-int  round;
-
-
-    state_data[0] = aes_ptr -> nx_crypto_aes_state[0];
-    state_data[1] = aes_ptr -> nx_crypto_aes_state[1];
-    state_data[2] = aes_ptr -> nx_crypto_aes_state[2];
-    state_data[3] = aes_ptr -> nx_crypto_aes_state[3];
-
-    for (round = 1; round < num_rounds; round++)
-    {
-        /* make a copy of the state data. */
-
-        saved_state[0] = state_data[0];
-        saved_state[1] = state_data[1];
-        saved_state[2] = state_data[2];
-        saved_state[3] = state_data[3];
-
-        /*
-           The MixColumns operates on the state after rotation.  The table below
-           illustrates the bytes before and after the ShiftRows operation.
-           This routine picks up bytes from its position BEFORE the rotation,
-           effectively combining SubBytes, ShiftRows, MixColumns, AddRoundKey
-           into one routine.
-
-           S00    S04    S08    S12          S00    S04    S08    S12
-
-           S01    S05    S09    S13          S05    S09    S13    S01
-                                      --->
-           S02    S06    S10    S14          S10    S14    S02    S06
-
-           S03    S07    S11    S15          S15    S03    S07    S11
-
-           The following code segment fully spells out the AES encryption, step by step.
-
-
-
-           S = bytes[ 0];
-           V0 = aes_encryption_table[S];
-           S = bytes[ 5];
-           val = aes_encryption_table[S];
-           V1 = LEFT_ROTATE24(val);
-           S = bytes[10];
-           val = aes_encryption_table[S];
-           V2 = LEFT_ROTATE16(val);
-           S = bytes[15];
-           val = aes_encryption_table[S];
-           V3 = LEFT_ROTATE8(val);
-           temp_state[0] = V0 ^ V1 ^ V2 ^ V3 ^ (aes_ptr -> nx_crypto_aes_key_schedule[round * 4]);
-
-           S = bytes[ 4];
-           V0 = aes_encryption_table[S];
-           S = bytes[ 9];
-           val = aes_encryption_table[S];
-           V1 = LEFT_ROTATE24(val);
-           S = bytes[14];
-           val = aes_encryption_table[S];
-           V2 = LEFT_ROTATE16(val);
-           S = bytes[ 3];
-           val = aes_encryption_table[S];
-           V3 = LEFT_ROTATE8(val);
-           temp_state[1] = V0 ^ V1 ^ V2 ^ V3 ^ (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 1]);
-
-
-           S = bytes[ 8];
-           V0 = aes_encryption_table[S];
-           S = bytes[13];
-           val = aes_encryption_table[S];
-           V1 = LEFT_ROTATE24(val);
-           S = bytes[ 2];
-           val = aes_encryption_table[S];
-           V2 = LEFT_ROTATE16(val);
-           S = bytes[ 7];
-           val = aes_encryption_table[S];
-           V3 = LEFT_ROTATE8(val);
-           temp_state[2] = V0 ^ V1 ^ V2 ^ V3 ^ (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 2]);
-
-           S = bytes[12];
-           V0 = aes_encryption_table[S];
-           S = bytes[ 1];
-           val = aes_encryption_table[S];
-           V1 = LEFT_ROTATE24(val);
-           S = bytes[ 6];
-           val = aes_encryption_table[S];
-           V2 = LEFT_ROTATE16(val);
-           S = bytes[11];
-           val = aes_encryption_table[S];
-           V3 = LEFT_ROTATE8(val);
-           temp_state[3] = V0 ^ V1 ^ V2 ^ V3 ^ (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 3]);
-
-         */
-
-        /* The following logic implements the steps above but could allow compiler to produce more
-           efficient code. */
-
-        state_data[0] = aes_encryption_table[EXTRACT_MSB_BYTE(saved_state[0])] ^
-            (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(saved_state[1])])) ^
-            (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(saved_state[2])])) ^
-            (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(saved_state[3])])) ^
-            (aes_ptr -> nx_crypto_aes_key_schedule[round * 4]);
-
-        state_data[1] = aes_encryption_table[EXTRACT_MSB_BYTE(saved_state[1])] ^
-            (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(saved_state[2])])) ^
-            (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(saved_state[3])])) ^
-            (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(saved_state[0])])) ^
-            (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 1]);
-
-        state_data[2] = aes_encryption_table[EXTRACT_MSB_BYTE(saved_state[2])] ^
-            (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(saved_state[3])])) ^
-            (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(saved_state[0])])) ^
-            (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(saved_state[1])])) ^
-            (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 2]);
-
-        state_data[3] = aes_encryption_table[EXTRACT_MSB_BYTE(saved_state[3])] ^
-            (LEFT_ROTATE24(aes_encryption_table[EXTRACT_2ND_BYTE(saved_state[0])])) ^
-            (LEFT_ROTATE16(aes_encryption_table[EXTRACT_3RD_BYTE(saved_state[1])])) ^
-            (LEFT_ROTATE8(aes_encryption_table[EXTRACT_LSB_BYTE(saved_state[2])])) ^
-            (aes_ptr -> nx_crypto_aes_key_schedule[round * 4 + 3]);
-    }
-
-    /* Write the data back to state structure. */
-    aes_ptr -> nx_crypto_aes_state[0] = state_data[0];
-    aes_ptr -> nx_crypto_aes_state[1] = state_data[1];
-    aes_ptr -> nx_crypto_aes_state[2] = state_data[2];
-    aes_ptr -> nx_crypto_aes_state[3] = state_data[3];
-
-#ifdef NX_SECURE_KEY_CLEAR
-    NX_CRYPTO_MEMSET(state_data, 0, sizeof(state_data));
-    NX_CRYPTO_MEMSET(saved_state, 0, sizeof(saved_state));
-#endif /* NX_SECURE_KEY_CLEAR  */
-}
-
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -1028,11 +889,7 @@ ULONG  val;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_seucre_aes_add_round_key          Perform AddRoundKey operation */
-/*    _nx_crypto_aes_encryption_round       The main body of AES          */
-/*                                            encryption                  */
-/*    _nx_crypto_aes_sub_shift_roundkey     Perform the last step in AES  */
-/*                                            encryption operation        */
+/*    _nx_crypto_aes_encrypt_block          Encrypt one block             */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -1052,11 +909,7 @@ NX_CRYPTO_KEEP UINT _nx_crypto_aes_encrypt(NX_CRYPTO_AES *aes_ptr, UCHAR *input,
 {
 UINT  num_rounds;
 UINT *w;
-#ifndef NX_CRYPTO_ENABLE_UNALIGNED_ACCESS
-UCHAR *aes_state;
-#else
-UINT *buf;
-#endif
+UINT *state;
 
 
     NX_CRYPTO_PARAMETER_NOT_USED(length);
@@ -1070,63 +923,255 @@ UINT *buf;
         return(NX_CRYPTO_INVALID_PARAMETER);
     }
 
-#ifndef NX_CRYPTO_ENABLE_UNALIGNED_ACCESS
-    aes_state = (UCHAR *)aes_ptr -> nx_crypto_aes_state;
-    aes_state[0] = input[0];
-    aes_state[1] = input[1];
-    aes_state[2] = input[2];
-    aes_state[3] = input[3];
-    aes_state[4] = input[4];
-    aes_state[5] = input[5];
-    aes_state[6] = input[6];
-    aes_state[7] = input[7];
-    aes_state[8] = input[8];
-    aes_state[9] = input[9];
-    aes_state[10] = input[10];
-    aes_state[11] = input[11];
-    aes_state[12] = input[12];
-    aes_state[13] = input[13];
-    aes_state[14] = input[14];
-    aes_state[15] = input[15];
-#else
-    buf = (UINT *)input;
-    aes_ptr -> nx_crypto_aes_state[0] = buf[0];
-    aes_ptr -> nx_crypto_aes_state[1] = buf[1];
-    aes_ptr -> nx_crypto_aes_state[2] = buf[2];
-    aes_ptr -> nx_crypto_aes_state[3] = buf[3];
-#endif
+    state = aes_ptr -> nx_crypto_aes_state;
+    state[0] = NX_CRYPTO_AES_LOAD_WORD(&input[0]);
+    state[1] = NX_CRYPTO_AES_LOAD_WORD(&input[4]);
+    state[2] = NX_CRYPTO_AES_LOAD_WORD(&input[8]);
+    state[3] = NX_CRYPTO_AES_LOAD_WORD(&input[12]);
 
-    _nx_crypto_aes_add_round_key(aes_ptr, &w[0]);
+    _nx_crypto_aes_encrypt_block(w, num_rounds, state);
 
-    _nx_crypto_aes_encryption_round(aes_ptr, (INT)num_rounds);
+    NX_CRYPTO_AES_STORE_WORD(&output[0], state[0]);
+    NX_CRYPTO_AES_STORE_WORD(&output[4], state[1]);
+    NX_CRYPTO_AES_STORE_WORD(&output[8], state[2]);
+    NX_CRYPTO_AES_STORE_WORD(&output[12], state[3]);
 
-    _nx_crypto_aes_sub_shift_roundkey(aes_ptr, &w[num_rounds * 4]);
+    return(NX_CRYPTO_SUCCESS);
+}
 
 
-#ifndef NX_CRYPTO_ENABLE_UNALIGNED_ACCESS
-    output[0] = aes_state[0];
-    output[1] = aes_state[1];
-    output[2] = aes_state[2];
-    output[3] = aes_state[3];
-    output[4] = aes_state[4];
-    output[5] = aes_state[5];
-    output[6] = aes_state[6];
-    output[7] = aes_state[7];
-    output[8] = aes_state[8];
-    output[9] = aes_state[9];
-    output[10] = aes_state[10];
-    output[11] = aes_state[11];
-    output[12] = aes_state[12];
-    output[13] = aes_state[13];
-    output[14] = aes_state[14];
-    output[15] = aes_state[15];
-#else
-    buf = (UINT *)output;
-    buf[0] = aes_ptr -> nx_crypto_aes_state[0];
-    buf[1] = aes_ptr -> nx_crypto_aes_state[1];
-    buf[2] = aes_ptr -> nx_crypto_aes_state[2];
-    buf[3] = aes_ptr -> nx_crypto_aes_state[3];
-#endif
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_aes_ctr_encrypt_blocks                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts or decrypts "blocks" 16-byte blocks in       */
+/*    counter mode, the bulk path of GCM and CTR. Each block of input is  */
+/*    XORed with the encryption of the counter block, whose last 32 bits  */
+/*    are then incremented as a big endian number, like inc32 of GCM and  */
+/*    the counter of CTR. The key schedule is checked once for all the    */
+/*    blocks. The output buffer may point to the input buffer.            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    counter_block                         Pointer to counter block,     */
+/*                                            updated on return           */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_encrypt_block          Encrypt one block             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_gctr                   Perform GCTR operation        */
+/*    _nx_crypto_ctr_encrypt                Perform CTR mode encryption   */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_aes_ctr_encrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *counter_block,
+                                                      UCHAR *input, UCHAR *output, UINT blocks)
+{
+UINT  num_rounds;
+UINT *w;
+UINT  counter[3];
+UINT  count;
+UINT  key_stream[4];
+
+
+    w = aes_ptr -> nx_crypto_aes_key_schedule;
+
+    num_rounds = aes_ptr -> nx_crypto_aes_rounds;
+
+    if (num_rounds < 10 || num_rounds > 14)
+    {
+        return(NX_CRYPTO_INVALID_PARAMETER);
+    }
+
+    /* The first 96 bits of the counter block do not change, the last 32 bits are counted
+       as a number and put back in the byte order of the state for each block.  */
+    counter[0] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[0]);
+    counter[1] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[4]);
+    counter[2] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[8]);
+    count = ((UINT)counter_block[12] << 24) | ((UINT)counter_block[13] << 16) |
+            ((UINT)counter_block[14] << 8) | (UINT)counter_block[15];
+
+    while (blocks > 0)
+    {
+        key_stream[0] = counter[0];
+        key_stream[1] = counter[1];
+        key_stream[2] = counter[2];
+        key_stream[3] = SET_MSB_BYTE(count >> 24) | SET_2ND_BYTE((count >> 16) & 0xFF) |
+                        SET_3RD_BYTE((count >> 8) & 0xFF) | SET_LSB_BYTE(count & 0xFF);
+
+        _nx_crypto_aes_encrypt_block(w, num_rounds, key_stream);
+
+        NX_CRYPTO_AES_STORE_WORD(&output[0], NX_CRYPTO_AES_LOAD_WORD(&input[0]) ^ key_stream[0]);
+        NX_CRYPTO_AES_STORE_WORD(&output[4], NX_CRYPTO_AES_LOAD_WORD(&input[4]) ^ key_stream[1]);
+        NX_CRYPTO_AES_STORE_WORD(&output[8], NX_CRYPTO_AES_LOAD_WORD(&input[8]) ^ key_stream[2]);
+        NX_CRYPTO_AES_STORE_WORD(&output[12], NX_CRYPTO_AES_LOAD_WORD(&input[12]) ^ key_stream[3]);
+
+        count++;
+        input += NX_CRYPTO_AES_BLOCK_SIZE;
+        output += NX_CRYPTO_AES_BLOCK_SIZE;
+        blocks--;
+    }
+
+    counter_block[12] = (UCHAR)(count >> 24);
+    counter_block[13] = (UCHAR)(count >> 16);
+    counter_block[14] = (UCHAR)(count >> 8);
+    counter_block[15] = (UCHAR)count;
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(key_stream, 0, sizeof(key_stream));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_aes_ccm_blocks                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts or decrypts "blocks" 16-byte blocks in CCM   */
+/*    mode, the bulk path of CCM. The CBC-MAC of each plaintext block and */
+/*    its counter mode encryption are done in one pass, with the key      */
+/*    schedule checked once for all the blocks. The counter block holds   */
+/*    the counter of the previous block, whose last 32 bits are           */
+/*    incremented as a big endian number before each block. The L bytes   */
+/*    of the CCM counter are at most 8 bytes and count at most            */
+/*    2^(8L) / 16 blocks, so that the carry out of a counter of less than */
+/*    4 bytes never happens. The output buffer may point to the input     */
+/*    buffer.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    op                                    NX_CRYPTO_ENCRYPT_UPDATE or   */
+/*                                            NX_CRYPTO_DECRYPT_UPDATE    */
+/*    counter_block                         Pointer to counter block,     */
+/*                                            updated on return           */
+/*    mac                                   Pointer to CBC-MAC value,     */
+/*                                            updated on return           */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_encrypt_block          Encrypt one block             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ccm_encrypt_update         Update data for CCM mode      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_aes_ccm_blocks(NX_CRYPTO_AES *aes_ptr, UINT op, UCHAR *counter_block,
+                                              UCHAR *mac, UCHAR *input, UCHAR *output, UINT blocks)
+{
+UINT  num_rounds;
+UINT *w;
+UINT  counter[3];
+UINT  count;
+UINT  key_stream[4];
+UINT  x[4];
+UINT  data[4];
+
+
+    w = aes_ptr -> nx_crypto_aes_key_schedule;
+
+    num_rounds = aes_ptr -> nx_crypto_aes_rounds;
+
+    if (num_rounds < 10 || num_rounds > 14)
+    {
+        return(NX_CRYPTO_INVALID_PARAMETER);
+    }
+
+    counter[0] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[0]);
+    counter[1] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[4]);
+    counter[2] = NX_CRYPTO_AES_LOAD_WORD(&counter_block[8]);
+    count = ((UINT)counter_block[12] << 24) | ((UINT)counter_block[13] << 16) |
+            ((UINT)counter_block[14] << 8) | (UINT)counter_block[15];
+
+    x[0] = NX_CRYPTO_AES_LOAD_WORD(&mac[0]);
+    x[1] = NX_CRYPTO_AES_LOAD_WORD(&mac[4]);
+    x[2] = NX_CRYPTO_AES_LOAD_WORD(&mac[8]);
+    x[3] = NX_CRYPTO_AES_LOAD_WORD(&mac[12]);
+
+    while (blocks > 0)
+    {
+        count++;
+        key_stream[0] = counter[0];
+        key_stream[1] = counter[1];
+        key_stream[2] = counter[2];
+        key_stream[3] = SET_MSB_BYTE(count >> 24) | SET_2ND_BYTE((count >> 16) & 0xFF) |
+                        SET_3RD_BYTE((count >> 8) & 0xFF) | SET_LSB_BYTE(count & 0xFF);
+
+        _nx_crypto_aes_encrypt_block(w, num_rounds, key_stream);
+
+        /* The MAC is over the plaintext: the input of an encryption, the output of a decryption.  */
+        data[0] = NX_CRYPTO_AES_LOAD_WORD(&input[0]);
+        data[1] = NX_CRYPTO_AES_LOAD_WORD(&input[4]);
+        data[2] = NX_CRYPTO_AES_LOAD_WORD(&input[8]);
+        data[3] = NX_CRYPTO_AES_LOAD_WORD(&input[12]);
+
+        NX_CRYPTO_AES_STORE_WORD(&output[0], data[0] ^ key_stream[0]);
+        NX_CRYPTO_AES_STORE_WORD(&output[4], data[1] ^ key_stream[1]);
+        NX_CRYPTO_AES_STORE_WORD(&output[8], data[2] ^ key_stream[2]);
+        NX_CRYPTO_AES_STORE_WORD(&output[12], data[3] ^ key_stream[3]);
+
+        if (op == NX_CRYPTO_DECRYPT_UPDATE)
+        {
+            data[0] ^= key_stream[0];
+            data[1] ^= key_stream[1];
+            data[2] ^= key_stream[2];
+            data[3] ^= key_stream[3];
+        }
+
+        x[0] ^= data[0];
+        x[1] ^= data[1];
+        x[2] ^= data[2];
+        x[3] ^= data[3];
+
+        _nx_crypto_aes_encrypt_block(w, num_rounds, x);
+
+        input += NX_CRYPTO_AES_BLOCK_SIZE;
+        output += NX_CRYPTO_AES_BLOCK_SIZE;
+        blocks--;
+    }
+
+    counter_block[12] = (UCHAR)(count >> 24);
+    counter_block[13] = (UCHAR)(count >> 16);
+    counter_block[14] = (UCHAR)(count >> 8);
+    counter_block[15] = (UCHAR)count;
+
+    NX_CRYPTO_AES_STORE_WORD(&mac[0], x[0]);
+    NX_CRYPTO_AES_STORE_WORD(&mac[4], x[1]);
+    NX_CRYPTO_AES_STORE_WORD(&mac[8], x[2]);
+    NX_CRYPTO_AES_STORE_WORD(&mac[12], x[3]);
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(key_stream, 0, sizeof(key_stream));
+    NX_CRYPTO_MEMSET(data, 0, sizeof(data));
+#endif /* NX_SECURE_KEY_CLEAR  */
 
     return(NX_CRYPTO_SUCCESS);
 }
@@ -1610,20 +1655,147 @@ UINT *buf;
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nx_crypto_aes_key_set                              PORTABLE C      */
-/*                                                           6.1.10       */
-/*  AUTHOR                                                                */
-/*                                                                        */
-/*    Timothy Stapko, Microsoft Corporation                               */
+/*    _nx_crypto_aes_cbc_decrypt_blocks                   PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function configures key for AES encryption and decryption.     */
+/*    This function decrypts "blocks" 16-byte blocks in CBC mode, the     */
+/*    bulk path of CBC decryption. The state of each block is loaded from */
+/*    the input in words, and the decrypted block is XORed in words with  */
+/*    the previous ciphertext block, kept in registers rather than copied */
+/*    to a buffer. The key schedule is checked once for all the blocks.   */
+/*    The output buffer may point to the input buffer.                    */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    aes_ptr                               Pointer to AES control block  */
-/*    key                                   Pointer to key string         */
+/*    iv                                    Pointer to the previous       */
+/*                                            ciphertext block, the last  */
+/*                                            block on return             */
+/*    input                                 Pointer to the input blocks   */
+/*    output                                Pointer to the output blocks  */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_key_expansion_inverse  Key expansion for decryption  */
+/*    _nx_crypto_aes_add_round_key          Perform AddRoundKey operation */
+/*    _nx_crypto_aes_decryption_round       The main body of AES          */
+/*                                            decryption                  */
+/*    _nx_crypto_aes_inv_sub_shift_roundkey Perform the last step in AES  */
+/*                                            decryption operation        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_cbc_decrypt                Perform CBC mode decryption   */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_aes_cbc_decrypt_blocks(NX_CRYPTO_AES *aes_ptr, UCHAR *iv,
+                                                      UCHAR *input, UCHAR *output, UINT blocks)
+{
+UINT  num_rounds;
+UINT  round;
+UINT *w;
+UINT *v;
+UINT *state;
+UINT  chain[4];
+UINT  cipher[4];
+
+
+    num_rounds = aes_ptr -> nx_crypto_aes_rounds;
+
+    if (num_rounds < 10 || num_rounds > 14)
+    {
+        return(NX_CRYPTO_INVALID_PARAMETER);
+    }
+
+    if (aes_ptr -> nx_crypto_aes_inverse_key_expanded == 0)
+    {
+        _nx_crypto_aes_key_expansion_inverse(aes_ptr);
+    }
+
+    w = aes_ptr -> nx_crypto_aes_decrypt_key_schedule;
+    v = aes_ptr -> nx_crypto_aes_key_schedule;
+    state = aes_ptr -> nx_crypto_aes_state;
+
+    chain[0] = NX_CRYPTO_AES_LOAD_WORD(&iv[0]);
+    chain[1] = NX_CRYPTO_AES_LOAD_WORD(&iv[4]);
+    chain[2] = NX_CRYPTO_AES_LOAD_WORD(&iv[8]);
+    chain[3] = NX_CRYPTO_AES_LOAD_WORD(&iv[12]);
+
+    while (blocks > 0)
+    {
+
+        /* The ciphertext chains to the next block, keep it before the output overwrites it.  */
+        cipher[0] = NX_CRYPTO_AES_LOAD_WORD(&input[0]);
+        cipher[1] = NX_CRYPTO_AES_LOAD_WORD(&input[4]);
+        cipher[2] = NX_CRYPTO_AES_LOAD_WORD(&input[8]);
+        cipher[3] = NX_CRYPTO_AES_LOAD_WORD(&input[12]);
+
+        state[0] = cipher[0];
+        state[1] = cipher[1];
+        state[2] = cipher[2];
+        state[3] = cipher[3];
+
+        _nx_crypto_aes_add_round_key(aes_ptr, &v[num_rounds * 4]);
+
+        for (round = num_rounds - 1; round >= 1; --round)
+        {
+            _nx_crypto_aes_decryption_round(aes_ptr, (INT)round);
+        }
+
+        _nx_crypto_aes_inv_sub_shift_roundkey(aes_ptr, &w[0]);
+
+        NX_CRYPTO_AES_STORE_WORD(&output[0], state[0] ^ chain[0]);
+        NX_CRYPTO_AES_STORE_WORD(&output[4], state[1] ^ chain[1]);
+        NX_CRYPTO_AES_STORE_WORD(&output[8], state[2] ^ chain[2]);
+        NX_CRYPTO_AES_STORE_WORD(&output[12], state[3] ^ chain[3]);
+
+        chain[0] = cipher[0];
+        chain[1] = cipher[1];
+        chain[2] = cipher[2];
+        chain[3] = cipher[3];
+
+        input += NX_CRYPTO_AES_BLOCK_SIZE;
+        output += NX_CRYPTO_AES_BLOCK_SIZE;
+        blocks--;
+    }
+
+    NX_CRYPTO_AES_STORE_WORD(&iv[0], chain[0]);
+    NX_CRYPTO_AES_STORE_WORD(&iv[4], chain[1]);
+    NX_CRYPTO_AES_STORE_WORD(&iv[8], chain[2]);
+    NX_CRYPTO_AES_STORE_WORD(&iv[12], chain[3]);
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(state, 0, sizeof(aes_ptr -> nx_crypto_aes_state));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_aes_key_set                              PORTABLE C      */
+/*                                                           6.1.10       */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Timothy Stapko, Microsoft Corporation                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function configures key for AES encryption and decryption.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    aes_ptr                               Pointer to AES control block  */
+/*    key                                   Pointer to key string         */
 /*    key_size                              Size of the key, valid values */
 /*                                            are:                        */
 /*                                        NX_CRYPTO_AES_KEY_SIZE_128_BITS */
@@ -1727,6 +1899,7 @@ UINT   i;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_aes_key_set                Set the key for AES           */
+/*    _nx_crypto_gcm_key_set                Compute the hash key table    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -1779,6 +1952,15 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_init(struct NX_CRYPTO_METHOD_STRUCT *
 
     _nx_crypto_aes_key_set((NX_CRYPTO_AES *)crypto_metadata, key, key_size_in_bits >> 5);
 
+    /* Build the GHASH table of the key here rather than for each message. */
+    if ((method -> nx_crypto_algorithm >= NX_CRYPTO_ENCRYPTION_AES_GCM_8) &&
+        (method -> nx_crypto_algorithm <= NX_CRYPTO_ENCRYPTION_AES_GCM_16))
+    {
+        return(_nx_crypto_gcm_key_set(crypto_metadata,
+                                      &(((NX_CRYPTO_AES *)crypto_metadata) -> nx_crypto_aes_mode_context.gcm),
+                                      (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt));
+    }
+
     return(NX_CRYPTO_SUCCESS);
 }
 
@@ -1991,21 +2173,20 @@ UINT    status;
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    _nx_crypto_method_aes_cbc_operation                 PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
-/*                                                                        */
-/*    Timothy Stapko, Microsoft Corporation                               */
+/*    _nx_crypto_aes_cbc_operation                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function encrypts and decrypts a message using                 */
-/*    the AES CBC algorithm.                                              */
+/*    This function encrypts and decrypts a message using the AES CBC     */
+/*    algorithm with the block functions of the caller, the software AES  */
+/*    or the CRYP peripheral.                                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
+/*    encrypt_function                      AES block encryption          */
+/*    decrypt_function                      AES block decryption          */
 /*    op                                    AES operation                 */
 /*    handle                                Crypto handle                 */
 /*    method                                Cryption Method Object        */
@@ -2032,18 +2213,14 @@ UINT    status;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    Application Code                                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
-/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_crypto_method_aes_cbc_operation   AES CBC software method       */
+/*    _nx_crypto_method_stm32_aes_cbc_operation                           */
+/*                                          AES CBC CRYP method           */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_cbc_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+NX_CRYPTO_KEEP static UINT  _nx_crypto_aes_cbc_operation(UINT (*encrypt_function)(VOID *, UCHAR *, UCHAR *, UINT),
+                                                         UINT (*decrypt_function)(VOID *, UCHAR *, UCHAR *, UINT),
+                                                         UINT op,      /* Encrypt, Decrypt, Authenticate */
                                                          VOID *handle, /* Crypto handler */
                                                          struct NX_CRYPTO_METHOD_STRUCT *method,
                                                          UCHAR *key,
@@ -2096,7 +2273,7 @@ UINT    status;
             }
 
             status = _nx_crypto_cbc_decrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.cbc),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_decrypt,
+                                            decrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2111,7 +2288,7 @@ UINT    status;
             }
 
             status = _nx_crypto_cbc_encrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.cbc),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                            encrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2131,7 +2308,7 @@ UINT    status;
         case NX_CRYPTO_DECRYPT_UPDATE:
         {
             status = _nx_crypto_cbc_decrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.cbc),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_decrypt,
+                                            decrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2139,7 +2316,7 @@ UINT    status;
         case NX_CRYPTO_ENCRYPT_UPDATE:
         {
             status = _nx_crypto_cbc_encrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.cbc),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                            encrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2162,6 +2339,152 @@ UINT    status;
     return(status);
 }
 
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_aes_cbc_operation                 PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Timothy Stapko, Microsoft Corporation                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using                 */
+/*    the AES CBC algorithm.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_cbc_operation          Perform AES CBC operation     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
+/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_cbc_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                         VOID *handle, /* Crypto handler */
+                                                         struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                         UCHAR *key,
+                                                         NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                         UCHAR *input,
+                                                         ULONG input_length_in_byte,
+                                                         UCHAR *iv_ptr,
+                                                         UCHAR *output,
+                                                         ULONG output_length_in_byte,
+                                                         VOID *crypto_metadata,
+                                                         ULONG crypto_metadata_size,
+                                                         VOID *packet_ptr,
+                                                         VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_cbc_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                        (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_decrypt, op, handle,
+                                        method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr, output,
+                                        output_length_in_byte, crypto_metadata, crypto_metadata_size, packet_ptr,
+                                        nx_crypto_hw_process_callback));
+}
+
+
+#ifdef NX_CRYPTO_STM32_HW
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_aes_cbc_operation           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using the AES CBC     */
+/*    algorithm in the CRYP peripheral, in place of                       */
+/*    _nx_crypto_method_aes_cbc_operation in the methods of the driver,   */
+/*    the software AES taking over when the peripheral is not available.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_cbc_operation          Perform AES CBC operation     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_stm32_aes_cbc_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                               VOID *handle, /* Crypto handler */
+                                                               struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                               UCHAR *key,
+                                                               NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                               UCHAR *input,
+                                                               ULONG input_length_in_byte,
+                                                               UCHAR *iv_ptr,
+                                                               UCHAR *output,
+                                                               ULONG output_length_in_byte,
+                                                               VOID *crypto_metadata,
+                                                               ULONG crypto_metadata_size,
+                                                               VOID *packet_ptr,
+                                                               VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_cbc_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt,
+                                        (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_decrypt, op,
+                                        handle, method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr,
+                                        output, output_length_in_byte, crypto_metadata, crypto_metadata_size,
+                                        packet_ptr, nx_crypto_hw_process_callback));
+}
+#endif /* NX_CRYPTO_STM32_HW */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -2461,21 +2784,19 @@ UINT    status;
 
 /**************************************************************************/
 /*                                                                        */
-/*  FUNCTION                                               RELEASE        */
-/*                                                                        */
-/*    _nx_crypto_method_aes_gcm_operation                 PORTABLE C      */
-/*                                                           6.1          */
-/*  AUTHOR                                                                */
+/*  FUNCTION                                                              */
 /*                                                                        */
-/*    Timothy Stapko, Microsoft Corporation                               */
+/*    _nx_crypto_aes_gcm_operation                        PORTABLE C      */
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function encrypts and decrypts a message using                 */
-/*    the AES GCM algorithm.                                              */
+/*    This function encrypts and decrypts a message using the AES GCM     */
+/*    algorithm with the block function of the caller, the software AES   */
+/*    or the CRYP peripheral.                                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
+/*    encrypt_function                      AES block encryption          */
 /*    op                                    AES operation                 */
 /*    handle                                Crypto handle                 */
 /*    method                                Cryption Method Object        */
@@ -2502,19 +2823,13 @@ UINT    status;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_crypto_method_aes_operation       Handle AES encrypt or decrypt */
-/*    Application Code                                                    */
-/*                                                                        */
-/*  RELEASE HISTORY                                                       */
-/*                                                                        */
-/*    DATE              NAME                      DESCRIPTION             */
-/*                                                                        */
-/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
-/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
-/*                                            resulting in version 6.1    */
+/*    _nx_crypto_method_aes_gcm_operation   AES GCM software method       */
+/*    _nx_crypto_method_stm32_aes_gcm_operation                           */
+/*                                          AES GCM CRYP method           */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_gcm_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+NX_CRYPTO_KEEP static UINT  _nx_crypto_aes_gcm_operation(UINT (*encrypt_function)(VOID *, UCHAR *, UCHAR *, UINT),
+                                                         UINT op,      /* Encrypt, Decrypt, Authenticate */
                                                          VOID *handle, /* Crypto handler */
                                                          struct NX_CRYPTO_METHOD_STRUCT *method,
                                                          UCHAR *key,
@@ -2534,6 +2849,7 @@ NX_CRYPTO_AES *ctx;
 UINT icv_len;
 UINT message_len;
 UINT    status;
+CYCLE_PROFILE_SAVE_AREA
 
     NX_CRYPTO_PARAMETER_NOT_USED(handle);
     NX_CRYPTO_PARAMETER_NOT_USED(key);
@@ -2563,6 +2879,8 @@ UINT    status;
         return(NX_CRYPTO_INVALID_ALGORITHM);
     }
 
+    CYCLE_PROFILE_ENTER
+
     /* IV : Nonce length(1 byte) + Nonce
        nx_crypto_ICV_size_in_bits: authentication tag length in bits */
     switch (op)
@@ -2587,7 +2905,7 @@ UINT    status;
 
             message_len = input_length_in_byte - icv_len;
             status = _nx_crypto_gcm_decrypt_init(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                 (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                 encrypt_function,
                                                  ctx -> nx_crypto_aes_mode_context.gcm.nx_crypto_gcm_additional_data,
                                                  ctx -> nx_crypto_aes_mode_context.gcm.nx_crypto_gcm_additional_data_len,
                                                  iv_ptr, NX_CRYPTO_AES_BLOCK_SIZE);
@@ -2598,7 +2916,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_decrypt_update(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                   (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                   encrypt_function,
                                                    input, output, message_len,
                                                    NX_CRYPTO_AES_BLOCK_SIZE);
 
@@ -2608,7 +2926,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_decrypt_calculate(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                      (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                      encrypt_function,
                                                       input + message_len, icv_len,
                                                       NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2632,7 +2950,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_encrypt_init(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                 (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                 encrypt_function,
                                                  ctx -> nx_crypto_aes_mode_context.gcm.nx_crypto_gcm_additional_data,
                                                  ctx -> nx_crypto_aes_mode_context.gcm.nx_crypto_gcm_additional_data_len,
                                                  iv_ptr, NX_CRYPTO_AES_BLOCK_SIZE);
@@ -2643,7 +2961,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_encrypt_update(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                   (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                   encrypt_function,
                                                    input, output, input_length_in_byte,
                                                    NX_CRYPTO_AES_BLOCK_SIZE);
 
@@ -2653,7 +2971,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_encrypt_calculate(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                      (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                      encrypt_function,
                                                       output + input_length_in_byte, icv_len,
                                                       NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2667,7 +2985,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_decrypt_init(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                 (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                 encrypt_function,
                                                  input, /* pointers to AAD */
                                                  input_length_in_byte, /* length of AAD */
                                                  iv_ptr, NX_CRYPTO_AES_BLOCK_SIZE);
@@ -2676,7 +2994,7 @@ UINT    status;
         case NX_CRYPTO_DECRYPT_UPDATE:
         {
             status = _nx_crypto_gcm_decrypt_update(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                   (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                   encrypt_function,
                                                    input, output, input_length_in_byte,
                                                    NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2691,7 +3009,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_decrypt_calculate(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                      (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                      encrypt_function,
                                                       input, icv_len,
                                                       NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2705,7 +3023,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_encrypt_init(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                 (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                 encrypt_function,
                                                  input, /* pointers to AAD */
                                                  input_length_in_byte, /* length of AAD */
                                                  iv_ptr, NX_CRYPTO_AES_BLOCK_SIZE);
@@ -2714,7 +3032,7 @@ UINT    status;
         case NX_CRYPTO_ENCRYPT_UPDATE:
         {
             status = _nx_crypto_gcm_encrypt_update(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                   (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                   encrypt_function,
                                                    input, output, input_length_in_byte,
                                                    NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2729,7 +3047,7 @@ UINT    status;
             }
 
             status = _nx_crypto_gcm_encrypt_calculate(ctx, &(ctx -> nx_crypto_aes_mode_context.gcm),
-                                                      (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                                      encrypt_function,
                                                       output, icv_len,
                                                       NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2752,14 +3070,17 @@ UINT    status;
         } break;
     }
 
+    CYCLE_PROFILE_EXIT(CYCLE_PROFILE_AES_GCM)
+
     return(status);
 }
 
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
 /*                                                                        */
-/*    _nx_crypto_method_aes_ctr_operation                 PORTABLE C      */
+/*    _nx_crypto_method_aes_gcm_operation                 PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -2768,7 +3089,7 @@ UINT    status;
 /*  DESCRIPTION                                                           */
 /*                                                                        */
 /*    This function encrypts and decrypts a message using                 */
-/*    the AES CTR algorithm.                                              */
+/*    the AES GCM algorithm.                                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -2793,7 +3114,7 @@ UINT    status;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_crypto_ctr_encrypt                Perform CTR mode encryption   */
+/*    _nx_crypto_aes_gcm_operation          Perform AES GCM operation     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -2809,7 +3130,143 @@ UINT    status;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_ctr_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_gcm_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                         VOID *handle, /* Crypto handler */
+                                                         struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                         UCHAR *key,
+                                                         NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                         UCHAR *input,
+                                                         ULONG input_length_in_byte,
+                                                         UCHAR *iv_ptr,
+                                                         UCHAR *output,
+                                                         ULONG output_length_in_byte,
+                                                         VOID *crypto_metadata,
+                                                         ULONG crypto_metadata_size,
+                                                         VOID *packet_ptr,
+                                                         VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_gcm_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt, op, handle,
+                                        method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr, output,
+                                        output_length_in_byte, crypto_metadata, crypto_metadata_size, packet_ptr,
+                                        nx_crypto_hw_process_callback));
+}
+
+
+#ifdef NX_CRYPTO_STM32_HW
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_aes_gcm_operation           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using the AES GCM     */
+/*    algorithm in the CRYP peripheral, in place of                       */
+/*    _nx_crypto_method_aes_gcm_operation in the methods of the driver,   */
+/*    the software AES taking over when the peripheral is not available.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_gcm_operation          Perform AES GCM operation     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_stm32_aes_gcm_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                               VOID *handle, /* Crypto handler */
+                                                               struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                               UCHAR *key,
+                                                               NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                               UCHAR *input,
+                                                               ULONG input_length_in_byte,
+                                                               UCHAR *iv_ptr,
+                                                               UCHAR *output,
+                                                               ULONG output_length_in_byte,
+                                                               VOID *crypto_metadata,
+                                                               ULONG crypto_metadata_size,
+                                                               VOID *packet_ptr,
+                                                               VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_gcm_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt, op,
+                                        handle, method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr,
+                                        output, output_length_in_byte, crypto_metadata, crypto_metadata_size,
+                                        packet_ptr, nx_crypto_hw_process_callback));
+}
+#endif /* NX_CRYPTO_STM32_HW */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_aes_ctr_operation                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using the AES CTR     */
+/*    algorithm with the block function of the caller, the software AES   */
+/*    or the CRYP peripheral.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    encrypt_function                      AES block encryption          */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ctr_encrypt                Perform CTR mode encryption   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_aes_ctr_operation   AES CTR software method       */
+/*    _nx_crypto_method_stm32_aes_ctr_operation                           */
+/*                                          AES CTR CRYP method           */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static UINT  _nx_crypto_aes_ctr_operation(UINT (*encrypt_function)(VOID *, UCHAR *, UCHAR *, UINT),
+                                                         UINT op,      /* Encrypt, Decrypt, Authenticate */
                                                          VOID *handle, /* Crypto handler */
                                                          struct NX_CRYPTO_METHOD_STRUCT *method,
                                                          UCHAR *key,
@@ -2863,7 +3320,7 @@ UINT                status;
             }
 
             status = _nx_crypto_ctr_encrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.ctr),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                            encrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2882,7 +3339,7 @@ UINT                status;
         case NX_CRYPTO_DECRYPT_UPDATE:
         {
             status = _nx_crypto_ctr_encrypt(ctx, &(ctx -> nx_crypto_aes_mode_context.ctr),
-                                            (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt,
+                                            encrypt_function,
                                             input, output, input_length_in_byte,
                                             NX_CRYPTO_AES_BLOCK_SIZE);
         } break;
@@ -2905,6 +3362,151 @@ UINT                status;
     return status;
 }
 
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_aes_ctr_operation                 PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Timothy Stapko, Microsoft Corporation                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using                 */
+/*    the AES CTR algorithm.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_ctr_operation          Perform AES CTR operation     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_aes_operation       Handle AES encrypt or decrypt */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Timothy Stapko           Initial Version 6.0           */
+/*  09-30-2020     Timothy Stapko           Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_aes_ctr_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                         VOID *handle, /* Crypto handler */
+                                                         struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                         UCHAR *key,
+                                                         NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                         UCHAR *input,
+                                                         ULONG input_length_in_byte,
+                                                         UCHAR *iv_ptr,
+                                                         UCHAR *output,
+                                                         ULONG output_length_in_byte,
+                                                         VOID *crypto_metadata,
+                                                         ULONG crypto_metadata_size,
+                                                         VOID *packet_ptr,
+                                                         VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_ctr_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt, op, handle,
+                                        method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr, output,
+                                        output_length_in_byte, crypto_metadata, crypto_metadata_size, packet_ptr,
+                                        nx_crypto_hw_process_callback));
+}
+
+
+#ifdef NX_CRYPTO_STM32_HW
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_method_stm32_aes_ctr_operation           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using the AES CTR     */
+/*    algorithm in the CRYP peripheral, in place of                       */
+/*    _nx_crypto_method_aes_ctr_operation in the methods of the driver,   */
+/*    the software AES taking over when the peripheral is not available.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    AES operation                 */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_aes_ctr_operation          Perform AES CTR operation     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_stm32_aes_ctr_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                               VOID *handle, /* Crypto handler */
+                                                               struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                               UCHAR *key,
+                                                               NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                               UCHAR *input,
+                                                               ULONG input_length_in_byte,
+                                                               UCHAR *iv_ptr,
+                                                               UCHAR *output,
+                                                               ULONG output_length_in_byte,
+                                                               VOID *crypto_metadata,
+                                                               ULONG crypto_metadata_size,
+                                                               VOID *packet_ptr,
+                                                               VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+    return(_nx_crypto_aes_ctr_operation((UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt, op,
+                                        handle, method, key, key_size_in_bits, input, input_length_in_byte, iv_ptr,
+                                        output, output_length_in_byte, crypto_metadata, crypto_metadata_size,
+                                        packet_ptr, nx_crypto_hw_process_callback));
+}
+#endif /* NX_CRYPTO_STM32_HW */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -21,6 +21,10 @@
 /**************************************************************************/
 
 #include "nx_crypto_cbc.h"
+#include "nx_crypto_aes.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
 
 /**************************************************************************/
 /*                                                                        */
@@ -34,7 +38,8 @@
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function performs XOR operation on the output buffer.          */
+/*    This function performs XOR operation on the output buffer, a word   */
+/*    at a time when the three buffers are aligned on words.              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -65,9 +70,17 @@
 /**************************************************************************/
 NX_CRYPTO_KEEP static VOID _nx_crypto_cbc_xor(UCHAR *plaintext, UCHAR *key, UCHAR *ciphertext, UCHAR block_size)
 {
-UINT i;
+UINT i = 0;
 
-    for (i = 0; i < block_size; i++)
+    if ((((ULONG)plaintext | (ULONG)key | (ULONG)ciphertext | block_size) & 0x3) == 0)
+    {
+        for (; i < block_size; i += 4)
+        {
+            *(UINT *)(ciphertext + i) = *(UINT *)(plaintext + i) ^ *(UINT *)(key + i);
+        }
+    }
+
+    for (; i < block_size; i++)
     {
         ciphertext[i] = plaintext[i] ^ key[i];
     }
@@ -107,6 +120,9 @@ UINT i;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_cbc_xor                    Perform CBC XOR operation     */
+/*    _nx_crypto_stm32_aes_cbc_encrypt_blocks                             */
+/*                                          Encrypt blocks in the CRYP    */
+/*                                            peripheral                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -152,6 +168,17 @@ UINT   i;
     /* Pick up last cipher. */
     last_cipher = cbc_metadata -> nx_crypto_cbc_last_block;
 
+#ifdef NX_CRYPTO_STM32_HW
+    if ((block_size == NX_CRYPTO_AES_BLOCK_SIZE) &&
+        (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt))
+    {
+
+        /* CRYP peripheral: chain and encrypt all the blocks in one call.  */
+        return(_nx_crypto_stm32_aes_cbc_encrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, last_cipher, input, output,
+                                                       length / NX_CRYPTO_AES_BLOCK_SIZE));
+    }
+#endif /* NX_CRYPTO_STM32_HW */
+
     for (i = 0; i < length; i += block_size)
     {
 
@@ -208,6 +235,10 @@ UINT   i;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_cbc_xor                    Perform CBC XOR operation     */
+/*    _nx_crypto_aes_cbc_decrypt_blocks     Decrypt blocks in CBC mode    */
+/*    _nx_crypto_stm32_aes_cbc_decrypt_blocks                             */
+/*                                          Decrypt blocks in the CRYP    */
+/*                                            peripheral                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -253,6 +284,25 @@ UINT  i;
 
     last_cipher = cbc_metadata -> nx_crypto_cbc_last_block;
 
+    if ((block_size == NX_CRYPTO_AES_BLOCK_SIZE) &&
+        (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_decrypt))
+    {
+
+        /* Software AES: decrypt all the blocks in one call rather than one call per block.  */
+        return(_nx_crypto_aes_cbc_decrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, last_cipher, input, output,
+                                                 length / NX_CRYPTO_AES_BLOCK_SIZE));
+    }
+#ifdef NX_CRYPTO_STM32_HW
+    if ((block_size == NX_CRYPTO_AES_BLOCK_SIZE) &&
+        (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_decrypt))
+    {
+
+        /* CRYP peripheral: decrypt and chain all the blocks in one call.  */
+        return(_nx_crypto_stm32_aes_cbc_decrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, last_cipher, input, output,
+                                                       length / NX_CRYPTO_AES_BLOCK_SIZE));
+    }
+#endif /* NX_CRYPTO_STM32_HW */
+
     for (i = 0; i < length; i += block_size)
     {
         /* If input == output, the xor clobbers the input buffer so we need to save off our last ciphertext
@@ -21,6 +21,7 @@
 /**************************************************************************/
 
 #include "nx_crypto_ccm.h"
+#include "nx_crypto_aes.h"
 
 /**************************************************************************/
 /*                                                                        */
@@ -369,6 +370,8 @@ UCHAR *A = ccm_metadata -> nx_crypto_ccm_A;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_ccm_cbc_pad                Update data for CCM mode      */
+/*    _nx_crypto_aes_ccm_blocks             Encrypt or decrypt blocks in  */
+/*                                            CCM mode                    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -390,6 +393,8 @@ NX_CRYPTO_KEEP UINT _nx_crypto_ccm_encrypt_update(UINT op, VOID *crypto_metadata
 UCHAR *A = ccm_metadata -> nx_crypto_ccm_A;
 UCHAR  X[NX_CRYPTO_CCM_BLOCK_SIZE];
 UINT   i = 0, k = 0;
+UINT   n;
+UINT   status;
 
     /* Check the block size.  */
     if (block_size != NX_CRYPTO_CCM_BLOCK_SIZE)
@@ -397,6 +402,23 @@ UINT   i = 0, k = 0;
         return(NX_CRYPTO_PTR_ERROR);
     }
 
+    /* Software AES: authenticate and encrypt the whole blocks in one pass.  */
+    n = length / NX_CRYPTO_CCM_BLOCK_SIZE;
+    if ((n > 0) && (ccm_metadata -> nx_crypto_ccm_icv_length > 0) &&
+        (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt))
+    {
+        status = _nx_crypto_aes_ccm_blocks((NX_CRYPTO_AES *)crypto_metadata, op, A, ccm_metadata -> nx_crypto_ccm_X,
+                                           input, output, n);
+        if (status)
+        {
+            return(status);
+        }
+
+        input += n * NX_CRYPTO_CCM_BLOCK_SIZE;
+        output += n * NX_CRYPTO_CCM_BLOCK_SIZE;
+        length -= n * NX_CRYPTO_CCM_BLOCK_SIZE;
+    }
+
     if (op == NX_CRYPTO_ENCRYPT_UPDATE)
     {
         
@@ -419,7 +441,13 @@ UINT   i = 0, k = 0;
         /* Cipher text block: C(i) = E(Key, A(i)) ^ M(i)   */
         for (i = 0; i < length; i += block_size)
         {
-            A[15] = (UCHAR)(A[15] + 1);
+
+            /* Increment the counter with its carry, as the bulk path does.  */
+            k = 15;
+            while ((++A[k] == 0) && (k > 12))
+            {
+                k--;
+            }
             crypto_function(crypto_metadata, A, X, block_size);
 
             for (k = 0; (k < block_size) && ((i + k) < length); k++)
@@ -514,8 +542,8 @@ UINT i;
         /* The authentication tag T is the leftmost M bytes of the CBC-MAC value X(t + 1).  */
         NX_CRYPTO_MEMCPY(icv, ccm_metadata -> nx_crypto_ccm_X, ccm_metadata -> nx_crypto_ccm_icv_length); /* Use case of memcpy is verified. */
 
-        /* Get encryption block X.  */
-        A[15] = 0;
+        /* Get encryption block X, with the L bytes of the counter set to 0.  */
+        NX_CRYPTO_MEMSET(&A[15 - (A[0] & 7)], 0, (UINT)(A[0] & 7) + 1);
         crypto_function(crypto_metadata, A, A, block_size);
 
         /* Encrypt authentication tag.  */
@@ -594,7 +622,7 @@ UINT i;
     {
 
         NX_CRYPTO_MEMCPY(temp, ccm_metadata -> nx_crypto_ccm_A, block_size); /* Use case of memcpy is verified. */
-        temp[15] = 0;
+        NX_CRYPTO_MEMSET(&temp[15 - (temp[0] & 7)], 0, (UINT)(temp[0] & 7) + 1);
         crypto_function(crypto_metadata, temp, temp, block_size);
 
         /* Encrypt authentication tag.  */
@@ -0,0 +1,1370 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   ChaCha20-Poly1305 AEAD                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#include "nx_crypto_chacha20_poly1305.h"
+
+/* ChaCha20 is only additions, rotations and exclusive ors of 32-bit words. The
+   block function keeps the 16 words of the state in local variables, and the
+   rotations fold into the shifted operand of the next instruction on Cortex-M.
+   Poly1305 works on five 26-bit limbs so that the products of a block fit in
+   64-bit accumulators without carry handling between the multiplications.  */
+#define NX_CRYPTO_CHACHA20_ROTATE(v, n)      (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define NX_CRYPTO_CHACHA20_QUARTER_ROUND(a, b, c, d)                    \
+    a += b; d ^= a; d = NX_CRYPTO_CHACHA20_ROTATE(d, 16);               \
+    c += d; b ^= c; b = NX_CRYPTO_CHACHA20_ROTATE(b, 12);               \
+    a += b; d ^= a; d = NX_CRYPTO_CHACHA20_ROTATE(d, 8);                \
+    c += d; b ^= c; b = NX_CRYPTO_CHACHA20_ROTATE(b, 7);
+
+#define NX_CRYPTO_CHACHA20_LOAD32(p)         ((UINT)(p)[0] | ((UINT)(p)[1] << 8) | \
+                                              ((UINT)(p)[2] << 16) | ((UINT)(p)[3] << 24))
+
+#define NX_CRYPTO_CHACHA20_STORE32(p, v)     (p)[0] = (UCHAR)(v);         \
+                                             (p)[1] = (UCHAR)((v) >> 8);  \
+                                             (p)[2] = (UCHAR)((v) >> 16); \
+                                             (p)[3] = (UCHAR)((v) >> 24);
+
+#define NX_CRYPTO_POLY1305_LIMB_MASK         0x3FFFFFF
+
+static VOID _nx_crypto_chacha20_block(NX_CRYPTO_CHACHA20_POLY1305 *ctx);
+static VOID _nx_crypto_chacha20_xor(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UCHAR *output, UINT length);
+static VOID _nx_crypto_poly1305_key_set(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *key);
+static VOID _nx_crypto_poly1305_blocks(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UINT blocks);
+static VOID _nx_crypto_poly1305_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UINT length);
+static VOID _nx_crypto_poly1305_pad(NX_CRYPTO_CHACHA20_POLY1305 *ctx);
+static VOID _nx_crypto_poly1305_finish(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *tag);
+static VOID _nx_crypto_chacha20_poly1305_tag_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *tag);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_block                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the ChaCha20 block of the current counter    */
+/*    into the key stream of the context and increments the counter.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_xor               Apply the ChaCha20 key stream */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init                           */
+/*                                          Initialize encryption         */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_chacha20_block(NX_CRYPTO_CHACHA20_POLY1305 *ctx)
+{
+UINT  *state = ctx -> nx_crypto_chacha20_state;
+UCHAR *key_stream = ctx -> nx_crypto_chacha20_key_stream;
+UINT   x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
+UINT   i;
+
+    x0 = state[0];
+    x1 = state[1];
+    x2 = state[2];
+    x3 = state[3];
+    x4 = state[4];
+    x5 = state[5];
+    x6 = state[6];
+    x7 = state[7];
+    x8 = state[8];
+    x9 = state[9];
+    x10 = state[10];
+    x11 = state[11];
+    x12 = state[12];
+    x13 = state[13];
+    x14 = state[14];
+    x15 = state[15];
+
+    /* 20 rounds, as 10 double rounds of a column round and a diagonal round. */
+    for (i = 0; i < 10; i++)
+    {
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x0, x4, x8, x12)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x1, x5, x9, x13)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x2, x6, x10, x14)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x3, x7, x11, x15)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x0, x5, x10, x15)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x1, x6, x11, x12)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x2, x7, x8, x13)
+        NX_CRYPTO_CHACHA20_QUARTER_ROUND(x3, x4, x9, x14)
+    }
+
+    /* Add the input block and serialize the words in little endian. */
+    x0 += state[0];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[0], x0)
+    x1 += state[1];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[4], x1)
+    x2 += state[2];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[8], x2)
+    x3 += state[3];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[12], x3)
+    x4 += state[4];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[16], x4)
+    x5 += state[5];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[20], x5)
+    x6 += state[6];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[24], x6)
+    x7 += state[7];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[28], x7)
+    x8 += state[8];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[32], x8)
+    x9 += state[9];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[36], x9)
+    x10 += state[10];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[40], x10)
+    x11 += state[11];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[44], x11)
+    x12 += state[12];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[48], x12)
+    x13 += state[13];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[52], x13)
+    x14 += state[14];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[56], x14)
+    x15 += state[15];
+    NX_CRYPTO_CHACHA20_STORE32(&key_stream[60], x15)
+
+    /* Move to the next block. */
+    state[12]++;
+    ctx -> nx_crypto_chacha20_key_stream_used = 0;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_xor                             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function combines data with the ChaCha20 key stream, starting  */
+/*    with the bytes left of the current block. The input and output may  */
+/*    be the same buffer.                                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Input data                    */
+/*    output                                Output data                   */
+/*    length                                Length of data                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_block             Compute a ChaCha20 block      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_update                         */
+/*                                          Encrypt data                  */
+/*    _nx_crypto_chacha20_poly1305_decrypt_update                         */
+/*                                          Decrypt data                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_chacha20_xor(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UCHAR *output, UINT length)
+{
+UCHAR *key_stream = ctx -> nx_crypto_chacha20_key_stream;
+UINT   used = ctx -> nx_crypto_chacha20_key_stream_used;
+UINT   i;
+
+    /* Use the rest of the key stream of the previous call. */
+    while ((used < NX_CRYPTO_CHACHA20_BLOCK_SIZE) && length)
+    {
+        *output++ = (UCHAR)(*input++ ^ key_stream[used++]);
+        length--;
+    }
+    ctx -> nx_crypto_chacha20_key_stream_used = used;
+
+    while (length >= NX_CRYPTO_CHACHA20_BLOCK_SIZE)
+    {
+        _nx_crypto_chacha20_block(ctx);
+
+        if (((((ULONG)input) | ((ULONG)output)) & 0x3) == 0)
+        {
+
+            /* Aligned data, combine the key stream a word at a time. */
+            for (i = 0; i < NX_CRYPTO_CHACHA20_BLOCK_SIZE; i += 4)
+            {
+                *(UINT *)(output + i) = *(UINT *)(input + i) ^ *(UINT *)(key_stream + i);
+            }
+        }
+        else
+        {
+            for (i = 0; i < NX_CRYPTO_CHACHA20_BLOCK_SIZE; i++)
+            {
+                output[i] = (UCHAR)(input[i] ^ key_stream[i]);
+            }
+        }
+
+        ctx -> nx_crypto_chacha20_key_stream_used = NX_CRYPTO_CHACHA20_BLOCK_SIZE;
+        input += NX_CRYPTO_CHACHA20_BLOCK_SIZE;
+        output += NX_CRYPTO_CHACHA20_BLOCK_SIZE;
+        length -= NX_CRYPTO_CHACHA20_BLOCK_SIZE;
+    }
+
+    if (length)
+    {
+
+        /* Start a new block for the tail, the next call uses the rest of it. */
+        _nx_crypto_chacha20_block(ctx);
+        for (i = 0; i < length; i++)
+        {
+            output[i] = (UCHAR)(input[i] ^ key_stream[i]);
+        }
+        ctx -> nx_crypto_chacha20_key_stream_used = length;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_poly1305_key_set                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the one-time Poly1305 key of a message: the      */
+/*    clamped r and s, and clears the accumulator.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    key                                   Poly1305 key, 32 bytes        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init                           */
+/*                                          Initialize encryption         */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_poly1305_key_set(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *key)
+{
+UINT *r = ctx -> nx_crypto_poly1305_r;
+UINT *h = ctx -> nx_crypto_poly1305_h;
+UINT *s = ctx -> nx_crypto_poly1305_s;
+
+    /* r is clamped as the RFC requires: the top four bits of its bytes 3, 7, 11
+       and 15 and the bottom two bits of its bytes 4, 8 and 12 are cleared.  */
+    r[0] = (NX_CRYPTO_CHACHA20_LOAD32(&key[0])) & 0x3FFFFFF;
+    r[1] = (NX_CRYPTO_CHACHA20_LOAD32(&key[3]) >> 2) & 0x3FFFF03;
+    r[2] = (NX_CRYPTO_CHACHA20_LOAD32(&key[6]) >> 4) & 0x3FFC0FF;
+    r[3] = (NX_CRYPTO_CHACHA20_LOAD32(&key[9]) >> 6) & 0x3F03FFF;
+    r[4] = (NX_CRYPTO_CHACHA20_LOAD32(&key[12]) >> 8) & 0x00FFFFF;
+
+    h[0] = 0;
+    h[1] = 0;
+    h[2] = 0;
+    h[3] = 0;
+    h[4] = 0;
+
+    s[0] = NX_CRYPTO_CHACHA20_LOAD32(&key[16]);
+    s[1] = NX_CRYPTO_CHACHA20_LOAD32(&key[20]);
+    s[2] = NX_CRYPTO_CHACHA20_LOAD32(&key[24]);
+    s[3] = NX_CRYPTO_CHACHA20_LOAD32(&key[28]);
+
+    ctx -> nx_crypto_poly1305_buffer_length = 0;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_poly1305_blocks                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function authenticates full 16-byte blocks with Poly1305: h =  */
+/*    (h + m) * r modulo 2^130 - 5 for each block.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Input data                    */
+/*    blocks                                Number of blocks              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_poly1305_update            Authenticate data             */
+/*    _nx_crypto_poly1305_pad               Pad data to a block           */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate                          */
+/*                                          Compute the AEAD tag          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_poly1305_blocks(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UINT blocks)
+{
+UINT    r0, r1, r2, r3, r4;
+UINT    s1, s2, s3, s4;
+UINT    h0, h1, h2, h3, h4;
+ULONG64 d0, d1, d2, d3, d4;
+UINT    c;
+
+    r0 = ctx -> nx_crypto_poly1305_r[0];
+    r1 = ctx -> nx_crypto_poly1305_r[1];
+    r2 = ctx -> nx_crypto_poly1305_r[2];
+    r3 = ctx -> nx_crypto_poly1305_r[3];
+    r4 = ctx -> nx_crypto_poly1305_r[4];
+
+    /* 2^130 = 5 modulo 2^130 - 5, so the limbs of the product above 2^130 are
+       folded back multiplied by 5.  */
+    s1 = r1 * 5;
+    s2 = r2 * 5;
+    s3 = r3 * 5;
+    s4 = r4 * 5;
+
+    h0 = ctx -> nx_crypto_poly1305_h[0];
+    h1 = ctx -> nx_crypto_poly1305_h[1];
+    h2 = ctx -> nx_crypto_poly1305_h[2];
+    h3 = ctx -> nx_crypto_poly1305_h[3];
+    h4 = ctx -> nx_crypto_poly1305_h[4];
+
+    while (blocks--)
+    {
+
+        /* h += m, with the 2^128 bit of a full block. */
+        h0 += (NX_CRYPTO_CHACHA20_LOAD32(&input[0])) & NX_CRYPTO_POLY1305_LIMB_MASK;
+        h1 += (NX_CRYPTO_CHACHA20_LOAD32(&input[3]) >> 2) & NX_CRYPTO_POLY1305_LIMB_MASK;
+        h2 += (NX_CRYPTO_CHACHA20_LOAD32(&input[6]) >> 4) & NX_CRYPTO_POLY1305_LIMB_MASK;
+        h3 += (NX_CRYPTO_CHACHA20_LOAD32(&input[9]) >> 6) & NX_CRYPTO_POLY1305_LIMB_MASK;
+        h4 += (NX_CRYPTO_CHACHA20_LOAD32(&input[12]) >> 8) | (1 << 24);
+
+        /* h *= r modulo 2^130 - 5, partially reduced. */
+        d0 = ((ULONG64)h0 * r0) + ((ULONG64)h1 * s4) + ((ULONG64)h2 * s3) + ((ULONG64)h3 * s2) + ((ULONG64)h4 * s1);
+        d1 = ((ULONG64)h0 * r1) + ((ULONG64)h1 * r0) + ((ULONG64)h2 * s4) + ((ULONG64)h3 * s3) + ((ULONG64)h4 * s2);
+        d2 = ((ULONG64)h0 * r2) + ((ULONG64)h1 * r1) + ((ULONG64)h2 * r0) + ((ULONG64)h3 * s4) + ((ULONG64)h4 * s3);
+        d3 = ((ULONG64)h0 * r3) + ((ULONG64)h1 * r2) + ((ULONG64)h2 * r1) + ((ULONG64)h3 * r0) + ((ULONG64)h4 * s4);
+        d4 = ((ULONG64)h0 * r4) + ((ULONG64)h1 * r3) + ((ULONG64)h2 * r2) + ((ULONG64)h3 * r1) + ((ULONG64)h4 * r0);
+
+        c = (UINT)(d0 >> 26);
+        h0 = (UINT)d0 & NX_CRYPTO_POLY1305_LIMB_MASK;
+        d1 += c;
+        c = (UINT)(d1 >> 26);
+        h1 = (UINT)d1 & NX_CRYPTO_POLY1305_LIMB_MASK;
+        d2 += c;
+        c = (UINT)(d2 >> 26);
+        h2 = (UINT)d2 & NX_CRYPTO_POLY1305_LIMB_MASK;
+        d3 += c;
+        c = (UINT)(d3 >> 26);
+        h3 = (UINT)d3 & NX_CRYPTO_POLY1305_LIMB_MASK;
+        d4 += c;
+        c = (UINT)(d4 >> 26);
+        h4 = (UINT)d4 & NX_CRYPTO_POLY1305_LIMB_MASK;
+        h0 += c * 5;
+        c = h0 >> 26;
+        h0 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+        h1 += c;
+
+        input += NX_CRYPTO_POLY1305_BLOCK_SIZE;
+    }
+
+    ctx -> nx_crypto_poly1305_h[0] = h0;
+    ctx -> nx_crypto_poly1305_h[1] = h1;
+    ctx -> nx_crypto_poly1305_h[2] = h2;
+    ctx -> nx_crypto_poly1305_h[3] = h3;
+    ctx -> nx_crypto_poly1305_h[4] = h4;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_poly1305_update                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function authenticates data of any length with Poly1305,       */
+/*    keeping the bytes of an incomplete block for the next call.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Input data                    */
+/*    length                                Length of data                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_MEMCPY                      Copy the memory               */
+/*    _nx_crypto_poly1305_blocks            Authenticate Poly1305 blocks  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init                           */
+/*                                          Initialize encryption         */
+/*    _nx_crypto_chacha20_poly1305_encrypt_update                         */
+/*                                          Encrypt data                  */
+/*    _nx_crypto_chacha20_poly1305_decrypt_update                         */
+/*                                          Decrypt data                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_poly1305_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *input, UINT length)
+{
+UCHAR *buffer = ctx -> nx_crypto_poly1305_buffer;
+UINT   buffer_length = ctx -> nx_crypto_poly1305_buffer_length;
+UINT   copy_length;
+
+    if (buffer_length)
+    {
+
+        /* Complete the block started by the previous call. */
+        copy_length = NX_CRYPTO_POLY1305_BLOCK_SIZE - buffer_length;
+        if (copy_length > length)
+        {
+            copy_length = length;
+        }
+
+        NX_CRYPTO_MEMCPY(&buffer[buffer_length], input, copy_length); /* Use case of memcpy is verified. */
+        buffer_length += copy_length;
+        input += copy_length;
+        length -= copy_length;
+
+        if (buffer_length < NX_CRYPTO_POLY1305_BLOCK_SIZE)
+        {
+            ctx -> nx_crypto_poly1305_buffer_length = buffer_length;
+            return;
+        }
+
+        _nx_crypto_poly1305_blocks(ctx, buffer, 1);
+        buffer_length = 0;
+    }
+
+    if (length >= NX_CRYPTO_POLY1305_BLOCK_SIZE)
+    {
+        _nx_crypto_poly1305_blocks(ctx, input, length / NX_CRYPTO_POLY1305_BLOCK_SIZE);
+        input += length & ~(UINT)(NX_CRYPTO_POLY1305_BLOCK_SIZE - 1);
+        length &= (NX_CRYPTO_POLY1305_BLOCK_SIZE - 1);
+    }
+
+    /* Keep the tail for the next call. */
+    NX_CRYPTO_MEMCPY(buffer, input, length); /* Use case of memcpy is verified. */
+    ctx -> nx_crypto_poly1305_buffer_length = length;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_poly1305_pad                             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function completes the pending Poly1305 block with zeros, as   */
+/*    the AEAD construction pads the additional data and the cipher text. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*    _nx_crypto_poly1305_blocks            Authenticate Poly1305 blocks  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate                          */
+/*                                          Compute the AEAD tag          */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init                           */
+/*                                          Initialize encryption         */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_poly1305_pad(NX_CRYPTO_CHACHA20_POLY1305 *ctx)
+{
+UINT buffer_length = ctx -> nx_crypto_poly1305_buffer_length;
+
+    if (buffer_length)
+    {
+        NX_CRYPTO_MEMSET(&ctx -> nx_crypto_poly1305_buffer[buffer_length], 0,
+                         NX_CRYPTO_POLY1305_BLOCK_SIZE - buffer_length);
+        _nx_crypto_poly1305_blocks(ctx, ctx -> nx_crypto_poly1305_buffer, 1);
+        ctx -> nx_crypto_poly1305_buffer_length = 0;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_poly1305_finish                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function fully reduces the Poly1305 accumulator in constant    */
+/*    time and adds s to produce the tag.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    tag                                   Tag, 16 bytes                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate                          */
+/*                                          Compute the AEAD tag          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_poly1305_finish(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *tag)
+{
+UINT    h0, h1, h2, h3, h4;
+UINT    g0, g1, g2, g3, g4;
+UINT    c;
+UINT    mask;
+ULONG64 f;
+
+    h0 = ctx -> nx_crypto_poly1305_h[0];
+    h1 = ctx -> nx_crypto_poly1305_h[1];
+    h2 = ctx -> nx_crypto_poly1305_h[2];
+    h3 = ctx -> nx_crypto_poly1305_h[3];
+    h4 = ctx -> nx_crypto_poly1305_h[4];
+
+    /* Propagate the carries. */
+    c = h1 >> 26;
+    h1 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    h2 += c;
+    c = h2 >> 26;
+    h2 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    h3 += c;
+    c = h3 >> 26;
+    h3 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    h4 += c;
+    c = h4 >> 26;
+    h4 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    h0 += c * 5;
+    c = h0 >> 26;
+    h0 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    h1 += c;
+
+    /* g = h + 5 - 2^130, selected without a branch when h >= 2^130 - 5. */
+    g0 = h0 + 5;
+    c = g0 >> 26;
+    g0 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    g1 = h1 + c;
+    c = g1 >> 26;
+    g1 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    g2 = h2 + c;
+    c = g2 >> 26;
+    g2 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    g3 = h3 + c;
+    c = g3 >> 26;
+    g3 &= NX_CRYPTO_POLY1305_LIMB_MASK;
+    g4 = h4 + c - (1 << 26);
+
+    mask = (g4 >> 31) - 1;
+    g0 &= mask;
+    g1 &= mask;
+    g2 &= mask;
+    g3 &= mask;
+    g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    /* Pack h in 32-bit words and add s modulo 2^128. */
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    f = (ULONG64)h0 + ctx -> nx_crypto_poly1305_s[0];
+    h0 = (UINT)f;
+    f = (ULONG64)h1 + ctx -> nx_crypto_poly1305_s[1] + (f >> 32);
+    h1 = (UINT)f;
+    f = (ULONG64)h2 + ctx -> nx_crypto_poly1305_s[2] + (f >> 32);
+    h2 = (UINT)f;
+    f = (ULONG64)h3 + ctx -> nx_crypto_poly1305_s[3] + (f >> 32);
+    h3 = (UINT)f;
+
+    NX_CRYPTO_CHACHA20_STORE32(&tag[0], h0)
+    NX_CRYPTO_CHACHA20_STORE32(&tag[4], h1)
+    NX_CRYPTO_CHACHA20_STORE32(&tag[8], h2)
+    NX_CRYPTO_CHACHA20_STORE32(&tag[12], h3)
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function authenticates the padding and the lengths of the      */
+/*    message and computes its ChaCha20-Poly1305 tag.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    tag                                   Tag, 16 bytes                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_poly1305_pad               Pad data to a block           */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*    _nx_crypto_poly1305_blocks            Authenticate Poly1305 blocks  */
+/*    _nx_crypto_poly1305_finish            Compute the Poly1305 tag      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_calculate                      */
+/*                                          Compute the tag               */
+/*    _nx_crypto_chacha20_poly1305_decrypt_calculate                      */
+/*                                          Verify the tag                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_chacha20_poly1305_tag_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx, UCHAR *tag)
+{
+UCHAR length_block[NX_CRYPTO_POLY1305_BLOCK_SIZE];
+UINT  additional_len = ctx -> nx_crypto_chacha20_poly1305_additional_data_len;
+ULONG text_length = ctx -> nx_crypto_chacha20_poly1305_text_length;
+
+    /* Pad the cipher text to a block, then authenticate the lengths of the
+       additional data and of the cipher text as 64-bit little endian values. */
+    _nx_crypto_poly1305_pad(ctx);
+
+    NX_CRYPTO_MEMSET(length_block, 0, sizeof(length_block));
+    NX_CRYPTO_CHACHA20_STORE32(&length_block[0], additional_len)
+    NX_CRYPTO_CHACHA20_STORE32(&length_block[8], text_length)
+    _nx_crypto_poly1305_blocks(ctx, length_block, 1);
+
+    _nx_crypto_poly1305_finish(ctx, tag);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts the encryption or decryption of a message with */
+/*    ChaCha20-Poly1305: it sets the nonce, derives the Poly1305 key from */
+/*    block 0 and authenticates the additional data.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    additional_data                       Pointer to additional data    */
+/*    additional_len                        Length of additional data     */
+/*    iv                                    Nonce length and nonce        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_block             Compute a ChaCha20 block      */
+/*    _nx_crypto_poly1305_key_set           Set the Poly1305 key          */
+/*    _nx_crypto_poly1305_update            Authenticate data             */
+/*    _nx_crypto_poly1305_pad               Pad data to a block           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation                       */
+/*                                          Handle ChaCha20-Poly1305      */
+/*                                            encrypt or decrypt          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_chacha20_poly1305_encrypt_init(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                              VOID *additional_data, UINT additional_len,
+                                                              UCHAR *iv)
+{
+UINT *state = ctx -> nx_crypto_chacha20_state;
+
+    /* IV : Nonce length(1 byte) + Nonce */
+    if (iv[0] != NX_CRYPTO_CHACHA20_NONCE_SIZE)
+    {
+        return(NX_CRYPTO_INVALID_PARAMETER);
+    }
+
+    if ((additional_len > 0) && (additional_data == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    state[12] = 0;
+    state[13] = NX_CRYPTO_CHACHA20_LOAD32(&iv[1]);
+    state[14] = NX_CRYPTO_CHACHA20_LOAD32(&iv[5]);
+    state[15] = NX_CRYPTO_CHACHA20_LOAD32(&iv[9]);
+
+    /* The one-time Poly1305 key is the first half of block 0, the message
+       is encrypted from block 1.  */
+    _nx_crypto_chacha20_block(ctx);
+    _nx_crypto_poly1305_key_set(ctx, ctx -> nx_crypto_chacha20_key_stream);
+    ctx -> nx_crypto_chacha20_key_stream_used = NX_CRYPTO_CHACHA20_BLOCK_SIZE;
+
+    ctx -> nx_crypto_chacha20_poly1305_additional_data = additional_data;
+    ctx -> nx_crypto_chacha20_poly1305_additional_data_len = additional_len;
+    ctx -> nx_crypto_chacha20_poly1305_text_length = 0;
+
+    /* Authenticate the additional data, padded to a block. */
+    if (additional_len)
+    {
+        _nx_crypto_poly1305_update(ctx, (UCHAR *)additional_data, additional_len);
+        _nx_crypto_poly1305_pad(ctx);
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_update         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts data of a message with ChaCha20 and          */
+/*    authenticates the cipher text.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Plain text                    */
+/*    output                                Cipher text                   */
+/*    length                                Length of data                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_xor               Apply the ChaCha20 key stream */
+/*    _nx_crypto_poly1305_update            Authenticate data             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation                       */
+/*                                          Handle ChaCha20-Poly1305      */
+/*                                            encrypt or decrypt          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_chacha20_poly1305_encrypt_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                                UCHAR *input, UCHAR *output, UINT length)
+{
+
+    _nx_crypto_chacha20_xor(ctx, input, output, length);
+    _nx_crypto_poly1305_update(ctx, output, length);
+    ctx -> nx_crypto_chacha20_poly1305_text_length += length;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_encrypt_calculate      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the tag of the encrypted message.            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    output                                Output buffer of the tag      */
+/*    icv_len                               Length of the tag             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate                          */
+/*                                          Compute the AEAD tag          */
+/*    NX_CRYPTO_MEMCPY                      Copy the memory               */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation                       */
+/*                                          Handle ChaCha20-Poly1305      */
+/*                                            encrypt or decrypt          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_chacha20_poly1305_encrypt_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                                   UCHAR *output, UINT icv_len)
+{
+UCHAR tag[NX_CRYPTO_POLY1305_TAG_SIZE];
+
+    if (icv_len > NX_CRYPTO_POLY1305_TAG_SIZE)
+    {
+        return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+    }
+
+    _nx_crypto_chacha20_poly1305_tag_calculate(ctx, tag);
+    NX_CRYPTO_MEMCPY(output, tag, icv_len); /* Use case of memcpy is verified. */
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(tag, 0, sizeof(tag));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_decrypt_update         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function authenticates cipher text of a message and decrypts   */
+/*    it with ChaCha20.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Cipher text                   */
+/*    output                                Plain text                    */
+/*    length                                Length of data                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_poly1305_update            Authenticate data             */
+/*    _nx_crypto_chacha20_xor               Apply the ChaCha20 key stream */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation                       */
+/*                                          Handle ChaCha20-Poly1305      */
+/*                                            encrypt or decrypt          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_chacha20_poly1305_decrypt_update(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                                UCHAR *input, UCHAR *output, UINT length)
+{
+
+    /* Authenticate the cipher text before it is decrypted, possibly in place. */
+    _nx_crypto_poly1305_update(ctx, input, length);
+    _nx_crypto_chacha20_xor(ctx, input, output, length);
+    ctx -> nx_crypto_chacha20_poly1305_text_length += length;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_decrypt_calculate      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the tag of the decrypted message and         */
+/*    compares it with the received one in constant time.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   ChaCha20-Poly1305 context     */
+/*    input                                 Received tag                  */
+/*    icv_len                               Length of the tag             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_tag_calculate                          */
+/*                                          Compute the AEAD tag          */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation                       */
+/*                                          Handle ChaCha20-Poly1305      */
+/*                                            encrypt or decrypt          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_chacha20_poly1305_decrypt_calculate(NX_CRYPTO_CHACHA20_POLY1305 *ctx,
+                                                                   UCHAR *input, UINT icv_len)
+{
+UCHAR tag[NX_CRYPTO_POLY1305_TAG_SIZE];
+UCHAR difference = 0;
+UINT  i;
+
+    if (icv_len > NX_CRYPTO_POLY1305_TAG_SIZE)
+    {
+        return(NX_CRYPTO_INVALID_BUFFER_SIZE);
+    }
+
+    _nx_crypto_chacha20_poly1305_tag_calculate(ctx, tag);
+
+    /* Compare all the bytes of the tag, whatever the first difference. */
+    for (i = 0; i < icv_len; i++)
+    {
+        difference |= (UCHAR)(input[i] ^ tag[i]);
+    }
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(tag, 0, sizeof(tag));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    if (difference)
+    {
+
+        /* Authentication failed. */
+        return(NX_CRYPTO_AUTHENTICATION_FAILED);
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_init            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function initializes the ChaCha20-Poly1305 crypto module with  */
+/*    the 256-bit key.                                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    method                                Crypto Method Object          */
+/*    key                                   Key                           */
+/*    key_size_in_bits                      Size of the key, in bits      */
+/*    handle                                Handle, specified by user     */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Size of the metadata area     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_chacha20_poly1305_init(struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                              UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                              VOID **handle,
+                                                              VOID *crypto_metadata,
+                                                              ULONG crypto_metadata_size)
+{
+NX_CRYPTO_CHACHA20_POLY1305 *ctx;
+UINT                        *state;
+
+    NX_CRYPTO_PARAMETER_NOT_USED(handle);
+
+    NX_CRYPTO_STATE_CHECK
+
+    if ((method == NX_CRYPTO_NULL) || (key == NX_CRYPTO_NULL) || (crypto_metadata == NX_CRYPTO_NULL))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    /* Verify the metadata addrsss is 4-byte aligned. */
+    if((((ULONG)crypto_metadata) & 0x3) != 0)
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if(crypto_metadata_size < sizeof(NX_CRYPTO_CHACHA20_POLY1305))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if (key_size_in_bits != NX_CRYPTO_CHACHA20_KEY_LEN_IN_BITS)
+    {
+        return(NX_CRYPTO_UNSUPPORTED_KEY_SIZE);
+    }
+
+    ctx = (NX_CRYPTO_CHACHA20_POLY1305 *)crypto_metadata;
+    NX_CRYPTO_MEMSET(ctx, 0, sizeof(NX_CRYPTO_CHACHA20_POLY1305));
+
+    /* "expand 32-byte k", then the key. The counter and the nonce are set for each message. */
+    state = ctx -> nx_crypto_chacha20_state;
+    state[0] = 0x61707865;
+    state[1] = 0x3320646E;
+    state[2] = 0x79622D32;
+    state[3] = 0x6B206574;
+    state[4] = NX_CRYPTO_CHACHA20_LOAD32(&key[0]);
+    state[5] = NX_CRYPTO_CHACHA20_LOAD32(&key[4]);
+    state[6] = NX_CRYPTO_CHACHA20_LOAD32(&key[8]);
+    state[7] = NX_CRYPTO_CHACHA20_LOAD32(&key[12]);
+    state[8] = NX_CRYPTO_CHACHA20_LOAD32(&key[16]);
+    state[9] = NX_CRYPTO_CHACHA20_LOAD32(&key[20]);
+    state[10] = NX_CRYPTO_CHACHA20_LOAD32(&key[24]);
+    state[11] = NX_CRYPTO_CHACHA20_LOAD32(&key[28]);
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_cleanup         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function cleans up the crypto metadata.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crypto_metadata                       Crypto metadata               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_MEMSET                      Set the memory                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_chacha20_poly1305_cleanup(VOID *crypto_metadata)
+{
+
+    NX_CRYPTO_STATE_CHECK
+
+#ifdef NX_SECURE_KEY_CLEAR
+    if (!crypto_metadata)
+        return (NX_CRYPTO_SUCCESS);
+
+    /* Clean up the crypto metadata.  */
+    NX_CRYPTO_MEMSET(crypto_metadata, 0, sizeof(NX_CRYPTO_CHACHA20_POLY1305));
+#else
+    NX_CRYPTO_PARAMETER_NOT_USED(crypto_metadata);
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_chacha20_poly1305_operation       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encrypts and decrypts a message using the             */
+/*    ChaCha20-Poly1305 AEAD algorithm.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    ChaCha20-Poly1305 operation   */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_chacha20_poly1305_decrypt_init                           */
+/*                                          Initialize decryption         */
+/*    _nx_crypto_chacha20_poly1305_decrypt_update                         */
+/*                                          Decrypt data                  */
+/*    _nx_crypto_chacha20_poly1305_decrypt_calculate                      */
+/*                                          Verify the tag                */
+/*    _nx_crypto_chacha20_poly1305_encrypt_init                           */
+/*                                          Initialize encryption         */
+/*    _nx_crypto_chacha20_poly1305_encrypt_update                         */
+/*                                          Encrypt data                  */
+/*    _nx_crypto_chacha20_poly1305_encrypt_calculate                      */
+/*                                          Compute the tag               */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_method_chacha20_poly1305_operation(UINT op,      /* Encrypt, Decrypt, Authenticate */
+                                                                   VOID *handle, /* Crypto handler */
+                                                                   struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                                   UCHAR *key,
+                                                                   NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                                   UCHAR *input,
+                                                                   ULONG input_length_in_byte,
+                                                                   UCHAR *iv_ptr,
+                                                                   UCHAR *output,
+                                                                   ULONG output_length_in_byte,
+                                                                   VOID *crypto_metadata,
+                                                                   ULONG crypto_metadata_size,
+                                                                   VOID *packet_ptr,
+                                                                   VOID (*nx_crypto_hw_process_callback)(VOID *packet_ptr, UINT status))
+{
+
+NX_CRYPTO_CHACHA20_POLY1305 *ctx;
+UINT                         icv_len;
+UINT                         message_len;
+UINT                         status;
+
+    NX_CRYPTO_PARAMETER_NOT_USED(handle);
+    NX_CRYPTO_PARAMETER_NOT_USED(key);
+    NX_CRYPTO_PARAMETER_NOT_USED(key_size_in_bits);
+    NX_CRYPTO_PARAMETER_NOT_USED(packet_ptr);
+    NX_CRYPTO_PARAMETER_NOT_USED(nx_crypto_hw_process_callback);
+
+    NX_CRYPTO_STATE_CHECK
+
+    /* Verify the metadata addrsss is 4-byte aligned. */
+    if((method == NX_CRYPTO_NULL) || (crypto_metadata == NX_CRYPTO_NULL) || ((((ULONG)crypto_metadata) & 0x3) != 0))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if(crypto_metadata_size < sizeof(NX_CRYPTO_CHACHA20_POLY1305))
+    {
+        return(NX_CRYPTO_PTR_ERROR);
+    }
+
+    if (method -> nx_crypto_algorithm != NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305)
+    {
+        return(NX_CRYPTO_INVALID_ALGORITHM);
+    }
+
+    ctx = (NX_CRYPTO_CHACHA20_POLY1305 *)crypto_metadata;
+    icv_len = (method -> nx_crypto_ICV_size_in_bits >> 3);
+
+    /* IV : Nonce length(1 byte) + Nonce
+       nx_crypto_ICV_size_in_bits: authentication tag length in bits */
+    switch (op)
+    {
+        case NX_CRYPTO_DECRYPT:
+        {
+            if (iv_ptr == NX_CRYPTO_NULL)
+            {
+                status = NX_CRYPTO_PTR_ERROR;
+                break;
+            }
+
+            if (input_length_in_byte < icv_len || output_length_in_byte < input_length_in_byte - icv_len)
+            {
+                status = NX_CRYPTO_INVALID_BUFFER_SIZE;
+                break;
+            }
+
+            message_len = input_length_in_byte - icv_len;
+            status = _nx_crypto_chacha20_poly1305_decrypt_init(ctx,
+                                                               ctx -> nx_crypto_chacha20_poly1305_additional_data,
+                                                               ctx -> nx_crypto_chacha20_poly1305_additional_data_len,
+                                                               iv_ptr);
+
+            if (status)
+            {
+                break;
+            }
+
+            _nx_crypto_chacha20_poly1305_decrypt_update(ctx, input, output, message_len);
+
+            status = _nx_crypto_chacha20_poly1305_decrypt_calculate(ctx, input + message_len, icv_len);
+        } break;
+
+        case NX_CRYPTO_ENCRYPT:
+        {
+            if (iv_ptr == NX_CRYPTO_NULL)
+            {
+                status = NX_CRYPTO_PTR_ERROR;
+                break;
+            }
+
+            if (output_length_in_byte < input_length_in_byte + icv_len)
+            {
+                status = NX_CRYPTO_INVALID_BUFFER_SIZE;
+                break;
+            }
+
+            status = _nx_crypto_chacha20_poly1305_encrypt_init(ctx,
+                                                               ctx -> nx_crypto_chacha20_poly1305_additional_data,
+                                                               ctx -> nx_crypto_chacha20_poly1305_additional_data_len,
+                                                               iv_ptr);
+
+            if (status)
+            {
+                break;
+            }
+
+            _nx_crypto_chacha20_poly1305_encrypt_update(ctx, input, output, input_length_in_byte);
+
+            status = _nx_crypto_chacha20_poly1305_encrypt_calculate(ctx, output + input_length_in_byte, icv_len);
+        } break;
+
+        case NX_CRYPTO_DECRYPT_INITIALIZE:
+        {
+            if (iv_ptr == NX_CRYPTO_NULL)
+            {
+                status = NX_CRYPTO_PTR_ERROR;
+                break;
+            }
+
+            status = _nx_crypto_chacha20_poly1305_decrypt_init(ctx,
+                                                               input, /* pointers to AAD */
+                                                               input_length_in_byte, /* length of AAD */
+                                                               iv_ptr);
+        } break;
+
+        case NX_CRYPTO_DECRYPT_UPDATE:
+        {
+            status = _nx_crypto_chacha20_poly1305_decrypt_update(ctx, input, output, input_length_in_byte);
+        } break;
+
+        case NX_CRYPTO_DECRYPT_CALCULATE:
+        {
+            if (input_length_in_byte < icv_len)
+            {
+                status = NX_CRYPTO_INVALID_BUFFER_SIZE;
+                break;
+            }
+
+            status = _nx_crypto_chacha20_poly1305_decrypt_calculate(ctx, input, icv_len);
+        } break;
+
+        case NX_CRYPTO_ENCRYPT_INITIALIZE:
+        {
+            if (iv_ptr == NX_CRYPTO_NULL)
+            {
+                status = NX_CRYPTO_PTR_ERROR;
+                break;
+            }
+
+            status = _nx_crypto_chacha20_poly1305_encrypt_init(ctx,
+                                                               input, /* pointers to AAD */
+                                                               input_length_in_byte, /* length of AAD */
+                                                               iv_ptr);
+        } break;
+
+        case NX_CRYPTO_ENCRYPT_UPDATE:
+        {
+            status = _nx_crypto_chacha20_poly1305_encrypt_update(ctx, input, output, input_length_in_byte);
+        } break;
+
+        case NX_CRYPTO_ENCRYPT_CALCULATE:
+        {
+            if (output_length_in_byte < icv_len)
+            {
+                status = NX_CRYPTO_INVALID_BUFFER_SIZE;
+                break;
+            }
+
+            status = _nx_crypto_chacha20_poly1305_encrypt_calculate(ctx, output, icv_len);
+        } break;
+
+        case NX_CRYPTO_SET_ADDITIONAL_DATA:
+        {
+
+            /* Set additonal data pointer.  */
+            ctx -> nx_crypto_chacha20_poly1305_additional_data = (VOID *)input;
+
+            /* Set additional data length.  */
+            ctx -> nx_crypto_chacha20_poly1305_additional_data_len = input_length_in_byte;
+
+            status = NX_CRYPTO_SUCCESS;
+        } break;
+
+        default:
+        {
+            status = NX_CRYPTO_INVALID_ALGORITHM;
+        } break;
+    }
+
+    return(status);
+}
@@ -21,6 +21,10 @@
 /**************************************************************************/
 
 #include "nx_crypto_ctr.h"
+#include "nx_crypto_aes.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
 
 /**************************************************************************/
 /*                                                                        */
@@ -192,6 +196,10 @@ USHORT result;
 /*                                                                        */
 /*    _nx_crypto_ctr_xor                    Perform XOR operation         */
 /*    _nx_crypto_ctr_add_one                Perform add one operation     */
+/*    _nx_crypto_aes_ctr_encrypt_blocks     Encrypt blocks in counter mode*/
+/*    _nx_crypto_stm32_aes_ctr_encrypt_blocks                             */
+/*                                          Encrypt blocks in the CRYP    */
+/*                                            peripheral                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -221,7 +229,27 @@ UINT   i;
         return(NX_CRYPTO_PTR_ERROR);
     }
 
-    for (i = 0; i < length; i += block_size)
+    i = 0;
+    if (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt)
+    {
+
+        /* Software AES: process all the full blocks in one call rather than one call per block.  */
+        i = length & ~(UINT)(NX_CRYPTO_CTR_BLOCK_SIZE - 1);
+        _nx_crypto_aes_ctr_encrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, control_block, input, output,
+                                          length / NX_CRYPTO_CTR_BLOCK_SIZE);
+    }
+#ifdef NX_CRYPTO_STM32_HW
+    else if (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt)
+    {
+
+        /* CRYP peripheral: the same counter, incremented in its last 32 bits, in one call.  */
+        i = length & ~(UINT)(NX_CRYPTO_CTR_BLOCK_SIZE - 1);
+        _nx_crypto_stm32_aes_ctr_encrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, control_block, input, output,
+                                                length / NX_CRYPTO_CTR_BLOCK_SIZE);
+    }
+#endif /* NX_CRYPTO_STM32_HW */
+
+    for (; i < length; i += block_size)
     {
         if (length - i < block_size)
         {
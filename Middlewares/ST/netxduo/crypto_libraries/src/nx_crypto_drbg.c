@@ -34,6 +34,15 @@ static UCHAR _nx_crypto_ctr_metadata[NX_CRYPTO_DRBG_CTR_METADATA_SIZE];
 
 static NX_CRYPTO_DRBG _nx_crypto_drbg_ctx;
 
+#if (NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN > 0)
+/* Output of _nx_crypto_drbg_ctx not given out yet, at the end of the buffer.
+   Bytes are cleared as they are given out.  */
+static UCHAR _nx_crypto_drbg_output[NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN];
+static UINT  _nx_crypto_drbg_output_left;
+
+static UINT _nx_crypto_drbg_buffered_generate(UCHAR *output, UINT output_length_in_byte);
+#endif
+
 static const UCHAR zeroiv[16] = { 0 };
 static const UCHAR _nx_crypto_drbg_df_key[] = {
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
@@ -1184,11 +1193,18 @@ UINT            status = NX_CRYPTO_SUCCESS;
 NX_CRYPTO_KEEP static UINT _nx_crypto_drbg_rnd_entropy_input(UCHAR *entropy, UINT *entropy_len,
                                                              UINT entropy_max_len)
 {
+#ifndef NX_CRYPTO_RAND_BYTES
 UINT bytes;
 UINT random_number;
+#endif
 
     NX_CRYPTO_PARAMETER_NOT_USED(entropy_max_len);
 
+#ifdef NX_CRYPTO_RAND_BYTES
+
+    /* Take all the entropy bytes at once. */
+    NX_CRYPTO_RAND_BYTES(entropy, *entropy_len);
+#else
     bytes = *entropy_len;
 
     while (bytes > 3)
@@ -1215,6 +1231,7 @@ UINT random_number;
         entropy++;
         bytes--;
     }
+#endif /* NX_CRYPTO_RAND_BYTES */
 
     return(NX_CRYPTO_SUCCESS);
 }
@@ -1254,14 +1271,24 @@ UINT status;
         _nx_crypto_drbg_initialize();
     }
 
-    status = _nx_crypto_drbg_generate(&_nx_crypto_drbg_ctx, result, bytes, NX_CRYPTO_NULL, 0);
-    if (status)
+#if (NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN > 0)
+    if (!_nx_crypto_drbg_ctx.nx_crypto_drbg_prediction_resistance)
     {
-        return(status);
+        status = _nx_crypto_drbg_buffered_generate(result, bytes);
+    }
+    else
+#endif
+    {
+        status = _nx_crypto_drbg_generate(&_nx_crypto_drbg_ctx, result, bytes, NX_CRYPTO_NULL, 0);
     }
 
     NX_CRYPTO_DRBG_MUTEX_PUT;
 
+    if (status)
+    {
+        return(status);
+    }
+
     /* Zero out extra bits generated. */
     bits = bits & 7;
     if (bits)
@@ -1272,3 +1299,81 @@ UINT status;
 
     return(status);
 }
+
+#if (NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN > 0)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_drbg_buffered_generate                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function gives out bytes of the DRBG of _nx_crypto_drbg() from */
+/*    its output buffer, which is refilled with one generate request of   */
+/*    NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN bytes when it runs out. A request  */
+/*    larger than the buffer is generated directly. The caller holds the  */
+/*    DRBG mutex.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    output                                Pointer to output buffer      */
+/*    output_length_in_byte                 Number of bytes requested     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_drbg_generate              Generate bits from DRBG       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_drbg                       Generate random bits          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static UINT _nx_crypto_drbg_buffered_generate(UCHAR *output, UINT output_length_in_byte)
+{
+UINT   status;
+UINT   length;
+UCHAR *start;
+
+    if (output_length_in_byte > NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN)
+    {
+        return(_nx_crypto_drbg_generate(&_nx_crypto_drbg_ctx, output, output_length_in_byte, NX_CRYPTO_NULL, 0));
+    }
+
+    while (output_length_in_byte > 0)
+    {
+        if (_nx_crypto_drbg_output_left == 0)
+        {
+            status = _nx_crypto_drbg_generate(&_nx_crypto_drbg_ctx, _nx_crypto_drbg_output,
+                                              NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN, NX_CRYPTO_NULL, 0);
+            if (status != NX_CRYPTO_SUCCESS)
+            {
+                return(status);
+            }
+
+            _nx_crypto_drbg_output_left = NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN;
+        }
+
+        length = output_length_in_byte;
+        if (length > _nx_crypto_drbg_output_left)
+        {
+            length = _nx_crypto_drbg_output_left;
+        }
+
+        /* Bytes given out are cleared, so that they cannot be read back later.  */
+        start = &_nx_crypto_drbg_output[NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN - _nx_crypto_drbg_output_left];
+        NX_CRYPTO_MEMCPY(output, start, length); /* Use case of memcpy is verified. */
+        NX_CRYPTO_MEMSET(start, 0, length);
+
+        _nx_crypto_drbg_output_left -= length;
+        output += length;
+        output_length_in_byte -= length;
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
+#endif /* NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN */
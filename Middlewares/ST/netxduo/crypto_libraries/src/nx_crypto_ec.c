@@ -71,6 +71,15 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp192r1_n[] =
     HN_ULONG_TO_UBASE(0x99DEF836), HN_ULONG_TO_UBASE(0xFFFFFFFF),
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF)
 };
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp192r1_n_mu[] =
+{
+
+    /* mu = 2^384 / n, for the Barrett reduction modulo n */
+    HN_ULONG_TO_UBASE(0x4B2DD7CF), HN_ULONG_TO_UBASE(0xEB94364E),
+    HN_ULONG_TO_UBASE(0x662107C9), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000001)
+};
 static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp192r1_h[] =
 {
 
@@ -133,6 +142,15 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp224r1_n[] =
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
     HN_ULONG_TO_UBASE(0xFFFFFFFF)
 };
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp224r1_n_mu[] =
+{
+
+    /* mu = 2^448 / n, for the Barrett reduction modulo n */
+    HN_ULONG_TO_UBASE(0xA3A3D5C3), HN_ULONG_TO_UBASE(0xEC22D6BA),
+    HN_ULONG_TO_UBASE(0x1F470FC1), HN_ULONG_TO_UBASE(0x0000E95D),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000001)
+};
 static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp224r1_h[] =
 {
 
@@ -195,6 +213,16 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp256r1_n[] =
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
     HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0xFFFFFFFF)
 };
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp256r1_n_mu[] =
+{
+
+    /* mu = 2^512 / n, for the Barrett reduction modulo n */
+    HN_ULONG_TO_UBASE(0xEEDF9BFE), HN_ULONG_TO_UBASE(0x012FFD85),
+    HN_ULONG_TO_UBASE(0xDF1A6C21), HN_ULONG_TO_UBASE(0x43190552),
+    HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFE),
+    HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000001)
+};
 static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp256r1_h[] =
 {
 
@@ -271,6 +299,18 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp384r1_n[] =
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF)
 };
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp384r1_n_mu[] =
+{
+
+    /* mu = 2^768 / n, for the Barrett reduction modulo n */
+    HN_ULONG_TO_UBASE(0x333AD68D), HN_ULONG_TO_UBASE(0x1313E695),
+    HN_ULONG_TO_UBASE(0xB74F5885), HN_ULONG_TO_UBASE(0xA7E5F24D),
+    HN_ULONG_TO_UBASE(0x0BC8D220), HN_ULONG_TO_UBASE(0x389CB27E),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000001)
+};
 static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp384r1_h[] =
 {
 
@@ -363,6 +403,20 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp521r1_n[] =
     HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
     HN_ULONG_TO_UBASE(0x000001FF)
 };
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp521r1_n_mu[] =
+{
+
+    /* mu = 2^1088 / n, for the Barrett reduction modulo n */
+    HN_ULONG_TO_UBASE(0xF501C8D1), HN_ULONG_TO_UBASE(0xE6FDC408),
+    HN_ULONG_TO_UBASE(0x12385BB1), HN_ULONG_TO_UBASE(0xEE145124),
+    HN_ULONG_TO_UBASE(0x8D91DD98), HN_ULONG_TO_UBASE(0x968BF112),
+    HN_ULONG_TO_UBASE(0xFFADC23D), HN_ULONG_TO_UBASE(0x1A65200C),
+    HN_ULONG_TO_UBASE(0x5E1F1034), HN_ULONG_TO_UBASE(0x00016B9E),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00800000)
+};
 static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp521r1_h[] =
 {
 
@@ -370,6 +424,61 @@ static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp521r1_h[] =
     HN_ULONG_TO_UBASE(0x00000001)
 };
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+/* curve25519, the Montgomery curve v^2 = u^3 + a * u^2 + u of X25519. */
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_p[] =
+{
+
+    /* p = 7FFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFED */
+    HN_ULONG_TO_UBASE(0xFFFFFFED), HN_ULONG_TO_UBASE(0xFFFFFFFF),
+    HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
+    HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0xFFFFFFFF),
+    HN_ULONG_TO_UBASE(0xFFFFFFFF), HN_ULONG_TO_UBASE(0x7FFFFFFF)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_a[] =
+{
+
+    /* a = 076D06 */
+    HN_ULONG_TO_UBASE(0x00076D06)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_b[] =
+{
+
+    /* b = 01 */
+    HN_ULONG_TO_UBASE(0x00000001)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_gx[] =
+{
+
+    /* G.u = 09 */
+    HN_ULONG_TO_UBASE(0x00000009)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_gy[] =
+{
+
+    /* G.v = 20AE19A1 B8A086B4 E01EDD2C 7748D14C 923D4D7E 6D7C61B2 29E9C5A2 7ECED3D9 */
+    HN_ULONG_TO_UBASE(0x7ECED3D9), HN_ULONG_TO_UBASE(0x29E9C5A2),
+    HN_ULONG_TO_UBASE(0x6D7C61B2), HN_ULONG_TO_UBASE(0x923D4D7E),
+    HN_ULONG_TO_UBASE(0x7748D14C), HN_ULONG_TO_UBASE(0xE01EDD2C),
+    HN_ULONG_TO_UBASE(0xB8A086B4), HN_ULONG_TO_UBASE(0x20AE19A1)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_n[] =
+{
+
+    /* n = 10000000 00000000 00000000 00000000 14DEF9DE A2F79CD6 5812631A 5CF5D3ED */
+    HN_ULONG_TO_UBASE(0x5CF5D3ED), HN_ULONG_TO_UBASE(0x5812631A),
+    HN_ULONG_TO_UBASE(0xA2F79CD6), HN_ULONG_TO_UBASE(0x14DEF9DE),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x00000000),
+    HN_ULONG_TO_UBASE(0x00000000), HN_ULONG_TO_UBASE(0x10000000)
+};
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_x25519_h[] =
+{
+
+    /* h = 08 */
+    HN_ULONG_TO_UBASE(0x00000008)
+};
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
 extern NX_CRYPTO_CONST NX_CRYPTO_EC_FIXED_POINTS _nx_crypto_ec_secp192r1_fixed_points;
 extern NX_CRYPTO_CONST NX_CRYPTO_EC_FIXED_POINTS _nx_crypto_ec_secp224r1_fixed_points;
 extern NX_CRYPTO_CONST NX_CRYPTO_EC_FIXED_POINTS _nx_crypto_ec_secp256r1_fixed_points;
@@ -431,11 +540,18 @@ NX_CRYPTO_CONST NX_CRYPTO_EC                     _nx_crypto_ec_secp192r1 =
         sizeof(_nx_crypto_ec_secp192r1_h),
         (UINT)NX_CRYPTO_FALSE
     },
+    {
+        (HN_UBASE *)_nx_crypto_ec_secp192r1_n_mu,
+        sizeof(_nx_crypto_ec_secp192r1_n_mu) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_secp192r1_n_mu),
+        (UINT)NX_CRYPTO_FALSE
+    },
     (NX_CRYPTO_EC_FIXED_POINTS *)&_nx_crypto_ec_secp192r1_fixed_points,
     _nx_crypto_ec_fp_affine_add,
     _nx_crypto_ec_fp_affine_subtract,
     _nx_crypto_ec_fp_projective_multiple,
-    _nx_crypto_ec_secp192r1_reduce
+    _nx_crypto_ec_secp192r1_reduce,
+    _nx_crypto_ec_fp_multiple_add
 };
 
 NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp224r1 =
@@ -493,11 +609,18 @@ NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp224r1 =
         sizeof(_nx_crypto_ec_secp224r1_h),
         (UINT)NX_CRYPTO_FALSE
     },
+    {
+        (HN_UBASE *)_nx_crypto_ec_secp224r1_n_mu,
+        sizeof(_nx_crypto_ec_secp224r1_n_mu) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_secp224r1_n_mu),
+        (UINT)NX_CRYPTO_FALSE
+    },
     (NX_CRYPTO_EC_FIXED_POINTS *)&_nx_crypto_ec_secp224r1_fixed_points,
     _nx_crypto_ec_fp_affine_add,
     _nx_crypto_ec_fp_affine_subtract,
     _nx_crypto_ec_fp_projective_multiple,
-    _nx_crypto_ec_secp224r1_reduce
+    _nx_crypto_ec_secp224r1_reduce,
+    _nx_crypto_ec_fp_multiple_add
 };
 
 NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp256r1 =
@@ -555,11 +678,26 @@ NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp256r1 =
         sizeof(_nx_crypto_ec_secp256r1_h),
         (UINT)NX_CRYPTO_FALSE
     },
+    {
+        (HN_UBASE *)_nx_crypto_ec_secp256r1_n_mu,
+        sizeof(_nx_crypto_ec_secp256r1_n_mu) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_secp256r1_n_mu),
+        (UINT)NX_CRYPTO_FALSE
+    },
     (NX_CRYPTO_EC_FIXED_POINTS *)&_nx_crypto_ec_secp256r1_fixed_points,
     _nx_crypto_ec_fp_affine_add,
     _nx_crypto_ec_fp_affine_subtract,
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32)
+    _nx_crypto_ec_secp256r1_multiple,
+#else
     _nx_crypto_ec_fp_projective_multiple,
-    _nx_crypto_ec_secp256r1_reduce
+#endif
+    _nx_crypto_ec_secp256r1_reduce,
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32)
+    _nx_crypto_ec_secp256r1_multiple_add
+#else
+    _nx_crypto_ec_fp_multiple_add
+#endif
 };
 
 NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp384r1 =
@@ -617,11 +755,18 @@ NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp384r1 =
         sizeof(_nx_crypto_ec_secp384r1_h),
         (UINT)NX_CRYPTO_FALSE
     },
+    {
+        (HN_UBASE *)_nx_crypto_ec_secp384r1_n_mu,
+        sizeof(_nx_crypto_ec_secp384r1_n_mu) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_secp384r1_n_mu),
+        (UINT)NX_CRYPTO_FALSE
+    },
     (NX_CRYPTO_EC_FIXED_POINTS *)&_nx_crypto_ec_secp384r1_fixed_points,
     _nx_crypto_ec_fp_affine_add,
     _nx_crypto_ec_fp_affine_subtract,
     _nx_crypto_ec_fp_projective_multiple,
-    _nx_crypto_ec_secp384r1_reduce
+    _nx_crypto_ec_secp384r1_reduce,
+    _nx_crypto_ec_fp_multiple_add
 };
 
 NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp521r1 =
@@ -679,12 +824,87 @@ NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_secp521r1 =
         sizeof(_nx_crypto_ec_secp521r1_h),
         (UINT)NX_CRYPTO_FALSE
     },
+    {
+        (HN_UBASE *)_nx_crypto_ec_secp521r1_n_mu,
+        sizeof(_nx_crypto_ec_secp521r1_n_mu) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_secp521r1_n_mu),
+        (UINT)NX_CRYPTO_FALSE
+    },
     (NX_CRYPTO_EC_FIXED_POINTS *)&_nx_crypto_ec_secp521r1_fixed_points,
     _nx_crypto_ec_fp_affine_add,
     _nx_crypto_ec_fp_affine_subtract,
     _nx_crypto_ec_fp_projective_multiple,
-    _nx_crypto_ec_secp521r1_reduce
+    _nx_crypto_ec_secp521r1_reduce,
+    _nx_crypto_ec_fp_multiple_add
 };
+
+#ifdef NX_CRYPTO_ENABLE_X25519
+/* Only the u-coordinates are used, by _nx_crypto_ec_x25519_multiple and the
+   ECDH. The curve has no point addition nor reduction for ECDSA.  */
+NX_CRYPTO_CONST NX_CRYPTO_EC _nx_crypto_ec_x25519 =
+{
+    "x25519",
+    NX_CRYPTO_EC_X25519,
+    0,
+    255,
+    {
+        .fp =
+        {
+            (HN_UBASE *)_nx_crypto_ec_x25519_p,
+            sizeof(_nx_crypto_ec_x25519_p) >> HN_SIZE_SHIFT,
+            sizeof(_nx_crypto_ec_x25519_p),
+            (UINT)NX_CRYPTO_FALSE
+        }
+    },
+    {
+        (HN_UBASE *)_nx_crypto_ec_x25519_a,
+        sizeof(_nx_crypto_ec_x25519_a) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_x25519_a),
+        (UINT)NX_CRYPTO_FALSE
+    },
+    {
+        (HN_UBASE *)_nx_crypto_ec_x25519_b,
+        sizeof(_nx_crypto_ec_x25519_b) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_x25519_b),
+        (UINT)NX_CRYPTO_FALSE
+    },
+    {
+        NX_CRYPTO_EC_POINT_AFFINE,
+        {
+            (HN_UBASE *)_nx_crypto_ec_x25519_gx,
+            sizeof(_nx_crypto_ec_x25519_gx) >> HN_SIZE_SHIFT,
+            sizeof(_nx_crypto_ec_x25519_gx),
+            (UINT)NX_CRYPTO_FALSE
+        },
+        {
+            (HN_UBASE *)_nx_crypto_ec_x25519_gy,
+            sizeof(_nx_crypto_ec_x25519_gy) >> HN_SIZE_SHIFT,
+            sizeof(_nx_crypto_ec_x25519_gy),
+            (UINT)NX_CRYPTO_FALSE
+        },
+        {(HN_UBASE *)NX_CRYPTO_NULL, 0u, 0u, 0u}
+    },
+    {
+        (HN_UBASE *)_nx_crypto_ec_x25519_n,
+        sizeof(_nx_crypto_ec_x25519_n) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_x25519_n),
+        (UINT)NX_CRYPTO_FALSE
+    },
+    {
+        (HN_UBASE *)_nx_crypto_ec_x25519_h,
+        sizeof(_nx_crypto_ec_x25519_h) >> HN_SIZE_SHIFT,
+        sizeof(_nx_crypto_ec_x25519_h),
+        (UINT)NX_CRYPTO_FALSE
+    },
+    {(HN_UBASE *)NX_CRYPTO_NULL, 0u, 0u, 0u},
+    (NX_CRYPTO_EC_FIXED_POINTS *)NX_CRYPTO_NULL,
+    NX_CRYPTO_NULL,
+    NX_CRYPTO_NULL,
+    _nx_crypto_ec_x25519_multiple,
+    NX_CRYPTO_NULL,
+    NX_CRYPTO_NULL
+};
+#endif /* NX_CRYPTO_ENABLE_X25519 */
 #ifndef NX_CRYPTO_SELF_TEST
 static NX_CRYPTO_CONST NX_CRYPTO_EC *_nx_crypto_ec_named_curves[] =
 {
@@ -3085,6 +3305,61 @@ UINT                       j;
                                &projective_point.nx_crypto_ec_point_y);
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_ec_fp_multiple_add                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates r = g * u1 + q * u2 with g the base point  */
+/*    of the curve, by the two multiplications of the curve and an affine */
+/*    addition. It is the multiple add of the curves without a            */
+/*    simultaneous multiplication of their own.                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve                                 Pointer to curve              */
+/*    u1                                    Factor of the base point      */
+/*    q                                     Point q                       */
+/*    u2                                    Factor of q                   */
+/*    r                                     Result r                      */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_EC_POINT_INITIALIZE         Initialize EC point           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*    _nx_crypto_ecdsa_verify               Verify hash data using ECDSA  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_ec_fp_multiple_add(NX_CRYPTO_EC *curve,
+                                                  NX_CRYPTO_HUGE_NUMBER *u1,
+                                                  NX_CRYPTO_EC_POINT *q,
+                                                  NX_CRYPTO_HUGE_NUMBER *u2,
+                                                  NX_CRYPTO_EC_POINT *r,
+                                                  HN_UBASE *scratch)
+{
+NX_CRYPTO_EC_POINT pt;
+UINT               buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffer_size;
+
+    NX_CRYPTO_EC_POINT_INITIALIZE(&pt, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
+
+    curve -> nx_crypto_ec_multiple(curve, &curve -> nx_crypto_ec_g, u1, r, scratch);
+    curve -> nx_crypto_ec_multiple(curve, q, u2, &pt, scratch);
+    curve -> nx_crypto_ec_add(curve, r, &pt, scratch);
+}
+
 /* nist.fips.186-4 APPENDIX B.4.1 */
 /**************************************************************************/
 /*                                                                        */
@@ -4234,6 +4509,83 @@ NX_CRYPTO_KEEP UINT _nx_crypto_method_ec_secp521r1_operation(UINT op,
     return(NX_CRYPTO_SUCCESS);
 }
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_method_ec_x25519_operation               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the curve25519 of X25519.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    op                                    Operation                     */
+/*    handle                                Crypto handle                 */
+/*    method                                Cryption Method Object        */
+/*    key                                   Encryption Key                */
+/*    key_size_in_bits                      Key size in bits              */
+/*    input                                 Input data                    */
+/*    input_length_in_byte                  Input data size               */
+/*    iv_ptr                                Initial vector                */
+/*    output                                Output buffer                 */
+/*    output_length_in_byte                 Output buffer size            */
+/*    crypto_metadata                       Metadata area                 */
+/*    crypto_metadata_size                  Metadata area size            */
+/*    packet_ptr                            Pointer to packet             */
+/*    nx_crypto_hw_process_callback         Callback function pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_method_ec_x25519_operation(UINT op,
+                                                          VOID *handle,
+                                                          struct NX_CRYPTO_METHOD_STRUCT *method,
+                                                          UCHAR *key, NX_CRYPTO_KEY_SIZE key_size_in_bits,
+                                                          UCHAR *input, ULONG input_length_in_byte,
+                                                          UCHAR *iv_ptr,
+                                                          UCHAR *output, ULONG output_length_in_byte,
+                                                          VOID *crypto_metadata, ULONG crypto_metadata_size,
+                                                          VOID *packet_ptr,
+                                                          VOID (*nx_crypto_hw_process_callback)(VOID *, UINT))
+{
+    NX_CRYPTO_PARAMETER_NOT_USED(handle);
+    NX_CRYPTO_PARAMETER_NOT_USED(method);
+    NX_CRYPTO_PARAMETER_NOT_USED(key);
+    NX_CRYPTO_PARAMETER_NOT_USED(key_size_in_bits);
+    NX_CRYPTO_PARAMETER_NOT_USED(input);
+    NX_CRYPTO_PARAMETER_NOT_USED(input_length_in_byte);
+    NX_CRYPTO_PARAMETER_NOT_USED(iv_ptr);
+    NX_CRYPTO_PARAMETER_NOT_USED(output);
+    NX_CRYPTO_PARAMETER_NOT_USED(output_length_in_byte);
+    NX_CRYPTO_PARAMETER_NOT_USED(crypto_metadata);
+    NX_CRYPTO_PARAMETER_NOT_USED(crypto_metadata_size);
+    NX_CRYPTO_PARAMETER_NOT_USED(packet_ptr);
+    NX_CRYPTO_PARAMETER_NOT_USED(nx_crypto_hw_process_callback);
+
+    if (op != NX_CRYPTO_EC_CURVE_GET)
+    {
+        return(NX_CRYPTO_NOT_SUCCESSFUL);
+    }
+
+    *((NX_CRYPTO_EC **)output) = (NX_CRYPTO_EC *)&_nx_crypto_ec_x25519;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
 
 /**************************************************************************/
 /*                                                                        */
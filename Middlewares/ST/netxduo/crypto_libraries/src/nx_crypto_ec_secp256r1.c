@@ -0,0 +1,1927 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   Elliptical Curve Cryptography                                       */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#include "nx_crypto_ec.h"
+
+#if (NX_CRYPTO_HUGE_NUMBER_BITS == 32)
+
+/* The field elements of secp256r1 are 8 digits, least significant first,
+   always reduced below p = 2^256 - 2^224 + 2^192 + 2^96 - 1. The field
+   operations run in constant time: they never branch on the value or
+   index memory with it.  */
+#define NX_CRYPTO_EC_SECP256R1_DIGITS      8
+
+/* Signed carry of the subtractions and of the reduction. HN_BASE2 is not
+   used, its LONG64 is not defined with the ThreadX ports. */
+#define NX_CRYPTO_EC_CARRY                 long long
+
+/* Window of the wNAF of the factor of q in _nx_crypto_ec_secp256r1_multiple_add,
+   and its count of odd multiples of q. A digit of the wNAF is its odd magnitude,
+   with NX_CRYPTO_EC_SECP256R1_WNAF_NEGATIVE set when negative.  */
+#define NX_CRYPTO_EC_SECP256R1_WNAF_WIDTH  5
+#define NX_CRYPTO_EC_SECP256R1_WNAF_TABLE  (1u << (NX_CRYPTO_EC_SECP256R1_WNAF_WIDTH - 2))
+#define NX_CRYPTO_EC_SECP256R1_WNAF_NEGATIVE 0x80u
+
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp256r1_fe_p[NX_CRYPTO_EC_SECP256R1_DIGITS] =
+{
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF
+};
+
+static NX_CRYPTO_CONST HN_UBASE _nx_crypto_ec_secp256r1_fe_zero[NX_CRYPTO_EC_SECP256R1_DIGITS] =
+{
+    0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000
+};
+
+static VOID _nx_crypto_ec_secp256r1_fe_add(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_secp256r1_fe_subtract(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_secp256r1_fe_reduce(HN_UBASE *r, const HN_UBASE *c);
+static VOID _nx_crypto_ec_secp256r1_fe_multiply(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_secp256r1_fe_square(HN_UBASE *r, const HN_UBASE *a);
+static VOID _nx_crypto_ec_secp256r1_fe_square_multiply(HN_UBASE *r, const HN_UBASE *a, UINT n,
+                                                       const HN_UBASE *b);
+static VOID _nx_crypto_ec_secp256r1_fe_inverse(HN_UBASE *r, const HN_UBASE *a, HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_fe_select(HN_UBASE *r, const HN_UBASE *a, HN_UBASE mask);
+static VOID _nx_crypto_ec_secp256r1_fe_swap(HN_UBASE *a, HN_UBASE *b, HN_UBASE mask);
+static HN_UBASE _nx_crypto_ec_secp256r1_fe_is_zero(const HN_UBASE *a);
+static VOID _nx_crypto_ec_secp256r1_point_double(HN_UBASE *x, HN_UBASE *y, HN_UBASE *z, HN_UBASE *scratch);
+static UINT _nx_crypto_ec_secp256r1_point_add(HN_UBASE *x1, HN_UBASE *y1, HN_UBASE *z1,
+                                              const HN_UBASE *x2, const HN_UBASE *y2,
+                                              HN_UBASE *x3, HN_UBASE *y3, HN_UBASE *z3,
+                                              HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_co_z_add(HN_UBASE *x1, HN_UBASE *y1, HN_UBASE *x2, HN_UBASE *y2,
+                                             HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_co_z_add_conjugate(HN_UBASE *x1, HN_UBASE *y1, HN_UBASE *x2, HN_UBASE *y2,
+                                                       HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_ladder_multiple(const HN_UBASE *px, const HN_UBASE *py, const HN_UBASE *k,
+                                                    const HN_UBASE *n, HN_UBASE *rx, HN_UBASE *ry,
+                                                    HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_comb_multiple(NX_CRYPTO_EC *curve, const HN_UBASE *k,
+                                                  HN_UBASE *rx, HN_UBASE *ry, HN_UBASE *scratch);
+static UINT _nx_crypto_ec_secp256r1_wnaf_compute(const HN_UBASE *k, UCHAR *naf, HN_UBASE *scratch);
+static VOID _nx_crypto_ec_secp256r1_point_accumulate(HN_UBASE *x, HN_UBASE *y, HN_UBASE *z,
+                                                     const HN_UBASE *px, const HN_UBASE *py,
+                                                     UINT *infinite, HN_UBASE *scratch);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_add                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds two field elements of secp256r1 modulo p in      */
+/*    constant time. The operands are below p.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_select     Select a field element by mask*/
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate                          */
+/*                                          Add and subtract co-Z points  */
+/*    _nx_crypto_ec_secp256r1_multiple      Calculate the multiplication  */
+/*                                            of a point                  */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_add(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+HN_UBASE           sum[NX_CRYPTO_EC_SECP256R1_DIGITS];
+HN_UBASE2          carry = 0;
+NX_CRYPTO_EC_CARRY borrow = 0;
+HN_UBASE           mask;
+UINT               i;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)a[i] + b[i];
+        sum[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        borrow += (NX_CRYPTO_EC_CARRY)sum[i] - _nx_crypto_ec_secp256r1_fe_p[i];
+        r[i] = (HN_UBASE)borrow;
+        borrow >>= HN_SHIFT;
+    }
+
+    /* Keep the sum when it is below p: the subtraction borrowed and the addition did not carry. */
+    mask = (HN_UBASE)borrow & ((HN_UBASE)carry - 1);
+    _nx_crypto_ec_secp256r1_fe_select(r, sum, mask);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function subtracts two field elements of secp256r1 modulo p in */
+/*    constant time. The operands are below p.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add      Add co-Z points               */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate                          */
+/*                                          Add and subtract co-Z points  */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_subtract(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+NX_CRYPTO_EC_CARRY borrow = 0;
+HN_UBASE2          carry = 0;
+HN_UBASE           mask;
+UINT               i;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        borrow += (NX_CRYPTO_EC_CARRY)a[i] - b[i];
+        r[i] = (HN_UBASE)borrow;
+        borrow >>= HN_SHIFT;
+    }
+
+    /* Add p back when the difference is negative. */
+    mask = (HN_UBASE)borrow;
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)r[i] + (_nx_crypto_ec_secp256r1_fe_p[i] & mask);
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_reduce                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reduces a product of two field elements of secp256r1  */
+/*    modulo p with the fast reduction of FIPS 186-4 D.2.3, for the       */
+/*    Solinas prime p = 2^256 - 2^224 + 2^192 + 2^96 - 1. It runs in      */
+/*    constant time.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result                        */
+/*    c                                     Product of 16 digits          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_select     Select a field element by mask*/
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_reduce(HN_UBASE *r, const HN_UBASE *c)
+{
+HN_UBASE           t[NX_CRYPTO_EC_SECP256R1_DIGITS];
+NX_CRYPTO_EC_CARRY acc;
+NX_CRYPTO_EC_CARRY k;
+HN_UBASE           mask;
+UINT               i;
+
+    /* r = s1 + 2 * s2 + 2 * s3 + s4 + s5 - d1 - d2 - d3 - d4 of FIPS 186-4 D.2.3,
+       summed one digit at a time with a signed carry.  */
+    acc = (NX_CRYPTO_EC_CARRY)c[0] + c[8] + c[9] - c[11] - c[12] - c[13] - c[14];
+    t[0] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[1] + c[9] + c[10] - c[12] - c[13] - c[14] - c[15];
+    t[1] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[2] + c[10] + c[11] - c[13] - c[14] - c[15];
+    t[2] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[3] + ((NX_CRYPTO_EC_CARRY)c[11] << 1) + ((NX_CRYPTO_EC_CARRY)c[12] << 1)
+           + c[13] - c[15] - c[8] - c[9];
+    t[3] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[4] + ((NX_CRYPTO_EC_CARRY)c[12] << 1) + ((NX_CRYPTO_EC_CARRY)c[13] << 1)
+           + c[14] - c[9] - c[10];
+    t[4] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[5] + ((NX_CRYPTO_EC_CARRY)c[13] << 1) + ((NX_CRYPTO_EC_CARRY)c[14] << 1)
+           + c[15] - c[10] - c[11];
+    t[5] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[6] + ((NX_CRYPTO_EC_CARRY)c[14] * 3) + ((NX_CRYPTO_EC_CARRY)c[15] << 1)
+           + c[13] - c[8] - c[9];
+    t[6] = (HN_UBASE)acc;
+    acc >>= HN_SHIFT;
+    acc += (NX_CRYPTO_EC_CARRY)c[7] + ((NX_CRYPTO_EC_CARRY)c[15] * 3) + c[8] - c[10] - c[11] - c[12] - c[13];
+    t[7] = (HN_UBASE)acc;
+    k = acc >> HN_SHIFT;
+
+    /* Fold the carry k * 2^256 = k * (2^224 - 2^192 - 2^96 + 1) back in.
+       The first fold leaves a carry of -1, 0 or 1, the second none.  */
+    for (i = 0; i < 2; i++)
+    {
+        acc = (NX_CRYPTO_EC_CARRY)t[0] + k;
+        t[0] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[1];
+        t[1] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[2];
+        t[2] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[3] - k;
+        t[3] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[4];
+        t[4] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[5];
+        t[5] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[6] - k;
+        t[6] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+        acc += (NX_CRYPTO_EC_CARRY)t[7] + k;
+        t[7] = (HN_UBASE)acc;
+        k = acc >> HN_SHIFT;
+    }
+
+    /* t is below 2^256 < 2p, subtract p once unless it borrows. */
+    acc = 0;
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        acc += (NX_CRYPTO_EC_CARRY)t[i] - _nx_crypto_ec_secp256r1_fe_p[i];
+        r[i] = (HN_UBASE)acc;
+        acc >>= HN_SHIFT;
+    }
+    mask = (HN_UBASE)acc;
+    _nx_crypto_ec_secp256r1_fe_select(r, t, mask);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function multiplies two field elements of secp256r1 modulo p   */
+/*    in constant time.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_reduce     Reduce a product modulo p     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add      Add co-Z points               */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate                          */
+/*                                          Add and subtract co-Z points  */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_fe_square_multiply                          */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_multiply(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+HN_UBASE t[NX_CRYPTO_EC_SECP256R1_DIGITS << 1];
+HN_UBASE carry;
+HN_UBASE digit;
+UINT     i, j;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        t[i] = 0;
+    }
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        carry = 0;
+        digit = a[i];
+        for (j = 0; j < NX_CRYPTO_EC_SECP256R1_DIGITS; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(t[i + j], carry, digit, b[j]);
+        }
+        t[i + NX_CRYPTO_EC_SECP256R1_DIGITS] = carry;
+    }
+
+    _nx_crypto_ec_secp256r1_fe_reduce(r, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_square                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function squares a field element of secp256r1 modulo p in      */
+/*    constant time, computing each cross product once.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     Operand                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_reduce     Reduce a product modulo p     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add      Add co-Z points               */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate                          */
+/*                                          Add and subtract co-Z points  */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_fe_square_multiply                          */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_square(HN_UBASE *r, const HN_UBASE *a)
+{
+HN_UBASE  t[NX_CRYPTO_EC_SECP256R1_DIGITS << 1];
+HN_UBASE  carry;
+HN_UBASE  digit;
+HN_UBASE2 sum;
+UINT      i, j;
+
+    /* The products a[i] * a[j] with i < j, each once.  */
+    for (i = 0; i < (NX_CRYPTO_EC_SECP256R1_DIGITS << 1); i++)
+    {
+        t[i] = 0;
+    }
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS - 1; i++)
+    {
+        carry = 0;
+        digit = a[i];
+        for (j = i + 1; j < NX_CRYPTO_EC_SECP256R1_DIGITS; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(t[i + j], carry, digit, a[j]);
+        }
+        t[i + NX_CRYPTO_EC_SECP256R1_DIGITS] = carry;
+    }
+
+    /* Double them.  */
+    carry = 0;
+    for (i = 0; i < (NX_CRYPTO_EC_SECP256R1_DIGITS << 1); i++)
+    {
+        digit = t[i];
+        t[i] = (digit << 1) | carry;
+        carry = digit >> (HN_SHIFT - 1);
+    }
+
+    /* Add the squares a[i] * a[i].  */
+    carry = 0;
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        digit = a[i];
+        HN_MULTIPLY_ACCUMULATE(t[i << 1], carry, digit, digit);
+        sum = (HN_UBASE2)t[(i << 1) + 1] + carry;
+        t[(i << 1) + 1] = (HN_UBASE)sum;
+        carry = (HN_UBASE)(sum >> HN_SHIFT);
+    }
+
+    _nx_crypto_ec_secp256r1_fe_reduce(r, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_square_multiply          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes r = a^(2^n) * b modulo p, the step of the    */
+/*    addition chain of the inversion.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be a but not b    */
+/*    a                                     Operand squared               */
+/*    n                                     Number of squarings           */
+/*    b                                     Operand multiplied            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_inverse    Invert a field element        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_square_multiply(HN_UBASE *r, const HN_UBASE *a, UINT n,
+                                                                      const HN_UBASE *b)
+{
+UINT i;
+
+    _nx_crypto_ec_secp256r1_fe_square(r, a);
+    for (i = 1; i < n; i++)
+    {
+        _nx_crypto_ec_secp256r1_fe_square(r, r);
+    }
+    _nx_crypto_ec_secp256r1_fe_multiply(r, r, b);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_inverse                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function inverts a field element of secp256r1 modulo p in      */
+/*    constant time, as a^(p - 2) with a fixed addition chain of 255      */
+/*    squarings and 12 multiplications.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     Operand                       */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_square_multiply                          */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_inverse(HN_UBASE *r, const HN_UBASE *a, HN_UBASE *scratch)
+{
+HN_UBASE *x2 = scratch;
+HN_UBASE *x3 = x2 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t1 = x3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t2 = t1 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+
+    /* r = a^(p - 2), where p - 2 is, from the most significant bit,
+       32 ones, 31 zeros, a one, 96 zeros, 94 ones, a zero and a one.
+       xn below is a^(2^n - 1), n ones.  */
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, a, 1, a);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x3, x2, 1, a);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(t1, x3, 3, x3);      /* x6  */
+    _nx_crypto_ec_secp256r1_fe_square_multiply(t2, t1, 6, t1);      /* x12 */
+    _nx_crypto_ec_secp256r1_fe_square_multiply(t1, t2, 3, x3);      /* x15 */
+    _nx_crypto_ec_secp256r1_fe_square_multiply(t2, t1, 15, t1);     /* x30 */
+    _nx_crypto_ec_secp256r1_fe_square_multiply(t1, t2, 2, x2);      /* x32 */
+
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, t1, 32, a);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, x2, 128, t1);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, x2, 32, t1);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, x2, 30, t2);
+    _nx_crypto_ec_secp256r1_fe_square_multiply(x2, x2, 2, a);
+
+    NX_CRYPTO_MEMCPY(r, x2, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_select                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies a field element into r when mask is all ones   */
+/*    and leaves r unchanged when mask is zero, without a branch.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Destination                   */
+/*    a                                     Source                        */
+/*    mask                                  All ones or zero              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_fe_add        Add field elements            */
+/*    _nx_crypto_ec_secp256r1_fe_reduce     Reduce a product modulo p     */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_select(HN_UBASE *r, const HN_UBASE *a, HN_UBASE mask)
+{
+UINT i;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        r[i] = (a[i] & mask) | (r[i] & ~mask);
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_swap                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function swaps two field elements when mask is all ones and    */
+/*    leaves them unchanged when mask is zero, without a branch.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    a                                     First field element           */
+/*    b                                     Second field element          */
+/*    mask                                  All ones or zero              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_fe_swap(HN_UBASE *a, HN_UBASE *b, HN_UBASE mask)
+{
+HN_UBASE t;
+UINT     i;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        t = (a[i] ^ b[i]) & mask;
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_is_zero                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks a field element for zero without a branch.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    a                                     Field element                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    mask                                  All ones when a is zero, zero */
+/*                                            otherwise                   */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple      Calculate the multiplication  */
+/*                                            of a point                  */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*    _nx_crypto_ec_secp256r1_wnaf_compute                                */
+/*                                          Compute the wNAF of a factor  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static HN_UBASE _nx_crypto_ec_secp256r1_fe_is_zero(const HN_UBASE *a)
+{
+HN_UBASE bits = 0;
+UINT     i;
+
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        bits |= a[i];
+    }
+
+    /* The most significant bit of bits | -bits is set unless bits is zero. */
+    return(((bits | (0 - bits)) >> (HN_SHIFT - 1)) - 1);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_point_double                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function doubles a point of secp256r1 in Jacobian coordinates, */
+/*    with the formulas for a = -3. The infinite point, of z = 0, stays   */
+/*    infinite.                                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     X coordinate, replaced        */
+/*    y                                     Y coordinate, replaced        */
+/*    z                                     Z coordinate, replaced        */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_add        Add field elements            */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*    _nx_crypto_ec_secp256r1_point_accumulate                            */
+/*                                          Add an affine point to an     */
+/*                                            accumulator                 */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_point_double(HN_UBASE *x, HN_UBASE *y, HN_UBASE *z,
+                                                                HN_UBASE *scratch)
+{
+HN_UBASE *delta = scratch;
+HN_UBASE *gamma = delta + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *beta = gamma + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *alpha = beta + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t = alpha + NX_CRYPTO_EC_SECP256R1_DIGITS;
+
+    /* dbl-2001-b for a = -3, 3M + 5S. */
+    _nx_crypto_ec_secp256r1_fe_square(delta, z);
+    _nx_crypto_ec_secp256r1_fe_square(gamma, y);
+    _nx_crypto_ec_secp256r1_fe_multiply(beta, x, gamma);
+
+    /* alpha = 3 * (x - delta) * (x + delta) */
+    _nx_crypto_ec_secp256r1_fe_subtract(t, x, delta);
+    _nx_crypto_ec_secp256r1_fe_add(alpha, x, delta);
+    _nx_crypto_ec_secp256r1_fe_multiply(alpha, alpha, t);
+    _nx_crypto_ec_secp256r1_fe_add(t, alpha, alpha);
+    _nx_crypto_ec_secp256r1_fe_add(alpha, alpha, t);
+
+    /* z = (y + z)^2 - gamma - delta */
+    _nx_crypto_ec_secp256r1_fe_add(z, y, z);
+    _nx_crypto_ec_secp256r1_fe_square(z, z);
+    _nx_crypto_ec_secp256r1_fe_subtract(z, z, gamma);
+    _nx_crypto_ec_secp256r1_fe_subtract(z, z, delta);
+
+    /* x = alpha^2 - 8 * beta */
+    _nx_crypto_ec_secp256r1_fe_add(beta, beta, beta);
+    _nx_crypto_ec_secp256r1_fe_add(beta, beta, beta);
+    _nx_crypto_ec_secp256r1_fe_square(x, alpha);
+    _nx_crypto_ec_secp256r1_fe_subtract(x, x, beta);
+    _nx_crypto_ec_secp256r1_fe_subtract(x, x, beta);
+
+    /* y = alpha * (4 * beta - x) - 8 * gamma^2 */
+    _nx_crypto_ec_secp256r1_fe_subtract(beta, beta, x);
+    _nx_crypto_ec_secp256r1_fe_multiply(beta, alpha, beta);
+    _nx_crypto_ec_secp256r1_fe_square(gamma, gamma);
+    _nx_crypto_ec_secp256r1_fe_add(gamma, gamma, gamma);
+    _nx_crypto_ec_secp256r1_fe_add(gamma, gamma, gamma);
+    _nx_crypto_ec_secp256r1_fe_add(gamma, gamma, gamma);
+    _nx_crypto_ec_secp256r1_fe_subtract(y, beta, gamma);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_point_add                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds an affine point to a point of secp256r1 in       */
+/*    Jacobian coordinates. The result is only valid when the points are  */
+/*    neither equal nor opposite, which it reports for the caller to      */
+/*    handle.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x1                                    X coordinate of Jacobian point*/
+/*    y1                                    Y coordinate of Jacobian point*/
+/*    z1                                    Z coordinate of Jacobian point*/
+/*    x2                                    X coordinate of affine point  */
+/*    y2                                    Y coordinate of affine point  */
+/*    x3                                    X coordinate of the sum       */
+/*    y3                                    Y coordinate of the sum       */
+/*    z3                                    Z coordinate of the sum       */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                1 if the points are equal, 2  */
+/*                                            if opposite, 0 otherwise    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_is_zero    Check a field element for zero*/
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*    _nx_crypto_ec_secp256r1_point_accumulate                            */
+/*                                          Add an affine point to an     */
+/*                                            accumulator                 */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static UINT _nx_crypto_ec_secp256r1_point_add(HN_UBASE *x1, HN_UBASE *y1, HN_UBASE *z1,
+                                                             const HN_UBASE *x2, const HN_UBASE *y2,
+                                                             HN_UBASE *x3, HN_UBASE *y3, HN_UBASE *z3,
+                                                             HN_UBASE *scratch)
+{
+HN_UBASE *t0 = scratch;
+HN_UBASE *t1 = t0 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t2 = t1 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t3 = t2 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE  h_zero;
+HN_UBASE  r_zero;
+
+    /* madd with u2 = x2 * z1^2, s2 = y2 * z1^3, h = u2 - x1, r = s2 - y1, 8M + 3S. */
+    _nx_crypto_ec_secp256r1_fe_square(t0, z1);
+    _nx_crypto_ec_secp256r1_fe_multiply(t1, x2, t0);
+    _nx_crypto_ec_secp256r1_fe_multiply(t0, t0, z1);
+    _nx_crypto_ec_secp256r1_fe_multiply(t0, t0, y2);
+    _nx_crypto_ec_secp256r1_fe_subtract(t1, t1, x1);                /* h */
+    _nx_crypto_ec_secp256r1_fe_subtract(t0, t0, y1);                /* r */
+
+    h_zero = _nx_crypto_ec_secp256r1_fe_is_zero(t1);
+    r_zero = _nx_crypto_ec_secp256r1_fe_is_zero(t0);
+
+    _nx_crypto_ec_secp256r1_fe_square(t2, t1);                      /* h^2 */
+    _nx_crypto_ec_secp256r1_fe_multiply(t3, t1, t2);                /* h^3 */
+    _nx_crypto_ec_secp256r1_fe_multiply(t2, x1, t2);                /* v = x1 * h^2 */
+    _nx_crypto_ec_secp256r1_fe_multiply(z3, z1, t1);
+
+    /* x3 = r^2 - h^3 - 2 * v */
+    _nx_crypto_ec_secp256r1_fe_square(x3, t0);
+    _nx_crypto_ec_secp256r1_fe_subtract(x3, x3, t3);
+    _nx_crypto_ec_secp256r1_fe_subtract(x3, x3, t2);
+    _nx_crypto_ec_secp256r1_fe_subtract(x3, x3, t2);
+
+    /* y3 = r * (v - x3) - y1 * h^3 */
+    _nx_crypto_ec_secp256r1_fe_subtract(t2, t2, x3);
+    _nx_crypto_ec_secp256r1_fe_multiply(t2, t0, t2);
+    _nx_crypto_ec_secp256r1_fe_multiply(t3, y1, t3);
+    _nx_crypto_ec_secp256r1_fe_subtract(y3, t2, t3);
+
+    /* 1 when the points are equal, 2 when they are opposite, 0 otherwise. */
+    return((UINT)(h_zero & ((r_zero & 1) | (~r_zero & 2))));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds two points of secp256r1 that share the same Z    */
+/*    coordinate (XYcZ-ADD). It returns P + Q and P, both with a new      */
+/*    common Z coordinate.                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x1                                    X of P, replaced by X of P    */
+/*    y1                                    Y of P, replaced by Y of P    */
+/*    x2                                    X of Q, replaced by X of P + Q*/
+/*    y2                                    Y of Q, replaced by Y of P + Q*/
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_co_z_add(HN_UBASE *x1, HN_UBASE *y1, HN_UBASE *x2, HN_UBASE *y2,
+                                                            HN_UBASE *scratch)
+{
+HN_UBASE *t = scratch;
+
+    _nx_crypto_ec_secp256r1_fe_subtract(t, x2, x1);
+    _nx_crypto_ec_secp256r1_fe_square(t, t);                        /* a = (x2 - x1)^2 */
+    _nx_crypto_ec_secp256r1_fe_multiply(x1, x1, t);                 /* b = x1 * a */
+    _nx_crypto_ec_secp256r1_fe_multiply(x2, x2, t);                 /* c = x2 * a */
+    _nx_crypto_ec_secp256r1_fe_subtract(y2, y2, y1);
+    _nx_crypto_ec_secp256r1_fe_square(t, y2);                       /* d = (y2 - y1)^2 */
+
+    _nx_crypto_ec_secp256r1_fe_subtract(t, t, x1);
+    _nx_crypto_ec_secp256r1_fe_subtract(t, t, x2);                  /* x3 = d - b - c */
+    _nx_crypto_ec_secp256r1_fe_subtract(x2, x2, x1);
+    _nx_crypto_ec_secp256r1_fe_multiply(y1, y1, x2);                /* e = y1 * (c - b) */
+    _nx_crypto_ec_secp256r1_fe_subtract(x2, x1, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(y2, y2, x2);
+    _nx_crypto_ec_secp256r1_fe_subtract(y2, y2, y1);                /* y3 = (y2 - y1) * (b - x3) - e */
+    NX_CRYPTO_MEMCPY(x2, t, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds and subtracts two points of secp256r1 that share */
+/*    the same Z coordinate (XYcZ-ADDC). It returns P + Q and P - Q, both */
+/*    with a new common Z coordinate.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x1                                    X of P, replaced by X of P - Q*/
+/*    y1                                    Y of P, replaced by Y of P - Q*/
+/*    x2                                    X of Q, replaced by X of P + Q*/
+/*    y2                                    Y of Q, replaced by Y of P + Q*/
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_add        Add field elements            */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_co_z_add_conjugate(HN_UBASE *x1, HN_UBASE *y1,
+                                                                      HN_UBASE *x2, HN_UBASE *y2,
+                                                                      HN_UBASE *scratch)
+{
+HN_UBASE *t5 = scratch;
+HN_UBASE *t6 = t5 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t7 = t6 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+
+    _nx_crypto_ec_secp256r1_fe_subtract(t5, x2, x1);
+    _nx_crypto_ec_secp256r1_fe_square(t5, t5);                      /* a = (x2 - x1)^2 */
+    _nx_crypto_ec_secp256r1_fe_multiply(x1, x1, t5);                /* b = x1 * a */
+    _nx_crypto_ec_secp256r1_fe_multiply(x2, x2, t5);                /* c = x2 * a */
+    _nx_crypto_ec_secp256r1_fe_add(t5, y2, y1);
+    _nx_crypto_ec_secp256r1_fe_subtract(y2, y2, y1);
+
+    _nx_crypto_ec_secp256r1_fe_subtract(t6, x2, x1);
+    _nx_crypto_ec_secp256r1_fe_multiply(y1, y1, t6);                /* e = y1 * (c - b) */
+    _nx_crypto_ec_secp256r1_fe_add(t6, x1, x2);                     /* b + c */
+    _nx_crypto_ec_secp256r1_fe_square(x2, y2);
+    _nx_crypto_ec_secp256r1_fe_subtract(x2, x2, t6);                /* x3 = (y2 - y1)^2 - b - c */
+    _nx_crypto_ec_secp256r1_fe_subtract(t7, x1, x2);
+    _nx_crypto_ec_secp256r1_fe_multiply(y2, y2, t7);
+    _nx_crypto_ec_secp256r1_fe_subtract(y2, y2, y1);                /* y3 = (y2 - y1) * (b - x3) - e */
+
+    _nx_crypto_ec_secp256r1_fe_square(t7, t5);
+    _nx_crypto_ec_secp256r1_fe_subtract(t7, t7, t6);                /* x3' = (y2 + y1)^2 - b - c */
+    _nx_crypto_ec_secp256r1_fe_subtract(t6, t7, x1);
+    _nx_crypto_ec_secp256r1_fe_multiply(t6, t6, t5);
+    _nx_crypto_ec_secp256r1_fe_subtract(y1, t6, y1);                /* y3' = (y2 + y1) * (x3' - b) - e */
+    NX_CRYPTO_MEMCPY(x1, t7, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_ladder_multiple             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates r = k * P for any point P of secp256r1     */
+/*    with a Montgomery ladder of co-Z additions. It does the same        */
+/*    operations for all the factors: the factor is made 257 bits long by */
+/*    adding n once or twice, and the points are swapped by masks.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    px                                    X coordinate of P             */
+/*    py                                    Y coordinate of P             */
+/*    k                                     Factor k, from 2 to n - 3     */
+/*    n                                     Order of the curve            */
+/*    rx                                    X coordinate of result        */
+/*    ry                                    Y coordinate of result        */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_co_z_add      Add co-Z points               */
+/*    _nx_crypto_ec_secp256r1_co_z_add_conjugate                          */
+/*                                          Add and subtract co-Z points  */
+/*    _nx_crypto_ec_secp256r1_fe_inverse    Invert a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_select     Select a field element by mask*/
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_swap       Swap field elements by mask   */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple      Calculate the multiplication  */
+/*                                            of a point                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_ladder_multiple(const HN_UBASE *px, const HN_UBASE *py,
+                                                                   const HN_UBASE *k, const HN_UBASE *n,
+                                                                   HN_UBASE *rx, HN_UBASE *ry,
+                                                                   HN_UBASE *scratch)
+{
+HN_UBASE *x0 = scratch;
+HN_UBASE *y0 = x0 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *x1 = y0 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *y1 = x1 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *z = y1 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *scalar = z + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *t = scalar + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE  scalar2[NX_CRYPTO_EC_SECP256R1_DIGITS];
+HN_UBASE2 carry;
+HN_UBASE  mask;
+INT       i;
+
+    /* The ladder runs over 257 bits with the top one set: scalar = k + n when that
+       carries out of 256 bits, k + 2n otherwise, both times the point give k * P. */
+    carry = 0;
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)k[i] + n[i];
+        scalar[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    mask = (HN_UBASE)carry - 1;
+    carry = 0;
+    for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)scalar[i] + n[i];
+        scalar2[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    _nx_crypto_ec_secp256r1_fe_select(scalar, scalar2, mask);
+
+    /* (x0, y0) = P and (x1, y1) = 2P, sharing z. */
+    NX_CRYPTO_MEMCPY(x0, px, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(y0, py, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(x1, px, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(y1, py, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMSET(z, 0, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT);
+    z[0] = 1;
+    _nx_crypto_ec_secp256r1_point_double(x1, y1, z, t);
+    _nx_crypto_ec_secp256r1_fe_square(t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(x0, x0, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(t, t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(y0, y0, t);
+
+    /* Montgomery ladder with co-Z additions: with R0 = jP and R1 = (j + 1)P, a clear bit
+       gives R0 = 2jP, R1 = (2j + 1)P and a set bit R0 = (2j + 1)P, R1 = (2j + 2)P.
+       The points are swapped under a mask instead of indexed by the bit. */
+    for (i = 255; i >= 0; i--)
+    {
+        mask = ((scalar[i >> 5] >> (i & 31)) & 1) - 1;
+        _nx_crypto_ec_secp256r1_fe_swap(x0, x1, mask);
+        _nx_crypto_ec_secp256r1_fe_swap(y0, y1, mask);
+
+        _nx_crypto_ec_secp256r1_co_z_add_conjugate(x1, y1, x0, y0, t);
+        if (i == 0)
+        {
+            break;
+        }
+        _nx_crypto_ec_secp256r1_co_z_add(x0, y0, x1, y1, t);
+
+        _nx_crypto_ec_secp256r1_fe_swap(x0, x1, mask);
+        _nx_crypto_ec_secp256r1_fe_swap(y0, y1, mask);
+    }
+
+    /* The last addition gives the result in (x0, y0), still swapped by the bit 0 mask.
+       Its z is not kept, 1 / z is found from the affine P instead:
+       1 / z = xb * yP / (xP * yb * (x1 - x0)) with b the point not added to. */
+    _nx_crypto_ec_secp256r1_fe_subtract(z, x1, x0);
+    _nx_crypto_ec_secp256r1_fe_subtract(t, _nx_crypto_ec_secp256r1_fe_zero, z);
+    _nx_crypto_ec_secp256r1_fe_select(z, t, mask);
+    _nx_crypto_ec_secp256r1_fe_multiply(z, z, y1);
+    _nx_crypto_ec_secp256r1_fe_multiply(z, z, px);
+    _nx_crypto_ec_secp256r1_fe_inverse(z, z, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(z, z, py);
+    _nx_crypto_ec_secp256r1_fe_multiply(z, z, x1);
+
+    _nx_crypto_ec_secp256r1_co_z_add(x0, y0, x1, y1, t);
+    _nx_crypto_ec_secp256r1_fe_swap(x0, x1, mask);
+    _nx_crypto_ec_secp256r1_fe_swap(y0, y1, mask);
+
+    _nx_crypto_ec_secp256r1_fe_square(t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(rx, x0, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(t, t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(ry, y0, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_comb_multiple               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates r = k * G for the base point of secp256r1  */
+/*    with the precomputed points of the curve, in constant time.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve                                 Pointer to curve              */
+/*    k                                     Factor k, from 1 to n - 1     */
+/*    rx                                    X coordinate of result        */
+/*    ry                                    Y coordinate of result        */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_inverse    Invert a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_select     Select a field element by mask*/
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple      Calculate the multiplication  */
+/*                                            of a point                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_comb_multiple(NX_CRYPTO_EC *curve, const HN_UBASE *k,
+                                                                 HN_UBASE *rx, HN_UBASE *ry, HN_UBASE *scratch)
+{
+NX_CRYPTO_EC_FIXED_POINTS *fixed_points = curve -> nx_crypto_ec_fixed_points;
+NX_CRYPTO_EC_POINT        *point;
+HN_UBASE                  *x = scratch;
+HN_UBASE                  *y = x + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *z = y + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *x3 = z + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *y3 = x3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *z3 = y3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *px = z3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *py = px + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *t = py + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                   infinite;
+HN_UBASE                   nonzero;
+HN_UBASE                   mask;
+UINT                       transpose_d;
+UINT                       bit_index;
+UINT                       half;
+UINT                       entry;
+UINT                       status;
+INT                        i;
+UINT                       j;
+
+    /* Same comb as _nx_crypto_ec_fp_fixed_multiple: each step adds the points
+       [a(w-1),...a(0)]G and 2^e[a(w-1),...a(0)]G of the transposed bits of k.
+       The table entry is read by masks over the whole table and the infinite
+       accumulator is a mask too, so the steps do not depend on the bits.  */
+    infinite = (HN_UBASE)-1;
+    NX_CRYPTO_MEMSET(x, 0, 3 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT));
+
+    for (i = (INT)(fixed_points -> nx_crypto_ec_fixed_points_e - 1); i >= 0; i--)
+    {
+        _nx_crypto_ec_secp256r1_point_double(x, y, z, t);
+
+        for (half = 0; half < 2; half++)
+        {
+            transpose_d = 0;
+            bit_index = (UINT)i + half * fixed_points -> nx_crypto_ec_fixed_points_e;
+            for (j = 0; j < fixed_points -> nx_crypto_ec_fixed_points_window_width; j++)
+            {
+                transpose_d |= (UINT)((k[bit_index >> 5] >> (bit_index & 31)) & 1) << j;
+                bit_index += fixed_points -> nx_crypto_ec_fixed_points_d;
+            }
+
+            /* (px, py) = transpose_d * G, or 2^e * transpose_d * G in the second half. */
+            NX_CRYPTO_MEMSET(px, 0, 2 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT));
+            for (entry = 1; entry < (1u << fixed_points -> nx_crypto_ec_fixed_points_window_width); entry++)
+            {
+                if (half)
+                {
+                    point = &fixed_points -> nx_crypto_ec_fixed_points_array_2e[entry - 1];
+                }
+                else if (entry == 1)
+                {
+                    point = &curve -> nx_crypto_ec_g;
+                }
+                else
+                {
+                    point = &fixed_points -> nx_crypto_ec_fixed_points_array[entry - 2];
+                }
+                mask = (HN_UBASE)0 - (HN_UBASE)(entry == transpose_d);
+                _nx_crypto_ec_secp256r1_fe_select(px, point -> nx_crypto_ec_point_x.nx_crypto_huge_number_data, mask);
+                _nx_crypto_ec_secp256r1_fe_select(py, point -> nx_crypto_ec_point_y.nx_crypto_huge_number_data, mask);
+            }
+
+            status = _nx_crypto_ec_secp256r1_point_add(x, y, z, px, py, x3, y3, z3, t);
+            nonzero = (HN_UBASE)0 - (HN_UBASE)(transpose_d != 0);
+
+            /* Adding a point to itself or to its opposite is only possible with a
+               negligible probability, handle it apart. */
+            if (status & (UINT)(nonzero & ~infinite))
+            {
+                NX_CRYPTO_MEMCPY(x3, x, 3 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)); /* Use case of memcpy is verified. */
+                if (status == 1)
+                {
+                    _nx_crypto_ec_secp256r1_point_double(x3, y3, z3, t);
+                }
+                else
+                {
+                    infinite = (HN_UBASE)-1;
+                    nonzero = 0;
+                }
+            }
+
+            /* The sum when both points are finite, the table entry when the accumulator
+               is infinite, unchanged when the entry is. */
+            mask = nonzero & ~infinite;
+            _nx_crypto_ec_secp256r1_fe_select(x, x3, mask);
+            _nx_crypto_ec_secp256r1_fe_select(y, y3, mask);
+            _nx_crypto_ec_secp256r1_fe_select(z, z3, mask);
+            mask = nonzero & infinite;
+            _nx_crypto_ec_secp256r1_fe_select(x, px, mask);
+            _nx_crypto_ec_secp256r1_fe_select(y, py, mask);
+            z[0] = (z[0] & ~mask) | (1 & mask);
+            for (j = 1; j < NX_CRYPTO_EC_SECP256R1_DIGITS; j++)
+            {
+                z[j] &= ~mask;
+            }
+            infinite &= ~nonzero;
+        }
+    }
+
+    /* Back to affine coordinates. */
+    _nx_crypto_ec_secp256r1_fe_inverse(z3, z, t);
+    _nx_crypto_ec_secp256r1_fe_square(t, z3);
+    _nx_crypto_ec_secp256r1_fe_multiply(rx, x, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(t, t, z3);
+    _nx_crypto_ec_secp256r1_fe_multiply(ry, y, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_wnaf_compute                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the width-w non-adjacent form of a factor    */
+/*    below n, from the least significant digit. Every nonzero digit is   */
+/*    odd and below 2 ^ (w - 1) in magnitude, and is followed by at least */
+/*    w - 1 zero digits. It branches on the factor, which must be public. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    k                                     Factor, below n               */
+/*    naf                                   Digits, 257 at most           */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    size                                  Count of digits               */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_fe_is_zero    Check a field element for zero*/
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static UINT _nx_crypto_ec_secp256r1_wnaf_compute(const HN_UBASE *k, UCHAR *naf, HN_UBASE *scratch)
+{
+HN_UBASE *work = scratch;
+HN_UBASE  digit;
+HN_UBASE2 carry;
+UINT      size = 0;
+UINT      i;
+
+    NX_CRYPTO_MEMCPY(work, k, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+    while (_nx_crypto_ec_secp256r1_fe_is_zero(work) == 0)
+    {
+        naf[size] = 0;
+        if (work[0] & 1)
+        {
+
+            /* The digit of the low w bits clears them, a negative one by adding to work.
+               With work below n the addition does not carry out of 256 bits. */
+            digit = work[0] & ((1u << NX_CRYPTO_EC_SECP256R1_WNAF_WIDTH) - 1);
+            if (digit & (1u << (NX_CRYPTO_EC_SECP256R1_WNAF_WIDTH - 1)))
+            {
+                digit = (1u << NX_CRYPTO_EC_SECP256R1_WNAF_WIDTH) - digit;
+                naf[size] = (UCHAR)(digit | NX_CRYPTO_EC_SECP256R1_WNAF_NEGATIVE);
+                carry = digit;
+                for (i = 0; (i < NX_CRYPTO_EC_SECP256R1_DIGITS) && (carry != 0); i++)
+                {
+                    carry += work[i];
+                    work[i] = (HN_UBASE)carry;
+                    carry >>= HN_SHIFT;
+                }
+            }
+            else
+            {
+                naf[size] = (UCHAR)digit;
+                work[0] -= digit;
+            }
+        }
+
+        for (i = 0; i < NX_CRYPTO_EC_SECP256R1_DIGITS - 1; i++)
+        {
+            work[i] = (work[i] >> 1) | (work[i + 1] << (HN_SHIFT - 1));
+        }
+        work[NX_CRYPTO_EC_SECP256R1_DIGITS - 1] >>= 1;
+        size++;
+    }
+
+    return(size);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_point_accumulate            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds an affine point to a Jacobian accumulator, which */
+/*    may be infinite, and handles the addition of a point to itself or   */
+/*    to its opposite. It branches on the points, which must be public.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     X coordinate, replaced        */
+/*    y                                     Y coordinate, replaced        */
+/*    z                                     Z coordinate, replaced        */
+/*    px                                    X of the affine point         */
+/*    py                                    Y of the affine point         */
+/*    infinite                              Accumulator infinite, replaced*/
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple_add                                */
+/*                                          Add the multiplications of    */
+/*                                            two points                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_secp256r1_point_accumulate(HN_UBASE *x, HN_UBASE *y, HN_UBASE *z,
+                                                                    const HN_UBASE *px, const HN_UBASE *py,
+                                                                    UINT *infinite, HN_UBASE *scratch)
+{
+HN_UBASE *x3 = scratch;
+HN_UBASE *y3 = x3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *z3 = y3 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+UINT      status;
+
+    if (*infinite == NX_CRYPTO_FALSE)
+    {
+        status = _nx_crypto_ec_secp256r1_point_add(x, y, z, px, py, x3, y3, z3,
+                                                   z3 + NX_CRYPTO_EC_SECP256R1_DIGITS);
+        if (status == 0)
+        {
+            NX_CRYPTO_MEMCPY(x, x3, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+            NX_CRYPTO_MEMCPY(y, y3, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+            NX_CRYPTO_MEMCPY(z, z3, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+            return;
+        }
+
+        if (status == 2)
+        {
+            *infinite = NX_CRYPTO_TRUE;
+            return;
+        }
+    }
+
+    /* The point itself when the accumulator is infinite, its double when they are equal. */
+    NX_CRYPTO_MEMCPY(x, px, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(y, py, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMSET(z, 0, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT);
+    z[0] = 1;
+    if (*infinite == NX_CRYPTO_FALSE)
+    {
+        _nx_crypto_ec_secp256r1_point_double(x, y, z, scratch);
+    }
+    *infinite = NX_CRYPTO_FALSE;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates the multiplication r = g * d on secp256r1  */
+/*    with fixed size field elements. The base point uses the precomputed */
+/*    points with a comb, other points a co-Z Montgomery ladder, both in  */
+/*    constant time. The factors out of [1, n - 1] and the few edge cases */
+/*    are left to _nx_crypto_ec_fp_projective_multiple.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve                                 Pointer to curve              */
+/*    g                                     Base point g                  */
+/*    d                                     Factor d                      */
+/*    r                                     Result r                      */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_fp_projective_multiple  Calculate the projective      */
+/*                                            multiplication              */
+/*    _nx_crypto_ec_secp256r1_comb_multiple                               */
+/*                                          Multiply the base point with  */
+/*                                            the comb                    */
+/*    _nx_crypto_ec_secp256r1_fe_add        Add field elements            */
+/*    _nx_crypto_ec_secp256r1_fe_is_zero    Check a field element for zero*/
+/*    _nx_crypto_ec_secp256r1_ladder_multiple                             */
+/*                                          Multiply a point with the co-Z*/
+/*                                            ladder                      */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_compare_unsigned                             */
+/*                                          Compare two unsigned huge     */
+/*                                            numbers                     */
+/*    _nx_crypto_huge_number_is_zero        Check if huge number is zero  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_ec_secp256r1_multiple(NX_CRYPTO_EC *curve,
+                                                    NX_CRYPTO_EC_POINT *g,
+                                                    NX_CRYPTO_HUGE_NUMBER *d,
+                                                    NX_CRYPTO_EC_POINT *r,
+                                                    HN_UBASE *scratch)
+{
+HN_UBASE *k = scratch;
+HN_UBASE *px = k + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *py = px + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE *n = curve -> nx_crypto_ec_n.nx_crypto_huge_number_data;
+HN_UBASE  is_one;
+HN_UBASE  is_n_minus_1;
+HN_UBASE  is_n_minus_2;
+UINT      i;
+
+    /* Leave the cases this code does not handle to the generic one: d outside [1, n - 1],
+       numbers wider than the field and, for the ladder, a point of x = 0 or the
+       factors 1, n - 2 and n - 1 that reach the infinite point in its last steps. */
+    if ((d -> nx_crypto_huge_number_is_negative) ||
+        (d -> nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (g -> nx_crypto_ec_point_x.nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (g -> nx_crypto_ec_point_y.nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (r -> nx_crypto_ec_point_x.nx_crypto_huge_buffer_size < (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)) ||
+        (r -> nx_crypto_ec_point_y.nx_crypto_huge_buffer_size < (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)) ||
+        (_nx_crypto_huge_number_is_zero(d)) ||
+        (_nx_crypto_huge_number_compare_unsigned(d, &curve -> nx_crypto_ec_n) != NX_CRYPTO_HUGE_NUMBER_LESS))
+    {
+        _nx_crypto_ec_fp_projective_multiple(curve, g, d, r, scratch);
+        return;
+    }
+
+    NX_CRYPTO_MEMSET(k, 0, 3 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT));
+    NX_CRYPTO_MEMCPY(k, d -> nx_crypto_huge_number_data, d -> nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+    if ((curve -> nx_crypto_ec_fixed_points) && (&curve -> nx_crypto_ec_g == g))
+    {
+        _nx_crypto_ec_secp256r1_comb_multiple(curve, k, px, py, py + NX_CRYPTO_EC_SECP256R1_DIGITS);
+    }
+    else
+    {
+        NX_CRYPTO_MEMCPY(px, g -> nx_crypto_ec_point_x.nx_crypto_huge_number_data,
+                         g -> nx_crypto_ec_point_x.nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+        NX_CRYPTO_MEMCPY(py, g -> nx_crypto_ec_point_y.nx_crypto_huge_number_data,
+                         g -> nx_crypto_ec_point_y.nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+        /* Adding zero reduces the coordinates below p. */
+        _nx_crypto_ec_secp256r1_fe_add(px, px, _nx_crypto_ec_secp256r1_fe_zero);
+        _nx_crypto_ec_secp256r1_fe_add(py, py, _nx_crypto_ec_secp256r1_fe_zero);
+
+        /* The ladder runs on factors and coordinates of the other party, comparing
+           them to the edge values does not leak the private key. */
+        is_one = k[0] ^ 1;
+        is_n_minus_1 = k[0] ^ (n[0] - 1);
+        is_n_minus_2 = k[0] ^ (n[0] - 2);
+        for (i = 1; i < NX_CRYPTO_EC_SECP256R1_DIGITS; i++)
+        {
+            is_one |= k[i];
+            is_n_minus_1 |= k[i] ^ n[i];
+            is_n_minus_2 |= k[i] ^ n[i];
+        }
+
+        if ((is_one == 0) || (is_n_minus_1 == 0) || (is_n_minus_2 == 0) ||
+            (_nx_crypto_ec_secp256r1_fe_is_zero(px)))
+        {
+            _nx_crypto_ec_fp_projective_multiple(curve, g, d, r, scratch);
+            return;
+        }
+
+        _nx_crypto_ec_secp256r1_ladder_multiple(px, py, k, n, px, py, py + NX_CRYPTO_EC_SECP256R1_DIGITS);
+    }
+
+    NX_CRYPTO_MEMCPY(r -> nx_crypto_ec_point_x.nx_crypto_huge_number_data, px,
+                     NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(r -> nx_crypto_ec_point_y.nx_crypto_huge_number_data, py,
+                     NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    r -> nx_crypto_ec_point_x.nx_crypto_huge_number_size = NX_CRYPTO_EC_SECP256R1_DIGITS;
+    r -> nx_crypto_ec_point_y.nx_crypto_huge_number_size = NX_CRYPTO_EC_SECP256R1_DIGITS;
+    r -> nx_crypto_ec_point_x.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    r -> nx_crypto_ec_point_y.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    _nx_crypto_huge_number_adjust_size(&r -> nx_crypto_ec_point_x);
+    _nx_crypto_huge_number_adjust_size(&r -> nx_crypto_ec_point_y);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_ec_secp256r1_multiple_add                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates r = g * u1 + q * u2 on secp256r1, g being  */
+/*    the base point, for the ECDSA verification. The two multiplications */
+/*    share their doublings: the factor of g adds the entries of the      */
+/*    fixed points comb at the last d doublings, the factor of q adds the */
+/*    odd multiples of q computed for its wNAF, made affine with a single */
+/*    inversion. It is not constant time, the factors and q are public.   */
+/*    The factors out of [1, n - 1] and the infinite results are left to  */
+/*    _nx_crypto_ec_fp_multiple_add. About 1.8 KB of scratch buffer are   */
+/*    used.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve                                 Pointer to curve              */
+/*    u1                                    Factor of the base point      */
+/*    q                                     Point q                       */
+/*    u2                                    Factor of q                   */
+/*    r                                     Result r                      */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_fp_multiple_add         Add the multiplications of    */
+/*                                            two points                  */
+/*    _nx_crypto_ec_secp256r1_fe_add        Add field elements            */
+/*    _nx_crypto_ec_secp256r1_fe_inverse    Invert a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_is_zero    Check a field element for zero*/
+/*    _nx_crypto_ec_secp256r1_fe_multiply   Multiply field elements       */
+/*    _nx_crypto_ec_secp256r1_fe_square     Square a field element        */
+/*    _nx_crypto_ec_secp256r1_fe_subtract   Subtract field elements       */
+/*    _nx_crypto_ec_secp256r1_point_accumulate                            */
+/*                                          Add an affine point to an     */
+/*                                            accumulator                 */
+/*    _nx_crypto_ec_secp256r1_point_add     Add an affine point to a      */
+/*                                            Jacobian point              */
+/*    _nx_crypto_ec_secp256r1_point_double  Double a Jacobian point       */
+/*    _nx_crypto_ec_secp256r1_wnaf_compute  Compute the wNAF of a factor  */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_compare_unsigned                             */
+/*                                          Compare two unsigned huge     */
+/*                                            numbers                     */
+/*    _nx_crypto_huge_number_is_zero        Check if huge number is zero  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ecdsa_verify               Verify hash data using ECDSA  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_ec_secp256r1_multiple_add(NX_CRYPTO_EC *curve,
+                                                        NX_CRYPTO_HUGE_NUMBER *u1,
+                                                        NX_CRYPTO_EC_POINT *q,
+                                                        NX_CRYPTO_HUGE_NUMBER *u2,
+                                                        NX_CRYPTO_EC_POINT *r,
+                                                        HN_UBASE *scratch)
+{
+NX_CRYPTO_EC_FIXED_POINTS *fixed_points = curve -> nx_crypto_ec_fixed_points;
+NX_CRYPTO_EC_POINT        *point;
+HN_UBASE                  *k1 = scratch;
+HN_UBASE                  *k2 = k1 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *x = k2 + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *y = x + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *z = y + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *px = z + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *py = px + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *table_x = py + NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *table_y = table_x + NX_CRYPTO_EC_SECP256R1_WNAF_TABLE * NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *table_z = table_y + NX_CRYPTO_EC_SECP256R1_WNAF_TABLE * NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *prefix = table_z + NX_CRYPTO_EC_SECP256R1_WNAF_TABLE * NX_CRYPTO_EC_SECP256R1_DIGITS;
+HN_UBASE                  *t = prefix + NX_CRYPTO_EC_SECP256R1_WNAF_TABLE * NX_CRYPTO_EC_SECP256R1_DIGITS;
+UCHAR                     *naf = (UCHAR *)(t + 7 * NX_CRYPTO_EC_SECP256R1_DIGITS);
+UINT                       naf_size;
+UINT                       infinite;
+UINT                       column;
+UINT                       bit_index;
+UINT                       offset;
+INT                        i;
+UINT                       j;
+
+    if ((fixed_points == NX_CRYPTO_NULL) ||
+        (u1 -> nx_crypto_huge_number_is_negative) ||
+        (u2 -> nx_crypto_huge_number_is_negative) ||
+        (u1 -> nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (u2 -> nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (q -> nx_crypto_ec_point_x.nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (q -> nx_crypto_ec_point_y.nx_crypto_huge_number_size > NX_CRYPTO_EC_SECP256R1_DIGITS) ||
+        (r -> nx_crypto_ec_point_x.nx_crypto_huge_buffer_size < (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)) ||
+        (r -> nx_crypto_ec_point_y.nx_crypto_huge_buffer_size < (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)) ||
+        (_nx_crypto_huge_number_is_zero(u1)) ||
+        (_nx_crypto_huge_number_is_zero(u2)) ||
+        (_nx_crypto_huge_number_compare_unsigned(u1, &curve -> nx_crypto_ec_n) != NX_CRYPTO_HUGE_NUMBER_LESS) ||
+        (_nx_crypto_huge_number_compare_unsigned(u2, &curve -> nx_crypto_ec_n) != NX_CRYPTO_HUGE_NUMBER_LESS))
+    {
+        _nx_crypto_ec_fp_multiple_add(curve, u1, q, u2, r, scratch);
+        return;
+    }
+
+    NX_CRYPTO_MEMSET(k1, 0, 2 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT));
+    NX_CRYPTO_MEMCPY(k1, u1 -> nx_crypto_huge_number_data, u1 -> nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(k2, u2 -> nx_crypto_huge_number_data, u2 -> nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+    NX_CRYPTO_MEMSET(px, 0, 2 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT));
+    NX_CRYPTO_MEMCPY(px, q -> nx_crypto_ec_point_x.nx_crypto_huge_number_data,
+                     q -> nx_crypto_ec_point_x.nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(py, q -> nx_crypto_ec_point_y.nx_crypto_huge_number_data,
+                     q -> nx_crypto_ec_point_y.nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+    /* Adding zero reduces the coordinates below p. */
+    _nx_crypto_ec_secp256r1_fe_add(px, px, _nx_crypto_ec_secp256r1_fe_zero);
+    _nx_crypto_ec_secp256r1_fe_add(py, py, _nx_crypto_ec_secp256r1_fe_zero);
+
+    /* The odd multiples q, 3q, 5q, ... With (x, y, z) = 2q, they are sums of the affine
+       (x, y) on the curve isomorphic by z, where q is (qx * z^2, qy * z^3) of z = 1.
+       The addition formulas do not involve a, so the isomorphism does not change them. */
+    NX_CRYPTO_MEMCPY(x, px, 2 * (NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT)); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMSET(z, 0, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT);
+    z[0] = 1;
+    _nx_crypto_ec_secp256r1_point_double(x, y, z, t);
+    _nx_crypto_ec_secp256r1_fe_square(t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(table_x, px, t);
+    _nx_crypto_ec_secp256r1_fe_multiply(t, t, z);
+    _nx_crypto_ec_secp256r1_fe_multiply(table_y, py, t);
+    NX_CRYPTO_MEMSET(table_z, 0, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT);
+    table_z[0] = 1;
+    for (j = 1; j < NX_CRYPTO_EC_SECP256R1_WNAF_TABLE; j++)
+    {
+        offset = j * NX_CRYPTO_EC_SECP256R1_DIGITS;
+
+        /* Equal or opposite points only come from a q of small order. */
+        if (_nx_crypto_ec_secp256r1_point_add(table_x + offset - NX_CRYPTO_EC_SECP256R1_DIGITS,
+                                              table_y + offset - NX_CRYPTO_EC_SECP256R1_DIGITS,
+                                              table_z + offset - NX_CRYPTO_EC_SECP256R1_DIGITS,
+                                              x, y, table_x + offset, table_y + offset, table_z + offset, t))
+        {
+            _nx_crypto_ec_fp_multiple_add(curve, u1, q, u2, r, scratch);
+            return;
+        }
+    }
+
+    /* Back on the curve the z of the entries are multiplied by z. They are inverted
+       together from the inverse of their product. */
+    for (j = 0; j < NX_CRYPTO_EC_SECP256R1_WNAF_TABLE; j++)
+    {
+        offset = j * NX_CRYPTO_EC_SECP256R1_DIGITS;
+        _nx_crypto_ec_secp256r1_fe_multiply(table_z + offset, table_z + offset, z);
+        if (j == 0)
+        {
+            NX_CRYPTO_MEMCPY(prefix, table_z, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+        }
+        else
+        {
+            _nx_crypto_ec_secp256r1_fe_multiply(prefix + offset, prefix + offset - NX_CRYPTO_EC_SECP256R1_DIGITS,
+                                                table_z + offset);
+        }
+    }
+
+    offset = (NX_CRYPTO_EC_SECP256R1_WNAF_TABLE - 1) * NX_CRYPTO_EC_SECP256R1_DIGITS;
+    if (_nx_crypto_ec_secp256r1_fe_is_zero(prefix + offset))
+    {
+        _nx_crypto_ec_fp_multiple_add(curve, u1, q, u2, r, scratch);
+        return;
+    }
+    _nx_crypto_ec_secp256r1_fe_inverse(px, prefix + offset, t);
+
+    for (j = NX_CRYPTO_EC_SECP256R1_WNAF_TABLE; j-- > 0;)
+    {
+        offset = j * NX_CRYPTO_EC_SECP256R1_DIGITS;
+
+        /* px = 1 / (z0 * ... * zj) gives 1 / zj and then 1 / (z0 * ... * z(j-1)). */
+        if (j == 0)
+        {
+            NX_CRYPTO_MEMCPY(py, px, NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+        }
+        else
+        {
+            _nx_crypto_ec_secp256r1_fe_multiply(py, px, prefix + offset - NX_CRYPTO_EC_SECP256R1_DIGITS);
+            _nx_crypto_ec_secp256r1_fe_multiply(px, px, table_z + offset);
+        }
+
+        _nx_crypto_ec_secp256r1_fe_square(t, py);
+        _nx_crypto_ec_secp256r1_fe_multiply(table_x + offset, table_x + offset, t);
+        _nx_crypto_ec_secp256r1_fe_multiply(t, t, py);
+        _nx_crypto_ec_secp256r1_fe_multiply(table_y + offset, table_y + offset, t);
+    }
+
+    naf_size = _nx_crypto_ec_secp256r1_wnaf_compute(k2, naf, t);
+
+    /* Doubling from the top digit of the wNAF of u2, or from the top column of the comb of
+       u1. The column of the bits i, i + d, ... of u1 adds its entry of the comb at bit i,
+       as _nx_crypto_ec_secp256r1_comb_multiple does without the 2^e half. */
+    infinite = NX_CRYPTO_TRUE;
+    i = (INT)((naf_size > fixed_points -> nx_crypto_ec_fixed_points_d) ?
+              naf_size : fixed_points -> nx_crypto_ec_fixed_points_d) - 1;
+    for (; i >= 0; i--)
+    {
+        if (infinite == NX_CRYPTO_FALSE)
+        {
+            _nx_crypto_ec_secp256r1_point_double(x, y, z, t);
+        }
+
+        if (((UINT)i < naf_size) && (naf[i] != 0))
+        {
+            offset = ((naf[i] & ~NX_CRYPTO_EC_SECP256R1_WNAF_NEGATIVE) >> 1) * NX_CRYPTO_EC_SECP256R1_DIGITS;
+            if (naf[i] & NX_CRYPTO_EC_SECP256R1_WNAF_NEGATIVE)
+            {
+                _nx_crypto_ec_secp256r1_fe_subtract(py, _nx_crypto_ec_secp256r1_fe_zero, table_y + offset);
+                _nx_crypto_ec_secp256r1_point_accumulate(x, y, z, table_x + offset, py, &infinite, t);
+            }
+            else
+            {
+                _nx_crypto_ec_secp256r1_point_accumulate(x, y, z, table_x + offset, table_y + offset,
+                                                         &infinite, t);
+            }
+        }
+
+        if ((UINT)i < fixed_points -> nx_crypto_ec_fixed_points_d)
+        {
+            column = 0;
+            bit_index = (UINT)i;
+            for (j = 0; j < fixed_points -> nx_crypto_ec_fixed_points_window_width; j++)
+            {
+                column |= (UINT)((k1[bit_index >> 5] >> (bit_index & 31)) & 1) << j;
+                bit_index += fixed_points -> nx_crypto_ec_fixed_points_d;
+            }
+
+            if (column != 0)
+            {
+                if (column == 1)
+                {
+                    point = &curve -> nx_crypto_ec_g;
+                }
+                else
+                {
+                    point = &fixed_points -> nx_crypto_ec_fixed_points_array[column - 2];
+                }
+                _nx_crypto_ec_secp256r1_point_accumulate(x, y, z,
+                                                         point -> nx_crypto_ec_point_x.nx_crypto_huge_number_data,
+                                                         point -> nx_crypto_ec_point_y.nx_crypto_huge_number_data,
+                                                         &infinite, t);
+            }
+        }
+    }
+
+    if (infinite)
+    {
+        _nx_crypto_ec_fp_multiple_add(curve, u1, q, u2, r, scratch);
+        return;
+    }
+
+    /* Back to affine coordinates. */
+    _nx_crypto_ec_secp256r1_fe_inverse(px, z, t);
+    _nx_crypto_ec_secp256r1_fe_square(py, px);
+    _nx_crypto_ec_secp256r1_fe_multiply(x, x, py);
+    _nx_crypto_ec_secp256r1_fe_multiply(py, py, px);
+    _nx_crypto_ec_secp256r1_fe_multiply(y, y, py);
+
+    NX_CRYPTO_MEMCPY(r -> nx_crypto_ec_point_x.nx_crypto_huge_number_data, x,
+                     NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(r -> nx_crypto_ec_point_y.nx_crypto_huge_number_data, y,
+                     NX_CRYPTO_EC_SECP256R1_DIGITS << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    r -> nx_crypto_ec_point_x.nx_crypto_huge_number_size = NX_CRYPTO_EC_SECP256R1_DIGITS;
+    r -> nx_crypto_ec_point_y.nx_crypto_huge_number_size = NX_CRYPTO_EC_SECP256R1_DIGITS;
+    r -> nx_crypto_ec_point_x.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    r -> nx_crypto_ec_point_y.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    _nx_crypto_huge_number_adjust_size(&r -> nx_crypto_ec_point_x);
+    _nx_crypto_huge_number_adjust_size(&r -> nx_crypto_ec_point_y);
+}
+
+#endif /* NX_CRYPTO_HUGE_NUMBER_BITS == 32 */
@@ -0,0 +1,879 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Crypto Component                                                 */
+/**                                                                       */
+/**   Elliptical Curve Cryptography                                       */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#include "nx_crypto_ec.h"
+
+#ifdef NX_CRYPTO_ENABLE_X25519
+
+/* The field elements of curve25519 are 8 digits, least significant first.
+   They are kept below 2^256 and only fully reduced modulo p = 2^255 - 19
+   when encoded, since 2^256 = 38 modulo p folds any carry out of the top
+   digit back in. The field operations run in constant time: they never
+   branch on the value or index memory with it.  */
+#define NX_CRYPTO_EC_X25519_DIGITS         8
+
+/* (A - 2) / 4 of the Montgomery curve v^2 = u^3 + A * u^2 + u, A = 486662.  */
+#define NX_CRYPTO_EC_X25519_A24            121665
+
+static VOID _nx_crypto_ec_x25519_fe_add(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_x25519_fe_subtract(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_x25519_fe_reduce(HN_UBASE *r, const HN_UBASE *c);
+static VOID _nx_crypto_ec_x25519_fe_multiply(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b);
+static VOID _nx_crypto_ec_x25519_fe_square(HN_UBASE *r, const HN_UBASE *a);
+static VOID _nx_crypto_ec_x25519_fe_multiply_a24(HN_UBASE *r, const HN_UBASE *a);
+static VOID _nx_crypto_ec_x25519_fe_square_multiply(HN_UBASE *r, const HN_UBASE *a, UINT n,
+                                                    const HN_UBASE *b);
+static VOID _nx_crypto_ec_x25519_fe_inverse(HN_UBASE *r, const HN_UBASE *a, HN_UBASE *scratch);
+static VOID _nx_crypto_ec_x25519_fe_swap(HN_UBASE *a, HN_UBASE *b, HN_UBASE mask);
+static VOID _nx_crypto_ec_x25519_fe_decode(HN_UBASE *r, const UCHAR *u);
+static VOID _nx_crypto_ec_x25519_fe_encode(UCHAR *u, const HN_UBASE *a);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_add                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds two field elements of curve25519 modulo p in     */
+/*    constant time.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_add(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+HN_UBASE2 carry = 0;
+UINT      i;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)a[i] + b[i];
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+
+    /* Fold the carry, 2^256 = 38. The sum only carries again when it wrapped
+       to a few units, so the second fold cannot carry.  */
+    carry *= 38;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += r[i];
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    r[0] += (HN_UBASE)(carry * 38);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_subtract                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function subtracts two field elements of curve25519 modulo p   */
+/*    in constant time.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_subtract(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+HN_UBASE2 borrow = 0;
+UINT      i;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        borrow = (HN_UBASE2)a[i] - b[i] - borrow;
+        r[i] = (HN_UBASE)borrow;
+        borrow = (borrow >> HN_SHIFT) & 1;
+    }
+
+    /* A borrow added 2^256 = 38, take it back. The difference only borrows
+       again when it wrapped to the top, so the second one cannot borrow.  */
+    borrow *= 38;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        borrow = (HN_UBASE2)r[i] - borrow;
+        r[i] = (HN_UBASE)borrow;
+        borrow = (borrow >> HN_SHIFT) & 1;
+    }
+    r[0] -= (HN_UBASE)(borrow * 38);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_reduce                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reduces a product of two field elements of curve25519 */
+/*    modulo p, folding its upper half with 2^256 = 38. It runs in        */
+/*    constant time.                                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result                        */
+/*    c                                     Product of 16 digits          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_multiply      Multiply field elements       */
+/*    _nx_crypto_ec_x25519_fe_square        Square a field element        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_reduce(HN_UBASE *r, const HN_UBASE *c)
+{
+HN_UBASE2 carry = 0;
+UINT      i;
+
+    /* c = c_low + 2^256 * c_high = c_low + 38 * c_high.  */
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)c[i + NX_CRYPTO_EC_X25519_DIGITS] * 38 + c[i];
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+
+    /* The carry is at most 38, fold it like the sum of two field elements.  */
+    carry *= 38;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += r[i];
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    r[0] += (HN_UBASE)(carry * 38);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_multiply                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function multiplies two field elements of curve25519 modulo p  */
+/*    in constant time.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     First operand                 */
+/*    b                                     Second operand                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_reduce        Reduce a product modulo p     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_inverse       Invert a field element        */
+/*    _nx_crypto_ec_x25519_fe_square_multiply                             */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_multiply(HN_UBASE *r, const HN_UBASE *a, const HN_UBASE *b)
+{
+HN_UBASE t[NX_CRYPTO_EC_X25519_DIGITS << 1];
+HN_UBASE carry;
+HN_UBASE digit;
+UINT     i, j;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        t[i] = 0;
+    }
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry = 0;
+        digit = a[i];
+        for (j = 0; j < NX_CRYPTO_EC_X25519_DIGITS; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(t[i + j], carry, digit, b[j]);
+        }
+        t[i + NX_CRYPTO_EC_X25519_DIGITS] = carry;
+    }
+
+    _nx_crypto_ec_x25519_fe_reduce(r, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_square                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function squares a field element of curve25519 modulo p in     */
+/*    constant time, computing each cross product once.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     Operand                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_reduce        Reduce a product modulo p     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_inverse       Invert a field element        */
+/*    _nx_crypto_ec_x25519_fe_square_multiply                             */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_square(HN_UBASE *r, const HN_UBASE *a)
+{
+HN_UBASE  t[NX_CRYPTO_EC_X25519_DIGITS << 1];
+HN_UBASE  carry;
+HN_UBASE  digit;
+HN_UBASE2 sum;
+UINT      i, j;
+
+    /* The products a[i] * a[j] with i < j, each once.  */
+    for (i = 0; i < (NX_CRYPTO_EC_X25519_DIGITS << 1); i++)
+    {
+        t[i] = 0;
+    }
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS - 1; i++)
+    {
+        carry = 0;
+        digit = a[i];
+        for (j = i + 1; j < NX_CRYPTO_EC_X25519_DIGITS; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(t[i + j], carry, digit, a[j]);
+        }
+        t[i + NX_CRYPTO_EC_X25519_DIGITS] = carry;
+    }
+
+    /* Double them.  */
+    carry = 0;
+    for (i = 0; i < (NX_CRYPTO_EC_X25519_DIGITS << 1); i++)
+    {
+        digit = t[i];
+        t[i] = (digit << 1) | carry;
+        carry = digit >> (HN_SHIFT - 1);
+    }
+
+    /* Add the squares a[i] * a[i].  */
+    carry = 0;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        digit = a[i];
+        HN_MULTIPLY_ACCUMULATE(t[i << 1], carry, digit, digit);
+        sum = (HN_UBASE2)t[(i << 1) + 1] + carry;
+        t[(i << 1) + 1] = (HN_UBASE)sum;
+        carry = (HN_UBASE)(sum >> HN_SHIFT);
+    }
+
+    _nx_crypto_ec_x25519_fe_reduce(r, t);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_multiply_a24                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function multiplies a field element of curve25519 by the       */
+/*    constant a24 = 121665 of the ladder, modulo p in constant time.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     Operand                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_multiply_a24(HN_UBASE *r, const HN_UBASE *a)
+{
+HN_UBASE2 carry = 0;
+UINT      i;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += (HN_UBASE2)a[i] * NX_CRYPTO_EC_X25519_A24;
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+
+    /* The carry is below 2^17, 38 times it still fits in a digit.  */
+    carry *= 38;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += r[i];
+        r[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    r[0] += (HN_UBASE)(carry * 38);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_square_multiply             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes r = a^(2^n) * b modulo p, the step of the    */
+/*    addition chain of the inversion.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be a but not b    */
+/*    a                                     Operand squared               */
+/*    n                                     Number of squarings           */
+/*    b                                     Operand multiplied            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_multiply      Multiply field elements       */
+/*    _nx_crypto_ec_x25519_fe_square        Square a field element        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_inverse       Invert a field element        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_square_multiply(HN_UBASE *r, const HN_UBASE *a, UINT n,
+                                                                   const HN_UBASE *b)
+{
+UINT i;
+
+    _nx_crypto_ec_x25519_fe_square(r, a);
+    for (i = 1; i < n; i++)
+    {
+        _nx_crypto_ec_x25519_fe_square(r, r);
+    }
+    _nx_crypto_ec_x25519_fe_multiply(r, r, b);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_inverse                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function inverts a field element of curve25519 modulo p in     */
+/*    constant time, as a^(p - 2) with a fixed addition chain of 254      */
+/*    squarings and 11 multiplications.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result, may be an operand     */
+/*    a                                     Operand                       */
+/*    scratch                               Pointer to scratch buffer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_multiply      Multiply field elements       */
+/*    _nx_crypto_ec_x25519_fe_square        Square a field element        */
+/*    _nx_crypto_ec_x25519_fe_square_multiply                             */
+/*                                          Square repeatedly and multiply*/
+/*                                            field elements              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_inverse(HN_UBASE *r, const HN_UBASE *a, HN_UBASE *scratch)
+{
+HN_UBASE *a_11 = scratch;
+HN_UBASE *a_2_5 = a_11 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *a_2_10 = a_2_5 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *a_2_20 = a_2_10 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *a_2_50 = a_2_20 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *a_2_100 = a_2_50 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *t = a_2_100 + NX_CRYPTO_EC_X25519_DIGITS;
+
+    /* a_2_n is a^(2^n - 1), p - 2 = 2^255 - 21 = (2^250 - 1) * 2^5 + 11.
+       a_2_10 first holds a^9.  */
+    _nx_crypto_ec_x25519_fe_square(t, a);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_10, t, 2, a);
+    _nx_crypto_ec_x25519_fe_multiply(a_11, a_2_10, t);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_5, a_11, 1, a_2_10);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_10, a_2_5, 5, a_2_5);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_20, a_2_10, 10, a_2_10);
+    _nx_crypto_ec_x25519_fe_square_multiply(t, a_2_20, 20, a_2_20);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_50, t, 10, a_2_10);
+    _nx_crypto_ec_x25519_fe_square_multiply(a_2_100, a_2_50, 50, a_2_50);
+    _nx_crypto_ec_x25519_fe_square_multiply(t, a_2_100, 100, a_2_100);
+    _nx_crypto_ec_x25519_fe_square_multiply(t, t, 50, a_2_50);
+    _nx_crypto_ec_x25519_fe_square_multiply(r, t, 5, a_11);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_swap                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function swaps two field elements when mask is all ones and    */
+/*    leaves them unchanged when mask is zero, without a branch.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    a                                     First field element           */
+/*    b                                     Second field element          */
+/*    mask                                  All ones or zero              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_swap(HN_UBASE *a, HN_UBASE *b, HN_UBASE mask)
+{
+HN_UBASE t;
+UINT     i;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        t = (a[i] ^ b[i]) & mask;
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_decode                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function decodes the 32 little endian bytes of a u-coordinate  */
+/*    into a field element, ignoring the most significant bit.            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Field element                 */
+/*    u                                     Encoded u-coordinate          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_decode(HN_UBASE *r, const UCHAR *u)
+{
+UINT i;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        r[i] = (HN_UBASE)u[0] | ((HN_UBASE)u[1] << 8) | ((HN_UBASE)u[2] << 16) | ((HN_UBASE)u[3] << 24);
+        u += 4;
+    }
+
+    /* The most significant bit is ignored (RFC 7748, section 5).  */
+    r[NX_CRYPTO_EC_X25519_DIGITS - 1] &= 0x7FFFFFFF;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_encode                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function encodes a field element as the 32 little endian bytes */
+/*    of a u-coordinate, fully reduced modulo p, in constant time.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    u                                     Encoded u-coordinate          */
+/*    a                                     Field element                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP static VOID _nx_crypto_ec_x25519_fe_encode(UCHAR *u, const HN_UBASE *a)
+{
+HN_UBASE  r[NX_CRYPTO_EC_X25519_DIGITS];
+HN_UBASE  t[NX_CRYPTO_EC_X25519_DIGITS];
+HN_UBASE2 carry;
+HN_UBASE  mask;
+UINT      i, j;
+
+    /* Bring a below 2^255 by folding bit 255 twice, 2^255 = 19.  */
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        r[i] = a[i];
+    }
+    for (j = 0; j < 2; j++)
+    {
+        carry = (HN_UBASE2)(r[NX_CRYPTO_EC_X25519_DIGITS - 1] >> 31) * 19;
+        r[NX_CRYPTO_EC_X25519_DIGITS - 1] &= 0x7FFFFFFF;
+        for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+        {
+            carry += r[i];
+            r[i] = (HN_UBASE)carry;
+            carry >>= HN_SHIFT;
+        }
+    }
+
+    /* r - p = r + 19 - 2^255, kept when it reaches bit 255.  */
+    carry = 19;
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        carry += r[i];
+        t[i] = (HN_UBASE)carry;
+        carry >>= HN_SHIFT;
+    }
+    mask = (HN_UBASE)0 - (t[NX_CRYPTO_EC_X25519_DIGITS - 1] >> 31);
+    t[NX_CRYPTO_EC_X25519_DIGITS - 1] &= 0x7FFFFFFF;
+
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        r[i] ^= (r[i] ^ t[i]) & mask;
+        u[0] = (UCHAR)r[i];
+        u[1] = (UCHAR)(r[i] >> 8);
+        u[2] = (UCHAR)(r[i] >> 16);
+        u[3] = (UCHAR)(r[i] >> 24);
+        u += 4;
+    }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the X25519 function of RFC 7748: the         */
+/*    u-coordinate of k times the point of u-coordinate u on curve25519,  */
+/*    with the constant time Montgomery ladder. k is clamped as the RFC   */
+/*    requires. The result may overwrite u.                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    r                                     Result u-coordinate, 32 bytes */
+/*    k                                     Scalar, 32 bytes              */
+/*    u                                     U-coordinate, 32 bytes        */
+/*    scratch                               Pointer to scratch buffer of  */
+/*                                            at least 352 bytes          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_fe_add           Add field elements            */
+/*    _nx_crypto_ec_x25519_fe_decode        Decode a u-coordinate         */
+/*    _nx_crypto_ec_x25519_fe_encode        Encode a u-coordinate         */
+/*    _nx_crypto_ec_x25519_fe_inverse       Invert a field element        */
+/*    _nx_crypto_ec_x25519_fe_multiply      Multiply field elements       */
+/*    _nx_crypto_ec_x25519_fe_multiply_a24  Multiply a field element by   */
+/*                                            a24                         */
+/*    _nx_crypto_ec_x25519_fe_square        Square a field element        */
+/*    _nx_crypto_ec_x25519_fe_subtract      Subtract field elements       */
+/*    _nx_crypto_ec_x25519_fe_swap          Swap field elements by mask   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_multiple         Calculate the multiplication  */
+/*                                            of a point                  */
+/*    _nx_crypto_ecdh_compute_secret_x25519                               */
+/*                                          Compute X25519 shared secret  */
+/*    _nx_crypto_ecdh_setup_x25519          Setup X25519 local key pair   */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_ec_x25519_scalar_multiply(UCHAR *r, const UCHAR *k, const UCHAR *u, HN_UBASE *scratch)
+{
+UCHAR     scalar[NX_CRYPTO_EC_X25519_KEY_SIZE];
+HN_UBASE *x_1 = scratch;
+HN_UBASE *x_2 = x_1 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *z_2 = x_2 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *x_3 = z_2 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *z_3 = x_3 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *a = z_3 + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *aa = a + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *b = aa + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *bb = b + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *c = bb + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE *d = c + NX_CRYPTO_EC_X25519_DIGITS;
+HN_UBASE  swap = 0;
+HN_UBASE  bit;
+UINT      i;
+INT       t;
+
+    /* Clamp the scalar: a multiple of the cofactor 8, with bit 254 set.  */
+    NX_CRYPTO_MEMCPY(scalar, k, sizeof(scalar)); /* Use case of memcpy is verified. */
+    scalar[0] &= 248;
+    scalar[NX_CRYPTO_EC_X25519_KEY_SIZE - 1] &= 127;
+    scalar[NX_CRYPTO_EC_X25519_KEY_SIZE - 1] |= 64;
+
+    _nx_crypto_ec_x25519_fe_decode(x_1, u);
+    for (i = 0; i < NX_CRYPTO_EC_X25519_DIGITS; i++)
+    {
+        x_2[i] = 0;
+        z_2[i] = 0;
+        x_3[i] = x_1[i];
+        z_3[i] = 0;
+    }
+    x_2[0] = 1;
+    z_3[0] = 1;
+
+    /* Montgomery ladder of RFC 7748, section 5. (x_2 : z_2) = m * u and
+       (x_3 : z_3) = (m + 1) * u after the bits of m processed.  */
+    for (t = 254; t >= 0; t--)
+    {
+        bit = (HN_UBASE)((scalar[t >> 3] >> (t & 7)) & 1);
+        swap ^= bit;
+        _nx_crypto_ec_x25519_fe_swap(x_2, x_3, (HN_UBASE)0 - swap);
+        _nx_crypto_ec_x25519_fe_swap(z_2, z_3, (HN_UBASE)0 - swap);
+        swap = bit;
+
+        _nx_crypto_ec_x25519_fe_add(a, x_2, z_2);
+        _nx_crypto_ec_x25519_fe_square(aa, a);
+        _nx_crypto_ec_x25519_fe_subtract(b, x_2, z_2);
+        _nx_crypto_ec_x25519_fe_square(bb, b);
+        _nx_crypto_ec_x25519_fe_add(c, x_3, z_3);
+        _nx_crypto_ec_x25519_fe_subtract(d, x_3, z_3);
+
+        /* DA and CB.  */
+        _nx_crypto_ec_x25519_fe_multiply(d, d, a);
+        _nx_crypto_ec_x25519_fe_multiply(c, c, b);
+
+        /* x_3 = (DA + CB)^2, z_3 = x_1 * (DA - CB)^2.  */
+        _nx_crypto_ec_x25519_fe_add(x_3, d, c);
+        _nx_crypto_ec_x25519_fe_square(x_3, x_3);
+        _nx_crypto_ec_x25519_fe_subtract(z_3, d, c);
+        _nx_crypto_ec_x25519_fe_square(z_3, z_3);
+        _nx_crypto_ec_x25519_fe_multiply(z_3, z_3, x_1);
+
+        /* x_2 = AA * BB, z_2 = E * (AA + a24 * E) with E = AA - BB.  */
+        _nx_crypto_ec_x25519_fe_multiply(x_2, aa, bb);
+        _nx_crypto_ec_x25519_fe_subtract(bb, aa, bb);
+        _nx_crypto_ec_x25519_fe_multiply_a24(a, bb);
+        _nx_crypto_ec_x25519_fe_add(a, a, aa);
+        _nx_crypto_ec_x25519_fe_multiply(z_2, bb, a);
+    }
+    _nx_crypto_ec_x25519_fe_swap(x_2, x_3, (HN_UBASE)0 - swap);
+    _nx_crypto_ec_x25519_fe_swap(z_2, z_3, (HN_UBASE)0 - swap);
+
+    /* u = x_2 / z_2, zero for the points of small order.  */
+    _nx_crypto_ec_x25519_fe_inverse(z_2, z_2, x_3);
+    _nx_crypto_ec_x25519_fe_multiply(x_2, x_2, z_2);
+    _nx_crypto_ec_x25519_fe_encode(r, x_2);
+
+    NX_CRYPTO_MEMSET(scalar, 0, sizeof(scalar));
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_multiple                       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates the multiplication r = g * d on curve25519 */
+/*    for the curve structure. Only the x coordinates are used, as the    */
+/*    u-coordinates of X25519, and d is clamped like an X25519 private    */
+/*    key.                                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve                                 Pointer to curve              */
+/*    g                                     Base point g                  */
+/*    d                                     Factor d                      */
+/*    r                                     Result r                      */
+/*    scratch                               Pointer to scratch buffer of  */
+/*                                            at least 416 bytes          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*    _nx_crypto_huge_number_extract_fixed_size                           */
+/*                                          Extract huge number           */
+/*    _nx_crypto_huge_number_setup          Setup huge number             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_ec_x25519_multiple(NX_CRYPTO_EC *curve,
+                                                  NX_CRYPTO_EC_POINT *g,
+                                                  NX_CRYPTO_HUGE_NUMBER *d,
+                                                  NX_CRYPTO_EC_POINT *r,
+                                                  HN_UBASE *scratch)
+{
+UCHAR *k = (UCHAR *)scratch;
+UCHAR *u = k + NX_CRYPTO_EC_X25519_KEY_SIZE;
+UCHAR  byte;
+UINT   i;
+
+    NX_CRYPTO_PARAMETER_NOT_USED(curve);
+
+    /* The huge numbers are big endian, X25519 little endian.  */
+    _nx_crypto_huge_number_extract_fixed_size(d, k, NX_CRYPTO_EC_X25519_KEY_SIZE);
+    _nx_crypto_huge_number_extract_fixed_size(&g -> nx_crypto_ec_point_x, u, NX_CRYPTO_EC_X25519_KEY_SIZE);
+    for (i = 0; i < (NX_CRYPTO_EC_X25519_KEY_SIZE >> 1); i++)
+    {
+        byte = k[i];
+        k[i] = k[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i];
+        k[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i] = byte;
+        byte = u[i];
+        u[i] = u[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i];
+        u[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i] = byte;
+    }
+
+    _nx_crypto_ec_x25519_scalar_multiply(u, k, u, scratch + ((NX_CRYPTO_EC_X25519_KEY_SIZE << 1) >> HN_SIZE_SHIFT));
+
+    for (i = 0; i < (NX_CRYPTO_EC_X25519_KEY_SIZE >> 1); i++)
+    {
+        byte = u[i];
+        u[i] = u[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i];
+        u[NX_CRYPTO_EC_X25519_KEY_SIZE - 1 - i] = byte;
+    }
+    _nx_crypto_huge_number_setup(&r -> nx_crypto_ec_point_x, u, NX_CRYPTO_EC_X25519_KEY_SIZE);
+    NX_CRYPTO_MEMSET(k, 0, NX_CRYPTO_EC_X25519_KEY_SIZE);
+}
+
+#endif /* NX_CRYPTO_ENABLE_X25519 */
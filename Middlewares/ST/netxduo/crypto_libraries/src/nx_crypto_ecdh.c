@@ -90,6 +90,24 @@ NX_CRYPTO_HUGE_NUMBER private_key;
         return(NX_CRYPTO_SIZE_ERROR);
     }
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+    if (curve -> nx_crypto_ec_id == NX_CRYPTO_EC_X25519)
+    {
+
+        /* The X25519 private key is kept as the bytes it is made of. */
+        if (local_private_key_len != NX_CRYPTO_EC_X25519_KEY_SIZE)
+        {
+            return(NX_CRYPTO_SIZE_ERROR);
+        }
+
+        ecdh_ptr -> nx_crypto_ecdh_key_size = NX_CRYPTO_EC_X25519_KEY_SIZE;
+        NX_CRYPTO_MEMCPY(ecdh_ptr -> nx_crypto_ecdh_private_key_buffer, local_private_key_ptr,
+                         NX_CRYPTO_EC_X25519_KEY_SIZE); /* Use case of memcpy is verified. */
+
+        return(NX_CRYPTO_SUCCESS);
+    }
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
     public_key_len = 1 + (((curve -> nx_crypto_ec_bits + 7) >> 3) << 1);
     if (local_public_key_len > public_key_len)
     {
@@ -177,6 +195,22 @@ NX_CRYPTO_HUGE_NUMBER private_key;
     /* Figure out the sizes of our keys and buffers. */
     key_size = ecdh_ptr -> nx_crypto_ecdh_key_size;
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+    if (curve -> nx_crypto_ec_id == NX_CRYPTO_EC_X25519)
+    {
+        if (local_private_key_len < NX_CRYPTO_EC_X25519_KEY_SIZE)
+        {
+            return(NX_CRYPTO_SIZE_ERROR);
+        }
+
+        NX_CRYPTO_MEMCPY(local_private_key_ptr, ecdh_ptr -> nx_crypto_ecdh_private_key_buffer,
+                         NX_CRYPTO_EC_X25519_KEY_SIZE); /* Use case of memcpy is verified. */
+        *actual_local_private_key_len = NX_CRYPTO_EC_X25519_KEY_SIZE;
+
+        return(NX_CRYPTO_SUCCESS);
+    }
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
     /* Check to make sure the buffer is large enough to hold the private key. */
     clen = (curve -> nx_crypto_ec_bits + 7) >> 3;
     if (local_private_key_len < clen)
@@ -237,6 +271,7 @@ NX_CRYPTO_HUGE_NUMBER private_key;
 /*                                                                        */
 /*    _nx_crypto_ec_key_pair_generation_extra                             */
 /*                                          Generate EC Key Pair          */
+/*    _nx_crypto_ecdh_setup_x25519          Setup X25519 local key pair   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -263,6 +298,14 @@ UINT public_key_len;
 NX_CRYPTO_HUGE_NUMBER private_key;
 NX_CRYPTO_EC_POINT    public_key;
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+    if (curve -> nx_crypto_ec_id == NX_CRYPTO_EC_X25519)
+    {
+        return(_nx_crypto_ecdh_setup_x25519(ecdh_ptr, local_public_key_ptr, local_public_key_len,
+                                            actual_local_public_key_len, curve, scratch_buf_ptr));
+    }
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
     public_key_len = 1 + (((curve -> nx_crypto_ec_bits + 7) >> 3) << 1);
     if (local_public_key_len < public_key_len)
     {
@@ -343,6 +386,7 @@ NX_CRYPTO_EC_POINT    public_key;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_crypto_ecdh_compute_secret_x25519 Compute X25519 shared secret  */
 /*    _nx_crypto_huge_number_extract        Extract huge number           */
 /*    _nx_crypto_huge_number_setup          Setup huge number             */
 /*                                                                        */
@@ -385,6 +429,15 @@ NX_CRYPTO_EC_POINT    public_key, shared_secret;
 
     curve = ecdh_ptr -> nx_crypto_ecdh_curve;
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+    if (curve -> nx_crypto_ec_id == NX_CRYPTO_EC_X25519)
+    {
+        return(_nx_crypto_ecdh_compute_secret_x25519(ecdh_ptr, share_secret_key_ptr, share_secret_key_len_ptr,
+                                                     actual_share_secret_key_len, remote_public_key,
+                                                     remote_public_key_len, scratch_buf_ptr));
+    }
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
     /* Figure out the sizes of our keys and buffers. We need 4X the key size for our buffer space. */
     key_size = ecdh_ptr -> nx_crypto_ecdh_key_size;
 
@@ -441,6 +494,154 @@ NX_CRYPTO_EC_POINT    public_key, shared_secret;
     return(status);
 }
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ecdh_setup_x25519                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets up an X25519 Diffie-Hellman context (RFC 7748)   */
+/*    by generating a local key pair. The private key is 32 random bytes, */
+/*    the public key the u-coordinate X25519(private key, 9).             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ecdh_ptr                              ECDH context                  */
+/*    local_public_key_ptr                  Pointer to local public key   */
+/*    local_public_key_len                  Public key buffer length      */
+/*    actual_local_public_key_len           Pointer to public key length  */
+/*    curve                                 Elliptic Curve                */
+/*    scratch_buf_ptr                       Pointer to scratch buffer of  */
+/*                                            at least 384 bytes          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ecdh_setup                 Setup ECDH local key pair     */
+/*    _nx_crypto_method_ecdh_operation      Handle ECDH operation         */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_ecdh_setup_x25519(NX_CRYPTO_ECDH  *ecdh_ptr,
+                                                 UCHAR  *local_public_key_ptr,
+                                                 ULONG   local_public_key_len,
+                                                 ULONG  *actual_local_public_key_len,
+                                                 NX_CRYPTO_EC *curve,
+                                                 HN_UBASE *scratch_buf_ptr)
+{
+UINT   status;
+UCHAR *base_point = (UCHAR *)scratch_buf_ptr;
+
+    if (local_public_key_len < NX_CRYPTO_EC_X25519_KEY_SIZE)
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    ecdh_ptr -> nx_crypto_ecdh_curve = curve;
+    ecdh_ptr -> nx_crypto_ecdh_key_size = NX_CRYPTO_EC_X25519_KEY_SIZE;
+
+    /* Clear the private key buffer. */
+    NX_CRYPTO_MEMSET(ecdh_ptr -> nx_crypto_ecdh_private_key_buffer, 0,
+                     sizeof(ecdh_ptr -> nx_crypto_ecdh_private_key_buffer));
+
+    /* Any 32 bytes are a private key, _nx_crypto_ec_x25519_scalar_multiply clamps them. */
+    status = NX_CRYPTO_RBG(NX_CRYPTO_EC_X25519_KEY_SIZE << 3, (UCHAR *)ecdh_ptr -> nx_crypto_ecdh_private_key_buffer);
+    if (status)
+    {
+        return(status);
+    }
+
+    /* The public key is the private key times the base point, of u = 9. */
+    NX_CRYPTO_MEMSET(base_point, 0, NX_CRYPTO_EC_X25519_KEY_SIZE);
+    base_point[0] = 9;
+    _nx_crypto_ec_x25519_scalar_multiply(local_public_key_ptr, (UCHAR *)ecdh_ptr -> nx_crypto_ecdh_private_key_buffer,
+                                         base_point, scratch_buf_ptr + (NX_CRYPTO_EC_X25519_KEY_SIZE >> HN_SIZE_SHIFT));
+    *actual_local_public_key_len = NX_CRYPTO_EC_X25519_KEY_SIZE;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_ecdh_compute_secret_x25519               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the X25519 shared secret from the local      */
+/*    private key and the u-coordinate received from the remote entity.   */
+/*    The all-zero secret of the points of small order is rejected (RFC   */
+/*    7748, section 6.1).                                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ecdh_ptr                              ECDH context                  */
+/*    share_secret_key_ptr                  Shared secret buffer pointer  */
+/*    share_secret_key_len_ptr              Length of shared secret buffer*/
+/*    actual_share_secret_key_len           Length of shared secret       */
+/*    remote_public_key                     Pointer to remote public key  */
+/*    remote_public_key_len                 Remote public key length      */
+/*    scratch_buf_ptr                       Pointer to scratch buffer of  */
+/*                                            at least 352 bytes          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_ec_x25519_scalar_multiply  Compute X25519                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ecdh_compute_secret        Compute ECDH shared secret    */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_ecdh_compute_secret_x25519(NX_CRYPTO_ECDH  *ecdh_ptr,
+                                                          UCHAR  *share_secret_key_ptr,
+                                                          ULONG   share_secret_key_len_ptr,
+                                                          ULONG  *actual_share_secret_key_len,
+                                                          UCHAR  *remote_public_key,
+                                                          ULONG   remote_public_key_len,
+                                                          HN_UBASE *scratch_buf_ptr)
+{
+UCHAR non_zero = 0;
+UINT  i;
+
+    if ((remote_public_key_len != NX_CRYPTO_EC_X25519_KEY_SIZE) ||
+        (share_secret_key_len_ptr < NX_CRYPTO_EC_X25519_KEY_SIZE))
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    _nx_crypto_ec_x25519_scalar_multiply(share_secret_key_ptr, (UCHAR *)ecdh_ptr -> nx_crypto_ecdh_private_key_buffer,
+                                         remote_public_key, scratch_buf_ptr);
+
+    /* Check the secret without a branch on its bytes. */
+    for (i = 0; i < NX_CRYPTO_EC_X25519_KEY_SIZE; i++)
+    {
+        non_zero |= share_secret_key_ptr[i];
+    }
+    if (non_zero == 0)
+    {
+        return(NX_CRYPTO_INVALID_KEY);
+    }
+    *actual_share_secret_key_len = NX_CRYPTO_EC_X25519_KEY_SIZE;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
 
 /**************************************************************************/
 /*                                                                        */
@@ -616,6 +817,7 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_method_ecdh_cleanup(VOID *crypto_metadata)
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_ecdh_setup                 Setup local key pair          */
+/*    _nx_crypto_ecdh_setup_x25519          Setup X25519 local key pair   */
 /*    _nx_crypto_ecdh_compute_secret        Compute shared secret         */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -646,6 +848,7 @@ NX_CRYPTO_ECDH *ecdh;
 UINT            status = NX_CRYPTO_SUCCESS;
 NX_CRYPTO_EXTENDED_OUTPUT
                *extended_output;
+CYCLE_PROFILE_SAVE_AREA
 
     NX_CRYPTO_PARAMETER_NOT_USED(handle);
     NX_CRYPTO_PARAMETER_NOT_USED(iv_ptr);
@@ -691,22 +894,56 @@ NX_CRYPTO_EXTENDED_OUTPUT
         }
 
         extended_output = (NX_CRYPTO_EXTENDED_OUTPUT *)output;
+
+#ifdef NX_CRYPTO_ENABLE_X25519
+        if (ecdh -> nx_crypto_ecdh_curve -> nx_crypto_ec_id == NX_CRYPTO_EC_X25519)
+        {
+
+            /* The private key followed by the public key, like the other curves. */
+            if (extended_output -> nx_crypto_extended_output_length_in_byte < (NX_CRYPTO_EC_X25519_KEY_SIZE << 1))
+            {
+                return(NX_CRYPTO_SIZE_ERROR);
+            }
+
+            status = _nx_crypto_ecdh_setup_x25519(ecdh,
+                                                  extended_output -> nx_crypto_extended_output_data + NX_CRYPTO_EC_X25519_KEY_SIZE,
+                                                  NX_CRYPTO_EC_X25519_KEY_SIZE,
+                                                  &extended_output -> nx_crypto_extended_output_actual_size,
+                                                  ecdh -> nx_crypto_ecdh_curve,
+                                                  ecdh -> nx_crypto_ecdh_scratch_buffer);
+            if (status)
+            {
+                return(status);
+            }
+
+            NX_CRYPTO_MEMCPY(extended_output -> nx_crypto_extended_output_data, ecdh -> nx_crypto_ecdh_private_key_buffer,
+                             NX_CRYPTO_EC_X25519_KEY_SIZE); /* Use case of memcpy is verified. */
+            extended_output -> nx_crypto_extended_output_actual_size = NX_CRYPTO_EC_X25519_KEY_SIZE << 1;
+
+            return(NX_CRYPTO_SUCCESS);
+        }
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
+        CYCLE_PROFILE_ENTER
         status = _nx_crypto_ec_key_pair_stream_generate(ecdh -> nx_crypto_ecdh_curve,
                                                         extended_output -> nx_crypto_extended_output_data,
                                                         extended_output -> nx_crypto_extended_output_length_in_byte,
                                                         &extended_output -> nx_crypto_extended_output_actual_size,
                                                         ecdh -> nx_crypto_ecdh_scratch_buffer);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ECDH)
     }
     else if (op == NX_CRYPTO_DH_SETUP)
     {
         /* Setup local key pair. */
         extended_output = (NX_CRYPTO_EXTENDED_OUTPUT *)output;
+        CYCLE_PROFILE_ENTER
         status = _nx_crypto_ecdh_setup(ecdh,
                                        extended_output -> nx_crypto_extended_output_data,
                                        extended_output -> nx_crypto_extended_output_length_in_byte,
                                        &extended_output -> nx_crypto_extended_output_actual_size,
                                        ecdh -> nx_crypto_ecdh_curve,
                                        ecdh -> nx_crypto_ecdh_scratch_buffer);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ECDH)
     }
     else if (op == NX_CRYPTO_DH_KEY_PAIR_IMPORT)
     {
@@ -733,6 +970,7 @@ NX_CRYPTO_EXTENDED_OUTPUT
     {
         /* Compute shared secret. */
         extended_output = (NX_CRYPTO_EXTENDED_OUTPUT *)output;
+        CYCLE_PROFILE_ENTER
         status = _nx_crypto_ecdh_compute_secret(ecdh,
                                                 extended_output -> nx_crypto_extended_output_data,
                                                 extended_output -> nx_crypto_extended_output_length_in_byte,
@@ -740,6 +978,7 @@ NX_CRYPTO_EXTENDED_OUTPUT
                                                 input,
                                                 input_length_in_byte,
                                                 ecdh -> nx_crypto_ecdh_scratch_buffer);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ECDH)
     }
     else
     {
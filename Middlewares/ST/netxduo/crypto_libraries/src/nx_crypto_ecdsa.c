@@ -59,6 +59,9 @@
 /*                                                                        */
 /*    _nx_crypto_ec_key_pair_generation_extra                             */
 /*                                          Generate EC Key Pair          */
+/*    _nx_crypto_huge_number_barrett_reduce                               */
+/*                                          Reduce a huge number modulo   */
+/*                                            the group order             */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -160,7 +163,8 @@ UCHAR                *signature_s;
                                                     scratch);
 
             /* Calculate r = pt.x mod n */
-            _nx_crypto_huge_number_modulus(&pt.nx_crypto_ec_point_x, &curve -> nx_crypto_ec_n);
+            _nx_crypto_huge_number_barrett_reduce(&pt.nx_crypto_ec_point_x, &curve -> nx_crypto_ec_n,
+                                                  &curve -> nx_crypto_ec_n_mu, scratch);
 
         } while (_nx_crypto_huge_number_is_zero(&pt.nx_crypto_ec_point_x));
 
@@ -168,10 +172,12 @@ UCHAR                *signature_s;
         _nx_crypto_huge_number_inverse_modulus(&k, &curve -> nx_crypto_ec_n, &ik, scratch);
         _nx_crypto_huge_number_multiply(&pt.nx_crypto_ec_point_x, &privkey, &temp);
         _nx_crypto_huge_number_add_unsigned(&temp, &z);
-        _nx_crypto_huge_number_modulus(&temp, &curve -> nx_crypto_ec_n);
+        _nx_crypto_huge_number_barrett_reduce(&temp, &curve -> nx_crypto_ec_n,
+                                              &curve -> nx_crypto_ec_n_mu, scratch);
         NX_CRYPTO_HUGE_NUMBER_COPY(&k, &temp);
         _nx_crypto_huge_number_multiply(&ik, &k, &temp);
-        _nx_crypto_huge_number_modulus(&temp, &curve -> nx_crypto_ec_n);
+        _nx_crypto_huge_number_barrett_reduce(&temp, &curve -> nx_crypto_ec_n,
+                                              &curve -> nx_crypto_ec_n_mu, scratch);
 
     } while (_nx_crypto_huge_number_is_zero(&temp));
 
@@ -297,6 +303,9 @@ UCHAR                *signature_s;
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_huge_number_setup          Generate private key          */
+/*    _nx_crypto_huge_number_barrett_reduce                               */
+/*                                          Reduce a huge number modulo   */
+/*                                            the group order             */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -326,7 +335,6 @@ NX_CRYPTO_HUGE_NUMBER u1;
 NX_CRYPTO_HUGE_NUMBER u2;
 NX_CRYPTO_EC_POINT    pubkey;
 NX_CRYPTO_EC_POINT    pt;
-NX_CRYPTO_EC_POINT    pt2;
 UINT                  buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffer_size;
 
     /* Signature format follows ASN1 DER encoding as per RFC 4492, section 5.8:
@@ -373,7 +381,6 @@ UINT                  buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffe
     NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&u2, scratch, buffer_size << 1);
     NX_CRYPTO_EC_POINT_INITIALIZE(&pubkey, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
     NX_CRYPTO_EC_POINT_INITIALIZE(&pt, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
-    NX_CRYPTO_EC_POINT_INITIALIZE(&pt2, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
 
     /* Copy the public key from the caller's buffer. */
     status = _nx_crypto_ec_point_setup(&pubkey, public_key, public_key_length);
@@ -454,19 +461,19 @@ UINT                  buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffe
 
     /* Calculate u1 = zw mod n */
     _nx_crypto_huge_number_multiply(&z, &w, &u1);
-    _nx_crypto_huge_number_modulus(&u1, &curve -> nx_crypto_ec_n);
+    _nx_crypto_huge_number_barrett_reduce(&u1, &curve -> nx_crypto_ec_n,
+                                          &curve -> nx_crypto_ec_n_mu, scratch);
 
     /* Calculate u2 = rw mod n */
     _nx_crypto_huge_number_multiply(&r, &w, &u2);
-    _nx_crypto_huge_number_modulus(&u2, &curve -> nx_crypto_ec_n);
+    _nx_crypto_huge_number_barrett_reduce(&u2, &curve -> nx_crypto_ec_n,
+                                          &curve -> nx_crypto_ec_n_mu, scratch);
 
     /* Calculate (x1,y1) = u1*G + u2*public_key */
-    curve -> nx_crypto_ec_multiple(curve, &curve -> nx_crypto_ec_g, &u1, &pt, scratch);
-    curve -> nx_crypto_ec_multiple(curve, &pubkey, &u2, &pt2, scratch);
+    curve -> nx_crypto_ec_multiple_add(curve, &u1, &pubkey, &u2, &pt, scratch);
 
-    curve -> nx_crypto_ec_add(curve, &pt, &pt2, scratch);
-
-    _nx_crypto_huge_number_modulus(&pt.nx_crypto_ec_point_x, &curve -> nx_crypto_ec_n);
+    _nx_crypto_huge_number_barrett_reduce(&pt.nx_crypto_ec_point_x, &curve -> nx_crypto_ec_n,
+                                          &curve -> nx_crypto_ec_n_mu, scratch);
 
     /* Check r == x1 mod n */
     if (NX_CRYPTO_HUGE_NUMBER_EQUAL != _nx_crypto_huge_number_compare_unsigned(&pt.nx_crypto_ec_point_x, &r))
@@ -690,6 +697,7 @@ NX_CRYPTO_EXTENDED_OUTPUT
 NX_CRYPTO_METHOD *hash_method;
 VOID            *hash_handler = NX_CRYPTO_NULL;
 UCHAR           *hash_output = NX_CRYPTO_NULL;
+CYCLE_PROFILE_SAVE_AREA
 
     NX_CRYPTO_PARAMETER_NOT_USED(handle);
     NX_CRYPTO_PARAMETER_NOT_USED(iv_ptr);
@@ -865,6 +873,7 @@ UCHAR           *hash_output = NX_CRYPTO_NULL;
                 /* Signature generation. */
                 extended_output = (NX_CRYPTO_EXTENDED_OUTPUT *)output;
 
+                CYCLE_PROFILE_ENTER
                 status = _nx_crypto_ecdsa_sign(ecdsa -> nx_crypto_ecdsa_curve,
                                                hash_output,
                                                (hash_method -> nx_crypto_ICV_size_in_bits >> 3),
@@ -874,11 +883,13 @@ UCHAR           *hash_output = NX_CRYPTO_NULL;
                                                extended_output -> nx_crypto_extended_output_length_in_byte,
                                                &extended_output -> nx_crypto_extended_output_actual_size,
                                                ecdsa -> nx_crypto_ecdsa_scratch_buffer);
+                CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ECDSA)
             }
             else
             {
 
                 /* Signature verification. */
+                CYCLE_PROFILE_ENTER
                 status = _nx_crypto_ecdsa_verify(ecdsa->nx_crypto_ecdsa_curve,
                                                  hash_output,
                                                  (hash_method -> nx_crypto_ICV_size_in_bits >> 3),
@@ -886,6 +897,7 @@ UCHAR           *hash_output = NX_CRYPTO_NULL;
                                                  key_size_in_bits >> 3,
                                                  output, output_length_in_byte,
                                                  ecdsa -> nx_crypto_ecdsa_scratch_buffer);
+                CYCLE_PROFILE_EXIT(CYCLE_PROFILE_ECDSA)
             }
         }
     }
@@ -21,6 +21,80 @@
 /**************************************************************************/
 
 #include "nx_crypto_gcm.h"
+#include "nx_crypto_aes.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
+
+/* Reduction of the bits shifted out of a block multiplied by x^4 (or x^8), to add
+   to its 16 most significant bits.  */
+#if (NX_CRYPTO_GCM_TABLE_BITS == 8)
+static const USHORT _nx_crypto_gcm_reduction[256] =
+{
+    0x0000, 0x01C2, 0x0384, 0x0246, 0x0708, 0x06CA, 0x048C, 0x054E,
+    0x0E10, 0x0FD2, 0x0D94, 0x0C56, 0x0918, 0x08DA, 0x0A9C, 0x0B5E,
+    0x1C20, 0x1DE2, 0x1FA4, 0x1E66, 0x1B28, 0x1AEA, 0x18AC, 0x196E,
+    0x1230, 0x13F2, 0x11B4, 0x1076, 0x1538, 0x14FA, 0x16BC, 0x177E,
+    0x3840, 0x3982, 0x3BC4, 0x3A06, 0x3F48, 0x3E8A, 0x3CCC, 0x3D0E,
+    0x3650, 0x3792, 0x35D4, 0x3416, 0x3158, 0x309A, 0x32DC, 0x331E,
+    0x2460, 0x25A2, 0x27E4, 0x2626, 0x2368, 0x22AA, 0x20EC, 0x212E,
+    0x2A70, 0x2BB2, 0x29F4, 0x2836, 0x2D78, 0x2CBA, 0x2EFC, 0x2F3E,
+    0x7080, 0x7142, 0x7304, 0x72C6, 0x7788, 0x764A, 0x740C, 0x75CE,
+    0x7E90, 0x7F52, 0x7D14, 0x7CD6, 0x7998, 0x785A, 0x7A1C, 0x7BDE,
+    0x6CA0, 0x6D62, 0x6F24, 0x6EE6, 0x6BA8, 0x6A6A, 0x682C, 0x69EE,
+    0x62B0, 0x6372, 0x6134, 0x60F6, 0x65B8, 0x647A, 0x663C, 0x67FE,
+    0x48C0, 0x4902, 0x4B44, 0x4A86, 0x4FC8, 0x4E0A, 0x4C4C, 0x4D8E,
+    0x46D0, 0x4712, 0x4554, 0x4496, 0x41D8, 0x401A, 0x425C, 0x439E,
+    0x54E0, 0x5522, 0x5764, 0x56A6, 0x53E8, 0x522A, 0x506C, 0x51AE,
+    0x5AF0, 0x5B32, 0x5974, 0x58B6, 0x5DF8, 0x5C3A, 0x5E7C, 0x5FBE,
+    0xE100, 0xE0C2, 0xE284, 0xE346, 0xE608, 0xE7CA, 0xE58C, 0xE44E,
+    0xEF10, 0xEED2, 0xEC94, 0xED56, 0xE818, 0xE9DA, 0xEB9C, 0xEA5E,
+    0xFD20, 0xFCE2, 0xFEA4, 0xFF66, 0xFA28, 0xFBEA, 0xF9AC, 0xF86E,
+    0xF330, 0xF2F2, 0xF0B4, 0xF176, 0xF438, 0xF5FA, 0xF7BC, 0xF67E,
+    0xD940, 0xD882, 0xDAC4, 0xDB06, 0xDE48, 0xDF8A, 0xDDCC, 0xDC0E,
+    0xD750, 0xD692, 0xD4D4, 0xD516, 0xD058, 0xD19A, 0xD3DC, 0xD21E,
+    0xC560, 0xC4A2, 0xC6E4, 0xC726, 0xC268, 0xC3AA, 0xC1EC, 0xC02E,
+    0xCB70, 0xCAB2, 0xC8F4, 0xC936, 0xCC78, 0xCDBA, 0xCFFC, 0xCE3E,
+    0x9180, 0x9042, 0x9204, 0x93C6, 0x9688, 0x974A, 0x950C, 0x94CE,
+    0x9F90, 0x9E52, 0x9C14, 0x9DD6, 0x9898, 0x995A, 0x9B1C, 0x9ADE,
+    0x8DA0, 0x8C62, 0x8E24, 0x8FE6, 0x8AA8, 0x8B6A, 0x892C, 0x88EE,
+    0x83B0, 0x8272, 0x8034, 0x81F6, 0x84B8, 0x857A, 0x873C, 0x86FE,
+    0xA9C0, 0xA802, 0xAA44, 0xAB86, 0xAEC8, 0xAF0A, 0xAD4C, 0xAC8E,
+    0xA7D0, 0xA612, 0xA454, 0xA596, 0xA0D8, 0xA11A, 0xA35C, 0xA29E,
+    0xB5E0, 0xB422, 0xB664, 0xB7A6, 0xB2E8, 0xB32A, 0xB16C, 0xB0AE,
+    0xBBF0, 0xBA32, 0xB874, 0xB9B6, 0xBCF8, 0xBD3A, 0xBF7C, 0xBEBE
+};
+#else
+static const USHORT _nx_crypto_gcm_reduction[16] =
+{
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+#endif
+
+/* Load and store a big endian word of a block.  */
+#define NX_CRYPTO_GCM_LOAD_WORD(p)        (((UINT)(p)[0] << 24) | ((UINT)(p)[1] << 16) | \
+                                           ((UINT)(p)[2] << 8) | (UINT)(p)[3])
+#define NX_CRYPTO_GCM_STORE_WORD(p, v)    do {                                        \
+                                               (p)[0] = (UCHAR)((v) >> 24);            \
+                                               (p)[1] = (UCHAR)((v) >> 16);            \
+                                               (p)[2] = (UCHAR)((v) >> 8);             \
+                                               (p)[3] = (UCHAR)(v);                    \
+                                           } while (0)
+
+/* Z = Z * x^NX_CRYPTO_GCM_TABLE_BITS xor the product of the hash key by index, on the
+   words z0 (most significant) to z3 of _nx_crypto_gcm_multi.  */
+#define NX_CRYPTO_GCM_MULTI_STEP(index)                                                        \
+    rem = z3 & (NX_CRYPTO_GCM_TABLE_SIZE - 1);                                                 \
+    z3 = (z3 >> NX_CRYPTO_GCM_TABLE_BITS) | (z2 << (32 - NX_CRYPTO_GCM_TABLE_BITS));           \
+    z2 = (z2 >> NX_CRYPTO_GCM_TABLE_BITS) | (z1 << (32 - NX_CRYPTO_GCM_TABLE_BITS));           \
+    z1 = (z1 >> NX_CRYPTO_GCM_TABLE_BITS) | (z0 << (32 - NX_CRYPTO_GCM_TABLE_BITS));           \
+    z0 = (z0 >> NX_CRYPTO_GCM_TABLE_BITS) ^ ((UINT)_nx_crypto_gcm_reduction[rem] << 16);       \
+    entry = htable[(index)];                                                                   \
+    z0 ^= entry[0];                                                                            \
+    z1 ^= entry[1];                                                                            \
+    z2 ^= entry[2];                                                                            \
+    z3 ^= entry[3];
 
 
 /**************************************************************************/
@@ -53,8 +127,6 @@
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
-/*    _nx_crypto_gcm_multi                  Compute multilication in GF   */
-/*    _nx_crypto_gcm_ghash_update           Compute GHASH                 */
 /*    _nx_crypto_gcm_gctr                   Perform GCTR operation        */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
@@ -169,13 +241,16 @@ USHORT result;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function performs multiplication in GF(2^128).                 */
+/*    This function performs multiplication in GF(2^128) of a block by    */
+/*    the hash key, NX_CRYPTO_GCM_TABLE_BITS bits of the block at a time  */
+/*    with the table of products made by _nx_crypto_gcm_key_set.          */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    x                                     Pointer to X block            */
-/*    y                                     Pointer to Y block            */
-/*    output                                Pointer to result block       */
+/*    gcm_metadata                          Pointer to GCM metadata       */
+/*    x                                     Pointer to X block in big     */
+/*                                            endian words, replaced by   */
+/*                                            the result                  */
 /*                                                                        */
 /*  OUTPUT                                                                */
 /*                                                                        */
@@ -183,7 +258,7 @@ USHORT result;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_crypto_gcm_xor                    Perform XOR operation         */
+/*    None                                                                */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -199,51 +274,32 @@ USHORT result;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_multi(UCHAR *x, UCHAR *y, UCHAR *output)
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_multi(NX_CRYPTO_GCM *gcm_metadata, UINT *x)
 {
-UINT i;
-INT j;
-UCHAR v[NX_CRYPTO_GCM_BLOCK_SIZE];
-UCHAR lsb;
-UCHAR mask;
-
-    NX_CRYPTO_MEMSET(output, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-    NX_CRYPTO_MEMCPY(v, y, NX_CRYPTO_GCM_BLOCK_SIZE); /* Use case of memcpy is verified. */
-
-    mask = 0x80;
-    for (i = 0; i < NX_CRYPTO_GCM_BLOCK_SIZE_BITS; i++)
+UINT (*htable)[NX_CRYPTO_GCM_BLOCK_SIZE_INT] = gcm_metadata -> nx_crypto_gcm_htable;
+UINT *entry;
+UINT z0 = 0, z1 = 0, z2 = 0, z3 = 0;
+UINT rem;
+UINT byte;
+INT i;
+
+    /* Horner evaluation from the last byte of x, whose bits have the highest degrees. */
+    for (i = NX_CRYPTO_GCM_BLOCK_SIZE - 1; i >= 0; i--)
     {
+        byte = (x[i >> 2] >> ((3 - (i & 3)) << 3)) & 0xFF;
 
-        /* output = output xor v when the ith bit of x is set. */
-        if (*x & mask)
-        {
-            _nx_crypto_gcm_xor(output, v, output);
-        }
-
-        /* Store the LSB before shift right. */
-        j = NX_CRYPTO_GCM_BLOCK_SIZE - 1;
-        lsb = v[j];
-
-        /* v = v >> 1 */
-        for (; j > 0; j--)
-        {
-            v[j] = (UCHAR)((v[j] >> 1) | (v[j - 1] << 7));
-        }
-        v[0] = v[0] >> 1;
-
-        /* v = v xor R when LSB of v is set. */
-        if (lsb & 1)
-        {
-            v[0] = v[0] ^ 0xe1;
-        }
-
-        mask = mask >> 1;
-        if (!mask)
-        {
-            mask = 0x80;
-            x++;
-        }
+#if (NX_CRYPTO_GCM_TABLE_BITS == 8)
+        NX_CRYPTO_GCM_MULTI_STEP(byte)
+#else
+        NX_CRYPTO_GCM_MULTI_STEP(byte & 0xF)
+        NX_CRYPTO_GCM_MULTI_STEP(byte >> 4)
+#endif
     }
+
+    x[0] = z0;
+    x[1] = z1;
+    x[2] = z2;
+    x[3] = z3;
 }
 
 /**************************************************************************/
@@ -263,7 +319,7 @@ UCHAR mask;
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
-/*    hkey                                  Pointer to hash key           */
+/*    gcm_metadata                          Pointer to GCM metadata       */
 /*    input                                 Pointer to bytes of input     */
 /*    input_length                          Length of bytes of input      */
 /*    output                                Pointer to updated hash       */
@@ -274,7 +330,6 @@ UCHAR mask;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_crypto_gcm_xor                    Perform XOR operation         */
 /*    _nx_crypto_gcm_multi                  Perform multiplication in GF  */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -291,18 +346,28 @@ UCHAR mask;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_ghash_update(UCHAR *hkey, UCHAR *input, UINT input_length, UCHAR *output)
+NX_CRYPTO_KEEP static VOID _nx_crypto_gcm_ghash_update(NX_CRYPTO_GCM *gcm_metadata, UCHAR *input, UINT input_length, UCHAR *output)
 {
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
+UINT x[NX_CRYPTO_GCM_BLOCK_SIZE_INT];
 UINT i, n;
 
+    /* The hash is kept in words for all the blocks of input. */
+    x[0] = NX_CRYPTO_GCM_LOAD_WORD(&output[0]);
+    x[1] = NX_CRYPTO_GCM_LOAD_WORD(&output[4]);
+    x[2] = NX_CRYPTO_GCM_LOAD_WORD(&output[8]);
+    x[3] = NX_CRYPTO_GCM_LOAD_WORD(&output[12]);
+
     n = input_length >> NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
     for (i = 0; i < n; i++)
     {
 
         /* output = (output xor input) multi hkey */
-        _nx_crypto_gcm_xor(output, input, tmp_block);
-        _nx_crypto_gcm_multi(tmp_block, hkey, output);
+        x[0] ^= NX_CRYPTO_GCM_LOAD_WORD(&input[0]);
+        x[1] ^= NX_CRYPTO_GCM_LOAD_WORD(&input[4]);
+        x[2] ^= NX_CRYPTO_GCM_LOAD_WORD(&input[8]);
+        x[3] ^= NX_CRYPTO_GCM_LOAD_WORD(&input[12]);
+        _nx_crypto_gcm_multi(gcm_metadata, x);
         input += NX_CRYPTO_GCM_BLOCK_SIZE;
     }
 
@@ -314,9 +379,17 @@ UINT i, n;
             multiple of the block size. */
         NX_CRYPTO_MEMCPY(tmp_block, input, input_length); /* Use case of memcpy is verified. */
         NX_CRYPTO_MEMSET(&tmp_block[input_length], 0, sizeof(tmp_block) - input_length);
-        _nx_crypto_gcm_xor(output, tmp_block, tmp_block);
-        _nx_crypto_gcm_multi(tmp_block, hkey, output);
+        x[0] ^= NX_CRYPTO_GCM_LOAD_WORD(&tmp_block[0]);
+        x[1] ^= NX_CRYPTO_GCM_LOAD_WORD(&tmp_block[4]);
+        x[2] ^= NX_CRYPTO_GCM_LOAD_WORD(&tmp_block[8]);
+        x[3] ^= NX_CRYPTO_GCM_LOAD_WORD(&tmp_block[12]);
+        _nx_crypto_gcm_multi(gcm_metadata, x);
     }
+
+    NX_CRYPTO_GCM_STORE_WORD(&output[0], x[0]);
+    NX_CRYPTO_GCM_STORE_WORD(&output[4], x[1]);
+    NX_CRYPTO_GCM_STORE_WORD(&output[8], x[2]);
+    NX_CRYPTO_GCM_STORE_WORD(&output[12], x[3]);
 }
 
 /**************************************************************************/
@@ -351,6 +424,10 @@ UINT i, n;
 /*                                                                        */
 /*    _nx_crypto_gcm_xor                    Perform XOR operation         */
 /*    _nx_crypto_gcm_inc32                  Increase the counter by one   */
+/*    _nx_crypto_aes_ctr_encrypt_blocks     Encrypt blocks in counter mode*/
+/*    _nx_crypto_stm32_aes_ctr_encrypt_blocks                             */
+/*                                          Encrypt blocks in the CRYP    */
+/*                                            peripheral                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -375,6 +452,32 @@ UINT i, n;
 
     n = length >> NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
 
+    if ((n > 0) && (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_aes_encrypt))
+    {
+
+        /* Software AES: process all the full blocks in one call rather than one call per block.  */
+        _nx_crypto_aes_ctr_encrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, counter_block, input, output, n);
+
+        input += n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        output += n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        length -= n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        n = 0;
+    }
+#ifdef NX_CRYPTO_STM32_HW
+    else if ((n > 0) &&
+             (crypto_function == (UINT (*)(VOID *, UCHAR *, UCHAR *, UINT))_nx_crypto_stm32_aes_encrypt))
+    {
+
+        /* CRYP peripheral: the same counter, incremented in its last 32 bits, in one call.  */
+        _nx_crypto_stm32_aes_ctr_encrypt_blocks((NX_CRYPTO_AES *)crypto_metadata, counter_block, input, output, n);
+
+        input += n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        output += n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        length -= n << NX_CRYPTO_GCM_BLOCK_SIZE_SHIFT;
+        n = 0;
+    }
+#endif /* NX_CRYPTO_STM32_HW */
+
     for (i = 0; i < n; i++)
     {
 
@@ -404,6 +507,90 @@ UINT i, n;
 
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_gcm_key_set                              PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the hash key of the current cipher key and   */
+/*    the table of its products used by GHASH. It is called once when the */
+/*    key is set, the hash key is then the same for all the messages.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crypto_metadata                       Pointer to crypto metadata    */
+/*    gcm_metadata                          Pointer to GCM metadata       */
+/*    crypto_function                       Pointer to crypto function    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_gcm_encrypt_init           Initialize GCM mode           */
+/*    _nx_crypto_method_aes_init            Initialize AES crypto module  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_gcm_key_set(VOID *crypto_metadata, NX_CRYPTO_GCM *gcm_metadata,
+                                           UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT))
+{
+UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
+UINT (*htable)[NX_CRYPTO_GCM_BLOCK_SIZE_INT] = gcm_metadata -> nx_crypto_gcm_htable;
+UINT reduction;
+UINT status;
+UINT i, j;
+
+    /* Generate hash key by encrypt the zero block. */
+    NX_CRYPTO_MEMSET(hkey, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
+    status = crypto_function(crypto_metadata, hkey, hkey, NX_CRYPTO_GCM_BLOCK_SIZE);
+    if (status)
+    {
+        return(status);
+    }
+
+    /* The bits of the index are coefficients in the same order as in a block, so the
+       entry of the most significant bit is the hash key and the entry of each lower
+       bit is the previous one multiplied by x.  */
+    i = NX_CRYPTO_GCM_TABLE_SIZE >> 1;
+    htable[i][0] = NX_CRYPTO_GCM_LOAD_WORD(&hkey[0]);
+    htable[i][1] = NX_CRYPTO_GCM_LOAD_WORD(&hkey[4]);
+    htable[i][2] = NX_CRYPTO_GCM_LOAD_WORD(&hkey[8]);
+    htable[i][3] = NX_CRYPTO_GCM_LOAD_WORD(&hkey[12]);
+    for (; i > 1; i >>= 1)
+    {
+        reduction = (htable[i][3] & 1) ? 0xE1000000 : 0;
+        htable[i >> 1][3] = (htable[i][3] >> 1) | (htable[i][2] << 31);
+        htable[i >> 1][2] = (htable[i][2] >> 1) | (htable[i][1] << 31);
+        htable[i >> 1][1] = (htable[i][1] >> 1) | (htable[i][0] << 31);
+        htable[i >> 1][0] = (htable[i][0] >> 1) ^ reduction;
+    }
+
+    /* The other entries are sums of these. */
+    NX_CRYPTO_MEMSET(htable[0], 0, sizeof(htable[0]));
+    for (i = 2; i < NX_CRYPTO_GCM_TABLE_SIZE; i <<= 1)
+    {
+        for (j = 1; j < i; j++)
+        {
+            htable[i + j][0] = htable[i][0] ^ htable[j][0];
+            htable[i + j][1] = htable[i][1] ^ htable[j][1];
+            htable[i + j][2] = htable[i][2] ^ htable[j][2];
+            htable[i + j][3] = htable[i][3] ^ htable[j][3];
+        }
+    }
+
+    gcm_metadata -> nx_crypto_gcm_hkey_ready = 1;
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -438,6 +625,7 @@ UINT i, n;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_crypto_gcm_key_set                Compute the hash key table    */
 /*    _nx_crypto_gcm_ghash_update           Update GHASH                  */
 /*    _nx_crypto_gcm_inc32                  Increase the counter by one   */
 /*                                                                        */
@@ -460,12 +648,12 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_init(VOID *crypto_metadata, NX_CRYPTO
                                                 VOID *additional_data, UINT additional_len,
                                                 UCHAR *iv, UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *j0 = gcm_metadata -> nx_crypto_gcm_j0;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
 UCHAR iv_len;
+UINT status;
 
     /* Check the block size.  */
     if (block_size != NX_CRYPTO_GCM_BLOCK_SIZE)
@@ -473,9 +661,15 @@ UCHAR iv_len;
         return(NX_CRYPTO_PTR_ERROR);
     }
 
-    /* Generate hash key by encrypt the zero block. */
-    NX_CRYPTO_MEMSET(hkey, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-    crypto_function(crypto_metadata, hkey, hkey, NX_CRYPTO_GCM_BLOCK_SIZE);
+    /* The hash key and its table are computed once for each key. */
+    if (!gcm_metadata -> nx_crypto_gcm_hkey_ready)
+    {
+        status = _nx_crypto_gcm_key_set(crypto_metadata, gcm_metadata, crypto_function);
+        if (status)
+        {
+            return(status);
+        }
+    }
 
     /* Generate the pre-counter block j0. */
     iv_len = iv[0];
@@ -496,18 +690,18 @@ UCHAR iv_len;
 
         /* When the length of IV is not 12 then apply GHASH to the IV. */
         NX_CRYPTO_MEMSET(j0, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-        _nx_crypto_gcm_ghash_update(hkey, iv, iv_len, j0);
+        _nx_crypto_gcm_ghash_update(gcm_metadata, iv, iv_len, j0);
 
         /* Apply GHASH to the length of IV to form j0.*/
         NX_CRYPTO_MEMSET(tmp_block, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
         tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE - 2] = (UCHAR)(((iv_len << 3) & 0xFF00) >> 8);
         tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE - 1] = (UCHAR)((iv_len << 3) & 0x00FF);
-        _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, j0);
+        _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, j0);
     }
 
     /* Apply GHASH to the additional authenticated data. */
     NX_CRYPTO_MEMSET(s, 0, NX_CRYPTO_GCM_BLOCK_SIZE);
-    _nx_crypto_gcm_ghash_update(hkey, additional_data, additional_len, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, additional_data, additional_len, s);
 
     /* Initial counter block for GCTR is j0 + 1. */
     NX_CRYPTO_MEMCPY(counter, j0, NX_CRYPTO_GCM_BLOCK_SIZE); /* Use case of memcpy is verified. */
@@ -574,7 +768,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_update(VOID *crypto_metadata, NX_CRYP
                                                   UCHAR *input, UCHAR *output, UINT length,
                                                   UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
 
@@ -588,7 +781,7 @@ UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
     _nx_crypto_gcm_gctr(crypto_metadata, crypto_function, input, output, length, counter);
 
     /* Apply GHASH to the cipher text. */
-    _nx_crypto_gcm_ghash_update(hkey, output, length, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, output, length, s);
 
     gcm_metadata -> nx_crypto_gcm_input_total_length += length;
 
@@ -645,7 +838,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_encrypt_calculate(VOID *crypto_metadata, NX_C
                                                      UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT),
                                                      UCHAR *output, UINT icv_len, UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *j0 = gcm_metadata -> nx_crypto_gcm_j0;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
@@ -676,7 +868,7 @@ UINT length;
     tmp_block[13] = (UCHAR)(((length << 3) & 0x00FF0000) >> 16);
     tmp_block[14] = (UCHAR)(((length << 3) & 0x0000FF00) >> 8);
     tmp_block[15] = (UCHAR)((length << 3) & 0x000000FF);
-    _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
 
     /* Encrypt the GHASH result using GCTR with j0 as initial counter block.
         The result is the authentication tag. */
@@ -743,7 +935,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_decrypt_update(VOID *crypto_metadata, NX_CRYP
                                                   UCHAR *input, UCHAR *output, UINT length,
                                                   UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
 
@@ -754,7 +945,7 @@ UCHAR *counter = gcm_metadata -> nx_crypto_gcm_counter;
     }
 
     /* Apply GHASH to the cipher text. */
-    _nx_crypto_gcm_ghash_update(hkey, input, length, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, input, length, s);
 
     /* Invoke GCTR function to encrypt or decrypt the input message. */
     _nx_crypto_gcm_gctr(crypto_metadata, crypto_function, input, output, length, counter);
@@ -813,7 +1004,6 @@ NX_CRYPTO_KEEP UINT _nx_crypto_gcm_decrypt_calculate(VOID *crypto_metadata, NX_C
                                                      UINT (*crypto_function)(VOID *, UCHAR *, UCHAR *, UINT),
                                                      UCHAR *input, UINT icv_len, UINT block_size)
 {
-UCHAR *hkey = gcm_metadata -> nx_crypto_gcm_hkey;
 UCHAR *j0 = gcm_metadata -> nx_crypto_gcm_j0;
 UCHAR *s = gcm_metadata -> nx_crypto_gcm_s;
 UCHAR tmp_block[NX_CRYPTO_GCM_BLOCK_SIZE];
@@ -845,7 +1035,7 @@ UINT i;
     tmp_block[13] = (UCHAR)(((length << 3) & 0x00FF0000) >> 16);
     tmp_block[14] = (UCHAR)(((length << 3) & 0x0000FF00) >> 8);
     tmp_block[15] = (UCHAR)((length << 3) & 0x000000FF);
-    _nx_crypto_gcm_ghash_update(hkey, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
+    _nx_crypto_gcm_ghash_update(gcm_metadata, tmp_block, NX_CRYPTO_GCM_BLOCK_SIZE, s);
 
 #ifdef NX_SECURE_KEY_CLEAR
     NX_CRYPTO_MEMSET(tmp_block, 0, sizeof(tmp_block));
@@ -22,6 +22,7 @@
 
 #ifndef NX_CRYPTO_STANDALONE_ENABLE
 #include "nx_secure_tls.h"
+#include "nx_crypto_ec.h"
 
 
 /**************************************************************************/
@@ -71,6 +72,21 @@
 
 /* Define cryptographic methods for use with TLS. */
 
+#ifdef NX_CRYPTO_STM32_HW
+/* The methods over the CRYP and HASH peripherals take the place of the software ones in the
+   tables below, each running in software when its peripheral is not available to the caller.
+   The generic HMAC of the TLS 1.3 key schedule hashes in the peripheral through them too.  */
+#define crypto_method_aes_cbc_128    crypto_method_aes_cbc_128_stm32
+#define crypto_method_aes_cbc_256    crypto_method_aes_cbc_256_stm32
+#define crypto_method_aes_128_gcm_16 crypto_method_aes_128_gcm_16_stm32
+#define crypto_method_aes_256_gcm_16 crypto_method_aes_256_gcm_16_stm32
+#define crypto_method_hmac_sha1      crypto_method_hmac_sha1_stm32
+#define crypto_method_hmac_sha256    crypto_method_hmac_sha256_stm32
+#define crypto_method_sha1           crypto_method_sha1_stm32
+#define crypto_method_sha224         crypto_method_sha224_stm32
+#define crypto_method_sha256         crypto_method_sha256_stm32
+#endif /* NX_CRYPTO_STM32_HW */
+
 extern NX_CRYPTO_METHOD crypto_method_none;
 extern NX_CRYPTO_METHOD crypto_method_null;
 extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
@@ -79,6 +95,7 @@ extern NX_CRYPTO_METHOD crypto_method_aes_ccm_8;
 extern NX_CRYPTO_METHOD crypto_method_aes_ccm_16;
 extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
 extern NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_chacha20_poly1305;
 extern NX_CRYPTO_METHOD crypto_method_ecdsa;
 extern NX_CRYPTO_METHOD crypto_method_ecdhe;
 extern NX_CRYPTO_METHOD crypto_method_hmac_sha1;
@@ -90,6 +107,9 @@ extern NX_CRYPTO_METHOD crypto_method_auth_psk;
 extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
 extern NX_CRYPTO_METHOD crypto_method_ec_secp384;
 extern NX_CRYPTO_METHOD crypto_method_ec_secp521;
+#ifdef NX_CRYPTO_ENABLE_X25519
+extern NX_CRYPTO_METHOD crypto_method_ec_x25519;
+#endif /* NX_CRYPTO_ENABLE_X25519 */
 extern NX_CRYPTO_METHOD crypto_method_md5;
 extern NX_CRYPTO_METHOD crypto_method_sha1;
 extern NX_CRYPTO_METHOD crypto_method_sha224;
@@ -105,10 +125,59 @@ extern NX_CRYPTO_METHOD crypto_method_hkdf;
 extern NX_CRYPTO_METHOD crypto_method_hmac;
 
 
+#ifdef NX_SECURE_TLS_CIPHERSUITE_LIST
+/* Entries of the ciphersuites NX_SECURE_TLS_CIPHERSUITE_LIST may name, in the column order of the
+   tables below. The application defines NX_SECURE_TLS_CIPHERSUITE_LIST(ENTRY) as the sequence
+   ENTRY(<ciphersuite>) ENTRY(<ciphersuite>) ..., top priority first, and the table with ECC then
+   holds those ciphersuites only. Without NX_SECURE_ENABLE_ECC_CIPHERSUITE, the table without ECC
+   holds them instead, and the list names no ECDHE ciphersuite. The linker drops the methods no
+   table refers to, the ClientHello offers fewer ciphersuites and the metadata is only sized for
+   the listed ones. */
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256 \
+    {TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_chacha20_poly1305, 16, 32, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256 \
+    {TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, &crypto_method_ecdhe, &crypto_method_rsa, &crypto_method_chacha20_poly1305, 16, 32, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256 \
+    {TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_aes_128_gcm_16, 16, 16, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256 \
+    {TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256, &crypto_method_ecdhe, &crypto_method_rsa, &crypto_method_aes_128_gcm_16, 16, 16, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256 \
+    {TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_aes_cbc_128, 16, 16, &crypto_method_hmac_sha256, 32, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256 \
+    {TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256, &crypto_method_ecdhe, &crypto_method_rsa, &crypto_method_aes_cbc_128, 16, 16, &crypto_method_hmac_sha256, 32, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_RSA_WITH_AES_128_GCM_SHA256 \
+    {TLS_RSA_WITH_AES_128_GCM_SHA256, &crypto_method_rsa, &crypto_method_rsa, &crypto_method_aes_128_gcm_16, 16, 16, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_RSA_WITH_AES_256_CBC_SHA256 \
+    {TLS_RSA_WITH_AES_256_CBC_SHA256, &crypto_method_rsa, &crypto_method_rsa, &crypto_method_aes_cbc_256, 16, 32, &crypto_method_hmac_sha256, 32, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_RSA_WITH_AES_128_CBC_SHA256 \
+    {TLS_RSA_WITH_AES_128_CBC_SHA256, &crypto_method_rsa, &crypto_method_rsa, &crypto_method_aes_cbc_128, 16, 16, &crypto_method_hmac_sha256, 32, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_PSK_WITH_AES_128_CBC_SHA256 \
+    {TLS_PSK_WITH_AES_128_CBC_SHA256, &crypto_method_null, &crypto_method_auth_psk, &crypto_method_aes_cbc_128, 16, 16, &crypto_method_hmac_sha256, 32, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_PSK_WITH_AES_128_CCM_8 \
+    {TLS_PSK_WITH_AES_128_CCM_8, &crypto_method_null, &crypto_method_auth_psk, &crypto_method_aes_ccm_8, 16, 16, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_PSK_WITH_CHACHA20_POLY1305_SHA256 \
+    {TLS_PSK_WITH_CHACHA20_POLY1305_SHA256, &crypto_method_null, &crypto_method_auth_psk, &crypto_method_chacha20_poly1305, 16, 32, &crypto_method_null, 0, &crypto_method_tls_prf_sha256}
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_CHACHA20_POLY1305_SHA256 \
+    {TLS_CHACHA20_POLY1305_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_chacha20_poly1305, 96, 32, &crypto_method_sha256, 32, &crypto_method_hkdf}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_AES_128_GCM_SHA256 \
+    {TLS_AES_128_GCM_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_aes_128_gcm_16, 96, 16, &crypto_method_sha256, 32, &crypto_method_hkdf}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_AES_128_CCM_SHA256 \
+    {TLS_AES_128_CCM_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_aes_ccm_16, 96, 16, &crypto_method_sha256, 32, &crypto_method_hkdf}
+#define NX_CRYPTO_CIPHERSUITE_INFO_TLS_AES_128_CCM_8_SHA256 \
+    {TLS_AES_128_CCM_8_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa, &crypto_method_aes_ccm_8, 96, 16, &crypto_method_sha256, 32, &crypto_method_hkdf}
+#endif
+
+#define NX_CRYPTO_CIPHERSUITE_ENTRY(ciphersuite) NX_CRYPTO_CIPHERSUITE_INFO_##ciphersuite,
+#endif /* NX_SECURE_TLS_CIPHERSUITE_LIST */
+
 /* Ciphersuite table without ECC. */
 /* Lookup table used to map ciphersuites to cryptographic routines. */
 NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table[] =
 {
+#if defined(NX_SECURE_TLS_CIPHERSUITE_LIST) && !defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE)
+    NX_SECURE_TLS_CIPHERSUITE_LIST(NX_CRYPTO_CIPHERSUITE_ENTRY)
+#else
     /* Ciphersuite,                           public cipher,            public_auth,              session cipher & cipher mode,   iv size, key size,  hash method,                    hash size, TLS PRF */
 #ifdef NX_SECURE_ENABLE_AEAD_CIPHER
     {TLS_RSA_WITH_AES_128_GCM_SHA256,         &crypto_method_rsa,       &crypto_method_rsa,       &crypto_method_aes_128_gcm_16,  16,      16,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
@@ -120,12 +189,15 @@ NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table[] =
     {TLS_PSK_WITH_AES_128_CBC_SHA256,         &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_aes_cbc_128,     16,      16,        &crypto_method_hmac_sha256,     32,        &crypto_method_tls_prf_sha256},
 #ifdef NX_SECURE_ENABLE_AEAD_CIPHER
     {TLS_PSK_WITH_AES_128_CCM_8,              &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_aes_ccm_8,       16,      16,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
+    {TLS_PSK_WITH_CHACHA20_POLY1305_SHA256,   &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_chacha20_poly1305, 16,      32,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
 #endif
 #endif /* NX_SECURE_ENABLE_PSK_CIPHERSUITES */
+#endif /* NX_SECURE_TLS_CIPHERSUITE_LIST && !NX_SECURE_ENABLE_ECC_CIPHERSUITE */
 };
 
 const UINT _nx_crypto_ciphersuite_lookup_table_size = sizeof(_nx_crypto_ciphersuite_lookup_table) / sizeof(NX_SECURE_TLS_CIPHERSUITE_INFO);
 
+#ifndef NX_SECURE_DISABLE_X509
 /* Lookup table for X.509 digital certificates - they need a public-key algorithm and a hash routine for verification. */
 NX_SECURE_X509_CRYPTO _nx_crypto_x509_cipher_lookup_table[] =
 {
@@ -138,6 +210,7 @@ NX_SECURE_X509_CRYPTO _nx_crypto_x509_cipher_lookup_table[] =
 };
 
 const UINT _nx_crypto_x509_cipher_lookup_table_size = sizeof(_nx_crypto_x509_cipher_lookup_table) / sizeof(NX_SECURE_X509_CRYPTO);
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /* Define the object we can pass into TLS. */
 NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers =
@@ -174,6 +247,7 @@ NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers =
 
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
 
+#ifndef NX_SECURE_DISABLE_X509
 /* Lookup table for X.509 digital certificates - they need a public-key algorithm and a hash routine for verification. */
 NX_SECURE_X509_CRYPTO _nx_crypto_x509_cipher_lookup_table_ecc[] =
 {
@@ -191,12 +265,14 @@ NX_SECURE_X509_CRYPTO _nx_crypto_x509_cipher_lookup_table_ecc[] =
 };
 
 const UINT _nx_crypto_x509_cipher_lookup_table_ecc_size = sizeof(_nx_crypto_x509_cipher_lookup_table_ecc) / sizeof(NX_SECURE_X509_CRYPTO);
+#endif /* NX_SECURE_DISABLE_X509 */
 
 
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table_tls_1_3[] =
 {
 #ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+    {TLS_CHACHA20_POLY1305_SHA256,            &crypto_method_ecdhe,      &crypto_method_ecdsa,     &crypto_method_chacha20_poly1305, 96,      32,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
     {TLS_AES_128_GCM_SHA256,                  &crypto_method_ecdhe,      &crypto_method_ecdsa,     &crypto_method_aes_128_gcm_16,  96,      16,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
     /* SHA-384 ciphersuites not yet supported... {TLS_AES_256_GCM_SHA384,                  &crypto_method_ecdhe,      &crypto_method_rsa,     &crypto_method_aes_256_gcm_16,  16,      16,        &crypto_method_sha384,         48,         &crypto_method_hkdf},*/
     {TLS_AES_128_CCM_SHA256,                  &crypto_method_ecdhe,      &crypto_method_ecdsa,     &crypto_method_aes_ccm_16,       96,      16,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
@@ -212,14 +288,21 @@ const UINT _nx_crypto_ciphersuite_lookup_table_tls_1_3_size = sizeof(_nx_crypto_
 /* Ciphersuites are negotiated IN ORDER - top priority first. Ciphersuites lower in the list are considered less secure. */
 NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table_ecc[] =
 {
+#ifdef NX_SECURE_TLS_CIPHERSUITE_LIST
+    NX_SECURE_TLS_CIPHERSUITE_LIST(NX_CRYPTO_CIPHERSUITE_ENTRY)
+#else
     /* Ciphersuite,                           public cipher,            public_auth,              session cipher & cipher mode,   iv size, key size,  hash method,                    hash size, TLS PRF */
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+    {TLS_CHACHA20_POLY1305_SHA256,            &crypto_method_ecdhe,     &crypto_method_ecdsa,     &crypto_method_chacha20_poly1305, 96,      32,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
     {TLS_AES_128_GCM_SHA256,                  &crypto_method_ecdhe,     &crypto_method_ecdsa,     &crypto_method_aes_128_gcm_16,  96,      16,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
     {TLS_AES_128_CCM_SHA256,                  &crypto_method_ecdhe,     &crypto_method_ecdsa,     &crypto_method_aes_ccm_16,      96,      16,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
     {TLS_AES_128_CCM_8_SHA256,                &crypto_method_ecdhe,     &crypto_method_ecdsa,     &crypto_method_aes_ccm_8,       96,      16,        &crypto_method_sha256,         32,         &crypto_method_hkdf},
 #endif
 
 #ifdef NX_SECURE_ENABLE_AEAD_CIPHER
+    /* Without an AES accelerator, ChaCha20-Poly1305 is the fastest AEAD cipher in software. */
+    {TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, &crypto_method_ecdhe, &crypto_method_ecdsa,     &crypto_method_chacha20_poly1305, 16,      32,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
+    {TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, &crypto_method_ecdhe, &crypto_method_rsa,       &crypto_method_chacha20_poly1305, 16,      32,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
     {TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, &crypto_method_ecdhe,     &crypto_method_ecdsa,     &crypto_method_aes_128_gcm_16,  16,      16,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
     {TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,   &crypto_method_ecdhe,     &crypto_method_rsa,       &crypto_method_aes_128_gcm_16,  16,      16,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
 #endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
@@ -238,8 +321,10 @@ NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table_ecc[] =
     {TLS_PSK_WITH_AES_128_CBC_SHA256,         &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_aes_cbc_128,     16,      16,        &crypto_method_hmac_sha256,     32,        &crypto_method_tls_prf_sha256},
 #ifdef NX_SECURE_ENABLE_AEAD_CIPHER
     {TLS_PSK_WITH_AES_128_CCM_8,              &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_aes_ccm_8,       16,      16,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
+    {TLS_PSK_WITH_CHACHA20_POLY1305_SHA256,   &crypto_method_null,      &crypto_method_auth_psk,  &crypto_method_chacha20_poly1305, 16,      32,        &crypto_method_null,            0,         &crypto_method_tls_prf_sha256},
 #endif
 #endif /* NX_SECURE_ENABLE_PSK_CIPHERSUITES */
+#endif /* NX_SECURE_TLS_CIPHERSUITE_LIST */
 
 
 };
@@ -281,8 +366,13 @@ const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers_ecc =
 
 };
 
+/* The first group is the one of the TLS 1.3 key share of the ClientHello. X25519 comes first:
+   cheaper than secp256r1 and offered by most servers. */
 const USHORT nx_crypto_ecc_supported_groups[] =
 {
+#ifdef NX_CRYPTO_ENABLE_X25519
+    (USHORT)NX_CRYPTO_EC_X25519,
+#endif /* NX_CRYPTO_ENABLE_X25519 */
     (USHORT)NX_CRYPTO_EC_SECP256R1,
     (USHORT)NX_CRYPTO_EC_SECP384R1,
     (USHORT)NX_CRYPTO_EC_SECP521R1,
@@ -290,6 +380,9 @@ const USHORT nx_crypto_ecc_supported_groups[] =
 
 const NX_CRYPTO_METHOD *nx_crypto_ecc_curves[] =
 {
+#ifdef NX_CRYPTO_ENABLE_X25519
+    &crypto_method_ec_x25519,
+#endif /* NX_CRYPTO_ENABLE_X25519 */
     &crypto_method_ec_secp256,
     &crypto_method_ec_secp384,
     &crypto_method_ec_secp521,
@@ -398,6 +491,44 @@ const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256 =
     (NX_SECURE_TLS_BITFIELD_VERSIONS_PRE_1_3 | NX_SECURE_DTLS_BITFIELD_VERSIONS_PRE_1_3)
 };
 
+const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_rsa_with_chacha20_poly1305_sha256 =
+/* TLS ciphersuite entry. */
+{   TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, /* Ciphersuite ID. */
+    NX_SECURE_APPLICATION_TLS,               /* Internal application label. */
+    32,                                      /* Symmetric key size. */
+    {   /* Cipher role array. */
+        {NX_CRYPTO_KEY_EXCHANGE_ECDHE,           NX_CRYPTO_ROLE_KEY_EXCHANGE},
+        {NX_CRYPTO_KEY_EXCHANGE_RSA,             NX_CRYPTO_ROLE_SIGNATURE_CRYPTO},
+        {NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305, NX_CRYPTO_ROLE_SYMMETRIC},
+        {NX_CRYPTO_NONE,                         NX_CRYPTO_ROLE_MAC_HASH},
+        {NX_CRYPTO_HASH_SHA256,                  NX_CRYPTO_ROLE_RAW_HASH},
+        {NX_CRYPTO_HASH_HMAC,                    NX_CRYPTO_ROLE_HMAC},
+        {NX_CRYPTO_PRF_HMAC_SHA2_256,            NX_CRYPTO_ROLE_PRF},
+        {NX_CRYPTO_NONE,                         NX_CRYPTO_ROLE_NONE}
+    },
+    /* TLS/DTLS Versions supported. */
+    (NX_SECURE_TLS_BITFIELD_VERSIONS_PRE_1_3 | NX_SECURE_DTLS_BITFIELD_VERSIONS_PRE_1_3)
+};
+
+const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_ecdhe_ecdsa_with_chacha20_poly1305_sha256 =
+/* TLS ciphersuite entry. */
+{   TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, /* Ciphersuite ID. */
+    NX_SECURE_APPLICATION_TLS,               /* Internal application label. */
+    32,                                      /* Symmetric key size. */
+    {   /* Cipher role array. */
+        {NX_CRYPTO_KEY_EXCHANGE_ECDHE,           NX_CRYPTO_ROLE_KEY_EXCHANGE},
+        {NX_CRYPTO_DIGITAL_SIGNATURE_ECDSA,      NX_CRYPTO_ROLE_SIGNATURE_CRYPTO},
+        {NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305, NX_CRYPTO_ROLE_SYMMETRIC},
+        {NX_CRYPTO_NONE,                         NX_CRYPTO_ROLE_MAC_HASH},
+        {NX_CRYPTO_HASH_SHA256,                  NX_CRYPTO_ROLE_RAW_HASH},
+        {NX_CRYPTO_HASH_HMAC,                    NX_CRYPTO_ROLE_HMAC},
+        {NX_CRYPTO_PRF_HMAC_SHA2_256,            NX_CRYPTO_ROLE_PRF},
+        {NX_CRYPTO_NONE,                         NX_CRYPTO_ROLE_NONE}
+    },
+    /* TLS/DTLS Versions supported. */
+    (NX_SECURE_TLS_BITFIELD_VERSIONS_PRE_1_3 | NX_SECURE_DTLS_BITFIELD_VERSIONS_PRE_1_3)
+};
+
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_aes_128_gcm_sha256 =
 /* TLS ciphersuite entry. */
@@ -416,6 +547,24 @@ const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_aes_128_gcm_sha256 =
     /* TLS/DTLS Versions supported. */
     (NX_SECURE_TLS_BITFIELD_VERSION_1_3 | NX_SECURE_DTLS_BITFIELD_VERSION_1_3)
 };
+
+const NX_CRYPTO_CIPHERSUITE nx_crypto_tls_chacha20_poly1305_sha256 =
+/* TLS ciphersuite entry. */
+{   TLS_CHACHA20_POLY1305_SHA256, /* Ciphersuite ID. */
+    NX_SECURE_APPLICATION_TLS,               /* Internal application label. */
+    32,                                      /* Symmetric key size. */
+    {   /* Cipher role array. */
+        {NX_CRYPTO_KEY_EXCHANGE_ECDHE,           NX_CRYPTO_ROLE_KEY_EXCHANGE},
+        {NX_CRYPTO_DIGITAL_SIGNATURE_ECDSA,      NX_CRYPTO_ROLE_SIGNATURE_CRYPTO},
+        {NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305, NX_CRYPTO_ROLE_SYMMETRIC},
+        {NX_CRYPTO_HASH_SHA256,                  NX_CRYPTO_ROLE_MAC_HASH},
+        {NX_CRYPTO_HASH_SHA256,                  NX_CRYPTO_ROLE_RAW_HASH},
+        {NX_CRYPTO_HKDF_METHOD,                  NX_CRYPTO_ROLE_PRF},
+        {NX_CRYPTO_NONE,                         NX_CRYPTO_ROLE_NONE}
+    },
+    /* TLS/DTLS Versions supported. */
+    (NX_SECURE_TLS_BITFIELD_VERSION_1_3 | NX_SECURE_DTLS_BITFIELD_VERSION_1_3)
+};
 #endif
 
 const NX_CRYPTO_CIPHERSUITE nx_crypto_x509_rsa_md5 =
@@ -584,6 +733,7 @@ const NX_CRYPTO_METHOD *supported_crypto[] =
     &crypto_method_aes_cbc_256,
     &crypto_method_aes_128_gcm_16,
     &crypto_method_aes_256_gcm_16,
+    &crypto_method_chacha20_poly1305,
     &crypto_method_hmac,
     &crypto_method_hmac_md5,
     &crypto_method_hmac_sha1,
@@ -600,6 +750,9 @@ const NX_CRYPTO_METHOD *supported_crypto[] =
     &crypto_method_ec_secp256,
     &crypto_method_ec_secp384,
     &crypto_method_ec_secp521,
+#ifdef NX_CRYPTO_ENABLE_X25519
+    &crypto_method_ec_x25519,
+#endif /* NX_CRYPTO_ENABLE_X25519 */
 };
 
 const UINT supported_crypto_size = sizeof(supported_crypto) / sizeof(NX_CRYPTO_METHOD*);
@@ -608,8 +761,11 @@ const NX_CRYPTO_CIPHERSUITE *ciphersuite_map[] =
 {
     /* TLS ciphersuites. */
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+    &nx_crypto_tls_chacha20_poly1305_sha256,
     &nx_crypto_tls_aes_128_gcm_sha256,
 #endif
+    &nx_crypto_tls_ecdhe_rsa_with_chacha20_poly1305_sha256,
+    &nx_crypto_tls_ecdhe_ecdsa_with_chacha20_poly1305_sha256,
     &nx_crypto_tls_ecdhe_rsa_with_aes_128_gcm_sha256,
     &nx_crypto_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256,
     &nx_crypto_tls_rsa_with_aes_128_cbc_sha256,
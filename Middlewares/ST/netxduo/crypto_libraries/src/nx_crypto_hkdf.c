@@ -108,6 +108,9 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_method_hkdf_init(struct  NX_CRYPTO_METHOD_STRUCT
     hkdf->nx_crypto_hmac_method = NX_CRYPTO_NULL;
     hkdf->nx_crypto_hash_method = NX_CRYPTO_NULL;
 
+    /* No keyed HMAC states until a PRK is expanded. */
+    hkdf->nx_crypto_hkdf_keyed_hash_method = NX_CRYPTO_NULL;
+
     return(NX_CRYPTO_SUCCESS);
 }
 
@@ -323,6 +326,9 @@ UINT                 status;
         NX_CRYPTO_MEMCPY(hkdf->nx_crypto_hkdf_prk, key, (key_size_in_bits >> 3)); /* Use case of memcpy is verified. */
         hkdf->nx_crypto_hkdf_prk_size = (key_size_in_bits >> 3);
 
+        /* The keyed HMAC states are those of the previous PRK. */
+        hkdf->nx_crypto_hkdf_keyed_hash_method = NX_CRYPTO_NULL;
+
         break;
     case NX_CRYPTO_HKDF_EXTRACT:
         if(key == NX_CRYPTO_NULL)
@@ -346,6 +352,9 @@ UINT                 status;
         /* Our output size is the output size of the hash. */
         hkdf->nx_crypto_hkdf_prk_size = hkdf->nx_crypto_hmac_method->nx_crypto_block_size_in_bytes;
 
+        /* The keyed HMAC states are those of the previous PRK. */
+        hkdf->nx_crypto_hkdf_keyed_hash_method = NX_CRYPTO_NULL;
+
         status = _nx_crypto_hkdf_extract(hkdf);
 
         if(status == NX_CRYPTO_SUCCESS)
@@ -543,7 +552,10 @@ NX_CRYPTO_METHOD *hmac_method = hkdf -> nx_crypto_hmac_method;
 /*                                                                        */
 /*    This function performs the HKDF-expand operation detailed in RFC    */
 /*    5869. The hdkf parameter contains the input key (PRK) and other     */
-/*    parameters needed to generate the desired output data.              */
+/*    parameters needed to generate the desired output data. The HMAC     */
+/*    states keyed with the PRK are computed once, and each block then    */
+/*    costs the two hashes of its data only, for this and the next        */
+/*    expansions of the same PRK.                                         */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -555,6 +567,8 @@ NX_CRYPTO_METHOD *hmac_method = hkdf -> nx_crypto_hmac_method;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_crypto_hkdf_keyed_init            Compute the keyed HMAC states */
+/*    _nx_crypto_hkdf_keyed_hmac            Calculate the keyed HMAC      */
 /*    [hash method]                         Perform selected HMAC hash    */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -659,8 +673,24 @@ NX_CRYPTO_METHOD *hmac_method = hkdf -> nx_crypto_hmac_method;
     NX_CRYPTO_MEMSET(temp_T, 0, temp_T_size);
     T_len = 0;
 
-    /* Get our L count for our loop. */
-    N_count = 1 + ((desired_length) / hash_size);
+    /* Get our L count for our loop, N = ceil(L/HashLen). */
+    N_count = (desired_length + hash_size - 1) / hash_size;
+
+    if (N_count > 255)
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    /* Key the HMAC states with the PRK, unless done by a previous expansion. */
+    if (hkdf -> nx_crypto_hkdf_keyed_hash_method != hkdf -> nx_crypto_hash_method)
+    {
+        status = _nx_crypto_hkdf_keyed_init(hkdf);
+
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
+    }
 
     /* Loop through T(i) to calculate output material (OKM).
      * NOTE: We start at 1 so the counter is correct. Add one
@@ -678,41 +708,49 @@ NX_CRYPTO_METHOD *hmac_method = hkdf -> nx_crypto_hmac_method;
         /* Concatenate counter octet. */
         temp_T[T_len + info_len] = (UCHAR)(i & 0xFF);
 
-        /* Initialize hash method. */
-        if (hmac_method -> nx_crypto_init)
+        /* The number of bytes we want to hash is a combination of T_len (0 or <hash size>)
+           the length of "info", and add 1 for the counter octet. */
+        T_bytes_to_hash = T_len + info_len + 1;
+
+        /* Calculate T(i) = HMAC(PRK, T(i-1) | info | i) from the keyed states if any. */
+        if (hkdf -> nx_crypto_hkdf_keyed_hash_method != NX_CRYPTO_NULL)
+        {
+            status = _nx_crypto_hkdf_keyed_hmac(hkdf, temp_T, T_bytes_to_hash, temp_T);
+        }
+        else
         {
-            status = hmac_method -> nx_crypto_init(hmac_method,
-                                                   prk,
-                                                   (NX_CRYPTO_KEY_SIZE)(prk_len << 3),
-                                                   &handler,
-                                                   metadata,
-                                                   metadata_size);
 
-            if (status != NX_CRYPTO_SUCCESS)
+            /* Initialize hash method. */
+            if (hmac_method -> nx_crypto_init)
             {
-                return(status);
+                status = hmac_method -> nx_crypto_init(hmac_method,
+                                                       prk,
+                                                       (NX_CRYPTO_KEY_SIZE)(prk_len << 3),
+                                                       &handler,
+                                                       metadata,
+                                                       metadata_size);
+
+                if (status != NX_CRYPTO_SUCCESS)
+                {
+                    return(status);
+                }
             }
-        }
-
-        /* The number of bytes we want to hash is a combination of T_len (0 or <hash size>)
-           the length of "info", and add 1 for the counter octet. */
-        T_bytes_to_hash = T_len + info_len + 1;
 
-        /* Calculate T(i) = HMAC(PRK, T(i-1) | info | i) */
-        status = hmac_method -> nx_crypto_operation(NX_CRYPTO_AUTHENTICATE,
-                                                    handler,
-                                                    hmac_method,
-                                                    prk,
-                                                    (NX_CRYPTO_KEY_SIZE)(prk_len << 3),
-                                                    temp_T,
-                                                    T_bytes_to_hash,
-                                                    NX_CRYPTO_NULL,
-                                                    temp_T,
-                                                    temp_T_size,
-                                                    metadata,
-                                                    metadata_size,
-                                                    NX_CRYPTO_NULL,
-                                                    NX_CRYPTO_NULL);
+            status = hmac_method -> nx_crypto_operation(NX_CRYPTO_AUTHENTICATE,
+                                                        handler,
+                                                        hmac_method,
+                                                        prk,
+                                                        (NX_CRYPTO_KEY_SIZE)(prk_len << 3),
+                                                        temp_T,
+                                                        T_bytes_to_hash,
+                                                        NX_CRYPTO_NULL,
+                                                        temp_T,
+                                                        temp_T_size,
+                                                        metadata,
+                                                        metadata_size,
+                                                        NX_CRYPTO_NULL,
+                                                        NX_CRYPTO_NULL);
+        }
 
         if (status != NX_CRYPTO_SUCCESS)
         {
@@ -753,5 +791,222 @@ NX_CRYPTO_METHOD *hmac_method = hkdf -> nx_crypto_hmac_method;
 }
 
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_hkdf_keyed_init                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the hash states of the HMAC keyed with the   */
+/*    PRK, past the PRK XORed with ipad and with opad, that HKDF-expand   */
+/*    restores for each block instead of keying the HMAC again. When the  */
+/*    states do not fit in the HKDF structure, or the PRK is longer than  */
+/*    the hash block, no state is kept and HKDF-expand runs the full      */
+/*    HMAC.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    hkdf                                  HKDF structure                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [hash method]                         Perform selected hash         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_hkdf_expand                Generate HKDF key material    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_hkdf_keyed_init(NX_CRYPTO_HKDF *hkdf)
+{
+UINT    i;
+UINT    j;
+UINT    block_size;
+UINT    metadata_size;
+UCHAR  *metadata;
+UCHAR  *keyed_metadata;
+UCHAR   pad[NX_CRYPTO_HMAC_MAX_PAD_SIZE];
+UINT    status = NX_CRYPTO_SUCCESS;
+NX_CRYPTO_METHOD *hash_method = hkdf -> nx_crypto_hash_method;
+
+    NX_CRYPTO_STATE_CHECK
+
+    hkdf -> nx_crypto_hkdf_keyed_hash_method = NX_CRYPTO_NULL;
+
+    block_size = hash_method -> nx_crypto_block_size_in_bytes;
+    metadata_size = hash_method -> nx_crypto_metadata_area_size;
+
+    /* Hash in the room of the hash metadata past the HMAC control block, the HMAC initializes it again on its next use. */
+    metadata = hkdf -> nx_crypto_hmac_metadata + sizeof(NX_CRYPTO_HMAC);
+
+    /* Keep the full HMAC for each block if the states do not fit. */
+    if ((hash_method -> nx_crypto_operation == NX_CRYPTO_NULL) ||
+        (metadata_size > sizeof(hkdf -> nx_crypto_hkdf_inner_metadata)) ||
+        (metadata_size > (sizeof(hkdf -> nx_crypto_hmac_metadata) - sizeof(NX_CRYPTO_HMAC))) ||
+        (block_size > sizeof(pad)) ||
+        (hkdf -> nx_crypto_hkdf_prk_size > block_size))
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    /* The inner state hashes the PRK XORed with ipad, the outer one with opad. */
+    for (j = 0; j < 2; j++)
+    {
+        NX_CRYPTO_MEMSET(pad, 0, block_size);
+        NX_CRYPTO_MEMCPY(pad, hkdf -> nx_crypto_hkdf_prk, hkdf -> nx_crypto_hkdf_prk_size); /* Use case of memcpy is verified. */
+
+        for (i = 0; i < block_size; i++)
+        {
+            pad[i] ^= (UCHAR)((j == 0) ? 0x36 : 0x5c);
+        }
 
+        if (hash_method -> nx_crypto_init)
+        {
+            status = hash_method -> nx_crypto_init(hash_method, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                   metadata, metadata_size);
 
+            if (status != NX_CRYPTO_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE, NX_CRYPTO_NULL, hash_method,
+                                                    NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                    NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            break;
+        }
+
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, NX_CRYPTO_NULL, hash_method,
+                                                    NX_CRYPTO_NULL, 0, pad, block_size, NX_CRYPTO_NULL,
+                                                    NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            break;
+        }
+
+        /* Save the state past the padded key. */
+        keyed_metadata = (j == 0) ? hkdf -> nx_crypto_hkdf_inner_metadata : hkdf -> nx_crypto_hkdf_outer_metadata;
+        NX_CRYPTO_MEMCPY(keyed_metadata, metadata, metadata_size); /* Use case of memcpy is verified. */
+    }
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(pad, 0, sizeof(pad));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        hkdf -> nx_crypto_hkdf_keyed_hash_method = hash_method;
+    }
+
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_hkdf_keyed_hmac                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates the HMAC of the input with the PRK, from   */
+/*    the keyed hash states computed by _nx_crypto_hkdf_keyed_init: the   */
+/*    inner state is restored and hashes the input, then the outer state  */
+/*    is restored and hashes the inner digest. The output may be the      */
+/*    input buffer.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    hkdf                                  HKDF structure                */
+/*    input                                 Input data                    */
+/*    input_length                          Length of input data          */
+/*    output                                HMAC output, hash size        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [hash method]                         Perform selected hash         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_hkdf_expand                Generate HKDF key material    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_crypto_hkdf_keyed_hmac(NX_CRYPTO_HKDF *hkdf, UCHAR *input, UINT input_length, UCHAR *output)
+{
+UINT    hash_size;
+UINT    metadata_size;
+UCHAR  *metadata;
+UCHAR   icv[64];
+UINT    status;
+NX_CRYPTO_METHOD *hash_method = hkdf -> nx_crypto_hkdf_keyed_hash_method;
+
+    NX_CRYPTO_STATE_CHECK
+
+    hash_size = hash_method -> nx_crypto_ICV_size_in_bits >> 3;
+    metadata_size = hash_method -> nx_crypto_metadata_area_size;
+    metadata = hkdf -> nx_crypto_hmac_metadata + sizeof(NX_CRYPTO_HMAC);
+
+    if (hash_size > sizeof(icv))
+    {
+        return(NX_CRYPTO_SIZE_ERROR);
+    }
+
+    /* Inner hash, of the input past the PRK XORed with ipad. */
+    NX_CRYPTO_MEMCPY(metadata, hkdf -> nx_crypto_hkdf_inner_metadata, metadata_size); /* Use case of memcpy is verified. */
+
+    status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, NX_CRYPTO_NULL, hash_method,
+                                                NX_CRYPTO_NULL, 0, input, input_length, NX_CRYPTO_NULL,
+                                                NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE, NX_CRYPTO_NULL, hash_method,
+                                                    NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                    icv, hash_size, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    /* Outer hash, of the inner digest past the PRK XORed with opad. */
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        NX_CRYPTO_MEMCPY(metadata, hkdf -> nx_crypto_hkdf_outer_metadata, metadata_size); /* Use case of memcpy is verified. */
+
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, NX_CRYPTO_NULL, hash_method,
+                                                    NX_CRYPTO_NULL, 0, icv, hash_size, NX_CRYPTO_NULL,
+                                                    NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE, NX_CRYPTO_NULL, hash_method,
+                                                    NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                    output, hash_size, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(icv, 0, sizeof(icv));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    return(status);
+}
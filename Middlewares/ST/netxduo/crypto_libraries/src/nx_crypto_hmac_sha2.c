@@ -25,6 +25,219 @@
 #include "nx_crypto_hmac.h"
 
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_hmac_sha256_initialize                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts an HMAC SHA256 calculation with the key. The   */
+/*    SHA256 states after the key XOR ipad and key XOR opad blocks only   */
+/*    depend on the key, so they are kept in the key cache of the         */
+/*    metadata and recomputed only for a key not found there. Keys longer */
+/*    than a block are not cached.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   Pointer to HMAC SHA256 context*/
+/*    algorithm                             HMAC SHA224 or HMAC SHA256    */
+/*    key_ptr                               Pointer to key                */
+/*    key_length                            Length of key in bytes        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_hmac_initialize            Perform HMAC initialization   */
+/*    _nx_crypto_sha256_initialize          Initialize the SHA256 context */
+/*    _nx_crypto_sha256_update              Update the SHA256 digest      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_hmac_sha256_operation                             */
+/*                                          Handle HMAC SHA256 operation  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_hmac_sha256_initialize(NX_CRYPTO_SHA256_HMAC *ctx, UINT algorithm, UCHAR *key_ptr, UINT key_length)
+{
+NX_CRYPTO_SHA256_HMAC_KEY_CACHE *entry = NX_CRYPTO_NULL;
+NX_CRYPTO_SHA256                *sha256;
+UCHAR                           *pad;
+UCHAR                            diff;
+UINT                             i;
+UINT                             j;
+
+
+    /* Keys longer than a block are hashed first, take the generic path for them.  */
+    if ((key_length == 0) || (key_length > NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES))
+    {
+        ctx -> nx_sha256_hmac_key_cache_current = NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE;
+        return(_nx_crypto_hmac_initialize(&(ctx -> nx_sha256_hmac_metadata), key_ptr, key_length));
+    }
+
+    /* Look for the key in the cache. The key bytes are compared without exiting early.  */
+    for (i = 0; i < NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE; i++)
+    {
+        entry = &(ctx -> nx_sha256_hmac_key_cache[i]);
+        if ((entry -> nx_sha256_hmac_key_length != key_length) ||
+            (entry -> nx_sha256_hmac_algorithm != algorithm))
+        {
+            continue;
+        }
+
+        diff = 0;
+        for (j = 0; j < key_length; j++)
+        {
+            diff |= (UCHAR)(entry -> nx_sha256_hmac_key[j] ^ key_ptr[j]);
+        }
+
+        if (diff == 0)
+        {
+            break;
+        }
+    }
+
+    sha256 = &(ctx -> nx_sha256_hmac_context);
+
+    if (i == NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE)
+    {
+
+        /* Not found, compute the padded key states into the entry replaced next.  */
+        i = ctx -> nx_sha256_hmac_key_cache_next;
+        if (i >= NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE)
+        {
+            i = 0;
+        }
+        ctx -> nx_sha256_hmac_key_cache_next = (i + 1) % NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE;
+        entry = &(ctx -> nx_sha256_hmac_key_cache[i]);
+
+        /* The HMAC transform is SHA256(K XOR opad, SHA256(K XOR ipad, text)), where the key
+           is padded with zeros to the block size, ipad is the byte 0x36 and opad is the byte 0x5c
+           repeated block size times.  */
+        pad = ctx -> nx_sha256_hmac_metadata.k_ipad;
+        NX_CRYPTO_MEMSET(pad, 0, NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES);
+        NX_CRYPTO_MEMCPY(pad, key_ptr, key_length); /* Use case of memcpy is verified. */
+
+        for (j = 0; j < NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES; j++)
+        {
+            pad[j] ^= 0x36;
+        }
+        _nx_crypto_sha256_initialize(sha256, algorithm);
+        _nx_crypto_sha256_update(sha256, pad, NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES);
+        NX_CRYPTO_MEMCPY(entry -> nx_sha256_hmac_inner_states, sha256 -> nx_sha256_states,
+                         sizeof(entry -> nx_sha256_hmac_inner_states)); /* Use case of memcpy is verified. */
+
+        /* Turn the key XOR ipad into the key XOR opad.  */
+        for (j = 0; j < NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES; j++)
+        {
+            pad[j] ^= (0x36 ^ 0x5c);
+        }
+        _nx_crypto_sha256_initialize(sha256, algorithm);
+        _nx_crypto_sha256_update(sha256, pad, NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES);
+        NX_CRYPTO_MEMCPY(entry -> nx_sha256_hmac_outer_states, sha256 -> nx_sha256_states,
+                         sizeof(entry -> nx_sha256_hmac_outer_states)); /* Use case of memcpy is verified. */
+
+#ifdef NX_SECURE_KEY_CLEAR
+        NX_CRYPTO_MEMSET(pad, 0, NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES);
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+        NX_CRYPTO_MEMCPY(entry -> nx_sha256_hmac_key, key_ptr, key_length); /* Use case of memcpy is verified. */
+        entry -> nx_sha256_hmac_key_length = key_length;
+        entry -> nx_sha256_hmac_algorithm = algorithm;
+    }
+
+    ctx -> nx_sha256_hmac_key_cache_current = i;
+
+    /* Resume the inner hash after the key XOR ipad block.  */
+    NX_CRYPTO_MEMCPY(sha256 -> nx_sha256_states, entry -> nx_sha256_hmac_inner_states,
+                     sizeof(sha256 -> nx_sha256_states)); /* Use case of memcpy is verified. */
+    sha256 -> nx_sha256_bit_count[0] = NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES << 3;
+    sha256 -> nx_sha256_bit_count[1] = 0;
+
+    /* Return success.  */
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_hmac_sha256_digest_calculate             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finishes an HMAC SHA256 calculation started by        */
+/*    _nx_crypto_hmac_sha256_initialize, resuming the outer hash from the */
+/*    cached key XOR opad state.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   Pointer to HMAC SHA256 context*/
+/*    algorithm                             HMAC SHA224 or HMAC SHA256    */
+/*    digest_ptr                            Pointer to output digest      */
+/*    digest_length                         Length of output digest       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_hmac_digest_calculate      Calculate HMAC digest         */
+/*    _nx_crypto_sha256_digest_calculate    Calculate the SHA256 digest   */
+/*    _nx_crypto_sha256_update              Update the SHA256 digest      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_hmac_sha256_operation                             */
+/*                                          Handle HMAC SHA256 operation  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT _nx_crypto_hmac_sha256_digest_calculate(NX_CRYPTO_SHA256_HMAC *ctx, UINT algorithm, UCHAR *digest_ptr, UINT digest_length)
+{
+NX_CRYPTO_SHA256_HMAC_KEY_CACHE *entry;
+NX_CRYPTO_SHA256                *sha256;
+UCHAR                            icv_ptr[32];
+UINT                             output_length;
+
+
+    /* Check if the key was not cached.  */
+    if (ctx -> nx_sha256_hmac_key_cache_current >= NX_CRYPTO_HMAC_SHA256_KEY_CACHE_SIZE)
+    {
+        return(_nx_crypto_hmac_digest_calculate(&(ctx -> nx_sha256_hmac_metadata), digest_ptr, digest_length));
+    }
+
+    entry = &(ctx -> nx_sha256_hmac_key_cache[ctx -> nx_sha256_hmac_key_cache_current]);
+    sha256 = &(ctx -> nx_sha256_hmac_context);
+    output_length = ctx -> nx_sha256_hmac_metadata.output_length;
+
+    /* Finish the inner hash.  */
+    _nx_crypto_sha256_digest_calculate(sha256, icv_ptr, algorithm);
+
+    /* Perform the outer hash resuming after the key XOR opad block.  */
+    NX_CRYPTO_MEMCPY(sha256 -> nx_sha256_states, entry -> nx_sha256_hmac_outer_states,
+                     sizeof(sha256 -> nx_sha256_states)); /* Use case of memcpy is verified. */
+    sha256 -> nx_sha256_bit_count[0] = NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES << 3;
+    sha256 -> nx_sha256_bit_count[1] = 0;
+    _nx_crypto_sha256_update(sha256, icv_ptr, output_length);
+    _nx_crypto_sha256_digest_calculate(sha256, icv_ptr, algorithm);
+
+    NX_CRYPTO_MEMCPY(digest_ptr, icv_ptr, (digest_length > output_length ? output_length : digest_length)); /* Use case of memcpy is verified. */
+
+#ifdef NX_SECURE_KEY_CLEAR
+    NX_CRYPTO_MEMSET(icv_ptr, 0, sizeof(icv_ptr));
+#endif /* NX_SECURE_KEY_CLEAR  */
+
+    /* Return success.  */
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -198,11 +411,12 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_method_hmac_sha256_cleanup(VOID *crypto_metadata
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_crypto_hmac                       Calculate the HMAC            */
 /*    _nx_crypto_hmac_metadata_set          Set HMAC metadata             */
-/*    _nx_crypto_hmac_initialize            Perform HMAC initialization   */
+/*    _nx_crypto_hmac_sha256_initialize     Perform HMAC SHA256           */
+/*                                            initialization              */
 /*    _nx_crypto_hmac_update                Perform HMAC update           */
-/*    _nx_crypto_hmac_digest_calculate      Calculate HMAC digest         */
+/*    _nx_crypto_hmac_sha256_digest_calculate                             */
+/*                                          Calculate HMAC SHA256 digest  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -290,7 +504,7 @@ UINT                    icv_length;
             return(NX_CRYPTO_PTR_ERROR);
         }
 
-        _nx_crypto_hmac_initialize(hmac_metadata, key, key_size_in_bits >> 3);
+        _nx_crypto_hmac_sha256_initialize(ctx, method -> nx_crypto_algorithm, key, key_size_in_bits >> 3);
         break;
 
     case NX_CRYPTO_HASH_UPDATE:
@@ -302,9 +516,9 @@ UINT                    icv_length;
         {
             return(NX_CRYPTO_INVALID_BUFFER_SIZE);
         }
-        _nx_crypto_hmac_digest_calculate(hmac_metadata, output,
-                                         (output_length_in_byte > (ULONG)((method -> nx_crypto_ICV_size_in_bits) >> 3) ?
-                                         ((method -> nx_crypto_ICV_size_in_bits) >> 3) : output_length_in_byte));
+        _nx_crypto_hmac_sha256_digest_calculate(ctx, method -> nx_crypto_algorithm, output,
+                                                (output_length_in_byte > (ULONG)((method -> nx_crypto_ICV_size_in_bits) >> 3) ?
+                                                ((method -> nx_crypto_ICV_size_in_bits) >> 3) : output_length_in_byte));
         break;
 
     default:
@@ -317,9 +531,12 @@ UINT                    icv_length;
         {
             return(NX_CRYPTO_INVALID_BUFFER_SIZE);
         }
-        _nx_crypto_hmac(hmac_metadata, input, input_length_in_byte, key, (key_size_in_bits >> 3), output,
-                        (output_length_in_byte > (ULONG)((method -> nx_crypto_ICV_size_in_bits) >> 3) ?
-                        ((method -> nx_crypto_ICV_size_in_bits) >> 3) : output_length_in_byte));
+        /* Do entire HMAC operation in one pass (init, update, calculate). */
+        _nx_crypto_hmac_sha256_initialize(ctx, method -> nx_crypto_algorithm, key, key_size_in_bits >> 3);
+        _nx_crypto_hmac_update(hmac_metadata, input, input_length_in_byte);
+        _nx_crypto_hmac_sha256_digest_calculate(ctx, method -> nx_crypto_algorithm, output,
+                                                (output_length_in_byte > (ULONG)((method -> nx_crypto_ICV_size_in_bits) >> 3) ?
+                                                ((method -> nx_crypto_ICV_size_in_bits) >> 3) : output_length_in_byte));
         break;
     }
 
@@ -1090,7 +1090,8 @@ NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_multiply(NX_CRYPTO_HUGE_NUMBER *left,
 
 UINT      index, right_index; /* Loop variables */
 HN_UBASE *left_buffer, *right_buffer;
-HN_UBASE2 product;
+HN_UBASE  left_digit;
+HN_UBASE  carry;
 UINT      left_size, right_size;
 HN_UBASE *result_buffer;
 HN_UBASE *temp_ptr;
@@ -1100,9 +1101,9 @@ HN_UBASE *temp_ptr;
     left_buffer = left -> nx_crypto_huge_number_data;
     right_buffer = right -> nx_crypto_huge_number_data;
 
-    /* The temp buffer serves as "buckets".  During each itegration, the products of two digits are accumucated into
-       this buckets.  Since each "digit" is 16-bit, by using 32-bit buckets, the carry can be accumulated in to the
-       top 16-bits of the bucket.  Therefore, we don't need to worry about "carry" bit during each iteration.  */
+    /* The result buffer serves as "buckets".  During each iteration, the products of a digit on the left with
+       the digits on the right are accumulated into these buckets, and the top digit of each product is carried
+       into the next bucket.  */
 
     result_buffer = result -> nx_crypto_huge_number_data;
     result -> nx_crypto_huge_number_size = (left_size + right_size);
@@ -1121,19 +1122,16 @@ HN_UBASE *temp_ptr;
             continue;
         }
 
-        product = 0;
+        carry = 0;
+        left_digit = left_buffer[index];
         temp_ptr = result_buffer + index;
         for (right_index = 0; right_index < right_size; ++right_index, ++temp_ptr)
         {
-            /* Multiple "digit" from the left with the one the left. */
-            product >>= HN_SHIFT;
-            product += (HN_UBASE2)left_buffer[index] * (HN_UBASE2)right_buffer[right_index] + *temp_ptr;
-
-            /* The result (in product) could be two parts: the top digit the the lower digit. */
-            /* Accumulate the lower digit into the "bucket" and the top digit to the next "bucket". */
-            *temp_ptr = (product & HN_MASK);
+            /* Multiply "digit" from the left with the one on the right, accumulate the lower digit into the
+               "bucket" and carry the top digit to the next "bucket". */
+            HN_MULTIPLY_ACCUMULATE(*temp_ptr, carry, left_digit, right_buffer[right_index]);
         }
-        *temp_ptr = (HN_UBASE)((product >> HN_SHIFT));
+        *temp_ptr = carry;
     }
 
     /* Set is_negative. */
@@ -1289,6 +1287,7 @@ HN_UBASE *result_buffer;
 NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_square(NX_CRYPTO_HUGE_NUMBER *value, NX_CRYPTO_HUGE_NUMBER *result)
 {
 HN_UBASE2 product;
+HN_UBASE  carry;
 UINT      value_size;
 UINT      result_size;
 HN_UBASE *value_buffer;
@@ -1306,14 +1305,12 @@ UINT      i, j;
 
     for (i = 0; i < value_size; i++)
     {
-        product = 0;
+        carry = 0;
         for (j = i + 1; j < value_size; j++)
         {
-            product >>= HN_SHIFT;
-            product += result_buffer[i + j] + (HN_UBASE2)value_buffer[i] * value_buffer[j];
-            result_buffer[i + j] = product & HN_MASK;
+            HN_MULTIPLY_ACCUMULATE(result_buffer[i + j], carry, value_buffer[i], value_buffer[j]);
         }
-        result_buffer[i + j] = (HN_UBASE)(product >> HN_SHIFT);
+        result_buffer[i + j] = carry;
     }
 
     for (i = result_size - 1; i > 0; i--)
@@ -1586,6 +1583,148 @@ NX_CRYPTO_HUGE_NUMBER *result;
     return;
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_crypto_huge_number_barrett_reduce               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reduces a huge number x modulo m by the Barrett       */
+/*    reduction, with mu = floor(b ^ (2 * k) / m) precomputed for the k   */
+/*    digits of m. Two products on the width of m and at most two         */
+/*    subtractions take the place of the long division, which is left to  */
+/*    _nx_crypto_huge_number_modulus for a negative x, an x of more than  */
+/*    2 * k digits or an empty mu. The scratch buffer must hold the       */
+/*    digits of mu and 2 * k + 2 more. The result is placed in x.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     Huge number to reduce         */
+/*    m                                     Modulus                       */
+/*    mu                                    Barrett constant of m         */
+/*    scratch                               Buffer for the products       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
+/*    _nx_crypto_huge_number_compare_unsigned                             */
+/*                                          Compare two unsigned          */
+/*                                            huge numbers                */
+/*    _nx_crypto_huge_number_subtract_unsigned                            */
+/*                                          Calculate subtraction for     */
+/*                                            unsigned huge numbers       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_ecdsa_sign                 Sign hash data using ECDSA    */
+/*    _nx_crypto_ecdsa_verify               Verify hash data using ECDSA  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_barrett_reduce(NX_CRYPTO_HUGE_NUMBER *x,
+                                                          NX_CRYPTO_HUGE_NUMBER *m,
+                                                          NX_CRYPTO_HUGE_NUMBER *mu,
+                                                          HN_UBASE *scratch)
+{
+UINT      i, j;
+UINT      k = m -> nx_crypto_huge_number_size;
+UINT      x_len = x -> nx_crypto_huge_number_size;
+UINT      mu_len = mu -> nx_crypto_huge_number_size;
+UINT      q_len;
+UINT      r_len;
+HN_UBASE *x_buffer = x -> nx_crypto_huge_number_data;
+HN_UBASE *m_buffer = m -> nx_crypto_huge_number_data;
+HN_UBASE *mu_buffer = mu -> nx_crypto_huge_number_data;
+HN_UBASE *q_buffer = scratch;
+HN_UBASE *r_buffer;
+HN_UBASE  carry;
+HN_UBASE2 product;
+
+    /* The leading zeroes of x and mu would only add products of zero. */
+    while ((x_len > 1) && (x_buffer[x_len - 1] == 0))
+    {
+        x_len--;
+    }
+    while ((mu_len > 0) && (mu_buffer[mu_len - 1] == 0))
+    {
+        mu_len--;
+    }
+
+    /* The estimate of the quotient holds for x < b ^ (2 * k) and b ^ (k - 1) <= m. */
+    if ((mu_len == 0) || (k == 0) || (m_buffer[k - 1] == 0) ||
+        (x -> nx_crypto_huge_number_is_negative) || (x_len > (k << 1)))
+    {
+        _nx_crypto_huge_number_modulus(x, m);
+        return;
+    }
+
+    x -> nx_crypto_huge_number_size = x_len;
+
+    /* x < b ^ (k - 1) <= m is the remainder already. */
+    if (x_len < k)
+    {
+        return;
+    }
+
+    /* q = (x / b ^ (k - 1)) * mu, of which the digits from k + 1 up estimate x / m. */
+    q_len = x_len - (k - 1) + mu_len;
+    NX_CRYPTO_MEMSET(q_buffer, 0, q_len << HN_SIZE_SHIFT);
+    for (i = k - 1; i < x_len; i++)
+    {
+        carry = 0;
+        for (j = 0; j < mu_len; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(q_buffer[i - (k - 1) + j], carry, x_buffer[i], mu_buffer[j]);
+        }
+        q_buffer[i - (k - 1) + mu_len] = carry;
+    }
+
+    /* r = (q / b ^ (k + 1)) * m mod b ^ (k + 1), the digits of the product above k are not
+       computed. */
+    r_buffer = q_buffer + q_len;
+    NX_CRYPTO_MEMSET(r_buffer, 0, (k + 1) << HN_SIZE_SHIFT);
+    for (i = 0; ((i + k + 1) < q_len) && (i <= k); i++)
+    {
+        carry = 0;
+        for (j = 0; (j < k) && ((i + j) <= k); j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(r_buffer[i + j], carry, q_buffer[i + k + 1], m_buffer[j]);
+        }
+        if ((i + j) <= k)
+        {
+            r_buffer[i + j] += carry;
+        }
+    }
+
+    /* x - r is less than 3 * m, so it is within k + 1 digits, and within the k digits of x
+       when x has no more. */
+    r_len = (x_len > k) ? (k + 1) : k;
+    product = HN_RADIX;
+    for (i = 0; i < r_len; i++)
+    {
+        product >>= HN_SHIFT;
+        product += (HN_UBASE2)((HN_RADIX - 1) + x_buffer[i] - r_buffer[i]);
+        x_buffer[i] = (HN_UBASE)(product & HN_MASK);
+    }
+
+    while ((r_len > 1) && (x_buffer[r_len - 1] == 0))
+    {
+        r_len--;
+    }
+    x -> nx_crypto_huge_number_size = r_len;
+
+    /* At most two subtractions of m are left. */
+    while (_nx_crypto_huge_number_compare_unsigned(x, m) != NX_CRYPTO_HUGE_NUMBER_LESS)
+    {
+        _nx_crypto_huge_number_subtract_unsigned(x, m, x);
+    }
+}
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -1786,10 +1925,17 @@ UINT      num_words;
 NX_CRYPTO_KEEP UINT _nx_crypto_huge_number_rbg(UINT bits, UCHAR *result)
 {
 UCHAR *ptr = result;
+#ifndef NX_CRYPTO_RAND_BYTES
 UINT random_number;
 UINT temp;
+#endif
 UINT mask;
 
+#ifdef NX_CRYPTO_RAND_BYTES
+
+    /* Take all the bytes at once, the extra bits of the first one are cleared below. */
+    NX_CRYPTO_RAND_BYTES(ptr, (bits + 7) >> 3);
+#else
     while (bits >= 32)
     {
 
@@ -1836,6 +1982,7 @@ UINT mask;
     default:
         break;
     }
+#endif /* NX_CRYPTO_RAND_BYTES */
 
     /* Zero out extra bits generated. */
     bits = bits & 7;
@@ -2458,6 +2605,8 @@ NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont(NX_CRYPTO_HUGE_NUMBER *m, UINT m
 UINT      i, j;
 HN_UBASE  u;
 HN_UBASE  xi;
+HN_UBASE  digit;
+HN_UBASE  carry;
 HN_UBASE2 product;
 UINT      m_len = m -> nx_crypto_huge_number_size;
 UINT      x_len = x -> nx_crypto_huge_number_size;
@@ -2475,32 +2624,31 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
         xi = x_buffer[i];
 
         /* r = (r + x[i] * y + u * m) / radix */
-        product = 0;
+        carry = 0;
         for (j = 0; j < y_len; j++)
         {
-            product >>= HN_SHIFT;
-            product += result_buffer[j] + (HN_UBASE2)xi * y_buffer[j];
-            result_buffer[j] = (product & HN_MASK);
+            HN_MULTIPLY_ACCUMULATE(result_buffer[j], carry, xi, y_buffer[j]);
         }
-        for (; j < (m_len + 1); j++)
+        for (; (j < (m_len + 1)) && (carry != 0); j++)
         {
-            product >>= HN_SHIFT;
-            product += result_buffer[j];
+            product = (HN_UBASE2)result_buffer[j] + carry;
             result_buffer[j] = (product & HN_MASK);
+            carry = (HN_UBASE)(product >> HN_SHIFT);
         }
 
         /* u = (r[0] + x[i] * y[0]) * mi mod radix */
         u = result_buffer[0] * mi;
 
-        product = result_buffer[0] + (HN_UBASE2)u * m_buffer[0];
+        carry = 0;
+        digit = result_buffer[0];
+        HN_MULTIPLY_ACCUMULATE(digit, carry, u, m_buffer[0]);
         for (j = 1; j < m_len; j++)
         {
-            product >>= HN_SHIFT;
-            product += result_buffer[j] + (HN_UBASE2)u * m_buffer[j];
-            result_buffer[j - 1] = (product & HN_MASK);
+            digit = result_buffer[j];
+            HN_MULTIPLY_ACCUMULATE(digit, carry, u, m_buffer[j]);
+            result_buffer[j - 1] = digit;
         }
-        product >>= HN_SHIFT;
-        product += result_buffer[j];
+        product = (HN_UBASE2)result_buffer[j] + carry;
         result_buffer[j - 1] = (product & HN_MASK);
         result_buffer[j] = (HN_UBASE)(product >> HN_SHIFT);
     }
@@ -2512,15 +2660,16 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
         u = ((result_buffer[0] * mi) & HN_MASK);
 
         /* r = (r + x[i] * y + u * m) / radix */
-        product = result_buffer[0] + (HN_UBASE2)u * m_buffer[0];
+        carry = 0;
+        digit = result_buffer[0];
+        HN_MULTIPLY_ACCUMULATE(digit, carry, u, m_buffer[0]);
         for (j = 1; j < m_len; j++)
         {
-            product >>= HN_SHIFT;
-            product += result_buffer[j] + (HN_UBASE2)u * m_buffer[j];
-            result_buffer[j - 1] = (product & HN_MASK);
+            digit = result_buffer[j];
+            HN_MULTIPLY_ACCUMULATE(digit, carry, u, m_buffer[j]);
+            result_buffer[j - 1] = digit;
         }
-        product >>= HN_SHIFT;
-        product += result_buffer[j];
+        product = (HN_UBASE2)result_buffer[j] + carry;
         result_buffer[j - 1] = (product & HN_MASK);
         result_buffer[j] = (HN_UBASE)(product >> HN_SHIFT);
     }
@@ -2537,6 +2686,110 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
     }
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_square                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs Montgomery reduction for squaring.           */
+/*                  r = (x * x) * R ^ (-1) mod m                          */
+/*                                                                        */
+/*    The square is computed first, with each cross product computed      */
+/*    once, then reduced. This takes about three quarters of the          */
+/*    multiplications of _nx_crypto_huge_number_mont(m, mi, x, x, r).     */
+/*    x must be less than m. The work buffer must hold twice the number   */
+/*    of digits of m. r can be the same huge number as x.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    m                                     Huge number m                 */
+/*    mi                                    mi = -m ^ (-1) mod radix      */
+/*    x                                     Huge number x                 */
+/*    work                                  Huge number for the square    */
+/*    result                                Huge number r                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_huge_number_square         Compute the square of a value */
+/*    _nx_crypto_huge_number_subtract       Calculate subtraction for     */
+/*                                             huge numbers               */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_compare        Compare two huge numbers      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_modulus                           */
+/*                                          Raise a huge number for       */
+/*                                            montgomery reduction        */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_square(NX_CRYPTO_HUGE_NUMBER *m, UINT mi,
+                                                       NX_CRYPTO_HUGE_NUMBER *x,
+                                                       NX_CRYPTO_HUGE_NUMBER *work,
+                                                       NX_CRYPTO_HUGE_NUMBER *result)
+{
+UINT      i, j;
+HN_UBASE  u;
+HN_UBASE  carry;
+HN_UBASE  top = 0;
+HN_UBASE2 product;
+UINT      m_len = m -> nx_crypto_huge_number_size;
+UINT      work_len;
+HN_UBASE *m_buffer = m -> nx_crypto_huge_number_data;
+HN_UBASE *work_buffer = work -> nx_crypto_huge_number_data;
+HN_UBASE *temp_ptr;
+
+    /* t = x * x, zero extended to 2 * m_len digits. The digit above them, at most 1, is kept in top. */
+    _nx_crypto_huge_number_square(x, work);
+    work_len = work -> nx_crypto_huge_number_size;
+    NX_CRYPTO_MEMSET(work_buffer + work_len, 0, ((m_len << 1) - work_len) << HN_SIZE_SHIFT);
+
+    /* For each of the low digits of t, add the multiple of m that clears it, t = t + u * m * radix ^ i. */
+    for (i = 0; i < m_len; i++)
+    {
+
+        /* u = t[i] * mi mod radix */
+        u = ((work_buffer[i] * mi) & HN_MASK);
+
+        carry = 0;
+        temp_ptr = work_buffer + i;
+        for (j = 0; j < m_len; j++)
+        {
+            HN_MULTIPLY_ACCUMULATE(temp_ptr[j], carry, u, m_buffer[j]);
+        }
+        for (j += i; (j < (m_len << 1)) && (carry != 0); j++)
+        {
+            product = (HN_UBASE2)work_buffer[j] + carry;
+            work_buffer[j] = (product & HN_MASK);
+            carry = (HN_UBASE)(product >> HN_SHIFT);
+        }
+        top += carry;
+    }
+
+    /* r = t / radix ^ m_len */
+    NX_CRYPTO_MEMCPY(result -> nx_crypto_huge_number_data, work_buffer + m_len, m_len << HN_SIZE_SHIFT);
+    result -> nx_crypto_huge_number_data[m_len] = top;
+    result -> nx_crypto_huge_number_size = m_len + 1;
+    result -> nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+    _nx_crypto_huge_number_adjust_size(result);
+
+    if (_nx_crypto_huge_number_compare(result, m) != NX_CRYPTO_HUGE_NUMBER_LESS)
+    {
+
+        /* r = r - m. */
+        _nx_crypto_huge_number_subtract(result, m);
+    }
+}
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -2552,8 +2805,12 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
 /*    This function raises a huge number to the power of a second huge    */
 /*    number using a third huge number as a modulus. The result is placed */
 /*    in a fourth huge number. Montgomery reduction is used.              */
-/*    scratch is required to be larger than twice of buffer size of m     */
-/*    plus 8 bytes.                                                       */
+/*    The exponent is scanned from its most significant bit with a        */
+/*    sliding window of NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS bits, or one    */
+/*    bit for exponents of at most 64 bits.                               */
+/*    scratch is required to be larger than the number of odd powers in   */
+/*    the window plus one, times the buffer size of m plus 4 bytes.       */
+/*    result must hold twice the number of digits of m.                   */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -2570,21 +2827,11 @@ HN_UBASE *result_buffer = result -> nx_crypto_huge_number_data;
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    NX_CRYPTO_HUGE_NUMBER_COPY            Copy huge number              */
-/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE      Initialize the buffer of      */
-/*                                            huge number                 */
-/*    NX_CRYPTO_HUGE_NUMBER_SET_DIGIT       Set value of huge number      */
-/*                                            between 0 and (HN_RADIX - 1)*/
-/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
-/*                                            number to remove leading    */
-/*                                            zeroes                      */
-/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
-/*    _nx_crypto_huge_number_inverse_modulus                              */
-/*                                          Perform an inverse modulus    */
-/*                                            operation                   */
-/*    _nx_crypto_huge_number_mont           Perform Montgomery reduction  */
-/*                                            for multiplication          */
-/*    _nx_crypto_huge_number_square         Compute the square of a value */
+/*    _nx_crypto_huge_number_mont_setup     Compute the Montgomery        */
+/*                                            constants of a modulus      */
+/*    _nx_crypto_huge_number_mont_power_precomputed                       */
+/*                                          Raise a huge number with the  */
+/*                                            Montgomery constants        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -2612,24 +2859,75 @@ NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_power_modulus(NX_CRYPTO_HUGE_NUM
                                                               NX_CRYPTO_HUGE_NUMBER *result,
                                                               HN_UBASE *scratch)
 {
+UINT mi;
+
+    /* The result buffer holds radix ^ (2 * m_len) mod m until the exponentiation turns it into xx. */
+    _nx_crypto_huge_number_mont_setup(m, &mi, result, scratch);
+    _nx_crypto_huge_number_mont_power_precomputed(x, e, m, mi, result, result, scratch);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_setup                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the Montgomery constants of a modulus, the   */
+/*    ones _nx_crypto_huge_number_mont_power_precomputed takes.           */
+/*                 mi = -m ^ (-1) mod radix                               */
+/*                 rr = radix ^ (2 * m_len) mod m                         */
+/*    They only depend on m, a caller raising numbers modulo the same m   */
+/*    again can keep them. m must be odd. scratch is required to be no    */
+/*    less than the buffer size of m plus 4 bytes. rr must hold twice     */
+/*    the number of digits of m.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    m                                     Modulus number                */
+/*    mi                                    Pointer to mi                 */
+/*    rr                                    Huge number rr                */
+/*    scratch                               Buffer used to hold           */
+/*                                            intermediate data           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE      Initialize the buffer of      */
+/*                                            huge number                 */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
+/*    _nx_crypto_huge_number_inverse_modulus                              */
+/*                                          Perform an inverse modulus    */
+/*                                            operation                   */
+/*    _nx_crypto_huge_number_square         Compute the square of a value */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_modulus                           */
+/*                                          Raise a huge number for       */
+/*                                            montgomery reduction        */
+/*    _nx_crypto_rsa_operation              Perform an RSA operation      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_setup(NX_CRYPTO_HUGE_NUMBER *m, UINT *mi,
+                                                      NX_CRYPTO_HUGE_NUMBER *rr, HN_UBASE *scratch)
+{
 UINT                   m_len;
-NX_CRYPTO_HUGE_NUMBER  xx;
 NX_CRYPTO_HUGE_NUMBER  temp;
-NX_CRYPTO_HUGE_NUMBER  digit;
 NX_CRYPTO_HUGE_NUMBER  radix;
-NX_CRYPTO_HUGE_NUMBER  mi;
+NX_CRYPTO_HUGE_NUMBER  mm;
 NX_CRYPTO_HUGE_NUMBER  m0;
-HN_UBASE               digit_value;
 HN_UBASE              *val;
 HN_UBASE               radix_buffer[2] = {0, 1};
 HN_UBASE               mm_buffer[2];
-HN_UBASE               cur_block;
-UINT                   bit, exp_size;
-NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
 
-    /* Adjust sizes before performing the calculation. */
-    _nx_crypto_huge_number_adjust_size(x);
-    _nx_crypto_huge_number_adjust_size(e);
     _nx_crypto_huge_number_adjust_size(m);
 
     /* Initialize const huge numbers. */
@@ -2641,21 +2939,17 @@ NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
     m0.nx_crypto_huge_number_size = 1;
     m0.nx_crypto_huge_buffer_size = 4;
     m0.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
-    mi.nx_crypto_huge_number_data = mm_buffer;
-    mi.nx_crypto_huge_buffer_size = sizeof(mm_buffer);
+    mm.nx_crypto_huge_number_data = mm_buffer;
+    mm.nx_crypto_huge_buffer_size = sizeof(mm_buffer);
 
     /* mi = -m^(-1) mod radix */
-    _nx_crypto_huge_number_inverse_modulus(&m0, &radix, &mi, scratch);
-    mm_buffer[0] = (HN_UBASE)(HN_RADIX - mm_buffer[0]);
+    _nx_crypto_huge_number_inverse_modulus(&m0, &radix, &mm, scratch);
+    *mi = (HN_UBASE)(HN_RADIX - mm_buffer[0]);
 
-    /* Set buffers. */
-    /* Buffer usage: 2 * buffer_size of m + 8 */
-    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&xx, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    /* Buffer usage: buffer_size of m + 4 */
     NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
-    NX_CRYPTO_HUGE_NUMBER_INITIALIZE_DIGIT(&digit, &digit_value, 1);
 
-
-    /* x' = radix ^ m_len mod m */
+    /* temp = radix ^ m_len mod m */
     m_len = m -> nx_crypto_huge_number_size;
     val = temp.nx_crypto_huge_number_data;
     NX_CRYPTO_MEMSET(val, 0, (m_len << HN_SIZE_SHIFT));
@@ -2663,60 +2957,198 @@ NX_CRYPTO_HUGE_NUMBER *operand, *temp_result, *temp_swap;
     val[m_len] = 1;
     _nx_crypto_huge_number_modulus(&temp, m);
 
-    /* xx = mont(x, radix ^ (2 * m_len) mod m)*/
-    _nx_crypto_huge_number_square(&temp, result);
-    _nx_crypto_huge_number_modulus(result, m);
-    _nx_crypto_huge_number_mont(m, mm_buffer[0], x, result, &xx);
+    /* rr = radix ^ (2 * m_len) mod m */
+    _nx_crypto_huge_number_square(&temp, rr);
+    _nx_crypto_huge_number_modulus(rr, m);
+}
 
-    /* result = x' */
-    NX_CRYPTO_HUGE_NUMBER_COPY(result, &temp);
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_precomputed       PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function raises a huge number to the power of a second huge    */
+/*    number using a third huge number as a modulus, as                   */
+/*    _nx_crypto_huge_number_mont_power_modulus does, with the Montgomery */
+/*    constants of the modulus computed by                                */
+/*    _nx_crypto_huge_number_mont_setup, possibly in an earlier call.     */
+/*    The exponent is scanned from its most significant bit with a        */
+/*    sliding window of NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS bits, or one    */
+/*    bit for exponents of at most 64 bits: for e = 65537, 16 squarings   */
+/*    and one multiplication.                                             */
+/*    scratch is required to be larger than the number of odd powers in   */
+/*    the window plus one, times the buffer size of m plus 4 bytes.       */
+/*    result must hold twice the number of digits of m. rr can be the     */
+/*    same huge number as result, it is read before result is written.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     Number being exponentiated    */
+/*    e                                     Exponent number               */
+/*    m                                     Modulus number                */
+/*    mi                                    mi = -m ^ (-1) mod radix      */
+/*    rr                                    Montgomery constant rr        */
+/*    result                                Result buffer                 */
+/*    scratch                               Buffer used to hold           */
+/*                                            intermediate data           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_HUGE_NUMBER_COPY            Copy huge number              */
+/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE      Initialize the buffer of      */
+/*                                            huge number                 */
+/*    NX_CRYPTO_HUGE_NUMBER_SET_DIGIT       Set value of huge number      */
+/*                                            between 0 and (HN_RADIX - 1)*/
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
+/*    _nx_crypto_huge_number_mont           Perform Montgomery reduction  */
+/*                                            for multiplication          */
+/*    _nx_crypto_huge_number_mont_square    Perform Montgomery reduction  */
+/*                                            for squaring                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_modulus                           */
+/*                                          Raise a huge number for       */
+/*                                            montgomery reduction        */
+/*    _nx_crypto_rsa_operation              Perform an RSA operation      */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_power_precomputed(NX_CRYPTO_HUGE_NUMBER *x,
+                                                                  NX_CRYPTO_HUGE_NUMBER *e,
+                                                                  NX_CRYPTO_HUGE_NUMBER *m,
+                                                                  UINT mi,
+                                                                  NX_CRYPTO_HUGE_NUMBER *rr,
+                                                                  NX_CRYPTO_HUGE_NUMBER *result,
+                                                                  HN_UBASE *scratch)
+{
+NX_CRYPTO_HUGE_NUMBER  table[NX_CRYPTO_HUGE_NUMBER_WINDOW_TABLE_SIZE];
+NX_CRYPTO_HUGE_NUMBER  temp;
+NX_CRYPTO_HUGE_NUMBER  digit;
+HN_UBASE               digit_value;
+HN_UBASE              *val;
+HN_UBASE               cur_block;
+UINT                   bit, exp_bits;
+UINT                   window_bits, window, window_size;
+UINT                   table_size;
+UINT                   i;
+UINT                   started = NX_CRYPTO_FALSE;
 
-    /* Clear out the result since we need it to start with a simple value. */
+    /* Adjust sizes before performing the calculation. */
+    _nx_crypto_huge_number_adjust_size(x);
+    _nx_crypto_huge_number_adjust_size(e);
+    _nx_crypto_huge_number_adjust_size(m);
 
-    operand = result;
-    temp_result = &temp;
+    /* Number of significant bits in the exponent. */
+    exp_bits = (e -> nx_crypto_huge_number_size - 1) * NX_CRYPTO_HUGE_NUMBER_BITS;
+    for (cur_block = e -> nx_crypto_huge_number_data[e -> nx_crypto_huge_number_size - 1];
+         cur_block != 0; cur_block >>= 1)
+    {
+        exp_bits++;
+    }
 
-    exp_size = e -> nx_crypto_huge_number_size;
-    val = e -> nx_crypto_huge_number_data + (exp_size - 1);
+    /* x ^ 0 = 1, the loop below starts at the top set bit of the exponent. */
+    if (exp_bits == 0)
+    {
+        NX_CRYPTO_HUGE_NUMBER_SET_DIGIT(result, 1);
+        _nx_crypto_huge_number_modulus(result, m);
+        return;
+    }
 
-    /* Loop through the bits of the exponent. For each bit set, multiply the result by the running square. */
-    for (; (ULONG)val >= (ULONG)(e -> nx_crypto_huge_number_data); val--)
+    /* Short exponents, like the public exponents of RSA, do not make up for the precomputed powers. */
+    window_bits = (exp_bits > 64) ? NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS : 1;
+    table_size = 1u << (window_bits - 1);
+
+    /* Set buffers. */
+    /* Buffer usage: (table_size + 1) * (buffer_size of m + 4) */
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&table[0], scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    for (i = 1; i < table_size; i++)
     {
-        /* Current byte in the exponent determines whether we multiply or not. */
-        cur_block = *val;
+        NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&table[i], scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    }
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE_DIGIT(&digit, &digit_value, 1);
 
-        /* Loop over the bits in the current byte to see whether we add or not. */
-        for (bit = 0; bit < HN_SHIFT; bit++)
+
+    /* table[0] = xx = mont(x, radix ^ (2 * m_len) mod m) */
+    _nx_crypto_huge_number_mont(m, mi, x, rr, &table[0]);
+
+    /* table[i] = mont(table[i - 1], xx ^ 2), the odd powers of xx. The result buffer holds the square. */
+    if (table_size > 1)
+    {
+        _nx_crypto_huge_number_mont_square(m, mi, &table[0], result, &temp);
+        for (i = 1; i < table_size; i++)
         {
+            _nx_crypto_huge_number_mont(m, mi, &table[i - 1], &temp, &table[i]);
+        }
+    }
 
-            /* A non-zero bit means we need to multiply. */
-            if (cur_block & (1u << (NX_CRYPTO_HUGE_NUMBER_BITS - (1 + bit))))
-            {
+    /* Loop through the bits of the exponent from its most significant bit. Each zero bit squares the running
+       result in temp. A one bit starts a window of up to window_bits bits that ends with a one bit, which
+       squares the running result once per bit then multiplies it by the odd power of xx in the window. The
+       first window sets temp. */
+    bit = exp_bits;
+    while (bit > 0)
+    {
+        bit--;
+        val = e -> nx_crypto_huge_number_data + (bit / NX_CRYPTO_HUGE_NUMBER_BITS);
+        if (((*val >> (bit % NX_CRYPTO_HUGE_NUMBER_BITS)) & 1) == 0)
+        {
 
-                /* result = mont(result, result) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], operand, operand, temp_result);
+            /* temp = mont(temp, temp) */
+            _nx_crypto_huge_number_mont_square(m, mi, &temp, result, &temp);
+            continue;
+        }
 
-                /* result = mont(result, xx) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], temp_result, &xx, operand);
-            }
-            else
-            {
+        /* Collect the window, then drop its trailing zero bits. */
+        window = 1;
+        window_size = 1;
+        while ((window_size < window_bits) && (bit > 0))
+        {
+            bit--;
+            val = e -> nx_crypto_huge_number_data + (bit / NX_CRYPTO_HUGE_NUMBER_BITS);
+            window = (window << 1) | ((*val >> (bit % NX_CRYPTO_HUGE_NUMBER_BITS)) & 1);
+            window_size++;
+        }
+        while ((window & 1) == 0)
+        {
+            window >>= 1;
+            window_size--;
+            bit++;
+        }
 
-                /* result = mont(result, result) */
-                _nx_crypto_huge_number_mont(m, mm_buffer[0], operand, operand, temp_result);
-                temp_swap = temp_result;
-                temp_result = operand;
-                operand = temp_swap;
-            }
+        if (started == NX_CRYPTO_FALSE)
+        {
+
+            /* The first window, temp = xx ^ window. */
+            NX_CRYPTO_HUGE_NUMBER_COPY(&temp, &table[window >> 1]);
+            started = NX_CRYPTO_TRUE;
+            continue;
         }
+
+        for (i = 0; i < window_size; i++)
+        {
+
+            /* temp = mont(temp, temp) */
+            _nx_crypto_huge_number_mont_square(m, mi, &temp, result, &temp);
+        }
+
+        /* temp = mont(temp, xx ^ window) */
+        _nx_crypto_huge_number_mont(m, mi, &temp, &table[window >> 1], result);
+        NX_CRYPTO_HUGE_NUMBER_COPY(&temp, result);
     }
 
     /* result = mont(result, 1) */
-    _nx_crypto_huge_number_mont(m, mm_buffer[0], &digit, operand, temp_result);
-    if (temp_result != result)
-    {
-        NX_CRYPTO_HUGE_NUMBER_COPY(result, &temp);
-    }
+    _nx_crypto_huge_number_mont(m, mi, &digit, &temp, result);
 }
 
 /**************************************************************************/
@@ -2852,7 +3284,7 @@ HN_UBASE               digit_value;
     /* m1 = xp ^ ep mod p */
     m1 = &temp1;
 
-    /* Buffer usage: 1 * buffer_size of m + 8 bytes */
+    /* Buffer usage: (NX_CRYPTO_HUGE_NUMBER_WINDOW_TABLE_SIZE + 1) * (buffer_size of p + 4 bytes) */
     _nx_crypto_huge_number_mont_power_modulus(xp, ep, p, m1, scratch);
 
     /* m1 * qi * q */
@@ -2876,7 +3308,7 @@ HN_UBASE               digit_value;
     /* m2 = xq ^ eq mod q */
     m2 = &temp1;
 
-    /* Buffer usage: 1 * buffer_size of m + 8 bytes */
+    /* Buffer usage: (NX_CRYPTO_HUGE_NUMBER_WINDOW_TABLE_SIZE + 1) * (buffer_size of q + 4 bytes) */
     _nx_crypto_huge_number_mont_power_modulus(xq, eq, q, m2, scratch);
 
     /* pi * p * m2 */
@@ -2893,3 +3325,288 @@ HN_UBASE               digit_value;
     _nx_crypto_huge_number_modulus(result, m);
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_mont_power_fixed_window      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function raises a huge number to the power of a second huge    */
+/*    number using a third huge number as a modulus, for a secret         */
+/*    exponent. The exponent is scanned in windows of                     */
+/*    NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS bits from the top digit of its    */
+/*    size, each window squares the running result once per bit then      */
+/*    multiplies it by the power of the window, zero windows included.    */
+/*    The power is read from the table by a masked select of every entry. */
+/*    So the sequence of the operations and the memory read do not        */
+/*    depend on the bits of the exponent. The final subtraction of the    */
+/*    Montgomery product still depends on the data, the base is to be     */
+/*    blinded by the caller.                                              */
+/*                                                                        */
+/*    Requirement:                                                        */
+/*      1. m is odd and x is less than m.                                 */
+/*      2. result may be x, its buffer holds one digit more than m.       */
+/*      3. scratch is required to be no less than                         */
+/*         (2 ^ NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS + 4) times the buffer   */
+/*         size of m plus 4 bytes.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     Number being exponentiated    */
+/*    e                                     Exponent number               */
+/*    m                                     Modulus number                */
+/*    result                                Result buffer                 */
+/*    scratch                               Buffer used to hold           */
+/*                                            intermediate data           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE      Initialize the buffer of      */
+/*                                            huge number                 */
+/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE_DIGITInitialize the buffer of      */
+/*                                            huge number to a digit      */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_mont           Perform Montgomery            */
+/*                                            multiplication              */
+/*    _nx_crypto_huge_number_mont_square    Perform Montgomery square     */
+/*    _nx_crypto_huge_number_mont_setup     Compute the Montgomery        */
+/*                                            constants of a modulus      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_huge_number_crt_power_precomputed                        */
+/*                                          Raise a huge number with the  */
+/*                                            CRT parameters of a key     */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_mont_power_fixed_window(NX_CRYPTO_HUGE_NUMBER *x,
+                                                                   NX_CRYPTO_HUGE_NUMBER *e,
+                                                                   NX_CRYPTO_HUGE_NUMBER *m,
+                                                                   NX_CRYPTO_HUGE_NUMBER *result,
+                                                                   HN_UBASE *scratch)
+{
+NX_CRYPTO_HUGE_NUMBER  table[1 << NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS];
+NX_CRYPTO_HUGE_NUMBER  work, temp1, temp2;
+NX_CRYPTO_HUGE_NUMBER *acc, *prod, *swap;
+NX_CRYPTO_HUGE_NUMBER  digit;
+HN_UBASE               digit_value;
+HN_UBASE               mask;
+HN_UBASE              *val;
+UINT                   size_mask;
+UINT                   mi;
+UINT                   m_len;
+UINT                   bit, exp_bits;
+UINT                   window, windows;
+UINT                   i, j;
+
+    /* Adjust sizes before performing the calculation. */
+    _nx_crypto_huge_number_adjust_size(x);
+    _nx_crypto_huge_number_adjust_size(e);
+    _nx_crypto_huge_number_adjust_size(m);
+    m_len = m -> nx_crypto_huge_number_size;
+
+    /* Set buffers. */
+    /* Buffer usage: (2 ^ window_bits + 4) * (buffer_size of m + 4), the work of the squares holds rr
+       first then the power selected from the table. */
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&work, scratch, (m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE)) << 1);
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp1, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp2, scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    for (i = 0; i < (1u << NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS); i++)
+    {
+        NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&table[i], scratch, m -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    }
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE_DIGIT(&digit, &digit_value, 1);
+
+    /* work = rr = radix ^ (2 * m_len) mod m, the setup uses the scratch of the table. */
+    _nx_crypto_huge_number_mont_setup(m, &mi, &work, (HN_UBASE *)table[0].nx_crypto_huge_number_data);
+
+    /* table[0] = radix ^ m_len mod m, the Montgomery form of 1, table[1] = xx = mont(x, rr),
+       table[i] = mont(table[i - 1], xx), each zero extended to m_len + 1 digits for the select. */
+    _nx_crypto_huge_number_mont(m, mi, &digit, &work, &table[0]);
+    _nx_crypto_huge_number_mont(m, mi, x, &work, &table[1]);
+    for (i = 2; i < (1u << NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS); i++)
+    {
+        _nx_crypto_huge_number_mont(m, mi, &table[i - 1], &table[1], &table[i]);
+    }
+    for (i = 0; i < (1u << NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS); i++)
+    {
+        NX_CRYPTO_MEMSET(table[i].nx_crypto_huge_number_data + table[i].nx_crypto_huge_number_size, 0,
+                         ((m_len + 1) - table[i].nx_crypto_huge_number_size) << HN_SIZE_SHIFT);
+    }
+
+    acc = &temp1;
+    prod = &temp2;
+    NX_CRYPTO_HUGE_NUMBER_COPY(acc, &table[0]);
+
+    /* Every digit of the exponent is scanned, its leading zero bits as well. */
+    exp_bits = e -> nx_crypto_huge_number_size * NX_CRYPTO_HUGE_NUMBER_BITS;
+    windows = (exp_bits + (NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS - 1)) / NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS;
+    while (windows > 0)
+    {
+        windows--;
+
+        window = 0;
+        for (i = NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS; i > 0; i--)
+        {
+
+            /* acc = mont(acc, acc) */
+            _nx_crypto_huge_number_mont_square(m, mi, acc, &work, acc);
+
+            bit = (windows * NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS) + (i - 1);
+            window <<= 1;
+            if (bit < exp_bits)
+            {
+                val = e -> nx_crypto_huge_number_data + (bit / NX_CRYPTO_HUGE_NUMBER_BITS);
+                window |= (UINT)((*val >> (bit % NX_CRYPTO_HUGE_NUMBER_BITS)) & 1);
+            }
+        }
+
+        /* work = table[window], every entry is read. The mask is all ones for the entry of the window only. */
+        NX_CRYPTO_MEMSET(work.nx_crypto_huge_number_data, 0, (m_len + 1) << HN_SIZE_SHIFT);
+        work.nx_crypto_huge_number_size = 0;
+        work.nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+        for (i = 0; i < (1u << NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS); i++)
+        {
+            size_mask = 0u - (((i ^ window) - 1u) >> 31);
+            mask = (HN_UBASE)size_mask;
+            for (j = 0; j <= m_len; j++)
+            {
+                work.nx_crypto_huge_number_data[j] |= (HN_UBASE)(table[i].nx_crypto_huge_number_data[j] & mask);
+            }
+            work.nx_crypto_huge_number_size |= (table[i].nx_crypto_huge_number_size & size_mask);
+        }
+
+        /* acc = mont(acc, table[window]) */
+        _nx_crypto_huge_number_mont(m, mi, acc, &work, prod);
+        swap = acc;
+        acc = prod;
+        prod = swap;
+    }
+
+    /* result = mont(acc, 1) */
+    _nx_crypto_huge_number_mont(m, mi, &digit, acc, result);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_huge_number_crt_power_precomputed        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function raises a huge number to the power of a private RSA    */
+/*    exponent with the Chinese Remainder Theorem, from the parameters    */
+/*    of the key rather than its exponent:                                */
+/*      m1 = x ^ dp mod p, m2 = x ^ dq mod q                              */
+/*      h = qinv * (m1 - m2) mod p                                        */
+/*      r = m2 + h * q                                                    */
+/*    dp, dq and qinv are d mod (p - 1), d mod (q - 1) and q ^ (-1) mod   */
+/*    p, the exponent1, exponent2 and coefficient of the PKCS#1 key. Both */
+/*    halves are raised with the fixed window exponentiation.             */
+/*                                                                        */
+/*    Requirement:                                                        */
+/*      1. x is less than p * q.                                          */
+/*      2. result holds x, it is also the buffer x is reduced in.         */
+/*      3. scratch is required to be no less than                         */
+/*         (2 ^ NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS + 6) times the buffer   */
+/*         size of p plus 4 bytes, p and q of the same buffer size.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    x                                     Number being exponentiated    */
+/*    dp                                    d mod (p - 1)                 */
+/*    dq                                    d mod (q - 1)                 */
+/*    qinv                                  q ^ (-1) mod p                */
+/*    p                                     Prime number p                */
+/*    q                                     Prime number q                */
+/*    result                                Result buffer                 */
+/*    scratch                               Buffer used to hold           */
+/*                                            intermediate data           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    NX_CRYPTO_HUGE_NUMBER_COPY            Copy huge number              */
+/*    NX_CRYPTO_HUGE_NUMBER_INITIALIZE      Initialize the buffer of      */
+/*                                            huge number                 */
+/*    _nx_crypto_huge_number_add            Calculate addition for        */
+/*                                            huge numbers                */
+/*    _nx_crypto_huge_number_add_unsigned   Calculate addition for        */
+/*                                            unsigned huge numbers       */
+/*    _nx_crypto_huge_number_compare_unsigned                             */
+/*                                          Compare two unsigned huge     */
+/*                                            numbers                     */
+/*    _nx_crypto_huge_number_subtract_unsigned                            */
+/*                                          Calculate subtraction for     */
+/*                                            unsigned huge numbers       */
+/*    _nx_crypto_huge_number_multiply       Multiply two huge numbers     */
+/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
+/*    _nx_crypto_huge_number_mont_power_fixed_window                      */
+/*                                          Raise a huge number with a    */
+/*                                            fixed window                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_rsa_crt_operation          Perform an RSA private key    */
+/*                                            operation with the CRT      */
+/*                                            parameters                  */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP VOID _nx_crypto_huge_number_crt_power_precomputed(NX_CRYPTO_HUGE_NUMBER *x,
+                                                                 NX_CRYPTO_HUGE_NUMBER *dp,
+                                                                 NX_CRYPTO_HUGE_NUMBER *dq,
+                                                                 NX_CRYPTO_HUGE_NUMBER *qinv,
+                                                                 NX_CRYPTO_HUGE_NUMBER *p,
+                                                                 NX_CRYPTO_HUGE_NUMBER *q,
+                                                                 NX_CRYPTO_HUGE_NUMBER *result,
+                                                                 HN_UBASE *scratch)
+{
+NX_CRYPTO_HUGE_NUMBER m1, m2, temp;
+
+    /* Buffer usage: 2 * (buffer_size of p + 4) */
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&m1, scratch, p -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&m2, scratch, q -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE));
+
+    /* m1 = (x mod p) ^ dp mod p, x is reduced in the result buffer. */
+    /* Buffer usage: (2 ^ window_bits + 4) * (buffer_size of p + 4) */
+    NX_CRYPTO_HUGE_NUMBER_COPY(result, x);
+    _nx_crypto_huge_number_modulus(result, p);
+    _nx_crypto_huge_number_mont_power_fixed_window(result, dp, p, &m1, scratch);
+
+    /* m2 = (x mod q) ^ dq mod q */
+    NX_CRYPTO_HUGE_NUMBER_COPY(result, x);
+    _nx_crypto_huge_number_modulus(result, q);
+    _nx_crypto_huge_number_mont_power_fixed_window(result, dq, q, &m2, scratch);
+
+    /* m1 = (m1 - m2) mod p, m1 gets p added first when it is less than m2 mod p. */
+    NX_CRYPTO_HUGE_NUMBER_COPY(result, &m2);
+    _nx_crypto_huge_number_modulus(result, p);
+    if (_nx_crypto_huge_number_compare_unsigned(&m1, result) == NX_CRYPTO_HUGE_NUMBER_LESS)
+    {
+        _nx_crypto_huge_number_add_unsigned(&m1, p);
+    }
+    _nx_crypto_huge_number_subtract_unsigned(&m1, result, &m1);
+
+    /* h = qinv * m1 mod p, its product is held in the scratch of the exponentiations. */
+    /* Buffer usage: 2 * (buffer_size of p + 4) */
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&temp, scratch, (p -> nx_crypto_huge_buffer_size + sizeof(HN_UBASE)) << 1);
+    _nx_crypto_huge_number_multiply(&m1, qinv, &temp);
+    _nx_crypto_huge_number_modulus(&temp, p);
+
+    /* r = m2 + h * q, less than p * q. */
+    _nx_crypto_huge_number_multiply(&temp, q, result);
+    _nx_crypto_huge_number_add(result, &m2);
+}
+
@@ -38,6 +38,7 @@
 #include "nx_crypto_hmac_sha5.h"
 #include "nx_crypto_hmac_md5.h"
 #include "nx_crypto_aes.h"
+#include "nx_crypto_chacha20_poly1305.h"
 #include "nx_crypto_rsa.h"
 #include "nx_crypto_null.h"
 #include "nx_crypto_ecjpake.h"
@@ -45,6 +46,10 @@
 #include "nx_crypto_ecdh.h"
 #include "nx_crypto_drbg.h"
 #include "nx_crypto_pkcs1_v1.5.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_crypto_hmac.h"
+#include "nx_stm32_crypto_driver.h"
+#endif /* NX_CRYPTO_STM32_HW */
 
 /**************************************************************************/
 /*                                                                        */
@@ -219,6 +224,20 @@ NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16 =
     _nx_crypto_method_aes_gcm_operation,         /* AES-GCM operation                      */
 };
 
+/* Declare the ChaCha20-Poly1305 encrytion method. */
+NX_CRYPTO_METHOD crypto_method_chacha20_poly1305 =
+{
+    NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305,      /* ChaCha20-Poly1305 crypto algorithm     */
+    NX_CRYPTO_CHACHA20_KEY_LEN_IN_BITS,          /* Key size in bits                       */
+    (NX_CRYPTO_CHACHA20_NONCE_SIZE << 3),        /* IV size in bits                        */
+    (NX_CRYPTO_POLY1305_TAG_SIZE << 3),          /* ICV size in bits                       */
+    NX_CRYPTO_CHACHA20_BLOCK_SIZE,               /* Block size in bytes.                   */
+    sizeof(NX_CRYPTO_CHACHA20_POLY1305),         /* Metadata size in bytes                 */
+    _nx_crypto_method_chacha20_poly1305_init,    /* ChaCha20-Poly1305 initialization.      */
+    _nx_crypto_method_chacha20_poly1305_cleanup, /* ChaCha20-Poly1305 cleanup routine.     */
+    _nx_crypto_method_chacha20_poly1305_operation, /* ChaCha20-Poly1305 operation          */
+};
+
 /* Declare the AES-XCBC-MAC encrytion method. */
 NX_CRYPTO_METHOD crypto_method_aes_xcbc_mac_96 =
 {
@@ -513,6 +532,22 @@ NX_CRYPTO_METHOD crypto_method_ec_secp521 =
     _nx_crypto_method_ec_secp521r1_operation, /* Operation                              */
 };
 
+#ifdef NX_CRYPTO_ENABLE_X25519
+/* Declare a placeholder for X25519. */
+NX_CRYPTO_METHOD crypto_method_ec_x25519 =
+{
+    NX_CRYPTO_EC_X25519,                      /* EC placeholder                         */
+    255,                                      /* Key size in bits                       */
+    0,                                        /* IV size in bits                        */
+    0,                                        /* ICV size in bits, not used.            */
+    0,                                        /* Block size in bytes.                   */
+    0,                                        /* Metadata size in bytes                 */
+    NX_CRYPTO_NULL,                           /* Initialization routine.                */
+    NX_CRYPTO_NULL,                           /* Cleanup routine, not used.             */
+    _nx_crypto_method_ec_x25519_operation,    /* Operation                              */
+};
+#endif /* NX_CRYPTO_ENABLE_X25519 */
+
 /* Declare the public NULL cipher (not to be confused with the NULL methods above). This
  * is used as a placeholder in ciphersuites that do not use a cipher method for a
  * particular operation (e.g. some PSK ciphersuites don't use a public-key algorithm
@@ -774,3 +809,148 @@ NX_CRYPTO_METHOD crypto_method_pkcs1 =
     _nx_crypto_method_pkcs1_v1_5_cleanup,        /* PKCS#1v1.5 cleanup routine             */
     _nx_crypto_method_pkcs1_v1_5_operation       /* PKCS#1v1.5 operation                   */
 };
+
+#ifdef NX_CRYPTO_STM32_HW
+/* The methods over the CRYP and HASH peripherals of the STM32F4x7/F4x9, nx_stm32_crypto_driver.c.
+   Each runs in software when the peripheral is not available to the caller.  */
+
+/* Declare the AES-CBC 128 encryption method over the CRYP peripheral. */
+NX_CRYPTO_METHOD crypto_method_aes_cbc_128_stm32 =
+{
+    NX_CRYPTO_ENCRYPTION_AES_CBC,                /* AES crypto algorithm                  */
+    NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,           /* Key size in bits                      */
+    NX_CRYPTO_AES_IV_LEN_IN_BITS,                /* IV size in bits                       */
+    0,                                           /* ICV size in bits, not used            */
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),     /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_AES),                       /* Metadata size in bytes                */
+    _nx_crypto_method_aes_init,                  /* AES-CBC initialization routine        */
+    _nx_crypto_method_aes_cleanup,               /* AES-CBC cleanup routine               */
+    _nx_crypto_method_stm32_aes_cbc_operation    /* AES-CBC operation in the CRYP         */
+};
+
+/* Declare the AES-CBC 256 encryption method over the CRYP peripheral. */
+NX_CRYPTO_METHOD crypto_method_aes_cbc_256_stm32 =
+{
+    NX_CRYPTO_ENCRYPTION_AES_CBC,                /* AES crypto algorithm                  */
+    NX_CRYPTO_AES_256_KEY_LEN_IN_BITS,           /* Key size in bits                      */
+    NX_CRYPTO_AES_IV_LEN_IN_BITS,                /* IV size in bits                       */
+    0,                                           /* ICV size in bits, not used            */
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),     /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_AES),                       /* Metadata size in bytes                */
+    _nx_crypto_method_aes_init,                  /* AES-CBC initialization routine        */
+    _nx_crypto_method_aes_cleanup,               /* AES-CBC cleanup routine               */
+    _nx_crypto_method_stm32_aes_cbc_operation    /* AES-CBC operation in the CRYP         */
+};
+
+/* Declare the AES-GCM encryption method over the CRYP peripheral, GHASH in software. */
+NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16_stm32 =
+{
+    NX_CRYPTO_ENCRYPTION_AES_GCM_16,             /* AES crypto algorithm                  */
+    NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,           /* Key size in bits                      */
+    32,                                          /* IV size in bits                       */
+    128,                                         /* ICV size in bits                      */
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),     /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_AES),                       /* Metadata size in bytes                */
+    _nx_crypto_method_aes_init,                  /* AES-GCM initialization routine        */
+    _nx_crypto_method_aes_cleanup,               /* AES-GCM cleanup routine               */
+    _nx_crypto_method_stm32_aes_gcm_operation    /* AES-GCM operation in the CRYP         */
+};
+
+/* Declare the AES-GCM encryption method over the CRYP peripheral, GHASH in software. */
+NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16_stm32 =
+{
+    NX_CRYPTO_ENCRYPTION_AES_GCM_16,             /* AES crypto algorithm                  */
+    NX_CRYPTO_AES_256_KEY_LEN_IN_BITS,           /* Key size in bits                      */
+    32,                                          /* IV size in bits                       */
+    128,                                         /* ICV size in bits                      */
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),     /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_AES),                       /* Metadata size in bytes                */
+    _nx_crypto_method_aes_init,                  /* AES-GCM initialization routine        */
+    _nx_crypto_method_aes_cleanup,               /* AES-GCM cleanup routine               */
+    _nx_crypto_method_stm32_aes_gcm_operation    /* AES-GCM operation in the CRYP         */
+};
+
+/* Declare the AES-CTR 128 encryption method over the CRYP peripheral, its nonce after the key. */
+NX_CRYPTO_METHOD crypto_method_aes_ctr_128_stm32 =
+{
+    NX_CRYPTO_ENCRYPTION_AES_CTR,                /* AES crypto algorithm                  */
+    NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,           /* Key size in bits                      */
+    64,                                          /* IV size in bits                       */
+    0,                                           /* ICV size in bits, not used            */
+    (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),     /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_AES),                       /* Metadata size in bytes                */
+    _nx_crypto_method_aes_init,                  /* AES-CTR initialization routine        */
+    _nx_crypto_method_aes_cleanup,               /* AES-CTR cleanup routine               */
+    _nx_crypto_method_stm32_aes_ctr_operation    /* AES-CTR operation in the CRYP         */
+};
+
+/* Declare the SHA1 hash method over the HASH peripheral. */
+NX_CRYPTO_METHOD crypto_method_sha1_stm32 =
+{
+    NX_CRYPTO_HASH_SHA1,                         /* SHA1 algorithm                        */
+    0,                                           /* Key size in bits                      */
+    0,                                           /* IV size in bits, not used             */
+    NX_CRYPTO_SHA1_ICV_LEN_IN_BITS,              /* Transmitted ICV size in bits          */
+    NX_CRYPTO_SHA1_BLOCK_SIZE_IN_BYTES,          /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_STM32_HASH),                /* Metadata size in bytes                */
+    _nx_crypto_method_stm32_sha_init,            /* SHA1 initialization routine           */
+    _nx_crypto_method_stm32_sha_cleanup,         /* SHA1 cleanup routine                  */
+    _nx_crypto_method_stm32_sha_operation        /* SHA1 operation in the HASH            */
+};
+
+/* Declare the SHA224 hash method over the HASH peripheral. */
+NX_CRYPTO_METHOD crypto_method_sha224_stm32 =
+{
+    NX_CRYPTO_HASH_SHA224,                       /* SHA224 algorithm                      */
+    0,                                           /* Key size in bits                      */
+    0,                                           /* IV size in bits, not used             */
+    NX_CRYPTO_SHA224_ICV_LEN_IN_BITS,            /* Transmitted ICV size in bits          */
+    NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES,          /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_STM32_HASH),                /* Metadata size in bytes                */
+    _nx_crypto_method_stm32_sha_init,            /* SHA224 initialization routine         */
+    _nx_crypto_method_stm32_sha_cleanup,         /* SHA224 cleanup routine                */
+    _nx_crypto_method_stm32_sha_operation        /* SHA224 operation in the HASH          */
+};
+
+/* Declare the SHA256 hash method over the HASH peripheral. */
+NX_CRYPTO_METHOD crypto_method_sha256_stm32 =
+{
+    NX_CRYPTO_HASH_SHA256,                       /* SHA256 algorithm                      */
+    0,                                           /* Key size in bits                      */
+    0,                                           /* IV size in bits, not used             */
+    NX_CRYPTO_SHA256_ICV_LEN_IN_BITS,            /* Transmitted ICV size in bits          */
+    NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES,          /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_STM32_HASH),                /* Metadata size in bytes                */
+    _nx_crypto_method_stm32_sha_init,            /* SHA256 initialization routine         */
+    _nx_crypto_method_stm32_sha_cleanup,         /* SHA256 cleanup routine                */
+    _nx_crypto_method_stm32_sha_operation        /* SHA256 operation in the HASH          */
+};
+
+/* Declare the HMAC SHA1 authentication method, the generic HMAC over the HASH peripheral. */
+NX_CRYPTO_METHOD crypto_method_hmac_sha1_stm32 =
+{
+    NX_CRYPTO_AUTHENTICATION_HMAC_SHA1_160,      /* HMAC SHA1 algorithm                   */
+    0,                                           /* Key size in bits                      */
+    0,                                           /* IV size in bits, not used             */
+    NX_CRYPTO_HMAC_SHA1_ICV_FULL_LEN_IN_BITS,    /* Transmitted ICV size in bits          */
+    NX_CRYPTO_SHA1_BLOCK_SIZE_IN_BYTES,          /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_HMAC) + sizeof(NX_CRYPTO_STM32_HASH),/* Metadata size in bytes                */
+    _nx_crypto_method_hmac_init,                 /* HMAC SHA1 initialization routine      */
+    _nx_crypto_method_hmac_cleanup,              /* HMAC SHA1 cleanup routine             */
+    _nx_crypto_method_stm32_hmac_operation       /* HMAC SHA1 operation in the HASH       */
+};
+
+/* Declare the HMAC SHA256 authentication method, the generic HMAC over the HASH peripheral. */
+NX_CRYPTO_METHOD crypto_method_hmac_sha256_stm32 =
+{
+    NX_CRYPTO_AUTHENTICATION_HMAC_SHA2_256,      /* HMAC SHA256 algorithm                 */
+    0,                                           /* Key size in bits                      */
+    0,                                           /* IV size in bits, not used             */
+    NX_CRYPTO_HMAC_SHA256_ICV_FULL_LEN_IN_BITS,  /* Transmitted ICV size in bits          */
+    NX_CRYPTO_SHA2_BLOCK_SIZE_IN_BYTES,          /* Block size in bytes                   */
+    sizeof(NX_CRYPTO_HMAC) + sizeof(NX_CRYPTO_STM32_HASH),/* Metadata size in bytes                */
+    _nx_crypto_method_hmac_init,                 /* HMAC SHA256 initialization routine    */
+    _nx_crypto_method_hmac_cleanup,              /* HMAC SHA256 cleanup routine           */
+    _nx_crypto_method_stm32_hmac_operation       /* HMAC SHA256 operation in the HASH     */
+};
+#endif /* NX_CRYPTO_STM32_HW */
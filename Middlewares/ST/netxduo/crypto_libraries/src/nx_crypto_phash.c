@@ -222,14 +222,11 @@ NX_CRYPTO_METHOD *hash_method = phash -> nx_crypto_hmac_method;
 
         /* Adjust our remaining length by the number of bytes written. */
         remaining_len -= hash_size;
-
-        status = hash_method -> nx_crypto_cleanup(metadata);
-
-        if(status != NX_CRYPTO_SUCCESS)
-        {
-            return(status);
-        }                                                     
     }
 
-    return(NX_CRYPTO_SUCCESS);
+    /* Clean up once all blocks are generated, the HMAC method may keep the states derived from the
+       secret in its metadata between the blocks. */
+    status = hash_method -> nx_crypto_cleanup(metadata);
+
+    return(status);
 }
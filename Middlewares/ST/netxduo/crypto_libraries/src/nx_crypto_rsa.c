@@ -23,6 +23,14 @@
 #include "nx_crypto_rsa.h"
 #include "nx_crypto_huge_number.h"
 
+#if NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0
+static NX_CRYPTO_RSA_MONT_CACHE_ENTRY _nx_crypto_rsa_mont_cache[NX_CRYPTO_RSA_MONT_CACHE_SIZE];
+static UINT _nx_crypto_rsa_mont_cache_use_count;
+
+static VOID _nx_crypto_rsa_mont_setup(NX_CRYPTO_HUGE_NUMBER *modulus, UINT *mi,
+                                      NX_CRYPTO_HUGE_NUMBER *rr, HN_UBASE *scratch);
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0 */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -72,6 +80,11 @@
 /*    _nx_crypto_huge_number_mont_power_modulus                           */
 /*                                          Raise a huge number for       */
 /*                                            montgomery reduction        */
+/*    _nx_crypto_huge_number_mont_power_precomputed                       */
+/*                                          Raise a huge number with the  */
+/*                                            Montgomery constants        */
+/*    _nx_crypto_rsa_mont_setup             Get the Montgomery constants  */
+/*                                            of a public modulus         */
 /*    _nx_crypto_huge_number_extract        Extract huge number           */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -95,9 +108,15 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_rsa_operation(const UCHAR *exponent, UINT expone
 UCHAR                *scratch;
 UINT                  mod_length;
 NX_CRYPTO_HUGE_NUMBER modulus_hn, exponent_hn, input_hn, output_hn, p_hn, q_hn;
+#if NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0
+UINT                  mi;
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0 */
+CYCLE_PROFILE_SAVE_AREA
 
     NX_CRYPTO_PARAMETER_NOT_USED(scratch_buf_length);
 
+    CYCLE_PROFILE_ENTER
+
     /* The RSA operation is reversible so both encryption and decryption can be done with the same operation. */
     /* Local pointer for pointer arithmetic. */
     scratch = (UCHAR *)scratch_buf_ptr;
@@ -159,16 +178,344 @@ NX_CRYPTO_HUGE_NUMBER modulus_hn, exponent_hn, input_hn, output_hn, p_hn, q_hn;
         /* Finally, generate shared secret from the remote public key, our generated private key, and the modulus, modulus.
            The actual calculation is "shared_secret = (public_key**private_key) % modulus"
            where the "**" denotes exponentiation. */
+#if NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0
+
+        /* The output buffer holds radix ^ (2 * m_len) mod m until the exponentiation turns it into xx. */
+        _nx_crypto_rsa_mont_setup(&modulus_hn, &mi, &output_hn, (HN_UBASE *)scratch);
+        _nx_crypto_huge_number_mont_power_precomputed(&input_hn, &exponent_hn, &modulus_hn, mi,
+                                                      &output_hn, &output_hn, (HN_UBASE *)scratch);
+#else
         _nx_crypto_huge_number_mont_power_modulus(&input_hn, &exponent_hn, &modulus_hn,
                                                   &output_hn, (HN_UBASE *)scratch);
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0 */
     }
 
     /* Copy the shared secret into the return buffer. */
     _nx_crypto_huge_number_extract(&output_hn, output, modulus_length, &mod_length);
 
+    CYCLE_PROFILE_EXIT(CYCLE_PROFILE_RSA)
+
     return(NX_CRYPTO_SUCCESS);
 }
 
+#if NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_rsa_mont_setup                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function gets the Montgomery constants of a public modulus,    */
+/*    from the cache when the modulus was used last by one of the         */
+/*    NX_CRYPTO_RSA_MONT_CACHE_SIZE latest keys. Otherwise they are       */
+/*    computed and replace the entry of the key used least recently.      */
+/*    Moduli over NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE bits are not      */
+/*    cached.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    modulus                               RSA modulus                   */
+/*    mi                                    Pointer to mi                 */
+/*    rr                                    Huge number rr                */
+/*    scratch                               Buffer used to hold           */
+/*                                            intermediate data           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_huge_number_adjust_size    Adjust the size of a huge     */
+/*                                            number to remove leading    */
+/*                                            zeroes                      */
+/*    _nx_crypto_huge_number_mont_setup     Compute the Montgomery        */
+/*                                            constants of a modulus      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_rsa_operation              Perform an RSA operation      */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_crypto_rsa_mont_setup(NX_CRYPTO_HUGE_NUMBER *modulus, UINT *mi,
+                                      NX_CRYPTO_HUGE_NUMBER *rr, HN_UBASE *scratch)
+{
+NX_CRYPTO_RSA_MONT_CACHE_SAVE_AREA
+NX_CRYPTO_RSA_MONT_CACHE_ENTRY *entry;
+UINT                            modulus_size;
+UINT                            age, oldest_age;
+UINT                            i;
+
+    _nx_crypto_huge_number_adjust_size(modulus);
+    modulus_size = modulus -> nx_crypto_huge_number_size;
+
+    if (modulus_size > (NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE / NX_CRYPTO_HUGE_NUMBER_BITS))
+    {
+        _nx_crypto_huge_number_mont_setup(modulus, mi, rr, scratch);
+        return;
+    }
+
+    NX_CRYPTO_RSA_MONT_CACHE_LOCK
+
+    /* Look for the modulus, digit for digit. */
+    for (i = 0; i < NX_CRYPTO_RSA_MONT_CACHE_SIZE; i++)
+    {
+        entry = &_nx_crypto_rsa_mont_cache[i];
+        if ((entry -> nx_crypto_rsa_mont_cache_modulus_size == modulus_size) &&
+            (NX_CRYPTO_MEMCMP(entry -> nx_crypto_rsa_mont_cache_modulus, modulus -> nx_crypto_huge_number_data,
+                              modulus_size << HN_SIZE_SHIFT) == 0))
+        {
+            *mi = entry -> nx_crypto_rsa_mont_cache_mi;
+            NX_CRYPTO_MEMCPY(rr -> nx_crypto_huge_number_data, entry -> nx_crypto_rsa_mont_cache_rr,
+                             entry -> nx_crypto_rsa_mont_cache_rr_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+            rr -> nx_crypto_huge_number_size = entry -> nx_crypto_rsa_mont_cache_rr_size;
+            rr -> nx_crypto_huge_number_is_negative = NX_CRYPTO_FALSE;
+            entry -> nx_crypto_rsa_mont_cache_last_used = ++_nx_crypto_rsa_mont_cache_use_count;
+
+            NX_CRYPTO_RSA_MONT_CACHE_UNLOCK
+            return;
+        }
+    }
+
+    NX_CRYPTO_RSA_MONT_CACHE_UNLOCK
+
+    /* Not cached, computed with interrupts enabled. */
+    _nx_crypto_huge_number_mont_setup(modulus, mi, rr, scratch);
+
+    NX_CRYPTO_RSA_MONT_CACHE_LOCK
+
+    /* Replace a free entry, else the one used least recently. The use count wraps, the oldest
+       entry is the one whose last use is the furthest behind it. */
+    entry = &_nx_crypto_rsa_mont_cache[0];
+    oldest_age = 0;
+    for (i = 0; i < NX_CRYPTO_RSA_MONT_CACHE_SIZE; i++)
+    {
+        if (_nx_crypto_rsa_mont_cache[i].nx_crypto_rsa_mont_cache_modulus_size == 0)
+        {
+            entry = &_nx_crypto_rsa_mont_cache[i];
+            break;
+        }
+
+        age = _nx_crypto_rsa_mont_cache_use_count - _nx_crypto_rsa_mont_cache[i].nx_crypto_rsa_mont_cache_last_used;
+        if (age >= oldest_age)
+        {
+            oldest_age = age;
+            entry = &_nx_crypto_rsa_mont_cache[i];
+        }
+    }
+
+    entry -> nx_crypto_rsa_mont_cache_modulus_size = modulus_size;
+    entry -> nx_crypto_rsa_mont_cache_rr_size = rr -> nx_crypto_huge_number_size;
+    entry -> nx_crypto_rsa_mont_cache_mi = *mi;
+    entry -> nx_crypto_rsa_mont_cache_last_used = ++_nx_crypto_rsa_mont_cache_use_count;
+    NX_CRYPTO_MEMCPY(entry -> nx_crypto_rsa_mont_cache_modulus, modulus -> nx_crypto_huge_number_data,
+                     modulus_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+    NX_CRYPTO_MEMCPY(entry -> nx_crypto_rsa_mont_cache_rr, rr -> nx_crypto_huge_number_data,
+                     rr -> nx_crypto_huge_number_size << HN_SIZE_SHIFT); /* Use case of memcpy is verified. */
+
+    NX_CRYPTO_RSA_MONT_CACHE_UNLOCK
+}
+#endif /* NX_CRYPTO_RSA_MONT_CACHE_SIZE > 0 */
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_crypto_rsa_crt_operation                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs the RSA operation of a private key with the  */
+/*    Chinese Remainder Theorem, from the d mod (p - 1), d mod (q - 1)    */
+/*    and q ^ (-1) mod p of the key rather than its private exponent.     */
+/*    Both halves are raised with a fixed window, so that the sequence    */
+/*    of the operations does not depend on the key. With the public       */
+/*    exponent e set, the input is blinded first by r ^ e for a random    */
+/*    r, the result unblinded by r ^ (-1). Parameters longer than half    */
+/*    the modulus fall back to _nx_crypto_rsa_operation with the primes.  */
+/*                                                                        */
+/*    Buffer layout in the scratch buffer of the context, M the modulus   */
+/*    size: modulus then p and q (M), result (M), input (M), r ^ (-1)     */
+/*    (M), then dp, dq and qinv (1.5 M) and the scratch of the CRT.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ctx                                   RSA context with the key      */
+/*    exponent                              Private exponent, used by the */
+/*                                            fall back only              */
+/*    exponent_length                       Length of exponent in bytes   */
+/*    input                                 Input stream                  */
+/*    input_length                          Length of input in byte       */
+/*    output                                Output stream                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_crypto_huge_number_setup          Setup huge number             */
+/*    _nx_crypto_huge_number_rbg            Generate random huge number   */
+/*    _nx_crypto_huge_number_modulus        Perform a modulus operation   */
+/*    _nx_crypto_huge_number_inverse_modulus                              */
+/*                                          Perform an inverse modulus    */
+/*                                            operation                   */
+/*    _nx_crypto_huge_number_mont_power_modulus                           */
+/*                                          Raise a huge number for       */
+/*                                            montgomery reduction        */
+/*    _nx_crypto_huge_number_multiply       Multiply two huge numbers     */
+/*    _nx_crypto_huge_number_crt_power_precomputed                        */
+/*                                          Raise a huge number with the  */
+/*                                            CRT parameters of a key     */
+/*    _nx_crypto_huge_number_extract        Extract huge number           */
+/*    _nx_crypto_rsa_operation              Perform an RSA operation      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_crypto_method_rsa_operation       Handle RSA operation          */
+/*                                                                        */
+/**************************************************************************/
+NX_CRYPTO_KEEP UINT  _nx_crypto_rsa_crt_operation(NX_CRYPTO_RSA *ctx, const UCHAR *exponent, UINT exponent_length,
+                                                  const UCHAR *input, UINT input_length, UCHAR *output)
+{
+UCHAR                *scratch;
+UINT                  modulus_length = ctx -> nx_crypto_rsa_modulus_length;
+UINT                  half_length = modulus_length >> 1;
+UINT                  mod_length;
+NX_CRYPTO_HUGE_NUMBER modulus_hn, input_hn, output_hn, inverse_hn;
+NX_CRYPTO_HUGE_NUMBER p_hn, q_hn, dp_hn, dq_hn, qinv_hn;
+NX_CRYPTO_HUGE_NUMBER exponent_hn, power_hn, product_hn;
+CYCLE_PROFILE_SAVE_AREA
+
+    if (((modulus_length & 7) != 0) ||
+        (ctx -> nx_crypto_rsa_prime_p_length > half_length) ||
+        (ctx -> nx_crypto_rsa_prime_q_length > half_length) ||
+        (ctx -> nx_crypto_rsa_crt_exponent_p_length > half_length) ||
+        (ctx -> nx_crypto_rsa_crt_exponent_q_length > half_length) ||
+        (ctx -> nx_crypto_rsa_crt_coefficient_length > half_length) ||
+        (ctx -> nx_crypto_rsa_public_exponent_length > modulus_length))
+    {
+
+        /* Parameters out of the layout below, the primes alone are used. */
+        return(_nx_crypto_rsa_operation(exponent, exponent_length, ctx -> nx_crypto_rsa_modulus, modulus_length,
+                                        ctx -> nx_crypto_rsa_prime_p, ctx -> nx_crypto_rsa_prime_p_length,
+                                        ctx -> nx_crypto_rsa_prime_q, ctx -> nx_crypto_rsa_prime_q_length,
+                                        input, input_length, output,
+                                        ctx -> nx_crypto_rsa_scratch_buffer, NX_CRYPTO_RSA_SCRATCH_BUFFER_SIZE));
+    }
+
+    CYCLE_PROFILE_ENTER
+
+    scratch = (UCHAR *)ctx -> nx_crypto_rsa_scratch_buffer;
+
+    /* Modulus, then the primes in its buffer once the input is blinded. */
+    modulus_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    modulus_hn.nx_crypto_huge_buffer_size = modulus_length;
+    p_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    p_hn.nx_crypto_huge_buffer_size = half_length;
+    q_hn.nx_crypto_huge_number_data = (HN_UBASE *)(scratch + half_length);
+    q_hn.nx_crypto_huge_buffer_size = half_length;
+    scratch += modulus_length;
+
+    /* Output buffer, the input is reduced in it by the CRT. */
+    output_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += modulus_length;
+    output_hn.nx_crypto_huge_buffer_size = modulus_length;
+
+    /* Input buffer. */
+    input_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += modulus_length;
+    input_hn.nx_crypto_huge_buffer_size = modulus_length;
+
+    /* r ^ (-1) mod n */
+    inverse_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += modulus_length;
+    inverse_hn.nx_crypto_huge_buffer_size = modulus_length;
+
+    _nx_crypto_huge_number_setup(&modulus_hn, ctx -> nx_crypto_rsa_modulus, modulus_length);
+    _nx_crypto_huge_number_setup(&input_hn, input, input_length);
+
+    if (ctx -> nx_crypto_rsa_public_exponent != NX_CRYPTO_NULL)
+    {
+
+        /* r, a random number less than n, in the output buffer. Its bytes are taken in the scratch. */
+        _nx_crypto_huge_number_rbg(modulus_length << 3, scratch);
+        _nx_crypto_huge_number_setup(&output_hn, scratch, modulus_length);
+        _nx_crypto_huge_number_modulus(&output_hn, &modulus_hn);
+
+        /* Buffer usage: 6 * (sizeof(modulus) + 4) */
+        if (_nx_crypto_huge_number_inverse_modulus(&output_hn, &modulus_hn, &inverse_hn,
+                                                   (HN_UBASE *)scratch) != NX_CRYPTO_SUCCESS)
+        {
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_RSA)
+            return(NX_CRYPTO_NOT_SUCCESSFUL);
+        }
+
+        /* r ^ e mod n */
+        exponent_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+        exponent_hn.nx_crypto_huge_buffer_size = modulus_length;
+        power_hn.nx_crypto_huge_number_data = (HN_UBASE *)(scratch + modulus_length);
+        power_hn.nx_crypto_huge_buffer_size = modulus_length * 2;
+        product_hn.nx_crypto_huge_number_data = (HN_UBASE *)(scratch + (modulus_length * 3));
+        product_hn.nx_crypto_huge_buffer_size = modulus_length * 2;
+        _nx_crypto_huge_number_setup(&exponent_hn, ctx -> nx_crypto_rsa_public_exponent,
+                                     ctx -> nx_crypto_rsa_public_exponent_length);
+        _nx_crypto_huge_number_mont_power_modulus(&output_hn, &exponent_hn, &modulus_hn, &power_hn,
+                                                  (HN_UBASE *)(scratch + (modulus_length * 3)));
+
+        /* x = x * r ^ e mod n */
+        _nx_crypto_huge_number_multiply(&input_hn, &power_hn, &product_hn);
+        _nx_crypto_huge_number_modulus(&product_hn, &modulus_hn);
+        NX_CRYPTO_HUGE_NUMBER_COPY(&input_hn, &product_hn);
+    }
+
+    /* Copy the primes and the CRT parameters from the key. */
+    _nx_crypto_huge_number_setup(&p_hn, ctx -> nx_crypto_rsa_prime_p, ctx -> nx_crypto_rsa_prime_p_length);
+    _nx_crypto_huge_number_setup(&q_hn, ctx -> nx_crypto_rsa_prime_q, ctx -> nx_crypto_rsa_prime_q_length);
+
+    dp_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += half_length;
+    dp_hn.nx_crypto_huge_buffer_size = half_length;
+
+    dq_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += half_length;
+    dq_hn.nx_crypto_huge_buffer_size = half_length;
+
+    qinv_hn.nx_crypto_huge_number_data = (HN_UBASE *)scratch;
+    scratch += half_length;
+    qinv_hn.nx_crypto_huge_buffer_size = half_length;
+
+    _nx_crypto_huge_number_setup(&dp_hn, ctx -> nx_crypto_rsa_crt_exponent_p, ctx -> nx_crypto_rsa_crt_exponent_p_length);
+    _nx_crypto_huge_number_setup(&dq_hn, ctx -> nx_crypto_rsa_crt_exponent_q, ctx -> nx_crypto_rsa_crt_exponent_q_length);
+    _nx_crypto_huge_number_setup(&qinv_hn, ctx -> nx_crypto_rsa_crt_coefficient, ctx -> nx_crypto_rsa_crt_coefficient_length);
+
+    /* Buffer usage: (2 ^ NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS + 6) * (sizeof(modulus) / 2 + 4) */
+    _nx_crypto_huge_number_crt_power_precomputed(&input_hn, &dp_hn, &dq_hn, &qinv_hn, &p_hn, &q_hn,
+                                                 &output_hn, (HN_UBASE *)scratch);
+
+    if (ctx -> nx_crypto_rsa_public_exponent != NX_CRYPTO_NULL)
+    {
+
+        /* y = y * r ^ (-1) mod n, the modulus back in place of the primes. */
+        product_hn.nx_crypto_huge_number_data = inverse_hn.nx_crypto_huge_number_data + (modulus_length >> HN_SIZE_SHIFT);
+        product_hn.nx_crypto_huge_buffer_size = modulus_length * 2;
+        _nx_crypto_huge_number_setup(&modulus_hn, ctx -> nx_crypto_rsa_modulus, modulus_length);
+        _nx_crypto_huge_number_multiply(&output_hn, &inverse_hn, &product_hn);
+        _nx_crypto_huge_number_modulus(&product_hn, &modulus_hn);
+        NX_CRYPTO_HUGE_NUMBER_COPY(&output_hn, &product_hn);
+    }
+
+    /* Copy the result into the return buffer. */
+    _nx_crypto_huge_number_extract(&output_hn, output, modulus_length, &mod_length);
+
+    CYCLE_PROFILE_EXIT(CYCLE_PROFILE_RSA)
+
+    return(NX_CRYPTO_SUCCESS);
+}
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -249,9 +596,18 @@ NX_CRYPTO_RSA *ctx;
     ctx -> nx_crypto_rsa_prime_p_length = 0;
     ctx -> nx_crypto_rsa_prime_q = NX_CRYPTO_NULL;
     ctx -> nx_crypto_rsa_prime_q_length = 0;
+    ctx -> nx_crypto_rsa_crt_exponent_p = NX_CRYPTO_NULL;
+    ctx -> nx_crypto_rsa_crt_exponent_p_length = 0;
+    ctx -> nx_crypto_rsa_crt_exponent_q = NX_CRYPTO_NULL;
+    ctx -> nx_crypto_rsa_crt_exponent_q_length = 0;
+    ctx -> nx_crypto_rsa_crt_coefficient = NX_CRYPTO_NULL;
+    ctx -> nx_crypto_rsa_crt_coefficient_length = 0;
+    ctx -> nx_crypto_rsa_public_exponent = NX_CRYPTO_NULL;
+    ctx -> nx_crypto_rsa_public_exponent_length = 0;
 
     /* Call _nx_crypto_crypto_rsa_set_prime() to set p and q for private key.
-     * Chinese Remainder Theorem will be used when p and q are set. */
+     * Chinese Remainder Theorem will be used when p and q are set. With d mod (p - 1),
+     * d mod (q - 1) and q ^ (-1) mod p set as well, they are not computed by each operation. */
 
     return(NX_CRYPTO_SUCCESS);
 }
@@ -354,6 +710,9 @@ NX_CRYPTO_KEEP UINT  _nx_crypto_method_rsa_cleanup(VOID *crypto_metadata)
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_crypto_rsa_operation              Perform RSA operation         */
+/*    _nx_crypto_rsa_crt_operation          Perform an RSA private key    */
+/*                                            operation with the CRT      */
+/*                                            parameters                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -418,6 +777,26 @@ UINT           return_value = NX_CRYPTO_SUCCESS;
         ctx -> nx_crypto_rsa_prime_q = input;
         ctx -> nx_crypto_rsa_prime_q_length = input_length_in_byte;
     }
+    else if (op == NX_CRYPTO_SET_CRT_EXPONENT_P)
+    {
+        ctx -> nx_crypto_rsa_crt_exponent_p = input;
+        ctx -> nx_crypto_rsa_crt_exponent_p_length = input_length_in_byte;
+    }
+    else if (op == NX_CRYPTO_SET_CRT_EXPONENT_Q)
+    {
+        ctx -> nx_crypto_rsa_crt_exponent_q = input;
+        ctx -> nx_crypto_rsa_crt_exponent_q_length = input_length_in_byte;
+    }
+    else if (op == NX_CRYPTO_SET_CRT_COEFFICIENT)
+    {
+        ctx -> nx_crypto_rsa_crt_coefficient = input;
+        ctx -> nx_crypto_rsa_crt_coefficient_length = input_length_in_byte;
+    }
+    else if (op == NX_CRYPTO_SET_PUBLIC_EXPONENT)
+    {
+        ctx -> nx_crypto_rsa_public_exponent = input;
+        ctx -> nx_crypto_rsa_public_exponent_length = input_length_in_byte;
+    }
     else
     {
 
@@ -434,6 +813,15 @@ UINT           return_value = NX_CRYPTO_SUCCESS;
             return(NX_CRYPTO_PTR_ERROR);
         }
 
+        /* The private key operations with all the CRT parameters of the key do not use its exponent. */
+        if ((ctx -> nx_crypto_rsa_prime_p != NX_CRYPTO_NULL) && (ctx -> nx_crypto_rsa_prime_q != NX_CRYPTO_NULL) &&
+            (ctx -> nx_crypto_rsa_crt_exponent_p != NX_CRYPTO_NULL) &&
+            (ctx -> nx_crypto_rsa_crt_exponent_q != NX_CRYPTO_NULL) &&
+            (ctx -> nx_crypto_rsa_crt_coefficient != NX_CRYPTO_NULL))
+        {
+            return(_nx_crypto_rsa_crt_operation(ctx, key, key_size_in_bits >> 3, input, input_length_in_byte, output));
+        }
+
         return_value = _nx_crypto_rsa_operation(key,
                                                 key_size_in_bits >> 3,
                                                 ctx -> nx_crypto_rsa_modulus,
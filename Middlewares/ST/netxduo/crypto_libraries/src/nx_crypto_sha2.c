@@ -38,7 +38,7 @@ const ULONG _sha2_round_constants[64] =
 
 /* Define the SHA2 logic functions.  */
 #define CH_FUNC(x, y, z)           (((x) & (y)) ^ ((~(x)) & (z)))
-#define MAJ_FUNC(x, y, z)          (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define MAJ_FUNC(x, y, z)          (((x) & (y)) | ((z) & ((x) | (y))))
 
 #define RIGHT_SHIFT_CIRCULAR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
 #define LARGE_SIGMA_0(x)           (RIGHT_SHIFT_CIRCULAR((x),  2) ^ RIGHT_SHIFT_CIRCULAR((x), 13) ^ RIGHT_SHIFT_CIRCULAR((x), 22))
@@ -46,8 +46,27 @@ const ULONG _sha2_round_constants[64] =
 #define SMALL_SIGMA_0(x)           (RIGHT_SHIFT_CIRCULAR((x),  7) ^ RIGHT_SHIFT_CIRCULAR((x), 18) ^ ((x) >> 3))
 #define SMALL_SIGMA_1(x)           (RIGHT_SHIFT_CIRCULAR((x), 17) ^ RIGHT_SHIFT_CIRCULAR((x), 19) ^ ((x) >> 10))
 
-#define W0(t) ((((ULONG)buffer[(t) * 4]) << 24) | (((ULONG)buffer[((t) * 4) + 1]) << 16) | (((ULONG)buffer[((t) * 4) + 2]) << 8) | ((ULONG)buffer[((t) * 4) + 3]))
-#define W16(t) (SMALL_SIGMA_1(w[(t) - 2]) + w[(t) - 7] + SMALL_SIGMA_0(w[(t) - 15]) + w[(t) - 16])
+/* The message schedule is kept in 16 words, w[t & 15] holds w[t - 16] until round t replaces it.  */
+#define W0(t) (w[(t)] = (((ULONG)buffer[(t) * 4]) << 24) | (((ULONG)buffer[((t) * 4) + 1]) << 16) | (((ULONG)buffer[((t) * 4) + 2]) << 8) | ((ULONG)buffer[((t) * 4) + 3]))
+#define W16(t) (w[(t) & 15] += SMALL_SIGMA_1(w[((t) - 2) & 15]) + w[((t) - 7) & 15] + SMALL_SIGMA_0(w[((t) - 15) & 15]))
+
+/* Define one round. Instead of moving the state variables, the next round is passed
+   them rotated by one, so only d and h are written.  */
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, t, W)                                            \
+    temp1 = (h) + LARGE_SIGMA_1(e) + CH_FUNC(e, f, g) + _sha2_round_constants[(t)] + W(t);   \
+    (d) += temp1;                                                                             \
+    (h) = temp1 + LARGE_SIGMA_0(a) + MAJ_FUNC(a, b, c)
+
+/* Define eight rounds, after which the state variables are back in their places.  */
+#define SHA256_EIGHT_ROUNDS(t, W)                               \
+    SHA256_ROUND(a, b, c, d, e, f, g, h, (t),     W);           \
+    SHA256_ROUND(h, a, b, c, d, e, f, g, (t) + 1, W);           \
+    SHA256_ROUND(g, h, a, b, c, d, e, f, (t) + 2, W);           \
+    SHA256_ROUND(f, g, h, a, b, c, d, e, (t) + 3, W);           \
+    SHA256_ROUND(e, f, g, h, a, b, c, d, (t) + 4, W);           \
+    SHA256_ROUND(d, e, f, g, h, a, b, c, (t) + 5, W);           \
+    SHA256_ROUND(c, d, e, f, g, h, a, b, (t) + 6, W);           \
+    SHA256_ROUND(b, c, d, e, f, g, h, a, (t) + 7, W)
 
 /* Define the padding array.  This is used to pad the message such that its length is
    64 bits shy of being a multiple of 512 bits long.  */
@@ -437,8 +456,7 @@ ULONG padding_bytes;
 NX_CRYPTO_KEEP VOID _nx_crypto_sha256_process_buffer(NX_CRYPTO_SHA256 *context, UCHAR buffer[64])
 {
 ULONG *w;
-UINT   t;
-ULONG  temp1, temp2;
+ULONG  temp1;
 ULONG  a, b, c, d, e, f, g, h;
 
 
@@ -455,115 +473,16 @@ ULONG  a, b, c, d, e, f, g, h;
     g =  context -> nx_sha256_states[6];
     h =  context -> nx_sha256_states[7];
 
-    /* Now, perform Round operations.  */
-    for (t = 0; t < 16; t += 8)
-    {
-
-        /* Setup each entry.  */
-        w[t] =  W0(t);
-        temp1 = h + LARGE_SIGMA_1(e) + CH_FUNC(e, f, g) + _sha2_round_constants[t] + w[t];
-        temp2 = LARGE_SIGMA_0(a) + MAJ_FUNC(a, b, c);
-        d = d + temp1;
-        h = temp1 + temp2;
-
-        w[t + 1] =  W0(t + 1);
-        temp1 = g + LARGE_SIGMA_1(d) + CH_FUNC(d, e, f) + _sha2_round_constants[t + 1] + w[t + 1];
-        temp2 = LARGE_SIGMA_0(h) + MAJ_FUNC(h, a, b);
-        c = c + temp1;
-        g = temp1 + temp2;
-
-        w[t + 2] =  W0(t + 2);
-        temp1 = f + LARGE_SIGMA_1(c) + CH_FUNC(c, d, e) + _sha2_round_constants[t + 2] + w[t + 2];
-        temp2 = LARGE_SIGMA_0(g) + MAJ_FUNC(g, h, a);
-        b = b + temp1;
-        f = temp1 + temp2;
-
-        w[t + 3] =  W0(t + 3);
-        temp1 = e + LARGE_SIGMA_1(b) + CH_FUNC(b, c, d) + _sha2_round_constants[t + 3] + w[t + 3];
-        temp2 = LARGE_SIGMA_0(f) + MAJ_FUNC(f, g, h);
-        a = a + temp1;
-        e = temp1 + temp2;
-
-        w[t + 4] =  W0(t + 4);
-        temp1 = d + LARGE_SIGMA_1(a) + CH_FUNC(a, b, c) + _sha2_round_constants[t + 4] + w[t + 4];
-        temp2 = LARGE_SIGMA_0(e) + MAJ_FUNC(e, f, g);
-        h = h + temp1;
-        d = temp1 + temp2;
-
-
-        w[t + 5] =  W0(t + 5);
-        temp1 = c + LARGE_SIGMA_1(h) + CH_FUNC(h, a, b) + _sha2_round_constants[t + 5] + w[t + 5];
-        temp2 = LARGE_SIGMA_0(d) + MAJ_FUNC(d, e, f);
-        g = g + temp1;
-        c = temp1 + temp2;
-
-        w[t + 6] =  W0(t + 6);
-        temp1 = b + LARGE_SIGMA_1(g) + CH_FUNC(g, h, a) + _sha2_round_constants[t + 6] + w[t + 6];
-        temp2 = LARGE_SIGMA_0(c) + MAJ_FUNC(c, d, e);
-        f = f + temp1;
-        b = temp1 + temp2;
-
-        w[t + 7] =  W0(t + 7);
-        temp1 = a + LARGE_SIGMA_1(f) + CH_FUNC(f, g, h) + _sha2_round_constants[t + 7] + w[t + 7];
-        temp2 = LARGE_SIGMA_0(b) + MAJ_FUNC(b, c, d);
-        e = e + temp1;
-        a = temp1 + temp2;
-    }
-
-    for (; t < 64; t += 8)
-    {
-
-        /* Setup each entry.  */
-        w[t] =  W16(t);
-        temp1 = h + LARGE_SIGMA_1(e) + CH_FUNC(e, f, g) + _sha2_round_constants[t] + w[t];
-        temp2 = LARGE_SIGMA_0(a) + MAJ_FUNC(a, b, c);
-        d = d + temp1;
-        h = temp1 + temp2;
-
-        w[t + 1] =  W16(t + 1);
-        temp1 = g + LARGE_SIGMA_1(d) + CH_FUNC(d, e, f) + _sha2_round_constants[t + 1] + w[t + 1];
-        temp2 = LARGE_SIGMA_0(h) + MAJ_FUNC(h, a, b);
-        c = c + temp1;
-        g = temp1 + temp2;
-
-        w[t + 2] =  W16(t + 2);
-        temp1 = f + LARGE_SIGMA_1(c) + CH_FUNC(c, d, e) + _sha2_round_constants[t + 2] + w[t + 2];
-        temp2 = LARGE_SIGMA_0(g) + MAJ_FUNC(g, h, a);
-        b = b + temp1;
-        f = temp1 + temp2;
-
-        w[t + 3] =  W16(t + 3);
-        temp1 = e + LARGE_SIGMA_1(b) + CH_FUNC(b, c, d) + _sha2_round_constants[t + 3] + w[t + 3];
-        temp2 = LARGE_SIGMA_0(f) + MAJ_FUNC(f, g, h);
-        a = a + temp1;
-        e = temp1 + temp2;
-
-        w[t + 4] =  W16(t + 4);
-        temp1 = d + LARGE_SIGMA_1(a) + CH_FUNC(a, b, c) + _sha2_round_constants[t + 4] + w[t + 4];
-        temp2 = LARGE_SIGMA_0(e) + MAJ_FUNC(e, f, g);
-        h = h + temp1;
-        d = temp1 + temp2;
-
-
-        w[t + 5] =  W16(t + 5);
-        temp1 = c + LARGE_SIGMA_1(h) + CH_FUNC(h, a, b) + _sha2_round_constants[t + 5] + w[t + 5];
-        temp2 = LARGE_SIGMA_0(d) + MAJ_FUNC(d, e, f);
-        g = g + temp1;
-        c = temp1 + temp2;
-
-        w[t + 6] =  W16(t + 6);
-        temp1 = b + LARGE_SIGMA_1(g) + CH_FUNC(g, h, a) + _sha2_round_constants[t + 6] + w[t + 6];
-        temp2 = LARGE_SIGMA_0(c) + MAJ_FUNC(c, d, e);
-        f = f + temp1;
-        b = temp1 + temp2;
-
-        w[t + 7] =  W16(t + 7);
-        temp1 = a + LARGE_SIGMA_1(f) + CH_FUNC(f, g, h) + _sha2_round_constants[t + 7] + w[t + 7];
-        temp2 = LARGE_SIGMA_0(b) + MAJ_FUNC(b, c, d);
-        e = e + temp1;
-        a = temp1 + temp2;
-
-    }
+    /* Now, perform Round operations, fully unrolled. The first 16 rounds load the
+       message words, the others extend the schedule in place.  */
+    SHA256_EIGHT_ROUNDS(0,  W0);
+    SHA256_EIGHT_ROUNDS(8,  W0);
+    SHA256_EIGHT_ROUNDS(16, W16);
+    SHA256_EIGHT_ROUNDS(24, W16);
+    SHA256_EIGHT_ROUNDS(32, W16);
+    SHA256_EIGHT_ROUNDS(40, W16);
+    SHA256_EIGHT_ROUNDS(48, W16);
+    SHA256_EIGHT_ROUNDS(56, W16);
 
     /* Save the resulting in this SHA256 context.  */
     context -> nx_sha256_states[0] +=  a;
@@ -578,7 +497,7 @@ ULONG  a, b, c, d, e, f, g, h;
 #ifdef NX_SECURE_KEY_CLEAR
     a = 0; b = 0; c = 0; d = 0;
     e = 0; f = 0; g = 0; h = 0;
-    temp1 = 0; temp2 = 0;
+    temp1 = 0;
 #endif /* NX_SECURE_KEY_CLEAR  */
 }
 
@@ -50,7 +50,7 @@ const ULONG64 _sha5_round_constants[] =
 
 /* Define the SHA5 logic functions.  */
 #define CH_FUNC(x, y, z)           (((x) & (y)) ^ ((~(x)) & (z)))
-#define MAJ_FUNC(x, y, z)          (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define MAJ_FUNC(x, y, z)          (((x) & (y)) | ((z) & ((x) | (y))))
 
 #define RIGHT_SHIFT_CIRCULAR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
 #define LARGE_SIGMA_0(x)           (RIGHT_SHIFT_CIRCULAR((x),  28) ^ RIGHT_SHIFT_CIRCULAR((x), 34) ^ RIGHT_SHIFT_CIRCULAR((x), 39))
@@ -58,6 +58,31 @@ const ULONG64 _sha5_round_constants[] =
 #define SMALL_SIGMA_0(x)           (RIGHT_SHIFT_CIRCULAR((x),  1) ^ RIGHT_SHIFT_CIRCULAR((x), 8) ^ ((x) >> 7))
 #define SMALL_SIGMA_1(x)           (RIGHT_SHIFT_CIRCULAR((x), 19) ^ RIGHT_SHIFT_CIRCULAR((x), 61) ^ ((x) >> 6))
 
+/* The message schedule is kept in 16 words, w[t & 15] holds w[t - 16] until round t replaces it.  */
+#define W0(t)  (w[(t)] = (((ULONG64)buffer[(t) * 8]) << 56) | (((ULONG64)buffer[((t) * 8) + 1]) << 48) |       \
+                         (((ULONG64)buffer[((t) * 8) + 2]) << 40) | (((ULONG64)buffer[((t) * 8) + 3]) << 32) | \
+                         (((ULONG64)buffer[((t) * 8) + 4]) << 24) | (((ULONG64)buffer[((t) * 8) + 5]) << 16) | \
+                         (((ULONG64)buffer[((t) * 8) + 6]) << 8) | ((ULONG64)buffer[((t) * 8) + 7]))
+#define W16(t) (w[(t) & 15] += SMALL_SIGMA_1(w[((t) - 2) & 15]) + w[((t) - 7) & 15] + SMALL_SIGMA_0(w[((t) - 15) & 15]))
+
+/* Define one round. Instead of moving the state variables, the next round is passed
+   them rotated by one, so only d and h are written.  */
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, t, W)                                            \
+    temp1 = (h) + LARGE_SIGMA_1(e) + CH_FUNC(e, f, g) + _sha5_round_constants[(t)] + W(t);   \
+    (d) += temp1;                                                                             \
+    (h) = temp1 + LARGE_SIGMA_0(a) + MAJ_FUNC(a, b, c)
+
+/* Define eight rounds, after which the state variables are back in their places.  */
+#define SHA512_EIGHT_ROUNDS(t, W)                               \
+    SHA512_ROUND(a, b, c, d, e, f, g, h, (t),     W);           \
+    SHA512_ROUND(h, a, b, c, d, e, f, g, (t) + 1, W);           \
+    SHA512_ROUND(g, h, a, b, c, d, e, f, (t) + 2, W);           \
+    SHA512_ROUND(f, g, h, a, b, c, d, e, (t) + 3, W);           \
+    SHA512_ROUND(e, f, g, h, a, b, c, d, (t) + 4, W);           \
+    SHA512_ROUND(d, e, f, g, h, a, b, c, (t) + 5, W);           \
+    SHA512_ROUND(c, d, e, f, g, h, a, b, (t) + 6, W);           \
+    SHA512_ROUND(b, c, d, e, f, g, h, a, (t) + 7, W)
+
 /* Define the padding array.  This is used to pad the message such that its length is
    64 bits shy of being a multiple of 512 bits long.  */
 const UCHAR   _nx_crypto_sha512_padding[] =
@@ -501,37 +526,13 @@ UINT  loop;
 NX_CRYPTO_KEEP VOID _nx_crypto_sha512_process_buffer(NX_CRYPTO_SHA512 *context, UCHAR *buffer)
 {
 ULONG64 *w;
-UINT     t;
-ULONG64  temp1, temp2;
+ULONG64  temp1;
 ULONG64  a, b, c, d, e, f, g, h;
 
 
     /* Setup pointers to the word array.  */
     w =  context -> nx_sha512_word_array;
 
-    /* Initialize the first 16 words of the word array, taking care of the
-       endian issues at the same time.  */
-    for (t = 0; t < 16; t++)
-    {
-        /* Setup each entry.  */
-        w[t] =  (((ULONG64)buffer[0]) << 56) |
-            (((ULONG64)buffer[1]) << 48) |
-            (((ULONG64)buffer[2]) << 40) |
-            (((ULONG64)buffer[3]) << 32) |
-            (((ULONG64)buffer[4]) << 24) |
-            (((ULONG64)buffer[5]) << 16) |
-            (((ULONG64)buffer[6]) << 8) |
-            ((ULONG64)buffer[7]);
-        buffer += 8;
-    }
-
-    /* Setup the remaining entries of the word array.  */
-    for (t = 16; t < 80; t++)
-    {
-        /* Setup each entry.  */
-        w[t] =  SMALL_SIGMA_1(w[t - 2]) + w[t - 7] + SMALL_SIGMA_0(w[t - 15]) + w[t - 16];
-    }
-
     /* Initialize the state variables.  */
     a =  context -> nx_sha512_states[0];
     b =  context -> nx_sha512_states[1];
@@ -542,20 +543,18 @@ ULONG64  a, b, c, d, e, f, g, h;
     g =  context -> nx_sha512_states[6];
     h =  context -> nx_sha512_states[7];
 
-    /* Now, perform Round operations.  */
-    for (t = 0; t < 80; t++)
-    {
-        temp1 = h + LARGE_SIGMA_1(e) + CH_FUNC(e, f, g) + _sha5_round_constants[t] + w[t];
-        temp2 = LARGE_SIGMA_0(a) + MAJ_FUNC(a, b, c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + temp1;
-        d = c;
-        c = b;
-        b = a;
-        a = temp1 + temp2;
-    }
+    /* Now, perform Round operations, fully unrolled. The first 16 rounds load the
+       message words, the others extend the schedule in place.  */
+    SHA512_EIGHT_ROUNDS(0,  W0);
+    SHA512_EIGHT_ROUNDS(8,  W0);
+    SHA512_EIGHT_ROUNDS(16, W16);
+    SHA512_EIGHT_ROUNDS(24, W16);
+    SHA512_EIGHT_ROUNDS(32, W16);
+    SHA512_EIGHT_ROUNDS(40, W16);
+    SHA512_EIGHT_ROUNDS(48, W16);
+    SHA512_EIGHT_ROUNDS(56, W16);
+    SHA512_EIGHT_ROUNDS(64, W16);
+    SHA512_EIGHT_ROUNDS(72, W16);
 
     /* Save the resulting in this SHA512 context.  */
     context -> nx_sha512_states[0] +=  a;
@@ -570,7 +569,7 @@ ULONG64  a, b, c, d, e, f, g, h;
 #ifdef NX_SECURE_KEY_CLEAR
     a = 0; b = 0; c = 0; d = 0;
     e = 0; f = 0; g = 0; h = 0;
-    temp1 = 0; temp2 = 0;
+    temp1 = 0;
 #endif /* NX_SECURE_KEY_CLEAR  */
 }
 
@@ -286,6 +286,7 @@ extern   "C" {
 #define NX_SECURE_TLS_RECORD_OVERFLOW                   0x151       /* Received a TLSCiphertext record that had a length too long. */
 #define NX_SECURE_TLS_HANDSHAKE_FRAGMENT_RECEIVED       0x152       /* Received a fragmented handshake message - take appropriate action at a higher level of the state machine. */
 #define NX_SECURE_TLS_TRANSMIT_LOCKED                   0x153       /* Another thread is transmitting. */
+#define NX_SECURE_TLS_BAD_RECORD_SIZE_LIMIT             0x154       /* The remote host sent an illegal record_size_limit or max_fragment_length extension. */
 
 /* NX_CONTINUE is a symbol defined in NetX Duo 5.10.  For backward compatibility, this symbol is defined here */
 #if ((__NETXDUO_MAJOR_VERSION__ == 5) && (__NETXDUO_MINOR_VERSION__ == 9))
@@ -427,6 +428,19 @@ extern   "C" {
 #define NX_SECURE_TLS_TLS_1_3_ENABLED                   (0)
 #endif
 
+/* Configuration macro: carve the session cipher and PRF metadata out of the public cipher metadata.
+   The PRF keeps no state between its uses and a TLS 1.2 handshake sets the session keys after its
+   last public key operation, so they need not have their own areas. A renegotiation and a TLS 1.3
+   handshake run public key operations under the session keys, and DTLS may process a retransmitted
+   flight after setting them, so none of them can share the metadata.
+   #define NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+ */
+#ifdef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+#if !defined(NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION) || (NX_SECURE_TLS_TLS_1_3_ENABLED) || defined(NX_SECURE_ENABLE_DTLS)
+#error "NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA requires NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION, without TLS 1.3 and DTLS!"
+#endif
+#endif
+
 
 /* Define a structure to keep track of which versions of TLS are enabled and supported. */
 typedef struct NX_SECURE_TLS_VERSIONS_STRUCT
@@ -490,6 +504,7 @@ typedef struct NX_SECURE_VERSIONS_LIST_STRUCT
 #define TLS_RSA_WITH_AES_256_GCM_SHA384                    0x009D
 #define TLS_PSK_WITH_AES_128_CBC_SHA256                    0x00AE
 #define TLS_PSK_WITH_AES_128_CCM_8                         0xC0A8
+#define TLS_PSK_WITH_CHACHA20_POLY1305_SHA256              0xCCAB
 
 /* EC Ciphersuites. */
 #define TLS_ECDH_ECDSA_WITH_NULL_SHA                       0xC001
@@ -528,9 +543,12 @@ typedef struct NX_SECURE_VERSIONS_LIST_STRUCT
 #define TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384              0xC030
 #define TLS_ECDH_RSA_WITH_AES_128_GCM_SHA256               0xC031
 #define TLS_ECDH_RSA_WITH_AES_256_GCM_SHA384               0xC032
+#define TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256        0xCCA8
+#define TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256      0xCCA9
 
 #define TLS_AES_128_GCM_SHA256                             0x1301
 #define TLS_AES_256_GCM_SHA384                             0x1302
+#define TLS_CHACHA20_POLY1305_SHA256                       0x1303
 #define TLS_AES_128_CCM_SHA256                             0x1304
 #define TLS_AES_128_CCM_8_SHA256                           0x1305
 
@@ -613,6 +631,7 @@ typedef struct NX_SECURE_VERSIONS_LIST_STRUCT
 #define NX_SECURE_TLS_EXTENSION_EC_GROUPS                  (0x000A)
 #define NX_SECURE_TLS_EXTENSION_EC_POINT_FORMATS           (0x000B)
 #define NX_SECURE_TLS_EXTENSION_SIGNATURE_ALGORITHMS       (0x000D)
+#define NX_SECURE_TLS_EXTENSION_RECORD_SIZE_LIMIT          (0x001C)
 #define NX_SECURE_TLS_EXTENSION_PRE_SHARED_KEY             (0x0029)
 #define NX_SECURE_TLS_EXTENSION_EARLY_DATA                 (0x002A)
 #define NX_SECURE_TLS_EXTENSION_SUPPORTED_VERSIONS         (0x002B)
@@ -671,6 +690,33 @@ typedef struct NX_SECURE_VERSIONS_LIST_STRUCT
 #define NX_SECURE_TLS_MAX_CIPHERTEXT_LENGTH                (18432) /* Maximum TLSCiphertext record length. */
 #define NX_SECURE_TLS_MAX_CIPHERTEXT_LENGTH_1_3            (16640) /* Maximum TLSCiphertext record length of TLS 1.3. */
 #define NX_SECURE_TLS_MAX_PLAINTEXT_LENGTH                 (16384) /* Maximum TLSPlaintext record length. */
+#define NX_SECURE_TLS_MIN_RECORD_SIZE_LIMIT                (64)    /* Minimum record_size_limit value (RFC 8449). */
+
+/* Configuration macro: the maximum plaintext length of the records a TLS client asks the server
+ * to send, with the record_size_limit (RFC 8449) and max_fragment_length (RFC 6066) extensions.
+ * It must be 512, 1024, 2048 or 4096, the lengths max_fragment_length can express. The limit the
+ * server returns bounds the records we send. Not defined, neither extension is sent.
+ */
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+#if (NX_SECURE_TLS_RECORD_SIZE_LIMIT == 512)
+#define NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE             (1)
+#elif (NX_SECURE_TLS_RECORD_SIZE_LIMIT == 1024)
+#define NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE             (2)
+#elif (NX_SECURE_TLS_RECORD_SIZE_LIMIT == 2048)
+#define NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE             (3)
+#elif (NX_SECURE_TLS_RECORD_SIZE_LIMIT == 4096)
+#define NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE             (4)
+#else
+#error "NX_SECURE_TLS_RECORD_SIZE_LIMIT must be 512, 1024, 2048 or 4096."
+#endif
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
+/* Configuration macro: defined, nx_secure_tls_session_send splits application data longer than one
+ * TCP segment of the connection into records whose ciphertext and header fill one segment each,
+ * within the record size limit. The remote host decrypts each record as its segment arrives, and
+ * no short segment is left over per record. The data is then copied into packets of the session
+ * packet pool. Not defined, the data of a packet goes out as one record.
+ */
 
 /* The minimum size for the TLS message buffer is determined by a number of factors, but primarily
  * the expected size of the TLS handshake Certificate message (sent by the TLS server) that may
@@ -853,6 +899,36 @@ typedef struct NX_SECURE_TLS_ECC_STRUCT
     /* Corresponding crypto methods for the supported named curve. */
     const NX_CRYPTO_METHOD **nx_secure_tls_ecc_curves;
 } NX_SECURE_TLS_ECC;
+
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+/* States of a precomputed ECDHE key pair. */
+#define NX_SECURE_TLS_ECDHE_PRECOMPUTED_FREE               0
+#define NX_SECURE_TLS_ECDHE_PRECOMPUTED_GENERATING         1
+#define NX_SECURE_TLS_ECDHE_PRECOMPUTED_READY              2
+#define NX_SECURE_TLS_ECDHE_PRECOMPUTED_TAKEN              3
+
+/* An ephemeral ECDHE key pair generated ahead of the handshake that takes it, used once. */
+typedef struct NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEY_STRUCT
+{
+    /* One of the NX_SECURE_TLS_ECDHE_PRECOMPUTED states, changed with interrupts disabled. */
+    UINT nx_secure_tls_ecdhe_precomputed_state;
+
+    /* Curve of the key pair. */
+    const NX_CRYPTO_METHOD *nx_secure_tls_ecdhe_precomputed_curve;
+
+    /* Length of the private key. */
+    USHORT nx_secure_tls_ecdhe_precomputed_private_key_length;
+
+    /* Length of the public key. */
+    USHORT nx_secure_tls_ecdhe_precomputed_public_key_length;
+
+    /* Private key, as exported by the ECDHE method. */
+    UCHAR nx_secure_tls_ecdhe_precomputed_private_key[NX_SECURE_TLS_PREMASTER_SIZE];
+
+    /* Public key, in the format of the key exchange. */
+    UCHAR nx_secure_tls_ecdhe_precomputed_public_key[4 * NX_SECURE_TLS_PREMASTER_SIZE];
+} NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEY;
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
 
 
@@ -1093,6 +1169,56 @@ typedef struct NX_SECURE_TLS_HELLO_EXTENSION_STRUCT
     const UCHAR *nx_secure_tls_extension_data;
 } NX_SECURE_TLS_HELLO_EXTENSION;
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+#include "tx_byte_pool.h"
+#endif
+
+/* Memory shared by the TLS sessions created with nx_secure_tls_session_arena_create. Each
+   session takes its crypto metadata and packet buffer from the arena in one block. */
+typedef struct NX_SECURE_TLS_ARENA_STRUCT
+{
+    /* Byte pool of the arena memory. */
+    TX_BYTE_POOL nx_secure_tls_arena_pool;
+} NX_SECURE_TLS_ARENA;
+
+/* Byte pool overhead of the arena itself, the free list heads of a TLSF pool at its start. */
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+#define NX_SECURE_TLS_ARENA_POOL_OVERHEAD (TX_BYTE_POOL_TLSF_SIZE + 2 * sizeof(UCHAR *))
+#else
+#define NX_SECURE_TLS_ARENA_POOL_OVERHEAD (2 * sizeof(UCHAR *))
+#endif
+
+/* Arena memory for sessions of the given metadata and packet buffer sizes, with the byte pool
+   overhead of each block and of the pool itself. */
+#define NX_SECURE_TLS_ARENA_SIZE(sessions, metadata_size, packet_buffer_size) \
+    ((sessions) * ((((metadata_size) + 3) & ~3UL) + (((packet_buffer_size) + 3) & ~3UL) + 2 * sizeof(UCHAR *)) + \
+     NX_SECURE_TLS_ARENA_POOL_OVERHEAD)
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+/* Longest session ID of TLS 1.2 (RFC 5246 section 7.4.1.2). */
+#define NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE           (32)
+
+/* TLS 1.2 session of a full client handshake, as read with nx_secure_tls_session_resumption_get.
+   Given back to nx_secure_tls_session_resumption_set, its session ID is offered in the ClientHello
+   of a later connection, and a server that still knows it resumes the session: no certificate, no
+   key exchange, the keys come from the master secret with the new random values. */
+typedef struct NX_SECURE_TLS_SESSION_RESUMPTION_STRUCT
+{
+    /* Protocol version and ciphersuite negotiated in the full handshake. */
+    USHORT nx_secure_tls_resumption_protocol_version;
+    USHORT nx_secure_tls_resumption_ciphersuite;
+
+    /* Session ID given by the server in its ServerHello, a 0 length offers nothing. */
+    UCHAR  nx_secure_tls_resumption_session_id_length;
+    UCHAR  nx_secure_tls_resumption_session_id[NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE];
+
+    /* Master secret of the session. */
+    UCHAR  nx_secure_tls_resumption_master_secret[NX_SECURE_TLS_MASTER_SIZE];
+} NX_SECURE_TLS_SESSION_RESUMPTION;
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
 
 /* Definition of the top-level TLS session control block used by the application. */
 typedef struct NX_SECURE_TLS_SESSION_STRUCT
@@ -1110,6 +1236,9 @@ typedef struct NX_SECURE_TLS_SESSION_STRUCT
     /* Packet pool used by TLS stack to allocate outgoing packets used in TLS handshake. */
     NX_PACKET_POOL *nx_secure_tls_packet_pool;
 
+    /* Packet pool reserved to the handshake messages and alerts, NX_NULL when they share the one above. */
+    NX_PACKET_POOL *nx_secure_tls_control_packet_pool;
+
     /* Packet/message buffer for re-assembling TLS messages. */
     UCHAR *nx_secure_tls_packet_buffer;
     ULONG  nx_secure_tls_packet_buffer_size;
@@ -1160,6 +1289,13 @@ typedef struct NX_SECURE_TLS_SESSION_STRUCT
     UCHAR nx_secure_tls_session_cipher_client_initialized;
     UCHAR nx_secure_tls_session_cipher_server_initialized;
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+    /* Maximum plaintext length of the records sent to and received from the remote host,
+       negotiated in the hello extensions. Zero when no limit was negotiated. */
+    USHORT nx_secure_tls_send_record_size_limit;
+    USHORT nx_secure_tls_receive_record_size_limit;
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
     /* Chosen ciphersuite. */
     const NX_SECURE_TLS_CIPHERSUITE_INFO *nx_secure_tls_session_ciphersuite;
 
@@ -1336,8 +1472,42 @@ typedef struct NX_SECURE_TLS_SESSION_STRUCT
 
     UINT nx_secure_tls_signature_algorithm;
 #endif
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+    /* Arena block of the metadata and packet buffer, released when the session is deleted. */
+    VOID *nx_secure_tls_arena_block;
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+    /* Session offered in the ClientHello of the initial handshakes, kept across session resets. */
+    NX_SECURE_TLS_SESSION_RESUMPTION nx_secure_tls_session_resumption;
+
+    /* The server resumed the session offered in the current or last handshake. */
+    UINT nx_secure_tls_session_resumed;
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 } NX_SECURE_TLS_SESSION;
 
+/* Pool of the handshake messages and alerts of a session, see nx_secure_tls_session_control_packet_pool_set. */
+#define NX_SECURE_TLS_CONTROL_PACKET_POOL(s)                                                 \
+    (((s) -> nx_secure_tls_control_packet_pool != NX_NULL) ? (s) -> nx_secure_tls_control_packet_pool : \
+                                                              (s) -> nx_secure_tls_packet_pool)
+
+/* Pool the record layer appends to a packet from: a control record grows in the control pool,
+   it does not wait for the pool of the data.  */
+#define NX_SECURE_TLS_RECORD_PACKET_POOL(s, p)                                               \
+    (((p) -> nx_packet_pool_owner == (s) -> nx_secure_tls_control_packet_pool) ?              \
+     (s) -> nx_secure_tls_control_packet_pool : (s) -> nx_secure_tls_packet_pool)
+
+/* A client handshake resumed by the ServerHello, the ChangeCipherSpec and Finished of the server
+   coming next instead of its certificate and key exchange.  */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+#define NX_SECURE_TLS_CLIENT_RESUMING(s)                                                     \
+    ((s) -> nx_secure_tls_session_resumed &&                                                 \
+     ((s) -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO))
+#else
+#define NX_SECURE_TLS_CLIENT_RESUMING(s) NX_FALSE
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
 /* TLS record types. */
 #define NX_SECURE_TLS_CHANGE_CIPHER_SPEC   20
 #define NX_SECURE_TLS_ALERT                21
@@ -1410,6 +1580,9 @@ UINT _nx_secure_tls_ciphersuite_lookup(NX_SECURE_TLS_SESSION *tls_session, UINT
                                        const NX_SECURE_TLS_CIPHERSUITE_INFO **info, USHORT *ciphersuite_priority);
 UINT _nx_secure_tls_client_handshake(NX_SECURE_TLS_SESSION *tls_session, UCHAR *packet_buffer,
                                      UINT data_length, ULONG wait_option);
+#if defined(NX_SECURE_TLS_ENABLE_FALSE_START) && !defined(NX_SECURE_TLS_CLIENT_DISABLED)
+UINT _nx_secure_tls_false_start_check(NX_SECURE_TLS_SESSION *tls_session);
+#endif /* NX_SECURE_TLS_ENABLE_FALSE_START && !NX_SECURE_TLS_CLIENT_DISABLED */
 UINT _nx_secure_tls_finished_hash_generate(NX_SECURE_TLS_SESSION *tls_session,
                                            UCHAR *finished_label, UCHAR *finished_hash);
 UINT _nx_secure_tls_generate_keys(NX_SECURE_TLS_SESSION *tls_session);
@@ -1461,6 +1634,9 @@ UINT _nx_secure_tls_process_remote_certificate(NX_SECURE_TLS_SESSION *tls_sessio
                                                UCHAR *packet_buffer,
                                                UINT message_length,
                                                UINT data_length);
+UINT _nx_secure_tls_process_remote_certificate_stream(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
+                                                      ULONG *record_offset, UINT *message_length,
+                                                      ULONG wait_option);
 UINT _nx_secure_tls_process_server_key_exchange(NX_SECURE_TLS_SESSION *tls_session,
                                                 UCHAR *packet_buffer, UINT message_length);
 UINT _nx_secure_tls_process_serverhello(NX_SECURE_TLS_SESSION *tls_session, UCHAR *packet_buffer,
@@ -1542,6 +1718,11 @@ UINT _nx_secure_tls_proc_clienthello_sec_sa_extension(NX_SECURE_TLS_SESSION *tls
                                                       UINT *cert_curve_supported,
                                                       USHORT *ecdhe_signature_algorithm,
                                                       NX_SECURE_X509_CERT *cert);
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+UINT _nx_secure_tls_ecdhe_precomputed_get(const NX_CRYPTO_METHOD *curve_method,
+                                          UCHAR *public_key, UINT *public_key_length,
+                                          UCHAR *private_key, UINT *private_key_length);
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
 
 
@@ -1602,8 +1783,11 @@ UINT _nx_secure_tls_session_create_ext(NX_SECURE_TLS_SESSION *tls_session,
 
 UINT _nx_secure_tls_session_delete(NX_SECURE_TLS_SESSION *tls_session);
 UINT _nx_secure_tls_session_end(NX_SECURE_TLS_SESSION *tls_session, UINT wait_option);
+UINT _nx_secure_tls_session_handshake_step(NX_SECURE_TLS_SESSION *tls_session);
 UINT _nx_secure_tls_session_packet_buffer_set(NX_SECURE_TLS_SESSION *session_ptr,
                                               UCHAR *buffer_ptr, ULONG buffer_size);
+UINT _nx_secure_tls_session_control_packet_pool_set(NX_SECURE_TLS_SESSION *session_ptr,
+                                                    NX_PACKET_POOL *packet_pool);
 UINT _nx_secure_tls_session_protocol_version_override(NX_SECURE_TLS_SESSION *tls_session,
                                                       USHORT protocol_version);
 UINT _nx_secure_tls_session_receive(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET **packet_ptr_ptr,
@@ -1650,7 +1834,25 @@ UINT _nx_secure_tls_psk_identity_find(NX_SECURE_TLS_SESSION *tls_session, UCHAR
 UINT _nx_secure_tls_ecc_initialize(NX_SECURE_TLS_SESSION *tls_session,
                                    const USHORT *supported_groups, USHORT supported_group_count,
                                    const NX_CRYPTO_METHOD **curves);
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+UINT _nx_secure_tls_ecdhe_precompute(const NX_CRYPTO_METHOD *ecdhe_method, const NX_CRYPTO_METHOD *curve_method,
+                                     UINT key_count, VOID *metadata_area, ULONG metadata_size);
+UINT _nx_secure_tls_ecdhe_precompute_notify_set(VOID (*precompute_notify)(const NX_CRYPTO_METHOD *curve_method));
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+UINT _nx_secure_tls_arena_create(NX_SECURE_TLS_ARENA *arena_ptr, CHAR *name_ptr,
+                                 VOID *memory_ptr, ULONG memory_size);
+UINT _nx_secure_tls_session_arena_create(NX_SECURE_TLS_SESSION *session_ptr,
+                                         const NX_SECURE_TLS_CRYPTO *crypto_table,
+                                         NX_SECURE_TLS_ARENA *arena_ptr, ULONG packet_buffer_size);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+UINT _nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                           NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+UINT _nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                           const NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 
 /* Functions for error checking .*/
 UINT _nxe_secure_tls_active_certificate_set(NX_SECURE_TLS_SESSION *tls_session,
@@ -1694,8 +1896,11 @@ UINT _nxe_secure_tls_session_create(NX_SECURE_TLS_SESSION *session_ptr,
                                     ULONG metadata_size);
 UINT _nxe_secure_tls_session_delete(NX_SECURE_TLS_SESSION *tls_session);
 UINT _nxe_secure_tls_session_end(NX_SECURE_TLS_SESSION *tls_session, UINT wait_option);
+UINT _nxe_secure_tls_session_handshake_step(NX_SECURE_TLS_SESSION *tls_session);
 UINT _nxe_secure_tls_session_packet_buffer_set(NX_SECURE_TLS_SESSION *session_ptr,
                                                UCHAR *buffer_ptr, ULONG buffer_size);
+UINT _nxe_secure_tls_session_control_packet_pool_set(NX_SECURE_TLS_SESSION *session_ptr,
+                                                     NX_PACKET_POOL *packet_pool);
 UINT _nxe_secure_tls_session_protocol_version_override(NX_SECURE_TLS_SESSION *tls_session,
                                                        USHORT protocol_version);
 UINT _nxe_secure_tls_session_receive(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET **packet_ptr_ptr,
@@ -1734,6 +1939,19 @@ UINT _nxe_secure_tls_psk_find(NX_SECURE_TLS_SESSION *tls_session, UCHAR **psk_da
 UINT _nxe_secure_tls_client_psk_set(NX_SECURE_TLS_SESSION *tls_session, UCHAR *pre_shared_key, UINT psk_length,
                                     UCHAR *psk_identity, UINT identity_length, UCHAR *hint, UINT hint_length);
 #endif
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+UINT _nxe_secure_tls_arena_create(NX_SECURE_TLS_ARENA *arena_ptr, CHAR *name_ptr,
+                                  VOID *memory_ptr, ULONG memory_size);
+UINT _nxe_secure_tls_session_arena_create(NX_SECURE_TLS_SESSION *session_ptr,
+                                          const NX_SECURE_TLS_CRYPTO *crypto_table,
+                                          NX_SECURE_TLS_ARENA *arena_ptr, ULONG packet_buffer_size);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+UINT _nxe_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                            NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+UINT _nxe_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                            const NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 
 /* TLS component data declarations follow.  */
 
@@ -1753,6 +1971,12 @@ TLS_DECLARE  NX_SECURE_TLS_SESSION *_nx_secure_tls_created_ptr;
 TLS_DECLARE  ULONG    _nx_secure_tls_created_count;
 TLS_DECLARE  TX_MUTEX _nx_secure_tls_protection;
 
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+/* Define the ECDHE key pairs generated ahead of the handshakes, and the routine called when one is taken.  */
+TLS_DECLARE  NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEY _nx_secure_tls_ecdhe_precomputed_keys[NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS];
+TLS_DECLARE  VOID (*_nx_secure_tls_ecdhe_precompute_notify)(const NX_CRYPTO_METHOD *curve_method);
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE && NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -93,7 +93,9 @@ extern   "C" {
 #define nx_secure_tls_session_create                       _nx_secure_tls_session_create
 #define nx_secure_tls_session_delete                       _nx_secure_tls_session_delete
 #define nx_secure_tls_session_end                          _nx_secure_tls_session_end
+#define nx_secure_tls_session_handshake_step               _nx_secure_tls_session_handshake_step
 #define nx_secure_tls_session_packet_buffer_set            _nx_secure_tls_session_packet_buffer_set
+#define nx_secure_tls_session_control_packet_pool_set      _nx_secure_tls_session_control_packet_pool_set
 #define nx_secure_tls_session_protocol_version_override    _nx_secure_tls_session_protocol_version_override
 #define nx_secure_tls_session_receive                      _nx_secure_tls_session_receive
 #define nx_secure_tls_session_renegotiate                  _nx_secure_tls_session_renegotiate
@@ -112,6 +114,14 @@ extern   "C" {
 #define nx_secure_tls_client_psk_set                       _nx_secure_tls_client_psk_set
 #define nx_secure_tls_psk_add                              _nx_secure_tls_psk_add
 #endif /* defined(NX_SECURE_ENABLE_PSK_CIPHERSUITES) || defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) */
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+#define nx_secure_tls_arena_create                         _nx_secure_tls_arena_create
+#define nx_secure_tls_session_arena_create                 _nx_secure_tls_session_arena_create
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+#define nx_secure_tls_session_resumption_get               _nx_secure_tls_session_resumption_get
+#define nx_secure_tls_session_resumption_set               _nx_secure_tls_session_resumption_set
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 #else /* !NX_SEURE_DISABLE_ERROR_CHECKING */
 #define nx_secure_tls_active_certificate_set               _nxe_secure_tls_active_certificate_set
 #define nx_secure_tls_initialize                           _nx_secure_tls_initialize
@@ -135,7 +145,9 @@ extern   "C" {
 #define nx_secure_tls_session_create                       _nxe_secure_tls_session_create
 #define nx_secure_tls_session_delete                       _nxe_secure_tls_session_delete
 #define nx_secure_tls_session_end                          _nxe_secure_tls_session_end
+#define nx_secure_tls_session_handshake_step               _nxe_secure_tls_session_handshake_step
 #define nx_secure_tls_session_packet_buffer_set            _nxe_secure_tls_session_packet_buffer_set
+#define nx_secure_tls_session_control_packet_pool_set      _nxe_secure_tls_session_control_packet_pool_set
 #define nx_secure_tls_session_protocol_version_override    _nxe_secure_tls_session_protocol_version_override
 #define nx_secure_tls_session_receive                      _nxe_secure_tls_session_receive
 #define nx_secure_tls_session_renegotiate                  _nxe_secure_tls_session_renegotiate
@@ -154,11 +166,23 @@ extern   "C" {
 #define nx_secure_tls_client_psk_set                       _nxe_secure_tls_client_psk_set
 #define nx_secure_tls_psk_add                              _nxe_secure_tls_psk_add
 #endif /* defined(NX_SECURE_ENABLE_PSK_CIPHERSUITES) || defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) */
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+#define nx_secure_tls_arena_create                         _nxe_secure_tls_arena_create
+#define nx_secure_tls_session_arena_create                 _nxe_secure_tls_session_arena_create
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+#define nx_secure_tls_session_resumption_get               _nxe_secure_tls_session_resumption_get
+#define nx_secure_tls_session_resumption_set               _nxe_secure_tls_session_resumption_set
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 #endif /* NX_SECURE_DISABLE_ERROR_CHECKING */
 #define nx_secure_crypto_table_self_test                   _nx_secure_crypto_table_self_test
 #define nx_secure_crypto_rng_self_test                     _nx_secure_crypto_rng_self_test
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
 #define nx_secure_tls_ecc_initialize                       _nx_secure_tls_ecc_initialize
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+#define nx_secure_tls_ecdhe_precompute                     _nx_secure_tls_ecdhe_precompute
+#define nx_secure_tls_ecdhe_precompute_notify_set          _nx_secure_tls_ecdhe_precompute_notify_set
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
 
 UINT nx_secure_crypto_table_self_test(const NX_SECURE_TLS_CRYPTO *crypto_table,
@@ -216,8 +240,11 @@ UINT nx_secure_tls_session_create(NX_SECURE_TLS_SESSION *session_ptr,
                                   ULONG metadata_size);
 UINT nx_secure_tls_session_delete(NX_SECURE_TLS_SESSION *tls_session);
 UINT nx_secure_tls_session_end(NX_SECURE_TLS_SESSION *tls_session, UINT wait_option);
+UINT nx_secure_tls_session_handshake_step(NX_SECURE_TLS_SESSION *tls_session);
 UINT nx_secure_tls_session_packet_buffer_set(NX_SECURE_TLS_SESSION *session_ptr,
                                              UCHAR *buffer_ptr, ULONG buffer_size);
+UINT nx_secure_tls_session_control_packet_pool_set(NX_SECURE_TLS_SESSION *session_ptr,
+                                                   NX_PACKET_POOL *packet_pool);
 UINT nx_secure_tls_session_protocol_version_override(NX_SECURE_TLS_SESSION *tls_session,
                                                      USHORT protocol_version);
 UINT nx_secure_tls_session_receive(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET **packet_ptr_ptr,
@@ -258,7 +285,25 @@ UINT nx_secure_tls_client_psk_set(NX_SECURE_TLS_SESSION *tls_session, UCHAR *pre
 UINT nx_secure_tls_ecc_initialize(NX_SECURE_TLS_SESSION *tls_session,
                                   const USHORT *supported_groups, USHORT supported_group_count,
                                   const NX_CRYPTO_METHOD **curves);
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+UINT nx_secure_tls_ecdhe_precompute(const NX_CRYPTO_METHOD *ecdhe_method, const NX_CRYPTO_METHOD *curve_method,
+                                    UINT key_count, VOID *metadata_area, ULONG metadata_size);
+UINT nx_secure_tls_ecdhe_precompute_notify_set(VOID (*precompute_notify)(const NX_CRYPTO_METHOD *curve_method));
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+UINT nx_secure_tls_arena_create(NX_SECURE_TLS_ARENA *arena_ptr, CHAR *name_ptr,
+                                VOID *memory_ptr, ULONG memory_size);
+UINT nx_secure_tls_session_arena_create(NX_SECURE_TLS_SESSION *session_ptr,
+                                        const NX_SECURE_TLS_CRYPTO *crypto_table,
+                                        NX_SECURE_TLS_ARENA *arena_ptr, ULONG packet_buffer_size);
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+UINT nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                          NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+UINT nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                          const NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr);
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 #endif /* NX_SECURE_SOURCE_CODE */
 
 
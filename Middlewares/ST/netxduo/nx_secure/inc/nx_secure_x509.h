@@ -133,6 +133,25 @@ extern   "C" {
 #define NX_SECURE_X509_CERTIFICATE_INITIALIZE_EXTENSION
 #endif /* NX_SECURE_X509_CERTIFICATE_INITIALIZE_EXTENSION */
 
+/* Define the number of certificates remembered, by a SHA-256 fingerprint of each with its issuer, after
+   their signature verified during chain verification. A chain presented again skips the public key
+   operations. Zero disables the cache. */
+#ifndef NX_SECURE_X509_VERIFY_CACHE_SIZE
+#define NX_SECURE_X509_VERIFY_CACHE_SIZE                0
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
+/* Define the size in bits of the Bloom filter of a CRL index, tested before its sorted serial numbers
+   are searched. Most certificates not revoked are then ruled out by NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES
+   bit tests, with false positives in about (1 - e^(-probes * revoked / bits))^probes of them; 8 bits per
+   revoked certificate give about 3%. Zero leaves the filter out. */
+#ifndef NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+#define NX_SECURE_X509_CRL_INDEX_BLOOM_BITS             0
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+
+#ifndef NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES
+#define NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES           3
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES */
+
 /* Return values for X509 errors. */
 #define NX_SECURE_X509_SUCCESS                                    0     /* Successful return status. */
 #define NX_SECURE_X509_MULTIBYTE_TAG_UNSUPPORTED                  0x181 /* We encountered a multi-byte ASN.1 tag - not currently supported. */
@@ -179,6 +198,7 @@ extern   "C" {
 #define NX_SECURE_X509_INSUFFICIENT_CERT_SPACE                    0x1A8 /* Not enough certificate buffer space allocated for a certificate. */
 #define NX_SECURE_X509_CERT_ID_DUPLICATE                          0x1A9 /* Tried to add a certificate with a numeric ID that was already used - needs to be unique. */
 #define NX_SECURE_X509_MISSING_CRYPTO_ROUTINE                     0x1AA /* In attempting to perform a cryptographic operation, an entry in the ciphersuite table (or one of its function pointers) was NULL. */
+#define NX_SECURE_X509_CRL_INDEX_TOO_SMALL                        0x1AB /* The entries given to a CRL index are fewer than the revoked certificates of the CRL. */
 
 /* Defines for working with private key types. */
 #define NX_SECURE_X509_KEY_TYPE_USER_DEFINED_MASK                 (0xFFFF0000)
@@ -517,6 +537,15 @@ typedef struct NX_SECURE_RSA_PRIVATE_KEY_STRUCT
     USHORT       nx_secure_rsa_private_prime_q_length;
     const UCHAR *nx_secure_rsa_private_prime_p;
     USHORT       nx_secure_rsa_private_prime_p_length;
+
+    /* d mod (p - 1), d mod (q - 1) and q ^ (-1) mod p. With them, the private
+       key operations of the CRT do not compute them from the primes each time. */
+    const UCHAR *nx_secure_rsa_private_exponent_p;
+    USHORT       nx_secure_rsa_private_exponent_p_length;
+    const UCHAR *nx_secure_rsa_private_exponent_q;
+    USHORT       nx_secure_rsa_private_exponent_q_length;
+    const UCHAR *nx_secure_rsa_private_coefficient;
+    USHORT       nx_secure_rsa_private_coefficient_length;
 } NX_SECURE_RSA_PRIVATE_KEY;
 
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
@@ -857,6 +886,39 @@ typedef struct NX_SECURE_X509_CRL_STRUCT
     ULONG        nx_secure_x509_crl_revoked_certs_length;
 } NX_SECURE_X509_CRL;
 
+/* Value of nx_secure_x509_crl_index_id once an index is created. */
+#define NX_SECURE_X509_CRL_INDEX_ID                     ((ULONG)0x43524C49)
+
+/* Entry of a CRL index, for a revoked certificate. */
+typedef struct NX_SECURE_X509_CRL_INDEX_ENTRY_STRUCT
+{
+    /* Hash of the serial number, the entries are sorted by it. */
+    ULONG nx_secure_x509_crl_index_entry_hash;
+
+    /* Offset of the entry in the revokedCertificates list, to compare the serial number in full. */
+    ULONG nx_secure_x509_crl_index_entry_offset;
+} NX_SECURE_X509_CRL_INDEX_ENTRY;
+
+/* A CRL parsed and authenticated once, see nx_secure_x509_crl_index_create. The CRL data stays where
+   it was, the entries are supplied by the application. */
+typedef struct NX_SECURE_X509_CRL_INDEX_STRUCT
+{
+    /* Set to NX_SECURE_X509_CRL_INDEX_ID once the index is complete. */
+    ULONG nx_secure_x509_crl_index_id;
+
+    /* The CRL parsed. */
+    NX_SECURE_X509_CRL nx_secure_x509_crl_index_crl;
+
+    /* Entries of the revoked certificates, sorted by hash. */
+    NX_SECURE_X509_CRL_INDEX_ENTRY *nx_secure_x509_crl_index_entries;
+    UINT                            nx_secure_x509_crl_index_count;
+
+#if NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+    /* Bloom filter of the serial numbers of the revoked certificates. */
+    UCHAR nx_secure_x509_crl_index_bloom[(NX_SECURE_X509_CRL_INDEX_BLOOM_BITS + 7) >> 3];
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+} NX_SECURE_X509_CRL_INDEX;
+
 #endif
 
 /* X509 API. */
@@ -938,6 +1000,13 @@ UINT _nx_secure_x509_certificate_verify(NX_SECURE_X509_CERTIFICATE_STORE *store,
 UINT _nx_secure_x509_certificate_chain_verify(NX_SECURE_X509_CERTIFICATE_STORE *store,
                                               NX_SECURE_X509_CERT *certificate);
 
+#if (NX_SECURE_X509_VERIFY_CACHE_SIZE > 0)
+/* Verify a certificate against its issuer, unless it was verified recently. */
+UINT _nx_secure_x509_certificate_verify_cached(NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                               NX_SECURE_X509_CERT *certificate,
+                                               NX_SECURE_X509_CERT *issuer_certificate);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
 /* Parse an OID string, returning an internally-used constant (defined above) for use in other parsing. */
 VOID _nx_secure_x509_oid_parse(const UCHAR *oid, ULONG length, UINT *oid_value);
 
@@ -988,6 +1057,15 @@ UINT _nx_secure_x509_crl_revocation_check(const UCHAR *crl_data, UINT length,
 UINT _nx_secure_x509_crl_verify(NX_SECURE_X509_CERT *certificate, NX_SECURE_X509_CRL *crl,
                                 NX_SECURE_X509_CERTIFICATE_STORE *store,
                                 NX_SECURE_X509_CERT *issuer_certificate);
+UINT _nx_secure_x509_crl_parse_entry(const UCHAR *buffer, ULONG length, UINT *bytes_processed,
+                                     const UCHAR **serial_number, UINT *serial_number_length);
+UINT _nx_secure_x509_crl_index_create(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                      const UCHAR *crl_data, UINT crl_length,
+                                      NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                      NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT entries_count);
+ULONG _nx_secure_x509_crl_index_hash(const UCHAR *serial_number, UINT length);
+UINT _nx_secure_x509_crl_index_revocation_check(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                                NX_SECURE_X509_CERT *certificate);
 #endif /* NX_SECURE_X509_DISABLE_CRL */
 UINT _nx_secure_x509_expiration_check(NX_SECURE_X509_CERT *certificate, ULONG current_time);
 
@@ -1012,6 +1090,14 @@ UINT _nxe_secure_x509_dns_name_initialize(NX_SECURE_X509_DNS_NAME *dns_name,
 UINT _nxe_secure_x509_crl_revocation_check(const UCHAR *crl_data, UINT crl_length,
                                            NX_SECURE_X509_CERTIFICATE_STORE *store,
                                            NX_SECURE_X509_CERT *certificate);
+#ifndef NX_SECURE_X509_DISABLE_CRL
+UINT _nxe_secure_x509_crl_index_create(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                       const UCHAR *crl_data, UINT crl_length,
+                                       NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                       NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT entries_count);
+UINT _nxe_secure_x509_crl_index_revocation_check(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                                 NX_SECURE_X509_CERT *certificate);
+#endif /* NX_SECURE_X509_DISABLE_CRL */
 UINT _nxe_secure_x509_extended_key_usage_extension_parse(NX_SECURE_X509_CERT *certificate,
                                                          UINT key_usage);
 UINT _nxe_secure_x509_extension_find(NX_SECURE_X509_CERT *certificate,
@@ -1025,6 +1111,8 @@ UINT _nxe_secure_x509_key_usage_extension_parse(NX_SECURE_X509_CERT *certificate
 #define nx_secure_x509_common_name_dns_check              _nx_secure_x509_common_name_dns_check
 #define nx_secure_x509_dns_name_initialize                _nx_secure_x509_dns_name_initialize
 #define nx_secure_x509_crl_revocation_check               _nx_secure_x509_crl_revocation_check
+#define nx_secure_x509_crl_index_create                   _nx_secure_x509_crl_index_create
+#define nx_secure_x509_crl_index_revocation_check         _nx_secure_x509_crl_index_revocation_check
 #define nx_secure_x509_extended_key_usage_extension_parse _nx_secure_x509_extended_key_usage_extension_parse
 #define nx_secure_x509_extension_find                     _nx_secure_x509_extension_find
 #define nx_secure_x509_key_usage_extension_parse          _nx_secure_x509_key_usage_extension_parse
@@ -1033,6 +1121,8 @@ UINT _nxe_secure_x509_key_usage_extension_parse(NX_SECURE_X509_CERT *certificate
 #define nx_secure_x509_common_name_dns_check              _nxe_secure_x509_common_name_dns_check
 #define nx_secure_x509_dns_name_initialize                _nxe_secure_x509_dns_name_initialize
 #define nx_secure_x509_crl_revocation_check               _nxe_secure_x509_crl_revocation_check
+#define nx_secure_x509_crl_index_create                   _nxe_secure_x509_crl_index_create
+#define nx_secure_x509_crl_index_revocation_check         _nxe_secure_x509_crl_index_revocation_check
 #define nx_secure_x509_extended_key_usage_extension_parse _nxe_secure_x509_extended_key_usage_extension_parse
 #define nx_secure_x509_extension_find                     _nxe_secure_x509_extension_find
 #define nx_secure_x509_key_usage_extension_parse          _nxe_secure_x509_key_usage_extension_parse
@@ -1049,6 +1139,14 @@ UINT nx_secure_x509_dns_name_initialize(NX_SECURE_X509_DNS_NAME *dns_name,
 UINT nx_secure_x509_crl_revocation_check(const UCHAR *crl_data, UINT crl_length,
                                          NX_SECURE_X509_CERTIFICATE_STORE *store,
                                          NX_SECURE_X509_CERT *certificate);
+#ifndef NX_SECURE_X509_DISABLE_CRL
+UINT nx_secure_x509_crl_index_create(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                     const UCHAR *crl_data, UINT crl_length,
+                                     NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                     NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT entries_count);
+UINT nx_secure_x509_crl_index_revocation_check(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                               NX_SECURE_X509_CERT *certificate);
+#endif /* NX_SECURE_X509_DISABLE_CRL */
 UINT nx_secure_x509_extended_key_usage_extension_parse(NX_SECURE_X509_CERT *certificate,
                                                        UINT key_usage);
 UINT nx_secure_x509_extension_find(NX_SECURE_X509_CERT *certificate,
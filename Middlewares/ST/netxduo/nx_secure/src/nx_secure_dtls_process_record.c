@@ -175,7 +175,8 @@ NX_PACKET             *decrypted_packet;
         epoch_seq_num[6] = header_data[4];
         epoch_seq_num[7] = header_data[3];
 
-        /* Decrypt the record data. */
+        /* Decrypt the record data into a new packet. */
+        decrypted_packet = NX_NULL;
         status = _nx_secure_tls_record_payload_decrypt(tls_session, packet_ptr, header_length, message_length,
                                                        &decrypted_packet, (ULONG *)epoch_seq_num, (UCHAR)message_type,
                                                        wait_option);
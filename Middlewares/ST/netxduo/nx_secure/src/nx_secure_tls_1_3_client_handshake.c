@@ -161,6 +161,7 @@ UINT            alert_level;
 const NX_CRYPTO_METHOD
                *method_ptr = NX_NULL;
 const UCHAR    *server_random;
+CYCLE_PROFILE_SAVE_AREA
 
     /* Basic state machine for handshake:
      * 1. We have received a handshake message, now process the header.
@@ -248,7 +249,7 @@ const UCHAR    *server_random;
         packet_buffer += header_bytes;
 
         /* Allocate a packet for all send operations.  */
-        packet_pool = tls_session -> nx_secure_tls_packet_pool;
+        packet_pool = NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session);
 
         /* Hash this handshake message. We do not hash HelloRequest messages.
            Hashes include the handshake layer header but not the record layer header. */
@@ -267,7 +268,9 @@ const UCHAR    *server_random;
         {
         case NX_SECURE_TLS_SERVER_HELLO:
             /* Server has responded to our ClientHello. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_serverhello(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_SERVER_HELLO)
 
             /* RFC 8446 4.1.3:
                TLS 1.3 clients receiving a ServerHello indicating TLS 1.2 or below MUST check that 
@@ -311,7 +314,9 @@ const UCHAR    *server_random;
             break;
         case NX_SECURE_TLS_CERTIFICATE_MSG:
             /* Server has sent its certificate message. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_remote_certificate(tls_session, packet_buffer, message_length, packet_buffer_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_CERTIFICATE)
 
             if (status == NX_SUCCESS)
             {
@@ -345,7 +350,9 @@ const UCHAR    *server_random;
             }
 
             /* Final handshake message from the server, process it (verify the server handshake hash). */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_finished(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
             if (status != NX_SUCCESS)
             {
                 break;
@@ -363,7 +370,9 @@ const UCHAR    *server_random;
             break;
         case NX_SECURE_TLS_CERTIFICATE_VERIFY:
             /* Handle server-sent certificate verify. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_certificate_verify(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_CERTIFICATE)
             break;
         case NX_SECURE_TLS_NEW_SESSION_TICKET:
             /* TLS 1.3 post-handshake message. */
@@ -445,7 +454,7 @@ const UCHAR    *server_random;
             _nx_secure_tls_handshake_hash_update(tls_session, packet_start, message_length + header_bytes);
 
             /* Allocate a handshake packet so we can send the ClientHello. */
-            status = _nx_secure_tls_allocate_handshake_packet(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+            status = _nx_secure_tls_allocate_handshake_packet(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
             if (status != NX_SUCCESS)
             {
@@ -514,7 +523,9 @@ const UCHAR    *server_random;
             }
 
             /* Generate TLS 1.3 keys and secrets for the handshake. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_1_3_generate_handshake_keys(tls_session);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_KEY_EXCHANGE)
             if(status != NX_SUCCESS)
             {
                 break;
@@ -619,7 +630,9 @@ const UCHAR    *server_random;
                continue to the encrypted session. */
 
             /* Generate TLS 1.3 keys and secrets for the application data session. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_1_3_generate_session_keys(tls_session);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
             if(status != NX_SUCCESS)
             {
                 break;
@@ -649,7 +662,9 @@ const UCHAR    *server_random;
             }
 
             /* Generate and send the finished message, which completes the handshake. */
+            CYCLE_PROFILE_ENTER
             _nx_secure_tls_send_finished(tls_session, send_packet);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
 
             status = _nx_secure_tls_send_handshake_record(tls_session, send_packet, NX_SECURE_TLS_FINISHED, wait_option);
 
@@ -38,11 +38,23 @@ static UINT _nx_secure_tls_1_3_generate_handshake_secrets(NX_SECURE_TLS_SESSION
 static UINT _nx_secure_tls_1_3_generate_session_secrets(NX_SECURE_TLS_SESSION *tls_session);
 
 
+static UINT _nx_secure_tls_1_3_traffic_keys_generate(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+                                                     UCHAR *key_block, UINT key_block_size, UINT key_size, UINT iv_size,
+                                                     UCHAR *finished_key, UINT finished_key_size,
+                                                     const NX_CRYPTO_METHOD *hash_method);
+
 static UINT _nx_secure_tls_hkdf_expand_label(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
             UCHAR *label, UINT label_len, UCHAR *context, UINT context_len, UINT length,
             UCHAR *output, UINT output_length, const NX_CRYPTO_METHOD *hash_method);
 
-static UINT _nx_secure_tls_derive_secret(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+static UINT _nx_secure_tls_hkdf_prk_set(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+                                        const NX_CRYPTO_METHOD *hash_method);
+
+static UINT _nx_secure_tls_hkdf_label_expand(NX_SECURE_TLS_SESSION *tls_session,
+                                             UCHAR *label, UINT label_len, UCHAR *context, UINT context_len, UINT length,
+                                             UCHAR *output, UINT output_length);
+
+static UINT _nx_secure_tls_derive_secret(NX_SECURE_TLS_SESSION *tls_session,
                                   UCHAR *label, UINT label_len,
                                   UCHAR *message_hash, UINT message_hash_len,
                                   UCHAR *output, UINT output_length, const NX_CRYPTO_METHOD *hash_method);
@@ -138,8 +150,15 @@ UINT is_resumption_psk = NX_FALSE;
     label_length = 10;
 
     /* Ext/Res binder key has an empty messages context. */
-    status = _nx_secure_tls_derive_secret(tls_session, psk_entry->nx_secure_tls_psk_early_secret, psk_entry->nx_secure_tls_psk_early_secret_size,
-                                          label, label_length,
+    status = _nx_secure_tls_hkdf_prk_set(tls_session, psk_entry->nx_secure_tls_psk_early_secret,
+                                         psk_entry->nx_secure_tls_psk_early_secret_size, hash_method);
+
+    if(status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                           (UCHAR *)"", 0,
                                           psk_entry->nx_secure_tls_psk_binder_key, hash_length, hash_method);
 
@@ -281,64 +300,7 @@ UINT                                  hash_size;
 
     /* To generate handshake keys, we need the [sender]_handshake_traffic_secret. */
 
-    /* Generate client traffic key. */
-    key_offset = 0;
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_client_handshake_traffic_secret, secrets->tls_client_handshake_traffic_secret_len,
-                                          (UCHAR *)"key", 3, (UCHAR *)"", 0, key_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_write_key = &key_block[key_offset];
-
-    key_offset += key_size;
-
-    /* Generate client traffic IV. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_client_handshake_traffic_secret, secrets->tls_client_handshake_traffic_secret_len,
-                                          (UCHAR *)"iv", 2, (UCHAR *)"", 0, iv_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_iv = &key_block[key_offset];
-    
-    key_offset += iv_size;
-
-    /* Generate server-side key. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_server_handshake_traffic_secret, secrets->tls_server_handshake_traffic_secret_len,
-                                          (UCHAR *)"key", 3, (UCHAR *)"", 0, key_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_write_key = &key_block[key_offset];
-
-    key_offset += key_size;
-
-    /* Generate server-side IV. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_server_handshake_traffic_secret, secrets->tls_server_handshake_traffic_secret_len,
-                                          (UCHAR *)"iv", 2, (UCHAR *)"", 0, iv_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_iv = &key_block[key_offset];
-
-    key_offset += iv_size;
-
-    /* We now have the session keys so we can generate the Finished keys for both client and server. */
+    /* We generate the Finished keys for both client and server along with the session keys. */
     /*  From RFC 8446 (TLS 1.3):
         finished_key =
               HKDF-Expand-Label(BaseKey, "finished", "", Hash.length)
@@ -347,30 +309,41 @@ UINT                                  hash_size;
     /* Get hash size for this ciphersuite. */
     hash_size = tls_session -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_hash_size;
 
-    /* Generate server-side Finished Key. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_server_handshake_traffic_secret, secrets->tls_server_handshake_traffic_secret_len,
-                                          (UCHAR *)"finished", 8, (UCHAR *)"", 0, hash_size,
-                                          &secrets->tls_server_finished_key[0], (key_block_size - key_offset), hash_method);
+    /* Generate client traffic key and IV, and the client-side Finished key. */
+    key_offset = 0;
+    status = _nx_secure_tls_1_3_traffic_keys_generate(tls_session, secrets->tls_client_handshake_traffic_secret,
+                                                      secrets->tls_client_handshake_traffic_secret_len,
+                                                      &key_block[key_offset], (key_block_size - key_offset), key_size, iv_size,
+                                                      secrets->tls_client_finished_key, sizeof(secrets->tls_client_finished_key),
+                                                      hash_method);
 
     if(status != NX_SUCCESS)
     {
         return(status);
     }
 
-    secrets->tls_server_finished_key_len = hash_size;
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_write_key = &key_block[key_offset];
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_iv = &key_block[key_offset + key_size];
+    secrets->tls_client_finished_key_len = hash_size;
 
-    /* Generate client-side Finished Key. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_client_handshake_traffic_secret, secrets->tls_client_handshake_traffic_secret_len,
-                                          (UCHAR *)"finished", 8, (UCHAR *)"", 0, hash_size,
-                                          &secrets->tls_client_finished_key[0], (key_block_size - key_offset), hash_method);
+    key_offset += key_size + iv_size;
 
-    secrets->tls_client_finished_key_len = hash_size;
+    /* Generate server-side key and IV, and the server-side Finished key. */
+    status = _nx_secure_tls_1_3_traffic_keys_generate(tls_session, secrets->tls_server_handshake_traffic_secret,
+                                                      secrets->tls_server_handshake_traffic_secret_len,
+                                                      &key_block[key_offset], (key_block_size - key_offset), key_size, iv_size,
+                                                      secrets->tls_server_finished_key, sizeof(secrets->tls_server_finished_key),
+                                                      hash_method);
 
     if(status != NX_SUCCESS)
     {
         return(status);
     }
 
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_write_key = &key_block[key_offset];
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_iv = &key_block[key_offset + key_size];
+    secrets->tls_server_finished_key_len = hash_size;
+
 
     /* Now, we can initialize our crypto routines and turn on encryption. */
     /* Initialize the crypto method used in the session cipher. */
@@ -549,13 +522,14 @@ UINT                                  key_offset;
     tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_write_mac_secret = secrets->tls_client_application_traffic_secret_0;
     tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_write_mac_secret = secrets->tls_server_application_traffic_secret_0;
 
-    /* To generate handshake keys, we need the [sender]_handshake_traffic_secret. */
+    /* To generate session keys, we need the [sender]_application_traffic_secret_0. */
 
-    /* Generate client traffic key. */
+    /* Generate client traffic key and IV. */
     key_offset = 0;
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_client_application_traffic_secret_0, secrets->tls_client_application_traffic_secret_0_len,
-                                          (UCHAR *)"key", 3, (UCHAR *)"", 0, key_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
+    status = _nx_secure_tls_1_3_traffic_keys_generate(tls_session, secrets->tls_client_application_traffic_secret_0,
+                                                      secrets->tls_client_application_traffic_secret_0_len,
+                                                      &key_block[key_offset], (key_block_size - key_offset), key_size, iv_size,
+                                                      NX_NULL, 0, hash_method);
 
     if(status != NX_SUCCESS)
     {
@@ -564,27 +538,15 @@ UINT                                  key_offset;
 
     /* Save the generated keys to the on-deck space (don't initialize yet). */
     tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_next_write_key = &key_block[key_offset];
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_next_iv = &key_block[key_offset + key_size];
 
-    key_offset += key_size;
+    key_offset += key_size + iv_size;
 
-    /* Generate client traffic IV. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_client_application_traffic_secret_0, secrets->tls_client_application_traffic_secret_0_len,
-                                          (UCHAR *)"iv", 2, (UCHAR *)"", 0, iv_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_next_iv = &key_block[key_offset];
-
-    key_offset += iv_size;
-
-    /* Generate server-side key. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_server_application_traffic_secret_0, secrets->tls_server_application_traffic_secret_0_len,
-                                          (UCHAR *)"key", 3, (UCHAR *)"", 0, key_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
+    /* Generate server-side key and IV. */
+    status = _nx_secure_tls_1_3_traffic_keys_generate(tls_session, secrets->tls_server_application_traffic_secret_0,
+                                                      secrets->tls_server_application_traffic_secret_0_len,
+                                                      &key_block[key_offset], (key_block_size - key_offset), key_size, iv_size,
+                                                      NX_NULL, 0, hash_method);
 
     if(status != NX_SUCCESS)
     {
@@ -592,27 +554,7 @@ UINT                                  key_offset;
     }
 
     tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_next_write_key = &key_block[key_offset];
-
-    key_offset += key_size;
-
-    /* Generate server-side IV. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secrets->tls_server_application_traffic_secret_0, secrets->tls_server_application_traffic_secret_0_len,
-                                          (UCHAR *)"iv", 2, (UCHAR *)"", 0, iv_size,
-                                          &key_block[key_offset], (key_block_size - key_offset), hash_method);
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
-
-    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_next_iv = &key_block[key_offset];
-
-    key_offset += iv_size;
-
-    if(status != NX_SUCCESS)
-    {
-        return(status);
-    }
+    tls_session -> nx_secure_tls_key_material.nx_secure_tls_server_next_iv = &key_block[key_offset + key_size];
 
     return(NX_SUCCESS);
 
@@ -752,7 +694,6 @@ UCHAR *psk_secret;
 UINT   psk_secret_length;
 UCHAR *label;
 UINT label_length;
-UINT is_resumption_psk = NX_FALSE;
 
     if (tls_session -> nx_secure_tls_session_ciphersuite == NX_NULL)
     {
@@ -900,62 +841,21 @@ UINT is_resumption_psk = NX_FALSE;
         secrets->tls_early_secret_len = hash_length;
     }
 
-    /* Generate keys and secrets based on the "early secret". */
-    if(secrets->tls_early_secret_len != 0)
-    {
-        /*----- Binder key value. -----*/
-
-        /* Get the appropriate label for our secret derivation. */
-        label = (UCHAR *)((is_resumption_psk)? "res binder" : "ext binder");
-        label_length = 10;
-
-        /* Ext/Res binder key has an empty messages context. */
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_early_secret, secrets->tls_early_secret_len, label, label_length,
-                                              (UCHAR *)"", 0,
-                                              secrets->tls_binder_key, hash_length, hash_method);
-
-        if(status != NX_SUCCESS)
-        {
-            return(status);
-        }
-        secrets->tls_binder_key_len = hash_length;
-
-        /*----- Early traffic secret. -----*/
-        label = (UCHAR *)"c e traffic";
-        label_length = 11;
-
-        /* Context is hash of ClientHello. */
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_early_secret, secrets->tls_early_secret_len, label, label_length,
-                                              (UCHAR *)"FIXME", 5,
-                                              secrets->tls_client_early_traffic_secret, hash_length, hash_method);
-
-        if(status != NX_SUCCESS)
-        {
-            return(status);
-        }
-        secrets->tls_client_early_traffic_secret_len = hash_length;
-
-        /*----- Early exporter master secret. -----*/
-        label = (UCHAR *)"e exp master";
-        label_length = 12;
+    /* The binder key and the early traffic and exporter secrets of the "early secret" are not derived here:
+       the PSK binders use those of _nx_secure_tls_1_3_generate_psk_secret and there is no 0-RTT data. */
 
-        /* Context is hash of ClientHello. */
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_early_secret, secrets->tls_early_secret_len, label, label_length,
-                                              (UCHAR *)"FIXME", 5,
-                                              secrets->tls_early_exporter_master_secret, hash_length, hash_method);
+    /* Handshake secret - special case! Needs a pre-master secret from the ECDHE exchange and the early secret from above. */
+    if(secrets->tls_handshake_secret_len == 0 && tls_session->nx_secure_tls_key_material.nx_secure_tls_pre_master_secret_size != 0)
+    {
+        /* Start by deriving the salt from the early secret. Context is empty! */
+        status = _nx_secure_tls_hkdf_prk_set(tls_session, secrets->tls_early_secret, secrets->tls_early_secret_len, hash_method);
 
         if(status != NX_SUCCESS)
         {
             return(status);
         }
-        secrets->tls_early_exporter_master_secret_len = hash_length;
-    }
 
-    /* Handshake secret - special case! Needs a pre-master secret from the ECDHE exchange and the early secret from above. */
-    if(secrets->tls_handshake_secret_len == 0 && tls_session->nx_secure_tls_key_material.nx_secure_tls_pre_master_secret_size != 0)
-    {
-        /* Start by deriving the salt from the early secret. Context is empty! */
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_early_secret, secrets->tls_early_secret_len, (UCHAR *)"derived", 7,
+        status = _nx_secure_tls_derive_secret(tls_session, (UCHAR *)"derived", 7,
                                               (UCHAR *)"", 0,
                                               secrets->tls_handshake_secret, hash_length, hash_method);
 
@@ -981,11 +881,19 @@ UINT is_resumption_psk = NX_FALSE;
     /* Generate keys and secrets based on the "handshake secret". */
     if(secrets->tls_handshake_secret_len != 0)
     {
+        /* Both traffic secrets expand the handshake secret, key the HKDF with it once. */
+        status = _nx_secure_tls_hkdf_prk_set(tls_session, secrets->tls_handshake_secret, secrets->tls_handshake_secret_len, hash_method);
+
+        if(status != NX_SUCCESS)
+        {
+            return(status);
+        }
+
         /*----- Client handshake traffic secret. -----*/
         label = (UCHAR *)"c hs traffic";
         label_length = 12;
 
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_handshake_secret, secrets->tls_handshake_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               tls_session->nx_secure_tls_key_material.nx_secure_tls_transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_SERVERHELLO], hash_length,
                                               secrets->tls_client_handshake_traffic_secret, hash_length, hash_method);
 
@@ -999,7 +907,7 @@ UINT is_resumption_psk = NX_FALSE;
         label = (UCHAR *)"s hs traffic";
         label_length = 12;
 
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_handshake_secret, secrets->tls_handshake_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               tls_session->nx_secure_tls_key_material.nx_secure_tls_transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_SERVERHELLO], hash_length,
                                               secrets->tls_server_handshake_traffic_secret, hash_length, hash_method);
 
@@ -1084,8 +992,15 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
     /* Application Master secret - special case! Needs a secret derived from the previous secret. */
     if(secrets->tls_master_secret_len == 0 && secrets->tls_handshake_secret_len != 0)
     {
-        /* Start by deriving the salt from the handshake secret. Context is empty! */     
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_handshake_secret, secrets->tls_handshake_secret_len, (UCHAR *)"derived", 7,
+        /* Start by deriving the salt from the handshake secret. Context is empty! */
+        status = _nx_secure_tls_hkdf_prk_set(tls_session, secrets->tls_handshake_secret, secrets->tls_handshake_secret_len, hash_method);
+
+        if(status != NX_SUCCESS)
+        {
+            return(status);
+        }
+
+        status = _nx_secure_tls_derive_secret(tls_session, (UCHAR *)"derived", 7,
                                               (UCHAR *)"", 0,
                                               secrets->tls_master_secret, hash_length, hash_method);
 
@@ -1110,11 +1025,19 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
     /* Derive secrets based on the application master secret. */
     if(secrets->tls_master_secret_len != 0)
     {
+        /* All four secrets expand the master secret, key the HKDF with it once. */
+        status = _nx_secure_tls_hkdf_prk_set(tls_session, secrets->tls_master_secret, secrets->tls_master_secret_len, hash_method);
+
+        if(status != NX_SUCCESS)
+        {
+            return(status);
+        }
+
         /*----- Client application traffic secret 0. -----*/
         label = (UCHAR *)"c ap traffic";
         label_length = 12;
         
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_master_secret, secrets->tls_master_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_SERVER_FINISHED], hash_length,
                                               secrets->tls_client_application_traffic_secret_0, hash_length, hash_method);
 
@@ -1128,7 +1051,7 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
         label = (UCHAR *)"s ap traffic";
         label_length = 12;
 
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_master_secret, secrets->tls_master_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_SERVER_FINISHED], hash_length,
                                               secrets->tls_server_application_traffic_secret_0, hash_length, hash_method);
 
@@ -1142,7 +1065,7 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
         label = (UCHAR *)"exp master";
         label_length = 10;
 
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_master_secret, secrets->tls_master_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_SERVER_FINISHED], hash_length,
                                               secrets->tls_exporter_master_secret, hash_length, hash_method);
 
@@ -1150,13 +1073,13 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
         {
             return(status);
         }
-        secrets->tls_early_exporter_master_secret_len = hash_length;
+        secrets->tls_exporter_master_secret_len = hash_length;
 
         /*----- Resumption master secret. -----*/
         label = (UCHAR *)"res master";
         label_length = 10;
 
-        status = _nx_secure_tls_derive_secret(tls_session, secrets->tls_master_secret, secrets->tls_master_secret_len, label, label_length,
+        status = _nx_secure_tls_derive_secret(tls_session, label, label_length,
                                               transcript_hashes[NX_SECURE_TLS_TRANSCRIPT_IDX_CLIENT_FINISHED], hash_length,
                                               secrets->tls_resumption_master_secret, hash_length, hash_method);
 
@@ -1185,7 +1108,9 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function is used by TLS 1.3 in generating key material.        */
+/*    This function is used by TLS 1.3 in generating key material. The    */
+/*    secret is the PRK set by _nx_secure_tls_hkdf_prk_set, so that the   */
+/*    secrets derived from the same one key the HKDF once.                */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -1212,9 +1137,11 @@ UCHAR (*transcript_hashes)[NX_SECURE_TLS_MAX_HASH_SIZE] = tls_session->nx_secure
 /**************************************************************************/
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 
-static UCHAR _nx_secure_tls_temp_hash[100];
+/* Hash of the empty string, the same for all sessions, and its hash method. */
+static UCHAR _nx_secure_tls_empty_hash[NX_SECURE_TLS_MAX_HASH_SIZE];
+static const NX_CRYPTO_METHOD *_nx_secure_tls_empty_hash_method;
 
-static UINT _nx_secure_tls_derive_secret(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+static UINT _nx_secure_tls_derive_secret(NX_SECURE_TLS_SESSION *tls_session,
                                   UCHAR *label, UINT label_len,
                                   UCHAR *message_hash, UINT message_hash_len,
                                   UCHAR *output, UINT output_length, const NX_CRYPTO_METHOD *hash_method)
@@ -1237,10 +1164,21 @@ UINT hash_length;
        messages stored in the TLS session context. In some contexts, the message hash will be of 0 length! */
     if(message_hash_len == 0)
     {
-        /* Point the message hash at our temporary buffer. */
-        message_hash = &_nx_secure_tls_temp_hash[0];
+        if (hash_length > sizeof(_nx_secure_tls_empty_hash))
+        {
+
+            /* Buffer too small. */
+            return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+        }
+
+        /* Point the message hash at the hash of the empty string. */
+        message_hash = &_nx_secure_tls_empty_hash[0];
         message_hash_len = hash_length;
+    }
 
+    /* Compute the hash of the empty string once for each hash method. */
+    if ((message_hash == _nx_secure_tls_empty_hash) && (_nx_secure_tls_empty_hash_method != hash_method))
+    {
         /* Context has 0 length, so generate a hash on the empty string to feed into expand label call below.
          * Utilize the temporary "hash scratch" data buffer to initialize and calculate the hash. */
         if (hash_method -> nx_crypto_init)
@@ -1330,12 +1268,14 @@ UINT hash_length;
             }
 
         }
+
+        _nx_secure_tls_empty_hash_method = hash_method;
     }
 
-    /* Now derive the output by calling HKDF-Expand-Label. */
-    status = _nx_secure_tls_hkdf_expand_label(tls_session, secret, secret_len,
+    /* Now derive the output by calling HKDF-Expand-Label, the PRK set to the secret. */
+    status = _nx_secure_tls_hkdf_label_expand(tls_session,
             label, label_len, message_hash, message_hash_len, hash_length,
-            output, output_length, hash_method);
+            output, output_length);
 
     return(status);
 }
@@ -1354,7 +1294,8 @@ UINT hash_length;
 /*                                                                        */
 /*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function is used by TLS 1.3 in generating key material.        */
+/*    This function is used by TLS 1.3 in generating key material, from   */
+/*    a secret expanded once.                                             */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -1382,68 +1323,82 @@ UINT hash_length;
 /**************************************************************************/
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 
-/* Buffer for HKDF output. The HKDF temporary can technically be as big as 
-   514 bytes: 2 (length) + 1 (label length byte) + 255 (label) + 1 (context length byte) + 255 (context). 
-   However, 100 bytes is sufficient for the mandatory ciphersuite. */
-static UCHAR _nx_secure_tls_hkdf_temp_output[100];
 static UINT _nx_secure_tls_hkdf_expand_label(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
                                       UCHAR *label, UINT label_len, UCHAR *context, UINT context_len, UINT length,
                                       UCHAR *output, UINT output_length, const NX_CRYPTO_METHOD *hash_method)
 {
 UINT                                 status;
-UINT                                 data_len;
-const NX_CRYPTO_METHOD                     *session_hkdf_method = NX_NULL;
-const NX_CRYPTO_METHOD                     *session_hmac_method = NX_NULL;
 
-/*VOID                                 *handler = NX_NULL;*/
-    /* From RFC 8446, section 7.1:
-    HKDF-Expand-Label(Secret, Label, Context, Length) =
-           HKDF-Expand(Secret, HkdfLabel, Length)
 
-      Where HkdfLabel is specified as:
+    /* Key the HKDF with the secret, then expand the label. */
+    status = _nx_secure_tls_hkdf_prk_set(tls_session, secret, secret_len, hash_method);
 
-      struct {
-          uint16 length = Length;
-          opaque label<7..255> = "tls13 " + Label;
-          opaque context<0..255> = Context;
-      } HkdfLabel;
-    */
-
-    if (sizeof(_nx_secure_tls_hkdf_temp_output) < (10u + label_len + context_len))
+    if(status != NX_SUCCESS)
     {
-
-        /* Buffer too small. */
-        return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+        return(status);
     }
 
-    /* Get our HKDF method and hash routine. */
-    /*session_hash_method = ciphersuite->nx_secure_tls_hash;*/
-    session_hkdf_method = tls_session->nx_secure_tls_crypto_table->nx_secure_tls_hkdf_method;
-    session_hmac_method = tls_session->nx_secure_tls_crypto_table->nx_secure_tls_hmac_method;
+    status = _nx_secure_tls_hkdf_label_expand(tls_session, label, label_len, context, context_len, length,
+                                              output, output_length);
 
-    /* Now build the HkdfLabel from our inputs. */
-    _nx_secure_tls_hkdf_temp_output[0] = (UCHAR)((length & 0xFF00) >> 8);
-    _nx_secure_tls_hkdf_temp_output[1] = (UCHAR)(length & 0x00FF);
-    data_len = 2;
+    return(status);
+}
+#endif
 
-    /* Add the length of the label (single octet). */
-    _nx_secure_tls_hkdf_temp_output[data_len] = (UCHAR)(6 + label_len);
-    data_len = data_len + 1;
-    
-    /* Now copy in label with TLS 1.3 prefix. */
-    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], "tls13 ", 6); /* Use case of memcpy is verified. */
-    data_len += 6;
-    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], label, label_len); /* Use case of memcpy is verified. */
-    data_len += label_len;
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_hkdf_prk_set                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is used by TLS 1.3 to key the HKDF with a secret, the */
+/*    PRK the next HKDF-Expand-Label operations expand. The HMAC states   */
+/*    keyed with the secret are computed by the first expansion and       */
+/*    reused by the next ones, until the HKDF is keyed again.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    secret                                Secret, the PRK               */
+/*    secret_len                            Length of secret              */
+/*    hash_method                           Hash method of the HMAC       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [nx_crypto_init]                      Initialize the HKDF           */
+/*    [nx_crypto_operation]                 Set the HKDF methods and PRK  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_1_3_generate_psk_secret                              */
+/*                                          Generate the PSK secrets      */
+/*    _nx_secure_tls_1_3_traffic_keys_generate                            */
+/*                                          Generate the traffic keys     */
+/*    _nx_secure_tls_hkdf_expand_label      Expand a label of a secret    */
+/*    _nx_secure_tls_1_3_generate_handshake_secrets                       */
+/*                                          Generate the handshake secrets*/
+/*    _nx_secure_tls_1_3_generate_session_secrets                         */
+/*                                          Generate the session secrets  */
+/*                                                                        */
+/**************************************************************************/
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 
-    /* Add the length of the context (single octet). */
-    _nx_secure_tls_hkdf_temp_output[data_len] = (UCHAR)(context_len);
-    data_len = data_len + 1;    
-    
-    /* Now copy in context. */
-    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], context, context_len); /* Use case of memcpy is verified. */
-    data_len += context_len;
+static UINT _nx_secure_tls_hkdf_prk_set(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+                                        const NX_CRYPTO_METHOD *hash_method)
+{
+UINT                                 status;
+const NX_CRYPTO_METHOD                     *session_hkdf_method = NX_NULL;
+const NX_CRYPTO_METHOD                     *session_hmac_method = NX_NULL;
 
+    /* Get our HKDF method and hash routine. */
+    session_hkdf_method = tls_session->nx_secure_tls_crypto_table->nx_secure_tls_hkdf_method;
+    session_hmac_method = tls_session->nx_secure_tls_crypto_table->nx_secure_tls_hmac_method;
 
     /* Initialize the HKDF context. */
     status = session_hkdf_method->nx_crypto_init((NX_CRYPTO_METHOD*)session_hkdf_method, NX_NULL, 0, NX_NULL,
@@ -1494,12 +1449,118 @@ const NX_CRYPTO_METHOD                     *session_hmac_method = NX_NULL;
                                              tls_session -> nx_secure_tls_prf_metadata_size,
                                              NX_NULL, NX_NULL);
 
-    if(status != NX_CRYPTO_SUCCESS)
+    return(status);
+}
+#endif
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_hkdf_label_expand                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is used by TLS 1.3 to run HKDF-Expand-Label on the    */
+/*    PRK set by _nx_secure_tls_hkdf_prk_set, for exactly the length      */
+/*    octets of output.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    label                                 Label, without the prefix     */
+/*    label_len                             Length of label               */
+/*    context                               Context                       */
+/*    context_len                           Length of context             */
+/*    length                                Length of output to expand    */
+/*    output                                Output buffer                 */
+/*    output_length                         Size of output buffer         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [nx_crypto_operation]                 Expand the HKDF label         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_1_3_traffic_keys_generate                            */
+/*                                          Generate the traffic keys     */
+/*    _nx_secure_tls_derive_secret          Derive a secret               */
+/*    _nx_secure_tls_hkdf_expand_label      Expand a label of a secret    */
+/*                                                                        */
+/**************************************************************************/
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+
+/* Buffer for HKDF output. The HKDF temporary can technically be as big as 
+   514 bytes: 2 (length) + 1 (label length byte) + 255 (label) + 1 (context length byte) + 255 (context). 
+   However, 100 bytes is sufficient for the mandatory ciphersuite. */
+static UCHAR _nx_secure_tls_hkdf_temp_output[100];
+static UINT _nx_secure_tls_hkdf_label_expand(NX_SECURE_TLS_SESSION *tls_session,
+                                             UCHAR *label, UINT label_len, UCHAR *context, UINT context_len, UINT length,
+                                             UCHAR *output, UINT output_length)
+{
+UINT                                 status;
+UINT                                 data_len;
+const NX_CRYPTO_METHOD                     *session_hkdf_method = NX_NULL;
+
+    /* From RFC 8446, section 7.1:
+    HKDF-Expand-Label(Secret, Label, Context, Length) =
+           HKDF-Expand(Secret, HkdfLabel, Length)
+
+      Where HkdfLabel is specified as:
+
+      struct {
+          uint16 length = Length;
+          opaque label<7..255> = "tls13 " + Label;
+          opaque context<0..255> = Context;
+      } HkdfLabel;
+    */
+
+    if (sizeof(_nx_secure_tls_hkdf_temp_output) < (10u + label_len + context_len))
     {
-        return(status);
+
+        /* Buffer too small. */
+        return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
     }
 
-    /* Now perform the HKDF operation. */
+    if (length > output_length)
+    {
+
+        /* Output too small. */
+        return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+    }
+
+    /* Get our HKDF method. */
+    session_hkdf_method = tls_session->nx_secure_tls_crypto_table->nx_secure_tls_hkdf_method;
+
+    /* Now build the HkdfLabel from our inputs. */
+    _nx_secure_tls_hkdf_temp_output[0] = (UCHAR)((length & 0xFF00) >> 8);
+    _nx_secure_tls_hkdf_temp_output[1] = (UCHAR)(length & 0x00FF);
+    data_len = 2;
+
+    /* Add the length of the label (single octet). */
+    _nx_secure_tls_hkdf_temp_output[data_len] = (UCHAR)(6 + label_len);
+    data_len = data_len + 1;
+    
+    /* Now copy in label with TLS 1.3 prefix. */
+    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], "tls13 ", 6); /* Use case of memcpy is verified. */
+    data_len += 6;
+    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], label, label_len); /* Use case of memcpy is verified. */
+    data_len += label_len;
+
+    /* Add the length of the context (single octet). */
+    _nx_secure_tls_hkdf_temp_output[data_len] = (UCHAR)(context_len);
+    data_len = data_len + 1;    
+    
+    /* Now copy in context. */
+    NX_CRYPTO_MEMCPY(&_nx_secure_tls_hkdf_temp_output[data_len], context, context_len); /* Use case of memcpy is verified. */
+    data_len += context_len;
+
+
+    /* Now perform the HKDF operation, the PRK set to the secret. Expand only the Length octets. */
     status = session_hkdf_method->nx_crypto_operation(NX_CRYPTO_HKDF_EXPAND,
                                              NX_NULL,
                                              (NX_CRYPTO_METHOD*)session_hkdf_method,
@@ -1509,7 +1570,7 @@ const NX_CRYPTO_METHOD                     *session_hmac_method = NX_NULL;
                                              0,
                                              NX_NULL,
                                              (UCHAR *)output,
-                                             output_length,
+                                             length,
                                              tls_session -> nx_secure_tls_prf_metadata_area,
                                              tls_session -> nx_secure_tls_prf_metadata_size,
                                              NX_NULL, NX_NULL);
@@ -1518,6 +1579,103 @@ const NX_CRYPTO_METHOD                     *session_hmac_method = NX_NULL;
 }
 #endif
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_1_3_traffic_keys_generate            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is used by TLS 1.3 to generate the write key and IV   */
+/*    of one side from its traffic secret, followed in the key block, and */
+/*    the Finished key of that side if requested. All are expansions of   */
+/*    the same secret, which keys the HKDF once for them.                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    secret                                Traffic secret                */
+/*    secret_len                            Length of traffic secret      */
+/*    key_block                             Key block for the key and IV  */
+/*    key_block_size                        Size of key block             */
+/*    key_size                              Length of the write key       */
+/*    iv_size                               Length of the write IV        */
+/*    finished_key                          Finished key, or NX_NULL      */
+/*    finished_key_size                     Size of Finished key buffer   */
+/*    hash_method                           Hash method of the HMAC       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_hkdf_prk_set           Key the HKDF with a secret    */
+/*    _nx_secure_tls_hkdf_label_expand      Expand a label                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_1_3_generate_handshake_keys                          */
+/*                                          Generate the handshake keys   */
+/*    _nx_secure_tls_1_3_generate_session_keys                            */
+/*                                          Generate the session keys     */
+/*                                                                        */
+/**************************************************************************/
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+
+static UINT _nx_secure_tls_1_3_traffic_keys_generate(NX_SECURE_TLS_SESSION *tls_session, UCHAR *secret, UINT secret_len,
+                                                     UCHAR *key_block, UINT key_block_size, UINT key_size, UINT iv_size,
+                                                     UCHAR *finished_key, UINT finished_key_size,
+                                                     const NX_CRYPTO_METHOD *hash_method)
+{
+UINT status;
+
+    if ((key_size + iv_size) > key_block_size)
+    {
+
+        /* Buffer too small. */
+        return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+    }
+
+    /* Key the HKDF with the traffic secret, for all the keys below. */
+    status = _nx_secure_tls_hkdf_prk_set(tls_session, secret, secret_len, hash_method);
+
+    if(status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Generate traffic key. */
+    status = _nx_secure_tls_hkdf_label_expand(tls_session, (UCHAR *)"key", 3, (UCHAR *)"", 0, key_size,
+                                              key_block, key_size);
+
+    if(status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Generate traffic IV, after the key. */
+    status = _nx_secure_tls_hkdf_label_expand(tls_session, (UCHAR *)"iv", 2, (UCHAR *)"", 0, iv_size,
+                                              &key_block[key_size], iv_size);
+
+    if(status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Generate Finished key. */
+    if (finished_key != NX_NULL)
+    {
+        status = _nx_secure_tls_hkdf_label_expand(tls_session, (UCHAR *)"finished", 8, (UCHAR *)"", 0,
+                                                  (hash_method -> nx_crypto_ICV_size_in_bits >> 3),
+                                                  finished_key, finished_key_size);
+    }
+
+    return(status);
+}
+#endif
+
 
 /**************************************************************************/
 /*                                                                        */
@@ -207,7 +207,7 @@ NX_SECURE_TLS_SERVER_STATE            old_server_state;
     packet_buffer += header_bytes;
 
     /* Get reference to the packet pool so we can allocate a packet for all send operations.  */
-    packet_pool = tls_session -> nx_secure_tls_packet_pool;
+    packet_pool = NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session);
 
     /* Process the message itself information from the header. */
     status = NX_SECURE_TLS_SUCCESS;
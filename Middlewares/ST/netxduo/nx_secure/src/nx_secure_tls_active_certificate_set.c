@@ -80,11 +80,18 @@
 UINT _nx_secure_tls_active_certificate_set(NX_SECURE_TLS_SESSION *tls_session,
                                            NX_SECURE_X509_CERT *certificate)
 {
+#ifndef NX_SECURE_DISABLE_X509
 
     /* Set the active certificate (should be in the store). */
     tls_session -> nx_secure_tls_credentials.nx_secure_tls_active_certificate = certificate;
 
     /* Return completion status.  */
     return(NX_SUCCESS);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(certificate);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
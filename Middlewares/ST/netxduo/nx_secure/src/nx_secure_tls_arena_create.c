@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_arena_create                         PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function creates a TLS session arena in the supplied memory.   */
+/*    TLS sessions created with nx_secure_tls_session_arena_create take   */
+/*    their crypto metadata and packet buffer from the arena and return   */
+/*    them when deleted, so the memory is sized for the sessions open at  */
+/*    the same time instead of a static set of buffers for each one.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    arena_ptr                             Pointer to arena              */
+/*    name_ptr                              Name of arena                 */
+/*    memory_ptr                            Pointer to arena memory       */
+/*    memory_size                           Size of arena memory          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_byte_pool_create                   Create byte pool              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_arena_create(NX_SECURE_TLS_ARENA *arena_ptr, CHAR *name_ptr,
+                                 VOID *memory_ptr, ULONG memory_size)
+{
+UINT status;
+
+    /* The arena is a byte pool, its blocks are set free in any order. */
+    status = tx_byte_pool_create(&(arena_ptr -> nx_secure_tls_arena_pool), name_ptr, memory_ptr, memory_size);
+
+    if (status != TX_SUCCESS)
+    {
+        return(NX_SIZE_ERROR);
+    }
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
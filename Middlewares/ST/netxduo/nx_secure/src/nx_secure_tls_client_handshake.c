@@ -39,7 +39,11 @@
 /*                                                                        */
 /*    This function runs the TLS Client mode state machine. It processes  */
 /*    an incoming handshake record and takes appropriate action to        */
-/*    advance the TLS Client handshake.                                   */
+/*    advance the TLS Client handshake. When the server resumes the       */
+/*    session offered with                                                */
+/*    NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION, its                 */
+/*    ChangeCipherSpec and Finished follow the ServerHello, and the       */
+/*    client answers with its own.                                        */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -59,6 +63,7 @@
 /*    _nx_secure_tls_generate_keys          Generate session keys         */
 /*    _nx_secure_tls_generate_premaster_secret                            */
 /*                                          Generate premaster secret     */
+/*    _nx_secure_tls_handshake_hash_init    Initialize the finished hash  */
 /*    _nx_secure_tls_handshake_hash_update  Update Finished hash          */
 /*    _nx_secure_tls_map_error_to_alert     Map internal error to alert   */
 /*    _nx_secure_tls_packet_allocate        Allocate internal TLS packet  */
@@ -138,6 +143,7 @@ UINT            alert_number;
 UINT            alert_level;
 const NX_CRYPTO_METHOD
                *method_ptr = NX_NULL;
+CYCLE_PROFILE_SAVE_AREA
 
     /* Basic state machine for handshake:
      * 1. We have received a handshake message, now process the header.
@@ -178,8 +184,8 @@ const NX_CRYPTO_METHOD
         /* Advance the buffer pointer past the handshake header. */
         packet_buffer += header_bytes;
 
-        /* Allocate a packet for all send operations.  */
-        packet_pool = tls_session -> nx_secure_tls_packet_pool;
+        /* Allocate a packet for all send operations, from the control pool when the session has one.  */
+        packet_pool = NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session);
 
         /* Hash this handshake message. We do not hash HelloRequest messages.
            Hashes include the handshake layer header but not the record layer header. */
@@ -198,11 +204,15 @@ const NX_CRYPTO_METHOD
         {
         case NX_SECURE_TLS_SERVER_HELLO:
             /* Server has responded to our ClientHello. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_serverhello(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_SERVER_HELLO)
             break;
         case NX_SECURE_TLS_CERTIFICATE_MSG:
             /* Server has sent its certificate message. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_remote_certificate(tls_session, packet_buffer, message_length, packet_buffer_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_CERTIFICATE)
             break;
         case NX_SECURE_TLS_SERVER_HELLO_DONE:
             /* Server has responded to our ClientHello. */
@@ -212,7 +222,9 @@ const NX_CRYPTO_METHOD
             break;
         case NX_SECURE_TLS_SERVER_KEY_EXCHANGE:
             /* Server has sent a key exchange message, used for certain ciphersuites (DH and PSK mainly). */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_server_key_exchange(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_KEY_EXCHANGE)
             break;
         case NX_SECURE_TLS_CERTIFICATE_REQUEST:
             /* Server has requested we provide a client certificate. */
@@ -220,7 +232,20 @@ const NX_CRYPTO_METHOD
             break;
         case NX_SECURE_TLS_FINISHED:
             /* Final handshake message from the server, process it (verify the server handshake hash). */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_process_finished(tls_session, packet_buffer, message_length);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+            /* In a resumed handshake the server Finished comes first and our own Finished covers it,
+               so hash it and keep the hash handler until we have sent ours. */
+            if (tls_session -> nx_secure_tls_session_resumed && !tls_session -> nx_secure_tls_local_session_active &&
+                status == NX_SUCCESS)
+            {
+                status = _nx_secure_tls_handshake_hash_update(tls_session, packet_start, message_length + header_bytes);
+                break;
+            }
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 
             /* For client, cleanup hash handler after received the finished message from server. */
             /* NOTE: we want to run all of the nx_crypto_cleanup calls regardless of the status of the finished processing above
@@ -371,7 +396,7 @@ const NX_CRYPTO_METHOD
                     tls_session -> nx_secure_tls_renegotiation_handshake = NX_TRUE;
 
                     /* Allocate a handshake packet so we can send the ClientHello. */
-                    status = _nx_secure_tls_allocate_handshake_packet(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+                    status = _nx_secure_tls_allocate_handshake_packet(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
                     if (status != NX_SUCCESS)
                     {
@@ -404,7 +429,13 @@ const NX_CRYPTO_METHOD
             if(tls_session->nx_secure_tls_key_material.nx_secure_tls_handshake_cache_length > 0)
             {
                 /* We have some cached messages from earlier in the handshake that we need to process. Generally
-                   this will just be the ClientHello. */
+                   this will just be the ClientHello. The version is negotiated, initialize its hashes only. */
+                status = _nx_secure_tls_handshake_hash_init(tls_session);
+                if(status != NX_SUCCESS)
+                {
+                    return(status);
+                }
+
                 status = _nx_secure_tls_handshake_hash_update(tls_session, tls_session->nx_secure_tls_key_material.nx_secure_tls_handshake_cache,
                                                               tls_session->nx_secure_tls_key_material.nx_secure_tls_handshake_cache_length);
                 if(status != NX_SUCCESS)
@@ -417,6 +448,17 @@ const NX_CRYPTO_METHOD
 
                 _nx_secure_tls_handshake_hash_update(tls_session, packet_start, message_length + header_bytes);
             }
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+            /* The server resumed the session we offered, its ChangeCipherSpec and Finished follow the
+               ServerHello. Generate the keys from the master secret of the session it resumes. */
+            if (tls_session -> nx_secure_tls_session_resumed)
+            {
+                CYCLE_PROFILE_ENTER
+                status = _nx_secure_tls_generate_keys(tls_session);
+                CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
+            }
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
             break;
         case NX_SECURE_TLS_CLIENT_STATE_SERVER_CERTIFICATE:
             /* Processed a server certificate above. Here, we extract the public key and do any verification
@@ -460,7 +502,9 @@ const NX_CRYPTO_METHOD
             }
 
             /* Now, generate the pre-master secret that is used to generate keys for our session. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_generate_premaster_secret(tls_session, NX_SECURE_TLS);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_KEY_EXCHANGE)
             if (status != NX_SUCCESS)
             {
                 break;
@@ -475,7 +519,9 @@ const NX_CRYPTO_METHOD
             }
 
             /* Generate and send the ClientKeyExchange message. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_send_client_key_exchange(tls_session, send_packet);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_KEY_EXCHANGE)
 
             if (status != NX_SUCCESS)
             {
@@ -523,7 +569,9 @@ const NX_CRYPTO_METHOD
             /* Generate our key material from the data collected thus far and put it all into our
                socket structure. Don't call generate keys before sending the client_key_exchange message
                since it needs the pre-master secret and this call clears it out (for security). */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_generate_keys(tls_session);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
 
             if (status != NX_SUCCESS)
             {
@@ -579,7 +627,9 @@ const NX_CRYPTO_METHOD
             }
 
             /* Generate and send the finished message, which completes the handshake. */
+            CYCLE_PROFILE_ENTER
             _nx_secure_tls_send_finished(tls_session, send_packet);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
 
             status = _nx_secure_tls_send_handshake_record(tls_session, send_packet, NX_SECURE_TLS_FINISHED, wait_option);
 
@@ -587,6 +637,68 @@ const NX_CRYPTO_METHOD
         case NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED:
             /* We processed a server finished message, completing the handshake. Verify all is good and if so,
                continue to the encrypted session. */
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+            if (tls_session -> nx_secure_tls_session_resumed && !tls_session -> nx_secure_tls_local_session_active)
+            {
+                /* In a resumed handshake our ChangeCipherSpec and Finished answer the server ones. */
+
+                /* Release the protection before suspending on nx_packet_allocate. */
+                tx_mutex_put(&_nx_secure_tls_protection);
+
+                status = _nx_secure_tls_packet_allocate(tls_session, packet_pool, &send_packet, wait_option);
+
+                /* Get the protection after nx_packet_allocate. */
+                tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+                if (status != NX_SUCCESS)
+                {
+                    break;
+                }
+
+                /* ChangeCipherSpec is NOT a handshake message, so send as a normal TLS record. */
+                _nx_secure_tls_send_changecipherspec(tls_session, send_packet);
+
+                status = _nx_secure_tls_send_record(tls_session, send_packet, NX_SECURE_TLS_CHANGE_CIPHER_SPEC, wait_option);
+
+                if (status != NX_SUCCESS)
+                {
+                    /* Release packet on send error. */
+                    nx_secure_tls_packet_release(send_packet);
+                    break;
+                }
+
+                /* Reset the sequence number now that we are starting a new session. */
+                NX_SECURE_MEMSET(tls_session -> nx_secure_tls_local_sequence_number, 0, sizeof(tls_session -> nx_secure_tls_local_sequence_number));
+
+                /* Set our local session keys since we are sent a CCS message. */
+                _nx_secure_tls_session_keys_set(tls_session, NX_SECURE_TLS_KEY_SET_LOCAL);
+
+                status = _nx_secure_tls_allocate_handshake_packet(tls_session, packet_pool, &send_packet, wait_option);
+
+                if (status == NX_SUCCESS)
+                {
+                    /* Generate and send the finished message, which completes the handshake. */
+                    CYCLE_PROFILE_ENTER
+                    _nx_secure_tls_send_finished(tls_session, send_packet);
+                    CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_FINISHED)
+
+                    status = _nx_secure_tls_send_handshake_record(tls_session, send_packet, NX_SECURE_TLS_FINISHED, wait_option);
+                }
+
+#if (NX_SECURE_TLS_TLS_1_2_ENABLED)
+                /* The Finished messages are both hashed, cleanup the hash handler now. */
+                method_ptr = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_handshake_hash_sha256_method;
+                if (method_ptr -> nx_crypto_cleanup != NX_NULL)
+                {
+                    temp_status = method_ptr -> nx_crypto_cleanup(tls_session -> nx_secure_tls_handshake_hash.nx_secure_tls_handshake_hash_sha256_metadata);
+                    if(temp_status != NX_CRYPTO_SUCCESS)
+                    {
+                        status = temp_status;
+                    }
+                }
+#endif /* (NX_SECURE_TLS_TLS_1_2_ENABLED) */
+            }
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
             break;
         case NX_SECURE_TLS_CLIENT_STATE_HELLO_VERIFY: /* DTLS ONLY! */
         default:
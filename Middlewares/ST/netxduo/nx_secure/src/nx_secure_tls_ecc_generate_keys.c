@@ -121,6 +121,11 @@ NX_SECURE_X509_CRYPTO                *crypto_methods;
 NX_SECURE_EC_PRIVATE_KEY             *ec_privkey;
 NX_SECURE_EC_PUBLIC_KEY              *ec_pubkey;
 USHORT                                signature_algorithm_id;
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+UINT                                  precomputed_public_length;
+UINT                                  precomputed_private_length;
+UINT                                  precomputed = NX_FALSE;
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 
 
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
@@ -224,17 +229,33 @@ USHORT                                signature_algorithm_id;
         extended_output.nx_crypto_extended_output_length_in_byte = output_size - (length + 1);
     }
     extended_output.nx_crypto_extended_output_actual_size = 0;
-    status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, handler,
-                                                 (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
-                                                 NX_NULL, 0, NX_NULL,
-                                                 (UCHAR *)&extended_output,
-                                                 sizeof(extended_output),
-                                                 tls_session -> nx_secure_public_cipher_metadata_area,
-                                                 tls_session -> nx_secure_public_cipher_metadata_size,
-                                                 NX_NULL, NX_NULL);
-    if (status != NX_CRYPTO_SUCCESS)
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+    /* A key pair generated ahead saves the scalar multiplication of the setup. */
+    precomputed_public_length = extended_output.nx_crypto_extended_output_length_in_byte;
+    precomputed_private_length = sizeof(ecc_data -> nx_secure_tls_ecdhe_private_key);
+    if (_nx_secure_tls_ecdhe_precomputed_get(curve_method, extended_output.nx_crypto_extended_output_data,
+                                             &precomputed_public_length, ecc_data -> nx_secure_tls_ecdhe_private_key,
+                                             &precomputed_private_length) == NX_SUCCESS)
     {
-        return(status);
+        extended_output.nx_crypto_extended_output_actual_size = precomputed_public_length;
+        ecc_data -> nx_secure_tls_ecdhe_private_key_length = (USHORT)precomputed_private_length;
+        precomputed = NX_TRUE;
+    }
+    else
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
+    {
+        status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, handler,
+                                                     (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                     NX_NULL, 0, NX_NULL,
+                                                     (UCHAR *)&extended_output,
+                                                     sizeof(extended_output),
+                                                     tls_session -> nx_secure_public_cipher_metadata_area,
+                                                     tls_session -> nx_secure_public_cipher_metadata_size,
+                                                     NX_NULL, NX_NULL);
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
     }
 
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
@@ -249,26 +270,31 @@ USHORT                                signature_algorithm_id;
 
     length += (UINT)(extended_output.nx_crypto_extended_output_actual_size);
 
-    /* Export the private key for later use. */
-    extended_output.nx_crypto_extended_output_data = ecc_data -> nx_secure_tls_ecdhe_private_key;
-    extended_output.nx_crypto_extended_output_length_in_byte =
-        sizeof(ecc_data -> nx_secure_tls_ecdhe_private_key);
-    extended_output.nx_crypto_extended_output_actual_size = 0;
-    status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_PRIVATE_KEY_EXPORT, handler,
-                                                 (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
-                                                 NX_NULL, 0, NX_NULL,
-                                                 (UCHAR *)&extended_output,
-                                                 sizeof(extended_output),
-                                                 tls_session -> nx_secure_public_cipher_metadata_area,
-                                                 tls_session -> nx_secure_public_cipher_metadata_size,
-                                                 NX_NULL, NX_NULL);
-    if (status != NX_CRYPTO_SUCCESS)
+    /* Export the private key for later use, a precomputed one is already there. */
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+    if (!precomputed)
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
     {
-        return(status);
-    }
+        extended_output.nx_crypto_extended_output_data = ecc_data -> nx_secure_tls_ecdhe_private_key;
+        extended_output.nx_crypto_extended_output_length_in_byte =
+            sizeof(ecc_data -> nx_secure_tls_ecdhe_private_key);
+        extended_output.nx_crypto_extended_output_actual_size = 0;
+        status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_PRIVATE_KEY_EXPORT, handler,
+                                                     (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                     NX_NULL, 0, NX_NULL,
+                                                     (UCHAR *)&extended_output,
+                                                     sizeof(extended_output),
+                                                     tls_session -> nx_secure_public_cipher_metadata_area,
+                                                     tls_session -> nx_secure_public_cipher_metadata_size,
+                                                     NX_NULL, NX_NULL);
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
 
-    /* Set the private key length. */
-    ecc_data -> nx_secure_tls_ecdhe_private_key_length = (USHORT)extended_output.nx_crypto_extended_output_actual_size;
+        /* Set the private key length. */
+        ecc_data -> nx_secure_tls_ecdhe_private_key_length = (USHORT)extended_output.nx_crypto_extended_output_actual_size;
+    }
 
     /* Cleanup the ECC crypto state. */
     if (ecdhe_method -> nx_crypto_cleanup)
@@ -0,0 +1,196 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_ecdhe_precompute                     PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function generates ephemeral ECDHE key pairs on a curve until  */
+/*    key_count of them are ready, or until every entry of the table of   */
+/*    NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS key pairs is taken. The next   */
+/*    key exchanges on that curve take a ready key pair instead of        */
+/*    generating one, each key pair is used once. It is meant to be       */
+/*    called from a thread of low priority, so the scalar multiplications */
+/*    run while the system is idle. The metadata area is used by this     */
+/*    function only, and not shared with the TLS sessions.                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    ecdhe_method                          ECDHE crypto method           */
+/*    curve_method                          Curve of the key pairs        */
+/*    key_count                             Key pairs to keep ready       */
+/*    metadata_area                         Metadata of the ECDHE method  */
+/*    metadata_size                         Size of the metadata area     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [nx_crypto_init]                      Initialize crypto method      */
+/*    [nx_crypto_operation]                 Crypto operation              */
+/*    [nx_crypto_cleanup]                   Cleanup crypto method         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_ecdhe_precompute(const NX_CRYPTO_METHOD *ecdhe_method, const NX_CRYPTO_METHOD *curve_method,
+                                     UINT key_count, VOID *metadata_area, ULONG metadata_size)
+{
+TX_INTERRUPT_SAVE_AREA
+UINT                                  status;
+UINT                                  i;
+UINT                                  ready;
+NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEY  *key_ptr;
+NX_CRYPTO_EXTENDED_OUTPUT             extended_output;
+VOID                                 *handler = NX_NULL;
+
+
+    if ((ecdhe_method == NX_NULL) || (ecdhe_method -> nx_crypto_operation == NX_NULL) || (curve_method == NX_NULL))
+    {
+        return(NX_SECURE_TLS_MISSING_CRYPTO_ROUTINE);
+    }
+
+    for (;;)
+    {
+
+        /* Count the key pairs of the curve, and claim a free entry if more are needed. */
+        ready = 0;
+        key_ptr = NX_NULL;
+
+        TX_DISABLE
+
+        for (i = 0; i < NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS; i++)
+        {
+            if (_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_state == NX_SECURE_TLS_ECDHE_PRECOMPUTED_FREE)
+            {
+                if (key_ptr == NX_NULL)
+                {
+                    key_ptr = &_nx_secure_tls_ecdhe_precomputed_keys[i];
+                }
+            }
+            else if ((_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_state == NX_SECURE_TLS_ECDHE_PRECOMPUTED_READY) &&
+                     (_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_curve == curve_method))
+            {
+                ready++;
+            }
+        }
+
+        if ((ready >= key_count) || (key_ptr == NX_NULL))
+        {
+            TX_RESTORE
+
+            /* Enough key pairs are ready, or the table is full. */
+            return(NX_SUCCESS);
+        }
+
+        key_ptr -> nx_secure_tls_ecdhe_precomputed_state = NX_SECURE_TLS_ECDHE_PRECOMPUTED_GENERATING;
+        key_ptr -> nx_secure_tls_ecdhe_precomputed_curve = curve_method;
+
+        TX_RESTORE
+
+        /* Generate the key pair the way the key exchange does. */
+        status = NX_CRYPTO_SUCCESS;
+        if (ecdhe_method -> nx_crypto_init != NX_NULL)
+        {
+            status = ecdhe_method -> nx_crypto_init((NX_CRYPTO_METHOD*)ecdhe_method,
+                                                    NX_NULL,
+                                                    0,
+                                                    &handler,
+                                                    metadata_area,
+                                                    metadata_size);
+        }
+
+        if (status == NX_CRYPTO_SUCCESS)
+        {
+            status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET, handler,
+                                                         (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                         (UCHAR *)curve_method, sizeof(NX_CRYPTO_METHOD *), NX_NULL,
+                                                         NX_NULL, 0,
+                                                         metadata_area, metadata_size,
+                                                         NX_NULL, NX_NULL);
+        }
+
+        if (status == NX_CRYPTO_SUCCESS)
+        {
+            extended_output.nx_crypto_extended_output_data = key_ptr -> nx_secure_tls_ecdhe_precomputed_public_key;
+            extended_output.nx_crypto_extended_output_length_in_byte = sizeof(key_ptr -> nx_secure_tls_ecdhe_precomputed_public_key);
+            extended_output.nx_crypto_extended_output_actual_size = 0;
+            status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, handler,
+                                                         (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                         NX_NULL, 0, NX_NULL,
+                                                         (UCHAR *)&extended_output,
+                                                         sizeof(extended_output),
+                                                         metadata_area, metadata_size,
+                                                         NX_NULL, NX_NULL);
+            key_ptr -> nx_secure_tls_ecdhe_precomputed_public_key_length = (USHORT)extended_output.nx_crypto_extended_output_actual_size;
+        }
+
+        if (status == NX_CRYPTO_SUCCESS)
+        {
+            extended_output.nx_crypto_extended_output_data = key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key;
+            extended_output.nx_crypto_extended_output_length_in_byte = sizeof(key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key);
+            extended_output.nx_crypto_extended_output_actual_size = 0;
+            status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_PRIVATE_KEY_EXPORT, handler,
+                                                         (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                         NX_NULL, 0, NX_NULL,
+                                                         (UCHAR *)&extended_output,
+                                                         sizeof(extended_output),
+                                                         metadata_area, metadata_size,
+                                                         NX_NULL, NX_NULL);
+            key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key_length = (USHORT)extended_output.nx_crypto_extended_output_actual_size;
+        }
+
+        /* Cleanup the ECC crypto state, the private key included. */
+        if (ecdhe_method -> nx_crypto_cleanup)
+        {
+            ecdhe_method -> nx_crypto_cleanup(metadata_area);
+        }
+
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+
+            /* Give the entry back. */
+            NX_SECURE_MEMSET(key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key, 0,
+                             sizeof(key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key));
+            key_ptr -> nx_secure_tls_ecdhe_precomputed_state = NX_SECURE_TLS_ECDHE_PRECOMPUTED_FREE;
+
+            return(status);
+        }
+
+        /* The key pair can be taken now. */
+        key_ptr -> nx_secure_tls_ecdhe_precomputed_state = NX_SECURE_TLS_ECDHE_PRECOMPUTED_READY;
+    }
+}
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE && NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
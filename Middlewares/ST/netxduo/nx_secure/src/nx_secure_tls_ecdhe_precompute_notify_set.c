@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_ecdhe_precompute_notify_set          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the routine called when a handshake takes an     */
+/*    ECDHE key pair generated ahead, with the curve of the key pair, so  */
+/*    that the application has _nx_secure_tls_ecdhe_precompute generate   */
+/*    another one. It is called from the thread of the handshake and      */
+/*    must not block. If a NULL pointer is supplied, no routine is called.*/
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    precompute_notify                     Routine to call when a key    */
+/*                                            pair is taken               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_ecdhe_precompute_notify_set(VOID (*precompute_notify)(const NX_CRYPTO_METHOD *curve_method))
+{
+
+    _nx_secure_tls_ecdhe_precompute_notify = precompute_notify;
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE && NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
@@ -0,0 +1,121 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_ecdhe_precomputed_get                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function takes a key pair generated ahead on the curve by      */
+/*    _nx_secure_tls_ecdhe_precompute. The key pair is copied out and     */
+/*    cleared from the table, so it is never used again, and the          */
+/*    precompute notify is called to have it replaced.                    */
+/*                                                                        */
+/*    NOTE: The key sizes should contain the size of their respective     */
+/*          buffers as input. The value will be replaced with the actual  */
+/*          size of the key.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    curve_method                          Curve of the key exchange     */
+/*    public_key                            Public key, copied out        */
+/*    public_key_length                     Size of public key            */
+/*    private_key                           Private key, copied out       */
+/*    private_key_length                    Size of private key           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_SUCCESS                            Key pair taken                */
+/*    NX_NOT_FOUND                          No key pair ready             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    (_nx_secure_tls_ecdhe_precompute_notify)                            */
+/*                                          Application notify            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_ecc_generate_keys      Generate ECDHE key pair       */
+/*    _nx_secure_tls_process_server_key_exchange                          */
+/*                                          Process ServerKeyExchange     */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_ecdhe_precomputed_get(const NX_CRYPTO_METHOD *curve_method,
+                                          UCHAR *public_key, UINT *public_key_length,
+                                          UCHAR *private_key, UINT *private_key_length)
+{
+TX_INTERRUPT_SAVE_AREA
+UINT                                  i;
+NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEY  *key_ptr = NX_NULL;
+
+
+    /* Claim a key pair of the curve that fits the buffers. */
+    TX_DISABLE
+
+    for (i = 0; i < NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS; i++)
+    {
+        if ((_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_state == NX_SECURE_TLS_ECDHE_PRECOMPUTED_READY) &&
+            (_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_curve == curve_method) &&
+            (_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_public_key_length <= *public_key_length) &&
+            (_nx_secure_tls_ecdhe_precomputed_keys[i].nx_secure_tls_ecdhe_precomputed_private_key_length <= *private_key_length))
+        {
+            key_ptr = &_nx_secure_tls_ecdhe_precomputed_keys[i];
+            key_ptr -> nx_secure_tls_ecdhe_precomputed_state = NX_SECURE_TLS_ECDHE_PRECOMPUTED_TAKEN;
+            break;
+        }
+    }
+
+    TX_RESTORE
+
+    if (key_ptr == NX_NULL)
+    {
+        return(NX_NOT_FOUND);
+    }
+
+    *public_key_length = key_ptr -> nx_secure_tls_ecdhe_precomputed_public_key_length;
+    NX_SECURE_MEMCPY(public_key, key_ptr -> nx_secure_tls_ecdhe_precomputed_public_key, *public_key_length); /* Use case of memcpy is verified. */
+
+    *private_key_length = key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key_length;
+    NX_SECURE_MEMCPY(private_key, key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key, *private_key_length); /* Use case of memcpy is verified. */
+
+    /* The key pair is used once. */
+    NX_SECURE_MEMSET(key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key, 0,
+                     sizeof(key_ptr -> nx_secure_tls_ecdhe_precomputed_private_key));
+    key_ptr -> nx_secure_tls_ecdhe_precomputed_state = NX_SECURE_TLS_ECDHE_PRECOMPUTED_FREE;
+
+    /* Have it replaced. */
+    if (_nx_secure_tls_ecdhe_precompute_notify)
+    {
+        _nx_secure_tls_ecdhe_precompute_notify(curve_method);
+    }
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE && NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
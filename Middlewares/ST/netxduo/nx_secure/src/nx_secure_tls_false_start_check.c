@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#if defined(NX_SECURE_TLS_ENABLE_FALSE_START) && !defined(NX_SECURE_TLS_CLIENT_DISABLED)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_false_start_check                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks whether a TLS client that just sent its        */
+/*    Finished message may return to the application before the server    */
+/*    ChangeCipherSpec and Finished are received, following TLS False     */
+/*    Start (RFC 7918). The application data then goes out with the       */
+/*    client Finished flight, saving a round trip. The handshake must be  */
+/*    a full TLS 1.2 one, the server certificate verified, the key        */
+/*    exchange ECDHE for forward secrecy and the session cipher an AEAD   */
+/*    one, so that a downgrade of the handshake cannot expose the data.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                NX_TRUE to return now         */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_handshake_process      Process TLS handshake         */
+/*    _nx_secure_tls_session_handshake_step                               */
+/*                                          Step TLS handshake            */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_false_start_check(NX_SECURE_TLS_SESSION *tls_session)
+{
+const NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite = tls_session -> nx_secure_tls_session_ciphersuite;
+
+    /* Our Finished message is sent once the local session is active, and the remote one is not
+       active until the server ChangeCipherSpec is received. A renegotiation has both active. */
+    if ((tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE) ||
+        !tls_session -> nx_secure_tls_local_session_active || tls_session -> nx_secure_tls_remote_session_active ||
+        !tls_session -> nx_secure_tls_received_remote_credentials ||
+        (tls_session -> nx_secure_tls_protocol_version != NX_SECURE_TLS_VERSION_TLS_1_2) ||
+        (ciphersuite == NX_NULL))
+    {
+        return(NX_FALSE);
+    }
+
+    /* RFC 7918 requires a forward secure key exchange... */
+    if (ciphersuite -> nx_secure_tls_public_cipher -> nx_crypto_algorithm != NX_CRYPTO_KEY_EXCHANGE_ECDHE)
+    {
+        return(NX_FALSE);
+    }
+
+    /* ... and a strong session cipher. */
+    if ((ciphersuite -> nx_secure_tls_session_cipher -> nx_crypto_algorithm != NX_CRYPTO_ENCRYPTION_AES_GCM_16) &&
+        (ciphersuite -> nx_secure_tls_session_cipher -> nx_crypto_algorithm != NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305))
+    {
+        return(NX_FALSE);
+    }
+
+    return(NX_TRUE);
+}
+#endif /* NX_SECURE_TLS_ENABLE_FALSE_START && !NX_SECURE_TLS_CLIENT_DISABLED */
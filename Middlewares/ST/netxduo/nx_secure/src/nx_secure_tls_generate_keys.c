@@ -92,6 +92,7 @@ const NX_CRYPTO_METHOD               *session_cipher_method = NX_NULL;
 const NX_CRYPTO_METHOD               *session_prf_method = NX_NULL;
 const NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite;
 VOID                                 *handler = NX_NULL;
+UINT                                  master_secret_known = NX_FALSE;
 
     /* Generate the session keys using the parameters obtained in the handshake.
        By this point all the information needed to generate the TLS session key
@@ -189,8 +190,19 @@ VOID                                 *handler = NX_NULL;
             return(NX_SECURE_TLS_PROTOCOL_VERSION_CHANGED);
         }
 
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+        /* A resumed session has the master secret of the session it resumes, only the keys are new. */
+        if (tls_session -> nx_secure_tls_session_resumed)
+        {
+            master_secret_known = NX_TRUE;
+#ifdef NX_SECURE_KEY_CLEAR
+            NX_SECURE_MEMSET(_nx_secure_tls_gen_keys_random, 0, sizeof(_nx_secure_tls_gen_keys_random));
+#endif /* NX_SECURE_KEY_CLEAR  */
+        }
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
         /* Use the PRF to generate the master secret. */
-        if (session_prf_method -> nx_crypto_init != NX_NULL)
+        if (!master_secret_known && session_prf_method -> nx_crypto_init != NX_NULL)
         {
             status = session_prf_method -> nx_crypto_init((NX_CRYPTO_METHOD*)session_prf_method,
                                                  pre_master_sec, (NX_CRYPTO_KEY_SIZE)pre_master_sec_size,
@@ -208,7 +220,7 @@ VOID                                 *handler = NX_NULL;
             }                                                     
         }
 
-        if (session_prf_method -> nx_crypto_operation != NX_NULL)
+        if (!master_secret_known && session_prf_method -> nx_crypto_operation != NX_NULL)
         {
             status = session_prf_method -> nx_crypto_operation(NX_CRYPTO_PRF,
                                                       handler,
@@ -236,7 +248,7 @@ VOID                                 *handler = NX_NULL;
             }
         }
 
-        if (session_prf_method -> nx_crypto_cleanup)
+        if (!master_secret_known && session_prf_method -> nx_crypto_cleanup)
         {
             status = session_prf_method -> nx_crypto_cleanup(tls_session -> nx_secure_tls_prf_metadata_area);
 
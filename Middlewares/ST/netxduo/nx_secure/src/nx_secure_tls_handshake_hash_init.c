@@ -38,7 +38,10 @@
 /*  DESCRIPTION                                                           */
 /*                                                                        */
 /*    This function initializes the hash function states needed for the   */
-/*    TLS Finished message handshake hash.                                */
+/*    TLS Finished message handshake hash. A server initializes the       */
+/*    states of all the versions it supports when it receives the         */
+/*    ClientHello. A client caches its ClientHello and initializes the    */
+/*    states after the ServerHello, only those of the negotiated version. */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -56,7 +59,7 @@
 /*                                                                        */
 /*    _nx_secure_dtls_send_clienthello      Send ClientHello              */
 /*    _nx_secure_dtls_server_handshake      DTLS server state machine     */
-/*    _nx_secure_tls_send_clienthello       Send ClientHello              */
+/*    _nx_secure_tls_client_handshake       TLS client state machine      */
 /*    _nx_secure_tls_server_handshake       TLS server state machine      */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
@@ -75,6 +78,7 @@ UINT              status;
 VOID             *handler = NX_NULL;
 VOID             *metadata;
 UINT              metadata_size;
+USHORT            versions;
 
 
     /* We need to hash all of the handshake messages that we receive and send. When sending a ClientHello,
@@ -151,10 +155,27 @@ UINT              metadata_size;
 
 
     /* Initialize both the handshake "finished" hashes - TLS 1.1 uses both SHA-1 and MD5, TLS 1.2 uses SHA-256 by default.
-       At this point we don't yet know the version we will use, so initialize all of them. */
+       A server does not yet know the version it will use, so initialize all of them. A client initializes the hashes
+       after the ServerHello, those of the negotiated version only, the others are never hashed into. */
+    versions = tls_session -> nx_secure_tls_supported_versions;
+#ifndef NX_SECURE_TLS_CLIENT_DISABLED
+    if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT)
+    {
+        if (tls_session -> nx_secure_tls_protocol_version == NX_SECURE_TLS_VERSION_TLS_1_2)
+        {
+            versions = (USHORT)(versions & (USHORT)NX_SECURE_TLS_BITFIELD_VERSION_1_2);
+        }
+        else if ((tls_session -> nx_secure_tls_protocol_version == NX_SECURE_TLS_VERSION_TLS_1_0) ||
+                 (tls_session -> nx_secure_tls_protocol_version == NX_SECURE_TLS_VERSION_TLS_1_1))
+        {
+            versions = (USHORT)(versions & (USHORT)(NX_SECURE_TLS_BITFIELD_VERSION_1_0 | NX_SECURE_TLS_BITFIELD_VERSION_1_1));
+        }
+    }
+#endif /* NX_SECURE_TLS_CLIENT_DISABLED */
+
     /* Hash is determined by ciphersuite in TLS 1.2. Default is SHA-256. */
 #if (NX_SECURE_TLS_TLS_1_2_ENABLED)
-    if (tls_session -> nx_secure_tls_supported_versions & (USHORT)(NX_SECURE_TLS_BITFIELD_VERSION_1_2))
+    if (versions & (USHORT)(NX_SECURE_TLS_BITFIELD_VERSION_1_2))
     {
         method_ptr = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_handshake_hash_sha256_method;
         metadata = tls_session -> nx_secure_tls_handshake_hash.nx_secure_tls_handshake_hash_sha256_metadata;
@@ -202,7 +223,7 @@ UINT              metadata_size;
 #endif
 
 #if (NX_SECURE_TLS_TLS_1_0_ENABLED || NX_SECURE_TLS_TLS_1_1_ENABLED)
-    if (tls_session -> nx_secure_tls_supported_versions & (USHORT)(NX_SECURE_TLS_BITFIELD_VERSION_1_0 | NX_SECURE_TLS_BITFIELD_VERSION_1_1))
+    if (versions & (USHORT)(NX_SECURE_TLS_BITFIELD_VERSION_1_0 | NX_SECURE_TLS_BITFIELD_VERSION_1_1))
     {
         /* TLS 1.0 and 1.1 use both MD5 and SHA-1. */
         method_ptr = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_handshake_hash_md5_method;
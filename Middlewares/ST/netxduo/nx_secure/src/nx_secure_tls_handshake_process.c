@@ -42,6 +42,10 @@
 /*    Server in their own functions, this function is simply the entry    */
 /*    point for handling the handshake messages.                          */
 /*                                                                        */
+/*    With NX_SECURE_TLS_ENABLE_FALSE_START, a TLS client may return      */
+/*    once its Finished message is sent. The rest of the handshake is     */
+/*    then processed by _nx_secure_tls_session_receive.                   */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    tls_session                           TLS control block             */
@@ -53,6 +57,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_secure_tls_false_start_check      Check for TLS False Start     */
 /*    _nx_secure_tls_session_receive_records                              */
 /*                                          Receive TLS records           */
 /*    nx_secure_tls_packet_release          Release packet                */
@@ -94,6 +99,14 @@ NX_PACKET *incoming_packet = NX_NULL;
             {
                 break;
             }
+
+#if defined(NX_SECURE_TLS_ENABLE_FALSE_START) && !defined(NX_SECURE_TLS_CLIENT_DISABLED)
+            /* Let the application send data with our Finished message. */
+            if (_nx_secure_tls_false_start_check(tls_session))
+            {
+                break;
+            }
+#endif /* NX_SECURE_TLS_ENABLE_FALSE_START && !NX_SECURE_TLS_CLIENT_DISABLED */
         }
 
         if (tls_session -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED)
@@ -142,4 +155,3 @@ NX_PACKET *incoming_packet = NX_NULL;
 
     return(status);
 }
-
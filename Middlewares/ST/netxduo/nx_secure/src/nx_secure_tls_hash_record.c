@@ -292,15 +292,8 @@ ULONG                                 current_length;
 #endif /* NX_SECURE_KEY_CLEAR  */
     }
 
-    if (authentication_method -> nx_crypto_cleanup)
-    {
-        status = authentication_method -> nx_crypto_cleanup(metadata);
-
-        if(status != NX_CRYPTO_SUCCESS)
-        {
-            return(status);
-        }
-    }
+    /* The MAC metadata is not cleaned up after each record so the hash method can keep the states
+       derived from the MAC secrets. It is cleared when new keys are set and when the session is reset. */
 
     /* Return how many bytes our hash is since the caller doesn't necessarily know. */
     *hash_length = hash_size;
@@ -78,6 +78,7 @@
 UINT _nx_secure_tls_local_certificate_add(NX_SECURE_TLS_SESSION *tls_session,
                                           NX_SECURE_X509_CERT *certificate)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT status;
 
     /* Get the protection. */
@@ -109,5 +110,11 @@ UINT status;
     }
 
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(certificate);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
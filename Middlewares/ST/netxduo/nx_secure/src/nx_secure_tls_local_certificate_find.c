@@ -79,6 +79,7 @@ UINT  _nx_secure_tls_local_certificate_find(NX_SECURE_TLS_SESSION *tls_session,
                                             NX_SECURE_X509_CERT **certificate, UCHAR *common_name,
                                             UINT name_length)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                              status;
 NX_SECURE_X509_CERT              *list_head;
 NX_SECURE_X509_CERTIFICATE_STORE *store;
@@ -108,5 +109,13 @@ NX_SECURE_X509_DISTINGUISHED_NAME name;
 
     /* Return completion status.  */
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(certificate);
+    NX_PARAMETER_NOT_USED(common_name);
+    NX_PARAMETER_NOT_USED(name_length);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
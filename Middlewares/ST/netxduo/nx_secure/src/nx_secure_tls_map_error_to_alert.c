@@ -176,6 +176,7 @@ VOID _nx_secure_tls_map_error_to_alert(UINT error_number, UINT *alert_number, UI
     case NX_SECURE_TLS_BAD_COMPRESSION_METHOD:        /* Deliberate fall-through. */
     case NX_SECURE_TLS_1_3_UNKNOWN_CIPHERSUITE:
     case NX_SECURE_TLS_BAD_SERVERHELLO_KEYSHARE:
+    case NX_SECURE_TLS_BAD_RECORD_SIZE_LIMIT:
         *alert_number = NX_SECURE_TLS_ALERT_ILLEGAL_PARAMETER;
         *alert_level = NX_SECURE_TLS_ALERT_LEVEL_FATAL;
         break;
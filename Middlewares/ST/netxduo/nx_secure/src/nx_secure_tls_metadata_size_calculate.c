@@ -82,8 +82,10 @@ UINT                            max_handshake_hash_scratch_size  = 0;
 NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite_table;
 USHORT                          ciphersuite_table_size;
 ULONG                           max_total_metadata_size;
+#ifndef NX_SECURE_DISABLE_X509
 NX_SECURE_X509_CRYPTO          *cert_crypto;
 USHORT                          cert_crypto_size;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 
 #if (NX_SECURE_TLS_TLS_1_0_ENABLED || NX_SECURE_TLS_TLS_1_1_ENABLED)
@@ -112,8 +114,10 @@ const NX_CRYPTO_METHOD *crypto_method_sha256;
     /* Get working pointers to our tables. */
     ciphersuite_table = crypto_table -> nx_secure_tls_ciphersuite_lookup_table;
     ciphersuite_table_size = crypto_table -> nx_secure_tls_ciphersuite_lookup_table_size;
+#ifndef NX_SECURE_DISABLE_X509
     cert_crypto = crypto_table -> nx_secure_tls_x509_cipher_table;
     cert_crypto_size = crypto_table -> nx_secure_tls_x509_cipher_table_size;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 
     /* Loop through the ciphersuite table and find the largest metadata for each type of cipher. */
@@ -145,6 +149,7 @@ const NX_CRYPTO_METHOD *crypto_method_sha256;
         }
     }
 
+#ifndef NX_SECURE_DISABLE_X509
     /* Loop through the certificate cipher table as well. */
     for (i = 0; i < cert_crypto_size; ++i)
     {
@@ -164,6 +169,7 @@ const NX_CRYPTO_METHOD *crypto_method_sha256;
             max_handshake_hash_scratch_size = cert_crypto[i].nx_secure_x509_hash_method -> nx_crypto_metadata_area_size;
         }
     }
+#endif /* NX_SECURE_DISABLE_X509 */
 
     /* We also need metadata space for the TLS handshake hash, so add that into the total.
        We need some scratch space to copy the handshake hash metadata during final hash generation
@@ -215,6 +221,21 @@ const NX_CRYPTO_METHOD *crypto_method_sha256;
     }
 
 
+#ifdef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+    /* The two session cipher states and the PRF follow each other in the public cipher metadata,
+       so it must hold all of them. */
+    if (max_public_cipher_metadata_size < ((2 * max_session_cipher_metadata_size) + max_tls_prf_metadata_size))
+    {
+        max_public_cipher_metadata_size = (2 * max_session_cipher_metadata_size) + max_tls_prf_metadata_size;
+    }
+
+    /* The Total metadata size needed is the sum of the maximums calculated above, less the areas shared
+       with the public cipher. */
+    max_total_metadata_size = max_public_cipher_metadata_size +
+                              max_hash_mac_metadata_size +
+                              max_handshake_hash_metadata_size +
+                              max_handshake_hash_scratch_size;
+#else
     /* The Total metadata size needed is the sum of all the maximums calculated above.
        We need to keep track of two separate session cipher states, one for the server and one for the client,
        so account for that extra space. */
@@ -224,6 +245,7 @@ const NX_CRYPTO_METHOD *crypto_method_sha256;
                               max_tls_prf_metadata_size +
                               max_handshake_hash_metadata_size +
                               max_handshake_hash_scratch_size;
+#endif /* NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA */
 
     *metadata_size = max_total_metadata_size;
     return(NX_SUCCESS);
@@ -99,6 +99,9 @@ USHORT iv_size;
 
     if (status != NX_SUCCESS)
     {
+
+        /* Account the failure to TLS in the pool statistics.  */
+        NX_PACKET_POOL_CALLER_FAILURE(pool_ptr, NX_PACKET_POOL_CALLER_TLS);
         return(status);
     }
 
@@ -76,6 +76,7 @@
 UINT _nx_secure_tls_process_certificate_request(NX_SECURE_TLS_SESSION *tls_session,
                                                 UCHAR *packet_buffer, UINT message_length)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT  length;
 UINT  cert_types_length;
 UCHAR cert_type;
@@ -313,5 +314,14 @@ UINT extension_type;
 
     return(NX_SUCCESS);
 #endif
+#else
+
+    /* Certificates are not processed, the ciphersuites do not request them.  */
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(packet_buffer);
+    NX_PARAMETER_NOT_USED(message_length);
+
+    return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
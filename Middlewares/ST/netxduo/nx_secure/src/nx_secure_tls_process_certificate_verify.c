@@ -96,6 +96,7 @@ static const UCHAR _NX_SECURE_OID_SHA256[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09
 UINT _nx_secure_tls_process_certificate_verify(NX_SECURE_TLS_SESSION *tls_session,
                                                UCHAR *packet_buffer, UINT message_length)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                                  length = 0;
 UINT                                  data_size = 0;
 USHORT                                signature_algorithm;
@@ -898,5 +899,14 @@ NX_SECURE_EC_PUBLIC_KEY              *ec_pubkey;
     }
 
     return(NX_SUCCESS);
+#else
+
+    /* Certificates are not processed, the ciphersuites do not send them.  */
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(packet_buffer);
+    NX_PARAMETER_NOT_USED(message_length);
+
+    return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
@@ -101,8 +101,10 @@ UINT status = NX_SUCCESS;
         }
 #endif
 #ifndef NX_SECURE_TLS_CLIENT_DISABLED
+        /* The server ChangeCipherSpec follows its ServerHelloDone, or its ServerHello in a resumed handshake. */
         if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT &&
-            tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE)
+            tls_session -> nx_secure_tls_client_state != NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE &&
+            !NX_SECURE_TLS_CLIENT_RESUMING(tls_session))
         {
             return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
         }
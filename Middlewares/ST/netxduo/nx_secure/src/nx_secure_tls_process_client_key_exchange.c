@@ -24,7 +24,9 @@
 
 #include "nx_secure_tls.h"
 
+#ifndef NX_SECURE_DISABLE_X509
 static UCHAR _nx_secure_client_padded_pre_master[600];
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /**************************************************************************/
 /*                                                                        */
@@ -89,15 +91,21 @@ static UCHAR _nx_secure_client_padded_pre_master[600];
 UINT _nx_secure_tls_process_client_key_exchange(NX_SECURE_TLS_SESSION *tls_session,
                                                 UCHAR *packet_buffer, UINT message_length, UINT id)
 {
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) || !defined(NX_SECURE_DISABLE_X509)
 USHORT                                length;
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE || !NX_SECURE_DISABLE_X509 */
 UINT                                  status;
-UCHAR                                *encrypted_pre_master_secret;
+#if defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) || !defined(NX_SECURE_DISABLE_X509)
 const NX_CRYPTO_METHOD                     *public_cipher_method;
+#endif /* NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE || !NX_SECURE_DISABLE_X509 */
+#ifndef NX_SECURE_DISABLE_X509
+UCHAR                                *encrypted_pre_master_secret;
 NX_SECURE_X509_CERT                  *local_certificate;
 UINT                                  user_defined_key;
 VOID                                 *handler = NX_NULL;
 UCHAR                                 rand_byte;
 UINT                                  i;
+#endif /* NX_SECURE_DISABLE_X509 */
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
 NX_SECURE_EC_PRIVATE_KEY             *ec_privkey;
 NX_SECURE_TLS_ECDHE_HANDSHAKE_DATA   *ecdhe_data;
@@ -322,6 +330,13 @@ UINT                                  private_key_length;
         }
         else
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
+#ifdef NX_SECURE_DISABLE_X509
+        {
+
+            /* No local certificate to decrypt a pre-master secret with. */
+            return(NX_SECURE_TLS_UNSUPPORTED_PUBLIC_CIPHER);
+        }
+#else
         {       /* Certificate-based authentication. */
 
             /* Get pre-master-secret length. */
@@ -546,10 +561,11 @@ UINT                                  private_key_length;
                 return(NX_SECURE_TLS_UNSUPPORTED_PUBLIC_CIPHER);
             }
         }
+#endif /* NX_SECURE_DISABLE_X509 */
     }
-#ifdef NX_SECURE_KEY_CLEAR
+#if defined(NX_SECURE_KEY_CLEAR) && !defined(NX_SECURE_DISABLE_X509)
     NX_SECURE_MEMSET(_nx_secure_client_padded_pre_master, 0, sizeof(_nx_secure_client_padded_pre_master));
-#endif /* NX_SECURE_KEY_CLEAR  */
+#endif /* NX_SECURE_KEY_CLEAR && !NX_SECURE_DISABLE_X509 */
 
 #ifdef NX_SECURE_TLS_SERVER_DISABLED
     /* If TLS Server is disabled and we have processed a ClientKeyExchange, something is wrong... */
@@ -60,6 +60,9 @@ static VOID _nx_secure_tls_packet_trim(NX_PACKET *packet_ptr);
 /*    _nx_secure_tls_process_changecipherspec                             */
 /*                                          Process ChangeCipherSpec      */
 /*    _nx_secure_tls_process_header         Process record header         */
+/*    _nx_secure_tls_process_remote_certificate_stream                    */
+/*                                          Process Certificate messages  */
+/*                                            in a packet                 */
 /*    _nx_secure_tls_record_payload_decrypt Decrypt record data           */
 /*    _nx_secure_tls_server_handshake       TLS Server state machine      */
 /*    _nx_secure_tls_verify_mac             Verify record MAC checksum    */
@@ -110,6 +113,7 @@ UCHAR     *packet_data = NX_NULL;
 ULONG      record_offset = 0;
 ULONG      record_offset_next = 0;
 NX_PACKET *decrypted_packet;
+CYCLE_PROFILE_SAVE_AREA
 
     /* Basic state machine:
      * 1. Process header, which will set the state and return some data.
@@ -264,11 +268,40 @@ NX_PACKET *decrypted_packet;
                 }
             }
 
+            /* An application data record that ends the only packet in the queue is decrypted in place,
+               and that packet is returned as the decrypted packet instead of a copy of the record. */
+            if ((message_type == NX_SECURE_TLS_APPLICATION_DATA) &&
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+                !tls_session -> nx_secure_tls_1_3 &&
+#endif
+#if (NX_SECURE_TLS_TLS_1_0_ENABLED)
+                (tls_session -> nx_secure_tls_protocol_version != NX_SECURE_TLS_VERSION_TLS_1_0) &&
+#endif
+                (packet_ptr -> nx_packet_next == NX_NULL) &&
+                (record_offset_next == packet_ptr -> nx_packet_length))
+            {
+
+                /* All records in the packet are processed, so remove it from the queue. Record it so
+                   it can be released in case it is not returned to user application. */
+                tls_session -> nx_secure_record_queue_header = NX_NULL;
+                tls_session -> nx_secure_record_decrypted_packet = packet_ptr;
+                tls_session -> nx_secure_tls_bytes_processed = 0;
+                *bytes_processed = 0;
+
+                /* Start the packet at the record payload. */
+                packet_ptr -> nx_packet_prepend_ptr += record_offset;
+                packet_ptr -> nx_packet_length = message_length;
+                record_offset = 0;
+                decrypted_packet = packet_ptr;
+            }
+
             /* Decrypt the record data. */
+            CYCLE_PROFILE_ENTER
             status = _nx_secure_tls_record_payload_decrypt(tls_session, packet_ptr, record_offset,
                                                            message_length, &decrypted_packet,
                                                            tls_session -> nx_secure_tls_remote_sequence_number,
                                                            (UCHAR)message_type, wait_option);
+            CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_DECRYPT)
 
             /* Set the error status to something appropriate. */
             error_status = NX_SECURE_TLS_SUCCESS;
@@ -278,6 +311,13 @@ NX_PACKET *decrypted_packet;
             {
                 /* Save off the error status so we can return it after the mac check. */
                 error_status = status;
+
+                if (decrypted_packet == packet_ptr)
+                {
+
+                    /* The record was decrypted in place, so check the MAC over whatever the packet holds. */
+                    message_length = packet_ptr -> nx_packet_length;
+                }
             }
             else
             {
@@ -368,6 +408,15 @@ NX_PACKET *decrypted_packet;
                 return(NX_SECURE_TLS_RECORD_OVERFLOW);
             }
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+            /* The remote host agreed to send records no longer than we asked for. */
+            if (tls_session -> nx_secure_tls_receive_record_size_limit &&
+                (message_length > tls_session -> nx_secure_tls_receive_record_size_limit))
+            {
+                return(NX_SECURE_TLS_RECORD_OVERFLOW);
+            }
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
             /* Trim packet. */
             _nx_secure_tls_packet_trim(decrypted_packet);
         }
@@ -375,6 +424,26 @@ NX_PACKET *decrypted_packet;
         if (message_type != NX_SECURE_TLS_APPLICATION_DATA)
         {
 
+#if defined(NX_SECURE_TLS_ENABLE_CERTIFICATE_STREAMING) && !defined(NX_SECURE_TLS_CLIENT_DISABLED) && !defined(NX_SECURE_DISABLE_X509)
+            /* A TLS 1.2 client parses the server Certificate message straight from the packet, so the
+               chain is not copied to the packet buffer. Only the messages after it are extracted below. */
+            if ((message_type == NX_SECURE_TLS_HANDSHAKE) && (decrypted_packet == NX_NULL) &&
+                (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT) &&
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+                !tls_session -> nx_secure_tls_1_3 &&
+#endif
+                (tls_session -> nx_secure_tls_handshake_record_fragment_state == NX_SECURE_TLS_HANDSHAKE_NO_FRAGMENT))
+            {
+                status = _nx_secure_tls_process_remote_certificate_stream(tls_session, packet_ptr, &record_offset,
+                                                                          &message_length, wait_option);
+
+                if ((status != NX_SUCCESS) || (message_length == 0))
+                {
+                    return(status);
+                }
+            }
+#endif /* NX_SECURE_TLS_ENABLE_CERTIFICATE_STREAMING && !NX_SECURE_TLS_CLIENT_DISABLED && !NX_SECURE_DISABLE_X509 */
+
             /* For message other than application data, extract to packet buffer to make sure all data are in contiguous memory. */
             /* Check available area of buffer. */
             packet_data = tls_session -> nx_secure_tls_packet_buffer;
@@ -504,8 +573,7 @@ NX_PACKET *decrypted_packet;
                         /* Protocol version downgrade is disabled. Return error status. */
                         status = NX_SECURE_TLS_UNSUPPORTED_TLS_VERSION;
 #else
-                        /* Handle the ServerHello packet by legacy routine. */
-                        _nx_secure_tls_handshake_hash_init(tls_session);
+                        /* Handle the ServerHello packet by legacy routine, which initializes the handshake hash. */
                         status = _nx_secure_tls_client_handshake(tls_session, packet_data, message_length, wait_option);
 #endif /* NX_SECURE_TLS_DISABLE_PROTOCOL_VERSION_DOWNGRADE */
                     }
@@ -550,6 +618,13 @@ NX_PACKET *decrypted_packet;
                mitigation by some TLS implementations (notably OpenSSL). */
             if (message_length == 0)
             {
+                if (decrypted_packet == packet_ptr)
+                {
+
+                    /* The record decrypted in place emptied the queue, wait for more TCP packets. */
+                    return(NX_CONTINUE);
+                }
+
                 record_offset = record_offset_next;
                 status = NX_CONTINUE;
             }
@@ -90,6 +90,7 @@ UINT _nx_secure_tls_process_remote_certificate(NX_SECURE_TLS_SESSION *tls_sessio
                                                UCHAR *packet_buffer, UINT message_length,
                                                UINT data_length)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                 length;
 UINT                 total_length;
 UINT                 cert_length = 0;
@@ -438,5 +439,15 @@ ULONG                cert_buf_size;
 
     return(status);
 #endif
+#else
+
+    /* Certificates are not processed, the ciphersuites do not send them.  */
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(packet_buffer);
+    NX_PARAMETER_NOT_USED(message_length);
+    NX_PARAMETER_NOT_USED(data_length);
+
+    return(NX_SECURE_TLS_UNEXPECTED_MESSAGE);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
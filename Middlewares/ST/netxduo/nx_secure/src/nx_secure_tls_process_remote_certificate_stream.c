@@ -0,0 +1,683 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+
+#include "nx_secure_tls.h"
+#include "nx_secure_x509.h"
+
+#if defined(NX_SECURE_TLS_ENABLE_CERTIFICATE_STREAMING) && !defined(NX_SECURE_TLS_CLIENT_DISABLED) && !defined(NX_SECURE_DISABLE_X509)
+static UINT _nx_secure_tls_remote_certificate_stream(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
+                                                     ULONG offset, UINT message_length);
+static UINT _nx_secure_tls_remote_certificate_link(NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                                   NX_SECURE_X509_CERT *certificate,
+                                                   NX_SECURE_X509_CERT *next_certificate,
+                                                   UINT *chain_complete);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_process_remote_certificate_stream    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes the server Certificate messages of a record */
+/*    straight from the packet holding it, so the certificate chain is    */
+/*    never copied whole into the packet buffer. The handshake messages   */
+/*    before a Certificate message are processed as usual, and the offset */
+/*    and length of the messages after the last one are returned for the  */
+/*    normal record processing. A Certificate message continued in the    */
+/*    next record is left to the reassembly.                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    packet_ptr                            Packet holding the record     */
+/*    record_offset                         Offset of the record data,    */
+/*                                            updated on return           */
+/*    message_length                        Length of the record data,    */
+/*                                            updated on return           */
+/*    wait_option                           Controls timeout actions      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_client_handshake       TLS client state machine      */
+/*    _nx_secure_tls_process_handshake_header                             */
+/*                                          Process handshake header      */
+/*    _nx_secure_tls_remote_certificate_stream                            */
+/*                                          Process Certificate message   */
+/*    nx_packet_data_extract_offset         Extract data from packet      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_process_record         Process TLS record data       */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_process_remote_certificate_stream(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
+                                                      ULONG *record_offset, UINT *message_length,
+                                                      ULONG wait_option)
+{
+UINT   status;
+USHORT message_type;
+UINT   header_bytes;
+UINT   length;
+UCHAR  header[4];
+ULONG  bytes_copied;
+ULONG  offset = *record_offset;
+ULONG  start = *record_offset;
+ULONG  end = *record_offset + *message_length;
+
+    /* Walk the handshake messages of the record, which is entirely in the packet. */
+    while ((end - offset) >= sizeof(header))
+    {
+        status = nx_packet_data_extract_offset(packet_ptr, offset, header, sizeof(header), &bytes_copied);
+
+        if (status || (bytes_copied != sizeof(header)))
+        {
+            return(NX_SECURE_TLS_INVALID_PACKET);
+        }
+
+        header_bytes = sizeof(header);
+        status = _nx_secure_tls_process_handshake_header(header, &message_type, &header_bytes, &length);
+
+        if (status != NX_SECURE_TLS_SUCCESS)
+        {
+            return(status);
+        }
+
+        /* A message continued in the next record is left to the reassembly. */
+        if (length > (end - offset - header_bytes))
+        {
+            break;
+        }
+
+        if (message_type == NX_SECURE_TLS_CERTIFICATE_MSG)
+        {
+
+            /* Process the messages before the Certificate message as usual. */
+            if (offset > start)
+            {
+                if ((offset - start) > tls_session -> nx_secure_tls_packet_buffer_size)
+                {
+                    return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+                }
+
+                status = nx_packet_data_extract_offset(packet_ptr, start, tls_session -> nx_secure_tls_packet_buffer,
+                                                       offset - start, &bytes_copied);
+
+                if (status || (bytes_copied != (offset - start)))
+                {
+                    return(NX_SECURE_TLS_INVALID_PACKET);
+                }
+
+                status = _nx_secure_tls_client_handshake(tls_session, tls_session -> nx_secure_tls_packet_buffer,
+                                                         (UINT)(offset - start), wait_option);
+
+                if (status != NX_SUCCESS)
+                {
+                    return(status);
+                }
+            }
+
+            status = _nx_secure_tls_remote_certificate_stream(tls_session, packet_ptr, offset, length + header_bytes);
+
+            if (status != NX_SUCCESS)
+            {
+                return(status);
+            }
+
+            start = offset + header_bytes + length;
+        }
+
+        offset += header_bytes + length;
+    }
+
+    /* Return the messages after the last Certificate message. */
+    *record_offset = start;
+    *message_length = (UINT)(end - start);
+
+    return(NX_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_remote_certificate_stream            PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function processes a server Certificate message in a packet,   */
+/*    one certificate at a time. Each certificate is hashed into the      */
+/*    handshake hash, parsed, and used to verify the one received before  */
+/*    it, which is dropped unless it is the endpoint certificate. Only    */
+/*    the endpoint certificate is kept, at the end of the packet buffer   */
+/*    or in a user-allocated certificate, so the buffer needs to hold no  */
+/*    more than three certificates whatever the length of the chain. The  */
+/*    chain must be sent in order, each certificate followed by its       */
+/*    issuer, as TLS 1.2 requires.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    packet_ptr                            Packet holding the message    */
+/*    offset                                Offset of the message         */
+/*    message_length                        Length of the message with its*/
+/*                                            header                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_handshake_hash_update  Update Finished hash          */
+/*    _nx_secure_tls_remote_certificate_free_all                          */
+/*                                          Free all remote certificates  */
+/*    _nx_secure_tls_remote_certificate_link                              */
+/*                                          Verify chain certificate      */
+/*    _nx_secure_x509_certificate_list_add  Add incoming cert to store    */
+/*    _nx_secure_x509_certificate_parse     Extract public key data       */
+/*    _nx_secure_x509_expiration_check      Verify expiration of          */
+/*                                            certificate                 */
+/*    _nx_secure_x509_free_certificate_get  Get free TLS session          */
+/*                                            certificate                 */
+/*    _nx_secure_x509_remote_endpoint_certificate_get                     */
+/*                                          Get remote host certificate   */
+/*    nx_packet_data_extract_offset         Extract data from packet      */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*    [nx_secure_tls_session_certificate_callback]                        */
+/*                                          Application certificate checks*/
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_process_remote_certificate_stream                    */
+/*                                          Process Certificate messages  */
+/*                                            in a packet                 */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_tls_remote_certificate_stream(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
+                                                     ULONG offset, UINT message_length)
+{
+UINT                              status;
+UINT                              total_length;
+UINT                              cert_length;
+UINT                              bytes_processed;
+UINT                              chain_complete = NX_FALSE;
+UCHAR                             header[7];
+ULONG                             bytes_copied;
+ULONG                             buffer_size;
+ULONG                             slot_start = 0;
+ULONG                             slot_end = 0;
+ULONG                             cert_start;
+ULONG                             chunk_length;
+UCHAR                            *buffer = tls_session -> nx_secure_tls_packet_buffer;
+NX_SECURE_X509_CERT              *certificate;
+NX_SECURE_X509_CERT              *pending_certificate = NX_NULL;
+NX_SECURE_X509_CERTIFICATE_STORE *store = &tls_session -> nx_secure_tls_credentials.nx_secure_tls_certificate_store;
+ULONG                             current_time;
+
+    /* The certificates are taken from the packet one at a time, each verified against the next
+       one as it is parsed. Only the endpoint certificate, which is needed later, and the last
+       certificate, which waits for its issuer, are kept. The endpoint goes to the end of the
+       packet buffer (or to a user-allocated certificate) and the others alternate between the
+       two ends of the space left:
+        |                        Packet buffer                        |   Endpoint cert   |
+        | X.509 | Cert[i] |-->     free space      <--| X.509 | Cert[i+1] | Cert 0 | X.509 |
+    */
+
+    /* Drop the certificates of a previous handshake, which also frees the end of the packet buffer. */
+    status = _nx_secure_tls_remote_certificate_free_all(tls_session);
+
+    if (status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    buffer_size = tls_session -> nx_secure_tls_packet_buffer_size;
+
+    /* Hash the handshake header and the total length as the rest of the message is hashed piece by piece. */
+    status = nx_packet_data_extract_offset(packet_ptr, offset, header, sizeof(header), &bytes_copied);
+
+    if (status || (bytes_copied != sizeof(header)) || (message_length < sizeof(header)))
+    {
+        return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+    }
+
+    _nx_secure_tls_handshake_hash_update(tls_session, header, sizeof(header));
+
+    total_length = (UINT)((header[4] << 16) + (header[5] << 8) + header[6]);
+    offset += sizeof(header);
+
+    /* Make sure what we extracted makes sense. */
+    if (total_length > (message_length - sizeof(header)))
+    {
+        return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+    }
+
+    /* See if remote host sent an empty certificate message. */
+    if (total_length == 0)
+    {
+        /*  No certificate received! */
+        return(NX_SECURE_TLS_EMPTY_REMOTE_CERTIFICATE_RECEIVED);
+    }
+
+    while (total_length > 0)
+    {
+
+        /* Extract the next certificate's length. */
+        if (total_length < 3)
+        {
+            return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+        }
+
+        status = nx_packet_data_extract_offset(packet_ptr, offset, header, 3, &bytes_copied);
+
+        if (status || (bytes_copied != 3))
+        {
+            return(NX_SECURE_TLS_INVALID_PACKET);
+        }
+
+        _nx_secure_tls_handshake_hash_update(tls_session, header, 3);
+
+        cert_length = (UINT)((header[0] << 16) + (header[1] << 8) + header[2]);
+        offset += 3;
+
+        /* Make sure the individual cert length makes sense. */
+        if ((cert_length + 3) > total_length)
+        {
+            return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+        }
+
+        total_length -= (3 + cert_length);
+
+        if (chain_complete)
+        {
+
+            /* The chain already reached the trusted store, only hash the remaining certificates. */
+            while (cert_length > 0)
+            {
+                chunk_length = (cert_length < buffer_size) ? cert_length : buffer_size;
+
+                status = nx_packet_data_extract_offset(packet_ptr, offset, buffer, chunk_length, &bytes_copied);
+
+                if (status || (bytes_copied != chunk_length))
+                {
+                    return(NX_SECURE_TLS_INVALID_PACKET);
+                }
+
+                _nx_secure_tls_handshake_hash_update(tls_session, buffer, (UINT)chunk_length);
+
+                offset += chunk_length;
+                cert_length -= (UINT)chunk_length;
+            }
+
+            continue;
+        }
+
+        if (pending_certificate == NX_NULL)
+        {
+
+            /* This is the endpoint certificate, put it in a user-allocated certificate if there is one. */
+            status = _nx_secure_x509_free_certificate_get(store, &certificate);
+
+            if (status != NX_SUCCESS)
+            {
+                if (buffer_size < (sizeof(NX_SECURE_X509_CERT) + cert_length))
+                {
+                    return(NX_SECURE_TLS_INSUFFICIENT_CERT_SPACE);
+                }
+
+                /* Keep it at the end of the packet buffer for the rest of the session. */
+                buffer_size -= sizeof(NX_SECURE_X509_CERT);
+                certificate = (NX_SECURE_X509_CERT*)(&buffer[buffer_size]);
+                NX_SECURE_MEMSET(certificate, 0, sizeof(NX_SECURE_X509_CERT));
+
+                buffer_size -= cert_length;
+                certificate -> nx_secure_x509_certificate_raw_data = &buffer[buffer_size];
+                certificate -> nx_secure_x509_certificate_raw_buffer_size = cert_length;
+                certificate -> nx_secure_x509_user_allocated_cert = NX_FALSE;
+
+                /* Update total remaining size. */
+                tls_session -> nx_secure_tls_packet_buffer_size = buffer_size;
+            }
+            else if (certificate -> nx_secure_x509_certificate_raw_buffer_size < cert_length)
+            {
+
+                /* Not enough space to save our certificate. */
+                return(NX_SECURE_TLS_INSUFFICIENT_CERT_SPACE);
+            }
+        }
+        else
+        {
+
+            /* Take the end of the free space the waiting certificate does not use. */
+            if (slot_end == 0)
+            {
+                if (buffer_size < (sizeof(NX_SECURE_X509_CERT) + cert_length))
+                {
+                    return(NX_SECURE_TLS_INSUFFICIENT_CERT_SPACE);
+                }
+
+                cert_start = 0;
+            }
+            else if (slot_start == 0)
+            {
+                if ((buffer_size - slot_end) < (sizeof(NX_SECURE_X509_CERT) + cert_length))
+                {
+                    return(NX_SECURE_TLS_INSUFFICIENT_CERT_SPACE);
+                }
+
+                cert_start = buffer_size - (sizeof(NX_SECURE_X509_CERT) + cert_length);
+            }
+            else
+            {
+                if (slot_start < (sizeof(NX_SECURE_X509_CERT) + cert_length))
+                {
+                    return(NX_SECURE_TLS_INSUFFICIENT_CERT_SPACE);
+                }
+
+                cert_start = 0;
+            }
+
+            certificate = (NX_SECURE_X509_CERT*)(&buffer[cert_start]);
+            NX_SECURE_MEMSET(certificate, 0, sizeof(NX_SECURE_X509_CERT));
+
+            /* This certificate structure must NOT be used outside this function. */
+            certificate -> nx_secure_x509_certificate_raw_data = &buffer[cert_start + sizeof(NX_SECURE_X509_CERT)];
+            certificate -> nx_secure_x509_certificate_raw_buffer_size = cert_length;
+            certificate -> nx_secure_x509_user_allocated_cert = NX_FALSE;
+
+            slot_start = cert_start;
+            slot_end = cert_start + sizeof(NX_SECURE_X509_CERT) + cert_length;
+        }
+
+        /* Copy the certificate from the packet and hash it. */
+        status = nx_packet_data_extract_offset(packet_ptr, offset, certificate -> nx_secure_x509_certificate_raw_data,
+                                               cert_length, &bytes_copied);
+
+        if (status || (bytes_copied != cert_length))
+        {
+            return(NX_SECURE_TLS_INVALID_PACKET);
+        }
+
+        _nx_secure_tls_handshake_hash_update(tls_session, certificate -> nx_secure_x509_certificate_raw_data, cert_length);
+
+        certificate -> nx_secure_x509_certificate_raw_data_length = cert_length;
+        offset += cert_length;
+
+        /* Release the protection. */
+        tx_mutex_put(&_nx_secure_tls_protection);
+
+        /* Parse the DER-encoded X509 certificate to extract the public key data. */
+        status = _nx_secure_x509_certificate_parse(certificate -> nx_secure_x509_certificate_raw_data, cert_length, &bytes_processed, certificate);
+
+        /* Get the protection. */
+        tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+        /* Make sure we parsed a valid certificate. */
+        if (status != NX_SUCCESS)
+        {
+
+            /* Translate some X.509 return values into TLS return values. */
+            if (status == NX_SECURE_X509_UNSUPPORTED_PUBLIC_CIPHER)
+            {
+                return(NX_SECURE_TLS_UNSUPPORTED_PUBLIC_CIPHER);
+            }
+
+            return(status);
+        }
+
+        /* Assign the TLS Session metadata areas to the certificate for later use. */
+        certificate -> nx_secure_x509_public_cipher_metadata_area = tls_session -> nx_secure_public_cipher_metadata_area;
+        certificate -> nx_secure_x509_public_cipher_metadata_size = tls_session -> nx_secure_public_cipher_metadata_size;
+
+        certificate -> nx_secure_x509_hash_metadata_area = tls_session -> nx_secure_hash_mac_metadata_area;
+        certificate -> nx_secure_x509_hash_metadata_size = tls_session -> nx_secure_hash_mac_metadata_size;
+
+        /* Make sure the certificate has it's cipher table initialized. */
+        certificate -> nx_secure_x509_cipher_table = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_x509_cipher_table;
+        certificate -> nx_secure_x509_cipher_table_size = tls_session -> nx_secure_tls_crypto_table -> nx_secure_tls_x509_cipher_table_size;
+
+        if (pending_certificate == NX_NULL)
+        {
+
+            /* Add the endpoint certificate to the remote store, the only one it will hold. */
+            status = _nx_secure_x509_certificate_list_add(&store -> nx_secure_x509_remote_certificates, certificate, NX_TRUE);
+
+            if (status != NX_SUCCESS)
+            {
+
+                /* Translate some X.509 return values into TLS return values. */
+                if (status == NX_SECURE_X509_CERT_ID_DUPLICATE)
+                {
+                    return(NX_SECURE_TLS_CERT_ID_DUPLICATE);
+                }
+
+                return(status);
+            }
+        }
+        else
+        {
+
+            /* Verify the waiting certificate against this one. */
+            status = _nx_secure_tls_remote_certificate_link(store, pending_certificate, certificate, &chain_complete);
+
+            if (status != NX_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        pending_certificate = certificate;
+    }
+
+    /* The last certificate received must be issued by a trusted certificate. */
+    if ((status == NX_SUCCESS) && !chain_complete)
+    {
+        status = _nx_secure_tls_remote_certificate_link(store, pending_certificate, NX_NULL, &chain_complete);
+    }
+
+    if (status != NX_SUCCESS)
+    {
+
+        /* Translate some X.509 return values into TLS return values. */
+        switch (status)
+        {
+        case NX_SECURE_X509_UNSUPPORTED_PUBLIC_CIPHER:
+            return(NX_SECURE_TLS_UNSUPPORTED_PUBLIC_CIPHER);
+        case NX_SECURE_X509_UNKNOWN_CERT_SIG_ALGORITHM:
+            return(NX_SECURE_TLS_UNKNOWN_CERT_SIG_ALGORITHM);
+        case NX_SECURE_X509_CERTIFICATE_SIG_CHECK_FAILED:
+            return(NX_SECURE_TLS_CERTIFICATE_SIG_CHECK_FAILED);
+#ifndef NX_SECURE_ALLOW_SELF_SIGNED_CERTIFICATES
+        case NX_SECURE_X509_INVALID_SELF_SIGNED_CERT:
+            return(NX_SECURE_TLS_INVALID_SELF_SIGNED_CERT);
+#endif
+        case NX_SECURE_X509_ISSUER_CERTIFICATE_NOT_FOUND:
+            return(NX_SECURE_TLS_ISSUER_CERTIFICATE_NOT_FOUND);
+        case NX_SECURE_X509_MISSING_CRYPTO_ROUTINE:
+            return(NX_SECURE_TLS_MISSING_CRYPTO_ROUTINE);
+        default:
+            return(status);
+        }
+    }
+
+    /* Get the endpoint certificate back from the remote store. */
+    status = _nx_secure_x509_remote_endpoint_certificate_get(store, &certificate);
+
+    if (status != NX_SUCCESS)
+    {
+        return(NX_SECURE_TLS_NO_CERT_SPACE_ALLOCATED);
+    }
+
+    /* See if we have a timestamp function to get the current time. */
+    if (tls_session -> nx_secure_tls_session_time_function != NX_NULL)
+    {
+        /* Get the current time from our callback. */
+        current_time = tls_session -> nx_secure_tls_session_time_function();
+
+        /* Check the remote certificate against the current time. */
+        status = _nx_secure_x509_expiration_check(certificate, current_time);
+
+        if (status != NX_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    /* Now, see if the application has defined a callback to check additional certificate information. */
+    if (tls_session -> nx_secure_tls_session_certificate_callback != NX_NULL)
+    {
+        /* Call the user-defined callback to allow the application to perform additional validation. */
+        status = tls_session -> nx_secure_tls_session_certificate_callback(tls_session, certificate);
+
+        if (status != NX_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    /* We have received credentials from the remote host and may now pass Finished message processing. */
+    tls_session -> nx_secure_tls_received_remote_credentials = NX_TRUE;
+
+    /* Set our state to indicate we successfully parsed the Certificate message. */
+    tls_session -> nx_secure_tls_client_state = NX_SECURE_TLS_CLIENT_STATE_SERVER_CERTIFICATE;
+
+    return(NX_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_remote_certificate_link              PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function verifies a certificate of the chain sent by the       */
+/*    server against its issuer, which is either a certificate of the     */
+/*    trusted store, completing the chain, or the next certificate of the */
+/*    chain. It is the step of _nx_secure_x509_certificate_chain_verify   */
+/*    for a chain that is received one certificate at a time.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    store                                 Pointer to certificate store  */
+/*    certificate                           Pointer to certificate        */
+/*    next_certificate                      Pointer to next certificate of*/
+/*                                            the chain, NULL at its end  */
+/*    chain_complete                        Set when the issuer is trusted*/
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_list_find                               */
+/*                                          Find certificate by name      */
+/*    _nx_secure_x509_certificate_verify    Verify a certificate          */
+/*    _nx_secure_x509_certificate_verify_cached                           */
+/*                                          Verify a certificate once     */
+/*    _nx_secure_x509_distinguished_name_compare                          */
+/*                                          Compare distinguished names   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_remote_certificate_stream                            */
+/*                                          Process Certificate message   */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_tls_remote_certificate_link(NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                                   NX_SECURE_X509_CERT *certificate,
+                                                   NX_SECURE_X509_CERT *next_certificate,
+                                                   UINT *chain_complete)
+{
+UINT                 status;
+NX_SECURE_X509_CERT *issuer_certificate;
+INT                  compare_result;
+
+    /* See if the certificate is self-signed or not. */
+    compare_result = _nx_secure_x509_distinguished_name_compare(&certificate -> nx_secure_x509_distinguished_name,
+                                                                &certificate -> nx_secure_x509_issuer, NX_SECURE_X509_NAME_ALL_FIELDS);
+
+    if (compare_result != 0)
+    {
+
+        /* An issuer in the trusted store ends the chain, otherwise the issuer must be the next certificate. */
+        status = _nx_secure_x509_certificate_list_find(&store -> nx_secure_x509_trusted_certificates,
+                                                       &certificate -> nx_secure_x509_issuer, 0, &issuer_certificate);
+
+        if (status == NX_SECURE_X509_SUCCESS)
+        {
+            *chain_complete = NX_TRUE;
+        }
+        else if ((next_certificate != NX_NULL) &&
+                 (_nx_secure_x509_distinguished_name_compare(&certificate -> nx_secure_x509_issuer,
+                                                             &next_certificate -> nx_secure_x509_distinguished_name,
+                                                             NX_SECURE_X509_NAME_ALL_FIELDS) == 0))
+        {
+            issuer_certificate = next_certificate;
+        }
+        else
+        {
+            return(NX_SECURE_X509_ISSUER_CERTIFICATE_NOT_FOUND);
+        }
+    }
+    else
+    {
+#ifndef NX_SECURE_ALLOW_SELF_SIGNED_CERTIFICATES
+        /* The certificate is self-signed. If we don't allow that, return error. */
+        return(NX_SECURE_X509_INVALID_SELF_SIGNED_CERT);
+#else
+        /* A self-signed certificate must itself be in the trusted store. */
+        status = _nx_secure_x509_certificate_list_find(&store -> nx_secure_x509_trusted_certificates,
+                                                       &certificate -> nx_secure_x509_distinguished_name, 0, &issuer_certificate);
+
+        if (status != NX_SECURE_X509_SUCCESS)
+        {
+            return(NX_SECURE_X509_CHAIN_VERIFY_FAILURE);
+        }
+
+        issuer_certificate = certificate;
+        *chain_complete = NX_TRUE;
+#endif
+    }
+
+    /* Verify the certificate against its issuer certificate. */
+#if (NX_SECURE_X509_VERIFY_CACHE_SIZE > 0)
+    status = _nx_secure_x509_certificate_verify_cached(store, certificate, issuer_certificate);
+#else
+    status = _nx_secure_x509_certificate_verify(store, certificate, issuer_certificate);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
+    return(status);
+}
+#endif /* NX_SECURE_TLS_ENABLE_CERTIFICATE_STREAMING && !NX_SECURE_TLS_CLIENT_DISABLED && !NX_SECURE_DISABLE_X509 */
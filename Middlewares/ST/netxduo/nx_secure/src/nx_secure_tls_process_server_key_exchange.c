@@ -95,9 +95,11 @@ UINT _nx_secure_tls_process_server_key_exchange(NX_SECURE_TLS_SESSION *tls_sessi
 #ifdef NX_SECURE_ENABLE_PSK_CIPHERSUITES
 USHORT                                length;
 #endif /* NX_SECURE_ENABLE_PSK_CIPHERSUITES */
+#if defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) || defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE)
+UINT                                  status;
+#endif /* defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) || defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) */
 #if defined(NX_SECURE_ENABLE_PSK_CIPHERSUITES) || defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) || \
    (defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE))
-UINT                                  status;
 const NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite;
 #endif /* defined(NX_SECURE_ENABLE_PSK_CIPHERSUITES) || defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) */
 #if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE)
@@ -126,6 +128,11 @@ USHORT                                signature_algorithm_id;
 #if (NX_SECURE_TLS_TLS_1_0_ENABLED || NX_SECURE_TLS_TLS_1_1_ENABLED)
 UINT                                  i;
 #endif /* NX_SECURE_TLS_TLS_1_0_ENABLED || NX_SECURE_TLS_TLS_1_1_ENABLED */
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+UCHAR                                 private_key[NX_SECURE_TLS_PREMASTER_SIZE];
+UINT                                  public_key_length;
+UINT                                  private_key_length;
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
 #endif /* defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) */
 
     NX_PARAMETER_NOT_USED(tls_session);
@@ -868,14 +875,36 @@ UINT                                  i;
         extended_output.nx_crypto_extended_output_data = &tls_session -> nx_secure_tls_key_material.nx_secure_tls_new_key_material_data[1];
         extended_output.nx_crypto_extended_output_length_in_byte = sizeof(tls_session -> nx_secure_tls_key_material.nx_secure_tls_new_key_material_data) - 1;
         extended_output.nx_crypto_extended_output_actual_size = 0;
-        status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, handler,
-                                                     (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
-                                                     NX_NULL, 0, NX_NULL,
-                                                     (UCHAR *)&extended_output,
-                                                     sizeof(extended_output),
-                                                     tls_session -> nx_secure_public_cipher_metadata_area,
-                                                     tls_session -> nx_secure_public_cipher_metadata_size,
-                                                     NX_NULL, NX_NULL);
+#ifdef NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS
+        /* A key pair generated ahead saves the scalar multiplication of the setup. */
+        public_key_length = extended_output.nx_crypto_extended_output_length_in_byte;
+        private_key_length = sizeof(private_key);
+        if (_nx_secure_tls_ecdhe_precomputed_get(curve_method, extended_output.nx_crypto_extended_output_data,
+                                                 &public_key_length, private_key, &private_key_length) == NX_SUCCESS)
+        {
+            extended_output.nx_crypto_extended_output_actual_size = public_key_length;
+            status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_KEY_PAIR_IMPORT, handler,
+                                                         (NX_CRYPTO_METHOD*)ecdhe_method,
+                                                         private_key, private_key_length << 3,
+                                                         NX_NULL, 0, NX_NULL,
+                                                         NX_NULL, 0,
+                                                         tls_session -> nx_secure_public_cipher_metadata_area,
+                                                         tls_session -> nx_secure_public_cipher_metadata_size,
+                                                         NX_NULL, NX_NULL);
+            NX_SECURE_MEMSET(private_key, 0, sizeof(private_key));
+        }
+        else
+#endif /* NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
+        {
+            status = ecdhe_method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, handler,
+                                                         (NX_CRYPTO_METHOD*)ecdhe_method, NX_NULL, 0,
+                                                         NX_NULL, 0, NX_NULL,
+                                                         (UCHAR *)&extended_output,
+                                                         sizeof(extended_output),
+                                                         tls_session -> nx_secure_public_cipher_metadata_area,
+                                                         tls_session -> nx_secure_public_cipher_metadata_size,
+                                                         NX_NULL, NX_NULL);
+        }
         if (status != NX_CRYPTO_SUCCESS)
         {
             return(status);
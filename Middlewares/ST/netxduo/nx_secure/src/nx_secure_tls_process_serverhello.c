@@ -42,7 +42,9 @@ extern const UCHAR _nx_secure_tls_hello_retry_request_random[32];
 /*    This function processes an incoming ServerHello message, which is   */
 /*    the response to a TLS ClientHello coming from this host. The        */
 /*    ServerHello message contains the desired ciphersuite and data used  */
-/*    in the key generation process later in the handshake.               */
+/*    in the key generation process later in the handshake. A ServerHello */
+/*    echoing the session ID offered to resume restores the master secret */
+/*    of that session, its ChangeCipherSpec and Finished coming next.     */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -95,6 +97,9 @@ USHORT                                ciphersuite;
 USHORT                                ciphersuite_priority;
 NX_SECURE_TLS_HELLO_EXTENSION         extension_data[NX_SECURE_TLS_HELLO_EXTENSIONS_MAX];
 UINT                                  num_extensions;
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+NX_SECURE_TLS_SESSION_RESUMPTION     *resumption = &(tls_session -> nx_secure_tls_session_resumption);
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 USHORT                                tls_1_3 = tls_session -> nx_secure_tls_1_3;
 NX_SECURE_TLS_SERVER_STATE            old_client_state = tls_session -> nx_secure_tls_client_state;
@@ -285,6 +290,36 @@ NX_SECURE_TLS_SERVER_STATE            old_client_state = tls_session -> nx_secur
     tls_session -> nx_secure_tls_secure_renegotiation_verified = NX_FALSE;
 #endif /* NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION */
 
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+    /* The server resumes the TLS 1.2 session offered by echoing its session ID. A TLS 1.3 server
+       echoes it as well, as the legacy session ID, and resumes nothing. */
+    if ((resumption -> nx_secure_tls_resumption_session_id_length > 0) &&
+        (!tls_session -> nx_secure_tls_local_session_active) &&
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+        (!tls_session -> nx_secure_tls_1_3) &&
+#endif
+        (tls_session -> nx_secure_tls_session_id_length == resumption -> nx_secure_tls_resumption_session_id_length) &&
+        (NX_SECURE_MEMCMP(tls_session -> nx_secure_tls_session_id, resumption -> nx_secure_tls_resumption_session_id,
+                          tls_session -> nx_secure_tls_session_id_length) == 0))
+    {
+
+        /* A resumed session keeps the version and ciphersuite it was negotiated with. */
+        if ((version != resumption -> nx_secure_tls_resumption_protocol_version) ||
+            (ciphersuite != resumption -> nx_secure_tls_resumption_ciphersuite))
+        {
+            return(NX_SECURE_TLS_HANDSHAKE_FAILURE);
+        }
+
+        /* The server certificate was verified in the full handshake of the session: the keys come
+           from its master secret, after the ChangeCipherSpec and Finished of the server. */
+        NX_SECURE_MEMCPY(tls_session -> nx_secure_tls_key_material.nx_secure_tls_master_secret,
+                         resumption -> nx_secure_tls_resumption_master_secret,
+                         NX_SECURE_TLS_MASTER_SIZE); /* Use case of memcpy is verified. */
+        tls_session -> nx_secure_tls_received_remote_credentials = NX_TRUE;
+        tls_session -> nx_secure_tls_session_resumed = NX_TRUE;
+    }
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
 #ifdef NX_SECURE_TLS_CLIENT_DISABLED
     /* If TLS Client is disabled and we have processed a ServerHello, something is wrong... */
     tls_session -> nx_secure_tls_server_state = NX_SECURE_TLS_SERVER_STATE_ERROR;
@@ -54,6 +54,13 @@ static UINT _nx_secure_tls_proc_serverhello_ecjpake_key_kp_pair(NX_SECURE_TLS_SE
                                                                 USHORT *extension_length, UINT message_length);
 #endif
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+static UINT _nx_secure_tls_proc_serverhello_record_size_extension(NX_SECURE_TLS_SESSION *tls_session,
+                                                                  UCHAR *packet_buffer, USHORT extension_id,
+                                                                  USHORT *record_size_extension,
+                                                                  USHORT *extension_length, UINT message_length);
+#endif
+
 #endif /* NX_SECURE_TLS_CLIENT_DISABLED */
 
 /**************************************************************************/
@@ -91,6 +98,9 @@ static UINT _nx_secure_tls_proc_serverhello_ecjpake_key_kp_pair(NX_SECURE_TLS_SE
 /*    _nx_secure_tls_proc_serverhello_ecjpake_key_kp_pair                 */
 /*                                          Process ServerHello ECJPAKE   */
 /*                                            key kp pair extension       */
+/*    _nx_secure_tls_proc_serverhello_record_size_extension               */
+/*                                          Process ServerHello record    */
+/*                                            size extensions             */
 /*    _nx_secure_tls_proc_serverhello_sec_reneg_extension                 */
 /*                                          Process ServerHello           */
 /*                                            Renegotiation extension     */
@@ -130,6 +140,9 @@ USHORT                                extension_length;
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
 USHORT                                supported_version = tls_session -> nx_secure_tls_protocol_version;
 #endif
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+USHORT                                record_size_extension = 0;
+#endif
 
 #ifdef NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION
 #ifndef NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE
@@ -283,8 +296,22 @@ USHORT                                supported_version = tls_session -> nx_secu
         case NX_SECURE_TLS_EXTENSION_EC_POINT_FORMATS:
         case NX_SECURE_TLS_EXTENSION_ECJPAKE_KEY_KP_PAIR:
 #endif /* NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE */
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+        case NX_SECURE_TLS_EXTENSION_RECORD_SIZE_LIMIT:
+        case NX_SECURE_TLS_EXTENSION_MAX_FRAGMENT_LENGTH:
+            status = _nx_secure_tls_proc_serverhello_record_size_extension(tls_session, &packet_buffer[offset], extension_id,
+                                                                           &record_size_extension, &extension_length,
+                                                                           message_length - offset);
+            if (status)
+            {
+                return(status);
+            }
+            break;
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
         case NX_SECURE_TLS_EXTENSION_SERVER_NAME_INDICATION:
+#ifndef NX_SECURE_TLS_RECORD_SIZE_LIMIT
         case NX_SECURE_TLS_EXTENSION_MAX_FRAGMENT_LENGTH:
+#endif
         case NX_SECURE_TLS_EXTENSION_CLIENT_CERTIFICATE_URL:
         case NX_SECURE_TLS_EXTENSION_TRUSTED_CA_INDICATION:
         case NX_SECURE_TLS_EXTENSION_CERTIFICATE_STATUS_REQUEST:
@@ -1090,4 +1117,120 @@ ULONG  offset;
 }
 #endif
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_proc_serverhello_record_size_extension               */
+/*                                                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function parses the record_size_limit (RFC 8449) and           */
+/*    max_fragment_length (RFC 6066) extensions the server answered with, */
+/*    and sets the size limits of the records sent and received once the  */
+/*    session is encrypted. A server may answer with only one of them.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    packet_buffer                         Pointer to extension data     */
+/*    extension_id                          Extension type                */
+/*    record_size_extension                 Record size extension seen    */
+/*    extension_length                      Length of extension data      */
+/*    message_length                        Length of message data (bytes)*/
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_process_serverhello_extensions                       */
+/*                                          Process ServerHello extensions*/
+/*                                                                        */
+/**************************************************************************/
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+static UINT _nx_secure_tls_proc_serverhello_record_size_extension(NX_SECURE_TLS_SESSION *tls_session,
+                                                                  UCHAR *packet_buffer, USHORT extension_id,
+                                                                  USHORT *record_size_extension,
+                                                                  USHORT *extension_length, UINT message_length)
+{
+USHORT parsed_length;
+USHORT send_limit;
+USHORT receive_limit;
+
+    /* Record size extensions structure:
+     *
+     * |   2   |     2    |         2 or 1        |
+     * |  Type |  Length  |  Limit or Length Code |
+     */
+    parsed_length = (USHORT)((packet_buffer[0] << 8) + packet_buffer[1]);
+    *extension_length = (USHORT)(parsed_length + 2);
+
+    if (*extension_length > message_length)
+    {
+        return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+    }
+
+    /* RFC 8449, section 5: a server that answers with both extensions is in error. */
+    if (*record_size_extension != 0)
+    {
+        return(NX_SECURE_TLS_BAD_RECORD_SIZE_LIMIT);
+    }
+    *record_size_extension = extension_id;
+
+    if (extension_id == NX_SECURE_TLS_EXTENSION_RECORD_SIZE_LIMIT)
+    {
+        if (parsed_length != 2)
+        {
+            return(NX_SECURE_TLS_INCORRECT_MESSAGE_LENGTH);
+        }
+
+        /* The server's limit bounds what we send, the one we advertised bounds what we receive. */
+        send_limit = (USHORT)((packet_buffer[2] << 8) + packet_buffer[3]);
+        receive_limit = NX_SECURE_TLS_RECORD_SIZE_LIMIT;
+
+        if (send_limit < NX_SECURE_TLS_MIN_RECORD_SIZE_LIMIT)
+        {
+            return(NX_SECURE_TLS_BAD_RECORD_SIZE_LIMIT);
+        }
+
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+        /* In TLS 1.3 the limit counts the content type byte of the inner plaintext. */
+        if (tls_session -> nx_secure_tls_1_3)
+        {
+            send_limit = (USHORT)(send_limit - 1);
+        }
+#endif
+
+        if (send_limit > NX_SECURE_TLS_MAX_PLAINTEXT_LENGTH)
+        {
+            send_limit = NX_SECURE_TLS_MAX_PLAINTEXT_LENGTH;
+        }
+    }
+    else
+    {
+
+        /* RFC 6066, section 4: the server must echo the length we asked for. */
+        if ((parsed_length != 1) || (packet_buffer[2] != NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE))
+        {
+            return(NX_SECURE_TLS_BAD_RECORD_SIZE_LIMIT);
+        }
+
+        send_limit = NX_SECURE_TLS_RECORD_SIZE_LIMIT;
+        receive_limit = NX_SECURE_TLS_RECORD_SIZE_LIMIT;
+    }
+
+    tls_session -> nx_secure_tls_send_record_size_limit = send_limit;
+    tls_session -> nx_secure_tls_receive_record_size_limit = receive_limit;
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
 #endif /* NX_SECURE_TLS_CLIENT_DISABLED */
@@ -121,10 +121,8 @@ const NX_CRYPTO_METHOD               *authentication_method;
         return(status);
     }
 
-    if (authentication_method -> nx_crypto_cleanup)
-    {
-        status = authentication_method -> nx_crypto_cleanup(tls_session -> nx_secure_hash_mac_metadata_area);
-    }
+    /* The MAC metadata is not cleaned up after each record so the hash method can keep the states
+       derived from the MAC secrets. It is cleared when new keys are set and when the session is reset. */
 
     /* Return how many bytes our hash is since the caller doesn't necessarily know. */
     *hash_length = hash_size;
@@ -70,7 +70,9 @@ extern UCHAR _nx_secure_tls_record_block_buffer[NX_SECURE_TLS_MAX_CIPHER_BLOCK_S
 /*    message_length                        Length of message data in     */
 /*                                            encrypted_packet            */
 /*    decrypted_packet                      Pointer to packet containing  */
-/*                                            decrypted_packet            */
+/*                                            decrypted_packet, set to    */
+/*                                            encrypted_packet to decrypt */
+/*                                            in place                    */
 /*    sequence_num                          Record sequence number        */
 /*    record_type                           Record type                   */
 /*    wait_option                           Control timeout options       */
@@ -134,6 +136,8 @@ UCHAR                                 nonce[13];
         return(NX_SECURE_TLS_UNKNOWN_CIPHERSUITE);
     }
 
+    TRACE_SWO_EVENT(TRACE_SWO_EVENT_TLS_DECRYPT, tls_session, encrypted_packet, message_length, record_type)
+
     /* Select the decryption algorithm based on the ciphersuite. Then, using the session keys and the chosen
        cipher, decrypt the data. */
     session_cipher_method = tls_session -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_session_cipher;
@@ -160,6 +164,7 @@ UCHAR                                 nonce[13];
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CCM_12) ||
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CCM_16) ||
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_GCM_16) ||
+        (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305) ||
         NX_SECURE_AEAD_CIPHER_CHECK(session_cipher_method -> nx_crypto_algorithm))
     {
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
@@ -228,6 +233,51 @@ UCHAR                                 nonce[13];
         }
         else
 #endif
+        if (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305)
+        {
+
+            /* RFC 7905: ChaCha20-Poly1305 has no explicit nonce in the record. The nonce is
+               the 12-byte client_write_IV or server_write_IV XORed with the sequence number
+               padded to the left with zeroes, as in TLS 1.3.  */
+            icv_size = (session_cipher_method -> nx_crypto_ICV_size_in_bits >> 3);
+
+            if (message_length < icv_size)
+            {
+                return(NX_SECURE_TLS_AEAD_DECRYPT_FAIL);
+            }
+
+            nonce[0] = 12;
+
+            /* Copy client_write_IV or server_write_IV.  */
+            NX_SECURE_MEMCPY(&nonce[1], iv, 12); /* Use case of memcpy is verified. */
+
+            /* Correct the endianness of our sequence number and XOR with the IV. */
+            additional_data[0] = (UCHAR)(sequence_num[1] >> 24);
+            additional_data[1] = (UCHAR)(sequence_num[1] >> 16);
+            additional_data[2] = (UCHAR)(sequence_num[1] >> 8);
+            additional_data[3] = (UCHAR)(sequence_num[1]);
+            additional_data[4] = (UCHAR)(sequence_num[0] >> 24);
+            additional_data[5] = (UCHAR)(sequence_num[0] >> 16);
+            additional_data[6] = (UCHAR)(sequence_num[0] >> 8);
+            additional_data[7] = (UCHAR)(sequence_num[0]);
+            for (i = 0; i < 8; i++)
+            {
+                nonce[5 + i] = (UCHAR)(nonce[5 + i] ^ additional_data[i]);
+            }
+
+            /*  additional_data = seq_num + TLSCompressed.type +
+                            TLSCompressed.version + TLSCompressed.length;
+             */
+            additional_data[8]  = record_type;
+            additional_data[9]  = (UCHAR)(tls_session -> nx_secure_tls_protocol_version >> 8);
+            additional_data[10] = (UCHAR)(tls_session -> nx_secure_tls_protocol_version);
+            additional_data[11] = (UCHAR)((message_length - icv_size) >> 8);
+            additional_data[12] = (UCHAR)(message_length - icv_size);
+
+            /* We have 13 bytes of additional data (8 bytes seq num + 5 bytes header). */
+            additional_data_size = 13;
+        }
+        else
         {
             /* AEAD ciphers structure:
                  struct {
@@ -417,7 +467,12 @@ UCHAR                                 nonce[13];
                                                &padding_length, 1, &bytes_copied);
         if (status || (bytes_copied != 1))
         {
-            nx_secure_tls_packet_release(*decrypted_packet);
+
+            /* A packet decrypted in place is released by the caller. */
+            if (*decrypted_packet != encrypted_packet)
+            {
+                nx_secure_tls_packet_release(*decrypted_packet);
+            }
             return(NX_SECURE_TLS_PADDING_CHECK_FAILED);
         }
 
@@ -441,7 +496,10 @@ UCHAR                                 nonce[13];
                                                        copy_size, &bytes_copied);
                 if (status)
                 {
-                    nx_secure_tls_packet_release(*decrypted_packet);
+                    if (*decrypted_packet != encrypted_packet)
+                    {
+                        nx_secure_tls_packet_release(*decrypted_packet);
+                    }
                     return(NX_SECURE_TLS_PADDING_CHECK_FAILED);
                 }
 
@@ -465,17 +523,20 @@ UCHAR                                 nonce[13];
             status = NX_SECURE_TLS_PADDING_CHECK_FAILED;
         }
 
-        /* Adjust length to remove padding. */
-        /* Simply set packet length. The packet will be adjusted by caller. */
-        message_length -= (UINT)(padding_length + 1);
-        (*decrypted_packet) -> nx_packet_length = message_length;
-
         /* Return error status if appropriate. */
         if(status != NX_SUCCESS)
         {
-            nx_secure_tls_packet_release(*decrypted_packet);
+            if (*decrypted_packet != encrypted_packet)
+            {
+                nx_secure_tls_packet_release(*decrypted_packet);
+            }
             return(status);
         }
+
+        /* Adjust length to remove padding. */
+        /* Simply set packet length. The packet will be adjusted by caller. */
+        message_length -= (UINT)(padding_length + 1);
+        (*decrypted_packet) -> nx_packet_length = message_length;
     }
 
     return(NX_SUCCESS);
@@ -495,7 +556,9 @@ UCHAR                                 nonce[13];
 /*                                                                        */
 /*    This function decrypts the payload of an incoming TLS record in     */
 /*    chained packet using the session keys generated and ciphersuite     */
-/*    determined during the TLS handshake.                                */
+/*    determined during the TLS handshake. If decrypted_packet points to  */
+/*    encrypted_packet, the record is the rest of that single packet and  */
+/*    is decrypted in place, without allocating a packet for the result.  */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -507,7 +570,9 @@ UCHAR                                 nonce[13];
 /*    message_length                        Length of message data in     */
 /*                                            encrypted_packet            */
 /*    decrypted_packet                      Pointer to packet containing  */
-/*                                            decrypted_packet            */
+/*                                            decrypted_packet, set to    */
+/*                                            encrypted_packet to decrypt */
+/*                                            in place                    */
 /*    additional_data                       Pointer to additional data    */
 /*    additional_data_size                  Size of additional data       */
 /*    iv                                    Pointer to initial vector     */
@@ -520,6 +585,7 @@ UCHAR                                 nonce[13];
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    [nx_crypto_operation]                 Crypto operation              */
+/*    _nx_secure_tls_data_decrypt           Decrypt data                  */
 /*    _nx_secure_tls_record_packet_decrypt  Decrypt packet in one packet  */
 /*    nx_secure_tls_packet_release          Release packet                */
 /*                                                                        */
@@ -541,6 +607,7 @@ static UINT _nx_secure_tls_record_chained_packet_decrypt(NX_SECURE_TLS_SESSION *
                                                          UCHAR *iv, UINT wait_option)
 {
 UINT status;
+UCHAR *input;
 UCHAR *icv_ptr;
 UINT icv_size;
 UINT bytes_processed;
@@ -603,6 +670,51 @@ const NX_CRYPTO_METHOD *session_cipher_method;
         }
     }
 
+    if (*decrypted_packet == encrypted_packet)
+    {
+
+        /* Decrypt the payload over the cipher text, the ICV follows it in the same packet. */
+        input = encrypted_packet -> nx_packet_prepend_ptr + offset;
+        if (session_cipher_method -> nx_crypto_operation)
+        {
+            if (message_length > 0)
+            {
+                status = _nx_secure_tls_data_decrypt(tls_session, input, input, message_length);
+                if (status)
+                {
+                    return(status);
+                }
+            }
+
+            status = session_cipher_method -> nx_crypto_operation(NX_CRYPTO_DECRYPT_CALCULATE,
+                                                                  handler,
+                                                                  (NX_CRYPTO_METHOD*)session_cipher_method,
+                                                                  NX_NULL, 0,
+                                                                  input + message_length,
+                                                                  icv_size,
+                                                                  NX_NULL,
+                                                                  NX_NULL,
+                                                                  0,
+                                                                  crypto_method_metadata,
+                                                                  tls_session -> nx_secure_session_cipher_metadata_size,
+                                                                  NX_NULL, NX_NULL);
+            if (status == NX_CRYPTO_AUTHENTICATION_FAILED)
+            {
+                return(NX_SECURE_TLS_AEAD_DECRYPT_FAIL);
+            }
+            else if (status)
+            {
+                return(status);
+            }
+        }
+
+        /* Leave only the decrypted data in the packet. */
+        encrypted_packet -> nx_packet_prepend_ptr = input;
+        encrypted_packet -> nx_packet_append_ptr = input + message_length;
+        encrypted_packet -> nx_packet_length = message_length;
+        return(NX_SECURE_TLS_SUCCESS);
+    }
+
     /* Allocate another packet for decryption. */
     status = nx_packet_allocate(tls_session -> nx_secure_tls_packet_pool, &packet_ptr, 0, wait_option);
     if (status)
@@ -945,6 +1057,8 @@ UINT original_offset = offset;
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
+/*    _nx_secure_tls_record_chained_packet_decrypt                        */
+/*                                          Decrypt chained packet        */
 /*    _nx_secure_tls_record_packet_decrypt  Decrypt data in packet        */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
@@ -111,6 +111,8 @@ UCHAR                                *icv_ptr = NX_NULL;
         return(NX_SECURE_TLS_UNKNOWN_CIPHERSUITE);
     }
 
+    TRACE_SWO_EVENT(TRACE_SWO_EVENT_TLS_ENCRYPT, tls_session, send_packet, send_packet -> nx_packet_length, record_type)
+
     /* Select metadata based on the current mode. */
     if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_SERVER)
     {
@@ -365,7 +367,7 @@ UCHAR                                *icv_ptr = NX_NULL;
 
         /* Append data for AEAD cipher */
         status = nx_packet_data_append(send_packet, icv_ptr, icv_size,
-                                           tls_session -> nx_secure_tls_packet_pool, NX_WAIT_FOREVER);
+                                           NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet), NX_WAIT_FOREVER);
         if (status)
         {
             return(status);
@@ -475,6 +477,7 @@ UINT                                  message_length;
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CCM_12) ||
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CCM_16) ||
         (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_GCM_16) ||
+        (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305) ||
         NX_SECURE_AEAD_CIPHER_CHECK(session_cipher_method -> nx_crypto_algorithm))
     {
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
@@ -544,6 +547,49 @@ UINT                                  message_length;
         }
         else
 #endif
+        if (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305)
+        {
+
+            /* RFC 7905: ChaCha20-Poly1305 has no explicit nonce in the record. The nonce is
+               the 12-byte client_write_IV or server_write_IV XORed with the sequence number
+               padded to the left with zeroes, as in TLS 1.3.  */
+            nonce[0] = 12;
+
+            /* Copy client_write_IV or server_write_IV.  */
+            NX_SECURE_MEMCPY(&nonce[1], iv, 12); /* Use case of memcpy is verified. */
+
+            /* Correct the endianness of our sequence number and XOR with the IV. */
+            nonce[5]  = (UCHAR)(nonce[5] ^ (sequence_num[1] >> 24));
+            nonce[6]  = (UCHAR)(nonce[6] ^ (sequence_num[1] >> 16));
+            nonce[7]  = (UCHAR)(nonce[7] ^ (sequence_num[1] >> 8));
+            nonce[8]  = (UCHAR)(nonce[8] ^ (sequence_num[1]));
+            nonce[9]  = (UCHAR)(nonce[9] ^ (sequence_num[0] >> 24));
+            nonce[10] = (UCHAR)(nonce[10] ^ (sequence_num[0] >> 16));
+            nonce[11] = (UCHAR)(nonce[11] ^ (sequence_num[0] >> 8));
+            nonce[12] = (UCHAR)(nonce[12] ^ (sequence_num[0]));
+
+            /*  additional_data = seq_num + TLSCompressed.type +
+                            TLSCompressed.version + TLSCompressed.length;
+             */
+            message_length = send_packet -> nx_packet_length;
+            additional_data[0]  = (UCHAR)(sequence_num[1] >> 24);
+            additional_data[1]  = (UCHAR)(sequence_num[1] >> 16);
+            additional_data[2]  = (UCHAR)(sequence_num[1] >> 8);
+            additional_data[3]  = (UCHAR)(sequence_num[1]);
+            additional_data[4]  = (UCHAR)(sequence_num[0] >> 24);
+            additional_data[5]  = (UCHAR)(sequence_num[0] >> 16);
+            additional_data[6]  = (UCHAR)(sequence_num[0] >> 8);
+            additional_data[7]  = (UCHAR)(sequence_num[0]);
+            additional_data[8]  = record_type;
+            additional_data[9]  = (UCHAR)(tls_session -> nx_secure_tls_protocol_version >> 8);
+            additional_data[10] = (UCHAR)(tls_session -> nx_secure_tls_protocol_version);
+            additional_data[11] = (UCHAR)(message_length >> 8);
+            additional_data[12] = (UCHAR)(message_length);
+
+            /* We have 13 bytes of additional data (8 bytes seq num + 5 bytes header). */
+            additional_data_size = 13;
+        }
+        else
         {
 
             /* AEAD ciphers structure:
@@ -694,7 +740,7 @@ UINT                                  message_length;
                                  (send_packet -> nx_packet_length % block_size));
         NX_SECURE_MEMSET(_nx_secure_tls_record_block_buffer, padding_length - 1, padding_length);
         status = nx_packet_data_append(send_packet, _nx_secure_tls_record_block_buffer,
-                                       padding_length, tls_session -> nx_secure_tls_packet_pool,
+                                       padding_length, NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet),
                                        NX_WAIT_FOREVER);
 #ifdef NX_SECURE_KEY_CLEAR
         NX_SECURE_MEMSET(_nx_secure_tls_record_block_buffer, 0, block_size);
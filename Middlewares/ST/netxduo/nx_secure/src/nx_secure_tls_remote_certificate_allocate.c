@@ -89,6 +89,7 @@ UINT _nx_secure_tls_remote_certificate_allocate(NX_SECURE_TLS_SESSION *tls_sessi
                                                 NX_SECURE_X509_CERT *certificate,
                                                 UCHAR *raw_certificate_buffer, UINT buffer_size)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT status;
 
     /* Get the protection. */
@@ -115,5 +116,13 @@ UINT status;
     }
 
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(certificate);
+    NX_PARAMETER_NOT_USED(raw_certificate_buffer);
+    NX_PARAMETER_NOT_USED(buffer_size);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
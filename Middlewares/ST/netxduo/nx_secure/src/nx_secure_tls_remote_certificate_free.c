@@ -85,6 +85,7 @@
 UINT _nx_secure_tls_remote_certificate_free(NX_SECURE_TLS_SESSION *tls_session,
                                             NX_SECURE_X509_DISTINGUISHED_NAME *name)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                              status;
 NX_SECURE_X509_CERT              *list_head;
 NX_SECURE_X509_CERTIFICATE_STORE *store;
@@ -135,5 +136,11 @@ NX_SECURE_X509_CERT              *certificate;
 
     /* Return completion status.  */
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(name);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
@@ -75,6 +75,7 @@
 /**************************************************************************/
 UINT _nx_secure_tls_remote_certificate_free_all(NX_SECURE_TLS_SESSION *tls_session)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                              status = NX_SUCCESS;
 NX_SECURE_X509_CERTIFICATE_STORE *store;
 NX_SECURE_X509_CERT              *certificate;
@@ -105,5 +106,12 @@ NX_SECURE_X509_CERT              *certificate;
 
     /* Return completion status.  */
     return(status);
+#else
+
+    /* No remote certificate to free.  */
+    NX_PARAMETER_NOT_USED(tls_session);
+
+    return(NX_SUCCESS);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
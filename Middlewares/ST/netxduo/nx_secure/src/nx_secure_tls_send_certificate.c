@@ -81,6 +81,7 @@
 UINT _nx_secure_tls_send_certificate(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *send_packet,
                                      ULONG wait_option)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                 length;
 UINT                 total_length;
 UCHAR                length_buffer[3];
@@ -197,7 +198,7 @@ UINT                 extensions_length;
 
         /* Put the length into the buffer. */
         status = nx_packet_data_append(send_packet, length_buffer, 3,
-                                       tls_session -> nx_secure_tls_packet_pool, wait_option);
+                                       NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet), wait_option);
 
         /* Get the protection after nx_packet_data_append. */
         tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
@@ -212,7 +213,7 @@ UINT                 extensions_length;
 
         /* Put the certificate data into the buffer. */
         status = nx_packet_data_append(send_packet, cert -> nx_secure_x509_certificate_raw_data, length,
-                                       tls_session -> nx_secure_tls_packet_pool, wait_option);
+                                       NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet), wait_option);
 
         /* Get the protection after nx_packet_data_append. */
         tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
@@ -268,4 +269,11 @@ UINT                 extensions_length;
     record_start[2] = (UCHAR)(total_length & 0xFF);
 
     return(NX_SUCCESS);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(send_packet);
+    NX_PARAMETER_NOT_USED(wait_option);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
@@ -30,6 +30,10 @@
 static UCHAR handshake_hash[64 + 34 + 32]; /* We concatenate MD5 and SHA-1 hashes into this buffer, OR SHA-256. */
 static UCHAR _nx_secure_padded_signature[600];
 
+static UINT _nx_secure_tls_rsa_crt_set(const NX_CRYPTO_METHOD *public_cipher_method, VOID *handler,
+                                       NX_SECURE_RSA_PRIVATE_KEY *rsa_key,
+                                       VOID *metadata, ULONG metadata_size);
+
 #if (NX_SECURE_TLS_TLS_1_2_ENABLED)
 static const UCHAR _NX_SECURE_OID_SHA256[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20};
 #endif
@@ -103,6 +107,7 @@ static const UCHAR _NX_SECURE_OID_SHA256[] = {0x30, 0x31, 0x30, 0x0d, 0x06, 0x09
 UINT _nx_secure_tls_send_certificate_verify(NX_SECURE_TLS_SESSION *tls_session,
                                             NX_PACKET *send_packet)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                       length = 0;
 UINT                       data_size = 0;
 USHORT                     signature_algorithm;
@@ -687,6 +692,21 @@ NX_CRYPTO_EXTENDED_OUTPUT  extended_output;
 
             if (public_cipher_method -> nx_crypto_operation != NX_NULL)
             {
+                /* Check for P and Q in the private key. If they are present, the signature uses
+                   the Chinese Remainder Theorem, for about a third of the time. */
+                status = _nx_secure_tls_rsa_crt_set(public_cipher_method, handler,
+                                                    &local_certificate -> nx_secure_x509_private_key.rsa_private_key,
+                                                    local_certificate -> nx_secure_x509_public_cipher_metadata_area,
+                                                    local_certificate -> nx_secure_x509_public_cipher_metadata_size);
+
+                if(status != NX_CRYPTO_SUCCESS)
+                {
+#ifdef NX_SECURE_KEY_CLEAR
+                    NX_SECURE_MEMSET(_nx_secure_padded_signature, 0, sizeof(_nx_secure_padded_signature));
+#endif /* NX_SECURE_KEY_CLEAR  */
+                    return(status);
+                }
+
                 /* Sign the hash we just generated using our local RSA private key (associated with our local cert). */
                 status = public_cipher_method -> nx_crypto_operation(NX_CRYPTO_DECRYPT,
                                                             handler,
@@ -917,5 +937,74 @@ NX_CRYPTO_EXTENDED_OUTPUT  extended_output;
     send_packet -> nx_packet_length = send_packet -> nx_packet_length + (USHORT)(length);
 
     return(NX_SECURE_TLS_SUCCESS);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(send_packet);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
+/* This is a helper function to give the RSA method the primes of the private key, then its CRT
+   parameters, d mod (p - 1), d mod (q - 1) and q ^ (-1) mod p, and its public exponent which
+   blinds the operation. Those missing from the key are left out; without the primes, the
+   private exponent alone is used. */
+static UINT _nx_secure_tls_rsa_crt_set(const NX_CRYPTO_METHOD *public_cipher_method, VOID *handler,
+                                       NX_SECURE_RSA_PRIVATE_KEY *rsa_key,
+                                       VOID *metadata, ULONG metadata_size)
+{
+static const UINT ops[] = {NX_CRYPTO_SET_PRIME_P, NX_CRYPTO_SET_PRIME_Q,
+                           NX_CRYPTO_SET_CRT_EXPONENT_P, NX_CRYPTO_SET_CRT_EXPONENT_Q,
+                           NX_CRYPTO_SET_CRT_COEFFICIENT, NX_CRYPTO_SET_PUBLIC_EXPONENT};
+const UCHAR      *values[sizeof(ops) / sizeof(ops[0])];
+USHORT            lengths[sizeof(ops) / sizeof(ops[0])];
+UINT              status;
+UINT              i;
+
+    if ((rsa_key -> nx_secure_rsa_private_prime_p == NX_NULL) || (rsa_key -> nx_secure_rsa_private_prime_q == NX_NULL))
+    {
+        return(NX_CRYPTO_SUCCESS);
+    }
+
+    values[0] = rsa_key -> nx_secure_rsa_private_prime_p;
+    lengths[0] = rsa_key -> nx_secure_rsa_private_prime_p_length;
+    values[1] = rsa_key -> nx_secure_rsa_private_prime_q;
+    lengths[1] = rsa_key -> nx_secure_rsa_private_prime_q_length;
+    values[2] = rsa_key -> nx_secure_rsa_private_exponent_p;
+    lengths[2] = rsa_key -> nx_secure_rsa_private_exponent_p_length;
+    values[3] = rsa_key -> nx_secure_rsa_private_exponent_q;
+    lengths[3] = rsa_key -> nx_secure_rsa_private_exponent_q_length;
+    values[4] = rsa_key -> nx_secure_rsa_private_coefficient;
+    lengths[4] = rsa_key -> nx_secure_rsa_private_coefficient_length;
+    values[5] = rsa_key -> nx_secure_rsa_public_exponent;
+    lengths[5] = rsa_key -> nx_secure_rsa_public_exponent_length;
+
+    for (i = 0; i < (sizeof(ops) / sizeof(ops[0])); i++)
+    {
+        if (values[i] == NX_NULL)
+        {
+            continue;
+        }
+
+        status = public_cipher_method -> nx_crypto_operation(ops[i],
+                                                             handler,
+                                                             (NX_CRYPTO_METHOD*)public_cipher_method,
+                                                             NX_NULL,
+                                                             0,
+                                                             (VOID *)values[i],
+                                                             lengths[i],
+                                                             NX_NULL,
+                                                             NX_NULL,
+                                                             0,
+                                                             metadata,
+                                                             metadata_size,
+                                                             NX_NULL, NX_NULL);
+
+        if(status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    return(NX_CRYPTO_SUCCESS);
+}
@@ -25,7 +25,9 @@
 
 #include "nx_secure_tls.h"
 
+#ifndef NX_SECURE_DISABLE_X509
 static UCHAR _nx_secure_client_padded_pre_master[600];
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /**************************************************************************/
 /*                                                                        */
@@ -80,15 +82,19 @@ static UCHAR _nx_secure_client_padded_pre_master[600];
 UINT _nx_secure_tls_send_client_key_exchange(NX_SECURE_TLS_SESSION *tls_session,
                                              NX_PACKET *send_packet)
 {
+#if defined(NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE) || !defined(NX_SECURE_DISABLE_X509)
 UINT                                  status;
+const NX_CRYPTO_METHOD               *public_cipher_method;
+#endif /* NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE || !NX_SECURE_DISABLE_X509 */
 UINT                                  data_size;
 UCHAR                                *encrypted_data_ptr;
 UCHAR                                *packet_buffer;
+#ifndef NX_SECURE_DISABLE_X509
 UCHAR                                 rand_byte;
 UINT                                  i;
-const NX_CRYPTO_METHOD               *public_cipher_method;
 NX_SECURE_X509_CERT                  *remote_certificate;
 VOID                                 *handler = NX_NULL;
+#endif /* NX_SECURE_DISABLE_X509 */
 #ifdef NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE
 NX_CRYPTO_EXTENDED_OUTPUT             extended_output;
 #endif /* NX_SECURE_ENABLE_ECJPAKE_CIPHERSUITE */
@@ -194,6 +200,13 @@ NX_CRYPTO_EXTENDED_OUTPUT             extended_output;
         }
         else
 #endif
+#ifdef NX_SECURE_DISABLE_X509
+        {
+
+            /* No server certificate to encrypt a pre-master secret with. */
+            return(NX_SECURE_TLS_UNSUPPORTED_PUBLIC_CIPHER);
+        }
+#else
         {
 
             /* Extract the data to be verified from the remote certificate processed earlier. */
@@ -313,15 +326,16 @@ NX_CRYPTO_EXTENDED_OUTPUT             extended_output;
 
             data_size += 2;
         }
+#endif /* NX_SECURE_DISABLE_X509 */
     }
 
     /* Let the caller know how many bytes we wrote. +2 for the length we just added. */
     send_packet -> nx_packet_append_ptr = send_packet -> nx_packet_append_ptr + data_size;
     send_packet -> nx_packet_length = send_packet -> nx_packet_length + data_size;
 
-#ifdef NX_SECURE_KEY_CLEAR
+#if defined(NX_SECURE_KEY_CLEAR) && !defined(NX_SECURE_DISABLE_X509)
     NX_SECURE_MEMSET(_nx_secure_client_padded_pre_master, 0, sizeof(_nx_secure_client_padded_pre_master));
-#endif /* NX_SECURE_KEY_CLEAR  */
+#endif /* NX_SECURE_KEY_CLEAR && !NX_SECURE_DISABLE_X509 */
 
     return(NX_SECURE_TLS_SUCCESS);
 }
@@ -47,6 +47,8 @@ UINT _nx_secure_tls_send_clienthello_psk_extension(NX_SECURE_TLS_SESSION *tls_se
 /*                                                                        */
 /*    This function populates an NX_PACKET with a ClientHello message,    */
 /*    which kicks off a TLS handshake when sent to a remote TLS server.   */
+/*    The ClientHello of an initial handshake carries the session ID of   */
+/*    the session offered to resume, if any.                              */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -59,7 +61,6 @@ UINT _nx_secure_tls_send_clienthello_psk_extension(NX_SECURE_TLS_SESSION *tls_se
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _nx_secure_tls_handshake_hash_init    Initialize the finished hash  */
 /*    _nx_secure_tls_newest_supported_version                             */
 /*                                          Get the version of TLS to use */
 /*    _nx_secure_tls_send_clienthello_extensions                          */
@@ -109,13 +110,9 @@ ULONG                      extension_length, total_extensions_length;
 
     packet_buffer = send_packet -> nx_packet_append_ptr;
 
-    /* Initialize the handshake hashes used for the Finished message. */
-#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
-    if(!tls_session->nx_secure_tls_1_3)
-#endif
-    {
-        _nx_secure_tls_handshake_hash_init(tls_session);
-    }
+    /* The handshake hashes used for the Finished message are initialized after the ServerHello,
+       for the negotiated version only. Until then the ClientHello is cached by
+       _nx_secure_tls_send_handshake_record. */
 
     /* Use our length as an index into the buffer. */
     length = 0;
@@ -153,6 +150,25 @@ ULONG                      extension_length, total_extensions_length;
         ciphersuites_length = (USHORT)(ciphersuites_length + 2);
     }
 
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+    /* An initial handshake offers the session to resume, if any, by its session ID. The server
+       resumes it by echoing the ID in its ServerHello.  */
+    tls_session -> nx_secure_tls_session_resumed = NX_FALSE;
+    if ((tls_session -> nx_secure_tls_session_resumption.nx_secure_tls_resumption_session_id_length > 0) &&
+        (!tls_session -> nx_secure_tls_local_session_active))
+    {
+        tls_session -> nx_secure_tls_session_id_length =
+            tls_session -> nx_secure_tls_session_resumption.nx_secure_tls_resumption_session_id_length;
+        NX_SECURE_MEMCPY(tls_session -> nx_secure_tls_session_id,
+                         tls_session -> nx_secure_tls_session_resumption.nx_secure_tls_resumption_session_id,
+                         tls_session -> nx_secure_tls_session_id_length); /* Use case of memcpy is verified. */
+    }
+    else
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+    {
+        tls_session -> nx_secure_tls_session_id_length = 0;
+    }
+
     if (((ULONG)(send_packet -> nx_packet_data_end) - (ULONG)(send_packet -> nx_packet_append_ptr)) <
         (9u + sizeof(tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_random) +
          tls_session -> nx_secure_tls_session_id_length + ciphersuites_length))
@@ -203,7 +219,6 @@ ULONG                      extension_length, total_extensions_length;
     length += sizeof(tls_session -> nx_secure_tls_key_material.nx_secure_tls_client_random);
 
     /* Session ID length is one byte. */
-    tls_session -> nx_secure_tls_session_id_length  = 0;
     packet_buffer[length] = tls_session -> nx_secure_tls_session_id_length;
     length++;
 
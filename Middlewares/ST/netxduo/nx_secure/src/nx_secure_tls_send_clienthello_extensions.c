@@ -26,6 +26,7 @@
 
 #ifndef NX_SECURE_TLS_CLIENT_DISABLED
 
+#ifndef NX_SECURE_DISABLE_X509
 static VOID _nx_secure_tls_get_signature_algorithm(NX_SECURE_TLS_SESSION *tls_session,
                                                    NX_SECURE_X509_CRYPTO *crypto_method,
                                                    USHORT *signature_algorithm);
@@ -34,6 +35,7 @@ static UINT _nx_secure_tls_send_clienthello_sig_extension(NX_SECURE_TLS_SESSION
                                                           UCHAR *packet_buffer, ULONG *packet_offset,
                                                           USHORT *extension_length,
                                                           ULONG available_size);
+#endif /* NX_SECURE_DISABLE_X509 */
 static UINT _nx_secure_tls_send_clienthello_sni_extension(NX_SECURE_TLS_SESSION *tls_session,
                                                           UCHAR *packet_buffer, ULONG *packet_offset,
                                                           USHORT *extension_length,
@@ -76,6 +78,14 @@ static UINT _nx_secure_tls_send_clienthello_sec_reneg_extension(NX_SECURE_TLS_SE
                                                                 ULONG available_size);
 #endif
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+static UINT _nx_secure_tls_send_clienthello_record_size_extensions(NX_SECURE_TLS_SESSION *tls_session,
+                                                                   UCHAR *packet_buffer,
+                                                                   ULONG *packet_offset,
+                                                                   USHORT *extension_length,
+                                                                   ULONG available_size);
+#endif
+
 
 /**************************************************************************/
 /*                                                                        */
@@ -107,6 +117,9 @@ static UINT _nx_secure_tls_send_clienthello_sec_reneg_extension(NX_SECURE_TLS_SE
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_secure_tls_send_clienthello_record_size_extensions              */
+/*                                          Send ClientHello record size  */
+/*                                            extensions                  */
 /*    _nx_secure_tls_send_clienthello_sec_reneg_extension                 */
 /*                                          Send ClientHello Renegotiation*/
 /*                                            extension                   */
@@ -220,7 +233,9 @@ UINT   status;
 
     /* RFC 5246 7.4.1.4.1 Signature Algorithm:
        Note: this extension is not meaningful for TLS versions prior to 1.2.
-       Clients MUST NOT offer it if they are offering prior versions. */
+       Clients MUST NOT offer it if they are offering prior versions.
+       Without X.509 there is no signature to negotiate. */
+#ifndef NX_SECURE_DISABLE_X509
     if (tls_session -> nx_secure_tls_protocol_version == NX_SECURE_TLS_VERSION_TLS_1_2)
     {
 
@@ -232,6 +247,7 @@ UINT   status;
         }
         total_extensions_length = (USHORT)(total_extensions_length + extension_length);
     }
+#endif /* NX_SECURE_DISABLE_X509 */
 
 #ifndef NX_SECURE_TLS_SNI_EXTENSION_DISABLED
     /* Send the server name indication extension. */
@@ -243,6 +259,16 @@ UINT   status;
     total_extensions_length = (USHORT)(total_extensions_length + extension_length);
 #endif
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+    /* Ask the server for small records. */
+    status = _nx_secure_tls_send_clienthello_record_size_extensions(tls_session, packet_buffer, &length, &extension_length, available_size);
+    if(status != NX_SUCCESS)
+    {
+        return(status);
+    }
+    total_extensions_length = (USHORT)(total_extensions_length + extension_length);
+#endif
+
 #if (NX_SECURE_TLS_TLS_1_3_ENABLED)
     if(tls_session->nx_secure_tls_1_3 && tls_session->nx_secure_tls_credentials.nx_secure_tls_psk_count > 0)
     {
@@ -263,7 +289,7 @@ UINT   status;
 }
 
 
-
+#ifndef NX_SECURE_DISABLE_X509
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -481,6 +507,7 @@ UCHAR sig_algo = 0;
         *signature_algorithm = (USHORT)((hash_algo << 8) + sig_algo);
     }
 }
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /**************************************************************************/
 /*                                                                        */
@@ -1733,5 +1760,103 @@ NX_SECURE_TLS_ECC *ecc_info;
     return(NX_SUCCESS);
 }
 #endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE */
+
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_send_clienthello_record_size_extensions              */
+/*                                                        PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds the Record Size Limit extension (RFC 8449) and   */
+/*    the Maximum Fragment Length extension (RFC 6066) to an outgoing     */
+/*    ClientHello record, asking the server for records of at most        */
+/*    NX_SECURE_TLS_RECORD_SIZE_LIMIT bytes of plaintext. A server that   */
+/*    knows both answers with the Record Size Limit one.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    packet_buffer                         Outgoing TLS packet buffer    */
+/*    packet_offset                         Offset into packet buffer     */
+/*    extension_length                      Return length of data         */
+/*    available_size                        Available size of buffer      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_send_clienthello_extensions                          */
+/*                                          Send TLS ClientHello extension*/
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_tls_send_clienthello_record_size_extensions(NX_SECURE_TLS_SESSION *tls_session,
+                                                                   UCHAR *packet_buffer,
+                                                                   ULONG *packet_offset,
+                                                                   USHORT *extension_length,
+                                                                   ULONG available_size)
+{
+ULONG  offset;
+USHORT limit = NX_SECURE_TLS_RECORD_SIZE_LIMIT;
+
+    /* Record Size Limit and Maximum Fragment Length extensions structure:
+     * |     2      |     2     |      2       |     2      |     2     |    1     |
+     * |  Ext Type  |  Ext Len  | Record Limit |  Ext Type  |  Ext Len  |   Code   |
+     * |   0x001c   |   0x0002  |              |   0x0001   |   0x0001  |  1 - 4   |
+     */
+
+    /* Start with our passed-in packet offset. */
+    offset = *packet_offset;
+
+    if (available_size < (offset + 11u))
+    {
+
+        /* Packet buffer too small. */
+        return(NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL);
+    }
+
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+    /* In TLS 1.3 the limit also counts the content type of the inner plaintext. */
+    if (tls_session -> nx_secure_tls_1_3)
+    {
+        limit++;
+    }
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+#endif
+
+    packet_buffer[offset] = (UCHAR)((NX_SECURE_TLS_EXTENSION_RECORD_SIZE_LIMIT) >> 8);
+    packet_buffer[offset + 1] = (UCHAR)(NX_SECURE_TLS_EXTENSION_RECORD_SIZE_LIMIT);
+    packet_buffer[offset + 2] = 0x00;
+    packet_buffer[offset + 3] = 0x02;
+    packet_buffer[offset + 4] = (UCHAR)(limit >> 8);
+    packet_buffer[offset + 5] = (UCHAR)(limit);
+    offset += 6;
+
+    packet_buffer[offset] = (UCHAR)((NX_SECURE_TLS_EXTENSION_MAX_FRAGMENT_LENGTH) >> 8);
+    packet_buffer[offset + 1] = (UCHAR)(NX_SECURE_TLS_EXTENSION_MAX_FRAGMENT_LENGTH);
+    packet_buffer[offset + 2] = 0x00;
+    packet_buffer[offset + 3] = 0x01;
+    packet_buffer[offset + 4] = NX_SECURE_TLS_MAX_FRAGMENT_LENGTH_CODE;
+    offset += 5;
+
+    /* Return the amount of data we wrote. */
+    *extension_length = (USHORT)(offset - *packet_offset);
+
+    /* Return our updated packet offset. */
+    *packet_offset = offset;
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
 #endif /* NX_SECURE_TLS_CLIENT_DISABLED */
 
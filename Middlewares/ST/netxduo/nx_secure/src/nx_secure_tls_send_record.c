@@ -106,6 +106,7 @@ ULONG      hash_data_length;
 ULONG      length;
 USHORT     iv_size = 0;
 NX_PACKET *current_packet;
+CYCLE_PROFILE_SAVE_AREA
 
     /* Length of the data in the packet. */
     length = send_packet -> nx_packet_length;
@@ -133,6 +134,17 @@ NX_PACKET *current_packet;
         return(NX_SECURE_TLS_TRANSMIT_LOCKED);
     }
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+    /* The record size negotiated with the remote host bounds the protected records. */
+    if (tls_session -> nx_secure_tls_local_session_active &&
+        tls_session -> nx_secure_tls_send_record_size_limit &&
+        (length > tls_session -> nx_secure_tls_send_record_size_limit))
+    {
+        tx_mutex_put(&(tls_session -> nx_secure_tls_session_transmit_mutex));
+        return(NX_SECURE_TLS_RECORD_OVERFLOW);
+    }
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
     /* See if this is an active session, we need to account for the IV if the session cipher
        uses one. TLS 1.3 does not use an explicit IV so don't add it.*/
     if (tls_session -> nx_secure_tls_local_session_active
@@ -213,7 +225,7 @@ NX_PACKET *current_packet;
         {
             /* If in a TLS 1.3 encrypted session, write the message type to the end. */
             status = nx_packet_data_append(send_packet, (UCHAR*)(&record_type), 1,
-                                           tls_session -> nx_secure_tls_packet_pool, wait_option);
+                                           NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet), wait_option);
 
             if(status != NX_SUCCESS)
             {
@@ -293,7 +305,7 @@ NX_PACKET *current_packet;
 
             /* Append the hash to the plaintext data in the last packet before encryption. */
             status = nx_packet_data_append(send_packet, record_hash, hash_length,
-                                           tls_session -> nx_secure_tls_packet_pool, wait_option);
+                                           NX_SECURE_TLS_RECORD_PACKET_POOL(tls_session, send_packet), wait_option);
 
 #ifdef NX_SECURE_KEY_CLEAR
             NX_SECURE_MEMSET(record_hash, 0, sizeof(record_hash));
@@ -307,7 +319,9 @@ NX_PACKET *current_packet;
         /*************************************************************************************************************/
         /***** ENCRYPTION *****/
 
+        CYCLE_PROFILE_ENTER
         status = _nx_secure_tls_record_payload_encrypt(tls_session, send_packet, tls_session -> nx_secure_tls_local_sequence_number, record_type);
+        CYCLE_PROFILE_EXIT(CYCLE_PROFILE_TLS_ENCRYPT)
 
         if (status != NX_SUCCESS)
         {
@@ -345,7 +359,8 @@ NX_PACKET *current_packet;
     status = nx_tcp_socket_send(tls_session -> nx_secure_tls_tcp_socket, send_packet, wait_option);
 
 #ifdef NX_SECURE_KEY_CLEAR
-    if (tls_session -> nx_secure_tls_local_session_active)
+    /* A record queued on the socket is not sent yet, it must not be cleared. */
+    if (tls_session -> nx_secure_tls_local_session_active && (status != NX_IN_PROGRESS))
     {
 
         /* Clear all data in chained packet. */
@@ -360,6 +375,15 @@ NX_PACKET *current_packet;
     }
 #endif /* NX_SECURE_KEY_CLEAR  */
 
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* A record queued on the socket is sent in order once the window opens, so for the
+       record layer it is sent. */
+    if (status == NX_IN_PROGRESS)
+    {
+        status = NX_SUCCESS;
+    }
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+
     /* Get the protection after nx_tcp_socket_send. */
     tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
 
@@ -78,6 +78,7 @@
 UINT  _nx_secure_tls_server_certificate_find(NX_SECURE_TLS_SESSION *tls_session,
                                              NX_SECURE_X509_CERT **certificate, UINT cert_id)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT status;
 
     /* Find and return the certificate based on its ID. */
@@ -91,5 +92,12 @@ UINT status;
 
     /* Return completion status.  */
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(certificate);
+    NX_PARAMETER_NOT_USED(cert_id);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
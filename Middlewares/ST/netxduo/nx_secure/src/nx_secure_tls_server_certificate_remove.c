@@ -76,6 +76,7 @@
 /**************************************************************************/
 UINT  _nx_secure_tls_server_certificate_remove(NX_SECURE_TLS_SESSION *tls_session, UINT cert_id)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT status;
 
     /* Remove the certificate from the local store. */
@@ -90,5 +91,11 @@ UINT status;
 
     /* Return completion status.  */
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(cert_id);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
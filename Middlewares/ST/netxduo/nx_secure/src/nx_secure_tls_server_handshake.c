@@ -158,8 +158,9 @@ const NX_CRYPTO_METHOD               *method_ptr = NX_NULL;
     /* Advance the buffer pointer past the handshake header. */
     packet_buffer += header_bytes;
 
-    /* Get reference to the packet pool so we can allocate a packet for all send operations.  */
-    packet_pool = tls_session -> nx_secure_tls_packet_pool;
+    /* Get reference to the packet pool so we can allocate a packet for all send operations,
+       the control pool when the session has one.  */
+    packet_pool = NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session);
 
     /* We need to hash all of the handshake messages that we receive and send. If this message is a ClientHello,
        then we need to initialize the hashes (TLS 1.1 uses both MD5 and SHA-1). The final hash is generated
@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_session_arena_create                 PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function creates a TLS session whose crypto metadata and       */
+/*    packet buffer are taken from a TLS session arena, in one block. The */
+/*    metadata size is calculated from the crypto table. The block        */
+/*    returns to the arena when the session is deleted.                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    session_ptr                           TLS session control block     */
+/*    crypto_table                          Crypto methods                */
+/*    arena_ptr                             Pointer to arena              */
+/*    packet_buffer_size                    Size of packet buffer         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_metadata_size_calculate                              */
+/*                                          Calculate metadata size       */
+/*    _nx_secure_tls_session_create         Create TLS session            */
+/*    _nx_secure_tls_session_delete         Delete TLS session            */
+/*    _nx_secure_tls_session_packet_buffer_set                            */
+/*                                          Set packet buffer             */
+/*    tx_byte_allocate                      Allocate arena block          */
+/*    tx_byte_release                       Release arena block           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_session_arena_create(NX_SECURE_TLS_SESSION *session_ptr,
+                                         const NX_SECURE_TLS_CRYPTO *crypto_table,
+                                         NX_SECURE_TLS_ARENA *arena_ptr, ULONG packet_buffer_size)
+{
+UINT   status;
+ULONG  metadata_size;
+VOID  *block_ptr;
+
+    status = _nx_secure_tls_metadata_size_calculate(crypto_table, &metadata_size);
+
+    if (status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Keep the packet buffer after the metadata four byte aligned. */
+    metadata_size = (metadata_size + 3) & 0xFFFFFFFC;
+
+    /* Take the block from the arena, an exhausted arena fails the session instead of waiting. */
+    if (tx_byte_allocate(&(arena_ptr -> nx_secure_tls_arena_pool), &block_ptr,
+                         metadata_size + packet_buffer_size, TX_NO_WAIT) != TX_SUCCESS)
+    {
+        return(NX_SECURE_TLS_INSUFFICIENT_METADATA_SPACE);
+    }
+
+    status = _nx_secure_tls_session_create(session_ptr, crypto_table, block_ptr, metadata_size);
+
+    if (status != NX_SUCCESS)
+    {
+        tx_byte_release(block_ptr);
+        return(status);
+    }
+
+    status = _nx_secure_tls_session_packet_buffer_set(session_ptr, (UCHAR *)block_ptr + metadata_size,
+                                                      packet_buffer_size);
+
+    if (status != NX_SUCCESS)
+    {
+        _nx_secure_tls_session_delete(session_ptr);
+        tx_byte_release(block_ptr);
+        return(status);
+    }
+
+    /* Return the block to the arena once the session is deleted. */
+    session_ptr -> nx_secure_tls_arena_block = block_ptr;
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
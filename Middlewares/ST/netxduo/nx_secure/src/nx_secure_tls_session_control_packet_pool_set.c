@@ -0,0 +1,81 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_secure_tls.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_session_control_packet_pool_set      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the packet pool the TLS session allocates its    */
+/*    control records from: the handshake messages, ChangeCipherSpec and  */
+/*    the alerts, close_notify included. A small pool reserved to them    */
+/*    keeps a handshake or a closure going while the application data     */
+/*    has taken all the packets of the pool of the IP instance, which the */
+/*    data records still come from. Its packets must hold the largest     */
+/*    handshake message the session builds in one packet, the ClientHello */
+/*    of a client; a certificate message chains packets of the pool. A    */
+/*    NX_NULL pool puts the control records back in the data pool.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    session_ptr                           TLS session control block     */
+/*    packet_pool                           Pool of the control records   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nx_secure_tls_session_control_packet_pool_set(NX_SECURE_TLS_SESSION *session_ptr,
+                                                     NX_PACKET_POOL *packet_pool)
+{
+
+    /* Get the protection. */
+    tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+    /* Set the pool of the control records. */
+    session_ptr -> nx_secure_tls_control_packet_pool = packet_pool;
+
+    /* Release the protection. */
+    tx_mutex_put(&_nx_secure_tls_protection);
+
+    return(NX_SUCCESS);
+}
@@ -355,6 +355,7 @@ const UCHAR all_found =     sig_found | key_ex_found | symm_found | hash_found |
 }
 
 
+#ifndef NX_SECURE_DISABLE_X509
 
 static UINT _map_x509_ciphersuites(NX_SECURE_TLS_SESSION *tls_session,
                                   const NX_CRYPTO_METHOD **crypto_array, UINT crypto_array_size,
@@ -458,6 +459,7 @@ const UCHAR all_found =     pub_key_found | hash_found;
 
     return(NX_SUCCESS);
 }
+#endif /* NX_SECURE_DISABLE_X509 */
 
 
 
@@ -487,8 +489,10 @@ NX_SECURE_TLS_CRYPTO *          crypto_table;
 
 NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite_table;
 USHORT                          ciphersuite_table_size;
+#ifndef NX_SECURE_DISABLE_X509
 NX_SECURE_X509_CRYPTO           *cert_crypto;
 USHORT                          cert_crypto_size;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
 NX_CRYPTO_METHOD              **curve_crypto_list = NX_NULL;
@@ -577,6 +581,8 @@ ULONG metadata_size_sha256 = 0;
         /* Update metadata pointers. */
         metadata_area += cipher_table_bytes;
         metadata_size -= cipher_table_bytes;
+
+#ifndef NX_SECURE_DISABLE_X509
         cipher_table_bytes = metadata_size;
 
         /* Carve out space for our dynamic X.509 ciphersuite table. */
@@ -594,6 +600,7 @@ ULONG metadata_size_sha256 = 0;
         /* Advance the metadata area past the end of the crypto table. */
         metadata_area += cipher_table_bytes;
         metadata_size -= cipher_table_bytes;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 #ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
         curve_crypto_list = (NX_CRYPTO_METHOD **)(&metadata_area[0]);
@@ -649,8 +656,10 @@ ULONG metadata_size_sha256 = 0;
     ciphersuite_table = crypto_table->nx_secure_tls_ciphersuite_lookup_table;
     ciphersuite_table_size = crypto_table->nx_secure_tls_ciphersuite_lookup_table_size;
 
+#ifndef NX_SECURE_DISABLE_X509
     cert_crypto = crypto_table -> nx_secure_tls_x509_cipher_table;
     cert_crypto_size = crypto_table -> nx_secure_tls_x509_cipher_table_size;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 #if (NX_SECURE_TLS_TLS_1_0_ENABLED || NX_SECURE_TLS_TLS_1_1_ENABLED)
     crypto_method_md5 = crypto_table -> nx_secure_tls_handshake_hash_md5_method;
@@ -727,6 +736,7 @@ ULONG metadata_size_sha256 = 0;
     tls_session -> nx_secure_tls_1_3 = tls_session -> nx_secure_tls_1_3_supported;
 #endif
 
+#ifndef NX_SECURE_DISABLE_X509
     /* Loop through the certificate cipher table as well. */
     for (i = 0; i < cert_crypto_size; ++i)
     {
@@ -745,6 +755,7 @@ ULONG metadata_size_sha256 = 0;
             max_handshake_hash_scratch_size = cert_crypto[i].nx_secure_x509_hash_method -> nx_crypto_metadata_area_size;
         }
     }
+#endif /* NX_SECURE_DISABLE_X509 */
 
     /* We also need metadata space for the TLS handshake hash, so add that into the total.
        We need some scratch space to copy the handshake hash metadata during final hash generation
@@ -817,6 +828,21 @@ ULONG metadata_size_sha256 = 0;
         max_handshake_hash_scratch_size += 4 - (max_handshake_hash_scratch_size & 0x3);
     }
 
+#ifdef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+    /* The two session cipher states and the PRF follow each other in the public cipher metadata,
+       so it must hold all of them. */
+    if (max_public_cipher_metadata_size < ((2 * max_session_cipher_metadata_size) + max_tls_prf_metadata_size))
+    {
+        max_public_cipher_metadata_size = (2 * max_session_cipher_metadata_size) + max_tls_prf_metadata_size;
+    }
+
+    /* The Total metadata size needed is the sum of the maximums calculated above, less the areas shared
+       with the public cipher. */
+    max_total_metadata_size = max_public_cipher_metadata_size +
+                              max_hash_mac_metadata_size +
+                              max_handshake_hash_metadata_size +
+                              max_handshake_hash_scratch_size;
+#else
     /* The Total metadata size needed is the sum of all the maximums calculated above.
        We need to keep track of two separate session cipher states, one for the server and one for the client,
        so account for that extra space. */
@@ -826,6 +852,7 @@ ULONG metadata_size_sha256 = 0;
                               max_tls_prf_metadata_size +
                               max_handshake_hash_metadata_size +
                               max_handshake_hash_scratch_size;
+#endif /* NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA */
 
     /* Check if the caller provided enough metadata space. */
     if (max_total_metadata_size > metadata_size)
@@ -837,11 +864,13 @@ ULONG metadata_size_sha256 = 0;
     tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
 
 
+#ifndef NX_SECURE_DISABLE_X509
     /* Clear out the X509 certificate stores when we create a new TLS Session. */
     tls_session -> nx_secure_tls_credentials.nx_secure_tls_certificate_store.nx_secure_x509_remote_certificates = NX_NULL;
     tls_session -> nx_secure_tls_credentials.nx_secure_tls_certificate_store.nx_secure_x509_local_certificates = NX_NULL;
     tls_session -> nx_secure_tls_credentials.nx_secure_tls_certificate_store.nx_secure_x509_trusted_certificates = NX_NULL;
     tls_session -> nx_secure_tls_credentials.nx_secure_tls_active_certificate = NX_NULL;
+#endif /* NX_SECURE_DISABLE_X509 */
 
     /* Release the protection. */
     tx_mutex_put(&_nx_secure_tls_protection);
@@ -879,6 +908,7 @@ ULONG metadata_size_sha256 = 0;
     tls_session -> nx_secure_tls_handshake_hash.nx_secure_tls_handshake_hash_scratch_size = max_handshake_hash_scratch_size;
     offset += max_handshake_hash_scratch_size;
 
+#ifndef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
     /* Client and server session cipher metadata. */
     tls_session -> nx_secure_session_cipher_metadata_size = max_session_cipher_metadata_size;
 
@@ -887,10 +917,22 @@ ULONG metadata_size_sha256 = 0;
 
     tls_session -> nx_secure_session_cipher_metadata_area_server = &metadata_area[offset];
     offset += max_session_cipher_metadata_size;
+#endif /* NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA */
 
     /* Public cipher metadata. */
     tls_session -> nx_secure_public_cipher_metadata_area = &metadata_area[offset];
     tls_session -> nx_secure_public_cipher_metadata_size = max_public_cipher_metadata_size;
+
+#ifdef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+    /* Client and server session cipher metadata, then TLS PRF metadata, in the public cipher metadata. */
+    tls_session -> nx_secure_session_cipher_metadata_size = max_session_cipher_metadata_size;
+
+    tls_session -> nx_secure_session_cipher_metadata_area_client = &metadata_area[offset];
+    tls_session -> nx_secure_session_cipher_metadata_area_server = &metadata_area[offset + max_session_cipher_metadata_size];
+
+    tls_session -> nx_secure_tls_prf_metadata_area = &metadata_area[offset + (2 * max_session_cipher_metadata_size)];
+    tls_session -> nx_secure_tls_prf_metadata_size = max_tls_prf_metadata_size;
+#endif /* NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA */
     offset += max_public_cipher_metadata_size;
 
     /* Public authentication metadata. For now it shares space with the public cipher. */
@@ -902,10 +944,12 @@ ULONG metadata_size_sha256 = 0;
     tls_session -> nx_secure_hash_mac_metadata_size = max_hash_mac_metadata_size;
     offset += max_hash_mac_metadata_size;
 
+#ifndef NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
     /* TLS PRF metadata. */
     tls_session -> nx_secure_tls_prf_metadata_area = &metadata_area[offset];
     tls_session -> nx_secure_tls_prf_metadata_size = max_tls_prf_metadata_size;
     offset += max_tls_prf_metadata_size;
+#endif /* NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA */
 
     /* Place the new TLS control block on the list of created TLS. */
     if (_nx_secure_tls_created_ptr)
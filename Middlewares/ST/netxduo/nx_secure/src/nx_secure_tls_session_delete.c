@@ -50,6 +50,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_secure_tls_session_reset          Clear TLS control block       */
+/*    tx_byte_release                       Release arena block           */
 /*    tx_mutex_get                          Get protection mutex          */
 /*    tx_mutex_put                          Put protection mutex          */
 /*                                                                        */
@@ -57,6 +58,7 @@
 /*                                                                        */
 /*    Application Code                                                    */
 /*    _nx_secure_dtls_session_delete        Delete the DTLS session       */
+/*    _nx_secure_tls_session_arena_create   Create session from arena     */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -123,6 +125,21 @@ UINT status;
     /* Delete the mutex used for TLS session while transmitting packets. */
     tx_mutex_delete(&(tls_session -> nx_secure_tls_session_transmit_mutex));
 
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+    /* Return the metadata and packet buffer of a session created from an arena. */
+    if (tls_session -> nx_secure_tls_arena_block != NX_NULL)
+    {
+        tx_byte_release(tls_session -> nx_secure_tls_arena_block);
+        tls_session -> nx_secure_tls_arena_block = NX_NULL;
+    }
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+    /* Clear out the master secret of the session offered for resumption. */
+    NX_SECURE_MEMSET(&tls_session -> nx_secure_tls_session_resumption, 0, sizeof(NX_SECURE_TLS_SESSION_RESUMPTION));
+    tls_session -> nx_secure_tls_session_resumed = NX_FALSE;
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
     /* Release the protection. */
     tx_mutex_put(&_nx_secure_tls_protection);
 
@@ -124,7 +124,7 @@ NX_PACKET *tmp_ptr;
         tx_mutex_put(&_nx_secure_tls_protection);
 
         /* Allocate a packet for our close-notify alert. */
-        status = _nx_secure_tls_packet_allocate(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+        status = _nx_secure_tls_packet_allocate(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
         /* Check for errors in allocating packet. */
         if (status != NX_SUCCESS)
@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_tls.h"
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_tls_session_handshake_step               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function performs one step of a TLS handshake started with     */
+/*    nx_secure_tls_session_start and NX_NO_WAIT, for an application that */
+/*    drives the handshake from its own event loop instead of a blocking  */
+/*    call. Each step processes at most one TLS record, including the     */
+/*    public key operations of that record, and never suspends.           */
+/*                                                                        */
+/*    It returns NX_SUCCESS once the handshake is complete,               */
+/*    NX_IN_PROGRESS if more records are already queued and the           */
+/*    application should step again after servicing its other events, and */
+/*    NX_CONTINUE if the next step must wait for data from the network.   */
+/*    Any other status is an error and the session must be ended.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_false_start_check      Check for TLS False Start     */
+/*    _nx_secure_tls_session_receive_records                              */
+/*                                          Receive TLS records           */
+/*    nx_secure_tls_packet_release          Release packet                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_session_handshake_step(NX_SECURE_TLS_SESSION *tls_session)
+{
+UINT       status = NX_SECURE_TLS_INVALID_STATE;
+NX_PACKET *incoming_packet = NX_NULL;
+UINT       finished = NX_FALSE;
+
+#ifndef NX_SECURE_TLS_CLIENT_DISABLED
+    if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT)
+    {
+        if (tls_session -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED)
+        {
+            return(NX_SUCCESS);
+        }
+
+        /* Process one record, this never suspends. */
+        status = _nx_secure_tls_session_receive_records(tls_session, &incoming_packet, NX_NO_WAIT);
+
+        finished = (tls_session -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED);
+
+#if defined(NX_SECURE_TLS_ENABLE_FALSE_START)
+        /* Let the application send data with our Finished message, as _nx_secure_tls_handshake_process does. */
+        if ((status == NX_SUCCESS) && _nx_secure_tls_false_start_check(tls_session))
+        {
+            return(NX_SUCCESS);
+        }
+#endif /* NX_SECURE_TLS_ENABLE_FALSE_START */
+    }
+#endif
+
+#ifndef NX_SECURE_TLS_SERVER_DISABLED
+    if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_SERVER)
+    {
+        if (tls_session -> nx_secure_tls_server_state == NX_SECURE_TLS_SERVER_STATE_HANDSHAKE_FINISHED)
+        {
+            return(NX_SUCCESS);
+        }
+
+        /* Process one record, this never suspends. */
+        status = _nx_secure_tls_session_receive_records(tls_session, &incoming_packet, NX_NO_WAIT);
+
+        finished = (tls_session -> nx_secure_tls_server_state == NX_SECURE_TLS_SERVER_STATE_HANDSHAKE_FINISHED);
+    }
+#endif
+
+    if (status == NX_NO_PACKET)
+    {
+
+        /* Nothing received yet, wait for the network. */
+        return(NX_CONTINUE);
+    }
+
+    if (status != NX_SUCCESS)
+    {
+        return(status);
+    }
+
+    if (finished)
+    {
+
+        /* Release the incoming packet if we do receive it. */
+        nx_secure_tls_packet_release(incoming_packet);
+
+        return(NX_SUCCESS);
+    }
+
+    /* More records of this flight may already be queued, by TLS or by TCP. Return so that the
+       application can service its other events before the next, possibly long, record is processed. */
+    if ((tls_session -> nx_secure_record_queue_header != NX_NULL) ||
+        (tls_session -> nx_secure_tls_tcp_socket -> nx_tcp_socket_receive_queue_count > 0))
+    {
+        return(NX_IN_PROGRESS);
+    }
+
+    return(NX_CONTINUE);
+}
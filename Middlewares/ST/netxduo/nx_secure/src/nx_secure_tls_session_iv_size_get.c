@@ -136,6 +136,10 @@ UINT                                  algorithm;
                 *iv_size = 8;
             }
             break;
+        case NX_CRYPTO_ENCRYPTION_CHACHA20_POLY1305:
+            /* The nonce is derived from the sequence number, nothing precedes the data (RFC 7905). */
+            *iv_size = 0;
+            break;
 #endif /* NX_SECURE_ENABLE_AEAD_CIPHER */
         default:
             /* Default, do nothing - only allocate space for ciphers that need it. */
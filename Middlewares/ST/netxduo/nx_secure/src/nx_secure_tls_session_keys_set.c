@@ -157,6 +157,11 @@ const NX_CRYPTO_METHOD               *session_cipher_method = NX_NULL;
     if (hash_size > 0)
     {
 
+        /* The MAC metadata persists across records and may hold states derived from the previous
+           MAC secrets, or the data of a certificate hash that shared the area during the handshake.
+           Clear it so the hash method starts over with the new secrets. */
+        NX_SECURE_MEMSET(tls_session -> nx_secure_hash_mac_metadata_area, 0, tls_session -> nx_secure_hash_mac_metadata_size);
+
         /* Copy new client mac secret over if setting client keys. */
         if (is_client)
         {
@@ -108,6 +108,28 @@ UINT local_initiated_renegotiation = NX_FALSE;
 #endif
 #endif /* NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION */
 
+#if defined(NX_SECURE_TLS_ENABLE_FALSE_START) && !defined(NX_SECURE_TLS_CLIENT_DISABLED)
+    /* A false started handshake still waits for the server ChangeCipherSpec and Finished,
+       which come before any application data. */
+    if (tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT &&
+        tls_session -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_SERVERHELLO_DONE)
+    {
+        status = _nx_secure_tls_handshake_process(tls_session, wait_option);
+
+        if (status == NX_CONTINUE)
+        {
+
+            /* Non blocking mode, nothing received yet. */
+            return(NX_NO_PACKET);
+        }
+
+        if (status != NX_SUCCESS)
+        {
+            return(status);
+        }
+    }
+#endif /* NX_SECURE_TLS_ENABLE_FALSE_START && !NX_SECURE_TLS_CLIENT_DISABLED */
+
     /* Try receiving records from the remote host. */
     status = _nx_secure_tls_session_receive_records(tls_session, packet_ptr_ptr, wait_option);
 
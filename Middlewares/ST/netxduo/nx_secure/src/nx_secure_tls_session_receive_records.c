@@ -59,7 +59,7 @@
 /*    _nx_secure_tls_send_alert             Send TLS alert                */
 /*    _nx_secure_tls_send_record            Send the TLS record           */
 /*    nx_secure_tls_packet_release          Release packet                */
-/*    nx_tcp_socket_receive                 Receive TCP data              */
+/*    nx_tcp_socket_receive_chain           Receive TCP data              */
 /*    tx_mutex_get                          Get protection mutex          */
 /*    tx_mutex_put                          Put protection mutex          */
 /*                                                                        */
@@ -127,8 +127,9 @@ UCHAR          handshake_finished = NX_FALSE;
         /* Release the protection before suspending on nx_tcp_socket_receive. */
         tx_mutex_put(&_nx_secure_tls_protection);
 
-        /* Receive a packet over the TCP connection. */
-        status =  nx_tcp_socket_receive(tcp_socket, &packet_ptr, wait_option);
+        /* Receive all the packets available over the TCP connection as one chain,
+           so a record spanning several segments is queued in a single pass. */
+        status =  nx_tcp_socket_receive_chain(tcp_socket, &packet_ptr, wait_option);
 
 
         if (status != NX_SUCCESS)
@@ -149,51 +150,56 @@ UCHAR          handshake_finished = NX_FALSE;
     if (status == NX_SUCCESS || status == NX_SECURE_TLS_POST_HANDSHAKE_RECEIVED)
     {
 
-        /* Remove processed packets. Data in released packet will be cleared by nx_secure_tls_packet_release. */
-        tls_session -> nx_secure_record_queue_header -> nx_packet_length -= bytes_processed;
-        current_packet = tls_session -> nx_secure_record_queue_header;
-        previous_packet = NX_NULL;
-        while (current_packet)
+        /* A record decrypted in place takes the last packet of the queue with it, so the queue may be empty. */
+        if (tls_session -> nx_secure_record_queue_header)
         {
-            packet_fragment_length = (ULONG)(current_packet -> nx_packet_append_ptr) - (ULONG)(current_packet -> nx_packet_prepend_ptr);
 
-            /* Determine if all data in the current fragment have been processed. */
-            if (packet_fragment_length <= bytes_processed)
+            /* Remove processed packets. Data in released packet will be cleared by nx_secure_tls_packet_release. */
+            tls_session -> nx_secure_record_queue_header -> nx_packet_length -= bytes_processed;
+            current_packet = tls_session -> nx_secure_record_queue_header;
+            previous_packet = NX_NULL;
+            while (current_packet)
             {
-                bytes_processed -= packet_fragment_length;
+                packet_fragment_length = (ULONG)(current_packet -> nx_packet_append_ptr) - (ULONG)(current_packet -> nx_packet_prepend_ptr);
+
+                /* Determine if all data in the current fragment have been processed. */
+                if (packet_fragment_length <= bytes_processed)
+                {
+                    bytes_processed -= packet_fragment_length;
+                }
+                else
+                {
+                    current_packet -> nx_packet_prepend_ptr += bytes_processed;
+                    bytes_processed = 0;
+                    break;
+                }
+                previous_packet = current_packet;
+                current_packet = current_packet -> nx_packet_next;
             }
-            else
+
+            if (!current_packet)
             {
-                current_packet -> nx_packet_prepend_ptr += bytes_processed;
-                bytes_processed = 0;
-                break;
+                nx_secure_tls_packet_release(tls_session -> nx_secure_record_queue_header);
+                tls_session -> nx_secure_record_queue_header = NX_NULL;
             }
-            previous_packet = current_packet;
-            current_packet = current_packet -> nx_packet_next;
-        }
-
-        if (!current_packet)
-        {
-            nx_secure_tls_packet_release(tls_session -> nx_secure_record_queue_header);
-            tls_session -> nx_secure_record_queue_header = NX_NULL;
-        }
-        else if (previous_packet)
-        {
+            else if (previous_packet)
+            {
 
-            /* Release trimmed packets. */
-            /* Packets from tls_session -> nx_secure_record_queue_header till previous_packet can be trimmed. */
-            previous_packet -> nx_packet_next = NX_NULL;
+                /* Release trimmed packets. */
+                /* Packets from tls_session -> nx_secure_record_queue_header till previous_packet can be trimmed. */
+                previous_packet -> nx_packet_next = NX_NULL;
 
-            /* Update the length and last packet of remaining packets. */
-            current_packet -> nx_packet_length = tls_session -> nx_secure_record_queue_header -> nx_packet_length;
-            current_packet -> nx_packet_last = tls_session -> nx_secure_record_queue_header -> nx_packet_last;
+                /* Update the length and last packet of remaining packets. */
+                current_packet -> nx_packet_length = tls_session -> nx_secure_record_queue_header -> nx_packet_length;
+                current_packet -> nx_packet_last = tls_session -> nx_secure_record_queue_header -> nx_packet_last;
 
-            /* Correct the last packet to be trimmed. */
-            tls_session -> nx_secure_record_queue_header -> nx_packet_last = previous_packet;
-            nx_secure_tls_packet_release(tls_session -> nx_secure_record_queue_header);
+                /* Correct the last packet to be trimmed. */
+                tls_session -> nx_secure_record_queue_header -> nx_packet_last = previous_packet;
+                nx_secure_tls_packet_release(tls_session -> nx_secure_record_queue_header);
 
-            /* Update the remaining packets. */
-            tls_session -> nx_secure_record_queue_header = current_packet;
+                /* Update the remaining packets. */
+                tls_session -> nx_secure_record_queue_header = current_packet;
+            }
         }
 
         if (bytes_processed)
@@ -263,7 +269,7 @@ UCHAR          handshake_finished = NX_FALSE;
             /* Release the protection before suspending on nx_packet_allocate. */
             tx_mutex_put(&_nx_secure_tls_protection);
 
-            status = _nx_secure_tls_packet_allocate(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+            status = _nx_secure_tls_packet_allocate(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
             /* Get the protection after nx_packet_allocate. */
             tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
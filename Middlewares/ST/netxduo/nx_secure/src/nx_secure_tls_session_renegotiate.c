@@ -139,7 +139,7 @@ NX_PACKET *send_packet;
     {
 
         /* Allocate a handshake packet so we can send the ClientHello. */
-        status = _nx_secure_tls_allocate_handshake_packet(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+        status = _nx_secure_tls_allocate_handshake_packet(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
         if (status != NX_SUCCESS)
         {
@@ -218,7 +218,7 @@ NX_PACKET *send_packet;
 
         /* The session is active, so send a HelloRequest to re-establish the connection. */
         /* Allocate a handshake packet so we can send the HelloRequest message. */
-        status = _nx_secure_tls_allocate_handshake_packet(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+        status = _nx_secure_tls_allocate_handshake_packet(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
         if (status != NX_SUCCESS)
         {
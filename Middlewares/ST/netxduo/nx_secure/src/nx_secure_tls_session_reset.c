@@ -122,6 +122,18 @@ UINT temp_status;
         }
     }
 
+    /* The MAC metadata persists across records, clean it up with the session. */
+    if ((session_ptr -> nx_secure_tls_local_session_active || session_ptr -> nx_secure_tls_remote_session_active) &&
+        (session_ptr -> nx_secure_tls_session_ciphersuite != NX_NULL) &&
+        (session_ptr -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_hash -> nx_crypto_cleanup))
+    {
+        temp_status = session_ptr -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_hash -> nx_crypto_cleanup(session_ptr -> nx_secure_hash_mac_metadata_area);
+        if(temp_status != NX_CRYPTO_SUCCESS)
+        {
+            status = temp_status;
+        }
+    }
+
     /* Reset socket type. */
     session_ptr -> nx_secure_tls_socket_type = NX_SECURE_TLS_SESSION_TYPE_NONE;
 
@@ -155,8 +167,10 @@ UINT temp_status;
     /* Clear out all remote certificates. */
     status = _nx_secure_tls_remote_certificate_free_all(session_ptr);
 
+#ifndef NX_SECURE_DISABLE_X509
     /* Clear out the active certificate so if the session is reused it will return to the default (local cert). */
     session_ptr -> nx_secure_tls_credentials.nx_secure_tls_active_certificate = NX_NULL;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 
 #ifndef NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_secure_tls.h"
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_session_resumption_get               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reads the session of the last full TLS 1.2 handshake  */
+/*    of a client, to resume it in a later connection with                */
+/*    nx_secure_tls_session_resumption_set: its session ID, master        */
+/*    secret, protocol version and ciphersuite. A resumed session reads   */
+/*    back as it was offered. The master secret is a key of the session,  */
+/*    and must be kept as such.                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS session control block     */
+/*    resumption_ptr                        Session read                  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_session_resumption_get(NX_SECURE_TLS_SESSION *tls_session,
+                                           NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr)
+{
+UINT status = NX_NOT_FOUND;
+
+    /* Get the protection. */
+    tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+    /* Only an established TLS 1.2 client session the server gave an ID to can be resumed. */
+    if ((tls_session -> nx_secure_tls_socket_type == NX_SECURE_TLS_SESSION_TYPE_CLIENT) &&
+        (tls_session -> nx_secure_tls_client_state == NX_SECURE_TLS_CLIENT_STATE_HANDSHAKE_FINISHED) &&
+        (tls_session -> nx_secure_tls_local_session_active) &&
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+        (!tls_session -> nx_secure_tls_1_3) &&
+#endif
+        (tls_session -> nx_secure_tls_protocol_version == NX_SECURE_TLS_VERSION_TLS_1_2) &&
+        (tls_session -> nx_secure_tls_session_ciphersuite != NX_NULL) &&
+        (tls_session -> nx_secure_tls_session_id_length > 0) &&
+        (tls_session -> nx_secure_tls_session_id_length <= NX_SECURE_TLS_RESUMPTION_SESSION_ID_SIZE))
+    {
+        resumption_ptr -> nx_secure_tls_resumption_protocol_version = tls_session -> nx_secure_tls_protocol_version;
+        resumption_ptr -> nx_secure_tls_resumption_ciphersuite =
+            tls_session -> nx_secure_tls_session_ciphersuite -> nx_secure_tls_ciphersuite;
+        resumption_ptr -> nx_secure_tls_resumption_session_id_length = tls_session -> nx_secure_tls_session_id_length;
+        NX_SECURE_MEMCPY(resumption_ptr -> nx_secure_tls_resumption_session_id, tls_session -> nx_secure_tls_session_id,
+                         tls_session -> nx_secure_tls_session_id_length); /* Use case of memcpy is verified. */
+        NX_SECURE_MEMCPY(resumption_ptr -> nx_secure_tls_resumption_master_secret,
+                         tls_session -> nx_secure_tls_key_material.nx_secure_tls_master_secret,
+                         NX_SECURE_TLS_MASTER_SIZE); /* Use case of memcpy is verified. */
+        status = NX_SUCCESS;
+    }
+
+    /* Release the protection. */
+    tx_mutex_put(&_nx_secure_tls_protection);
+
+    return(status);
+}
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_secure_tls.h"
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_session_resumption_set               PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the session the TLS client offers to resume in   */
+/*    the ClientHello of its next initial handshakes, as read from an     */
+/*    earlier connection with nx_secure_tls_session_resumption_get. A     */
+/*    server that still knows it answers with its ChangeCipherSpec and    */
+/*    Finished right after the ServerHello: the session keys come from    */
+/*    the master secret, without certificate, verification or key         */
+/*    exchange. A server that does not goes on with a full handshake. The */
+/*    session offered is kept across session resets, a NX_NULL pointer    */
+/*    removes it.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS session control block     */
+/*    resumption_ptr                        Session to offer, or NX_NULL  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Put protection mutex          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_tls_session_resumption_set(NX_SECURE_TLS_SESSION *tls_session,
+                                           const NX_SECURE_TLS_SESSION_RESUMPTION *resumption_ptr)
+{
+
+    /* Get the protection. */
+    tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+    if (resumption_ptr != NX_NULL)
+    {
+        /* Offer this session from the next ClientHello on. */
+        tls_session -> nx_secure_tls_session_resumption = *resumption_ptr;
+    }
+    else
+    {
+        /* Offer nothing, and clear the master secret of the session offered so far. */
+        NX_SECURE_MEMSET(&(tls_session -> nx_secure_tls_session_resumption), 0, sizeof(NX_SECURE_TLS_SESSION_RESUMPTION));
+    }
+
+    /* Release the protection. */
+    tx_mutex_put(&_nx_secure_tls_protection);
+
+    return(NX_SUCCESS);
+}
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
@@ -24,6 +24,10 @@
 
 #include "nx_secure_tls.h"
 
+#ifdef NX_SECURE_TLS_SEGMENT_SIZED_RECORDS
+static ULONG _nx_secure_tls_session_record_length(NX_SECURE_TLS_SESSION *tls_session, ULONG packet_space);
+#endif /* NX_SECURE_TLS_SEGMENT_SIZED_RECORDS */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -40,6 +44,15 @@
 /*    all encryption and hashing before sending data over the established */
 /*    TCP socket connection.                    .                         */
 /*                                                                        */
+/*    With NX_SECURE_TLS_SEGMENT_SIZED_RECORDS defined, data longer than  */
+/*    one TCP segment of the connection is split into records that each   */
+/*    fill one segment, so that the remote host decrypts every record as  */
+/*    soon as its segment arrives.                                        */
+/*                                                                        */
+/*    With NX_ENABLE_TCP_SEND_ASYNC defined and a send notify set on the  */
+/*    TCP socket, NX_IN_PROGRESS is returned when the records are queued  */
+/*    on the socket instead of sent. The packet is consumed as on success.*/
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    tls_session                           TLS control block             */
@@ -53,7 +66,13 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _nx_secure_tls_packet_allocate        Allocate internal TLS packet  */
 /*    _nx_secure_tls_send_record            Send TLS encrypted record     */
+/*    _nx_secure_tls_session_record_length  Get the record length of one  */
+/*                                            TCP segment                 */
+/*    _nx_secure_tls_session_reset          Clear out the session         */
+/*    nx_packet_data_extract_offset         Copy data of a packet         */
+/*    nx_packet_release                     Release packet                */
 /*    tx_mutex_get                          Get protection mutex          */
 /*    tx_mutex_put                          Put protection mutex          */
 /*                                                                        */
@@ -73,19 +92,113 @@
 UINT _nx_secure_tls_session_send(NX_SECURE_TLS_SESSION *tls_session, NX_PACKET *packet_ptr,
                                  ULONG wait_option)
 {
-UINT status;
+UINT       status;
+#ifdef NX_SECURE_TLS_SEGMENT_SIZED_RECORDS
+NX_PACKET *record_packet;
+ULONG      record_length;
+ULONG      packet_space;
+ULONG      offset;
+ULONG      bytes_copied;
+#endif /* NX_SECURE_TLS_SEGMENT_SIZED_RECORDS */
 
 
     /* Get the protection. */
     tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
 
-    status = _nx_secure_tls_send_record(tls_session, packet_ptr, NX_SECURE_TLS_APPLICATION_DATA, wait_option);
+#ifdef NX_SECURE_TLS_SEGMENT_SIZED_RECORDS
+    /* Data longer than a segment goes out in records of one segment each, copied from the packet
+       into packets of the session pool. */
+    record_length = 0;
+    if (tls_session -> nx_secure_tls_local_session_active && (tls_session -> nx_secure_tls_tcp_socket != NX_NULL) &&
+        (tls_session -> nx_secure_tls_packet_pool != NX_NULL))
+    {
+        /* The packets of the records are allocated with the TCP/IP headroom of the connection. */
+        if (tls_session -> nx_secure_tls_tcp_socket -> nx_tcp_socket_connect_ip.nxd_ip_version == NX_IP_VERSION_V4)
+        {
+            packet_space = NX_IPv4_TCP_PACKET;
+        }
+        else
+        {
+            packet_space = NX_IPv6_TCP_PACKET;
+        }
+
+        if (tls_session -> nx_secure_tls_packet_pool -> nx_packet_pool_payload_size > packet_space)
+        {
+            packet_space = tls_session -> nx_secure_tls_packet_pool -> nx_packet_pool_payload_size - packet_space;
+            record_length = _nx_secure_tls_session_record_length(tls_session, packet_space);
+        }
+    }
+
+    if ((record_length != 0) && (packet_ptr -> nx_packet_length > record_length))
+    {
+        status = NX_SUCCESS;
+        for (offset = 0; (status == NX_SUCCESS) && (offset < packet_ptr -> nx_packet_length); offset += record_length)
+        {
+
+            /* Release the protection before suspending on the packet allocation. */
+            tx_mutex_put(&_nx_secure_tls_protection);
+
+            status = _nx_secure_tls_packet_allocate(tls_session, tls_session -> nx_secure_tls_packet_pool,
+                                                    &record_packet, wait_option);
+
+            tx_mutex_get(&_nx_secure_tls_protection, TX_WAIT_FOREVER);
+
+            if (status != NX_SUCCESS)
+            {
+                break;
+            }
+
+            /* The record length left room for the headroom of the packet. */
+            if (record_length > (ULONG)(record_packet -> nx_packet_data_end - record_packet -> nx_packet_prepend_ptr))
+            {
+                nx_packet_release(record_packet);
+                status = NX_SECURE_TLS_PACKET_BUFFER_TOO_SMALL;
+                break;
+            }
+
+            status = nx_packet_data_extract_offset(packet_ptr, offset, record_packet -> nx_packet_prepend_ptr,
+                                                   record_length, &bytes_copied);
+
+            if (status == NX_SUCCESS)
+            {
+                record_packet -> nx_packet_append_ptr = record_packet -> nx_packet_prepend_ptr + bytes_copied;
+                record_packet -> nx_packet_length = bytes_copied;
+
+                status = _nx_secure_tls_send_record(tls_session, record_packet, NX_SECURE_TLS_APPLICATION_DATA, wait_option);
+            }
+
+            if (status != NX_SUCCESS)
+            {
+                nx_packet_release(record_packet);
+            }
+        }
+
+        if (status == NX_SUCCESS)
+        {
+
+            /* Every record is sent, the packet of the caller is consumed. */
+            nx_packet_release(packet_ptr);
+        }
+    }
+    else
+#endif /* NX_SECURE_TLS_SEGMENT_SIZED_RECORDS */
+    {
+        status = _nx_secure_tls_send_record(tls_session, packet_ptr, NX_SECURE_TLS_APPLICATION_DATA, wait_option);
+    }
 
     if(status != NX_SUCCESS)
     {
         /* Make sure we clear keys on errors. */
         _nx_secure_tls_session_reset(tls_session);
     }
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    else if ((tls_session -> nx_secure_tls_tcp_socket != NX_NULL) &&
+             (tls_session -> nx_secure_tls_tcp_socket -> nx_tcp_socket_send_pending_head != NX_NULL))
+    {
+        /* The records are queued on the socket, its send notify tells when they are sent. */
+        status = NX_IN_PROGRESS;
+    }
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
 
     /* Release the protection. */
     tx_mutex_put(&_nx_secure_tls_protection);
@@ -93,3 +206,119 @@ UINT status;
     return(status);
 }
 
+#ifdef NX_SECURE_TLS_SEGMENT_SIZED_RECORDS
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_tls_session_record_length                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the largest plaintext whose protected record, */
+/*    header included, fits in one TCP segment of the connection, and     */
+/*    whose ciphertext fits in a packet allocated for it. The expansion   */
+/*    of the session cipher is taken into account: the explicit IV, the   */
+/*    MAC and the padding of CBC, the tag of AEAD and the inner content   */
+/*    type of TLS 1.3. The record size limit negotiated with the remote   */
+/*    host bounds the length too.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tls_session                           TLS control block             */
+/*    packet_space                          Payload of a record packet    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    length                                Plaintext length, 0 if none   */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_session_iv_size_get    Get IV size for this session  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_tls_session_send           Sends data using TLS session  */
+/*                                                                        */
+/**************************************************************************/
+static ULONG _nx_secure_tls_session_record_length(NX_SECURE_TLS_SESSION *tls_session, ULONG packet_space)
+{
+const NX_SECURE_TLS_CIPHERSUITE_INFO *ciphersuite = tls_session -> nx_secure_tls_session_ciphersuite;
+const NX_CRYPTO_METHOD               *session_cipher_method;
+ULONG                                 segment_space;
+ULONG                                 trailer_size = 0;
+ULONG                                 block_size = 0;
+ULONG                                 length;
+USHORT                                iv_size;
+
+    if ((ciphersuite == NX_NULL) ||
+        (_nx_secure_tls_session_iv_size_get(tls_session, &iv_size) != NX_SUCCESS))
+    {
+        return(0);
+    }
+    session_cipher_method = ciphersuite -> nx_secure_tls_session_cipher;
+
+    /* Bytes of a segment after the record header and the IV. */
+    segment_space = tls_session -> nx_secure_tls_tcp_socket -> nx_tcp_socket_connect_mss;
+    if (segment_space <= (ULONG)(NX_SECURE_TLS_RECORD_HEADER_SIZE + iv_size))
+    {
+        return(0);
+    }
+    segment_space -= (ULONG)(NX_SECURE_TLS_RECORD_HEADER_SIZE + iv_size);
+
+    /* The pool payload holds the record header and the IV before the data. */
+    if (packet_space <= (ULONG)(NX_SECURE_TLS_RECORD_HEADER_SIZE + iv_size))
+    {
+        return(0);
+    }
+    packet_space -= (ULONG)(NX_SECURE_TLS_RECORD_HEADER_SIZE + iv_size);
+    if (packet_space < segment_space)
+    {
+        segment_space = packet_space;
+    }
+
+    /* What the protection adds after the data, the same way as _nx_secure_tls_send_record. */
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+    if (tls_session -> nx_secure_tls_1_3)
+    {
+        trailer_size += 1;
+    }
+    else
+#endif
+    if (ciphersuite -> nx_secure_tls_hash -> nx_crypto_operation)
+    {
+        trailer_size += ciphersuite -> nx_secure_tls_hash_size;
+    }
+    trailer_size += (ULONG)(session_cipher_method -> nx_crypto_ICV_size_in_bits >> 3);
+    if (session_cipher_method -> nx_crypto_algorithm == NX_CRYPTO_ENCRYPTION_AES_CBC)
+    {
+
+        /* The data, the MAC and the padding length byte are padded to whole blocks. */
+        block_size = session_cipher_method -> nx_crypto_block_size_in_bytes;
+        trailer_size += 1;
+    }
+
+    if (block_size > 1)
+    {
+        segment_space -= segment_space % block_size;
+    }
+
+    if (segment_space <= trailer_size)
+    {
+        return(0);
+    }
+    length = segment_space - trailer_size;
+
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+    /* _nx_secure_tls_send_record refuses the records over the limit of the remote host. */
+    if (tls_session -> nx_secure_tls_send_record_size_limit &&
+        (length > tls_session -> nx_secure_tls_send_record_size_limit))
+    {
+        length = tls_session -> nx_secure_tls_send_record_size_limit;
+    }
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
+    return(length);
+}
+#endif /* NX_SECURE_TLS_SEGMENT_SIZED_RECORDS */
+
@@ -106,6 +106,12 @@ NX_PACKET *send_packet;
     tls_session -> nx_secure_tls_remote_session_active = 0;
     tls_session -> nx_secure_tls_received_remote_credentials = NX_FALSE;
 
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+    /* No record size limit until the hello extensions negotiate one. */
+    tls_session -> nx_secure_tls_send_record_size_limit = 0;
+    tls_session -> nx_secure_tls_receive_record_size_limit = 0;
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
     /* Reset alert tracking. */
     tls_session -> nx_secure_tls_received_alert_level = 0;
     tls_session -> nx_secure_tls_received_alert_value = 0;
@@ -145,7 +151,7 @@ NX_PACKET *send_packet;
     {
 
         /* Allocate a handshake packet so we can send the ClientHello. */
-        status = _nx_secure_tls_allocate_handshake_packet(tls_session, tls_session -> nx_secure_tls_packet_pool, &send_packet, wait_option);
+        status = _nx_secure_tls_allocate_handshake_packet(tls_session, NX_SECURE_TLS_CONTROL_PACKET_POOL(tls_session), &send_packet, wait_option);
 
         if (status != NX_SUCCESS)
         {
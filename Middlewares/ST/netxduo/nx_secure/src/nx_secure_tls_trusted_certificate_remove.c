@@ -76,6 +76,7 @@
 UINT _nx_secure_tls_trusted_certificate_remove(NX_SECURE_TLS_SESSION *tls_session,
                                                UCHAR *common_name, UINT common_name_length)
 {
+#ifndef NX_SECURE_DISABLE_X509
 UINT                              status;
 NX_SECURE_X509_DISTINGUISHED_NAME name;
 
@@ -102,5 +103,12 @@ NX_SECURE_X509_DISTINGUISHED_NAME name;
     }
 
     return(status);
+#else
+    NX_PARAMETER_NOT_USED(tls_session);
+    NX_PARAMETER_NOT_USED(common_name);
+    NX_PARAMETER_NOT_USED(common_name_length);
+
+    return(NX_NOT_SUPPORTED);
+#endif /* NX_SECURE_DISABLE_X509 */
 }
 
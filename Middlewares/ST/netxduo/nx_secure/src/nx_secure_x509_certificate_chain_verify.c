@@ -24,6 +24,18 @@
 
 #include "nx_secure_x509.h"
 
+#if (NX_SECURE_X509_VERIFY_CACHE_SIZE > 0)
+#define NX_SECURE_X509_FINGERPRINT_SIZE                 32
+
+/* Fingerprints of the last certificates verified against their issuer, most recently used first. */
+static UCHAR _nx_secure_x509_verify_cache[NX_SECURE_X509_VERIFY_CACHE_SIZE][NX_SECURE_X509_FINGERPRINT_SIZE];
+static UINT  _nx_secure_x509_verify_cache_count;
+
+static UINT _nx_secure_x509_certificate_fingerprint(NX_SECURE_X509_CERT *certificate,
+                                                    NX_SECURE_X509_CERT *issuer_certificate,
+                                                    UCHAR *fingerprint);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -52,6 +64,8 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _nx_secure_x509_certificate_verify    Verify a certificate          */
+/*    _nx_secure_x509_certificate_verify_cached                           */
+/*                                          Verify a certificate once     */
 /*    _nx_secure_x509_store_certificate_find                              */
 /*                                          Find a cert in a store        */
 /*    _nx_secure_x509_distinguished_name_compare                          */
@@ -135,7 +149,11 @@ INT                  compare_result;
         }
 
         /* Verify the current certificate against its issuer certificate. */
+#if (NX_SECURE_X509_VERIFY_CACHE_SIZE > 0)
+        status = _nx_secure_x509_certificate_verify_cached(store, current_certificate, issuer_certificate);
+#else
         status = _nx_secure_x509_certificate_verify(store, current_certificate, issuer_certificate);
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
 
         if (status != 0)
         {
@@ -176,3 +194,207 @@ INT                  compare_result;
     return(NX_SECURE_X509_CHAIN_VERIFY_FAILURE);
 }
 
+#if (NX_SECURE_X509_VERIFY_CACHE_SIZE > 0)
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_fingerprint             PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function computes the SHA-256 fingerprint of a certificate     */
+/*    together with its issuer certificate, over the DER of both. The     */
+/*    result of the signature check of the certificate only depends on    */
+/*    these bytes, so the fingerprint identifies it.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    certificate                           Pointer to certificate        */
+/*    issuer_certificate                    Pointer to issuer certificate */
+/*    fingerprint                           Pointer to fingerprint output */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    [nx_crypto_init]                      Initialize crypto             */
+/*    [nx_crypto_operation]                 Crypto operation              */
+/*    [nx_crypto_cleanup]                   Cleanup crypto                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_verify_cached                           */
+/*                                          Verify a certificate once     */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_secure_x509_certificate_fingerprint(NX_SECURE_X509_CERT *certificate,
+                                                    NX_SECURE_X509_CERT *issuer_certificate,
+                                                    UCHAR *fingerprint)
+{
+UINT                    status;
+UINT                    i;
+const NX_CRYPTO_METHOD *hash_method = NX_CRYPTO_NULL;
+VOID                   *handler = NX_CRYPTO_NULL;
+VOID                   *metadata = certificate -> nx_secure_x509_hash_metadata_area;
+ULONG                   metadata_size = certificate -> nx_secure_x509_hash_metadata_size;
+
+    /* Find SHA-256 among the hash methods of the certificate. */
+    for (i = 0; i < certificate -> nx_secure_x509_cipher_table_size; i++)
+    {
+        if (certificate -> nx_secure_x509_cipher_table[i].nx_secure_x509_hash_method -> nx_crypto_algorithm == NX_CRYPTO_HASH_SHA256)
+        {
+            hash_method = certificate -> nx_secure_x509_cipher_table[i].nx_secure_x509_hash_method;
+            break;
+        }
+    }
+
+    if ((hash_method == NX_CRYPTO_NULL) || (hash_method -> nx_crypto_operation == NX_CRYPTO_NULL))
+    {
+        return(NX_SECURE_X509_MISSING_CRYPTO_ROUTINE);
+    }
+
+    if (hash_method -> nx_crypto_init)
+    {
+        status = hash_method -> nx_crypto_init((NX_CRYPTO_METHOD*)hash_method, NX_CRYPTO_NULL, 0, &handler,
+                                               metadata, metadata_size);
+
+        if (status != NX_CRYPTO_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE, handler, (NX_CRYPTO_METHOD*)hash_method,
+                                                NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, handler, (NX_CRYPTO_METHOD*)hash_method,
+                                                    NX_CRYPTO_NULL, 0, certificate -> nx_secure_x509_certificate_raw_data,
+                                                    certificate -> nx_secure_x509_certificate_raw_data_length,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, handler, (NX_CRYPTO_METHOD*)hash_method,
+                                                    NX_CRYPTO_NULL, 0, issuer_certificate -> nx_secure_x509_certificate_raw_data,
+                                                    issuer_certificate -> nx_secure_x509_certificate_raw_data_length,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+        status = hash_method -> nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE, handler, (NX_CRYPTO_METHOD*)hash_method,
+                                                    NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                    fingerprint, NX_SECURE_X509_FINGERPRINT_SIZE, metadata, metadata_size,
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    }
+
+    if (hash_method -> nx_crypto_cleanup)
+    {
+        hash_method -> nx_crypto_cleanup(metadata);
+    }
+
+    return(status);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_verify_cached           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function verifies a certificate against its issuer             */
+/*    certificate, unless the fingerprint of both is among the last       */
+/*    NX_SECURE_X509_VERIFY_CACHE_SIZE ones that verified. A chain        */
+/*    presented again, by the same server on a reconnection, then skips   */
+/*    the public key operations. The cache is kept most recently used     */
+/*    first and is protected by the caller, as the TLS protection mutex   */
+/*    is held during the handshake.                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    store                                 Pointer to certificate store  */
+/*    certificate                           Pointer to certificate        */
+/*    issuer_certificate                    Pointer to issuer certificate */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_fingerprint                             */
+/*                                          Fingerprint a certificate     */
+/*    _nx_secure_x509_certificate_verify    Verify a certificate          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_chain_verify                            */
+/*                                          Verify a certificate chain    */
+/*    _nx_secure_tls_remote_certificate_link                              */
+/*                                          Verify chain certificate      */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_x509_certificate_verify_cached(NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                               NX_SECURE_X509_CERT *certificate,
+                                               NX_SECURE_X509_CERT *issuer_certificate)
+{
+UINT  status;
+UINT  i;
+UCHAR fingerprint[NX_SECURE_X509_FINGERPRINT_SIZE];
+
+    status = _nx_secure_x509_certificate_fingerprint(certificate, issuer_certificate, fingerprint);
+
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        /* No fingerprint without SHA-256, just check the signature. */
+        return(_nx_secure_x509_certificate_verify(store, certificate, issuer_certificate));
+    }
+
+    /* See if the certificate was already verified against this issuer. */
+    for (i = 0; i < _nx_secure_x509_verify_cache_count; i++)
+    {
+        if (NX_SECURE_MEMCMP(_nx_secure_x509_verify_cache[i], fingerprint, NX_SECURE_X509_FINGERPRINT_SIZE) == 0)
+        {
+            break;
+        }
+    }
+
+    if (i == _nx_secure_x509_verify_cache_count)
+    {
+
+        /* Not found, check the signature. */
+        status = _nx_secure_x509_certificate_verify(store, certificate, issuer_certificate);
+
+        if (status != NX_SECURE_X509_SUCCESS)
+        {
+            return(status);
+        }
+
+        /* Take a free entry, or the least recently used one when the cache is full. */
+        if (_nx_secure_x509_verify_cache_count < NX_SECURE_X509_VERIFY_CACHE_SIZE)
+        {
+            _nx_secure_x509_verify_cache_count++;
+        }
+        i = _nx_secure_x509_verify_cache_count - 1;
+    }
+
+    /* Move the fingerprint to the front. */
+    NX_SECURE_MEMMOVE(_nx_secure_x509_verify_cache[1], _nx_secure_x509_verify_cache[0], i * NX_SECURE_X509_FINGERPRINT_SIZE); /* Use case of memmove is verified. */
+    NX_SECURE_MEMCPY(_nx_secure_x509_verify_cache[0], fingerprint, NX_SECURE_X509_FINGERPRINT_SIZE); /* Use case of memcpy is verified. */
+
+    return(NX_SECURE_X509_SUCCESS);
+}
+#endif /* NX_SECURE_X509_VERIFY_CACHE_SIZE */
+
@@ -0,0 +1,321 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    X.509 Digital Certificates                                         */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_x509.h"
+
+#ifndef NX_SECURE_X509_DISABLE_CRL
+static VOID _nx_secure_x509_crl_index_sort(NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT count);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_hash                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function hashes the serial number of a certificate for a CRL   */
+/*    index, with 32-bit FNV-1a. The hash only orders the index, a serial */
+/*    number found under it is compared in full.                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    serial_number                         Serial number, ASN.1 integer  */
+/*    length                                Length of the serial number   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    hash                                  Hash of the serial number     */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_create      Create an index of a CRL      */
+/*    _nx_secure_x509_crl_index_revocation_check                          */
+/*                                          Check revocation in an index  */
+/*                                                                        */
+/**************************************************************************/
+ULONG _nx_secure_x509_crl_index_hash(const UCHAR *serial_number, UINT length)
+{
+ULONG hash = 0x811C9DC5;
+
+    while (length > 0)
+    {
+        hash = (hash ^ *serial_number) * 0x01000193;
+        serial_number++;
+        length--;
+    }
+
+    return(hash);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_create                    PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function parses a DER-encoded Certificate Revocation List once */
+/*    into an index, to check certificates against it without parsing it  */
+/*    again. The CRL is authenticated here as                             */
+/*    _nx_secure_x509_crl_revocation_check does: its issuer is found in   */
+/*    the certificate store, the chain of the issuer is verified and the  */
+/*    signature of the CRL is checked. The serial number of each revoked  */
+/*    certificate is then hashed into the entries given, which are sorted */
+/*    by hash, and set in the Bloom filter of the index when              */
+/*    NX_SECURE_X509_CRL_INDEX_BLOOM_BITS is not zero. The CRL data is    */
+/*    referenced by the index and must stay in place, in RAM or in flash, */
+/*    while the index is used. An index is created again for a new CRL or */
+/*    when the store changes.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crl_index                             Index to create               */
+/*    crl_data                              Pointer to DER-encoded CRL    */
+/*    crl_length                            Length of CRL data in buffer  */
+/*    store                                 Certificate store to be used  */
+/*    entries                               Entries of the index, one for */
+/*                                            each revoked certificate    */
+/*    entries_count                         Number of entries             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_certificate_chain_verify                            */
+/*                                          Verify cert against stores    */
+/*    _nx_secure_x509_certificate_revocation_list_parse                   */
+/*                                          Parse revocation list         */
+/*    _nx_secure_x509_crl_index_hash        Hash a serial number          */
+/*    _nx_secure_x509_crl_index_sort        Sort the entries of an index  */
+/*    _nx_secure_x509_crl_parse_entry       Parse an entry in crl         */
+/*    _nx_secure_x509_crl_verify            Verify revocation list        */
+/*    _nx_secure_x509_store_certificate_find                              */
+/*                                          Find a cert in a store        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_x509_crl_index_create(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                      const UCHAR *crl_data, UINT crl_length,
+                                      NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                      NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT entries_count)
+{
+NX_SECURE_X509_CRL  *crl = &crl_index -> nx_secure_x509_crl_index_crl;
+UINT                 status;
+UINT                 crl_bytes;
+UINT                 bytes_processed;
+ULONG                length;
+const UCHAR         *current_buffer;
+NX_SECURE_X509_CERT *issuer_certificate;
+UINT                 issuer_location;
+const UCHAR         *serial_number = NX_NULL;
+UINT                 serial_number_length;
+UINT                 count = 0;
+#if NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+ULONG                hash;
+ULONG                step;
+ULONG                bit;
+UINT                 i;
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+
+    /* Until it is complete, the index is invalid. */
+    NX_SECURE_MEMSET(crl_index, 0, sizeof(NX_SECURE_X509_CRL_INDEX));
+
+    status = _nx_secure_x509_certificate_revocation_list_parse(crl_data, crl_length, &crl_bytes, crl);
+
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Authenticate the CRL once, as _nx_secure_x509_crl_revocation_check does on every call. */
+    status = _nx_secure_x509_store_certificate_find(store, &crl -> nx_secure_x509_crl_issuer, 0, &issuer_certificate, &issuer_location);
+
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        return(status);
+    }
+
+    status = _nx_secure_x509_certificate_chain_verify(store, issuer_certificate);
+
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* The issuer provides the crypto methods and metadata of the signature check. */
+    status = _nx_secure_x509_crl_verify(issuer_certificate, crl, store, issuer_certificate);
+
+    if (status != NX_SECURE_X509_SUCCESS)
+    {
+        return(status);
+    }
+
+    /* Index every entry of the revokedCertificates list by the hash of its serial number,
+       with its offset in the list to compare the serial number in full. */
+    current_buffer = crl -> nx_secure_x509_crl_revoked_certs;
+    length = crl -> nx_secure_x509_crl_revoked_certs_length;
+    while (length > 0)
+    {
+        status = _nx_secure_x509_crl_parse_entry(current_buffer, length, &bytes_processed, &serial_number, &serial_number_length);
+
+        if (status != NX_SECURE_X509_SUCCESS)
+        {
+            return(status);
+        }
+
+        /* Make sure we don't run past the end of the sequence if one of the entries was too big. */
+        if (length < bytes_processed)
+        {
+            return(NX_SECURE_X509_ASN1_LENGTH_TOO_LONG);
+        }
+
+        if (count == entries_count)
+        {
+            return(NX_SECURE_X509_CRL_INDEX_TOO_SMALL);
+        }
+
+        entries[count].nx_secure_x509_crl_index_entry_hash = _nx_secure_x509_crl_index_hash(serial_number, serial_number_length);
+        entries[count].nx_secure_x509_crl_index_entry_offset = (ULONG)(current_buffer - crl -> nx_secure_x509_crl_revoked_certs);
+
+#if NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+        /* Set the bits of the serial number, double hashing from its hash. */
+        hash = entries[count].nx_secure_x509_crl_index_entry_hash;
+        step = ((hash >> 17) | (hash << 15)) | 1;
+        for (i = 0; i < NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES; i++)
+        {
+            bit = (hash + (i * step)) % NX_SECURE_X509_CRL_INDEX_BLOOM_BITS;
+            crl_index -> nx_secure_x509_crl_index_bloom[bit >> 3] = (UCHAR)(crl_index -> nx_secure_x509_crl_index_bloom[bit >> 3] | (1 << (bit & 7)));
+        }
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+
+        count++;
+        length -= bytes_processed;
+        current_buffer = current_buffer + bytes_processed;
+    }
+
+    _nx_secure_x509_crl_index_sort(entries, count);
+
+    crl_index -> nx_secure_x509_crl_index_entries = entries;
+    crl_index -> nx_secure_x509_crl_index_count = count;
+    crl_index -> nx_secure_x509_crl_index_id = NX_SECURE_X509_CRL_INDEX_ID;
+
+    return(NX_SECURE_X509_SUCCESS);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_sort                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sorts the entries of a CRL index by the hash of their */
+/*    serial number, with a heap sort that needs neither recursion nor    */
+/*    extra memory.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    entries                               Entries to sort               */
+/*    count                                 Number of entries             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_create      Create an index of a CRL      */
+/*                                                                        */
+/**************************************************************************/
+static VOID _nx_secure_x509_crl_index_sort(NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT count)
+{
+NX_SECURE_X509_CRL_INDEX_ENTRY entry;
+UINT                           start;
+UINT                           end;
+UINT                           parent;
+UINT                           child;
+
+    if (count < 2)
+    {
+        return;
+    }
+
+    /* Build a max-heap, then move its root after the heap one entry at a time. */
+    start = count / 2;
+    end = count;
+    while (end > 1)
+    {
+        if (start > 0)
+        {
+            start--;
+        }
+        else
+        {
+            end--;
+            entry = entries[end];
+            entries[end] = entries[0];
+            entries[0] = entry;
+        }
+
+        /* Sift the entry at start down the heap. */
+        parent = start;
+        child = (2 * parent) + 1;
+        while (child < end)
+        {
+            if (((child + 1) < end) &&
+                (entries[child + 1].nx_secure_x509_crl_index_entry_hash > entries[child].nx_secure_x509_crl_index_entry_hash))
+            {
+                child++;
+            }
+
+            if (entries[child].nx_secure_x509_crl_index_entry_hash <= entries[parent].nx_secure_x509_crl_index_entry_hash)
+            {
+                break;
+            }
+
+            entry = entries[child];
+            entries[child] = entries[parent];
+            entries[parent] = entry;
+            parent = child;
+            child = (2 * parent) + 1;
+        }
+    }
+}
+#endif /* NX_SECURE_X509_DISABLE_CRL */
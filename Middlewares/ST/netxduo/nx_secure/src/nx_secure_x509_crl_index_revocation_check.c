@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    X.509 Digital Certificates                                         */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_x509.h"
+
+#ifndef NX_SECURE_X509_DISABLE_CRL
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_revocation_check          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks a certificate against a CRL index created by   */
+/*    _nx_secure_x509_crl_index_create. The issuer of the CRL must be the */
+/*    issuer of the certificate. The serial number of the certificate is  */
+/*    hashed, ruled out by the Bloom filter of the index for most         */
+/*    certificates when it is configured, and otherwise searched in the   */
+/*    sorted entries. A revoked certificate is only reported once its     */
+/*    serial number is found in full in the CRL. The CRL was              */
+/*    authenticated when the index was created and is not verified again. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crl_index                             Index of the CRL              */
+/*    certificate                           The certificate being checked */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_hash        Hash a serial number          */
+/*    _nx_secure_x509_crl_parse_entry       Parse an entry in crl         */
+/*    _nx_secure_x509_distinguished_name_compare                          */
+/*                                          Compare distinguished name    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nx_secure_x509_crl_index_revocation_check(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                                NX_SECURE_X509_CERT *certificate)
+{
+NX_SECURE_X509_CRL             *crl = &crl_index -> nx_secure_x509_crl_index_crl;
+NX_SECURE_X509_CRL_INDEX_ENTRY *entries = crl_index -> nx_secure_x509_crl_index_entries;
+UINT                            status;
+INT                             compare_value;
+UINT                            bytes_processed;
+ULONG                           offset;
+ULONG                           hash;
+UINT                            low;
+UINT                            high;
+UINT                            middle;
+const UCHAR                    *serial_number = NX_NULL;
+UINT                            serial_number_length;
+#if NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+ULONG                           step;
+ULONG                           bit;
+UINT                            i;
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+
+    /* An index whose creation failed holds no CRL authenticated against its issuer. */
+    if (crl_index -> nx_secure_x509_crl_index_id != NX_SECURE_X509_CRL_INDEX_ID)
+    {
+        return(NX_SECURE_X509_CRL_SIGNATURE_CHECK_FAILED);
+    }
+
+    /* Check that the issuers match according to process in RFC 5280. */
+    compare_value = _nx_secure_x509_distinguished_name_compare(&crl -> nx_secure_x509_crl_issuer, &certificate -> nx_secure_x509_issuer, NX_SECURE_X509_NAME_ALL_FIELDS);
+
+    if (compare_value)
+    {
+        /* The issuers did not match, return error. */
+        return(NX_SECURE_X509_CRL_ISSUER_MISMATCH);
+    }
+
+    hash = _nx_secure_x509_crl_index_hash(certificate -> nx_secure_x509_serial_number,
+                                          certificate -> nx_secure_x509_serial_number_length);
+
+#if NX_SECURE_X509_CRL_INDEX_BLOOM_BITS
+    /* A bit clear rules the serial number out. */
+    step = ((hash >> 17) | (hash << 15)) | 1;
+    for (i = 0; i < NX_SECURE_X509_CRL_INDEX_BLOOM_PROBES; i++)
+    {
+        bit = (hash + (i * step)) % NX_SECURE_X509_CRL_INDEX_BLOOM_BITS;
+        if ((crl_index -> nx_secure_x509_crl_index_bloom[bit >> 3] & (1 << (bit & 7))) == 0)
+        {
+            return(NX_SECURE_X509_SUCCESS);
+        }
+    }
+#endif /* NX_SECURE_X509_CRL_INDEX_BLOOM_BITS */
+
+    /* Find the first entry of the hash. */
+    low = 0;
+    high = crl_index -> nx_secure_x509_crl_index_count;
+    while (low < high)
+    {
+        middle = low + ((high - low) >> 1);
+        if (entries[middle].nx_secure_x509_crl_index_entry_hash < hash)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    /* Compare the serial number of each entry of the hash in full. */
+    for (; (low < crl_index -> nx_secure_x509_crl_index_count) &&
+           (entries[low].nx_secure_x509_crl_index_entry_hash == hash); low++)
+    {
+        offset = entries[low].nx_secure_x509_crl_index_entry_offset;
+        status = _nx_secure_x509_crl_parse_entry(crl -> nx_secure_x509_crl_revoked_certs + offset,
+                                                 crl -> nx_secure_x509_crl_revoked_certs_length - offset,
+                                                 &bytes_processed, &serial_number, &serial_number_length);
+
+        if (status != NX_SECURE_X509_SUCCESS)
+        {
+            return(status);
+        }
+
+        if ((serial_number_length == certificate -> nx_secure_x509_serial_number_length) &&
+            (NX_SECURE_MEMCMP(serial_number, certificate -> nx_secure_x509_serial_number, serial_number_length) == 0))
+        {
+            /* This certificate has been revoked! */
+            return(NX_SECURE_X509_CRL_CERTIFICATE_REVOKED);
+        }
+    }
+
+    /* The certificate is not in the CRL. */
+    return(NX_SECURE_X509_SUCCESS);
+}
+#endif /* NX_SECURE_X509_DISABLE_CRL */
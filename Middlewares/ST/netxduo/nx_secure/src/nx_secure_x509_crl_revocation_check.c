@@ -25,11 +25,6 @@
 #include "nx_secure_x509.h"
 
 
-#ifndef NX_SECURE_X509_DISABLE_CRL
-static UINT _nx_secure_x509_crl_parse_entry(const UCHAR *buffer, ULONG length, UINT *bytes_processed,
-                                            const UCHAR **serial_number, UINT *serial_number_length);
-#endif /* NX_SECURE_X509_DISABLE_CRL */
-
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -221,7 +216,7 @@ UINT                 serial_number_length;
 }
 
 #ifndef NX_SECURE_X509_DISABLE_CRL
-/* Helper function to parse entries in the revokedCertificates list. */
+/* Helper function to parse entries in the revokedCertificates list, also used by the CRL index. */
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -259,6 +254,9 @@ UINT                 serial_number_length;
 /*  CALLED BY                                                             */
 /*                                                                        */
 /*    _nx_secure_x509_crl_revocation_check  Check revocation in crl       */
+/*    _nx_secure_x509_crl_index_create      Create an index of a CRL      */
+/*    _nx_secure_x509_crl_index_revocation_check                          */
+/*                                          Check revocation in an index  */
 /*                                                                        */
 /*  RELEASE HISTORY                                                       */
 /*                                                                        */
@@ -269,8 +267,8 @@ UINT                 serial_number_length;
 /*                                            resulting in version 6.1    */
 /*                                                                        */
 /**************************************************************************/
-static UINT _nx_secure_x509_crl_parse_entry(const UCHAR *buffer, ULONG length, UINT *bytes_processed,
-                                            const UCHAR **serial_number, UINT *serial_number_length)
+UINT _nx_secure_x509_crl_parse_entry(const UCHAR *buffer, ULONG length, UINT *bytes_processed,
+                                     const UCHAR **serial_number, UINT *serial_number_length)
 {
 USHORT       tlv_type;
 USHORT       tlv_type_class;
@@ -88,6 +88,9 @@ ULONG        header_length;
 ULONG        seq_length;
 UINT         status;
 USHORT       version;
+UINT         i;
+const UCHAR **crt_values[3];
+USHORT      *crt_lengths[3];
 
 
     /* Parse an ASN.1 DER-encoded PKCS#1 formatted RSA private key file. */
@@ -297,6 +300,48 @@ USHORT       version;
                                                &rsa_key -> nx_secure_rsa_private_prime_q_length);
     }
 
+    /* Advance our working pointer past the last field. */
+    tlv_data = &tlv_data[tlv_length];
+
+    if (rsa_key != NULL)
+    {
+        crt_values[0] = &rsa_key -> nx_secure_rsa_private_exponent_p;
+        crt_lengths[0] = &rsa_key -> nx_secure_rsa_private_exponent_p_length;
+        crt_values[1] = &rsa_key -> nx_secure_rsa_private_exponent_q;
+        crt_lengths[1] = &rsa_key -> nx_secure_rsa_private_exponent_q_length;
+        crt_values[2] = &rsa_key -> nx_secure_rsa_private_coefficient;
+        crt_lengths[2] = &rsa_key -> nx_secure_rsa_private_coefficient_length;
+    }
+
+    /* Parse the last fields, exponent1, exponent2 and coefficient, used by the CRT. */
+    for (i = 0; i < 3; i++)
+    {
+        status = _nx_secure_x509_asn1_tlv_block_parse(tlv_data, &seq_length, &tlv_type, &tlv_type_class, &tlv_length, &tlv_data, &header_length);
+
+        /*  Make sure we parsed the block alright. */
+        if (status != 0)
+        {
+            return(status);
+        }
+
+        if (tlv_type != NX_SECURE_ASN_TAG_INTEGER || tlv_type_class != NX_SECURE_ASN_TAG_CLASS_UNIVERSAL)
+        {
+            return(NX_SECURE_PKCS1_INVALID_PRIVATE_KEY);
+        }
+
+        /* Update byte count. */
+        *bytes_processed += (header_length + tlv_length);
+
+        /* The value is an integer, so no padding bytes are needed (as with a BITSTRING). */
+        if (rsa_key != NULL)
+        {
+            _nx_secure_asn1_parse_unsigned_integer(tlv_data, tlv_length, crt_values[i], crt_lengths[i]);
+        }
+
+        /* Advance our working pointer past the last field. */
+        tlv_data = &tlv_data[tlv_length];
+    }
+
     return(NX_SECURE_X509_SUCCESS);
 }
 
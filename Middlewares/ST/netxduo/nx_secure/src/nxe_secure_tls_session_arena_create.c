@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    Transport Layer Security (TLS)                                     */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_secure_tls.h"
+
+/* Bring in externs for caller checking code.  */
+
+NX_SECURE_CALLER_CHECKING_EXTERNS
+
+#ifdef NX_SECURE_TLS_ENABLE_SESSION_ARENA
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nxe_secure_tls_session_arena_create                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the TLS session arena create     */
+/*    call.                                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    session_ptr                           TLS session control block     */
+/*    crypto_table                          Crypto methods                */
+/*    arena_ptr                             Pointer to arena              */
+/*    packet_buffer_size                    Size of packet buffer         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_tls_session_arena_create   Actual session create call    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT  _nxe_secure_tls_session_arena_create(NX_SECURE_TLS_SESSION *session_ptr,
+                                           const NX_SECURE_TLS_CRYPTO *crypto_table,
+                                           NX_SECURE_TLS_ARENA *arena_ptr, ULONG packet_buffer_size)
+{
+UINT status;
+NX_SECURE_TLS_SESSION *created_tls_session;
+ULONG created_count;
+
+    if ((session_ptr == NX_NULL) || (crypto_table == NX_NULL) || (arena_ptr == NX_NULL))
+    {
+        return(NX_PTR_ERROR);
+    }
+
+    /* Loop to check for the TLS session already created.  */
+    created_tls_session = _nx_secure_tls_created_ptr;
+    created_count = _nx_secure_tls_created_count;
+    while (created_count--)
+    {
+
+        /* Is the new session already created?  */
+        if (session_ptr == created_tls_session)
+        {
+
+            /* Duplicate tls session created, return an error!  */
+            return(NX_PTR_ERROR);
+        }
+
+        /* Move to next entry.  */
+        created_tls_session = created_tls_session -> nx_secure_tls_created_next;
+    }
+
+    /* Check for appropriate caller.  */
+    NX_THREADS_ONLY_CALLER_CHECKING
+
+    status = _nx_secure_tls_session_arena_create(session_ptr, crypto_table, arena_ptr, packet_buffer_size);
+
+    /* Return completion status.  */
+    return(status);
+}
+#endif /* NX_SECURE_TLS_ENABLE_SESSION_ARENA */
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Secure Component                                                 */
+/**                                                                       */
+/**    X.509 Digital Certificates                                         */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SECURE_SOURCE_CODE
+
+#include "nx_secure_x509.h"
+
+/* Bring in externs for caller checking code.  */
+
+NX_SECURE_CALLER_CHECKING_EXTERNS
+
+#ifndef NX_SECURE_X509_DISABLE_CRL
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                                              */
+/*                                                                        */
+/*    _nxe_secure_x509_crl_index_create                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks for errors in the X.509 CRL index create call. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    crl_index                             Index to create               */
+/*    crl_data                              Pointer to DER-encoded CRL    */
+/*    crl_length                            Length of CRL data in buffer  */
+/*    store                                 Certificate store to be used  */
+/*    entries                               Entries of the index          */
+/*    entries_count                         Number of entries             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _nx_secure_x509_crl_index_create      Actual X509 CRL index create  */
+/*                                            call                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT _nxe_secure_x509_crl_index_create(NX_SECURE_X509_CRL_INDEX *crl_index,
+                                       const UCHAR *crl_data, UINT crl_length,
+                                       NX_SECURE_X509_CERTIFICATE_STORE *store,
+                                       NX_SECURE_X509_CRL_INDEX_ENTRY *entries, UINT entries_count)
+{
+UINT status;
+
+    /* Check for pointer errors. */
+    if ((crl_index == NX_CRYPTO_NULL) || (crl_data == NX_CRYPTO_NULL) || (crl_length == 0) || (store == NX_CRYPTO_NULL) ||
+        ((entries == NX_CRYPTO_NULL) && (entries_count != 0)))
+    {
+#ifdef NX_CRYPTO_STANDALONE_ENABLE
+        return(NX_CRYPTO_PTR_ERROR);
+#else
+        return(NX_PTR_ERROR);
+#endif /* NX_CRYPTO_STANDALONE_ENABLE */
+    }
+
+    /* Check for appropriate caller.  */
+    NX_THREADS_ONLY_CALLER_CHECKING
+
+    /* Make the actual call. */
+    status = _nx_secure_x509_crl_index_create(crl_index, crl_data, crl_length, store, entries, entries_count);
+
+    return(status);
+}
+#endif /* NX_SECURE_X509_DISABLE_CRL */
@@ -140,6 +140,67 @@
 #endif
 
 
+/* Define the Internet checksum kernel used by _nx_ip_checksum_compute. It sums "words"
+   32-bit words starting at "ptr" with end-around carry, four words per iteration on
+   word aligned data, and returns the sum folded so that further 16-bit additions by
+   the caller cannot overflow. A halfword aligned head is handled by summing its first
+   and last halfwords apart, any other misalignment falls back to single LDR loads.  */
+
+#define NX_PORT_CHECKSUM_WORDS_ADD(sum, ptr, words)  _nx_port_checksum_words_add((sum), (ptr), (words))
+
+static inline ULONG _nx_port_checksum_words_add(ULONG sum, ULONG *ptr, ULONG words)
+{
+ULONG   a, b, c, d;
+USHORT *short_ptr;
+
+    if (words == 0)
+    {
+        return(sum);
+    }
+
+    if (((ULONG)ptr & 3) == 2)
+    {
+        short_ptr = (USHORT *)ptr;
+        sum += short_ptr[0];
+        sum += short_ptr[(words << 1) - 1];
+        ptr = (ULONG *)(short_ptr + 1);
+        words--;
+    }
+
+    if (((ULONG)ptr & 3) == 0)
+    {
+        while (words >= 4)
+        {
+            __asm__ volatile ("ldrd   %[a], %[b], [%[p]], #8  \n\t"
+                              "ldrd   %[c], %[d], [%[p]], #8  \n\t"
+                              "adds   %[s], %[s], %[a]        \n\t"
+                              "adcs   %[s], %[s], %[b]        \n\t"
+                              "adcs   %[s], %[s], %[c]        \n\t"
+                              "adcs   %[s], %[s], %[d]        \n\t"
+                              "adc    %[s], %[s], #0"
+                              : [s] "+r" (sum), [p] "+r" (ptr),
+                                [a] "=&r" (a), [b] "=&r" (b), [c] "=&r" (c), [d] "=&r" (d)
+                              :
+                              : "cc", "memory");
+            words -= 4;
+        }
+    }
+
+    while (words)
+    {
+        __asm__ volatile ("ldr    %[a], [%[p]], #4        \n\t"
+                          "adds   %[s], %[s], %[a]        \n\t"
+                          "adc    %[s], %[s], #0"
+                          : [s] "+r" (sum), [p] "+r" (ptr), [a] "=&r" (a)
+                          :
+                          : "cc", "memory");
+        words--;
+    }
+
+    return((sum >> 16) + (sum & 0xFFFF));
+}
+
+
 /* Define several macros for the error checking shell in NetX.  */
 
 #ifndef TX_TIMER_PROCESS_IN_ISR
@@ -63,6 +63,63 @@
 #define TX_BYTE_BLOCK_MIN                       ((ULONG) 20)
 #endif
 
+
+/* Determine if the byte pools use two-level segregated fit (TLSF) free lists.  */
+
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+/* Free blocks are kept on one list per size class, TX_BYTE_POOL_TLSF_SL_COUNT classes
+   per power of two and one class per ALIGN_TYPE below TX_BYTE_POOL_TLSF_SMALL_SIZE.  Two
+   bitmaps tell which lists are not empty, so a block is found, split, and merged with its
+   free neighbors in constant time.  The first level covers blocks of up to
+   2^(TX_BYTE_POOL_TLSF_FL_COUNT + 4) bytes, larger blocks share the last list.  */
+
+#ifndef TX_BYTE_POOL_TLSF_FL_COUNT
+#define TX_BYTE_POOL_TLSF_FL_COUNT              ((UINT) 16)
+#endif
+
+#define TX_BYTE_POOL_TLSF_SL_LOG2               ((UINT) 3)
+#define TX_BYTE_POOL_TLSF_SL_COUNT              ((UINT) 8)
+#define TX_BYTE_POOL_TLSF_SMALL_LOG2            ((UINT) 5)
+#define TX_BYTE_POOL_TLSF_SMALL_SIZE            ((ULONG) 32)
+
+
+/* Define the flag set in the next block pointer of a block whose previous block is free.
+   The last pointer of a free block holds its own address, so the next block finds it for
+   merging.  */
+
+#define TX_BYTE_BLOCK_PREVIOUS_FREE             ((ALIGN_TYPE) 1)
+
+
+/* Define the smallest block, large enough for the header, the free list links, and the
+   pointer at its end.  */
+
+#define TX_BYTE_POOL_TLSF_BLOCK_MIN             ((((((sizeof(UCHAR *)) * ((ULONG) 4)) + ((sizeof(ALIGN_TYPE)) * ((ULONG) 2))) - ((ULONG) 1)) / (sizeof(ALIGN_TYPE))) * (sizeof(ALIGN_TYPE)))
+
+
+/* Define the free lists, kept at the beginning of the pool's memory area.  */
+
+typedef struct TX_BYTE_POOL_TLSF_STRUCT
+{
+
+    /* Define the bitmap of the first level classes with a list that is not empty.  */
+    ULONG               tx_byte_pool_tlsf_fl_bitmap;
+
+    /* Define the bitmaps of the second level lists that are not empty.  */
+    ULONG               tx_byte_pool_tlsf_sl_bitmap[TX_BYTE_POOL_TLSF_FL_COUNT];
+
+    /* Define the heads of the free lists.  */
+    UCHAR               *tx_byte_pool_tlsf_free_list[TX_BYTE_POOL_TLSF_FL_COUNT][TX_BYTE_POOL_TLSF_SL_COUNT];
+} TX_BYTE_POOL_TLSF;
+
+#define TX_BYTE_POOL_TLSF_SIZE                  ((((((ULONG) (sizeof(TX_BYTE_POOL_TLSF))) + (sizeof(ALIGN_TYPE))) - ((ULONG) 1)) / (sizeof(ALIGN_TYPE))) * (sizeof(ALIGN_TYPE)))
+#define TX_BYTE_POOL_TO_TLSF_POINTER_CONVERT(a) ((TX_BYTE_POOL_TLSF *) ((VOID *) ((a) -> tx_byte_pool_start)))
+
+#ifndef TX_BYTE_POOL_MIN
+#define TX_BYTE_POOL_MIN                        (TX_BYTE_POOL_TLSF_SIZE + ((ULONG) 100))
+#endif
+#endif
+
 #ifndef TX_BYTE_POOL_MIN
 #define TX_BYTE_POOL_MIN                        ((ULONG) 100)
 #endif
@@ -103,6 +160,10 @@ VOID        _tx_byte_pool_initialize(VOID);
 /* Define internal byte memory pool management function prototypes.  */
 
 UCHAR       *_tx_byte_pool_search(TX_BYTE_POOL *pool_ptr, ULONG memory_size);
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+VOID        _tx_byte_pool_tlsf_insert(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr);
+VOID        _tx_byte_pool_tlsf_release(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr);
+#endif
 VOID        _tx_byte_pool_cleanup(TX_THREAD *thread_ptr, ULONG suspension_sequence);
 
 
@@ -54,7 +54,15 @@
 /* Define timer management specific data definitions.  */
 
 #define TX_TIMER_ID                             ((ULONG) 0x4154494D)
+
+
+/* Define the number of entries in the timer list, one per tick.  A timer set further out
+   waits in the last entry and passes through the list again, so a larger list takes fewer
+   passes for long timeouts at the cost of one pointer per entry (typically set in tx_user.h).  */
+
+#ifndef TX_TIMER_ENTRIES
 #define TX_TIMER_ENTRIES                        ((ULONG) 32)
+#endif
 
 
 /* Define internal timer management function prototypes.  */
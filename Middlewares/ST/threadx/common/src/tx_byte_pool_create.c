@@ -100,6 +100,16 @@ ALIGN_TYPE          *free_ptr;
     pool_ptr -> tx_byte_pool_start =   TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
     pool_ptr -> tx_byte_pool_size =    pool_size;
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+    /* Keep the free lists at the beginning of the memory area, the blocks follow them.  */
+    TX_MEMSET(pool_start, 0, (sizeof(TX_BYTE_POOL_TLSF)));
+    temp_ptr =    TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
+    temp_ptr =    TX_UCHAR_POINTER_ADD(temp_ptr, TX_BYTE_POOL_TLSF_SIZE);
+    pool_start =  TX_UCHAR_TO_VOID_POINTER_CONVERT(temp_ptr);
+    pool_size =   pool_size - TX_BYTE_POOL_TLSF_SIZE;
+#endif
+
     /* Setup memory list to the beginning as well as the search pointer.  */
     pool_ptr -> tx_byte_pool_list =    TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
     pool_ptr -> tx_byte_pool_search =  TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
@@ -140,6 +150,12 @@ ALIGN_TYPE          *free_ptr;
     free_ptr =             TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(block_ptr);
     *free_ptr =            TX_BYTE_BLOCK_FREE;
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+    /* Put the large available block on its free list.  */
+    _tx_byte_pool_tlsf_insert(pool_ptr, TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start));
+#endif
+
     /* Clear the owner id.  */
     pool_ptr -> tx_byte_pool_owner =  TX_NULL;
 
@@ -30,6 +30,11 @@
 #include "tx_byte_pool.h"
 
 
+/* Determine if the first-fit search is used, the TLSF search is in tx_byte_pool_tlsf.c.  */
+
+#ifndef TX_BYTE_POOL_ENABLE_TLSF
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -352,3 +357,4 @@ ULONG           total_theoretical_available;
     return(current_ptr);
 }
 
+#endif
@@ -0,0 +1,557 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Byte Memory                                                         */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_byte_pool.h"
+
+
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+/* Define the accesses to the fields of a block.  Each block starts with the pointer to the
+   next block, with TX_BYTE_BLOCK_PREVIOUS_FREE in its low bit, followed by the owner field.
+   A free block keeps its next and previous free blocks after the owner field.  */
+
+#define TX_BYTE_BLOCK_HEADER_SIZE               ((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE)))
+#define TX_BYTE_BLOCK_LINK(b)                   (*(TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(b)))
+#define TX_BYTE_BLOCK_NEXT(b)                   (TX_VOID_TO_UCHAR_POINTER_CONVERT(TX_ALIGN_TYPE_TO_POINTER_CONVERT(TX_BYTE_BLOCK_LINK(b) & ~TX_BYTE_BLOCK_PREVIOUS_FREE)))
+#define TX_BYTE_BLOCK_OWNER(b)                  (*(TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(TX_UCHAR_POINTER_ADD((b), (sizeof(UCHAR *))))))
+#define TX_BYTE_BLOCK_FREE_NEXT(b)              (*(TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_ADD((b), TX_BYTE_BLOCK_HEADER_SIZE))))
+#define TX_BYTE_BLOCK_FREE_PREVIOUS(b)          (*(TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_ADD((b), (TX_BYTE_BLOCK_HEADER_SIZE + (sizeof(UCHAR *)))))))
+#define TX_BYTE_BLOCK_FOOTER(n)                 (*(TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_SUB((n), (sizeof(UCHAR *))))))
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_mapping                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the first and second level indexes of the     */
+/*    free list of the specified block size.                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    block_size                            Size of the block in bytes    */
+/*    fl_ptr                                Destination for first level   */
+/*    sl_ptr                                Destination for second level  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX Components                                                  */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _tx_byte_pool_tlsf_mapping(ULONG block_size, UINT *fl_ptr, UINT *sl_ptr)
+{
+
+ULONG   value;
+UINT    msb;
+
+
+    /* Determine if this is a small block.  */
+    if (block_size < TX_BYTE_POOL_TLSF_SMALL_SIZE)
+    {
+
+        /* Yes, small blocks have one list per 4 bytes.  */
+        *fl_ptr =  ((UINT) 0);
+        *sl_ptr =  (UINT) (block_size >> 2);
+    }
+    else
+    {
+
+        /* Find the most significant bit of the size.  */
+        value =  block_size;
+        msb =    ((UINT) 0);
+        if (value >= ((ULONG) 0x10000))
+        {
+            value =  value >> 16;
+            msb =    msb + ((UINT) 16);
+        }
+        if (value >= ((ULONG) 0x100))
+        {
+            value =  value >> 8;
+            msb =    msb + ((UINT) 8);
+        }
+        if (value >= ((ULONG) 0x10))
+        {
+            value =  value >> 4;
+            msb =    msb + ((UINT) 4);
+        }
+        if (value >= ((ULONG) 0x4))
+        {
+            value =  value >> 2;
+            msb =    msb + ((UINT) 2);
+        }
+        if (value >= ((ULONG) 0x2))
+        {
+            msb =    msb + ((UINT) 1);
+        }
+
+        /* The power of two selects the first level, the next bits the second level.  */
+        *fl_ptr =  (msb - TX_BYTE_POOL_TLSF_SMALL_LOG2) + ((UINT) 1);
+        *sl_ptr =  ((UINT) (block_size >> (msb - TX_BYTE_POOL_TLSF_SL_LOG2))) & (TX_BYTE_POOL_TLSF_SL_COUNT - ((UINT) 1));
+
+        /* Larger blocks share the last list.  */
+        if (*fl_ptr >= TX_BYTE_POOL_TLSF_FL_COUNT)
+        {
+            *fl_ptr =  TX_BYTE_POOL_TLSF_FL_COUNT - ((UINT) 1);
+            *sl_ptr =  TX_BYTE_POOL_TLSF_SL_COUNT - ((UINT) 1);
+        }
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_remove                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function removes a free block from its free list.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    tlsf_ptr                              Pointer to the free lists     */
+/*    block_ptr                             Pointer to the free block     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_mapping            Find the list of the block    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX Components                                                  */
+/*                                                                        */
+/**************************************************************************/
+static VOID  _tx_byte_pool_tlsf_remove(TX_BYTE_POOL_TLSF *tlsf_ptr, UCHAR *block_ptr)
+{
+
+UCHAR   *next_free_ptr;
+UCHAR   *previous_free_ptr;
+UINT    fl;
+UINT    sl;
+
+
+    /* Find the list of the block.  */
+    _tx_byte_pool_tlsf_mapping(TX_UCHAR_POINTER_DIF(TX_BYTE_BLOCK_NEXT(block_ptr), block_ptr), &fl, &sl);
+
+    /* Unlink the block.  */
+    next_free_ptr =      TX_BYTE_BLOCK_FREE_NEXT(block_ptr);
+    previous_free_ptr =  TX_BYTE_BLOCK_FREE_PREVIOUS(block_ptr);
+    if (next_free_ptr != TX_NULL)
+    {
+        TX_BYTE_BLOCK_FREE_PREVIOUS(next_free_ptr) =  previous_free_ptr;
+    }
+    if (previous_free_ptr != TX_NULL)
+    {
+        TX_BYTE_BLOCK_FREE_NEXT(previous_free_ptr) =  next_free_ptr;
+    }
+    else
+    {
+
+        /* The block was the head of the list.  */
+        tlsf_ptr -> tx_byte_pool_tlsf_free_list[fl][sl] =  next_free_ptr;
+
+        /* Clear the bits of an empty list.  */
+        if (next_free_ptr == TX_NULL)
+        {
+            tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] & ~(((ULONG) 1) << sl);
+            if (tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] == ((ULONG) 0))
+            {
+                tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap =  tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap & ~(((ULONG) 1) << fl);
+            }
+        }
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_insert                           PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function marks a block as free, and puts it at the head of the */
+/*    free list of its size.  Interrupts are assumed to be disabled.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to pool control block */
+/*    block_ptr                             Pointer to the block          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_mapping            Find the list of the block    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_pool_create                  Create byte pool              */
+/*    _tx_byte_pool_search                  Search byte pool for memory   */
+/*    _tx_byte_pool_tlsf_release            Release byte pool block       */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_byte_pool_tlsf_insert(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr)
+{
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *next_ptr;
+UCHAR               *head_ptr;
+UINT                fl;
+UINT                sl;
+
+
+    /* Pickup the free lists.  */
+    tlsf_ptr =  TX_BYTE_POOL_TO_TLSF_POINTER_CONVERT(pool_ptr);
+
+    /* Mark the block as free.  */
+    TX_BYTE_BLOCK_OWNER(block_ptr) =  TX_BYTE_BLOCK_FREE;
+
+    /* Leave the address of the block at its end and flag it in the next block.  */
+    next_ptr =                          TX_BYTE_BLOCK_NEXT(block_ptr);
+    TX_BYTE_BLOCK_FOOTER(next_ptr) =    block_ptr;
+    TX_BYTE_BLOCK_LINK(next_ptr) =      TX_BYTE_BLOCK_LINK(next_ptr) | TX_BYTE_BLOCK_PREVIOUS_FREE;
+
+    /* Put the block at the head of its list.  */
+    _tx_byte_pool_tlsf_mapping(TX_UCHAR_POINTER_DIF(next_ptr, block_ptr), &fl, &sl);
+    head_ptr =                                  tlsf_ptr -> tx_byte_pool_tlsf_free_list[fl][sl];
+    TX_BYTE_BLOCK_FREE_NEXT(block_ptr) =        head_ptr;
+    TX_BYTE_BLOCK_FREE_PREVIOUS(block_ptr) =    TX_NULL;
+    if (head_ptr != TX_NULL)
+    {
+        TX_BYTE_BLOCK_FREE_PREVIOUS(head_ptr) =  block_ptr;
+    }
+    tlsf_ptr -> tx_byte_pool_tlsf_free_list[fl][sl] =  block_ptr;
+
+    /* Set the bits of the list.  */
+    tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] | (((ULONG) 1) << sl);
+    tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap =      tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap | (((ULONG) 1) << fl);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_release                          PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns an allocated block to the free lists, merged  */
+/*    with its free neighbors.  Interrupts are assumed to be disabled.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to pool control block */
+/*    block_ptr                             Pointer to the block          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_remove             Remove block from free list   */
+/*    _tx_byte_pool_tlsf_insert             Put block on free list        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_release                      Release byte memory           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_byte_pool_tlsf_release(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr)
+{
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *next_ptr;
+UCHAR               *previous_ptr;
+
+
+    /* Pickup the free lists.  */
+    tlsf_ptr =  TX_BYTE_POOL_TO_TLSF_POINTER_CONVERT(pool_ptr);
+
+    /* Update the number of available bytes in the pool.  */
+    next_ptr =  TX_BYTE_BLOCK_NEXT(block_ptr);
+    pool_ptr -> tx_byte_pool_available =  pool_ptr -> tx_byte_pool_available + TX_UCHAR_POINTER_DIF(next_ptr, block_ptr);
+
+    /* Determine if the next block is free.  */
+    if (TX_BYTE_BLOCK_OWNER(next_ptr) == TX_BYTE_BLOCK_FREE)
+    {
+
+        /* Yes, merge it into this block.  */
+        _tx_byte_pool_tlsf_remove(tlsf_ptr, next_ptr);
+        TX_BYTE_BLOCK_LINK(block_ptr) =  (TX_BYTE_BLOCK_LINK(block_ptr) & TX_BYTE_BLOCK_PREVIOUS_FREE) |
+                                         TX_POINTER_TO_ALIGN_TYPE_CONVERT(TX_BYTE_BLOCK_NEXT(next_ptr));
+        pool_ptr -> tx_byte_pool_fragments--;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+        /* Increment the total merge counter.  */
+        _tx_byte_pool_performance_merge_count++;
+
+        /* Increment the number of blocks merged on this pool.  */
+        pool_ptr -> tx_byte_pool_performance_merge_count++;
+#endif
+    }
+
+    /* Determine if the previous block is free.  */
+    if ((TX_BYTE_BLOCK_LINK(block_ptr) & TX_BYTE_BLOCK_PREVIOUS_FREE) != ((ALIGN_TYPE) 0))
+    {
+
+        /* Yes, merge this block into it.  */
+        previous_ptr =  TX_BYTE_BLOCK_FOOTER(block_ptr);
+        _tx_byte_pool_tlsf_remove(tlsf_ptr, previous_ptr);
+        TX_BYTE_BLOCK_LINK(previous_ptr) =  (TX_BYTE_BLOCK_LINK(previous_ptr) & TX_BYTE_BLOCK_PREVIOUS_FREE) |
+                                            TX_POINTER_TO_ALIGN_TYPE_CONVERT(TX_BYTE_BLOCK_NEXT(block_ptr));
+        block_ptr =  previous_ptr;
+        pool_ptr -> tx_byte_pool_fragments--;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+        /* Increment the total merge counter.  */
+        _tx_byte_pool_performance_merge_count++;
+
+        /* Increment the number of blocks merged on this pool.  */
+        pool_ptr -> tx_byte_pool_performance_merge_count++;
+#endif
+    }
+
+    /* Put the merged block on its free list.  */
+    _tx_byte_pool_tlsf_insert(pool_ptr, block_ptr);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_search                                PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function takes a free block of at least the specified size     */
+/*    from the free lists, in constant time.  The size is rounded up to   */
+/*    the next size class, whose list holds only large enough blocks, and */
+/*    the first list of that class or above that is not empty is found    */
+/*    from the bitmaps.  Only if there is none, the list of the size      */
+/*    itself is searched.  The rest of the block is put back on the free  */
+/*    lists if it is large enough.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Pointer to pool control block */
+/*    memory_size                           Number of bytes required      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    UCHAR *                               Pointer to the allocated      */
+/*                                            memory, if successful.      */
+/*                                            Otherwise, a NULL is        */
+/*                                            returned                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_mapping            Find the list of a size       */
+/*    _tx_byte_pool_tlsf_remove             Remove block from free list   */
+/*    _tx_byte_pool_tlsf_insert             Put block on free list        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_allocate                     Allocate bytes of memory      */
+/*    _tx_byte_release                      Release bytes of memory       */
+/*                                                                        */
+/**************************************************************************/
+UCHAR  *_tx_byte_pool_search(TX_BYTE_POOL *pool_ptr, ULONG memory_size)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *current_ptr;
+UCHAR               *next_ptr;
+UCHAR               *split_ptr;
+ULONG               block_size;
+ULONG               search_size;
+ULONG               map;
+UINT                fl;
+UINT                sl;
+UINT                size_fl;
+UINT                size_sl;
+
+
+    /* Default to no memory found.  */
+    current_ptr =  TX_NULL;
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* First, determine if there are enough bytes in the pool.  */
+    if (memory_size < pool_ptr -> tx_byte_pool_available)
+    {
+
+        /* Pickup the free lists.  */
+        tlsf_ptr =  TX_BYTE_POOL_TO_TLSF_POINTER_CONVERT(pool_ptr);
+
+        /* Add the header, and keep the block large enough to be freed again.  */
+        block_size =  memory_size + TX_BYTE_BLOCK_HEADER_SIZE;
+        if (block_size < TX_BYTE_POOL_TLSF_BLOCK_MIN)
+        {
+            block_size =  TX_BYTE_POOL_TLSF_BLOCK_MIN;
+        }
+
+        /* Pickup the list of the size itself, its blocks may or may not fit.  */
+        _tx_byte_pool_tlsf_mapping(block_size, &size_fl, &size_sl);
+
+        /* Round the size up to the next size class, so any block of its list fits.  */
+        search_size =  block_size;
+        if (search_size >= TX_BYTE_POOL_TLSF_SMALL_SIZE)
+        {
+            search_size =  (search_size + ((TX_BYTE_POOL_TLSF_SMALL_SIZE << (size_fl - ((UINT) 1))) >> TX_BYTE_POOL_TLSF_SL_LOG2)) - ((ULONG) 1);
+        }
+        _tx_byte_pool_tlsf_mapping(search_size, &fl, &sl);
+
+        /* Find a list of this class that is not empty.  */
+        map =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] & (((ULONG) 0xFFFFFFFF) << sl);
+        if (map == ((ULONG) 0))
+        {
+
+            /* None, find a larger class that is not empty.  */
+            map =  tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap & (((ULONG) 0xFFFFFFFF) << (fl + ((UINT) 1)));
+            if (map != ((ULONG) 0))
+            {
+                TX_LOWEST_SET_BIT_CALCULATE(map, fl)
+                map =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl];
+            }
+        }
+
+        /* Determine if a list was found.  */
+        if (map != ((ULONG) 0))
+        {
+
+            /* Pickup the head of the list.  */
+            TX_LOWEST_SET_BIT_CALCULATE(map, sl)
+            current_ptr =  tlsf_ptr -> tx_byte_pool_tlsf_free_list[fl][sl];
+
+            /* Only the last list, shared by the largest blocks, may hold a block smaller
+               than required.  */
+            while ((current_ptr != TX_NULL) && (TX_UCHAR_POINTER_DIF(TX_BYTE_BLOCK_NEXT(current_ptr), current_ptr) < block_size))
+            {
+                current_ptr =  TX_BYTE_BLOCK_FREE_NEXT(current_ptr);
+            }
+        }
+
+        /* Determine if no larger class has a block.  */
+        if (current_ptr == TX_NULL)
+        {
+
+            /* Look for a block that fits in the list of the size itself, so a pool with
+               one large block left still satisfies a request close to its size.  */
+            current_ptr =  tlsf_ptr -> tx_byte_pool_tlsf_free_list[size_fl][size_sl];
+            while ((current_ptr != TX_NULL) && (TX_UCHAR_POINTER_DIF(TX_BYTE_BLOCK_NEXT(current_ptr), current_ptr) < block_size))
+            {
+                current_ptr =  TX_BYTE_BLOCK_FREE_NEXT(current_ptr);
+            }
+        }
+
+        /* Determine if a block was found.  */
+        if (current_ptr != TX_NULL)
+        {
+
+            /* Take the block off its free list.  */
+            _tx_byte_pool_tlsf_remove(tlsf_ptr, current_ptr);
+            next_ptr =  TX_BYTE_BLOCK_NEXT(current_ptr);
+
+            /* Determine if we need to split this block.  */
+            if ((TX_UCHAR_POINTER_DIF(next_ptr, current_ptr) - block_size) >= TX_BYTE_POOL_TLSF_BLOCK_MIN)
+            {
+
+                /* Split the block, the rest goes back on the free lists.  */
+                split_ptr =                         TX_UCHAR_POINTER_ADD(current_ptr, block_size);
+                TX_BYTE_BLOCK_LINK(split_ptr) =     TX_POINTER_TO_ALIGN_TYPE_CONVERT(next_ptr);
+                TX_BYTE_BLOCK_LINK(current_ptr) =   (TX_BYTE_BLOCK_LINK(current_ptr) & TX_BYTE_BLOCK_PREVIOUS_FREE) |
+                                                    TX_POINTER_TO_ALIGN_TYPE_CONVERT(split_ptr);
+                _tx_byte_pool_tlsf_insert(pool_ptr, split_ptr);
+
+                /* Increase the total fragment counter.  */
+                pool_ptr -> tx_byte_pool_fragments++;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+                /* Increment the total split counter.  */
+                _tx_byte_pool_performance_split_count++;
+
+                /* Increment the number of blocks split on this pool.  */
+                pool_ptr -> tx_byte_pool_performance_split_count++;
+#endif
+            }
+            else
+            {
+
+                /* The whole block is allocated, clear its flag in the next block.  */
+                TX_BYTE_BLOCK_LINK(next_ptr) =  TX_BYTE_BLOCK_LINK(next_ptr) & ~TX_BYTE_BLOCK_PREVIOUS_FREE;
+                block_size =                    TX_UCHAR_POINTER_DIF(next_ptr, current_ptr);
+            }
+
+            /* Mark the block as allocated.  */
+            TX_BYTE_BLOCK_OWNER(current_ptr) =  TX_POINTER_TO_ALIGN_TYPE_CONVERT(pool_ptr);
+
+            /* Reduce the number of available bytes in the pool.  */
+            pool_ptr -> tx_byte_pool_available =  pool_ptr -> tx_byte_pool_available - block_size;
+
+            /* Adjust the pointer for the application.  */
+            current_ptr =  TX_UCHAR_POINTER_ADD(current_ptr, TX_BYTE_BLOCK_HEADER_SIZE);
+        }
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Return the memory pointer.  */
+    return(current_ptr);
+}
+#endif
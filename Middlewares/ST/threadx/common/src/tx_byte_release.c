@@ -84,7 +84,9 @@ TX_BYTE_POOL        *pool_ptr;
 TX_THREAD           *thread_ptr;
 UCHAR               *work_ptr;
 UCHAR               *temp_ptr;
+#ifndef TX_BYTE_POOL_ENABLE_TLSF
 UCHAR               *next_block_ptr;
+#endif
 TX_THREAD           *susp_thread_ptr;
 UINT                suspended_count;
 TX_THREAD           *next_thread;
@@ -92,7 +94,9 @@ TX_THREAD           *previous_thread;
 ULONG               memory_size;
 ALIGN_TYPE          *free_ptr;
 TX_BYTE_POOL        **byte_pool_ptr;
+#ifndef TX_BYTE_POOL_ENABLE_TLSF
 UCHAR               **block_link_ptr;
+#endif
 UCHAR               **suspend_info_ptr;
 
 
@@ -193,6 +197,12 @@ UCHAR               **suspend_info_ptr;
         /* Log this kernel call.  */
         TX_EL_BYTE_RELEASE_INSERT
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+        /* Release the memory to the free lists, merged with its free neighbors.  */
+        _tx_byte_pool_tlsf_release(pool_ptr, work_ptr);
+#else
+
         /* Release the memory.  */
         temp_ptr =   TX_UCHAR_POINTER_ADD(work_ptr, (sizeof(UCHAR *)));
         free_ptr =   TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(temp_ptr);
@@ -211,6 +221,7 @@ UCHAR               **suspend_info_ptr;
             /* Yes, update the search pointer to the released block.  */
             pool_ptr -> tx_byte_pool_search =  work_ptr;
         }
+#endif
 
         /* Determine if there are threads suspended on this byte pool.  */
         if (pool_ptr -> tx_byte_pool_suspended_count != TX_NO_SUSPENSIONS)
@@ -338,6 +349,9 @@ UCHAR               **suspend_info_ptr;
                     /* Put the memory back on the available list since this thread is no longer
                        suspended.  */
                     work_ptr =  TX_UCHAR_POINTER_SUB(work_ptr, (((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE)))));
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+                    _tx_byte_pool_tlsf_release(pool_ptr, work_ptr);
+#else
                     temp_ptr =  TX_UCHAR_POINTER_ADD(work_ptr, (sizeof(UCHAR *)));
                     free_ptr =  TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(temp_ptr);
                     *free_ptr =  TX_BYTE_BLOCK_FREE;
@@ -355,6 +369,7 @@ UCHAR               **suspend_info_ptr;
                         /* Yes, update the search pointer.  */
                         pool_ptr -> tx_byte_pool_search =  work_ptr;
                     }
+#endif
                 }
             }
 
@@ -693,6 +693,22 @@ VOID                                            _tx_thread_interrupt_restore(UIN
 #endif  /* TX_DISABLE_INLINE */
 
 
+/* Define the interrupt disable/restore macros of the critical section tracer. With TX_IRQ_OFF_TRACE
+   defined, the sections entered with the interrupts enabled are timed by the hooks of
+   Core/Src/irq_off_trace.c, which disable and restore the interrupts as the macros above do.  */
+
+#ifdef TX_IRQ_OFF_TRACE
+
+UINT                                            _tx_irq_off_trace_disable(VOID);
+VOID                                            _tx_irq_off_trace_restore(UINT interrupt_save);
+
+#undef TX_DISABLE
+#undef TX_RESTORE
+#define TX_DISABLE                              interrupt_save = _tx_irq_off_trace_disable();
+#define TX_RESTORE                              _tx_irq_off_trace_restore(interrupt_save);
+#endif  /* TX_IRQ_OFF_TRACE */
+
+
 /* Define FPU extension for the Cortex-M. Each is assumed to be called in the context of the executing
    thread. These are no longer needed, but are preserved for backward compatibility only.  */
 
@@ -210,6 +210,14 @@ __tx_ts_restore:
     POP     {r0, r1}                                // Recover r0 and r1
 #endif
 
+#if defined(__ARM_FP) && defined(TX_THREAD_FPU_POLICY)
+    /* Grant or deny the FPU to the thread, before its VFP registers are restored.  */
+    PUSH    {r0, r1}                                // Save r0 and r1
+    MOV     r0, r1                                  // Pass the new thread pointer
+    BL      App_ThreadX_FPU_Switch                  // Set CPACR from the thread's FPU attribute
+    POP     {r0, r1}                                // Recover r0 and r1
+#endif
+
     /* Restore the thread context and PSP.  */
 
     LDR     r12, [r1, #8]                           // Pickup thread's stack pointer
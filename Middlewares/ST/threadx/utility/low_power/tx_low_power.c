@@ -0,0 +1,324 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Low Power Timer Management                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_timer.h"
+#include "tx_low_power.h"
+
+
+#ifdef TX_LOW_POWER
+
+/* Define the hooks to the low power timer and the sleep mode of the target to
+   nothing, if they haven't been defined previously (typically in tx_user.h).  */
+
+#ifndef TX_LOW_POWER_TIMER_SETUP
+#define TX_LOW_POWER_TIMER_SETUP(_count)
+#endif
+
+#ifndef TX_LOW_POWER_USER_TIMER_ADJUST
+#define TX_LOW_POWER_USER_TIMER_ADJUST  ((ULONG) 0)
+#endif
+
+#ifndef TX_LOW_POWER_USER_ENTER
+#define TX_LOW_POWER_USER_ENTER
+#endif
+
+#ifndef TX_LOW_POWER_USER_EXIT
+#define TX_LOW_POWER_USER_EXIT
+#endif
+
+
+/* Define the flag set while the low power timer stands in for the tick.  */
+
+static UINT     tx_low_power_timer_active;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    tx_low_power_enter                                  PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called from the idle loop of the scheduler, with   */
+/*    interrupts disabled, before the core waits for an interrupt.  It    */
+/*    programs the low power timer for the tick of the next timer         */
+/*    expiration, so the ticks in between are not taken.  Without an      */
+/*    active timer the low power timer is programmed for as long as it    */
+/*    allows, so the system clock keeps counting.                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_timer_get_next                     Get ticks to next expiration  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_schedule                   Thread scheduling loop        */
+/*                                                                        */
+/**************************************************************************/
+VOID  tx_low_power_enter(VOID)
+{
+
+ULONG   timers_next;
+
+
+    /* Clear the flag of the low power timer.  */
+    tx_low_power_timer_active =  TX_FALSE;
+
+    /* Leave the tick alone while an expiration or a time-slice waits for it.  */
+    if ((_tx_timer_expired == TX_FALSE) && (_tx_timer_time_slice == ((ULONG) 0)))
+    {
+
+        /* Pickup the ticks to the next timer expiration.  */
+        if (tx_timer_get_next(&timers_next) == TX_FALSE)
+        {
+
+            /* No timer is active, the low power timer limits the sleep.  */
+            timers_next =  ((ULONG) 0xFFFFFFFF);
+        }
+
+        /* Is there any tick to skip?  */
+        if (timers_next > ((ULONG) 1))
+        {
+
+            /* Yes, program the low power timer in place of the tick.  */
+            TX_LOW_POWER_TIMER_SETUP(timers_next);
+            tx_low_power_timer_active =  TX_TRUE;
+        }
+    }
+
+    /* Enter the sleep mode of the target.  */
+    TX_LOW_POWER_USER_ENTER;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    tx_low_power_exit                                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called from the idle loop of the scheduler, with   */
+/*    interrupts still disabled, once the core is woken.  It restores the */
+/*    tick and adds the ticks that elapsed during the sleep to the timer  */
+/*    list and the system clock.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_time_increment                     Add the elapsed ticks         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_schedule                   Thread scheduling loop        */
+/*                                                                        */
+/**************************************************************************/
+VOID  tx_low_power_exit(VOID)
+{
+
+ULONG   ticks;
+
+
+    /* Leave the sleep mode of the target.  */
+    TX_LOW_POWER_USER_EXIT;
+
+    /* Did the low power timer stand in for the tick?  */
+    if (tx_low_power_timer_active == TX_TRUE)
+    {
+
+        /* Yes, clear the flag.  */
+        tx_low_power_timer_active =  TX_FALSE;
+
+        /* Restore the tick and pickup the ticks elapsed.  This excludes the tick
+           whose interrupt is pending, if the low power timer expired.  */
+        ticks =  TX_LOW_POWER_USER_TIMER_ADJUST;
+
+        /* Add the ticks elapsed.  */
+        if (ticks != ((ULONG) 0))
+        {
+            tx_time_increment(ticks);
+        }
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    tx_timer_get_next                                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the ticks to the next entry of the timer list */
+/*    that is not empty, the entry under the current pointer being        */
+/*    processed on the next tick.  A timer further out than the list      */
+/*    waits in an earlier entry, so the result never comes after its      */
+/*    expiration.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    next_timer_tick_ptr                   Pointer to destination for    */
+/*                                            the ticks to expiration     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    TX_TRUE                               A timer is active             */
+/*    TX_FALSE                              No timer is active            */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    tx_low_power_enter                    Enter low power mode          */
+/*                                                                        */
+/**************************************************************************/
+UINT  tx_timer_get_next(ULONG *next_timer_tick_ptr)
+{
+
+TX_TIMER_INTERNAL   **timer_list_ptr;
+ULONG               ticks;
+UINT                status;
+
+
+    /* Default to no timer active.  */
+    status =  TX_FALSE;
+
+    /* Start with the entry processed on the next tick.  */
+    timer_list_ptr =  _tx_timer_current_ptr;
+    ticks =  ((ULONG) 1);
+
+    /* Search the timer list for an entry that is not empty.  */
+    do
+    {
+
+        /* Is there a timer in this entry?  */
+        if (*timer_list_ptr != TX_NULL)
+        {
+
+            /* Yes, return the ticks to it.  */
+            *next_timer_tick_ptr =  ticks;
+            status =  TX_TRUE;
+        }
+        else
+        {
+
+            /* Move to the next entry.  */
+            timer_list_ptr =  TX_TIMER_POINTER_ADD(timer_list_ptr, ((ULONG) 1));
+
+            /* Check for wrap-around.  */
+            if (timer_list_ptr == _tx_timer_list_end)
+            {
+
+                /* Wrap to beginning of list.  */
+                timer_list_ptr =  _tx_timer_list_start;
+            }
+
+            ticks++;
+        }
+    } while ((status == TX_FALSE) && (ticks <= TX_TIMER_ENTRIES));
+
+    /* Return completion status.  */
+    return(status);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    tx_time_increment                                   PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds the ticks elapsed while the tick was suppressed  */
+/*    to the system clock, and moves the current timer pointer over the   */
+/*    empty entries of the timer list.  The pointer stops at an entry     */
+/*    that is not empty, whose expiration is left to the tick interrupt.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    time_increment                        Number of ticks elapsed       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    tx_low_power_exit                     Exit low power mode           */
+/*                                                                        */
+/**************************************************************************/
+VOID  tx_time_increment(ULONG time_increment)
+{
+
+    /* Add the elapsed ticks to the system clock.  */
+    _tx_timer_system_clock =  _tx_timer_system_clock + time_increment;
+
+    /* Move the current timer pointer over the entries skipped.  */
+    while ((time_increment != ((ULONG) 0)) && (*_tx_timer_current_ptr == TX_NULL))
+    {
+
+        /* Move to the next entry.  */
+        _tx_timer_current_ptr =  TX_TIMER_POINTER_ADD(_tx_timer_current_ptr, ((ULONG) 1));
+
+        /* Check for wrap-around.  */
+        if (_tx_timer_current_ptr == _tx_timer_list_end)
+        {
+
+            /* Wrap to beginning of list.  */
+            _tx_timer_current_ptr =  _tx_timer_list_start;
+        }
+
+        time_increment--;
+    }
+}
+#endif /* TX_LOW_POWER */
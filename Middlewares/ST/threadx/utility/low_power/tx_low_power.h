@@ -0,0 +1,68 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Low Power Timer Management                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  COMPONENT DEFINITION                                   RELEASE        */
+/*                                                                        */
+/*    tx_low_power.h                                      PORTABLE C      */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This file defines the ThreadX low power entry and exit functions    */
+/*    called from the idle loop of the scheduler when TX_LOW_POWER is     */
+/*    defined.  While idle, the tick is suppressed up to the next timer   */
+/*    expiration and the elapsed ticks are added back on wake.  It is     */
+/*    assumed that tx_api.h and tx_port.h have already been included.     */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef TX_LOW_POWER_H
+#define TX_LOW_POWER_H
+
+/* Determine if a C++ compiler is being used.  If so, ensure that standard
+   C is used to process the API information.  */
+
+#ifdef __cplusplus
+
+/* Yes, C++ compiler is present.  Use standard C.  */
+extern   "C" {
+
+#endif
+
+
+/* Define the low power function prototypes.  */
+
+VOID        tx_low_power_enter(VOID);
+VOID        tx_low_power_exit(VOID);
+UINT        tx_timer_get_next(ULONG *next_timer_tick_ptr);
+VOID        tx_time_increment(ULONG time_increment);
+
+
+/* Determine if a C++ compiler is being used.  If so, complete the standard
+   C conditional started above.  */
+#ifdef __cplusplus
+        }
+#endif
+
+#endif
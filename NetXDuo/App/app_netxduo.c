@@ -25,49 +25,199 @@
 /* USER CODE BEGIN Includes */
 #include "nx_ip.h"
 #include "nx_stm32_eth_config.h"
+#include "nx_stm32_phy_driver.h"
+#include "publish_store.h"
+#include "flash_service.h"
+#include "mqtt_benchmark.h"
+#include "crypto_benchmark.h"
+#include "net_benchmark.h"
+#include "tls_benchmark.h"
+#include "telemetry_dtls.h"
+#include "dns_resolver.h"
+#include "dhcp_lease.h"
+#include "tls_resume.h"
+#include "dhcp_gateway.h"
+#include "sensor_sampler.h"
+#include "cbor_writer.h"
+#include "mqtt_manager.h"
+#include "broker_connect.h"
+#include "local_bus.h"
+#include "local_broker.h"
+#include "packet_capture.h"
+#include "ota_update.h"
+#include "device_stats.h"
+#include "report_filter.h"
+#include "payload_compress.h"
+#include "thread_profile.h"
+#include "boot_profile.h"
+#include "thread_metric.h"
+#include "perf_harness.h"
+#include "log_uart.h"
+#include "dma_copy.h"
+#include "crc_service.h"
+#include "pool_map.h"
+#include "irq_off_trace.h"
+#include "clock_governor.h"
+#include "ecdhe_precompute.h"
+#include "work_queue.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_stm32_crypto_driver.h"
+#endif
+#ifndef NX_SECURE_DISABLE_X509
 #include  MOSQUITTO_CERT_FILE
+#endif
+#include <string.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
-extern RNG_HandleTypeDef hrng;
 
-TX_THREAD AppMainThread;
 TX_THREAD AppMQTTClientThread;
-TX_THREAD AppLinkThread;
-
-TX_SEMAPHORE Semaphore;
 
 NX_PACKET_POOL  AppPool;
+NX_PACKET_POOL  MediumPool;
+NX_PACKET_POOL  AuxPool;
+NX_PACKET_POOL  TlsControlPool;
 NX_IP           IpInstance;
 NX_DHCP         DHCPClient;
 NXD_MQTT_CLIENT mqtt_client;
 static NX_DNS   dns_client;
 
+/* Answers of the DNS server, kept for their time to live. */
+static ULONG dns_cache[DNS_CACHE_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
 ULONG   IpAddress;
 ULONG   NetMask;
 
-ULONG mqtt_client_stack[MQTT_CLIENT_STACK_SIZE];
+/* The CPU only thread stacks and TLS work areas live in CCM-RAM, off the bus
+   matrix shared with the Ethernet DMA. */
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+ULONG mqtt_client_stack[MQTT_CLIENT_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+#endif
+static ULONG ip_thread_stack[IP_THREAD_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+static ULONG mqtt_app_thread_stack[MQTT_APP_THREAD_MEMORY_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+static ULONG work_queue_stack[WORK_QUEUE_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* The packets are read and written by the Ethernet DMA, their pools stay in the main SRAM. */
+static UCHAR packet_pool_memory[NX_PACKET_POOL_SIZE] DMA_RAM __attribute__((aligned(NX_PACKET_ALIGNMENT)));
+static UCHAR medium_packet_pool_memory[NX_MEDIUM_PACKET_POOL_SIZE] DMA_RAM __attribute__((aligned(NX_PACKET_ALIGNMENT)));
+static UCHAR aux_packet_pool_memory[NX_AUX_PACKET_POOL_SIZE] DMA_RAM __attribute__((aligned(NX_PACKET_ALIGNMENT)));
+static UCHAR tls_control_packet_pool_memory[NX_TLS_CONTROL_PACKET_POOL_SIZE] DMA_RAM __attribute__((aligned(NX_PACKET_ALIGNMENT)));
+
+/* ARP entries, in the main SRAM freed by the NetX byte pool to leave the CCM-RAM to the stacks. */
+static ULONG arp_cache_memory[ARP_CACHE_SIZE / sizeof(ULONG)];
 
 TX_EVENT_FLAGS_GROUP mqtt_app_flag;
 
-/* Declare buffers to hold message and topic. */
+/* Counts the PUBACKs received and not yet retired from the publish store. */
+static TX_SEMAPHORE mqtt_publish_acks;
+
+/* The start of the network, the DHCP client and the supervision of the link run as items of one
+   work queue, in place of a main thread and a link thread that spent their life waiting. */
+static WORK_QUEUE app_work_queue;
+static WORK_ITEM app_start_item;
+static WORK_ITEM link_wait_item;
+static WORK_ITEM link_check_item;
+static WORK_ITEM address_bound_item;
+#ifndef GATEWAY_DHCP_SERVER
+static WORK_ITEM dhcp_timeout_item;
+#endif
+static WORK_ITEM housekeeping_item;
+#if defined(TX_EXECUTION_PROFILE_ENABLE) || defined(POOL_MAP) || defined(TX_IRQ_OFF_TRACE)
+static WORK_ITEM profile_report_item;
+#endif
+
+/* Time the wait for the link started at, and the state of the link as last checked. */
+static ULONG link_wait_start;
+static UINT link_down = NX_FALSE;
+static UINT address_bound = NX_FALSE;
+
+/* Packet ID index of the messages waiting for their ACK. */
+static NXD_MQTT_INFLIGHT_ENTRY mqtt_inflight_table[MQTT_INFLIGHT_TABLE_SIZE] CCMRAM_BSS;
+static NXD_MQTT_QOS2_ENTRY mqtt_qos2_table[MQTT_QOS2_TABLE_SIZE] CCMRAM_BSS;
+
+/* Nodes of the topic filters with their own callback. */
+static NXD_MQTT_TOPIC_NODE mqtt_topic_nodes[MQTT_TOPIC_NODES] CCMRAM_BSS;
+
+/* Topics subscribed at each connection not resumed, in one SUBSCRIBE. Their SUBACK sets the reason codes. */
+static NXD_MQTT_TOPIC_FILTER mqtt_topic_filters[] =
+{
+  {TOPIC_NAME, STRLEN(TOPIC_NAME), QOS0, 0U, 0U, 0U},
+#ifdef OTA_UPDATE
+  /* The chunks of an image are all needed, with QoS level 1 those lost with a connection are sent again. */
+  {OTA_TOPIC_NAME, STRLEN(OTA_TOPIC_NAME), QOS1, 0U, 0U, 0U},
+#endif
+};
+#define MQTT_TOPIC_FILTER_COUNT (sizeof(mqtt_topic_filters) / sizeof(mqtt_topic_filters[0]))
+
+/* Last message received on each topic, the retained ones included. */
+static ULONG mqtt_last_value_cache[MQTT_LAST_VALUE_ENTRIES * MQTT_LAST_VALUE_ENTRY_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Messages enqueued from interrupts and the threads above the MQTT thread, published by its event processing. */
+static ULONG mqtt_publish_ring[MQTT_PUBLISH_SLOTS * MQTT_PUBLISH_SLOT_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* CONNECT packet encoded for the first connection, sent as it is by the reconnections. */
+static UCHAR mqtt_connect_cache[MQTT_CONNECT_CACHE_SIZE] CCMRAM_BSS;
+
+/* Header and topic of the stored messages, encoded once for all their PUBLISH packets. */
+static NXD_MQTT_PREPARED_TOPIC mqtt_store_topic;
+
+/* Declare buffer to hold the published message. */
 static char message[NXD_MQTT_MAX_MESSAGE_LENGTH];
-static UCHAR message_buffer[NXD_MQTT_MAX_MESSAGE_LENGTH];
-static UCHAR topic_buffer[NXD_MQTT_MAX_TOPIC_NAME_LENGTH];
+
+#ifdef PAYLOAD_COMPRESS
+/* Payload of a message compressed, before it is copied into its record. */
+static UCHAR mqtt_compressed_payload[PUBLISH_STORE_MESSAGE_MAX] CCMRAM_BSS;
+#endif
+
+#ifdef MQTT_BACKUP_BROKER_NAME
+/* Client of the backup broker, connected by the MQTT manager, which serves both clients from its thread. */
+static NXD_MQTT_CLIENT mqtt_backup_client;
+static MQTT_MANAGER_CONNECTION mqtt_primary_connection;
+static MQTT_MANAGER_CONNECTION mqtt_backup_connection;
+#endif
+
+/* Client the messages of the store go out through: the backup one with MQTT_BACKUP_STANDBY, while the primary
+   broker is out of reach. */
+static NXD_MQTT_CLIENT *mqtt_publish_client = &mqtt_client;
 
 /* TLS buffers and certificate containers. */
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+extern const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers_ecc;
+extern const USHORT nx_crypto_ecc_supported_groups[];
+extern const NX_CRYPTO_METHOD *nx_crypto_ecc_curves[];
+extern const UINT nx_crypto_ecc_supported_groups_size;
+#else
 extern const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers;
-/* calculated with nx_secure_tls_metadata_size_calculate */
-static CHAR crypto_metadata_client[CRYPTO_METADATA_CLIENT_SIZE];
-/* Define the TLS packet reassembly buffer. */
-UCHAR tls_packet_buffer[TLS_PACKET_BUFFER_SIZE];
+#endif
+/* Crypto metadata and packet reassembly buffers of the TLS sessions open at the same time.
+   Each session takes one block from the arena and returns it when deleted. */
+static NX_SECURE_TLS_ARENA tls_arena;
+static ULONG tls_arena_memory[TLS_ARENA_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+#ifndef NX_SECURE_DISABLE_X509
+/* DER of the trusted CA certificates, in flash. Add the CA of each other broker here. */
+static const UCHAR *const trusted_ca_der[] = {mosquitto_org_der};
+static const USHORT trusted_ca_der_length[] = {sizeof(mosquitto_org_der)};
+#define TRUSTED_CA_COUNT (sizeof(trusted_ca_der) / sizeof(trusted_ca_der[0]))
+
+/* Trusted CA certificates, parsed once at startup. Their fields point into the DER,
+   so each connection only adds them to the trusted store of its new TLS session. */
+static NX_SECURE_X509_CERT trusted_ca_certificates[TRUSTED_CA_COUNT] CCMRAM_BSS;
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#ifdef MQTT_BACKUP_STANDBY
+/* The messages one broker did not acknowledge are sent to the other one from the store, the session of the
+   primary broker keeps none of them for its next connection. */
+#define MQTT_CLEAN_SESSION          NX_TRUE
+#else
+#define MQTT_CLEAN_SESSION          CLEAN_SESSION
+#endif
 
 /* USER CODE END PD */
 
@@ -82,10 +232,41 @@ UCHAR tls_packet_buffer[TLS_PACKET_BUFFER_SIZE];
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-static VOID App_Main_Thread_Entry(ULONG thread_input);
 static VOID App_MQTT_Client_Thread_Entry(ULONG thread_input);
-static VOID App_Link_Thread_Entry(ULONG thread_input);
+static VOID app_start_work(WORK_ITEM *item);
+static VOID link_wait_work(WORK_ITEM *item);
+static VOID link_check_work(WORK_ITEM *item);
+static VOID address_bound_work(WORK_ITEM *item);
+#ifndef GATEWAY_DHCP_SERVER
+static VOID dhcp_timeout_work(WORK_ITEM *item);
+#endif
+static VOID housekeeping_work(WORK_ITEM *item);
+#if defined(TX_EXECUTION_PROFILE_ENABLE) || defined(POOL_MAP) || defined(TX_IRQ_OFF_TRACE)
+static VOID profile_report_work(WORK_ITEM *item);
+#endif
 static VOID ip_address_change_notify_callback(NX_IP *ip_instance, VOID *ptr);
+static VOID pool_watermark_notify(NX_PACKET_POOL *pool_ptr, UINT is_low);
+#ifndef NX_SECURE_DISABLE_X509
+static UINT trusted_ca_parse(VOID);
+#endif
+static UINT mqtt_message_store(const UCHAR *message_ptr, UINT length);
+static VOID mqtt_client_messages_get(NXD_MQTT_CLIENT *client_ptr, UINT *received_count);
+#ifdef MQTT_PAYLOAD_CBOR
+static UINT mqtt_readings_encode(UINT *message_length);
+#elif !defined(SENSOR_SAMPLING)
+static UINT mqtt_reading_take(uint32_t *reading);
+#endif
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+static UINT mqtt_client_resume_slot(NXD_MQTT_CLIENT *client_pt);
+#endif
+#ifdef MQTT_BACKUP_BROKER_NAME
+static UINT mqtt_backup_start(VOID);
+static VOID mqtt_backup_stop(VOID);
+static VOID mqtt_backup_connected(NXD_MQTT_CLIENT *client_ptr);
+#endif
+#ifdef MQTT_BACKUP_STANDBY
+static UINT mqtt_standby_failover(VOID);
+#endif
 /* USER CODE END PFP */
 /**
   * @brief  Application NetXDuo Initialization.
@@ -98,36 +279,99 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   TX_BYTE_POOL *byte_pool = (TX_BYTE_POOL*)memory_ptr;
 
   /* USER CODE BEGIN MX_NetXDuo_MEM_POOL */
+  /* All the memory is static, see the static memory configuration of app_netxduo.h */
+  (void)byte_pool;
+
+#ifdef THREAD_METRIC
+  /* The kernel benchmark runs alone, without the network and its interrupts */
+  return ret;
+#endif
   /* USER CODE END MX_NetXDuo_MEM_POOL */
 
   /* USER CODE BEGIN MX_NetXDuo_Init */
   printf("Nx_MQTT_Client application started..\n");
 
-  CHAR *pointer;
+  /* Start the cycle counter of the hot path profiling, if enabled in nx_user.h. */
+  cycle_profile_init();
+
+  /* Start collecting the random numbers of NX_RAND before TLS needs them. */
+  rng_pool_init();
 
-  /* Allocate the memory for packet_pool.  */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer,  NX_PACKET_POOL_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  /* The large packet copies go to DMA2 from now on, memcpy() does them until then. */
+  ret = dma_copy_init();
+  if (ret != TX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  /* The CRC unit checks the records of the store, the lease, the sessions and the update chunks. */
+  ret = crc_service_init();
+  if (ret != TX_SUCCESS)
   {
-    return TX_POOL_ERROR;
+    return NX_NOT_ENABLED;
   }
 
   /* Create the Packet pool to be used for packet allocation */
-  ret = nx_packet_pool_create(&AppPool, "Main Packet Pool", PAYLOAD_SIZE, pointer, NX_PACKET_POOL_SIZE);
+  ret = nx_packet_pool_create(&AppPool, "Main Packet Pool", PAYLOAD_SIZE, packet_pool_memory, sizeof(packet_pool_memory));
+
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  /* Create the small packet pool used by the stack for ACKs, ARP and other control packets */
+  ret = nx_packet_pool_create(&AuxPool, "Auxiliary Packet Pool", AUX_PAYLOAD_SIZE, aux_packet_pool_memory,
+                              sizeof(aux_packet_pool_memory));
+
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  /* Create the medium packet pool used for MQTT control and short publish messages */
+  ret = nx_packet_pool_create(&MediumPool, "Medium Packet Pool", MEDIUM_PAYLOAD_SIZE, medium_packet_pool_memory,
+                              sizeof(medium_packet_pool_memory));
+
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  /* Create the pool reserved to the TLS handshake messages and alerts, out of the size classes, so that
+     a handshake or a close_notify does not wait for the packets the MQTT messages hold */
+  ret = nx_packet_pool_create(&TlsControlPool, "TLS Control Packet Pool", TLS_CONTROL_PAYLOAD_SIZE,
+                              tls_control_packet_pool_memory, sizeof(tls_control_packet_pool_memory));
 
   if (ret != NX_SUCCESS)
   {
     return NX_NOT_ENABLED;
   }
 
- /* Allocate the memory for Ip_Instance */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, 2 * DEFAULT_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  /* Link the pools into size classes, smallest first, so nx_packet_size_allocate
+     only takes a full MTU buffer from the main pool when the payload needs it */
+  ret = nx_packet_pool_class_set(&AuxPool, &MediumPool);
+
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_packet_pool_class_set(&MediumPool, &AppPool);
+  }
+
+  if (ret != NX_SUCCESS)
   {
-    return TX_POOL_ERROR;
+    return NX_NOT_ENABLED;
   }
 
-  /* Create the main NX_IP instance */
+  /* Create the main NX_IP instance, its thread stack is in CCM-RAM */
   ret = nx_ip_create(&IpInstance, "Main Ip instance", NULL_ADDRESS, NULL_ADDRESS, &AppPool, nx_stm32_eth_driver,
-                     pointer, 2 * DEFAULT_MEMORY_SIZE, DEFAULT_MAIN_PRIORITY);
+                     ip_thread_stack, sizeof(ip_thread_stack), DEFAULT_MAIN_PRIORITY);
+
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  /* Keep the main packet pool for data, small packets come from the auxiliary pool */
+  ret = nx_ip_auxiliary_packet_pool_set(&IpInstance, &AuxPool);
 
   if (ret != NX_SUCCESS)
   {
@@ -142,22 +386,36 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
     return NX_NOT_ENABLED;
   }
 
-  /* Allocate the memory for ARP */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, DEFAULT_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  /* Keep its lease in the backup SRAM for the next start */
+  ret = dhcp_lease_init(&DHCPClient);
+
+  if (ret != NX_SUCCESS)
   {
-    return TX_POOL_ERROR;
+    return NX_NOT_ENABLED;
   }
 
   /* Enable the ARP protocol and provide the ARP cache size for the IP instance */
-  ret = nx_arp_enable(&IpInstance, (VOID *)pointer,  DEFAULT_MEMORY_SIZE);
+  ret = nx_arp_enable(&IpInstance, (VOID *)arp_cache_memory, sizeof(arp_cache_memory));
 
   if (ret != NX_SUCCESS)
   {
     return NX_NOT_ENABLED;
   }
 
+#ifdef MQTT_DUAL_STACK
+  /* Enable IPv6, and ICMP for both families, ICMPv6 carries the neighbor discovery */
+  ret = nxd_ipv6_enable(&IpInstance);
+
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+
+  ret = nxd_icmp_enable(&IpInstance);
+#else
   /* Enable the ICMP */
   ret = nx_icmp_enable(&IpInstance);
+#endif
 
   if (ret != NX_SUCCESS)
   {
@@ -180,29 +438,18 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
     return NX_NOT_ENABLED;
   }
 
-  /* Allocate the memory for main thread   */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, THREAD_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
-  {
-    return TX_POOL_ERROR;
-  }
-
-  /* Create the main thread */
-  ret = tx_thread_create(&AppMainThread, "App Main thread", App_Main_Thread_Entry, 0, pointer, THREAD_MEMORY_SIZE,
-                         DEFAULT_MAIN_PRIORITY, DEFAULT_MAIN_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+  /* Create the work queue of the start, DHCP and link items, its stack is in CCM-RAM */
+  ret = work_queue_create(&app_work_queue, "App Work Queue", work_queue_stack, sizeof(work_queue_stack),
+                          WORK_QUEUE_PRIORITY);
 
   if (ret != TX_SUCCESS)
   {
     return NX_NOT_ENABLED;
   }
 
-  /* Allocate the memory for MQTT client thread   */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, THREAD_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
-  {
-    return TX_POOL_ERROR;
-  }
-
-  /* create the MQTT client thread */
-  ret = tx_thread_create(&AppMQTTClientThread, "App MQTT Thread", App_MQTT_Client_Thread_Entry, 0, pointer, THREAD_MEMORY_SIZE,
+  /* create the MQTT client thread, its stack is in CCM-RAM */
+  ret = tx_thread_create(&AppMQTTClientThread, "App MQTT Thread", App_MQTT_Client_Thread_Entry, 0,
+                         mqtt_app_thread_stack, sizeof(mqtt_app_thread_stack),
                          DEFAULT_PRIORITY, DEFAULT_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START);
 
   if (ret != TX_SUCCESS)
@@ -210,25 +457,52 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
     return NX_NOT_ENABLED;
   }
 
-  /* Allocate the memory for Link thread   */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer,2 *  DEFAULT_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  /* Create the MQTT flag before the link items report on it */
+  tx_event_flags_create(&mqtt_app_flag, "my app event");
+
+  /* Pause the publishing before the pools the MQTT and TLS records come from run dry, the RX
+     descriptors are refilled from the pool of the driver and are not paused */
+  ret = nx_packet_pool_watermark_notify(&AppPool, MQTT_POOL_LOW_WATERMARK, MQTT_POOL_HIGH_WATERMARK,
+                                        pool_watermark_notify);
+
+  if (ret == NX_SUCCESS)
   {
-    return TX_POOL_ERROR;
+    ret = nx_packet_pool_watermark_notify(&MediumPool, MQTT_POOL_LOW_WATERMARK, MQTT_POOL_HIGH_WATERMARK,
+                                          pool_watermark_notify);
   }
 
-  /* create the Link thread */
-  ret = tx_thread_create(&AppLinkThread, "App Link Thread", App_Link_Thread_Entry, 0, pointer, 2 * DEFAULT_MEMORY_SIZE,
-                         LINK_PRIORITY, LINK_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
-
-  if (ret != TX_SUCCESS)
+  /* Without NX_ENABLE_LOW_WATERMARK the publishing is never paused */
+  if ((ret != NX_SUCCESS) && (ret != NX_NOT_SUPPORTED))
   {
     return NX_NOT_ENABLED;
   }
 
+  /* The start item runs first, the periodic ones from now on. */
+  work_item_init(&app_start_item, app_start_work, NX_NULL);
+  work_item_init(&link_wait_item, link_wait_work, NX_NULL);
+  work_item_init(&link_check_item, link_check_work, NX_NULL);
+  work_item_init(&address_bound_item, address_bound_work, NX_NULL);
+#ifndef GATEWAY_DHCP_SERVER
+  work_item_init(&dhcp_timeout_item, dhcp_timeout_work, NX_NULL);
+#endif
+  work_item_init(&housekeeping_item, housekeeping_work, NX_NULL);
+  work_item_submit(&app_work_queue, &app_start_item);
+  work_item_schedule(&app_work_queue, &housekeeping_item, DHCP_LEASE_SAVE_PERIOD, DHCP_LEASE_SAVE_PERIOD);
+#if defined(TX_EXECUTION_PROFILE_ENABLE) || defined(POOL_MAP) || defined(TX_IRQ_OFF_TRACE)
+  work_item_init(&profile_report_item, profile_report_work, NX_NULL);
+  work_item_schedule(&app_work_queue, &profile_report_item, THREAD_PROFILE_REPORT_PERIOD,
+                     THREAD_PROFILE_REPORT_PERIOD);
+#endif
+
+  /* Create the arena of the TLS sessions */
+  ret = nx_secure_tls_arena_create(&tls_arena, "TLS Arena", tls_arena_memory, sizeof(tls_arena_memory));
 
-  /* set DHCP notification callback  */
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
 
-  tx_semaphore_create(&Semaphore, "DHCP Semaphore", 0);
+  boot_profile_mark(BOOT_PROFILE_NETX);
   /* USER CODE END MX_NetXDuo_Init */
 
   return ret;
@@ -236,6 +510,28 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
 
 /* USER CODE BEGIN 1 */
 
+/**
+* @brief  Watermark callback of the main and medium pools, from the context that took or gave back the packet.
+* @param  pool_ptr: pool that crossed a watermark
+* @param  is_low: NX_TRUE at the low watermark, NX_FALSE back at the high one
+* @retval none
+*/
+static VOID pool_watermark_notify(NX_PACKET_POOL *pool_ptr, UINT is_low)
+{
+  ULONG flag = (pool_ptr == &AppPool) ? DEMO_APP_POOL_LOW_EVENT : DEMO_MEDIUM_POOL_LOW_EVENT;
+
+  /* The flags are the state of the pools, the publisher reads them without clearing them. */
+  if (is_low)
+  {
+    tx_event_flags_set(&mqtt_app_flag, flag, TX_OR);
+  }
+  else
+  {
+    tx_event_flags_set(&mqtt_app_flag, ~flag, TX_AND);
+    tx_event_flags_set(&mqtt_app_flag, DEMO_POOL_RESUME_EVENT, TX_OR);
+  }
+}
+
 /**
 * @brief  ip address change callback.
 * @param ip_instance: NX_IP instance
@@ -244,61 +540,196 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
 */
 static VOID ip_address_change_notify_callback(NX_IP *ip_instance, VOID *ptr)
 {
-  /* release the semaphore as soon as an IP address is available */
-  tx_semaphore_put(&Semaphore);
+  /* report the address from the work queue as soon as one is available */
+  work_item_submit(&app_work_queue, &address_bound_item);
+
+  /* an offline MQTT client can reconnect right away */
+  tx_event_flags_set(&mqtt_app_flag, DEMO_LINK_UP_EVENT, TX_OR);
 }
 
 /**
-* @brief  Main thread entry.
-* @param thread_input: ULONG user argument used by the thread entry
+* @brief  Start work item, in place of the main thread: the crypto, the MQTT client thread, and the address,
+*         the static one of the gateway or the DHCP client once the link is up.
+* @param  item: work item
 * @retval none
 */
-static VOID App_Main_Thread_Entry(ULONG thread_input)
+static VOID app_start_work(WORK_ITEM *item)
 {
   UINT ret = NX_SUCCESS;
 
+  NX_PARAMETER_NOT_USED(item);
+
+#ifdef NX_CRYPTO_STM32_HW
+  /* Start the CRYP and HASH peripherals for the methods of the TLS tables. A part without them,
+     an STM32F429 running this build, keeps the software methods. */
+  if (nx_stm32_crypto_initialize() != NX_CRYPTO_SUCCESS)
+  {
+    printf("No CRYP and HASH peripherals, the crypto runs in software\n");
+  }
+#endif
+
+#ifdef PERF_HARNESS
+  /* The suites that need no address first, the kernel one with the work of the queue held. */
+  perf_harness_start();
+  perf_harness_suite_end("crypto", crypto_benchmark_run());
+  perf_harness_suite_end("rtos", thread_metric_run());
+#elif defined(CRYPTO_BENCHMARK)
+  /* Measure the crypto primitives in place of the demo, before the network adds its interrupts. */
+  if (crypto_benchmark_run() != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+  Success_Handler();
+#endif
+
   ret = nx_ip_address_change_notify(&IpInstance, ip_address_change_notify_callback, NULL);
   if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
 
-  /* start DHCP client */
-  ret = nx_dhcp_start(&DHCPClient);
+#ifdef GATEWAY_DHCP_SERVER
+  /* take the static address of the gateway and serve the sensors of the segment */
+  ret = dhcp_gateway_start(&IpInstance, &AppPool);
   if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
+
+  /* start the MQTT client thread, it sets up its store, certificates and DNS client meanwhile
+     and waits for the address before connecting */
+  tx_thread_resume(&AppMQTTClientThread);
+
+  /* the PHY negotiates the link after the reset, the first DHCP message must not be lost before it */
+  link_wait_start = tx_time_get();
+  work_item_submit(&app_work_queue, &link_wait_item);
+}
+
+/**
+* @brief  Link wait work item: checks the link every LINK_WAIT_POLL until it is up or DHCP_LEASE_LINK_WAIT
+*         passed, then starts the DHCP client and the supervision of the link.
+* @param  item: work item
+* @retval none
+*/
+static VOID link_wait_work(WORK_ITEM *item)
+{
+  ULONG link_status;
+#ifndef GATEWAY_DHCP_SERVER
+  UINT ret;
+#endif
+
+  if (nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED, &link_status, NX_NO_WAIT) == NX_SUCCESS)
+  {
+    boot_profile_mark(BOOT_PROFILE_LINK_UP);
+  }
+  else if ((tx_time_get() - link_wait_start) < DHCP_LEASE_LINK_WAIT)
+  {
+    work_item_schedule(&app_work_queue, item, LINK_WAIT_POLL, 0);
+    return;
+  }
 
-  /* wait until an IP address is ready */
-  if(tx_semaphore_get(&Semaphore, TX_WAIT_FOREVER) != TX_SUCCESS)
+#ifndef GATEWAY_DHCP_SERVER
+#ifdef MQTT_DUAL_STACK
+  /* the link local address from the MAC, the global one follows from the router advertisements */
+  if (nxd_ipv6_address_set(&IpInstance, 0, NX_NULL, 10, NX_NULL) != NX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
 
-  ret = nx_ip_address_get(&IpInstance, &IpAddress, &NetMask);
+  /* request the address of the last lease first, a single request and its ACK, and discover
+     a new one if no ACK comes in time */
+  if (dhcp_lease_request(&DHCPClient) == NX_SUCCESS)
+  {
+    work_item_schedule(&app_work_queue, &dhcp_timeout_item, DHCP_LEASE_REBOOT_WAIT, 0);
+  }
 
-  if (ret != TX_SUCCESS)
+  /* start DHCP client */
+  ret = nx_dhcp_start(&DHCPClient);
+  if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
+#endif /* GATEWAY_DHCP_SERVER */
+
+  /* The first link up is no reconnection to report, the link is supervised from now on: on each
+     change the PHY interrupts on, or every NX_ETH_CABLE_CONNECTION_CHECK_PERIOD. */
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+  work_item_submit(&app_work_queue, &link_check_item);
+#else
+  work_item_schedule(&app_work_queue, &link_check_item, NX_ETH_CABLE_CONNECTION_CHECK_PERIOD,
+                     NX_ETH_CABLE_CONNECTION_CHECK_PERIOD);
+#endif
+}
+
+/**
+* @brief  Address bound work item, submitted by the address change notify: reports the first address.
+* @param  item: work item
+* @retval none
+*/
+static VOID address_bound_work(WORK_ITEM *item)
+{
+  NX_PARAMETER_NOT_USED(item);
+
+  /* the notify also tells of an address lost, and of the ones after the first */
+  if (address_bound || (nx_ip_address_get(&IpInstance, &IpAddress, &NetMask) != NX_SUCCESS) || (IpAddress == 0))
+  {
+    return;
+  }
+
+  address_bound = NX_TRUE;
+
+  boot_profile_mark(BOOT_PROFILE_DHCP);
 
  PRINT_IP_ADDRESS(IpAddress);
 
-  /* start the MQTT client thread */
-  tx_thread_resume(&AppMQTTClientThread);
+#ifndef GATEWAY_DHCP_SERVER
+  work_item_cancel(&app_work_queue, &dhcp_timeout_item);
 
-  /* this thread is not needed any more, we relinquish it */
-  tx_thread_relinquish();
+  /* keep the lease for the next start */
+  dhcp_lease_save(&DHCPClient);
+#endif
+}
 
-  return;
+#ifndef GATEWAY_DHCP_SERVER
+/**
+* @brief  DHCP timeout work item: no server acknowledged the last lease within DHCP_LEASE_REBOOT_WAIT.
+* @param  item: work item
+* @retval none
+*/
+static VOID dhcp_timeout_work(WORK_ITEM *item)
+{
+  ULONG address;
+  ULONG mask;
+
+  NX_PARAMETER_NOT_USED(item);
+
+  /* the ACK may have come just before, the address bound item is then queued behind this one */
+  if ((nx_ip_address_get(&IpInstance, &address, &mask) == NX_SUCCESS) && (address != 0))
+  {
+    return;
+  }
+
+  /* discover a new lease, with no time limit */
+  printf("The last DHCP lease is not acknowledged, discovering a new one\n");
+  dhcp_lease_clear();
+  nx_dhcp_stop(&DHCPClient);
+  nx_dhcp_reinitialize(&DHCPClient);
+
+  if (nx_dhcp_start(&DHCPClient) != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
 }
+#endif /* GATEWAY_DHCP_SERVER */
 
 /* Declare the disconnect notify function. */
 static VOID my_disconnect_func(NXD_MQTT_CLIENT *client_ptr)
 {
   NX_PARAMETER_NOT_USED(client_ptr);
   printf("client disconnected from broker < %s >.\n", MQTT_BROKER_NAME);
+  tx_event_flags_set(&mqtt_app_flag, DEMO_DISCONNECT_EVENT, TX_OR);
 }
 
 /* Declare the notify function. */
@@ -310,6 +741,147 @@ static VOID my_notify_func(NXD_MQTT_CLIENT* client_ptr, UINT number_of_messages)
   return;
 }
 
+/* Declare the ACK notify function, a PUBACK, or the PUBCOMP of a QoS 2 message, acknowledges the oldest message
+   of the publish store. */
+static VOID my_ack_notify_func(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                               NX_PACKET *transmit_packet_ptr, VOID *context)
+{
+  NX_PARAMETER_NOT_USED(client_ptr);
+  NX_PARAMETER_NOT_USED(packet_id);
+  NX_PARAMETER_NOT_USED(transmit_packet_ptr);
+
+  if ((type == MQTT_CONTROL_PACKET_TYPE_PUBACK) || (type == MQTT_CONTROL_PACKET_TYPE_PUBCOMP))
+  {
+    tx_semaphore_put((TX_SEMAPHORE *)context);
+  }
+}
+
+/**
+* @brief  Print a received message. The binary log records keep its lengths only, not its text.
+* @param  received_count: number of the message
+* @param  packet_ptr: received packet
+* @param  topic_offset: offset of the topic in the packet
+* @param  topic_length: length of the topic
+* @param  message_offset: offset of the message in the packet
+* @param  message_length: length of the message
+* @retval None
+*/
+static VOID mqtt_received_message_print(UINT received_count, NX_PACKET *packet_ptr,
+                                        ULONG topic_offset, UINT topic_length,
+                                        ULONG message_offset, ULONG message_length)
+{
+#if !defined(LOG_BINARY_ENABLE) && !defined(MQTT_PAYLOAD_CBOR)
+  if (packet_ptr -> nx_packet_next == NX_NULL)
+  {
+    printf("Message %d received: TOPIC = %.*s, MESSAGE = %.*s\n", received_count,
+           (int)topic_length, (char *)(packet_ptr -> nx_packet_prepend_ptr + topic_offset),
+           (int)message_length, (char *)(packet_ptr -> nx_packet_prepend_ptr + message_offset));
+    return;
+  }
+#else
+  NX_PARAMETER_NOT_USED(packet_ptr);
+  NX_PARAMETER_NOT_USED(topic_offset);
+  NX_PARAMETER_NOT_USED(message_offset);
+#endif
+
+  /* chained packet, the message is not contiguous, or binary */
+  LOG_PRINTF("Message %d received: TOPIC length = %u, MESSAGE length = %lu\n", received_count,
+             topic_length, message_length);
+}
+
+/**
+* @brief  Topic callback, called from the MQTT client events processing for each TOPIC_NAME message.
+* @param  packet_ptr: received packet, valid during the call only
+* @param  context: number of messages received so far, updated
+* @retval None
+*/
+static VOID mqtt_topic_callback(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                ULONG topic_offset, UINT topic_length,
+                                ULONG message_offset, ULONG message_length, VOID *context)
+{
+  UINT *received_count = (UINT *)context;
+
+  NX_PARAMETER_NOT_USED(client_ptr);
+
+  *received_count += 1;
+  DEVICE_STATS_ADD(DEVICE_STATS_MQTT_RECEIVED, 1U);
+
+  mqtt_received_message_print(*received_count, packet_ptr, topic_offset, topic_length,
+                              message_offset, message_length);
+}
+
+/**
+* @brief  Get all the messages received from the brokers without waiting.
+* @param  received_count: number of messages received so far, updated
+* @retval None
+*/
+static VOID mqtt_received_messages_drain(UINT *received_count)
+{
+  ULONG events;
+
+  if (tx_event_flags_get(&mqtt_app_flag, DEMO_MESSAGE_EVENT, TX_OR_CLEAR, &events, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return;
+  }
+
+  /* check event received */
+  if(events & DEMO_MESSAGE_EVENT)
+  {
+    mqtt_client_messages_get(&mqtt_client, received_count);
+#ifdef MQTT_BACKUP_STANDBY
+    /* The subscriptions of the standby client get their messages too, they are not left in its queue. */
+    mqtt_client_messages_get(&mqtt_backup_client, received_count);
+#endif
+  }
+}
+
+/**
+* @brief  Get the messages received by a client, read in place from the received packets.
+* @param  client_ptr: client the messages are taken from
+* @param  received_count: number of messages received so far, updated
+* @retval None
+*/
+static VOID mqtt_client_messages_get(NXD_MQTT_CLIENT *client_ptr, UINT *received_count)
+{
+  NX_PACKET *packet_ptr;
+  ULONG topic_offset, message_offset, message_length;
+  UINT topic_length;
+#ifdef OTA_UPDATE
+  UCHAR topic[STRLEN(OTA_TOPIC_NAME)];
+  ULONG bytes_copied;
+  UINT ret;
+#endif
+
+  while (nxd_mqtt_client_message_packet_get(client_ptr, &packet_ptr, &topic_offset, &topic_length,
+                                            &message_offset, &message_length) == NXD_MQTT_SUCCESS)
+  {
+#ifdef OTA_UPDATE
+    /* The chunks of an image are programmed from the packet, this thread owns the flash with the store. */
+    if ((topic_length == STRLEN(OTA_TOPIC_NAME)) &&
+        (nx_packet_data_extract_offset(packet_ptr, topic_offset, topic, sizeof(topic), &bytes_copied) == NX_SUCCESS) &&
+        (memcmp(topic, OTA_TOPIC_NAME, sizeof(topic)) == 0))
+    {
+      ret = ota_update_message(packet_ptr, message_offset, message_length);
+      if (ret != OTA_UPDATE_SUCCESS)
+      {
+        printf("OTA update message failed: %u\n", ret);
+      }
+
+      nxd_mqtt_client_message_packet_release(client_ptr, packet_ptr);
+      continue;
+    }
+#endif
+
+    *received_count += 1;
+    DEVICE_STATS_ADD(DEVICE_STATS_MQTT_RECEIVED, 1U);
+
+    mqtt_received_message_print(*received_count, packet_ptr, topic_offset, topic_length,
+                                message_offset, message_length);
+
+    nxd_mqtt_client_message_packet_release(client_ptr, packet_ptr);
+  }
+}
+
 /**
 * @brief  DNS Create Function.
 * @param dns_ptr
@@ -318,6 +890,7 @@ static VOID my_notify_func(NXD_MQTT_CLIENT* client_ptr, UINT number_of_messages)
 UINT dns_create(NX_DNS *dns_ptr)
 {
   UINT ret = NX_SUCCESS;
+  ULONG lease_dns_address;
 
   /* Create a DNS instance for the Client */
   ret = nx_dns_create(dns_ptr, &IpInstance, (UCHAR *)"DNS Client");
@@ -325,6 +898,18 @@ UINT dns_create(NX_DNS *dns_ptr)
   {
     Error_Handler();
   }
+  /* Ask the server of the last DHCP lease first, until the resolver ranks the servers of the next ACK */
+  lease_dns_address = dhcp_lease_dns_server();
+  if ((lease_dns_address != 0) && (lease_dns_address != USER_DNS_ADDRESS) &&
+      (lease_dns_address != USER_DNS_ADDRESS_SECONDARY))
+  {
+    ret = nx_dns_server_add(dns_ptr, lease_dns_address);
+    if (ret)
+    {
+      Error_Handler();
+    }
+  }
+
   /* Initialize DNS instance with a dummy server */
   ret = nx_dns_server_add(dns_ptr, USER_DNS_ADDRESS);
   if (ret)
@@ -332,6 +917,27 @@ UINT dns_create(NX_DNS *dns_ptr)
     Error_Handler();
   }
 
+  /* Asked when the first server does not answer */
+  ret = nx_dns_server_add(dns_ptr, USER_DNS_ADDRESS_SECONDARY);
+  if (ret)
+  {
+    Error_Handler();
+  }
+
+  /* Resolve the broker again on reconnection from the cache, until the answer expires */
+  ret = nx_dns_cache_initialize(dns_ptr, dns_cache, sizeof(dns_cache));
+  if (ret)
+  {
+    Error_Handler();
+  }
+
+  /* Keep the addresses past their time to live, refreshed in the background */
+  ret = dns_resolver_start(dns_ptr);
+  if (ret)
+  {
+    Error_Handler();
+  }
+
   return ret;
 }
 
@@ -342,16 +948,82 @@ UINT dns_create(NX_DNS *dns_ptr)
 */
 void message_generate(uint32_t *RandomNbr)
 {
-  HAL_RNG_Init(&hrng);
+  /* take a random number from the pool filled by the RNG interrupt */
+  *RandomNbr = rng_pool_get() % 100;
+}
+
+#ifdef MQTT_PAYLOAD_CBOR
+/**
+* @brief  Take MQTT_PAYLOAD_READINGS readings and encode them into the message, as a CBOR array of the
+*         time of the first one, in ticks, and of the deltas of the readings, the first one from 0.
+* @param  message_length: length of the message encoded
+* @retval CBOR_WRITER_SUCCESS or CBOR_WRITER_OVERFLOW
+*/
+static UINT mqtt_readings_encode(UINT *message_length)
+{
+  CBOR_WRITER writer;
+  uint32_t reading;
+  uint32_t previous = 0;
+  UINT i;
+
+  cbor_writer_init(&writer, (UCHAR *)message, sizeof(message));
+  cbor_encode_array(&writer, MQTT_PAYLOAD_READINGS + 1);
+  cbor_encode_uint(&writer, tx_time_get());
+
+  /* A delta of -24 to 23 takes one byte. */
+  for (i = 0; i < MQTT_PAYLOAD_READINGS; i++)
+  {
+    message_generate(&reading);
+    cbor_encode_int(&writer, (LONG)reading - (LONG)previous);
+    previous = reading;
+  }
+
+  return cbor_writer_finish(&writer, message_length);
+}
+#elif !defined(SENSOR_SAMPLING)
+/**
+* @brief  Take a reading, and with REPORT_FILTER tell whether it is worth a message.
+* @param  reading: reading taken
+* @retval NX_TRUE if the reading is to be published
+*/
+static UINT mqtt_reading_take(uint32_t *reading)
+{
+  message_generate(reading);
 
-  /* generate a random number */
-  if(HAL_RNG_GenerateRandomNumber(&hrng, RandomNbr) != HAL_OK)
+#ifdef REPORT_FILTER
+  if (report_filter_check(REPORT_CHANNEL_READING, (LONG)*reading) != REPORT_FILTER_SEND)
   {
-    Error_Handler();
+    /* Readings are taken at a pace meanwhile, not back to back. */
+    tx_thread_sleep(REPORT_SAMPLE_INTERVAL);
+    return NX_FALSE;
+  }
+#endif
+
+  return NX_TRUE;
+}
+#endif
+
+#ifndef NX_SECURE_DISABLE_X509
+/**
+* @brief  Parse the trusted CA certificates, once for all the connections.
+* @param  None
+* @retval NX_SUCCESS or the error of the first certificate that does not parse
+*/
+static UINT trusted_ca_parse(VOID)
+{
+  UINT ret = NX_SUCCESS;
+  UINT i;
+
+  for (i = 0; (i < TRUSTED_CA_COUNT) && (ret == NX_SUCCESS); i++)
+  {
+    ret = nx_secure_x509_certificate_initialize(&trusted_ca_certificates[i], (UCHAR *)trusted_ca_der[i],
+                                                trusted_ca_der_length[i], NX_NULL, 0, NULL, 0,
+                                                NX_SECURE_X509_KEY_TYPE_NONE);
   }
 
-  *RandomNbr %= 100;
+  return ret;
 }
+#endif /* NX_SECURE_DISABLE_X509 */
 
 /* Callback to setup TLS parameters for secure MQTT connection. */
 UINT tls_setup_callback(NXD_MQTT_CLIENT *client_pt,
@@ -360,57 +1032,451 @@ UINT tls_setup_callback(NXD_MQTT_CLIENT *client_pt,
                         NX_SECURE_X509_CERT *trusted_certificate_ptr)
 {
   UINT ret = NX_SUCCESS;
+#ifndef NX_SECURE_DISABLE_X509
+  UINT i;
+#endif
   NX_PARAMETER_NOT_USED(client_pt);
+  NX_PARAMETER_NOT_USED(certificate_ptr);
+  NX_PARAMETER_NOT_USED(trusted_certificate_ptr);
+
+#ifdef NXD_MQTT_TLS_SESSION_KEEP
+  /* The session of a previous connection was reset by the client, its ciphersuites, pools and
+     trusted store still set up */
+  if (TLS_session_ptr->nx_secure_tls_id == NX_SECURE_TLS_ID)
+  {
+    DEVICE_STATS_ADD(DEVICE_STATS_TLS_SESSIONS, 1U);
+    tls_resume_offer(mqtt_client_resume_slot(client_pt), TLS_session_ptr);
+    return NX_SUCCESS;
+  }
+#endif
 
   /* Initialize TLS module */
   nx_secure_tls_initialize();
 
-  /* Create a TLS session */
-  ret = nx_secure_tls_session_create(TLS_session_ptr, &nx_crypto_tls_ciphers,
-                                     crypto_metadata_client, sizeof(crypto_metadata_client));
+  /* Create a TLS session from the arena, with the ECDHE ciphersuites when ECC is enabled.
+     A full arena fails this connection only, the other sessions keep their blocks. */
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+  ret = nx_secure_tls_session_arena_create(TLS_session_ptr, &nx_crypto_tls_ciphers_ecc,
+                                           &tls_arena, TLS_PACKET_BUFFER_SIZE);
+#else
+  ret = nx_secure_tls_session_arena_create(TLS_session_ptr, &nx_crypto_tls_ciphers,
+                                           &tls_arena, TLS_PACKET_BUFFER_SIZE);
+#endif
   if (ret != TX_SUCCESS)
   {
-    Error_Handler();
+    DEVICE_STATS_ADD(DEVICE_STATS_TLS_SETUP_ERRORS, 1U);
+    return ret;
   }
-  /* Need to allocate space for the certificate coming in from the broker. */
-  memset((certificate_ptr), 0, sizeof(NX_SECURE_X509_CERT));
+  DEVICE_STATS_ADD(DEVICE_STATS_TLS_SESSIONS, 1U);
 
-  /* Allocate space for packet reassembly. */
-  ret = nx_secure_tls_session_packet_buffer_set(TLS_session_ptr, tls_packet_buffer,
-                                                sizeof(tls_packet_buffer));
+  /* The handshake and the alerts come from the reserved pool, the records of the messages from the pool of the IP */
+  ret = nx_secure_tls_session_control_packet_pool_set(TLS_session_ptr, &TlsControlPool);
   if (ret != TX_SUCCESS)
   {
     Error_Handler();
   }
 
-  /* allocate space for the certificate coming in from the remote host */
-  ret = nx_secure_tls_remote_certificate_allocate(TLS_session_ptr, certificate_ptr,
-                                                  tls_packet_buffer, sizeof(tls_packet_buffer));
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+  /* Offer the ECDHE ciphersuites with the curves of the crypto library, x25519 first */
+  ret = nx_secure_tls_ecc_initialize(TLS_session_ptr, nx_crypto_ecc_supported_groups,
+                                     nx_crypto_ecc_supported_groups_size, nx_crypto_ecc_curves);
   if (ret != TX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
 
-  /* initialize Certificate to verify incoming server certificates. */
-  ret = nx_secure_x509_certificate_initialize(trusted_certificate_ptr, (UCHAR*)mosquitto_org_der,
-                                              mosquitto_org_der_len, NX_NULL, 0, NULL, 0,
-                                              NX_SECURE_X509_KEY_TYPE_NONE);
-  if (ret != TX_SUCCESS)
+#ifndef NX_SECURE_DISABLE_X509
+  /* The packet buffer comes from the arena. No remote certificate is allocated: TLS keeps
+     the broker certificate at the end of this buffer, which must not be its storage too. */
+
+  /* Add the CA certificates parsed at startup to our trusted store */
+  for (i = 0; i < TRUSTED_CA_COUNT; i++)
   {
-    printf("Certificate issue..\nPlease make sure that your X509_certificate is valid. \n");
-    Error_Handler();
+    ret = nx_secure_tls_trusted_certificate_add(TLS_session_ptr, &trusted_ca_certificates[i]);
+    if (ret != TX_SUCCESS)
+    {
+      Error_Handler();
+    }
   }
+#endif /* NX_SECURE_DISABLE_X509 */
 
-  /* Add a CA Certificate to our trusted store */
-  ret = nx_secure_tls_trusted_certificate_add(TLS_session_ptr, trusted_certificate_ptr);
+#ifdef MQTT_TLS_PSK_IDENTITY
+  /* Offer the PSK ciphersuites as well, the broker picks one if it knows the identity, the
+     key is binary and its length is the one of the string literal */
+  ret = nx_secure_tls_client_psk_set(TLS_session_ptr, (UCHAR *)MQTT_TLS_PSK_KEY, sizeof(MQTT_TLS_PSK_KEY) - 1U,
+                                     (UCHAR *)MQTT_TLS_PSK_IDENTITY, STRLEN(MQTT_TLS_PSK_IDENTITY), NX_NULL, 0);
   if (ret != TX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
+
+  /* Offer the session saved by the last connection of this client, before a reset as well */
+  tls_resume_offer(mqtt_client_resume_slot(client_pt), TLS_session_ptr);
 
   return ret;
 }
 
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+/**
+* @brief  Slot of the saved TLS session of a client, the benchmark clients have none.
+* @param  client_pt: client the TLS session is set up for
+* @retval TLS_RESUME_SLOT_PRIMARY, TLS_RESUME_SLOT_BACKUP or TLS_RESUME_SLOTS for none
+*/
+static UINT mqtt_client_resume_slot(NXD_MQTT_CLIENT *client_pt)
+{
+  if (client_pt == &mqtt_client)
+  {
+    return TLS_RESUME_SLOT_PRIMARY;
+  }
+#ifdef MQTT_BACKUP_BROKER_NAME
+  if (client_pt == &mqtt_backup_client)
+  {
+    return TLS_RESUME_SLOT_BACKUP;
+  }
+#endif
+
+  return TLS_RESUME_SLOTS;
+}
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
+/**
+* @brief  Retire from the publish store the messages acknowledged by the broker.
+* @param  inflight: number of messages waiting for their PUBACK, updated
+* @retval None
+*/
+static VOID mqtt_publish_acks_retire(UINT *inflight)
+{
+  while (tx_semaphore_get(&mqtt_publish_acks, TX_NO_WAIT) == TX_SUCCESS)
+  {
+    if (publish_store_consume() == PUBLISH_STORE_SUCCESS)
+    {
+      DEVICE_STATS_ADD(DEVICE_STATS_MQTT_ACKED, 1U);
+      *inflight -= 1;
+    }
+  }
+}
+
+/**
+* @brief  Wait for a PUBACK of the broker.
+* @param  wait_option: longest wait, in ticks
+* @retval TX_SUCCESS when a PUBACK is counted
+*/
+static UINT mqtt_publish_ack_wait(ULONG wait_option)
+{
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP) && !defined(MQTT_BACKUP_BROKER_NAME)
+  /* The client has no thread, its PUBACKs are counted while this thread processes its events. */
+  if (tx_semaphore_get(&mqtt_publish_acks, TX_NO_WAIT) == TX_SUCCESS)
+  {
+    return TX_SUCCESS;
+  }
+
+  nxd_mqtt_client_events_process(&mqtt_client, wait_option);
+
+  return tx_semaphore_get(&mqtt_publish_acks, TX_NO_WAIT);
+#else
+  /* The client thread, or the thread of the MQTT manager, counts them meanwhile. */
+  return tx_semaphore_get(&mqtt_publish_acks, wait_option);
+#endif
+}
+
+/**
+* @brief  Append a message to the publish store, as its compressed payload with PAYLOAD_COMPRESS.
+* @param  message_ptr: message to publish on TOPIC_NAME
+* @param  length: length of the message
+* @retval PUBLISH_STORE_SUCCESS, PUBLISH_STORE_INVALID_SIZE when the payload is too long, or the error of the store
+*/
+static UINT mqtt_message_store(const UCHAR *message_ptr, UINT length)
+{
+#ifdef PAYLOAD_COMPRESS
+  /* Compressed once, a message sent again after a reconnection is taken from its record as it is. */
+  if (payload_compress(message_ptr, length, mqtt_compressed_payload, sizeof(mqtt_compressed_payload),
+                       &length) != PAYLOAD_COMPRESS_SUCCESS)
+  {
+    return PUBLISH_STORE_INVALID_SIZE;
+  }
+
+  return publish_store_append(mqtt_compressed_payload, length);
+#else
+  return publish_store_append(message_ptr, length);
+#endif
+}
+
+/**
+* @brief  Publish the stored messages not sent yet, as long as the window has room.
+* @param  inflight: number of messages waiting for their PUBACK, updated
+* @param  batch_count: number of messages in the open batch, updated
+* @retval NXD_MQTT_SUCCESS or the error of the failed publish
+*/
+static UINT mqtt_store_publish(UINT *inflight, UINT *batch_count)
+{
+  UINT ret = NXD_MQTT_SUCCESS;
+  const UCHAR *stored_message;
+  UINT stored_length;
+
+  while ((ret == NXD_MQTT_SUCCESS) && (*inflight < MQTT_PUBLISH_WINDOW) &&
+         (publish_store_peek(&stored_message, &stored_length) == PUBLISH_STORE_SUCCESS))
+  {
+    /* Pack up to MQTT_PUBLISH_BATCH messages into one TLS record. */
+    if (*batch_count == 0)
+    {
+      nxd_mqtt_client_publish_batch_begin(mqtt_publish_client);
+    }
+
+    /* Publish a message with QoS Level 1, it stays in the store until its PUBACK. */
+    ret = nxd_mqtt_client_prepared_publish(mqtt_publish_client, &mqtt_store_topic,
+                                           (CHAR*)stored_message, stored_length, NX_WAIT_FOREVER);
+
+    /* A message that failed to go out is queued in the client all the same, for the next connection. */
+    if ((ret != NXD_MQTT_SUCCESS) && (ret != NXD_MQTT_COMMUNICATION_FAILURE))
+    {
+      break;
+    }
+
+    publish_store_next();
+    *inflight += 1;
+    DEVICE_STATS_ADD(DEVICE_STATS_MQTT_PUBLISHED, 1U);
+
+    if (ret != NXD_MQTT_SUCCESS)
+    {
+      break;
+    }
+
+    if (++(*batch_count) == MQTT_PUBLISH_BATCH)
+    {
+      ret = nxd_mqtt_client_publish_batch_flush(mqtt_publish_client, NX_WAIT_FOREVER);
+      *batch_count = 0;
+    }
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Connect to the broker and subscribe to the topic.
+* @param  server_ip: address of the broker
+* @retval NXD_MQTT_SUCCESS or the error of the failed step
+*/
+static UINT mqtt_client_connect(NXD_ADDRESS *server_ip)
+{
+  UINT ret;
+  ULONG events;
+
+  /* A disconnection notified earlier is not about this connection. */
+  tx_event_flags_get(&mqtt_app_flag, DEMO_DISCONNECT_EVENT, TX_OR_CLEAR, &events, TX_NO_WAIT);
+
+  /* Look up MQTT Server address, only the first connection waits for the DNS servers. */
+#ifdef MQTT_DUAL_STACK
+  ret = broker_connect_address_get(&IpInstance, MQTT_BROKER_NAME, MQTT_PORT, server_ip, MQTT_CONNECT_TIMEOUT);
+#else
+  ret = dns_resolver_host_get(MQTT_BROKER_NAME, &server_ip -> nxd_ip_address.v4, DEFAULT_TIMEOUT);
+#endif
+
+  if (ret != NX_SUCCESS)
+  {
+    printf("\nMQTT client failed to resolve broker < %s >.\n",MQTT_BROKER_NAME);
+    return ret;
+  }
+
+  boot_profile_mark(BOOT_PROFILE_DNS);
+
+  /* Start a secure connection to the server, the handshake at full speed. */
+  clock_governor_boost();
+  ret = nxd_mqtt_client_secure_connect(&mqtt_client, server_ip, MQTT_PORT, tls_setup_callback,
+                                       MQTT_KEEP_ALIVE_TIMER, MQTT_CLEAN_SESSION, MQTT_CONNECT_TIMEOUT);
+  clock_governor_release();
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    DEVICE_STATS_ADD(DEVICE_STATS_MQTT_FAILED, 1U);
+    printf("\nMQTT client failed to connect to broker < %s >.\n",MQTT_BROKER_NAME);
+    return ret;
+  }
+  DEVICE_STATS_ADD(DEVICE_STATS_MQTT_CONNECTS, 1U);
+
+  printf("\nMQTT client connected to broker < %s > at PORT %d :\n",MQTT_BROKER_NAME, MQTT_PORT);
+
+  /* The next connection resumes this TLS session, after a reset as well. */
+  tls_resume_save(TLS_RESUME_SLOT_PRIMARY, &mqtt_client.nxd_mqtt_tls_session);
+
+  /* The first connection ends the boot. */
+  boot_profile_mark(BOOT_PROFILE_MQTT);
+  boot_profile_report();
+
+  /* A resumed session keeps the subscriptions, otherwise subscribe to all the topics at once. */
+  if (mqtt_client.nxd_mqtt_client_session_present)
+  {
+    return NXD_MQTT_SUCCESS;
+  }
+
+  ret = nxd_mqtt_client_subscribe_list(&mqtt_client, mqtt_topic_filters, MQTT_TOPIC_FILTER_COUNT);
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    nxd_mqtt_client_disconnect(&mqtt_client);
+  }
+
+  return ret;
+}
+
+#ifdef MQTT_BACKUP_BROKER_NAME
+/**
+* @brief  Create the client of the backup broker and hand both clients to the MQTT manager,
+*         which connects the backup one as soon as the address is bound.
+* @param  None
+* @retval NX_SUCCESS or the error of the failed step
+*/
+static UINT mqtt_backup_start(VOID)
+{
+  UINT ret;
+
+  /* Without a thread of its own, on the packet pool of the primary client. */
+  ret = nxd_mqtt_client_create(&mqtt_backup_client, "backup_client", CLIENT_ID_STRING, STRLEN(CLIENT_ID_STRING),
+                               &IpInstance, &AppPool, NX_NULL, 0, 0, NX_NULL, 0);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+#ifdef MQTT_BACKUP_STANDBY
+  /* Publishing in place of the primary client, its PUBACKs retire the messages of the store as well. */
+  nxd_mqtt_client_receive_notify_set(&mqtt_backup_client, my_notify_func);
+  nxd_mqtt_client_receive_queue_set(&mqtt_backup_client, MQTT_RECEIVE_QUEUE_MESSAGES, MQTT_RECEIVE_QUEUE_BYTES,
+                                    NXD_MQTT_RECEIVE_QUEUE_DROP_OLDEST);
+  nxd_mqtt_client_ack_notify_set(&mqtt_backup_client, my_ack_notify_func, &mqtt_publish_acks);
+#endif
+
+  ret = mqtt_manager_start();
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* The primary broker is connected by this thread, with its publish store. */
+  mqtt_primary_connection.client_ptr = &mqtt_client;
+  mqtt_primary_connection.broker_name = NX_NULL;
+
+  ret = mqtt_manager_connection_add(&mqtt_primary_connection);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    return ret;
+  }
+
+  mqtt_backup_connection.client_ptr = &mqtt_backup_client;
+  mqtt_backup_connection.broker_name = MQTT_BACKUP_BROKER_NAME;
+  mqtt_backup_connection.broker_port = MQTT_BACKUP_PORT;
+  mqtt_backup_connection.tls_setup = tls_setup_callback;
+  mqtt_backup_connection.keepalive = MQTT_KEEP_ALIVE_TIMER;
+  mqtt_backup_connection.clean_session = NX_TRUE;
+  mqtt_backup_connection.connected_notify = mqtt_backup_connected;
+
+  return mqtt_manager_connection_add(&mqtt_backup_connection);
+}
+
+/**
+* @brief  Take both clients back from the MQTT manager, then end and delete the backup one.
+* @param  None
+* @retval None
+*/
+static VOID mqtt_backup_stop(VOID)
+{
+  mqtt_manager_connection_remove(&mqtt_primary_connection);
+  mqtt_manager_connection_remove(&mqtt_backup_connection);
+
+  LOG_PRINTF("%lu messages published to the backup broker, %lu dropped\n",
+             mqtt_backup_connection.published, mqtt_backup_connection.dropped);
+
+  if (mqtt_backup_client.nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+  {
+    nxd_mqtt_client_disconnect(&mqtt_backup_client);
+  }
+
+  if (nxd_mqtt_client_delete(&mqtt_backup_client) != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+}
+
+/**
+* @brief  Connection callback of the backup client, from the thread of the MQTT manager.
+* @param  client_ptr: backup client, connected
+* @retval None
+*/
+static VOID mqtt_backup_connected(NXD_MQTT_CLIENT *client_ptr)
+{
+  NX_PARAMETER_NOT_USED(client_ptr);
+
+  /* The next connection resumes this TLS session, after a reset as well. */
+  tls_resume_save(TLS_RESUME_SLOT_BACKUP, &client_ptr -> nxd_mqtt_tls_session);
+
+#ifdef MQTT_BACKUP_STANDBY
+  /* Subscribed ahead, the client takes over with nothing left to set up. The SUBACKs are not waited for. */
+  if (nxd_mqtt_client_subscribe_list(client_ptr, mqtt_topic_filters, MQTT_TOPIC_FILTER_COUNT) != NXD_MQTT_SUCCESS)
+  {
+    printf("\nMQTT backup client failed to subscribe, connected to broker < %s >.\n", MQTT_BACKUP_BROKER_NAME);
+  }
+#endif
+}
+#endif
+
+#ifdef MQTT_BACKUP_STANDBY
+/**
+* @brief  Hand the publishing to the other client once the one publishing lost its connection.
+* @param  None
+* @retval NX_TRUE when the other client is connected and publishes the store from now on, NX_FALSE otherwise
+*/
+static UINT mqtt_standby_failover(VOID)
+{
+  NXD_MQTT_CLIENT *standby_ptr;
+
+  standby_ptr = (mqtt_publish_client == &mqtt_client) ? &mqtt_backup_client : &mqtt_client;
+
+  /* Connected and subscribed already: the next message goes out on its connection, with no handshake first. */
+  if (standby_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED)
+  {
+    return NX_FALSE;
+  }
+
+  mqtt_publish_client = standby_ptr;
+
+  if (standby_ptr == &mqtt_backup_client)
+  {
+    LOG_PRINTF("MQTT publishing moved to the backup broker\n");
+  }
+  else
+  {
+    LOG_PRINTF("MQTT publishing moved back to the primary broker\n");
+  }
+
+  return NX_TRUE;
+}
+#endif
+
+/**
+* @brief  Get ready to send the messages again once the connection is lost.
+* @param  inflight: number of messages waiting for their PUBACK, cleared
+* @retval None
+*/
+static VOID mqtt_client_offline(UINT *inflight)
+{
+  /* The PUBACKs received before the disconnection still count. */
+  mqtt_publish_acks_retire(inflight);
+
+  /* Every message not acknowledged is sent again on the next connection. A persistent
+     session keeps them queued in the client, which sends them again itself. */
+  if (MQTT_CLEAN_SESSION)
+  {
+    publish_store_rewind();
+    *inflight = 0;
+  }
+
+  /* Keep them across a reset while offline. */
+  publish_store_flush();
+
+  LOG_PRINTF("MQTT client offline, %lu messages stored\n", (unsigned long)publish_store_count());
+}
+
 /**
 * @brief  MQTT Client thread entry.
 * @param thread_input: ULONG user argument used by the thread entry
@@ -420,139 +1486,618 @@ static VOID App_MQTT_Client_Thread_Entry(ULONG thread_input)
 {
   UINT ret = NX_SUCCESS;
   NXD_ADDRESS mqtt_server_ip;
-  ULONG events;
+  UINT message_length;
+#ifdef SENSOR_SAMPLING
+  UCHAR *payload_ptr;
+#elif !defined(MQTT_PAYLOAD_CBOR)
   uint32_t aRandom32bit;
-  UINT topic_length, message_length;
+#endif
+#ifdef PAYLOAD_COMPRESS
+  ULONG compress_message_bytes;
+  ULONG compress_payload_bytes;
+#endif
   UINT remaining_msg = NB_MESSAGE;
   UINT message_count = 0;
+  UINT received_count = 0;
+  UINT dropped_count = 0;
   UINT unlimited_publish = NX_FALSE;
+  UINT connected = NX_FALSE;
+  UINT link_down = NX_FALSE;
+  ULONG link_down_time = 0;
+  UINT inflight = 0;
+  UINT batch_count = 0;
+#ifdef MQTT_BACKUP_STANDBY
+  ULONG failback_time = 0;
+#endif
+  UINT pool_low;
+  ULONG events;
+  ULONG link_status;
 
   mqtt_server_ip.nxd_ip_version = 4;
 
-  /* Create a DNS client */
-  ret = dns_create(&dns_client);
+  /* Recover the messages stored before the last reset, the store programs the flash through the flash service. */
+  if ((flash_service_start() != TX_SUCCESS) || (publish_store_init() != PUBLISH_STORE_SUCCESS))
+  {
+    Error_Handler();
+  }
+
+  if (publish_store_count() != 0)
+  {
+    LOG_PRINTF("%lu messages recovered from the publish store\n", (unsigned long)publish_store_count());
+  }
 
+#ifndef NX_SECURE_DISABLE_X509
+  /* Parse the certificates to verify incoming server certificates, the connections reuse them.
+     It needs no IP instance, it runs while the PHY negotiates the link. */
+  ret = trusted_ca_parse();
   if (ret != NX_SUCCESS)
   {
+    printf("Certificate issue..\nPlease make sure that your X509_certificate is valid. \n");
     Error_Handler();
   }
+#endif
 
-  /* Look up MQTT Server address. */
-  ret = nx_dns_host_by_name_get(&dns_client, (UCHAR *)MQTT_BROKER_NAME,
-                                &mqtt_server_ip.nxd_ip_address.v4, DEFAULT_TIMEOUT);
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+  /* The ECDHE key pairs of the handshakes are generated whenever the threads above are idle,
+     the first ones while the link comes up and the address is leased. */
+  if (ecdhe_precompute_start() != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
+  /* Create a DNS client */
+  ret = dns_create(&dns_client);
 
-  /* Check status.  */
   if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
 
   /* Create MQTT client instance. */
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+  /* Its events are processed by this thread, there is no MQTT thread to create. */
+  ret = nxd_mqtt_client_create(&mqtt_client, "my_client", CLIENT_ID_STRING, STRLEN(CLIENT_ID_STRING),
+                               &IpInstance, &AppPool, NX_NULL, 0, 0, NX_NULL, 0);
+#else
   ret = nxd_mqtt_client_create(&mqtt_client, "my_client", CLIENT_ID_STRING, STRLEN(CLIENT_ID_STRING),
                                &IpInstance, &AppPool, (VOID*)mqtt_client_stack, MQTT_CLIENT_STACK_SIZE,
                                MQTT_THREAD_PRIORTY, NX_NULL, 0);
+#endif
 
   if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
 
+#ifdef NX_ENABLE_TCP_QUICKACK
+  /* ACK the handshake and the short control packets of the broker at once, the
+     longer messages are ACKed by the reply or the delayed ACK timer. */
+  ret = nx_tcp_socket_ack_policy_set(&mqtt_client.nxd_mqtt_client_socket, MQTT_QUICKACK_SEGMENTS,
+                                     MQTT_QUICKACK_PUSH_SIZE);
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
   /* Register the disconnect notification function. */
   nxd_mqtt_client_disconnect_notify_set(&mqtt_client, my_disconnect_func);
 
   /* Set the receive notify function. */
   nxd_mqtt_client_receive_notify_set(&mqtt_client, my_notify_func);
 
-  /* Create an MQTT flag */
-  ret = tx_event_flags_create(&mqtt_app_flag, "my app event");
+  /* Bound the messages the app thread has not taken yet, a retained flood after the subscribe
+     would hold the packets of the main pool. The PUBACKs of the window come on the same
+     connection and this thread takes the messages between publishes, so the reading is not
+     stopped, the oldest QoS 0 messages are dropped. */
+  ret = nxd_mqtt_client_receive_queue_set(&mqtt_client, MQTT_RECEIVE_QUEUE_MESSAGES, MQTT_RECEIVE_QUEUE_BYTES,
+                                          NXD_MQTT_RECEIVE_QUEUE_DROP_OLDEST);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Create the PUBACK count, no message is in flight before the first publish. */
+  ret = tx_semaphore_create(&mqtt_publish_acks, "MQTT publish acks", 0);
+  if (ret != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Set the ACK notify function that counts the PUBACKs. */
+  nxd_mqtt_client_ack_notify_set(&mqtt_client, my_ack_notify_func, &mqtt_publish_acks);
+
+  /* Match the ACKs of the window by packet ID in constant time. */
+  ret = nxd_mqtt_client_inflight_table_set(&mqtt_client, mqtt_inflight_table, sizeof(mqtt_inflight_table));
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Keep the QoS 2 exchanges by packet ID once their message is acknowledged, not as packets. */
+  ret = nxd_mqtt_client_qos2_table_set(&mqtt_client, mqtt_qos2_table, sizeof(mqtt_qos2_table));
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Keep the last message of each topic for nxd_mqtt_client_last_value_get(). */
+  ret = nxd_mqtt_client_last_value_cache_set(&mqtt_client, mqtt_last_value_cache, sizeof(mqtt_last_value_cache),
+                                             MQTT_LAST_VALUE_ENTRY_SIZE);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Let the producers that cannot block publish with nxd_mqtt_client_publish_enqueue(). */
+  ret = nxd_mqtt_client_publish_ring_set(&mqtt_client, mqtt_publish_ring, sizeof(mqtt_publish_ring), MQTT_PUBLISH_SLOT_SIZE);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Send the CONNECT encoded for the first connection again at each reconnection. */
+  ret = nxd_mqtt_client_connect_cache_set(&mqtt_client, mqtt_connect_cache, sizeof(mqtt_connect_cache));
+  if (ret == NXD_MQTT_SUCCESS)
+  {
+    /* The stored messages are all published on TOPIC_NAME with QoS Level 1. */
+    ret = nxd_mqtt_client_topic_prepare(&mqtt_store_topic, TOPIC_NAME, STRLEN(TOPIC_NAME), NX_FALSE, QOS1);
+  }
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  /* Dispatch the messages of the topic to their callback, the others go to the receive queue. */
+  ret = nxd_mqtt_client_topic_trie_set(&mqtt_client, mqtt_topic_nodes, sizeof(mqtt_topic_nodes));
+  if (ret == NXD_MQTT_SUCCESS)
+  {
+    ret = nxd_mqtt_client_topic_callback_set(&mqtt_client, TOPIC_NAME, STRLEN(TOPIC_NAME),
+                                             mqtt_topic_callback, &received_count);
+  }
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+#if (MQTT_PUBLISH_RATE > 0)
+  /* Keep the publishes under the quota of the broker, they wait for their token. The
+     subscribe requests and the PINGREQs do not count against it. */
+  ret = nxd_mqtt_client_lane_rate_set(&mqtt_client, NXD_MQTT_LANE_BULK, MQTT_PUBLISH_RATE, MQTT_PUBLISH_BURST);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
+  boot_profile_mark(BOOT_PROFILE_TLS_READY);
+
+  /* The setup above ran while the PHY negotiated the link and the DHCP client got the address,
+     wait for it before the first connection. */
+  ret = nx_ip_interface_status_check(&IpInstance, 0, NX_IP_ADDRESS_RESOLVED, &link_status, TX_WAIT_FOREVER);
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+#ifdef PERF_HARNESS
+  /* The client tests of the network, then the TLS sessions, the MQTT client last. */
+  perf_harness_suite_end("net", net_benchmark_run(&IpInstance, &AppPool));
+  perf_harness_suite_end("tls", tls_benchmark_run(&IpInstance, &AppPool, &tls_arena));
+#else
+#ifdef NET_BENCHMARK
+  /* Serve the network tests in place of the demo, without the MQTT and telemetry traffic. */
+  ret = net_benchmark_run(&IpInstance, &AppPool);
+  printf("Network benchmark setup failed: 0x%x\n", ret);
+  Error_Handler();
+#endif
+
+#ifdef TLS_BENCHMARK
+  /* Time the TLS sessions in place of the demo, with the arena of the MQTT client that does not connect. */
+  if (tls_benchmark_run(&IpInstance, &AppPool, &tls_arena) != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+  Success_Handler();
+#endif
+#endif /* PERF_HARNESS */
+
+#ifdef TELEMETRY_DTLS
+  /* Send the telemetry over DTLS next to the MQTT client, resolving its gateway with the same DNS resolver. */
+  ret = telemetry_dtls_start(&IpInstance, &MediumPool);
+
   if (ret != TX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
 
-  /* Start a secure connection to the server. */
-  ret = nxd_mqtt_client_secure_connect(&mqtt_client, &mqtt_server_ip, MQTT_PORT, tls_setup_callback,
-                                       MQTT_KEEP_ALIVE_TIMER, CLEAN_SESSION, NX_WAIT_FOREVER);
+#ifdef LOCAL_BUS
+  /* The messages are also sent to the devices of the segment, through the multicast group of the bus. */
+  ret = local_bus_start(&IpInstance, &MediumPool);
 
   if (ret != NX_SUCCESS)
   {
-    printf("\nMQTT client failed to connect to broker < %s >.\n",MQTT_BROKER_NAME);
     Error_Handler();
   }
-  else
+#endif
+
+#ifdef LOCAL_BROKER
+  /* The clients of the site exchange their messages through the gateway, the messages of the demo with them. */
+  ret = local_broker_start(&IpInstance, &MediumPool);
+#ifdef LOCAL_BROKER_BRIDGE
+  if (ret == NX_SUCCESS)
+  {
+    ret = local_broker_bridge_set(&mqtt_client);
+  }
+#endif
+
+  if (ret != NX_SUCCESS)
   {
-    printf("\nMQTT client connected to broker < %s > at PORT %d :\n",MQTT_BROKER_NAME, MQTT_PORT);
+    Error_Handler();
   }
+#endif
 
-  /* Subscribe to the topic with QoS level 0. */
-  ret = nxd_mqtt_client_subscribe(&mqtt_client, TOPIC_NAME, STRLEN(TOPIC_NAME), QOS0);
+#ifdef PACKET_CAPTURE
+  /* The frames captured by the driver are sent on request, also while the broker is not reachable. */
+  ret = packet_capture_start(&IpInstance, &MediumPool);
 
   if (ret != NX_SUCCESS)
   {
     Error_Handler();
   }
+#endif
+
+#ifdef PERF_HARNESS
+  /* Any regression, missing result or failed suite ends in the error handler. */
+  perf_harness_suite_end("mqtt", mqtt_benchmark_run(&mqtt_client, &dns_client));
+  if (perf_harness_end() != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
+  Success_Handler();
+#elif defined(MQTT_BENCHMARK)
+  /* Measure the client in place of the demo. */
+  if (mqtt_benchmark_run(&mqtt_client, &dns_client) != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+  Success_Handler();
+#endif
+
+#ifdef MQTT_BACKUP_BROKER_NAME
+  /* Both clients are served by the thread of the MQTT manager from now on. */
+  ret = mqtt_backup_start();
+
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
+#ifdef SENSOR_SAMPLING
+  /* The samples are taken from now on, at their rate whether the broker is reachable or not. */
+  ret = sensor_sampler_start();
+
+  if (ret != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
+#ifdef REPORT_FILTER
+  /* The readings are published by exception, a message of each one outside the deadband, and one as a heartbeat. */
+  ret = report_filter_channel_set(REPORT_CHANNEL_READING, REPORT_DEADBAND, REPORT_DEADBAND_PERCENT,
+                                  REPORT_MIN_INTERVAL, REPORT_MAX_INTERVAL);
+
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+#endif
+
+  /* HCLK follows the load from now on, the peripherals that read the bus clocks are set up. */
+  ret = clock_governor_start();
+
+  if (ret != TX_SUCCESS)
+  {
+    Error_Handler();
+  }
 
   if (NB_MESSAGE ==0)
     unlimited_publish = NX_TRUE;
 
-  while(unlimited_publish || remaining_msg)
+  /* Every message goes through the publish store, so that the ones generated
+     while the broker is out of reach are sent once it is back. */
+  while(unlimited_publish || remaining_msg || (publish_store_count() != 0))
   {
-    message_generate(&aRandom32bit);
+#if defined(NXD_MQTT_APPLICATION_EVENT_LOOP) && !defined(MQTT_BACKUP_BROKER_NAME)
+    /* Process the ACKs, received messages, keepalive and disconnection of the client. */
+    nxd_mqtt_client_events_process(&mqtt_client, TX_NO_WAIT);
+#endif
 
-    snprintf(message, STRLEN(message), "%lu", (unsigned long)aRandom32bit);
+    mqtt_publish_acks_retire(&inflight);
 
-    /* Publish a message with QoS Level 1. */
-    ret = nxd_mqtt_client_publish(&mqtt_client, TOPIC_NAME, STRLEN(TOPIC_NAME),
-                                  (CHAR*)message, STRLEN(message), NX_FALSE, QOS1, NX_WAIT_FOREVER);
-    if (ret != NX_SUCCESS)
+    /* Keep the stored messages across a reset as soon as the link or the connection is lost. */
+    if (tx_event_flags_get(&mqtt_app_flag, DEMO_DISCONNECT_EVENT | DEMO_LINK_DOWN_EVENT | DEMO_LINK_UP_EVENT,
+                           TX_OR_CLEAR, &events, TX_NO_WAIT) == TX_SUCCESS)
     {
-      Error_Handler();
+#ifndef MQTT_BACKUP_STANDBY
+      if ((events & DEMO_DISCONNECT_EVENT) && connected)
+      {
+        connected = NX_FALSE;
+        batch_count = 0;
+        mqtt_client_offline(&inflight);
+      }
+      else
+#endif
+      if (events & (DEMO_DISCONNECT_EVENT | DEMO_LINK_DOWN_EVENT))
+      {
+        publish_store_flush();
+      }
+
+      /* Both events may be pending, the link state tells which came last. */
+      if (events & (DEMO_LINK_DOWN_EVENT | DEMO_LINK_UP_EVENT))
+      {
+        if (nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED, &link_status, NX_NO_WAIT) != NX_SUCCESS)
+        {
+          if (!link_down)
+          {
+            link_down = NX_TRUE;
+            link_down_time = tx_time_get();
+          }
+        }
+        else
+        {
+          link_down = NX_FALSE;
+        }
+      }
     }
 
-    /* wait for the broker to publish the message. */
-    tx_event_flags_get(&mqtt_app_flag, DEMO_ALL_EVENTS, TX_OR_CLEAR, &events, TX_WAIT_FOREVER);
+#ifdef MQTT_BACKUP_STANDBY
+    /* The client publishing lost its connection: the other one takes over on this turn when connected, its
+       messages not acknowledged sent again through it. The standby client is reconnected by the MQTT manager. */
+    if (connected && (mqtt_publish_client -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_CONNECTED))
+    {
+      batch_count = 0;
+      mqtt_client_offline(&inflight);
+      connected = mqtt_standby_failover();
+      failback_time = tx_time_get();
+    }
+#endif
 
-    /* check event received */
-    if(events & DEMO_MESSAGE_EVENT)
+    /* Below the low watermark of a pool, nothing new is sent from this thread until the pool is back at its
+       high one: the messages wait in the store and go out in full batches then, the capture waits too. */
+    pool_low = (tx_event_flags_get(&mqtt_app_flag, DEMO_POOL_LOW_EVENTS, TX_OR, &events, TX_NO_WAIT) == TX_SUCCESS);
+
+    /* A capture requested is sent on this turn, a failed send is asked for again by the host. */
+    if (!pool_low)
+    {
+      (void)packet_capture_poll();
+    }
+
+    /* A short outage costs nothing: the connection is kept, the publishing paused, and the TLS session
+       goes on once the cable is back. The broker would drop it after 1.5 keep alive periods anyway. */
+    if (connected && link_down && ((tx_time_get() - link_down_time) >= MQTT_LINK_DOWN_HOLD))
+    {
+      nxd_mqtt_client_disconnect(mqtt_publish_client);
+      connected = NX_FALSE;
+      batch_count = 0;
+      mqtt_client_offline(&inflight);
+    }
+
+    /* Without the cable, do not wait for a connection that cannot complete. */
+    if (!connected &&
+        (nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED, &link_status, NX_NO_WAIT) == NX_SUCCESS))
+    {
+      connected = (mqtt_client_connect(&mqtt_server_ip) == NXD_MQTT_SUCCESS);
+#ifdef MQTT_BACKUP_STANDBY
+      /* The backup broker meanwhile, when the primary one is out of reach. */
+      mqtt_publish_client = &mqtt_client;
+      if (!connected)
+      {
+        connected = mqtt_standby_failover();
+        failback_time = tx_time_get();
+      }
+    }
+    /* Back to the primary broker once no message waits for a PUBACK of the backup one, so that the PUBACKs of
+       one broker never retire messages sent to the other. The new messages wait in the store meanwhile. */
+    else if (connected && !link_down && (mqtt_publish_client == &mqtt_backup_client) && (inflight == 0) &&
+             (batch_count == 0) && ((tx_time_get() - failback_time) >= MQTT_RECONNECT_INTERVAL))
     {
-      /* get message from the broker */
-      ret = nxd_mqtt_client_message_get(&mqtt_client, topic_buffer, sizeof(topic_buffer), &topic_length,
-                                        message_buffer, sizeof(message_buffer), &message_length);
-      if(ret == NXD_MQTT_SUCCESS)
+      failback_time = tx_time_get();
+      if (mqtt_client_connect(&mqtt_server_ip) == NXD_MQTT_SUCCESS)
       {
-        printf("Message %d received: TOPIC = %s, MESSAGE = %s\n", message_count + 1, topic_buffer, message_buffer);
+        mqtt_publish_client = &mqtt_client;
+        LOG_PRINTF("MQTT publishing moved back to the primary broker\n");
+      }
+#endif
+    }
+
+    /* Backpressure: wait for a PUBACK when MQTT_PUBLISH_WINDOW messages wait for theirs, or when
+       nothing is left to send, sending the open batch first so that its messages can be acknowledged. */
+    if (connected && !link_down && ((inflight == MQTT_PUBLISH_WINDOW) ||
+                      (!(unlimited_publish || remaining_msg) && (publish_store_unsent_count() == 0))))
+    {
+      ret = NXD_MQTT_SUCCESS;
+      if (batch_count != 0)
+      {
+        ret = nxd_mqtt_client_publish_batch_flush(mqtt_publish_client, NX_WAIT_FOREVER);
+        batch_count = 0;
+      }
+
+      /* A bounded wait, the connection may be lost meanwhile. */
+      if ((ret == NXD_MQTT_SUCCESS) &&
+          (mqtt_publish_ack_wait(MQTT_ACK_WAIT) == TX_SUCCESS) &&
+          (publish_store_consume() == PUBLISH_STORE_SUCCESS))
+      {
+        DEVICE_STATS_ADD(DEVICE_STATS_MQTT_ACKED, 1U);
+        inflight--;
+      }
+    }
+    else
+    {
+#ifdef SENSOR_SAMPLING
+      /* A batch encoded by the sampler thread, waited for only when there is nothing else to send. */
+      if ((unlimited_publish || remaining_msg) &&
+          (sensor_sampler_payload_get(&payload_ptr, &message_length,
+                                      (publish_store_unsent_count() == 0) ? SENSOR_PAYLOAD_WAIT : TX_NO_WAIT) == TX_SUCCESS))
+      {
+        ret = mqtt_message_store(payload_ptr, message_length);
+#if defined(MQTT_BACKUP_BROKER_NAME) && !defined(MQTT_BACKUP_STANDBY)
+        mqtt_manager_publish(TOPIC_NAME, STRLEN(TOPIC_NAME), (CHAR *)payload_ptr, message_length, MQTT_BACKUP_QOS);
+#endif
+#ifdef LOCAL_BUS
+        local_bus_publish(LOCAL_BUS_GROUP, payload_ptr, message_length);
+#endif
+#ifdef LOCAL_BROKER
+        local_broker_publish(TOPIC_NAME, STRLEN(TOPIC_NAME), payload_ptr, message_length, QOS0);
+#endif
+        sensor_sampler_payload_release(payload_ptr);
+#elif defined(MQTT_PAYLOAD_CBOR)
+      if (unlimited_publish || remaining_msg)
+      {
+        /* The readings are encoded straight into the message, no text is formatted. */
+        if (mqtt_readings_encode(&message_length) != CBOR_WRITER_SUCCESS)
+        {
+          Error_Handler();
+        }
+
+        ret = mqtt_message_store((UCHAR *)message, message_length);
+#else
+      if ((unlimited_publish || remaining_msg) && mqtt_reading_take(&aRandom32bit))
+      {
+        message_length = (UINT)snprintf(message, sizeof(message), "%lu", (unsigned long)aRandom32bit);
+
+        ret = mqtt_message_store((UCHAR *)message, message_length);
+#endif
+
+#if defined(MQTT_BACKUP_BROKER_NAME) && !defined(MQTT_BACKUP_STANDBY) && !defined(SENSOR_SAMPLING)
+        /* The backup broker gets its copy at once, the primary one through the store. */
+        mqtt_manager_publish(TOPIC_NAME, STRLEN(TOPIC_NAME), message, message_length, MQTT_BACKUP_QOS);
+#endif
+
+#if defined(LOCAL_BUS) && !defined(SENSOR_SAMPLING)
+        /* Once on the segment whatever the number of subscribers, a frame lost there is not sent again. */
+        local_bus_publish(LOCAL_BUS_GROUP, (UCHAR *)message, message_length);
+#endif
+
+#if defined(LOCAL_BROKER) && !defined(SENSOR_SAMPLING)
+        /* The subscribers of the site get it from the gateway, not from the remote broker. */
+        local_broker_publish(TOPIC_NAME, STRLEN(TOPIC_NAME), (UCHAR *)message, message_length, QOS0);
+#endif
+
+        /* When the store is full the newest messages are dropped, the ones queued first are kept. */
+        if (ret == PUBLISH_STORE_FULL)
+        {
+          dropped_count++;
+          DEVICE_STATS_ADD(DEVICE_STATS_MQTT_DROPPED, 1U);
+        }
+        else if (ret != PUBLISH_STORE_SUCCESS)
+        {
+          Error_Handler();
+        }
+
+        /* Decrement message numbre */
+        remaining_msg -- ;
+        message_count ++ ;
+      }
+
+      ret = NXD_MQTT_SUCCESS;
+      if (connected && !link_down && !pool_low)
+      {
+        ret = mqtt_store_publish(&inflight, &batch_count);
+
+        /* The counters go out every DEVICE_STATS_INTERVAL, in the open batch if there is one. */
+        if (ret == NXD_MQTT_SUCCESS)
+        {
+          ret = device_stats_publish(mqtt_publish_client, &IpInstance, &AppPool);
+        }
+      }
+      else if (connected && !link_down)
+      {
+        /* The open batch has its packets already, sending it lets TCP give them back once acknowledged. */
+        if (batch_count != 0)
+        {
+          ret = nxd_mqtt_client_publish_batch_flush(mqtt_publish_client, NX_WAIT_FOREVER);
+          batch_count = 0;
+        }
+
+        /* The PUBACKs are retired meanwhile on the next turns, the connection is checked at least as often. */
+        tx_event_flags_get(&mqtt_app_flag, DEMO_POOL_RESUME_EVENT, TX_OR_CLEAR, &events, MQTT_ACK_WAIT);
       }
       else
       {
-        Error_Handler();
+        /* Retry the connection, or resume the paused one, later or as soon as the link is up again. */
+        if (tx_event_flags_get(&mqtt_app_flag, DEMO_LINK_UP_EVENT, TX_OR_CLEAR, &events,
+                               MQTT_RECONNECT_INTERVAL) == TX_SUCCESS)
+        {
+          link_down = NX_FALSE;
+        }
       }
     }
 
-    /* Decrement message numbre */
-    remaining_msg -- ;
-    message_count ++ ;
+    /* A failed publish loses the connection, its messages are sent again on the next one. */
+    if (connected && (ret != NXD_MQTT_SUCCESS))
+    {
+      nxd_mqtt_client_disconnect(mqtt_publish_client);
+      connected = NX_FALSE;
+      batch_count = 0;
+      mqtt_client_offline(&inflight);
+#ifdef MQTT_BACKUP_STANDBY
+      connected = mqtt_standby_failover();
+      failback_time = tx_time_get();
+#endif
+    }
 
-    /* Delay 1s between each pub */
-    tx_thread_sleep(100);
+    /* get the messages the broker published back meanwhile. */
+    mqtt_received_messages_drain(&received_count);
 
+#if (MQTT_PUBLISH_INTERVAL > 0)
+    tx_thread_sleep(MQTT_PUBLISH_INTERVAL);
+#endif
   }
 
-  /* Now unsubscribe the topic. */
-  ret = nxd_mqtt_client_unsubscribe(&mqtt_client, TOPIC_NAME, STRLEN(TOPIC_NAME));
-
-  if (ret != NX_SUCCESS)
+  mqtt_received_messages_drain(&received_count);
+  LOG_PRINTF("%d messages published, %d dropped, %d received\n", message_count, dropped_count, received_count);
+#ifdef SENSOR_SAMPLING
+  LOG_PRINTF("%lu sensor batches dropped before the publisher\n", sensor_sampler_dropped());
+#endif
+#if defined(REPORT_FILTER) && !defined(SENSOR_SAMPLING) && !defined(MQTT_PAYLOAD_CBOR)
+  LOG_PRINTF("%lu readings within their deadband not published\n", report_filter_suppressed());
+#endif
+#ifdef PAYLOAD_COMPRESS
+  payload_compress_totals(&compress_message_bytes, &compress_payload_bytes);
+  LOG_PRINTF("%lu message bytes stored in %lu payload bytes\n", compress_message_bytes, compress_payload_bytes);
+#endif
+
+  /* The last PUBACK may have come just before the connection was lost, there is nothing to end then. */
+  if (connected)
   {
-    Error_Handler();
-  }
+    /* Now unsubscribe the topic. */
+    ret = nxd_mqtt_client_unsubscribe(mqtt_publish_client, TOPIC_NAME, STRLEN(TOPIC_NAME));
 
-  /* Disconnect from the broker. */
-  ret = nxd_mqtt_client_disconnect(&mqtt_client);
+    if (ret != NX_SUCCESS)
+    {
+      Error_Handler();
+    }
 
-  if (ret != NX_SUCCESS)
-  {
-    Error_Handler();
+    /* Disconnect from the broker. */
+    ret = nxd_mqtt_client_disconnect(mqtt_publish_client);
+
+    if (ret != NX_SUCCESS)
+    {
+      Error_Handler();
+    }
   }
 
+#ifdef MQTT_BACKUP_BROKER_NAME
+  mqtt_backup_stop();
+#endif
+
   /* Delete the client instance, release all the resources. */
   ret = nxd_mqtt_client_delete(&mqtt_client);
 
@@ -561,65 +2106,132 @@ static VOID App_MQTT_Client_Thread_Entry(ULONG thread_input)
     Error_Handler();
   }
 
+  cycle_profile_dump("of the demo");
+  thread_profile_dump();
+  pool_map_dump();
+  irq_off_trace_dump();
+
   /* test OK -> success Handler */
   Success_Handler();
 }
 
 /**
-* @brief  Link thread entry
-* @param thread_input: ULONG thread parameter
+* @brief  Link check work item: reports the cable disconnected and connected again.
+* @param  item: work item
 * @retval none
 */
-static VOID App_Link_Thread_Entry(ULONG thread_input)
+static VOID link_check_work(WORK_ITEM *item)
 {
   ULONG actual_status;
-  UINT linkdown = 0, status;
+  UINT status;
 
-  while(1)
-  {
-    /* Get Physical Link stackavailtus. */
-    status = nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED,
-                                      &actual_status, 10);
+  NX_PARAMETER_NOT_USED(item);
 
-    if(status == NX_SUCCESS)
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+  /* Release nINT for the next change, the link state is read after. */
+  nx_eth_phy_interrupt_clear();
+#endif
+
+  /* Get Physical Link status. */
+  status = nx_ip_interface_status_check(&IpInstance, 0, NX_IP_LINK_ENABLED, &actual_status, NX_NO_WAIT);
+
+  if(status == NX_SUCCESS)
+  {
+    if(link_down)
     {
-      if(linkdown == 1)
+      link_down = NX_FALSE;
+      status = nx_ip_interface_status_check(&IpInstance, 0, NX_IP_ADDRESS_RESOLVED, &actual_status, NX_NO_WAIT);
+      if(status == NX_SUCCESS)
       {
-        linkdown = 0;
-        status = nx_ip_interface_status_check(&IpInstance, 0, NX_IP_ADDRESS_RESOLVED,
-                                      &actual_status, 10);
-        if(status == NX_SUCCESS)
-        {
-          /* The network cable is connected again. */
-          printf("The network cable is connected again.\n");
-          /* Print MQTT Client is available again. */
-          printf("MQTT Client is available again.\n");
-        }
-        else
-        {
-          /* The network cable is connected. */
-          printf("The network cable is connected.\n");
-          /* Send command to Enable Nx driver. */
-          nx_ip_driver_direct_command(&IpInstance, NX_LINK_ENABLE,
-                                      &actual_status);
-          /* Restart DHCP Client. */
-          nx_dhcp_stop(&DHCPClient);
-          nx_dhcp_start(&DHCPClient);
-        }
+        /* The network cable is connected again. */
+        printf("The network cable is connected again.\n");
+        /* Print MQTT Client is available again. */
+        printf("MQTT Client is available again.\n");
+        /* The lease is still held, the DHCP client renews it itself. Have the MQTT client resume
+           the connection it kept through the outage, or reconnect right away. */
+        tx_event_flags_set(&mqtt_app_flag, DEMO_LINK_UP_EVENT, TX_OR);
       }
-    }
-    else
-    {
-      if(0 == linkdown)
+      else
       {
-        linkdown = 1;
-        /* The network cable is not connected. */
-        printf("The network cable is not connected.\n");
+        /* The network cable is connected. */
+        printf("The network cable is connected.\n");
+        /* Send command to Enable Nx driver. */
+        nx_ip_driver_direct_command(&IpInstance, NX_LINK_ENABLE,
+                                    &actual_status);
+        /* No address, the lease ran out during the outage or was never bound: restart DHCP Client. */
+        nx_dhcp_stop(&DHCPClient);
+        nx_dhcp_start(&DHCPClient);
       }
     }
+  }
+  else
+  {
+    if(!link_down)
+    {
+      link_down = NX_TRUE;
+      /* The network cable is not connected. */
+      printf("The network cable is not connected.\n");
+      /* Have the MQTT client thread save its pending messages and pause its publishing. */
+      tx_event_flags_set(&mqtt_app_flag, DEMO_LINK_DOWN_EVENT, TX_OR);
+    }
+  }
+}
 
-    tx_thread_sleep(NX_ETH_CABLE_CONNECTION_CHECK_PERIOD);
+/**
+* @brief  Housekeeping work item, every DHCP_LEASE_SAVE_PERIOD: saves the time left of the lease and
+*         reports the log output lost.
+* @param  item: work item
+* @retval none
+*/
+static VOID housekeeping_work(WORK_ITEM *item)
+{
+  static ULONG log_dropped = 0;
+
+  NX_PARAMETER_NOT_USED(item);
+
+  /* Keep the time left of the saved DHCP lease current. */
+#ifndef GATEWAY_DHCP_SERVER
+  dhcp_lease_save(&DHCPClient);
+#endif
+
+  /* Tell that output was lost, once the ring is drained enough to take the line. */
+  if (log_uart_dropped() != log_dropped)
+  {
+    log_dropped = log_uart_dropped();
+    LOG_PRINTF("Log output full, %lu bytes dropped since the start\n", log_dropped);
+  }
+}
+
+#if defined(TX_EXECUTION_PROFILE_ENABLE) || defined(POOL_MAP) || defined(TX_IRQ_OFF_TRACE)
+/**
+* @brief  Profile report work item, every THREAD_PROFILE_REPORT_PERIOD: the CPU time and the stack usage of the
+*         threads, the blocks of the byte pools and the longest critical sections.
+* @param  item: work item
+* @retval none
+*/
+static VOID profile_report_work(WORK_ITEM *item)
+{
+  NX_PARAMETER_NOT_USED(item);
+
+  thread_profile_dump();
+  pool_map_dump();
+  irq_off_trace_dump();
+}
+#endif
+
+#ifdef NX_ETH_PHY_INTERRUPT_PIN
+/**
+* @brief  EXTI line callback, the PHY pulled nINT low on a link change.
+* @param  GPIO_Pin: pin of the EXTI line
+* @retval None
+*/
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == NX_ETH_PHY_INTERRUPT_PIN)
+  {
+    work_item_submit(&app_work_queue, &link_check_item);
   }
 }
+#endif
 
 /* USER CODE END 1 */
@@ -34,6 +34,7 @@ extern "C" {
 /* USER CODE BEGIN Includes */
 #include <stdio.h>
 #include "main.h"
+#include "log_binary.h"
 #include "nxd_dhcp_client.h"
 #include "nxd_mqtt_client.h" 
 #include "nxd_dns.h"
@@ -48,25 +49,91 @@ extern "C" {
 /* USER CODE BEGIN EC */
 #define MOSQUITTO_CERT_FILE         "mosquitto.cert.h"
   
-  /* Threads configuration */  
+/* Static memory configuration. The packet pools, the thread stacks, the ARP cache and the
+   TLS sessions below are arrays of app_netxduo.c, placed by the linker in the section of
+   their use: the packet pools in DMA_RAM, the CPU only areas in CCM-RAM. Nothing is taken
+   from the NetX byte pool, an area too large for its section fails the link, not the boot. */
 #define PAYLOAD_SIZE                1536
-#define NX_PACKET_POOL_SIZE         (( PAYLOAD_SIZE + sizeof(NX_PACKET)) * 20)  
+#define NX_PACKET_POOL_PACKETS      16
+#define MEDIUM_PAYLOAD_SIZE         512
+#define NX_MEDIUM_PACKET_POOL_PACKETS 16
+#define AUX_PAYLOAD_SIZE            128
+#define NX_AUX_PACKET_POOL_PACKETS  16
+#define TLS_CONTROL_PAYLOAD_SIZE    512                   /* Holds a ClientHello, the handshake messages and alerts are built in one packet */
+#define NX_TLS_CONTROL_PACKET_POOL_PACKETS 6              /* A client flight of the primary and the backup session together */
+
+/* Bytes of a pool of packets, each header and payload rounded up to NX_PACKET_ALIGNMENT
+   as nx_packet_pool_create() does, so that the pool holds exactly the packets asked for */
+#define NX_PACKET_ALIGN_UP(size)    ((((size) + NX_PACKET_ALIGNMENT - 1) / NX_PACKET_ALIGNMENT) * NX_PACKET_ALIGNMENT)
+#define NX_PACKET_POOL_BYTES(payload, packets) \
+                                    (NX_PACKET_ALIGN_UP(NX_PACKET_ALIGN_UP(sizeof(NX_PACKET)) + (payload)) * (packets))
+
+#define NX_PACKET_POOL_SIZE         NX_PACKET_POOL_BYTES(PAYLOAD_SIZE, NX_PACKET_POOL_PACKETS)
+#define NX_MEDIUM_PACKET_POOL_SIZE  NX_PACKET_POOL_BYTES(MEDIUM_PAYLOAD_SIZE, NX_MEDIUM_PACKET_POOL_PACKETS)
+#define NX_AUX_PACKET_POOL_SIZE     NX_PACKET_POOL_BYTES(AUX_PAYLOAD_SIZE, NX_AUX_PACKET_POOL_PACKETS)
+#define NX_TLS_CONTROL_PACKET_POOL_SIZE NX_PACKET_POOL_BYTES(TLS_CONTROL_PAYLOAD_SIZE, NX_TLS_CONTROL_PACKET_POOL_PACKETS)
+
+#define ARP_CACHE_SIZE              1024                  /* Bytes of the ARP entries, sizeof(NX_ARP) each */
+
+  /* Threads configuration */  
 #define DEFAULT_MEMORY_SIZE         1024
 #define DEFAULT_MAIN_PRIORITY       10
 #define DEFAULT_PRIORITY            5  
 #define THREAD_MEMORY_SIZE          2 * DEFAULT_MEMORY_SIZE  
-#define LINK_PRIORITY               11
+#define IP_THREAD_STACK_SIZE        (2 * DEFAULT_MEMORY_SIZE)
+#ifdef CRYPTO_BENCHMARK
+#define WORK_QUEUE_STACK_SIZE       8 * DEFAULT_MEMORY_SIZE   /* The start item runs the crypto methods, as the TLS client thread */
+#else
+#define WORK_QUEUE_STACK_SIZE       (2 * DEFAULT_MEMORY_SIZE) /* Start, DHCP and link items, in place of a main and a link thread */
+#endif
+#define WORK_QUEUE_PRIORITY         DEFAULT_MAIN_PRIORITY
+#define LINK_WAIT_POLL              (NX_IP_PERIODIC_RATE / 50) /* Period the link is checked at until it first comes up */
+
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+#define MQTT_APP_THREAD_MEMORY_SIZE 4 * DEFAULT_MEMORY_SIZE   /* The app MQTT thread also processes the MQTT client events */
+#else
+#define MQTT_APP_THREAD_MEMORY_SIZE THREAD_MEMORY_SIZE
+#endif
 
 /* MQTT Client configuration */
-#define MQTT_CLIENT_STACK_SIZE      1024 * 10
+#define MQTT_CLIENT_STACK_SIZE      1024 * 10            /* Not used with NXD_MQTT_APPLICATION_EVENT_LOOP */
 #define CLIENT_ID_STRING            "MQTT_client_ID"  
 #define MQTT_THREAD_PRIORTY         2
 #define MQTT_KEEP_ALIVE_TIMER       30000                /* Define the MQTT keep alive timer for 5 minutes */
-#define CLEAN_SESSION               NX_TRUE
+#define CLEAN_SESSION               NX_FALSE             /* Persistent session: subscriptions and unacknowledged messages survive a reconnection */
 #define STRLEN(p)                   (sizeof(p) - 1)  
   
 #define TOPIC_NAME                  "Temperature" 
 #define NB_MESSAGE                  10                    /*  if NB_MESSAGE = 0, client will publish messages infinitely */
+#define MQTT_PUBLISH_WINDOW         8                     /* Maximum number of QoS1 messages waiting for their PUBACK */
+#define MQTT_PUBLISH_INTERVAL       0                     /* Delay in ticks between two publishes, 0 publishes back to back */
+#define MQTT_PUBLISH_BATCH          4                     /* Number of messages sent together in one TLS record */
+#define MQTT_PUBLISH_RATE           0                     /* Messages per second the broker accepts on the bulk lane, 0 is no limit */
+#define MQTT_PUBLISH_BURST          MQTT_PUBLISH_WINDOW   /* Messages sent back to back after an idle time, with MQTT_PUBLISH_RATE */
+/* Defined, MQTT_PAYLOAD_CBOR packs MQTT_PAYLOAD_READINGS readings in each message, as a CBOR array of the time
+   of the first reading, the first reading and the deltas of the next ones, instead of one reading in decimal text */
+/*
+#define MQTT_PAYLOAD_CBOR
+*/
+#define MQTT_PAYLOAD_READINGS       8                     /* Readings per message with MQTT_PAYLOAD_CBOR, 12 at most fit in the message */
+#define MQTT_INFLIGHT_TABLE_SIZE    16                    /* Power of two above MQTT_PUBLISH_WINDOW plus the subscribe requests */
+#define MQTT_QOS2_TABLE_SIZE        16                    /* QoS 2 exchanges kept by packet ID after their message, less one */
+#define MQTT_TOPIC_NODES            4                     /* Topic filter levels the client dispatches on */
+#define MQTT_LAST_VALUE_ENTRIES     4                     /* Topics whose last message is kept, less one */
+#define MQTT_LAST_VALUE_ENTRY_SIZE  64                    /* Header, topic and message of a last value */
+#define MQTT_PUBLISH_SLOTS          8                     /* Messages of nxd_mqtt_client_publish_enqueue() waiting, a power of two */
+#define MQTT_PUBLISH_SLOT_SIZE      64                    /* Header, topic and message of an enqueued message */
+#define MQTT_CONNECT_CACHE_SIZE     128                   /* CONNECT packet kept for the reconnections, client ID and login */
+#define MQTT_RECEIVE_QUEUE_MESSAGES 4                     /* Messages waiting for nxd_mqtt_client_message_get(), a quarter of the main pool */
+#define MQTT_RECEIVE_QUEUE_BYTES    (2 * PAYLOAD_SIZE)    /* Bytes of the messages waiting, the oldest QoS 0 ones are dropped past it */
+#define MQTT_CONNECT_TIMEOUT        (10 * NX_IP_PERIODIC_RATE) /* Time allowed to connect to the broker */
+#define MQTT_RECONNECT_INTERVAL     (5 * NX_IP_PERIODIC_RATE)  /* Delay between two connection attempts while offline */
+#define MQTT_LINK_DOWN_HOLD         (MQTT_KEEP_ALIVE_TIMER * NX_IP_PERIODIC_RATE) /* Longest cable outage the connection is kept through */
+#define MQTT_ACK_WAIT               NX_IP_PERIODIC_RATE   /* Longest wait for a PUBACK before checking the connection */
+#define MQTT_POOL_LOW_WATERMARK     4                     /* Free packets of the main or medium pool the publishing pauses at */
+#define MQTT_POOL_HIGH_WATERMARK    8                     /* Free packets of both pools the publishing resumes at */
+#define MQTT_QUICKACK_SEGMENTS      8                     /* Segments ACKed at once after connecting, covers the TLS handshake */
+#define MQTT_QUICKACK_PUSH_SIZE     64                    /* Largest record ACKed at once, a PUBACK or PINGRESP in a TLS record */
                                     
 #define MQTT_BROKER_NAME            "test.mosquitto.org" /* MQTT Server */
                            
@@ -76,23 +143,301 @@ extern "C" {
 #define QOS1                        1 
                                     
 #define DEMO_MESSAGE_EVENT          1 
-#define DEMO_ALL_EVENTS             3
+#define DEMO_DISCONNECT_EVENT       2
+#define DEMO_LINK_DOWN_EVENT        4
+#define DEMO_LINK_UP_EVENT          8
+#define DEMO_APP_POOL_LOW_EVENT     16                    /* Set while the main pool is under its high watermark */
+#define DEMO_MEDIUM_POOL_LOW_EVENT  32                    /* Set while the medium pool is under its high watermark */
+#define DEMO_POOL_RESUME_EVENT      64
+#define DEMO_POOL_LOW_EVENTS        (DEMO_APP_POOL_LOW_EVENT | DEMO_MEDIUM_POOL_LOW_EVENT)
+#define DEMO_ALL_EVENTS             127
                                     
 #define NULL_ADDRESS                0  
 #define USER_DNS_ADDRESS            IP_ADDRESS(1, 1, 1, 1)   /* User should configure it with his DNS address */
 
 #define DEFAULT_TIMEOUT             5 * NX_IP_PERIODIC_RATE
+#define USER_DNS_ADDRESS_SECONDARY  IP_ADDRESS(8, 8, 8, 8)   /* Asked when USER_DNS_ADDRESS does not answer */
+#define DNS_CACHE_SIZE              1024                  /* Bytes of DNS answers kept for their TTL */
+#define DNS_RESOLVER_HOSTS          4                     /* Host names the resolver keeps an address of */
+#define DNS_RESOLVER_DEFAULT_TTL    (60 * NX_IP_PERIODIC_RATE) /* Lifetime of an address whose answer the cache could not keep */
+#define DNS_RESOLVER_RETRY_INTERVAL (30 * NX_IP_PERIODIC_RATE) /* Delay before a failed refresh is tried again */
+#define DNS_RESOLVER_STACK_SIZE     2 * DEFAULT_MEMORY_SIZE
+#define DNS_RESOLVER_PRIORITY       DEFAULT_MAIN_PRIORITY
+#define DNS_RESOLVER_SERVERS        3                     /* DNS servers of a DHCP ACK ranked by response time */
+#define DNS_RESOLVER_PROBE_TIMEOUT  (NX_IP_PERIODIC_RATE / 2) /* Longest wait for the answer of a server to its probe */
+
+/* DHCP lease configuration, see dhcp_lease.c */
+#define DHCP_LEASE_LINK_WAIT        (5 * NX_IP_PERIODIC_RATE)  /* Longest wait for the link before the first DHCP message */
+#define DHCP_LEASE_REBOOT_WAIT      (2 * NX_IP_PERIODIC_RATE)  /* Wait for the ACK of the last lease before discovering a new one */
+#define DHCP_LEASE_SAVE_PERIOD      (60 * NX_IP_PERIODIC_RATE) /* Period the time left of the lease is saved at */
+
+/* Gateway profile, see dhcp_gateway.c. Defined, GATEWAY_DHCP_SERVER gives the board the static address below
+   in place of the DHCP client, and serves the addresses of the sensors of its segment with the DHCP server */
+/*
+#define GATEWAY_DHCP_SERVER
+*/
+#define GATEWAY_IP_ADDRESS          IP_ADDRESS(192, 168, 10, 1)
+#define GATEWAY_NETWORK_MASK        IP_ADDRESS(255, 255, 255, 0)
+#define GATEWAY_ROUTER_ADDRESS      IP_ADDRESS(192, 168, 10, 254) /* Router of the segment toward the broker */
+#define GATEWAY_POOL_START          IP_ADDRESS(192, 168, 10, 100) /* Addresses of the sensors, the static leases */
+#define GATEWAY_POOL_END            IP_ADDRESS(192, 168, 10, 115) /* included, NX_DHCP_IP_ADDRESS_MAX_LIST_SIZE at most */
+#define GATEWAY_DHCP_STACK_SIZE     2 * DEFAULT_MEMORY_SIZE
   
+/* Benchmark configuration, see mqtt_benchmark.c. Defined, MQTT_BENCHMARK runs the benchmark in place of the demo */
+/*
+#define MQTT_BENCHMARK
+*/
+#define BENCHMARK_MESSAGES          200                   /* Messages of each publish rate test */
+#define BENCHMARK_ECHO_COUNT        100                   /* Round trips of each echo latency test */
+#define BENCHMARK_PAYLOAD_MIN       1                     /* First payload of the sweep, doubled up to NXD_MQTT_MAX_MESSAGE_LENGTH */
+#define BENCHMARK_RATE_TOPIC        TOPIC_NAME "/rate"    /* Not subscribed, the broker does not send the messages back */
+#define BENCHMARK_TIMEOUT           (2 * NX_IP_PERIODIC_RATE) /* Longest wait for an ACK or an echo */
+
+/* Crypto benchmark configuration, see crypto_benchmark.c. Defined, CRYPTO_BENCHMARK measures the crypto
+   primitives in place of the demo, make CRYPTO_BENCHMARK=1 defines it in a build of its own */
+/*
+#define CRYPTO_BENCHMARK
+*/
+#define CRYPTO_BENCHMARK_SIZE_MIN   16                    /* First message of the sweep, multiplied by 4 up to the next */
+#define CRYPTO_BENCHMARK_SIZE_MAX   4096                  /* Last message of the sweep, 256 bytes at least for RSA-2048 */
+#define CRYPTO_BENCHMARK_BYTES      65536                 /* Bytes processed at each message size */
+#define CRYPTO_BENCHMARK_PK_ITERATIONS 8                  /* Operations of each public key measurement */
+
+/* Network benchmark configuration, see net_benchmark.c. Defined, NET_BENCHMARK serves the iperf2, echo and
+   packet rate tests in place of the demo, make NET_BENCHMARK=1 defines it in a build of its own */
+/*
+#define NET_BENCHMARK
+*/
+#define NET_BENCHMARK_PEER_ADDRESS  NULL_ADDRESS          /* Host of iperf -s and iperf -s -u, the client tests are skipped when NULL_ADDRESS */
+#define NET_BENCHMARK_DURATION      (10 * NX_IP_PERIODIC_RATE) /* Length of each client test, the iperf2 default */
+#define NET_BENCHMARK_UDP_RATE      10000000              /* Bits per second of the UDP client test */
+#define NET_BENCHMARK_UDP_LENGTH    1470                  /* Datagrams of the UDP client test, the iperf2 default */
+#define NET_BENCHMARK_TCP_WINDOW    (8 * 1460)            /* Receive window of the TCP tests, 8 full segments */
+#define NET_BENCHMARK_UDP_QUEUE     8                     /* Datagrams queued on each UDP socket before they are dropped */
+#define NET_BENCHMARK_PPS_PORT      5002                  /* UDP port of the packet rate test */
+#define NET_BENCHMARK_TIMEOUT       (2 * NX_IP_PERIODIC_RATE) /* Longest wait for a connection, a packet or a send */
+
+/* TLS benchmark configuration, see tls_benchmark.c. Defined, TLS_BENCHMARK times the handshakes and records
+   of each ciphersuite in place of the demo, make TLS_BENCHMARK=1 defines it in a build of its own */
+/*
+#define TLS_BENCHMARK
+*/
+#define TLS_BENCHMARK_PEER_ADDRESS  NULL_ADDRESS          /* Host of Utilities/tls_benchmark.py server, to be set */
+#define TLS_BENCHMARK_PEER_PORT     4433                  /* Default port of openssl s_server */
+#define TLS_BENCHMARK_HANDSHAKES    5                     /* Handshakes of each ciphersuite, the chain is verified by the first one */
+#define TLS_BENCHMARK_BYTES         65536                 /* Application data sent in the records of each size */
+#define TLS_BENCHMARK_TCP_WINDOW    (4 * 1460)            /* Receive window, the server certificates of the handshake */
+#define TLS_BENCHMARK_TIMEOUT       (10 * NX_IP_PERIODIC_RATE) /* Longest wait for a connection, a handshake or a send */
+
+/* DTLS telemetry configuration, see telemetry_dtls.c. Defined, TELEMETRY_DTLS also sends the readings
+   to an MQTT-SN gateway as QoS -1 publishes over DTLS, from a thread of its own */
+/*
+#define TELEMETRY_DTLS
+*/
+#define TELEMETRY_SERVER_NAME       MQTT_BROKER_NAME      /* MQTT-SN gateway */
+#define TELEMETRY_PORT              1884                  /* DTLS port of the gateway */
+#define TELEMETRY_TOPIC_ID          1                     /* Topic ID predefined on the gateway for the readings */
+#define TELEMETRY_READINGS          16                    /* Readings packed in one publish, one datagram */
+#define TELEMETRY_SAMPLE_INTERVAL   NX_IP_PERIODIC_RATE   /* Delay in ticks between two readings */
+#define TELEMETRY_SESSION_LIFETIME  (3600 * NX_IP_PERIODIC_RATE) /* Age of the DTLS session renewed by a new handshake */
+#define TELEMETRY_CONNECT_TIMEOUT   (10 * NX_IP_PERIODIC_RATE) /* Time allowed for the DTLS handshake */
+#define TELEMETRY_RETRY_INTERVAL    (5 * NX_IP_PERIODIC_RATE) /* Delay between two handshake attempts */
+#define TELEMETRY_SOCKET_QUEUE      4                     /* Datagrams from the gateway queued before they are dropped */
+#define TELEMETRY_BUFFER_SIZE       1024                  /* DTLS handshake reassembly, no certificate with PSK */
+#define TELEMETRY_STACK_SIZE        4 * DEFAULT_MEMORY_SIZE
+#define TELEMETRY_PRIORITY          DEFAULT_PRIORITY
+#define TELEMETRY_PSK_IDENTITY      CLIENT_ID_STRING      /* PSK credentials shared with the gateway */
+#define TELEMETRY_PSK_KEY           "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"
+
+/* Sensor sampling configuration, see sensor_sampler.c. Defined, SENSOR_SAMPLING publishes batches of
+   ADC samples taken at a fixed rate instead of the random numbers */
+/*
+#define SENSOR_SAMPLING
+*/
+#define SENSOR_SAMPLE_RATE          1000                  /* Samples per second, a divider of 1 MHz */
+#define SENSOR_BATCH_SAMPLES        128                   /* Samples published in one message, half the DMA buffer */
+#define SENSOR_PAYLOAD_COUNT        8                     /* Payloads waiting for the publisher before batches are dropped */
+#define SENSOR_PAYLOAD_WAIT         (NX_IP_PERIODIC_RATE / 10) /* Wait of the publisher for a batch when nothing is unsent */
+#define SENSOR_STACK_SIZE           DEFAULT_MEMORY_SIZE
+#define SENSOR_PRIORITY             (DEFAULT_PRIORITY - 1) /* Above the publisher, a half is copied before the DMA comes back */
+
+/* Sensor aggregation configuration, see sensor_aggregate.c. Defined, SENSOR_AGGREGATE publishes the minimum, maximum,
+   mean, RMS and band energies of each batch of SENSOR_SAMPLING instead of its samples, computed with CMSIS-DSP */
+/*
+#define SENSOR_AGGREGATE
+*/
+#define SENSOR_AGGREGATE_BANDS      8                     /* FFT bands up to half the sample rate, 0 for no FFT */
+
+/* Report by exception configuration, see report_filter.h. Defined, REPORT_FILTER publishes a reading only once it
+   moved out of the deadband of the last one sent, or REPORT_MAX_INTERVAL after it, instead of every reading. It filters
+   the messages of one reading, neither MQTT_PAYLOAD_CBOR nor SENSOR_SAMPLING */
+/*
+#define REPORT_FILTER
+*/
+#define REPORT_FILTER_CHANNELS      8                     /* Channels of readings filtered, 32 at most */
+#define REPORT_CHANNEL_READING      0                     /* Channel of the reading published on TOPIC_NAME */
+#define REPORT_DEADBAND             2                     /* Change of a reading reported whatever its value */
+#define REPORT_DEADBAND_PERCENT     5                     /* Change reported, in percent of the last reading sent */
+#define REPORT_MIN_INTERVAL         (NX_IP_PERIODIC_RATE / 10) /* Shortest time between two readings sent */
+#define REPORT_MAX_INTERVAL         (60 * NX_IP_PERIODIC_RATE) /* Longest time without a reading sent */
+#define REPORT_SAMPLE_INTERVAL      1                     /* Ticks to the next reading after one not sent */
+
+/* Payload compression configuration, see payload_compress.c. Defined, PAYLOAD_COMPRESS starts each message on TOPIC_NAME
+   with a format byte and compresses it in the LZ4 block format when it gets shorter, Utilities/payload_decode.py reads
+   them back. The backup broker and the local bus get the messages as they are */
+/*
+#define PAYLOAD_COMPRESS
+*/
+#define PAYLOAD_COMPRESS_HASH_BITS  9                     /* Match table of 2 ^ bits entries of 2 bytes, 1 KB */
+
+/* Local bus configuration, see local_bus.c. Defined, LOCAL_BUS also sends each message once to a multicast group
+   of the segment, for the devices of the site subscribed to it with local_bus_subscribe(), the broker not involved */
+/*
+#define LOCAL_BUS
+*/
+#define LOCAL_BUS_GROUP             IP_ADDRESS(239, 255, 10, 1) /* Organization-local scope of RFC 2365 */
+#define LOCAL_BUS_PORT              5010
+#define LOCAL_BUS_TTL               1                     /* Not forwarded by the routers, the segment only */
+#define LOCAL_BUS_QUEUE             8                     /* Frames received and not taken before they are dropped */
+
+/* Local broker configuration, see local_broker.c. Defined, LOCAL_BROKER serves the MQTT 3.1.1 clients of the site on
+   LOCAL_BROKER_PORT, so that they exchange their messages through the gateway instead of the remote broker. The
+   messages of TOPIC_NAME are published there too, with QoS level 0 */
+/*
+#define LOCAL_BROKER
+*/
+/* Defined, LOCAL_BROKER_BRIDGE also forwards the messages of the local clients to the remote broker, with QoS level 0 */
+/*
+#define LOCAL_BROKER_BRIDGE
+*/
+#define LOCAL_BROKER_PORT           NXD_MQTT_PORT         /* 1883, the connections of the site are not encrypted */
+#define LOCAL_BROKER_CLIENTS        4                     /* Connections served at once, 32 at most */
+#define LOCAL_BROKER_LISTEN_QUEUE   2                     /* Connection requests waiting while every connection is taken */
+#define LOCAL_BROKER_TOPIC_NODES    32                    /* Levels of the topic filters subscribed, shared by the clients */
+#define LOCAL_BROKER_LEVEL_SIZE     16                    /* Longest level of a topic filter */
+#define LOCAL_BROKER_PACKET_SIZE    512                   /* Longest MQTT packet received, a longer one closes its connection */
+#define LOCAL_BROKER_TCP_WINDOW     (2 * LOCAL_BROKER_PACKET_SIZE)
+#define LOCAL_BROKER_CONNECT_TIMEOUT (5 * NX_IP_PERIODIC_RATE) /* Time allowed between the connection and its CONNECT */
+#define LOCAL_BROKER_SEND_TIMEOUT   (NX_IP_PERIODIC_RATE / 10) /* Longest wait for a packet or the window of a subscriber */
+#define LOCAL_BROKER_STACK_SIZE     2 * DEFAULT_MEMORY_SIZE
+#define LOCAL_BROKER_PRIORITY       DEFAULT_PRIORITY
+
+/* Packet capture configuration, see packet_capture.c. Defined, PACKET_CAPTURE answers a datagram to PACKET_CAPTURE_PORT
+   with the frames the Ethernet driver captured, as a pcap stream. Requires NX_DRIVER_ENABLE_CAPTURE */
+/*
+#define PACKET_CAPTURE
+*/
+#define PACKET_CAPTURE_PORT         5011
+#define PACKET_CAPTURE_DATAGRAM_SIZE 1472                 /* UDP payload of an Ethernet frame, records are not split */
+
+/* Client manager configuration, see mqtt_manager.c. Defined, MQTT_BACKUP_BROKER_NAME keeps a second connection to this
+   broker, which gets a copy of each message as it is generated, whether the primary broker is reachable or not. The
+   events of both clients are processed by the thread of the manager. Add the CA of the broker to trusted_ca_der. */
+/*
+#define MQTT_BACKUP_BROKER_NAME     "broker.emqx.io"
+*/
+#define MQTT_BACKUP_PORT            NXD_MQTT_TLS_PORT
+#define MQTT_BACKUP_QOS             QOS0                  /* The store and its PUBACK window stay with the primary broker */
+/* Defined with MQTT_BACKUP_BROKER_NAME, MQTT_BACKUP_STANDBY keeps the backup connection subscribed and quiet but for
+   its keep alives, in place of the copies: once the primary broker is lost, the store is published through it on the
+   next turn, with no DNS, handshake or subscription first, and through the primary broker again once it is back and
+   the backup one has acknowledged all it got. The primary broker is connected with a clean session then. */
+/*
+#define MQTT_BACKUP_STANDBY
+*/
+#if defined(MQTT_BACKUP_STANDBY) && !defined(MQTT_BACKUP_BROKER_NAME)
+#error "MQTT_BACKUP_STANDBY needs the backup broker of MQTT_BACKUP_BROKER_NAME"
+#endif
+#define MQTT_MANAGER_CONNECTIONS    2                     /* Clients served by the thread of the manager, 32 at most */
+#define MQTT_MANAGER_STACK_SIZE     4 * DEFAULT_MEMORY_SIZE /* Runs the TLS handshakes of the connections it keeps */
+#define MQTT_MANAGER_PRIORITY       MQTT_THREAD_PRIORTY
+
+/* Device statistics configuration, see device_stats.c. Defined, DEVICE_STATS publishes the counters of the link, IP,
+   TCP, packet pools, thread stacks, TLS and MQTT as one CBOR message on DEVICE_STATS_TOPIC, with QoS level 0 */
+/*
+#define DEVICE_STATS
+*/
+#define DEVICE_STATS_TOPIC          CLIENT_ID_STRING "/$SYS/stats" /* A leading $SYS/ is the broker's own, clients may not publish there */
+#define DEVICE_STATS_INTERVAL       (60 * NX_IP_PERIODIC_RATE) /* Period of the messages, the counters are cumulative */
+#ifndef NXD_MQTT_LATENCY_ENABLE
+#define DEVICE_STATS_MESSAGE_SIZE   640                   /* 16 threads with their names, 4 pools, and the counters */
+#else
+#define DEVICE_STATS_MESSAGE_SIZE   (640 + 3 * (16 + 7 * NXD_MQTT_LATENCY_BUCKETS)) /* And the three latency histograms full */
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+/* Flash service configuration, see flash_service.c, the thread the publish store and the firmware update program through */
+#define FLASH_SERVICE_STACK_SIZE    DEFAULT_MEMORY_SIZE
+#define FLASH_SERVICE_PRIORITY      DEFAULT_MAIN_PRIORITY /* Below the MQTT thread, which waits for its requests */
+#define FLASH_SERVICE_QUEUE         4                     /* Requests queued before the next one waits */
+#define FLASH_SERVICE_ERASE_TIMEOUT (4 * NX_IP_PERIODIC_RATE) /* Longest erase of a 128 KB sector, 4 s by the byte */
+#define FLASH_SERVICE_VOLTAGE_RANGE FLASH_VOLTAGE_RANGE_3 /* 2.7 to 3.6 V, by the word. FLASH_VOLTAGE_RANGE_4, by the double word, needs VPP */
+
+/* Firmware update configuration, see ota_update.c. Defined, OTA_UPDATE programs the images published on OTA_TOPIC_NAME
+   into the other flash bank and boots them once their signature is verified with the key of ota_update.key.h */
+/*
+#define OTA_UPDATE
+*/
+#define OTA_TOPIC_NAME              "Firmware"            /* Subscribed with QoS level 1, each chunk is needed */
+
+/* Dual stack configuration, see broker_connect.c. Defined, MQTT_DUAL_STACK enables IPv6 and connects to the broker
+   over the family whose TCP connection is established first, IPv6 given a head start. make DUAL_STACK=1 defines it. */
+/*
+#define MQTT_DUAL_STACK
+*/
+#define BROKER_CONNECT_ATTEMPT_DELAY (NX_IP_PERIODIC_RATE / 4) /* Head start of the preferred family, 250 ms of RFC 8305 */
+#define BROKER_CONNECT_POLL         (NX_IP_PERIODIC_RATE / 50) /* Period the race checks the connections at */
+#define BROKER_CONNECT_WINDOW       1460                  /* Receive window of the race sockets, no data is received */
+
+/* ECDHE precompute configuration, see ecdhe_precompute.c, with NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS in nx_user.h */
+#define ECDHE_PRECOMPUTE_STACK_SIZE 2 * DEFAULT_MEMORY_SIZE /* The scalar multiplication, its scratch is in the metadata */
+#define ECDHE_PRECOMPUTE_PRIORITY   (WORK_QUEUE_PRIORITY + 1) /* Below every other thread, the key pairs are made while idle */
+#define ECDHE_PRECOMPUTE_CURVES     2                     /* First curves of nx_crypto_ecc_curves, x25519 and secp256r1 */
+#define ECDHE_PRECOMPUTE_KEYS       2                     /* Key pairs kept ready on each curve */
+
 /* TLS  configuration */ 
-#define CRYPTO_METADATA_CLIENT_SIZE 11600   
+#ifdef NX_CRYPTO_STM32_HW
+#define CRYPTO_METADATA_HW_SIZE     1024                  /* The hash contexts of the HASH methods keep its context swap registers */
+#else
+#define CRYPTO_METADATA_HW_SIZE     0
+#endif
+#if defined(NX_SECURE_TLS_ENABLE_TLS_1_3)
+#define CRYPTO_METADATA_CLIENT_SIZE (12288 + CRYPTO_METADATA_HW_SIZE) /* TLS 1.3 does not share the handshake metadata, and adds the HKDF */
+#elif defined(MQTT_TLS_PSK_ONLY)
+#define CRYPTO_METADATA_CLIENT_SIZE (3080 + CRYPTO_METADATA_HW_SIZE) /* 2 AES-CCM states and the PRF in the shared area, the SHA-256 handshake hash and its copy */
+#else
+#define CRYPTO_METADATA_CLIENT_SIZE (8148 + CRYPTO_METADATA_HW_SIZE) /* 4740 bytes more with NX_CRYPTO_GCM_TABLE_BITS 8, 1032 more with NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS 3 */
+#endif
+#ifdef MQTT_TLS_PSK_ONLY
+#define TLS_PACKET_BUFFER_SIZE      1024                  /* The handshake messages only, no certificate chain */
+#else
 #define TLS_PACKET_BUFFER_SIZE      4000 
+#endif
+#ifdef MQTT_BACKUP_BROKER_NAME
+#define TLS_ARENA_SESSIONS          2                     /* TLS sessions open at the same time, the backup broker has one too */
+#else
+#define TLS_ARENA_SESSIONS          1                     /* TLS sessions open at the same time, e.g. 2 with a backup broker */
+#endif
+#define TLS_ARENA_SIZE              NX_SECURE_TLS_ARENA_SIZE(TLS_ARENA_SESSIONS, CRYPTO_METADATA_CLIENT_SIZE, TLS_PACKET_BUFFER_SIZE)
+
+/* TLS PSK credentials shared with the broker. When it accepts a PSK ciphersuite, the handshake
+   skips the certificate chain and its public key operations. Requires NX_SECURE_ENABLE_PSK_CIPHERSUITES in nx_user.h,
+   and are the only credentials of the make TLS_PSK=1 build, MQTT_TLS_PSK_ONLY. */
+#ifdef MQTT_TLS_PSK_ONLY
+#define MQTT_TLS_PSK_IDENTITY       "MQTT_client_ID"
+#define MQTT_TLS_PSK_KEY            "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"
+#else
+/*
+#define MQTT_TLS_PSK_IDENTITY       "MQTT_client_ID"
+#define MQTT_TLS_PSK_KEY            "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"
+*/
+#endif
   
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
 #define PRINT_IP_ADDRESS(addr)           do { \
-                                              printf("STM32 %s: %lu.%lu.%lu.%lu \n", #addr, \
+                                              LOG_PRINTF("STM32 %s: %lu.%lu.%lu.%lu \n", #addr, \
                                                 (addr >> 24) & 0xff,                        \
                                                   (addr >> 16) & 0xff,                      \
                                                     (addr >> 8) & 0xff,                     \
@@ -104,6 +449,9 @@ extern "C" {
 UINT MX_NetXDuo_Init(VOID *memory_ptr);
 
 /* USER CODE BEGIN EFP */
+UINT tls_setup_callback(NXD_MQTT_CLIENT *client_pt, NX_SECURE_TLS_SESSION *TLS_session_ptr,
+                        NX_SECURE_X509_CERT *certificate_ptr, NX_SECURE_X509_CERT *trusted_certificate_ptr);
+void message_generate(uint32_t *RandomNbr);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,217 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    broker_connect.c
+  * @author  MCD Application Team
+  * @brief   Address of the broker raced over IPv6 and IPv4, RFC 8305
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "broker_connect.h"
+#include "dns_resolver.h"
+
+#ifdef MQTT_DUAL_STACK
+
+#ifndef FEATURE_NX_IPV6
+#error "MQTT_DUAL_STACK needs IPv6, make DUAL_STACK=1 leaves NX_DISABLE_IPV6 undefined in nx_user.h"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define BROKER_CONNECT_IPV6           0U
+#define BROKER_CONNECT_IPV4           1U
+#define BROKER_CONNECT_FAMILIES       2U
+#define BROKER_CONNECT_NONE           BROKER_CONNECT_FAMILIES
+
+/* Private variables ---------------------------------------------------------*/
+static NX_TCP_SOCKET broker_connect_sockets[BROKER_CONNECT_FAMILIES];
+
+/* Family of the last connection established, IPv6 first as RFC 8305 prefers it. */
+static UINT broker_connect_preferred = BROKER_CONNECT_IPV6;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT broker_connect_race(NX_IP *ip_ptr, NXD_ADDRESS *addresses, UINT port, ULONG wait_option);
+static UINT broker_connect_start(UINT family, NXD_ADDRESS *address_ptr, UINT port);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Get the address of the broker on the family that connects first. Only the first call waits
+*         for the DNS servers, for the A record, the first connection goes over IPv4 unless the AAAA
+*         record is known already.
+* @param  ip_ptr: IP instance of the connections
+* @param  host_name: name of the broker, kept by the caller while the resolver runs
+* @param  port: TCP port of the broker
+* @param  address_ptr: address of the broker, set
+* @param  wait_option: ticks the race may last
+* @retval NX_SUCCESS, NX_NOT_CONNECTED when no family connected in time, or the error of dns_resolver_host_get()
+*/
+UINT broker_connect_address_get(NX_IP *ip_ptr, const CHAR *host_name, UINT port,
+                                NXD_ADDRESS *address_ptr, ULONG wait_option)
+{
+  NXD_ADDRESS addresses[BROKER_CONNECT_FAMILIES];
+  UINT known6;
+  UINT winner;
+  UINT ret;
+
+  /* Ask for the AAAA record first, the resolver thread looks it up while the A record is waited for. */
+  addresses[BROKER_CONNECT_IPV6].nxd_ip_version = NX_IP_VERSION_V6;
+  known6 = (dns_resolver_host6_get(host_name, addresses[BROKER_CONNECT_IPV6].nxd_ip_address.v6) == NX_SUCCESS);
+
+  addresses[BROKER_CONNECT_IPV4].nxd_ip_version = NX_IP_VERSION_V4;
+  ret = dns_resolver_host_get(host_name, &addresses[BROKER_CONNECT_IPV4].nxd_ip_address.v4, DEFAULT_TIMEOUT);
+
+  if (ret != NX_SUCCESS)
+  {
+    if (!known6)
+    {
+      return ret;
+    }
+
+    *address_ptr = addresses[BROKER_CONNECT_IPV6];
+    return NX_SUCCESS;
+  }
+
+  if (!known6)
+  {
+    *address_ptr = addresses[BROKER_CONNECT_IPV4];
+    return NX_SUCCESS;
+  }
+
+  winner = broker_connect_race(ip_ptr, addresses, port, wait_option);
+  if (winner == BROKER_CONNECT_NONE)
+  {
+    return NX_NOT_CONNECTED;
+  }
+
+  /* The next race starts with the family that answered, RFC 8305 section 5. */
+  broker_connect_preferred = winner;
+  *address_ptr = addresses[winner];
+
+  return NX_SUCCESS;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Race a TCP connection on each family, the preferred one BROKER_CONNECT_ATTEMPT_DELAY ahead,
+*         then reset both.
+* @param  ip_ptr: IP instance of the connections
+* @param  addresses: IPv6 and IPv4 addresses of the broker
+* @param  port: TCP port of the broker
+* @param  wait_option: ticks the race may last
+* @retval Family of the first connection established, BROKER_CONNECT_NONE when none was in time
+*/
+static UINT broker_connect_race(NX_IP *ip_ptr, NXD_ADDRESS *addresses, UINT port, ULONG wait_option)
+{
+  NX_TCP_SOCKET *socket_ptr;
+  UINT started[BROKER_CONNECT_FAMILIES] = {NX_FALSE, NX_FALSE};
+  UINT failed[BROKER_CONNECT_FAMILIES] = {NX_FALSE, NX_FALSE};
+  UINT created[BROKER_CONNECT_FAMILIES] = {NX_FALSE, NX_FALSE};
+  UINT first = broker_connect_preferred;
+  UINT second = BROKER_CONNECT_IPV4 - first;
+  UINT winner = BROKER_CONNECT_NONE;
+  UINT family;
+  ULONG start;
+  ULONG elapsed;
+
+  for (family = 0U; family < BROKER_CONNECT_FAMILIES; family++)
+  {
+    socket_ptr = &broker_connect_sockets[family];
+    created[family] = (nx_tcp_socket_create(ip_ptr, socket_ptr, "Broker race", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                                            NX_IP_TIME_TO_LIVE, BROKER_CONNECT_WINDOW, NX_NULL, NX_NULL) == NX_SUCCESS);
+    failed[family] = !created[family] || (nx_tcp_client_socket_bind(socket_ptr, NX_ANY_PORT, NX_NO_WAIT) != NX_SUCCESS);
+  }
+
+  start = tx_time_get();
+  for (;;)
+  {
+    elapsed = tx_time_get() - start;
+
+    /* The preferred family at once, the other one after the delay or as soon as the first failed. */
+    if (!started[first] && !failed[first])
+    {
+      started[first] = NX_TRUE;
+      failed[first] = !broker_connect_start(first, &addresses[first], port);
+    }
+
+    if (!started[second] && !failed[second] && (failed[first] || (elapsed >= BROKER_CONNECT_ATTEMPT_DELAY)))
+    {
+      started[second] = NX_TRUE;
+      failed[second] = !broker_connect_start(second, &addresses[second], port);
+    }
+
+    for (family = 0U; family < BROKER_CONNECT_FAMILIES; family++)
+    {
+      if (!started[family] || failed[family])
+      {
+        continue;
+      }
+
+      socket_ptr = &broker_connect_sockets[family];
+      if (socket_ptr -> nx_tcp_socket_state == NX_TCP_ESTABLISHED)
+      {
+        winner = family;
+        break;
+      }
+
+      /* Reset by the broker, or the SYN retries are over. */
+      if (socket_ptr -> nx_tcp_socket_state == NX_TCP_CLOSED)
+      {
+        failed[family] = NX_TRUE;
+      }
+    }
+
+    if ((winner != BROKER_CONNECT_NONE) || (failed[first] && failed[second]) || (elapsed >= wait_option))
+    {
+      break;
+    }
+
+    tx_thread_sleep(BROKER_CONNECT_POLL);
+  }
+
+  /* The MQTT client makes a connection of its own, both are reset. */
+  for (family = 0U; family < BROKER_CONNECT_FAMILIES; family++)
+  {
+    socket_ptr = &broker_connect_sockets[family];
+    if (!created[family])
+    {
+      continue;
+    }
+
+    nx_tcp_socket_disconnect(socket_ptr, NX_NO_WAIT);
+    nx_tcp_client_socket_unbind(socket_ptr);
+    nx_tcp_socket_delete(socket_ptr);
+  }
+
+  return winner;
+}
+
+/**
+* @brief  Send the SYN of a family, without waiting for the answer.
+* @param  family: BROKER_CONNECT_IPV6 or BROKER_CONNECT_IPV4
+* @param  address_ptr: address of the broker on the family
+* @param  port: TCP port of the broker
+* @retval NX_TRUE while the connection is in progress, NX_FALSE without an address or a route on the family
+*/
+static UINT broker_connect_start(UINT family, NXD_ADDRESS *address_ptr, UINT port)
+{
+  UINT ret;
+
+  ret = nxd_tcp_client_socket_connect(&broker_connect_sockets[family], address_ptr, port, NX_NO_WAIT);
+
+  return (ret == NX_IN_PROGRESS) || (ret == NX_SUCCESS);
+}
+
+#endif /* MQTT_DUAL_STACK */
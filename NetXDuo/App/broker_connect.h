@@ -0,0 +1,48 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    broker_connect.h
+  * @author  MCD Application Team
+  * @brief   Address of the broker raced over IPv6 and IPv4, RFC 8305
+  *
+  *          broker_connect_address_get() resolves the broker with its A record,
+  *          while the resolver thread looks up its AAAA record. Once both are
+  *          known, TCP connections to the port race on the two families: the
+  *          family that won last starts, IPv6 the first time, the other one
+  *          BROKER_CONNECT_ATTEMPT_DELAY later, or as soon as the first fails.
+  *          The address of the first connection established is returned, both
+  *          connections are then reset and the MQTT client connects to it over
+  *          TLS. A broken family costs the delay, not a TCP connect timeout.
+  *          With one family known, its address is returned without a race.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BROKER_CONNECT_H__
+#define __BROKER_CONNECT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT broker_connect_address_get(NX_IP *ip_ptr, const CHAR *host_name, UINT port,
+                                NXD_ADDRESS *address_ptr, ULONG wait_option);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __BROKER_CONNECT_H__ */
@@ -0,0 +1,275 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cbor_writer.c
+  * @author  MCD Application Team
+  * @brief   Streaming encoder of compact binary payloads, in CBOR (RFC 8949)
+  *
+  *          Each item starts with a byte holding its major type in the top 3
+  *          bits, and in the low 5 bits either its value, up to 23, or the size
+  *          of the big endian value that follows, 1, 2 or 4 bytes. Integers
+  *          from -24 to 23 and the headers of short strings and arrays thus
+  *          take one byte, so a time series encoded as its first value and the
+  *          deltas of the next ones takes one byte per slow moving reading,
+  *          against its decimal text. The values are written at their shortest,
+  *          the preferred serialization of RFC 8949, and any CBOR decoder reads
+  *          them back.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cbor_writer.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+/* Major types, in the top 3 bits of the initial byte */
+#define CBOR_MAJOR_UINT               0x00U
+#define CBOR_MAJOR_NEGATIVE_INT       0x20U
+#define CBOR_MAJOR_BYTES              0x40U
+#define CBOR_MAJOR_TEXT               0x60U
+#define CBOR_MAJOR_ARRAY              0x80U
+#define CBOR_MAJOR_MAP                0xA0U
+#define CBOR_MAJOR_SIMPLE             0xE0U
+
+/* Additional information of the initial byte: the value itself, or the size of the value after it */
+#define CBOR_VALUE_MAX                23U
+#define CBOR_VALUE_1_BYTE             24U
+#define CBOR_VALUE_2_BYTES            25U
+#define CBOR_VALUE_4_BYTES            26U
+
+/* Private function prototypes -----------------------------------------------*/
+static UCHAR *cbor_reserve(CBOR_WRITER *writer, UINT length);
+static VOID cbor_encode_head(CBOR_WRITER *writer, UCHAR major, ULONG value);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start encoding into a buffer.
+* @param  writer: writer to initialize
+* @param  buffer: buffer of the encoded items, the payload of the message
+* @param  size: size of the buffer in bytes
+* @retval None
+*/
+VOID cbor_writer_init(CBOR_WRITER *writer, UCHAR *buffer, UINT size)
+{
+  writer -> cbor_writer_start = buffer;
+  writer -> cbor_writer_size = size;
+  writer -> cbor_writer_length = 0;
+  writer -> cbor_writer_overflow = TX_FALSE;
+}
+
+/**
+* @brief  End the encoding and get its length.
+* @param  writer: writer of the items
+* @param  length_ptr: bytes encoded
+* @retval CBOR_WRITER_SUCCESS, or CBOR_WRITER_OVERFLOW when an item did not fit and the encoding is cut
+*/
+UINT cbor_writer_finish(CBOR_WRITER *writer, UINT *length_ptr)
+{
+  *length_ptr = writer -> cbor_writer_length;
+
+  return writer -> cbor_writer_overflow ? CBOR_WRITER_OVERFLOW : CBOR_WRITER_SUCCESS;
+}
+
+/**
+* @brief  Encode an unsigned integer.
+* @param  writer: writer of the items
+* @param  value: integer, 1 to 5 bytes encoded
+* @retval None
+*/
+VOID cbor_encode_uint(CBOR_WRITER *writer, ULONG value)
+{
+  cbor_encode_head(writer, CBOR_MAJOR_UINT, value);
+}
+
+/**
+* @brief  Encode a signed integer, a negative one as -1 - n with n unsigned.
+* @param  writer: writer of the items
+* @param  value: integer, 1 to 5 bytes encoded
+* @retval None
+*/
+VOID cbor_encode_int(CBOR_WRITER *writer, LONG value)
+{
+  if (value < 0)
+  {
+    cbor_encode_head(writer, CBOR_MAJOR_NEGATIVE_INT, ~(ULONG)value);
+  }
+  else
+  {
+    cbor_encode_head(writer, CBOR_MAJOR_UINT, (ULONG)value);
+  }
+}
+
+/**
+* @brief  Encode a byte string.
+* @param  writer: writer of the items
+* @param  data: bytes of the string
+* @param  length: length of the string
+* @retval None
+*/
+VOID cbor_encode_bytes(CBOR_WRITER *writer, const UCHAR *data, UINT length)
+{
+  UCHAR *buffer;
+
+  cbor_encode_head(writer, CBOR_MAJOR_BYTES, length);
+
+  buffer = cbor_reserve(writer, length);
+  if (buffer != TX_NULL)
+  {
+    memcpy(buffer, data, length);
+  }
+}
+
+/**
+* @brief  Encode a text string.
+* @param  writer: writer of the items
+* @param  text: UTF-8 text, without terminating null
+* @param  length: length of the text in bytes
+* @retval None
+*/
+VOID cbor_encode_text(CBOR_WRITER *writer, const CHAR *text, UINT length)
+{
+  UCHAR *buffer;
+
+  cbor_encode_head(writer, CBOR_MAJOR_TEXT, length);
+
+  buffer = cbor_reserve(writer, length);
+  if (buffer != TX_NULL)
+  {
+    memcpy(buffer, text, length);
+  }
+}
+
+/**
+* @brief  Start an array, its items are the next ones encoded.
+* @param  writer: writer of the items
+* @param  count: number of items of the array
+* @retval None
+*/
+VOID cbor_encode_array(CBOR_WRITER *writer, UINT count)
+{
+  cbor_encode_head(writer, CBOR_MAJOR_ARRAY, count);
+}
+
+/**
+* @brief  Start a map, its keys and values are the next items encoded, in turn.
+* @param  writer: writer of the items
+* @param  count: number of key and value pairs of the map
+* @retval None
+*/
+VOID cbor_encode_map(CBOR_WRITER *writer, UINT count)
+{
+  cbor_encode_head(writer, CBOR_MAJOR_MAP, count);
+}
+
+/**
+* @brief  Encode a single precision float, in its 4 bytes whatever its value.
+* @param  writer: writer of the items
+* @param  value: encoded
+* @retval None
+*/
+VOID cbor_encode_float(CBOR_WRITER *writer, float value)
+{
+  UCHAR *buffer;
+  ULONG bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  buffer = cbor_reserve(writer, 5);
+  if (buffer != TX_NULL)
+  {
+    buffer[0] = (UCHAR)(CBOR_MAJOR_SIMPLE | CBOR_VALUE_4_BYTES);
+    buffer[1] = (UCHAR)(bits >> 24);
+    buffer[2] = (UCHAR)(bits >> 16);
+    buffer[3] = (UCHAR)(bits >> 8);
+    buffer[4] = (UCHAR)bits;
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Take space for an item at the end of the encoding.
+* @param  writer: writer of the items
+* @param  length: bytes of the item
+* @retval Space of the item, or TX_NULL when it does not fit or an item before it did not
+*/
+static UCHAR *cbor_reserve(CBOR_WRITER *writer, UINT length)
+{
+  UCHAR *buffer;
+
+  if (writer -> cbor_writer_overflow ||
+      (length > (writer -> cbor_writer_size - writer -> cbor_writer_length)))
+  {
+    writer -> cbor_writer_overflow = TX_TRUE;
+    return TX_NULL;
+  }
+
+  buffer = writer -> cbor_writer_start + writer -> cbor_writer_length;
+  writer -> cbor_writer_length += length;
+
+  return buffer;
+}
+
+/**
+* @brief  Encode the initial byte of an item and the value that follows it, at its shortest.
+* @param  writer: writer of the items
+* @param  major: major type of the item
+* @param  value: integer, length of a string or count of a container
+* @retval None
+*/
+static VOID cbor_encode_head(CBOR_WRITER *writer, UCHAR major, ULONG value)
+{
+  UCHAR *buffer;
+
+  if (value <= CBOR_VALUE_MAX)
+  {
+    buffer = cbor_reserve(writer, 1);
+    if (buffer != TX_NULL)
+    {
+      buffer[0] = (UCHAR)(major | value);
+    }
+  }
+  else if (value <= 0xFFU)
+  {
+    buffer = cbor_reserve(writer, 2);
+    if (buffer != TX_NULL)
+    {
+      buffer[0] = (UCHAR)(major | CBOR_VALUE_1_BYTE);
+      buffer[1] = (UCHAR)value;
+    }
+  }
+  else if (value <= 0xFFFFU)
+  {
+    buffer = cbor_reserve(writer, 3);
+    if (buffer != TX_NULL)
+    {
+      buffer[0] = (UCHAR)(major | CBOR_VALUE_2_BYTES);
+      buffer[1] = (UCHAR)(value >> 8);
+      buffer[2] = (UCHAR)value;
+    }
+  }
+  else
+  {
+    buffer = cbor_reserve(writer, 5);
+    if (buffer != TX_NULL)
+    {
+      buffer[0] = (UCHAR)(major | CBOR_VALUE_4_BYTES);
+      buffer[1] = (UCHAR)(value >> 24);
+      buffer[2] = (UCHAR)(value >> 16);
+      buffer[3] = (UCHAR)(value >> 8);
+      buffer[4] = (UCHAR)value;
+    }
+  }
+}
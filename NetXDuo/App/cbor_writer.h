@@ -0,0 +1,67 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cbor_writer.h
+  * @author  MCD Application Team
+  * @brief   Streaming encoder of compact binary payloads, in CBOR (RFC 8949)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CBOR_WRITER_H__
+#define __CBOR_WRITER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct CBOR_WRITER_STRUCT
+{
+  /* Buffer the items are encoded into. */
+  UCHAR *cbor_writer_start;
+  UINT   cbor_writer_size;
+
+  /* Bytes encoded so far. */
+  UINT   cbor_writer_length;
+
+  /* Set by the first item that did not fit, the items after it are not encoded. */
+  UINT   cbor_writer_overflow;
+} CBOR_WRITER;
+
+/* Exported constants --------------------------------------------------------*/
+/* Status values */
+#define CBOR_WRITER_SUCCESS           0
+#define CBOR_WRITER_OVERFLOW          1   /* An item did not fit in the buffer  */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* The items are checked for space as they are encoded, and only once at the end
+   by the caller, with cbor_writer_finish(). */
+VOID cbor_writer_init(CBOR_WRITER *writer, UCHAR *buffer, UINT size);
+UINT cbor_writer_finish(CBOR_WRITER *writer, UINT *length_ptr);
+
+VOID cbor_encode_uint(CBOR_WRITER *writer, ULONG value);
+VOID cbor_encode_int(CBOR_WRITER *writer, LONG value);
+VOID cbor_encode_bytes(CBOR_WRITER *writer, const UCHAR *data, UINT length);
+VOID cbor_encode_text(CBOR_WRITER *writer, const CHAR *text, UINT length);
+VOID cbor_encode_array(CBOR_WRITER *writer, UINT count);
+VOID cbor_encode_map(CBOR_WRITER *writer, UINT count);
+VOID cbor_encode_float(CBOR_WRITER *writer, float value);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CBOR_WRITER_H__ */
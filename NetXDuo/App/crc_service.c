@@ -0,0 +1,395 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    crc_service.c
+  * @author  MCD Application Team
+  * @brief   CRC-32 of the persistent records and the update chunks, by the CRC unit
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "crc_service.h"
+#include "thread_profile.h"
+#include "main.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define CRC_SERVICE_POLYNOMIAL        0x04C11DB7U
+
+/* Words of one transfer, the width of the NDTR register */
+#define CRC_SERVICE_MAX_WORDS         0xFFFFU
+
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef crc_service_dma;
+static TX_MUTEX crc_service_mutex;
+static TX_SEMAPHORE crc_service_semaphore;
+
+/* Set from crc_service_init() on */
+static UINT crc_service_ready;
+
+static volatile UINT crc_service_error;
+
+/* Private function prototypes -----------------------------------------------*/
+static ULONG crc_service_words(ULONG crc, const UCHAR *data, ULONG words);
+static ULONG crc_service_software(ULONG crc, const UCHAR *data, ULONG words);
+static VOID  crc_service_seed(ULONG crc);
+static VOID  crc_service_cpu_feed(const UCHAR *data, ULONG words);
+static UINT  crc_service_dma_feed(const UCHAR *data, ULONG words);
+static UINT  crc_service_reachable(const VOID *address, ULONG size);
+static VOID  crc_service_complete(DMA_HandleTypeDef *hdma);
+static VOID  crc_service_failed(DMA_HandleTypeDef *hdma);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Clock the CRC unit and set up DMA2 stream 2 to write words into its data register,
+*         with the mutex and the semaphore of the service.
+* @param  None
+* @retval TX_SUCCESS, the error of the mutex or semaphore creation, or TX_START_ERROR
+*/
+UINT crc_service_init(VOID)
+{
+  UINT ret;
+
+  ret = tx_mutex_create(&crc_service_mutex, "CRC Service Mutex", TX_INHERIT);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_semaphore_create(&crc_service_semaphore, "CRC Service Semaphore", 0);
+  if (ret != TX_SUCCESS)
+  {
+    tx_mutex_delete(&crc_service_mutex);
+    return ret;
+  }
+
+  __HAL_RCC_CRC_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* The source walks the data, the destination stays on CRC_DR. The FIFO is required in
+     memory-to-memory mode. */
+  crc_service_dma.Instance = DMA2_Stream2;
+  crc_service_dma.Init.Channel = DMA_CHANNEL_0;
+  crc_service_dma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  crc_service_dma.Init.PeriphInc = DMA_PINC_ENABLE;
+  crc_service_dma.Init.MemInc = DMA_MINC_DISABLE;
+  crc_service_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  crc_service_dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  crc_service_dma.Init.Mode = DMA_NORMAL;
+  crc_service_dma.Init.Priority = DMA_PRIORITY_LOW;
+  crc_service_dma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+  crc_service_dma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+  crc_service_dma.Init.MemBurst = DMA_MBURST_SINGLE;
+  crc_service_dma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+  if (HAL_DMA_Init(&crc_service_dma) != HAL_OK)
+  {
+    tx_semaphore_delete(&crc_service_semaphore);
+    tx_mutex_delete(&crc_service_mutex);
+    return TX_START_ERROR;
+  }
+  crc_service_dma.XferCpltCallback = crc_service_complete;
+  crc_service_dma.XferErrorCallback = crc_service_failed;
+
+  HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, CRC_SERVICE_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+
+  crc_service_ready = 1U;
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Start a CRC.
+* @param  context_ptr: context of the CRC
+* @retval None
+*/
+VOID crc_service_begin(CRC_SERVICE_CONTEXT *context_ptr)
+{
+  context_ptr -> crc = CRC_SERVICE_INITIAL;
+  context_ptr -> pending_count = 0U;
+}
+
+/**
+* @brief  Add bytes to a CRC. Calls may cut the data anywhere, the CRC is that of the whole.
+* @param  context_ptr: context of the CRC
+* @param  data: bytes, any alignment
+* @param  size: number of bytes
+* @retval None
+*/
+VOID crc_service_update(CRC_SERVICE_CONTEXT *context_ptr, const VOID *data, ULONG size)
+{
+  const UCHAR *byte_ptr = (const UCHAR *)data;
+  ULONG words;
+
+  /* The word started by the previous call first. */
+  while ((context_ptr -> pending_count != 0U) && (size != 0U))
+  {
+    context_ptr -> pending[context_ptr -> pending_count++] = *byte_ptr++;
+    size--;
+
+    if (context_ptr -> pending_count == sizeof(ULONG))
+    {
+      context_ptr -> crc = crc_service_words(context_ptr -> crc, context_ptr -> pending, 1U);
+      context_ptr -> pending_count = 0U;
+    }
+  }
+
+  words = size / sizeof(ULONG);
+  if (words != 0U)
+  {
+    context_ptr -> crc = crc_service_words(context_ptr -> crc, byte_ptr, words);
+    byte_ptr += words * sizeof(ULONG);
+    size -= words * sizeof(ULONG);
+  }
+
+  if (size != 0U)
+  {
+    memcpy(context_ptr -> pending, byte_ptr, size);
+    context_ptr -> pending_count = size;
+  }
+}
+
+/**
+* @brief  End a CRC, the last bytes completed with zeros to a word.
+* @param  context_ptr: context of the CRC
+* @retval CRC of the bytes given to crc_service_update()
+*/
+ULONG crc_service_end(CRC_SERVICE_CONTEXT *context_ptr)
+{
+  if (context_ptr -> pending_count != 0U)
+  {
+    memset(&context_ptr -> pending[context_ptr -> pending_count], 0,
+           sizeof(ULONG) - context_ptr -> pending_count);
+    context_ptr -> crc = crc_service_words(context_ptr -> crc, context_ptr -> pending, 1U);
+    context_ptr -> pending_count = 0U;
+  }
+
+  return context_ptr -> crc;
+}
+
+/**
+* @brief  CRC of a block, in one call.
+* @param  data: bytes, any alignment
+* @param  size: number of bytes
+* @retval CRC of the bytes
+*/
+ULONG crc_service_block(const VOID *data, ULONG size)
+{
+  CRC_SERVICE_CONTEXT context;
+
+  crc_service_begin(&context);
+  crc_service_update(&context, data, size);
+
+  return crc_service_end(&context);
+}
+
+/**
+* @brief  This function handles DMA2 stream2 global interrupt, the CRC feed.
+* @param  None
+* @retval None
+*/
+void DMA2_Stream2_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+  HAL_DMA_IRQHandler(&crc_service_dma);
+  THREAD_PROFILE_ISR_EXIT();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Continue a CRC over whole words, by the unit when the calling thread gets it.
+* @param  crc: CRC of the data before the words
+* @param  data: words, any alignment
+* @param  words: number of words, not zero
+* @retval CRC of the data and the words
+*/
+static ULONG crc_service_words(ULONG crc, const UCHAR *data, ULONG words)
+{
+  ULONG count;
+  UINT dma;
+
+  /* tx_mutex_get() fails from the timer thread and before the kernel runs. */
+  if (!crc_service_ready || (__get_IPSR() != 0U) || (__get_PRIMASK() != 0U) ||
+      (tx_mutex_get(&crc_service_mutex, TX_WAIT_FOREVER) != TX_SUCCESS))
+  {
+    return crc_service_software(crc, data, words);
+  }
+
+  dma = (words * sizeof(ULONG) >= CRC_SERVICE_DMA_THRESHOLD) &&
+        ((((ULONG)data) & (sizeof(ULONG) - 1U)) == 0U) &&
+        crc_service_reachable(data, words * sizeof(ULONG));
+
+  crc_service_seed(crc);
+
+  while (words != 0U)
+  {
+    count = (words > CRC_SERVICE_MAX_WORDS) ? CRC_SERVICE_MAX_WORDS : words;
+
+    if (!dma || !crc_service_dma_feed(data, count))
+    {
+      crc_service_cpu_feed(data, count);
+    }
+
+    data += count * sizeof(ULONG);
+    words -= count;
+  }
+
+  crc = CRC -> DR;
+
+  tx_mutex_put(&crc_service_mutex);
+
+  return crc;
+}
+
+/**
+* @brief  Continue a CRC over whole words on the CPU alone, without the unit.
+* @param  crc: CRC of the data before the words
+* @param  data: words, any alignment
+* @param  words: number of words
+* @retval CRC of the data and the words
+*/
+static ULONG crc_service_software(ULONG crc, const UCHAR *data, ULONG words)
+{
+  ULONG word;
+  UINT bit;
+
+  while (words-- != 0U)
+  {
+    memcpy(&word, data, sizeof(word));
+    data += sizeof(word);
+
+    crc ^= word;
+    for (bit = 0; bit < 32U; bit++)
+    {
+      crc = ((crc & 0x80000000U) != 0U) ? ((crc << 1) ^ CRC_SERVICE_POLYNOMIAL) : (crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+/**
+* @brief  Bring the unit to a CRC value. The unit resets to CRC_SERVICE_INITIAL only: the word
+*         written after the reset is the one its 32 steps take to the value, found by running
+*         the steps backwards from it. Called with the mutex held.
+* @param  crc: value the unit continues from
+* @retval None
+*/
+static VOID crc_service_seed(ULONG crc)
+{
+  UINT bit;
+
+  CRC -> CR = CRC_CR_RESET;
+
+  if (crc == CRC_SERVICE_INITIAL)
+  {
+    return;
+  }
+
+  /* A step shifts left and adds the polynomial when the top bit goes out, which sets the
+     bottom bit: the bottom bit tells the steps that added it. */
+  for (bit = 0; bit < 32U; bit++)
+  {
+    crc = ((crc & 1U) != 0U) ? (((crc ^ CRC_SERVICE_POLYNOMIAL) >> 1) | 0x80000000U) : (crc >> 1);
+  }
+
+  CRC -> DR = crc ^ CRC_SERVICE_INITIAL;
+}
+
+/**
+* @brief  Write words into the unit from the CPU. Called with the mutex held.
+* @param  data: words, any alignment
+* @param  words: number of words
+* @retval None
+*/
+static VOID crc_service_cpu_feed(const UCHAR *data, ULONG words)
+{
+  ULONG word;
+
+  while (words-- != 0U)
+  {
+    memcpy(&word, data, sizeof(word));
+    data += sizeof(word);
+    CRC -> DR = word;
+  }
+}
+
+/**
+* @brief  Write words into the unit by the DMA, the calling thread suspended until they are.
+*         Called with the mutex held.
+* @param  data: words, word aligned and reachable by the DMA
+* @param  words: number of words, up to CRC_SERVICE_MAX_WORDS
+* @retval 1 when the unit took the words, 0 when the CPU is to write them, the unit left as before
+*/
+static UINT crc_service_dma_feed(const UCHAR *data, ULONG words)
+{
+  ULONG crc = CRC -> DR;
+
+  crc_service_error = 0U;
+
+  if (HAL_DMA_Start_IT(&crc_service_dma, (uint32_t)data, (uint32_t)&CRC -> DR, words) != HAL_OK)
+  {
+    return 0U;
+  }
+
+  tx_semaphore_get(&crc_service_semaphore, TX_WAIT_FOREVER);
+
+  /* A bus error aborted the transfer after an unknown number of words. */
+  if (crc_service_error)
+  {
+    crc_service_seed(crc);
+    return 0U;
+  }
+
+  return 1U;
+}
+
+/**
+* @brief  Tell whether the DMA reaches a buffer: the CCM-RAM is on the data bus of the CPU only.
+* @param  address: start of the buffer
+* @param  size: bytes of the buffer, not zero
+* @retval 1 when reachable, 0 otherwise
+*/
+static UINT crc_service_reachable(const VOID *address, ULONG size)
+{
+  ULONG start = (ULONG)address;
+  ULONG end = start + size - 1U;
+
+  return ((end < CCMDATARAM_BASE) || (start > CCMDATARAM_END)) ? 1U : 0U;
+}
+
+/**
+* @brief  Transfer complete, resume the thread waiting for it. Called from the DMA interrupt.
+* @param  hdma: DMA handle
+* @retval None
+*/
+static VOID crc_service_complete(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  tx_semaphore_put(&crc_service_semaphore);
+}
+
+/**
+* @brief  Transfer aborted on an error, resume the thread waiting for it. Called from the DMA interrupt.
+* @param  hdma: DMA handle
+* @retval None
+*/
+static VOID crc_service_failed(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  crc_service_error = 1U;
+  tx_semaphore_put(&crc_service_semaphore);
+}
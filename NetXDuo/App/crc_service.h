@@ -0,0 +1,75 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    crc_service.h
+  * @author  MCD Application Team
+  * @brief   CRC-32 of the persistent records and the update chunks, by the CRC unit
+  *
+  *          The CRC computed is CRC-32/MPEG-2, polynomial 0x04C11DB7, initial
+  *          value 0xFFFFFFFF, neither reflected nor complemented, over the
+  *          data taken as little endian 32-bit words, the last one completed
+  *          with zero bytes: the unit only takes whole words. In Python,
+  *          crcmod.predefined.mkCrcFun("crc-32-mpeg") of the data padded to a
+  *          multiple of 4 bytes, each word byte reversed, gives the same value.
+  *          The words are written to the CRC unit by the CPU, or by the
+  *          memory-to-memory stream 2 of DMA2 for CRC_SERVICE_DMA_THRESHOLD
+  *          bytes or more of word aligned main SRAM or flash, the calling
+  *          thread suspended meanwhile. The unit belongs to one thread at a
+  *          time, by a mutex, and has no initial value register: each call
+  *          restarts it from the value the context holds. From an interrupt,
+  *          a timer expiration function, with interrupts disabled or before
+  *          crc_service_init() the same CRC is computed in software.
+  *          crc_service_update() takes any number of bytes, the bytes of a
+  *          word cut between two calls waiting in the context for the next.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC_SERVICE_H__
+#define __CRC_SERVICE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Bytes from which the words go to the DMA: under it, the CPU writes them before the transfer
+   is set up and its interrupt and the two context switches are taken */
+#define CRC_SERVICE_DMA_THRESHOLD     1024U
+#define CRC_SERVICE_IRQ_PRIORITY      10U  /* With the copy stream */
+
+/* Value after the reset of the unit, the CRC of no data */
+#define CRC_SERVICE_INITIAL           0xFFFFFFFFU
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct CRC_SERVICE_CONTEXT_STRUCT
+{
+  ULONG crc;                          /* CRC of the whole words so far */
+  UCHAR pending[sizeof(ULONG)];       /* Bytes of the next word, not in the CRC yet */
+  UINT  pending_count;
+} CRC_SERVICE_CONTEXT;
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT  crc_service_init(VOID);
+VOID  crc_service_begin(CRC_SERVICE_CONTEXT *context_ptr);
+VOID  crc_service_update(CRC_SERVICE_CONTEXT *context_ptr, const VOID *data, ULONG size);
+ULONG crc_service_end(CRC_SERVICE_CONTEXT *context_ptr);
+ULONG crc_service_block(const VOID *data, ULONG size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CRC_SERVICE_H__ */
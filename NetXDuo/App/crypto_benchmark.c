@@ -0,0 +1,916 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    crypto_benchmark.c
+  * @author  MCD Application Team
+  * @brief   Cycle counts of the crypto primitives used by TLS and DTLS
+  *
+  *          The NetX Duo crypto methods are called as the TLS session calls
+  *          them, with their metadata initialized once per key:
+  *           - AES-128-CBC, AES-128-CTR, AES-128-GCM and AES-256-GCM encryption
+  *             and decryption, the decryption checking the result,
+  *           - SHA-1, SHA-256, SHA-384 and their HMAC,
+  *           - the CTR DRBG of the library, as NX_CRYPTO_RAND feeds it,
+  *           - RSA-2048 private key operation with CRT, the signature, and
+  *             public key operation, its verification,
+  *           - ECDSA P-256 signature and verification,
+  *           - ECDH P-256 key pair generation and shared secret.
+  *          With NX_CRYPTO_STM32_HW, the methods over the CRYP and HASH
+  *          peripherals run too, marked HW, after the software ones.
+  *          The first ones run over messages from CRYPTO_BENCHMARK_SIZE_MIN,
+  *          multiplied by 4 up to CRYPTO_BENCHMARK_SIZE_MAX, each size about
+  *          CRYPTO_BENCHMARK_BYTES in total, and are reported in cycles per
+  *          byte and operations per second. The public key ones run
+  *          CRYPTO_BENCHMARK_PK_ITERATIONS times and are reported in cycles
+  *          and operations per second. Each operation is measured alone with
+  *          the DWT cycle counter, interrupts enabled.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "crypto_benchmark.h"
+#include "nx_crypto_aes.h"
+#include "nx_crypto_sha1.h"
+#include "nx_crypto_sha2.h"
+#include "nx_crypto_sha5.h"
+#include "nx_crypto_hmac_sha1.h"
+#include "nx_crypto_hmac_sha2.h"
+#include "nx_crypto_hmac_sha5.h"
+#include "nx_crypto_rsa.h"
+#include "nx_crypto_ecdsa.h"
+#ifdef NX_CRYPTO_STM32_HW
+#include "nx_crypto_hmac.h"
+#include "nx_stm32_crypto_driver.h"
+#endif
+#include "nx_crypto_ecdh.h"
+#include "nx_crypto_drbg.h"
+#include "perf_harness.h"
+#include <string.h>
+
+#ifdef CRYPTO_BENCHMARK
+
+#if (CRYPTO_BENCHMARK_SIZE_MAX < 256)
+#error "CRYPTO_BENCHMARK_SIZE_MAX must hold the 256 bytes of an RSA-2048 message"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+/* How the messages of the sweep are processed */
+#define CRYPTO_BENCHMARK_CIPHER       0   /* Encrypted then decrypted, same length       */
+#define CRYPTO_BENCHMARK_AEAD         1   /* Same, with the tag after the ciphertext     */
+#define CRYPTO_BENCHMARK_DIGEST       2   /* Hashed, with the key of an HMAC             */
+
+/* Longest digest, SHA-384 */
+#define CRYPTO_BENCHMARK_DIGEST_SIZE  48U
+
+/* Additional data of the AEAD, as long as the header of a TLS 1.2 record */
+#define CRYPTO_BENCHMARK_AAD_SIZE     13U
+
+/* GCM nonce, after its length byte in the IV */
+#define CRYPTO_BENCHMARK_NONCE_SIZE   12U
+
+/* The RFC 3686 nonce follows the AES key of AES-CTR */
+#define CRYPTO_BENCHMARK_CTR_NONCE_SIZE 4U
+
+#define CRYPTO_BENCHMARK_RSA_BITS     2048U
+
+/* Key pair generation of ECDSA, as in its self test */
+#define CRYPTO_BENCHMARK_EC_SCRATCH_SIZE 4000U
+
+/* P-256 uncompressed public key */
+#define CRYPTO_BENCHMARK_EC_PUBLIC_KEY_SIZE (1U + 2U * 32U)
+
+/* Private types -------------------------------------------------------------*/
+/* Metadata of any method measured, aligned as their routines require */
+typedef union CRYPTO_BENCHMARK_METADATA_UNION
+{
+  NX_CRYPTO_AES         aes;
+  NX_CRYPTO_SHA1        sha1;
+  NX_CRYPTO_SHA256      sha256;
+  NX_CRYPTO_SHA512      sha512;
+  NX_CRYPTO_SHA1_HMAC   hmac_sha1;
+  NX_CRYPTO_SHA256_HMAC hmac_sha256;
+  NX_CRYPTO_SHA512_HMAC hmac_sha512;
+  NX_CRYPTO_RSA         rsa;
+  NX_CRYPTO_ECDSA       ecdsa;
+  NX_CRYPTO_ECDH        ecdh;
+#ifdef NX_CRYPTO_STM32_HW
+  NX_CRYPTO_STM32_HASH  sha_hw;
+  struct
+  {
+    NX_CRYPTO_HMAC       hmac;
+    NX_CRYPTO_STM32_HASH hash;
+  } hmac_hw;
+#endif
+} CRYPTO_BENCHMARK_METADATA;
+
+/* Algorithm of the size sweep */
+typedef struct CRYPTO_BENCHMARK_TEST_STRUCT
+{
+  const CHAR       *name;
+  NX_CRYPTO_METHOD *method;
+  UINT              key_bits;   /* 0 for a hash */
+  UINT              kind;
+} CRYPTO_BENCHMARK_TEST;
+
+/* External variables --------------------------------------------------------*/
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16;
+extern NX_CRYPTO_METHOD crypto_method_sha1;
+extern NX_CRYPTO_METHOD crypto_method_sha256;
+extern NX_CRYPTO_METHOD crypto_method_sha384;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha1;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha384;
+#ifdef NX_CRYPTO_STM32_HW
+extern NX_CRYPTO_METHOD crypto_method_aes_cbc_128_stm32;
+extern NX_CRYPTO_METHOD crypto_method_aes_ctr_128_stm32;
+extern NX_CRYPTO_METHOD crypto_method_aes_128_gcm_16_stm32;
+extern NX_CRYPTO_METHOD crypto_method_aes_256_gcm_16_stm32;
+extern NX_CRYPTO_METHOD crypto_method_sha1_stm32;
+extern NX_CRYPTO_METHOD crypto_method_sha256_stm32;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha1_stm32;
+extern NX_CRYPTO_METHOD crypto_method_hmac_sha256_stm32;
+#endif
+extern NX_CRYPTO_METHOD crypto_method_rsa;
+extern NX_CRYPTO_METHOD crypto_method_ecdsa;
+extern NX_CRYPTO_METHOD crypto_method_ecdh;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
+
+/* Private variables ---------------------------------------------------------*/
+/* AES-CTR is not in the method table of nx_crypto_methods.c, TLS does not use it. */
+static NX_CRYPTO_METHOD crypto_benchmark_aes_ctr_128 =
+{
+  NX_CRYPTO_ENCRYPTION_AES_CTR,
+  NX_CRYPTO_AES_128_KEY_LEN_IN_BITS,
+  64,
+  0,
+  (NX_CRYPTO_AES_BLOCK_SIZE_IN_BITS >> 3),
+  sizeof(NX_CRYPTO_AES),
+  _nx_crypto_method_aes_init,
+  _nx_crypto_method_aes_cleanup,
+  _nx_crypto_method_aes_ctr_operation
+};
+
+static const CRYPTO_BENCHMARK_TEST crypto_benchmark_tests[] =
+{
+  { "AES-128-CBC",  &crypto_method_aes_cbc_128,    128, CRYPTO_BENCHMARK_CIPHER },
+  { "AES-128-CTR",  &crypto_benchmark_aes_ctr_128, 128, CRYPTO_BENCHMARK_CIPHER },
+  { "AES-128-GCM",  &crypto_method_aes_128_gcm_16, 128, CRYPTO_BENCHMARK_AEAD   },
+  { "AES-256-GCM",  &crypto_method_aes_256_gcm_16, 256, CRYPTO_BENCHMARK_AEAD   },
+  { "SHA-1",        &crypto_method_sha1,           0,   CRYPTO_BENCHMARK_DIGEST },
+  { "SHA-256",      &crypto_method_sha256,         0,   CRYPTO_BENCHMARK_DIGEST },
+  { "SHA-384",      &crypto_method_sha384,         0,   CRYPTO_BENCHMARK_DIGEST },
+  { "HMAC-SHA-1",   &crypto_method_hmac_sha1,      256, CRYPTO_BENCHMARK_DIGEST },
+  { "HMAC-SHA-256", &crypto_method_hmac_sha256,    256, CRYPTO_BENCHMARK_DIGEST },
+  { "HMAC-SHA-384", &crypto_method_hmac_sha384,    256, CRYPTO_BENCHMARK_DIGEST },
+#ifdef NX_CRYPTO_STM32_HW
+  { "AES-128-CBC HW",  &crypto_method_aes_cbc_128_stm32,    128, CRYPTO_BENCHMARK_CIPHER },
+  { "AES-128-CTR HW",  &crypto_method_aes_ctr_128_stm32,    128, CRYPTO_BENCHMARK_CIPHER },
+  { "AES-128-GCM HW",  &crypto_method_aes_128_gcm_16_stm32, 128, CRYPTO_BENCHMARK_AEAD   },
+  { "AES-256-GCM HW",  &crypto_method_aes_256_gcm_16_stm32, 256, CRYPTO_BENCHMARK_AEAD   },
+  { "SHA-1 HW",        &crypto_method_sha1_stm32,           0,   CRYPTO_BENCHMARK_DIGEST },
+  { "SHA-256 HW",      &crypto_method_sha256_stm32,         0,   CRYPTO_BENCHMARK_DIGEST },
+  { "HMAC-SHA-1 HW",   &crypto_method_hmac_sha1_stm32,      256, CRYPTO_BENCHMARK_DIGEST },
+  { "HMAC-SHA-256 HW", &crypto_method_hmac_sha256_stm32,    256, CRYPTO_BENCHMARK_DIGEST },
+#endif
+};
+
+/* RSA-2048 key of the NetX Duo self test, nx_crypto_method_self_test_rsa.c */
+static const UCHAR crypto_benchmark_rsa_modulus[] =
+{
+  0xE0, 0xF5, 0x05, 0x99, 0x66, 0xA8, 0xAE, 0xC4, 0xBF, 0x7C, 0xDA, 0xC8, 0xAE, 0x24, 0x30, 0xBD,
+  0xF6, 0x1C, 0x54, 0xD0, 0x9C, 0xAB, 0x99, 0x63, 0xCB, 0xF9, 0xA5, 0x2A, 0xC6, 0x41, 0xE3, 0x84,
+  0xB6, 0x43, 0x1D, 0x3B, 0x6A, 0x9D, 0x18, 0x11, 0x51, 0x9A, 0x29, 0x04, 0xE1, 0x17, 0x0A, 0x44,
+  0x44, 0x6C, 0x80, 0xE7, 0x63, 0x8A, 0x4A, 0xF2, 0x72, 0x0A, 0x76, 0x54, 0xAB, 0x74, 0x0D, 0x8A,
+  0x15, 0x1F, 0xDD, 0x21, 0x6F, 0x3D, 0x69, 0x33, 0x42, 0x2F, 0xD9, 0xAC, 0x14, 0xAE, 0xDE, 0x9C,
+  0xCD, 0x02, 0x1E, 0xA7, 0x9E, 0x46, 0x92, 0x5F, 0x4B, 0x18, 0xFD, 0x1A, 0xF2, 0xC0, 0x07, 0x3C,
+  0xFC, 0x3A, 0x69, 0xAC, 0x71, 0xA2, 0xB3, 0x67, 0x3D, 0x08, 0x13, 0x6C, 0xDB, 0x01, 0xC3, 0x79,
+  0x89, 0x26, 0x01, 0xC7, 0xC8, 0x57, 0xD6, 0x80, 0x18, 0xDA, 0xE9, 0x24, 0xCB, 0x8C, 0xD2, 0x93,
+  0x77, 0xA1, 0x4C, 0x75, 0x2B, 0x92, 0xBA, 0xFF, 0x14, 0xC3, 0xA4, 0x97, 0x25, 0xAE, 0x2F, 0xEF,
+  0xAA, 0xD4, 0x68, 0x6D, 0x8A, 0x7D, 0x9F, 0x94, 0xEB, 0x11, 0xBF, 0x81, 0xE0, 0x5B, 0xD5, 0xD2,
+  0x58, 0x65, 0x26, 0xFB, 0x12, 0x9E, 0x73, 0x53, 0x9F, 0x92, 0x23, 0xD4, 0x96, 0xB2, 0xAC, 0xA2,
+  0x3C, 0xCA, 0xCC, 0x34, 0xD5, 0xB1, 0x85, 0x33, 0xBD, 0x0F, 0x58, 0x15, 0xA7, 0x6F, 0x94, 0xF4,
+  0xF5, 0x5D, 0x96, 0x5F, 0xE6, 0x15, 0x99, 0xB4, 0x4B, 0xD8, 0xFB, 0xAD, 0x35, 0xF4, 0x2B, 0x61,
+  0x2A, 0x4C, 0x4F, 0x27, 0x65, 0xB2, 0x09, 0x7A, 0x5C, 0x00, 0x90, 0xEA, 0x81, 0x66, 0xD9, 0xC6,
+  0xDA, 0x1E, 0x03, 0xB6, 0x11, 0x97, 0x36, 0xB7, 0x94, 0x60, 0x04, 0x91, 0xC4, 0x84, 0x33, 0x13,
+  0x2D, 0x0F, 0x15, 0xD5, 0xDE, 0x3B, 0xB4, 0x27, 0x0D, 0xF6, 0xBC, 0x90, 0x12, 0xB7, 0x49, 0x31,
+};
+
+static const UCHAR crypto_benchmark_rsa_public_exponent[] =
+{
+  0x00, 0x01, 0x00, 0x01,
+};
+
+static const UCHAR crypto_benchmark_rsa_private_exponent[] =
+{
+  0x13, 0xFF, 0x74, 0x29, 0xF8, 0xE8, 0x51, 0xF1, 0x07, 0x9C, 0xCF, 0xCE, 0x3B, 0x3C, 0xD8, 0x60,
+  0x6A, 0xBA, 0x86, 0x07, 0xAD, 0x85, 0xCB, 0xB3, 0x05, 0x75, 0x01, 0xEB, 0xD5, 0x88, 0x11, 0xF3,
+  0xC0, 0x48, 0x23, 0x17, 0x1F, 0x19, 0x2C, 0x04, 0x8E, 0x1E, 0x88, 0x3A, 0xF8, 0xCF, 0x95, 0x88,
+  0x10, 0x15, 0x1D, 0x38, 0x74, 0xAE, 0xDC, 0x8E, 0xC4, 0xF8, 0x8D, 0x20, 0x65, 0xC5, 0x81, 0x56,
+  0x9F, 0x1E, 0x20, 0x08, 0x52, 0xDD, 0x40, 0xB6, 0xDF, 0xD1, 0x65, 0x26, 0x59, 0x08, 0x5A, 0x9D,
+  0xD1, 0xD3, 0xB8, 0x69, 0xEA, 0x36, 0x17, 0xD9, 0x04, 0xD2, 0x09, 0xDE, 0x15, 0x6A, 0x60, 0xBA,
+  0x59, 0x29, 0xD0, 0x2F, 0x16, 0x43, 0x02, 0x73, 0xD1, 0x07, 0x20, 0xC2, 0xF2, 0x8D, 0x2B, 0x95,
+  0x68, 0x4D, 0xCA, 0xA6, 0xB9, 0xF6, 0xA5, 0x08, 0xEA, 0x2C, 0xBB, 0xC1, 0x1B, 0x9F, 0x3F, 0x30,
+  0xD6, 0x20, 0x1E, 0xA6, 0xCF, 0xFB, 0xBF, 0x1C, 0x44, 0x25, 0x5C, 0xEC, 0x58, 0xEE, 0x70, 0xDB,
+  0xC8, 0x72, 0x44, 0x2B, 0xCC, 0xF1, 0x15, 0xD8, 0xF7, 0x43, 0x55, 0x7B, 0x5D, 0xE5, 0xF4, 0x2D,
+  0xDD, 0xA6, 0xCE, 0xAE, 0x79, 0x77, 0x79, 0x3C, 0xC9, 0xD9, 0x0A, 0xDF, 0xE6, 0x5E, 0x52, 0x0F,
+  0x55, 0x20, 0xB6, 0x15, 0xCF, 0x3B, 0x8C, 0x2D, 0xC8, 0x2D, 0x7A, 0xC7, 0x5E, 0xDB, 0x12, 0x97,
+  0xCF, 0x38, 0xAB, 0x23, 0xA3, 0x7E, 0xED, 0x18, 0xD4, 0xDD, 0x45, 0xD9, 0xAD, 0x05, 0x1B, 0x26,
+  0x40, 0x1B, 0xE8, 0x6E, 0x8C, 0x8E, 0x53, 0xF9, 0x58, 0x5A, 0x70, 0x2D, 0x02, 0xF1, 0xB5, 0xBD,
+  0x65, 0xF6, 0x73, 0x9D, 0xFA, 0x6B, 0xFF, 0xE5, 0x60, 0xCA, 0x13, 0x0B, 0x6F, 0x1D, 0x47, 0x79,
+  0xC5, 0x56, 0xC0, 0x6D, 0x9C, 0xD2, 0x9F, 0xB7, 0x2D, 0x88, 0x51, 0x90, 0x4F, 0x9C, 0xDE, 0xE9,
+};
+
+static const UCHAR crypto_benchmark_rsa_prime_p[] =
+{
+  0xFB, 0xE7, 0xB4, 0x56, 0xB6, 0xCC, 0x03, 0x5D, 0x5D, 0xFF, 0xBA, 0x3C, 0x72, 0xD0, 0x33, 0x71,
+  0x7E, 0xA4, 0xF2, 0xFB, 0xA7, 0x1C, 0xAF, 0xF7, 0x0A, 0x5D, 0xFE, 0xA5, 0xAE, 0x01, 0x92, 0x87,
+  0x85, 0x0C, 0x20, 0x40, 0x4E, 0x04, 0xA1, 0x56, 0xAF, 0x12, 0x96, 0xA5, 0x16, 0x44, 0xDE, 0xDB,
+  0x64, 0x29, 0x2C, 0x7B, 0xDB, 0x2D, 0xCE, 0x3B, 0x5C, 0xA3, 0xC9, 0xF8, 0xAF, 0x13, 0x68, 0x3E,
+  0x23, 0x88, 0xD0, 0xB2, 0x77, 0x0C, 0x4E, 0x83, 0x02, 0xF4, 0x70, 0x9B, 0xF8, 0x74, 0x2A, 0x10,
+  0xA1, 0xDA, 0x9F, 0x45, 0xC2, 0x9F, 0xE2, 0x8F, 0x29, 0xF8, 0x92, 0x6F, 0x8D, 0x3C, 0x3A, 0x82,
+  0x78, 0x48, 0xBD, 0x08, 0xF1, 0x56, 0x35, 0x62, 0x22, 0xA7, 0xB3, 0x86, 0x36, 0x09, 0xCF, 0xCF,
+  0x4D, 0xCF, 0xB8, 0x58, 0x21, 0xA0, 0x08, 0xA2, 0xE4, 0x5C, 0x93, 0xA3, 0xAD, 0x12, 0x93, 0x8B,
+};
+
+static const UCHAR crypto_benchmark_rsa_prime_q[] =
+{
+  0xE4, 0x9D, 0x2C, 0x99, 0x33, 0x04, 0x19, 0x44, 0x97, 0x7E, 0xE1, 0x94, 0x2E, 0x0A, 0xFD, 0xB6,
+  0x9F, 0x92, 0x79, 0x7C, 0x08, 0x9A, 0x06, 0x49, 0xB9, 0xD8, 0x5E, 0x0C, 0xD2, 0x97, 0x56, 0x5E,
+  0xDE, 0xBE, 0x29, 0xE9, 0xF4, 0x3C, 0x31, 0xF1, 0x8E, 0x13, 0xF3, 0xCA, 0x4B, 0x83, 0xAA, 0xE7,
+  0x22, 0x73, 0x41, 0xC1, 0x01, 0x7C, 0x45, 0x47, 0xCE, 0x64, 0x92, 0x07, 0xCE, 0x82, 0x40, 0x72,
+  0xE5, 0x24, 0xE7, 0x96, 0x1D, 0xFB, 0xFF, 0x5C, 0x6F, 0xBB, 0x62, 0x12, 0x9B, 0xAC, 0xD1, 0x45,
+  0x7E, 0x11, 0x2B, 0x3F, 0x5D, 0x14, 0x0F, 0xE8, 0x74, 0xEB, 0x3B, 0xC2, 0x16, 0xC2, 0xA0, 0xB6,
+  0x60, 0xC8, 0xFD, 0xB7, 0x24, 0x8F, 0xA5, 0x42, 0xC8, 0x7B, 0xC5, 0xF3, 0x1E, 0x4F, 0x36, 0x39,
+  0x33, 0xDA, 0xD6, 0xAA, 0x0F, 0xE8, 0xE4, 0xFF, 0xEE, 0xEB, 0x50, 0x87, 0xCE, 0xF6, 0x3D, 0xB3,
+};
+
+static CRYPTO_BENCHMARK_METADATA crypto_benchmark_metadata;
+
+/* Peer of the ECDH exchange, both ends are computed here. */
+static NX_CRYPTO_ECDH crypto_benchmark_ecdh_peer;
+
+static UCHAR crypto_benchmark_key[32 + CRYPTO_BENCHMARK_CTR_NONCE_SIZE];
+static UCHAR crypto_benchmark_iv[1 + 16];
+static UCHAR crypto_benchmark_aad[CRYPTO_BENCHMARK_AAD_SIZE];
+
+/* Messages of the sweep, room for the tag after the ciphertext. */
+static UCHAR crypto_benchmark_input[CRYPTO_BENCHMARK_SIZE_MAX];
+static UCHAR crypto_benchmark_output[CRYPTO_BENCHMARK_SIZE_MAX + 16];
+static UCHAR crypto_benchmark_check[CRYPTO_BENCHMARK_SIZE_MAX];
+
+static UCHAR crypto_benchmark_signature[CRYPTO_BENCHMARK_RSA_BITS / 8];
+static UCHAR crypto_benchmark_public_key[CRYPTO_BENCHMARK_EC_PUBLIC_KEY_SIZE];
+static UCHAR crypto_benchmark_peer_public_key[CRYPTO_BENCHMARK_EC_PUBLIC_KEY_SIZE];
+static UCHAR crypto_benchmark_private_key[32];
+static HN_UBASE crypto_benchmark_ec_scratch[CRYPTO_BENCHMARK_EC_SCRATCH_SIZE / sizeof(HN_UBASE)];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Report the operations of a message size.
+* @param  name: algorithm
+* @param  operation: what was measured
+* @param  length: message length in bytes
+* @param  count: operations measured
+* @param  cycles: CPU cycles of the operations
+* @retval None
+*/
+static VOID crypto_benchmark_throughput_report(const CHAR *name, const CHAR *operation, UINT length,
+                                               UINT count, ULONG64 cycles)
+{
+  ULONG64 cycles_per_byte_x10;
+  ULONG64 rate;
+
+  if (cycles == 0)
+  {
+    cycles = 1;
+  }
+
+  /* No floating point printf with the nano C library, tenths are printed apart. */
+  cycles_per_byte_x10 = (cycles * 10U) / ((ULONG64)length * count);
+  rate = ((ULONG64)SystemCoreClock * count) / cycles;
+
+  printf("%-15s %-7s %5u B: %5lu.%lu cycles/B, %7lu ops/s\n", name, operation, length,
+         (unsigned long)(cycles_per_byte_x10 / 10U), (unsigned long)(cycles_per_byte_x10 % 10U),
+         (unsigned long)rate);
+  perf_harness_result("crypto", "cycles/B x10", (ULONG)cycles_per_byte_x10, PERF_HARNESS_LOWER, "%s %s %u B",
+                      name, operation, length);
+}
+
+/**
+* @brief  Report the operations of a public key algorithm.
+* @param  name: algorithm and operation
+* @param  count: operations measured
+* @param  cycles: CPU cycles of the operations
+* @retval None
+*/
+static VOID crypto_benchmark_operation_report(const CHAR *name, UINT count, ULONG64 cycles)
+{
+  ULONG64 rate_x100;
+
+  if (cycles == 0)
+  {
+    cycles = 1;
+  }
+
+  /* Slower ones run less than once per second, hundredths are printed apart. */
+  rate_x100 = ((ULONG64)SystemCoreClock * count * 100U) / cycles;
+
+  printf("%-24s %10lu cycles, %5lu.%02lu ops/s\n", name, (unsigned long)(cycles / count),
+         (unsigned long)(rate_x100 / 100U), (unsigned long)(rate_x100 % 100U));
+  perf_harness_result("crypto", "cycles", (ULONG)(cycles / count), PERF_HARNESS_LOWER, "%s", name);
+}
+
+/**
+* @brief  Report a failed measurement.
+* @param  name: algorithm and operation
+* @param  status: error of the crypto method, NX_CRYPTO_NOT_SUCCESSFUL when the result is wrong
+* @retval None
+*/
+static VOID crypto_benchmark_failure_report(const CHAR *name, UINT status)
+{
+  printf("%s failed: 0x%x\n", name, status);
+}
+
+/**
+* @brief  Encrypt and decrypt a message, or hash it, repeatedly.
+* @param  test: algorithm
+* @param  length: message length in bytes, a multiple of the AES block
+* @retval NX_CRYPTO_SUCCESS, or the error of the failed operation
+*/
+static UINT crypto_benchmark_size_run(const CRYPTO_BENCHMARK_TEST *test, UINT length)
+{
+  NX_CRYPTO_METHOD *method = test -> method;
+  VOID *handle = NX_CRYPTO_NULL;
+  UINT icv_length = 0;
+  UINT count;
+  UINT i;
+  UINT status;
+  uint32_t start;
+  ULONG64 cycles;
+
+  count = CRYPTO_BENCHMARK_BYTES / length;
+  if (count == 0)
+  {
+    count = 1;
+  }
+
+  status = method -> nx_crypto_init(method, (test -> key_bits != 0) ? crypto_benchmark_key : NX_CRYPTO_NULL,
+                                    test -> key_bits, &handle,
+                                    &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata));
+
+  if ((status == NX_CRYPTO_SUCCESS) && (test -> kind == CRYPTO_BENCHMARK_AEAD))
+  {
+    icv_length = method -> nx_crypto_ICV_size_in_bits >> 3;
+
+    /* The metadata keeps the additional data from now on. */
+    status = method -> nx_crypto_operation(NX_CRYPTO_SET_ADDITIONAL_DATA, handle, method, NX_CRYPTO_NULL, 0,
+                                           crypto_benchmark_aad, sizeof(crypto_benchmark_aad), NX_CRYPTO_NULL,
+                                           NX_CRYPTO_NULL, 0,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report(test -> name, status);
+    return status;
+  }
+
+  if (test -> kind == CRYPTO_BENCHMARK_DIGEST)
+  {
+    cycles = 0;
+    for (i = 0; (i < count) && (status == NX_CRYPTO_SUCCESS); i++)
+    {
+      start = DWT -> CYCCNT;
+      status = method -> nx_crypto_operation(NX_CRYPTO_AUTHENTICATE, handle, method,
+                                             (test -> key_bits != 0) ? crypto_benchmark_key : NX_CRYPTO_NULL,
+                                             test -> key_bits, crypto_benchmark_input, length, NX_CRYPTO_NULL,
+                                             crypto_benchmark_output, CRYPTO_BENCHMARK_DIGEST_SIZE,
+                                             &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                             NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+      cycles += DWT -> CYCCNT - start;
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+      crypto_benchmark_throughput_report(test -> name, "hash", length, count, cycles);
+    }
+  }
+  else
+  {
+    cycles = 0;
+    for (i = 0; (i < count) && (status == NX_CRYPTO_SUCCESS); i++)
+    {
+      start = DWT -> CYCCNT;
+      status = method -> nx_crypto_operation(NX_CRYPTO_ENCRYPT, handle, method, crypto_benchmark_key,
+                                             test -> key_bits, crypto_benchmark_input, length,
+                                             crypto_benchmark_iv, crypto_benchmark_output, length + icv_length,
+                                             &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                             NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+      cycles += DWT -> CYCCNT - start;
+    }
+
+    if (status == NX_CRYPTO_SUCCESS)
+    {
+      crypto_benchmark_throughput_report(test -> name, "encrypt", length, count, cycles);
+
+      /* The AEAD decryption checks the tag, the result is compared to the message below. */
+      cycles = 0;
+      for (i = 0; (i < count) && (status == NX_CRYPTO_SUCCESS); i++)
+      {
+        start = DWT -> CYCCNT;
+        status = method -> nx_crypto_operation(NX_CRYPTO_DECRYPT, handle, method, crypto_benchmark_key,
+                                               test -> key_bits, crypto_benchmark_output, length + icv_length,
+                                               crypto_benchmark_iv, crypto_benchmark_check, length,
+                                               &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                               NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+        cycles += DWT -> CYCCNT - start;
+      }
+
+      if ((status == NX_CRYPTO_SUCCESS) && (memcmp(crypto_benchmark_check, crypto_benchmark_input, length) != 0))
+      {
+        status = NX_CRYPTO_NOT_SUCCESSFUL;
+      }
+
+      if (status == NX_CRYPTO_SUCCESS)
+      {
+        crypto_benchmark_throughput_report(test -> name, "decrypt", length, count, cycles);
+      }
+    }
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report(test -> name, status);
+  }
+
+  if (method -> nx_crypto_cleanup)
+  {
+    method -> nx_crypto_cleanup(&crypto_benchmark_metadata);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Fill buffers of random bytes, as the TLS session does for its randoms and nonces.
+* @param  length: bytes of each request
+* @retval NX_CRYPTO_SUCCESS, or the error of the DRBG
+*/
+static UINT crypto_benchmark_drbg_run(UINT length)
+{
+  UINT count;
+  UINT i;
+  UINT status = NX_CRYPTO_SUCCESS;
+  uint32_t start;
+  ULONG64 cycles = 0;
+
+  count = CRYPTO_BENCHMARK_BYTES / length;
+  if (count == 0)
+  {
+    count = 1;
+  }
+
+  for (i = 0; (i < count) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = _nx_crypto_drbg(length << 3, crypto_benchmark_output);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("DRBG", status);
+    return status;
+  }
+
+  crypto_benchmark_throughput_report("DRBG", "fill", length, count, cycles);
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/**
+* @brief  Sign with the RSA-2048 private key, then verify the signature with the public key.
+* @note   The operations are the raw modular exponentiations, without the PKCS#1 padding
+*         around them that costs little in comparison.
+* @retval NX_CRYPTO_SUCCESS, or the error of the failed operation
+*/
+static UINT crypto_benchmark_rsa_run(VOID)
+{
+  NX_CRYPTO_METHOD *method = &crypto_method_rsa;
+  VOID *handle = NX_CRYPTO_NULL;
+  UINT i;
+  UINT status;
+  uint32_t start;
+  ULONG64 cycles;
+
+  /* Any value below the modulus stands for the padded hash. */
+  crypto_benchmark_input[0] = 0;
+
+  /* The primes set after the modulus select the CRT, as for a key with its primes in the PKCS#1 file. */
+  status = method -> nx_crypto_init(method, (UCHAR *)crypto_benchmark_rsa_modulus, CRYPTO_BENCHMARK_RSA_BITS,
+                                    &handle, &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata));
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_SET_PRIME_P, handle, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)crypto_benchmark_rsa_prime_p,
+                                           sizeof(crypto_benchmark_rsa_prime_p), NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_SET_PRIME_Q, handle, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)crypto_benchmark_rsa_prime_q,
+                                           sizeof(crypto_benchmark_rsa_prime_q), NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = method -> nx_crypto_operation(NX_CRYPTO_DECRYPT, handle, method,
+                                           (UCHAR *)crypto_benchmark_rsa_private_exponent, CRYPTO_BENCHMARK_RSA_BITS,
+                                           crypto_benchmark_input, sizeof(crypto_benchmark_signature), NX_CRYPTO_NULL,
+                                           crypto_benchmark_signature, sizeof(crypto_benchmark_signature),
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("RSA-2048 sign", status);
+    return status;
+  }
+
+  crypto_benchmark_operation_report("RSA-2048 sign (CRT)", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+  /* A new initialization drops the primes, the public exponent is used alone. */
+  status = method -> nx_crypto_init(method, (UCHAR *)crypto_benchmark_rsa_modulus, CRYPTO_BENCHMARK_RSA_BITS,
+                                    &handle, &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata));
+
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = method -> nx_crypto_operation(NX_CRYPTO_ENCRYPT, handle, method,
+                                           (UCHAR *)crypto_benchmark_rsa_public_exponent,
+                                           sizeof(crypto_benchmark_rsa_public_exponent) << 3,
+                                           crypto_benchmark_signature, sizeof(crypto_benchmark_signature),
+                                           NX_CRYPTO_NULL, crypto_benchmark_check, sizeof(crypto_benchmark_signature),
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  if ((status == NX_CRYPTO_SUCCESS) &&
+      (memcmp(crypto_benchmark_check, crypto_benchmark_input, sizeof(crypto_benchmark_signature)) != 0))
+  {
+    status = NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("RSA-2048 verify", status);
+    return status;
+  }
+
+  crypto_benchmark_operation_report("RSA-2048 verify", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/**
+* @brief  Sign a message with ECDSA P-256 and SHA-256, then verify the signature.
+* @retval NX_CRYPTO_SUCCESS, or the error of the failed operation
+*/
+static UINT crypto_benchmark_ecdsa_run(VOID)
+{
+  NX_CRYPTO_METHOD *method = &crypto_method_ecdsa;
+  NX_CRYPTO_METHOD *curve_method = &crypto_method_ec_secp256;
+  NX_CRYPTO_EC *curve = NX_CRYPTO_NULL;
+  NX_CRYPTO_HUGE_NUMBER private_key;
+  NX_CRYPTO_EC_POINT public_key;
+  NX_CRYPTO_EXTENDED_OUTPUT extended_output;
+  HN_UBASE *scratch = crypto_benchmark_ec_scratch;
+  VOID *handle = NX_CRYPTO_NULL;
+  UINT buffer_size = 0;
+  UINT public_key_length = 0;
+  ULONG signature_length = 0;
+  UINT i;
+  UINT status;
+  uint32_t start;
+  ULONG64 cycles;
+
+  status = method -> nx_crypto_init(method, NX_CRYPTO_NULL, 0, &handle,
+                                    &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata));
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_HASH_METHOD_SET, handle, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)&crypto_method_sha256, sizeof(NX_CRYPTO_METHOD *),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET, handle, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)curve_method, sizeof(NX_CRYPTO_METHOD *),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = curve_method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_GET, NX_CRYPTO_NULL, curve_method,
+                                                 NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                 (UCHAR *)&curve, 0, NX_CRYPTO_NULL, 0,
+                                                 NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+
+  /* A key pair of the curve, generated as the self test of the method does. */
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    buffer_size = curve -> nx_crypto_ec_n.nx_crypto_huge_buffer_size;
+    NX_CRYPTO_EC_POINT_INITIALIZE(&public_key, NX_CRYPTO_EC_POINT_AFFINE, scratch, buffer_size);
+    NX_CRYPTO_HUGE_NUMBER_INITIALIZE(&private_key, scratch, buffer_size + 8);
+
+    status = _nx_crypto_ec_key_pair_generation_extra(curve, &curve -> nx_crypto_ec_g, &private_key,
+                                                     &public_key, scratch);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = _nx_crypto_huge_number_extract_fixed_size(&private_key, crypto_benchmark_private_key, buffer_size);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    _nx_crypto_ec_point_extract_uncompressed(curve, &public_key, crypto_benchmark_public_key,
+                                             sizeof(crypto_benchmark_public_key), &public_key_length);
+  }
+
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    extended_output.nx_crypto_extended_output_data = crypto_benchmark_signature;
+    extended_output.nx_crypto_extended_output_length_in_byte = sizeof(crypto_benchmark_signature);
+
+    start = DWT -> CYCCNT;
+    status = method -> nx_crypto_operation(NX_CRYPTO_SIGNATURE_GENERATE, handle, method,
+                                           crypto_benchmark_private_key, buffer_size << 3,
+                                           crypto_benchmark_input, 32, NX_CRYPTO_NULL,
+                                           (UCHAR *)&extended_output, sizeof(extended_output),
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    cycles += DWT -> CYCCNT - start;
+
+    signature_length = extended_output.nx_crypto_extended_output_actual_size;
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("ECDSA P-256 sign", status);
+    return status;
+  }
+
+  crypto_benchmark_operation_report("ECDSA P-256 sign", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+  /* The verification fails on a wrong signature. */
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = method -> nx_crypto_operation(NX_CRYPTO_SIGNATURE_VERIFY, handle, method,
+                                           crypto_benchmark_public_key, public_key_length << 3,
+                                           crypto_benchmark_input, 32, NX_CRYPTO_NULL,
+                                           crypto_benchmark_signature, signature_length,
+                                           &crypto_benchmark_metadata, sizeof(crypto_benchmark_metadata),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  if (method -> nx_crypto_cleanup)
+  {
+    method -> nx_crypto_cleanup(&crypto_benchmark_metadata);
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("ECDSA P-256 verify", status);
+    return status;
+  }
+
+  crypto_benchmark_operation_report("ECDSA P-256 verify", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/**
+* @brief  Set up the P-256 curve of an ECDH context and generate its key pair.
+* @param  metadata: ECDH context
+* @param  public_key: uncompressed public key of the pair
+* @param  public_key_length: length of the public key
+* @retval NX_CRYPTO_SUCCESS, or the error of the method
+*/
+static UINT crypto_benchmark_ecdh_setup(NX_CRYPTO_ECDH *metadata, UCHAR *public_key, ULONG *public_key_length)
+{
+  NX_CRYPTO_METHOD *method = &crypto_method_ecdh;
+  NX_CRYPTO_EXTENDED_OUTPUT extended_output;
+  UINT status;
+
+  status = method -> nx_crypto_init(method, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, metadata, sizeof(NX_CRYPTO_ECDH));
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET, NX_CRYPTO_NULL, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)&crypto_method_ec_secp256, sizeof(NX_CRYPTO_METHOD *),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0, metadata, sizeof(NX_CRYPTO_ECDH),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    extended_output.nx_crypto_extended_output_data = public_key;
+    extended_output.nx_crypto_extended_output_length_in_byte = CRYPTO_BENCHMARK_EC_PUBLIC_KEY_SIZE;
+    status = method -> nx_crypto_operation(NX_CRYPTO_DH_SETUP, NX_CRYPTO_NULL, method, NX_CRYPTO_NULL, 0,
+                                           NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                           (UCHAR *)&extended_output, sizeof(extended_output),
+                                           metadata, sizeof(NX_CRYPTO_ECDH), NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+    *public_key_length = extended_output.nx_crypto_extended_output_actual_size;
+  }
+
+  return status;
+}
+
+/**
+* @brief  Compute the ECDH P-256 shared secret with the public key of the peer.
+* @param  metadata: ECDH context, set up
+* @param  peer_public_key: uncompressed public key of the other end
+* @param  peer_public_key_length: length of the public key
+* @param  secret: the x coordinate of the shared point
+* @retval NX_CRYPTO_SUCCESS, or the error of the method
+*/
+static UINT crypto_benchmark_ecdh_calculate(NX_CRYPTO_ECDH *metadata, UCHAR *peer_public_key,
+                                            ULONG peer_public_key_length, UCHAR *secret)
+{
+  NX_CRYPTO_METHOD *method = &crypto_method_ecdh;
+  NX_CRYPTO_EXTENDED_OUTPUT extended_output;
+
+  extended_output.nx_crypto_extended_output_data = secret;
+  extended_output.nx_crypto_extended_output_length_in_byte = CRYPTO_BENCHMARK_EC_PUBLIC_KEY_SIZE;
+
+  return method -> nx_crypto_operation(NX_CRYPTO_DH_CALCULATE, NX_CRYPTO_NULL, method, NX_CRYPTO_NULL, 0,
+                                       peer_public_key, peer_public_key_length, NX_CRYPTO_NULL,
+                                       (UCHAR *)&extended_output, sizeof(extended_output),
+                                       metadata, sizeof(NX_CRYPTO_ECDH), NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+}
+
+/**
+* @brief  Generate ECDH P-256 key pairs, then compute the shared secret of an exchange.
+* @retval NX_CRYPTO_SUCCESS, or the error of the failed operation
+*/
+static UINT crypto_benchmark_ecdh_run(VOID)
+{
+  NX_CRYPTO_ECDH *local = &crypto_benchmark_metadata.ecdh;
+  ULONG public_key_length = 0;
+  ULONG peer_public_key_length = 0;
+  UINT i;
+  UINT status = NX_CRYPTO_SUCCESS;
+  uint32_t start;
+  ULONG64 cycles;
+
+  /* Each setup initializes the context and generates a new key pair, as a TLS handshake does. */
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = crypto_benchmark_ecdh_setup(local, crypto_benchmark_public_key, &public_key_length);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_operation_report("ECDH P-256 key pair", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+    status = crypto_benchmark_ecdh_setup(&crypto_benchmark_ecdh_peer, crypto_benchmark_peer_public_key,
+                                         &peer_public_key_length);
+  }
+
+  cycles = 0;
+  for (i = 0; (i < CRYPTO_BENCHMARK_PK_ITERATIONS) && (status == NX_CRYPTO_SUCCESS); i++)
+  {
+    start = DWT -> CYCCNT;
+    status = crypto_benchmark_ecdh_calculate(local, crypto_benchmark_peer_public_key, peer_public_key_length,
+                                             crypto_benchmark_output);
+    cycles += DWT -> CYCCNT - start;
+  }
+
+  /* Both ends find the same secret. */
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = crypto_benchmark_ecdh_calculate(&crypto_benchmark_ecdh_peer, crypto_benchmark_public_key,
+                                             public_key_length, crypto_benchmark_check);
+  }
+  if ((status == NX_CRYPTO_SUCCESS) && (memcmp(crypto_benchmark_output, crypto_benchmark_check, 32) != 0))
+  {
+    status = NX_CRYPTO_NOT_SUCCESSFUL;
+  }
+
+  crypto_method_ecdh.nx_crypto_cleanup(local);
+  crypto_method_ecdh.nx_crypto_cleanup(&crypto_benchmark_ecdh_peer);
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    crypto_benchmark_failure_report("ECDH P-256", status);
+    return status;
+  }
+
+  crypto_benchmark_operation_report("ECDH P-256 shared secret", CRYPTO_BENCHMARK_PK_ITERATIONS, cycles);
+
+  return NX_CRYPTO_SUCCESS;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Run the benchmark.
+* @retval NX_SUCCESS, or the error of the first failed measurement
+*/
+UINT crypto_benchmark_run(VOID)
+{
+  UINT ret = NX_CRYPTO_SUCCESS;
+  UINT status;
+  UINT length;
+  UINT i;
+
+  /* Start the cycle counter. */
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CYCCNT = 0;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for (i = 0; i < sizeof(crypto_benchmark_input); i++)
+  {
+    crypto_benchmark_input[i] = (UCHAR)(i * 7U + 1U);
+  }
+  memset(crypto_benchmark_key, 0x5A, sizeof(crypto_benchmark_key));
+  memset(crypto_benchmark_iv, 0xA5, sizeof(crypto_benchmark_iv));
+  memset(crypto_benchmark_aad, 0x17, sizeof(crypto_benchmark_aad));
+
+  /* The GCM IV starts with the length of its nonce, the others do not read that far. */
+  crypto_benchmark_iv[0] = CRYPTO_BENCHMARK_NONCE_SIZE;
+
+  printf("Crypto benchmark, CPU at %lu MHz\n", (unsigned long)(SystemCoreClock / 1000000U));
+
+  /* A failed algorithm is reported and the next ones still run. */
+  for (i = 0; i < sizeof(crypto_benchmark_tests) / sizeof(crypto_benchmark_tests[0]); i++)
+  {
+    for (length = CRYPTO_BENCHMARK_SIZE_MIN; length <= CRYPTO_BENCHMARK_SIZE_MAX; length *= 4U)
+    {
+      status = crypto_benchmark_size_run(&crypto_benchmark_tests[i], length);
+      if (status != NX_CRYPTO_SUCCESS)
+      {
+        ret = (ret == NX_CRYPTO_SUCCESS) ? status : ret;
+        break;
+      }
+    }
+  }
+
+  for (length = CRYPTO_BENCHMARK_SIZE_MIN; length <= CRYPTO_BENCHMARK_SIZE_MAX; length *= 4U)
+  {
+    status = crypto_benchmark_drbg_run(length);
+    if (status != NX_CRYPTO_SUCCESS)
+    {
+      ret = (ret == NX_CRYPTO_SUCCESS) ? status : ret;
+      break;
+    }
+  }
+
+  status = crypto_benchmark_rsa_run();
+  ret = (ret == NX_CRYPTO_SUCCESS) ? status : ret;
+
+  status = crypto_benchmark_ecdsa_run();
+  ret = (ret == NX_CRYPTO_SUCCESS) ? status : ret;
+
+  status = crypto_benchmark_ecdh_run();
+  ret = (ret == NX_CRYPTO_SUCCESS) ? status : ret;
+
+  printf("Crypto benchmark done\n");
+
+  return ret;
+}
+
+#endif /* CRYPTO_BENCHMARK */
@@ -0,0 +1,39 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    crypto_benchmark.h
+  * @author  MCD Application Team
+  * @brief   Cycle counts of the crypto primitives used by TLS and DTLS
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRYPTO_BENCHMARK_H__
+#define __CRYPTO_BENCHMARK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Runs the measurements configured in app_netxduo.h and reports them over the
+   UART. No network is needed, it is run before the interface is started. */
+UINT crypto_benchmark_run(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CRYPTO_BENCHMARK_H__ */
@@ -0,0 +1,183 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cycle_profile.c
+  * @author  MCD Application Team
+  * @brief   Cycle counter profiling of the network hot paths
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_api.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef CYCLE_PROFILE_ENABLE
+
+/* Private variables ---------------------------------------------------------*/
+static CYCLE_PROFILE_STATS cycle_profile_stats[CYCLE_PROFILE_REGIONS] CCMRAM_BSS;
+
+/* Time of the last reset, the base of the CPU share of the dump. */
+static ULONG cycle_profile_reset_time;
+
+static const CHAR *const cycle_profile_names[CYCLE_PROFILE_REGIONS] =
+{
+  "ETH receive",
+  "TCP process",
+  "TLS decrypt",
+  "AES-GCM",
+  "MQTT receive",
+  "TLS SrvHello",
+  "TLS cert",
+  "TLS key exch",
+  "TLS finished",
+  "TLS encrypt",
+  "RSA",
+  "ECDSA",
+  "ECDH",
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the DWT cycle counter and clear the statistics.
+* @param  None
+* @retval None
+*/
+VOID cycle_profile_init(VOID)
+{
+  /* The counter is not cleared, thread_profile.c and boot_profile.c may be measuring with it. */
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  cycle_profile_reset();
+}
+
+/**
+* @brief  Add one duration to the statistics of a region.
+* @param  region: CYCLE_PROFILE_ETH_RECEIVE ... CYCLE_PROFILE_ECDH
+* @param  cycles: duration in CPU cycles
+* @retval None
+*/
+VOID cycle_profile_record(UINT region, ULONG cycles)
+{
+  TX_INTERRUPT_SAVE_AREA
+  CYCLE_PROFILE_STATS *stats_ptr = &cycle_profile_stats[region];
+  UINT bucket;
+
+  bucket = (cycles > 1) ? (31U - (UINT)__builtin_clz(cycles)) : 0U;
+  if (bucket >= CYCLE_PROFILE_BUCKETS)
+  {
+    bucket = CYCLE_PROFILE_BUCKETS - 1;
+  }
+
+  /* The regions run in the IP, MQTT and application threads, which preempt each other. */
+  TX_DISABLE
+  stats_ptr -> count++;
+  stats_ptr -> total += cycles;
+  if (cycles > stats_ptr -> max)
+  {
+    stats_ptr -> max = cycles;
+  }
+  stats_ptr -> histogram[bucket]++;
+  stats_ptr -> last = DWT -> CYCCNT;
+  TX_RESTORE
+}
+
+/**
+* @brief  Copy the statistics of a region.
+* @param  region: CYCLE_PROFILE_ETH_RECEIVE ... CYCLE_PROFILE_ECDH
+* @param  stats_ptr: destination of the statistics
+* @retval NX_SUCCESS or NX_INVALID_PARAMETERS
+*/
+UINT cycle_profile_get(UINT region, CYCLE_PROFILE_STATS *stats_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  if ((region >= CYCLE_PROFILE_REGIONS) || (stats_ptr == NX_NULL))
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  TX_DISABLE
+  *stats_ptr = cycle_profile_stats[region];
+  TX_RESTORE
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Clear the statistics of all the regions.
+* @param  None
+* @retval None
+*/
+VOID cycle_profile_reset(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  TX_DISABLE
+  memset(cycle_profile_stats, 0, sizeof(cycle_profile_stats));
+  cycle_profile_reset_time = tx_time_get();
+  TX_RESTORE
+}
+
+/**
+* @brief  Print the statistics of all the regions over the UART.
+* @param  title: printed before the statistics
+* @retval None
+*/
+VOID cycle_profile_dump(const CHAR *title)
+{
+  CYCLE_PROFILE_STATS stats;
+  ULONG64 elapsed;
+  ULONG permille;
+  UINT region;
+  UINT bucket;
+
+  /* Cycles elapsed since the reset, the counter itself wraps every 24 s at 180 MHz. */
+  elapsed = (ULONG64)(tx_time_get() - cycle_profile_reset_time) * (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND);
+
+  printf("Cycle profile %s, %lu ms:\n", title,
+         (unsigned long)((tx_time_get() - cycle_profile_reset_time) * 1000U / TX_TIMER_TICKS_PER_SECOND));
+
+  for (region = 0; region < CYCLE_PROFILE_REGIONS; region++)
+  {
+    cycle_profile_get(region, &stats);
+
+    if (stats.count == 0)
+    {
+      printf("  %-12s no call\n", cycle_profile_names[region]);
+      continue;
+    }
+
+    permille = (elapsed != 0) ? (ULONG)((stats.total * 1000U) / elapsed) : 0;
+
+    printf("  %-12s %lu calls, avg %lu, max %lu cycles, %lu.%lu%% CPU\n", cycle_profile_names[region],
+           stats.count, (ULONG)(stats.total / stats.count), stats.max, permille / 10, permille % 10);
+
+    /* Histogram, as "cycles from: calls" for the buckets used. */
+    printf("   ");
+    for (bucket = 0; bucket < CYCLE_PROFILE_BUCKETS; bucket++)
+    {
+      if (stats.histogram[bucket] != 0)
+      {
+        printf(" %lu:%lu", 1UL << bucket, stats.histogram[bucket]);
+      }
+    }
+    printf("\n");
+  }
+}
+
+#endif /* CYCLE_PROFILE_ENABLE */
@@ -0,0 +1,105 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cycle_profile.h
+  * @author  MCD Application Team
+  * @brief   Cycle counter profiling of the network hot paths
+  *
+  *          With CYCLE_PROFILE_ENABLE defined in nx_user.h, each region below
+  *          records its duration in CPU cycles, read from the DWT cycle counter,
+  *          into a call count, a total, a maximum and a log2 histogram. The
+  *          regions are inclusive: TLS_DECRYPT contains AES_GCM, ETH_RECEIVE
+  *          contains the IP and TCP processing of the packets it passes to
+  *          NetX in the driver thread. Without CYCLE_PROFILE_ENABLE the macros
+  *          and the functions compile to nothing.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CYCLE_PROFILE_H__
+#define __CYCLE_PROFILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Profiled regions */
+#define CYCLE_PROFILE_ETH_RECEIVE       0   /* Ethernet driver receive processing       */
+#define CYCLE_PROFILE_TCP_PROCESS       1   /* TCP processing of one segment            */
+#define CYCLE_PROFILE_TLS_DECRYPT       2   /* Decryption and check of one TLS record   */
+#define CYCLE_PROFILE_AES_GCM           3   /* One AES-GCM operation                    */
+#define CYCLE_PROFILE_MQTT_RECEIVE      4   /* MQTT processing of the received data     */
+#define CYCLE_PROFILE_TLS_SERVER_HELLO  5   /* TLS client processing of the ServerHello */
+#define CYCLE_PROFILE_TLS_CERTIFICATE   6   /* Server certificates and CertificateVerify */
+#define CYCLE_PROFILE_TLS_KEY_EXCHANGE  7   /* Key exchange and handshake key generation */
+#define CYCLE_PROFILE_TLS_FINISHED      8   /* Session keys and Finished messages       */
+#define CYCLE_PROFILE_TLS_ENCRYPT       9   /* Encryption of one TLS record             */
+#define CYCLE_PROFILE_RSA               10  /* One RSA modular exponentiation           */
+#define CYCLE_PROFILE_ECDSA             11  /* One ECDSA signature or verification      */
+#define CYCLE_PROFILE_ECDH              12  /* One ECDH key pair or shared secret       */
+#define CYCLE_PROFILE_REGIONS           13
+
+/* Histogram bucket n counts the durations from 2^n to 2^(n+1) - 1 cycles,
+   the last one also the longer durations. */
+#define CYCLE_PROFILE_BUCKETS           24
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct CYCLE_PROFILE_STATS_STRUCT
+{
+  ULONG64 total;
+  ULONG   count;
+  ULONG   max;
+  ULONG   last;     /* Counter at the end of the last call, places it in time */
+  ULONG   histogram[CYCLE_PROFILE_BUCKETS];
+} CYCLE_PROFILE_STATS;
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef CYCLE_PROFILE_ENABLE
+
+/* DWT cycle counter, read without the CMSIS headers that the NetX sources do not include. */
+#define CYCLE_PROFILE_COUNTER         (*(volatile ULONG *)0xE0001004UL)
+
+/* CYCLE_PROFILE_SAVE_AREA goes with the local declarations of the function,
+   like TX_INTERRUPT_SAVE_AREA, then CYCLE_PROFILE_ENTER and CYCLE_PROFILE_EXIT
+   bracket the region. */
+#define CYCLE_PROFILE_SAVE_AREA       ULONG cycle_profile_start;
+#define CYCLE_PROFILE_ENTER           cycle_profile_start = CYCLE_PROFILE_COUNTER;
+#define CYCLE_PROFILE_EXIT(region)    cycle_profile_record((region), CYCLE_PROFILE_COUNTER - cycle_profile_start);
+
+/* Exported functions prototypes ---------------------------------------------*/
+VOID cycle_profile_init(VOID);
+VOID cycle_profile_record(UINT region, ULONG cycles);
+UINT cycle_profile_get(UINT region, CYCLE_PROFILE_STATS *stats_ptr);
+VOID cycle_profile_reset(VOID);
+VOID cycle_profile_dump(const CHAR *title);
+
+#else
+
+#define CYCLE_PROFILE_SAVE_AREA
+#define CYCLE_PROFILE_ENTER
+#define CYCLE_PROFILE_EXIT(region)
+
+#define cycle_profile_init()
+#define cycle_profile_reset()
+#define cycle_profile_dump(title)
+
+#endif /* CYCLE_PROFILE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __CYCLE_PROFILE_H__ */
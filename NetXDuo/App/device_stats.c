@@ -0,0 +1,318 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    device_stats.c
+  * @author  MCD Application Team
+  * @brief   Counters of the device published over MQTT, as one CBOR message
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "device_stats.h"
+#include "cbor_writer.h"
+#include "thread_profile.h"
+#include "tx_thread.h"
+#include <string.h>
+
+#ifdef DEVICE_STATS
+
+/* Private define ------------------------------------------------------------*/
+/* Items of the message array after the version and the uptime */
+#ifndef NXD_MQTT_LATENCY_ENABLE
+#define DEVICE_STATS_GROUPS           7U
+#else
+#define DEVICE_STATS_GROUPS           8U
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+/* Pools of a size class list and threads reported, the others are left out */
+#define DEVICE_STATS_POOLS            4U
+#define DEVICE_STATS_THREADS          16U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct DEVICE_STATS_THREAD_STRUCT
+{
+  const CHAR *name;
+  ULONG       stack_used;
+  ULONG       stack_size;
+} DEVICE_STATS_THREAD;
+
+/* Exported variables --------------------------------------------------------*/
+ULONG device_stats_counters[DEVICE_STATS_COUNTERS];
+
+/* Private variables ---------------------------------------------------------*/
+/* Message encoded, copied into the packets of the client by nxd_mqtt_client_publish(). */
+static UCHAR device_stats_message[DEVICE_STATS_MESSAGE_SIZE];
+
+/* Tick of the last message. */
+static ULONG device_stats_publish_time;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID device_stats_network_encode(CBOR_WRITER *writer, NX_IP *ip_ptr);
+static VOID device_stats_pools_encode(CBOR_WRITER *writer, NX_PACKET_POOL *pool_ptr);
+static VOID device_stats_threads_encode(CBOR_WRITER *writer);
+#ifdef NXD_MQTT_LATENCY_ENABLE
+static VOID device_stats_latency_encode(CBOR_WRITER *writer, NXD_MQTT_CLIENT *client_ptr);
+static VOID device_stats_histogram_encode(CBOR_WRITER *writer, const NXD_MQTT_LATENCY_HISTOGRAM *histogram_ptr);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Publish the counters once DEVICE_STATS_INTERVAL has elapsed since the last message, with QoS level 0.
+* @param  client_ptr: connected client
+* @param  ip_ptr: IP instance whose driver, IP and TCP counters are read
+* @param  pool_ptr: packet pool of the size class list whose pools are read
+* @retval NXD_MQTT_SUCCESS when published or not due, otherwise the error of nxd_mqtt_client_publish()
+*/
+UINT device_stats_publish(NXD_MQTT_CLIENT *client_ptr, NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  CBOR_WRITER writer;
+  ULONG now = tx_time_get();
+  UINT message_length;
+  UINT i;
+
+  if ((now - device_stats_publish_time) < DEVICE_STATS_INTERVAL)
+  {
+    return NXD_MQTT_SUCCESS;
+  }
+  device_stats_publish_time = now;
+
+  cbor_writer_init(&writer, device_stats_message, sizeof(device_stats_message));
+  cbor_encode_array(&writer, 2U + DEVICE_STATS_GROUPS);
+  cbor_encode_uint(&writer, DEVICE_STATS_VERSION);
+  cbor_encode_uint(&writer, now / TX_TIMER_TICKS_PER_SECOND);
+
+  device_stats_network_encode(&writer, ip_ptr);
+  device_stats_pools_encode(&writer, pool_ptr);
+  device_stats_threads_encode(&writer);
+
+  /* Each counter read once, those added meanwhile go in the next message. */
+  cbor_encode_array(&writer, DEVICE_STATS_TLS_COUNTERS);
+  for (i = 0U; i < DEVICE_STATS_TLS_COUNTERS; i++)
+  {
+    cbor_encode_uint(&writer, device_stats_counters[i]);
+  }
+
+  cbor_encode_array(&writer, DEVICE_STATS_COUNTERS - DEVICE_STATS_TLS_COUNTERS);
+  for (i = DEVICE_STATS_TLS_COUNTERS; i < DEVICE_STATS_COUNTERS; i++)
+  {
+    cbor_encode_uint(&writer, device_stats_counters[i]);
+  }
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+  device_stats_latency_encode(&writer, client_ptr);
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+  /* DEVICE_STATS_MESSAGE_SIZE holds DEVICE_STATS_POOLS pools and DEVICE_STATS_THREADS threads. */
+  if (cbor_writer_finish(&writer, &message_length) != CBOR_WRITER_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  return nxd_mqtt_client_publish(client_ptr, DEVICE_STATS_TOPIC, STRLEN(DEVICE_STATS_TOPIC),
+                                 (CHAR *)device_stats_message, message_length, NX_FALSE, QOS0, NX_NO_WAIT);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Encode the counters of the Ethernet driver, IP and TCP, kept by NetX Duo.
+* @param  writer: message encoded
+* @param  ip_ptr: IP instance
+* @retval None
+*/
+static VOID device_stats_network_encode(CBOR_WRITER *writer, NX_IP *ip_ptr)
+{
+  ULONG link[4] = {0U, 0U, 0U, 0U};
+  ULONG packets_sent;
+  ULONG packets_received;
+  ULONG invalid_packets;
+  ULONG receive_dropped;
+  ULONG send_dropped;
+  ULONG checksum_errors;
+  ULONG connections;
+  ULONG disconnections;
+  ULONG connections_dropped;
+  ULONG retransmits;
+  ULONG unused;
+
+  nx_ip_driver_direct_command(ip_ptr, NX_LINK_GET_RX_COUNT, &link[0]);
+  nx_ip_driver_direct_command(ip_ptr, NX_LINK_GET_TX_COUNT, &link[1]);
+  nx_ip_driver_direct_command(ip_ptr, NX_LINK_GET_ERROR_COUNT, &link[2]);
+  nx_ip_driver_direct_command(ip_ptr, NX_LINK_GET_ALLOC_ERRORS, &link[3]);
+
+  cbor_encode_array(writer, 4U);
+  cbor_encode_uint(writer, link[0]);
+  cbor_encode_uint(writer, link[1]);
+  cbor_encode_uint(writer, link[2]);
+  cbor_encode_uint(writer, link[3]);
+
+  nx_ip_info_get(ip_ptr, &packets_sent, &unused, &packets_received, &unused, &invalid_packets,
+                 &receive_dropped, &unused, &send_dropped, &unused, &unused);
+
+  cbor_encode_array(writer, 5U);
+  cbor_encode_uint(writer, packets_sent);
+  cbor_encode_uint(writer, packets_received);
+  cbor_encode_uint(writer, invalid_packets);
+  cbor_encode_uint(writer, receive_dropped);
+  cbor_encode_uint(writer, send_dropped);
+
+  nx_tcp_info_get(ip_ptr, &packets_sent, &unused, &packets_received, &unused, &invalid_packets, &unused,
+                  &checksum_errors, &connections, &disconnections, &connections_dropped, &retransmits);
+
+  cbor_encode_array(writer, 8U);
+  cbor_encode_uint(writer, packets_sent);
+  cbor_encode_uint(writer, packets_received);
+  cbor_encode_uint(writer, invalid_packets);
+  cbor_encode_uint(writer, checksum_errors);
+  cbor_encode_uint(writer, connections);
+  cbor_encode_uint(writer, disconnections);
+  cbor_encode_uint(writer, connections_dropped);
+  cbor_encode_uint(writer, retransmits);
+}
+
+/**
+* @brief  Encode the counters of each pool of the size class list, smallest payload first.
+* @param  writer: message encoded
+* @param  pool_ptr: pool of the list, or a pool in no list
+* @retval None
+*/
+static VOID device_stats_pools_encode(CBOR_WRITER *writer, NX_PACKET_POOL *pool_ptr)
+{
+  NX_PACKET_POOL *pools[DEVICE_STATS_POOLS];
+  ULONG total_packets;
+  ULONG free_packets;
+  ULONG empty_requests;
+  ULONG invalid_releases;
+  ULONG unused;
+  UINT pool_count = 0U;
+  UINT i;
+
+  if (pool_ptr -> nx_packet_pool_class_first != NX_NULL)
+  {
+    pool_ptr = pool_ptr -> nx_packet_pool_class_first;
+  }
+
+  while ((pool_ptr != NX_NULL) && (pool_count < DEVICE_STATS_POOLS))
+  {
+    pools[pool_count++] = pool_ptr;
+    pool_ptr = pool_ptr -> nx_packet_pool_class_next;
+  }
+
+  cbor_encode_array(writer, pool_count);
+  for (i = 0U; i < pool_count; i++)
+  {
+    nx_packet_pool_info_get(pools[i], &total_packets, &free_packets, &empty_requests, &unused, &invalid_releases);
+
+    cbor_encode_array(writer, 5U);
+    cbor_encode_uint(writer, pools[i] -> nx_packet_pool_payload_size);
+    cbor_encode_uint(writer, total_packets);
+    cbor_encode_uint(writer, free_packets);
+    cbor_encode_uint(writer, empty_requests);
+    cbor_encode_uint(writer, invalid_releases);
+  }
+}
+
+/**
+* @brief  Encode the stack high-water mark of each created thread.
+* @param  writer: message encoded
+* @retval None
+*/
+static VOID device_stats_threads_encode(CBOR_WRITER *writer)
+{
+  TX_INTERRUPT_SAVE_AREA
+  DEVICE_STATS_THREAD threads[DEVICE_STATS_THREADS];
+  TX_THREAD *thread_ptr;
+  UINT thread_count = 0U;
+  UINT i;
+
+  /* The searches are short, they are done at once while the threads cannot be deleted. */
+  TX_DISABLE
+  thread_ptr = _tx_thread_created_ptr;
+  for (i = 0U; (i < _tx_thread_created_count) && (thread_count < DEVICE_STATS_THREADS); i++)
+  {
+    threads[thread_count].name = thread_ptr -> tx_thread_name;
+    threads[thread_count].stack_used = thread_profile_stack_used(thread_ptr);
+    threads[thread_count].stack_size = thread_ptr -> tx_thread_stack_size;
+    thread_count++;
+    thread_ptr = thread_ptr -> tx_thread_created_next;
+  }
+  TX_RESTORE
+
+  cbor_encode_array(writer, thread_count);
+  for (i = 0U; i < thread_count; i++)
+  {
+    cbor_encode_array(writer, 3U);
+    cbor_encode_text(writer, threads[i].name, (UINT)strlen(threads[i].name));
+    cbor_encode_uint(writer, threads[i].stack_used);
+    cbor_encode_uint(writer, threads[i].stack_size);
+  }
+}
+
+#ifdef NXD_MQTT_LATENCY_ENABLE
+/**
+* @brief  Encode the latency histograms of the QoS 1 and QoS 2 messages, cumulative like the counters.
+* @param  writer: message encoded
+* @param  client_ptr: client whose messages are timed
+* @retval None
+*/
+static VOID device_stats_latency_encode(CBOR_WRITER *writer, NXD_MQTT_CLIENT *client_ptr)
+{
+  /* Static, the histograms do not fit in the stack of the MQTT thread. */
+  static NXD_MQTT_LATENCY latency;
+
+  nxd_mqtt_client_latency_get(client_ptr, &latency, NX_FALSE);
+
+  cbor_encode_array(writer, 3U);
+  device_stats_histogram_encode(writer, &latency.nxd_mqtt_latency_queueing);
+  device_stats_histogram_encode(writer, &latency.nxd_mqtt_latency_network);
+  device_stats_histogram_encode(writer, &latency.nxd_mqtt_latency_total);
+}
+
+/**
+* @brief  Encode a latency histogram, with its buckets that counted a message only.
+* @param  writer: message encoded
+* @param  histogram_ptr: histogram
+* @retval None
+*/
+static VOID device_stats_histogram_encode(CBOR_WRITER *writer, const NXD_MQTT_LATENCY_HISTOGRAM *histogram_ptr)
+{
+  UINT bucket_count = 0U;
+  UINT i;
+
+  for (i = 0U; i < NXD_MQTT_LATENCY_BUCKETS; i++)
+  {
+    if (histogram_ptr -> nxd_mqtt_latency_buckets[i] != 0U)
+    {
+      bucket_count++;
+    }
+  }
+
+  cbor_encode_array(writer, 3U);
+  cbor_encode_uint(writer, histogram_ptr -> nxd_mqtt_latency_count);
+  cbor_encode_uint(writer, histogram_ptr -> nxd_mqtt_latency_maximum);
+
+  cbor_encode_map(writer, bucket_count);
+  for (i = 0U; i < NXD_MQTT_LATENCY_BUCKETS; i++)
+  {
+    if (histogram_ptr -> nxd_mqtt_latency_buckets[i] != 0U)
+    {
+      cbor_encode_uint(writer, i);
+      cbor_encode_uint(writer, histogram_ptr -> nxd_mqtt_latency_buckets[i]);
+    }
+  }
+}
+#endif /* NXD_MQTT_LATENCY_ENABLE */
+
+#endif /* DEVICE_STATS */
@@ -0,0 +1,116 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    device_stats.h
+  * @author  MCD Application Team
+  * @brief   Counters of the device published over MQTT, as one CBOR message
+  *
+  *          device_stats_publish() is called by the MQTT thread on each turn
+  *          of its loop, and every DEVICE_STATS_INTERVAL publishes on
+  *          DEVICE_STATS_TOPIC, with QoS level 0, a CBOR array of the counters
+  *          NetX Duo and ThreadX keep already: the Ethernet driver, IP, TCP,
+  *          each packet pool of the size classes and the stack high-water
+  *          mark of each thread. The TLS and MQTT counters NetX Secure and the
+  *          MQTT client do not keep are added here, with DEVICE_STATS_ADD()
+  *          from any thread or interrupt: an exclusive load and store, no lock
+  *          and no interrupt masking. The counters are cumulative since the
+  *          boot, a lost message needs no resend, the next one tells. Without
+  *          DEVICE_STATS, DEVICE_STATS_ADD() and device_stats_publish()
+  *          compile to nothing.
+  *
+  *          The message is the array [version, uptime in seconds,
+  *          [link receive, transmit, errors, allocation errors],
+  *          [IP packets sent, received, invalid, receive dropped, send dropped],
+  *          [TCP packets sent, received, invalid, checksum errors, connections,
+  *           disconnections, connections dropped, retransmits],
+  *          [[pool payload size, total, free, empty requests, invalid releases]...],
+  *          [[thread name, stack used, stack size]...], [TLS counters...],
+  *          [MQTT counters...]], the last two in the order of the indexes below.
+  *          With NXD_MQTT_LATENCY_ENABLE, the array ends with the latency
+  *          histograms of the QoS 1 and QoS 2 messages, [queueing, network,
+  *          total], each [count, maximum, {bucket index: count...}] in
+  *          microseconds, the buckets NXD_MQTT_LATENCY_BUCKET_LOWER() starts
+  *          and that counted a message only.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DEVICE_STATS_H__
+#define __DEVICE_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Version of the message, the first item of its array */
+#define DEVICE_STATS_VERSION          1U
+
+/* TLS counters */
+#define DEVICE_STATS_TLS_SESSIONS     0U  /* Sessions set up for a handshake                */
+#define DEVICE_STATS_TLS_SETUP_ERRORS 1U  /* Sessions not set up, the arena full            */
+#define DEVICE_STATS_TLS_COUNTERS     2U
+
+/* MQTT counters, after the TLS ones */
+#define DEVICE_STATS_MQTT_CONNECTS    2U  /* Connections accepted by the broker             */
+#define DEVICE_STATS_MQTT_FAILED      3U  /* Attempts failed, in TCP, TLS or the CONNACK    */
+#define DEVICE_STATS_MQTT_PUBLISHED   4U  /* QoS1 messages sent, again after a reconnection */
+#define DEVICE_STATS_MQTT_ACKED       5U  /* PUBACKs retiring a message of the store        */
+#define DEVICE_STATS_MQTT_DROPPED     6U  /* Messages not stored, the store full            */
+#define DEVICE_STATS_MQTT_RECEIVED    7U  /* Messages received on the subscriptions         */
+#define DEVICE_STATS_COUNTERS         8U
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef DEVICE_STATS
+
+#define DEVICE_STATS_ADD(counter, value) device_stats_add((counter), (value))
+
+/* Exported variables --------------------------------------------------------*/
+extern ULONG device_stats_counters[DEVICE_STATS_COUNTERS];
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT device_stats_publish(NXD_MQTT_CLIENT *client_ptr, NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Add to a counter, with an exclusive load and store that a preemption between them makes retry.
+* @param  counter: index of the counter
+* @param  value: added
+* @retval None
+*/
+static inline VOID device_stats_add(UINT counter, ULONG value)
+{
+  ULONG count;
+
+  do
+  {
+    count = __LDREXW((volatile uint32_t *)&device_stats_counters[counter]);
+  } while (__STREXW(count + value, (volatile uint32_t *)&device_stats_counters[counter]) != 0U);
+}
+
+#else
+
+#define DEVICE_STATS_ADD(counter, value)
+#define device_stats_publish(client_ptr, ip_ptr, pool_ptr) NXD_MQTT_SUCCESS
+
+#endif /* DEVICE_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __DEVICE_STATS_H__ */
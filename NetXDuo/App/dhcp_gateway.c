@@ -0,0 +1,110 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dhcp_gateway.c
+  * @author  MCD Application Team
+  * @brief   Gateway profile, DHCP server of the downstream sensors
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dhcp_gateway.h"
+#include "nxd_dhcp_server.h"
+
+#ifdef GATEWAY_DHCP_SERVER
+
+/* Private define ------------------------------------------------------------*/
+/* The single Ethernet port of the board */
+#define DHCP_GATEWAY_INTERFACE        0U
+
+/* Private variables ---------------------------------------------------------*/
+static NX_DHCP_SERVER dhcp_gateway_server;
+static ULONG dhcp_gateway_stack[GATEWAY_DHCP_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Sensors given the same address at each start, MAC address high 16 bits, low 32 bits,
+   then the address, in the pool. Constant, the table stays in flash. */
+static const NX_DHCP_STATIC_LEASE dhcp_gateway_static_leases[] =
+{
+  { 0x0080U, 0xE1000001UL, IP_ADDRESS(192, 168, 10, 100) },   /* 00:80:E1:00:00:01 */
+  { 0x0080U, 0xE1000002UL, IP_ADDRESS(192, 168, 10, 101) },   /* 00:80:E1:00:00:02 */
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Give the board its static address on the port and start the DHCP server of the sensors.
+*         Called by the start work item, in place of the DHCP client, once UDP is enabled.
+* @param  ip_ptr: IP instance
+* @param  pool_ptr: packet pool of the server replies, of full size DHCP messages
+* @retval NX_SUCCESS or the error of the address or DHCP server services
+*/
+UINT dhcp_gateway_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  UINT addresses_added;
+  UINT ret;
+
+  /* The address change notify callback reports the address, as a DHCP lease would. */
+  ret = nx_ip_interface_address_set(ip_ptr, DHCP_GATEWAY_INTERFACE, GATEWAY_IP_ADDRESS, GATEWAY_NETWORK_MASK);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_ip_gateway_address_set(ip_ptr, GATEWAY_ROUTER_ADDRESS);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_dhcp_server_create(&dhcp_gateway_server, ip_ptr, dhcp_gateway_stack, sizeof(dhcp_gateway_stack),
+                              "Gateway DHCP Server", pool_ptr);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_dhcp_create_server_ip_address_list(&dhcp_gateway_server, DHCP_GATEWAY_INTERFACE,
+                                              GATEWAY_POOL_START, GATEWAY_POOL_END, &addresses_added);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_dhcp_set_interface_network_parameters(&dhcp_gateway_server, DHCP_GATEWAY_INTERFACE, GATEWAY_NETWORK_MASK,
+                                                 GATEWAY_ROUTER_ADDRESS, USER_DNS_ADDRESS);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* After the address list, the static addresses are reserved in it. */
+  ret = nx_dhcp_set_interface_static_leases(&dhcp_gateway_server, DHCP_GATEWAY_INTERFACE, dhcp_gateway_static_leases,
+                                            sizeof(dhcp_gateway_static_leases) / sizeof(dhcp_gateway_static_leases[0]));
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_dhcp_server_start(&dhcp_gateway_server);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  printf("DHCP server started, %u addresses for the sensors\n", addresses_added);
+
+  return NX_SUCCESS;
+}
+
+#endif /* GATEWAY_DHCP_SERVER */
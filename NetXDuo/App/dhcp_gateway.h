@@ -0,0 +1,53 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dhcp_gateway.h
+  * @author  MCD Application Team
+  * @brief   Gateway profile, DHCP server of the downstream sensors
+  *
+  *          With GATEWAY_DHCP_SERVER defined in app_netxduo.h, the board
+  *          takes the static address GATEWAY_IP_ADDRESS in place of a DHCP
+  *          lease, and its DHCP server hands the addresses from
+  *          GATEWAY_POOL_START to GATEWAY_POOL_END out to the sensors of the
+  *          segment, GATEWAY_ROUTER_ADDRESS as their router. The sensors of
+  *          the static lease table of dhcp_gateway.c, kept in flash, always
+  *          get the same address. The server finds the record of a sensor
+  *          by its MAC address in a hash chain, and a sensor asking for Rapid
+  *          Commit (RFC 4039) is bound by the ACK to its DISCOVER, a single
+  *          round trip. The board has one Ethernet port: the sensors share
+  *          its segment, the gateway does not route their traffic.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DHCP_GATEWAY_H__
+#define __DHCP_GATEWAY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+#ifdef GATEWAY_DHCP_SERVER
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT dhcp_gateway_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+
+#endif /* GATEWAY_DHCP_SERVER */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __DHCP_GATEWAY_H__ */
@@ -0,0 +1,219 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dhcp_lease.c
+  * @author  MCD Application Team
+  * @brief   DHCP lease kept in the backup SRAM across resets
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dhcp_lease.h"
+#include "dns_resolver.h"
+#include "crc_service.h"
+#include <stddef.h>
+
+/* Private define ------------------------------------------------------------*/
+#define DHCP_LEASE_MAGIC              0x4C454153U   /* "LEAS" */
+
+/* Addresses an option holds at most, in its 255 bytes */
+#define DHCP_LEASE_OPTION_WORDS       64U
+
+/* The lease is saved at the start of the 4 KB backup SRAM */
+#define DHCP_LEASE_SAVED              ((DHCP_LEASE_RECORD *)BKPSRAM_BASE)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct DHCP_LEASE_RECORD_STRUCT
+{
+  ULONG magic;                  /* DHCP_LEASE_MAGIC when a lease is saved */
+  ULONG ip_address;
+  ULONG network_mask;
+  ULONG gateway_address;        /* 0 without gateway */
+  ULONG dns_address;            /* First DNS server of the lease, 0 without */
+  ULONG remain_time;            /* Seconds of the lease left when saved, NX_DHCP_INFINITE_LEASE for ever */
+  ULONG checksum;               /* CRC-32 of the words above */
+} DHCP_LEASE_RECORD;
+
+/* Private variables ---------------------------------------------------------*/
+/* Tick the last ACK of the server bound the client at. */
+static ULONG dhcp_lease_bound_time;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID dhcp_lease_state_change(NX_DHCP *dhcp_ptr, UCHAR new_state);
+static UINT dhcp_lease_valid(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Give access to the backup SRAM, kept on VBAT by the backup regulator, and follow the
+*         state of the DHCP client. Called before the DHCP client is started.
+* @param  dhcp_ptr: created DHCP client
+* @retval NX_SUCCESS or the error of nx_dhcp_state_change_notify()
+*/
+UINT dhcp_lease_init(NX_DHCP *dhcp_ptr)
+{
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+  __HAL_RCC_BKPSRAM_CLK_ENABLE();
+
+  /* Keep the backup SRAM on VBAT. HAL_PWREx_EnableBkUpReg() would wait for the regulator on the HAL
+     tick, stopped while the application is defined: the regulator is ready long before the first save. */
+  SET_BIT(PWR -> CSR, PWR_CSR_BRE);
+
+  return nx_dhcp_state_change_notify(dhcp_ptr, dhcp_lease_state_change);
+}
+
+/**
+* @brief  Have the DHCP client request the address of the saved lease, skipping the discovery.
+*         Called before nx_dhcp_start().
+* @param  dhcp_ptr: created DHCP client, not started
+* @retval NX_SUCCESS, NX_NOT_FOUND without a lease left, or the error of nx_dhcp_request_client_ip()
+*/
+UINT dhcp_lease_request(NX_DHCP *dhcp_ptr)
+{
+  DHCP_LEASE_RECORD *record = DHCP_LEASE_SAVED;
+
+  if (!dhcp_lease_valid() || (record -> remain_time == 0U))
+  {
+    return NX_NOT_FOUND;
+  }
+
+  printf("Requesting the address of the last DHCP lease, %lu.%lu.%lu.%lu\n",
+         (record -> ip_address >> 24) & 0xFFU, (record -> ip_address >> 16) & 0xFFU,
+         (record -> ip_address >> 8) & 0xFFU, record -> ip_address & 0xFFU);
+
+  return nx_dhcp_request_client_ip(dhcp_ptr, record -> ip_address, NX_TRUE);
+}
+
+/**
+* @brief  Save the lease the client is bound to, with the time left of it.
+* @param  dhcp_ptr: started DHCP client
+* @retval NX_SUCCESS, NX_DHCP_NOT_BOUND or the error of nx_ip_address_get()
+*/
+UINT dhcp_lease_save(NX_DHCP *dhcp_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+  DHCP_LEASE_RECORD record;
+  ULONG options[DHCP_LEASE_OPTION_WORDS];
+  ULONG elapsed;
+  UINT size;
+  UINT ret;
+
+  /* The lease time, and whether the client is bound at all. */
+  size = sizeof(options);
+  ret = nx_dhcp_user_option_retrieve(dhcp_ptr, NX_DHCP_OPTION_DHCP_LEASE, (UCHAR *)options, &size);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  record.remain_time = options[0];
+  if (record.remain_time != NX_DHCP_INFINITE_LEASE)
+  {
+    elapsed = (tx_time_get() - dhcp_lease_bound_time) / NX_IP_PERIODIC_RATE;
+    record.remain_time = (elapsed < record.remain_time) ? (record.remain_time - elapsed) : 0U;
+  }
+
+  ret = nx_ip_address_get(dhcp_ptr -> nx_dhcp_ip_ptr, &record.ip_address, &record.network_mask);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  if (nx_ip_gateway_address_get(dhcp_ptr -> nx_dhcp_ip_ptr, &record.gateway_address) != NX_SUCCESS)
+  {
+    record.gateway_address = 0U;
+  }
+
+  size = sizeof(options);
+  if (nx_dhcp_user_option_retrieve(dhcp_ptr, NX_DHCP_OPTION_DNS_SVR, (UCHAR *)options, &size) == NX_SUCCESS)
+  {
+    record.dns_address = options[0];
+  }
+  else
+  {
+    record.dns_address = 0U;
+  }
+
+  record.magic = DHCP_LEASE_MAGIC;
+  record.checksum = crc_service_block(&record, offsetof(DHCP_LEASE_RECORD, checksum));
+
+  /* The address bound and the housekeeping work items both save, keep the record whole. */
+  TX_DISABLE
+  *DHCP_LEASE_SAVED = record;
+  TX_RESTORE
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Forget the saved lease, the next start discovers a new one.
+* @param  None
+* @retval None
+*/
+VOID dhcp_lease_clear(VOID)
+{
+  DHCP_LEASE_SAVED -> magic = 0U;
+}
+
+/**
+* @brief  DNS server of the saved lease, known before the DHCP server answers.
+* @param  None
+* @retval Address of the server, 0 without
+*/
+ULONG dhcp_lease_dns_server(VOID)
+{
+  return dhcp_lease_valid() ? DHCP_LEASE_SAVED -> dns_address : 0U;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  DHCP state change callback, called from the DHCP thread. The lease time counts from the
+*         ACK that bound the client, of the first request or of a renewal, and the DNS servers
+*         of the ACK go to the resolver.
+* @param  dhcp_ptr: DHCP client
+* @param  new_state: state entered
+* @retval None
+*/
+static VOID dhcp_lease_state_change(NX_DHCP *dhcp_ptr, UCHAR new_state)
+{
+  ULONG servers[DHCP_LEASE_OPTION_WORDS];
+  UINT size = sizeof(servers);
+
+  if (new_state == NX_DHCP_STATE_BOUND)
+  {
+    dhcp_lease_bound_time = tx_time_get();
+
+    /* The DHCP mutex nests, the DHCP thread holds it already. */
+    if (nx_dhcp_user_option_retrieve(dhcp_ptr, NX_DHCP_OPTION_DNS_SVR, (UCHAR *)servers, &size) == NX_SUCCESS)
+    {
+      dns_resolver_servers_set(servers, size / sizeof(ULONG));
+    }
+  }
+}
+
+/**
+* @brief  Determine if the backup SRAM holds a saved lease.
+* @param  None
+* @retval 1 if a lease is saved, 0 otherwise
+*/
+static UINT dhcp_lease_valid(VOID)
+{
+  DHCP_LEASE_RECORD *record = DHCP_LEASE_SAVED;
+
+  /* The backup SRAM is random after a power off without VBAT. */
+  return (record -> magic == DHCP_LEASE_MAGIC) &&
+         (record -> checksum == crc_service_block(record, offsetof(DHCP_LEASE_RECORD, checksum)));
+}
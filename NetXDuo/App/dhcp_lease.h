@@ -0,0 +1,53 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dhcp_lease.h
+  * @author  MCD Application Team
+  * @brief   DHCP lease kept in the backup SRAM across resets
+  *
+  *          The address, network mask, gateway and DNS server of the lease
+  *          are saved in the backup SRAM once bound, then every
+  *          DHCP_LEASE_SAVE_PERIOD with the lease time left. At the next
+  *          start, dhcp_lease_request() has the DHCP client ask for the same
+  *          address straight away (INIT-REBOOT, RFC 2131 section 3.2),
+  *          one request and its ACK in place of the discovery, and the DNS
+  *          server is known before the answer. The server still has the last
+  *          word: a NAK, or no answer within DHCP_LEASE_REBOOT_WAIT, falls
+  *          back to the discovery. The backup SRAM keeps the lease across the
+  *          resets, and across power off only with a battery on VBAT; the
+  *          time spent off is not known, the server checks the lease anyway.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DHCP_LEASE_H__
+#define __DHCP_LEASE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT  dhcp_lease_init(NX_DHCP *dhcp_ptr);
+UINT  dhcp_lease_request(NX_DHCP *dhcp_ptr);
+UINT  dhcp_lease_save(NX_DHCP *dhcp_ptr);
+VOID  dhcp_lease_clear(VOID);
+ULONG dhcp_lease_dns_server(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __DHCP_LEASE_H__ */
@@ -0,0 +1,245 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dma_copy.c
+  * @author  MCD Application Team
+  * @brief   Large memory copies by the memory-to-memory stream of DMA2
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dma_copy.h"
+#include "thread_profile.h"
+#include "main.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+/* Words of one transfer, the width of the NDTR register */
+#define DMA_COPY_MAX_WORDS            0xFFFFU
+
+/* Private variables ---------------------------------------------------------*/
+static DMA_HandleTypeDef dma_copy_handle;
+static TX_SEMAPHORE dma_copy_semaphore;
+
+/* Set from dma_copy_init() on */
+static UINT dma_copy_ready;
+
+/* A copy is in progress, the stream belongs to the thread that started it */
+static volatile UINT dma_copy_busy;
+
+/* The part of the copy given to the DMA, made again by the CPU if the transfer fails */
+static VOID *dma_copy_destination;
+static const VOID *dma_copy_source;
+static ULONG dma_copy_size;
+static volatile UINT dma_copy_error;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT dma_copy_reachable(const VOID *address, ULONG size);
+static VOID dma_copy_complete(DMA_HandleTypeDef *hdma);
+static VOID dma_copy_failed(DMA_HandleTypeDef *hdma);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Set up DMA2 stream 1 for memory-to-memory word transfers, and its semaphore.
+* @param  None
+* @retval TX_SUCCESS, the error of the semaphore creation, or TX_START_ERROR
+*/
+UINT dma_copy_init(VOID)
+{
+  UINT ret;
+
+  ret = tx_semaphore_create(&dma_copy_semaphore, "DMA Copy Semaphore", 0);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* The FIFO is required in memory-to-memory mode, single transfers never cross a 1 KB boundary */
+  dma_copy_handle.Instance = DMA2_Stream1;
+  dma_copy_handle.Init.Channel = DMA_CHANNEL_0;
+  dma_copy_handle.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  dma_copy_handle.Init.PeriphInc = DMA_PINC_ENABLE;
+  dma_copy_handle.Init.MemInc = DMA_MINC_ENABLE;
+  dma_copy_handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  dma_copy_handle.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  dma_copy_handle.Init.Mode = DMA_NORMAL;
+  dma_copy_handle.Init.Priority = DMA_PRIORITY_LOW;
+  dma_copy_handle.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+  dma_copy_handle.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+  dma_copy_handle.Init.MemBurst = DMA_MBURST_SINGLE;
+  dma_copy_handle.Init.PeriphBurst = DMA_PBURST_SINGLE;
+  if (HAL_DMA_Init(&dma_copy_handle) != HAL_OK)
+  {
+    tx_semaphore_delete(&dma_copy_semaphore);
+    return TX_START_ERROR;
+  }
+  dma_copy_handle.XferCpltCallback = dma_copy_complete;
+  dma_copy_handle.XferErrorCallback = dma_copy_failed;
+
+  HAL_NVIC_SetPriority(DMA2_Stream1_IRQn, DMA_COPY_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+
+  dma_copy_ready = 1U;
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Copy size bytes, by the DMA when it is worth it and the buffers allow it, else by the CPU.
+* @param  destination: buffer written, not overlapping the source
+* @param  source: buffer read
+* @param  size: number of bytes
+* @retval destination, as memcpy()
+*/
+VOID *dma_copy(VOID *destination, const VOID *source, ULONG size)
+{
+  if (dma_copy_start(destination, source, size) == DMA_COPY_PENDING)
+  {
+    dma_copy_wait();
+  }
+
+  return destination;
+}
+
+/**
+* @brief  Start a copy and return without waiting for the DMA. The bytes past the words one
+*         transfer carries are copied by the CPU meanwhile. The buffers are not to be accessed
+*         until dma_copy_wait().
+* @param  destination: buffer written, not overlapping the source
+* @param  source: buffer read
+* @param  size: number of bytes
+* @retval DMA_COPY_DONE when the CPU made the copy, DMA_COPY_PENDING when the calling thread is
+*         to call dma_copy_wait()
+*/
+UINT dma_copy_start(VOID *destination, const VOID *source, ULONG size)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG words;
+
+  /* A thread that may suspend, buffers the DMA can reach word by word. */
+  if ((size < DMA_COPY_THRESHOLD) || !dma_copy_ready ||
+      ((((ULONG)destination) | ((ULONG)source)) & (sizeof(ULONG) - 1U)) ||
+      !dma_copy_reachable(destination, size) || !dma_copy_reachable(source, size) ||
+      (__get_IPSR() != 0U) || (__get_PRIMASK() != 0U) || (tx_thread_identify() == TX_NULL))
+  {
+    memcpy(destination, source, size);
+    return DMA_COPY_DONE;
+  }
+
+  /* Another thread copies, the CPU is done before that copy is. */
+  TX_DISABLE
+  if (dma_copy_busy)
+  {
+    TX_RESTORE
+    memcpy(destination, source, size);
+    return DMA_COPY_DONE;
+  }
+  dma_copy_busy = 1U;
+  TX_RESTORE
+
+  words = size / sizeof(ULONG);
+  if (words > DMA_COPY_MAX_WORDS)
+  {
+    words = DMA_COPY_MAX_WORDS;
+  }
+
+  dma_copy_destination = destination;
+  dma_copy_source = source;
+  dma_copy_size = words * sizeof(ULONG);
+  dma_copy_error = 0U;
+
+  if (HAL_DMA_Start_IT(&dma_copy_handle, (uint32_t)source, (uint32_t)destination, words) != HAL_OK)
+  {
+    dma_copy_busy = 0U;
+    memcpy(destination, source, size);
+    return DMA_COPY_DONE;
+  }
+
+  /* The tail overlaps the transfer. */
+  memcpy((UCHAR *)destination + dma_copy_size, (const UCHAR *)source + dma_copy_size, size - dma_copy_size);
+
+  return DMA_COPY_PENDING;
+}
+
+/**
+* @brief  Suspend until the copy started by the calling thread completes, and free the stream.
+* @param  None
+* @retval None
+*/
+VOID dma_copy_wait(VOID)
+{
+  tx_semaphore_get(&dma_copy_semaphore, TX_WAIT_FOREVER);
+
+  /* A bus error aborted the transfer, the CPU copies what the DMA was given. */
+  if (dma_copy_error)
+  {
+    memcpy(dma_copy_destination, dma_copy_source, dma_copy_size);
+  }
+
+  dma_copy_busy = 0U;
+}
+
+/**
+* @brief  This function handles DMA2 stream1 global interrupt, the memory copies.
+* @param  None
+* @retval None
+*/
+void DMA2_Stream1_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+  HAL_DMA_IRQHandler(&dma_copy_handle);
+  THREAD_PROFILE_ISR_EXIT();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Tell whether the DMA reaches a buffer: the CCM-RAM is on the data bus of the CPU only.
+* @param  address: start of the buffer
+* @param  size: bytes of the buffer, not zero
+* @retval 1 when reachable, 0 otherwise
+*/
+static UINT dma_copy_reachable(const VOID *address, ULONG size)
+{
+  ULONG start = (ULONG)address;
+  ULONG end = start + size - 1U;
+
+  return ((end < CCMDATARAM_BASE) || (start > CCMDATARAM_END)) ? 1U : 0U;
+}
+
+/**
+* @brief  Transfer complete, resume the thread waiting for it. Called from the DMA interrupt.
+* @param  hdma: DMA handle
+* @retval None
+*/
+static VOID dma_copy_complete(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  tx_semaphore_put(&dma_copy_semaphore);
+}
+
+/**
+* @brief  Transfer aborted on an error, resume the thread waiting for it. Called from the DMA interrupt.
+* @param  hdma: DMA handle
+* @retval None
+*/
+static VOID dma_copy_failed(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  dma_copy_error = 1U;
+  tx_semaphore_put(&dma_copy_semaphore);
+}
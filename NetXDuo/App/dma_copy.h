@@ -0,0 +1,66 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dma_copy.h
+  * @author  MCD Application Team
+  * @brief   Large memory copies by the memory-to-memory stream of DMA2
+  *
+  *          A copy of DMA_COPY_THRESHOLD bytes or more between word aligned
+  *          buffers of the main SRAM or the flash is made by DMA2 stream 1,
+  *          the calling thread suspended on a semaphore meanwhile, so that
+  *          the other threads compute during the transfer. The shorter or
+  *          unaligned copies, the ones involving the CCM-RAM the DMA cannot
+  *          reach, those from an interrupt, with interrupts disabled or
+  *          before the kernel runs, and the ones made while the stream is
+  *          busy with another copy stay on the CPU with memcpy().
+  *          dma_copy() is NX_PACKET_DATA_COPY in nx_user.h, the copy of
+  *          nx_packet_data_append(), nx_packet_copy(),
+  *          nx_packet_data_extract_offset() and nx_packet_data_retrieve(),
+  *          the TLS record reassembly included. dma_copy_start() and
+  *          dma_copy_wait() let a thread work on something else, a hash of
+  *          the previous chunk for instance, until its copy completes. Not
+  *          for the timer expiration functions, which cannot suspend.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DMA_COPY_H__
+#define __DMA_COPY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Bytes from which a copy goes to the DMA: under it, memcpy() ends before the
+   transfer is set up and its interrupt and the two context switches are taken */
+#define DMA_COPY_THRESHOLD            1024U
+#define DMA_COPY_IRQ_PRIORITY         10U  /* Under the ADC1 stream */
+
+/* Returned by dma_copy_start() */
+#define DMA_COPY_DONE                 0U   /* Copied by the CPU already */
+#define DMA_COPY_PENDING              1U   /* In progress, dma_copy_wait() before using the data */
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT dma_copy_init(VOID);
+VOID *dma_copy(VOID *destination, const VOID *source, ULONG size);
+UINT dma_copy_start(VOID *destination, const VOID *source, ULONG size);
+VOID dma_copy_wait(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __DMA_COPY_H__ */
@@ -0,0 +1,575 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dns_resolver.c
+  * @author  MCD Application Team
+  * @brief   Host names resolved once, then refreshed in the background
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dns_resolver.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define DNS_RESOLVER_REFRESH_EVENT    1U
+#define DNS_RESOLVER_SERVERS_EVENT    2U
+
+/* Response time of a server that did not answer its probe */
+#define DNS_RESOLVER_NO_ANSWER        0xFFFFFFFFU
+
+/* Probe of a server, the SOA record of the root zone: the header, the root name, the type and the class */
+#define DNS_RESOLVER_PROBE_SIZE       (12U + 1U + 2U + 2U)
+#define DNS_RESOLVER_RR_TYPE_SOA      6U
+#define DNS_RESOLVER_RR_CLASS_IN      1U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct DNS_RESOLVER_ENTRY_STRUCT
+{
+  const CHAR *name;             /* Host name, a string kept by the caller, NX_NULL when free */
+  ULONG       address;          /* Last address resolved, 0 before the first */
+  ULONG       expiry;           /* Tick the time to live of the address ends at */
+  UINT        refresh_pending;  /* The resolver thread is asked to refresh it */
+#ifdef FEATURE_NX_IPV6
+  ULONG       address6[4];      /* Last IPv6 address resolved, all 0 before the first */
+  ULONG       expiry6;          /* Tick the time to live of the IPv6 address ends at, 0 before the first query */
+  UINT        refresh6_pending; /* The resolver thread is asked to look up the AAAA record */
+#endif
+} DNS_RESOLVER_ENTRY;
+
+/* Private variables ---------------------------------------------------------*/
+static NX_DNS *dns_resolver_dns_ptr;
+
+static DNS_RESOLVER_ENTRY dns_resolver_entries[DNS_RESOLVER_HOSTS];
+static TX_MUTEX dns_resolver_mutex;
+static TX_EVENT_FLAGS_GROUP dns_resolver_events;
+
+/* DNS servers of the last DHCP ACK, ranked by the resolver thread once it runs. */
+static ULONG dns_resolver_servers[DNS_RESOLVER_SERVERS];
+static UINT dns_resolver_server_count;
+static UINT dns_resolver_servers_pending;
+static UINT dns_resolver_started;
+static USHORT dns_resolver_probe_id;
+
+static TX_THREAD dns_resolver_thread;
+static ULONG dns_resolver_thread_stack[DNS_RESOLVER_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID dns_resolver_thread_entry(ULONG thread_input);
+static DNS_RESOLVER_ENTRY *dns_resolver_entry_get(const CHAR *host_name);
+static UINT dns_resolver_query(DNS_RESOLVER_ENTRY *entry, ULONG wait_option);
+#ifdef FEATURE_NX_IPV6
+static UINT dns_resolver_query6(DNS_RESOLVER_ENTRY *entry, ULONG wait_option);
+#endif
+static VOID dns_resolver_servers_rank(VOID);
+static ULONG dns_resolver_probe(NX_UDP_SOCKET *socket_ptr, ULONG server_address);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the resolver over a DNS client whose servers and cache are set.
+* @param  dns_ptr: created DNS client
+* @retval TX_SUCCESS or the error of the object creations
+*/
+UINT dns_resolver_start(NX_DNS *dns_ptr)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UINT pending;
+  UINT ret;
+
+  dns_resolver_dns_ptr = dns_ptr;
+
+  ret = tx_mutex_create(&dns_resolver_mutex, "DNS resolver", TX_NO_INHERIT);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_event_flags_create(&dns_resolver_events, "DNS resolver");
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* Rank the servers of an ACK received before the start. */
+  TX_DISABLE
+  dns_resolver_started = NX_TRUE;
+  pending = dns_resolver_servers_pending;
+  TX_RESTORE
+
+  if (pending)
+  {
+    tx_event_flags_set(&dns_resolver_events, DNS_RESOLVER_SERVERS_EVENT, TX_OR);
+  }
+
+  return tx_thread_create(&dns_resolver_thread, "App DNS Resolver Thread", dns_resolver_thread_entry, 0,
+                          dns_resolver_thread_stack, sizeof(dns_resolver_thread_stack),
+                          DNS_RESOLVER_PRIORITY, DNS_RESOLVER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Get the address of a host. Only the first call for a name waits for the DNS servers,
+*         the next ones return the last address, stale or not, and a stale one is refreshed by
+*         the resolver thread.
+* @param  host_name: name to resolve, kept by the caller while the resolver runs
+* @param  host_address_ptr: IPv4 address of the host, set
+* @param  wait_option: ticks to wait for the first resolution
+* @retval NX_SUCCESS, NX_DNS_CACHE_ERROR if DNS_RESOLVER_HOSTS names are resolved already,
+*         or the error of nx_dns_host_by_name_get()
+*/
+UINT dns_resolver_host_get(const CHAR *host_name, ULONG *host_address_ptr, ULONG wait_option)
+{
+  DNS_RESOLVER_ENTRY *entry;
+  UINT ret;
+
+  tx_mutex_get(&dns_resolver_mutex, TX_WAIT_FOREVER);
+
+  entry = dns_resolver_entry_get(host_name);
+  if (entry == NX_NULL)
+  {
+    tx_mutex_put(&dns_resolver_mutex);
+    return NX_DNS_CACHE_ERROR;
+  }
+
+  if (entry -> address != 0U)
+  {
+    *host_address_ptr = entry -> address;
+
+    /* Stale while revalidate: the caller goes on with the old address. */
+    if (((LONG)(tx_time_get() - entry -> expiry) >= 0) && !entry -> refresh_pending)
+    {
+      entry -> refresh_pending = NX_TRUE;
+      tx_event_flags_set(&dns_resolver_events, DNS_RESOLVER_REFRESH_EVENT, TX_OR);
+    }
+
+    tx_mutex_put(&dns_resolver_mutex);
+    return NX_SUCCESS;
+  }
+
+  tx_mutex_put(&dns_resolver_mutex);
+
+  /* Nothing known yet, wait for the servers. */
+  ret = dns_resolver_query(entry, wait_option);
+  if (ret == NX_SUCCESS)
+  {
+    *host_address_ptr = entry -> address;
+  }
+
+  return ret;
+}
+
+#ifdef FEATURE_NX_IPV6
+/**
+* @brief  Get the IPv6 address of a host, without waiting. The AAAA record is looked up by the
+*         resolver thread, the first time and once its time to live has passed, and the last
+*         address is returned in the meantime.
+* @param  host_name: name to resolve, kept by the caller while the resolver runs
+* @param  host_address_ptr: IPv6 address of the host, 4 words, set
+* @retval NX_SUCCESS, NX_IN_PROGRESS while no address is known, or NX_DNS_CACHE_ERROR
+*         if DNS_RESOLVER_HOSTS names are resolved already
+*/
+UINT dns_resolver_host6_get(const CHAR *host_name, ULONG *host_address_ptr)
+{
+  DNS_RESOLVER_ENTRY *entry;
+  UINT ret = NX_IN_PROGRESS;
+
+  tx_mutex_get(&dns_resolver_mutex, TX_WAIT_FOREVER);
+
+  entry = dns_resolver_entry_get(host_name);
+  if (entry == NX_NULL)
+  {
+    tx_mutex_put(&dns_resolver_mutex);
+    return NX_DNS_CACHE_ERROR;
+  }
+
+  if (entry -> address6[0] | entry -> address6[1] | entry -> address6[2] | entry -> address6[3])
+  {
+    memcpy(host_address_ptr, entry -> address6, sizeof(entry -> address6));
+    ret = NX_SUCCESS;
+  }
+
+  if (((entry -> expiry6 == 0U) || ((LONG)(tx_time_get() - entry -> expiry6) >= 0)) && !entry -> refresh6_pending)
+  {
+    entry -> refresh6_pending = NX_TRUE;
+    tx_event_flags_set(&dns_resolver_events, DNS_RESOLVER_REFRESH_EVENT, TX_OR);
+  }
+
+  tx_mutex_put(&dns_resolver_mutex);
+
+  return ret;
+}
+#endif /* FEATURE_NX_IPV6 */
+
+/**
+* @brief  Set the DNS servers of a DHCP ACK, the first one or a renewal. The resolver thread measures
+*         their response times and has the DNS client ask the fastest first, then USER_DNS_ADDRESS and
+*         USER_DNS_ADDRESS_SECONDARY, then the servers that did not answer. Called from the DHCP thread,
+*         before or after dns_resolver_start().
+* @param  server_addresses: IPv4 addresses of the servers, in the order of the DHCP server
+* @param  server_count: number of servers, the ones past DNS_RESOLVER_SERVERS are left out
+* @retval None
+*/
+VOID dns_resolver_servers_set(const ULONG *server_addresses, UINT server_count)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UINT started;
+  UINT i;
+
+  if (server_count > DNS_RESOLVER_SERVERS)
+  {
+    server_count = DNS_RESOLVER_SERVERS;
+  }
+
+  TX_DISABLE
+  for (i = 0; i < server_count; i++)
+  {
+    dns_resolver_servers[i] = server_addresses[i];
+  }
+  dns_resolver_server_count = server_count;
+  dns_resolver_servers_pending = NX_TRUE;
+  started = dns_resolver_started;
+  TX_RESTORE
+
+  if (started)
+  {
+    tx_event_flags_set(&dns_resolver_events, DNS_RESOLVER_SERVERS_EVENT, TX_OR);
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Resolver thread entry, rank the DHCP servers and refresh the stale addresses asked for.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID dns_resolver_thread_entry(ULONG thread_input)
+{
+  ULONG events;
+  UINT i;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  for (;;)
+  {
+    tx_event_flags_get(&dns_resolver_events, DNS_RESOLVER_REFRESH_EVENT | DNS_RESOLVER_SERVERS_EVENT, TX_OR_CLEAR,
+                       &events, TX_WAIT_FOREVER);
+
+    if (events & DNS_RESOLVER_SERVERS_EVENT)
+    {
+      dns_resolver_servers_rank();
+    }
+
+    for (i = 0; i < DNS_RESOLVER_HOSTS; i++)
+    {
+      if (dns_resolver_entries[i].refresh_pending)
+      {
+        dns_resolver_query(&dns_resolver_entries[i], DEFAULT_TIMEOUT);
+        dns_resolver_entries[i].refresh_pending = NX_FALSE;
+      }
+
+#ifdef FEATURE_NX_IPV6
+      if (dns_resolver_entries[i].refresh6_pending)
+      {
+        dns_resolver_query6(&dns_resolver_entries[i], DEFAULT_TIMEOUT);
+        dns_resolver_entries[i].refresh6_pending = NX_FALSE;
+      }
+#endif
+    }
+  }
+}
+
+/**
+* @brief  Find the entry of a name, or take a free one for it. Called with the mutex held.
+* @param  host_name: name to resolve, kept by the caller while the resolver runs
+* @retval Entry of the name, NX_NULL when all are taken
+*/
+static DNS_RESOLVER_ENTRY *dns_resolver_entry_get(const CHAR *host_name)
+{
+  DNS_RESOLVER_ENTRY *entry = NX_NULL;
+  UINT i;
+
+  for (i = 0; i < DNS_RESOLVER_HOSTS; i++)
+  {
+    if ((dns_resolver_entries[i].name != NX_NULL) && (strcmp(dns_resolver_entries[i].name, host_name) == 0))
+    {
+      entry = &dns_resolver_entries[i];
+      break;
+    }
+
+    if ((entry == NX_NULL) && (dns_resolver_entries[i].name == NX_NULL))
+    {
+      entry = &dns_resolver_entries[i];
+    }
+  }
+
+  if (entry != NX_NULL)
+  {
+    entry -> name = host_name;
+  }
+
+  return entry;
+}
+
+/**
+* @brief  Ask the DNS client for the address of an entry, and keep it until its time to live ends.
+*         On failure the last address is kept and a new query is done after DNS_RESOLVER_RETRY_INTERVAL.
+* @param  entry: entry of the name
+* @param  wait_option: ticks to wait for the servers
+* @retval NX_SUCCESS or the error of nx_dns_host_by_name_get()
+*/
+static UINT dns_resolver_query(DNS_RESOLVER_ENTRY *entry, ULONG wait_option)
+{
+  ULONG address;
+  ULONG ttl;
+  ULONG lifetime;
+  UINT ret;
+
+  /* The DNS client tries its servers in turn, the next one when the current one does not answer. */
+  ret = nx_dns_host_by_name_get(dns_resolver_dns_ptr, (UCHAR *)entry -> name, &address, wait_option);
+
+  if (ret == NX_SUCCESS)
+  {
+    /* The answer is in the cache with its time to live, unless the cache is full. */
+    if (nx_dns_cache_ttl_get(dns_resolver_dns_ptr, (UCHAR *)entry -> name, NX_DNS_RR_TYPE_A, &ttl) == NX_DNS_SUCCESS)
+    {
+      lifetime = ttl * NX_IP_PERIODIC_RATE;
+    }
+    else
+    {
+      lifetime = DNS_RESOLVER_DEFAULT_TTL;
+    }
+  }
+  else
+  {
+    lifetime = DNS_RESOLVER_RETRY_INTERVAL;
+  }
+
+  tx_mutex_get(&dns_resolver_mutex, TX_WAIT_FOREVER);
+  if (ret == NX_SUCCESS)
+  {
+    entry -> address = address;
+  }
+  entry -> expiry = tx_time_get() + lifetime;
+  tx_mutex_put(&dns_resolver_mutex);
+
+  return ret;
+}
+
+#ifdef FEATURE_NX_IPV6
+/**
+* @brief  Ask the DNS client for the AAAA record of an entry, as dns_resolver_query() for the A record.
+*         A name without AAAA record is asked again after DNS_RESOLVER_RETRY_INTERVAL.
+* @param  entry: entry of the name
+* @param  wait_option: ticks to wait for the servers
+* @retval NX_SUCCESS or the error of nxd_dns_host_by_name_get()
+*/
+static UINT dns_resolver_query6(DNS_RESOLVER_ENTRY *entry, ULONG wait_option)
+{
+  NXD_ADDRESS address;
+  ULONG ttl;
+  ULONG lifetime;
+  UINT ret;
+
+  ret = nxd_dns_host_by_name_get(dns_resolver_dns_ptr, (UCHAR *)entry -> name, &address, wait_option,
+                                 NX_IP_VERSION_V6);
+
+  if (ret == NX_SUCCESS)
+  {
+    if (nx_dns_cache_ttl_get(dns_resolver_dns_ptr, (UCHAR *)entry -> name, NX_DNS_RR_TYPE_AAAA, &ttl) == NX_DNS_SUCCESS)
+    {
+      lifetime = ttl * NX_IP_PERIODIC_RATE;
+    }
+    else
+    {
+      lifetime = DNS_RESOLVER_DEFAULT_TTL;
+    }
+  }
+  else
+  {
+    lifetime = DNS_RESOLVER_RETRY_INTERVAL;
+  }
+
+  tx_mutex_get(&dns_resolver_mutex, TX_WAIT_FOREVER);
+  if (ret == NX_SUCCESS)
+  {
+    memcpy(entry -> address6, address.nxd_ip_address.v6, sizeof(entry -> address6));
+  }
+
+  /* Never 0 once queried, 0 asks for the first query. */
+  entry -> expiry6 = (tx_time_get() + lifetime) | 1U;
+  tx_mutex_put(&dns_resolver_mutex);
+
+  return ret;
+}
+#endif /* FEATURE_NX_IPV6 */
+
+/**
+* @brief  Probe the DHCP servers, then replace the servers of the DNS client, the fastest first.
+*         The list is replaced under the mutex of the DNS client, no query finds it empty.
+* @param  None
+* @retval None
+*/
+static VOID dns_resolver_servers_rank(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  NX_UDP_SOCKET probe_socket;
+  ULONG servers[DNS_RESOLVER_SERVERS];
+  ULONG times[DNS_RESOLVER_SERVERS];
+  ULONG server;
+  ULONG time;
+  UINT count;
+  UINT i;
+  UINT j;
+
+  TX_DISABLE
+  count = dns_resolver_server_count;
+  for (i = 0; i < count; i++)
+  {
+    servers[i] = dns_resolver_servers[i];
+  }
+  dns_resolver_servers_pending = NX_FALSE;
+  TX_RESTORE
+
+  if (count == 0U)
+  {
+    return;
+  }
+
+  if (nx_udp_socket_create(dns_resolver_dns_ptr -> nx_dns_ip_ptr, &probe_socket, "DNS probe", NX_IP_NORMAL,
+                           NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, 2) != NX_SUCCESS)
+  {
+    return;
+  }
+
+  if (nx_udp_socket_bind(&probe_socket, NX_ANY_PORT, NX_NO_WAIT) != NX_SUCCESS)
+  {
+    nx_udp_socket_delete(&probe_socket);
+    return;
+  }
+
+  /* Measure each server, insertion sorted by response time, the DHCP order kept on ties. */
+  for (i = 0; i < count; i++)
+  {
+    server = servers[i];
+    time = dns_resolver_probe(&probe_socket, server);
+
+    for (j = i; (j > 0U) && (times[j - 1U] > time); j--)
+    {
+      servers[j] = servers[j - 1U];
+      times[j] = times[j - 1U];
+    }
+    servers[j] = server;
+    times[j] = time;
+  }
+
+  nx_udp_socket_unbind(&probe_socket);
+  nx_udp_socket_delete(&probe_socket);
+
+  /* The DNS client mutex nests, the server calls below take it again. */
+  tx_mutex_get(&dns_resolver_dns_ptr -> nx_dns_mutex, TX_WAIT_FOREVER);
+
+  nx_dns_server_remove_all(dns_resolver_dns_ptr);
+
+  /* The servers that answered, then the configured ones, then the silent ones. The duplicates are refused. */
+  for (i = 0; (i < count) && (times[i] != DNS_RESOLVER_NO_ANSWER); i++)
+  {
+    printf("DNS server %lu.%lu.%lu.%lu answered in %lu ms\n", (servers[i] >> 24) & 0xFFU,
+           (servers[i] >> 16) & 0xFFU, (servers[i] >> 8) & 0xFFU, servers[i] & 0xFFU, times[i]);
+    nx_dns_server_add(dns_resolver_dns_ptr, servers[i]);
+  }
+
+  nx_dns_server_add(dns_resolver_dns_ptr, USER_DNS_ADDRESS);
+  nx_dns_server_add(dns_resolver_dns_ptr, USER_DNS_ADDRESS_SECONDARY);
+
+  for (; i < count; i++)
+  {
+    nx_dns_server_add(dns_resolver_dns_ptr, servers[i]);
+  }
+
+  tx_mutex_put(&dns_resolver_dns_ptr -> nx_dns_mutex);
+}
+
+/**
+* @brief  Send a query to a DNS server and time its answer.
+* @param  socket_ptr: bound UDP socket
+* @param  server_address: IPv4 address of the server
+* @retval Response time in ms, DNS_RESOLVER_NO_ANSWER without answer within DNS_RESOLVER_PROBE_TIMEOUT
+*/
+static ULONG dns_resolver_probe(NX_UDP_SOCKET *socket_ptr, ULONG server_address)
+{
+  NX_PACKET_POOL *pool_ptr = dns_resolver_dns_ptr -> nx_dns_packet_pool_ptr;
+  NX_PACKET *packet_ptr;
+  UCHAR query[DNS_RESOLVER_PROBE_SIZE];
+  USHORT id = ++dns_resolver_probe_id;
+  ULONG deadline;
+  ULONG start;
+  ULONG source_address;
+  UINT source_port;
+  UINT match;
+
+  /* Header with the recursion desired flag and one question, then the question. */
+  memset(query, 0, sizeof(query));
+  query[0] = (UCHAR)(id >> 8);
+  query[1] = (UCHAR)id;
+  query[2] = 0x01U;
+  query[5] = 1U;
+  query[14] = DNS_RESOLVER_RR_TYPE_SOA;
+  query[16] = DNS_RESOLVER_RR_CLASS_IN;
+
+  if (nx_packet_allocate(pool_ptr, &packet_ptr, NX_UDP_PACKET, DNS_RESOLVER_PROBE_TIMEOUT) != NX_SUCCESS)
+  {
+    return DNS_RESOLVER_NO_ANSWER;
+  }
+
+  if (nx_packet_data_append(packet_ptr, query, sizeof(query), pool_ptr, DNS_RESOLVER_PROBE_TIMEOUT) != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+    return DNS_RESOLVER_NO_ANSWER;
+  }
+
+  start = HAL_GetTick();
+  deadline = tx_time_get() + DNS_RESOLVER_PROBE_TIMEOUT;
+
+  if (nx_udp_socket_send(socket_ptr, packet_ptr, server_address, NX_DNS_PORT) != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+    return DNS_RESOLVER_NO_ANSWER;
+  }
+
+  /* A late answer to a previous probe is skipped by its ID. */
+  for (;;)
+  {
+    if ((LONG)(deadline - tx_time_get()) <= 0)
+    {
+      return DNS_RESOLVER_NO_ANSWER;
+    }
+
+    if (nx_udp_socket_receive(socket_ptr, &packet_ptr, deadline - tx_time_get()) != NX_SUCCESS)
+    {
+      return DNS_RESOLVER_NO_ANSWER;
+    }
+
+    match = (nx_udp_source_extract(packet_ptr, &source_address, &source_port) == NX_SUCCESS) &&
+            (source_address == server_address) && (packet_ptr -> nx_packet_length >= 2U) &&
+            (packet_ptr -> nx_packet_prepend_ptr[0] == (UCHAR)(id >> 8)) &&
+            (packet_ptr -> nx_packet_prepend_ptr[1] == (UCHAR)id);
+    nx_packet_release(packet_ptr);
+
+    if (match)
+    {
+      return HAL_GetTick() - start;
+    }
+  }
+}
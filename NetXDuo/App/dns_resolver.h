@@ -0,0 +1,57 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dns_resolver.h
+  * @author  MCD Application Team
+  * @brief   Host names resolved once, then refreshed in the background
+  *
+  *          dns_resolver_host_get() waits for the DNS servers only the first
+  *          time a name is asked for. The address is then kept with the time
+  *          to live of its answer in the NetX DNS cache, and returned at once
+  *          on the next calls. Once the time to live has passed the address
+  *          is still returned, stale, while the resolver thread asks the
+  *          servers again, so a reconnection never waits on DNS. A failed
+  *          refresh keeps the stale address and is retried after
+  *          DNS_RESOLVER_RETRY_INTERVAL.
+  *          The DNS servers of each DHCP ACK are probed by the resolver
+  *          thread with a query of their own, and the DNS client asks them
+  *          fastest first, before USER_DNS_ADDRESS and its secondary.
+  *          With IPv6, dns_resolver_host6_get() never waits: the resolver
+  *          thread looks up the AAAA record, and the last IPv6 address is
+  *          returned once known, refreshed the same way.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DNS_RESOLVER_H__
+#define __DNS_RESOLVER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT dns_resolver_start(NX_DNS *dns_ptr);
+UINT dns_resolver_host_get(const CHAR *host_name, ULONG *host_address_ptr, ULONG wait_option);
+VOID dns_resolver_servers_set(const ULONG *server_addresses, UINT server_count);
+#ifdef FEATURE_NX_IPV6
+UINT dns_resolver_host6_get(const CHAR *host_name, ULONG *host_address_ptr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __DNS_RESOLVER_H__ */
@@ -0,0 +1,126 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    ecdhe_precompute.c
+  * @author  MCD Application Team
+  * @brief   Ephemeral ECDHE key pairs generated ahead of the TLS handshakes
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ecdhe_precompute.h"
+
+#if defined(NX_SECURE_ENABLE_ECC_CIPHERSUITE) && defined(NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS)
+#include "nx_secure_tls_api.h"
+#include "nx_crypto_ecdh.h"
+
+#if (NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS < (ECDHE_PRECOMPUTE_CURVES * ECDHE_PRECOMPUTE_KEYS))
+#error "NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS holds fewer key pairs than ECDHE_PRECOMPUTE_CURVES * ECDHE_PRECOMPUTE_KEYS"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define ECDHE_PRECOMPUTE_EVENT_TAKEN  0x01U
+
+/* Private variables ---------------------------------------------------------*/
+extern NX_CRYPTO_METHOD crypto_method_ecdhe;
+extern const NX_CRYPTO_METHOD *nx_crypto_ecc_curves[];
+extern const UINT nx_crypto_ecc_supported_groups_size;
+
+static TX_THREAD ecdhe_precompute_thread;
+static ULONG ecdhe_precompute_thread_stack[ECDHE_PRECOMPUTE_STACK_SIZE / sizeof(ULONG)];
+
+/* Set by the handshakes as they take a key pair. */
+static TX_EVENT_FLAGS_GROUP ecdhe_precompute_events;
+
+/* Metadata of the ECDHE method, the TLS sessions have their own. */
+static ULONG ecdhe_precompute_metadata[(sizeof(NX_CRYPTO_ECDH) + sizeof(ULONG) - 1) / sizeof(ULONG)];
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID ecdhe_precompute_thread_entry(ULONG thread_input);
+static VOID ecdhe_precompute_taken(const NX_CRYPTO_METHOD *curve_method);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Create the thread generating the key pairs, it fills the table first
+  * @param  None
+  * @retval TX_SUCCESS or the error of the object creation
+  */
+UINT ecdhe_precompute_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_event_flags_create(&ecdhe_precompute_events, "ECDHE precompute events");
+  if (ret != TX_SUCCESS)
+  {
+    return(ret);
+  }
+
+  nx_secure_tls_ecdhe_precompute_notify_set(ecdhe_precompute_taken);
+
+  return(tx_thread_create(&ecdhe_precompute_thread, "ECDHE precompute thread", ecdhe_precompute_thread_entry, 0,
+                          ecdhe_precompute_thread_stack, sizeof(ecdhe_precompute_thread_stack),
+                          ECDHE_PRECOMPUTE_PRIORITY, ECDHE_PRECOMPUTE_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Generate the key pairs missing on each curve, then wait for one to be taken
+  * @param  thread_input: not used
+  * @retval None
+  */
+static VOID ecdhe_precompute_thread_entry(ULONG thread_input)
+{
+  UINT curve;
+  UINT curves = ECDHE_PRECOMPUTE_CURVES;
+  UINT ret;
+  ULONG events;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  if (curves > nx_crypto_ecc_supported_groups_size)
+  {
+    curves = nx_crypto_ecc_supported_groups_size;
+  }
+
+  for (;;)
+  {
+    for (curve = 0; curve < curves; curve++)
+    {
+      ret = nx_secure_tls_ecdhe_precompute(&crypto_method_ecdhe, nx_crypto_ecc_curves[curve], ECDHE_PRECOMPUTE_KEYS,
+                                           ecdhe_precompute_metadata, sizeof(ecdhe_precompute_metadata));
+      if (ret != NX_SUCCESS)
+      {
+        LOG_PRINTF("ECDHE precompute of curve %u failed: 0x%x\n", curve, ret);
+      }
+    }
+
+    tx_event_flags_get(&ecdhe_precompute_events, ECDHE_PRECOMPUTE_EVENT_TAKEN, TX_OR_CLEAR, &events, TX_WAIT_FOREVER);
+  }
+}
+
+/**
+  * @brief  Wake the thread once a handshake took a key pair, called from the thread of the handshake
+  * @param  curve_method: curve of the key pair taken
+  * @retval None
+  */
+static VOID ecdhe_precompute_taken(const NX_CRYPTO_METHOD *curve_method)
+{
+  NX_PARAMETER_NOT_USED(curve_method);
+
+  tx_event_flags_set(&ecdhe_precompute_events, ECDHE_PRECOMPUTE_EVENT_TAKEN, TX_OR);
+}
+
+#endif /* NX_SECURE_ENABLE_ECC_CIPHERSUITE && NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS */
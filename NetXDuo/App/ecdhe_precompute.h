@@ -0,0 +1,48 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    ecdhe_precompute.h
+  * @author  MCD Application Team
+  * @brief   Ephemeral ECDHE key pairs generated ahead of the TLS handshakes
+  *
+  *          A thread below the work queue keeps ECDHE_PRECOMPUTE_KEYS key
+  *          pairs ready on each of the first ECDHE_PRECOMPUTE_CURVES curves
+  *          offered by the client, with nx_secure_tls_ecdhe_precompute().
+  *          The key exchange of a handshake takes a ready key pair instead
+  *          of running the scalar multiplication of its own, and the thread
+  *          generates the next one once the system is idle again. A key
+  *          pair is taken once and cleared. With none ready, the handshake
+  *          generates its key pair as before. Requires
+  *          NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS in nx_user.h, of at least
+  *          ECDHE_PRECOMPUTE_CURVES * ECDHE_PRECOMPUTE_KEYS.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ECDHE_PRECOMPUTE_H__
+#define __ECDHE_PRECOMPUTE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT ecdhe_precompute_start(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __ECDHE_PRECOMPUTE_H__ */
@@ -0,0 +1,561 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    flash_service.c
+  * @author  MCD Application Team
+  * @brief   Erase and program requests of the internal flash, run by one thread
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_service.h"
+#include "thread_profile.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define FLASH_SERVICE_BANK_SIZE       0x00100000U
+#define FLASH_SERVICE_ERASED          0xFFFFFFFFU
+
+/* Program unit of the voltage range, the values of FLASH_TYPEPROGRAM_BYTE to
+   FLASH_TYPEPROGRAM_DOUBLEWORD are the log2 of their width in bytes */
+#if (FLASH_SERVICE_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_4)
+#define FLASH_SERVICE_PROGRAM_TYPE    FLASH_TYPEPROGRAM_DOUBLEWORD
+#elif (FLASH_SERVICE_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_3)
+#define FLASH_SERVICE_PROGRAM_TYPE    FLASH_TYPEPROGRAM_WORD
+#elif (FLASH_SERVICE_VOLTAGE_RANGE == FLASH_VOLTAGE_RANGE_2)
+#define FLASH_SERVICE_PROGRAM_TYPE    FLASH_TYPEPROGRAM_HALFWORD
+#else
+#define FLASH_SERVICE_PROGRAM_TYPE    FLASH_TYPEPROGRAM_BYTE
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD flash_service_thread;
+static ULONG flash_service_thread_stack[FLASH_SERVICE_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+static TX_QUEUE flash_service_queue;
+static ULONG flash_service_queue_storage[FLASH_SERVICE_QUEUE];
+
+/* Put by the flash interrupt at the end of an erase, with the error seen. */
+static TX_SEMAPHORE flash_service_done;
+static volatile UINT flash_service_error;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID flash_service_thread_entry(ULONG thread_input);
+static UINT flash_service_request_queue(FLASH_SERVICE_REQUEST *request_ptr);
+static UINT flash_service_request_wait(FLASH_SERVICE_REQUEST *request_ptr);
+static VOID flash_service_wake(FLASH_SERVICE_REQUEST *request_ptr);
+static UINT flash_service_range_valid(ULONG address, ULONG length);
+static UINT flash_service_sector_get(ULONG address, uint32_t *bank_ptr, uint32_t *sector_ptr,
+                                     ULONG *start_ptr, ULONG *size_ptr);
+static UINT flash_service_sector_erase(ULONG address);
+static UINT flash_service_bytes_program(ULONG address, const UCHAR *data_ptr, ULONG length);
+static VOID flash_service_cache_flush(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Create the queue and the thread of the service, and enable the flash interrupt
+  * @param  None
+  * @retval TX_SUCCESS or the error of the object creation
+  */
+UINT flash_service_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_semaphore_create(&flash_service_done, "Flash service done", 0);
+  if (ret != TX_SUCCESS)
+  {
+    return(ret);
+  }
+
+  ret = tx_queue_create(&flash_service_queue, "Flash service queue", TX_1_ULONG,
+                        flash_service_queue_storage, sizeof(flash_service_queue_storage));
+  if (ret != TX_SUCCESS)
+  {
+    return(ret);
+  }
+
+  HAL_NVIC_SetPriority(FLASH_IRQn, 11, 0);
+  HAL_NVIC_EnableIRQ(FLASH_IRQn);
+
+  return(tx_thread_create(&flash_service_thread, "Flash service thread", flash_service_thread_entry, 0,
+                          flash_service_thread_stack, sizeof(flash_service_thread_stack),
+                          FLASH_SERVICE_PRIORITY, FLASH_SERVICE_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START));
+}
+
+/**
+  * @brief  Queue the erase of a sector
+  * @param  request_ptr: request, kept by the caller until its callback
+  * @param  address: address in the sector, as mapped now
+  * @param  callback: called from the thread of the service once the sector is erased or failed, or NX_NULL
+  * @param  context: for the callback
+  * @retval FLASH_SERVICE_SUCCESS once queued, the status of the erase is then in the request,
+  *         FLASH_SERVICE_INVALID or FLASH_SERVICE_ERROR
+  */
+UINT flash_service_erase(FLASH_SERVICE_REQUEST *request_ptr, ULONG address,
+                         VOID (*callback)(FLASH_SERVICE_REQUEST *), VOID *context)
+{
+  if (!flash_service_range_valid(address, 1))
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  request_ptr -> operation = FLASH_SERVICE_ERASE;
+  request_ptr -> address = address;
+  request_ptr -> data_ptr = NX_NULL;
+  request_ptr -> length = 0;
+  request_ptr -> callback = callback;
+  request_ptr -> context = context;
+
+  return(flash_service_request_queue(request_ptr));
+}
+
+/**
+  * @brief  Queue the programming of bytes, their sectors erased
+  * @param  request_ptr: request, kept by the caller until its callback
+  * @param  address: address of the first byte, as mapped now
+  * @param  data_ptr: bytes to program, any alignment, kept by the caller until the callback
+  * @param  length: number of bytes
+  * @param  callback: called from the thread of the service once the bytes are programmed or failed, or NX_NULL
+  * @param  context: for the callback
+  * @retval FLASH_SERVICE_SUCCESS once queued, the status of the programming is then in the request,
+  *         FLASH_SERVICE_INVALID or FLASH_SERVICE_ERROR
+  */
+UINT flash_service_program(FLASH_SERVICE_REQUEST *request_ptr, ULONG address, const VOID *data_ptr, ULONG length,
+                           VOID (*callback)(FLASH_SERVICE_REQUEST *), VOID *context)
+{
+  if ((length == 0) || !flash_service_range_valid(address, length))
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  request_ptr -> operation = FLASH_SERVICE_PROGRAM;
+  request_ptr -> address = address;
+  request_ptr -> data_ptr = (const UCHAR *)data_ptr;
+  request_ptr -> length = length;
+  request_ptr -> callback = callback;
+  request_ptr -> context = context;
+
+  return(flash_service_request_queue(request_ptr));
+}
+
+/**
+  * @brief  Erase a sector, the calling thread suspended until the requests queued before and the erase are done
+  * @param  address: address in the sector, as mapped now
+  * @retval FLASH_SERVICE_SUCCESS, FLASH_SERVICE_INVALID or FLASH_SERVICE_ERROR
+  */
+UINT flash_service_erase_wait(ULONG address)
+{
+  FLASH_SERVICE_REQUEST request;
+
+  if (!flash_service_range_valid(address, 1))
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  request.operation = FLASH_SERVICE_ERASE;
+  request.address = address;
+  request.data_ptr = NX_NULL;
+  request.length = 0;
+
+  return(flash_service_request_wait(&request));
+}
+
+/**
+  * @brief  Program bytes, the calling thread suspended until the requests queued before and the programming are done
+  * @param  address: address of the first byte, as mapped now
+  * @param  data_ptr: bytes to program, any alignment
+  * @param  length: number of bytes
+  * @retval FLASH_SERVICE_SUCCESS, FLASH_SERVICE_INVALID or FLASH_SERVICE_ERROR
+  */
+UINT flash_service_program_wait(ULONG address, const VOID *data_ptr, ULONG length)
+{
+  FLASH_SERVICE_REQUEST request;
+
+  if ((length == 0) || !flash_service_range_valid(address, length))
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  request.operation = FLASH_SERVICE_PROGRAM;
+  request.address = address;
+  request.data_ptr = (const UCHAR *)data_ptr;
+  request.length = length;
+
+  return(flash_service_request_wait(&request));
+}
+
+/**
+  * @brief  Wait for the requests queued so far, e.g. before a reset
+  * @param  None
+  * @retval FLASH_SERVICE_SUCCESS, or FLASH_SERVICE_ERROR when the service is not started
+  */
+UINT flash_service_drain(VOID)
+{
+  FLASH_SERVICE_REQUEST request;
+
+  request.operation = FLASH_SERVICE_DRAIN;
+  request.address = 0;
+  request.data_ptr = NX_NULL;
+  request.length = 0;
+
+  return(flash_service_request_wait(&request));
+}
+
+/**
+  * @brief  End of the sector an address is in
+  * @param  address: address in the flash, as mapped now
+  * @retval Address following the sector, 0 out of the flash
+  */
+ULONG flash_service_sector_end(ULONG address)
+{
+  uint32_t bank;
+  uint32_t sector;
+  ULONG start;
+  ULONG size;
+
+  if (flash_service_sector_get(address, &bank, &sector, &start, &size) != FLASH_SERVICE_SUCCESS)
+  {
+    return(0);
+  }
+
+  return(start + size);
+}
+
+/**
+  * @brief  End of the flash operation callback, from the flash interrupt
+  * @param  ReturnValue: erased sector, 0xFFFFFFFF once the last one is erased
+  * @retval None
+  */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+  NX_PARAMETER_NOT_USED(ReturnValue);
+
+  /* One sector per erase. An error may be followed by an end of operation, the ceiling keeps one wake up. */
+  tx_semaphore_ceiling_put(&flash_service_done, 1);
+}
+
+/**
+  * @brief  Flash operation error callback, from the flash interrupt
+  * @param  ReturnValue: sector of the failed erase
+  * @retval None
+  */
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+  NX_PARAMETER_NOT_USED(ReturnValue);
+
+  flash_service_error = 1U;
+  tx_semaphore_ceiling_put(&flash_service_done, 1);
+}
+
+/**
+  * @brief  This function handles the flash global interrupt, the erases of the service.
+  * @param  None
+  * @retval None
+  */
+void FLASH_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+  HAL_FLASH_IRQHandler();
+  THREAD_PROFILE_ISR_EXIT();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Thread of the service, run the requests in the order they are queued
+  * @param  thread_input: not used
+  * @retval None
+  */
+static VOID flash_service_thread_entry(ULONG thread_input)
+{
+  FLASH_SERVICE_REQUEST *request_ptr;
+  UINT status;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  for (;;)
+  {
+    if (tx_queue_receive(&flash_service_queue, &request_ptr, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      continue;
+    }
+
+    if (request_ptr -> operation == FLASH_SERVICE_ERASE)
+    {
+      status = flash_service_sector_erase(request_ptr -> address);
+    }
+    else if (request_ptr -> operation == FLASH_SERVICE_PROGRAM)
+    {
+      status = flash_service_bytes_program(request_ptr -> address, request_ptr -> data_ptr, request_ptr -> length);
+    }
+    else
+    {
+      status = FLASH_SERVICE_SUCCESS;
+    }
+
+    /* The request is the caller's again from its callback on, it is not touched after it.  */
+    request_ptr -> status = status;
+    if (request_ptr -> callback != NX_NULL)
+    {
+      request_ptr -> callback(request_ptr);
+    }
+  }
+}
+
+/**
+  * @brief  Queue a request filled in, behind those of the other users
+  * @param  request_ptr: request
+  * @retval FLASH_SERVICE_SUCCESS, or FLASH_SERVICE_ERROR when the service is not started
+  */
+static UINT flash_service_request_queue(FLASH_SERVICE_REQUEST *request_ptr)
+{
+  request_ptr -> status = FLASH_SERVICE_PENDING;
+
+  if (tx_queue_send(&flash_service_queue, &request_ptr, TX_WAIT_FOREVER) != TX_SUCCESS)
+  {
+    request_ptr -> status = FLASH_SERVICE_ERROR;
+    return(FLASH_SERVICE_ERROR);
+  }
+
+  return(FLASH_SERVICE_SUCCESS);
+}
+
+/**
+  * @brief  Queue a request filled in and suspend the calling thread until its callback
+  * @param  request_ptr: request, on the stack of the caller
+  * @retval Status of the request
+  */
+static UINT flash_service_request_wait(FLASH_SERVICE_REQUEST *request_ptr)
+{
+  TX_SEMAPHORE done;
+  UINT ret;
+
+  if (tx_semaphore_create(&done, "Flash service wait", 0) != TX_SUCCESS)
+  {
+    return(FLASH_SERVICE_ERROR);
+  }
+
+  request_ptr -> callback = flash_service_wake;
+  request_ptr -> context = &done;
+
+  ret = flash_service_request_queue(request_ptr);
+  if (ret == FLASH_SERVICE_SUCCESS)
+  {
+    tx_semaphore_get(&done, TX_WAIT_FOREVER);
+    ret = request_ptr -> status;
+  }
+
+  tx_semaphore_delete(&done);
+
+  return(ret);
+}
+
+/**
+  * @brief  Callback of the requests waited for, wake the thread waiting
+  * @param  request_ptr: request done
+  * @retval None
+  */
+static VOID flash_service_wake(FLASH_SERVICE_REQUEST *request_ptr)
+{
+  tx_semaphore_put((TX_SEMAPHORE *)request_ptr -> context);
+}
+
+/**
+  * @brief  Check a range is in the flash of the two banks
+  * @param  address: first byte, as mapped now
+  * @param  length: number of bytes, not 0
+  * @retval 1 when the range is in the flash, 0 otherwise
+  */
+static UINT flash_service_range_valid(ULONG address, ULONG length)
+{
+  return((address >= FLASH_BASE) && (address - FLASH_BASE < 2U * FLASH_SERVICE_BANK_SIZE) &&
+         (length <= 2U * FLASH_SERVICE_BANK_SIZE - (address - FLASH_BASE)));
+}
+
+/**
+  * @brief  Sector an address is in
+  * @param  address: address in the flash, as mapped now
+  * @param  bank_ptr: set to FLASH_BANK_1 or FLASH_BANK_2, the physical bank
+  * @param  sector_ptr: set to the physical sector, FLASH_SECTOR_0 to FLASH_SECTOR_23
+  * @param  start_ptr: set to the address of the sector, as mapped now
+  * @param  size_ptr: set to the size of the sector
+  * @retval FLASH_SERVICE_SUCCESS or FLASH_SERVICE_INVALID
+  */
+static UINT flash_service_sector_get(ULONG address, uint32_t *bank_ptr, uint32_t *sector_ptr,
+                                     ULONG *start_ptr, ULONG *size_ptr)
+{
+  ULONG offset;
+  ULONG sector;
+  ULONG sector_start;
+  ULONG sector_size;
+  UINT second;
+
+  if (!flash_service_range_valid(address, 1))
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  /* Bank 2 is mapped at FLASH_BASE when booted from it.  */
+  offset = (address - FLASH_BASE) % FLASH_SERVICE_BANK_SIZE;
+  second = ((address - FLASH_BASE) >= FLASH_SERVICE_BANK_SIZE) !=
+           (READ_BIT(SYSCFG -> MEMRMP, SYSCFG_MEMRMP_UFB_MODE) != 0U);
+
+  /* Four 16 KB sectors, one of 64 KB, then 128 KB ones in each bank.  */
+  if (offset < 0x10000U)
+  {
+    sector = offset / 0x4000U;
+    sector_start = sector * 0x4000U;
+    sector_size = 0x4000U;
+  }
+  else if (offset < 0x20000U)
+  {
+    sector = 4U;
+    sector_start = 0x10000U;
+    sector_size = 0x10000U;
+  }
+  else
+  {
+    sector = 4U + offset / 0x20000U;
+    sector_start = (sector - 4U) * 0x20000U;
+    sector_size = 0x20000U;
+  }
+
+  *bank_ptr = second ? FLASH_BANK_2 : FLASH_BANK_1;
+  *sector_ptr = (second ? FLASH_SECTOR_12 : FLASH_SECTOR_0) + sector;
+  *start_ptr = address - offset + sector_start;
+  *size_ptr = sector_size;
+
+  return(FLASH_SERVICE_SUCCESS);
+}
+
+/**
+  * @brief  Erase a sector under the flash interrupt, unless it is blank already
+  * @param  address: address in the sector, as mapped now
+  * @retval FLASH_SERVICE_SUCCESS, FLASH_SERVICE_INVALID or FLASH_SERVICE_ERROR
+  */
+static UINT flash_service_sector_erase(ULONG address)
+{
+  FLASH_EraseInitTypeDef erase;
+  ULONG start;
+  ULONG size;
+  ULONG *word;
+  ULONG *sector_end;
+  UINT ret = FLASH_SERVICE_SUCCESS;
+
+  if (flash_service_sector_get(address, &erase.Banks, &erase.Sector, &start, &size) != FLASH_SERVICE_SUCCESS)
+  {
+    return(FLASH_SERVICE_INVALID);
+  }
+
+  word = (ULONG *)start;
+  sector_end = (ULONG *)(start + size);
+  while ((word < sector_end) && (*word == FLASH_SERVICE_ERASED))
+  {
+    word++;
+  }
+
+  if (word == sector_end)
+  {
+    return(FLASH_SERVICE_SUCCESS);
+  }
+
+  erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+  erase.NbSectors = 1;
+  erase.VoltageRange = FLASH_SERVICE_VOLTAGE_RANGE;
+
+  /* The end of an erase that timed out is not taken for this one.  */
+  tx_semaphore_get(&flash_service_done, TX_NO_WAIT);
+  flash_service_error = 0U;
+
+  HAL_FLASH_Unlock();
+
+  if ((HAL_FLASHEx_Erase_IT(&erase) != HAL_OK) ||
+      (tx_semaphore_get(&flash_service_done, FLASH_SERVICE_ERASE_TIMEOUT) != TX_SUCCESS) ||
+      flash_service_error)
+  {
+    ret = FLASH_SERVICE_ERROR;
+  }
+
+  HAL_FLASH_Lock();
+
+  return(ret);
+}
+
+/**
+  * @brief  Program bytes by the widest unit the voltage range and their alignment allow
+  * @param  address: address of the first byte, as mapped now
+  * @param  data_ptr: bytes to program, any alignment
+  * @param  length: number of bytes
+  * @retval FLASH_SERVICE_SUCCESS or FLASH_SERVICE_ERROR
+  */
+static UINT flash_service_bytes_program(ULONG address, const UCHAR *data_ptr, ULONG length)
+{
+  ULONG64 unit;
+  ULONG64 erased;
+  ULONG width;
+  UINT type;
+  UINT ret = FLASH_SERVICE_SUCCESS;
+
+  HAL_FLASH_Unlock();
+
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                         FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+
+  while ((length != 0) && (ret == FLASH_SERVICE_SUCCESS))
+  {
+    /* Narrower units at an unaligned start and at the end only.  */
+    type = FLASH_SERVICE_PROGRAM_TYPE;
+    width = 1U << type;
+    while (((address & (width - 1U)) != 0U) || (length < width))
+    {
+      type--;
+      width >>= 1;
+    }
+
+    unit = 0;
+    memcpy(&unit, data_ptr, width);
+    erased = (width == sizeof(ULONG64)) ? ~(ULONG64)0 : (((ULONG64)1 << (8U * width)) - 1U);
+
+    /* Erased units are left as they are.  */
+    if ((unit != erased) && (HAL_FLASH_Program(type, address, unit) != HAL_OK))
+    {
+      ret = FLASH_SERVICE_ERROR;
+    }
+
+    address += width;
+    data_ptr += width;
+    length -= width;
+  }
+
+  HAL_FLASH_Lock();
+  flash_service_cache_flush();
+
+  return(ret);
+}
+
+/**
+  * @brief  Drop the flash data cache lines made stale by programming
+  * @param  None
+  * @retval None
+  */
+static VOID flash_service_cache_flush(VOID)
+{
+  if (READ_BIT(FLASH->ACR, FLASH_ACR_DCEN) != 0U)
+  {
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+  }
+}
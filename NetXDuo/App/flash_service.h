@@ -0,0 +1,94 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    flash_service.h
+  * @author  MCD Application Team
+  * @brief   Erase and program requests of the internal flash, run by one thread
+  *
+  *          The users of the flash queue their requests to the thread of the
+  *          service instead of driving the flash controller themselves. The
+  *          requests run in the order they are queued, so that a sector erase
+  *          queued ahead of need is done before the programming behind it,
+  *          and the programming of a record before that of its header. A
+  *          request ends with its callback, from the thread of the service;
+  *          flash_service_erase_wait() and flash_service_program_wait()
+  *          suspend the calling thread until then, instead of spinning on
+  *          the busy flag. Only one thread drives the controller, the flash
+  *          needs no lock between its users.
+  *
+  *          A sector erase runs under the flash interrupt while the thread of
+  *          the service waits for it, and is skipped on a blank sector. The
+  *          programming goes by the widest unit FLASH_SERVICE_VOLTAGE_RANGE
+  *          allows, narrower units only at an unaligned start or end, and
+  *          leaves the erased units as they are. The two banks are read while
+  *          the other one is written, code running from the bank not written
+  *          does not stall; a read of the bank written waits for the end of
+  *          the operation, so a bank is not read while an erase of it may be
+  *          in progress.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_SERVICE_H__
+#define __FLASH_SERVICE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Operations */
+#define FLASH_SERVICE_ERASE           0
+#define FLASH_SERVICE_PROGRAM         1
+#define FLASH_SERVICE_DRAIN           2   /* Nothing, done once those queued before are */
+
+/* Status values */
+#define FLASH_SERVICE_SUCCESS         0
+#define FLASH_SERVICE_ERROR           1   /* Flash program or erase failure     */
+#define FLASH_SERVICE_INVALID         2   /* Range out of the flash             */
+#define FLASH_SERVICE_PENDING         3   /* Request queued or in progress      */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct FLASH_SERVICE_REQUEST_STRUCT
+{
+  UINT         operation;          /* FLASH_SERVICE_ERASE, FLASH_SERVICE_PROGRAM or FLASH_SERVICE_DRAIN */
+  ULONG        address;            /* Address as mapped now, in the sector to erase or the first byte to program */
+  const UCHAR *data_ptr;           /* Bytes to program, kept by the caller until the callback */
+  ULONG        length;
+  VOID       (*callback)(struct FLASH_SERVICE_REQUEST_STRUCT *request_ptr); /* NX_NULL when none */
+  VOID        *context;            /* For the callback */
+
+  /* Set by the service */
+  UINT         status;             /* FLASH_SERVICE_PENDING until the callback */
+} FLASH_SERVICE_REQUEST;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Requests are queued from threads only, the request stays with the service until its callback. */
+UINT  flash_service_start(VOID);
+UINT  flash_service_erase(FLASH_SERVICE_REQUEST *request_ptr, ULONG address,
+                          VOID (*callback)(FLASH_SERVICE_REQUEST *), VOID *context);
+UINT  flash_service_program(FLASH_SERVICE_REQUEST *request_ptr, ULONG address, const VOID *data_ptr, ULONG length,
+                            VOID (*callback)(FLASH_SERVICE_REQUEST *), VOID *context);
+UINT  flash_service_erase_wait(ULONG address);
+UINT  flash_service_program_wait(ULONG address, const VOID *data_ptr, ULONG length);
+UINT  flash_service_drain(VOID);
+ULONG flash_service_sector_end(ULONG address);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __FLASH_SERVICE_H__ */
@@ -0,0 +1,1468 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    local_broker.c
+  * @author  MCD Application Team
+  * @brief   MQTT broker of the site, served by the gateway
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "local_broker.h"
+#include <string.h>
+
+#ifdef LOCAL_BROKER
+
+#if (LOCAL_BROKER_CLIENTS > 32)
+#error "LOCAL_BROKER_CLIENTS is the number of bits of a subscriber mask at most."
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define LOCAL_BROKER_SOCKET_EVENT     1U
+
+/* Period the keep alive of the connections is checked at, without socket events */
+#define LOCAL_BROKER_CHECK_INTERVAL   NX_IP_PERIODIC_RATE
+
+/* MQTT 3.1.1, whatever the protocol of the client of the remote broker */
+#define LOCAL_BROKER_PROTOCOL_LEVEL   4U
+
+/* Longest client identifier a server must accept, a longer one is rejected */
+#define LOCAL_BROKER_CLIENT_ID_SIZE   23U
+
+/* Bytes of a fixed header at most: the type and four bytes of remaining length */
+#define LOCAL_BROKER_HEADER_SIZE      5U
+
+/* State of a connection */
+#define LOCAL_BROKER_IDLE             0U   /* Socket not listening */
+#define LOCAL_BROKER_LISTEN           1U   /* Socket listening on the port, or in its handshake */
+#define LOCAL_BROKER_OPEN             2U   /* TCP connection established, waiting for the CONNECT */
+#define LOCAL_BROKER_CONNECTED        3U   /* CONNECT accepted */
+
+/* No socket listening on the port */
+#define LOCAL_BROKER_NO_LISTENER      LOCAL_BROKER_CLIENTS
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct LOCAL_BROKER_CLIENT_STRUCT
+{
+  NX_TCP_SOCKET socket;
+  UINT          state;
+
+  /* Data queued on the socket, waiting for the window of the client to open. Cleared by the IP thread. */
+  UINT          send_pending;
+
+  /* Tick of the last MQTT packet received, or of the connection, and the ticks allowed after it. 0 for ever. */
+  ULONG         last_time;
+  ULONG         keepalive;
+
+  USHORT        packet_id;
+  UCHAR         client_id_length;
+  UCHAR         client_id[LOCAL_BROKER_CLIENT_ID_SIZE];
+
+  /* The MQTT packet being received, and the first bytes of the next ones. */
+  UINT          rx_length;
+  UCHAR         rx_buffer[LOCAL_BROKER_PACKET_SIZE];
+} LOCAL_BROKER_CLIENT;
+
+/* A level of the topic filters subscribed, the filters that share their first levels share their nodes */
+typedef struct LOCAL_BROKER_NODE_STRUCT
+{
+  struct LOCAL_BROKER_NODE_STRUCT *child;
+  struct LOCAL_BROKER_NODE_STRUCT *sibling;
+
+  /* Clients whose filter ends at this level, by the bit of their index, and the ones of them granted QoS 1. */
+  ULONG         subscribers;
+  ULONG         qos1_subscribers;
+
+  UCHAR         in_use;
+  UCHAR         level_length;
+  UCHAR         level[LOCAL_BROKER_LEVEL_SIZE];
+} LOCAL_BROKER_NODE;
+
+/* Private variables ---------------------------------------------------------*/
+static NX_IP *local_broker_ip_ptr;
+static NX_PACKET_POOL *local_broker_pool_ptr;
+
+static LOCAL_BROKER_CLIENT local_broker_clients[LOCAL_BROKER_CLIENTS] CCMRAM_BSS;
+static UINT local_broker_listener;
+
+/* The first levels of the filters, the nodes of the next levels linked from them. */
+static LOCAL_BROKER_NODE local_broker_nodes[LOCAL_BROKER_TOPIC_NODES] CCMRAM_BSS;
+static LOCAL_BROKER_NODE *local_broker_root;
+
+#ifdef LOCAL_BROKER_BRIDGE
+static NXD_MQTT_CLIENT *local_broker_bridge_ptr;
+#endif
+
+/* Held by the thread while it serves the connections, and by local_broker_publish(). */
+static TX_MUTEX local_broker_mutex;
+static TX_EVENT_FLAGS_GROUP local_broker_events;
+
+static TX_THREAD local_broker_thread;
+static ULONG local_broker_thread_stack[LOCAL_BROKER_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID local_broker_thread_entry(ULONG thread_input);
+static VOID local_broker_socket_notify(NX_TCP_SOCKET *socket_ptr);
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+static VOID local_broker_send_notify(NX_TCP_SOCKET *socket_ptr);
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+static VOID local_broker_listen_notify(NX_TCP_SOCKET *socket_ptr, UINT port);
+static VOID local_broker_listen_check(VOID);
+static VOID local_broker_client_poll(UINT index);
+static VOID local_broker_client_close(UINT index);
+static UINT local_broker_stream_process(UINT index, NX_PACKET *packet_ptr);
+static UINT local_broker_packet_process(UINT index, UCHAR type, UCHAR *data, UINT length);
+static UINT local_broker_connect_process(UINT index, UCHAR *data, UINT length);
+static UINT local_broker_subscribe_process(UINT index, UCHAR *data, UINT length);
+static UINT local_broker_unsubscribe_process(UINT index, UCHAR *data, UINT length);
+static UINT local_broker_publish_process(UINT index, UCHAR type, UCHAR *data, UINT length);
+static VOID local_broker_fanout(const UCHAR *topic, UINT topic_length, const UCHAR *message, UINT message_length,
+                                UINT qos);
+static NX_PACKET *local_broker_publish_build(const UCHAR *topic, UINT topic_length, const UCHAR *message,
+                                             UINT message_length, UINT qos);
+static VOID local_broker_packet_id_set(NX_PACKET *packet_ptr, ULONG offset, USHORT packet_id);
+static UINT local_broker_send(UINT index, const UCHAR *data, UINT length);
+static UINT local_broker_socket_send(LOCAL_BROKER_CLIENT *client_ptr, NX_PACKET *packet_ptr);
+static UINT local_broker_length_encode(UCHAR *buffer, UINT length);
+static UINT local_broker_string_get(UCHAR *data, UINT length, UINT *offset, UCHAR **string_ptr, UINT *string_length);
+static UINT local_broker_filter_check(const UCHAR *filter, UINT filter_length);
+static UINT local_broker_subscribe(const UCHAR *filter, UINT filter_length, UINT qos, UINT index);
+static VOID local_broker_unsubscribe(const UCHAR *filter, UINT filter_length, UINT index);
+static VOID local_broker_match(LOCAL_BROKER_NODE *node_ptr, const UCHAR *topic, UINT topic_length, UINT first,
+                               ULONG *subscribers, ULONG *qos1_subscribers);
+static VOID local_broker_prune(LOCAL_BROKER_NODE **list_ptr);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Create the sockets of the clients, listen on the port with the first one and start the
+*         thread that serves them.
+* @param  ip_ptr: IP instance
+* @param  pool_ptr: pool of the packets sent to the clients
+* @retval NX_SUCCESS or the error of the failed call
+*/
+UINT local_broker_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  UINT ret;
+  UINT i;
+
+  local_broker_ip_ptr = ip_ptr;
+  local_broker_pool_ptr = pool_ptr;
+
+  ret = tx_mutex_create(&local_broker_mutex, "Local broker", TX_NO_INHERIT);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_event_flags_create(&local_broker_events, "Local broker");
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  for (i = 0; i < LOCAL_BROKER_CLIENTS; i++)
+  {
+    local_broker_clients[i].state = LOCAL_BROKER_IDLE;
+    local_broker_clients[i].rx_length = 0;
+    local_broker_clients[i].send_pending = NX_FALSE;
+
+    ret = nx_tcp_socket_create(ip_ptr, &local_broker_clients[i].socket, "Local broker", NX_IP_NORMAL,
+                               NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, LOCAL_BROKER_TCP_WINDOW, NX_NULL,
+                               local_broker_socket_notify);
+    if (ret == NX_SUCCESS)
+    {
+      ret = nx_tcp_socket_receive_notify(&local_broker_clients[i].socket, local_broker_socket_notify);
+    }
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+    /* A slow client does not hold the thread: what does not fit its window is queued on its socket. */
+    if (ret == NX_SUCCESS)
+    {
+      ret = nx_tcp_socket_send_notify_set(&local_broker_clients[i].socket, local_broker_send_notify);
+    }
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+
+    if (ret != NX_SUCCESS)
+    {
+      return ret;
+    }
+  }
+
+  /* The connection requests that come while every socket is taken wait in the queue of the port. */
+  ret = nx_tcp_server_socket_listen(ip_ptr, LOCAL_BROKER_PORT, &local_broker_clients[0].socket,
+                                    LOCAL_BROKER_LISTEN_QUEUE, local_broker_listen_notify);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* Not waiting, the connection is established by the IP thread and found by the poll. */
+  nx_tcp_server_socket_accept(&local_broker_clients[0].socket, NX_NO_WAIT);
+  local_broker_clients[0].state = LOCAL_BROKER_LISTEN;
+  local_broker_listener = 0;
+
+  return tx_thread_create(&local_broker_thread, "App Local Broker Thread", local_broker_thread_entry, 0,
+                          local_broker_thread_stack, sizeof(local_broker_thread_stack),
+                          LOCAL_BROKER_PRIORITY, LOCAL_BROKER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Send a message of the gateway to the clients subscribed to its topic, as a message
+*         received from a client would be. Not sent to the remote broker by the bridge.
+* @param  topic_name: topic of the message, without wildcard
+* @param  topic_name_length: length of the topic
+* @param  message: message to publish
+* @param  message_length: length of the message
+* @param  qos: QoS level of the message, 0 or 1
+* @retval NX_SUCCESS, or NX_INVALID_PARAMETERS for a topic with a wildcard or a QoS level above 1
+*/
+UINT local_broker_publish(const CHAR *topic_name, UINT topic_name_length, const UCHAR *message,
+                          UINT message_length, UINT qos)
+{
+  if ((topic_name_length == 0) || (topic_name_length > 0xFFFFU) || (qos > 1U) ||
+      memchr(topic_name, '+', topic_name_length) || memchr(topic_name, '#', topic_name_length))
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  tx_mutex_get(&local_broker_mutex, TX_WAIT_FOREVER);
+  local_broker_fanout((const UCHAR *)topic_name, topic_name_length, message, message_length, qos);
+  tx_mutex_put(&local_broker_mutex);
+
+  return NX_SUCCESS;
+}
+
+#ifdef LOCAL_BROKER_BRIDGE
+/**
+* @brief  Forward the messages of the clients to the remote broker through a client, with QoS
+*         level 0 and without waiting: a message the client cannot take is not forwarded.
+* @param  client_ptr: client connected to the remote broker, NX_NULL to stop forwarding
+* @retval NX_SUCCESS
+*/
+UINT local_broker_bridge_set(NXD_MQTT_CLIENT *client_ptr)
+{
+  tx_mutex_get(&local_broker_mutex, TX_WAIT_FOREVER);
+  local_broker_bridge_ptr = client_ptr;
+  tx_mutex_put(&local_broker_mutex);
+
+  return NX_SUCCESS;
+}
+#endif /* LOCAL_BROKER_BRIDGE */
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Thread of the broker: serve the connections whose sockets received data or changed state,
+*         and check the keep alive of the others at LOCAL_BROKER_CHECK_INTERVAL.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID local_broker_thread_entry(ULONG thread_input)
+{
+  ULONG flags;
+  UINT i;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  for (;;)
+  {
+    tx_event_flags_get(&local_broker_events, LOCAL_BROKER_SOCKET_EVENT, TX_OR_CLEAR, &flags,
+                       LOCAL_BROKER_CHECK_INTERVAL);
+
+    tx_mutex_get(&local_broker_mutex, TX_WAIT_FOREVER);
+
+    for (i = 0; i < LOCAL_BROKER_CLIENTS; i++)
+    {
+      local_broker_client_poll(i);
+    }
+
+    local_broker_listen_check();
+
+    tx_mutex_put(&local_broker_mutex);
+  }
+}
+
+/**
+* @brief  Data received, connection closed by the peer or connection request: wake the thread up.
+*         Called from the IP thread.
+* @param  socket_ptr: socket of the event
+* @retval None
+*/
+static VOID local_broker_socket_notify(NX_TCP_SOCKET *socket_ptr)
+{
+  NX_PARAMETER_NOT_USED(socket_ptr);
+  tx_event_flags_set(&local_broker_events, LOCAL_BROKER_SOCKET_EVENT, TX_OR);
+}
+
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+/**
+* @brief  The data queued on the socket of a client is sent. Called from the IP thread.
+* @param  socket_ptr: socket of the client, first member of its LOCAL_BROKER_CLIENT
+* @retval None
+*/
+static VOID local_broker_send_notify(NX_TCP_SOCKET *socket_ptr)
+{
+  ((LOCAL_BROKER_CLIENT *)socket_ptr) -> send_pending = NX_FALSE;
+}
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+
+/**
+* @brief  Connection request on the port: wake the thread up. Called from the IP thread.
+* @param  socket_ptr: socket listening
+* @param  port: port of the request
+* @retval None
+*/
+static VOID local_broker_listen_notify(NX_TCP_SOCKET *socket_ptr, UINT port)
+{
+  NX_PARAMETER_NOT_USED(port);
+  local_broker_socket_notify(socket_ptr);
+}
+
+/**
+* @brief  Once the socket listening got its connection, listen with an idle one, which takes the
+*         request queued meanwhile if any. Without an idle socket, the requests wait in the queue.
+* @param  None
+* @retval None
+*/
+static VOID local_broker_listen_check(VOID)
+{
+  UINT ret;
+  UINT i;
+
+  if (local_broker_listener != LOCAL_BROKER_NO_LISTENER)
+  {
+    return;
+  }
+
+  for (i = 0; i < LOCAL_BROKER_CLIENTS; i++)
+  {
+    if (local_broker_clients[i].state != LOCAL_BROKER_IDLE)
+    {
+      continue;
+    }
+
+    ret = nx_tcp_server_socket_relisten(local_broker_ip_ptr, LOCAL_BROKER_PORT, &local_broker_clients[i].socket);
+    if ((ret == NX_SUCCESS) || (ret == NX_CONNECTION_PENDING))
+    {
+      nx_tcp_server_socket_accept(&local_broker_clients[i].socket, NX_NO_WAIT);
+      local_broker_clients[i].state = LOCAL_BROKER_LISTEN;
+      local_broker_listener = i;
+    }
+    else
+    {
+      printf("Local broker: relisten failed: 0x%x\n", ret);
+    }
+    return;
+  }
+}
+
+/**
+* @brief  Serve a connection: follow its handshake, take the data received, and close it once closed
+*         by the peer or silent for longer than its keep alive.
+* @param  index: index of the client
+* @retval None
+*/
+static VOID local_broker_client_poll(UINT index)
+{
+  LOCAL_BROKER_CLIENT *client_ptr = &local_broker_clients[index];
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  if (client_ptr -> state == LOCAL_BROKER_IDLE)
+  {
+    return;
+  }
+
+  if (client_ptr -> state == LOCAL_BROKER_LISTEN)
+  {
+    if (client_ptr -> socket.nx_tcp_socket_state == NX_TCP_SYN_RECEIVED)
+    {
+      return;
+    }
+
+    /* A handshake reset by the peer puts the socket back in the listen state. */
+    if (client_ptr -> socket.nx_tcp_socket_state == NX_TCP_LISTEN_STATE)
+    {
+      nx_tcp_server_socket_accept(&client_ptr -> socket, NX_NO_WAIT);
+      return;
+    }
+
+    if (client_ptr -> socket.nx_tcp_socket_state < NX_TCP_ESTABLISHED)
+    {
+      local_broker_client_close(index);
+      return;
+    }
+
+    /* Established, the CONNECT is expected within LOCAL_BROKER_CONNECT_TIMEOUT. */
+    client_ptr -> state = LOCAL_BROKER_OPEN;
+    client_ptr -> last_time = tx_time_get();
+    client_ptr -> keepalive = LOCAL_BROKER_CONNECT_TIMEOUT;
+    client_ptr -> rx_length = 0;
+    local_broker_listener = LOCAL_BROKER_NO_LISTENER;
+  }
+
+  while (nx_tcp_socket_receive(&client_ptr -> socket, &packet_ptr, NX_NO_WAIT) == NX_SUCCESS)
+  {
+    ret = local_broker_stream_process(index, packet_ptr);
+    nx_packet_release(packet_ptr);
+
+    /* A protocol error, a DISCONNECT, or a client taken over by a new connection. */
+    if ((ret != NX_SUCCESS) || (client_ptr -> state == LOCAL_BROKER_IDLE))
+    {
+      local_broker_client_close(index);
+      return;
+    }
+  }
+
+  /* Closed by the peer, the data it sent first is served. */
+  if (client_ptr -> socket.nx_tcp_socket_state != NX_TCP_ESTABLISHED)
+  {
+    local_broker_client_close(index);
+    return;
+  }
+
+  /* The client is considered lost after 1.5 keep alive periods without a packet. */
+  if ((client_ptr -> keepalive != 0) && ((tx_time_get() - client_ptr -> last_time) > client_ptr -> keepalive))
+  {
+    local_broker_client_close(index);
+  }
+}
+
+/**
+* @brief  Forget the subscriptions of a client and abort its connection, its socket idle then.
+* @param  index: index of the client
+* @retval None
+*/
+static VOID local_broker_client_close(UINT index)
+{
+  LOCAL_BROKER_CLIENT *client_ptr = &local_broker_clients[index];
+  ULONG bit = 1UL << index;
+  UINT i;
+
+  if (client_ptr -> state == LOCAL_BROKER_IDLE)
+  {
+    return;
+  }
+
+  if (client_ptr -> state == LOCAL_BROKER_CONNECTED)
+  {
+    printf("Local broker: client %.*s disconnected\n", (int)client_ptr -> client_id_length,
+           (CHAR *)client_ptr -> client_id);
+
+    for (i = 0; i < LOCAL_BROKER_TOPIC_NODES; i++)
+    {
+      local_broker_nodes[i].subscribers &= ~bit;
+      local_broker_nodes[i].qos1_subscribers &= ~bit;
+    }
+    local_broker_prune(&local_broker_root);
+  }
+
+  /* No wait: a reset, the thread serves the other connections meanwhile. */
+  nx_tcp_socket_disconnect(&client_ptr -> socket, NX_NO_WAIT);
+  nx_tcp_server_socket_unaccept(&client_ptr -> socket);
+
+  if (local_broker_listener == index)
+  {
+    local_broker_listener = LOCAL_BROKER_NO_LISTENER;
+  }
+
+  client_ptr -> state = LOCAL_BROKER_IDLE;
+  client_ptr -> rx_length = 0;
+  client_ptr -> send_pending = NX_FALSE;
+}
+
+/**
+* @brief  Add the bytes of a TCP packet to the stream of a client, and process each MQTT packet it
+*         completes. The bytes of the next packet are kept for the next TCP packet.
+* @param  index: index of the client
+* @param  packet_ptr: packet received, released by the caller
+* @retval NX_SUCCESS, or an error to close the connection on
+*/
+static UINT local_broker_stream_process(UINT index, NX_PACKET *packet_ptr)
+{
+  LOCAL_BROKER_CLIENT *client_ptr = &local_broker_clients[index];
+  ULONG offset = 0;
+  ULONG copied;
+  UINT remaining_length;
+  UINT header_length;
+  UINT total;
+  UINT ret;
+
+  while (offset < packet_ptr -> nx_packet_length)
+  {
+    if (nx_packet_data_extract_offset(packet_ptr, offset, &client_ptr -> rx_buffer[client_ptr -> rx_length],
+                                      sizeof(client_ptr -> rx_buffer) - client_ptr -> rx_length,
+                                      &copied) != NX_SUCCESS)
+    {
+      return NX_INVALID_PACKET;
+    }
+    offset += copied;
+    client_ptr -> rx_length += copied;
+
+    while (client_ptr -> rx_length >= MQTT_FIXED_HEADER_SIZE)
+    {
+      /* The remaining length, 7 bits in each of up to 4 bytes. */
+      remaining_length = 0;
+      for (header_length = 1; header_length < LOCAL_BROKER_HEADER_SIZE; header_length++)
+      {
+        if (header_length >= client_ptr -> rx_length)
+        {
+          break;
+        }
+
+        remaining_length |= (UINT)(client_ptr -> rx_buffer[header_length] & 0x7FU) << (7U * (header_length - 1U));
+        if ((client_ptr -> rx_buffer[header_length] & 0x80U) == 0)
+        {
+          break;
+        }
+      }
+
+      if (header_length == LOCAL_BROKER_HEADER_SIZE)
+      {
+        return NX_INVALID_PACKET;
+      }
+
+      /* Its length not received whole yet. */
+      if (header_length >= client_ptr -> rx_length)
+      {
+        break;
+      }
+
+      header_length++;
+      total = header_length + remaining_length;
+      if (total > sizeof(client_ptr -> rx_buffer))
+      {
+        return NX_OVERFLOW;
+      }
+
+      if (client_ptr -> rx_length < total)
+      {
+        break;
+      }
+
+      client_ptr -> last_time = tx_time_get();
+
+      ret = local_broker_packet_process(index, client_ptr -> rx_buffer[0],
+                                        &client_ptr -> rx_buffer[header_length], remaining_length);
+      if ((ret != NX_SUCCESS) || (client_ptr -> state == LOCAL_BROKER_IDLE))
+      {
+        return ret;
+      }
+
+      client_ptr -> rx_length -= total;
+      memmove(client_ptr -> rx_buffer, &client_ptr -> rx_buffer[total], client_ptr -> rx_length);
+    }
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Process an MQTT packet of a client. Before its CONNECT is accepted, anything else closes
+*         the connection.
+* @param  index: index of the client
+* @param  type: first byte of the fixed header, the type and its flags
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @retval NX_SUCCESS, or an error to close the connection on
+*/
+static UINT local_broker_packet_process(UINT index, UCHAR type, UCHAR *data, UINT length)
+{
+  static const UCHAR pingresp[] = { MQTT_CONTROL_PACKET_TYPE_PINGRESP << 4, 0 };
+  UINT packet_type = (type & MQTT_CONTROL_PACKET_TYPE_FIELD) >> 4;
+
+  if (local_broker_clients[index].state == LOCAL_BROKER_OPEN)
+  {
+    if (packet_type != MQTT_CONTROL_PACKET_TYPE_CONNECT)
+    {
+      return NX_INVALID_PACKET;
+    }
+
+    return local_broker_connect_process(index, data, length);
+  }
+
+  switch (packet_type)
+  {
+  case MQTT_CONTROL_PACKET_TYPE_PUBLISH:
+    return local_broker_publish_process(index, type, data, length);
+
+  case MQTT_CONTROL_PACKET_TYPE_PUBACK:
+    /* No copy is kept for retransmission, the connection carries them. */
+    return NX_SUCCESS;
+
+  case MQTT_CONTROL_PACKET_TYPE_SUBSCRIBE:
+    return ((type & 0x0FU) == 0x02U) ? local_broker_subscribe_process(index, data, length) : NX_INVALID_PACKET;
+
+  case MQTT_CONTROL_PACKET_TYPE_UNSUBSCRIBE:
+    return ((type & 0x0FU) == 0x02U) ? local_broker_unsubscribe_process(index, data, length) : NX_INVALID_PACKET;
+
+  case MQTT_CONTROL_PACKET_TYPE_PINGREQ:
+    return local_broker_send(index, pingresp, sizeof(pingresp));
+
+  case MQTT_CONTROL_PACKET_TYPE_DISCONNECT:
+    local_broker_client_close(index);
+    return NX_SUCCESS;
+
+  default:
+    /* A second CONNECT, the QoS 2 exchanges of a broker that grants QoS 1 at most. */
+    return NX_INVALID_PACKET;
+  }
+}
+
+/**
+* @brief  Accept the CONNECT of a client and answer with its CONNACK. A client connected with the
+*         same identifier is disconnected, its session taken over.
+* @param  index: index of the client
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @retval NX_SUCCESS, or an error to close the connection on, after the CONNACK of a refusal
+*/
+static UINT local_broker_connect_process(UINT index, UCHAR *data, UINT length)
+{
+  LOCAL_BROKER_CLIENT *client_ptr = &local_broker_clients[index];
+  UCHAR connack[] = { MQTT_CONTROL_PACKET_TYPE_CONNACK << 4, 2, 0, MQTT_CONNACK_CONNECT_RETURN_CODE_ACCEPTED };
+  UCHAR *client_id_ptr;
+  UINT client_id_length;
+  UCHAR *string_ptr;
+  UINT string_length;
+  UINT offset = 0;
+  UINT flags;
+  UINT keepalive;
+  UINT i;
+
+  if ((local_broker_string_get(data, length, &offset, &string_ptr, &string_length) != NX_SUCCESS) ||
+      (string_length != 4) || (memcmp(string_ptr, "MQTT", 4) != 0) || ((offset + 4) > length))
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  flags = data[offset + 1];
+  keepalive = ((UINT)data[offset + 2] << 8) | data[offset + 3];
+  if (data[offset] != LOCAL_BROKER_PROTOCOL_LEVEL)
+  {
+    connack[3] = MQTT_CONNACK_CONNECT_RETURN_CODE_UNACCEPTABLE_PROTOCOL_VERSION;
+    local_broker_send(index, connack, sizeof(connack));
+    return NX_NOT_SUCCESSFUL;
+  }
+  offset += 4;
+
+  /* The reserved flag is zero. */
+  if (flags & 1U)
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  if (local_broker_string_get(data, length, &offset, &client_id_ptr, &client_id_length) != NX_SUCCESS)
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  /* No session is kept, a client asking the broker for an identifier expects none. */
+  if ((client_id_length > LOCAL_BROKER_CLIENT_ID_SIZE) ||
+      ((client_id_length == 0) && !(flags & MQTT_CONNECT_FLAGS_CLEAN_SESSION)))
+  {
+    connack[3] = MQTT_CONNACK_CONNECT_RETURN_CODE_IDENTIFIER_REJECTED;
+    local_broker_send(index, connack, sizeof(connack));
+    return NX_NOT_SUCCESSFUL;
+  }
+
+  /* The will, the user name and the password are read past, the broker does not use them. */
+  if (flags & MQTT_CONNECT_FLAGS_WILL_FLAG)
+  {
+    if ((local_broker_string_get(data, length, &offset, &string_ptr, &string_length) != NX_SUCCESS) ||
+        (local_broker_string_get(data, length, &offset, &string_ptr, &string_length) != NX_SUCCESS))
+    {
+      return NX_INVALID_PACKET;
+    }
+  }
+  if (((flags & MQTT_CONNECT_FLAGS_USERNAME) &&
+       (local_broker_string_get(data, length, &offset, &string_ptr, &string_length) != NX_SUCCESS)) ||
+      ((flags & MQTT_CONNECT_FLAGS_PASSWORD) &&
+       (local_broker_string_get(data, length, &offset, &string_ptr, &string_length) != NX_SUCCESS)))
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  if (client_id_length != 0)
+  {
+    for (i = 0; i < LOCAL_BROKER_CLIENTS; i++)
+    {
+      if ((i != index) && (local_broker_clients[i].state == LOCAL_BROKER_CONNECTED) &&
+          (local_broker_clients[i].client_id_length == client_id_length) &&
+          (memcmp(local_broker_clients[i].client_id, client_id_ptr, client_id_length) == 0))
+      {
+        local_broker_client_close(i);
+      }
+    }
+  }
+
+  memcpy(client_ptr -> client_id, client_id_ptr, client_id_length);
+  client_ptr -> client_id_length = (UCHAR)client_id_length;
+  client_ptr -> keepalive = (keepalive * NX_IP_PERIODIC_RATE * 3U) / 2U;
+  client_ptr -> packet_id = 0;
+  client_ptr -> state = LOCAL_BROKER_CONNECTED;
+
+  printf("Local broker: client %.*s connected\n", (int)client_id_length, (CHAR *)client_ptr -> client_id);
+
+  return local_broker_send(index, connack, sizeof(connack));
+}
+
+/**
+* @brief  Add the topic filters of a SUBSCRIBE and answer with their codes, the QoS level granted
+*         or the failure of a filter that is invalid or finds no free node.
+* @param  index: index of the client
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @retval NX_SUCCESS, or an error to close the connection on
+*/
+static UINT local_broker_subscribe_process(UINT index, UCHAR *data, UINT length)
+{
+  UCHAR header[LOCAL_BROKER_HEADER_SIZE + 2];
+  NX_PACKET *packet_ptr;
+  UCHAR *filter_ptr;
+  UINT filter_length;
+  UINT header_length;
+  UINT offset;
+  UINT count = 0;
+  UCHAR code;
+  UINT ret;
+
+  /* The filters are checked first, so that the SUBACK is built in one pass. */
+  for (offset = 2; offset < length; offset++)
+  {
+    if ((local_broker_string_get(data, length, &offset, &filter_ptr, &filter_length) != NX_SUCCESS) ||
+        (offset >= length) || (data[offset] > 2U))
+    {
+      return NX_INVALID_PACKET;
+    }
+    count++;
+  }
+
+  if ((length < 2) || (count == 0))
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  header[0] = MQTT_CONTROL_PACKET_TYPE_SUBACK << 4;
+  header_length = 1 + local_broker_length_encode(&header[1], 2 + count);
+  header[header_length++] = data[0];
+  header[header_length++] = data[1];
+
+  ret = nx_packet_allocate(local_broker_pool_ptr, &packet_ptr, NX_TCP_PACKET, LOCAL_BROKER_SEND_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, header, header_length, local_broker_pool_ptr, LOCAL_BROKER_SEND_TIMEOUT);
+
+  for (offset = 2; (ret == NX_SUCCESS) && (offset < length); offset++)
+  {
+    local_broker_string_get(data, length, &offset, &filter_ptr, &filter_length);
+
+    /* QoS 2 is served as QoS 1. */
+    code = (data[offset] == 0) ? 0U : 1U;
+    if (local_broker_subscribe(filter_ptr, filter_length, code, index) != NX_SUCCESS)
+    {
+      code = 0x80U;
+    }
+
+    ret = nx_packet_data_append(packet_ptr, &code, 1, local_broker_pool_ptr, LOCAL_BROKER_SEND_TIMEOUT);
+  }
+
+  if (ret == NX_SUCCESS)
+  {
+    ret = local_broker_socket_send(&local_broker_clients[index], packet_ptr);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Remove the topic filters of an UNSUBSCRIBE and answer with its UNSUBACK.
+* @param  index: index of the client
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @retval NX_SUCCESS, or an error to close the connection on
+*/
+static UINT local_broker_unsubscribe_process(UINT index, UCHAR *data, UINT length)
+{
+  UCHAR unsuback[] = { MQTT_CONTROL_PACKET_TYPE_UNSUBACK << 4, 2, 0, 0 };
+  UCHAR *filter_ptr;
+  UINT filter_length;
+  UINT offset = 2;
+
+  if (length <= 2)
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  while (offset < length)
+  {
+    if (local_broker_string_get(data, length, &offset, &filter_ptr, &filter_length) != NX_SUCCESS)
+    {
+      return NX_INVALID_PACKET;
+    }
+
+    local_broker_unsubscribe(filter_ptr, filter_length, index);
+  }
+
+  unsuback[2] = data[0];
+  unsuback[3] = data[1];
+
+  return local_broker_send(index, unsuback, sizeof(unsuback));
+}
+
+/**
+* @brief  Send a PUBLISH of a client to the clients subscribed to its topic, the client itself
+*         included when it is, acknowledge it for QoS 1, and forward it through the bridge.
+* @param  index: index of the client
+* @param  type: first byte of the fixed header, with the QoS level
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @retval NX_SUCCESS, or an error to close the connection on
+*/
+static UINT local_broker_publish_process(UINT index, UCHAR type, UCHAR *data, UINT length)
+{
+  UCHAR puback[] = { MQTT_CONTROL_PACKET_TYPE_PUBACK << 4, 2, 0, 0 };
+  UINT qos = (type & MQTT_PUBLISH_QOS_LEVEL_FIELD) >> 1;
+  UCHAR *topic_ptr;
+  UINT topic_length;
+  UINT offset = 0;
+
+  /* QoS 2 is not granted to any subscription, a client does not use it. */
+  if ((qos > 1U) || (local_broker_string_get(data, length, &offset, &topic_ptr, &topic_length) != NX_SUCCESS) ||
+      (topic_length == 0) || memchr(topic_ptr, '+', topic_length) || memchr(topic_ptr, '#', topic_length))
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  if (qos)
+  {
+    if ((offset + 2) > length)
+    {
+      return NX_INVALID_PACKET;
+    }
+
+    puback[2] = data[offset];
+    puback[3] = data[offset + 1];
+    offset += 2;
+  }
+
+  local_broker_fanout(topic_ptr, topic_length, &data[offset], length - offset, qos);
+
+#ifdef LOCAL_BROKER_BRIDGE
+  if (local_broker_bridge_ptr != NX_NULL)
+  {
+    nxd_mqtt_client_publish(local_broker_bridge_ptr, (CHAR *)topic_ptr, topic_length, (CHAR *)&data[offset],
+                            length - offset, NX_FALSE, QOS0, NX_NO_WAIT);
+  }
+#endif /* LOCAL_BROKER_BRIDGE */
+
+  /* The fan-out may have closed the publisher, a QoS 1 subscriber of its own topic. */
+  if (qos && (local_broker_clients[index].state == LOCAL_BROKER_CONNECTED))
+  {
+    return local_broker_send(index, puback, sizeof(puback));
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Send a message to each client subscribed to its topic, at the lower of its QoS level and
+*         of the one granted to the client. The PUBLISH is encoded once for each QoS level: the
+*         subscribers get a copy of it, made with nx_packet_copy(), and the last one the packet
+*         itself. A TCP socket owns the packets it sends until they are acknowledged, linked in its
+*         queue of packets sent, so that one packet cannot be queued on several sockets.
+* @param  topic: topic of the message
+* @param  topic_length: length of the topic
+* @param  message: message
+* @param  message_length: length of the message
+* @param  qos: QoS level of the message, 0 or 1
+* @retval None
+*/
+static VOID local_broker_fanout(const UCHAR *topic, UINT topic_length, const UCHAR *message, UINT message_length,
+                                UINT qos)
+{
+  LOCAL_BROKER_CLIENT *client_ptr;
+  NX_PACKET *template_ptr[2] = { NX_NULL, NX_NULL };
+  NX_PACKET *packet_ptr;
+  ULONG subscribers = 0;
+  ULONG qos1_subscribers = 0;
+  UCHAR length_bytes[4];
+  ULONG mask[2];
+  ULONG bit;
+  ULONG id_offset;
+  UINT level;
+  UINT ret;
+  UINT i;
+
+  local_broker_match(local_broker_root, topic, topic_length, NX_TRUE, &subscribers, &qos1_subscribers);
+  if (subscribers == 0)
+  {
+    return;
+  }
+
+  /* The packet ID follows the fixed header, the length of the topic and the topic. */
+  id_offset = 1U + local_broker_length_encode(length_bytes, 2U + topic_length + 2U + message_length) +
+              2U + topic_length;
+
+  mask[1] = qos ? (subscribers & qos1_subscribers) : 0U;
+  mask[0] = subscribers & ~mask[1];
+
+  for (level = 0; level < 2; level++)
+  {
+    if (mask[level] != 0)
+    {
+      template_ptr[level] = local_broker_publish_build(topic, topic_length, message, message_length, level);
+    }
+  }
+
+  for (i = 0; i < LOCAL_BROKER_CLIENTS; i++)
+  {
+    bit = 1UL << i;
+    if (!(subscribers & bit))
+    {
+      continue;
+    }
+
+    /* Closed by a failed send to a subscriber before it. */
+    client_ptr = &local_broker_clients[i];
+    if (client_ptr -> state != LOCAL_BROKER_CONNECTED)
+    {
+      continue;
+    }
+
+    level = (mask[1] & bit) ? 1U : 0U;
+
+    /* A QoS 0 copy is not queued behind the data a slow client has not taken yet. */
+    if (!level && client_ptr -> send_pending)
+    {
+      continue;
+    }
+
+    /* The subscribers of the lower indexes get a copy, the last one the packet. */
+    ret = NX_NO_PACKET;
+    if (template_ptr[level] != NX_NULL)
+    {
+      if (mask[level] & ~(bit | (bit - 1U)))
+      {
+        ret = nx_packet_copy(template_ptr[level], &packet_ptr, local_broker_pool_ptr, NX_NO_WAIT);
+      }
+      else
+      {
+        packet_ptr = template_ptr[level];
+        template_ptr[level] = NX_NULL;
+        ret = NX_SUCCESS;
+      }
+    }
+
+    if (ret == NX_SUCCESS)
+    {
+      if (level)
+      {
+        if (++client_ptr -> packet_id == 0)
+        {
+          client_ptr -> packet_id = 1;
+        }
+        local_broker_packet_id_set(packet_ptr, id_offset, client_ptr -> packet_id);
+      }
+
+      ret = local_broker_socket_send(client_ptr, packet_ptr);
+      if (ret != NX_SUCCESS)
+      {
+        nx_packet_release(packet_ptr);
+      }
+    }
+
+    /* A QoS 0 copy is lost, a QoS 1 subscriber is told by its connection closed. */
+    if ((ret != NX_SUCCESS) && level)
+    {
+      local_broker_client_close(i);
+    }
+  }
+
+  /* Left when the last subscriber of its level was closed meanwhile. */
+  for (level = 0; level < 2; level++)
+  {
+    if (template_ptr[level] != NX_NULL)
+    {
+      nx_packet_release(template_ptr[level]);
+    }
+  }
+}
+
+/**
+* @brief  Encode a PUBLISH in a packet of the pool, with a zero packet ID for QoS 1.
+* @param  topic: topic of the message
+* @param  topic_length: length of the topic
+* @param  message: message
+* @param  message_length: length of the message
+* @param  qos: QoS level of the PUBLISH, 0 or 1
+* @retval The packet, or NX_NULL when the pool is out of packets
+*/
+static NX_PACKET *local_broker_publish_build(const UCHAR *topic, UINT topic_length, const UCHAR *message,
+                                             UINT message_length, UINT qos)
+{
+  UCHAR header[LOCAL_BROKER_HEADER_SIZE + 2];
+  static const UCHAR packet_id[2] = { 0, 0 };
+  NX_PACKET *packet_ptr;
+  UINT header_length;
+  UINT ret;
+
+  header[0] = (UCHAR)((MQTT_CONTROL_PACKET_TYPE_PUBLISH << 4) | (qos ? MQTT_PUBLISH_QOS_LEVEL_1 : 0));
+  header_length = 1 + local_broker_length_encode(&header[1], 2 + topic_length + (qos ? 2 : 0) + message_length);
+  header[header_length++] = (UCHAR)(topic_length >> 8);
+  header[header_length++] = (UCHAR)topic_length;
+
+  if (nx_packet_allocate(local_broker_pool_ptr, &packet_ptr, NX_TCP_PACKET, LOCAL_BROKER_SEND_TIMEOUT) != NX_SUCCESS)
+  {
+    return NX_NULL;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, header, header_length, local_broker_pool_ptr, LOCAL_BROKER_SEND_TIMEOUT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_packet_data_append(packet_ptr, (VOID *)topic, topic_length, local_broker_pool_ptr,
+                                LOCAL_BROKER_SEND_TIMEOUT);
+  }
+  if ((ret == NX_SUCCESS) && qos)
+  {
+    ret = nx_packet_data_append(packet_ptr, (VOID *)packet_id, sizeof(packet_id), local_broker_pool_ptr,
+                                LOCAL_BROKER_SEND_TIMEOUT);
+  }
+  if ((ret == NX_SUCCESS) && (message_length != 0))
+  {
+    ret = nx_packet_data_append(packet_ptr, (VOID *)message, message_length, local_broker_pool_ptr,
+                                LOCAL_BROKER_SEND_TIMEOUT);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+    return NX_NULL;
+  }
+
+  return packet_ptr;
+}
+
+/**
+* @brief  Write the packet ID of a QoS 1 PUBLISH, where the packets of the chain put it.
+* @param  packet_ptr: PUBLISH of local_broker_publish_build(), or its copy
+* @param  offset: offset of the packet ID in the PUBLISH
+* @param  packet_id: packet ID of the subscriber
+* @retval None
+*/
+static VOID local_broker_packet_id_set(NX_PACKET *packet_ptr, ULONG offset, USHORT packet_id)
+{
+  UCHAR value[2];
+  ULONG size;
+  UINT i = 0;
+
+  value[0] = (UCHAR)(packet_id >> 8);
+  value[1] = (UCHAR)packet_id;
+
+  while ((packet_ptr != NX_NULL) && (i < sizeof(value)))
+  {
+    size = (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    if (offset < size)
+    {
+      packet_ptr -> nx_packet_prepend_ptr[offset++] = value[i++];
+      continue;
+    }
+
+    offset -= size;
+    packet_ptr = packet_ptr -> nx_packet_next;
+  }
+}
+
+/**
+* @brief  Send a short control packet to a client.
+* @param  index: index of the client
+* @param  data: the MQTT packet
+* @param  length: its length
+* @retval NX_SUCCESS or the error of the allocation or the send
+*/
+static UINT local_broker_send(UINT index, const UCHAR *data, UINT length)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  ret = nx_packet_allocate(local_broker_pool_ptr, &packet_ptr, NX_TCP_PACKET, LOCAL_BROKER_SEND_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, (VOID *)data, length, local_broker_pool_ptr, LOCAL_BROKER_SEND_TIMEOUT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = local_broker_socket_send(&local_broker_clients[index], packet_ptr);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Send a packet on the connection of a client. With NX_ENABLE_TCP_SEND_ASYNC, what does not fit
+*         the window of the client is queued on its socket instead of waiting for it.
+* @param  client_ptr: the client
+* @param  packet_ptr: packet to send, released by the caller on error only
+* @retval NX_SUCCESS, the packet sent or queued, or the error of the send
+*/
+static UINT local_broker_socket_send(LOCAL_BROKER_CLIENT *client_ptr, NX_PACKET *packet_ptr)
+{
+#ifdef NX_ENABLE_TCP_SEND_ASYNC
+  UINT ret;
+
+  /* Set before the send, the IP thread may send the queued data before it returns. */
+  client_ptr -> send_pending = NX_TRUE;
+
+  ret = nx_tcp_socket_send(&client_ptr -> socket, packet_ptr, NX_NO_WAIT);
+  if (ret == NX_IN_PROGRESS)
+  {
+    ret = NX_SUCCESS;
+  }
+  else
+  {
+    client_ptr -> send_pending = NX_FALSE;
+  }
+
+  return ret;
+#else
+  return nx_tcp_socket_send(&client_ptr -> socket, packet_ptr, LOCAL_BROKER_SEND_TIMEOUT);
+#endif /* NX_ENABLE_TCP_SEND_ASYNC */
+}
+ of a fixed header.
+* @param  buffer: 4 bytes at least
+* @param  length: remaining length, 268435455 at most
+* @retval Bytes written
+*/
+static UINT local_broker_length_encode(UCHAR *buffer, UINT length)
+{
+  UINT count = 0;
+
+  do
+  {
+    buffer[count] = (UCHAR)(length & 0x7FU);
+    length >>= 7;
+    if (length)
+    {
+      buffer[count] |= 0x80U;
+    }
+    count++;
+  } while (length);
+
+  return count;
+}
+
+/**
+* @brief  Read a string of a packet, its length on 2 bytes then its bytes.
+* @param  data: variable header and payload
+* @param  length: remaining length
+* @param  offset: offset of the string, moved past it
+* @param  string_ptr: first byte of the string
+* @param  string_length: length of the string
+* @retval NX_SUCCESS or NX_INVALID_PACKET when the string goes past the packet
+*/
+static UINT local_broker_string_get(UCHAR *data, UINT length, UINT *offset, UCHAR **string_ptr, UINT *string_length)
+{
+  UINT size;
+
+  if ((*offset + 2) > length)
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  size = ((UINT)data[*offset] << 8) | data[*offset + 1];
+  if ((*offset + 2 + size) > length)
+  {
+    return NX_INVALID_PACKET;
+  }
+
+  *string_ptr = &data[*offset + 2];
+  *string_length = size;
+  *offset += 2 + size;
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Check a topic filter: "+" and "#" are whole levels, "#" the last one, and each level fits
+*         in a node.
+* @param  filter: topic filter
+* @param  filter_length: length of the filter
+* @retval NX_SUCCESS or NX_INVALID_PARAMETERS
+*/
+static UINT local_broker_filter_check(const UCHAR *filter, UINT filter_length)
+{
+  UINT start = 0;
+  UINT i;
+
+  if (filter_length == 0)
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  for (i = 0; i <= filter_length; i++)
+  {
+    if ((i < filter_length) && (filter[i] != '/'))
+    {
+      if (((filter[i] == '+') || (filter[i] == '#')) &&
+          ((i != start) || ((i + 1 < filter_length) && (filter[i + 1] != '/'))))
+      {
+        return NX_INVALID_PARAMETERS;
+      }
+      if ((filter[i] == '#') && (i + 1 != filter_length))
+      {
+        return NX_INVALID_PARAMETERS;
+      }
+      continue;
+    }
+
+    if ((i - start) > LOCAL_BROKER_LEVEL_SIZE)
+    {
+      return NX_INVALID_PARAMETERS;
+    }
+    start = i + 1;
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Add a topic filter of a client to the trie, the nodes of the levels not subscribed yet
+*         taken from the free ones. A filter subscribed again has its QoS level replaced.
+* @param  filter: topic filter
+* @param  filter_length: length of the filter
+* @param  qos: QoS level granted, 0 or 1
+* @param  index: index of the client
+* @retval NX_SUCCESS, NX_INVALID_PARAMETERS for an invalid filter, or NX_NO_MORE_ENTRIES
+*/
+static UINT local_broker_subscribe(const UCHAR *filter, UINT filter_length, UINT qos, UINT index)
+{
+  LOCAL_BROKER_NODE **list_ptr = &local_broker_root;
+  LOCAL_BROKER_NODE *node_ptr = NX_NULL;
+  UINT level_length;
+  UINT start = 0;
+  UINT i;
+
+  if (local_broker_filter_check(filter, filter_length) != NX_SUCCESS)
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  while (start <= filter_length)
+  {
+    for (level_length = 0; ((start + level_length) < filter_length) && (filter[start + level_length] != '/');
+         level_length++)
+    {
+    }
+
+    for (node_ptr = *list_ptr; node_ptr != NX_NULL; node_ptr = node_ptr -> sibling)
+    {
+      if ((node_ptr -> level_length == level_length) &&
+          (memcmp(node_ptr -> level, &filter[start], level_length) == 0))
+      {
+        break;
+      }
+    }
+
+    if (node_ptr == NX_NULL)
+    {
+      for (i = 0; (i < LOCAL_BROKER_TOPIC_NODES) && local_broker_nodes[i].in_use; i++)
+      {
+      }
+
+      /* The levels added so far hold no subscriber, they are taken back. */
+      if (i == LOCAL_BROKER_TOPIC_NODES)
+      {
+        local_broker_prune(&local_broker_root);
+        return NX_NO_MORE_ENTRIES;
+      }
+
+      node_ptr = &local_broker_nodes[i];
+      node_ptr -> in_use = NX_TRUE;
+      node_ptr -> level_length = (UCHAR)level_length;
+      memcpy(node_ptr -> level, &filter[start], level_length);
+      node_ptr -> subscribers = 0;
+      node_ptr -> qos1_subscribers = 0;
+      node_ptr -> child = NX_NULL;
+      node_ptr -> sibling = *list_ptr;
+      *list_ptr = node_ptr;
+    }
+
+    list_ptr = &node_ptr -> child;
+    start += level_length + 1;
+  }
+
+  node_ptr -> subscribers |= 1UL << index;
+  if (qos)
+  {
+    node_ptr -> qos1_subscribers |= 1UL << index;
+  }
+  else
+  {
+    node_ptr -> qos1_subscribers &= ~(1UL << index);
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Remove a topic filter of a client from the trie, and the nodes left without use.
+* @param  filter: topic filter
+* @param  filter_length: length of the filter
+* @param  index: index of the client
+* @retval None
+*/
+static VOID local_broker_unsubscribe(const UCHAR *filter, UINT filter_length, UINT index)
+{
+  LOCAL_BROKER_NODE *list_ptr = local_broker_root;
+  LOCAL_BROKER_NODE *node_ptr = NX_NULL;
+  UINT level_length;
+  UINT start = 0;
+
+  while (start <= filter_length)
+  {
+    for (level_length = 0; ((start + level_length) < filter_length) && (filter[start + level_length] != '/');
+         level_length++)
+    {
+    }
+
+    for (node_ptr = list_ptr; node_ptr != NX_NULL; node_ptr = node_ptr -> sibling)
+    {
+      if ((node_ptr -> level_length == level_length) &&
+          (memcmp(node_ptr -> level, &filter[start], level_length) == 0))
+      {
+        break;
+      }
+    }
+
+    /* Not subscribed. */
+    if (node_ptr == NX_NULL)
+    {
+      return;
+    }
+
+    list_ptr = node_ptr -> child;
+    start += level_length + 1;
+  }
+
+  node_ptr -> subscribers &= ~(1UL << index);
+  node_ptr -> qos1_subscribers &= ~(1UL << index);
+  local_broker_prune(&local_broker_root);
+}
+
+/**
+* @brief  Collect the clients subscribed to a topic, from the nodes of a level down. A "+" matches
+*         any level, a "#" any levels left and its parent level, neither a first level that starts
+*         with "$".
+* @param  node_ptr: first node of the level
+* @param  topic: topic from this level on
+* @param  topic_length: bytes of the topic from this level on
+* @param  first: NX_TRUE at the first level
+* @param  subscribers: clients subscribed, completed
+* @param  qos1_subscribers: clients granted QoS 1, completed
+* @retval None
+*/
+static VOID local_broker_match(LOCAL_BROKER_NODE *node_ptr, const UCHAR *topic, UINT topic_length, UINT first,
+                               ULONG *subscribers, ULONG *qos1_subscribers)
+{
+  LOCAL_BROKER_NODE *child_ptr;
+  UINT wildcard_allowed = !(first && (topic_length != 0) && (topic[0] == '$'));
+  UINT level_length;
+  UINT last;
+
+  for (level_length = 0; (level_length < topic_length) && (topic[level_length] != '/'); level_length++)
+  {
+  }
+  last = (level_length == topic_length);
+
+  for (; node_ptr != NX_NULL; node_ptr = node_ptr -> sibling)
+  {
+    if ((node_ptr -> level_length == 1) && (node_ptr -> level[0] == '#'))
+    {
+      if (wildcard_allowed)
+      {
+        *subscribers |= node_ptr -> subscribers;
+        *qos1_subscribers |= node_ptr -> qos1_subscribers;
+      }
+      continue;
+    }
+
+    if (((node_ptr -> level_length != 1) || (node_ptr -> level[0] != '+') || !wildcard_allowed) &&
+        ((node_ptr -> level_length != level_length) || (memcmp(node_ptr -> level, topic, level_length) != 0)))
+    {
+      continue;
+    }
+
+    if (!last)
+    {
+      local_broker_match(node_ptr -> child, &topic[level_length + 1], topic_length - level_length - 1, NX_FALSE,
+                         subscribers, qos1_subscribers);
+      continue;
+    }
+
+    *subscribers |= node_ptr -> subscribers;
+    *qos1_subscribers |= node_ptr -> qos1_subscribers;
+
+    /* "a/#" matches "a" too. */
+    for (child_ptr = node_ptr -> child; child_ptr != NX_NULL; child_ptr = child_ptr -> sibling)
+    {
+      if ((child_ptr -> level_length == 1) && (child_ptr -> level[0] == '#'))
+      {
+        *subscribers |= child_ptr -> subscribers;
+        *qos1_subscribers |= child_ptr -> qos1_subscribers;
+      }
+    }
+  }
+}
+
+/**
+* @brief  Free the nodes of a level and of the levels below that have neither a subscriber nor a
+*         child left.
+* @param  list_ptr: link to the first node of the level
+* @retval None
+*/
+static VOID local_broker_prune(LOCAL_BROKER_NODE **list_ptr)
+{
+  LOCAL_BROKER_NODE *node_ptr;
+
+  while ((node_ptr = *list_ptr) != NX_NULL)
+  {
+    local_broker_prune(&node_ptr -> child);
+
+    if ((node_ptr -> child == NX_NULL) && (node_ptr -> subscribers == 0))
+    {
+      *list_ptr = node_ptr -> sibling;
+      node_ptr -> in_use = NX_FALSE;
+      continue;
+    }
+
+    list_ptr = &node_ptr -> sibling;
+  }
+}
+
+#endif /* LOCAL_BROKER */
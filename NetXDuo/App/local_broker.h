@@ -0,0 +1,63 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    local_broker.h
+  * @author  MCD Application Team
+  * @brief   MQTT broker of the site, served by the gateway
+  *
+  *          With LOCAL_BROKER defined in app_netxduo.h, the gateway accepts
+  *          LOCAL_BROKER_CLIENTS MQTT 3.1.1 connections on LOCAL_BROKER_PORT,
+  *          so that the devices of the site exchange their messages through
+  *          it instead of crossing the WAN to the remote broker and back.
+  *          One thread serves every connection: the subscriptions are kept
+  *          in a trie of topic filter levels shared by the clients, each
+  *          level a mask of the clients subscribed there, so that a message
+  *          is matched once whatever the number of subscribers, with the
+  *          "+" and "#" wildcards. QoS levels 0 and 1 are served, a QoS 2
+  *          subscription is granted QoS 1 and a QoS 2 publish closes its
+  *          connection. The broker keeps no session, no retained message
+  *          and no will: a connection starts with no subscription. A QoS 1
+  *          subscriber whose copy cannot be sent is disconnected rather than
+  *          left with a gap. With LOCAL_BROKER_BRIDGE, the messages of the
+  *          clients also go to the remote broker through the client given
+  *          to local_broker_bridge_set(). The connections are not encrypted,
+  *          the broker is for the devices of the site.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOCAL_BROKER_H__
+#define __LOCAL_BROKER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef LOCAL_BROKER
+/* Listens on LOCAL_BROKER_PORT once the IP address is set, the packets sent taken from pool_ptr. */
+UINT local_broker_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+UINT local_broker_publish(const CHAR *topic_name, UINT topic_name_length, const UCHAR *message,
+                          UINT message_length, UINT qos);
+#ifdef LOCAL_BROKER_BRIDGE
+UINT local_broker_bridge_set(NXD_MQTT_CLIENT *client_ptr);
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LOCAL_BROKER_H__ */
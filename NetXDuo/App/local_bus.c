@@ -0,0 +1,165 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    local_bus.c
+  * @author  MCD Application Team
+  * @brief   Sensor frames published to the devices of the LAN over UDP multicast
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "local_bus.h"
+
+#ifdef LOCAL_BUS
+
+/* Private define ------------------------------------------------------------*/
+/* The single Ethernet port of the board */
+#define LOCAL_BUS_INTERFACE           0U
+
+/* Private variables ---------------------------------------------------------*/
+static NX_IP *local_bus_ip_ptr;
+static NX_PACKET_POOL *local_bus_pool_ptr;
+
+static NX_UDP_SOCKET local_bus_socket;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Enable IGMP and bind the socket of the bus to LOCAL_BUS_PORT. The frames sent by the board
+*         are not looped back to its own socket.
+* @param  ip_ptr: IP instance, its address set
+* @param  pool_ptr: pool of the frames published
+* @retval NX_SUCCESS or the error of the IGMP or UDP setup
+*/
+UINT local_bus_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  UINT ret;
+
+  local_bus_ip_ptr = ip_ptr;
+  local_bus_pool_ptr = pool_ptr;
+
+  ret = nx_igmp_enable(ip_ptr);
+  if ((ret != NX_SUCCESS) && (ret != NX_ALREADY_ENABLED))
+  {
+    return ret;
+  }
+
+  ret = nx_igmp_loopback_disable(ip_ptr);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_udp_socket_create(ip_ptr, &local_bus_socket, "Local bus", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             LOCAL_BUS_TTL, LOCAL_BUS_QUEUE);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_udp_socket_bind(&local_bus_socket, LOCAL_BUS_PORT, TX_NO_WAIT);
+  if (ret != NX_SUCCESS)
+  {
+    nx_udp_socket_delete(&local_bus_socket);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Join a group: IGMP reports the membership and the driver lets the frames of the group in.
+* @param  group_address: multicast address, 239.0.0.0/8 for a group of the site
+* @retval NX_SUCCESS or the error of nx_igmp_multicast_interface_join()
+*/
+UINT local_bus_subscribe(ULONG group_address)
+{
+  return nx_igmp_multicast_interface_join(local_bus_ip_ptr, group_address, LOCAL_BUS_INTERFACE);
+}
+
+/**
+* @brief  Leave a group, its frames are dropped by the hardware again once no other member is left.
+* @param  group_address: multicast address joined
+* @retval NX_SUCCESS or the error of nx_igmp_multicast_leave()
+*/
+UINT local_bus_unsubscribe(ULONG group_address)
+{
+  return nx_igmp_multicast_leave(local_bus_ip_ptr, group_address);
+}
+
+/**
+* @brief  Send a frame once to all the subscribers of a group, without joining it.
+* @param  group_address: multicast address of the subscribers
+* @param  frame: frame, copied
+* @param  frame_length: bytes of the frame, one datagram
+* @retval NX_SUCCESS or the error of the allocation or of the send, the packet is released then
+*/
+UINT local_bus_publish(ULONG group_address, const UCHAR *frame, UINT frame_length)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  ret = nx_packet_allocate(local_bus_pool_ptr, &packet_ptr, NX_UDP_PACKET, TX_NO_WAIT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, (VOID *)frame, frame_length, local_bus_pool_ptr, TX_NO_WAIT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_send(&local_bus_socket, packet_ptr, group_address, LOCAL_BUS_PORT);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Take the next frame received on the groups subscribed.
+* @param  buffer: copy of the frame
+* @param  buffer_size: bytes of the buffer, a longer frame is truncated
+* @param  frame_length_ptr: bytes copied, set
+* @param  source_address_ptr: address of the publisher, set
+* @param  wait_option: ticks to wait for a frame
+* @retval NX_SUCCESS, NX_NO_PACKET when none came in time
+*/
+UINT local_bus_receive(UCHAR *buffer, UINT buffer_size, UINT *frame_length_ptr,
+                       ULONG *source_address_ptr, ULONG wait_option)
+{
+  NX_PACKET *packet_ptr;
+  ULONG bytes_copied;
+  UINT port;
+  UINT ret;
+
+  ret = nx_udp_socket_receive(&local_bus_socket, &packet_ptr, wait_option);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  nx_udp_source_extract(packet_ptr, source_address_ptr, &port);
+
+  ret = nx_packet_data_extract_offset(packet_ptr, 0, buffer, buffer_size, &bytes_copied);
+  *frame_length_ptr = (UINT)bytes_copied;
+
+  nx_packet_release(packet_ptr);
+
+  return ret;
+}
+
+#endif /* LOCAL_BUS */
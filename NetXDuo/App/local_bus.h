@@ -0,0 +1,55 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    local_bus.h
+  * @author  MCD Application Team
+  * @brief   Sensor frames published to the devices of the LAN over UDP multicast
+  *
+  *          With LOCAL_BUS defined in app_netxduo.h, a frame is sent once to
+  *          a multicast group, whatever the number of devices subscribed on
+  *          the segment, instead of going through the remote broker. A device
+  *          subscribes with an IGMP join of the group: the Ethernet driver
+  *          adds the group to the MAC filter, so that the frames of the groups
+  *          not joined are dropped by the hardware. The datagrams are sent
+  *          with a TTL of LOCAL_BUS_TTL, 1 keeps them on the segment. They are
+  *          not encrypted, the bus is for the consumers of the site.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOCAL_BUS_H__
+#define __LOCAL_BUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef LOCAL_BUS
+/* Enables IGMP and binds the socket of the bus once the IP address is set. The frames of the
+   groups subscribed are queued on the socket until local_bus_receive() takes them. */
+UINT local_bus_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+UINT local_bus_subscribe(ULONG group_address);
+UINT local_bus_unsubscribe(ULONG group_address);
+UINT local_bus_publish(ULONG group_address, const UCHAR *frame, UINT frame_length);
+UINT local_bus_receive(UCHAR *buffer, UINT buffer_size, UINT *frame_length_ptr,
+                       ULONG *source_address_ptr, ULONG wait_option);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LOCAL_BUS_H__ */
@@ -0,0 +1,507 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mqtt_benchmark.c
+  * @author  MCD Application Team
+  * @brief   MQTT client throughput and latency benchmark
+  *
+  *          The tests run against the broker of the demo, first over TCP when
+  *          NXD_MQTT_REQUIRE_TLS allows it, then over TLS:
+  *           - connection time,
+  *           - echo round trip through the broker on TOPIC_NAME, for payloads
+  *             from BENCHMARK_PAYLOAD_MIN doubling up to NXD_MQTT_MAX_MESSAGE_LENGTH,
+  *           - QoS0 publish rate, with the duration of each publish call,
+  *           - QoS1 publish rate with MQTT_PUBLISH_WINDOW messages in flight,
+  *             with the PUBACK latency of each message.
+  *          Durations are measured with the DWT cycle counter and reported as
+  *          p50/p99/max, rates from the ThreadX time.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mqtt_benchmark.h"
+#include "perf_harness.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef MQTT_BENCHMARK
+
+/* Private define ------------------------------------------------------------*/
+#define BENCHMARK_SAMPLES           ((BENCHMARK_MESSAGES > BENCHMARK_ECHO_COUNT) ? BENCHMARK_MESSAGES : BENCHMARK_ECHO_COUNT)
+
+/* Private variables ---------------------------------------------------------*/
+static NXD_MQTT_CLIENT *benchmark_client_ptr;
+
+/* Durations of the running test, in CPU cycles. */
+static uint32_t benchmark_samples[BENCHMARK_SAMPLES] CCMRAM_BSS;
+static UINT benchmark_sample_count;
+
+/* Start of the QoS1 messages in flight, indexed by their rank modulo the window. */
+static uint32_t benchmark_publish_start[MQTT_PUBLISH_WINDOW];
+static UINT benchmark_puback_count;
+
+/* Arrival of the last message echoed by the broker. */
+static uint32_t benchmark_echo_cycles;
+static UINT benchmark_echo_length;
+
+static TX_SEMAPHORE benchmark_pubacks;
+static TX_SEMAPHORE benchmark_subacks;
+static TX_SEMAPHORE benchmark_echoes;
+
+static UCHAR benchmark_payload[NXD_MQTT_MAX_MESSAGE_LENGTH];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Count the PUBACKs and record their latency, called from the MQTT client events processing.
+* @retval None
+*/
+static VOID benchmark_ack_notify(NXD_MQTT_CLIENT *client_ptr, UINT type, USHORT packet_id,
+                                 NX_PACKET *transmit_packet_ptr, VOID *context)
+{
+  uint32_t now = DWT -> CYCCNT;
+
+  NX_PARAMETER_NOT_USED(client_ptr);
+  NX_PARAMETER_NOT_USED(packet_id);
+  NX_PARAMETER_NOT_USED(transmit_packet_ptr);
+  NX_PARAMETER_NOT_USED(context);
+
+  if (type == MQTT_CONTROL_PACKET_TYPE_PUBACK)
+  {
+    /* The broker acknowledges the messages in the order they were sent. */
+    if (benchmark_sample_count < BENCHMARK_SAMPLES)
+    {
+      benchmark_samples[benchmark_sample_count++] =
+        now - benchmark_publish_start[benchmark_puback_count % MQTT_PUBLISH_WINDOW];
+    }
+    benchmark_puback_count++;
+    tx_semaphore_put(&benchmark_pubacks);
+  }
+  else if (type == MQTT_CONTROL_PACKET_TYPE_SUBACK)
+  {
+    tx_semaphore_put(&benchmark_subacks);
+  }
+}
+
+/**
+* @brief  Record the arrival of the echoed message, called from the MQTT client events processing.
+* @retval None
+*/
+static VOID benchmark_echo_callback(NXD_MQTT_CLIENT *client_ptr, NX_PACKET *packet_ptr,
+                                    ULONG topic_offset, UINT topic_length,
+                                    ULONG message_offset, ULONG message_length, VOID *context)
+{
+  uint32_t now = DWT -> CYCCNT;
+
+  NX_PARAMETER_NOT_USED(client_ptr);
+  NX_PARAMETER_NOT_USED(topic_offset);
+  NX_PARAMETER_NOT_USED(topic_length);
+  NX_PARAMETER_NOT_USED(context);
+
+  /* Other clients of the broker may publish on the topic too, the first byte tells the round apart. */
+  if ((message_length != benchmark_echo_length) ||
+      ((packet_ptr -> nx_packet_next == NX_NULL) &&
+       (packet_ptr -> nx_packet_prepend_ptr[message_offset] != benchmark_payload[0])))
+  {
+    return;
+  }
+
+  benchmark_echo_cycles = now;
+  tx_semaphore_put(&benchmark_echoes);
+}
+
+/**
+* @brief  Wait for a semaphore, processing the MQTT client events meanwhile when the client has no thread.
+* @param  semaphore_ptr: semaphore put by the client callbacks
+* @param  wait_option: longest wait, in ticks
+* @retval TX_SUCCESS when the semaphore is obtained
+*/
+static UINT benchmark_wait(TX_SEMAPHORE *semaphore_ptr, ULONG wait_option)
+{
+#ifdef NXD_MQTT_APPLICATION_EVENT_LOOP
+  ULONG start = tx_time_get();
+  ULONG elapsed;
+
+  while (tx_semaphore_get(semaphore_ptr, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    elapsed = tx_time_get() - start;
+    if (elapsed >= wait_option)
+    {
+      return TX_NO_INSTANCE;
+    }
+
+    nxd_mqtt_client_events_process(benchmark_client_ptr, wait_option - elapsed);
+  }
+
+  return TX_SUCCESS;
+#else
+  return tx_semaphore_get(semaphore_ptr, wait_option);
+#endif
+}
+
+/**
+* @brief  Drop the counts left over by the previous test.
+* @retval None
+*/
+static VOID benchmark_reset(VOID)
+{
+  while (tx_semaphore_get(&benchmark_pubacks, TX_NO_WAIT) == TX_SUCCESS);
+  while (tx_semaphore_get(&benchmark_echoes, TX_NO_WAIT) == TX_SUCCESS);
+
+  benchmark_sample_count = 0;
+  benchmark_puback_count = 0;
+}
+
+/**
+* @brief  Order two samples for qsort.
+* @retval negative, zero or positive
+*/
+static int benchmark_compare(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+* @brief  Report the p50/p99/max of the samples of a test.
+* @param  name: test name
+* @retval None
+*/
+static VOID benchmark_report(const CHAR *name)
+{
+  uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  UINT count = benchmark_sample_count;
+  ULONG p50;
+  ULONG p99;
+
+  if (count == 0)
+  {
+    printf("%s: no sample\n", name);
+    return;
+  }
+
+  qsort(benchmark_samples, count, sizeof(benchmark_samples[0]), benchmark_compare);
+
+  p50 = benchmark_samples[((count - 1) * 50) / 100] / cycles_per_us;
+  p99 = benchmark_samples[((count - 1) * 99) / 100] / cycles_per_us;
+
+  printf("%s: %u samples, p50 %lu us, p99 %lu us, max %lu us\n", name, count, (unsigned long)p50,
+         (unsigned long)p99, (unsigned long)(benchmark_samples[count - 1] / cycles_per_us));
+  perf_harness_result("mqtt", "p50 us", p50, PERF_HARNESS_LOWER, "%s", name);
+  perf_harness_result("mqtt", "p99 us", p99, PERF_HARNESS_LOWER, "%s", name);
+}
+
+/**
+* @brief  Connect to the broker and subscribe to the echo topic.
+* @param  server_ip: address of the broker
+* @param  tls: NX_TRUE to connect over TLS
+* @retval NXD_MQTT_SUCCESS or the error of the failed step
+*/
+static UINT benchmark_connect(NXD_ADDRESS *server_ip, UINT tls)
+{
+  UINT ret;
+  uint32_t start;
+  ULONG ms;
+
+  start = DWT -> CYCCNT;
+
+  /* A clean session, nothing is left from the previous runs. */
+  if (tls)
+  {
+    ret = nxd_mqtt_client_secure_connect(benchmark_client_ptr, server_ip, NXD_MQTT_TLS_PORT, tls_setup_callback,
+                                         MQTT_KEEP_ALIVE_TIMER, NX_TRUE, MQTT_CONNECT_TIMEOUT);
+  }
+  else
+  {
+#ifndef NXD_MQTT_REQUIRE_TLS
+    ret = nxd_mqtt_client_connect(benchmark_client_ptr, server_ip, NXD_MQTT_PORT,
+                                  MQTT_KEEP_ALIVE_TIMER, NX_TRUE, MQTT_CONNECT_TIMEOUT);
+#else
+    ret = NXD_MQTT_CONNECT_FAILURE;
+#endif
+  }
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    printf("%s connect failed: 0x%x\n", tls ? "TLS" : "TCP", ret);
+    return ret;
+  }
+
+  ms = (DWT -> CYCCNT - start) / (SystemCoreClock / 1000U);
+  printf("%s connect: %lu ms\n", tls ? "TLS" : "TCP", (unsigned long)ms);
+  perf_harness_result("mqtt", "ms", ms, PERF_HARNESS_LOWER, "%s connect", tls ? "TLS" : "TCP");
+
+  ret = nxd_mqtt_client_subscribe(benchmark_client_ptr, TOPIC_NAME, STRLEN(TOPIC_NAME), QOS0);
+  if ((ret == NXD_MQTT_SUCCESS) && (benchmark_wait(&benchmark_subacks, BENCHMARK_TIMEOUT) != TX_SUCCESS))
+  {
+    ret = NXD_MQTT_COMMUNICATION_FAILURE;
+  }
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    printf("%s subscribe failed: 0x%x\n", tls ? "TLS" : "TCP", ret);
+    nxd_mqtt_client_disconnect(benchmark_client_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Measure the round trip of a QoS0 message through the broker.
+* @param  transport: "TCP" or "TLS"
+* @param  length: payload length
+* @retval NXD_MQTT_SUCCESS or the error of the failed publish
+*/
+static UINT benchmark_echo(const CHAR *transport, UINT length)
+{
+  UINT ret = NXD_MQTT_SUCCESS;
+  UINT round;
+  UINT lost = 0;
+  uint32_t start;
+  CHAR name[48];
+
+  benchmark_reset();
+  benchmark_echo_length = length;
+
+  for (round = 0; round < BENCHMARK_ECHO_COUNT; round++)
+  {
+    benchmark_payload[0] = (UCHAR)('A' + (round % 26));
+
+    start = DWT -> CYCCNT;
+    ret = nxd_mqtt_client_publish(benchmark_client_ptr, TOPIC_NAME, STRLEN(TOPIC_NAME),
+                                  (CHAR *)benchmark_payload, length, NX_FALSE, QOS0, NX_WAIT_FOREVER);
+    if (ret != NXD_MQTT_SUCCESS)
+    {
+      break;
+    }
+
+    if (benchmark_wait(&benchmark_echoes, BENCHMARK_TIMEOUT) != TX_SUCCESS)
+    {
+      lost++;
+      continue;
+    }
+
+    benchmark_samples[benchmark_sample_count++] = benchmark_echo_cycles - start;
+  }
+
+  /* The name is the key of the results in the performance harness, the lost ones are apart. */
+  snprintf(name, sizeof(name), "%s echo %u B", transport, length);
+  if (lost != 0)
+  {
+    printf("%s: %u lost\n", name, lost);
+  }
+  benchmark_report(name);
+
+  return ret;
+}
+
+/**
+* @brief  Measure the publish rate at a QoS level.
+* @param  transport: "TCP" or "TLS"
+* @param  qos: QOS0 to time the publish calls, QOS1 to time the PUBACKs
+* @retval NXD_MQTT_SUCCESS or the error of the failed publish
+*/
+static UINT benchmark_publish_rate(const CHAR *transport, UINT qos)
+{
+  UINT ret = NXD_MQTT_SUCCESS;
+  UINT sent;
+  UINT pending;
+  ULONG start_time;
+  ULONG elapsed;
+  uint32_t start;
+  CHAR name[48];
+
+  benchmark_reset();
+  start_time = tx_time_get();
+
+  for (sent = 0; sent < BENCHMARK_MESSAGES; sent++)
+  {
+    /* Beyond the window, each QoS1 message waits for the PUBACK of an older one. */
+    if ((qos == QOS1) && (sent >= MQTT_PUBLISH_WINDOW) &&
+        (benchmark_wait(&benchmark_pubacks, BENCHMARK_TIMEOUT) != TX_SUCCESS))
+    {
+      ret = NXD_MQTT_COMMUNICATION_FAILURE;
+      break;
+    }
+
+    start = DWT -> CYCCNT;
+    benchmark_publish_start[sent % MQTT_PUBLISH_WINDOW] = start;
+
+    ret = nxd_mqtt_client_publish(benchmark_client_ptr, BENCHMARK_RATE_TOPIC, STRLEN(BENCHMARK_RATE_TOPIC),
+                                  (CHAR *)benchmark_payload, sizeof(benchmark_payload), NX_FALSE, qos, NX_WAIT_FOREVER);
+    if (ret != NXD_MQTT_SUCCESS)
+    {
+      break;
+    }
+
+    if (qos == QOS0)
+    {
+      benchmark_samples[benchmark_sample_count++] = DWT -> CYCCNT - start;
+    }
+  }
+
+  /* The rate counts the QoS1 messages once acknowledged. */
+  if (qos == QOS1)
+  {
+    for (pending = (sent < MQTT_PUBLISH_WINDOW) ? sent : MQTT_PUBLISH_WINDOW; pending; pending--)
+    {
+      if (benchmark_wait(&benchmark_pubacks, BENCHMARK_TIMEOUT) != TX_SUCCESS)
+      {
+        ret = NXD_MQTT_COMMUNICATION_FAILURE;
+        break;
+      }
+    }
+  }
+
+  elapsed = tx_time_get() - start_time;
+  if (elapsed == 0)
+  {
+    elapsed = 1;
+  }
+
+  printf("%s QoS%u rate: %u messages of %u B in %lu ms, %lu msg/s\n", transport, qos, sent,
+         (UINT)sizeof(benchmark_payload), (unsigned long)((elapsed * 1000U) / NX_IP_PERIODIC_RATE),
+         (unsigned long)((sent * NX_IP_PERIODIC_RATE) / elapsed));
+  perf_harness_result("mqtt", "msg/s", (sent * NX_IP_PERIODIC_RATE) / elapsed, PERF_HARNESS_HIGHER, "%s QoS%u rate",
+                      transport, qos);
+
+  snprintf(name, sizeof(name), "%s QoS%u %s", transport, qos, (qos == QOS0) ? "publish call" : "PUBACK latency");
+  benchmark_report(name);
+
+  return ret;
+}
+
+/**
+* @brief  Run all the tests over one transport.
+* @param  server_ip: address of the broker
+* @param  tls: NX_TRUE to run over TLS
+* @retval None
+*/
+static VOID benchmark_transport_run(NXD_ADDRESS *server_ip, UINT tls)
+{
+  const CHAR *transport = tls ? "TLS" : "TCP";
+  UINT ret;
+  UINT length;
+
+  if (benchmark_connect(server_ip, tls) != NXD_MQTT_SUCCESS)
+  {
+    return;
+  }
+
+  /* Profile the tests only, without the connection. */
+  cycle_profile_reset();
+
+  /* Payload sweep of the echo round trip. */
+  ret = NXD_MQTT_SUCCESS;
+  for (length = BENCHMARK_PAYLOAD_MIN; ret == NXD_MQTT_SUCCESS; length *= 2)
+  {
+    if (length > sizeof(benchmark_payload))
+    {
+      length = sizeof(benchmark_payload);
+    }
+
+    ret = benchmark_echo(transport, length);
+
+    if (length == sizeof(benchmark_payload))
+    {
+      break;
+    }
+  }
+
+  if (ret == NXD_MQTT_SUCCESS)
+  {
+    ret = benchmark_publish_rate(transport, QOS0);
+  }
+
+  if (ret == NXD_MQTT_SUCCESS)
+  {
+    ret = benchmark_publish_rate(transport, QOS1);
+  }
+
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    printf("%s benchmark stopped: 0x%x\n", transport, ret);
+  }
+
+  cycle_profile_dump(transport);
+
+  nxd_mqtt_client_disconnect(benchmark_client_ptr);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Run the benchmark.
+* @param  client_ptr: MQTT client, created and not connected
+* @param  dns_ptr: DNS client resolving the broker
+* @retval NX_SUCCESS or the error that prevented the tests
+*/
+UINT mqtt_benchmark_run(NXD_MQTT_CLIENT *client_ptr, NX_DNS *dns_ptr)
+{
+  UINT ret;
+  NXD_ADDRESS server_ip;
+
+  benchmark_client_ptr = client_ptr;
+
+  /* Start the cycle counter. */
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CYCCNT = 0;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  ret = tx_semaphore_create(&benchmark_pubacks, "Benchmark PUBACKs", 0);
+  ret |= tx_semaphore_create(&benchmark_subacks, "Benchmark SUBACKs", 0);
+  ret |= tx_semaphore_create(&benchmark_echoes, "Benchmark echoes", 0);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* The benchmark takes over the ACKs and the messages of the echo topic. */
+  nxd_mqtt_client_ack_notify_set(client_ptr, benchmark_ack_notify, NX_NULL);
+  ret = nxd_mqtt_client_topic_callback_set(client_ptr, TOPIC_NAME, STRLEN(TOPIC_NAME),
+                                           benchmark_echo_callback, NX_NULL);
+  if (ret != NXD_MQTT_SUCCESS)
+  {
+    return ret;
+  }
+
+  memset(benchmark_payload, 'x', sizeof(benchmark_payload));
+
+  server_ip.nxd_ip_version = 4;
+  ret = nx_dns_host_by_name_get(dns_ptr, (UCHAR *)MQTT_BROKER_NAME, &server_ip.nxd_ip_address.v4, DEFAULT_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    printf("Benchmark failed to resolve broker < %s >.\n", MQTT_BROKER_NAME);
+    return ret;
+  }
+
+  printf("MQTT benchmark with broker < %s >, CPU at %lu MHz\n", MQTT_BROKER_NAME,
+         (unsigned long)(SystemCoreClock / 1000000U));
+
+  /* Over TCP first, a plain connection does not follow a TLS one on the same client. */
+#ifndef NXD_MQTT_REQUIRE_TLS
+  benchmark_transport_run(&server_ip, NX_FALSE);
+#else
+  printf("TCP skipped, NXD_MQTT_REQUIRE_TLS is defined\n");
+#endif
+  benchmark_transport_run(&server_ip, NX_TRUE);
+
+  printf("MQTT benchmark done\n");
+
+  return NX_SUCCESS;
+}
+
+#endif /* MQTT_BENCHMARK */
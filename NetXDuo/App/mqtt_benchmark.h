@@ -0,0 +1,39 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mqtt_benchmark.h
+  * @author  MCD Application Team
+  * @brief   MQTT client throughput and latency benchmark
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MQTT_BENCHMARK_H__
+#define __MQTT_BENCHMARK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Runs the tests selected in app_netxduo.h with a client already created,
+   and reports them over the UART. The client is disconnected on return. */
+UINT mqtt_benchmark_run(NXD_MQTT_CLIENT *client_ptr, NX_DNS *dns_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __MQTT_BENCHMARK_H__ */
@@ -0,0 +1,341 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mqtt_manager.c
+  * @author  MCD Application Team
+  * @brief   Several MQTT broker connections served by one thread
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mqtt_manager.h"
+#include "dns_resolver.h"
+
+#ifdef MQTT_BACKUP_BROKER_NAME
+
+#ifndef NXD_MQTT_APPLICATION_EVENT_LOOP
+#error "The MQTT manager requires NXD_MQTT_APPLICATION_EVENT_LOOP, the clients have no thread of their own."
+#endif
+
+#if (MQTT_MANAGER_CONNECTIONS > 32)
+#error "MQTT_MANAGER_CONNECTIONS is the number of flags of an event flags group at most."
+#endif
+
+/* Private define ------------------------------------------------------------*/
+/* Flag of each connection in the group of the manager, its index in the table */
+#define MQTT_MANAGER_FLAG(index)      (1UL << (index))
+#define MQTT_MANAGER_ALL_FLAGS        (0xFFFFFFFFUL >> (32U - MQTT_MANAGER_CONNECTIONS))
+
+/* Private variables ---------------------------------------------------------*/
+static MQTT_MANAGER_CONNECTION *mqtt_manager_connections[MQTT_MANAGER_CONNECTIONS];
+
+/* Held while the table is changed or walked, by the thread of the manager while it processes the events. */
+static TX_MUTEX mqtt_manager_mutex;
+static TX_EVENT_FLAGS_GROUP mqtt_manager_events;
+
+static TX_THREAD mqtt_manager_thread;
+static ULONG mqtt_manager_thread_stack[MQTT_MANAGER_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID mqtt_manager_thread_entry(ULONG thread_input);
+static VOID mqtt_manager_connection_check(MQTT_MANAGER_CONNECTION *connection_ptr, ULONG *wait_option);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the thread that serves the connections, before the first one is added.
+* @param  None
+* @retval TX_SUCCESS or the error of the object creations
+*/
+UINT mqtt_manager_start(VOID)
+{
+  UINT ret;
+
+  ret = tx_mutex_create(&mqtt_manager_mutex, "MQTT manager", TX_NO_INHERIT);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_event_flags_create(&mqtt_manager_events, "MQTT manager");
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  return tx_thread_create(&mqtt_manager_thread, "App MQTT Manager Thread", mqtt_manager_thread_entry, 0,
+                          mqtt_manager_thread_stack, sizeof(mqtt_manager_thread_stack),
+                          MQTT_MANAGER_PRIORITY, MQTT_MANAGER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Have the thread of the manager process the events of a client from now on, and keep it
+*         connected to connection_ptr -> broker_name when one is given. The application does not
+*         call nxd_mqtt_client_events_process() for it any more, it waits for its ACKs on what its
+*         notify functions set, as with a client thread.
+* @param  connection_ptr: connection of a created client, its fields above the ones of the manager set
+* @retval NXD_MQTT_SUCCESS or NX_NO_MORE_ENTRIES if MQTT_MANAGER_CONNECTIONS are added already
+*/
+UINT mqtt_manager_connection_add(MQTT_MANAGER_CONNECTION *connection_ptr)
+{
+  UINT ret = NX_NO_MORE_ENTRIES;
+  UINT i;
+
+  connection_ptr -> connected = NX_FALSE;
+  connection_ptr -> retry_time = tx_time_get();
+  connection_ptr -> published = 0;
+  connection_ptr -> dropped = 0;
+
+  tx_mutex_get(&mqtt_manager_mutex, TX_WAIT_FOREVER);
+
+  for (i = 0; i < MQTT_MANAGER_CONNECTIONS; i++)
+  {
+    if (mqtt_manager_connections[i] == NX_NULL)
+    {
+      mqtt_manager_connections[i] = connection_ptr;
+      ret = nxd_mqtt_client_events_signal_set(connection_ptr -> client_ptr, &mqtt_manager_events,
+                                              MQTT_MANAGER_FLAG(i));
+
+      /* The events set before the signal, and the first connection. */
+      tx_event_flags_set(&mqtt_manager_events, MQTT_MANAGER_FLAG(i), TX_OR);
+      break;
+    }
+  }
+
+  tx_mutex_put(&mqtt_manager_mutex);
+
+  return ret;
+}
+
+/**
+* @brief  Give the events of a client back to the application before it disconnects and deletes it.
+*         The connection the manager kept is left as it is.
+* @param  connection_ptr: added connection
+* @retval NXD_MQTT_SUCCESS or NX_ENTRY_NOT_FOUND
+*/
+UINT mqtt_manager_connection_remove(MQTT_MANAGER_CONNECTION *connection_ptr)
+{
+  UINT ret = NX_ENTRY_NOT_FOUND;
+  UINT i;
+
+  tx_mutex_get(&mqtt_manager_mutex, TX_WAIT_FOREVER);
+
+  for (i = 0; i < MQTT_MANAGER_CONNECTIONS; i++)
+  {
+    if (mqtt_manager_connections[i] == connection_ptr)
+    {
+      mqtt_manager_connections[i] = NX_NULL;
+      ret = nxd_mqtt_client_events_signal_set(connection_ptr -> client_ptr, NX_NULL, 0);
+      break;
+    }
+  }
+
+  tx_mutex_put(&mqtt_manager_mutex);
+
+  return ret;
+}
+
+/**
+* @brief  Publish a message on each connection the manager keeps connected, without waiting for
+*         any of them: a broker that is offline or slow to take its copy loses the message, the
+*         others get theirs all the same.
+* @param  topic_name: topic of the message
+* @param  topic_name_length: length of the topic
+* @param  message: message to publish
+* @param  message_length: length of the message
+* @param  qos: QoS of the copies
+* @retval NXD_MQTT_SUCCESS if at least one connection took the message, NXD_MQTT_NOT_CONNECTED otherwise
+*/
+UINT mqtt_manager_publish(CHAR *topic_name, UINT topic_name_length, CHAR *message, UINT message_length, UINT qos)
+{
+  MQTT_MANAGER_CONNECTION *connection_ptr;
+  UINT ret = NXD_MQTT_NOT_CONNECTED;
+  UINT i;
+
+  tx_mutex_get(&mqtt_manager_mutex, TX_WAIT_FOREVER);
+
+  for (i = 0; i < MQTT_MANAGER_CONNECTIONS; i++)
+  {
+    connection_ptr = mqtt_manager_connections[i];
+    if ((connection_ptr == NX_NULL) || (connection_ptr -> broker_name == NX_NULL))
+    {
+      continue;
+    }
+
+    if (connection_ptr -> connected &&
+        (nxd_mqtt_client_publish(connection_ptr -> client_ptr, topic_name, topic_name_length, message, message_length,
+                                 NX_FALSE, qos, NX_NO_WAIT) == NXD_MQTT_SUCCESS))
+    {
+      connection_ptr -> published++;
+      ret = NXD_MQTT_SUCCESS;
+    }
+    else
+    {
+      connection_ptr -> dropped++;
+    }
+  }
+
+  tx_mutex_put(&mqtt_manager_mutex);
+
+  return ret;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Thread of the manager: process the events of the clients whose flag is set, then
+*         connect the ones that are offline, once their retry time is reached.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID mqtt_manager_thread_entry(ULONG thread_input)
+{
+  MQTT_MANAGER_CONNECTION *connection_ptr;
+  ULONG wait_option = TX_WAIT_FOREVER;
+  ULONG flags;
+  UINT i;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  for (;;)
+  {
+    /* Woken up by an event of a client, or the next connection attempt. */
+    if (tx_event_flags_get(&mqtt_manager_events, MQTT_MANAGER_ALL_FLAGS, TX_OR_CLEAR, &flags,
+                           wait_option) != TX_SUCCESS)
+    {
+      flags = 0;
+    }
+
+    tx_mutex_get(&mqtt_manager_mutex, TX_WAIT_FOREVER);
+
+    wait_option = TX_WAIT_FOREVER;
+    for (i = 0; i < MQTT_MANAGER_CONNECTIONS; i++)
+    {
+      connection_ptr = mqtt_manager_connections[i];
+      if (connection_ptr == NX_NULL)
+      {
+        continue;
+      }
+
+      /* All the events of the client are taken at once, a new one sets its flag again. */
+      if (flags & MQTT_MANAGER_FLAG(i))
+      {
+        nxd_mqtt_client_events_process(connection_ptr -> client_ptr, TX_NO_WAIT);
+      }
+
+      if (connection_ptr -> broker_name != NX_NULL)
+      {
+        mqtt_manager_connection_check(connection_ptr, &wait_option);
+      }
+    }
+
+    tx_mutex_put(&mqtt_manager_mutex);
+  }
+}
+
+/**
+* @brief  Follow the state of a connection the manager keeps, and start a connection once it is
+*         offline and its retry time is reached. The connection goes on in the events of the client,
+*         it does not hold the thread: only the first resolution of the broker name waits.
+* @param  connection_ptr: connection with a broker name
+* @param  wait_option: ticks until the next attempt of the connections checked so far, lowered
+* @retval None
+*/
+static VOID mqtt_manager_connection_check(MQTT_MANAGER_CONNECTION *connection_ptr, ULONG *wait_option)
+{
+  NXD_MQTT_CLIENT *client_ptr = connection_ptr -> client_ptr;
+  NXD_ADDRESS broker_address;
+  ULONG link_status;
+  ULONG remaining;
+  UINT ret;
+
+  if (client_ptr -> nxd_mqtt_client_state == NXD_MQTT_CLIENT_STATE_CONNECTED)
+  {
+    if (!connection_ptr -> connected)
+    {
+      connection_ptr -> connected = NX_TRUE;
+      printf("MQTT manager connected to broker < %s >\n", connection_ptr -> broker_name);
+
+      if (connection_ptr -> connected_notify != NX_NULL)
+      {
+        connection_ptr -> connected_notify(client_ptr);
+      }
+    }
+    return;
+  }
+
+  /* The handshake goes on, its end wakes the thread up. */
+  if (client_ptr -> nxd_mqtt_client_state != NXD_MQTT_CLIENT_STATE_IDLE)
+  {
+    return;
+  }
+
+  if (connection_ptr -> connected)
+  {
+    connection_ptr -> connected = NX_FALSE;
+    connection_ptr -> retry_time = tx_time_get() + MQTT_RECONNECT_INTERVAL;
+    printf("MQTT manager disconnected from broker < %s >\n", connection_ptr -> broker_name);
+  }
+
+  remaining = connection_ptr -> retry_time - tx_time_get();
+  if (((LONG)remaining > 0) ||
+      (nx_ip_interface_status_check(client_ptr -> nxd_mqtt_client_ip_ptr, 0, NX_IP_ADDRESS_RESOLVED | NX_IP_LINK_ENABLED,
+                                    &link_status, NX_NO_WAIT) != NX_SUCCESS))
+  {
+    if ((LONG)remaining <= 0)
+    {
+      remaining = MQTT_RECONNECT_INTERVAL;
+      connection_ptr -> retry_time = tx_time_get() + remaining;
+    }
+
+    if (remaining < *wait_option)
+    {
+      *wait_option = remaining;
+    }
+    return;
+  }
+
+  /* Attempt again after the interval if this one fails. */
+  connection_ptr -> retry_time = tx_time_get() + MQTT_RECONNECT_INTERVAL;
+  if (MQTT_RECONNECT_INTERVAL < *wait_option)
+  {
+    *wait_option = MQTT_RECONNECT_INTERVAL;
+  }
+
+  broker_address.nxd_ip_version = 4;
+  ret = dns_resolver_host_get(connection_ptr -> broker_name, &broker_address.nxd_ip_address.v4, DEFAULT_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return;
+  }
+
+  if (connection_ptr -> tls_setup != NX_NULL)
+  {
+    ret = nxd_mqtt_client_secure_connect(client_ptr, &broker_address, connection_ptr -> broker_port,
+                                         connection_ptr -> tls_setup, connection_ptr -> keepalive,
+                                         connection_ptr -> clean_session, NX_NO_WAIT);
+  }
+  else
+  {
+    ret = nxd_mqtt_client_connect(client_ptr, &broker_address, connection_ptr -> broker_port,
+                                  connection_ptr -> keepalive, connection_ptr -> clean_session, NX_NO_WAIT);
+  }
+
+  if ((ret != NXD_MQTT_SUCCESS) && (ret != NX_IN_PROGRESS))
+  {
+    printf("MQTT manager failed to connect to broker < %s >: 0x%x\n", connection_ptr -> broker_name, ret);
+  }
+}
+
+#endif /* MQTT_BACKUP_BROKER_NAME */
@@ -0,0 +1,68 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mqtt_manager.h
+  * @author  MCD Application Team
+  * @brief   Several MQTT broker connections served by one thread
+  *
+  *          Each connection is the state of one created MQTT client, without
+  *          a thread or a stack of its own: the thread of the manager waits
+  *          for the events of all the clients on one event flags group and
+  *          processes those of each client whose flag is set. The clients
+  *          share the packet pool they are created on. The manager also keeps
+  *          the clients given a broker connected, and publishes a message on
+  *          each of them at once, so that a backup broker gets the messages
+  *          while the primary is out of reach as well.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MQTT_MANAGER_H__
+#define __MQTT_MANAGER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct MQTT_MANAGER_CONNECTION_STRUCT
+{
+  NXD_MQTT_CLIENT *client_ptr;     /* Created client, set up before it is added */
+  const CHAR      *broker_name;    /* Broker the manager keeps the client connected to, NX_NULL when the application connects it */
+  UINT             broker_port;
+  UINT           (*tls_setup)(NXD_MQTT_CLIENT *, NX_SECURE_TLS_SESSION *,
+                              NX_SECURE_X509_CERT *, NX_SECURE_X509_CERT *); /* NX_NULL for a plain TCP connection */
+  UINT             keepalive;      /* In seconds */
+  UINT             clean_session;
+  VOID           (*connected_notify)(NXD_MQTT_CLIENT *); /* Called from the thread of the manager once connected, NX_NULL for none */
+
+  /* Kept by the manager */
+  UINT             connected;      /* Last state seen by the thread of the manager */
+  ULONG            retry_time;     /* Tick of the next connection attempt */
+  ULONG            published;      /* Messages taken by the client from mqtt_manager_publish() */
+  ULONG            dropped;        /* Messages it did not take, offline or its connection full */
+} MQTT_MANAGER_CONNECTION;
+
+/* Exported functions prototypes ---------------------------------------------*/
+UINT mqtt_manager_start(VOID);
+UINT mqtt_manager_connection_add(MQTT_MANAGER_CONNECTION *connection_ptr);
+UINT mqtt_manager_connection_remove(MQTT_MANAGER_CONNECTION *connection_ptr);
+UINT mqtt_manager_publish(CHAR *topic_name, UINT topic_name_length, CHAR *message, UINT message_length, UINT qos);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __MQTT_MANAGER_H__ */
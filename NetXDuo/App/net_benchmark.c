@@ -0,0 +1,1019 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    net_benchmark.c
+  * @author  MCD Application Team
+  * @brief   iperf2, echo and packet rate tests of the network stack
+  *
+  *          Once the interface has its address, the board serves, from the
+  *          thread of the demo:
+  *           - an iperf2 TCP server on port 5001, iperf -c <board>,
+  *           - an iperf2 UDP server on port 5001, iperf -c <board> -u, that
+  *             counts the lost and out of order datagrams, measures their
+  *             jitter as RFC 3550 and sends the server report of iperf2 back,
+  *           - a TCP and a UDP echo server on port 7 for the round trip time,
+  *           - a UDP sink on NET_BENCHMARK_PPS_PORT, reporting the datagrams
+  *             received in each second.
+  *          With NET_BENCHMARK_PEER_ADDRESS, it first runs the iperf2 TCP and
+  *          UDP client tests to an iperf -s and iperf -s -u on that host.
+  *          Each test reports, next to its result, what the Ethernet driver,
+  *          the packet pool and the TCP or UDP layer counted meanwhile: frames
+  *          received and sent, frames dropped or missed, failed RX packet
+  *          allocations, empty pool requests, retransmissions and checksum
+  *          errors. Utilities/net_benchmark.py is the host side of the echo and
+  *          packet rate tests.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "net_benchmark.h"
+#include "perf_harness.h"
+#include <string.h>
+
+#ifdef NET_BENCHMARK
+
+/* Private define ------------------------------------------------------------*/
+#define NET_BENCHMARK_IPERF_PORT      5001                  /* Default port of iperf2 */
+#define NET_BENCHMARK_ECHO_PORT       7                     /* Echo protocol, RFC 862 */
+#define NET_BENCHMARK_SOCKET_EVENT    1U
+#define NET_BENCHMARK_POLL_BUDGET     16                    /* Packets taken from a socket before the others */
+#define NET_BENCHMARK_PAYLOAD_SIZE    1472                  /* Largest UDP payload of a 1500 bytes MTU */
+
+/* iperf2 datagrams start with their number, negated in the last ones, and their time of sending.
+   The server report follows this header in the reply to the last ones. */
+#define IPERF_DATAGRAM_HEADER_SIZE    12
+#define IPERF_SERVER_REPORT_SIZE      40
+#define IPERF_HEADER_VERSION1         0x80000000UL
+#define IPERF_FIN_RETRIES             10
+#define IPERF_FIN_WAIT                (NX_IP_PERIODIC_RATE / 4)
+
+#if (NET_BENCHMARK_UDP_LENGTH < (IPERF_DATAGRAM_HEADER_SIZE + IPERF_SERVER_REPORT_SIZE)) || \
+    (NET_BENCHMARK_UDP_LENGTH > NET_BENCHMARK_PAYLOAD_SIZE)
+#error "NET_BENCHMARK_UDP_LENGTH must hold the iperf2 server report and fit in one frame"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct NET_BENCHMARK_COUNTERS_STRUCT
+{
+  /* Ethernet driver */
+  ULONG eth_receive;
+  ULONG eth_transmit;
+  ULONG eth_errors;
+  ULONG eth_allocation_errors;
+
+  /* Packet pool of the tests */
+  ULONG pool_empty_requests;
+
+  ULONG tcp_retransmits;
+  ULONG tcp_checksum_errors;
+  ULONG udp_dropped;
+  ULONG udp_checksum_errors;
+} NET_BENCHMARK_COUNTERS;
+
+typedef struct NET_BENCHMARK_TCP_SERVER_STRUCT
+{
+  NX_TCP_SOCKET socket;
+  const CHAR   *name;
+  UINT          port;
+
+  /* NX_TRUE sends the data received back. */
+  UINT          echo;
+
+  UINT          connected;
+  ULONG64       bytes;
+  ULONG         start_time;
+  ULONG         last_time;
+  NET_BENCHMARK_COUNTERS counters;
+} NET_BENCHMARK_TCP_SERVER;
+
+typedef struct NET_BENCHMARK_IPERF_UDP_STRUCT
+{
+  UINT          active;
+  ULONG         peer_address;
+  UINT          peer_port;
+
+  /* Number of the next datagram expected. */
+  LONG          next_id;
+  ULONG         datagrams;
+  ULONG         lost;
+  ULONG         out_of_order;
+  ULONG64       bytes;
+
+  /* Times in us of the first datagram and of the last one, received and sent. */
+  ULONG64       first_time;
+  ULONG64       last_time;
+  ULONG64       last_sent_time;
+
+  /* 16 times the jitter in us, the running mean of RFC 3550 (A.8). */
+  ULONG         jitter;
+
+  /* Server report of the last test, sent again to the retries of its last datagram. */
+  UINT          report_valid;
+  UCHAR         report[IPERF_SERVER_REPORT_SIZE];
+  NET_BENCHMARK_COUNTERS counters;
+} NET_BENCHMARK_IPERF_UDP;
+
+typedef struct NET_BENCHMARK_PPS_STRUCT
+{
+  ULONG         datagrams;
+  ULONG64       bytes;
+  ULONG         start_time;
+  ULONG         last_time;
+
+  /* Datagrams received since the last report of the rate. */
+  ULONG         interval_datagrams;
+  ULONG         interval_bytes;
+  NET_BENCHMARK_COUNTERS counters;
+} NET_BENCHMARK_PPS;
+
+/* Private variables ---------------------------------------------------------*/
+static NX_IP *benchmark_ip_ptr;
+static NX_PACKET_POOL *benchmark_pool_ptr;
+
+static TX_EVENT_FLAGS_GROUP benchmark_events;
+
+static NET_BENCHMARK_TCP_SERVER benchmark_tcp_iperf;
+static NET_BENCHMARK_TCP_SERVER benchmark_tcp_echo;
+static NX_UDP_SOCKET benchmark_udp_iperf_socket;
+static NX_UDP_SOCKET benchmark_udp_echo_socket;
+static NX_UDP_SOCKET benchmark_udp_pps_socket;
+
+static NET_BENCHMARK_IPERF_UDP benchmark_iperf_udp;
+static NET_BENCHMARK_PPS benchmark_pps;
+
+/* Microseconds clock, the DWT cycles accumulated past the 23 s wrap of the counter. */
+static ULONG64 benchmark_clock_cycles;
+static uint32_t benchmark_clock_last;
+
+static UCHAR benchmark_payload[NET_BENCHMARK_PAYLOAD_SIZE] CCMRAM_BSS;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Read the microseconds clock, it has to be read at least every 23 s.
+* @retval Time in us
+*/
+static ULONG64 benchmark_time_us(VOID)
+{
+  uint32_t now = DWT -> CYCCNT;
+
+  benchmark_clock_cycles += now - benchmark_clock_last;
+  benchmark_clock_last = now;
+
+  return benchmark_clock_cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+* @brief  Read a big endian 32-bit word.
+* @retval Word
+*/
+static ULONG benchmark_read_ulong(const UCHAR *buffer)
+{
+  return ((ULONG)buffer[0] << 24) | ((ULONG)buffer[1] << 16) | ((ULONG)buffer[2] << 8) | (ULONG)buffer[3];
+}
+
+/**
+* @brief  Write a big endian 32-bit word.
+* @retval None
+*/
+static VOID benchmark_write_ulong(UCHAR *buffer, ULONG value)
+{
+  buffer[0] = (UCHAR)(value >> 24);
+  buffer[1] = (UCHAR)(value >> 16);
+  buffer[2] = (UCHAR)(value >> 8);
+  buffer[3] = (UCHAR)value;
+}
+
+/**
+* @brief  Wake the benchmark thread, called from the IP thread on socket events.
+* @retval None
+*/
+static VOID benchmark_tcp_notify(NX_TCP_SOCKET *socket_ptr)
+{
+  NX_PARAMETER_NOT_USED(socket_ptr);
+
+  tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+}
+
+/**
+* @brief  Wake the benchmark thread on a connection request.
+* @retval None
+*/
+static VOID benchmark_tcp_listen_notify(NX_TCP_SOCKET *socket_ptr, UINT port)
+{
+  NX_PARAMETER_NOT_USED(port);
+
+  benchmark_tcp_notify(socket_ptr);
+}
+
+/**
+* @brief  Wake the benchmark thread on a datagram received.
+* @retval None
+*/
+static VOID benchmark_udp_notify(NX_UDP_SOCKET *socket_ptr)
+{
+  NX_PARAMETER_NOT_USED(socket_ptr);
+
+  tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+}
+
+/**
+* @brief  Read the counters of the driver, the packet pool and the transport layers.
+* @param  counters: counters read
+* @retval None
+*/
+static VOID benchmark_counters_get(NET_BENCHMARK_COUNTERS *counters)
+{
+  ULONG unused;
+
+  memset(counters, 0, sizeof(*counters));
+
+  nx_ip_driver_direct_command(benchmark_ip_ptr, NX_LINK_GET_RX_COUNT, &counters -> eth_receive);
+  nx_ip_driver_direct_command(benchmark_ip_ptr, NX_LINK_GET_TX_COUNT, &counters -> eth_transmit);
+  nx_ip_driver_direct_command(benchmark_ip_ptr, NX_LINK_GET_ERROR_COUNT, &counters -> eth_errors);
+  nx_ip_driver_direct_command(benchmark_ip_ptr, NX_LINK_GET_ALLOC_ERRORS, &counters -> eth_allocation_errors);
+
+  nx_packet_pool_info_get(benchmark_pool_ptr, &unused, &unused, &counters -> pool_empty_requests, &unused, &unused);
+
+  nx_tcp_info_get(benchmark_ip_ptr, &unused, &unused, &unused, &unused, &unused, &unused,
+                  &counters -> tcp_checksum_errors, &unused, &unused, &unused, &counters -> tcp_retransmits);
+  nx_udp_info_get(benchmark_ip_ptr, &unused, &unused, &unused, &unused, &unused,
+                  &counters -> udp_dropped, &counters -> udp_checksum_errors);
+}
+
+/**
+* @brief  Report what the counters counted since the start of a test.
+* @param  start: counters read at the start of the test
+* @retval None
+*/
+static VOID benchmark_counters_print(const NET_BENCHMARK_COUNTERS *start)
+{
+  NET_BENCHMARK_COUNTERS now;
+  ULONG total_packets;
+  ULONG free_packets;
+  ULONG unused;
+
+  benchmark_counters_get(&now);
+  nx_packet_pool_info_get(benchmark_pool_ptr, &total_packets, &free_packets, &unused, &unused, &unused);
+
+  printf("  ETH: %lu frames received, %lu sent, %lu dropped or missed, %lu RX allocation failures\n",
+         now.eth_receive - start -> eth_receive, now.eth_transmit - start -> eth_transmit,
+         now.eth_errors - start -> eth_errors, now.eth_allocation_errors - start -> eth_allocation_errors);
+  printf("  pool: %lu/%lu packets free, %lu empty requests; TCP: %lu retransmits, %lu checksum errors; "
+         "UDP: %lu dropped, %lu checksum errors\n",
+         free_packets, total_packets, now.pool_empty_requests - start -> pool_empty_requests,
+         now.tcp_retransmits - start -> tcp_retransmits, now.tcp_checksum_errors - start -> tcp_checksum_errors,
+         now.udp_dropped - start -> udp_dropped, now.udp_checksum_errors - start -> udp_checksum_errors);
+}
+
+/**
+* @brief  Report the rate of a transfer.
+* @param  name: name of the test
+* @param  bytes: bytes transferred
+* @param  ticks: duration of the transfer
+* @retval None
+*/
+static VOID benchmark_rate_print(const CHAR *name, ULONG64 bytes, ULONG ticks)
+{
+  ULONG kbits;
+
+  if (ticks == 0)
+  {
+    ticks = 1;
+  }
+
+  kbits = (ULONG)((bytes * 8U * NX_IP_PERIODIC_RATE) / ((ULONG64)ticks * 1000U));
+
+  printf("%s: %lu bytes in %lu ms, %lu.%02lu Mbit/s\n", name, (unsigned long)bytes,
+         (unsigned long)((ticks * 1000U) / NX_IP_PERIODIC_RATE), kbits / 1000U, (kbits % 1000U) / 10U);
+  perf_harness_result("net", "kbit/s", kbits, PERF_HARNESS_HIGHER, "%s", name);
+}
+
+/**
+* @brief  Create a TCP server and listen for its first connection.
+* @param  server: server to create
+* @param  name: name of the reports
+* @param  port: TCP port
+* @param  echo: NX_TRUE to send the data received back
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_tcp_server_create(NET_BENCHMARK_TCP_SERVER *server, const CHAR *name, UINT port, UINT echo)
+{
+  UINT ret;
+
+  server -> name = name;
+  server -> port = port;
+  server -> echo = echo;
+
+  ret = nx_tcp_socket_create(benchmark_ip_ptr, &server -> socket, (CHAR *)name, NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, NET_BENCHMARK_TCP_WINDOW, NX_NULL, benchmark_tcp_notify);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_receive_notify(&server -> socket, benchmark_tcp_notify);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Listen for the connections of a TCP server.
+* @param  server: server created
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_tcp_server_listen(NET_BENCHMARK_TCP_SERVER *server)
+{
+  UINT ret;
+
+  ret = nx_tcp_server_socket_listen(benchmark_ip_ptr, server -> port, &server -> socket, 1,
+                                    benchmark_tcp_listen_notify);
+
+  /* Not waiting, the connection is established by the IP thread and found by the poll. */
+  if (ret == NX_SUCCESS)
+  {
+    nx_tcp_server_socket_accept(&server -> socket, NX_NO_WAIT);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Serve a TCP connection: take the data received, report and accept the next connection once closed.
+* @param  server: server polled
+* @retval None
+*/
+static VOID benchmark_tcp_server_poll(NET_BENCHMARK_TCP_SERVER *server)
+{
+  NX_PACKET *packet_ptr;
+  ULONG length;
+  UINT budget;
+  UINT ret;
+
+  if (!server -> connected)
+  {
+    if (server -> socket.nx_tcp_socket_state != NX_TCP_ESTABLISHED)
+    {
+      return;
+    }
+
+    server -> connected = NX_TRUE;
+    server -> bytes = 0;
+    server -> start_time = tx_time_get();
+    server -> last_time = server -> start_time;
+    benchmark_counters_get(&server -> counters);
+  }
+
+  for (budget = 0; budget < NET_BENCHMARK_POLL_BUDGET; budget++)
+  {
+    ret = nx_tcp_socket_receive(&server -> socket, &packet_ptr, NX_NO_WAIT);
+    if (ret != NX_SUCCESS)
+    {
+      break;
+    }
+
+    nx_packet_length_get(packet_ptr, &length);
+    server -> bytes += length;
+    server -> last_time = tx_time_get();
+
+    if (!server -> echo || (nx_tcp_socket_send(&server -> socket, packet_ptr, NET_BENCHMARK_TIMEOUT) != NX_SUCCESS))
+    {
+      nx_packet_release(packet_ptr);
+    }
+  }
+
+  if (budget == NET_BENCHMARK_POLL_BUDGET)
+  {
+    /* More data may be queued, come back after the other sockets. */
+    tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+    return;
+  }
+
+  /* The queue is empty, the test is over once the peer has closed its side. */
+  if (server -> socket.nx_tcp_socket_state == NX_TCP_ESTABLISHED)
+  {
+    return;
+  }
+
+  benchmark_rate_print(server -> name, server -> bytes, server -> last_time - server -> start_time);
+  benchmark_counters_print(&server -> counters);
+
+  server -> connected = NX_FALSE;
+  nx_tcp_socket_disconnect(&server -> socket, NET_BENCHMARK_TIMEOUT);
+  nx_tcp_server_socket_unaccept(&server -> socket);
+
+  /* A connection request queued meanwhile is served by the accept. */
+  ret = nx_tcp_server_socket_relisten(benchmark_ip_ptr, server -> port, &server -> socket);
+  if ((ret == NX_SUCCESS) || (ret == NX_CONNECTION_PENDING))
+  {
+    nx_tcp_server_socket_accept(&server -> socket, NX_NO_WAIT);
+  }
+  else
+  {
+    printf("%s: relisten failed: 0x%x\n", server -> name, ret);
+  }
+}
+
+/**
+* @brief  Send the datagrams received on the echo port back to their source.
+* @retval None
+*/
+static VOID benchmark_udp_echo_poll(VOID)
+{
+  NX_PACKET *packet_ptr;
+  ULONG address;
+  UINT port;
+  UINT budget;
+
+  for (budget = 0; budget < NET_BENCHMARK_POLL_BUDGET; budget++)
+  {
+    if (nx_udp_socket_receive(&benchmark_udp_echo_socket, &packet_ptr, NX_NO_WAIT) != NX_SUCCESS)
+    {
+      return;
+    }
+
+    /* The headers of the datagram received leave room for those of the reply. */
+    if ((nx_udp_source_extract(packet_ptr, &address, &port) != NX_SUCCESS) ||
+        (nx_udp_socket_send(&benchmark_udp_echo_socket, packet_ptr, address, port) != NX_SUCCESS))
+    {
+      nx_packet_release(packet_ptr);
+    }
+  }
+
+  tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+}
+
+/**
+* @brief  Encode the iperf2 server report of the UDP test.
+* @param  test: UDP test ended
+* @retval None
+*/
+static VOID benchmark_iperf_udp_report_encode(NET_BENCHMARK_IPERF_UDP *test)
+{
+  ULONG64 duration = test -> last_time - test -> first_time;
+  UCHAR *report = test -> report;
+
+  benchmark_write_ulong(&report[0], IPERF_HEADER_VERSION1);
+  benchmark_write_ulong(&report[4], (ULONG)(test -> bytes >> 32));
+  benchmark_write_ulong(&report[8], (ULONG)test -> bytes);
+  benchmark_write_ulong(&report[12], (ULONG)(duration / 1000000U));
+  benchmark_write_ulong(&report[16], (ULONG)(duration % 1000000U));
+  benchmark_write_ulong(&report[20], test -> lost);
+  benchmark_write_ulong(&report[24], test -> out_of_order);
+  benchmark_write_ulong(&report[28], (ULONG)test -> next_id);
+  benchmark_write_ulong(&report[32], (test -> jitter / 16U) / 1000000U);
+  benchmark_write_ulong(&report[36], (test -> jitter / 16U) % 1000000U);
+
+  test -> report_valid = NX_TRUE;
+}
+
+/**
+* @brief  Account a datagram of the iperf2 UDP test, and answer its last ones with the server report.
+* @param  packet_ptr: datagram received, released or sent back
+* @param  now: time of reception in us
+* @retval None
+*/
+static VOID benchmark_iperf_udp_datagram(NX_PACKET *packet_ptr, ULONG64 now)
+{
+  NET_BENCHMARK_IPERF_UDP *test = &benchmark_iperf_udp;
+  UCHAR header[IPERF_DATAGRAM_HEADER_SIZE];
+  ULONG copied;
+  ULONG length;
+  ULONG address;
+  UINT port;
+  LONG id;
+  ULONG64 sent;
+  LONG transit_change;
+
+  nx_packet_length_get(packet_ptr, &length);
+  if ((nx_packet_data_extract_offset(packet_ptr, 0, header, sizeof(header), &copied) != NX_SUCCESS) ||
+      (copied != sizeof(header)) || (nx_udp_source_extract(packet_ptr, &address, &port) != NX_SUCCESS))
+  {
+    nx_packet_release(packet_ptr);
+    return;
+  }
+
+  id = (LONG)benchmark_read_ulong(&header[0]);
+  sent = ((ULONG64)benchmark_read_ulong(&header[4]) * 1000000U) + benchmark_read_ulong(&header[8]);
+
+  if (id < 0)
+  {
+    /* The client sends its last datagram again until it gets the report. */
+    if (test -> active)
+    {
+      test -> active = NX_FALSE;
+      benchmark_iperf_udp_report_encode(test);
+
+      benchmark_rate_print("iperf UDP server", test -> bytes,
+                           (ULONG)(((test -> last_time - test -> first_time) * NX_IP_PERIODIC_RATE) / 1000000U));
+      printf("  %lu/%lu datagrams lost, %lu out of order, jitter %lu us\n", test -> lost, (ULONG)test -> next_id,
+             test -> out_of_order, test -> jitter / 16U);
+      benchmark_counters_print(&test -> counters);
+    }
+
+    /* The reply is the datagram itself, the report after its header. */
+    if (test -> report_valid && (packet_ptr -> nx_packet_next == NX_NULL) &&
+        (length >= (IPERF_DATAGRAM_HEADER_SIZE + IPERF_SERVER_REPORT_SIZE)))
+    {
+      memcpy(packet_ptr -> nx_packet_prepend_ptr + IPERF_DATAGRAM_HEADER_SIZE, test -> report, IPERF_SERVER_REPORT_SIZE);
+      if (nx_udp_socket_send(&benchmark_udp_iperf_socket, packet_ptr, address, port) == NX_SUCCESS)
+      {
+        return;
+      }
+    }
+
+    nx_packet_release(packet_ptr);
+    return;
+  }
+
+  /* A new test, or a client restarted without ending the previous one. */
+  if (!test -> active || (id == 0) || (address != test -> peer_address) || (port != test -> peer_port))
+  {
+    memset(test, 0, sizeof(*test));
+    test -> active = NX_TRUE;
+    test -> peer_address = address;
+    test -> peer_port = port;
+    test -> first_time = now;
+    benchmark_counters_get(&test -> counters);
+  }
+  else
+  {
+    /* Change of the transit time from the previous datagram, the two clocks need not agree. */
+    transit_change = (LONG)((now - test -> last_time) - (sent - test -> last_sent_time));
+    if (transit_change < 0)
+    {
+      transit_change = -transit_change;
+    }
+    test -> jitter += (ULONG)transit_change - ((test -> jitter + 8U) / 16U);
+  }
+
+  if (id >= test -> next_id)
+  {
+    test -> lost += (ULONG)(id - test -> next_id);
+    test -> next_id = id + 1;
+  }
+  else
+  {
+    /* Counted as lost when the datagrams after it came. */
+    test -> out_of_order++;
+    if (test -> lost)
+    {
+      test -> lost--;
+    }
+  }
+
+  test -> datagrams++;
+  test -> bytes += length;
+  test -> last_time = now;
+  test -> last_sent_time = sent;
+
+  nx_packet_release(packet_ptr);
+}
+
+/**
+* @brief  Take the datagrams of the iperf2 UDP test.
+* @retval None
+*/
+static VOID benchmark_iperf_udp_poll(VOID)
+{
+  NX_PACKET *packet_ptr;
+  UINT budget;
+
+  for (budget = 0; budget < NET_BENCHMARK_POLL_BUDGET; budget++)
+  {
+    if (nx_udp_socket_receive(&benchmark_udp_iperf_socket, &packet_ptr, NX_NO_WAIT) != NX_SUCCESS)
+    {
+      return;
+    }
+
+    benchmark_iperf_udp_datagram(packet_ptr, benchmark_time_us());
+  }
+
+  tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+}
+
+/**
+* @brief  Count the datagrams of the packet rate test.
+* @retval None
+*/
+static VOID benchmark_pps_poll(VOID)
+{
+  static NX_UDP_DATAGRAM datagrams[NET_BENCHMARK_POLL_BUDGET];
+  NET_BENCHMARK_PPS *test = &benchmark_pps;
+  NX_PACKET *packet_ptr;
+  ULONG length;
+  UINT count;
+  UINT index;
+
+  /* Take the whole budget of the socket in one call */
+  if (nx_udp_socket_receive_batch(&benchmark_udp_pps_socket, datagrams, NET_BENCHMARK_POLL_BUDGET,
+                                  &count, NX_NO_WAIT) != NX_SUCCESS)
+  {
+    return;
+  }
+
+  for (index = 0; index < count; index++)
+  {
+    packet_ptr = datagrams[index].nx_udp_datagram_packet_ptr;
+
+    if (test -> datagrams == 0)
+    {
+      test -> start_time = tx_time_get();
+      benchmark_counters_get(&test -> counters);
+    }
+
+    nx_packet_length_get(packet_ptr, &length);
+    nx_packet_release(packet_ptr);
+
+    test -> datagrams++;
+    test -> bytes += length;
+    test -> interval_datagrams++;
+    test -> interval_bytes += length;
+    test -> last_time = tx_time_get();
+  }
+
+  /* Datagrams may be left once the budget is spent */
+  if (count == NET_BENCHMARK_POLL_BUDGET)
+  {
+    tx_event_flags_set(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR);
+  }
+}
+
+/**
+* @brief  Report the packet rate of the last second, and the whole test once the datagrams stop.
+* @retval None
+*/
+static VOID benchmark_pps_report(VOID)
+{
+  NET_BENCHMARK_PPS *test = &benchmark_pps;
+  ULONG ticks;
+
+  if (test -> interval_datagrams != 0)
+  {
+    printf("PPS: %lu datagrams/s, %lu kbit/s\n", test -> interval_datagrams,
+           (test -> interval_bytes * 8U) / 1000U);
+    test -> interval_datagrams = 0;
+    test -> interval_bytes = 0;
+    return;
+  }
+
+  if (test -> datagrams == 0)
+  {
+    return;
+  }
+
+  ticks = test -> last_time - test -> start_time;
+  if (ticks == 0)
+  {
+    ticks = 1;
+  }
+
+  printf("PPS test: %lu datagrams in %lu ms, %lu datagrams/s\n", test -> datagrams,
+         (unsigned long)((ticks * 1000U) / NX_IP_PERIODIC_RATE),
+         (unsigned long)(((ULONG64)test -> datagrams * NX_IP_PERIODIC_RATE) / ticks));
+  benchmark_counters_print(&test -> counters);
+
+  memset(test, 0, sizeof(*test));
+}
+
+/**
+* @brief  Run the iperf2 TCP client test to the peer.
+* @param  peer: address of the iperf -s host
+* @retval None
+*/
+static VOID benchmark_tcp_client_run(ULONG peer)
+{
+  NX_TCP_SOCKET *socket_ptr = &benchmark_tcp_iperf.socket;
+  NET_BENCHMARK_COUNTERS counters;
+  NX_PACKET *packet_ptr;
+  ULONG64 bytes = 0;
+  ULONG start_time;
+  ULONG mss;
+  UINT ret;
+
+  ret = nx_tcp_client_socket_bind(socket_ptr, NX_ANY_PORT, NET_BENCHMARK_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    printf("iperf TCP client: bind failed: 0x%x\n", ret);
+    return;
+  }
+
+  ret = nx_tcp_client_socket_connect(socket_ptr, peer, NET_BENCHMARK_IPERF_PORT, NET_BENCHMARK_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    printf("iperf TCP client: connect failed: 0x%x\n", ret);
+    nx_tcp_client_socket_unbind(socket_ptr);
+    return;
+  }
+
+  /* Full segments of zeros, the iperf2 server takes the first bytes as a header without options. */
+  nx_tcp_socket_mss_get(socket_ptr, &mss);
+  if (mss > sizeof(benchmark_payload))
+  {
+    mss = sizeof(benchmark_payload);
+  }
+  memset(benchmark_payload, 0, sizeof(benchmark_payload));
+
+  benchmark_counters_get(&counters);
+  start_time = tx_time_get();
+
+  while ((tx_time_get() - start_time) < NET_BENCHMARK_DURATION)
+  {
+    ret = nx_packet_allocate(benchmark_pool_ptr, &packet_ptr, NX_TCP_PACKET, NET_BENCHMARK_TIMEOUT);
+    if (ret != NX_SUCCESS)
+    {
+      break;
+    }
+
+    ret = nx_packet_data_append(packet_ptr, benchmark_payload, mss, benchmark_pool_ptr, NET_BENCHMARK_TIMEOUT);
+    if (ret == NX_SUCCESS)
+    {
+      ret = nx_tcp_socket_send(socket_ptr, packet_ptr, NET_BENCHMARK_TIMEOUT);
+    }
+
+    if (ret != NX_SUCCESS)
+    {
+      nx_packet_release(packet_ptr);
+      break;
+    }
+
+    bytes += mss;
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    printf("iperf TCP client: send failed: 0x%x\n", ret);
+  }
+
+  /* The rate counts the data acknowledged, the disconnection waits for it. */
+  nx_tcp_socket_disconnect(socket_ptr, NET_BENCHMARK_TIMEOUT);
+  benchmark_rate_print("iperf TCP client", bytes, tx_time_get() - start_time);
+  benchmark_counters_print(&counters);
+
+  nx_tcp_client_socket_unbind(socket_ptr);
+}
+
+/**
+* @brief  Send a datagram of the iperf2 UDP client test.
+* @param  peer: address of the iperf -s -u host
+* @param  id: number of the datagram, negated for the last ones
+* @param  now: time of sending in us
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_udp_client_send(ULONG peer, LONG id, ULONG64 now)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  benchmark_write_ulong(&benchmark_payload[0], (ULONG)id);
+  benchmark_write_ulong(&benchmark_payload[4], (ULONG)(now / 1000000U));
+  benchmark_write_ulong(&benchmark_payload[8], (ULONG)(now % 1000000U));
+
+  ret = nx_packet_allocate(benchmark_pool_ptr, &packet_ptr, NX_UDP_PACKET, NET_BENCHMARK_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, benchmark_payload, NET_BENCHMARK_UDP_LENGTH, benchmark_pool_ptr,
+                              NET_BENCHMARK_TIMEOUT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_send(&benchmark_udp_iperf_socket, packet_ptr, peer, NET_BENCHMARK_IPERF_PORT);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Run the iperf2 UDP client test to the peer at NET_BENCHMARK_UDP_RATE, and print the server report.
+* @param  peer: address of the iperf -s -u host
+* @retval None
+*/
+static VOID benchmark_udp_client_run(ULONG peer)
+{
+  NET_BENCHMARK_COUNTERS counters;
+  UCHAR report[IPERF_DATAGRAM_HEADER_SIZE + IPERF_SERVER_REPORT_SIZE];
+  NX_PACKET *packet_ptr;
+  ULONG64 interval = ((ULONG64)NET_BENCHMARK_UDP_LENGTH * 8U * 1000000U) / NET_BENCHMARK_UDP_RATE;
+  ULONG64 tick = 1000000U / NX_IP_PERIODIC_RATE;
+  ULONG64 start;
+  ULONG64 next;
+  ULONG64 now;
+  ULONG copied;
+  LONG id = 0;
+  ULONG failures = 0;
+  UINT retry;
+
+  memset(benchmark_payload, 0, sizeof(benchmark_payload));
+  benchmark_counters_get(&counters);
+
+  start = benchmark_time_us();
+  next = start;
+
+  /* The datagrams due are sent at each tick, in bursts above the tick rate. */
+  while (((now = benchmark_time_us()) - start) < (((ULONG64)NET_BENCHMARK_DURATION * 1000000U) / NX_IP_PERIODIC_RATE))
+  {
+    if (now < next)
+    {
+      tx_thread_sleep((next - now + tick - 1) / tick);
+      continue;
+    }
+
+    if (benchmark_udp_client_send(peer, id, now) != NX_SUCCESS)
+    {
+      failures++;
+    }
+
+    id++;
+    next += interval;
+  }
+
+  printf("iperf UDP client: %lu datagrams of %u bytes sent, %lu failed\n", (ULONG)id,
+         (UINT)NET_BENCHMARK_UDP_LENGTH, failures);
+
+  for (retry = 0; retry < IPERF_FIN_RETRIES; retry++)
+  {
+    benchmark_udp_client_send(peer, -id, benchmark_time_us());
+
+    if (nx_udp_socket_receive(&benchmark_udp_iperf_socket, &packet_ptr, IPERF_FIN_WAIT) != NX_SUCCESS)
+    {
+      continue;
+    }
+
+    nx_packet_data_extract_offset(packet_ptr, 0, report, sizeof(report), &copied);
+    nx_packet_release(packet_ptr);
+
+    if ((copied == sizeof(report)) &&
+        (benchmark_read_ulong(&report[IPERF_DATAGRAM_HEADER_SIZE]) & IPERF_HEADER_VERSION1))
+    {
+      const UCHAR *server = &report[IPERF_DATAGRAM_HEADER_SIZE];
+      ULONG64 bytes = ((ULONG64)benchmark_read_ulong(&server[4]) << 32) | benchmark_read_ulong(&server[8]);
+      ULONG64 duration = ((ULONG64)benchmark_read_ulong(&server[12]) * 1000000U) + benchmark_read_ulong(&server[16]);
+
+      benchmark_rate_print("iperf UDP client, server report", bytes,
+                           (ULONG)((duration * NX_IP_PERIODIC_RATE) / 1000000U));
+      printf("  %lu/%lu datagrams lost, %lu out of order, jitter %lu us\n", benchmark_read_ulong(&server[20]),
+             benchmark_read_ulong(&server[28]), benchmark_read_ulong(&server[24]),
+             (benchmark_read_ulong(&server[32]) * 1000000U) + benchmark_read_ulong(&server[36]));
+      break;
+    }
+  }
+
+  if (retry == IPERF_FIN_RETRIES)
+  {
+    printf("iperf UDP client: no server report\n");
+  }
+
+  benchmark_counters_print(&counters);
+}
+
+/**
+* @brief  Create and bind a UDP socket that wakes the benchmark thread.
+* @param  socket_ptr: socket to create
+* @param  name: name of the socket
+* @param  port: UDP port
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_udp_socket_create(NX_UDP_SOCKET *socket_ptr, CHAR *name, UINT port)
+{
+  UINT ret;
+
+  ret = nx_udp_socket_create(benchmark_ip_ptr, socket_ptr, name, NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, NET_BENCHMARK_UDP_QUEUE);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_bind(socket_ptr, port, TX_NO_WAIT);
+  }
+
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_receive_notify(socket_ptr, benchmark_udp_notify);
+  }
+
+  return ret;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Run the client tests, then serve the tests of the host forever.
+* @param  ip_ptr: IP instance, its address resolved
+* @param  pool_ptr: packet pool of the packets sent
+* @retval Error of the setup, the tests do not end; NX_SUCCESS after the client tests in the
+*         performance harness, the host does not drive it
+*/
+UINT net_benchmark_run(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  UINT ret;
+  ULONG address;
+  ULONG mask;
+  ULONG events;
+  ULONG report_time;
+  ULONG now;
+
+  benchmark_ip_ptr = ip_ptr;
+  benchmark_pool_ptr = pool_ptr;
+
+  /* Start the cycle counter. */
+  CoreDebug -> DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT -> CYCCNT = 0;
+  DWT -> CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  benchmark_clock_last = DWT -> CYCCNT;
+
+  ret = tx_event_flags_create(&benchmark_events, "Net benchmark events");
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = benchmark_tcp_server_create(&benchmark_tcp_iperf, "iperf TCP server", NET_BENCHMARK_IPERF_PORT, NX_FALSE);
+  if (ret == NX_SUCCESS)
+  {
+    ret = benchmark_tcp_server_create(&benchmark_tcp_echo, "TCP echo", NET_BENCHMARK_ECHO_PORT, NX_TRUE);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = benchmark_udp_socket_create(&benchmark_udp_iperf_socket, "iperf UDP", NET_BENCHMARK_IPERF_PORT);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = benchmark_udp_socket_create(&benchmark_udp_echo_socket, "UDP echo", NET_BENCHMARK_ECHO_PORT);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = benchmark_udp_socket_create(&benchmark_udp_pps_socket, "UDP PPS", NET_BENCHMARK_PPS_PORT);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  nx_ip_address_get(ip_ptr, &address, &mask);
+  printf("Network benchmark on %lu.%lu.%lu.%lu, CPU at %lu MHz\n", (address >> 24) & 0xFF, (address >> 16) & 0xFF,
+         (address >> 8) & 0xFF, address & 0xFF, (unsigned long)(SystemCoreClock / 1000000U));
+
+  /* The client tests use the sockets of the servers before they serve. */
+  if (NET_BENCHMARK_PEER_ADDRESS != NULL_ADDRESS)
+  {
+    benchmark_tcp_client_run(NET_BENCHMARK_PEER_ADDRESS);
+    benchmark_udp_client_run(NET_BENCHMARK_PEER_ADDRESS);
+  }
+
+#ifdef PERF_HARNESS
+  return NX_SUCCESS;
+#endif
+
+  ret = benchmark_tcp_server_listen(&benchmark_tcp_iperf);
+  if (ret == NX_SUCCESS)
+  {
+    ret = benchmark_tcp_server_listen(&benchmark_tcp_echo);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  printf("Serving iperf2 TCP and UDP on %u, TCP and UDP echo on %u, UDP PPS on %u\n",
+         (UINT)NET_BENCHMARK_IPERF_PORT, (UINT)NET_BENCHMARK_ECHO_PORT, (UINT)NET_BENCHMARK_PPS_PORT);
+
+  report_time = tx_time_get() + NX_IP_PERIODIC_RATE;
+
+  for (;;)
+  {
+    /* Woken by the sockets, and each second for the packet rate and the microseconds clock. */
+    now = tx_time_get();
+    if ((LONG)(report_time - now) <= 0)
+    {
+      benchmark_pps_report();
+      report_time += NX_IP_PERIODIC_RATE;
+      continue;
+    }
+
+    tx_event_flags_get(&benchmark_events, NET_BENCHMARK_SOCKET_EVENT, TX_OR_CLEAR, &events, report_time - now);
+    benchmark_time_us();
+
+    /* The echoes first, their round trip is the measure. */
+    benchmark_udp_echo_poll();
+    benchmark_tcp_server_poll(&benchmark_tcp_echo);
+    benchmark_iperf_udp_poll();
+    benchmark_pps_poll();
+    benchmark_tcp_server_poll(&benchmark_tcp_iperf);
+  }
+}
+
+#endif /* NET_BENCHMARK */
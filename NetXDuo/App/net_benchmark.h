@@ -0,0 +1,39 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    net_benchmark.h
+  * @author  MCD Application Team
+  * @brief   iperf2, echo and packet rate tests of the network stack
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __NET_BENCHMARK_H__
+#define __NET_BENCHMARK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Serves the tests configured in app_netxduo.h and reports them over the UART,
+   once the interface has its address. Only returns on a setup failure. */
+UINT net_benchmark_run(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NET_BENCHMARK_H__ */
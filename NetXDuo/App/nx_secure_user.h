@@ -343,6 +343,12 @@
 #define NX_SECURE_X509_DISABLE_CRL
 */
 
+/* Defines the bits of the Bloom filter of a CRL index, tested before its sorted serial numbers.
+   The default value is 0, no filter. */
+/*
+#define NX_SECURE_X509_CRL_INDEX_BLOOM_BITS              0
+*/
+
 /* This macro must be defined to enable DTLS logic in NetX Secure. */
 /*
 #define NX_SECURE_ENABLE_DTLS
@@ -102,6 +102,19 @@
 #define NX_DRIVER_DEFERRED_PROCESSING
 */
 
+/* Defined, the events of the IP helper thread are posted to a pending word
+   and the thread is woken with a semaphore, only by the first event posted
+   since it last picked them up, instead of through an event flags group.
+   The Ethernet driver posts one on each RX and TX interrupt. */
+#define NX_ENABLE_IP_EVENT_SEMAPHORE
+
+/* This define specifies the number of packets the IP helper thread processes
+   from a deferred receive queue before it serves its other events. The
+   default value is 16. */
+/*
+#define NX_IP_THREAD_PACKET_BUDGET                  16
+*/
+
 /* Defined, the source address of incoming packet is checked. The default is
    disabled. */
 /*
@@ -145,7 +158,11 @@
 */
 
 /* Defined, NetX Duo is built with NAT process. By default this option is not
-   defined. */
+   defined. It is left undefined in the gateway profile as well: the NAT addon
+   is not part of this tree, and with the single interface of the board,
+   NX_MAX_PHYSICAL_INTERFACES 1, there is no second network to translate to.
+   The sensors reach the broker through GATEWAY_ROUTER_ADDRESS. Defined alone,
+   it only adds the test of the NAT hooks to each IPv4 packet received. */
 /*
 #define NX_NAT_ENABLE
 */
@@ -153,9 +170,7 @@
 /* Defined, allows the stack to use two packet pools, one with large payload
    size and one with smaller payload size. By default this option is not
    enabled. */
-/*
 #define NX_ENABLE_DUAL_PACKET_POOL
-*/
 
 /*****************************************************************************/
 /***************** Configuration options for Packet **************************/
@@ -182,14 +197,32 @@
 #define NX_DISABLE_PACKET_INFO
 */
 
+/* Defined, adds NX_PACKET_HEADER_PAD_SIZE ULONG words to the packet header.
+   The Ethernet driver stores the receive time stamps of the frames there
+   when NX_DRIVER_ENABLE_PTP is defined, and needs 2 words. */
+/*
+#define NX_PACKET_HEADER_PAD
+#define NX_PACKET_HEADER_PAD_SIZE         2
+*/
+
 /* Defined, enables NetX Duo packet pool low watermark feature. Application
    sets low watermark value. On receiving TCP packets, if the packet pool
    low watermark is reached, NetX Duo silently discards the packet by releasing
    it, preventing the packet pool from starvation. By default this feature is
    not enabled. */
-/*
 #define NX_ENABLE_LOW_WATERMARK
-*/
+
+/* Defined, enables packet pool statistics: the lowest free count, allocation
+   failures per caller class, time blocked in allocation and the chain length
+   histogram of released packets, retrieved by nx_packet_pool_stats_get. */
+#define NX_ENABLE_PACKET_POOL_STATISTICS
+
+/* Defines the copy between packets and buffers of nx_packet_data_append(),
+   nx_packet_copy(), nx_packet_data_extract_offset() and nx_packet_data_retrieve():
+   dma_copy() hands the copies of 1 KB or more to the memory-to-memory stream of
+   DMA2 and lets the other threads run meanwhile, see dma_copy.h. The default is
+   memcpy. */
+#define NX_PACKET_DATA_COPY               dma_copy
 
 /*****************************************************************************/
 /************* Configuration options for Neighbor Cache **********************/
@@ -225,11 +258,20 @@
 #define NX_IPV6_DAD_TRANSMITS               3
 */
 
+/* Defined, the link local address built from the MAC address and the
+   addresses from Stateless Address Auto Configuration are optimistic
+   (RFC 4429): they send and receive at once while DAD runs, advertise no
+   link layer address that would override a neighbor cache, and are removed
+   on DAD failure as tentative addresses are. The first router solicitation
+   goes out without waiting for the link local address to be validated.
+   By default, this option is disabled. */
+#define NX_IPV6_OPTIMISTIC_DAD
+
 /* Specifies the number of entries in the IPv6 Neighbor Cache table. Defined
-   in nx_nd_cache.h, the default value is 16. */
-/*
-#define NX_IPV6_NEIGHBOR_CACHE_SIZE         16
-*/
+   in nx_nd_cache.h, the default value is 16. The table is hashed by address,
+   it is sized for the dozens of neighbors of a plant network, IPv6 being in
+   the dual stack build only. */
+#define NX_IPV6_NEIGHBOR_CACHE_SIZE         32
 
 /* Specifies the delay in seconds before the first solicitation is sent out for
    a cache entry in the STALE state. Defined in nx_nd_cache.h, the default
@@ -313,6 +355,16 @@
 #define NX_ENABLE_IP_STATIC_ROUTING
 */
 
+/* Defined, each UDP socket caches the interface and the next hop of the last
+   IPv4 destination it sent to, and uses them again for the next packet to the
+   same destination until the addresses, the gateway or the static routes of the
+   IP instance change. By default this feature is not enabled.
+   With the IPv4 and UDP checksums offloaded to the MAC, see
+   NX_ENABLE_INTERFACE_CAPABILITY, a socket sending to one peer, such as the DTLS
+   telemetry socket, then only fills in the UDP and IP header words and finds
+   the peer in the hashed ARP table for each datagram. */
+#define NX_ENABLE_UDP_ROUTE_CACHE
+
 /* This define specifies the maximum time of IP reassembly.  The default value
    is 60. By default this option is not defined.  */
 /*
@@ -391,8 +443,11 @@
 
 /* Disables IPv6 functionality when the NetX Duo library is built.
    For applications that do not need IPv6, this avoids pulling in code and
-   additional storage space needed to support IPv6. */
+   additional storage space needed to support IPv6. The dual stack build,
+   MQTT_DUAL_STACK, keeps it. */
+#ifndef MQTT_DUAL_STACK
 #define NX_DISABLE_IPV6
+#endif
 
 /* Defined, enable IPV6 features. */
 /*
@@ -448,9 +503,18 @@
 /* Specifies the number of entries in the IPv6 destination table. This stores
    information about next hop addresses for IPv6 addresses. Defined in nx_api.h,
    the default value is 8. */
-/*
-#define NX_IPV6_DESTINATION_TABLE_SIZE          8
-*/
+#define NX_IPV6_DESTINATION_TABLE_SIZE          32
+
+/* Defined, an IPv6 destination is added at a slot hashed from its address, as
+   in the Neighbor Cache, and looked up from that slot, so a lookup does not
+   walk the table before finding it. By default this feature is not enabled. */
+#define NX_ENABLE_IPV6_DESTINATION_HASH
+
+/* Defined, a full IPv6 destination table reuses the entry looked up least
+   recently for a new destination. Otherwise the packet to the new destination
+   is dropped until an entry is freed, which only happens when its neighbor
+   cache entry is deleted. By default this feature is not enabled. */
+#define NX_ENABLE_IPV6_DESTINATION_LRU
 
 /* Specifies the size of the prefix table. Prefix information is obtained from
    router advertisements and is part of the IPv6 address configuration. Defined
@@ -599,6 +663,15 @@
 #define NX_TCP_FAST_TIMER_RATE            10
 */
 
+/* Defined, the fast TCP timer is stopped while no socket has a retransmit,
+   connect, FIN or zero window probe timeout or a delayed ACK pending, and
+   restarted by the next received segment or armed timeout. An idle connection
+   then leaves the processor asleep until the IP periodic timer, or the next
+   application timer, instead of waking it every fast timer period. With IPv6
+   the ND cache keeps the timer running. By default this feature is not
+   enabled. */
+#define NX_ENABLE_TCP_FAST_TIMER_IDLE
+
 /* Specifies how the number of system ticks (NX_IP_PERIODIC_RATE) is divided to
    calculate the timer rate for the TCP transmit retry processing.
    The default value is 1, which represents 1 second, and is defined in nx_tcp.h.
@@ -685,9 +758,7 @@
    times as long. The default value is 0 and is defined in nx_tcp.h.
    The application can override the default by defining the value before nx_api.h
    is included. */
-/*
-#define NX_TCP_RETRY_SHIFT                0x0
-*/
+#define NX_TCP_RETRY_SHIFT                0x1
 
 /* Specifies how many keepalive retries are allowed before the connection is
    deemed broken. The default value is 10, which represents 10 retries, and is
@@ -705,6 +776,88 @@
 #define NX_ENABLE_TCP_WINDOW_SCALING
 */
 
+/* Defined, the TCP receive window advertised to the peer is capped by the
+   free packets, above the low watermark, of the pool its segments are received
+   in, one MSS each. The peer then stops sending before the pool runs out,
+   instead of having its segments dropped and retransmitted. By default this
+   feature is not enabled. */
+#define NX_ENABLE_TCP_RX_WINDOW_POOL_LIMIT
+
+/* Defined, enables the TCP selective acknowledgement (SACK) option of RFC 2018.
+   The receiver reports the out of order segments it holds, and in fast recovery
+   the sender retransmits only the holes between the ranges the peer reported,
+   one per duplicate ACK. By default this feature is not enabled. */
+#define NX_ENABLE_TCP_SACK
+
+/* Defined, the contiguous TCP segments received out of order are merged into
+   one entry of the socket receive queue, a packet chain, and the data of a
+   segment that fits in the room left in the last packet is copied there and
+   its packet released. An entry then stands for a range of sequence numbers:
+   the out of order limit and the queue depth count ranges, and an insertion
+   walks the ranges, the last one checked first. Requires packet chaining.
+   By default this feature is not enabled. */
+#define NX_ENABLE_TCP_RX_SEGMENT_MERGE
+
+/* Defined, enables the per socket ACK policy set by nx_tcp_socket_ack_policy_set.
+   The first segments of a connection and the small segments with the PSH bit are
+   acknowledged immediately, the others wait for the delayed ACK timer, and their
+   ACK is carried by the data sent in reply before it expires. By default this
+   feature is not enabled. */
+#define NX_ENABLE_TCP_QUICKACK
+
+/* Defined, derives the TCP retransmit timeout of each connection from its
+   measured round trip time and variation as described in RFC 6298, instead of
+   using the fixed timeout of nx_tcp_socket_transmit_configure, which becomes
+   the initial timeout. Retransmitted segments are not timed, per Karn's
+   algorithm. Exponential backoff also needs NX_TCP_RETRY_SHIFT set to 1.
+   By default this feature is not enabled. */
+#define NX_ENABLE_TCP_RTO_ESTIMATION
+
+/* Defined, coalesces the small TCP sends as described in RFC 896 (Nagle).
+   While data sent is waiting to be acknowledged, the data of the sends smaller
+   than the MSS is appended to one packet held by the socket, which is sent once
+   it reaches the MSS or once everything outstanding is acknowledged. The
+   packets of the appended sends are released right away. By default this
+   feature is not enabled. */
+#define NX_ENABLE_TCP_SEND_COALESCE
+
+/* Defined, nx_tcp_socket_send_notify_set is available. On a socket with a send
+   notify set, a send that would suspend, or that comes while earlier such sends
+   are still queued, is queued on the socket instead and returns NX_IN_PROGRESS.
+   The queued packets are sent from the IP thread as ACKs open the window, and
+   the notify is called from the IP thread once they are all sent, so it must
+   not block. By default this feature is not enabled. */
+#define NX_ENABLE_TCP_SEND_ASYNC
+
+/* Specifies how the number of system ticks (NX_IP_PERIODIC_RATE) is divided
+   to calculate the minimum retransmit timeout derived from the round trip time
+   when NX_ENABLE_TCP_RTO_ESTIMATION is defined. The default value is 1, which
+   represents 1 second as recommended by RFC 6298, and is defined in nx_tcp.h.
+   The value 5 allows 200ms on a local network. */
+#define NX_TCP_RTO_MINIMUM_RATE           5
+
+/* Specifies the maximum retransmit timeout in seconds derived from the round
+   trip time when NX_ENABLE_TCP_RTO_ESTIMATION is defined. The default value
+   is 60, and is defined in nx_tcp.h. */
+/*
+#define NX_TCP_RTO_MAXIMUM                60
+*/
+
+/* Defined, indexes the connected TCP sockets in a table hashed by their local
+   port, peer port and peer address, and looks up the connection of a segment
+   there, starting with the connection found last. Otherwise all the sockets
+   bound to the local port are searched, which grows with the number of
+   connections accepted on a server port. By default this feature is not
+   enabled. */
+#define NX_ENABLE_TCP_CONNECTION_TABLE
+
+/* Specifies the number of entries of the TCP connection table when
+   NX_ENABLE_TCP_CONNECTION_TABLE is defined. The value must be a power of two.
+   The default value is 32 and is defined in nx_api.h. */
+/*
+#define NX_TCP_CONNECTION_TABLE_SIZE      32
+*/
+
 /* Defined, disables the reset processing during disconnect when the timeout
    value supplied is specified as NX_NO_WAIT. */
 /*
@@ -852,6 +1005,14 @@
 #define NX_ARP_DEFEND_INTERVAL          10
 */
 
+/* Defined, moves a dynamic ARP entry to the front of the ARP cache each time a
+   packet is sent through it, so new entries reuse the least recently used
+   entries. Otherwise the least recently added entry is reused, which can be the
+   gateway entry when other hosts keep adding entries, and the next packet to the
+   gateway then waits for ARP resolution. By default this feature is not
+   enabled. */
+#define NX_ENABLE_ARP_ENTRY_LRU
+
 /* Defined, disables entering ARP request information in the ARP cache. */
 /*
 #define NX_DISABLE_ARP_AUTO_ENTRY
@@ -980,6 +1141,12 @@
 #define NX_DHCP_CLIENT_SEND_MAX_DHCP_MESSAGE_OPTION
 */
 
+/* Defined, this enables the DHCP Client to send the rapid commit option in
+   the discover message and to take an ACK to it for the offer, two messages
+   to the address instead of four when the server supports it. By default,
+   this option is disabled. */
+#define NX_DHCP_CLIENT_ENABLE_RAPID_COMMIT
+
 /* Defined, this enables the DHCP Client to check the input host name in the
    nx_dhcp_create call for invalid characters or length. By default, this
    option is disabled. */
@@ -1094,17 +1261,25 @@
 */
 
 /* This is size of the DHCP Server array for holding available IP addresses for
-   assigning to the Client. The default value is 20. */
-/*
-#define NX_DHCP_IP_ADDRESS_MAX_LIST_SIZE        20
-*/
+   assigning to the Client. The default value is 20. Sized for the sensors of
+   the gateway profile, see GATEWAY_DHCP_SERVER in app_netxduo.h. */
+#define NX_DHCP_IP_ADDRESS_MAX_LIST_SIZE        16
 
 /* This is size of the DHCP Server array for holding Client records.
    The default value is 50. */
+#define NX_DHCP_CLIENT_RECORD_TABLE_SIZE        16
+
+/* This is the number of hash chains of the DHCP Server Client records, looked
+   up by hardware address at each Client message. Must be a power of 2.
+   The default value is 16. */
 /*
-#define NX_DHCP_CLIENT_RECORD_TABLE_SIZE        50
+#define NX_DHCP_CLIENT_RECORD_INDEX_SIZE        16
 */
 
+/* Defined, the DHCP Server answers a DISCOVER carrying the Rapid Commit option
+   with an ACK: the Client is bound in a single exchange (RFC 4039). */
+#define NX_DHCP_SERVER_ENABLE_RAPID_COMMIT
+
 /* This is size of the array in the DHCP Client instance for holding the all
    the requested options in the parameter request list in the current session.
    The default value is 12. */
@@ -1493,9 +1668,7 @@
 */
 
 /* This enables the DNS Client to store the answer records into DNS cache. */
-/*
 #define NX_DNS_CACHE_ENABLE
-*/
 
 /* This sets the timeout option for allocating a packet from the DNS client
    packet pool. The default value is 1 second (1*NX_IP_PERIODIC_RATE). */
@@ -1509,6 +1682,67 @@
 #define NX_DNS_MAX_RETRANS_TIMEOUT             (64 * NX_IP_PERIODIC_RATE)
 */
 
+/*****************************************************************************/
+/******************** Configuration options for Crypto ***********************/
+/*****************************************************************************/
+
+/* Defines the random number generator of NetX, and of the crypto library through
+   NX_CRYPTO_RAND: the words of the RNG peripheral collected by rng_pool.c. The
+   default is rand() of the C library, which is neither seeded nor unpredictable. */
+#define NX_RAND                                 rng_pool_get
+
+/* Defines the function filling a buffer with random bytes in one call, used for the
+   random numbers of the public key operations and the DRBG entropy: rng_pool_fill()
+   copies the words of the pool at once, with interrupts disabled only once. */
+#define NX_RAND_BYTES                           rng_pool_fill
+
+/* Defines the number of bytes the CTR-DRBG of _nx_crypto_drbg() generates at a time
+   and serves the small requests from, with prediction resistance disabled only
+   (NX_CRYPTO_DRBG_PREDICTION_RESISTANCE 0). That DRBG is NX_CRYPTO_RBG in the
+   NX_CRYPTO_SELF_TEST builds only; the other builds take the random numbers of the
+   public key operations from NX_RAND_BYTES. The default value is 0, no buffer.  */
+/*
+#define NX_CRYPTO_DRBG_OUTPUT_BUFFER_LEN        256
+*/
+
+/* Defined, the AES lookup tables are copied to RAM at startup instead of being
+   read from the flash, whose wait states slow down their random accesses. */
+#define NX_CRYPTO_AES_USE_RAM_TABLES
+
+/* Defines the section of the AES lookup tables in RAM. The CCM-RAM section of
+   the linker script has no wait state and is off the bus matrix shared with the
+   Ethernet DMA. */
+#define NX_CRYPTO_AES_TABLE_SECTION             __attribute__((section(".ccmram")))
+
+/* Defines the number of bits of a block the GCM hash multiplies at a time. With 8,
+   the table of each key is 4 KB instead of 256 bytes. Each TLS session has two keys
+   in its crypto metadata, see CRYPTO_METADATA_CLIENT_SIZE in app_netxduo.h. The
+   default value is 4.  */
+/*
+#define NX_CRYPTO_GCM_TABLE_BITS                8
+*/
+
+/* Defines the window, in bits, of the modular exponentiation of RSA and DH with
+   exponents longer than 64 bits. A window of w bits keeps 2^(w-1) odd powers of
+   the base, all but one in the scratch buffer of the RSA metadata, which grows by
+   the modulus size for each. The default value is 2.  */
+/*
+#define NX_CRYPTO_HUGE_NUMBER_WINDOW_BITS       3
+*/
+
+/* Defines the number of RSA public keys whose Montgomery constants are kept from one
+   operation to the next, so that the signature checks of a key seen again, the trusted
+   CA at each reconnection, skip about a tenth of their time. Each entry takes 4 bytes
+   per bit of NX_CRYPTO_RSA_MONT_CACHE_MODULUS_SIZE over 16, 528 bytes for the default
+   2048 bits. The default value is 0, the constants are computed on each operation.  */
+#define NX_CRYPTO_RSA_MONT_CACHE_SIZE           4
+
+/* Defined, the crypto library leaves out the X25519 key exchange, which TLS
+   otherwise offers before secp256r1. By default, this symbol is not defined. */
+/*
+#define NX_CRYPTO_DISABLE_X25519
+*/
+
 /*****************************************************************************/
 /********************* Configuration options for MQTT ************************/
 /*****************************************************************************/
@@ -1523,12 +1757,170 @@
    defined. */
 #define NXD_MQTT_REQUIRE_TLS
 
-/* Defines the MQTT timer rate, in ThreadX timer ticks. This timer is used to
-   keep track of the time since last MQTT control message was sent, and sends
-   out an MQTT PINGREQ message before the keep-alive time expires. This timer
+/* Defined, NetX Secure TLS offers the ciphersuites authenticated by a
+   Pre-Shared Key, which need neither certificate nor public key operation.
+   The application sets the key with MQTT_TLS_PSK_IDENTITY. By default, this
+   symbol is not defined. */
+/*
+#define NX_SECURE_ENABLE_PSK_CIPHERSUITES
+*/
+
+/* Defined, by make TLS_PSK=1, the MQTT client authenticates the broker with
+   a Pre-Shared Key only. NetX Secure TLS is then built with the PSK
+   ciphersuites, without X.509 and without ECC: no certificate is parsed or
+   verified, and none of the RSA, ECDSA and ECDHE code is linked. The
+   handshake is one round trip of symmetric operations, without forward
+   secrecy, as NetX Secure has no ECDHE_PSK ciphersuite. The broker must
+   know MQTT_TLS_PSK_IDENTITY. Requires a TLS 1.2 build. By default, this
+   symbol is not defined. */
+#ifdef MQTT_TLS_PSK_ONLY
+#ifdef NX_SECURE_TLS_ENABLE_TLS_1_3
+#error "MQTT_TLS_PSK_ONLY has no TLS 1.3 ciphersuite, make TLS_PSK=1 without TLS_1_3=1"
+#endif /* NX_SECURE_TLS_ENABLE_TLS_1_3 */
+#define NX_SECURE_ENABLE_PSK_CIPHERSUITES
+#define NX_SECURE_DISABLE_X509
+#define NX_SECURE_DISABLE_ECC_CIPHERSUITE
+#endif /* MQTT_TLS_PSK_ONLY */
+
+/* Defined, NetX Secure TLS offers the AEAD ciphersuites, ChaCha20-Poly1305
+   first, then AES-GCM and AES-CCM. Without an AES accelerator on this MCU,
+   ChaCha20-Poly1305 is the cheapest record protection in software. The PSK
+   ciphersuites offer AES-CCM_8 first: its 8-byte tag makes each record 8
+   bytes shorter, a fair share of a 20 to 50 byte publication, and the
+   software AES authenticates and encrypts its blocks in one pass. By
+   default, this symbol is not defined. */
+#define NX_SECURE_ENABLE_AEAD_CIPHER
+
+/* Defined, NetX Secure TLS refuses the renegotiation of a session. The
+   client answers a HelloRequest of the broker with a no_renegotiation alert.
+   By default, this symbol is not defined. */
+#define NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION
+
+/* Defined, NetX Secure TLS places the session cipher and PRF metadata in the
+   public key metadata, which a TLS 1.2 handshake is done with when it sets
+   the session keys. Requires NX_SECURE_TLS_DISABLE_SECURE_RENEGOTIATION, and
+   saves 2 x 868 + 1008 bytes of CRYPTO_METADATA_CLIENT_SIZE. Not defined in a
+   TLS 1.3 build, make TLS_1_3=1, whose handshake cannot share it. By default,
+   this symbol is not defined. */
+#ifndef NX_SECURE_TLS_ENABLE_TLS_1_3
+#define NX_SECURE_TLS_SHARE_HANDSHAKE_METADATA
+#endif /* NX_SECURE_TLS_ENABLE_TLS_1_3 */
+
+/* Defines the ciphersuites of the ECC ciphersuite table, top priority first,
+   as ENTRY(<ciphersuite>) for each of them. Only the ECDHE AEAD ciphersuites
+   are kept: the CBC ones and the RSA key exchange are not linked, and the
+   metadata is not sized for HMAC-SHA256, saving 740 - 412 bytes of
+   CRYPTO_METADATA_CLIENT_SIZE. By default, this symbol is not defined and the
+   table holds all supported ciphersuites. A TLS 1.3 build puts its own
+   ciphersuites first, the ECDSA certificate of the broker is then needed.
+   MQTT_TLS_PSK_ONLY lists the PSK AEAD ciphersuites alone, in the table
+   without ECC. */
+#ifdef NX_SECURE_TLS_ENABLE_TLS_1_3
+#define NX_SECURE_TLS_1_3_CIPHERSUITE_LIST(ENTRY)                             \
+    ENTRY(TLS_CHACHA20_POLY1305_SHA256)                                       \
+    ENTRY(TLS_AES_128_GCM_SHA256)                                             \
+    ENTRY(TLS_AES_128_CCM_8_SHA256)
+#else
+#define NX_SECURE_TLS_1_3_CIPHERSUITE_LIST(ENTRY)
+#endif /* NX_SECURE_TLS_ENABLE_TLS_1_3 */
+
+#if defined(MQTT_TLS_PSK_ONLY)
+#define NX_SECURE_TLS_CIPHERSUITE_LIST(ENTRY)                                 \
+    ENTRY(TLS_PSK_WITH_AES_128_CCM_8)                                         \
+    ENTRY(TLS_PSK_WITH_CHACHA20_POLY1305_SHA256)
+#elif !defined(NX_SECURE_ENABLE_PSK_CIPHERSUITES)
+#define NX_SECURE_TLS_CIPHERSUITE_LIST(ENTRY)                                 \
+    NX_SECURE_TLS_1_3_CIPHERSUITE_LIST(ENTRY)                                 \
+    ENTRY(TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256)                      \
+    ENTRY(TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256)                        \
+    ENTRY(TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256)                            \
+    ENTRY(TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256)
+#else
+#define NX_SECURE_TLS_CIPHERSUITE_LIST(ENTRY)                                 \
+    NX_SECURE_TLS_1_3_CIPHERSUITE_LIST(ENTRY)                                 \
+    ENTRY(TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256)                      \
+    ENTRY(TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256)                        \
+    ENTRY(TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256)                            \
+    ENTRY(TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256)                              \
+    ENTRY(TLS_PSK_WITH_AES_128_CCM_8)                                         \
+    ENTRY(TLS_PSK_WITH_CHACHA20_POLY1305_SHA256)
+#endif /* MQTT_TLS_PSK_ONLY */
+
+/* Defines the number of certificates of the broker chains whose signature
+   check against their issuer is remembered, by a SHA-256 fingerprint of both.
+   Reconnecting to a broker then skips the RSA/ECDSA verification of its
+   chain; the expiration check and the certificate callback still run. The
+   default value is 0, no cache. */
+#define NX_SECURE_X509_VERIFY_CACHE_SIZE        4
+
+/* Defined, the TLS client parses the server Certificate message straight
+   from the received packets, one certificate at a time, each verified against
+   the next one. The packet buffer then holds the endpoint certificate and at
+   most two others instead of the whole chain. The chain must be sent in
+   order and its Certificate message in a single record. By default, this
+   symbol is not defined. */
+#define NX_SECURE_TLS_ENABLE_CERTIFICATE_STREAMING
+
+/* Defined, the TLS client returns from the handshake once its Finished
+   message is sent when the ciphersuite is an ECDHE AEAD one (TLS False Start,
+   RFC 7918). The MQTT CONNECT then goes out with the Finished flight instead
+   of one round trip later, and the server Finished is checked by the first
+   receive. By default, this symbol is not defined. */
+#define NX_SECURE_TLS_ENABLE_FALSE_START
+
+/* Defined, nx_secure_tls_session_arena_create creates a TLS session whose crypto
+   metadata and packet buffer come from an arena shared by the sessions, see
+   nx_secure_tls_arena_create. The arena is sized for the sessions open at the
+   same time and a deleted session returns its block. By default, this symbol
+   is not defined. */
+#define NX_SECURE_TLS_ENABLE_SESSION_ARENA
+
+/* Defined, a TLS 1.2 client offers in its ClientHello the session ID of a
+   session set by nx_secure_tls_session_resumption_set(), and when the server
+   resumes it, the abbreviated handshake skips the certificates and the key
+   exchange. nx_secure_tls_session_resumption_get() returns the session of a
+   completed handshake, to offer on the next connection. By default, this
+   symbol is not defined. */
+#define NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+
+/* Defines the largest record, in bytes, the TLS client asks the server to send
+   and accepts to send, with the record_size_limit (RFC 8449) and
+   max_fragment_length (RFC 6066) extensions. One of 512, 1024, 2048 or 4096.
+   The encrypted records then fit in a couple of packets and are decrypted as
+   soon as they arrive. By default, this symbol is not defined and records may
+   be 16KB long. */
+#define NX_SECURE_TLS_RECORD_SIZE_LIMIT         1024
+
+/* Defined, nx_secure_tls_session_send splits the data longer than one TCP
+   segment into records that each fill a segment, header and cipher expansion
+   included, instead of one record straddling several segments. The record
+   size limit above bounds the records too. By default, this symbol is not
+   defined. */
+#define NX_SECURE_TLS_SEGMENT_SIZED_RECORDS
+
+/* Defines the number of ephemeral ECDHE key pairs nx_secure_tls_ecdhe_precompute
+   generates ahead of the handshakes, each taken once by the key exchange
+   instead of the scalar multiplication. By default, this symbol is not
+   defined and the key pairs are generated during the handshake. */
+#define NX_SECURE_TLS_ECDHE_PRECOMPUTED_KEYS    4
+
+/* Defined, MQTT Client connects with MQTT 5 instead of MQTT 3.1.1, and
+   names the topic of repeated publishes by a two-byte topic alias. By
+   default, this symbol is not defined. */
+#define NXD_MQTT_V5_ENABLE
+
+/* Defines the largest number of topic aliases MQTT Client assigns to its
+   publishes, further capped by the broker. The default value is 8. */
+/*
+#define NXD_MQTT_TOPIC_ALIAS_MAX                8
+*/
+
+/* Defines how long, in ThreadX timer ticks, before the keep-alive time
+   expires the MQTT Client sends out an MQTT PINGREQ message. The keep-alive
+   timer is one-shot, it expires only when a ping may be due, and no ping is
+   sent while other MQTT control messages keep the connection busy. This timer
    is activated if the client connects to the broker with a keep-alive timer
-   value set. The default value is TX_TIMER_TICKS_PER_SECOND, which is a
-   one-second timer. The default value is TX_TIMER_TICKS_PER_SECOND. */
+   value set. The default value is TX_TIMER_TICKS_PER_SECOND. */
 /*
 #define NXD_MQTT_KEEPALIVE_TIMER_RATE           (NX_IP_PERIODIC_RATE)
 */
@@ -1554,6 +1946,35 @@
 #define NXD_MQTT_CLOUD_ENABLE
 */
 
+/* Defined, MQTT Client creates no thread of its own. The application
+   processes the client events by calling nxd_mqtt_client_events_process
+   from the thread that connects and publishes, which saves the stack of the
+   client thread and a context switch per received packet. By default, this
+   symbol is not defined. */
+#define NXD_MQTT_APPLICATION_EVENT_LOOP
+
+/* Defined, MQTT Client resets its TLS session at the end of a connection
+   instead of deleting it, and the next secure connect reuses it as set up by
+   the first tls_setup callback. The session is deleted with the client. By
+   default, this symbol is not defined. */
+#define NXD_MQTT_TLS_SESSION_KEEP
+
+/* Defined, MQTT Client times each QoS 1 and QoS 2 message from its publish
+   call to TCP and to the PUBACK or PUBREC, into the latency histograms
+   read with nxd_mqtt_client_latency_get. By default, this symbol is not
+   defined. */
+/*
+#define NXD_MQTT_LATENCY_ENABLE
+*/
+
+/* Define the clock of the latencies. The ThreadX timer by default, of 10 ms
+   at 100 ticks per second; the DWT cycle counter boot_profile_init() starts
+   resolves the cycle at 180 MHz, and wraps after 23 s. */
+/*
+#define NXD_MQTT_LATENCY_TIME()                 (*(volatile ULONG *)0xE0001004UL)
+#define NXD_MQTT_LATENCY_MICROSECONDS(time)     ((time) / 180UL)
+*/
+
 /* Define memcpy function used internal. */
 /*
 #define NXD_MQTT_SECURE_MEMCPY                  memcpy
@@ -2536,4 +2957,36 @@
 #define NX_WEB_HTTP_SERVER_RETRY_MAX            10
 */
 
+/* Defined, the Ethernet receive, TCP, TLS record decryption, AES-GCM and MQTT receive
+   paths, the TLS client handshake phases, the record encryption and the RSA, ECDSA
+   and ECDH operations record their duration in CPU cycles, see cycle_profile.h. The
+   memory and the few cycles of each measure are only spent with this option. */
+/*
+#define CYCLE_PROFILE_ENABLE
+*/
+
+/* Defined, the NetX sources get and put their mutexes, nx_ip_protection and the MQTT client
+   nxd_mqtt_protection above all, inline when uncontended, see fast_mutex.h. The inline path
+   records neither the trace events nor the performance information of the mutexes, it is
+   left out when these are enabled in tx_user.h. */
+#define NX_ENABLE_FAST_MUTEX
+
+/* The profiling and trace macros are used in the NetX sources, which all include this file. */
+#include "cycle_profile.h"
+#include "trace_swo.h"
+
+#if defined(NX_ENABLE_FAST_MUTEX) && !defined(TX_ENABLE_EVENT_TRACE) && !defined(TX_MUTEX_ENABLE_PERFORMANCE_INFO)
+#include "fast_mutex.h"
+#undef tx_mutex_get
+#undef tx_mutex_put
+#define tx_mutex_get                            fast_mutex_get
+#define tx_mutex_put                            fast_mutex_put
+#endif
+
+/* Declares NX_RAND. */
+#include "rng_pool.h"
+
+/* Declares NX_PACKET_DATA_COPY. */
+#include "dma_copy.h"
+
 #endif /* NX_USER_H */
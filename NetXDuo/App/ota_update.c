@@ -0,0 +1,584 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    ota_update.c
+  * @author  MCD Application Team
+  * @brief   Firmware update streamed over MQTT into the other flash bank
+  *
+  *          The image arrives in chunks on OTA_TOPIC_NAME, framed as in
+  *          ota_update.h, and each chunk is programmed into the bank not
+  *          running the code as it is read from the received packets: there
+  *          is no copy of the image in RAM, only the bytes of a word cut by
+  *          two packets wait for the next one. The flash service programs
+  *          them, and erases a sector when the image reaches it, the thread
+  *          suspended meanwhile. The words programmed are hashed back from
+  *          the flash, so that the signature checks what the device will boot.
+  *          Each chunk carries its CRC-32, checked by the CRC unit before any
+  *          of it is programmed: a chunk damaged between the server and the
+  *          device is refused with OTA_UPDATE_CORRUPT and may be sent again,
+  *          instead of failing the whole image at its signature.
+  *
+  *          Once the whole image is programmed and its ECDSA P-256 signature
+  *          of its SHA-256 verified, the BFB2 option bit is toggled and the
+  *          device resets. With BFB2 set, the system memory boot loader maps
+  *          bank 2 at 0x08000000 and starts it, so that every image is linked
+  *          for bank 1. A bank failing the boot loader check falls back to
+  *          bank 1. Chunks sent again by the broker are skipped.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ota_update.h"
+#include "publish_store.h"
+#include "flash_service.h"
+#include "crc_service.h"
+#include "clock_governor.h"
+#include "nx_crypto_sha2.h"
+#include "nx_crypto_ecdsa.h"
+#include "ota_update.key.h"
+#include <string.h>
+
+#ifdef OTA_UPDATE
+
+/* Private define ------------------------------------------------------------*/
+/* Type and image size or offset */
+#define OTA_UPDATE_HEADER_SIZE        5U
+
+/* Type, offset and CRC of a chunk */
+#define OTA_UPDATE_DATA_HEADER_SIZE   9U
+
+#define OTA_UPDATE_HASH_SIZE          32U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct OTA_UPDATE_STATE_STRUCT
+{
+  UINT  active;
+  ULONG image_size;
+
+  /* Offset of the next byte expected, and of the first one not hashed yet. */
+  ULONG next_offset;
+  ULONG hashed_offset;
+
+  /* End of the sectors erased for the image. */
+  ULONG erased_offset;
+
+  /* Bytes of the word at next_offset, received and not programmed yet. */
+  UCHAR pending[sizeof(ULONG)];
+  UINT  pending_count;
+
+  UCHAR signature[OTA_UPDATE_SIGNATURE_MAX];
+  UINT  signature_length;
+} OTA_UPDATE_STATE;
+
+/* Private variables ---------------------------------------------------------*/
+static OTA_UPDATE_STATE ota CCMRAM_BSS;
+
+/* The hash runs along the whole update, the ECDSA metadata is only used at its end. */
+static NX_CRYPTO_SHA256 ota_update_sha256 CCMRAM_BSS;
+static NX_CRYPTO_ECDSA ota_update_ecdsa CCMRAM_BSS;
+
+extern NX_CRYPTO_METHOD crypto_method_sha256;
+extern NX_CRYPTO_METHOD crypto_method_ecdsa;
+extern NX_CRYPTO_METHOD crypto_method_ec_secp256;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT  ota_update_begin(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length);
+static UINT  ota_update_data(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length);
+static UINT  ota_update_end(VOID);
+static ULONG ota_update_chunk_crc(NX_PACKET *packet_ptr, ULONG offset, ULONG length);
+static UINT  ota_update_bytes_program(const UCHAR *data, ULONG length);
+static UINT  ota_update_program(ULONG offset, const UCHAR *data, ULONG length);
+static UINT  ota_update_hash(ULONG end_offset);
+static UINT  ota_update_signature_verify(VOID);
+static UINT  ota_update_bank_switch(VOID);
+
+/**
+  * @brief  Process a message of the update topic, read in place from the received packet
+  * @param  packet_ptr: received packet, its chain holds the message
+  * @param  message_offset: offset of the message from the prepend pointer of the packet
+  * @param  message_length: length of the message
+  * @retval OTA_UPDATE_SUCCESS, or the status of the failed message. Does not return
+  *         when the image is verified, the device boots it.
+  */
+UINT ota_update_message(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length)
+{
+  UCHAR type;
+  ULONG bytes_copied;
+
+  if ((message_length == 0) ||
+      (nx_packet_data_extract_offset(packet_ptr, message_offset, &type, 1, &bytes_copied) != NX_SUCCESS))
+  {
+    return(OTA_UPDATE_INVALID);
+  }
+
+  switch (type)
+  {
+    case OTA_UPDATE_BEGIN:
+      return(ota_update_begin(packet_ptr, message_offset, message_length));
+
+    case OTA_UPDATE_DATA:
+      return(ota_update_data(packet_ptr, message_offset, message_length));
+
+    case OTA_UPDATE_END:
+      return(ota_update_end());
+
+    default:
+      return(OTA_UPDATE_INVALID);
+  }
+}
+
+/**
+  * @brief  Start an update, dropping the one in progress
+  * @param  packet_ptr: received packet, its chain holds the message
+  * @param  message_offset: offset of the message from the prepend pointer of the packet
+  * @param  message_length: length of the message
+  * @retval OTA_UPDATE_SUCCESS or OTA_UPDATE_INVALID
+  */
+static UINT ota_update_begin(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length)
+{
+  UCHAR header[OTA_UPDATE_HEADER_SIZE];
+  ULONG bytes_copied;
+  ULONG image_size;
+  VOID *handle = NX_CRYPTO_NULL;
+
+  ota.active = 0U;
+
+  if ((message_length <= OTA_UPDATE_HEADER_SIZE) ||
+      (message_length > OTA_UPDATE_HEADER_SIZE + OTA_UPDATE_SIGNATURE_MAX) ||
+      (nx_packet_data_extract_offset(packet_ptr, message_offset, header, sizeof(header),
+                                     &bytes_copied) != NX_SUCCESS) ||
+      (nx_packet_data_extract_offset(packet_ptr, message_offset + OTA_UPDATE_HEADER_SIZE, ota.signature,
+                                     message_length - OTA_UPDATE_HEADER_SIZE, &bytes_copied) != NX_SUCCESS))
+  {
+    return(OTA_UPDATE_INVALID);
+  }
+
+  image_size = ((ULONG)header[1] << 24) | ((ULONG)header[2] << 16) | ((ULONG)header[3] << 8) | header[4];
+  if ((image_size == 0) || (image_size > OTA_UPDATE_IMAGE_MAX))
+  {
+    return(OTA_UPDATE_INVALID);
+  }
+
+  if ((crypto_method_sha256.nx_crypto_init(&crypto_method_sha256, NX_CRYPTO_NULL, 0, &handle,
+                                           &ota_update_sha256, sizeof(ota_update_sha256)) != NX_CRYPTO_SUCCESS) ||
+      (crypto_method_sha256.nx_crypto_operation(NX_CRYPTO_HASH_INITIALIZE, handle, &crypto_method_sha256,
+                                                NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                NX_CRYPTO_NULL, 0,
+                                                &ota_update_sha256, sizeof(ota_update_sha256),
+                                                NX_CRYPTO_NULL, NX_CRYPTO_NULL) != NX_CRYPTO_SUCCESS))
+  {
+    return(OTA_UPDATE_ERROR);
+  }
+
+  ota.image_size = image_size;
+  ota.signature_length = message_length - OTA_UPDATE_HEADER_SIZE;
+  ota.next_offset = 0;
+  ota.hashed_offset = 0;
+  ota.erased_offset = 0;
+  ota.pending_count = 0;
+  ota.active = 1U;
+
+  return(OTA_UPDATE_SUCCESS);
+}
+
+/**
+  * @brief  Program a chunk of the image, straight from the packets it was received in
+  * @param  packet_ptr: received packet, its chain holds the message
+  * @param  message_offset: offset of the message from the prepend pointer of the packet
+  * @param  message_length: length of the message
+  * @retval OTA_UPDATE_SUCCESS, OTA_UPDATE_SEQUENCE when the chunk does not start at or before
+  *         the next offset, OTA_UPDATE_CORRUPT, OTA_UPDATE_INVALID, or OTA_UPDATE_ERROR
+  */
+static UINT ota_update_data(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length)
+{
+  UCHAR header[OTA_UPDATE_DATA_HEADER_SIZE];
+  ULONG bytes_copied;
+  ULONG chunk_offset;
+  ULONG chunk_crc;
+  ULONG length;
+  ULONG offset;
+  ULONG segment;
+  UINT ret = OTA_UPDATE_SUCCESS;
+
+  if (!ota.active)
+  {
+    return(OTA_UPDATE_SEQUENCE);
+  }
+
+  if ((message_length < OTA_UPDATE_DATA_HEADER_SIZE) ||
+      (nx_packet_data_extract_offset(packet_ptr, message_offset, header, sizeof(header),
+                                     &bytes_copied) != NX_SUCCESS))
+  {
+    return(OTA_UPDATE_INVALID);
+  }
+
+  chunk_offset = ((ULONG)header[1] << 24) | ((ULONG)header[2] << 16) | ((ULONG)header[3] << 8) | header[4];
+  chunk_crc = ((ULONG)header[5] << 24) | ((ULONG)header[6] << 16) | ((ULONG)header[7] << 8) | header[8];
+  length = message_length - OTA_UPDATE_DATA_HEADER_SIZE;
+
+  if ((chunk_offset > ota.image_size) || (length > ota.image_size - chunk_offset))
+  {
+    return(OTA_UPDATE_INVALID);
+  }
+
+  if (chunk_offset > ota.next_offset)
+  {
+    return(OTA_UPDATE_SEQUENCE);
+  }
+
+  /* A chunk sent again is skipped up to the bytes not programmed yet.  */
+  if (chunk_offset + length <= ota.next_offset)
+  {
+    return(OTA_UPDATE_SUCCESS);
+  }
+
+  /* The update goes on, the chunk may come again whole.  */
+  if (ota_update_chunk_crc(packet_ptr, message_offset + OTA_UPDATE_DATA_HEADER_SIZE, length) != chunk_crc)
+  {
+    return(OTA_UPDATE_CORRUPT);
+  }
+
+  offset = message_offset + OTA_UPDATE_DATA_HEADER_SIZE + (ota.next_offset - chunk_offset);
+  length -= ota.next_offset - chunk_offset;
+
+  /* Find the packet of the chain the bytes start in.  */
+  while ((packet_ptr != NX_NULL) &&
+         (offset >= (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr)))
+  {
+    offset -= (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    packet_ptr = packet_ptr -> nx_packet_next;
+  }
+
+  while ((packet_ptr != NX_NULL) && (length != 0) && (ret == OTA_UPDATE_SUCCESS))
+  {
+    segment = (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr) - offset;
+    if (segment > length)
+    {
+      segment = length;
+    }
+
+    ret = ota_update_bytes_program(packet_ptr -> nx_packet_prepend_ptr + offset, segment);
+
+    length -= segment;
+    offset = 0;
+    packet_ptr = packet_ptr -> nx_packet_next;
+  }
+
+  if ((ret == OTA_UPDATE_SUCCESS) && (length != 0))
+  {
+    ret = OTA_UPDATE_INVALID;
+  }
+
+  /* Hash the words programmed, the pending bytes are not in the flash yet.  */
+  if (ret == OTA_UPDATE_SUCCESS)
+  {
+    ret = ota_update_hash(ota.next_offset - ota.pending_count);
+  }
+
+  if (ret != OTA_UPDATE_SUCCESS)
+  {
+    ota.active = 0U;
+  }
+
+  return(ret);
+}
+
+/**
+  * @brief  Program the last bytes of the image, check its signature and boot it
+  * @param  None
+  * @retval OTA_UPDATE_SEQUENCE when chunks are missing, OTA_UPDATE_ERROR or OTA_UPDATE_SIGNATURE.
+  *         Does not return on success.
+  */
+static UINT ota_update_end(VOID)
+{
+  UINT ret = OTA_UPDATE_SUCCESS;
+
+  if (!ota.active || (ota.next_offset != ota.image_size))
+  {
+    return(OTA_UPDATE_SEQUENCE);
+  }
+
+  ota.active = 0U;
+
+  /* The last word is padded with erased bytes, which the hash leaves out.  */
+  if (ota.pending_count != 0)
+  {
+    memset(&ota.pending[ota.pending_count], 0xFF, sizeof(ota.pending) - ota.pending_count);
+    ret = ota_update_program(ota.next_offset - ota.pending_count, ota.pending, sizeof(ota.pending));
+  }
+
+  if (ret == OTA_UPDATE_SUCCESS)
+  {
+    ret = ota_update_hash(ota.image_size);
+  }
+
+  if (ret == OTA_UPDATE_SUCCESS)
+  {
+    /* The ECDSA verification at full speed. */
+    clock_governor_boost();
+    ret = ota_update_signature_verify();
+    clock_governor_release();
+  }
+
+  if (ret == OTA_UPDATE_SUCCESS)
+  {
+    ret = ota_update_bank_switch();
+  }
+
+  return(ret);
+}
+
+/**
+  * @brief  CRC of a chunk, over the packets it was received in
+  * @param  packet_ptr: received packet, its chain holds the chunk
+  * @param  offset: offset of the chunk from the prepend pointer of the packet
+  * @param  length: length of the chunk
+  * @retval CRC-32 of the chunk, of the bytes the chain holds when it is shorter
+  */
+static ULONG ota_update_chunk_crc(NX_PACKET *packet_ptr, ULONG offset, ULONG length)
+{
+  CRC_SERVICE_CONTEXT context;
+  ULONG segment;
+
+  crc_service_begin(&context);
+
+  while ((packet_ptr != NX_NULL) && (length != 0))
+  {
+    segment = (ULONG)(packet_ptr -> nx_packet_append_ptr - packet_ptr -> nx_packet_prepend_ptr);
+    if (offset >= segment)
+    {
+      offset -= segment;
+    }
+    else
+    {
+      segment -= offset;
+      if (segment > length)
+      {
+        segment = length;
+      }
+
+      crc_service_update(&context, packet_ptr -> nx_packet_prepend_ptr + offset, segment);
+
+      length -= segment;
+      offset = 0;
+    }
+    packet_ptr = packet_ptr -> nx_packet_next;
+  }
+
+  return(crc_service_end(&context));
+}
+
+/**
+  * @brief  Program bytes at the next offset of the image
+  * @param  data: bytes to program, in a packet
+  * @param  length: number of bytes
+  * @retval OTA_UPDATE_SUCCESS or OTA_UPDATE_ERROR
+  */
+static UINT ota_update_bytes_program(const UCHAR *data, ULONG length)
+{
+  ULONG words;
+  UINT ret = OTA_UPDATE_SUCCESS;
+
+  while ((length != 0) && (ret == OTA_UPDATE_SUCCESS))
+  {
+    /* Whole words in place, the bytes of a word cut by the end of the packet wait for the next one.  */
+    if ((ota.pending_count == 0) && (length >= sizeof(ULONG)))
+    {
+      words = length & ~(sizeof(ULONG) - 1U);
+      ret = ota_update_program(ota.next_offset, data, words);
+
+      data += words;
+      length -= words;
+      ota.next_offset += words;
+      continue;
+    }
+
+    ota.pending[ota.pending_count++] = *data++;
+    length--;
+    ota.next_offset++;
+
+    if (ota.pending_count == sizeof(ULONG))
+    {
+      ota.pending_count = 0;
+      ret = ota_update_program(ota.next_offset - sizeof(ULONG), ota.pending, sizeof(ULONG));
+    }
+  }
+
+  return(ret);
+}
+
+/**
+  * @brief  Program words of the image through the flash service, erasing each sector first when the image enters it
+  * @param  offset: offset of the first word in the image, word aligned
+  * @param  data: bytes to program, any alignment
+  * @param  length: number of bytes, whole words
+  * @retval OTA_UPDATE_SUCCESS or OTA_UPDATE_ERROR
+  */
+static UINT ota_update_program(ULONG offset, const UCHAR *data, ULONG length)
+{
+  ULONG segment;
+
+  while (length != 0)
+  {
+    /* Not erased ahead of need: the hash reads the bank back, and would stall on an erase in progress.  */
+    if (offset >= ota.erased_offset)
+    {
+      if (flash_service_erase_wait(OTA_UPDATE_BANK_ADDRESS + offset) != FLASH_SERVICE_SUCCESS)
+      {
+        return(OTA_UPDATE_ERROR);
+      }
+      ota.erased_offset = flash_service_sector_end(OTA_UPDATE_BANK_ADDRESS + offset) - OTA_UPDATE_BANK_ADDRESS;
+    }
+
+    segment = ota.erased_offset - offset;
+    if (segment > length)
+    {
+      segment = length;
+    }
+
+    if (flash_service_program_wait(OTA_UPDATE_BANK_ADDRESS + offset, data, segment) != FLASH_SERVICE_SUCCESS)
+    {
+      return(OTA_UPDATE_ERROR);
+    }
+
+    offset += segment;
+    data += segment;
+    length -= segment;
+  }
+
+  return(OTA_UPDATE_SUCCESS);
+}
+
+/**
+  * @brief  Hash the image up to an offset, reading it back from the flash
+  * @param  end_offset: offset of the first byte not to hash
+  * @retval OTA_UPDATE_SUCCESS or OTA_UPDATE_ERROR
+  */
+static UINT ota_update_hash(ULONG end_offset)
+{
+  UINT status;
+
+  if (end_offset <= ota.hashed_offset)
+  {
+    return(OTA_UPDATE_SUCCESS);
+  }
+
+  status = crypto_method_sha256.nx_crypto_operation(NX_CRYPTO_HASH_UPDATE, NX_CRYPTO_NULL, &crypto_method_sha256,
+                                                    NX_CRYPTO_NULL, 0,
+                                                    (UCHAR *)(OTA_UPDATE_BANK_ADDRESS + ota.hashed_offset),
+                                                    end_offset - ota.hashed_offset, NX_CRYPTO_NULL,
+                                                    NX_CRYPTO_NULL, 0,
+                                                    &ota_update_sha256, sizeof(ota_update_sha256),
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    return(OTA_UPDATE_ERROR);
+  }
+
+  ota.hashed_offset = end_offset;
+
+  return(OTA_UPDATE_SUCCESS);
+}
+
+/**
+  * @brief  Verify the signature of the image received with the update begin message
+  * @param  None
+  * @retval OTA_UPDATE_SUCCESS, OTA_UPDATE_SIGNATURE, or OTA_UPDATE_ERROR
+  */
+static UINT ota_update_signature_verify(VOID)
+{
+  NX_CRYPTO_METHOD *method = &crypto_method_ecdsa;
+  UCHAR hash[OTA_UPDATE_HASH_SIZE];
+  VOID *handle = NX_CRYPTO_NULL;
+  UINT status;
+
+  status = crypto_method_sha256.nx_crypto_operation(NX_CRYPTO_HASH_CALCULATE, NX_CRYPTO_NULL, &crypto_method_sha256,
+                                                    NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL, 0, NX_CRYPTO_NULL,
+                                                    hash, sizeof(hash),
+                                                    &ota_update_sha256, sizeof(ota_update_sha256),
+                                                    NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    return(OTA_UPDATE_ERROR);
+  }
+
+  status = method -> nx_crypto_init(method, NX_CRYPTO_NULL, 0, &handle,
+                                    &ota_update_ecdsa, sizeof(ota_update_ecdsa));
+  if (status == NX_CRYPTO_SUCCESS)
+  {
+    status = method -> nx_crypto_operation(NX_CRYPTO_EC_CURVE_SET, handle, method, NX_CRYPTO_NULL, 0,
+                                           (UCHAR *)&crypto_method_ec_secp256, sizeof(NX_CRYPTO_METHOD *),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL, 0,
+                                           &ota_update_ecdsa, sizeof(ota_update_ecdsa),
+                                           NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+  }
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    return(OTA_UPDATE_ERROR);
+  }
+
+  /* The hash is computed already, the signature is checked against it alone.  */
+  status = method -> nx_crypto_operation(NX_CRYPTO_VERIFY, handle, method,
+                                         (UCHAR *)ota_update_public_key, sizeof(ota_update_public_key) << 3,
+                                         hash, sizeof(hash), NX_CRYPTO_NULL,
+                                         ota.signature, ota.signature_length,
+                                         &ota_update_ecdsa, sizeof(ota_update_ecdsa),
+                                         NX_CRYPTO_NULL, NX_CRYPTO_NULL);
+
+  if (method -> nx_crypto_cleanup)
+  {
+    method -> nx_crypto_cleanup(&ota_update_ecdsa);
+  }
+
+  if (status != NX_CRYPTO_SUCCESS)
+  {
+    return(OTA_UPDATE_SIGNATURE);
+  }
+
+  return(OTA_UPDATE_SUCCESS);
+}
+
+/**
+  * @brief  Boot from the other bank: toggle BFB2 and reset, the records of the store in RAM programmed first
+  * @param  None
+  * @retval OTA_UPDATE_ERROR, returns only when the option bytes could not be programmed
+  */
+static UINT ota_update_bank_switch(VOID)
+{
+  FLASH_AdvOBProgramInitTypeDef option_bytes;
+
+  /* No erase of the store may be cut by the reset either.  */
+  publish_store_flush();
+  flash_service_drain();
+
+  HAL_FLASHEx_AdvOBGetConfig(&option_bytes);
+  option_bytes.OptionType = OPTIONBYTE_BOOTCONFIG;
+  option_bytes.BootConfig = (READ_BIT(SYSCFG -> MEMRMP, SYSCFG_MEMRMP_UFB_MODE) != 0U) ?
+                            OB_DUAL_BOOT_DISABLE : OB_DUAL_BOOT_ENABLE;
+
+  HAL_FLASH_Unlock();
+  HAL_FLASH_OB_Unlock();
+
+  if ((HAL_FLASHEx_AdvOBProgram(&option_bytes) == HAL_OK) && (HAL_FLASH_OB_Launch() == HAL_OK))
+  {
+    NVIC_SystemReset();
+  }
+
+  HAL_FLASH_OB_Lock();
+  HAL_FLASH_Lock();
+
+  return(OTA_UPDATE_ERROR);
+}
+
+#endif /* OTA_UPDATE */
@@ -0,0 +1,65 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    ota_update.h
+  * @author  MCD Application Team
+  * @brief   Firmware update streamed over MQTT into the other flash bank
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __OTA_UPDATE_H__
+#define __OTA_UPDATE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_api.h"
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The bank not running the code is always seen at this address, whichever of the two it is. */
+#define OTA_UPDATE_BANK_ADDRESS       0x08100000U
+#define OTA_UPDATE_BANK_SIZE          0x00100000U
+
+/* Sectors 0 to 9 of a bank, the last two of bank 2 hold the publish store. The FLASH
+   region of the linker script is as long, so that each image fits either bank. */
+#define OTA_UPDATE_IMAGE_MAX          (768U * 1024U)
+
+/* DER encoded ECDSA P-256 signature, two 33 byte integers at most */
+#define OTA_UPDATE_SIGNATURE_MAX      72U
+
+/* Type of a message, its first byte. The numbers that follow are big endian. */
+#define OTA_UPDATE_BEGIN              1U  /* Image size on 4 bytes, then the signature of the image   */
+#define OTA_UPDATE_DATA               2U  /* Offset of the chunk in the image on 4 bytes, the CRC-32 of the
+                                               chunk on 4 bytes, as computed in crc_service.h, then the chunk */
+#define OTA_UPDATE_END                3U  /* Nothing more, the image is checked and the device boots it */
+
+/* Status values */
+#define OTA_UPDATE_SUCCESS            0
+#define OTA_UPDATE_ERROR              1   /* Flash program or erase failure              */
+#define OTA_UPDATE_INVALID            2   /* Message malformed, or beyond the image      */
+#define OTA_UPDATE_SEQUENCE           3   /* No update begun, or a chunk is missing      */
+#define OTA_UPDATE_SIGNATURE          4   /* The image programmed does not match its signature */
+#define OTA_UPDATE_CORRUPT            5   /* A chunk does not match its CRC, to be sent again */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Called from the thread of the publish store, both program the flash. */
+UINT ota_update_message(NX_PACKET *packet_ptr, ULONG message_offset, ULONG message_length);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __OTA_UPDATE_H__ */
@@ -0,0 +1,172 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    packet_capture.c
+  * @author  MCD Application Team
+  * @brief   Frames captured by the Ethernet driver, sent as a pcap stream over UDP
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "packet_capture.h"
+
+#ifdef PACKET_CAPTURE
+
+#ifndef NX_DRIVER_ENABLE_CAPTURE
+#error "PACKET_CAPTURE requires NX_DRIVER_ENABLE_CAPTURE in nx_stm32_eth_config.h"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+/* pcap file header: magic number in the byte order of the target, version 2.4, Ethernet links */
+#define PACKET_CAPTURE_MAGIC          0xA1B2C3D4UL
+#define PACKET_CAPTURE_VERSION_MAJOR  2U
+#define PACKET_CAPTURE_VERSION_MINOR  4U
+#define PACKET_CAPTURE_LINKTYPE       1UL
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct PACKET_CAPTURE_HEADER_STRUCT
+{
+  ULONG  magic;
+  USHORT version_major;
+  USHORT version_minor;
+  LONG   zone;
+  ULONG  accuracy;
+  ULONG  snap_length;
+  ULONG  link_type;
+} PACKET_CAPTURE_HEADER;
+
+/* Private variables ---------------------------------------------------------*/
+static NX_PACKET_POOL *packet_capture_pool_ptr;
+
+static NX_UDP_SOCKET packet_capture_socket;
+
+/* Records of one datagram, read from the ring. */
+static UCHAR packet_capture_buffer[PACKET_CAPTURE_DATAGRAM_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT packet_capture_send(const VOID *data_ptr, ULONG length, ULONG address, UINT port);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Bind the socket the requests come to, once the IP address is set.
+* @param  ip_ptr: IP instance
+* @param  pool_ptr: pool of the datagrams sent
+* @retval NX_SUCCESS or the error of the UDP setup
+*/
+UINT packet_capture_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  UINT ret;
+
+  packet_capture_pool_ptr = pool_ptr;
+
+  ret = nx_udp_socket_create(ip_ptr, &packet_capture_socket, "Packet capture", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, 1);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_udp_socket_bind(&packet_capture_socket, PACKET_CAPTURE_PORT, TX_NO_WAIT);
+  if (ret != NX_SUCCESS)
+  {
+    nx_udp_socket_delete(&packet_capture_socket);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Answer a request, if one came, with the frames of the capture ring. Does not wait for a request.
+* @retval NX_SUCCESS when none came or all the frames were sent, otherwise the error of the send
+*/
+UINT packet_capture_poll(VOID)
+{
+  PACKET_CAPTURE_HEADER header;
+  NX_PACKET *packet_ptr;
+  ULONG address;
+  ULONG sequence = 0U;
+  ULONG length;
+  UINT port;
+  UINT ret;
+
+  if (nx_udp_socket_receive(&packet_capture_socket, &packet_ptr, NX_NO_WAIT) != NX_SUCCESS)
+  {
+    return NX_SUCCESS;
+  }
+
+  /* The request carries nothing but its source. */
+  nx_udp_source_extract(packet_ptr, &address, &port);
+  nx_packet_release(packet_ptr);
+
+  header.magic = PACKET_CAPTURE_MAGIC;
+  header.version_major = PACKET_CAPTURE_VERSION_MAJOR;
+  header.version_minor = PACKET_CAPTURE_VERSION_MINOR;
+  header.zone = 0;
+  header.accuracy = 0U;
+  header.snap_length = NX_DRIVER_CAPTURE_SNAP_LENGTH;
+  header.link_type = PACKET_CAPTURE_LINKTYPE;
+
+  nx_stm32_eth_capture_enable(NX_FALSE);
+
+  ret = packet_capture_send(&header, sizeof(header), address, port);
+
+  while ((ret == NX_SUCCESS) &&
+         (nx_stm32_eth_capture_read(&sequence, packet_capture_buffer, sizeof(packet_capture_buffer),
+                                    &length) == NX_SUCCESS))
+  {
+    ret = packet_capture_send(packet_capture_buffer, length, address, port);
+  }
+
+  nx_stm32_eth_capture_enable(NX_TRUE);
+
+  return ret;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Send bytes of the stream in one datagram.
+* @param  data_ptr: bytes, copied
+* @param  length: bytes to send
+* @param  address: IPv4 address of the requester
+* @param  port: UDP port of the requester
+* @retval NX_SUCCESS or the error of the allocation or of the send, the packet is released then
+*/
+static UINT packet_capture_send(const VOID *data_ptr, ULONG length, ULONG address, UINT port)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  ret = nx_packet_allocate(packet_capture_pool_ptr, &packet_ptr, NX_UDP_PACKET, NX_IP_PERIODIC_RATE);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, (VOID *)data_ptr, length, packet_capture_pool_ptr, NX_IP_PERIODIC_RATE);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_send(&packet_capture_socket, packet_ptr, address, port);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+#endif /* PACKET_CAPTURE */
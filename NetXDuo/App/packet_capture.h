@@ -0,0 +1,54 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    packet_capture.h
+  * @author  MCD Application Team
+  * @brief   Frames captured by the Ethernet driver, sent as a pcap stream over UDP
+  *
+  *          With NX_DRIVER_ENABLE_CAPTURE in nx_stm32_eth_config.h, the
+  *          Ethernet driver keeps the headers of the last frames received
+  *          and sent, with their times. With PACKET_CAPTURE defined in
+  *          app_netxduo.h, any datagram to PACKET_CAPTURE_PORT asks for them:
+  *          packet_capture_poll(), called by the MQTT thread on each turn of
+  *          its loop, answers the sender with the pcap file header, then with
+  *          the records of the ring in datagrams of PACKET_CAPTURE_DATAGRAM_SIZE
+  *          bytes at most, oldest first. The capture is stopped while they are
+  *          sent, so that the stream does not capture itself. On the host,
+  *          "echo | nc -u -w 2 <board> 5011 > capture.pcap" writes the file.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PACKET_CAPTURE_H__
+#define __PACKET_CAPTURE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "nx_stm32_eth_config.h"
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef PACKET_CAPTURE
+UINT packet_capture_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+UINT packet_capture_poll(VOID);
+#else
+#define packet_capture_poll()         NX_SUCCESS
+#endif /* PACKET_CAPTURE */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PACKET_CAPTURE_H__ */
@@ -0,0 +1,301 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    payload_compress.c
+  * @author  MCD Application Team
+  * @brief   Compression of the message payloads, in the LZ4 block format
+  *
+  *          The batches of readings and samples repeat themselves, and each
+  *          byte of a message costs AES-GCM cycles and uplink time. With
+  *          PAYLOAD_COMPRESS, each message on TOPIC_NAME is compressed once,
+  *          into its record of the publish store, so that a message sent
+  *          again after a reconnection is not compressed again and the store
+  *          holds more of them. Its payload starts with a format byte, the
+  *          marker the subscribers of the topic read it by: a message that
+  *          compressed shorter is PAYLOAD_FORMAT_LZ4, its length and its LZ4
+  *          block, any other PAYLOAD_FORMAT_RAW and the message unchanged,
+  *          one byte longer. Utilities/payload_decode.py, or any LZ4 block
+  *          decoder, reads them back on the host.
+  *
+  *          The encoder is a greedy LZ4, sized for the messages of the store:
+  *          the message itself is the window, and the only memory is the
+  *          table of the last position of each hash of 4 bytes, 2 bytes each
+  *          for 2 ^ PAYLOAD_COMPRESS_HASH_BITS entries, cleared for each
+  *          message. A sequence is a token, the number of literals in its top
+  *          4 bits and the match length less 4 in its low ones, each extended
+  *          with bytes of 255 when 15, then the literals, the offset of the
+  *          match back from its position, 2 bytes little endian, and the end
+  *          of the match length. As the format requires, the last 5 bytes are
+  *          literals and no match starts in the last 12.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "payload_compress.h"
+#include <string.h>
+
+#ifdef PAYLOAD_COMPRESS
+
+/* Private define ------------------------------------------------------------*/
+#define PAYLOAD_COMPRESS_TABLE_SIZE   (1U << PAYLOAD_COMPRESS_HASH_BITS)
+
+/* Header of a compressed payload: the format byte and the length of the message */
+#define PAYLOAD_COMPRESS_HEADER_SIZE  3U
+
+/* Limits of the LZ4 block format */
+#define LZ4_MIN_MATCH                 4U
+#define LZ4_LAST_LITERALS             5U
+#define LZ4_MATCH_LIMIT               12U
+#define LZ4_LENGTH_MASK               15U
+
+#if (PAYLOAD_COMPRESS_HASH_BITS < 4) || (PAYLOAD_COMPRESS_HASH_BITS > 12)
+#error "PAYLOAD_COMPRESS_HASH_BITS must be from 4 to 12, the table 8 KB at most."
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct PAYLOAD_COMPRESS_OUTPUT_STRUCT
+{
+  UCHAR *output_start;
+  UINT   output_size;
+  UINT   output_length;
+} PAYLOAD_COMPRESS_OUTPUT;
+
+/* Private variables ---------------------------------------------------------*/
+/* Last position of each hash of 4 bytes in the message. */
+static USHORT payload_compress_table[PAYLOAD_COMPRESS_TABLE_SIZE] CCMRAM_BSS;
+
+static ULONG payload_compress_message_bytes;
+static ULONG payload_compress_payload_bytes;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT payload_compress_block(const UCHAR *message, UINT message_length, PAYLOAD_COMPRESS_OUTPUT *output);
+static UINT payload_compress_sequence(PAYLOAD_COMPRESS_OUTPUT *output, const UCHAR *literals, UINT literal_length,
+                                      UINT offset, UINT match_length);
+static UINT payload_compress_length(PAYLOAD_COMPRESS_OUTPUT *output, UINT length);
+static ULONG payload_compress_read(const UCHAR *bytes);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Encode a message as its payload, compressed when it gets shorter, raw otherwise.
+* @param  message: message to compress
+* @param  message_length: length of the message, up to 65535
+* @param  payload_ptr: buffer of the payload
+* @param  payload_size: size of the buffer, PAYLOAD_COMPRESS_BOUND(message_length) is enough
+* @param  payload_length_ptr: length of the payload
+* @retval PAYLOAD_COMPRESS_SUCCESS, or PAYLOAD_COMPRESS_OVERFLOW when the raw payload does not fit either
+*/
+UINT payload_compress(const UCHAR *message, UINT message_length, UCHAR *payload_ptr, UINT payload_size,
+                      UINT *payload_length_ptr)
+{
+  PAYLOAD_COMPRESS_OUTPUT output;
+
+  /* The block is kept only when shorter than the raw payload, its header included. */
+  if ((message_length > PAYLOAD_COMPRESS_HEADER_SIZE) && (message_length <= 0xFFFFU))
+  {
+    output.output_start = payload_ptr + PAYLOAD_COMPRESS_HEADER_SIZE;
+    output.output_size = message_length - PAYLOAD_COMPRESS_HEADER_SIZE;
+    output.output_length = 0;
+    if (payload_size < (PAYLOAD_COMPRESS_HEADER_SIZE + output.output_size))
+    {
+      output.output_size = (payload_size > PAYLOAD_COMPRESS_HEADER_SIZE) ? (payload_size - PAYLOAD_COMPRESS_HEADER_SIZE) : 0;
+    }
+
+    if ((output.output_size != 0) && (payload_compress_block(message, message_length, &output) == PAYLOAD_COMPRESS_SUCCESS))
+    {
+      payload_ptr[0] = PAYLOAD_FORMAT_LZ4;
+      payload_ptr[1] = (UCHAR)message_length;
+      payload_ptr[2] = (UCHAR)(message_length >> 8);
+      *payload_length_ptr = PAYLOAD_COMPRESS_HEADER_SIZE + output.output_length;
+
+      payload_compress_message_bytes += message_length;
+      payload_compress_payload_bytes += *payload_length_ptr;
+      return PAYLOAD_COMPRESS_SUCCESS;
+    }
+  }
+
+  if (payload_size < PAYLOAD_COMPRESS_BOUND(message_length))
+  {
+    return PAYLOAD_COMPRESS_OVERFLOW;
+  }
+
+  payload_ptr[0] = PAYLOAD_FORMAT_RAW;
+  memcpy(&payload_ptr[1], message, message_length);
+  *payload_length_ptr = PAYLOAD_COMPRESS_BOUND(message_length);
+
+  payload_compress_message_bytes += message_length;
+  payload_compress_payload_bytes += *payload_length_ptr;
+  return PAYLOAD_COMPRESS_SUCCESS;
+}
+
+/**
+* @brief  Bytes of the messages compressed since the start, and of their payloads.
+* @param  message_bytes_ptr: bytes of the messages
+* @param  payload_bytes_ptr: bytes of the payloads, the format bytes included
+* @retval None
+*/
+VOID payload_compress_totals(ULONG *message_bytes_ptr, ULONG *payload_bytes_ptr)
+{
+  *message_bytes_ptr = payload_compress_message_bytes;
+  *payload_bytes_ptr = payload_compress_payload_bytes;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Compress a message into an LZ4 block, taking the longest match at the last position of each hash.
+* @param  message: message to compress
+* @param  message_length: length of the message
+* @param  output: space of the block
+* @retval PAYLOAD_COMPRESS_SUCCESS, or PAYLOAD_COMPRESS_OVERFLOW when the block does not fit
+*/
+static UINT payload_compress_block(const UCHAR *message, UINT message_length, PAYLOAD_COMPRESS_OUTPUT *output)
+{
+  UINT anchor = 0;
+  UINT position = 0;
+  UINT candidate;
+  UINT match_length;
+  ULONG bytes;
+  ULONG hash;
+
+  memset(payload_compress_table, 0, sizeof(payload_compress_table));
+
+  while ((position + LZ4_MATCH_LIMIT) <= message_length)
+  {
+    bytes = payload_compress_read(&message[position]);
+    hash = (bytes * 2654435761U) >> (32U - PAYLOAD_COMPRESS_HASH_BITS);
+    hash &= (PAYLOAD_COMPRESS_TABLE_SIZE - 1U);
+    candidate = payload_compress_table[hash];
+    payload_compress_table[hash] = (USHORT)position;
+
+    /* An entry never set reads as the start of the message, checked as any other. */
+    if ((candidate >= position) || (payload_compress_read(&message[candidate]) != bytes))
+    {
+      position++;
+      continue;
+    }
+
+    match_length = LZ4_MIN_MATCH;
+    while (((position + match_length) < (message_length - LZ4_LAST_LITERALS)) &&
+           (message[candidate + match_length] == message[position + match_length]))
+    {
+      match_length++;
+    }
+
+    if (payload_compress_sequence(output, &message[anchor], position - anchor,
+                                  position - candidate, match_length) != PAYLOAD_COMPRESS_SUCCESS)
+    {
+      return PAYLOAD_COMPRESS_OVERFLOW;
+    }
+
+    position += match_length;
+    anchor = position;
+  }
+
+  /* The last literals, a sequence with no match. */
+  return payload_compress_sequence(output, &message[anchor], message_length - anchor, 0, 0);
+}
+
+/**
+* @brief  Append a sequence to the block: its token, its literals, then its match unless it is the last one.
+* @param  output: space of the block
+* @param  literals: literals of the sequence
+* @param  literal_length: number of literals
+* @param  offset: distance of the match back from its position, 0 for the last sequence
+* @param  match_length: length of the match, 4 at least
+* @retval PAYLOAD_COMPRESS_SUCCESS or PAYLOAD_COMPRESS_OVERFLOW
+*/
+static UINT payload_compress_sequence(PAYLOAD_COMPRESS_OUTPUT *output, const UCHAR *literals, UINT literal_length,
+                                      UINT offset, UINT match_length)
+{
+  UINT token_match = 0;
+  UINT token_position;
+
+  if (output -> output_length >= output -> output_size)
+  {
+    return PAYLOAD_COMPRESS_OVERFLOW;
+  }
+  token_position = output -> output_length++;
+
+  if ((payload_compress_length(output, literal_length) != PAYLOAD_COMPRESS_SUCCESS) ||
+      (literal_length > (output -> output_size - output -> output_length)))
+  {
+    return PAYLOAD_COMPRESS_OVERFLOW;
+  }
+  memcpy(output -> output_start + output -> output_length, literals, literal_length);
+  output -> output_length += literal_length;
+
+  if (offset != 0)
+  {
+    if ((output -> output_size - output -> output_length) < 2U)
+    {
+      return PAYLOAD_COMPRESS_OVERFLOW;
+    }
+    output -> output_start[output -> output_length++] = (UCHAR)offset;
+    output -> output_start[output -> output_length++] = (UCHAR)(offset >> 8);
+
+    token_match = match_length - LZ4_MIN_MATCH;
+    if (payload_compress_length(output, token_match) != PAYLOAD_COMPRESS_SUCCESS)
+    {
+      return PAYLOAD_COMPRESS_OVERFLOW;
+    }
+  }
+
+  output -> output_start[token_position] =
+    (UCHAR)((((literal_length < LZ4_LENGTH_MASK) ? literal_length : LZ4_LENGTH_MASK) << 4) |
+            ((token_match < LZ4_LENGTH_MASK) ? token_match : LZ4_LENGTH_MASK));
+
+  return PAYLOAD_COMPRESS_SUCCESS;
+}
+
+/**
+* @brief  Append the bytes of a length past the 15 of its token: 255 each, then the rest.
+* @param  output: space of the block
+* @param  length: length of the token
+* @retval PAYLOAD_COMPRESS_SUCCESS or PAYLOAD_COMPRESS_OVERFLOW
+*/
+static UINT payload_compress_length(PAYLOAD_COMPRESS_OUTPUT *output, UINT length)
+{
+  if (length < LZ4_LENGTH_MASK)
+  {
+    return PAYLOAD_COMPRESS_SUCCESS;
+  }
+
+  for (length -= LZ4_LENGTH_MASK; ; length -= 255U)
+  {
+    if (output -> output_length >= output -> output_size)
+    {
+      return PAYLOAD_COMPRESS_OVERFLOW;
+    }
+
+    if (length < 255U)
+    {
+      output -> output_start[output -> output_length++] = (UCHAR)length;
+      return PAYLOAD_COMPRESS_SUCCESS;
+    }
+    output -> output_start[output -> output_length++] = 255U;
+  }
+}
+
+/**
+* @brief  Read 4 bytes of the message, at any alignment.
+* @param  bytes: first byte
+* @retval The 4 bytes, little endian
+*/
+static ULONG payload_compress_read(const UCHAR *bytes)
+{
+  return (ULONG)bytes[0] | ((ULONG)bytes[1] << 8) | ((ULONG)bytes[2] << 16) | ((ULONG)bytes[3] << 24);
+}
+
+#endif /* PAYLOAD_COMPRESS */
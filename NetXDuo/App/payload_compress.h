@@ -0,0 +1,54 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    payload_compress.h
+  * @author  MCD Application Team
+  * @brief   Compression of the message payloads, in the LZ4 block format
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PAYLOAD_COMPRESS_H__
+#define __PAYLOAD_COMPRESS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Format byte first in each payload */
+#define PAYLOAD_FORMAT_RAW            0x00U  /* The message follows as it is                   */
+#define PAYLOAD_FORMAT_LZ4            0x01U  /* Its length, 2 bytes little endian, then its LZ4 block */
+
+/* Longest payload of a message of the length given, sent raw when it does not get shorter */
+#define PAYLOAD_COMPRESS_BOUND(length) ((length) + 1)
+
+/* Status values */
+#define PAYLOAD_COMPRESS_SUCCESS      0
+#define PAYLOAD_COMPRESS_OVERFLOW     1   /* The payload does not fit in the buffer */
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef PAYLOAD_COMPRESS
+/* Not thread safe, the match table is shared: used from one thread only. */
+UINT payload_compress(const UCHAR *message, UINT message_length, UCHAR *payload_ptr, UINT payload_size,
+                      UINT *payload_length_ptr);
+VOID payload_compress_totals(ULONG *message_bytes_ptr, ULONG *payload_bytes_ptr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PAYLOAD_COMPRESS_H__ */
@@ -0,0 +1,615 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    publish_store.c
+  * @author  MCD Application Team
+  * @brief   Flash backed store-and-forward queue of the messages to publish
+  *
+  *          The store is a log of records in the flash sectors reserved for it.
+  *          Each sector starts with a header holding a sequence number, which
+  *          orders the sectors of the log after a reset. A record is:
+  *            - a header word, PUBLISH_STORE_RECORD_MAGIC and the message length,
+  *            - a state word, left erased until the message is acknowledged,
+  *            - the CRC-32 of the header word and the padded message,
+  *            - the message, padded to a word.
+  *          The header word is programmed last, so that a record cut by a reset
+  *          is never taken for a valid one. Acknowledging a record programs its
+  *          state word to zero, clearing bits only, which needs no erase. The
+  *          CRC, computed by the CRC unit, is checked wherever the log is
+  *          walked: a record whose bits no longer match ends its sector as a
+  *          cut record does, rather than being published corrupted.
+  *
+  *          New records are first gathered in RAM and programmed by
+  *          PUBLISH_STORE_PROGRAM_SIZE, or on publish_store_flush(). A reset
+  *          loses at most the records still in RAM.
+  *
+  *          The flash is programmed and erased by the flash service, the
+  *          calls of the store suspend the thread meanwhile. Once every
+  *          record is acknowledged, the store reads nothing from the flash
+  *          until its next programming, queued behind any erase: the sector
+  *          the store opens next is then erased in the background.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "publish_store.h"
+#include "flash_service.h"
+#include "crc_service.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define PUBLISH_STORE_SECTOR_MAGIC    0x50535132U   /* "PSQ2", the records with their CRC */
+#define PUBLISH_STORE_RECORD_MAGIC    0xA5000000U
+#define PUBLISH_STORE_MAGIC_MASK      0xFF000000U
+#define PUBLISH_STORE_LENGTH_MASK     0x0000FFFFU
+#define PUBLISH_STORE_ERASED          0xFFFFFFFFU
+#define PUBLISH_STORE_CONSUMED        0x00000000U
+
+/* Sector header and record header sizes, in bytes */
+#define PUBLISH_STORE_SECTOR_HEADER   8
+#define PUBLISH_STORE_RECORD_HEADER   12
+
+#define PUBLISH_STORE_RECORD_SIZE(length) \
+  (PUBLISH_STORE_RECORD_HEADER + (((length) + 3U) & ~3U))
+
+/* Address of the store as mapped now, bank 2 is at 0x08000000 when booted from it */
+#define PUBLISH_STORE_BASE \
+  ((READ_BIT(SYSCFG -> MEMRMP, SYSCFG_MEMRMP_UFB_MODE) != 0U) ? \
+   (PUBLISH_STORE_ADDRESS - PUBLISH_STORE_BANK_SIZE) : PUBLISH_STORE_ADDRESS)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct PUBLISH_STORE_STRUCT
+{
+  /* Flash address the RAM buffer is programmed at. Addresses from it on are
+     looked up in the RAM buffer instead of the flash. */
+  ULONG write_address;
+  ULONG write_sector;
+  ULONG write_sequence;
+
+  /* Oldest record not acknowledged and next record to send. */
+  ULONG read_address;
+  ULONG send_address;
+
+  ULONG count;
+  ULONG sent_count;
+
+  ULONG buffer_used;
+  ULONG buffer[PUBLISH_STORE_PROGRAM_SIZE / sizeof(ULONG)];
+
+  /* Erase of the sector after write_sector, queued ahead of its opening. */
+  FLASH_SERVICE_REQUEST erase_request;
+  UINT  erase_queued;
+} PUBLISH_STORE;
+
+/* Private variables ---------------------------------------------------------*/
+static PUBLISH_STORE store CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static ULONG publish_store_sector_base(ULONG sector);
+static UINT  publish_store_buffered(ULONG address);
+static ULONG *publish_store_record(ULONG address);
+static UINT  publish_store_record_valid(ULONG address, ULONG sector_end);
+static ULONG publish_store_record_crc(const ULONG *record);
+static ULONG publish_store_record_next(ULONG address);
+static UINT  publish_store_sector_open(VOID);
+static UINT  publish_store_program(ULONG address, const VOID *data_ptr, ULONG length);
+
+/**
+  * @brief  Recover the store from the flash, to be called once at boot
+  * @param  None
+  * @retval PUBLISH_STORE_SUCCESS, or PUBLISH_STORE_ERROR when the flash could not be prepared
+  */
+UINT publish_store_init(VOID)
+{
+  ULONG *sector_header;
+  ULONG newest = 0;
+  ULONG oldest;
+  ULONG found = 0;
+  ULONG sector;
+  ULONG sector_end;
+  ULONG address;
+  ULONG i;
+
+  memset(&store, 0, sizeof(store));
+
+  /* Find the newest sector of the log.  */
+  for (i = 0; i < PUBLISH_STORE_SECTOR_COUNT; i++)
+  {
+    sector_header = (ULONG *)publish_store_sector_base(i);
+    if ((sector_header[0] == PUBLISH_STORE_SECTOR_MAGIC) &&
+        ((found == 0) || ((LONG)(sector_header[1] - store.write_sequence) > 0)))
+    {
+      newest = i;
+      store.write_sequence = sector_header[1];
+      found = 1;
+    }
+  }
+
+  if (found == 0)
+  {
+    /* Blank or foreign content: start the log in the last sector, so that
+       the first sector opened is the first one.  */
+    store.write_sector = PUBLISH_STORE_SECTOR_COUNT - 1;
+    store.write_address = publish_store_sector_base(PUBLISH_STORE_SECTOR_COUNT);
+    store.read_address = store.write_address;
+    store.send_address = store.write_address;
+    return(publish_store_sector_open());
+  }
+
+  /* Walk back the sectors written just before it, to the oldest one.  */
+  oldest = newest;
+  for (i = 1; i < PUBLISH_STORE_SECTOR_COUNT; i++)
+  {
+    sector = (newest + PUBLISH_STORE_SECTOR_COUNT - i) % PUBLISH_STORE_SECTOR_COUNT;
+    sector_header = (ULONG *)publish_store_sector_base(sector);
+    if ((sector_header[0] != PUBLISH_STORE_SECTOR_MAGIC) ||
+        (sector_header[1] != store.write_sequence - i))
+    {
+      break;
+    }
+    oldest = sector;
+  }
+
+  /* Scan the records, oldest first. Acknowledgements are in order, so the
+     first record not acknowledged starts the queue.  */
+  store.read_address = 0;
+  sector = oldest;
+  for (;;)
+  {
+    address = publish_store_sector_base(sector) + PUBLISH_STORE_SECTOR_HEADER;
+    sector_end = publish_store_sector_base(sector) + PUBLISH_STORE_SECTOR_SIZE;
+
+    while (publish_store_record_valid(address, sector_end))
+    {
+      if (((ULONG *)address)[1] != PUBLISH_STORE_CONSUMED)
+      {
+        if (store.read_address == 0)
+        {
+          store.read_address = address;
+        }
+        store.count++;
+      }
+      address += PUBLISH_STORE_RECORD_SIZE(((ULONG *)address)[0] & PUBLISH_STORE_LENGTH_MASK);
+    }
+
+    if (sector == newest)
+    {
+      break;
+    }
+    sector = (sector + 1) % PUBLISH_STORE_SECTOR_COUNT;
+  }
+
+  /* The new records go after the last valid one. Anything programmed there
+     is a record cut by a reset: leave the rest of the sector alone.  */
+  store.write_sector = newest;
+  store.write_address = address;
+  while (address < sector_end)
+  {
+    if (*(ULONG *)address != PUBLISH_STORE_ERASED)
+    {
+      store.write_address = sector_end;
+      break;
+    }
+    address += sizeof(ULONG);
+  }
+
+  if (store.read_address == 0)
+  {
+    store.read_address = store.write_address;
+  }
+  store.send_address = store.read_address;
+
+  return(PUBLISH_STORE_SUCCESS);
+}
+
+/**
+  * @brief  Append a message at the end of the store
+  * @param  message: message to store
+  * @param  message_length: length of the message, up to PUBLISH_STORE_MESSAGE_MAX
+  * @retval PUBLISH_STORE_SUCCESS, PUBLISH_STORE_FULL when the message is dropped for lack of room,
+  *         PUBLISH_STORE_INVALID_SIZE or PUBLISH_STORE_ERROR
+  */
+UINT publish_store_append(const UCHAR *message, UINT message_length)
+{
+  ULONG record_size;
+  ULONG *record;
+  UINT  ret;
+
+  if ((message_length == 0) || (message_length > PUBLISH_STORE_MESSAGE_MAX))
+  {
+    return(PUBLISH_STORE_INVALID_SIZE);
+  }
+
+  record_size = PUBLISH_STORE_RECORD_SIZE(message_length);
+
+  /* The RAM buffer maps to one sector, program it before it overflows.  */
+  if ((store.buffer_used + record_size > PUBLISH_STORE_PROGRAM_SIZE) ||
+      (store.write_address + store.buffer_used + record_size >
+       publish_store_sector_base(store.write_sector) + PUBLISH_STORE_SECTOR_SIZE))
+  {
+    ret = publish_store_flush();
+    if (ret != PUBLISH_STORE_SUCCESS)
+    {
+      return(ret);
+    }
+
+    if (store.write_address + record_size >
+        publish_store_sector_base(store.write_sector) + PUBLISH_STORE_SECTOR_SIZE)
+    {
+      ret = publish_store_sector_open();
+      if (ret != PUBLISH_STORE_SUCCESS)
+      {
+        return(ret);
+      }
+    }
+  }
+
+  record = &store.buffer[store.buffer_used / sizeof(ULONG)];
+  memset(record, 0xFF, record_size);
+  record[0] = PUBLISH_STORE_RECORD_MAGIC | message_length;
+  memcpy(&record[3], message, message_length);
+  record[2] = publish_store_record_crc(record);
+
+  store.buffer_used += record_size;
+  store.count++;
+
+  return(PUBLISH_STORE_SUCCESS);
+}
+
+/**
+  * @brief  Program the records gathered in RAM
+  * @param  None
+  * @retval PUBLISH_STORE_SUCCESS or PUBLISH_STORE_ERROR
+  */
+UINT publish_store_flush(VOID)
+{
+  ULONG offset = 0;
+  ULONG record_size;
+  ULONG *record;
+  UINT ret = PUBLISH_STORE_SUCCESS;
+
+  if (store.buffer_used == 0)
+  {
+    return(PUBLISH_STORE_SUCCESS);
+  }
+
+  while ((offset < store.buffer_used) && (ret == PUBLISH_STORE_SUCCESS))
+  {
+    record = &store.buffer[offset / sizeof(ULONG)];
+    record_size = PUBLISH_STORE_RECORD_SIZE(record[0] & PUBLISH_STORE_LENGTH_MASK);
+
+    /* State, CRC and message first, header last. The service skips the erased words.  */
+    ret = publish_store_program(store.write_address + offset + sizeof(ULONG), &record[1],
+                                record_size - sizeof(ULONG));
+
+    if (ret == PUBLISH_STORE_SUCCESS)
+    {
+      ret = publish_store_program(store.write_address + offset, &record[0], sizeof(ULONG));
+    }
+
+    offset += record_size;
+  }
+
+  if (ret != PUBLISH_STORE_SUCCESS)
+  {
+    /* The records stay readable from RAM, they are only lost on a reset.  */
+    return(ret);
+  }
+
+  store.write_address += store.buffer_used;
+  store.buffer_used = 0;
+
+  return(PUBLISH_STORE_SUCCESS);
+}
+
+/**
+  * @brief  Get the next message to send, publish_store_next() moves past it once sent
+  * @param  message_ptr: set to the message, valid until the next call to the store
+  * @param  message_length_ptr: set to the length of the message
+  * @retval PUBLISH_STORE_SUCCESS, or PUBLISH_STORE_EMPTY when every message is sent
+  */
+UINT publish_store_peek(const UCHAR **message_ptr, UINT *message_length_ptr)
+{
+  ULONG *record;
+
+  if (store.sent_count == store.count)
+  {
+    return(PUBLISH_STORE_EMPTY);
+  }
+
+  record = publish_store_record(store.send_address);
+  *message_ptr = (const UCHAR *)&record[3];
+  *message_length_ptr = record[0] & PUBLISH_STORE_LENGTH_MASK;
+
+  return(PUBLISH_STORE_SUCCESS);
+}
+
+/**
+  * @brief  Count the next message as sent, it waits for its acknowledgement
+  * @param  None
+  * @retval None
+  */
+VOID publish_store_next(VOID)
+{
+  if (store.sent_count != store.count)
+  {
+    store.send_address = publish_store_record_next(store.send_address);
+    store.sent_count++;
+  }
+}
+
+/**
+  * @brief  Acknowledge the oldest message sent
+  * @param  None
+  * @retval PUBLISH_STORE_SUCCESS, PUBLISH_STORE_EMPTY when no message is waiting for its
+  *         acknowledgement, or PUBLISH_STORE_ERROR
+  */
+UINT publish_store_consume(VOID)
+{
+  ULONG consumed = PUBLISH_STORE_CONSUMED;
+  UINT ret = PUBLISH_STORE_SUCCESS;
+
+  if (store.sent_count == 0)
+  {
+    return(PUBLISH_STORE_EMPTY);
+  }
+
+  if (publish_store_buffered(store.read_address))
+  {
+    publish_store_record(store.read_address)[1] = PUBLISH_STORE_CONSUMED;
+  }
+  else
+  {
+    ret = publish_store_program(store.read_address + sizeof(ULONG), &consumed, sizeof(ULONG));
+  }
+
+  store.read_address = publish_store_record_next(store.read_address);
+  store.count--;
+  store.sent_count--;
+
+  /* Every record still in RAM is acknowledged: drop them unprogrammed.  */
+  if ((store.count == 0) && (store.buffer_used != 0))
+  {
+    store.buffer_used = 0;
+    store.read_address = store.write_address;
+    store.send_address = store.write_address;
+  }
+
+  /* Nothing is read from the flash any more before the next programming, which waits for the erase.  */
+  if ((store.count == 0) && !store.erase_queued)
+  {
+    store.erase_queued = (flash_service_erase(&store.erase_request,
+                                              publish_store_sector_base((store.write_sector + 1) % PUBLISH_STORE_SECTOR_COUNT),
+                                              NX_NULL, NX_NULL) == FLASH_SERVICE_SUCCESS);
+  }
+
+  return(ret);
+}
+
+/**
+  * @brief  Send again every message not acknowledged, after a disconnection
+  * @param  None
+  * @retval None
+  */
+VOID publish_store_rewind(VOID)
+{
+  store.send_address = store.read_address;
+  store.sent_count = 0;
+}
+
+/**
+  * @brief  Number of messages not acknowledged
+  * @param  None
+  * @retval Count of messages
+  */
+ULONG publish_store_count(VOID)
+{
+  return(store.count);
+}
+
+/**
+  * @brief  Number of messages not sent yet
+  * @param  None
+  * @retval Count of messages
+  */
+ULONG publish_store_unsent_count(VOID)
+{
+  return(store.count - store.sent_count);
+}
+
+/**
+  * @brief  Flash address of a sector of the store
+  * @param  sector: index of the sector in the store
+  * @retval Address of the sector
+  */
+static ULONG publish_store_sector_base(ULONG sector)
+{
+  return(PUBLISH_STORE_BASE + sector * PUBLISH_STORE_SECTOR_SIZE);
+}
+
+/**
+  * @brief  Check an address maps to the RAM buffer, or is the end of the store
+  * @param  address: flash address in the store
+  * @retval 1 when the address is not programmed yet, 0 otherwise
+  */
+static UINT publish_store_buffered(ULONG address)
+{
+  /* The log wraps around, an older record may be above the write address.  */
+  return((address >= store.write_address) && (address - store.write_address <= store.buffer_used));
+}
+
+/**
+  * @brief  Locate a record in the flash or in the RAM buffer
+  * @param  address: flash address of the record
+  * @retval Pointer to the record
+  */
+static ULONG *publish_store_record(ULONG address)
+{
+  if (publish_store_buffered(address))
+  {
+    return(&store.buffer[(address - store.write_address) / sizeof(ULONG)]);
+  }
+
+  return((ULONG *)address);
+}
+
+/**
+  * @brief  Check a record was completely programmed in the flash, and still reads as programmed
+  * @param  address: flash address of the record
+  * @param  sector_end: end of the sector holding it
+  * @retval 1 when the record is valid, 0 otherwise
+  */
+static UINT publish_store_record_valid(ULONG address, ULONG sector_end)
+{
+  ULONG header;
+
+  if (address + PUBLISH_STORE_RECORD_HEADER > sector_end)
+  {
+    return(0);
+  }
+
+  header = *(ULONG *)address;
+  if (((header & PUBLISH_STORE_MAGIC_MASK) != PUBLISH_STORE_RECORD_MAGIC) ||
+      ((header & PUBLISH_STORE_LENGTH_MASK) == 0) ||
+      ((header & PUBLISH_STORE_LENGTH_MASK) > PUBLISH_STORE_MESSAGE_MAX) ||
+      ((header & ~(PUBLISH_STORE_MAGIC_MASK | PUBLISH_STORE_LENGTH_MASK)) != 0) ||
+      (address + PUBLISH_STORE_RECORD_SIZE(header & PUBLISH_STORE_LENGTH_MASK) > sector_end) ||
+      (((ULONG *)address)[2] != publish_store_record_crc((ULONG *)address)))
+  {
+    return(0);
+  }
+
+  return(1);
+}
+
+/**
+  * @brief  CRC of a record, over its header word and its padded message
+  * @param  record: record with a valid header word, in the flash or in the RAM buffer
+  * @retval CRC-32 of the record
+  */
+static ULONG publish_store_record_crc(const ULONG *record)
+{
+  CRC_SERVICE_CONTEXT context;
+
+  crc_service_begin(&context);
+  crc_service_update(&context, &record[0], sizeof(ULONG));
+  crc_service_update(&context, &record[3],
+                     PUBLISH_STORE_RECORD_SIZE(record[0] & PUBLISH_STORE_LENGTH_MASK) - PUBLISH_STORE_RECORD_HEADER);
+
+  return(crc_service_end(&context));
+}
+
+/**
+  * @brief  Address of the record following another one
+  * @param  address: flash address of a record in the store
+  * @retval Address of the next record, or the end of the store
+  */
+static ULONG publish_store_record_next(ULONG address)
+{
+  ULONG sector = (address - PUBLISH_STORE_BASE) / PUBLISH_STORE_SECTOR_SIZE;
+
+  address += PUBLISH_STORE_RECORD_SIZE(publish_store_record(address)[0] & PUBLISH_STORE_LENGTH_MASK);
+
+  /* The records in RAM and the end of the store are contiguous.  */
+  if (publish_store_buffered(address))
+  {
+    return(address);
+  }
+
+  /* The end of an older sector is unused, or a cut record: go on in the next one.  */
+  if (!publish_store_record_valid(address, publish_store_sector_base(sector) + PUBLISH_STORE_SECTOR_SIZE))
+  {
+    sector = (sector + 1) % PUBLISH_STORE_SECTOR_COUNT;
+    address = publish_store_sector_base(sector) + PUBLISH_STORE_SECTOR_HEADER;
+  }
+
+  return(address);
+}
+
+/**
+  * @brief  Move the end of the store to the next sector, erasing it when needed
+  * @param  None
+  * @retval PUBLISH_STORE_SUCCESS, PUBLISH_STORE_FULL when the next sector holds
+  *         messages not acknowledged, or PUBLISH_STORE_ERROR
+  */
+static UINT publish_store_sector_open(VOID)
+{
+  ULONG header[2];
+  ULONG sector;
+  UINT ret = PUBLISH_STORE_SUCCESS;
+
+  sector = (store.write_sector + 1) % PUBLISH_STORE_SECTOR_COUNT;
+
+  if ((store.count != 0) &&
+      ((store.read_address - PUBLISH_STORE_BASE) / PUBLISH_STORE_SECTOR_SIZE == sector))
+  {
+    return(PUBLISH_STORE_FULL);
+  }
+
+  /* Queued behind the erase queued ahead, if any, the service then finds the sector blank.  */
+  store.erase_queued = 0U;
+  if (flash_service_erase_wait(publish_store_sector_base(sector)) != FLASH_SERVICE_SUCCESS)
+  {
+    return(PUBLISH_STORE_ERROR);
+  }
+
+  /* Sequence first, magic last.  */
+  header[0] = PUBLISH_STORE_SECTOR_MAGIC;
+  header[1] = store.write_sequence + 1;
+
+  ret = publish_store_program(publish_store_sector_base(sector) + sizeof(ULONG), &header[1], sizeof(ULONG));
+
+  if (ret == PUBLISH_STORE_SUCCESS)
+  {
+    ret = publish_store_program(publish_store_sector_base(sector), &header[0], sizeof(ULONG));
+  }
+
+  if (ret != PUBLISH_STORE_SUCCESS)
+  {
+    return(ret);
+  }
+
+  store.write_sector = sector;
+  store.write_sequence++;
+  store.write_address = publish_store_sector_base(sector) + PUBLISH_STORE_SECTOR_HEADER;
+
+  /* The cursors at the end of the store follow it.  */
+  if (store.count == 0)
+  {
+    store.read_address = store.write_address;
+  }
+  if (store.sent_count == store.count)
+  {
+    store.send_address = store.write_address;
+  }
+
+  return(PUBLISH_STORE_SUCCESS);
+}
+
+/**
+  * @brief  Program words of the flash through the flash service, waiting for them
+  * @param  address: flash address of the first word
+  * @param  data_ptr: words to program
+  * @param  length: number of bytes
+  * @retval PUBLISH_STORE_SUCCESS or PUBLISH_STORE_ERROR
+  */
+static UINT publish_store_program(ULONG address, const VOID *data_ptr, ULONG length)
+{
+  if (flash_service_program_wait(address, data_ptr, length) != FLASH_SERVICE_SUCCESS)
+  {
+    return(PUBLISH_STORE_ERROR);
+  }
+
+  return(PUBLISH_STORE_SUCCESS);
+}
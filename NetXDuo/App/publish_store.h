@@ -0,0 +1,74 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    publish_store.h
+  * @author  MCD Application Team
+  * @brief   Flash backed store-and-forward queue of the messages to publish
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PUBLISH_STORE_H__
+#define __PUBLISH_STORE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Flash sectors reserved for the store, see the STORE region of the linker script.
+   They are in bank 2, so that programming and erasing do not stall the code
+   running from bank 1. The sectors are used in turn, each is erased only when
+   the ring comes back to it, or in the background as soon as every record is
+   acknowledged. Booted from bank 2 after an OTA update, the same sectors are
+   seen PUBLISH_STORE_BANK_SIZE lower and keep the records; they then share
+   the bank the code runs from, which stalls while they are erased. */
+#define PUBLISH_STORE_ADDRESS         0x081C0000U
+#define PUBLISH_STORE_BANK_SIZE       0x00100000U
+#define PUBLISH_STORE_SECTOR_COUNT    2
+#define PUBLISH_STORE_SECTOR_SIZE     (128 * 1024)
+
+/* RAM buffer the new records are gathered in before they are programmed together.
+   Records published and acknowledged while still in it never reach the flash. */
+#define PUBLISH_STORE_PROGRAM_SIZE    512
+
+/* Largest message a record holds. */
+#define PUBLISH_STORE_MESSAGE_MAX     (PUBLISH_STORE_PROGRAM_SIZE - 12)
+
+/* Status values */
+#define PUBLISH_STORE_SUCCESS         0
+#define PUBLISH_STORE_ERROR           1   /* Flash program or erase failure     */
+#define PUBLISH_STORE_FULL            2   /* No sector free of unsent records   */
+#define PUBLISH_STORE_EMPTY           3   /* No record to send or acknowledge   */
+#define PUBLISH_STORE_INVALID_SIZE    4   /* Message is empty or too long       */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* The store is not thread safe, it is used from one thread only. */
+UINT  publish_store_init(VOID);
+UINT  publish_store_append(const UCHAR *message, UINT message_length);
+UINT  publish_store_flush(VOID);
+UINT  publish_store_peek(const UCHAR **message_ptr, UINT *message_length_ptr);
+VOID  publish_store_next(VOID);
+UINT  publish_store_consume(VOID);
+VOID  publish_store_rewind(VOID);
+ULONG publish_store_count(VOID);
+ULONG publish_store_unsent_count(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PUBLISH_STORE_H__ */
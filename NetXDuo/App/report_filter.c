@@ -0,0 +1,148 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    report_filter.c
+  * @author  MCD Application Team
+  * @brief   Report by exception of the readings, ahead of the publisher
+  *
+  *          The settings and the last reading sent of the channels are kept as
+  *          a struct of arrays, one array per field indexed by the channel:
+  *          the check of a reading loads the few words of its channel it
+  *          compares, and the table of REPORT_FILTER_CHANNELS channels packs
+  *          without padding. A bit per channel tells whether it has sent a
+  *          reading yet.
+  *
+  *          The intervals are in ticks, compared as differences so that they
+  *          hold across the wrap of tx_time_get(). The percentage is taken of
+  *          the magnitude of the last reading sent, without overflow.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "report_filter.h"
+
+#ifdef REPORT_FILTER
+
+#if (REPORT_FILTER_CHANNELS > 32)
+#error "REPORT_FILTER_CHANNELS is above the bits of report_filter_table.sent"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct REPORT_FILTER_TABLE_STRUCT
+{
+  LONG   last_value[REPORT_FILTER_CHANNELS];        /* Last reading sent                      */
+  ULONG  last_time[REPORT_FILTER_CHANNELS];         /* Tick it was sent at                    */
+  ULONG  deadband[REPORT_FILTER_CHANNELS];          /* Absolute change reported               */
+  ULONG  min_interval[REPORT_FILTER_CHANNELS];      /* Ticks between two readings sent        */
+  ULONG  max_interval[REPORT_FILTER_CHANNELS];      /* Ticks a reading is sent after, 0 never */
+  UCHAR  deadband_percent[REPORT_FILTER_CHANNELS];  /* Change reported, in % of the last one  */
+  ULONG  sent;                                      /* Bit of each channel with a reading sent */
+} REPORT_FILTER_TABLE;
+
+/* Private variables ---------------------------------------------------------*/
+static REPORT_FILTER_TABLE report_filter_table;
+static ULONG report_filter_suppressed_count;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Set the deadband and the intervals of a channel, its next reading is sent.
+* @param  channel: index of the channel, below REPORT_FILTER_CHANNELS
+* @param  deadband: change of a reading reported whatever the last one
+* @param  deadband_percent: change reported, in percent of the last reading sent, 0 for none, up to 100
+* @param  min_interval: ticks from a reading sent before the next one can be
+* @param  max_interval: ticks from a reading sent after which the next one is, 0 for none
+* @retval NX_SUCCESS or NX_INVALID_PARAMETERS
+*/
+UINT report_filter_channel_set(UINT channel, ULONG deadband, UINT deadband_percent,
+                               ULONG min_interval, ULONG max_interval)
+{
+  if ((channel >= REPORT_FILTER_CHANNELS) || (deadband_percent > 100U) ||
+      ((max_interval != 0U) && (max_interval < min_interval)))
+  {
+    return NX_INVALID_PARAMETERS;
+  }
+
+  report_filter_table.deadband[channel] = deadband;
+  report_filter_table.deadband_percent[channel] = (UCHAR)deadband_percent;
+  report_filter_table.min_interval[channel] = min_interval;
+  report_filter_table.max_interval[channel] = max_interval;
+  report_filter_table.sent &= ~(1UL << channel);
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Tell whether a reading of a channel is to be published, it is then the last one sent.
+* @param  channel: index of the channel, a reading of a channel out of the table is always sent
+* @param  value: reading
+* @retval REPORT_FILTER_SEND or REPORT_FILTER_SKIP
+*/
+UINT report_filter_check(UINT channel, LONG value)
+{
+  ULONG now = tx_time_get();
+  ULONG elapsed;
+  ULONG change;
+  ULONG magnitude;
+  ULONG threshold;
+  LONG last;
+
+  if (channel >= REPORT_FILTER_CHANNELS)
+  {
+    return REPORT_FILTER_SEND;
+  }
+
+  /* Until the maximum interval, a reading is sent once out of the deadband, after the minimum interval. */
+  if (report_filter_table.sent & (1UL << channel))
+  {
+    elapsed = now - report_filter_table.last_time[channel];
+
+    if ((report_filter_table.max_interval[channel] == 0U) || (elapsed < report_filter_table.max_interval[channel]))
+    {
+      last = report_filter_table.last_value[channel];
+      change = (value >= last) ? ((ULONG)value - (ULONG)last) : ((ULONG)last - (ULONG)value);
+      magnitude = (last >= 0) ? (ULONG)last : (0UL - (ULONG)last);
+      threshold = ((magnitude / 100U) * report_filter_table.deadband_percent[channel]) +
+                  (((magnitude % 100U) * report_filter_table.deadband_percent[channel]) / 100U);
+      if (threshold < report_filter_table.deadband[channel])
+      {
+        threshold = report_filter_table.deadband[channel];
+      }
+
+      if ((elapsed < report_filter_table.min_interval[channel]) || (change <= threshold))
+      {
+        report_filter_suppressed_count++;
+        return REPORT_FILTER_SKIP;
+      }
+    }
+  }
+
+  report_filter_table.last_value[channel] = value;
+  report_filter_table.last_time[channel] = now;
+  report_filter_table.sent |= (1UL << channel);
+
+  return REPORT_FILTER_SEND;
+}
+
+/**
+* @brief  Readings not sent since the start, within their deadband or their minimum interval.
+* @param  None
+* @retval Number of readings
+*/
+ULONG report_filter_suppressed(VOID)
+{
+  return report_filter_suppressed_count;
+}
+
+#endif /* REPORT_FILTER */
@@ -0,0 +1,59 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    report_filter.h
+  * @author  MCD Application Team
+  * @brief   Report by exception of the readings, ahead of the publisher
+  *
+  *          report_filter_check() is given each reading of a channel before it
+  *          is published, and tells whether it is worth a message: the first
+  *          reading of a channel always is, the next ones only once they moved
+  *          out of the deadband of the last reading sent, and no sooner than
+  *          the minimum interval after it. The deadband is the larger of an
+  *          absolute change and a percentage of the last reading sent. After
+  *          the maximum interval, a reading is sent whatever its change, so
+  *          that the subscribers know the channel is alive. A reading sent
+  *          becomes the reference of the next ones. The filter is not thread
+  *          safe, it is used from the publisher thread only.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __REPORT_FILTER_H__
+#define __REPORT_FILTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Decisions of report_filter_check() */
+#define REPORT_FILTER_SKIP            0U
+#define REPORT_FILTER_SEND            1U
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef REPORT_FILTER
+/* A channel not set reports every change, with no minimum nor maximum interval. */
+UINT  report_filter_channel_set(UINT channel, ULONG deadband, UINT deadband_percent,
+                                ULONG min_interval, ULONG max_interval);
+UINT  report_filter_check(UINT channel, LONG value);
+ULONG report_filter_suppressed(VOID);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __REPORT_FILTER_H__ */
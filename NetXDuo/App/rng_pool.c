@@ -0,0 +1,201 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    rng_pool.c
+  * @author  MCD Application Team
+  * @brief   Random numbers of the RNG peripheral, collected under interrupt
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rng_pool.h"
+#include "main.h"
+
+/* Private variables ---------------------------------------------------------*/
+extern RNG_HandleTypeDef hrng;
+
+/* Ring of random words, written by the interrupt and read by the threads. */
+static ULONG rng_pool_ring[RNG_POOL_SIZE];
+static volatile ULONG rng_pool_head;
+static volatile ULONG rng_pool_tail;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID rng_pool_restart(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start filling the pool. The RNG is initialized by MX_RNG_Init().
+* @param  None
+* @retval None
+*/
+VOID rng_pool_init(VOID)
+{
+  rng_pool_head = 0;
+  rng_pool_tail = 0;
+
+  if (HAL_RNG_GenerateRandomNumber_IT(&hrng) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/**
+* @brief  Take one random word from the pool.
+* @param  None
+* @retval 32-bit random number
+*/
+ULONG rng_pool_get(VOID)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG random_number;
+
+  TX_DISABLE
+  if (rng_pool_tail != rng_pool_head)
+  {
+    random_number = rng_pool_ring[rng_pool_tail & (RNG_POOL_SIZE - 1)];
+    rng_pool_tail++;
+
+    /* The interrupt stops on a full pool, restart it now that there is room. */
+    if (hrng.State == HAL_RNG_STATE_READY)
+    {
+      HAL_RNG_GenerateRandomNumber_IT(&hrng);
+    }
+  }
+  else
+  {
+    /* Pool drained, read the next word directly, the RNG gives one every 40 cycles of its 48 MHz clock.
+       Reading DR clears DRDY, the interrupt then finds nothing to do. */
+    while ((hrng.Instance -> SR & RNG_SR_DRDY) == 0)
+    {
+      if (hrng.Instance -> SR & (RNG_SR_SECS | RNG_SR_CECS))
+      {
+        rng_pool_restart();
+      }
+    }
+    random_number = hrng.Instance -> DR;
+  }
+  TX_RESTORE
+
+  return random_number;
+}
+
+/**
+* @brief  Copy the random words in the pool, without waiting for the RNG.
+* @param  buffer: destination
+* @param  length: bytes wanted
+* @retval Bytes copied, less than length when the pool ran out
+*/
+UINT rng_pool_get_bytes(VOID *buffer, UINT length)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UCHAR *buffer_ptr = (UCHAR *)buffer;
+  UINT copied = 0;
+  ULONG random_number;
+  UINT i;
+
+  TX_DISABLE
+  while ((copied < length) && (rng_pool_tail != rng_pool_head))
+  {
+    random_number = rng_pool_ring[rng_pool_tail & (RNG_POOL_SIZE - 1)];
+    rng_pool_tail++;
+
+    for (i = 0; (i < sizeof(ULONG)) && (copied < length); i++)
+    {
+      buffer_ptr[copied++] = (UCHAR)random_number;
+      random_number >>= 8;
+    }
+  }
+
+  /* The interrupt stops on a full pool, restart it now that there is room. */
+  if ((copied != 0U) && (hrng.State == HAL_RNG_STATE_READY))
+  {
+    HAL_RNG_GenerateRandomNumber_IT(&hrng);
+  }
+  TX_RESTORE
+
+  return copied;
+}
+
+/**
+* @brief  Fill a buffer with random bytes, from the pool then from the RNG directly once it is drained.
+* @param  buffer: destination
+* @param  length: number of bytes
+* @retval None
+*/
+VOID rng_pool_fill(VOID *buffer, UINT length)
+{
+  UCHAR *buffer_ptr = (UCHAR *)buffer;
+  UINT copied;
+  ULONG random_number;
+  UINT i;
+
+  copied = rng_pool_get_bytes(buffer_ptr, length);
+
+  while (copied < length)
+  {
+    random_number = rng_pool_get();
+
+    for (i = 0; (i < sizeof(ULONG)) && (copied < length); i++)
+    {
+      buffer_ptr[copied++] = (UCHAR)random_number;
+      random_number >>= 8;
+    }
+  }
+}
+
+/**
+* @brief  Data ready callback, store the word and ask for the next one unless the pool is full.
+* @param  hrng: RNG handle pointer
+* @param  random32bit: generated random number
+* @retval None
+*/
+void HAL_RNG_ReadyDataCallback(RNG_HandleTypeDef *hrng, uint32_t random32bit)
+{
+  rng_pool_ring[rng_pool_head & (RNG_POOL_SIZE - 1)] = random32bit;
+  rng_pool_head++;
+
+  if ((rng_pool_head - rng_pool_tail) < RNG_POOL_SIZE)
+  {
+    HAL_RNG_GenerateRandomNumber_IT(hrng);
+  }
+}
+
+/**
+* @brief  Error callback, restart the RNG after a seed or clock error.
+* @param  hrng: RNG handle pointer
+* @retval None
+*/
+void HAL_RNG_ErrorCallback(RNG_HandleTypeDef *hrng)
+{
+  rng_pool_restart();
+  HAL_RNG_GenerateRandomNumber_IT(hrng);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Recover from a seed or clock error: clear the error, then disable and enable the RNG
+*         so that it discards the faulty value and seeds itself again.
+* @param  None
+* @retval None
+*/
+static VOID rng_pool_restart(VOID)
+{
+  hrng.Instance -> SR &= ~(RNG_SR_SEIS | RNG_SR_CEIS);
+  __HAL_RNG_DISABLE(&hrng);
+  __HAL_RNG_ENABLE(&hrng);
+  hrng.State = HAL_RNG_STATE_READY;
+  __HAL_UNLOCK(&hrng);
+}
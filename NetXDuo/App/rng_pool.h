@@ -0,0 +1,54 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    rng_pool.h
+  * @author  MCD Application Team
+  * @brief   Random numbers of the RNG peripheral, collected under interrupt
+  *
+  *          The RNG is started once and its interrupt fills a ring of random
+  *          words in the background. rng_pool_get() takes one word from the
+  *          ring, so the callers do not wait for the peripheral unless the
+  *          ring was emptied faster than the RNG refills it. rng_pool_get() is
+  *          NX_RAND in nx_user.h, and through NX_CRYPTO_RAND the source of the
+  *          TLS random values. rng_pool_get_bytes() copies the words in the
+  *          ring and never waits, rng_pool_fill() reads the RNG for the rest:
+  *          it is NX_RAND_BYTES, which gives the random numbers of the ECDHE
+  *          keys and the DRBG entropy in one call.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __RNG_POOL_H__
+#define __RNG_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Random words kept ahead, a power of two */
+#define RNG_POOL_SIZE                 64
+
+/* Exported functions prototypes ---------------------------------------------*/
+VOID  rng_pool_init(VOID);
+ULONG rng_pool_get(VOID);
+UINT  rng_pool_get_bytes(VOID *buffer, UINT length);
+VOID  rng_pool_fill(VOID *buffer, UINT length);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __RNG_POOL_H__ */
@@ -0,0 +1,205 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    sensor_aggregate.c
+  * @author  MCD Application Team
+  * @brief   Statistics and band energies of a sensor batch, published instead of its samples
+  *
+  *          At kHz sample rates the raw batches take more of the uplink than
+  *          MQTT over TLS has to give, so with SENSOR_AGGREGATE the sampler
+  *          thread publishes a few numbers per batch instead: its minimum,
+  *          maximum, mean and RMS, and the energies of SENSOR_AGGREGATE_BANDS
+  *          frequency bands, enough to watch a vibration. They are computed by
+  *          the CMSIS-DSP kernels of Drivers/CMSIS/Lib/GCC, written for the
+  *          FPU of the Cortex-M4: the samples are converted to float, the mean
+  *          is taken out, so that the RMS is the one of the vibration and not
+  *          of the offset of the sensor, and a real FFT of the batch gives the
+  *          power of each frequency. The bands split the frequencies from 0 to
+  *          half the sample rate into equal widths, and each band sums the
+  *          power of its bins, scaled so that the bands add up to the square
+  *          of the RMS. The Nyquist bin, and the DC bin taken out with the
+  *          mean, are not counted. SENSOR_AGGREGATE_BANDS 0 leaves the FFT
+  *          out, with the statistics only.
+  *
+  *          A payload is the CBOR array [first sample, sample count, sample
+  *          period in microseconds, minimum, maximum, mean, RMS, [band
+  *          energy...]], the first three as in the raw payloads, the others
+  *          single precision floats in ADC counts, squared for the bands.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_aggregate.h"
+#include "cbor_writer.h"
+#include <stdint.h>
+
+#ifdef SENSOR_AGGREGATE
+
+#ifndef SENSOR_SAMPLING
+#error "SENSOR_AGGREGATE reduces the batches of SENSOR_SAMPLING, define it as well."
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/* The library ships without arm_math.h, the kernels used are declared as built in
+   it, the CMSIS-DSP release of the real FFT instance holding the complex one. */
+typedef float float32_t;
+
+typedef enum
+{
+  ARM_MATH_SUCCESS = 0
+} arm_status;
+
+typedef struct
+{
+  uint16_t fftLen;
+  const float32_t *pTwiddle;
+  const uint16_t *pBitRevTable;
+  uint16_t bitRevLength;
+} arm_cfft_instance_f32;
+
+typedef struct
+{
+  arm_cfft_instance_f32 Sint;
+  uint16_t fftLenRFFT;
+  float32_t *pTwiddleRFFT;
+} arm_rfft_fast_instance_f32;
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+void arm_cmplx_mag_squared_f32(float32_t *pSrc, float32_t *pDst, uint32_t numSamples);
+void arm_min_f32(float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex);
+void arm_max_f32(float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex);
+void arm_mean_f32(float32_t *pSrc, uint32_t blockSize, float32_t *pResult);
+void arm_rms_f32(float32_t *pSrc, uint32_t blockSize, float32_t *pResult);
+void arm_offset_f32(float32_t *pSrc, float32_t offset, float32_t *pDst, uint32_t blockSize);
+
+/* Private define ------------------------------------------------------------*/
+#define SENSOR_AGGREGATE_ITEMS        8U
+
+/* FFT bins from 0 to half the sample rate, and bins per band */
+#define SENSOR_AGGREGATE_BINS         (SENSOR_BATCH_SAMPLES / 2)
+#define SENSOR_AGGREGATE_BAND_BINS    (SENSOR_AGGREGATE_BINS / ((SENSOR_AGGREGATE_BANDS > 0) ? SENSOR_AGGREGATE_BANDS : 1))
+
+/* Power of a bin to its share of the mean square, both halves of the spectrum counted */
+#define SENSOR_AGGREGATE_BAND_SCALE   (2.0f / ((float32_t)SENSOR_BATCH_SAMPLES * (float32_t)SENSOR_BATCH_SAMPLES))
+
+#if (SENSOR_AGGREGATE_BANDS > 0) && ((SENSOR_BATCH_SAMPLES < 32) || (SENSOR_BATCH_SAMPLES > 4096) || \
+                                     ((SENSOR_BATCH_SAMPLES & (SENSOR_BATCH_SAMPLES - 1)) != 0))
+#error "SENSOR_BATCH_SAMPLES must be a power of two from 32 to 4096 for the FFT of the bands."
+#endif
+
+#if (SENSOR_AGGREGATE_BANDS > 23) || ((SENSOR_AGGREGATE_BANDS > 0) && ((SENSOR_AGGREGATE_BINS % SENSOR_AGGREGATE_BANDS) != 0))
+#error "SENSOR_AGGREGATE_BANDS must divide SENSOR_BATCH_SAMPLES / 2, 23 at most."
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* Only the sampler thread computes, a batch at a time. */
+static float32_t sensor_aggregate_samples[SENSOR_BATCH_SAMPLES] CCMRAM_BSS;
+
+#if (SENSOR_AGGREGATE_BANDS > 0)
+static arm_rfft_fast_instance_f32 sensor_aggregate_fft;
+static float32_t sensor_aggregate_spectrum[SENSOR_BATCH_SAMPLES] CCMRAM_BSS;
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Set up the real FFT of the batches, its twiddle and bit reversal tables.
+* @param  None
+* @retval TX_SUCCESS, or TX_SIZE_ERROR when the library has no FFT of SENSOR_BATCH_SAMPLES
+*/
+UINT sensor_aggregate_init(VOID)
+{
+#if (SENSOR_AGGREGATE_BANDS > 0)
+  if (arm_rfft_fast_init_f32(&sensor_aggregate_fft, SENSOR_BATCH_SAMPLES) != ARM_MATH_SUCCESS)
+  {
+    return TX_SIZE_ERROR;
+  }
+#endif
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Compute the statistics and band energies of a batch and encode them as the payload.
+* @param  samples: SENSOR_BATCH_SAMPLES samples of the batch
+* @param  first_sample: index of the first sample since the start
+* @param  sample_period: sample period in microseconds
+* @param  payload_ptr: buffer of the payload
+* @param  payload_size: size of the buffer, SENSOR_AGGREGATE_PAYLOAD_SIZE
+* @param  payload_length_ptr: length of the payload encoded
+* @retval CBOR_WRITER_SUCCESS or CBOR_WRITER_OVERFLOW
+*/
+UINT sensor_aggregate_encode(const USHORT *samples, ULONG first_sample, UINT sample_period,
+                             UCHAR *payload_ptr, UINT payload_size, UINT *payload_length_ptr)
+{
+  CBOR_WRITER writer;
+  float32_t minimum;
+  float32_t maximum;
+  float32_t mean;
+  float32_t rms;
+  uint32_t index;
+  UINT i;
+#if (SENSOR_AGGREGATE_BANDS > 0)
+  float32_t energy;
+  UINT band;
+#endif
+
+  for (i = 0; i < SENSOR_BATCH_SAMPLES; i++)
+  {
+    sensor_aggregate_samples[i] = (float32_t)samples[i];
+  }
+
+  arm_min_f32(sensor_aggregate_samples, SENSOR_BATCH_SAMPLES, &minimum, &index);
+  arm_max_f32(sensor_aggregate_samples, SENSOR_BATCH_SAMPLES, &maximum, &index);
+  arm_mean_f32(sensor_aggregate_samples, SENSOR_BATCH_SAMPLES, &mean);
+
+  /* The RMS and the spectrum of the vibration, without the offset of the sensor. */
+  arm_offset_f32(sensor_aggregate_samples, -mean, sensor_aggregate_samples, SENSOR_BATCH_SAMPLES);
+  arm_rms_f32(sensor_aggregate_samples, SENSOR_BATCH_SAMPLES, &rms);
+
+  cbor_writer_init(&writer, payload_ptr, payload_size);
+  cbor_encode_array(&writer, SENSOR_AGGREGATE_ITEMS);
+  cbor_encode_uint(&writer, first_sample);
+  cbor_encode_uint(&writer, SENSOR_BATCH_SAMPLES);
+  cbor_encode_uint(&writer, sample_period);
+  cbor_encode_float(&writer, minimum);
+  cbor_encode_float(&writer, maximum);
+  cbor_encode_float(&writer, mean);
+  cbor_encode_float(&writer, rms);
+  cbor_encode_array(&writer, SENSOR_AGGREGATE_BANDS);
+
+#if (SENSOR_AGGREGATE_BANDS > 0)
+  /* The FFT works in place on its input. Its output starts with the DC and Nyquist bins, both real,
+     in the place of the first complex bin, which is dropped. */
+  arm_rfft_fast_f32(&sensor_aggregate_fft, sensor_aggregate_samples, sensor_aggregate_spectrum, 0);
+  arm_cmplx_mag_squared_f32(sensor_aggregate_spectrum, sensor_aggregate_spectrum, SENSOR_AGGREGATE_BINS);
+  sensor_aggregate_spectrum[0] = 0.0f;
+
+  for (band = 0; band < SENSOR_AGGREGATE_BANDS; band++)
+  {
+    energy = 0.0f;
+    for (i = band * SENSOR_AGGREGATE_BAND_BINS; i < ((band + 1U) * SENSOR_AGGREGATE_BAND_BINS); i++)
+    {
+      energy += sensor_aggregate_spectrum[i];
+    }
+
+    cbor_encode_float(&writer, energy * SENSOR_AGGREGATE_BAND_SCALE);
+  }
+#endif
+
+  return cbor_writer_finish(&writer, payload_length_ptr);
+}
+
+#endif /* SENSOR_AGGREGATE */
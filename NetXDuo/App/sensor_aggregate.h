@@ -0,0 +1,46 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    sensor_aggregate.h
+  * @author  MCD Application Team
+  * @brief   Statistics and band energies of a sensor batch, published instead of its samples
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SENSOR_AGGREGATE_H__
+#define __SENSOR_AGGREGATE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Payload of a batch at its longest: the array and its 7 items, first sample 5 bytes,
+   count and period 3 bytes each, the 4 statistics 5 bytes each, then the array of the bands */
+#define SENSOR_AGGREGATE_PAYLOAD_SIZE (1 + 5 + 3 + 3 + (4 * 5) + 1 + (SENSOR_AGGREGATE_BANDS * 5))
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef SENSOR_AGGREGATE
+UINT sensor_aggregate_init(VOID);
+UINT sensor_aggregate_encode(const USHORT *samples, ULONG first_sample, UINT sample_period,
+                             UCHAR *payload_ptr, UINT payload_size, UINT *payload_length_ptr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SENSOR_AGGREGATE_H__ */
@@ -0,0 +1,441 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    sensor_sampler.c
+  * @author  MCD Application Team
+  * @brief   Sensor samples taken by the ADC at a fixed rate, published in batches
+  *
+  *          The update of TIM2 triggers each conversion of ADC1 on channel 3,
+  *          the A0 pin PA3 of the Nucleo-144, at SENSOR_SAMPLE_RATE, and DMA2
+  *          stream 0 writes the results into a circular buffer of two halves
+  *          of SENSOR_BATCH_SAMPLES samples. The CPU is not involved per
+  *          sample: only the half transfer and transfer complete interrupts
+  *          hand the half just filled to the sampler thread, through an SPSC
+  *          ring. The thread copies the half into the payload of one MQTT
+  *          message while the DMA fills the other half, and commits it to the
+  *          publisher through a block channel, without another copy. The
+  *          sampling never waits for the network: when the publisher falls
+  *          SENSOR_PAYLOAD_COUNT payloads behind, or when the thread does not
+  *          copy a half before the DMA comes back to it, the batch is dropped
+  *          and counted.
+  *
+  *          A payload is, little endian: the index of its first sample since
+  *          the start, 4 bytes, the number of samples, 2 bytes, the sample
+  *          period in microseconds, 2 bytes, then the 12-bit samples, 2 bytes
+  *          each. With SENSOR_AGGREGATE, the thread encodes the statistics
+  *          of the half instead, see sensor_aggregate.c, a few tens of bytes
+  *          whatever the batch.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_sampler.h"
+#include "spsc_ring.h"
+#include "block_channel.h"
+#include "publish_store.h"
+#include "thread_profile.h"
+#include "cbor_writer.h"
+#include "payload_compress.h"
+#include "app_threadx.h"
+#include <string.h>
+
+#ifdef SENSOR_SAMPLING
+
+/* Private define ------------------------------------------------------------*/
+/* TIM2 counts microseconds, its update triggers the conversions */
+#define SENSOR_TIMER_CLOCK            1000000U
+#define SENSOR_SAMPLE_PERIOD          (SENSOR_TIMER_CLOCK / SENSOR_SAMPLE_RATE)
+
+/* Halves filled and not taken yet: the thread runs late when more are waiting, the DMA
+   is then writing into the oldest one */
+#define SENSOR_RING_SIZE              (4U * 2U * sizeof(ULONG))
+#define SENSOR_HALF_EVENT             0x01U
+
+#if (SENSOR_PAYLOAD_SIZE > PUBLISH_STORE_MESSAGE_MAX) || \
+    (defined(PAYLOAD_COMPRESS) && (PAYLOAD_COMPRESS_BOUND(SENSOR_PAYLOAD_SIZE) > PUBLISH_STORE_MESSAGE_MAX))
+#error "SENSOR_BATCH_SAMPLES must keep a payload within a record of the publish store."
+#endif
+
+#if ((SENSOR_TIMER_CLOCK % SENSOR_SAMPLE_RATE) != 0) || (SENSOR_SAMPLE_PERIOD > 0xFFFF)
+#error "SENSOR_SAMPLE_RATE must divide 1 MHz, 16 Hz at least."
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static ADC_HandleTypeDef sensor_adc;
+static DMA_HandleTypeDef sensor_dma;
+static TIM_HandleTypeDef sensor_timer;
+
+/* Written by the DMA, so out of the CCM-RAM. */
+static USHORT sensor_samples[2 * SENSOR_BATCH_SAMPLES] DMA_RAM;
+
+/* Halves filled since the start, the number of the next one. */
+static volatile ULONG sensor_half_count;
+
+static SPSC_RING sensor_ring;
+static ULONG sensor_ring_storage[SENSOR_RING_SIZE / sizeof(ULONG)];
+static TX_EVENT_FLAGS_GROUP sensor_events;
+
+/* Payloads encoded in place, handed to the publisher without a copy. */
+static BLOCK_CHANNEL sensor_payload_channel;
+static ULONG sensor_payload_memory[BLOCK_CHANNEL_POOL_SIZE(SENSOR_PAYLOAD_SIZE, SENSOR_PAYLOAD_COUNT) / sizeof(ULONG)] CCMRAM_BSS;
+static ULONG sensor_payload_queue_storage[BLOCK_CHANNEL_QUEUE_SIZE(SENSOR_PAYLOAD_COUNT) / sizeof(ULONG)];
+
+static ULONG sensor_dropped;
+
+static TX_THREAD sensor_thread;
+static ULONG sensor_thread_stack[SENSOR_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID sensor_thread_entry(ULONG thread_input);
+static VOID sensor_half_filled(ULONG half);
+static UINT sensor_hardware_init(VOID);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Create the payload pool and the sampler thread, then start the conversions.
+* @param  None
+* @retval TX_SUCCESS, the error of the object creation, or TX_START_ERROR when the ADC does not start
+*/
+UINT sensor_sampler_start(VOID)
+{
+  UINT ret;
+
+#ifdef SENSOR_AGGREGATE
+  ret = sensor_aggregate_init();
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+#endif
+
+  ret = block_channel_create(&sensor_payload_channel, "Sensor payload channel", SENSOR_PAYLOAD_SIZE,
+                             sensor_payload_memory, sizeof(sensor_payload_memory),
+                             sensor_payload_queue_storage, sizeof(sensor_payload_queue_storage));
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_event_flags_create(&sensor_events, "Sensor events");
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = spsc_ring_create(&sensor_ring, 2, sensor_ring_storage, sizeof(sensor_ring_storage));
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+  spsc_ring_notify_set(&sensor_ring, &sensor_events, SENSOR_HALF_EVENT);
+
+  ret = tx_thread_create(&sensor_thread, "Sensor sampler thread", sensor_thread_entry, 0,
+                         sensor_thread_stack, sizeof(sensor_thread_stack),
+                         SENSOR_PRIORITY, SENSOR_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+#ifdef SENSOR_AGGREGATE
+  /* The statistics and the bands are computed on the FPU. */
+  App_ThreadX_FPU_Enable(&sensor_thread);
+#endif
+
+  ret = tx_thread_resume(&sensor_thread);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  return sensor_hardware_init();
+}
+
+/**
+* @brief  Take the oldest payload encoded.
+* @param  payload_ptr: payload, to give back with sensor_sampler_payload_release()
+* @param  payload_length_ptr: length of the payload
+* @param  wait_option: ticks to wait for a payload, TX_NO_WAIT or TX_WAIT_FOREVER
+* @retval TX_SUCCESS or TX_QUEUE_EMPTY
+*/
+UINT sensor_sampler_payload_get(UCHAR **payload_ptr, UINT *payload_length_ptr, ULONG wait_option)
+{
+  ULONG length;
+  UINT ret;
+
+  ret = block_channel_receive(&sensor_payload_channel, (VOID **)payload_ptr, &length, wait_option);
+  if (ret == TX_SUCCESS)
+  {
+    *payload_length_ptr = (UINT)length;
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Give a payload back to the pool, once it is copied.
+* @param  payload_ptr: payload of sensor_sampler_payload_get()
+* @retval None
+*/
+VOID sensor_sampler_payload_release(UCHAR *payload_ptr)
+{
+  block_channel_release(payload_ptr);
+}
+
+/**
+* @brief  Batches dropped since the start, the publisher or the sampler thread being late.
+* @param  None
+* @retval Number of batches
+*/
+ULONG sensor_sampler_dropped(VOID)
+{
+  return sensor_dropped;
+}
+
+/**
+* @brief  The DMA filled the first half of the buffer, it goes on with the second.
+* @param  hadc: ADC handle
+* @retval None
+*/
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  NX_PARAMETER_NOT_USED(hadc);
+  sensor_half_filled(0);
+}
+
+/**
+* @brief  The DMA filled the second half of the buffer, it starts the first again.
+* @param  hadc: ADC handle
+* @retval None
+*/
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  NX_PARAMETER_NOT_USED(hadc);
+  sensor_half_filled(1);
+}
+
+/**
+* @brief  This function handles DMA2 stream0 global interrupt, the ADC1 conversions.
+* @param  None
+* @retval None
+*/
+void DMA2_Stream0_IRQHandler(void)
+{
+  THREAD_PROFILE_ISR_ENTER();
+  HAL_DMA_IRQHandler(&sensor_dma);
+  THREAD_PROFILE_ISR_EXIT();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Hand a half filled to the thread, with its number. Called from the DMA interrupt.
+* @param  half: 0 for the first half of the buffer, 1 for the second
+* @retval None
+*/
+static VOID sensor_half_filled(ULONG half)
+{
+  ULONG message[2];
+
+  message[0] = half;
+  message[1] = sensor_half_count;
+  sensor_half_count++;
+
+  if (spsc_ring_send(&sensor_ring, message) != TX_SUCCESS)
+  {
+    sensor_dropped++;
+  }
+}
+
+/**
+* @brief  Sampler thread entry, copy or aggregate each half filled into a payload and queue it for the publisher.
+* @param  thread_input: not used
+* @retval None
+*/
+static VOID sensor_thread_entry(ULONG thread_input)
+{
+  ULONG message[2];
+  UCHAR *payload_ptr;
+  ULONG first_sample;
+#ifdef SENSOR_AGGREGATE
+  UINT payload_length;
+#else
+  const UINT payload_length = SENSOR_PAYLOAD_SIZE;
+#endif
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  for (;;)
+  {
+    if (spsc_ring_receive(&sensor_ring, message, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      continue;
+    }
+
+    /* The publisher is late, the sampling goes on without this batch. */
+    if (block_channel_reserve(&sensor_payload_channel, (VOID **)&payload_ptr, TX_NO_WAIT) != TX_SUCCESS)
+    {
+      sensor_dropped++;
+      continue;
+    }
+
+    first_sample = message[1] * SENSOR_BATCH_SAMPLES;
+#ifdef SENSOR_AGGREGATE
+    if (sensor_aggregate_encode(&sensor_samples[message[0] * SENSOR_BATCH_SAMPLES], first_sample,
+                                SENSOR_SAMPLE_PERIOD, payload_ptr, SENSOR_PAYLOAD_SIZE,
+                                &payload_length) != CBOR_WRITER_SUCCESS)
+    {
+      block_channel_release(payload_ptr);
+      sensor_dropped++;
+      continue;
+    }
+#else
+    payload_ptr[0] = (UCHAR)first_sample;
+    payload_ptr[1] = (UCHAR)(first_sample >> 8);
+    payload_ptr[2] = (UCHAR)(first_sample >> 16);
+    payload_ptr[3] = (UCHAR)(first_sample >> 24);
+    payload_ptr[4] = (UCHAR)SENSOR_BATCH_SAMPLES;
+    payload_ptr[5] = (UCHAR)(SENSOR_BATCH_SAMPLES >> 8);
+    payload_ptr[6] = (UCHAR)SENSOR_SAMPLE_PERIOD;
+    payload_ptr[7] = (UCHAR)(SENSOR_SAMPLE_PERIOD >> 8);
+
+    /* The samples are little endian already, as in the payload. */
+    memcpy(&payload_ptr[SENSOR_PAYLOAD_HEADER_SIZE], &sensor_samples[message[0] * SENSOR_BATCH_SAMPLES],
+           SENSOR_BATCH_SAMPLES * sizeof(USHORT));
+#endif
+
+    /* The next half filled as well, the DMA came back to this one during the copy or the computation. */
+    if ((sensor_half_count - message[1]) >= 2U)
+    {
+      block_channel_release(payload_ptr);
+      sensor_dropped++;
+      continue;
+    }
+
+    block_channel_commit(&sensor_payload_channel, payload_ptr, payload_length);
+  }
+}
+
+/**
+* @brief  Set up TIM2, ADC1 and its DMA stream, then start the conversions.
+* @param  None
+* @retval TX_SUCCESS or TX_START_ERROR
+*/
+static UINT sensor_hardware_init(VOID)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  ADC_ChannelConfTypeDef sConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  ULONG timer_clock;
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_ADC1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+  __HAL_RCC_TIM2_CLK_ENABLE();
+
+  /**ADC1 GPIO Configuration
+  PA3     ------> ADC1_IN3
+  */
+  GPIO_InitStruct.Pin = GPIO_PIN_3;
+  GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  /* ADC1 DMA Init, circular over both halves */
+  sensor_dma.Instance = DMA2_Stream0;
+  sensor_dma.Init.Channel = DMA_CHANNEL_0;
+  sensor_dma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  sensor_dma.Init.PeriphInc = DMA_PINC_DISABLE;
+  sensor_dma.Init.MemInc = DMA_MINC_ENABLE;
+  sensor_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  sensor_dma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+  sensor_dma.Init.Mode = DMA_CIRCULAR;
+  sensor_dma.Init.Priority = DMA_PRIORITY_HIGH;
+  sensor_dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+  if (HAL_DMA_Init(&sensor_dma) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+  __HAL_LINKDMA(&sensor_adc, DMA_Handle, sensor_dma);
+
+  HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 9, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+  /* One conversion per trigger, PCLK2 / 4 = 22.5 MHz */
+  sensor_adc.Instance = ADC1;
+  sensor_adc.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
+  sensor_adc.Init.Resolution = ADC_RESOLUTION_12B;
+  sensor_adc.Init.ScanConvMode = DISABLE;
+  sensor_adc.Init.ContinuousConvMode = DISABLE;
+  sensor_adc.Init.DiscontinuousConvMode = DISABLE;
+  sensor_adc.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+  sensor_adc.Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T2_TRGO;
+  sensor_adc.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+  sensor_adc.Init.NbrOfConversion = 1;
+  sensor_adc.Init.DMAContinuousRequests = ENABLE;
+  sensor_adc.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+  if (HAL_ADC_Init(&sensor_adc) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  sConfig.Channel = ADC_CHANNEL_3;
+  sConfig.Rank = 1;
+  sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;
+  if (HAL_ADC_ConfigChannel(&sensor_adc, &sConfig) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  /* The APB1 timers run at twice PCLK1 when it is divided. */
+  timer_clock = HAL_RCC_GetPCLK1Freq();
+  if ((RCC -> CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+  {
+    timer_clock *= 2U;
+  }
+
+  sensor_timer.Instance = TIM2;
+  sensor_timer.Init.Prescaler = (timer_clock / SENSOR_TIMER_CLOCK) - 1U;
+  sensor_timer.Init.CounterMode = TIM_COUNTERMODE_UP;
+  sensor_timer.Init.Period = SENSOR_SAMPLE_PERIOD - 1U;
+  sensor_timer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  sensor_timer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&sensor_timer) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&sensor_timer, &sMasterConfig) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  if (HAL_ADC_Start_DMA(&sensor_adc, (uint32_t *)sensor_samples, 2 * SENSOR_BATCH_SAMPLES) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  /* The timer comes last, the first trigger finds the ADC waiting for it. */
+  if (HAL_TIM_Base_Start(&sensor_timer) != HAL_OK)
+  {
+    return TX_START_ERROR;
+  }
+
+  return TX_SUCCESS;
+}
+
+#endif /* SENSOR_SAMPLING */
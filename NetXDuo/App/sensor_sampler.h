@@ -0,0 +1,55 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    sensor_sampler.h
+  * @author  MCD Application Team
+  * @brief   Sensor samples taken by the ADC at a fixed rate, published in batches
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SENSOR_SAMPLER_H__
+#define __SENSOR_SAMPLER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+#include "sensor_aggregate.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Payload of a batch: the index of its first sample and the sample count, then the samples,
+   or with SENSOR_AGGREGATE their statistics, at most SENSOR_PAYLOAD_SIZE */
+#define SENSOR_PAYLOAD_HEADER_SIZE    8
+#ifdef SENSOR_AGGREGATE
+#define SENSOR_PAYLOAD_SIZE           SENSOR_AGGREGATE_PAYLOAD_SIZE
+#else
+#define SENSOR_PAYLOAD_SIZE           (SENSOR_PAYLOAD_HEADER_SIZE + (SENSOR_BATCH_SAMPLES * 2))
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef SENSOR_SAMPLING
+/* Starts the sampling and the thread encoding the batches. The payloads are taken by the
+   publisher with sensor_sampler_payload_get() and given back with sensor_sampler_payload_release(). */
+UINT  sensor_sampler_start(VOID);
+UINT  sensor_sampler_payload_get(UCHAR **payload_ptr, UINT *payload_length_ptr, ULONG wait_option);
+VOID  sensor_sampler_payload_release(UCHAR *payload_ptr);
+ULONG sensor_sampler_dropped(VOID);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SENSOR_SAMPLER_H__ */
@@ -0,0 +1,318 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    telemetry_dtls.c
+  * @author  MCD Application Team
+  * @brief   Fire and forget telemetry to an MQTT-SN gateway over DTLS
+  *
+  *          The readings are sent as MQTT-SN QoS -1 PUBLISH messages (MQTT-SN
+  *          1.2, section 6.8), which need neither a connection to the gateway
+  *          nor an acknowledgement, in DTLS 1.2 records over UDP. A lost
+  *          datagram loses its own readings only: no later message waits for
+  *          its retransmission and no ACK flows back, unlike with MQTT over TCP.
+  *
+  *          Each PUBLISH carries TELEMETRY_READINGS readings on the
+  *          topic ID TELEMETRY_TOPIC_ID, predefined on the gateway. Its data is
+  *          the ThreadX time of the first reading, 4 bytes big endian, then one
+  *          byte per reading, taken every TELEMETRY_SAMPLE_INTERVAL ticks.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry_dtls.h"
+#include "dns_resolver.h"
+#include "clock_governor.h"
+#include "nx_secure_dtls_api.h"
+
+#ifdef TELEMETRY_DTLS
+
+/* Private define ------------------------------------------------------------*/
+#define MQTTSN_PUBLISH                0x0C
+#define MQTTSN_FLAG_QOS_MINUS_ONE     0x60
+#define MQTTSN_FLAG_TOPIC_PREDEFINED  0x01
+#define MQTTSN_PUBLISH_HEADER_SIZE    7     /* Length, type, flags, topic ID and message ID */
+
+#define TELEMETRY_PUBLISH_SIZE        (MQTTSN_PUBLISH_HEADER_SIZE + 4 + TELEMETRY_READINGS)
+
+#if (TELEMETRY_PUBLISH_SIZE > 255)
+#error "TELEMETRY_READINGS must keep the PUBLISH length on one byte."
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+extern const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers_ecc;
+extern const USHORT nx_crypto_ecc_supported_groups[];
+extern const NX_CRYPTO_METHOD *nx_crypto_ecc_curves[];
+extern const UINT nx_crypto_ecc_supported_groups_size;
+#else
+extern const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers;
+#endif
+
+static TX_THREAD telemetry_thread;
+static ULONG telemetry_thread_stack[TELEMETRY_STACK_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+
+static NX_IP *telemetry_ip_ptr;
+static NX_PACKET_POOL *telemetry_pool_ptr;
+
+static NX_UDP_SOCKET telemetry_socket;
+static NX_SECURE_DTLS_SESSION telemetry_session;
+
+/* Crypto metadata and handshake reassembly buffer of the DTLS session. With the
+   PSK ciphersuites no certificate is received, so the buffer stays small. */
+static ULONG telemetry_metadata[CRYPTO_METADATA_CLIENT_SIZE / sizeof(ULONG)] CCMRAM_BSS;
+static UCHAR telemetry_packet_buffer[TELEMETRY_BUFFER_SIZE] CCMRAM_BSS;
+
+/* PUBLISH message the readings are gathered in. */
+static UCHAR telemetry_publish[TELEMETRY_PUBLISH_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Create the DTLS session with the PSK shared with the gateway, once for all the connections.
+* @retval NX_SUCCESS or the error of the session setup
+*/
+static UINT telemetry_session_setup(VOID)
+{
+  UINT ret;
+
+  nx_secure_dtls_initialize();
+
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+  ret = nx_secure_dtls_session_create(&telemetry_session, &nx_crypto_tls_ciphers_ecc,
+                                      telemetry_metadata, sizeof(telemetry_metadata),
+                                      telemetry_packet_buffer, sizeof(telemetry_packet_buffer), 0, NX_NULL, 0);
+#else
+  ret = nx_secure_dtls_session_create(&telemetry_session, &nx_crypto_tls_ciphers,
+                                      telemetry_metadata, sizeof(telemetry_metadata),
+                                      telemetry_packet_buffer, sizeof(telemetry_packet_buffer), 0, NX_NULL, 0);
+#endif
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+#ifdef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+  /* The table also holds the ECDHE ciphersuites, give them their curves */
+  ret = nx_secure_dtls_ecc_initialize(&telemetry_session, nx_crypto_ecc_supported_groups,
+                                      nx_crypto_ecc_supported_groups_size, nx_crypto_ecc_curves);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+#endif
+
+  return nx_secure_dtls_psk_add(&telemetry_session, (UCHAR *)TELEMETRY_PSK_KEY, STRLEN(TELEMETRY_PSK_KEY),
+                                (UCHAR *)TELEMETRY_PSK_IDENTITY, STRLEN(TELEMETRY_PSK_IDENTITY), NX_NULL, 0);
+}
+
+/**
+* @brief  Resolve the gateway and run the DTLS handshake with it.
+* @param  server_ip: address of the gateway, set
+* @retval NX_SUCCESS or the error of the resolution or of the handshake
+*/
+static UINT telemetry_connect(NXD_ADDRESS *server_ip)
+{
+  UINT ret;
+
+  /* The address of the MQTT broker name is kept, it costs no query when the names are the same */
+  server_ip -> nxd_ip_version = 4;
+  ret = dns_resolver_host_get(TELEMETRY_SERVER_NAME, &server_ip -> nxd_ip_address.v4, DEFAULT_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  /* The handshake at full speed */
+  clock_governor_boost();
+  ret = nx_secure_dtls_client_session_start(&telemetry_session, &telemetry_socket, server_ip,
+                                            TELEMETRY_PORT, TELEMETRY_CONNECT_TIMEOUT);
+  clock_governor_release();
+
+  return ret;
+}
+
+/**
+* @brief  Take TELEMETRY_READINGS readings into the PUBLISH message.
+* @retval None
+*/
+static VOID telemetry_readings_collect(VOID)
+{
+  ULONG time_stamp = tx_time_get();
+  uint32_t reading;
+  UINT i;
+
+  telemetry_publish[0] = TELEMETRY_PUBLISH_SIZE;
+  telemetry_publish[1] = MQTTSN_PUBLISH;
+  telemetry_publish[2] = MQTTSN_FLAG_QOS_MINUS_ONE | MQTTSN_FLAG_TOPIC_PREDEFINED;
+  telemetry_publish[3] = (UCHAR)(TELEMETRY_TOPIC_ID >> 8);
+  telemetry_publish[4] = (UCHAR)(TELEMETRY_TOPIC_ID & 0xFF);
+
+  /* Messages of QoS -1 have no message ID */
+  telemetry_publish[5] = 0;
+  telemetry_publish[6] = 0;
+
+  telemetry_publish[7] = (UCHAR)(time_stamp >> 24);
+  telemetry_publish[8] = (UCHAR)(time_stamp >> 16);
+  telemetry_publish[9] = (UCHAR)(time_stamp >> 8);
+  telemetry_publish[10] = (UCHAR)time_stamp;
+
+  for (i = 0; i < TELEMETRY_READINGS; i++)
+  {
+    if (i != 0)
+    {
+      tx_thread_sleep(TELEMETRY_SAMPLE_INTERVAL);
+    }
+
+    message_generate(&reading);
+    telemetry_publish[MQTTSN_PUBLISH_HEADER_SIZE + 4 + i] = (UCHAR)reading;
+  }
+}
+
+/**
+* @brief  Send the PUBLISH message in one DTLS record.
+* @param  server_ip: address of the gateway
+* @retval NX_SUCCESS or the error of the allocation or of the send
+*/
+static UINT telemetry_publish_send(NXD_ADDRESS *server_ip)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  /* Do not wait for a packet, the readings are late already when the pool is empty */
+  ret = nx_secure_dtls_packet_allocate(&telemetry_session, telemetry_pool_ptr, &packet_ptr, TX_NO_WAIT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet_ptr, telemetry_publish, sizeof(telemetry_publish),
+                              telemetry_pool_ptr, TX_NO_WAIT);
+
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_secure_dtls_session_send(&telemetry_session, packet_ptr, server_ip, TELEMETRY_PORT);
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Discard the records sent by the gateway, the publishes expect no answer.
+* @retval NX_SUCCESS, or the error of the session once the gateway has closed or lost it
+*/
+static UINT telemetry_receive_drain(VOID)
+{
+  NX_PACKET *packet_ptr;
+  UINT ret;
+
+  while ((ret = nx_secure_dtls_session_receive(&telemetry_session, &packet_ptr, TX_NO_WAIT)) == NX_SUCCESS)
+  {
+    nx_packet_release(packet_ptr);
+  }
+
+  return (ret == NX_NO_PACKET) ? NX_SUCCESS : ret;
+}
+
+/**
+* @brief  Telemetry thread entry.
+* @param  thread_input: ULONG user argument used by the thread entry
+* @retval none
+*/
+static VOID telemetry_thread_entry(ULONG thread_input)
+{
+  NXD_ADDRESS server_ip;
+  UINT connected = NX_FALSE;
+  ULONG session_start = 0;
+  UINT ret;
+
+  NX_PARAMETER_NOT_USED(thread_input);
+
+  ret = nx_udp_socket_create(telemetry_ip_ptr, &telemetry_socket, "Telemetry Socket", NX_IP_NORMAL,
+                             NX_DONT_FRAGMENT, NX_IP_TIME_TO_LIVE, TELEMETRY_SOCKET_QUEUE);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_udp_socket_bind(&telemetry_socket, NX_ANY_PORT, TX_WAIT_FOREVER);
+  }
+
+  if (ret == NX_SUCCESS)
+  {
+    ret = telemetry_session_setup();
+  }
+
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
+
+  while (1)
+  {
+    if (!connected)
+    {
+      ret = telemetry_connect(&server_ip);
+      if (ret != NX_SUCCESS)
+      {
+        printf("DTLS handshake with < %s > failed: 0x%x\n", TELEMETRY_SERVER_NAME, ret);
+        nx_secure_dtls_session_reset(&telemetry_session);
+        tx_thread_sleep(TELEMETRY_RETRY_INTERVAL);
+        continue;
+      }
+
+      connected = NX_TRUE;
+      session_start = tx_time_get();
+    }
+
+    telemetry_readings_collect();
+
+    /* A send that fails drops its readings, the next ones go out on a new session */
+    ret = telemetry_publish_send(&server_ip);
+
+    if (ret == NX_SUCCESS)
+    {
+      ret = telemetry_receive_drain();
+    }
+
+    /* Renew the session periodically, in case the gateway has lost it silently */
+    if ((ret != NX_SUCCESS) || ((tx_time_get() - session_start) >= TELEMETRY_SESSION_LIFETIME))
+    {
+      nx_secure_dtls_session_end(&telemetry_session, TX_NO_WAIT);
+      nx_secure_dtls_session_reset(&telemetry_session);
+      connected = NX_FALSE;
+    }
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Start the telemetry thread.
+* @param  ip_ptr: IP instance, with its address set
+* @param  pool_ptr: packet pool of the datagrams
+* @retval NX_SUCCESS or the error of the thread creation
+*/
+UINT telemetry_dtls_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr)
+{
+  telemetry_ip_ptr = ip_ptr;
+  telemetry_pool_ptr = pool_ptr;
+
+  return tx_thread_create(&telemetry_thread, "App Telemetry Thread", telemetry_thread_entry, 0,
+                          telemetry_thread_stack, sizeof(telemetry_thread_stack),
+                          TELEMETRY_PRIORITY, TELEMETRY_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+#endif /* TELEMETRY_DTLS */
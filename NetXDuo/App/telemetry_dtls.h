@@ -0,0 +1,39 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    telemetry_dtls.h
+  * @author  MCD Application Team
+  * @brief   Fire and forget telemetry to an MQTT-SN gateway over DTLS
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TELEMETRY_DTLS_H__
+#define __TELEMETRY_DTLS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Starts the telemetry thread once the IP address is set, next to the MQTT client.
+   The gateway is resolved by the DNS resolver shared with it. */
+UINT telemetry_dtls_start(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TELEMETRY_DTLS_H__ */
@@ -0,0 +1,550 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tls_benchmark.c
+  * @author  MCD Application Team
+  * @brief   TLS handshake and record layer timings against an OpenSSL server
+  *
+  *          Once the interface has its address, the board connects to the
+  *          OpenSSL s_server started by Utilities/tls_benchmark.py server, and
+  *          for each ciphersuite of the ECC table, offered alone:
+  *           - runs TLS_BENCHMARK_HANDSHAKES handshakes with
+  *             nx_secure_tls_session_start, TLS 1.3 for its own ciphersuites,
+  *             TLS 1.2 for the others. Each one reports its duration, the time
+  *             from the ClientHello to the processed ServerHello, and the CPU
+  *             time of the ServerHello, of the Certificate and CertificateVerify,
+  *             of the key exchange and of the Finished messages, with the RSA,
+  *             ECDSA and ECDH operations done within them. The first handshake
+  *             verifies the server chain, the others find it in the
+  *             NX_SECURE_X509_VERIFY_CACHE_SIZE cache and are reported apart,
+  *           - sends TLS_BENCHMARK_BYTES of application data in records of 16,
+  *             256 and 4096 bytes over its last session, and reports their rate
+  *             and the encryption cycles of each record.
+  *          The phases are the cycle_profile.h regions of NetX Secure, the build
+  *          needs CYCLE_PROFILE_ENABLE; make TLS_BENCHMARK=1 defines both, and
+  *          TLS_1_3=1 adds the TLS 1.3 ciphersuites.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tls_benchmark.h"
+#include "perf_harness.h"
+#include <string.h>
+
+#ifdef TLS_BENCHMARK
+
+#include "tls_benchmark.cert.h"
+
+#ifndef CYCLE_PROFILE_ENABLE
+#error "TLS_BENCHMARK times the TLS phases with CYCLE_PROFILE_ENABLE, make TLS_BENCHMARK=1 defines both"
+#endif
+
+#ifndef NX_SECURE_ENABLE_ECC_CIPHERSUITE
+#error "TLS_BENCHMARK sweeps the ECC ciphersuite table"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define TLS_BENCHMARK_RECORD_SIZE_MAX 4096                  /* Largest record of the rate test */
+#define TLS_BENCHMARK_CA_COUNT        2                     /* RSA and ECDSA test CAs */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct TLS_BENCHMARK_PHASE_STRUCT
+{
+  UINT        region;
+  const CHAR *name;
+} TLS_BENCHMARK_PHASE;
+
+typedef struct TLS_BENCHMARK_SUITE_NAME_STRUCT
+{
+  USHORT      ciphersuite;
+  const CHAR *name;
+} TLS_BENCHMARK_SUITE_NAME;
+
+typedef struct TLS_BENCHMARK_RESULT_STRUCT
+{
+  /* Handshakes added up in this result. */
+  UINT        handshakes;
+
+  /* Cycles of the TCP connection, of nx_secure_tls_session_start and up to the end
+     of the ServerHello processing. */
+  ULONG64     connect;
+  ULONG64     handshake;
+  ULONG64     server_hello;
+
+  /* Cycles and calls of each phase. */
+  ULONG64     cycles[CYCLE_PROFILE_REGIONS];
+  ULONG       calls[CYCLE_PROFILE_REGIONS];
+} TLS_BENCHMARK_RESULT;
+
+/* Private variables ---------------------------------------------------------*/
+/* Ciphersuite table of the ECC crypto, TLS 1.3 ciphersuites first when enabled. */
+extern const NX_SECURE_TLS_CRYPTO nx_crypto_tls_ciphers_ecc;
+extern NX_SECURE_TLS_CIPHERSUITE_INFO _nx_crypto_ciphersuite_lookup_table_ecc[];
+extern const UINT _nx_crypto_ciphersuite_lookup_table_ecc_size;
+extern const USHORT nx_crypto_ecc_supported_groups[];
+extern const NX_CRYPTO_METHOD *nx_crypto_ecc_curves[];
+extern const UINT nx_crypto_ecc_supported_groups_size;
+
+/* The regions reported for each handshake. The public key operations run within the phases. */
+static const TLS_BENCHMARK_PHASE benchmark_phases[] =
+{
+  {CYCLE_PROFILE_TLS_SERVER_HELLO, "ServerHello"},
+  {CYCLE_PROFILE_TLS_CERTIFICATE,  "certificate"},
+  {CYCLE_PROFILE_TLS_KEY_EXCHANGE, "key exchange"},
+  {CYCLE_PROFILE_TLS_FINISHED,     "finished"},
+  {CYCLE_PROFILE_RSA,              "RSA"},
+  {CYCLE_PROFILE_ECDSA,            "ECDSA"},
+  {CYCLE_PROFILE_ECDH,             "ECDH"},
+};
+#define TLS_BENCHMARK_PHASES          (sizeof(benchmark_phases) / sizeof(benchmark_phases[0]))
+
+/* OpenSSL names of the ciphersuites, the ones of the -cipher and -ciphersuites options. */
+static const TLS_BENCHMARK_SUITE_NAME benchmark_suite_names[] =
+{
+  {TLS_AES_128_GCM_SHA256,                        "TLS_AES_128_GCM_SHA256"},
+  {TLS_CHACHA20_POLY1305_SHA256,                  "TLS_CHACHA20_POLY1305_SHA256"},
+  {TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, "ECDHE-ECDSA-CHACHA20-POLY1305"},
+  {TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,   "ECDHE-RSA-CHACHA20-POLY1305"},
+  {TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,       "ECDHE-ECDSA-AES128-GCM-SHA256"},
+  {TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,         "ECDHE-RSA-AES128-GCM-SHA256"},
+  {TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,       "ECDHE-ECDSA-AES128-SHA256"},
+  {TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,         "ECDHE-RSA-AES128-SHA256"},
+};
+
+static const UINT benchmark_record_sizes[] = {16, 256, TLS_BENCHMARK_RECORD_SIZE_MAX};
+
+static NX_PACKET_POOL *benchmark_pool_ptr;
+static NX_SECURE_TLS_ARENA *benchmark_arena_ptr;
+static const CHAR *benchmark_suite_current;
+
+static NX_TCP_SOCKET benchmark_socket;
+static NX_SECURE_TLS_SESSION benchmark_session;
+
+/* Crypto table of the session, the ECC one limited to the ciphersuite measured. */
+static NX_SECURE_TLS_CRYPTO benchmark_crypto;
+
+static NX_SECURE_X509_CERT benchmark_ca_certificates[TLS_BENCHMARK_CA_COUNT];
+
+static TLS_BENCHMARK_RESULT benchmark_cold;
+static TLS_BENCHMARK_RESULT benchmark_warm;
+
+static UCHAR benchmark_payload[TLS_BENCHMARK_RECORD_SIZE_MAX] CCMRAM_BSS;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Convert CPU cycles to microseconds.
+* @param  cycles: duration in cycles
+* @retval Duration in us
+*/
+static ULONG benchmark_cycles_us(ULONG64 cycles)
+{
+  return (ULONG)(cycles / (SystemCoreClock / 1000000U));
+}
+
+/**
+* @brief  Print a duration in ms with one decimal.
+* @param  cycles: duration in cycles
+* @retval None
+*/
+static VOID benchmark_ms_print(ULONG64 cycles)
+{
+  ULONG us = benchmark_cycles_us(cycles);
+
+  printf("%lu.%lu ms", us / 1000U, (us % 1000U) / 100U);
+}
+
+/**
+* @brief  Find the OpenSSL name of a ciphersuite.
+* @param  ciphersuite: value on the wire
+* @retval Name, or "?" for a ciphersuite of no entry
+*/
+static const CHAR *benchmark_suite_name(USHORT ciphersuite)
+{
+  UINT i;
+
+  for (i = 0; i < sizeof(benchmark_suite_names) / sizeof(benchmark_suite_names[0]); i++)
+  {
+    if (benchmark_suite_names[i].ciphersuite == ciphersuite)
+    {
+      return benchmark_suite_names[i].name;
+    }
+  }
+
+  return "?";
+}
+
+/**
+* @brief  Report the average of the handshakes of a result.
+* @param  title: printed before the result
+* @param  key: name of the result in the performance harness, after the ciphersuite
+* @param  result: handshakes added up
+* @retval None
+*/
+static VOID benchmark_result_print(const CHAR *title, const CHAR *key, const TLS_BENCHMARK_RESULT *result)
+{
+  UINT handshakes = result -> handshakes;
+  UINT region;
+  UINT i;
+
+  if (handshakes == 0)
+  {
+    return;
+  }
+
+  printf("  %s: handshake ", title);
+  benchmark_ms_print(result -> handshake / handshakes);
+  perf_harness_result("tls", "handshake us", benchmark_cycles_us(result -> handshake / handshakes),
+                      PERF_HARNESS_LOWER, "%s %s", benchmark_suite_current, key);
+  printf(", ServerHello at ");
+  benchmark_ms_print(result -> server_hello / handshakes);
+  printf(", TCP connect ");
+  benchmark_ms_print(result -> connect / handshakes);
+  printf("\n    CPU");
+
+  for (i = 0; i < TLS_BENCHMARK_PHASES; i++)
+  {
+    region = benchmark_phases[i].region;
+    printf("%s %s ", (i == 0) ? "" : ",", benchmark_phases[i].name);
+    benchmark_ms_print(result -> cycles[region] / handshakes);
+
+    /* The public key operations, per handshake too. */
+    if ((region >= CYCLE_PROFILE_RSA) && (result -> calls[region] != 0))
+    {
+      printf(" in %lu", (ULONG)(result -> calls[region] / handshakes));
+    }
+  }
+  printf("\n");
+}
+
+/**
+* @brief  Create the session of one handshake, offering a single ciphersuite.
+* @param  suite: entry of the ECC ciphersuite table
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_session_create(NX_SECURE_TLS_CIPHERSUITE_INFO *suite)
+{
+  UINT ret;
+  UINT i;
+
+  benchmark_crypto = nx_crypto_tls_ciphers_ecc;
+  benchmark_crypto.nx_secure_tls_ciphersuite_lookup_table = suite;
+  benchmark_crypto.nx_secure_tls_ciphersuite_lookup_table_size = 1;
+
+  ret = nx_secure_tls_session_arena_create(&benchmark_session, &benchmark_crypto, benchmark_arena_ptr,
+                                           TLS_PACKET_BUFFER_SIZE);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_secure_tls_ecc_initialize(&benchmark_session, nx_crypto_ecc_supported_groups,
+                                     nx_crypto_ecc_supported_groups_size, nx_crypto_ecc_curves);
+
+  for (i = 0; (i < TLS_BENCHMARK_CA_COUNT) && (ret == NX_SUCCESS); i++)
+  {
+    ret = nx_secure_tls_trusted_certificate_add(&benchmark_session, &benchmark_ca_certificates[i]);
+  }
+
+#if (NX_SECURE_TLS_TLS_1_3_ENABLED)
+  /* A TLS 1.2 ciphersuite alone in a TLS 1.3 ClientHello would not be negotiated. */
+  if ((ret == NX_SUCCESS) && ((suite -> nx_secure_tls_ciphersuite & 0xFF00) != 0x1300))
+  {
+    ret = nx_secure_tls_session_protocol_version_override(&benchmark_session, NX_SECURE_TLS_VERSION_TLS_1_2);
+  }
+#endif
+
+  if (ret != NX_SUCCESS)
+  {
+    nx_secure_tls_session_delete(&benchmark_session);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Send application data in records of one size and report their rate.
+* @param  size: plaintext bytes of each record
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_records_run(UINT size)
+{
+  CYCLE_PROFILE_STATS stats;
+  NX_PACKET *packet_ptr;
+  ULONG64 elapsed = 0;
+  ULONG records = TLS_BENCHMARK_BYTES / size;
+  ULONG sent;
+  ULONG start;
+  ULONG now;
+  ULONG deadline;
+  ULONG us;
+  ULONG kbits;
+  UINT ret = NX_SUCCESS;
+
+#ifdef NX_SECURE_TLS_RECORD_SIZE_LIMIT
+  if ((benchmark_session.nx_secure_tls_send_record_size_limit != 0) &&
+      (size > benchmark_session.nx_secure_tls_send_record_size_limit))
+  {
+    printf("  records of %u B: above the server record size limit of %u B\n", size,
+           (UINT)benchmark_session.nx_secure_tls_send_record_size_limit);
+    return NX_SUCCESS;
+  }
+#endif /* NX_SECURE_TLS_RECORD_SIZE_LIMIT */
+
+  cycle_profile_reset();
+  start = DWT -> CYCCNT;
+
+  for (sent = 0; sent < records; sent++)
+  {
+    ret = nx_secure_tls_packet_allocate(&benchmark_session, benchmark_pool_ptr, &packet_ptr, TLS_BENCHMARK_TIMEOUT);
+    if (ret != NX_SUCCESS)
+    {
+      break;
+    }
+
+    ret = nx_packet_data_append(packet_ptr, benchmark_payload, size, benchmark_pool_ptr, TLS_BENCHMARK_TIMEOUT);
+    if (ret == NX_SUCCESS)
+    {
+      ret = nx_secure_tls_session_send(&benchmark_session, packet_ptr, TLS_BENCHMARK_TIMEOUT);
+    }
+
+    if (ret != NX_SUCCESS)
+    {
+      nx_packet_release(packet_ptr);
+      break;
+    }
+
+    /* Add up the cycles often enough for the 23 s wrap of the counter. */
+    now = DWT -> CYCCNT;
+    elapsed += now - start;
+    start = now;
+  }
+
+  /* The rate counts the records acknowledged by the server, the wait is shorter than the wrap. */
+  deadline = tx_time_get() + TLS_BENCHMARK_TIMEOUT;
+  while ((ret == NX_SUCCESS) && (benchmark_socket.nx_tcp_socket_transmit_sent_count != 0) &&
+         ((LONG)(deadline - tx_time_get()) > 0))
+  {
+    tx_thread_sleep(1);
+  }
+  elapsed += DWT -> CYCCNT - start;
+
+  if (ret != NX_SUCCESS)
+  {
+    printf("  records of %u B: send failed after %lu records: 0x%x\n", size, sent, ret);
+    return ret;
+  }
+
+  cycle_profile_get(CYCLE_PROFILE_TLS_ENCRYPT, &stats);
+  us = benchmark_cycles_us(elapsed);
+  kbits = (ULONG)(((ULONG64)records * size * 8U * 1000U) / ((us != 0) ? us : 1U));
+
+  printf("  records of %u B: %lu bytes in ", size, records * size);
+  benchmark_ms_print(elapsed);
+  printf(", %lu.%02lu Mbit/s, encryption %lu cycles/record, max %lu\n", kbits / 1000U, (kbits % 1000U) / 10U,
+         (stats.count != 0) ? (ULONG)(stats.total / stats.count) : 0UL, stats.max);
+  perf_harness_result("tls", "kbit/s", kbits, PERF_HARNESS_HIGHER, "%s %u B", benchmark_suite_current, size);
+  perf_harness_result("tls", "cycles/record", (stats.count != 0) ? (ULONG)(stats.total / stats.count) : 0UL,
+                      PERF_HARNESS_LOWER, "%s %u B", benchmark_suite_current, size);
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Connect and run one handshake, then the record tests after the last one.
+* @param  suite: entry of the ECC ciphersuite table
+* @param  index: number of the handshake, 0 for the first one
+* @retval NX_SUCCESS or the error of the failed call
+*/
+static UINT benchmark_handshake_run(NX_SECURE_TLS_CIPHERSUITE_INFO *suite, UINT index)
+{
+  TLS_BENCHMARK_RESULT *result = (index == 0) ? &benchmark_cold : &benchmark_warm;
+  CYCLE_PROFILE_STATS stats;
+  ULONG connect_start;
+  ULONG start;
+  ULONG end;
+  UINT ret;
+  UINT i;
+
+  ret = benchmark_session_create(suite);
+  if (ret != NX_SUCCESS)
+  {
+    printf("  session create failed: 0x%x\n", ret);
+    return ret;
+  }
+
+  ret = nx_tcp_client_socket_bind(&benchmark_socket, NX_ANY_PORT, TLS_BENCHMARK_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    printf("  bind failed: 0x%x\n", ret);
+    nx_secure_tls_session_delete(&benchmark_session);
+    return ret;
+  }
+
+  connect_start = DWT -> CYCCNT;
+  ret = nx_tcp_client_socket_connect(&benchmark_socket, TLS_BENCHMARK_PEER_ADDRESS, TLS_BENCHMARK_PEER_PORT,
+                                     TLS_BENCHMARK_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    printf("  connect failed: 0x%x\n", ret);
+    nx_tcp_client_socket_unbind(&benchmark_socket);
+    nx_secure_tls_session_delete(&benchmark_session);
+    return ret;
+  }
+
+  /* Only the regions of this handshake. */
+  cycle_profile_reset();
+  start = DWT -> CYCCNT;
+  ret = nx_secure_tls_session_start(&benchmark_session, &benchmark_socket, TLS_BENCHMARK_TIMEOUT);
+  end = DWT -> CYCCNT;
+
+  if (ret == NX_SUCCESS)
+  {
+    result -> handshakes++;
+    result -> connect += start - connect_start;
+    result -> handshake += end - start;
+
+    for (i = 0; i < TLS_BENCHMARK_PHASES; i++)
+    {
+      cycle_profile_get(benchmark_phases[i].region, &stats);
+      result -> cycles[benchmark_phases[i].region] += stats.total;
+      result -> calls[benchmark_phases[i].region] += stats.count;
+
+      /* The ServerHello is processed once, when its last call ended. */
+      if ((benchmark_phases[i].region == CYCLE_PROFILE_TLS_SERVER_HELLO) && (stats.count != 0))
+      {
+        result -> server_hello += stats.last - start;
+      }
+    }
+
+    /* The handshakes are reported before the records of the last session. */
+    if (index == (TLS_BENCHMARK_HANDSHAKES - 1))
+    {
+      benchmark_result_print("first, chain verified", "cold", &benchmark_cold);
+      benchmark_result_print("next ones, chain cached", "warm", &benchmark_warm);
+
+      for (i = 0; (i < sizeof(benchmark_record_sizes) / sizeof(benchmark_record_sizes[0])) && (ret == NX_SUCCESS); i++)
+      {
+        ret = benchmark_records_run(benchmark_record_sizes[i]);
+      }
+    }
+
+    nx_secure_tls_session_end(&benchmark_session, TLS_BENCHMARK_TIMEOUT);
+  }
+  else
+  {
+    printf("  handshake %u failed: 0x%x\n", index + 1, ret);
+  }
+
+  nx_tcp_socket_disconnect(&benchmark_socket, TLS_BENCHMARK_TIMEOUT);
+  nx_tcp_client_socket_unbind(&benchmark_socket);
+  nx_secure_tls_session_delete(&benchmark_session);
+
+  return ret;
+}
+
+/**
+* @brief  Run the handshakes and record tests of each ciphersuite.
+* @param  ip_ptr: IP instance, its address resolved
+* @param  pool_ptr: packet pool of the records sent
+* @param  arena_ptr: TLS arena the sessions take their block from
+* @retval NX_SUCCESS, or the error of the setup or of the last ciphersuite that failed
+*/
+UINT tls_benchmark_run(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr, NX_SECURE_TLS_ARENA *arena_ptr)
+{
+  NX_SECURE_TLS_CIPHERSUITE_INFO *suite;
+  const CHAR *version;
+  ULONG peer = TLS_BENCHMARK_PEER_ADDRESS;
+  UINT status = NX_SUCCESS;
+  UINT ret;
+  UINT index;
+  UINT i;
+
+  benchmark_pool_ptr = pool_ptr;
+  benchmark_arena_ptr = arena_ptr;
+
+  if (peer == NULL_ADDRESS)
+  {
+    printf("TLS benchmark: set TLS_BENCHMARK_PEER_ADDRESS to the host of the server\n");
+    return NX_INVALID_PARAMETERS;
+  }
+
+  nx_secure_tls_initialize();
+
+  ret = nx_secure_x509_certificate_initialize(&benchmark_ca_certificates[0], (UCHAR *)tls_benchmark_rsa_ca_der,
+                                              sizeof(tls_benchmark_rsa_ca_der), NX_NULL, 0, NULL, 0,
+                                              NX_SECURE_X509_KEY_TYPE_NONE);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_secure_x509_certificate_initialize(&benchmark_ca_certificates[1], (UCHAR *)tls_benchmark_ecdsa_ca_der,
+                                                sizeof(tls_benchmark_ecdsa_ca_der), NX_NULL, 0, NULL, 0,
+                                                NX_SECURE_X509_KEY_TYPE_NONE);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_create(ip_ptr, &benchmark_socket, "TLS benchmark", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                               NX_IP_TIME_TO_LIVE, TLS_BENCHMARK_TCP_WINDOW, NX_NULL, NX_NULL);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  memset(benchmark_payload, 'A', sizeof(benchmark_payload));
+
+  printf("TLS benchmark to %lu.%lu.%lu.%lu:%u, CPU at %lu MHz, %u handshakes of each ciphersuite\n",
+         (peer >> 24) & 0xFF, (peer >> 16) & 0xFF, (peer >> 8) & 0xFF, peer & 0xFF, (UINT)TLS_BENCHMARK_PEER_PORT,
+         (unsigned long)(SystemCoreClock / 1000000U), (UINT)TLS_BENCHMARK_HANDSHAKES);
+
+  for (i = 0; i < _nx_crypto_ciphersuite_lookup_table_ecc_size; i++)
+  {
+    suite = &_nx_crypto_ciphersuite_lookup_table_ecc[i];
+
+    /* Without a certificate, a PSK handshake has nothing of the others to measure. */
+    if (suite -> nx_secure_tls_public_auth -> nx_crypto_algorithm == NX_CRYPTO_KEY_EXCHANGE_PSK)
+    {
+      continue;
+    }
+
+    version = ((suite -> nx_secure_tls_ciphersuite & 0xFF00) == 0x1300) ? "1.3" : "1.2";
+    benchmark_suite_current = benchmark_suite_name(suite -> nx_secure_tls_ciphersuite);
+    printf("TLS %s %s (0x%04x):\n", version, benchmark_suite_current, (UINT)suite -> nx_secure_tls_ciphersuite);
+
+    memset(&benchmark_cold, 0, sizeof(benchmark_cold));
+    memset(&benchmark_warm, 0, sizeof(benchmark_warm));
+
+    for (index = 0; index < TLS_BENCHMARK_HANDSHAKES; index++)
+    {
+      ret = benchmark_handshake_run(suite, index);
+      if (ret != NX_SUCCESS)
+      {
+        /* The handshakes done until the failure. */
+        if (index < (TLS_BENCHMARK_HANDSHAKES - 1))
+        {
+          benchmark_result_print("first, chain verified", "cold", &benchmark_cold);
+          benchmark_result_print("next ones, chain cached", "warm", &benchmark_warm);
+        }
+        status = ret;
+        break;
+      }
+    }
+  }
+
+  nx_tcp_socket_delete(&benchmark_socket);
+  printf("TLS benchmark done\n");
+
+  return status;
+}
+
+#endif /* TLS_BENCHMARK */
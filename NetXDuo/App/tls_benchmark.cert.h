@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file    tls_benchmark.cert.h
+  * @author  MCD Application Team
+  * @brief   Test CA certificates of the TLS benchmark server
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Generated by Utilities/tls_benchmark.py certs, with the server certificates and keys of
+   Utilities/tls_benchmark. ASN.1 DER encoded, one CA for the RSA and one for the ECDSA chain. */
+
+const unsigned char tls_benchmark_rsa_ca_der[] = {
+  0x30, 0x82, 0x03, 0x59, 0x30, 0x82, 0x02, 0x41, 0xa0, 0x03, 0x02, 0x01,
+  0x02, 0x02, 0x14, 0x7e, 0x6d, 0xbd, 0x4d, 0xc4, 0x89, 0x2d, 0x3e, 0x88,
+  0xb7, 0x78, 0x99, 0x07, 0x42, 0x78, 0x00, 0x53, 0xb4, 0xe9, 0x5d, 0x30,
+  0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b,
+  0x05, 0x00, 0x30, 0x3c, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04,
+  0x0a, 0x0c, 0x12, 0x53, 0x54, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x65, 0x6c,
+  0x65, 0x63, 0x74, 0x72, 0x6f, 0x6e, 0x69, 0x63, 0x73, 0x31, 0x1d, 0x30,
+  0x1b, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x14, 0x54, 0x4c, 0x53, 0x20,
+  0x62, 0x65, 0x6e, 0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x20, 0x52, 0x53,
+  0x41, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30,
+  0x31, 0x34, 0x31, 0x35, 0x34, 0x32, 0x30, 0x32, 0x5a, 0x17, 0x0d, 0x34,
+  0x36, 0x31, 0x30, 0x30, 0x39, 0x31, 0x35, 0x34, 0x32, 0x30, 0x32, 0x5a,
+  0x30, 0x3c, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c,
+  0x12, 0x53, 0x54, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x65, 0x6c, 0x65, 0x63,
+  0x74, 0x72, 0x6f, 0x6e, 0x69, 0x63, 0x73, 0x31, 0x1d, 0x30, 0x1b, 0x06,
+  0x03, 0x55, 0x04, 0x03, 0x0c, 0x14, 0x54, 0x4c, 0x53, 0x20, 0x62, 0x65,
+  0x6e, 0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x20, 0x52, 0x53, 0x41, 0x20,
+  0x43, 0x41, 0x30, 0x82, 0x01, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86,
+  0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x82, 0x01,
+  0x0f, 0x00, 0x30, 0x82, 0x01, 0x0a, 0x02, 0x82, 0x01, 0x01, 0x00, 0x97,
+  0x44, 0x1c, 0x21, 0xb0, 0x40, 0xaf, 0xb1, 0x15, 0xfc, 0x5c, 0x45, 0x9e,
+  0xc8, 0xad, 0x14, 0x42, 0xd8, 0x74, 0x10, 0x9f, 0x9a, 0xa3, 0x86, 0xaf,
+  0xff, 0x23, 0xe2, 0xbb, 0x3b, 0x19, 0x11, 0x4c, 0xa2, 0xe8, 0x7f, 0x4f,
+  0x33, 0x8d, 0x21, 0xf1, 0x75, 0x6e, 0xba, 0x9e, 0x58, 0x46, 0xb6, 0xdf,
+  0x59, 0xc4, 0x81, 0x71, 0x87, 0xe7, 0xdf, 0xcb, 0x3c, 0x88, 0x45, 0xb9,
+  0x50, 0xb2, 0x54, 0xf7, 0xc6, 0x0d, 0xf7, 0x83, 0x27, 0xec, 0x07, 0xa0,
+  0xb2, 0x4b, 0x70, 0x32, 0xf1, 0x56, 0x8d, 0xa7, 0xae, 0x41, 0x9a, 0xe6,
+  0x1f, 0x26, 0x4d, 0xe0, 0xec, 0xe7, 0x35, 0xbc, 0xb4, 0xdc, 0x33, 0xa6,
+  0xd2, 0xfd, 0xc1, 0x32, 0x5b, 0xb3, 0xa2, 0x54, 0x31, 0x7a, 0x6b, 0xc2,
+  0xb1, 0x14, 0x02, 0x50, 0x97, 0xac, 0xe2, 0x62, 0xd5, 0x0f, 0xda, 0xc6,
+  0x0d, 0x48, 0x1c, 0x36, 0x17, 0x56, 0x37, 0xca, 0x8e, 0x9a, 0x0b, 0x47,
+  0x59, 0xaf, 0xb8, 0x8d, 0x1d, 0xa4, 0x01, 0x30, 0xc4, 0xdc, 0xf1, 0x64,
+  0x01, 0x8a, 0x2f, 0x54, 0xd1, 0xe7, 0x8d, 0x9f, 0x90, 0xb1, 0x2e, 0xbe,
+  0x30, 0x94, 0x27, 0x5e, 0x9b, 0xfd, 0xc5, 0x19, 0x4f, 0x8c, 0xd4, 0x3e,
+  0x4a, 0x20, 0xd2, 0x23, 0x84, 0xf0, 0x39, 0x3b, 0x57, 0xaa, 0xef, 0x92,
+  0x85, 0x59, 0x7e, 0x16, 0x0d, 0x22, 0x70, 0xe2, 0x74, 0x7c, 0xed, 0x9d,
+  0x22, 0x80, 0x2f, 0x86, 0x20, 0x69, 0x7f, 0x83, 0x53, 0x9f, 0x8d, 0x03,
+  0x62, 0x14, 0xed, 0xcf, 0x12, 0xb0, 0x06, 0xf0, 0xf4, 0xb8, 0xbe, 0x2f,
+  0xdc, 0x45, 0xf4, 0xd2, 0x0c, 0x5b, 0x66, 0xac, 0xe5, 0x7f, 0xda, 0x30,
+  0xd7, 0x24, 0x33, 0x9c, 0x76, 0x13, 0x28, 0x4a, 0xa1, 0x69, 0x52, 0xe0,
+  0x28, 0xa6, 0x9f, 0x6d, 0x30, 0xe4, 0x58, 0x4c, 0xa1, 0x81, 0x58, 0x64,
+  0xd2, 0x56, 0xe5, 0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x53, 0x30, 0x51,
+  0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xb5,
+  0x25, 0x89, 0xe5, 0x14, 0x77, 0x99, 0x9e, 0x39, 0x12, 0x65, 0xc7, 0x89,
+  0x62, 0x3e, 0x0b, 0x86, 0xf2, 0x1f, 0x0a, 0x30, 0x1f, 0x06, 0x03, 0x55,
+  0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0xb5, 0x25, 0x89, 0xe5,
+  0x14, 0x77, 0x99, 0x9e, 0x39, 0x12, 0x65, 0xc7, 0x89, 0x62, 0x3e, 0x0b,
+  0x86, 0xf2, 0x1f, 0x0a, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01,
+  0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0d, 0x06,
+  0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00,
+  0x03, 0x82, 0x01, 0x01, 0x00, 0x3b, 0x73, 0xeb, 0x26, 0xf8, 0x0a, 0xfc,
+  0xf2, 0x95, 0xa6, 0x3b, 0xfc, 0x46, 0xab, 0xcd, 0x37, 0x65, 0xf5, 0x2f,
+  0xd5, 0xbc, 0x52, 0x03, 0xbc, 0x98, 0xd0, 0x78, 0x57, 0x7c, 0x74, 0x48,
+  0xf4, 0x60, 0xd4, 0x87, 0x71, 0xdb, 0x1e, 0x1a, 0x65, 0x7a, 0x65, 0xaa,
+  0xec, 0xf9, 0x6a, 0x85, 0x29, 0xe3, 0x7c, 0x00, 0x55, 0xc3, 0xcc, 0x70,
+  0xd6, 0x92, 0x31, 0xad, 0xc3, 0xa5, 0x18, 0xe7, 0x46, 0x7f, 0xed, 0xba,
+  0x6e, 0x27, 0xa2, 0x80, 0x65, 0xea, 0x23, 0x9d, 0x78, 0x0a, 0x3c, 0x3a,
+  0xf9, 0x30, 0x20, 0x80, 0x11, 0x76, 0x3d, 0x67, 0x99, 0x0f, 0xc7, 0x19,
+  0x26, 0xff, 0xda, 0x10, 0x2a, 0xde, 0x16, 0x03, 0x8d, 0xd0, 0x21, 0x33,
+  0x86, 0xf4, 0xd1, 0x21, 0x7d, 0x59, 0x82, 0x91, 0x86, 0xf1, 0xed, 0xe0,
+  0xe3, 0xa6, 0x1a, 0x0f, 0xe8, 0xad, 0xda, 0x1b, 0xcd, 0x20, 0xc6, 0x6e,
+  0x40, 0x2f, 0x6a, 0x68, 0xda, 0x79, 0x88, 0x4e, 0x45, 0x11, 0xfb, 0xdd,
+  0xb5, 0x4f, 0x6a, 0x1d, 0xc1, 0x18, 0x0a, 0xfa, 0x3f, 0x4a, 0x2d, 0xba,
+  0x5e, 0x59, 0x81, 0xe1, 0x88, 0x2e, 0x5e, 0x6c, 0xeb, 0x96, 0xcd, 0xf4,
+  0xd4, 0xaf, 0xb1, 0x3d, 0xe0, 0x6a, 0xe3, 0x00, 0x67, 0x60, 0x80, 0xff,
+  0xfb, 0xe7, 0x5e, 0x2c, 0x00, 0x1e, 0x51, 0x79, 0xa6, 0x30, 0x4a, 0xde,
+  0xbd, 0xd5, 0x75, 0x4c, 0x36, 0x95, 0x65, 0x64, 0xf1, 0x6a, 0x20, 0x96,
+  0x6d, 0x6b, 0xc6, 0x62, 0xc1, 0x4c, 0xe0, 0xf3, 0x50, 0xd4, 0xb1, 0x3e,
+  0x9b, 0xb3, 0x9a, 0x52, 0xd7, 0xee, 0xb4, 0x13, 0xb5, 0x43, 0x37, 0xf6,
+  0x85, 0xc2, 0xde, 0x4e, 0xf9, 0x97, 0x8a, 0xf5, 0xfa, 0x35, 0xfb, 0x07,
+  0xc2, 0xae, 0x22, 0x8b, 0xc5, 0xd7, 0x11, 0x23, 0x71, 0x12, 0x7f, 0x29,
+  0x78, 0x87, 0x92, 0x90, 0x9a, 0xb3, 0x45, 0xc2, 0x0b
+};
+
+const unsigned char tls_benchmark_ecdsa_ca_der[] = {
+  0x30, 0x82, 0x01, 0xd0, 0x30, 0x82, 0x01, 0x77, 0xa0, 0x03, 0x02, 0x01,
+  0x02, 0x02, 0x14, 0x54, 0x2f, 0x25, 0x16, 0xd5, 0xa8, 0xd0, 0x25, 0xfc,
+  0x0e, 0x02, 0x7c, 0xb2, 0x0b, 0xc0, 0xb3, 0x4e, 0xc1, 0x02, 0x41, 0x30,
+  0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30,
+  0x3e, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x12,
+  0x53, 0x54, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x65, 0x6c, 0x65, 0x63, 0x74,
+  0x72, 0x6f, 0x6e, 0x69, 0x63, 0x73, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03,
+  0x55, 0x04, 0x03, 0x0c, 0x16, 0x54, 0x4c, 0x53, 0x20, 0x62, 0x65, 0x6e,
+  0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x20, 0x45, 0x43, 0x44, 0x53, 0x41,
+  0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31,
+  0x34, 0x31, 0x35, 0x34, 0x32, 0x30, 0x33, 0x5a, 0x17, 0x0d, 0x34, 0x36,
+  0x31, 0x30, 0x30, 0x39, 0x31, 0x35, 0x34, 0x32, 0x30, 0x33, 0x5a, 0x30,
+  0x3e, 0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x12,
+  0x53, 0x54, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x65, 0x6c, 0x65, 0x63, 0x74,
+  0x72, 0x6f, 0x6e, 0x69, 0x63, 0x73, 0x31, 0x1f, 0x30, 0x1d, 0x06, 0x03,
+  0x55, 0x04, 0x03, 0x0c, 0x16, 0x54, 0x4c, 0x53, 0x20, 0x62, 0x65, 0x6e,
+  0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x20, 0x45, 0x43, 0x44, 0x53, 0x41,
+  0x20, 0x43, 0x41, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48,
+  0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03,
+  0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0xb6, 0xd5, 0x8b, 0x58, 0x95, 0xe2,
+  0x57, 0xce, 0xec, 0x10, 0x61, 0x33, 0x97, 0xe2, 0xa5, 0x04, 0x9d, 0x35,
+  0x1e, 0x42, 0xa3, 0xe7, 0xf3, 0x0a, 0x34, 0x4a, 0x23, 0xe8, 0x0f, 0xd4,
+  0x74, 0x2e, 0xcc, 0xfa, 0x87, 0xd6, 0x23, 0x4d, 0x07, 0xd7, 0x0e, 0x59,
+  0xb0, 0x05, 0xa6, 0x99, 0x88, 0xd6, 0xc8, 0xb5, 0x0c, 0x7d, 0x4c, 0xc7,
+  0x2c, 0x07, 0xc1, 0x07, 0x41, 0xff, 0x4d, 0x35, 0xbe, 0xbe, 0xa3, 0x53,
+  0x30, 0x51, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04,
+  0x14, 0x33, 0x1b, 0x64, 0xab, 0x68, 0x48, 0xcb, 0xab, 0x10, 0xcf, 0x0c,
+  0xd8, 0xf1, 0x3d, 0x0c, 0xfa, 0xd1, 0x85, 0xff, 0xb2, 0x30, 0x1f, 0x06,
+  0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x33, 0x1b,
+  0x64, 0xab, 0x68, 0x48, 0xcb, 0xab, 0x10, 0xcf, 0x0c, 0xd8, 0xf1, 0x3d,
+  0x0c, 0xfa, 0xd1, 0x85, 0xff, 0xb2, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d,
+  0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30,
+  0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03,
+  0x47, 0x00, 0x30, 0x44, 0x02, 0x20, 0x08, 0x47, 0x69, 0x63, 0x0d, 0xce,
+  0xb2, 0x85, 0x90, 0x00, 0x0c, 0xec, 0x94, 0x6f, 0x29, 0x82, 0xf1, 0xdc,
+  0xa1, 0x41, 0x00, 0xd5, 0x31, 0x1d, 0x38, 0xda, 0xf9, 0x71, 0x74, 0x3c,
+  0xec, 0xe5, 0x02, 0x20, 0x11, 0xb7, 0xc3, 0x30, 0x12, 0x75, 0xfa, 0x3d,
+  0x7f, 0xf4, 0xb9, 0xae, 0xd1, 0x80, 0x97, 0x54, 0x39, 0x13, 0x8a, 0xcd,
+  0xf5, 0xfe, 0xfb, 0x26, 0xa2, 0x85, 0xb7, 0x6c, 0xdc, 0x1e, 0xc2, 0xa2
+};
@@ -0,0 +1,40 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tls_benchmark.h
+  * @author  MCD Application Team
+  * @brief   TLS handshake and record layer timings against an OpenSSL server
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TLS_BENCHMARK_H__
+#define __TLS_BENCHMARK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Runs the handshakes and record tests of each ciphersuite to the server configured
+   in app_netxduo.h and reports them over the UART. The sessions take their block
+   from the arena of the MQTT client, which does not run meanwhile. */
+UINT tls_benchmark_run(NX_IP *ip_ptr, NX_PACKET_POOL *pool_ptr, NX_SECURE_TLS_ARENA *arena_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TLS_BENCHMARK_H__ */
@@ -0,0 +1,110 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tls_resume.c
+  * @author  MCD Application Team
+  * @brief   TLS sessions of the MQTT clients kept in the backup SRAM across resets
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tls_resume.h"
+#include "crc_service.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+
+/* Private define ------------------------------------------------------------*/
+#define TLS_RESUME_MAGIC              0x544C5352U   /* "TLSR" */
+
+/* The sessions are saved after the DHCP lease, at the start of the 4 KB backup SRAM */
+#define TLS_RESUME_SAVED              ((TLS_RESUME_RECORD *)(BKPSRAM_BASE + 0x100U))
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct TLS_RESUME_RECORD_STRUCT
+{
+  ULONG                            magic;     /* TLS_RESUME_MAGIC when a session is saved */
+  NX_SECURE_TLS_SESSION_RESUMPTION session;
+  ULONG                            checksum;  /* CRC-32 of the bytes above */
+} TLS_RESUME_RECORD;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Offer the saved session of a client to its next handshake, and consume it. Called by the
+*         tls_setup callback, on a created session.
+* @param  slot: slot of the client, TLS_RESUME_SLOTS or past for none
+* @param  session_ptr: TLS session of the client
+* @retval None
+*/
+VOID tls_resume_offer(UINT slot, NX_SECURE_TLS_SESSION *session_ptr)
+{
+  TLS_RESUME_RECORD *record;
+
+  if (slot < TLS_RESUME_SLOTS)
+  {
+    record = &TLS_RESUME_SAVED[slot];
+    if ((record -> magic == TLS_RESUME_MAGIC) &&
+        (record -> checksum == crc_service_block(record, offsetof(TLS_RESUME_RECORD, checksum))))
+    {
+      nx_secure_tls_session_resumption_set(session_ptr, &record -> session);
+
+      /* Saved again once the connection succeeds. */
+      record -> magic = 0U;
+      return;
+    }
+  }
+
+  /* The session kept by a reset TLS session is not offered either, it may be the rejected one. */
+  nx_secure_tls_session_resumption_set(session_ptr, NX_NULL);
+}
+
+/**
+* @brief  Save the session of a connected client, left unchanged when the broker resumed it.
+* @param  slot: slot of the client, TLS_RESUME_SLOTS or past for none
+* @param  session_ptr: TLS session of the client, its handshake finished
+* @retval None
+*/
+VOID tls_resume_save(UINT slot, NX_SECURE_TLS_SESSION *session_ptr)
+{
+  TLS_RESUME_RECORD record;
+
+  if (slot >= TLS_RESUME_SLOTS)
+  {
+    return;
+  }
+
+  /* A TLS 1.3 session, or one without an ID, is not resumed. */
+  memset(&record, 0, sizeof(record));
+  if (nx_secure_tls_session_resumption_get(session_ptr, &record.session) != NX_SUCCESS)
+  {
+    return;
+  }
+
+  record.magic = TLS_RESUME_MAGIC;
+  record.checksum = crc_service_block(&record, offsetof(TLS_RESUME_RECORD, checksum));
+
+  /* Each slot is offered and saved by the thread that connects its client, a reset in the middle
+     of the write leaves a record the checksum rejects. */
+  if (memcmp(&TLS_RESUME_SAVED[slot], &record, sizeof(record)) != 0)
+  {
+    TLS_RESUME_SAVED[slot] = record;
+  }
+
+  /* Clean up the copy of the master secret. */
+  memset(&record, 0, sizeof(record));
+}
+
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
@@ -0,0 +1,71 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tls_resume.h
+  * @author  MCD Application Team
+  * @brief   TLS sessions of the MQTT clients kept in the backup SRAM across resets
+  *
+  *          Once a client is connected, tls_resume_save() keeps the session
+  *          ID, ciphersuite and master secret of its TLS 1.2 session in the
+  *          backup SRAM, one slot per client. The tls_setup callback of the
+  *          next connection, after a reset as well, offers it with
+  *          tls_resume_offer(): a broker that still knows the session
+  *          resumes it with the abbreviated handshake, no certificate chain
+  *          to receive and verify and no key exchange, both the costly part
+  *          of a connection. A broker that does not falls back to the full
+  *          handshake. An offer consumes the saved session, saved again only
+  *          by a connection that succeeds, so that a session the broker
+  *          rejects costs one full handshake and no more. The record is
+  *          checked by a magic and a CRC-32, the backup SRAM is random
+  *          after a power off without a battery on VBAT; the master secret
+  *          it holds is erased with the backup SRAM by a tamper event. The
+  *          access to the backup SRAM is given by dhcp_lease_init(). Without
+  *          NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION, both functions
+  *          compile to nothing.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TLS_RESUME_H__
+#define __TLS_RESUME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_netxduo.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Slots of the saved sessions, one per MQTT client */
+#define TLS_RESUME_SLOT_PRIMARY       0U  /* Client of MQTT_BROKER_NAME                    */
+#define TLS_RESUME_SLOT_BACKUP        1U  /* Client of MQTT_BACKUP_BROKER_NAME             */
+#define TLS_RESUME_SLOTS              2U  /* A slot past the last one is never saved       */
+
+/* Exported functions prototypes ---------------------------------------------*/
+#ifdef NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION
+
+VOID tls_resume_offer(UINT slot, NX_SECURE_TLS_SESSION *session_ptr);
+VOID tls_resume_save(UINT slot, NX_SECURE_TLS_SESSION *session_ptr);
+
+#else
+
+#define tls_resume_offer(slot, session_ptr)
+#define tls_resume_save(slot, session_ptr)
+
+#endif /* NX_SECURE_TLS_ENABLE_CLIENT_SESSION_RESUMPTION */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __TLS_RESUME_H__ */
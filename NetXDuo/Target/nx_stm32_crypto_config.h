@@ -0,0 +1,93 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef NX_STM32_CRYPTO_CONFIG_H
+#define NX_STM32_CRYPTO_CONFIG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_hal.h"
+
+/* USER CODE BEGIN Includes */
+#include "main.h"
+#include "thread_profile.h"
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+/* This define defines the smallest buffer, in bytes, moved by the DMA to and from the
+   CRYP and HASH peripherals. Shorter buffers, those not word aligned or in the CCM RAM,
+   which the DMA cannot reach, are written and read by the CPU.*/
+#define NX_CRYPTO_STM32_DMA_THRESHOLD        256
+
+/* This define defines the longest wait, in ThreadX ticks, for the end of a DMA transfer.
+   A transfer not done by then fails the operation.*/
+#define NX_CRYPTO_STM32_DMA_TIMEOUT          10
+
+/* These defines define the DMA2 streams of the CRYP input and output and of the HASH
+   input, all three on channel 2. The streams are 5 to 7, whose flags are in the HISR and
+   HIFCR registers. The end of the CRYP output and HASH input transfers interrupts with
+   NX_CRYPTO_STM32_DMA_PRIORITY.*/
+#define NX_CRYPTO_STM32_DMA_CHANNEL          DMA_SxCR_CHSEL_1
+#define NX_CRYPTO_STM32_CRYP_IN_STREAM       DMA2_Stream6
+#define NX_CRYPTO_STM32_CRYP_IN_FLAGS        (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | \
+                                              DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+#define NX_CRYPTO_STM32_CRYP_OUT_STREAM      DMA2_Stream5
+#define NX_CRYPTO_STM32_CRYP_OUT_FLAGS       (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | \
+                                              DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+#define NX_CRYPTO_STM32_CRYP_OUT_DONE        DMA_HISR_TCIF5
+#define NX_CRYPTO_STM32_CRYP_OUT_ERROR       DMA_HISR_TEIF5
+#define NX_CRYPTO_STM32_CRYP_OUT_IRQn        DMA2_Stream5_IRQn
+#define NX_CRYPTO_STM32_CRYP_OUT_IRQHandler  DMA2_Stream5_IRQHandler
+#define NX_CRYPTO_STM32_HASH_IN_STREAM       DMA2_Stream7
+#define NX_CRYPTO_STM32_HASH_IN_FLAGS        (DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTEIF7 | \
+                                              DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7)
+#define NX_CRYPTO_STM32_HASH_IN_DONE         DMA_HISR_TCIF7
+#define NX_CRYPTO_STM32_HASH_IN_ERROR        DMA_HISR_TEIF7
+#define NX_CRYPTO_STM32_HASH_IN_IRQn         DMA2_Stream7_IRQn
+#define NX_CRYPTO_STM32_HASH_IN_IRQHandler   DMA2_Stream7_IRQHandler
+#define NX_CRYPTO_STM32_DMA_PRIORITY         6
+/* USER CODE END EC */
+
+/* Exported macro ------------------------------------------------------------*/
+/* USER CODE BEGIN EM */
+
+/* USER CODE END EM */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+/* USER CODE END PD */
+
+/* USER CODE BEGIN 0 */
+
+/* USER CODE END 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NX_STM32_CRYPTO_CONFIG_H */
@@ -22,6 +22,7 @@
 #include "lan8742.h"
 
 /* USER CODE BEGIN Includes */
+#include "main.h"
 
 /* USER CODE END Includes */
 
@@ -38,10 +39,101 @@
 /* USER CODE BEGIN EC */
 /* This define defines the period of checking the connection of network cable.*/
 #define NX_ETH_CABLE_CONNECTION_CHECK_PERIOD 600
+
+/* These defines define the EXTI pin wired to the nINT output of the PHY. When defined,
+   the PHY interrupts on link down and on auto-negotiation complete, and the link is
+   checked on these interrupts instead of every
+   NX_ETH_CABLE_CONNECTION_CHECK_PERIOD. They are left undefined on the NUCLEO-F429ZI:
+   its LAN8742 nINT/REFCLKO pin supplies the 50 MHz RMII reference clock instead.*/
+/*
+#define NX_ETH_PHY_INTERRUPT_PORT            GPIOG
+#define NX_ETH_PHY_INTERRUPT_PIN             GPIO_PIN_2
+#define NX_ETH_PHY_INTERRUPT_IRQn            EXTI2_IRQn
+#define NX_ETH_PHY_INTERRUPT_IRQHandler      EXTI2_IRQHandler
+#define NX_ETH_PHY_INTERRUPT_PRIORITY        10
+*/
+
+/* This define defines the maximum number of frames drained from the RX ring per
+   IP thread wakeup. RX interrupts stay masked while the budget keeps being used up.*/
+#define NX_DRIVER_RX_POLL_BUDGET             8
+
+/* This define defines the RX mitigation delay in ThreadX ticks. When non zero, the
+   driver polls the RX ring once more after this delay before unmasking RX interrupts.
+   0 unmasks RX interrupts as soon as the ring is found empty.*/
+#define NX_DRIVER_RX_MITIGATION_TICKS        0
+
+/* This define defines the number of packets of the driver owned RX packet pool. The RX
+   descriptors are armed from this pool only, 0 arms them from the IP default packet pool.*/
+#define NX_DRIVER_RX_POOL_PACKETS            12
+
+/* This define defines the RX packet pool low watermark. Received TCP and UDP frames are
+   discarded instead of queued while the pool holds no more free packets than this, so
+   that the RX descriptors can always be re-armed.*/
+#define NX_DRIVER_RX_POOL_WATERMARK          ETH_RX_DESC_CNT
+
+/* These defines define the copy-break of received frames. Frames up to
+   NX_DRIVER_RX_COPY_BREAK bytes, such as TCP ACKs, ARP and MQTT acknowledgements, are
+   copied into a packet of a small pool of NX_DRIVER_RX_SMALL_POOL_PACKETS packets, and
+   their full size RX packet re-arms the ring at once. 0 disables the copy.*/
+#define NX_DRIVER_RX_COPY_BREAK              128
+#define NX_DRIVER_RX_SMALL_POOL_PACKETS      16
+
+/* This define defines the number of TX descriptors the interactive and bulk frames may
+   hold. The last one is kept for the control frames, ARP and TCP ACKs, which then wait
+   behind at most this many frames however long the bulk queue is.*/
+#define NX_DRIVER_TX_SHARED_DESCRIPTORS      (ETH_TX_DESC_CNT - 1)
+
+/* This define defines the number of sent packets from the RX packet pool, the replies
+   built in a received frame longer than the copy-break such as ICMP echo replies, kept
+   by the driver to re-arm RX descriptors without a pool allocation. 0 releases them all
+   to the pool.*/
+#define NX_DRIVER_TX_RECYCLE_PACKETS         4
+
+/* This define defines, in ThreadX ticks, the retry period for re-arming RX descriptors
+   when the RX packet pool was found empty.*/
+#define NX_DRIVER_RX_REFILL_TICKS            1
+
+/* This define makes the driver pass the received IP frames to the NetX IP receive
+   processing directly, as the RX ring is drained on the IP thread. Otherwise the
+   frames are queued for the IP thread and processed on its next event loop pass.*/
+#define NX_DRIVER_RX_DIRECT_DISPATCH
+
+/* This define makes the driver answer the ICMP echo requests to the interface address
+   itself, turning the received frame into the reply and sending it back to the MAC
+   address it came from. NetX still answers the requests the driver leaves, those with
+   IP options, fragmented, or whose checksums the MAC did not verify.
+   Requires NX_ENABLE_INTERFACE_CAPABILITY in nx_user.h.*/
+#define NX_DRIVER_ICMP_ECHO_FAST_REPLY
+
+/* This define enables the IEEE 1588 time stamps of the MAC. Each received frame gets
+   the PTP clock time of its reception, read with nx_stm32_eth_packet_timestamp_get(),
+   and a notify set with nx_stm32_eth_transmit_timestamp_notify_set() gets the time of
+   transmission of each sent frame. The PTP clock runs from power up unless set.
+   Requires HAL_ETH_USE_PTP in stm32f4xx_hal_conf.h, and NX_PACKET_HEADER_PAD with
+   NX_PACKET_HEADER_PAD_SIZE 2 in nx_user.h.*/
+/*
+#define NX_DRIVER_ENABLE_PTP
+*/
+
+/* This define enables the capture of the frames received and sent. The first
+   NX_DRIVER_CAPTURE_SNAP_LENGTH bytes of each frame and its time, of the PTP clock with
+   NX_DRIVER_ENABLE_PTP or else of the ThreadX timer, go into a ring of the last
+   NX_DRIVER_CAPTURE_FRAMES frames, read as pcap records with nx_stm32_eth_capture_read().
+   Stopped with nx_stm32_eth_capture_enable(), a frame costs a test of the switch.*/
+/*
+#define NX_DRIVER_ENABLE_CAPTURE
+*/
+#define NX_DRIVER_CAPTURE_SNAP_LENGTH        96
+#define NX_DRIVER_CAPTURE_FRAMES             64
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
+/* Place the driver RX packet pool memory in DMA visible SRAM.*/
+#define NX_DRIVER_DMA_MEMORY                 DMA_RAM
+
+/* Place the capture ring, not read by the DMA, in the CCM RAM.*/
+#define NX_DRIVER_CAPTURE_MEMORY             CCMRAM_BSS
 
 /* USER CODE END EM */
 
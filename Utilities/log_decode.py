@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Print the text of the binary log records of the USART3 output, see Core/Inc/log_binary.h.
+
+The format strings are read from the .log_strings section of the ELF file of the image, the %s
+arguments from its loaded sections. The bytes outside the records are printed unchanged.
+
+    stty -F /dev/ttyACM0 115200 raw
+    python3 Utilities/log_decode.py build/Nx_MQTT_Client.elf < /dev/ttyACM0
+"""
+
+import re
+import struct
+import sys
+
+LOG_BINARY_MARKER = 0xFF
+LOG_BINARY_HEADER_SIZE = 4
+LOG_BINARY_ARGS_MAX = 8
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 2
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Image:
+    """Sections of a 32-bit little endian ELF file."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("%s is not a 32-bit little endian ELF file" % path)
+
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        headers = [struct.unpack_from("<IIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+
+        self.strings = None
+        self.loaded = []
+        for name, kind, flags, addr, offset, size in headers:
+            end = data.index(b"\0", names[4] + name)
+            section = data[names[4] + name:end].decode()
+            content = data[offset:offset + size]
+            if section == ".log_strings":
+                self.strings = content
+            elif (kind == SHT_PROGBITS) and (flags & SHF_ALLOC):
+                self.loaded.append((addr, content))
+
+        if self.strings is None:
+            raise ValueError("%s has no .log_strings section" % path)
+
+    def format_string(self, offset):
+        if offset >= len(self.strings):
+            return None
+        return self.strings[offset:self.strings.index(b"\0", offset)].decode(errors="replace")
+
+    def constant_string(self, address):
+        for addr, content in self.loaded:
+            if addr <= address < addr + len(content):
+                start = address - addr
+                return content[start:content.index(b"\0", start)].decode(errors="replace")
+        return "<0x%08x>" % address
+
+
+def format_record(image, format_text, args):
+    """Format the arguments as printf() would, the 32-bit words taken in order."""
+    words = iter(args)
+    text = []
+    position = 0
+
+    for match in CONVERSION.finditer(format_text):
+        text.append(format_text[position:match.start()])
+        position = match.end()
+        flags, width, precision, _, conversion = match.groups()
+
+        if conversion == "%":
+            text.append("%")
+            continue
+
+        if width == "*":
+            width = str(struct.unpack("<i", struct.pack("<I", next(words, 0)))[0])
+        if precision == "*":
+            precision = str(next(words, 0))
+
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        word = next(words, 0)
+
+        if conversion in "di":
+            value = struct.unpack("<i", struct.pack("<I", word))[0]
+            text.append((spec + "d") % value)
+        elif conversion == "u":
+            text.append((spec + "d") % word)
+        elif conversion in "oxX":
+            text.append((spec + conversion) % word)
+        elif conversion == "c":
+            text.append((spec + "c") % chr(word & 0xFF))
+        elif conversion == "p":
+            text.append((spec + "s") % ("0x%08x" % word))
+        else:
+            text.append((spec + "s") % image.constant_string(word))
+
+    text.append(format_text[position:])
+    return "".join(text)
+
+
+def decode(image, stream, output):
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            break
+        if chunk[0] != LOG_BINARY_MARKER:
+            output.write(chunk.decode("latin-1"))
+            if chunk == b"\n":
+                output.flush()
+            continue
+
+        header = stream.read(LOG_BINARY_HEADER_SIZE - 1)
+        if len(header) < LOG_BINARY_HEADER_SIZE - 1:
+            break
+        count = header[0]
+        offset = header[1] | (header[2] << 8)
+        format_text = image.format_string(offset)
+        if (count > LOG_BINARY_ARGS_MAX) or (format_text is None):
+            output.write("<bad log record>\n")
+            continue
+
+        words = stream.read(count * 4)
+        if len(words) < count * 4:
+            break
+        output.write(format_record(image, format_text, struct.unpack("<%dI" % count, words)))
+        output.flush()
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.stderr.write("usage: log_decode.py image.elf [capture]\n")
+        return 2
+
+    image = Image(sys.argv[1])
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "rb") as stream:
+            decode(image, stream, sys.stdout)
+    else:
+        decode(image, sys.stdin.buffer, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
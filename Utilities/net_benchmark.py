@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Host side of the echo and packet rate tests of the network benchmark, see NetXDuo/App/net_benchmark.c.
+
+The round trip of UDP datagrams or TCP messages through the echo server of the board, reported
+in us, and a flood of small UDP datagrams to its packet rate sink, whose receive rate the board
+prints each second next to its driver and pool counters. The throughput tests run with iperf2.
+
+    make NET_BENCHMARK=1
+    python3 Utilities/net_benchmark.py echo 192.168.1.20 --size 64 --count 1000
+    python3 Utilities/net_benchmark.py echo 192.168.1.20 --tcp --size 1024
+    python3 Utilities/net_benchmark.py pps 192.168.1.20 --size 18 --rate 20000 --duration 10
+    iperf -c 192.168.1.20 -t 10
+    iperf -c 192.168.1.20 -u -b 50M -t 10
+"""
+
+import argparse
+import socket
+import sys
+import time
+
+ECHO_PORT = 7
+PPS_PORT = 5002
+
+
+def percentile(samples, rank):
+    return samples[((len(samples) - 1) * rank) // 100]
+
+
+def echo(args):
+    """Time each message until its echo, one in flight."""
+    payload = bytes(range(256)) * (args.size // 256 + 1)
+    samples = []
+    lost = 0
+
+    if args.tcp:
+        sock = socket.create_connection((args.board, ECHO_PORT), timeout=args.timeout)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    else:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.settimeout(args.timeout)
+        sock.connect((args.board, ECHO_PORT))
+
+    for index in range(args.count):
+        message = index.to_bytes(4, "big") + payload[:max(args.size - 4, 0)]
+        start = time.perf_counter()
+        try:
+            sock.sendall(message)
+            if args.tcp:
+                received = b""
+                while len(received) < len(message):
+                    chunk = sock.recv(len(message) - len(received))
+                    if not chunk:
+                        raise ConnectionError("connection closed by the board")
+                    received += chunk
+            else:
+                # A late echo of a previous round is not this one.
+                while True:
+                    received = sock.recv(65536)
+                    if received[:4] == message[:4]:
+                        break
+        except socket.timeout:
+            lost += 1
+            continue
+        samples.append((time.perf_counter() - start) * 1e6)
+        if args.interval:
+            time.sleep(args.interval)
+
+    sock.close()
+
+    if not samples:
+        print("%s echo %u B: no echo" % ("TCP" if args.tcp else "UDP", args.size))
+        return 1
+
+    samples.sort()
+    print("%s echo %u B: %u samples, %u lost, min %.0f us, p50 %.0f us, p99 %.0f us, max %.0f us"
+          % ("TCP" if args.tcp else "UDP", args.size, len(samples), lost, samples[0],
+             percentile(samples, 50), percentile(samples, 99), samples[-1]))
+    return 0
+
+
+def pps(args):
+    """Send datagrams at a fixed rate, or as fast as possible with --rate 0."""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.connect((args.board, PPS_PORT))
+    payload = bytes(args.size)
+    sent = 0
+    failed = 0
+
+    start = time.perf_counter()
+    end = start + args.duration
+    now = start
+    while now < end:
+        # Catch up with the datagrams due, in bursts when the loop is late.
+        due = int((now - start) * args.rate) + 1 if args.rate else sent + 64
+        while sent < due:
+            try:
+                sock.send(payload)
+            except OSError:
+                failed += 1
+            sent += 1
+        if args.rate:
+            time.sleep(max(0.0, start + sent / args.rate - time.perf_counter()))
+        now = time.perf_counter()
+
+    elapsed = time.perf_counter() - start
+    sock.close()
+    print("PPS: %u datagrams of %u B sent in %.2f s, %.0f datagrams/s, %u failed"
+          % (sent, args.size, elapsed, sent / elapsed, failed))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    parser_echo = commands.add_parser("echo", help="round trip time through the echo server")
+    parser_echo.add_argument("board", help="address of the board")
+    parser_echo.add_argument("--tcp", action="store_true", help="TCP echo instead of UDP")
+    parser_echo.add_argument("--size", type=int, default=64, help="bytes of each message")
+    parser_echo.add_argument("--count", type=int, default=1000, help="round trips measured")
+    parser_echo.add_argument("--interval", type=float, default=0.0, help="delay in s between two round trips")
+    parser_echo.add_argument("--timeout", type=float, default=1.0, help="longest wait in s for an echo")
+
+    parser_pps = commands.add_parser("pps", help="flood of small datagrams to the packet rate sink")
+    parser_pps.add_argument("board", help="address of the board")
+    parser_pps.add_argument("--size", type=int, default=18, help="bytes of each datagram, 18 fill a 64 bytes frame")
+    parser_pps.add_argument("--rate", type=int, default=0, help="datagrams per second, 0 sends as fast as possible")
+    parser_pps.add_argument("--duration", type=float, default=10.0, help="length of the test in s")
+
+    args = parser.parse_args()
+    if args.command == "echo":
+        return echo(args)
+    return pps(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Decode the payloads of the messages published with PAYLOAD_COMPRESS, see NetXDuo/App/payload_compress.c.
+
+Each payload starts with its format byte: 0 for the message as it is, 1 for the length of the
+message, 2 bytes little endian, then its LZ4 block. The payloads are read one per line in hex,
+as mosquitto_sub prints them, and the messages printed the same way, or as text with --text.
+
+    mosquitto_sub -h test.mosquitto.org -t Temperature -F %x | python3 Utilities/payload_decode.py
+"""
+
+import argparse
+import sys
+
+PAYLOAD_FORMAT_RAW = 0x00
+PAYLOAD_FORMAT_LZ4 = 0x01
+
+
+def lz4_block_decode(block, length):
+    """Decode an LZ4 block into the message of the length given."""
+    message = bytearray()
+    position = 0
+
+    while position < len(block):
+        token = block[position]
+        position += 1
+
+        literals = token >> 4
+        if literals == 15:
+            while True:
+                extra = block[position]
+                position += 1
+                literals += extra
+                if extra != 255:
+                    break
+        message += block[position:position + literals]
+        position += literals
+
+        # The last sequence has no match.
+        if position == len(block):
+            break
+
+        offset = block[position] | (block[position + 1] << 8)
+        position += 2
+        if (offset == 0) or (offset > len(message)):
+            raise ValueError("match offset %d out of the message" % offset)
+
+        match = token & 15
+        if match == 15:
+            while True:
+                extra = block[position]
+                position += 1
+                match += extra
+                if extra != 255:
+                    break
+        match += 4
+
+        # A match may overlap the bytes it copies, one byte at a time.
+        start = len(message) - offset
+        for i in range(match):
+            message.append(message[start + i])
+
+    if len(message) != length:
+        raise ValueError("message of %d bytes, %d expected" % (len(message), length))
+    return bytes(message)
+
+
+def payload_decode(payload):
+    """Message of a payload, after its format byte."""
+    if not payload:
+        raise ValueError("empty payload")
+    if payload[0] == PAYLOAD_FORMAT_RAW:
+        return bytes(payload[1:])
+    if payload[0] == PAYLOAD_FORMAT_LZ4:
+        if len(payload) < 3:
+            raise ValueError("compressed payload without its length")
+        return lz4_block_decode(payload[3:], payload[1] | (payload[2] << 8))
+    raise ValueError("unknown payload format %d" % payload[0])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--text", action="store_true", help="print the messages as text")
+    args = parser.parse_args()
+
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            message = payload_decode(bytes.fromhex(line))
+        except ValueError as error:
+            print("invalid payload: %s" % error, file=sys.stderr)
+            continue
+        if args.text:
+            print(message.decode(errors="replace"))
+        else:
+            print(message.hex())
+        sys.stdout.flush()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Generate Core/Inc/perf_baseline.h from the PERF lines of runs of the performance harness.
+
+Each log is the USART3 output of a run of make PERF_HARNESS=1, the baseline of each result is
+its median over the logs. The thresholds set by hand in the current header are kept.
+
+    python3 Utilities/perf_baseline.py run1.log run2.log run3.log
+    python3 Utilities/perf_baseline.py --threshold 10 --output Core/Inc/perf_baseline.h run1.log
+"""
+
+import argparse
+import re
+import statistics
+import sys
+
+PERF_FIELDS = 9
+
+ENTRY = re.compile(r'ENTRY\("((?:[^"\\]|\\.)*)", *"((?:[^"\\]|\\.)*)", *"((?:[^"\\]|\\.)*)", *(\d+)U?, *(\d+)U?\)')
+
+HEADER = """/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    perf_baseline.h
+  * @author  MCD Application Team
+  * @brief   Baselines of the performance harness
+  *
+  *          Generated by Utilities/perf_baseline.py from the PERF lines of
+  *          one or more runs of the harness build, the median of each
+  *          result; regenerate it when a change is meant to move a result.
+  *          Each entry is
+  *            ENTRY(suite, name, metric, value, threshold)
+  *          the threshold in percent, 0 for PERF_HARNESS_THRESHOLD_PERCENT.
+  *          A result without an entry is reported NEW and does not fail the
+  *          run, an entry without a result does.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERF_BASELINE_H__
+#define __PERF_BASELINE_H__
+
+/* Exported constants --------------------------------------------------------*/
+"""
+
+FOOTER = """
+#endif /* __PERF_BASELINE_H__ */
+"""
+
+
+def results(paths):
+    """Values of each suite, name and metric, over the result lines of the logs."""
+    values = {}
+    for path in paths:
+        with open(path, errors="replace") as f:
+            for line in f:
+                fields = line.strip().split(",")
+                if len(fields) != PERF_FIELDS or fields[0] != "PERF" or not fields[5].isdigit():
+                    continue
+                # The status lines of the suites and the summary are not results.
+                if fields[4] == "status" or fields[2] == "summary":
+                    continue
+                values.setdefault((fields[2], fields[3], fields[4]), []).append(int(fields[5]))
+    return values
+
+
+def thresholds(path):
+    """Thresholds of the entries of the current header, those set by hand."""
+    kept = {}
+    try:
+        with open(path) as f:
+            for match in ENTRY.finditer(f.read()):
+                if int(match.group(5)) != 0:
+                    kept[match.group(1, 2, 3)] = int(match.group(5))
+    except FileNotFoundError:
+        pass
+    return kept
+
+
+def quote(text):
+    return '"%s"' % text.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("logs", nargs="+", help="outputs of runs of the harness build")
+    parser.add_argument("--output", default="Core/Inc/perf_baseline.h", help="header generated")
+    parser.add_argument("--threshold", type=int, default=0,
+                        help="threshold in percent of the new entries, 0 for PERF_HARNESS_THRESHOLD_PERCENT")
+    args = parser.parse_args()
+
+    values = results(args.logs)
+    if not values:
+        print("No PERF result in %s" % ", ".join(args.logs), file=sys.stderr)
+        return 1
+
+    kept = thresholds(args.output)
+    lines = ["#define PERF_BASELINE_LIST(ENTRY) \\"]
+    for key in sorted(values):
+        median = int(statistics.median(values[key]))
+        lines.append("  ENTRY(%s, %s, %s, %uU, %uU) \\"
+                     % (quote(key[0]), quote(key[1]), quote(key[2]), median, kept.get(key, args.threshold)))
+    # The last continuation ends on an empty line.
+    lines.append("")
+
+    with open(args.output, "w", newline="\r\n") as f:
+        f.write(HEADER + "\n".join(lines) + FOOTER)
+
+    print("%d baselines from %d logs written to %s" % (len(values), len(args.logs), args.output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Host side of the TLS benchmark, see NetXDuo/App/tls_benchmark.c.
+
+The board connects to an OpenSSL s_server on the host, which holds an RSA and an ECDSA server
+certificate so that every ECDHE ciphersuite of the sweep finds its own. The two test CAs that
+issue them are built into the board by NetXDuo/App/tls_benchmark.cert.h; the keys are test keys,
+never use them for anything else. The server discards the application data, the board times
+the records it sends.
+
+    python3 Utilities/tls_benchmark.py server
+    make TLS_BENCHMARK=1                       (TLS 1.2 ciphersuites)
+    make TLS_BENCHMARK=1 TLS_1_3=1             (TLS 1.3 ciphersuites first, then TLS 1.2)
+
+Regenerating the certificates rewrites the header, the board must be built again:
+
+    python3 Utilities/tls_benchmark.py certs
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CERT_DIR = os.path.join(ROOT, "Utilities", "tls_benchmark")
+HEADER = os.path.join(ROOT, "NetXDuo", "App", "tls_benchmark.cert.h")
+PORT = 4433
+DAYS = 7300
+
+HEADER_BANNER = """/**
+  ******************************************************************************
+  * @file    tls_benchmark.cert.h
+  * @author  MCD Application Team
+  * @brief   Test CA certificates of the TLS benchmark server
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Generated by Utilities/tls_benchmark.py certs, with the server certificates and keys of
+   Utilities/tls_benchmark. ASN.1 DER encoded, one CA for the RSA and one for the ECDSA chain. */
+"""
+
+
+def openssl(*args):
+    subprocess.run(("openssl",) + args, check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def chain(name, key_args):
+    """A self-signed CA and the server certificate it issues, both on the same key type."""
+    ca_key = os.path.join(CERT_DIR, "%s_ca.key" % name)
+    ca_crt = os.path.join(CERT_DIR, "%s_ca.crt" % name)
+    key = os.path.join(CERT_DIR, "%s_server.key" % name)
+    crt = os.path.join(CERT_DIR, "%s_server.crt" % name)
+
+    openssl("genpkey", *key_args, "-out", ca_key)
+    openssl("req", "-x509", "-new", "-key", ca_key, "-sha256", "-days", str(DAYS),
+            "-subj", "/O=STMicroelectronics/CN=TLS benchmark %s CA" % name.upper(), "-out", ca_crt)
+
+    openssl("genpkey", *key_args, "-out", key)
+    with tempfile.TemporaryDirectory() as scratch:
+        csr = os.path.join(scratch, "server.csr")
+        ext = os.path.join(scratch, "server.ext")
+        with open(ext, "w") as ext_file:
+            ext_file.write("basicConstraints = CA:FALSE\n"
+                           "keyUsage = digitalSignature, keyEncipherment\n"
+                           "extendedKeyUsage = serverAuth\n")
+        openssl("req", "-new", "-key", key, "-subj", "/O=STMicroelectronics/CN=tls-benchmark", "-out", csr)
+        openssl("x509", "-req", "-in", csr, "-CA", ca_crt, "-CAkey", ca_key, "-CAcreateserial",
+                "-sha256", "-days", str(DAYS), "-extfile", ext, "-out", crt)
+    # The CA only issues this certificate, a new one comes with the next certs.
+    os.remove(os.path.join(CERT_DIR, "%s_ca.srl" % name))
+    os.remove(ca_key)
+
+    return subprocess.run(("openssl", "x509", "-in", ca_crt, "-outform", "DER"),
+                          check=True, stdout=subprocess.PIPE).stdout
+
+
+def c_array(name, der):
+    lines = ["const unsigned char %s[] = {" % name]
+    for offset in range(0, len(der), 12):
+        lines.append("  " + ", ".join("0x%02x" % byte for byte in der[offset:offset + 12]) + ",")
+    lines[-1] = lines[-1][:-1]
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def certs(args):
+    os.makedirs(CERT_DIR, exist_ok=True)
+    rsa_der = chain("rsa", ("-algorithm", "RSA", "-pkeyopt", "rsa_keygen_bits:2048"))
+    ecdsa_der = chain("ecdsa", ("-algorithm", "EC", "-pkeyopt", "ec_paramgen_curve:P-256"))
+
+    with open(HEADER, "w", newline="\r\n") as header:
+        header.write(HEADER_BANNER + "\n")
+        header.write(c_array("tls_benchmark_rsa_ca_der", rsa_der) + "\n")
+        header.write(c_array("tls_benchmark_ecdsa_ca_der", ecdsa_der))
+
+    print("Certificates written to %s, CAs to %s" % (CERT_DIR, HEADER))
+    return 0
+
+
+def server(args):
+    """Serve the handshakes until interrupted, the received data is discarded."""
+    command = ["openssl", "s_server", "-accept", str(args.port), "-quiet",
+               "-cert", os.path.join(CERT_DIR, "rsa_server.crt"), "-key", os.path.join(CERT_DIR, "rsa_server.key"),
+               "-dcert", os.path.join(CERT_DIR, "ecdsa_server.crt"), "-dkey", os.path.join(CERT_DIR, "ecdsa_server.key")]
+    if args.tls1_2:
+        command.append("-tls1_2")
+    print(" ".join(command))
+    try:
+        return subprocess.run(command, stdin=subprocess.PIPE, stdout=subprocess.DEVNULL).returncode
+    except KeyboardInterrupt:
+        return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    commands.add_parser("certs", help="new test CAs and server certificates, and the header of the board")
+
+    parser_server = commands.add_parser("server", help="OpenSSL s_server the board connects to")
+    parser_server.add_argument("--port", type=int, default=PORT, help="TCP port, TLS_BENCHMARK_PEER_PORT of the board")
+    parser_server.add_argument("--tls1_2", action="store_true", help="refuse TLS 1.3 even when the board offers it")
+
+    args = parser.parse_args()
+    if args.command == "certs":
+        return certs(args)
+    return server(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
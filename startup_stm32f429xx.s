@@ -43,6 +43,20 @@ defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
 .word  _ebss
+/* start address for the initialization values of the .ccmram section.
+defined in linker script */
+.word  _siccmram
+/* start and end addresses for the .ccmram section. defined in linker script */
+.word  _sccmram
+.word  _eccmram
+/* start and end addresses for the .ccmbss section. defined in linker script */
+.word  _sccmbss
+.word  _eccmbss
+/* start address for the code of the .ramfunc section in flash, start and end
+addresses for the .ramfunc section in SRAM. defined in linker script */
+.word  _siramfunc
+.word  _sramfunc
+.word  _eramfunc
 /* stack used for SystemInit_ExtMemCtl; always internal RAM used */
 
 /**
@@ -91,6 +105,57 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the ccmram segment initializers from flash to CCMRAM */  
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  movs r3, #0
+  b LoopCopyCcmramInit
+
+CopyCcmramInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyCcmramInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyCcmramInit
+
+/* Zero fill the ccmbss segment. */
+  ldr r2, =_sccmbss
+  ldr r4, =_eccmbss
+  movs r3, #0
+  b LoopFillZeroCcmbss
+
+FillZeroCcmbss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroCcmbss:
+  cmp r2, r4
+  bcc FillZeroCcmbss
+
+/* Copy the code run from SRAM, see ram_functions.ld */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  movs r3, #0
+  b LoopCopyRamfuncInit
+
+CopyRamfuncInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRamfuncInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRamfuncInit
+/* The copied instructions are fetched from now on */
+  dsb
+  isb
+
 /* Call the clock system initialization function.*/
   bl  SystemInit   
 /* Call static constructors */